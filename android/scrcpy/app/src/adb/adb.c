@@ -6,11 +6,13 @@
 #include <string.h>
 #include <sys/types.h>
 
+#include "adb/adb_client.h"
 #include "adb/adb_device.h"
 #include "adb/adb_parser.h"
 #include "util/env.h"
 #include "util/file.h"
 #include "util/log.h"
+#include "util/memory.h"
 #include "util/process_intr.h"
 #include "util/str.h"
 
@@ -262,6 +264,17 @@ sc_adb_forward(struct sc_intr *intr, const char *serial, uint16_t local_port,
     }
 
     assert(serial);
+
+    char command[8 + sizeof(local) + sizeof(remote)]; // forward:LOCAL;REMOTE
+    r = snprintf(command, sizeof(command), "forward:%s;%s", local, remote);
+    assert(r >= 0 && (size_t) r < sizeof(command));
+
+    enum sc_adb_client_result res =
+        sc_adb_client_host_command(intr, serial, command, flags);
+    if (res != SC_ADB_CLIENT_UNAVAILABLE) {
+        return res == SC_ADB_CLIENT_OK;
+    }
+
     const char *const argv[] =
         SC_ADB_COMMAND("-s", serial, "forward", local, remote);
 
@@ -275,9 +288,20 @@ sc_adb_forward_remove(struct sc_intr *intr, const char *serial,
     char local[4 + 5 + 1]; // tcp:PORT
     int r = snprintf(local, sizeof(local), "tcp:%" PRIu16, local_port);
     assert(r >= 0 && (size_t) r < sizeof(local));
-    (void) r;
 
     assert(serial);
+
+    char command[12 + sizeof(local)]; // killforward:LOCAL
+    r = snprintf(command, sizeof(command), "killforward:%s", local);
+    assert(r >= 0 && (size_t) r < sizeof(command));
+    (void) r;
+
+    enum sc_adb_client_result res =
+        sc_adb_client_host_command(intr, serial, command, flags);
+    if (res != SC_ADB_CLIENT_UNAVAILABLE) {
+        return res == SC_ADB_CLIENT_OK;
+    }
+
     const char *const argv[] =
         SC_ADB_COMMAND("-s", serial, "forward", "--remove", local);
 
@@ -302,6 +326,19 @@ sc_adb_reverse(struct sc_intr *intr, const char *serial,
     }
 
     assert(serial);
+
+    // reverse:forward:REMOTE;LOCAL
+    char service[16 + sizeof(remote) + sizeof(local)];
+    r = snprintf(service, sizeof(service), "reverse:forward:%s;%s", remote,
+                 local);
+    assert(r >= 0 && (size_t) r < sizeof(service));
+
+    enum sc_adb_client_result res =
+        sc_adb_client_device_command(intr, serial, service, flags);
+    if (res != SC_ADB_CLIENT_UNAVAILABLE) {
+        return res == SC_ADB_CLIENT_OK;
+    }
+
     const char *const argv[] =
         SC_ADB_COMMAND("-s", serial, "reverse", remote, local);
 
@@ -321,6 +358,17 @@ sc_adb_reverse_remove(struct sc_intr *intr, const char *serial,
     }
 
     assert(serial);
+
+    char service[20 + sizeof(remote)]; // reverse:killforward:REMOTE
+    r = snprintf(service, sizeof(service), "reverse:killforward:%s", remote);
+    assert(r >= 0 && (size_t) r < sizeof(service));
+
+    enum sc_adb_client_result res =
+        sc_adb_client_device_command(intr, serial, service, flags);
+    if (res != SC_ADB_CLIENT_UNAVAILABLE) {
+        return res == SC_ADB_CLIENT_OK;
+    }
+
     const char *const argv[] =
         SC_ADB_COMMAND("-s", serial, "reverse", "--remove", remote);
 
@@ -346,10 +394,16 @@ sc_adb_push(struct sc_intr *intr, const char *serial, const char *local,
 #endif
 
     assert(serial);
-    const char *const argv[] =
-        SC_ADB_COMMAND("-s", serial, "push", local, remote);
-
-    sc_pid pid = sc_adb_execute(argv, flags);
+    sc_pid pid;
+    if (flags & SC_ADB_PUSH_SYNC) {
+        const char *const argv[] =
+            SC_ADB_COMMAND("-s", serial, "push", "--sync", local, remote);
+        pid = sc_adb_execute(argv, flags);
+    } else {
+        const char *const argv[] =
+            SC_ADB_COMMAND("-s", serial, "push", local, remote);
+        pid = sc_adb_execute(argv, flags);
+    }
 
 #ifdef _WIN32
     free((void *) remote);
@@ -359,6 +413,70 @@ sc_adb_push(struct sc_intr *intr, const char *serial, const char *local,
     return process_check_success_intr(intr, pid, "adb push", flags);
 }
 
+bool
+sc_adb_push_files(struct sc_intr *intr, const char *serial,
+                  const char *const *locals, size_t count, const char *remote,
+                  unsigned flags) {
+    assert(serial);
+    assert(count);
+
+    // adb -s <serial> push [--sync] <locals...> <remote> NULL
+    const char **argv = sc_allocarray(count + 6, sizeof(*argv));
+    if (!argv) {
+        LOG_OOM();
+        return false;
+    }
+
+    size_t argc = 0;
+    argv[argc++] = sc_adb_get_executable();
+    argv[argc++] = "-s";
+    argv[argc++] = serial;
+    argv[argc++] = "push";
+    if (flags & SC_ADB_PUSH_SYNC) {
+        argv[argc++] = "--sync";
+    }
+
+    const char **paths = &argv[argc];
+    size_t path_count = 0;
+    bool ok = false;
+
+    for (size_t i = 0; i < count; ++i) {
+#ifdef _WIN32
+        // Windows will parse the string, so the paths must be quoted
+        // (see sys/win/command.c)
+        const char *local = sc_str_quote(locals[i]);
+        if (!local) {
+            goto end;
+        }
+#else
+        const char *local = locals[i];
+#endif
+        paths[path_count++] = local;
+    }
+
+#ifdef _WIN32
+    remote = sc_str_quote(remote);
+    if (!remote) {
+        goto end;
+    }
+#endif
+    paths[path_count++] = remote;
+    paths[path_count] = NULL;
+
+    sc_pid pid = sc_adb_execute(argv, flags);
+    ok = process_check_success_intr(intr, pid, "adb push", flags);
+
+#ifdef _WIN32
+end:
+    for (size_t i = 0; i < path_count; ++i) {
+        free((void *) paths[i]);
+    }
+#endif
+    free(argv);
+
+    return ok;
+}
+
 bool
 sc_adb_install(struct sc_intr *intr, const char *serial, const char *local,
                unsigned flags) {
@@ -463,6 +581,25 @@ sc_adb_list_devices(struct sc_intr *intr, unsigned flags,
         return false;
     }
 
+    // The parser expects the output of "adb devices -l", including its header
+#define DEVICES_HEADER "List of devices attached\n"
+#define DEVICES_HEADER_LEN (sizeof(DEVICES_HEADER) - 1)
+    memcpy(buf, DEVICES_HEADER, DEVICES_HEADER_LEN);
+
+    size_t len;
+    enum sc_adb_client_result res =
+        sc_adb_client_host_query(intr, "host:devices-l",
+                                 buf + DEVICES_HEADER_LEN,
+                                 BUFSIZE - DEVICES_HEADER_LEN, &len, flags);
+    if (res != SC_ADB_CLIENT_UNAVAILABLE) {
+        bool ok = res == SC_ADB_CLIENT_OK;
+        if (ok) {
+            ok = sc_adb_parse_devices(buf, out_vec);
+        }
+        free(buf);
+        return ok;
+    }
+
     sc_pipe pout;
     sc_pid pid = sc_adb_execute_p(argv, flags, &pout);
     if (pid == SC_PROCESS_NONE) {
@@ -700,31 +837,52 @@ char *
 sc_adb_getprop(struct sc_intr *intr, const char *serial, const char *prop,
                unsigned flags) {
     assert(serial);
-    const char *const argv[] =
-        SC_ADB_COMMAND("-s", serial, "shell", "getprop", prop);
-
-    sc_pipe pout;
-    sc_pid pid = sc_adb_execute_p(argv, flags, &pout);
-    if (pid == SC_PROCESS_NONE) {
-        LOGE("Could not execute \"adb getprop\"");
-        return NULL;
-    }
 
     char buf[128];
-    ssize_t r = sc_pipe_read_all_intr(intr, pid, pout, buf, sizeof(buf) - 1);
-    sc_pipe_close(pout);
 
-    bool ok = process_check_success_intr(intr, pid, "adb getprop", flags);
-    if (!ok) {
+    char *command = sc_str_concat("getprop ", prop);
+    if (!command) {
+        LOG_OOM();
         return NULL;
     }
 
-    if (r == -1) {
+    size_t out_len;
+    enum sc_adb_client_result res =
+        sc_adb_client_shell(intr, serial, command, buf, sizeof(buf), &out_len,
+                            flags);
+    free(command);
+    if (res == SC_ADB_CLIENT_FAILED) {
         return NULL;
     }
 
-    assert((size_t) r < sizeof(buf));
-    buf[r] = '\0';
+    if (res == SC_ADB_CLIENT_UNAVAILABLE) {
+        const char *const argv[] =
+            SC_ADB_COMMAND("-s", serial, "shell", "getprop", prop);
+
+        sc_pipe pout;
+        sc_pid pid = sc_adb_execute_p(argv, flags, &pout);
+        if (pid == SC_PROCESS_NONE) {
+            LOGE("Could not execute \"adb getprop\"");
+            return NULL;
+        }
+
+        ssize_t r =
+            sc_pipe_read_all_intr(intr, pid, pout, buf, sizeof(buf) - 1);
+        sc_pipe_close(pout);
+
+        bool ok = process_check_success_intr(intr, pid, "adb getprop", flags);
+        if (!ok) {
+            return NULL;
+        }
+
+        if (r == -1) {
+            return NULL;
+        }
+
+        assert((size_t) r < sizeof(buf));
+        buf[r] = '\0';
+    }
+
     size_t len = strcspn(buf, " \r\n");
     buf[len] = '\0';
 
@@ -12,6 +12,9 @@
 #define SC_ADB_NO_STDOUT (1 << 0)
 #define SC_ADB_NO_STDERR (1 << 1)
 #define SC_ADB_NO_LOGERR (1 << 2)
+// For sc_adb_push(): do not transfer the file if it is already up to date on
+// the device (same size and modification time)
+#define SC_ADB_PUSH_SYNC (1 << 3)
 
 #define SC_ADB_SILENT (SC_ADB_NO_STDOUT | SC_ADB_NO_STDERR | SC_ADB_NO_LOGERR)
 
@@ -66,6 +69,17 @@ bool
 sc_adb_push(struct sc_intr *intr, const char *serial, const char *local,
             const char *remote, unsigned flags);
 
+/**
+ * Push several files to the same remote directory
+ *
+ * All the files are transferred over a single adb sync session, which is a
+ * lot faster than one `adb push` per file for many small files.
+ */
+bool
+sc_adb_push_files(struct sc_intr *intr, const char *serial,
+                  const char *const *locals, size_t count, const char *remote,
+                  unsigned flags);
+
 bool
 sc_adb_install(struct sc_intr *intr, const char *serial, const char *local,
                unsigned flags);
@@ -0,0 +1,321 @@
+#include "adb_client.h"
+
+#include <assert.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "adb/adb.h"
+#include "util/log.h"
+#include "util/net_intr.h"
+#include "util/str.h"
+
+#define SC_ADB_SERVER_PORT_DEFAULT 5037
+
+// Maximum length of a request (the length is sent as 4 hex digits)
+#define SC_ADB_CLIENT_MAX_REQUEST_LEN 0xFFFF
+
+static bool
+sc_adb_client_get_server_port(uint16_t *port) {
+    if (getenv("ADB_SERVER_SOCKET")) {
+        // A custom server socket (possibly remote) is not supported
+        return false;
+    }
+
+    const char *s = getenv("ANDROID_ADB_SERVER_PORT");
+    if (!s) {
+        *port = SC_ADB_SERVER_PORT_DEFAULT;
+        return true;
+    }
+
+    long value;
+    bool ok = sc_str_parse_integer(s, &value);
+    if (!ok || value <= 0 || value > 0xFFFF) {
+        LOGW("Invalid ANDROID_ADB_SERVER_PORT: %s", s);
+        return false;
+    }
+
+    *port = (uint16_t) value;
+    return true;
+}
+
+static enum sc_adb_client_result
+sc_adb_client_connect(struct sc_intr *intr, sc_socket *out_socket) {
+    uint16_t port;
+    if (!sc_adb_client_get_server_port(&port)) {
+        return SC_ADB_CLIENT_UNAVAILABLE;
+    }
+
+    sc_socket socket = net_socket();
+    if (socket == SC_SOCKET_NONE) {
+        return SC_ADB_CLIENT_UNAVAILABLE;
+    }
+
+    bool ok = net_connect_intr(intr, socket, IPV4_LOCALHOST, port);
+    if (!ok) {
+        net_close(socket);
+        if (sc_intr_is_interrupted(intr)) {
+            return SC_ADB_CLIENT_FAILED;
+        }
+        LOGD("adb server not reachable on port %" PRIu16, port);
+        return SC_ADB_CLIENT_UNAVAILABLE;
+    }
+
+    *out_socket = socket;
+    return SC_ADB_CLIENT_OK;
+}
+
+static bool
+sc_adb_client_send_request(struct sc_intr *intr, sc_socket socket,
+                           const char *request) {
+    size_t len = strlen(request);
+    if (len > SC_ADB_CLIENT_MAX_REQUEST_LEN) {
+        LOGE("adb request too long");
+        return false;
+    }
+
+    char header[5];
+    int r = snprintf(header, sizeof(header), "%04x", (unsigned) len);
+    assert(r == 4);
+    (void) r;
+
+    if (net_send_all_intr(intr, socket, header, 4) != 4) {
+        return false;
+    }
+
+    return net_send_all_intr(intr, socket, request, len) == (ssize_t) len;
+}
+
+static bool
+sc_adb_client_read_length(struct sc_intr *intr, sc_socket socket,
+                          size_t *out_len) {
+    char hex[5];
+    if (net_recv_all_intr(intr, socket, hex, 4) != 4) {
+        return false;
+    }
+    hex[4] = '\0';
+
+    char *endptr;
+    unsigned long len = strtoul(hex, &endptr, 16);
+    if (*endptr != '\0') {
+        LOGE("Invalid length from adb server");
+        return false;
+    }
+
+    *out_len = len;
+    return true;
+}
+
+static bool
+sc_adb_client_read_status(struct sc_intr *intr, sc_socket socket,
+                          unsigned flags) {
+    bool log_errors = !(flags & SC_ADB_NO_LOGERR);
+
+    char status[4];
+    if (net_recv_all_intr(intr, socket, status, 4) != 4) {
+        if (log_errors && !sc_intr_is_interrupted(intr)) {
+            LOGE("Could not read status from adb server");
+        }
+        return false;
+    }
+
+    if (!memcmp(status, "OKAY", 4)) {
+        return true;
+    }
+
+    if (memcmp(status, "FAIL", 4)) {
+        if (log_errors) {
+            LOGE("Unexpected status from adb server");
+        }
+        return false;
+    }
+
+    if (log_errors) {
+        char msg[256];
+        size_t len;
+        ssize_t r = -1;
+        if (sc_adb_client_read_length(intr, socket, &len)) {
+            // The message may be truncated, the socket is closed anyway
+            len = MIN(len, sizeof(msg) - 1);
+            r = net_recv_all_intr(intr, socket, msg, len);
+        }
+        if (r >= 0) {
+            msg[r] = '\0';
+            LOGE("adb: %s", msg);
+        } else {
+            LOGE("adb request failed");
+        }
+    }
+
+    return false;
+}
+
+// Switch the connection to the device, so that the next request is handled by
+// the device daemon
+static bool
+sc_adb_client_switch_transport(struct sc_intr *intr, sc_socket socket,
+                               const char *serial, unsigned flags) {
+    char *request = sc_str_concat("host:transport:", serial);
+    if (!request) {
+        LOG_OOM();
+        return false;
+    }
+
+    bool ok = sc_adb_client_send_request(intr, socket, request);
+    free(request);
+    if (!ok) {
+        return false;
+    }
+
+    return sc_adb_client_read_status(intr, socket, flags);
+}
+
+enum sc_adb_client_result
+sc_adb_client_host_query(struct sc_intr *intr, const char *service,
+                         char *buf, size_t bufsize, size_t *out_len,
+                         unsigned flags) {
+    assert(bufsize);
+
+    sc_socket socket;
+    enum sc_adb_client_result res = sc_adb_client_connect(intr, &socket);
+    if (res != SC_ADB_CLIENT_OK) {
+        return res;
+    }
+
+    res = SC_ADB_CLIENT_FAILED;
+
+    if (!sc_adb_client_send_request(intr, socket, service)
+            || !sc_adb_client_read_status(intr, socket, flags)) {
+        goto end;
+    }
+
+    size_t len;
+    if (!sc_adb_client_read_length(intr, socket, &len)) {
+        goto end;
+    }
+
+    if (len >= bufsize) {
+        LOGW("Result of \"%s\" does not fit in %" SC_PRIsizet " bytes",
+             service, bufsize);
+        goto end;
+    }
+
+    if (net_recv_all_intr(intr, socket, buf, len) != (ssize_t) len) {
+        goto end;
+    }
+
+    buf[len] = '\0';
+    *out_len = len;
+    res = SC_ADB_CLIENT_OK;
+
+end:
+    net_close(socket);
+    return res;
+}
+
+enum sc_adb_client_result
+sc_adb_client_host_command(struct sc_intr *intr, const char *serial,
+                           const char *command, unsigned flags) {
+    assert(serial);
+
+    char *request;
+    int r = asprintf(&request, "host-serial:%s:%s", serial, command);
+    if (r == -1) {
+        LOG_OOM();
+        return SC_ADB_CLIENT_FAILED;
+    }
+
+    sc_socket socket;
+    enum sc_adb_client_result res = sc_adb_client_connect(intr, &socket);
+    if (res != SC_ADB_CLIENT_OK) {
+        free(request);
+        return res;
+    }
+
+    // The adb server replies twice: once when the request is accepted, once
+    // when the command is executed
+    bool ok = sc_adb_client_send_request(intr, socket, request)
+           && sc_adb_client_read_status(intr, socket, flags)
+           && sc_adb_client_read_status(intr, socket, flags);
+
+    free(request);
+    net_close(socket);
+
+    return ok ? SC_ADB_CLIENT_OK : SC_ADB_CLIENT_FAILED;
+}
+
+enum sc_adb_client_result
+sc_adb_client_device_command(struct sc_intr *intr, const char *serial,
+                             const char *service, unsigned flags) {
+    assert(serial);
+
+    sc_socket socket;
+    enum sc_adb_client_result res = sc_adb_client_connect(intr, &socket);
+    if (res != SC_ADB_CLIENT_OK) {
+        return res;
+    }
+
+    // The first status is sent by the adb server when the stream to the
+    // device is open, the second one by the device daemon
+    bool ok = sc_adb_client_switch_transport(intr, socket, serial, flags)
+           && sc_adb_client_send_request(intr, socket, service)
+           && sc_adb_client_read_status(intr, socket, flags)
+           && sc_adb_client_read_status(intr, socket, flags);
+
+    net_close(socket);
+
+    return ok ? SC_ADB_CLIENT_OK : SC_ADB_CLIENT_FAILED;
+}
+
+enum sc_adb_client_result
+sc_adb_client_shell(struct sc_intr *intr, const char *serial,
+                    const char *command, char *buf, size_t bufsize,
+                    size_t *out_len, unsigned flags) {
+    assert(serial);
+    assert(bufsize);
+
+    char *service = sc_str_concat("shell:", command);
+    if (!service) {
+        LOG_OOM();
+        return SC_ADB_CLIENT_FAILED;
+    }
+
+    sc_socket socket;
+    enum sc_adb_client_result res = sc_adb_client_connect(intr, &socket);
+    if (res != SC_ADB_CLIENT_OK) {
+        free(service);
+        return res;
+    }
+
+    res = SC_ADB_CLIENT_FAILED;
+
+    bool ok = sc_adb_client_switch_transport(intr, socket, serial, flags)
+           && sc_adb_client_send_request(intr, socket, service)
+           && sc_adb_client_read_status(intr, socket, flags);
+    free(service);
+    if (!ok) {
+        goto end;
+    }
+
+    // The output is raw, until the device closes the stream
+    size_t len = 0;
+    while (len < bufsize - 1) {
+        ssize_t r = net_recv_intr(intr, socket, buf + len, bufsize - 1 - len);
+        if (r < 0) {
+            goto end;
+        }
+        if (r == 0) {
+            break;
+        }
+        len += r;
+    }
+
+    buf[len] = '\0';
+    *out_len = len;
+    res = SC_ADB_CLIENT_OK;
+
+end:
+    net_close(socket);
+    return res;
+}
@@ -0,0 +1,72 @@
+#ifndef SC_ADB_CLIENT_H
+#define SC_ADB_CLIENT_H
+
+#include "common.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "util/intr.h"
+
+/**
+ * Minimal in-process client for the adb server "smart socket" protocol
+ *
+ * It sends the requests directly to the adb server (on localhost, port 5037
+ * or $ANDROID_ADB_SERVER_PORT), instead of executing an adb process for each
+ * request.
+ *
+ * The adb server must already be running ("adb start-server"). If it can not
+ * be reached, the functions return SC_ADB_CLIENT_UNAVAILABLE, so that the
+ * caller may fall back to executing the adb binary.
+ *
+ * The flags are the SC_ADB_* flags from adb.h (only SC_ADB_NO_LOGERR is
+ * meaningful).
+ */
+
+enum sc_adb_client_result {
+    SC_ADB_CLIENT_OK,
+    // The request failed (the error has been logged, unless SC_ADB_NO_LOGERR)
+    SC_ADB_CLIENT_FAILED,
+    // The adb server is not reachable
+    SC_ADB_CLIENT_UNAVAILABLE,
+};
+
+/**
+ * Execute a host service returning data (e.g. "host:devices-l")
+ *
+ * The result is written to `buf` as a NUL-terminated string, and its length
+ * is written to `out_len`.
+ */
+enum sc_adb_client_result
+sc_adb_client_host_query(struct sc_intr *intr, const char *service,
+                         char *buf, size_t bufsize, size_t *out_len,
+                         unsigned flags);
+
+/**
+ * Execute a host service for a specific device (e.g. "forward:tcp:1234;...")
+ *
+ * The request is sent as "host-serial:<serial>:<command>".
+ */
+enum sc_adb_client_result
+sc_adb_client_host_command(struct sc_intr *intr, const char *serial,
+                           const char *command, unsigned flags);
+
+/**
+ * Execute a device service returning only a status (e.g. "reverse:forward:...")
+ */
+enum sc_adb_client_result
+sc_adb_client_device_command(struct sc_intr *intr, const char *serial,
+                             const char *service, unsigned flags);
+
+/**
+ * Execute a shell command on the device and read its whole output
+ *
+ * The output is written to `buf` as a NUL-terminated string (truncated if it
+ * does not fit), and its length is written to `out_len`.
+ */
+enum sc_adb_client_result
+sc_adb_client_shell(struct sc_intr *intr, const char *serial,
+                    const char *command, char *buf, size_t bufsize,
+                    size_t *out_len, unsigned flags);
+
+#endif
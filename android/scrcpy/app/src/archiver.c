@@ -0,0 +1,541 @@
+#include "archiver.h"
+
+#include <assert.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <libavutil/hwcontext.h>
+
+#include "util/log.h"
+
+/** Downcast frame_sink to sc_archiver */
+#define DOWNCAST(SINK) container_of(SINK, struct sc_archiver, frame_sink)
+
+static const AVRational SCRCPY_TIME_BASE = {1, 1000000}; // timestamps in us
+
+// A key frame every 10 seconds at 60 fps, long GOPs are cheap for archives
+#define SC_ARCHIVER_GOP_SIZE 600
+
+// Tried in order if no encoder is explicitly requested
+static const char *const sc_archiver_auto_encoders[] = {
+    "hevc_nvenc",
+    "hevc_qsv",
+    "hevc_vaapi",
+    "h264_nvenc",
+    "h264_qsv",
+    "h264_vaapi",
+};
+
+#ifdef SCRCPY_LAVC_HAS_HW_CONFIG
+static const AVCodecHWConfig *
+sc_archiver_find_hw_frames_config(const AVCodec *encoder) {
+    for (int i = 0;; ++i) {
+        const AVCodecHWConfig *config = avcodec_get_hw_config(encoder, i);
+        if (!config) {
+            return NULL;
+        }
+
+        if (config->methods & AV_CODEC_HW_CONFIG_METHOD_HW_FRAMES_CTX) {
+            return config;
+        }
+    }
+}
+
+// Some encoders (e.g. VAAPI) only accept frames in GPU memory: the NV12
+// frames are uploaded to a pool of hardware frames
+static bool
+sc_archiver_init_hw_frames(struct sc_archiver *ar, AVCodecContext *enc,
+                           const AVCodecHWConfig *config) {
+    int r = av_hwdevice_ctx_create(&ar->hw_device_ctx, config->device_type,
+                                   NULL, NULL, 0);
+    if (r < 0) {
+        LOGD("Archiver: could not create %s device: %d",
+             av_hwdevice_get_type_name(config->device_type), r);
+        return false;
+    }
+
+    AVBufferRef *frames_ref = av_hwframe_ctx_alloc(ar->hw_device_ctx);
+    if (!frames_ref) {
+        LOG_OOM();
+        goto error_unref_device;
+    }
+
+    AVHWFramesContext *frames_ctx = (AVHWFramesContext *) frames_ref->data;
+    frames_ctx->format = config->pix_fmt;
+    frames_ctx->sw_format = AV_PIX_FMT_NV12;
+    frames_ctx->width = enc->width;
+    frames_ctx->height = enc->height;
+    frames_ctx->initial_pool_size = SC_ARCHIVER_QUEUE_SIZE;
+
+    r = av_hwframe_ctx_init(frames_ref);
+    if (r < 0) {
+        LOGD("Archiver: could not initialize hardware frames: %d", r);
+        av_buffer_unref(&frames_ref);
+        goto error_unref_device;
+    }
+
+    ar->hw_frame = av_frame_alloc();
+    if (!ar->hw_frame) {
+        LOG_OOM();
+        av_buffer_unref(&frames_ref);
+        goto error_unref_device;
+    }
+
+    // The codec context takes ownership of the frames context
+    enc->hw_frames_ctx = frames_ref;
+    enc->pix_fmt = config->pix_fmt;
+
+    return true;
+
+error_unref_device:
+    av_buffer_unref(&ar->hw_device_ctx);
+
+    return false;
+}
+#endif
+
+static void
+sc_archiver_close_encoder(struct sc_archiver *ar) {
+    avcodec_free_context(&ar->encoder_ctx);
+    av_frame_free(&ar->hw_frame);
+    av_buffer_unref(&ar->hw_device_ctx);
+}
+
+static bool
+sc_archiver_open_encoder(struct sc_archiver *ar, const AVCodec *encoder,
+                         const AVCodecContext *ctx) {
+    AVCodecContext *enc = avcodec_alloc_context3(encoder);
+    if (!enc) {
+        LOG_OOM();
+        return false;
+    }
+
+    ar->encoder_ctx = enc;
+    ar->hw_device_ctx = NULL;
+    ar->hw_frame = NULL;
+
+    enc->width = ctx->width;
+    enc->height = ctx->height;
+    enc->time_base = SCRCPY_TIME_BASE;
+    enc->bit_rate = ar->bit_rate;
+    enc->gop_size = SC_ARCHIVER_GOP_SIZE;
+    enc->pix_fmt = AV_PIX_FMT_NV12;
+
+    if (ar->format_ctx->oformat->flags & AVFMT_GLOBALHEADER) {
+        enc->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+    }
+
+#ifdef SCRCPY_LAVC_HAS_HW_CONFIG
+    const AVCodecHWConfig *config = sc_archiver_find_hw_frames_config(encoder);
+    if (config && !sc_archiver_init_hw_frames(ar, enc, config)) {
+        sc_archiver_close_encoder(ar);
+        return false;
+    }
+#endif
+
+    int r = avcodec_open2(enc, encoder, NULL);
+    if (r < 0) {
+        LOGD("Archiver: could not open encoder %s: %d", encoder->name, r);
+        sc_archiver_close_encoder(ar);
+        return false;
+    }
+
+    return true;
+}
+
+static bool
+sc_archiver_open_any_encoder(struct sc_archiver *ar,
+                             const AVCodecContext *ctx) {
+    if (ar->encoder_name) {
+        const AVCodec *encoder = avcodec_find_encoder_by_name(ar->encoder_name);
+        if (!encoder || encoder->type != AVMEDIA_TYPE_VIDEO) {
+            LOGE("Archiver: video encoder not found: %s", ar->encoder_name);
+            return false;
+        }
+
+        if (!sc_archiver_open_encoder(ar, encoder, ctx)) {
+            LOGE("Archiver: could not open encoder %s", ar->encoder_name);
+            return false;
+        }
+
+        return true;
+    }
+
+    for (size_t i = 0; i < ARRAY_LEN(sc_archiver_auto_encoders); ++i) {
+        const char *name = sc_archiver_auto_encoders[i];
+        const AVCodec *encoder = avcodec_find_encoder_by_name(name);
+        if (encoder && sc_archiver_open_encoder(ar, encoder, ctx)) {
+            return true;
+        }
+    }
+
+    LOGE("Archiver: no hardware encoder available (use --archive-encoder)");
+    return false;
+}
+
+static bool
+sc_archiver_write_packets(struct sc_archiver *ar) {
+    AVStream *ostream = ar->format_ctx->streams[0];
+    AVPacket *packet = ar->packet;
+
+    for (;;) {
+        int r = avcodec_receive_packet(ar->encoder_ctx, packet);
+        if (r == AVERROR(EAGAIN) || r == AVERROR_EOF) {
+            return true;
+        }
+
+        if (r < 0) {
+            LOGE("Archiver: could not receive packet: %d", r);
+            return false;
+        }
+
+        av_packet_rescale_ts(packet, ar->encoder_ctx->time_base,
+                             ostream->time_base);
+        packet->stream_index = ostream->index;
+
+        // The packet is unreferenced by the muxer
+        r = av_interleaved_write_frame(ar->format_ctx, packet);
+        if (r < 0) {
+            LOGE("Archiver: could not write packet: %d", r);
+            return false;
+        }
+    }
+}
+
+// Encode the frame (or flush the encoder if frame is NULL)
+static bool
+sc_archiver_encode(struct sc_archiver *ar, AVFrame *frame) {
+    AVCodecContext *enc = ar->encoder_ctx;
+
+    if (frame) {
+        if (frame->width != enc->width || frame->height != enc->height) {
+            // The encoder cannot change its size during the stream
+            if (!ar->size_mismatch_logged) {
+                LOGW("Archiver: frame size changed (%dx%d), frames dropped",
+                     frame->width, frame->height);
+                ar->size_mismatch_logged = true;
+            }
+            return true;
+        }
+
+        if (ar->pts_origin == AV_NOPTS_VALUE) {
+            ar->pts_origin = frame->pts;
+        }
+        frame->pts -= ar->pts_origin;
+
+        if (frame->pts <= ar->last_pts) {
+            // The encoders require strictly increasing timestamps
+            return true;
+        }
+        ar->last_pts = frame->pts;
+
+        if (ar->hw_frame) {
+            AVFrame *hw_frame = ar->hw_frame;
+            int r = av_hwframe_get_buffer(enc->hw_frames_ctx, hw_frame, 0);
+            if (r < 0) {
+                LOGE("Archiver: could not get hardware frame: %d", r);
+                return false;
+            }
+
+            r = av_hwframe_transfer_data(hw_frame, frame, 0);
+            if (r < 0 || av_frame_copy_props(hw_frame, frame) < 0) {
+                LOGE("Archiver: could not upload frame: %d", r);
+                av_frame_unref(hw_frame);
+                return false;
+            }
+
+            frame = hw_frame;
+        }
+    }
+
+    int r = avcodec_send_frame(enc, frame);
+    if (ar->hw_frame) {
+        av_frame_unref(ar->hw_frame);
+    }
+    if (r < 0 && r != AVERROR(EAGAIN) && r != AVERROR_EOF) {
+        LOGE("Archiver: could not send frame: %d", r);
+        return false;
+    }
+
+    return sc_archiver_write_packets(ar);
+}
+
+static int
+run_archiver(void *data) {
+    struct sc_archiver *ar = data;
+
+    for (;;) {
+        sc_mutex_lock(&ar->mutex);
+
+        while (!ar->stopped && !ar->has_frame) {
+            sc_cond_wait(&ar->cond, &ar->mutex);
+        }
+
+        bool stopped = ar->stopped;
+        ar->has_frame = false;
+        sc_mutex_unlock(&ar->mutex);
+
+        // Encode the pending frames even on stop, to archive all the frames
+        // received
+        while (sc_frame_buffer_consume(&ar->fb, ar->frame, NULL)) {
+            bool ok = sc_archiver_encode(ar, ar->frame);
+            av_frame_unref(ar->frame);
+            if (!ok) {
+                LOGE("Archiver: encoding stopped, next frames dropped");
+                goto end;
+            }
+        }
+
+        if (stopped) {
+            break;
+        }
+    }
+
+    // Flush the frames still buffered by the encoder
+    sc_archiver_encode(ar, NULL);
+
+end:
+    LOGD("Archiver thread ended");
+
+    return 0;
+}
+
+static bool
+sc_archiver_open_muxer(struct sc_archiver *ar, const AVCodecContext *ctx) {
+    // The container is guessed from the file extension
+    int r = avformat_alloc_output_context2(&ar->format_ctx, NULL, NULL,
+                                           ar->filename);
+    if (r < 0) {
+        LOGE("Archiver: unsupported container for %s", ar->filename);
+        return false;
+    }
+
+    AVStream *ostream = avformat_new_stream(ar->format_ctx, NULL);
+    if (!ostream) {
+        LOG_OOM();
+        goto error_avformat_free_context;
+    }
+
+    if (!sc_archiver_open_any_encoder(ar, ctx)) {
+        goto error_avformat_free_context;
+    }
+
+    r = avcodec_parameters_from_context(ostream->codecpar, ar->encoder_ctx);
+    if (r < 0) {
+        LOG_OOM();
+        goto error_close_encoder;
+    }
+    ostream->time_base = ar->encoder_ctx->time_base;
+
+    r = avio_open(&ar->format_ctx->pb, ar->filename, AVIO_FLAG_WRITE);
+    if (r < 0) {
+        LOGE("Archiver: could not open %s", ar->filename);
+        goto error_close_encoder;
+    }
+
+    r = avformat_write_header(ar->format_ctx, NULL);
+    if (r < 0) {
+        LOGE("Archiver: could not write header to %s", ar->filename);
+        goto error_avio_close;
+    }
+
+    LOGI("Archiving to %s (%s, %dx%d, %" PRIu32 " bps)", ar->filename,
+         ar->encoder_ctx->codec->name, ctx->width, ctx->height, ar->bit_rate);
+
+    return true;
+
+error_avio_close:
+    avio_closep(&ar->format_ctx->pb);
+error_close_encoder:
+    sc_archiver_close_encoder(ar);
+error_avformat_free_context:
+    avformat_free_context(ar->format_ctx);
+
+    return false;
+}
+
+static void
+sc_archiver_close_muxer(struct sc_archiver *ar) {
+    int r = av_write_trailer(ar->format_ctx);
+    if (r < 0) {
+        LOGW("Archiver: could not write trailer to %s", ar->filename);
+    }
+
+    sc_archiver_close_encoder(ar);
+    avio_closep(&ar->format_ctx->pb);
+    avformat_free_context(ar->format_ctx);
+}
+
+static bool
+sc_archiver_open(struct sc_archiver *ar, const AVCodecContext *ctx) {
+    // The frames are converted upstream
+    assert(ctx->pix_fmt == AV_PIX_FMT_NV12);
+
+    bool ok = sc_frame_buffer_init(&ar->fb, SC_ARCHIVER_QUEUE_SIZE,
+                                   SC_FRAME_BUFFER_POLICY_FIFO);
+    if (!ok) {
+        return false;
+    }
+
+    ok = sc_mutex_init(&ar->mutex);
+    if (!ok) {
+        goto error_frame_buffer_destroy;
+    }
+
+    ok = sc_cond_init(&ar->cond);
+    if (!ok) {
+        goto error_mutex_destroy;
+    }
+
+    ar->frame = av_frame_alloc();
+    if (!ar->frame) {
+        LOG_OOM();
+        goto error_cond_destroy;
+    }
+
+    ar->packet = av_packet_alloc();
+    if (!ar->packet) {
+        LOG_OOM();
+        goto error_av_frame_free;
+    }
+
+    ok = sc_archiver_open_muxer(ar, ctx);
+    if (!ok) {
+        goto error_av_packet_free;
+    }
+
+    ar->has_frame = false;
+    ar->stopped = false;
+    ar->pts_origin = AV_NOPTS_VALUE;
+    ar->last_pts = -1;
+    ar->size_mismatch_logged = false;
+    ar->dropped = 0;
+
+    LOGD("Starting archiver thread");
+    ok = sc_thread_create(&ar->thread, run_archiver, "scrcpy-archive", ar);
+    if (!ok) {
+        LOGE("Could not start archiver thread");
+        goto error_close_muxer;
+    }
+
+    return true;
+
+error_close_muxer:
+    sc_archiver_close_muxer(ar);
+error_av_packet_free:
+    av_packet_free(&ar->packet);
+error_av_frame_free:
+    av_frame_free(&ar->frame);
+error_cond_destroy:
+    sc_cond_destroy(&ar->cond);
+error_mutex_destroy:
+    sc_mutex_destroy(&ar->mutex);
+error_frame_buffer_destroy:
+    sc_frame_buffer_destroy(&ar->fb);
+
+    return false;
+}
+
+static void
+sc_archiver_close(struct sc_archiver *ar) {
+    sc_mutex_lock(&ar->mutex);
+    ar->stopped = true;
+    sc_cond_signal(&ar->cond);
+    sc_mutex_unlock(&ar->mutex);
+
+    sc_thread_join(&ar->thread, NULL);
+
+    if (ar->dropped) {
+        LOGW("Archiver: %" PRIu64_ " frame(s) dropped (the encoder did not "
+             "keep up)", ar->dropped);
+    }
+
+    sc_archiver_close_muxer(ar);
+    av_packet_free(&ar->packet);
+    av_frame_free(&ar->frame);
+    sc_cond_destroy(&ar->cond);
+    sc_mutex_destroy(&ar->mutex);
+    sc_frame_buffer_destroy(&ar->fb);
+}
+
+static bool
+sc_archiver_push(struct sc_archiver *ar, const AVFrame *frame) {
+    enum sc_frame_buffer_drop drop;
+    unsigned slot;
+    bool ok = sc_frame_buffer_push(&ar->fb, frame, &drop, &slot);
+    if (!ok) {
+        return false;
+    }
+
+    if (drop != SC_FRAME_BUFFER_DROP_NONE) {
+        // Only accessed from the pushing thread until the sink is closed
+        ++ar->dropped;
+        return true;
+    }
+
+    sc_mutex_lock(&ar->mutex);
+    ar->has_frame = true;
+    sc_cond_signal(&ar->cond);
+    sc_mutex_unlock(&ar->mutex);
+
+    return true;
+}
+
+static bool
+sc_archiver_frame_sink_open(struct sc_frame_sink *sink,
+                            const AVCodecContext *ctx) {
+    struct sc_archiver *ar = DOWNCAST(sink);
+    return sc_archiver_open(ar, ctx);
+}
+
+static void
+sc_archiver_frame_sink_close(struct sc_frame_sink *sink) {
+    struct sc_archiver *ar = DOWNCAST(sink);
+    sc_archiver_close(ar);
+}
+
+static bool
+sc_archiver_frame_sink_push(struct sc_frame_sink *sink,
+                            const AVFrame *frame) {
+    struct sc_archiver *ar = DOWNCAST(sink);
+    return sc_archiver_push(ar, frame);
+}
+
+bool
+sc_archiver_init(struct sc_archiver *ar, const char *filename,
+                 const char *encoder_name, uint32_t bit_rate) {
+    ar->filename = strdup(filename);
+    if (!ar->filename) {
+        LOG_OOM();
+        return false;
+    }
+
+    if (encoder_name) {
+        ar->encoder_name = strdup(encoder_name);
+        if (!ar->encoder_name) {
+            LOG_OOM();
+            free(ar->filename);
+            return false;
+        }
+    } else {
+        ar->encoder_name = NULL;
+    }
+
+    ar->bit_rate = bit_rate;
+
+    static const struct sc_frame_sink_ops ops = {
+        .open = sc_archiver_frame_sink_open,
+        .close = sc_archiver_frame_sink_close,
+        .push = sc_archiver_frame_sink_push,
+    };
+
+    ar->frame_sink.ops = &ops;
+
+    return true;
+}
+
+void
+sc_archiver_destroy(struct sc_archiver *ar) {
+    free(ar->encoder_name);
+    free(ar->filename);
+}
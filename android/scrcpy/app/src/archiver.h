@@ -0,0 +1,74 @@
+#ifndef SC_ARCHIVER_H
+#define SC_ARCHIVER_H
+
+#include "common.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+
+#include "frame_buffer.h"
+#include "trait/frame_sink.h"
+#include "util/thread.h"
+
+// Number of decoded frames which may be pending before they are dropped
+#define SC_ARCHIVER_QUEUE_SIZE 8
+
+/**
+ * Transcoding sink, to record long sessions at a lower bit rate
+ *
+ * Contrary to the recorder, which stores the device stream verbatim, it
+ * re-encodes the decoded frames (typically through a hardware encoder) and
+ * muxes them to a file.
+ *
+ * The frames are received in NV12 (see sc_frame_transform), and encoded from
+ * a separate thread. If the encoder does not keep up, the frames which do not
+ * fit in the queue are dropped.
+ */
+struct sc_archiver {
+    struct sc_frame_sink frame_sink; // frame sink trait
+
+    struct sc_frame_buffer fb;
+
+    char *filename;
+    char *encoder_name; // NULL for the first available hardware encoder
+    uint32_t bit_rate;
+
+    AVFormatContext *format_ctx;
+    AVCodecContext *encoder_ctx;
+    // Only used if the encoder requires hardware frames (e.g. VAAPI)
+    AVBufferRef *hw_device_ctx;
+    AVFrame *hw_frame;
+
+    sc_thread thread;
+    sc_mutex mutex;
+    sc_cond cond;
+    bool has_frame;
+    bool stopped;
+
+    // Only accessed from the archiver thread
+    int64_t pts_origin;
+    int64_t last_pts;
+    bool size_mismatch_logged;
+
+    uint64_t dropped; // frames dropped because the queue was full
+
+    AVFrame *frame;
+    AVPacket *packet;
+};
+
+/**
+ * Initialize an archiver
+ *
+ * If encoder_name is NULL, the first available hardware encoder is used
+ * (NVENC, QSV or VAAPI, for H.265 then H.264).
+ */
+bool
+sc_archiver_init(struct sc_archiver *ar, const char *filename,
+                 const char *encoder_name, uint32_t bit_rate);
+
+void
+sc_archiver_destroy(struct sc_archiver *ar);
+
+#endif
@@ -0,0 +1,318 @@
+#include "audio_output_alsa.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <stdlib.h>
+
+#include "util/log.h"
+
+/** Downcast audio_output to sc_audio_output_alsa */
+#define DOWNCAST(AOUT) \
+    container_of(AOUT, struct sc_audio_output_alsa, audio_output)
+
+#define SC_ALSA_DEVICE "default"
+// Maximum time to wait for the device, so that a stop request is handled
+#define SC_ALSA_WAIT_TIMEOUT_MS 100
+
+static bool
+sc_audio_output_alsa_recover(struct sc_audio_output_alsa *aout, int err) {
+    if (err == -EPIPE) {
+        LOGV("[Audio] ALSA underrun");
+    }
+
+    // The device is restarted automatically once a period is written
+    // (according to the start threshold)
+    err = snd_pcm_recover(aout->pcm, err, 1);
+    if (err < 0) {
+        LOGE("ALSA: could not recover: %s", snd_strerror(err));
+        return false;
+    }
+
+    return true;
+}
+
+static int
+sc_audio_output_alsa_write_mmap(struct sc_audio_output_alsa *aout) {
+    const snd_pcm_channel_area_t *areas;
+    snd_pcm_uframes_t offset;
+    snd_pcm_uframes_t frames = aout->period;
+
+    int err = snd_pcm_mmap_begin(aout->pcm, &areas, &offset, &frames);
+    if (err < 0) {
+        return err;
+    }
+
+    // Interleaved access: all the channels share the first area, and the
+    // samples are pulled straight into the device buffer
+    assert(areas[0].step == aout->sample_size * 8);
+    uint8_t *out = (uint8_t *) areas[0].addr + areas[0].first / 8
+                 + offset * aout->sample_size;
+    aout->cbs->on_pull(out, frames, aout->cbs_userdata);
+
+    snd_pcm_sframes_t r = snd_pcm_mmap_commit(aout->pcm, offset, frames);
+    if (r < 0) {
+        return r;
+    }
+    if ((snd_pcm_uframes_t) r != frames) {
+        return -EPIPE;
+    }
+
+    return 0;
+}
+
+static int
+sc_audio_output_alsa_write_rw(struct sc_audio_output_alsa *aout) {
+    aout->cbs->on_pull(aout->buf, aout->period, aout->cbs_userdata);
+
+    snd_pcm_uframes_t written = 0;
+    while (written < aout->period) {
+        snd_pcm_sframes_t r =
+            snd_pcm_writei(aout->pcm, aout->buf + written * aout->sample_size,
+                           aout->period - written);
+        if (r < 0) {
+            return r;
+        }
+        written += r;
+    }
+
+    return 0;
+}
+
+static int
+run_alsa(void *data) {
+    struct sc_audio_output_alsa *aout = data;
+
+    bool ok = sc_thread_set_priority(SC_THREAD_PRIORITY_TIME_CRITICAL);
+    if (!ok) {
+        ok = sc_thread_set_priority(SC_THREAD_PRIORITY_HIGH);
+        (void) ok; // We don't care if it worked, at least we tried
+    }
+
+    while (!atomic_load_explicit(&aout->stopped, memory_order_relaxed)) {
+        snd_pcm_sframes_t avail = snd_pcm_avail_update(aout->pcm);
+        if (avail < 0) {
+            if (!sc_audio_output_alsa_recover(aout, avail)) {
+                break;
+            }
+            continue;
+        }
+
+        snd_pcm_state_t state = snd_pcm_state(aout->pcm);
+        if ((snd_pcm_uframes_t) avail < aout->period
+                && state == SND_PCM_STATE_RUNNING) {
+            // Wait until a full period can be written
+            int err = snd_pcm_wait(aout->pcm, SC_ALSA_WAIT_TIMEOUT_MS);
+            if (err < 0 && !sc_audio_output_alsa_recover(aout, err)) {
+                break;
+            }
+            continue;
+        }
+
+        int err = aout->mmap ? sc_audio_output_alsa_write_mmap(aout)
+                             : sc_audio_output_alsa_write_rw(aout);
+        if (err < 0 && !sc_audio_output_alsa_recover(aout, err)) {
+            break;
+        }
+    }
+
+    LOGD("ALSA audio thread ended");
+
+    return 0;
+}
+
+static bool
+sc_audio_output_alsa_set_hw_params(struct sc_audio_output_alsa *aout,
+                                   uint32_t sample_rate, uint8_t nb_channels,
+                                   snd_pcm_uframes_t *period) {
+    snd_pcm_hw_params_t *hw;
+    snd_pcm_hw_params_alloca(&hw);
+
+    snd_pcm_t *pcm = aout->pcm;
+    int err = snd_pcm_hw_params_any(pcm, hw);
+    if (err < 0) {
+        goto error;
+    }
+
+    aout->mmap = true;
+    err = snd_pcm_hw_params_set_access(pcm, hw,
+                                       SND_PCM_ACCESS_MMAP_INTERLEAVED);
+    if (err < 0) {
+        LOGD("ALSA: mmap access not supported, fallback to read/write");
+        aout->mmap = false;
+        err = snd_pcm_hw_params_set_access(pcm, hw,
+                                           SND_PCM_ACCESS_RW_INTERLEAVED);
+        if (err < 0) {
+            goto error;
+        }
+    }
+
+    err = snd_pcm_hw_params_set_format(pcm, hw, SND_PCM_FORMAT_FLOAT);
+    if (err < 0) {
+        goto error;
+    }
+
+    err = snd_pcm_hw_params_set_channels(pcm, hw, nb_channels);
+    if (err < 0) {
+        goto error;
+    }
+
+    // The device must play at the stream sample rate (let alsa-lib convert
+    // if the hardware does not support it)
+    err = snd_pcm_hw_params_set_rate_resample(pcm, hw, 1);
+    if (err < 0) {
+        goto error;
+    }
+    err = snd_pcm_hw_params_set_rate(pcm, hw, sample_rate, 0);
+    if (err < 0) {
+        goto error;
+    }
+
+    err = snd_pcm_hw_params_set_period_size_near(pcm, hw, period, NULL);
+    if (err < 0) {
+        goto error;
+    }
+
+    // Double buffering: one period played while the next one is written
+    snd_pcm_uframes_t buffer_size = *period * 2;
+    err = snd_pcm_hw_params_set_buffer_size_near(pcm, hw, &buffer_size);
+    if (err < 0) {
+        goto error;
+    }
+
+    err = snd_pcm_hw_params(pcm, hw);
+    if (err < 0) {
+        goto error;
+    }
+
+    return true;
+
+error:
+    LOGE("ALSA: could not configure the device: %s", snd_strerror(err));
+    return false;
+}
+
+static bool
+sc_audio_output_alsa_set_sw_params(struct sc_audio_output_alsa *aout) {
+    snd_pcm_sw_params_t *sw;
+    snd_pcm_sw_params_alloca(&sw);
+
+    snd_pcm_t *pcm = aout->pcm;
+    int err = snd_pcm_sw_params_current(pcm, sw);
+    if (err < 0) {
+        goto error;
+    }
+
+    err = snd_pcm_sw_params_set_avail_min(pcm, sw, aout->period);
+    if (err < 0) {
+        goto error;
+    }
+
+    // Start as soon as the first period is written
+    err = snd_pcm_sw_params_set_start_threshold(pcm, sw, aout->period);
+    if (err < 0) {
+        goto error;
+    }
+
+    err = snd_pcm_sw_params(pcm, sw);
+    if (err < 0) {
+        goto error;
+    }
+
+    return true;
+
+error:
+    LOGE("ALSA: could not configure the device: %s", snd_strerror(err));
+    return false;
+}
+
+static bool
+sc_audio_output_alsa_open(struct sc_audio_output *audio_output,
+                          uint32_t sample_rate, uint8_t nb_channels,
+                          uint32_t *period,
+                          const struct sc_audio_output_callbacks *cbs,
+                          void *cbs_userdata) {
+    struct sc_audio_output_alsa *aout = DOWNCAST(audio_output);
+
+    assert(cbs && cbs->on_pull);
+
+    aout->sample_size = nb_channels * sizeof(float);
+    aout->cbs = cbs;
+    aout->cbs_userdata = cbs_userdata;
+    aout->buf = NULL;
+    aout->started = false;
+
+    int err = snd_pcm_open(&aout->pcm, SC_ALSA_DEVICE,
+                           SND_PCM_STREAM_PLAYBACK, 0);
+    if (err < 0) {
+        LOGE("ALSA: could not open audio device: %s", snd_strerror(err));
+        return false;
+    }
+
+    snd_pcm_uframes_t period_size = *period;
+    if (!sc_audio_output_alsa_set_hw_params(aout, sample_rate, nb_channels,
+                                            &period_size)) {
+        goto error_close_pcm;
+    }
+    aout->period = period_size;
+
+    if (!sc_audio_output_alsa_set_sw_params(aout)) {
+        goto error_close_pcm;
+    }
+
+    if (!aout->mmap) {
+        aout->buf = malloc(aout->period * aout->sample_size);
+        if (!aout->buf) {
+            LOG_OOM();
+            goto error_close_pcm;
+        }
+    }
+
+    *period = aout->period;
+    return true;
+
+error_close_pcm:
+    snd_pcm_close(aout->pcm);
+
+    return false;
+}
+
+static bool
+sc_audio_output_alsa_start(struct sc_audio_output *audio_output) {
+    struct sc_audio_output_alsa *aout = DOWNCAST(audio_output);
+
+    atomic_init(&aout->stopped, false);
+
+    bool ok = sc_thread_create(&aout->thread, run_alsa, "scrcpy-alsa", aout);
+    if (!ok) {
+        LOGE("Could not start ALSA audio thread");
+        return false;
+    }
+
+    aout->started = true;
+    return true;
+}
+
+static void
+sc_audio_output_alsa_close(struct sc_audio_output *audio_output) {
+    struct sc_audio_output_alsa *aout = DOWNCAST(audio_output);
+
+    if (aout->started) {
+        atomic_store_explicit(&aout->stopped, true, memory_order_relaxed);
+        sc_thread_join(&aout->thread, NULL);
+    }
+
+    snd_pcm_drop(aout->pcm);
+    snd_pcm_close(aout->pcm);
+    free(aout->buf);
+}
+
+void
+sc_audio_output_alsa_init(struct sc_audio_output_alsa *aout) {
+    static const struct sc_audio_output_ops ops = {
+        .open = sc_audio_output_alsa_open,
+        .start = sc_audio_output_alsa_start,
+        .close = sc_audio_output_alsa_close,
+    };
+
+    aout->audio_output.ops = &ops;
+}
@@ -0,0 +1,36 @@
+#ifndef SC_AUDIO_OUTPUT_ALSA_H
+#define SC_AUDIO_OUTPUT_ALSA_H
+
+#include "common.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <alsa/asoundlib.h>
+
+#include "trait/audio_output.h"
+#include "util/thread.h"
+
+struct sc_audio_output_alsa {
+    struct sc_audio_output audio_output; // audio output trait
+
+    snd_pcm_t *pcm;
+    size_t sample_size;
+    snd_pcm_uframes_t period;
+
+    // If the device does not support mmap access, samples are pulled to an
+    // intermediate buffer and written by snd_pcm_writei()
+    bool mmap;
+    uint8_t *buf;
+
+    const struct sc_audio_output_callbacks *cbs;
+    void *cbs_userdata;
+
+    sc_thread thread;
+    bool started;
+    atomic_bool stopped;
+};
+
+void
+sc_audio_output_alsa_init(struct sc_audio_output_alsa *aout);
+
+#endif
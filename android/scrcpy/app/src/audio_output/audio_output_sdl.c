@@ -0,0 +1,98 @@
+#include "audio_output_sdl.h"
+
+#include <assert.h>
+#include <SDL2/SDL.h>
+
+#include "util/log.h"
+
+/** Downcast audio_output to sc_audio_output_sdl */
+#define DOWNCAST(AOUT) \
+    container_of(AOUT, struct sc_audio_output_sdl, audio_output)
+
+#define SC_SDL_SAMPLE_FMT AUDIO_F32
+
+static void SDLCALL
+sc_audio_output_sdl_callback(void *userdata, uint8_t *stream, int len_int) {
+    struct sc_audio_output_sdl *aout = userdata;
+
+    assert(len_int > 0);
+    size_t len = len_int;
+
+    assert(len % aout->sample_size == 0);
+    uint32_t out_samples = len / aout->sample_size;
+
+    aout->cbs->on_pull(stream, out_samples, aout->cbs_userdata);
+}
+
+static bool
+sc_audio_output_sdl_open(struct sc_audio_output *audio_output,
+                         uint32_t sample_rate, uint8_t nb_channels,
+                         uint32_t *period,
+                         const struct sc_audio_output_callbacks *cbs,
+                         void *cbs_userdata) {
+    struct sc_audio_output_sdl *aout = DOWNCAST(audio_output);
+
+    assert(cbs && cbs->on_pull);
+    assert(*period <= 0xFFFF);
+
+    aout->sample_size = nb_channels * sizeof(float);
+    aout->cbs = cbs;
+    aout->cbs_userdata = cbs_userdata;
+
+    SDL_AudioSpec desired = {
+        .freq = sample_rate,
+        .format = SC_SDL_SAMPLE_FMT,
+        .channels = nb_channels,
+        .samples = *period,
+        .callback = sc_audio_output_sdl_callback,
+        .userdata = aout,
+    };
+    SDL_AudioSpec obtained;
+
+    // The audio subsystem is initialized only once the device has confirmed
+    // that it captures audio: initializing the audio backend (PulseAudio,
+    // WASAPI...) is slow, and would be wasted if the audio is disabled
+    if (SDL_InitSubSystem(SDL_INIT_AUDIO)) {
+        LOGE("Could not initialize SDL audio: %s", SDL_GetError());
+        return false;
+    }
+
+    aout->device = SDL_OpenAudioDevice(NULL, 0, &desired, &obtained, 0);
+    if (!aout->device) {
+        LOGE("Could not open audio device: %s", SDL_GetError());
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+        return false;
+    }
+
+    *period = obtained.samples;
+    return true;
+}
+
+static bool
+sc_audio_output_sdl_start(struct sc_audio_output *audio_output) {
+    struct sc_audio_output_sdl *aout = DOWNCAST(audio_output);
+
+    SDL_PauseAudioDevice(aout->device, 0);
+    return true;
+}
+
+static void
+sc_audio_output_sdl_close(struct sc_audio_output *audio_output) {
+    struct sc_audio_output_sdl *aout = DOWNCAST(audio_output);
+
+    assert(aout->device);
+    SDL_PauseAudioDevice(aout->device, 1);
+    SDL_CloseAudioDevice(aout->device);
+    SDL_QuitSubSystem(SDL_INIT_AUDIO);
+}
+
+void
+sc_audio_output_sdl_init(struct sc_audio_output_sdl *aout) {
+    static const struct sc_audio_output_ops ops = {
+        .open = sc_audio_output_sdl_open,
+        .start = sc_audio_output_sdl_start,
+        .close = sc_audio_output_sdl_close,
+    };
+
+    aout->audio_output.ops = &ops;
+}
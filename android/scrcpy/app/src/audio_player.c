@@ -1,23 +1,18 @@
 #include "audio_player.h"
 
+#include <inttypes.h>
+
 #include "util/log.h"
+#include "util/thread.h"
 
 /** Downcast frame_sink to sc_audio_player */
 #define DOWNCAST(SINK) container_of(SINK, struct sc_audio_player, frame_sink)
 
-#define SC_SDL_SAMPLE_FMT AUDIO_F32
-
-static void SDLCALL
-sc_audio_player_sdl_callback(void *userdata, uint8_t *stream, int len_int) {
+static void
+sc_audio_player_on_pull(uint8_t *out, uint32_t samples, void *userdata) {
     struct sc_audio_player *ap = userdata;
 
-    assert(len_int > 0);
-    size_t len = len_int;
-
-    assert(len % ap->audioreg.sample_size == 0);
-    uint32_t out_samples = len / ap->audioreg.sample_size;
-
-    sc_audio_regulator_pull(&ap->audioreg, stream, out_samples);
+    sc_audio_regulator_pull(&ap->audioreg, out, samples);
 }
 
 static bool
@@ -46,67 +41,99 @@ sc_audio_player_frame_sink_open(struct sc_frame_sink *sink,
     assert(!av_sample_fmt_is_planar(SC_AV_SAMPLE_FMT));
     int out_bytes_per_sample = av_get_bytes_per_sample(SC_AV_SAMPLE_FMT);
     assert(out_bytes_per_sample > 0);
-
-    uint32_t target_buffering_samples =
-        ap->target_buffering_delay * ctx->sample_rate / SC_TICK_FREQ;
-
-    size_t sample_size = nb_channels * out_bytes_per_sample;
-    bool ok = sc_audio_regulator_init(&ap->audioreg, sample_size, ctx,
-                                      target_buffering_samples);
-    if (!ok) {
-        return false;
-    }
+    // The audio outputs expect 32-bit float samples
+    assert(out_bytes_per_sample == sizeof(float));
 
     uint64_t aout_samples = ap->output_buffer_duration * ctx->sample_rate
                                                        / SC_TICK_FREQ;
     assert(aout_samples <= 0xFFFF);
+    uint32_t period = aout_samples;
 
-    SDL_AudioSpec desired = {
-        .freq = ctx->sample_rate,
-        .format = SC_SDL_SAMPLE_FMT,
-        .channels = nb_channels,
-        .samples = aout_samples,
-        .callback = sc_audio_player_sdl_callback,
-        .userdata = ap,
+    static const struct sc_audio_output_callbacks cbs = {
+        .on_pull = sc_audio_player_on_pull,
     };
-    SDL_AudioSpec obtained;
 
-    ap->device = SDL_OpenAudioDevice(NULL, 0, &desired, &obtained, 0);
-    if (!ap->device) {
-        LOGE("Could not open audio device: %s", SDL_GetError());
-        sc_audio_regulator_destroy(&ap->audioreg);
+    // Open the output first, the obtained period size bounds the target
+    // buffering of the regulator
+    bool ok = ap->output->ops->open(ap->output, ctx->sample_rate, nb_channels,
+                                    &period, &cbs, ap);
+    if (!ok) {
         return false;
     }
 
+    LOGD("Audio output period: %" PRIu32 " samples (requested %" PRIu64 ")",
+         period, aout_samples);
+
+    uint32_t target_buffering_samples =
+        ap->target_buffering_delay * ctx->sample_rate / SC_TICK_FREQ;
+    if (target_buffering_samples < period) {
+        // The output pulls a full period at once: a lower target would cause
+        // an underflow on every pull
+        LOGW("Audio buffer lower than the audio output period, using %" PRIu32
+             " samples", period);
+        target_buffering_samples = period;
+    }
+
+    size_t sample_size = nb_channels * out_bytes_per_sample;
+    ok = sc_audio_regulator_init(&ap->audioreg, sample_size, ctx,
+                                 target_buffering_samples);
+    if (!ok) {
+        goto error_close_output;
+    }
+
     // The thread calling open() is the thread calling push(), which fills the
-    // audio buffer consumed by the SDL audio thread.
+    // audio buffer consumed by the audio output thread.
     ok = sc_thread_set_priority(SC_THREAD_PRIORITY_TIME_CRITICAL);
     if (!ok) {
         ok = sc_thread_set_priority(SC_THREAD_PRIORITY_HIGH);
         (void) ok; // We don't care if it worked, at least we tried
     }
 
-    SDL_PauseAudioDevice(ap->device, 0);
+    ok = ap->output->ops->start(ap->output);
+    if (!ok) {
+        goto error_destroy_audioreg;
+    }
 
     return true;
+
+error_destroy_audioreg:
+    sc_audio_regulator_destroy(&ap->audioreg);
+error_close_output:
+    ap->output->ops->close(ap->output);
+
+    return false;
 }
 
 static void
 sc_audio_player_frame_sink_close(struct sc_frame_sink *sink) {
     struct sc_audio_player *ap = DOWNCAST(sink);
 
-    assert(ap->device);
-    SDL_PauseAudioDevice(ap->device, 1);
-    SDL_CloseAudioDevice(ap->device);
+    ap->output->ops->close(ap->output);
 
     sc_audio_regulator_destroy(&ap->audioreg);
 }
 
 void
 sc_audio_player_init(struct sc_audio_player *ap, sc_tick target_buffering,
-                     sc_tick output_buffer_duration) {
+                     sc_tick output_buffer_duration,
+                     enum sc_audio_output_backend backend) {
     ap->target_buffering_delay = target_buffering;
     ap->output_buffer_duration = output_buffer_duration;
+    ap->backend = backend;
+
+    switch (backend) {
+#ifdef HAVE_ALSA
+        case SC_AUDIO_OUTPUT_BACKEND_ALSA:
+            sc_audio_output_alsa_init(&ap->outputs.alsa);
+            ap->output = &ap->outputs.alsa.audio_output;
+            break;
+#endif
+        default:
+            assert(backend == SC_AUDIO_OUTPUT_BACKEND_SDL);
+            sc_audio_output_sdl_init(&ap->outputs.sdl);
+            ap->output = &ap->outputs.sdl.audio_output;
+            break;
+    }
 
     static const struct sc_frame_sink_ops ops = {
         .open = sc_audio_player_frame_sink_open,
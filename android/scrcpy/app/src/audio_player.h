@@ -3,12 +3,17 @@
 
 #include "common.h"
 
-#include <SDL2/SDL_audio.h>
-
+#include "audio_output/audio_output_sdl.h"
 #include "audio_regulator.h"
+#include "options.h"
+#include "trait/audio_output.h"
 #include "trait/frame_sink.h"
 #include "util/tick.h"
 
+#ifdef HAVE_ALSA
+# include "audio_output/audio_output_alsa.h"
+#endif
+
 struct sc_audio_player {
     struct sc_frame_sink frame_sink;
 
@@ -19,15 +24,24 @@ struct sc_audio_player {
     // value should be higher.
     sc_tick target_buffering_delay;
 
-    // SDL audio output buffer size
+    // Audio output buffer (period) size
     sc_tick output_buffer_duration;
 
-    SDL_AudioDeviceID device;
+    enum sc_audio_output_backend backend;
+    union {
+        struct sc_audio_output_sdl sdl;
+#ifdef HAVE_ALSA
+        struct sc_audio_output_alsa alsa;
+#endif
+    } outputs;
+    struct sc_audio_output *output; // points to the selected backend
+
     struct sc_audio_regulator audioreg;
 };
 
 void
 sc_audio_player_init(struct sc_audio_player *ap, sc_tick target_buffering,
-                     sc_tick audio_output_buffer);
+                     sc_tick audio_output_buffer,
+                     enum sc_audio_output_backend backend);
 
 #endif
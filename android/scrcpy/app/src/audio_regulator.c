@@ -7,6 +7,7 @@
 #include <libavcodec/avcodec.h>
 #include <libavutil/opt.h>
 
+#include "stats.h"
 #include "util/log.h"
 
 //#define SC_AUDIO_REGULATOR_DEBUG // uncomment to debug
@@ -34,8 +35,10 @@
  * requested by the audio player). Therefore, it may only apply compensation by
  * resampling (converting _m_ input samples to _n_ output samples).
  *
- * The compensation itself is applied by libswresample (FFmpeg). It is
- * configured using swr_set_compensation(). An important work for the regulator
+ * The compensation itself is applied by libswresample (FFmpeg), configured
+ * using swr_set_compensation(), or by a lightweight resampler with the same
+ * semantics if the decoded samples are already 32-bit float (which is the case
+ * for OPUS and AAC). An important work for the regulator
  * is to estimate the compensation value regularly and apply it.
  *
  * The estimated buffering level is the result of averaging the "natural"
@@ -66,9 +69,19 @@ sc_audio_regulator_pull(struct sc_audio_regulator *ar, uint8_t *out,
     LOGD("[Audio] Audio regulator pulls %" PRIu32 " samples", out_samples);
 #endif
 
-    // A lock is necessary in the rare case where the producer needs to drop
-    // samples already pushed (when the buffer is full)
-    sc_mutex_lock(&ar->mutex);
+    // Drop the old samples the producer requested to skip. The counter is
+    // decremented only after the reader cursor has moved, and only by the
+    // number of samples actually dropped (the remaining ones will be dropped
+    // on the next pull), so that the producer never underestimates the number
+    // of samples to be played.
+    uint32_t skip = atomic_load_explicit(&ar->skip, memory_order_acquire);
+    if (skip) {
+        uint32_t skipped = sc_audiobuf_read(&ar->buf, NULL, skip);
+        if (skipped) {
+            atomic_fetch_sub_explicit(&ar->skip, skipped,
+                                      memory_order_release);
+        }
+    }
 
     bool played = atomic_load_explicit(&ar->played, memory_order_relaxed);
     if (!played) {
@@ -84,14 +97,17 @@ sc_audio_regulator_pull(struct sc_audio_regulator *ar, uint8_t *out,
             // whole buffer with silence (len is small compared to the
             // arbitrary margin value).
             memset(out, 0, out_samples * ar->sample_size);
-            sc_mutex_unlock(&ar->mutex);
             return;
         }
     }
 
-    uint32_t read = sc_audiobuf_read(&ar->buf, out, out_samples);
-
-    sc_mutex_unlock(&ar->mutex);
+    // Copy directly from the ring buffer regions to the output
+    struct sc_audiobuf_spans spans;
+    uint32_t read = sc_audiobuf_get_read_spans(&ar->buf, &spans, out_samples);
+    memcpy(out, spans.data[0], TO_BYTES(spans.count[0]));
+    memcpy(out + TO_BYTES(spans.count[0]), spans.data[1],
+           TO_BYTES(spans.count[1]));
+    sc_audiobuf_advance_read(&ar->buf, read);
 
     if (read < out_samples) {
         uint32_t silence = out_samples - read;
@@ -112,12 +128,22 @@ sc_audio_regulator_pull(struct sc_audio_regulator *ar, uint8_t *out,
             // Inserting additional samples immediately increases buffering
             atomic_fetch_add_explicit(&ar->underflow, silence,
                                       memory_order_relaxed);
+            sc_stats_add(SC_STATS_AUDIO_UNDERFLOW_SAMPLES, silence);
         }
     }
 
     atomic_store_explicit(&ar->played, true, memory_order_relaxed);
 }
 
+static uint32_t
+sc_audio_regulator_get_buffered(struct sc_audio_regulator *ar) {
+    // Load the pending skip before the cursors (see
+    // sc_audio_regulator_pull())
+    uint32_t skip = atomic_load_explicit(&ar->skip, memory_order_acquire);
+    uint32_t can_read = sc_audiobuf_can_read(&ar->buf);
+    return can_read > skip ? can_read - skip : 0;
+}
+
 static uint8_t *
 sc_audio_regulator_get_swr_buf(struct sc_audio_regulator *ar,
                                uint32_t min_samples) {
@@ -137,10 +163,105 @@ sc_audio_regulator_get_swr_buf(struct sc_audio_regulator *ar,
     return ar->swr_buf;
 }
 
+static int
+sc_audio_regulator_set_compensation(struct sc_audio_regulator *ar, int diff,
+                                    int distance) {
+    if (ar->use_resampler) {
+        bool ok = sc_resampler_set_compensation(&ar->resampler, diff,
+                                                distance);
+        return ok ? 0 : AVERROR(EINVAL);
+    }
+
+    return swr_set_compensation(ar->swr_ctx, diff, distance);
+}
+
+static bool
+sc_audio_regulator_convert_swr(struct sc_audio_regulator *ar,
+                               const AVFrame *frame, uint32_t *produced,
+                               uint32_t *skipped) {
+    int64_t swr_delay = swr_get_delay(ar->swr_ctx, ar->sample_rate);
+    // No need to av_rescale_rnd(), input and output sample rates are the same.
+    // Add more space (256) for clock compensation.
+    int dst_nb_samples = swr_delay + frame->nb_samples + 256;
+
+    uint8_t *swr_buf = sc_audio_regulator_get_swr_buf(ar, dst_nb_samples);
+    if (!swr_buf) {
+        return false;
+    }
+
+    int ret = swr_convert(ar->swr_ctx, &swr_buf, dst_nb_samples,
+                          (const uint8_t **) frame->data, frame->nb_samples);
+    if (ret < 0) {
+        LOGE("Resampling failed: %d", ret);
+        return false;
+    }
+
+    // swr_convert() returns the number of samples which would have been
+    // written if the buffer was big enough.
+    uint32_t samples = MIN(ret, dst_nb_samples);
+#ifdef SC_AUDIO_REGULATOR_DEBUG
+    LOGD("[Audio] %" PRIu32 " samples written to buffer", samples);
+#endif
+
+    *produced = samples;
+    *skipped = 0;
+
+    uint32_t can_write = sc_audiobuf_can_write(&ar->buf);
+    if (samples > can_write) {
+        // Very very unlikely: the audio buffer is 1 second larger than the
+        // target buffering. Old samples may only be dropped by the consumer,
+        // so drop the first new samples instead.
+        *skipped = samples - can_write;
+        swr_buf += TO_BYTES(*skipped);
+        samples = can_write;
+    }
+
+    uint32_t written = sc_audiobuf_write(&ar->buf, swr_buf, samples);
+    assert(written == samples);
+    (void) written;
+
+    return true;
+}
+
+static bool
+sc_audio_regulator_resample(struct sc_audio_regulator *ar,
+                            const AVFrame *frame, uint32_t *produced) {
+    // Resample directly into the audio buffer, without intermediate buffer
+    struct sc_audiobuf_spans spans;
+    sc_audiobuf_get_write_spans(&ar->buf, &spans, UINT32_MAX);
+
+    const float *const *in = (const float *const *) frame->data;
+    int32_t r = sc_resampler_process(&ar->resampler, (float *) spans.data[0],
+                                     spans.count[0], in, ar->planar,
+                                     frame->nb_samples);
+    if (r < 0) {
+        return false;
+    }
+
+    uint32_t samples = r;
+    if (samples == spans.count[0] && spans.count[1]) {
+        // Continue at the beginning of the ring buffer (with the frames
+        // already passed to the resampler)
+        r = sc_resampler_process(&ar->resampler, (float *) spans.data[1],
+                                 spans.count[1], NULL, ar->planar, 0);
+        assert(r >= 0); // no input, so no allocation
+        samples += r;
+    }
+
+    // If the buffer is full (very very unlikely), the remaining frames are
+    // kept by the resampler for the next call
+#ifdef SC_AUDIO_REGULATOR_DEBUG
+    LOGD("[Audio] %" PRIu32 " samples written to buffer", samples);
+#endif
+
+    sc_audiobuf_advance_write(&ar->buf, samples);
+    *produced = samples;
+
+    return true;
+}
+
 bool
 sc_audio_regulator_push(struct sc_audio_regulator *ar, const AVFrame *frame) {
-    SwrContext *swr_ctx = ar->swr_ctx;
-
     uint32_t input_samples = frame->nb_samples;
 
     assert(frame->pts >= 0);
@@ -150,7 +271,7 @@ sc_audio_regulator_push(struct sc_audio_regulator *ar, const AVFrame *frame) {
              pts - ar->next_expected_pts);
         // More than 100ms: consider it as a discontinuity
         // (typically because silence packets were not captured)
-        uint32_t can_read = sc_audiobuf_can_read(&ar->buf);
+        uint32_t can_read = sc_audio_regulator_get_buffered(ar);
         if (input_samples + can_read < ar->target_buffering) {
             // Adjust buffering to the target value directly
             uint32_t silence = ar->target_buffering - can_read - input_samples;
@@ -159,7 +280,7 @@ sc_audio_regulator_push(struct sc_audio_regulator *ar, const AVFrame *frame) {
 
         // Reset state
         ar->avg_buffering.avg = ar->target_buffering;
-        int ret = swr_set_compensation(swr_ctx, 0, 0);
+        int ret = sc_audio_regulator_set_compensation(ar, 0, 0);
         (void) ret;
         assert(!ret); // disabling compensation should never fail
         ar->compensation_active = false;
@@ -171,70 +292,16 @@ sc_audio_regulator_push(struct sc_audio_regulator *ar, const AVFrame *frame) {
                             / ar->sample_rate;
     ar->next_expected_pts = pts + packet_duration;
 
-    int64_t swr_delay = swr_get_delay(swr_ctx, ar->sample_rate);
-    // No need to av_rescale_rnd(), input and output sample rates are the same.
-    // Add more space (256) for clock compensation.
-    int dst_nb_samples = swr_delay + frame->nb_samples + 256;
-
-    uint8_t *swr_buf = sc_audio_regulator_get_swr_buf(ar, dst_nb_samples);
-    if (!swr_buf) {
-        return false;
-    }
-
-    int ret = swr_convert(swr_ctx, &swr_buf, dst_nb_samples,
-                          (const uint8_t **) frame->data, frame->nb_samples);
-    if (ret < 0) {
-        LOGE("Resampling failed: %d", ret);
-        return false;
-    }
-
-    // swr_convert() returns the number of samples which would have been
-    // written if the buffer was big enough.
-    uint32_t samples = MIN(ret, dst_nb_samples);
-#ifdef SC_AUDIO_REGULATOR_DEBUG
-    LOGD("[Audio] %" PRIu32 " samples written to buffer", samples);
-#endif
-
-    uint32_t cap = sc_audiobuf_capacity(&ar->buf);
-    if (samples > cap) {
-        // Very very unlikely: a single resampled frame should never
-        // exceed the audio buffer size (or something is very wrong).
-        // Ignore the first bytes in swr_buf to avoid memory corruption anyway.
-        swr_buf += TO_BYTES(samples - cap);
-        samples = cap;
-    }
-
+    // Samples produced by the resampler (for compensation)
+    uint32_t produced;
     uint32_t skipped_samples = 0;
 
-    uint32_t written = sc_audiobuf_write(&ar->buf, swr_buf, samples);
-    if (written < samples) {
-        uint32_t remaining = samples - written;
-
-        // All samples that could be written without locking have been written,
-        // now we need to lock to drop/consume old samples
-        sc_mutex_lock(&ar->mutex);
-
-        // Retry with the lock
-        written += sc_audiobuf_write(&ar->buf,
-                                     swr_buf + TO_BYTES(written),
-                                     remaining);
-        if (written < samples) {
-            remaining = samples - written;
-            // Still insufficient, drop old samples to make space
-            skipped_samples = sc_audiobuf_read(&ar->buf, NULL, remaining);
-            assert(skipped_samples == remaining);
-        }
-
-        sc_mutex_unlock(&ar->mutex);
-
-        if (written < samples) {
-            // Now there is enough space
-            uint32_t w = sc_audiobuf_write(&ar->buf,
-                                           swr_buf + TO_BYTES(written),
-                                           remaining);
-            assert(w == remaining);
-            (void) w;
-        }
+    bool ok = ar->use_resampler
+            ? sc_audio_regulator_resample(ar, frame, &produced)
+            : sc_audio_regulator_convert_swr(ar, frame, &produced,
+                                             &skipped_samples);
+    if (!ok) {
+        return false;
     }
 
     uint32_t underflow = 0;
@@ -255,31 +322,22 @@ sc_audio_regulator_push(struct sc_audio_regulator *ar, const AVFrame *frame) {
                              + 10 * ar->sample_rate / 1000 /* 10 ms */;
     }
 
-    uint32_t can_read = sc_audiobuf_can_read(&ar->buf);
+    uint32_t can_read = sc_audio_regulator_get_buffered(ar);
     if (can_read > max_buffered_samples) {
-        uint32_t skip_samples = 0;
-
-        sc_mutex_lock(&ar->mutex);
-        can_read = sc_audiobuf_can_read(&ar->buf);
-        if (can_read > max_buffered_samples) {
-            skip_samples = can_read - max_buffered_samples;
-            uint32_t r = sc_audiobuf_read(&ar->buf, NULL, skip_samples);
-            assert(r == skip_samples);
-            (void) r;
-            skipped_samples += skip_samples;
-        }
-        sc_mutex_unlock(&ar->mutex);
-
-        if (skip_samples) {
-            if (played) {
-                LOGD("[Audio] Buffering threshold exceeded, skipping %" PRIu32
-                     " samples", skip_samples);
+        // Request the consumer to drop the excess of old samples
+        uint32_t skip_samples = can_read - max_buffered_samples;
+        atomic_fetch_add_explicit(&ar->skip, skip_samples,
+                                  memory_order_relaxed);
+        skipped_samples += skip_samples;
+
+        if (played) {
+            LOGD("[Audio] Buffering threshold exceeded, skipping %" PRIu32
+                 " samples", skip_samples);
 #ifdef SC_AUDIO_REGULATOR_DEBUG
-            } else {
-                LOGD("[Audio] Playback not started, skipping %" PRIu32
-                     " samples", skip_samples);
+        } else {
+            LOGD("[Audio] Playback not started, skipping %" PRIu32
+                 " samples", skip_samples);
 #endif
-            }
         }
     }
 
@@ -290,7 +348,7 @@ sc_audio_regulator_push(struct sc_audio_regulator *ar, const AVFrame *frame) {
     }
 
     // Number of samples added (or removed, if negative) for compensation
-    int32_t instant_compensation = (int32_t) written - input_samples;
+    int32_t instant_compensation = (int32_t) produced - input_samples;
     // Inserting silence instantly increases buffering
     int32_t inserted_silence = (int32_t) underflow;
     // Dropping input samples instantly decreases buffering
@@ -317,7 +375,7 @@ sc_audio_regulator_push(struct sc_audio_regulator *ar, const AVFrame *frame) {
          can_read, sc_average_get(&ar->avg_buffering));
 #endif
 
-    ar->samples_since_resync += written;
+    ar->samples_since_resync += produced;
     if (ar->samples_since_resync >= ar->sample_rate) {
         // Recompute compensation every second
         ar->samples_since_resync = 0;
@@ -350,7 +408,7 @@ sc_audio_regulator_push(struct sc_audio_regulator *ar, const AVFrame *frame) {
              ar->target_buffering, avg, can_read, diff, ar->underflow_report);
         ar->underflow_report = 0;
 
-        int ret = swr_set_compensation(swr_ctx, diff, distance);
+        int ret = sc_audio_regulator_set_compensation(ar, diff, distance);
         if (ret < 0) {
             LOGW("Resampling compensation failed: %d", ret);
             // not fatal
@@ -362,9 +420,9 @@ sc_audio_regulator_push(struct sc_audio_regulator *ar, const AVFrame *frame) {
     return true;
 }
 
-bool
-sc_audio_regulator_init(struct sc_audio_regulator *ar, size_t sample_size,
-                        const AVCodecContext *ctx, uint32_t target_buffering) {
+static bool
+sc_audio_regulator_init_swr(struct sc_audio_regulator *ar,
+                            const AVCodecContext *ctx) {
     SwrContext *swr_ctx = swr_alloc();
     if (!swr_ctx) {
         LOG_OOM();
@@ -391,12 +449,46 @@ sc_audio_regulator_init(struct sc_audio_regulator *ar, size_t sample_size,
     int ret = swr_init(swr_ctx);
     if (ret) {
         LOGE("Failed to initialize the resampling context");
-        goto error_free_swr_ctx;
+        swr_free(&ar->swr_ctx);
+        return false;
+    }
+
+    return true;
+}
+
+static void
+sc_audio_regulator_destroy_resampling(struct sc_audio_regulator *ar) {
+    if (ar->use_resampler) {
+        sc_resampler_destroy(&ar->resampler);
+    } else {
+        swr_free(&ar->swr_ctx);
     }
+}
 
-    bool ok = sc_mutex_init(&ar->mutex);
+bool
+sc_audio_regulator_init(struct sc_audio_regulator *ar, size_t sample_size,
+                        const AVCodecContext *ctx, uint32_t target_buffering) {
+    static_assert(SC_AV_SAMPLE_FMT == AV_SAMPLE_FMT_FLT,
+                  "The lightweight resampler outputs interleaved float");
+
+    // The lightweight resampler only compensates the clock drift, it does not
+    // convert the format
+    ar->use_resampler = ctx->sample_fmt == AV_SAMPLE_FMT_FLT
+                     || ctx->sample_fmt == AV_SAMPLE_FMT_FLTP;
+    bool ok;
+    if (ar->use_resampler) {
+        ar->swr_ctx = NULL;
+        ar->planar = ctx->sample_fmt == AV_SAMPLE_FMT_FLTP;
+        ok = sc_resampler_init(&ar->resampler, sample_size / sizeof(float));
+        if (ok) {
+            LOGD("[Audio] Using the lightweight resampler (%s)",
+                 ar->resampler.impl_name);
+        }
+    } else {
+        ok = sc_audio_regulator_init_swr(ar, ctx);
+    }
     if (!ok) {
-        goto error_free_swr_ctx;
+        return false;
     }
 
     ar->target_buffering = target_buffering;
@@ -404,14 +496,14 @@ sc_audio_regulator_init(struct sc_audio_regulator *ar, size_t sample_size,
     ar->sample_rate = ctx->sample_rate;
 
     // Use a ring-buffer of the target buffering size plus 1 second between the
-    // producer and the consumer. It's too big on purpose, to guarantee that
-    // the producer and the consumer will be able to access it in parallel
-    // without locking.
+    // producer and the consumer. It's too big on purpose, so that it is
+    // practically never full (the producer requests the consumer to drop old
+    // samples well before).
     uint32_t audiobuf_samples = target_buffering + ar->sample_rate;
 
     ok = sc_audiobuf_init(&ar->buf, sample_size, audiobuf_samples);
     if (!ok) {
-        goto error_destroy_mutex;
+        goto error_destroy_resampling;
     }
 
     size_t initial_swr_buf_size = TO_BYTES(4096);
@@ -431,6 +523,7 @@ sc_audio_regulator_init(struct sc_audio_regulator *ar, size_t sample_size,
     atomic_init(&ar->played, false);
     atomic_init(&ar->received, false);
     atomic_init(&ar->underflow, 0);
+    atomic_init(&ar->skip, 0);
     ar->underflow_report = 0;
     ar->compensation_active = false;
     ar->next_expected_pts = 0;
@@ -439,10 +532,8 @@ sc_audio_regulator_init(struct sc_audio_regulator *ar, size_t sample_size,
 
 error_destroy_audiobuf:
     sc_audiobuf_destroy(&ar->buf);
-error_destroy_mutex:
-    sc_mutex_destroy(&ar->mutex);
-error_free_swr_ctx:
-    swr_free(&ar->swr_ctx);
+error_destroy_resampling:
+    sc_audio_regulator_destroy_resampling(ar);
 
     return false;
 }
@@ -451,6 +542,5 @@ void
 sc_audio_regulator_destroy(struct sc_audio_regulator *ar) {
     free(ar->swr_buf);
     sc_audiobuf_destroy(&ar->buf);
-    sc_mutex_destroy(&ar->mutex);
-    swr_free(&ar->swr_ctx);
+    sc_audio_regulator_destroy_resampling(ar);
 }
@@ -11,13 +11,11 @@
 #include <libswresample/swresample.h>
 #include "util/audiobuf.h"
 #include "util/average.h"
-#include "util/thread.h"
+#include "util/resampler.h"
 
 #define SC_AV_SAMPLE_FMT AV_SAMPLE_FMT_FLT
 
 struct sc_audio_regulator {
-    sc_mutex mutex;
-
     // Target buffering between the producer and the consumer (in samples)
     uint32_t target_buffering;
 
@@ -25,7 +23,13 @@ struct sc_audio_regulator {
     struct sc_audiobuf buf;
 
     // Resampler (only used from the receiver thread)
+    // If the input samples are already 32-bit float, the lightweight
+    // resampler is used instead of libswresample (swr_ctx is then NULL)
     struct SwrContext *swr_ctx;
+    struct sc_resampler resampler;
+    bool use_resampler;
+    // Whether the input is planar (only if use_resampler)
+    bool planar;
 
     // The sample rate is the same for input and output
     uint32_t sample_rate;
@@ -46,6 +50,10 @@ struct sc_audio_regulator {
     // Number of silence samples inserted since the last received packet
     atomic_uint_least32_t underflow;
 
+    // Number of old samples to be dropped by the consumer (only the consumer
+    // may move the reader cursor, so that the buffer needs no lock)
+    atomic_uint_least32_t skip;
+
     // Number of silence samples inserted since the last log
     uint32_t underflow_report;
 
@@ -114,6 +114,51 @@ enum {
     OPT_NO_VD_SYSTEM_DECORATIONS,
     OPT_NO_VD_DESTROY_CONTENT,
     OPT_DISPLAY_IME_POLICY,
+    OPT_VIDEO_HWACCEL,
+    OPT_DISPLAY_FRAME_SLOTS,
+    OPT_DISPLAY_FRAME_POLICY,
+    OPT_DISPLAY_PACING,
+    OPT_V4L2_DIRECT,
+    OPT_V4L2_PIXEL_FORMAT,
+    OPT_V4L2_ORIENTATION,
+    OPT_VIDEO_BUFFER_MAX,
+    OPT_AUDIO_OUTPUT_BACKEND,
+    OPT_RECORD_SEGMENT_DURATION,
+    OPT_RECORD_SEGMENT_SIZE,
+    OPT_RECORD_SEGMENT_COUNT,
+    OPT_RECORD_LOW_LATENCY,
+    OPT_RESTREAM,
+    OPT_RESTREAM_FORMAT,
+    OPT_RESUME,
+    OPT_ARCHIVE,
+    OPT_ARCHIVE_BIT_RATE,
+    OPT_ARCHIVE_DOWNSCALE,
+    OPT_ARCHIVE_ENCODER,
+    OPT_SNAPSHOT_DIR,
+    OPT_SNAPSHOT_FORMAT,
+    OPT_EXTRA_DISPLAY_ID,
+    OPT_SOCKET_PROFILE,
+    OPT_LATENCY_STATS,
+    OPT_STATS_PORT,
+    OPT_ADAPTIVE_VIDEO,
+    OPT_VIDEO_DECODER_THREADS,
+    OPT_VIDEO_DECODER_THREAD_TYPE,
+    OPT_VIDEO_DECODER_FAST,
+    OPT_RENDER_SHADER,
+    OPT_DAMAGE_TRACKING,
+    OPT_ASYNC_LOG,
+    OPT_THREAD_PROFILE,
+    OPT_THREAD_AFFINITY,
+    OPT_MATCH_DISPLAY_RATE,
+    OPT_VIDEO_DECODER_SKIP,
+    OPT_VIDEO_DECODER_RESYNC,
+    OPT_RECORD_CONTROL,
+    OPT_VIDEO_CATCH_UP,
+    OPT_RENDER_THREAD,
+    OPT_USB_TRANSPORT,
+    OPT_MEMORY_BUDGET,
+    OPT_CLIPBOARD_CHUNKS,
+    OPT_TEXT_CHUNKS,
 };
 
 struct sc_option {
@@ -150,6 +195,16 @@ struct sc_getopt_adapter {
 };
 
 static const struct sc_option options[] = {
+    {
+        .longopt_id = OPT_ADAPTIVE_VIDEO,
+        .longopt = "adaptive-video",
+        .text = "Adapt the video bit rate, then the video size, on the fly "
+                "when congestion is detected (increasing packet delay or "
+                "skipped frames), and restore them progressively once the "
+                "stream is stable.\n"
+                "The values passed to --video-bit-rate and --max-size are "
+                "the upper bounds.",
+    },
     {
         .longopt_id = OPT_ALWAYS_ON_TOP,
         .longopt = "always-on-top",
@@ -162,6 +217,50 @@ static const struct sc_option options[] = {
         .text = "Rotate the video content by a custom angle, in degrees "
                 "(clockwise).",
     },
+    {
+        .longopt_id = OPT_ARCHIVE,
+        .longopt = "archive",
+        .argdesc = "file.mp4",
+        .text = "Re-encode the video to a file at a lower bit rate (typically "
+                "for long sessions), through a hardware encoder.\n"
+                "Contrary to --record, which stores the device stream as is, "
+                "the video is decoded then encoded again.\n"
+                "The container format is determined by the file extension.\n"
+                "Also see --archive-bit-rate, --archive-downscale and "
+                "--archive-encoder.",
+    },
+    {
+        .longopt_id = OPT_ARCHIVE_BIT_RATE,
+        .longopt = "archive-bit-rate",
+        .argdesc = "value",
+        .text = "Encode the archived video (see --archive) at the given bit "
+                "rate, expressed in bits/s. Unit suffixes are supported: "
+                "'K' (x1000) and 'M' (x1000000).\n"
+                "Default is 2M (2000000).",
+    },
+    {
+        .longopt_id = OPT_ARCHIVE_DOWNSCALE,
+        .longopt = "archive-downscale",
+        .text = "Downscale the archived video (see --archive) by 2 in both "
+                "dimensions.",
+    },
+    {
+        .longopt_id = OPT_ARCHIVE_ENCODER,
+        .longopt = "archive-encoder",
+        .argdesc = "name",
+        .text = "Use a specific FFmpeg encoder for --archive (e.g. "
+                "hevc_vaapi, h264_nvenc or libx264).\n"
+                "By default, the first available hardware encoder among "
+                "NVENC, QSV and VAAPI is used, for H.265 then H.264.",
+    },
+    {
+        .longopt_id = OPT_ASYNC_LOG,
+        .longopt = "async-log",
+        .text = "Write the logs to the console from a separate thread, so "
+                "that verbose logs do not slow down the other threads.\n"
+                "If too many messages are logged, some verbose, debug or "
+                "info messages may be dropped.",
+    },
     {
         .longopt_id = OPT_AUDIO_BIT_RATE,
         .longopt = "audio-bit-rate",
@@ -244,11 +343,22 @@ static const struct sc_option options[] = {
                 "microphone and the device playback.\n"
                 "Default is output.",
     },
+    {
+        .longopt_id = OPT_AUDIO_OUTPUT_BACKEND,
+        .longopt = "audio-output-backend",
+        .argdesc = "value",
+        .text = "Select the audio output backend.\n"
+                "Possible values are \"sdl\" and \"alsa\" (Linux only).\n"
+                "The ALSA backend writes the samples directly to the device "
+                "buffer (mmap), from a real-time thread, for a lower "
+                "latency.\n"
+                "Default is sdl.",
+    },
     {
         .longopt_id = OPT_AUDIO_OUTPUT_BUFFER,
         .longopt = "audio-output-buffer",
         .argdesc = "ms",
-        .text = "Configure the size of the SDL audio output buffer (in "
+        .text = "Configure the size of the audio output buffer (in "
                 "milliseconds).\n"
                 "If you get \"robotic\" audio playback, you should test with "
                 "a higher value (10). Do not change this setting otherwise.\n"
@@ -330,6 +440,15 @@ static const struct sc_option options[] = {
                 "initial device orientation.\n"
                 "Default is 0.",
     },
+    {
+        .longopt_id = OPT_CLIPBOARD_CHUNKS,
+        .longopt = "clipboard-chunks",
+        .text = "Send the clipboard texts larger than 4 KiB in chunks, one at "
+                "a time between the other control messages, so that they do "
+                "not delay the input events.\n"
+                "This requires a server supporting chunked clipboard "
+                "messages.",
+    },
     {
         // Not really deprecated (--codec has never been released), but without
         // declaring an explicit --codec option, getopt_long() partial matching
@@ -353,6 +472,16 @@ static const struct sc_option options[] = {
                 "The values are expressed in the device natural orientation "
                 "(typically, portrait for a phone, landscape for a tablet).",
     },
+    {
+        .longopt_id = OPT_DAMAGE_TRACKING,
+        .longopt = "damage-tracking",
+        .text = "Compare each video frame with the previous one by tiles, and "
+                "upload only the regions which changed to the GPU.\n"
+                "This reduces the memory bandwidth when only small parts of "
+                "the device screen change, at the cost of some CPU time to "
+                "hash the frames.\n"
+                "It has no effect with --render-shader.",
+    },
     {
         .shortopt = 'd',
         .longopt = "select-usb",
@@ -385,6 +514,28 @@ static const struct sc_option options[] = {
                 "    scrcpy --list-displays\n"
                 "Default is 0.",
     },
+    {
+        .longopt_id = OPT_DISPLAY_FRAME_POLICY,
+        .longopt = "display-frame-policy",
+        .argdesc = "value",
+        .text = "Select how pending frames are displayed when "
+                "--display-frame-slots is greater than 1.\n"
+                "Possible values are \"fifo\" (display every frame in order) "
+                "and \"newest-spare\" (drop stale frames, keeping at most one "
+                "spare frame to absorb rendering stalls).\n"
+                "Default is fifo.",
+    },
+    {
+        .longopt_id = OPT_DISPLAY_FRAME_SLOTS,
+        .longopt = "display-frame-slots",
+        .argdesc = "n",
+        .text = "Set the number of decoded frames which may be pending for "
+                "display (between 1 and " STR(SC_DISPLAY_FRAME_SLOTS_MAX) ").\n"
+                "With 1 slot, a frame not displayed yet is replaced by the "
+                "next one (lowest latency). More slots make frame pacing "
+                "smoother if the rendering stalls for a few milliseconds.\n"
+                "Default is 1.",
+    },
     {
         .longopt_id = OPT_DISPLAY_IME_POLICY,
         .longopt = "display-ime-policy",
@@ -409,6 +560,16 @@ static const struct sc_option options[] = {
                 "before the rotation.\n"
                 "Default is 0.",
     },
+    {
+        .longopt_id = OPT_DISPLAY_PACING,
+        .longopt = "display-pacing",
+        .text = "Schedule the presentation of each frame on the vblank of the "
+                "computer display, according to the device frame cadence "
+                "(estimated from the timestamps), instead of rendering it as "
+                "soon as it is decoded.\n"
+                "This reduces judder, at the cost of up to one refresh period "
+                "of latency. It enables vsync on the renderer.",
+    },
     {
         .shortopt = 'e',
         .longopt = "select-tcpip",
@@ -421,6 +582,18 @@ static const struct sc_option options[] = {
         .longopt = "encoder",
         .argdesc = "name",
     },
+    {
+        .longopt_id = OPT_EXTRA_DISPLAY_ID,
+        .longopt = "extra-display-id",
+        .argdesc = "id",
+        .text = "Also mirror the given device display in a second window, "
+                "from the same server instance (the adb tunnel, the control "
+                "channel and the device connection are shared).\n"
+                "The second window is view-only: the input events are "
+                "always injected to the main display (see --display-id).\n"
+                "The available display ids can be listed by:\n"
+                "    scrcpy --list-displays",
+    },
     {
         .shortopt = 'f',
         .longopt = "fullscreen",
@@ -498,6 +671,16 @@ static const struct sc_option options[] = {
         .longopt_id = OPT_HID_KEYBOARD_DEPRECATED,
         .longopt = "hid-keyboard",
     },
+    {
+        .longopt_id = OPT_LATENCY_STATS,
+        .longopt = "latency-stats",
+        .argdesc = "file",
+        .optional_arg = true,
+        .text = "Measure the latency of each stage of the video pipeline "
+                "(demuxing, decoding, uploading and presenting the frames).\n"
+                "The statistics are printed on exit and with MOD+Shift+i. If "
+                "a file is provided, they are appended to this file instead.",
+    },
     {
         .longopt_id = OPT_LEGACY_PASTE,
         .longopt = "legacy-paste",
@@ -537,6 +720,17 @@ static const struct sc_option options[] = {
         .longopt = "lock-video-orientation",
         .argdesc = "value",
     },
+    {
+        .longopt_id = OPT_MATCH_DISPLAY_RATE,
+        .longopt = "match-display-rate",
+        .text = "Ask the device to limit the encoder frame rate to the "
+                "refresh rate of the computer display showing the window "
+                "(updated when the window moves to another display), so that "
+                "no frame is encoded, transmitted and decoded only to be "
+                "skipped.\n"
+                "This requires a server supporting the SET_MAX_FPS control "
+                "message.",
+    },
     {
         .shortopt = 'm',
         .longopt = "max-size",
@@ -563,6 +757,19 @@ static const struct sc_option options[] = {
         .text = "Limit the frame rate of screen capture (officially supported "
                 "since Android 10, but may work on earlier versions).",
     },
+    {
+        .longopt_id = OPT_MEMORY_BUDGET,
+        .longopt = "memory-budget",
+        .argdesc = "MiB",
+        .text = "Limit the memory used to buffer data which could not be "
+                "consumed in time (control messages, recorded packets and "
+                "delayed frames).\n"
+                "Once exceeded, the droppable control messages (e.g. mouse "
+                "motion) are dropped, the other ones are kept beyond the "
+                "limit, the recorder drops the video packets until the next "
+                "key frame, and the delay buffer drops its oldest frames.\n"
+                "Default is 0 (unlimited).",
+    },
     {
         .longopt_id = OPT_MOUSE,
         .longopt = "mouse",
@@ -808,6 +1015,14 @@ static const struct sc_option options[] = {
         .longopt = "raw-key-events",
         .text = "Inject key events for all input keys, and ignore text events."
     },
+    {
+        .longopt_id = OPT_RECORD_CONTROL,
+        .longopt = "record-control",
+        .argdesc = "file",
+        .text = "Record the control messages sent to the device, with their "
+                "timestamps, to replay them later (for example to measure "
+                "the input throughput).",
+    },
     {
         .longopt_id = OPT_RECORD_FORMAT,
         .longopt = "record-format",
@@ -815,6 +1030,15 @@ static const struct sc_option options[] = {
         .text = "Force recording format (mp4, mkv, m4a, mka, opus, aac, flac "
                 "or wav).",
     },
+    {
+        .longopt_id = OPT_RECORD_LOW_LATENCY,
+        .longopt = "record-low-latency",
+        .text = "Write each video packet as soon as it is received (instead of "
+                "waiting for the next one to know its duration), and produce "
+                "a streamable output (fragmented MP4 or live Matroska).\n"
+                "This is useful to record to a pipe or a FIFO for live "
+                "restreaming.",
+    },
     {
         .longopt_id = OPT_RECORD_ORIENTATION,
         .longopt = "record-orientation",
@@ -824,6 +1048,35 @@ static const struct sc_option options[] = {
                 "the clockwise rotation in degrees.\n"
                 "Default is 0.",
     },
+    {
+        .longopt_id = OPT_RECORD_SEGMENT_COUNT,
+        .longopt = "record-segment-count",
+        .argdesc = "n",
+        .text = "Only keep the last n segments of a segmented recording (see "
+                "--record-segment-duration and --record-segment-size), older "
+                "segments are deleted.\n"
+                "For example, with --record-segment-duration=60, the value 60 "
+                "keeps the last hour.\n"
+                "Default is 0 (keep all segments).",
+    },
+    {
+        .longopt_id = OPT_RECORD_SEGMENT_DURATION,
+        .longopt = "record-segment-duration",
+        .argdesc = "seconds",
+        .text = "Split the recording into several files, starting a new file "
+                "on the first key frame after the given duration.\n"
+                "The segment index is inserted before the file extension "
+                "(e.g. file-00000.mp4, file-00001.mp4...).\n"
+                "Default is 0 (disabled).",
+    },
+    {
+        .longopt_id = OPT_RECORD_SEGMENT_SIZE,
+        .longopt = "record-segment-size",
+        .argdesc = "MiB",
+        .text = "Split the recording into several files, starting a new file "
+                "on the first key frame after the given file size (in MiB).\n"
+                "Default is 0 (disabled).",
+    },
     {
         .longopt_id = OPT_RENDER_DRIVER,
         .longopt = "render-driver",
@@ -834,6 +1087,25 @@ static const struct sc_option options[] = {
                 "\"opengles2\", \"opengles\", \"metal\" and \"software\".\n"
                 "<https://wiki.libsdl.org/SDL_HINT_RENDER_DRIVER>",
     },
+    {
+        .longopt_id = OPT_RENDER_SHADER,
+        .longopt = "render-shader",
+        .text = "Render the video with a custom OpenGL shader, which converts "
+                "the YUV frames to RGB and scales them (with a bicubic filter) "
+                "in a single pass, instead of generating mipmaps on every "
+                "frame.\n"
+                "It requires an OpenGL renderer (see --render-driver) with "
+                "OpenGL 3.0+ or OpenGL ES 3.0+, otherwise the default "
+                "rendering is used.",
+    },
+    {
+        .longopt_id = OPT_RENDER_THREAD,
+        .longopt = "render-thread",
+        .text = "Upload and present the video frames from a dedicated thread "
+                "instead of the event loop, so that window drags, resizing "
+                "and input processing do not delay the frames.\n"
+                "It is not supported on macOS, nor with --display-pacing.",
+    },
     {
         .longopt_id = OPT_REQUIRE_AUDIO,
         .longopt = "require-audio",
@@ -841,6 +1113,35 @@ static const struct sc_option options[] = {
                 "fails on the device. This option makes scrcpy fail if audio "
                 "is enabled but does not work."
     },
+    {
+        .longopt_id = OPT_RESTREAM,
+        .longopt = "restream",
+        .argdesc = "url",
+        .text = "Mux the video and audio streams (without decoding them) to "
+                "the given URL, for live restreaming (e.g. "
+                "udp://192.168.1.2:5000 or tcp://host:1234).\n"
+                "The supported protocols depend on the FFmpeg build.\n"
+                "If the network does not keep up, packets are dropped until "
+                "the next video key frame.",
+    },
+    {
+        .longopt_id = OPT_RESTREAM_FORMAT,
+        .longopt = "restream-format",
+        .argdesc = "format",
+        .text = "Set the restreaming container format (mpegts or mp4). MP4 is "
+                "written fragmented.\n"
+                "Default is mpegts.",
+    },
+    {
+        .longopt_id = OPT_RESUME,
+        .longopt = "resume",
+        .text = "Keep the adb tunnel open to resume the session when the "
+                "device connection is lost transiently (e.g. a Wi-Fi drop "
+                "with --tcpip): the sockets are reconnected and a new key "
+                "frame is requested, while the window and the decoders are "
+                "kept.\n"
+                "The server process must still be running on the device.",
+    },
     {
         // deprecated
         .longopt_id = OPT_ROTATION,
@@ -900,6 +1201,48 @@ static const struct sc_option options[] = {
                 "on exit.\n"
                 "It only shows physical touches (not clicks from scrcpy).",
     },
+    {
+        .longopt_id = OPT_SNAPSHOT_DIR,
+        .longopt = "snapshot-dir",
+        .argdesc = "dir",
+        .text = "Save the snapshots of the video stream (MOD+Shift+s, or "
+                "POST /snapshot on the stats server, see --stats-port) in the "
+                "given directory.\n"
+                "Default is the current directory.",
+    },
+    {
+        .longopt_id = OPT_SNAPSHOT_FORMAT,
+        .longopt = "snapshot-format",
+        .argdesc = "format",
+        .text = "Set the image format of the snapshots (png, jpeg or webp).\n"
+                "WebP requires an FFmpeg build with libwebp.\n"
+                "Default is png.",
+    },
+    {
+        .longopt_id = OPT_SOCKET_PROFILE,
+        .longopt = "socket-profile",
+        .argdesc = "profile",
+        .text = "Tune the video, audio and control sockets.\n"
+                "Possible values are \"default\", \"low-latency\" (mark "
+                "the packets with DSCP EF/AF41 and busy poll on read, which "
+                "uses more CPU) and \"throughput\" (larger receive buffer "
+                "for the video socket).\n"
+                "The DSCP marking only matters if the sockets are not local "
+                "(see --tunnel-host).\n"
+                "Default is default.",
+    },
+    {
+        .longopt_id = OPT_STATS_PORT,
+        .longopt = "stats-port",
+        .argdesc = "port",
+        .text = "Publish the session statistics (received bytes, rendered "
+                "and skipped frames, audio underflows, control queue depth) "
+                "over HTTP on localhost:<port>, in Prometheus format on "
+                "/metrics and in JSON on /stats.\n"
+                "A POST request to /snapshot saves a snapshot of the video "
+                "(see --snapshot-dir).\n"
+                "Default is 0 (disabled).",
+    },
     {
         .longopt_id = OPT_TCPIP,
         .longopt = "tcpip",
@@ -915,6 +1258,42 @@ static const struct sc_option options[] = {
                 "this address before starting.\n"
                 "Prefix the address with a '+' to force a reconnection.",
     },
+    {
+        .longopt_id = OPT_TEXT_CHUNKS,
+        .longopt = "text-chunks",
+        .text = "Inject the texts longer than 300 bytes (typically pasted with "
+                "--legacy-paste) in chunks, instead of truncating them.\n"
+                "This requires a server supporting chunked text messages.",
+    },
+    {
+        .longopt_id = OPT_THREAD_AFFINITY,
+        .longopt = "thread-affinity",
+        .argdesc = "role=cpus[,...]",
+        .text = "Restrict the threads of a role to a set of CPUs (Linux and "
+                "Windows only).\n"
+                "The roles are \"video\" (video demuxer and decoder), "
+                "\"audio\" (audio demuxer and decoder), \"control\" "
+                "(controller and receiver) and \"recording\" (recorder).\n"
+                "The CPUs are a single index or a range (up to 63), and the "
+                "same role may be repeated to add CPUs.\n"
+                "For example, to pin the latency-critical threads away from "
+                "the CPUs used by the recording: "
+                "--thread-affinity=video=2-3,audio=1,control=1,"
+                "recording=0",
+    },
+    {
+        .longopt_id = OPT_THREAD_PROFILE,
+        .longopt = "thread-profile",
+        .argdesc = "profile",
+        .text = "Set the scheduling policy of the threads.\n"
+                "Possible values are \"default\", \"latency\" (high "
+                "priority for the video, audio and control threads, low "
+                "priority for the recording) and \"realtime\" (like "
+                "\"latency\", but with real-time scheduling for the video "
+                "and audio threads: SCHED_FIFO on Linux if permitted, MMCSS "
+                "on Windows).\n"
+                "Default is default.",
+    },
     {
         .longopt_id = OPT_TIME_LIMIT,
         .longopt = "time-limit",
@@ -940,6 +1319,17 @@ static const struct sc_option options[] = {
                 "Default is 0 (not forced): the local port used for "
                 "establishing the tunnel will be used.",
     },
+    {
+        .longopt_id = OPT_USB_TRANSPORT,
+        .longopt = "usb-transport",
+        .text = "Transfer the video, audio and control streams over a "
+                "dedicated USB bulk interface (the device is switched to "
+                "the AOA accessory mode) instead of the adb tunnel, to "
+                "avoid the copies and the throughput limit of the adb "
+                "forwarding at high bit rates.\n"
+                "adb is still used to start the server. The device must be "
+                "connected over USB.",
+    },
     {
         .shortopt = 'v',
         .longopt = "version",
@@ -974,6 +1364,40 @@ static const struct sc_option options[] = {
                 "Default is 0 (no buffering).\n"
                 "This option is only available on Linux.",
     },
+    {
+        .longopt_id = OPT_V4L2_DIRECT,
+        .longopt = "v4l2-direct",
+        .text = "Write the frames directly to memory-mapped V4L2 buffers, "
+                "instead of re-encoding them as raw video through a muxer. "
+                "This saves a lot of copies and CPU.\n"
+                "This option is only available on Linux.",
+    },
+    {
+        .longopt_id = OPT_V4L2_ORIENTATION,
+        .longopt = "v4l2-orientation",
+        .argdesc = "value",
+        .text = "Set the orientation of the frames written to the V4L2 "
+                "device.\n"
+                "Possible values are 0, 90, 180, 270, flip0, flip90, flip180 "
+                "and flip270 (see --display-orientation). The frames are "
+                "rotated by scrcpy, since the V4L2 consumers do not handle "
+                "any rotation metadata.\n"
+                "It requires --v4l2-direct, or the yuv420p pixel format.\n"
+                "Default is 0.\n"
+                "This option is only available on Linux.",
+    },
+    {
+        .longopt_id = OPT_V4L2_PIXEL_FORMAT,
+        .longopt = "v4l2-pixel-format",
+        .argdesc = "format",
+        .text = "Select the pixel format of the frames written to the V4L2 "
+                "device.\n"
+                "Possible values are \"yuv420p\", \"nv12\" and \"yuyv\" "
+                "(the frames are converted using SIMD instructions if "
+                "available).\n"
+                "Default is yuv420p.\n"
+                "This option is only available on Linux.",
+    },
     {
         .longopt_id = OPT_VIDEO_BUFFER,
         .longopt = "video-buffer",
@@ -983,6 +1407,27 @@ static const struct sc_option options[] = {
                 "This increases latency to compensate for jitter.\n"
                 "Default is 0 (no buffering).",
     },
+    {
+        .longopt_id = OPT_VIDEO_BUFFER_MAX,
+        .longopt = "video-buffer-max",
+        .argdesc = "ms",
+        .text = "Enable adaptive video buffering: the buffering delay is "
+                "adjusted to the measured jitter, between the --video-buffer "
+                "value (the minimum) and this value (in milliseconds).\n"
+                "Default is 0 (fixed buffering delay).",
+    },
+    {
+        .longopt_id = OPT_VIDEO_CATCH_UP,
+        .longopt = "video-catch-up",
+        .argdesc = "ms",
+        .text = "When the video lags behind the device by more than this "
+                "delay (in milliseconds), for example after the device or the "
+                "connection stalled, drop the video packets until the next "
+                "key frame instead of decoding the backlog.\n"
+                "A new key frame is requested to the device if control is "
+                "enabled.\n"
+                "Default is 0 (disabled).",
+    },
     {
         .longopt_id = OPT_VIDEO_CODEC,
         .longopt = "video-codec",
@@ -1002,6 +1447,54 @@ static const struct sc_option options[] = {
                 "Android documentation: "
                 "<https://d.android.com/reference/android/media/MediaFormat>",
     },
+    {
+        .longopt_id = OPT_VIDEO_DECODER_FAST,
+        .longopt = "video-decoder-fast",
+        .text = "Allow non-spec-compliant speedup tricks in the software "
+                "video decoder (FFmpeg flags2 +fast).",
+    },
+    {
+        .longopt_id = OPT_VIDEO_DECODER_RESYNC,
+        .longopt = "video-decoder-resync",
+        .text = "On video decoding error, keep presenting the last frame and "
+                "drop the packets until the next key frame instead of "
+                "stopping.\n"
+                "A new key frame is requested to the device if control is "
+                "enabled.",
+    },
+    {
+        .longopt_id = OPT_VIDEO_DECODER_SKIP,
+        .longopt = "video-decoder-skip",
+        .text = "Drop the non-reference video frames before decoding while "
+                "the display cannot keep up (only for H.264 and H.265).\n"
+                "No other frame depends on them, so the video is not "
+                "corrupted. This also affects the frames written to the V4L2 "
+                "sink.",
+    },
+    {
+        .longopt_id = OPT_VIDEO_DECODER_THREADS,
+        .longopt = "video-decoder-threads",
+        .argdesc = "n",
+        .text = "Set the number of threads of the software video decoder "
+                "(0 for one thread per CPU core).\n"
+                "By default, a single thread is used, except for videos "
+                "larger than about 1.8 megapixels, which are decoded with "
+                "slice threading on up to 4 threads.",
+    },
+    {
+        .longopt_id = OPT_VIDEO_DECODER_THREAD_TYPE,
+        .longopt = "video-decoder-thread-type",
+        .argdesc = "type",
+        .text = "Select the threading method of the software video decoder: "
+                "\"slice\" or \"frame\".\n"
+                "Slice threading decodes parts of the same frame in parallel, "
+                "so it does not increase latency, but it only helps if the "
+                "encoder produces several slices (or tiles) per frame.\n"
+                "Frame threading decodes several frames in parallel, which "
+                "scales better, but delays each frame by (threads - 1) "
+                "frames (e.g. +50ms with 4 threads at 60 fps).\n"
+                "Default is slice.",
+    },
     {
         .longopt_id = OPT_VIDEO_ENCODER,
         .longopt = "video-encoder",
@@ -1010,6 +1503,16 @@ static const struct sc_option options[] = {
                 "codec provided by --video-codec).\n"
                 "The available encoders can be listed by --list-encoders.",
     },
+    {
+        .longopt_id = OPT_VIDEO_HWACCEL,
+        .longopt = "video-hwaccel",
+        .argdesc = "name",
+        .text = "Decode the video using the given FFmpeg hardware device type "
+                "(for example vaapi, d3d11va, videotoolbox or cuda).\n"
+                "If the hardware decoder could not be initialized, scrcpy "
+                "falls back to software decoding.\n"
+                "Default is disabled (software decoding).",
+    },
     {
         .longopt_id = OPT_VIDEO_SOURCE,
         .longopt = "video-source",
@@ -1187,6 +1690,15 @@ static const struct sc_shortcut shortcuts[] = {
         .shortcuts = { "MOD+i" },
         .text = "Enable/disable FPS counter (print frames/second in logs)",
     },
+    {
+        .shortcuts = { "MOD+Shift+i" },
+        .text = "Print video pipeline latency statistics (see "
+                "--latency-stats)",
+    },
+    {
+        .shortcuts = { "MOD+Shift+s" },
+        .text = "Save a snapshot of the video (see --snapshot-dir)",
+    },
     {
         .shortcuts = { "Ctrl+click-and-move" },
         .text = "Pinch-to-zoom and rotate from the center of the screen",
@@ -1207,6 +1719,10 @@ static const struct sc_shortcut shortcuts[] = {
         .shortcuts = { "Drag & drop non-APK file" },
         .text = "Push file to device (see --push-target)",
     },
+    {
+        .shortcuts = { "MOD+Esc" },
+        .text = "Cancel the pending APK installations and file pushes",
+    },
 };
 
 static const struct sc_envvar envvars[] = {
@@ -1646,6 +2162,91 @@ parse_audio_output_buffer(const char *s, sc_tick *tick) {
     return true;
 }
 
+static bool
+parse_catch_up_delay(const char *s, sc_tick *tick) {
+    long value;
+    bool ok = parse_integer_arg(s, &value, false, 0, 60 * 1000,
+                                "catch-up delay");
+    if (!ok) {
+        return false;
+    }
+
+    *tick = SC_TICK_FROM_MS(value);
+    return true;
+}
+
+static bool
+parse_display_frame_slots(const char *s, uint8_t *slots) {
+    long value;
+    bool ok = parse_integer_arg(s, &value, false, 1,
+                                SC_DISPLAY_FRAME_SLOTS_MAX,
+                                "display frame slots");
+    if (!ok) {
+        return false;
+    }
+
+    *slots = (uint8_t) value;
+    return true;
+}
+
+static bool
+parse_display_frame_policy(const char *s,
+                           enum sc_display_frame_policy *policy) {
+    if (!strcmp(s, "fifo")) {
+        *policy = SC_DISPLAY_FRAME_POLICY_FIFO;
+        return true;
+    }
+    if (!strcmp(s, "newest-spare")) {
+        *policy = SC_DISPLAY_FRAME_POLICY_NEWEST_KEEP_SPARE;
+        return true;
+    }
+    LOGE("Unsupported display frame policy: %s (expected fifo or "
+         "newest-spare)", s);
+    return false;
+}
+
+static bool
+parse_audio_output_backend(const char *s,
+                           enum sc_audio_output_backend *backend) {
+    if (!strcmp(s, "sdl")) {
+        *backend = SC_AUDIO_OUTPUT_BACKEND_SDL;
+        return true;
+    }
+    if (!strcmp(s, "alsa")) {
+#ifdef HAVE_ALSA
+        *backend = SC_AUDIO_OUTPUT_BACKEND_ALSA;
+        return true;
+#else
+        LOGE("ALSA audio output is disabled (or unsupported on this "
+             "platform).");
+        return false;
+#endif
+    }
+    LOGE("Unsupported audio output backend: %s (expected sdl or alsa)", s);
+    return false;
+}
+
+#ifdef HAVE_V4L2
+static bool
+parse_v4l2_pixel_format(const char *s, enum sc_v4l2_pixel_format *format) {
+    if (!strcmp(s, "yuv420p")) {
+        *format = SC_V4L2_PIXEL_FORMAT_YUV420P;
+        return true;
+    }
+    if (!strcmp(s, "nv12")) {
+        *format = SC_V4L2_PIXEL_FORMAT_NV12;
+        return true;
+    }
+    if (!strcmp(s, "yuyv")) {
+        *format = SC_V4L2_PIXEL_FORMAT_YUYV;
+        return true;
+    }
+    LOGE("Unsupported V4L2 pixel format: %s (expected yuv420p, nv12 or yuyv)",
+         s);
+    return false;
+}
+#endif
+
 static bool
 parse_display_ime_policy(const char *s, enum sc_display_ime_policy *policy) {
     if (!strcmp(s, "local")) {
@@ -1912,6 +2513,121 @@ sc_parse_shortcut_mods(const char *s, uint8_t *mods) {
 }
 #endif
 
+static bool
+parse_thread_profile(const char *s, enum sc_thread_profile *profile) {
+    if (!strcmp(s, "default")) {
+        *profile = SC_THREAD_PROFILE_DEFAULT;
+        return true;
+    }
+    if (!strcmp(s, "latency")) {
+        *profile = SC_THREAD_PROFILE_LATENCY;
+        return true;
+    }
+    if (!strcmp(s, "realtime")) {
+        *profile = SC_THREAD_PROFILE_REALTIME;
+        return true;
+    }
+    LOGE("Unsupported thread profile: %s (expected default, latency or "
+         "realtime)", s);
+    return false;
+}
+
+static bool
+parse_cpu_index(const char *s, size_t len, unsigned *index) {
+    char buf[4];
+    if (!len || len >= sizeof(buf)) {
+        return false;
+    }
+    memcpy(buf, s, len);
+    buf[len] = '\0';
+
+    long value;
+    if (!sc_str_parse_integer(buf, &value) || value < 0 || value > 63) {
+        return false;
+    }
+
+    *index = value;
+    return true;
+}
+
+static bool
+parse_thread_affinity_item(const char *item, size_t len,
+                           struct sc_thread_affinity *affinity) {
+    const char *eq = memchr(item, '=', len);
+    if (!eq) {
+        LOGE("Invalid thread affinity (expected role=cpus): %.*s", (int) len,
+             item);
+        return false;
+    }
+
+    size_t role_len = eq - item;
+    uint64_t *mask;
+#define STREQ(literal, s, len) \
+    ((sizeof(literal)-1 == len) && !memcmp(literal, s, len))
+    if (STREQ("video", item, role_len)) {
+        mask = &affinity->video;
+    } else if (STREQ("audio", item, role_len)) {
+        mask = &affinity->audio;
+    } else if (STREQ("control", item, role_len)) {
+        mask = &affinity->control;
+    } else if (STREQ("recording", item, role_len)) {
+        mask = &affinity->recording;
+    } else {
+        LOGE("Unknown thread role: %.*s (must be one of: video, audio, "
+             "control, recording)", (int) role_len, item);
+        return false;
+    }
+#undef STREQ
+
+    const char *cpus = eq + 1;
+    size_t cpus_len = len - role_len - 1;
+    const char *dash = memchr(cpus, '-', cpus_len);
+
+    unsigned first;
+    unsigned last;
+    bool ok;
+    if (dash) {
+        ok = parse_cpu_index(cpus, dash - cpus, &first)
+          && parse_cpu_index(dash + 1, cpus_len - (dash + 1 - cpus), &last)
+          && first <= last;
+    } else {
+        ok = parse_cpu_index(cpus, cpus_len, &first);
+        last = first;
+    }
+    if (!ok) {
+        LOGE("Invalid CPUs (expected an index or a range between 0 and 63): "
+             "%.*s", (int) cpus_len, cpus);
+        return false;
+    }
+
+    for (unsigned i = first; i <= last; ++i) {
+        *mask |= UINT64_C(1) << i;
+    }
+
+    return true;
+}
+
+static bool
+parse_thread_affinity(const char *s, struct sc_thread_affinity *affinity) {
+    // A list of role=cpus items, for example "video=2-3,recording=0"
+    for (;;) {
+        const char *comma = strchr(s, ',');
+        size_t limit = comma ? (size_t) (comma - s) : strlen(s);
+
+        if (!parse_thread_affinity_item(s, limit, affinity)) {
+            return false;
+        }
+
+        if (!comma) {
+            break;
+        }
+
+        s = comma + 1;
+    }
+
+    return true;
+}
+
 static enum sc_record_format
 get_record_format(const char *name) {
     if (!strcmp(name, "mp4")) {
@@ -1955,51 +2671,128 @@ parse_record_format(const char *optarg, enum sc_record_format *format) {
 }
 
 static bool
-parse_ip(const char *optarg, uint32_t *ipv4) {
-    return net_parse_ipv4(optarg, ipv4);
-}
-
-static bool
-parse_port(const char *optarg, uint16_t *port) {
-    long value;
-    if (!parse_integer_arg(optarg, &value, false, 0, 0xFFFF, "port")) {
-        return false;
+parse_restream_format(const char *s, enum sc_restream_format *format) {
+    if (!strcmp(s, "mpegts")) {
+        *format = SC_RESTREAM_FORMAT_MPEGTS;
+        return true;
     }
-    *port = (uint16_t) value;
-    return true;
-}
-
-static enum sc_record_format
-guess_record_format(const char *filename) {
-    const char *dot = strrchr(filename, '.');
-    if (!dot) {
-        return 0;
+    if (!strcmp(s, "mp4")) {
+        *format = SC_RESTREAM_FORMAT_MP4;
+        return true;
     }
-
-    const char *ext = dot + 1;
-    return get_record_format(ext);
+    LOGE("Unsupported restream format: %s (expected mpegts or mp4)", s);
+    return false;
 }
 
 static bool
-parse_video_codec(const char *optarg, enum sc_codec *codec) {
-    if (!strcmp(optarg, "h264")) {
-        *codec = SC_CODEC_H264;
+parse_snapshot_format(const char *s, enum sc_snapshot_format *format) {
+    if (!strcmp(s, "png")) {
+        *format = SC_SNAPSHOT_FORMAT_PNG;
         return true;
     }
-    if (!strcmp(optarg, "h265")) {
-        *codec = SC_CODEC_H265;
+    if (!strcmp(s, "jpeg")) {
+        *format = SC_SNAPSHOT_FORMAT_JPEG;
         return true;
     }
-    if (!strcmp(optarg, "av1")) {
-        *codec = SC_CODEC_AV1;
+    if (!strcmp(s, "webp")) {
+        *format = SC_SNAPSHOT_FORMAT_WEBP;
         return true;
     }
-    LOGE("Unsupported video codec: %s (expected h264, h265 or av1)", optarg);
+    LOGE("Unsupported snapshot format: %s (expected png, jpeg or webp)", s);
     return false;
 }
 
 static bool
-parse_audio_codec(const char *optarg, enum sc_codec *codec) {
+parse_socket_profile(const char *s, enum sc_socket_profile *profile) {
+    if (!strcmp(s, "default")) {
+        *profile = SC_SOCKET_PROFILE_DEFAULT;
+        return true;
+    }
+    if (!strcmp(s, "low-latency")) {
+        *profile = SC_SOCKET_PROFILE_LOW_LATENCY;
+        return true;
+    }
+    if (!strcmp(s, "throughput")) {
+        *profile = SC_SOCKET_PROFILE_THROUGHPUT;
+        return true;
+    }
+    LOGE("Unsupported socket profile: %s (expected default, low-latency or "
+         "throughput)", s);
+    return false;
+}
+
+static bool
+parse_video_decoder_threads(const char *s, int *threads) {
+    long value;
+    if (!parse_integer_arg(s, &value, false, 0, 64, "decoder threads")) {
+        return false;
+    }
+
+    *threads = (int) value;
+    return true;
+}
+
+static bool
+parse_video_decoder_thread_type(const char *s,
+                                enum sc_decoder_thread_type *type) {
+    if (!strcmp(s, "slice")) {
+        *type = SC_DECODER_THREAD_TYPE_SLICE;
+        return true;
+    }
+    if (!strcmp(s, "frame")) {
+        *type = SC_DECODER_THREAD_TYPE_FRAME;
+        return true;
+    }
+    LOGE("Unsupported decoder thread type: %s (expected slice or frame)", s);
+    return false;
+}
+
+static bool
+parse_ip(const char *optarg, uint32_t *ipv4) {
+    return net_parse_ipv4(optarg, ipv4);
+}
+
+static bool
+parse_port(const char *optarg, uint16_t *port) {
+    long value;
+    if (!parse_integer_arg(optarg, &value, false, 0, 0xFFFF, "port")) {
+        return false;
+    }
+    *port = (uint16_t) value;
+    return true;
+}
+
+static enum sc_record_format
+guess_record_format(const char *filename) {
+    const char *dot = strrchr(filename, '.');
+    if (!dot) {
+        return 0;
+    }
+
+    const char *ext = dot + 1;
+    return get_record_format(ext);
+}
+
+static bool
+parse_video_codec(const char *optarg, enum sc_codec *codec) {
+    if (!strcmp(optarg, "h264")) {
+        *codec = SC_CODEC_H264;
+        return true;
+    }
+    if (!strcmp(optarg, "h265")) {
+        *codec = SC_CODEC_H265;
+        return true;
+    }
+    if (!strcmp(optarg, "av1")) {
+        *codec = SC_CODEC_AV1;
+        return true;
+    }
+    LOGE("Unsupported video codec: %s (expected h264, h265 or av1)", optarg);
+    return false;
+}
+
+static bool
+parse_audio_codec(const char *optarg, enum sc_codec *codec) {
     if (!strcmp(optarg, "opus")) {
         *codec = SC_CODEC_OPUS;
         return true;
@@ -2242,6 +3035,60 @@ parse_time_limit(const char *s, sc_tick *tick) {
     return true;
 }
 
+static bool
+parse_record_segment_duration(const char *s, sc_tick *tick) {
+    long value;
+    bool ok = parse_integer_arg(s, &value, false, 0, 0x7FFFFFFF,
+                                "record segment duration");
+    if (!ok) {
+        return false;
+    }
+
+    *tick = SC_TICK_FROM_SEC(value);
+    return true;
+}
+
+static bool
+parse_record_segment_size(const char *s, uint64_t *size) {
+    long value;
+    // value in MiB
+    bool ok = parse_integer_arg(s, &value, false, 0, 0x7FFFFFFF,
+                                "record segment size");
+    if (!ok) {
+        return false;
+    }
+
+    *size = (uint64_t) value << 20;
+    return true;
+}
+
+static bool
+parse_memory_budget(const char *s, uint64_t *size) {
+    long value;
+    // value in MiB
+    bool ok = parse_integer_arg(s, &value, false, 0, 0x7FFFFFFF,
+                                "memory budget");
+    if (!ok) {
+        return false;
+    }
+
+    *size = (uint64_t) value << 20;
+    return true;
+}
+
+static bool
+parse_record_segment_count(const char *s, unsigned *count) {
+    long value;
+    bool ok = parse_integer_arg(s, &value, false, 0, 0xFFFF,
+                                "record segment count");
+    if (!ok) {
+        return false;
+    }
+
+    *count = (unsigned) value;
+    return true;
+}
+
 static bool
 parse_screen_off_timeout(const char *s, sc_tick *tick) {
     long value;
@@ -2388,6 +3235,11 @@ parse_args_with_getopt(struct scrcpy_cli_args *args, int argc, char *argv[],
                     return false;
                 }
                 break;
+            case OPT_EXTRA_DISPLAY_ID:
+                if (!parse_display_id(optarg, &opts->extra_display_id)) {
+                    return false;
+                }
+                break;
             case 'd':
                 opts->select_usb = true;
                 break;
@@ -2397,6 +3249,9 @@ parse_args_with_getopt(struct scrcpy_cli_args *args, int argc, char *argv[],
             case 'f':
                 opts->fullscreen = true;
                 break;
+            case OPT_RECORD_CONTROL:
+                opts->record_control_filename = optarg;
+                break;
             case OPT_RECORD_FORMAT:
                 if (!parse_record_format(optarg, &opts->record_format)) {
                     return false;
@@ -2420,6 +3275,11 @@ parse_args_with_getopt(struct scrcpy_cli_args *args, int argc, char *argv[],
             case OPT_MAX_FPS:
                 opts->max_fps = optarg;
                 break;
+            case OPT_MEMORY_BUDGET:
+                if (!parse_memory_budget(optarg, &opts->memory_budget)) {
+                    return false;
+                }
+                break;
             case 'm':
                 if (!parse_max_size(optarg, &opts->max_size)) {
                     return false;
@@ -2461,6 +3321,11 @@ parse_args_with_getopt(struct scrcpy_cli_args *args, int argc, char *argv[],
                     return false;
                 }
                 break;
+            case OPT_STATS_PORT:
+                if (!parse_port(optarg, &opts->stats_port)) {
+                    return false;
+                }
+                break;
             case OPT_TUNNEL_PORT:
                 if (!parse_port(optarg, &opts->tunnel_port)) {
                     return false;
@@ -2571,6 +3436,40 @@ parse_args_with_getopt(struct scrcpy_cli_args *args, int argc, char *argv[],
                     return false;
                 }
                 break;
+            case OPT_RESTREAM:
+                opts->restream_url = optarg;
+                break;
+            case OPT_RESTREAM_FORMAT:
+                if (!parse_restream_format(optarg, &opts->restream_format)) {
+                    return false;
+                }
+                break;
+            case OPT_SOCKET_PROFILE:
+                if (!parse_socket_profile(optarg, &opts->socket_profile)) {
+                    return false;
+                }
+                break;
+            case OPT_RECORD_LOW_LATENCY:
+                opts->record_low_latency = true;
+                break;
+            case OPT_RECORD_SEGMENT_DURATION:
+                if (!parse_record_segment_duration(optarg,
+                                            &opts->record_segment_duration)) {
+                    return false;
+                }
+                break;
+            case OPT_RECORD_SEGMENT_SIZE:
+                if (!parse_record_segment_size(optarg,
+                                               &opts->record_segment_size)) {
+                    return false;
+                }
+                break;
+            case OPT_RECORD_SEGMENT_COUNT:
+                if (!parse_record_segment_count(optarg,
+                                                &opts->record_segment_count)) {
+                    return false;
+                }
+                break;
             case OPT_ORIENTATION: {
                 enum sc_orientation orientation;
                 if (!parse_orientation(optarg, &orientation)) {
@@ -2606,6 +3505,82 @@ parse_args_with_getopt(struct scrcpy_cli_args *args, int argc, char *argv[],
             case OPT_VIDEO_ENCODER:
                 opts->video_encoder = optarg;
                 break;
+            case OPT_VIDEO_HWACCEL:
+                opts->video_hwaccel = optarg;
+                break;
+            case OPT_VIDEO_DECODER_THREADS:
+                if (!parse_video_decoder_threads(optarg,
+                                            &opts->video_decoder_threads)) {
+                    return false;
+                }
+                break;
+            case OPT_VIDEO_DECODER_THREAD_TYPE:
+                if (!parse_video_decoder_thread_type(optarg,
+                                        &opts->video_decoder_thread_type)) {
+                    return false;
+                }
+                break;
+            case OPT_VIDEO_DECODER_FAST:
+                opts->video_decoder_fast = true;
+                break;
+            case OPT_RENDER_SHADER:
+                opts->render_shader = true;
+                break;
+            case OPT_RENDER_THREAD:
+#ifdef __APPLE__
+                // The window and its OpenGL context must be used from the main
+                // thread
+                LOGE("--render-thread is not supported on macOS");
+                return false;
+#else
+                opts->render_thread = true;
+                break;
+#endif
+            case OPT_DAMAGE_TRACKING:
+                opts->damage_tracking = true;
+                break;
+            case OPT_ASYNC_LOG:
+                opts->async_log = true;
+                break;
+            case OPT_THREAD_PROFILE:
+                if (!parse_thread_profile(optarg, &opts->thread_profile)) {
+                    return false;
+                }
+                break;
+            case OPT_THREAD_AFFINITY:
+                if (!parse_thread_affinity(optarg, &opts->thread_affinity)) {
+                    return false;
+                }
+                break;
+            case OPT_MATCH_DISPLAY_RATE:
+                opts->match_display_rate = true;
+                break;
+            case OPT_VIDEO_DECODER_SKIP:
+                opts->video_decoder_skip = true;
+                break;
+            case OPT_VIDEO_DECODER_RESYNC:
+                opts->video_decoder_resync = true;
+                break;
+            case OPT_VIDEO_CATCH_UP:
+                if (!parse_catch_up_delay(optarg, &opts->video_catch_up)) {
+                    return false;
+                }
+                break;
+            case OPT_DISPLAY_FRAME_SLOTS:
+                if (!parse_display_frame_slots(optarg,
+                                               &opts->display_frame_slots)) {
+                    return false;
+                }
+                break;
+            case OPT_DISPLAY_FRAME_POLICY:
+                if (!parse_display_frame_policy(optarg,
+                                                &opts->display_frame_policy)) {
+                    return false;
+                }
+                break;
+            case OPT_DISPLAY_PACING:
+                opts->display_pacing = true;
+                break;
             case OPT_AUDIO_ENCODER:
                 opts->audio_encoder = optarg;
                 break;
@@ -2639,6 +3614,11 @@ parse_args_with_getopt(struct scrcpy_cli_args *args, int argc, char *argv[],
                     return false;
                 }
                 break;
+            case OPT_VIDEO_BUFFER_MAX:
+                if (!parse_buffering_time(optarg, &opts->video_buffer_max)) {
+                    return false;
+                }
+                break;
             case OPT_NO_CLIPBOARD_AUTOSYNC:
                 opts->clipboard_autosync = false;
                 break;
@@ -2664,6 +3644,18 @@ parse_args_with_getopt(struct scrcpy_cli_args *args, int argc, char *argv[],
             case OPT_PRINT_FPS:
                 opts->start_fps_counter = true;
                 break;
+            case OPT_ADAPTIVE_VIDEO:
+                opts->adaptive_video = true;
+                break;
+            case OPT_CLIPBOARD_CHUNKS:
+                opts->clipboard_chunks = true;
+                break;
+            case OPT_TEXT_CHUNKS:
+                opts->text_chunks = true;
+                break;
+            case OPT_LATENCY_STATS:
+                opts->latency_stats = optarg ? optarg : "";
+                break;
             case OPT_CODEC:
                 LOGE("--codec has been removed, "
                      "use --video-codec or --audio-codec.");
@@ -2705,6 +3697,38 @@ parse_args_with_getopt(struct scrcpy_cli_args *args, int argc, char *argv[],
                 LOGE("V4L2 (--v4l2-buffer) is disabled (or unsupported on this "
                      "platform).");
                 return false;
+#endif
+            case OPT_V4L2_DIRECT:
+#ifdef HAVE_V4L2
+                opts->v4l2_direct = true;
+                break;
+#else
+                LOGE("V4L2 (--v4l2-direct) is disabled (or unsupported on this "
+                     "platform).");
+                return false;
+#endif
+            case OPT_V4L2_PIXEL_FORMAT:
+#ifdef HAVE_V4L2
+                if (!parse_v4l2_pixel_format(optarg,
+                                             &opts->v4l2_pixel_format)) {
+                    return false;
+                }
+                break;
+#else
+                LOGE("V4L2 (--v4l2-pixel-format) is disabled (or unsupported "
+                     "on this platform).");
+                return false;
+#endif
+            case OPT_V4L2_ORIENTATION:
+#ifdef HAVE_V4L2
+                if (!parse_orientation(optarg, &opts->v4l2_orientation)) {
+                    return false;
+                }
+                break;
+#else
+                LOGE("V4L2 (--v4l2-orientation) is disabled (or unsupported "
+                     "on this platform).");
+                return false;
 #endif
             case OPT_LIST_ENCODERS:
                 opts->list |= SC_OPTION_LIST_ENCODERS;
@@ -2724,11 +3748,50 @@ parse_args_with_getopt(struct scrcpy_cli_args *args, int argc, char *argv[],
             case OPT_REQUIRE_AUDIO:
                 opts->require_audio = true;
                 break;
+            case OPT_RESUME:
+                opts->resume = true;
+                break;
+            case OPT_USB_TRANSPORT:
+#ifdef HAVE_USB
+                opts->usb_transport = true;
+                break;
+#else
+                LOGE("USB transport (--usb-transport) is disabled.");
+                return false;
+#endif
+            case OPT_ARCHIVE:
+                opts->archive_filename = optarg;
+                break;
+            case OPT_ARCHIVE_BIT_RATE:
+                if (!parse_bit_rate(optarg, &opts->archive_bit_rate)) {
+                    return false;
+                }
+                break;
+            case OPT_ARCHIVE_DOWNSCALE:
+                opts->archive_downscale = true;
+                break;
+            case OPT_ARCHIVE_ENCODER:
+                opts->archive_encoder = optarg;
+                break;
+            case OPT_SNAPSHOT_DIR:
+                opts->snapshot_dir = optarg;
+                break;
+            case OPT_SNAPSHOT_FORMAT:
+                if (!parse_snapshot_format(optarg, &opts->snapshot_format)) {
+                    return false;
+                }
+                break;
             case OPT_AUDIO_BUFFER:
                 if (!parse_buffering_time(optarg, &opts->audio_buffer)) {
                     return false;
                 }
                 break;
+            case OPT_AUDIO_OUTPUT_BACKEND:
+                if (!parse_audio_output_backend(optarg,
+                                                &opts->audio_output_backend)) {
+                    return false;
+                }
+                break;
             case OPT_AUDIO_OUTPUT_BUFFER:
                 if (!parse_audio_output_buffer(optarg,
                                                &opts->audio_output_buffer)) {
@@ -2876,12 +3939,13 @@ parse_args_with_getopt(struct scrcpy_cli_args *args, int argc, char *argv[],
     }
 
     if (opts->video && !opts->video_playback && !opts->record_filename
-            && !v4l2) {
+            && !opts->restream_url && !v4l2 && !opts->archive_filename) {
         LOGI("No video playback, no recording, no V4L2 sink: video disabled");
         opts->video = false;
     }
 
-    if (opts->audio && !opts->audio_playback && !opts->record_filename) {
+    if (opts->audio && !opts->audio_playback && !opts->record_filename
+            && !opts->restream_url) {
         LOGI("No audio playback, no recording: audio disabled");
         opts->audio = false;
     }
@@ -2922,12 +3986,105 @@ parse_args_with_getopt(struct scrcpy_cli_args *args, int argc, char *argv[],
         opts->downsize_on_error = false;
     }
 
+    if (opts->video_buffer_max
+            && opts->video_buffer_max <= opts->video_buffer) {
+        LOGE("--video-buffer-max must be greater than --video-buffer");
+        return false;
+    }
+
     if (opts->v4l2_buffer && !opts->v4l2_device) {
         LOGE("V4L2 buffer value without V4L2 sink");
         return false;
     }
+
+    if (opts->v4l2_direct && !opts->v4l2_device) {
+        LOGE("--v4l2-direct requires --v4l2-sink");
+        return false;
+    }
+
+    if (opts->v4l2_pixel_format != SC_V4L2_PIXEL_FORMAT_YUV420P
+            && !opts->v4l2_device) {
+        LOGE("--v4l2-pixel-format requires --v4l2-sink");
+        return false;
+    }
+
+    if (opts->v4l2_orientation != SC_ORIENTATION_0) {
+        if (!opts->v4l2_device) {
+            LOGE("--v4l2-orientation requires --v4l2-sink");
+            return false;
+        }
+
+        // Without --v4l2-direct, the frames are converted to the pixel format
+        // before reaching the v4l2 sink, where they are oriented
+        if (!opts->v4l2_direct
+                && opts->v4l2_pixel_format != SC_V4L2_PIXEL_FORMAT_YUV420P) {
+            LOGE("--v4l2-orientation requires --v4l2-direct or "
+                 "--v4l2-pixel-format=yuv420p");
+            return false;
+        }
+    }
+
+    if (v4l2 && opts->video_hwaccel) {
+        // The V4L2 sink expects the decoder pixel format (YUV420P), while
+        // hardware decoded frames are downloaded in the hardware format
+        // (typically NV12)
+        LOGE("--video-hwaccel is incompatible with --v4l2-sink");
+        return false;
+    }
 #endif
 
+    if (opts->display_frame_policy != SC_DISPLAY_FRAME_POLICY_FIFO
+            && opts->display_frame_slots == 1) {
+        LOGE("--display-frame-policy requires --display-frame-slots > 1");
+        return false;
+    }
+
+    if (opts->display_pacing && !opts->video_playback) {
+        LOGW("--display-pacing has no effect without video playback");
+        opts->display_pacing = false;
+    }
+
+    if (opts->render_thread && !opts->video_playback) {
+        LOGW("--render-thread has no effect without video playback");
+        opts->render_thread = false;
+    }
+
+    if (opts->render_thread && opts->display_pacing) {
+        // The presentation is scheduled by timers on the event thread
+        LOGE("--render-thread is incompatible with --display-pacing");
+        return false;
+    }
+
+    if (opts->match_display_rate && (!opts->video_playback
+                                        || !opts->control)) {
+        LOGW("--match-display-rate requires video playback and control");
+        opts->match_display_rate = false;
+    }
+
+    if (opts->video_decoder_skip && !opts->video_playback) {
+        // The frames skipped by the display drive the decoder skipping
+        LOGW("--video-decoder-skip has no effect without video playback");
+        opts->video_decoder_skip = false;
+    }
+
+    bool video_decoded = opts->video_playback;
+#ifdef HAVE_V4L2
+    video_decoded |= !!opts->v4l2_device;
+#endif
+    if (!video_decoded && (opts->video_decoder_threads != -1
+                || opts->video_decoder_thread_type
+                        != SC_DECODER_THREAD_TYPE_AUTO
+                || opts->video_decoder_fast
+                || opts->video_decoder_resync
+                || opts->video_catch_up)) {
+        LOGW("Video decoder options have no effect without video decoding");
+    }
+
+    if (opts->video_hwaccel && !opts->video_playback) {
+        LOGW("--video-hwaccel has no effect without video playback");
+        opts->video_hwaccel = NULL;
+    }
+
     if (opts->control) {
         if (opts->keyboard_input_mode == SC_KEYBOARD_INPUT_MODE_AUTO) {
             opts->keyboard_input_mode = otg ? SC_KEYBOARD_INPUT_MODE_AOA
@@ -3130,6 +4287,24 @@ parse_args_with_getopt(struct scrcpy_cli_args *args, int argc, char *argv[],
         return false;
     }
 
+    if (opts->extra_display_id != SC_DISPLAY_ID_NONE) {
+        if (opts->video_source != SC_VIDEO_SOURCE_DISPLAY) {
+            LOGE("--extra-display-id is only available with "
+                 "--video-source=display");
+            return false;
+        }
+
+        if (!opts->video_playback || !opts->window) {
+            LOGE("--extra-display-id requires video playback in a window");
+            return false;
+        }
+
+        if (!opts->new_display && opts->extra_display_id == opts->display_id) {
+            LOGE("The extra display must differ from the mirrored display");
+            return false;
+        }
+    }
+
     if (opts->audio && opts->audio_source == SC_AUDIO_SOURCE_AUTO) {
         // Select the audio source according to the video source
         if (opts->video_source == SC_VIDEO_SOURCE_DISPLAY) {
@@ -3163,6 +4338,35 @@ parse_args_with_getopt(struct scrcpy_cli_args *args, int argc, char *argv[],
         return false;
     }
 
+    if ((opts->archive_encoder || opts->archive_downscale)
+            && !opts->archive_filename) {
+        LOGE("Archive options specified without --archive");
+        return false;
+    }
+
+    if (opts->archive_filename && !opts->video) {
+        LOGE("--archive requires video");
+        return false;
+    }
+
+    if (opts->record_low_latency && !opts->record_filename) {
+        LOGE("--record-low-latency requires --record");
+        return false;
+    }
+
+    if ((opts->record_segment_duration || opts->record_segment_size)
+            && !opts->record_filename) {
+        LOGE("Record segmentation specified without recording");
+        return false;
+    }
+
+    if (opts->record_segment_count && !opts->record_segment_duration
+            && !opts->record_segment_size) {
+        LOGE("--record-segment-count requires --record-segment-duration or "
+             "--record-segment-size");
+        return false;
+    }
+
     if (opts->record_filename) {
         if (!opts->video && !opts->audio) {
             LOGE("Video and audio disabled, nothing to record");
@@ -3229,6 +4433,28 @@ parse_args_with_getopt(struct scrcpy_cli_args *args, int argc, char *argv[],
         }
     }
 
+    if (opts->restream_format && !opts->restream_url) {
+        LOGE("Restream format specified without restreaming");
+        return false;
+    }
+
+    if (opts->restream_url) {
+        if (!opts->video && !opts->audio) {
+            LOGE("Video and audio disabled, nothing to restream");
+            return false;
+        }
+
+        if (!opts->restream_format) {
+            opts->restream_format = SC_RESTREAM_FORMAT_MPEGTS;
+        }
+
+        if (opts->audio && opts->audio_codec == SC_CODEC_RAW) {
+            LOGE("Restreaming does not support RAW audio "
+                 "(try with --audio-codec=opus or --no-audio)");
+            return false;
+        }
+    }
+
     if (opts->audio_codec == SC_CODEC_FLAC && opts->audio_bit_rate) {
         LOGW("--audio-bit-rate is ignored for FLAC audio codec");
     }
@@ -3266,6 +4492,10 @@ parse_args_with_getopt(struct scrcpy_cli_args *args, int argc, char *argv[],
             LOGE("Cannot start an Android app if control is disabled");
             return false;
         }
+        if (opts->record_control_filename) {
+            LOGE("Cannot record control messages if control is disabled");
+            return false;
+        }
     }
 
 # ifdef _WIN32
@@ -3284,6 +4514,48 @@ parse_args_with_getopt(struct scrcpy_cli_args *args, int argc, char *argv[],
         opts->start_fps_counter = false;
     }
 
+    if (opts->adaptive_video && (!opts->video || !opts->control)) {
+        LOGW("--adaptive-video has no effect without video and control");
+        opts->adaptive_video = false;
+    }
+
+    if (opts->clipboard_chunks && !opts->control) {
+        LOGW("--clipboard-chunks has no effect without control");
+        opts->clipboard_chunks = false;
+    }
+
+    if (opts->text_chunks && !opts->control) {
+        LOGW("--text-chunks has no effect without control");
+        opts->text_chunks = false;
+    }
+
+    if (opts->latency_stats && !opts->video_playback) {
+        LOGW("--latency-stats has no effect without video playback");
+        opts->latency_stats = NULL;
+    }
+
+#ifdef HAVE_USB
+    if (opts->usb_transport) {
+        if (otg) {
+            LOGE("--usb-transport is incompatible with OTG mode");
+            return false;
+        }
+        if (opts->tcpip || opts->select_tcpip) {
+            LOGE("--usb-transport requires a device connected over USB");
+            return false;
+        }
+        if (opts->resume) {
+            LOGE("--resume is not supported with --usb-transport");
+            return false;
+        }
+        if (opts->force_adb_forward || opts->tunnel_host
+                || opts->tunnel_port) {
+            LOGE("--usb-transport does not use the adb tunnel");
+            return false;
+        }
+    }
+#endif
+
     if (otg) {
         // OTG mode is compatible with only very few options.
         // Only report obvious errors.
@@ -3291,6 +4563,10 @@ parse_args_with_getopt(struct scrcpy_cli_args *args, int argc, char *argv[],
             LOGE("OTG mode: cannot record");
             return false;
         }
+        if (opts->restream_url) {
+            LOGE("OTG mode: cannot restream");
+            return false;
+        }
         if (opts->turn_screen_off) {
             LOGE("OTG mode: could not turn screen off");
             return false;
@@ -10,9 +10,11 @@
 
 #ifndef _WIN32
 # define PRIu64_ PRIu64
+# define PRIx64_ PRIx64
 # define SC_PRIsizet "zu"
 #else
 # define PRIu64_ "I64u"  // Windows...
+# define PRIx64_ "I64x"
 # define SC_PRIsizet "Iu"
 #endif
 
@@ -61,6 +63,23 @@
 # define SCRCPY_LAVC_HAS_CODECPAR_CODEC_SIDEDATA
 #endif
 
+// AVCodecHWConfig and avcodec_get_hw_config() are available since FFmpeg 4.0
+// (lavc 58.18.100)
+#if LIBAVCODEC_VERSION_INT >= AV_VERSION_INT(58, 18, 100)
+# define SCRCPY_LAVC_HAS_HW_CONFIG
+#endif
+
+// FFmpeg 5.0 (lavu 57) changed the type of buffer sizes from int to size_t
+#if LIBAVUTIL_VERSION_MAJOR >= 57
+# define SCRCPY_LAVU_HAS_SIZE_T_BUFFER_SIZE
+#endif
+
+// FFmpeg 7.0 (lavf 61) made the buffer parameter of the AVIOContext write
+// callback a pointer-to-const
+#if LIBAVFORMAT_VERSION_MAJOR >= 61
+# define SCRCPY_LAVF_HAS_AVIO_WRITE_CONST_BUF
+#endif
+
 #if SDL_VERSION_ATLEAST(2, 0, 6)
 // <https://github.com/libsdl-org/SDL/commit/d7a318de563125e5bb465b1000d6bc9576fbc6fc>
 # define SCRCPY_SDL_HAS_HINT_TOUCH_MOUSE_EVENTS
@@ -75,6 +94,14 @@
 # define SCRCPY_SDL_HAS_THREAD_PRIORITY_TIME_CRITICAL
 #endif
 
+#if SDL_VERSION_ATLEAST(2, 0, 16)
+# define SCRCPY_SDL_HAS_UPDATE_NV_TEXTURE
+#endif
+
+#if SDL_VERSION_ATLEAST(2, 0, 10)
+# define SCRCPY_SDL_HAS_RENDER_FLUSH
+#endif
+
 #if SDL_VERSION_ATLEAST(2, 0, 18)
 # define SCRCPY_SDL_HAS_HINT_APP_NAME
 #endif
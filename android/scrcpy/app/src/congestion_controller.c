@@ -0,0 +1,271 @@
+#include "congestion_controller.h"
+
+#include <assert.h>
+#include <inttypes.h>
+#include <stdlib.h>
+
+#include "control_msg.h"
+#include "events.h"
+#include "stats.h"
+#include "util/log.h"
+#include "util/thread.h"
+
+/** Downcast packet_sink to congestion_controller */
+#define DOWNCAST(SINK) \
+    container_of(SINK, struct sc_congestion_controller, packet_sink)
+
+// Same as the server default
+#define SC_CC_DEFAULT_BIT_RATE 8000000
+
+#define SC_CC_MIN_BIT_RATE 500000
+#define SC_CC_MIN_MAX_SIZE 480
+
+#define SC_CC_INTERVAL SC_TICK_FROM_SEC(1)
+// The base delay is the minimum over the last 2 windows of this number of
+// intervals, so that a clock drift is eventually absorbed
+#define SC_CC_WINDOW_INTERVALS 10
+
+// Congestion thresholds
+#define SC_CC_MAX_QUEUING_DELAY SC_TICK_FROM_MS(150)
+#define SC_CC_MAX_SKIPPED_PERCENT 20
+#define SC_CC_MIN_FRAMES 10
+
+// Number of stable intervals before increasing the quality again
+#define SC_CC_STABLE_INTERVALS 5
+// Number of intervals to ignore after a change, to let it take effect
+#define SC_CC_COOLDOWN_INTERVALS 2
+
+struct sc_cc_task_data {
+    struct sc_controller *controller;
+    uint32_t bit_rate;
+    uint16_t max_size;
+};
+
+static void
+task_set_video_params(void *userdata) {
+    assert(sc_thread_get_id() == SC_MAIN_THREAD_ID);
+
+    struct sc_cc_task_data *data = userdata;
+
+    struct sc_control_msg msg;
+    msg.type = SC_CONTROL_MSG_TYPE_SET_VIDEO_PARAMS;
+    msg.set_video_params.bit_rate = data->bit_rate;
+    msg.set_video_params.max_size = data->max_size;
+
+    if (!sc_controller_push_msg(data->controller, &msg)) {
+        LOGW("Could not request new video parameters");
+    }
+
+    free(data);
+}
+
+static void
+sc_congestion_controller_request(struct sc_congestion_controller *cc,
+                                 uint32_t bit_rate, uint16_t max_size) {
+    assert(bit_rate != cc->bit_rate || max_size != cc->max_size);
+
+    LOGI("Congestion control: bit rate %" PRIu32 " -> %" PRIu32 ", max size "
+         "%" PRIu16 " -> %" PRIu16, cc->bit_rate, bit_rate, cc->max_size,
+         max_size);
+
+    struct sc_cc_task_data *data = malloc(sizeof(*data));
+    if (!data) {
+        LOG_OOM();
+        return;
+    }
+
+    data->controller = cc->controller;
+    // 0 means unchanged
+    data->bit_rate = bit_rate != cc->bit_rate ? bit_rate : 0;
+    data->max_size = max_size != cc->max_size ? max_size : 0;
+
+    // The controller must be fed from the main thread
+    bool ok = sc_post_to_main_thread(task_set_video_params, data);
+    if (!ok) {
+        LOGW("Could not post video parameters to main thread");
+        free(data);
+        return;
+    }
+
+    cc->bit_rate = bit_rate;
+    cc->max_size = max_size;
+    cc->cooldown_intervals = SC_CC_COOLDOWN_INTERVALS;
+}
+
+static void
+sc_congestion_controller_decrease(struct sc_congestion_controller *cc,
+                                  uint32_t measured_bit_rate) {
+    if (cc->bit_rate > SC_CC_MIN_BIT_RATE) {
+        // Decrease multiplicatively, but below the rate actually received
+        uint32_t bit_rate = MIN(cc->bit_rate / 10 * 7,
+                                measured_bit_rate / 10 * 9);
+        bit_rate = MAX(bit_rate, SC_CC_MIN_BIT_RATE);
+        sc_congestion_controller_request(cc, bit_rate, cc->max_size);
+        return;
+    }
+
+    if (cc->max_size > SC_CC_MIN_MAX_SIZE) {
+        // Keep the size a multiple of 8
+        uint16_t max_size = (cc->max_size / 4 * 3) & ~7;
+        max_size = MAX(max_size, SC_CC_MIN_MAX_SIZE);
+        sc_congestion_controller_request(cc, cc->bit_rate, max_size);
+        return;
+    }
+
+    LOGD("Congestion control: lower bounds reached");
+}
+
+static void
+sc_congestion_controller_increase(struct sc_congestion_controller *cc) {
+    // Restore the video size first, then the bit rate
+    if (cc->max_size < cc->initial_max_size) {
+        uint32_t max_size = ((uint32_t) cc->max_size / 3 * 4) & ~7;
+        max_size = MIN(max_size, cc->initial_max_size);
+        sc_congestion_controller_request(cc, cc->bit_rate, max_size);
+        return;
+    }
+
+    if (cc->bit_rate < cc->initial_bit_rate) {
+        uint64_t bit_rate = (uint64_t) cc->bit_rate * 5 / 4;
+        bit_rate = MIN(bit_rate, cc->initial_bit_rate);
+        sc_congestion_controller_request(cc, bit_rate, cc->max_size);
+    }
+}
+
+static void
+sc_congestion_controller_evaluate(struct sc_congestion_controller *cc,
+                                  sc_tick now) {
+    // Duration of the interval (the evaluation may be late if no packet has
+    // been received for some time)
+    sc_tick duration = now - (cc->next_evaluation - SC_CC_INTERVAL);
+    assert(duration > 0);
+    uint32_t measured_bit_rate =
+        MIN(cc->interval_bytes * 8 * SC_TICK_FREQ / duration, UINT32_MAX);
+
+    sc_tick queuing_delay = cc->interval_packets
+                          ? cc->interval_delay_sum / cc->interval_packets
+                          : 0;
+
+    uint64_t rendered = sc_stats_get(SC_STATS_FRAMES_RENDERED);
+    uint64_t skipped = sc_stats_get(SC_STATS_FRAMES_SKIPPED);
+    uint64_t interval_rendered = rendered - cc->last_frames_rendered;
+    uint64_t interval_skipped = skipped - cc->last_frames_skipped;
+    cc->last_frames_rendered = rendered;
+    cc->last_frames_skipped = skipped;
+    uint64_t interval_frames = interval_rendered + interval_skipped;
+
+    LOGV("Congestion control: rate=%" PRIu32 " queuing_delay=%" PRItick
+         "ms skipped=%" PRIu64 "/%" PRIu64, measured_bit_rate,
+         SC_TICK_TO_MS(queuing_delay), interval_skipped, interval_frames);
+
+    if (cc->cooldown_intervals) {
+        --cc->cooldown_intervals;
+        return;
+    }
+
+    bool congested = queuing_delay > SC_CC_MAX_QUEUING_DELAY
+                  || (interval_frames >= SC_CC_MIN_FRAMES
+                        && interval_skipped * 100
+                           > interval_frames * SC_CC_MAX_SKIPPED_PERCENT);
+
+    if (congested) {
+        cc->stable_intervals = 0;
+        sc_congestion_controller_decrease(cc, measured_bit_rate);
+    } else if (++cc->stable_intervals >= SC_CC_STABLE_INTERVALS) {
+        cc->stable_intervals = 0;
+        sc_congestion_controller_increase(cc);
+    }
+}
+
+static bool
+sc_congestion_controller_packet_sink_open(struct sc_packet_sink *sink,
+                                          AVCodecContext *ctx) {
+    struct sc_congestion_controller *cc = DOWNCAST(sink);
+
+    if (!cc->initial_max_size) {
+        // Not limited, start from the actual video size
+        int size = MAX(ctx->width, ctx->height);
+        cc->initial_max_size = MIN(size, UINT16_MAX) & ~7;
+    }
+    cc->max_size = cc->initial_max_size;
+
+    cc->base_delay = INT64_MAX;
+    cc->window_min_delay = INT64_MAX;
+    cc->window_intervals = 0;
+
+    cc->next_evaluation = sc_tick_now() + SC_CC_INTERVAL;
+    cc->interval_bytes = 0;
+    cc->interval_delay_sum = 0;
+    cc->interval_packets = 0;
+    cc->last_frames_rendered = sc_stats_get(SC_STATS_FRAMES_RENDERED);
+    cc->last_frames_skipped = sc_stats_get(SC_STATS_FRAMES_SKIPPED);
+
+    cc->stable_intervals = 0;
+    cc->cooldown_intervals = 0;
+
+    return true;
+}
+
+static void
+sc_congestion_controller_packet_sink_close(struct sc_packet_sink *sink) {
+    (void) sink;
+}
+
+static bool
+sc_congestion_controller_packet_sink_push(struct sc_packet_sink *sink,
+                                          const AVPacket *packet) {
+    struct sc_congestion_controller *cc = DOWNCAST(sink);
+
+    if (packet->pts == AV_NOPTS_VALUE) {
+        // Config packet, not timestamped
+        return true;
+    }
+
+    sc_tick now = sc_tick_now();
+
+    sc_tick delay = now - packet->pts;
+    cc->window_min_delay = MIN(cc->window_min_delay, delay);
+    cc->base_delay = MIN(cc->base_delay, delay);
+
+    cc->interval_bytes += packet->size;
+    cc->interval_delay_sum += delay - cc->base_delay;
+    ++cc->interval_packets;
+
+    if (now >= cc->next_evaluation) {
+        sc_congestion_controller_evaluate(cc, now);
+
+        if (++cc->window_intervals == SC_CC_WINDOW_INTERVALS) {
+            // The new base delay is the minimum over the last 2 windows
+            cc->base_delay = cc->window_min_delay;
+            cc->window_min_delay = INT64_MAX;
+            cc->window_intervals = 0;
+        }
+
+        cc->next_evaluation = now + SC_CC_INTERVAL;
+        cc->interval_bytes = 0;
+        cc->interval_delay_sum = 0;
+        cc->interval_packets = 0;
+    }
+
+    return true;
+}
+
+void
+sc_congestion_controller_init(struct sc_congestion_controller *cc,
+                              struct sc_controller *controller,
+                              uint32_t bit_rate, uint16_t max_size) {
+    assert(controller);
+    cc->controller = controller;
+    cc->initial_bit_rate = bit_rate ? bit_rate : SC_CC_DEFAULT_BIT_RATE;
+    cc->initial_max_size = max_size & ~7;
+    cc->bit_rate = cc->initial_bit_rate;
+    cc->max_size = cc->initial_max_size;
+
+    static const struct sc_packet_sink_ops ops = {
+        .open = sc_congestion_controller_packet_sink_open,
+        .close = sc_congestion_controller_packet_sink_close,
+        .push = sc_congestion_controller_packet_sink_push,
+    };
+
+    cc->packet_sink.ops = &ops;
+}
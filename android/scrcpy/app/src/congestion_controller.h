@@ -0,0 +1,70 @@
+#ifndef SC_CONGESTION_CONTROLLER_H
+#define SC_CONGESTION_CONTROLLER_H
+
+#include "common.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "controller.h"
+#include "trait/packet_sink.h"
+#include "util/tick.h"
+
+/**
+ * Video congestion controller
+ *
+ * It is a packet sink of the video demuxer. For each packet, it measures the
+ * delay between the device capture timestamp (PTS) and the reception on the
+ * computer: its increase above the minimal observed value is the queuing
+ * delay (the clock offset between the device and the computer cancels out).
+ *
+ * Every second, the queuing delay and the frames skipped by the screen are
+ * evaluated. On congestion, it asks the server to decrease the video bit
+ * rate, then the video size once the bit rate reaches its lower bound. Once
+ * the stream is stable again, the initial values are restored progressively.
+ */
+struct sc_congestion_controller {
+    struct sc_packet_sink packet_sink; // packet sink trait
+
+    struct sc_controller *controller;
+
+    // The configured values (the upper bounds)
+    uint32_t initial_bit_rate;
+    uint16_t initial_max_size; // initialized on open() if 0
+
+    // The values currently requested
+    uint32_t bit_rate;
+    uint16_t max_size;
+
+    // The following fields are only accessed from the demuxer thread
+
+    // Minimal (PTS to reception) delay over the current and the previous
+    // windows
+    sc_tick base_delay;
+    sc_tick window_min_delay;
+    unsigned window_intervals;
+
+    // Measurements over the current interval
+    sc_tick next_evaluation;
+    uint64_t interval_bytes;
+    sc_tick interval_delay_sum;
+    unsigned interval_packets;
+    uint64_t last_frames_rendered;
+    uint64_t last_frames_skipped;
+
+    unsigned stable_intervals;
+    unsigned cooldown_intervals;
+};
+
+/**
+ * Initialize the congestion controller
+ *
+ * The initial bit rate and max size are the values requested on start (0 for
+ * the server defaults).
+ */
+void
+sc_congestion_controller_init(struct sc_congestion_controller *cc,
+                              struct sc_controller *controller,
+                              uint32_t bit_rate, uint16_t max_size);
+
+#endif
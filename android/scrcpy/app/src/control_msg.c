@@ -115,6 +115,16 @@ sc_control_msg_serialize(const struct sc_control_msg *msg, uint8_t *buf) {
                                       SC_CONTROL_MSG_INJECT_TEXT_MAX_LENGTH);
             return 1 + len;
         }
+        case SC_CONTROL_MSG_TYPE_INJECT_TEXT_CHUNK:
+            assert(msg->inject_text_chunk.size
+                    <= SC_CONTROL_MSG_INJECT_TEXT_CHUNK_SIZE);
+            sc_write64be(&buf[1], msg->inject_text_chunk.sequence);
+            // flags: bit 0 = last chunk
+            buf[9] = msg->inject_text_chunk.last ? 1 : 0;
+            sc_write32be(&buf[10], msg->inject_text_chunk.size);
+            memcpy(&buf[14], msg->inject_text_chunk.data,
+                   msg->inject_text_chunk.size);
+            return 14 + msg->inject_text_chunk.size;
         case SC_CONTROL_MSG_TYPE_INJECT_TOUCH_EVENT:
             buf[1] = msg->inject_touch_event.action;
             sc_write64be(&buf[2], msg->inject_touch_event.pointer_id);
@@ -151,6 +161,17 @@ sc_control_msg_serialize(const struct sc_control_msg *msg, uint8_t *buf) {
             size_t len = write_string(&buf[10], msg->set_clipboard.text,
                                       SC_CONTROL_MSG_CLIPBOARD_TEXT_MAX_LENGTH);
             return 10 + len;
+        case SC_CONTROL_MSG_TYPE_SET_CLIPBOARD_CHUNK:
+            assert(msg->set_clipboard_chunk.size
+                    <= SC_CONTROL_MSG_CLIPBOARD_CHUNK_SIZE);
+            sc_write64be(&buf[1], msg->set_clipboard_chunk.sequence);
+            // flags: bit 0 = paste, bit 1 = last chunk
+            buf[9] = (msg->set_clipboard_chunk.paste ? 1 : 0)
+                   | (msg->set_clipboard_chunk.last ? 2 : 0);
+            sc_write32be(&buf[10], msg->set_clipboard_chunk.size);
+            memcpy(&buf[14], msg->set_clipboard_chunk.data,
+                   msg->set_clipboard_chunk.size);
+            return 14 + msg->set_clipboard_chunk.size;
         case SC_CONTROL_MSG_TYPE_SET_DISPLAY_POWER:
             buf[1] = msg->set_display_power.on;
             return 2;
@@ -182,6 +203,13 @@ sc_control_msg_serialize(const struct sc_control_msg *msg, uint8_t *buf) {
             size_t len = write_string_tiny(&buf[1], msg->start_app.name, 255);
             return 1 + len;
         }
+        case SC_CONTROL_MSG_TYPE_SET_VIDEO_PARAMS:
+            sc_write32be(&buf[1], msg->set_video_params.bit_rate);
+            sc_write16be(&buf[5], msg->set_video_params.max_size);
+            return 7;
+        case SC_CONTROL_MSG_TYPE_SET_MAX_FPS:
+            sc_write16be(&buf[1], msg->set_max_fps.max_fps);
+            return 3;
         case SC_CONTROL_MSG_TYPE_EXPAND_NOTIFICATION_PANEL:
         case SC_CONTROL_MSG_TYPE_EXPAND_SETTINGS_PANEL:
         case SC_CONTROL_MSG_TYPE_COLLAPSE_PANELS:
@@ -210,6 +238,12 @@ sc_control_msg_log(const struct sc_control_msg *msg) {
         case SC_CONTROL_MSG_TYPE_INJECT_TEXT:
             LOG_CMSG("text \"%s\"", msg->inject_text.text);
             break;
+        case SC_CONTROL_MSG_TYPE_INJECT_TEXT_CHUNK:
+            LOG_CMSG("text chunk %" PRIu64_ " size=%" PRIu32 "%s",
+                     msg->inject_text_chunk.sequence,
+                     msg->inject_text_chunk.size,
+                     msg->inject_text_chunk.last ? " (last)" : "");
+            break;
         case SC_CONTROL_MSG_TYPE_INJECT_TOUCH_EVENT: {
             int action = msg->inject_touch_event.action
                        & AMOTION_EVENT_ACTION_MASK;
@@ -264,6 +298,13 @@ sc_control_msg_log(const struct sc_control_msg *msg) {
                      msg->set_clipboard.paste ? "paste" : "nopaste",
                      msg->set_clipboard.text);
             break;
+        case SC_CONTROL_MSG_TYPE_SET_CLIPBOARD_CHUNK:
+            LOG_CMSG("clipboard chunk %" PRIu64_ " %s size=%" PRIu32 "%s",
+                     msg->set_clipboard_chunk.sequence,
+                     msg->set_clipboard_chunk.paste ? "paste" : "nopaste",
+                     msg->set_clipboard_chunk.size,
+                     msg->set_clipboard_chunk.last ? " (last)" : "");
+            break;
         case SC_CONTROL_MSG_TYPE_SET_DISPLAY_POWER:
             LOG_CMSG("display power %s",
                      msg->set_display_power.on ? "on" : "off");
@@ -294,16 +335,11 @@ sc_control_msg_log(const struct sc_control_msg *msg) {
             break;
         }
         case SC_CONTROL_MSG_TYPE_UHID_INPUT: {
-            char *hex = sc_str_to_hex_string(msg->uhid_input.data,
-                                             msg->uhid_input.size);
-            if (hex) {
-                LOG_CMSG("UHID input [%" PRIu16 "] %s",
-                         msg->uhid_input.id, hex);
-                free(hex);
-            } else {
-                LOG_CMSG("UHID input [%" PRIu16 "] size=%" PRIu16,
-                         msg->uhid_input.id, msg->uhid_input.size);
-            }
+            // The size is bounded, do not allocate for every HID event
+            char hex[SC_STR_HEX_SIZE(SC_HID_MAX_SIZE)];
+            assert(msg->uhid_input.size <= SC_HID_MAX_SIZE);
+            sc_str_write_hex(hex, msg->uhid_input.data, msg->uhid_input.size);
+            LOG_CMSG("UHID input [%" PRIu16 "] %s", msg->uhid_input.id, hex);
             break;
         }
         case SC_CONTROL_MSG_TYPE_UHID_DESTROY:
@@ -318,6 +354,14 @@ sc_control_msg_log(const struct sc_control_msg *msg) {
         case SC_CONTROL_MSG_TYPE_RESET_VIDEO:
             LOG_CMSG("reset video");
             break;
+        case SC_CONTROL_MSG_TYPE_SET_VIDEO_PARAMS:
+            LOG_CMSG("set video params bit_rate=%" PRIu32 " max_size=%" PRIu16,
+                     msg->set_video_params.bit_rate,
+                     msg->set_video_params.max_size);
+            break;
+        case SC_CONTROL_MSG_TYPE_SET_MAX_FPS:
+            LOG_CMSG("set max fps %" PRIu16, msg->set_max_fps.max_fps);
+            break;
         default:
             LOG_CMSG("unknown type: %u", (unsigned) msg->type);
             break;
@@ -330,8 +374,74 @@ sc_control_msg_is_droppable(const struct sc_control_msg *msg) {
     // UHID_INPUT messages for this device to be invalid.
     // Cannot drop UHID_DESTROY messages either, because a further UHID_CREATE
     // with the same id may fail.
+    // Cannot drop SET_VIDEO_PARAMS messages, because they are typically sent
+    // under congestion, and the sender assumes they are applied.
+    // Cannot drop SET_MAX_FPS messages either, they are only sent when the
+    // display rate changes.
     return msg->type != SC_CONTROL_MSG_TYPE_UHID_CREATE
-        && msg->type != SC_CONTROL_MSG_TYPE_UHID_DESTROY;
+        && msg->type != SC_CONTROL_MSG_TYPE_UHID_DESTROY
+        && msg->type != SC_CONTROL_MSG_TYPE_SET_VIDEO_PARAMS
+        && msg->type != SC_CONTROL_MSG_TYPE_SET_MAX_FPS;
+}
+
+static bool
+sc_position_equals(const struct sc_position *a, const struct sc_position *b) {
+    return a->point.x == b->point.x
+        && a->point.y == b->point.y
+        && a->screen_size.width == b->screen_size.width
+        && a->screen_size.height == b->screen_size.height;
+}
+
+bool
+sc_control_msg_coalesce(struct sc_control_msg *msg,
+                        const struct sc_control_msg *next) {
+    if (msg->type != next->type) {
+        return false;
+    }
+
+    switch (msg->type) {
+        case SC_CONTROL_MSG_TYPE_INJECT_TOUCH_EVENT: {
+            // Only the last position of a move matters (the intermediate
+            // positions are lost)
+            enum android_motionevent_action action =
+                msg->inject_touch_event.action;
+            if ((action != AMOTION_EVENT_ACTION_MOVE
+                        && action != AMOTION_EVENT_ACTION_HOVER_MOVE)
+                    || next->inject_touch_event.action != action
+                    || next->inject_touch_event.pointer_id
+                            != msg->inject_touch_event.pointer_id
+                    || next->inject_touch_event.buttons
+                            != msg->inject_touch_event.buttons
+                    || next->inject_touch_event.action_button
+                            != msg->inject_touch_event.action_button) {
+                return false;
+            }
+            msg->inject_touch_event = next->inject_touch_event;
+            return true;
+        }
+        case SC_CONTROL_MSG_TYPE_INJECT_SCROLL_EVENT: {
+            if (!sc_position_equals(&msg->inject_scroll_event.position,
+                                    &next->inject_scroll_event.position)
+                    || next->inject_scroll_event.buttons
+                            != msg->inject_scroll_event.buttons) {
+                return false;
+            }
+            float hscroll = msg->inject_scroll_event.hscroll
+                          + next->inject_scroll_event.hscroll;
+            float vscroll = msg->inject_scroll_event.vscroll
+                          + next->inject_scroll_event.vscroll;
+            // Values outside [-16, 16] would be clamped on serialization
+            if (hscroll < -16 || hscroll > 16
+                    || vscroll < -16 || vscroll > 16) {
+                return false;
+            }
+            msg->inject_scroll_event.hscroll = hscroll;
+            msg->inject_scroll_event.vscroll = vscroll;
+            return true;
+        }
+        default:
+            return false;
+    }
 }
 
 void
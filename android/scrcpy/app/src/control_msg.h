@@ -15,9 +15,17 @@
 #define SC_CONTROL_MSG_MAX_SIZE (1 << 18) // 256k
 
 #define SC_CONTROL_MSG_INJECT_TEXT_MAX_LENGTH 300
+// Longer texts (typically pasted with --legacy-paste) are streamed in chunks
+// of this size (see SC_CONTROL_MSG_TYPE_INJECT_TEXT_CHUNK), up to
+// SC_CONTROL_MSG_CLIPBOARD_TEXT_MAX_LENGTH
+#define SC_CONTROL_MSG_INJECT_TEXT_CHUNK_SIZE 4096
 // type: 1 byte; sequence: 8 bytes; paste flag: 1 byte; length: 4 bytes
 #define SC_CONTROL_MSG_CLIPBOARD_TEXT_MAX_LENGTH (SC_CONTROL_MSG_MAX_SIZE - 14)
 
+// Clipboard texts larger than this are streamed in chunks of this size (see
+// SC_CONTROL_MSG_TYPE_SET_CLIPBOARD_CHUNK)
+#define SC_CONTROL_MSG_CLIPBOARD_CHUNK_SIZE 4096
+
 #define SC_POINTER_ID_MOUSE UINT64_C(-1)
 #define SC_POINTER_ID_GENERIC_FINGER UINT64_C(-2)
 
@@ -43,6 +51,10 @@ enum sc_control_msg_type {
     SC_CONTROL_MSG_TYPE_OPEN_HARD_KEYBOARD_SETTINGS,
     SC_CONTROL_MSG_TYPE_START_APP,
     SC_CONTROL_MSG_TYPE_RESET_VIDEO,
+    SC_CONTROL_MSG_TYPE_SET_CLIPBOARD_CHUNK,
+    SC_CONTROL_MSG_TYPE_SET_VIDEO_PARAMS,
+    SC_CONTROL_MSG_TYPE_SET_MAX_FPS,
+    SC_CONTROL_MSG_TYPE_INJECT_TEXT_CHUNK,
 };
 
 enum sc_copy_key {
@@ -63,6 +75,14 @@ struct sc_control_msg {
         struct {
             char *text; // owned, to be freed by free()
         } inject_text;
+        struct {
+            // The chunks of a text are sent in order. The device injects the
+            // whole text at once (as a single IME batch) on the last one.
+            uint64_t sequence;
+            const char *data; // not owned, not null-terminated
+            uint32_t size;
+            bool last;
+        } inject_text_chunk;
         struct {
             enum android_motionevent_action action;
             enum android_motionevent_buttons action_button;
@@ -89,6 +109,16 @@ struct sc_control_msg {
             char *text; // owned, to be freed by free()
             bool paste;
         } set_clipboard;
+        struct {
+            // The chunks of a clipboard text are sent in order, possibly
+            // interleaved with other msgs. The device sets the clipboard on
+            // the last one.
+            uint64_t sequence;
+            const char *data; // not owned, not null-terminated
+            uint32_t size;
+            bool paste;
+            bool last;
+        } set_clipboard_chunk;
         struct {
             bool on;
         } set_display_power;
@@ -111,6 +141,16 @@ struct sc_control_msg {
         struct {
             char *name;
         } start_app;
+        struct {
+            // Change the encoding parameters on the fly (0 to keep unchanged)
+            uint32_t bit_rate;
+            uint16_t max_size;
+        } set_video_params;
+        struct {
+            // Cap the encoder frame rate to the rate the client can present
+            // (0 for no limit)
+            uint16_t max_fps;
+        } set_max_fps;
     };
 };
 
@@ -127,6 +167,15 @@ sc_control_msg_log(const struct sc_control_msg *msg);
 bool
 sc_control_msg_is_droppable(const struct sc_control_msg *msg);
 
+// Merge `next` into `msg` if the resulting message is equivalent to both
+// (consecutive mouse/touch moves of the same pointer, or scroll events at the
+// same position).
+//
+// Return true if `next` has been merged (it must then be discarded).
+bool
+sc_control_msg_coalesce(struct sc_control_msg *msg,
+                        const struct sc_control_msg *next);
+
 void
 sc_control_msg_destroy(struct sc_control_msg *msg);
 
@@ -1,12 +1,27 @@
 #include "controller.h"
 
 #include <assert.h>
-
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "memory_budget.h"
+#include "stats.h"
+#include "util/binary.h"
+#include "util/file.h"
 #include "util/log.h"
+#include "util/str.h"
 
 // Drop droppable events above this limit
 #define SC_CONTROL_MSG_QUEUE_LIMIT 60
 
+// Serialize consecutive msgs until this size is reached before sending them
+#define SC_CONTROL_MSG_BATCH_SIZE 4096
+
+// Keep some room to support 4 non-droppable events without locking
+static_assert(SC_CONTROL_MSG_QUEUE_LIMIT + 4 <= SC_CONTROL_MSG_RING_SIZE,
+              "control msg ring too small");
+
 static void
 sc_controller_receiver_on_ended(struct sc_receiver *receiver, bool error,
                                 void *userdata) {
@@ -17,47 +32,61 @@ sc_controller_receiver_on_ended(struct sc_receiver *receiver, bool error,
     controller->cbs->on_ended(controller, error, controller->cbs_userdata);
 }
 
+static sc_socket
+sc_controller_receiver_on_disconnected(struct sc_receiver *receiver,
+                                       sc_socket socket, void *userdata) {
+    (void) receiver;
+
+    struct sc_controller *controller = userdata;
+    if (!controller->cbs->on_disconnected) {
+        return SC_SOCKET_NONE;
+    }
+
+    // Forward the event to the controller listener
+    return controller->cbs->on_disconnected(controller, socket,
+                                            controller->cbs_userdata);
+}
+
 bool
 sc_controller_init(struct sc_controller *controller, sc_socket control_socket,
                    const struct sc_controller_callbacks *cbs,
                    void *cbs_userdata) {
-    sc_vecdeque_init(&controller->queue);
-
-    // Add 4 to support 4 non-droppable events without re-allocation
-    bool ok = sc_vecdeque_reserve(&controller->queue,
-                                  SC_CONTROL_MSG_QUEUE_LIMIT + 4);
-    if (!ok) {
-        return false;
-    }
+    sc_spsc_ring_init(&controller->ring);
+    sc_vecdeque_init(&controller->overflow);
+    atomic_init(&controller->overflow_count, 0);
+    controller->budget_exceeded = false;
+    controller->clipboard_chunks = false;
+    controller->clipboard_stream.text = NULL;
+    controller->text_chunks = false;
+    controller->next_text_sequence = 0;
+    controller->record.file = NULL;
 
     static const struct sc_receiver_callbacks receiver_cbs = {
         .on_ended = sc_controller_receiver_on_ended,
+        .on_disconnected = sc_controller_receiver_on_disconnected,
     };
 
-    ok = sc_receiver_init(&controller->receiver, control_socket, &receiver_cbs,
-                          controller);
+    bool ok = sc_receiver_init(&controller->receiver, control_socket,
+                               &receiver_cbs, controller);
     if (!ok) {
-        sc_vecdeque_destroy(&controller->queue);
         return false;
     }
 
     ok = sc_mutex_init(&controller->mutex);
     if (!ok) {
         sc_receiver_destroy(&controller->receiver);
-        sc_vecdeque_destroy(&controller->queue);
         return false;
     }
 
-    ok = sc_cond_init(&controller->msg_cond);
+    ok = sc_ring_waiter_init(&controller->waiter);
     if (!ok) {
         sc_receiver_destroy(&controller->receiver);
         sc_mutex_destroy(&controller->mutex);
-        sc_vecdeque_destroy(&controller->queue);
         return false;
     }
 
     controller->control_socket = control_socket;
-    controller->stopped = false;
+    atomic_init(&controller->stopped, false);
 
     assert(cbs && cbs->on_ended);
     controller->cbs = cbs;
@@ -74,21 +103,102 @@ sc_controller_configure(struct sc_controller *controller,
     controller->receiver.uhid_devices = uhid_devices;
 }
 
+// Memory accounted to the memory budget for a msg in the overflow queue
+static uint64_t
+sc_control_msg_get_memory_size(const struct sc_control_msg *msg) {
+    uint64_t size = sizeof(*msg);
+    switch (msg->type) {
+        case SC_CONTROL_MSG_TYPE_INJECT_TEXT:
+            size += strlen(msg->inject_text.text) + 1;
+            break;
+        case SC_CONTROL_MSG_TYPE_SET_CLIPBOARD:
+            size += strlen(msg->set_clipboard.text) + 1;
+            break;
+        case SC_CONTROL_MSG_TYPE_START_APP:
+            size += strlen(msg->start_app.name) + 1;
+            break;
+        default:
+            break;
+    }
+    return size;
+}
+
 void
 sc_controller_destroy(struct sc_controller *controller) {
-    sc_cond_destroy(&controller->msg_cond);
+    sc_ring_waiter_destroy(&controller->waiter);
     sc_mutex_destroy(&controller->mutex);
 
-    while (!sc_vecdeque_is_empty(&controller->queue)) {
-        struct sc_control_msg *msg = sc_vecdeque_popref(&controller->queue);
+    // The controller thread is joined, the current thread may pop
+    struct sc_control_msg pending;
+    while (sc_spsc_ring_pop(&controller->ring, &pending)) {
+        sc_control_msg_destroy(&pending);
+    }
+
+    while (!sc_vecdeque_is_empty(&controller->overflow)) {
+        struct sc_control_msg *msg = sc_vecdeque_popref(&controller->overflow);
         assert(msg);
+        sc_memory_budget_release(SC_MEMORY_BUDGET_CONTROL,
+                                 sc_control_msg_get_memory_size(msg));
         sc_control_msg_destroy(msg);
     }
-    sc_vecdeque_destroy(&controller->queue);
+    sc_vecdeque_destroy(&controller->overflow);
+
+    free(controller->clipboard_stream.text);
+
+    if (controller->record.file) {
+        fclose(controller->record.file);
+    }
 
     sc_receiver_destroy(&controller->receiver);
 }
 
+bool
+sc_controller_record(struct sc_controller *controller, const char *filename) {
+    assert(!controller->record.file);
+
+    controller->record.file = sc_file_open(filename, "wb");
+    if (!controller->record.file) {
+        LOGE("Could not open control record file: %s", filename);
+        return false;
+    }
+
+    controller->record.start = sc_tick_now();
+    LOGI("Recording control messages to %s", filename);
+    return true;
+}
+
+// Reserve the memory of a msg to append to the overflow queue
+//
+// Only a droppable msg may be refused: a non-droppable one (e.g. the up event
+// matching a down event already sent) is always kept. The producer is the SDL
+// event thread, so it never waits for the budget: a non-droppable msg is
+// counted beyond the limit instead.
+static bool
+sc_controller_reserve_overflow(struct sc_controller *controller,
+                               const struct sc_control_msg *msg,
+                               uint64_t size) {
+    sc_mutex_assert(&controller->mutex);
+
+    if (sc_memory_budget_reserve(SC_MEMORY_BUDGET_CONTROL, size)) {
+        controller->budget_exceeded = false;
+        return true;
+    }
+
+    if (sc_control_msg_is_droppable(msg)) {
+        return false;
+    }
+
+    sc_memory_budget_force_reserve(SC_MEMORY_BUDGET_CONTROL, size);
+    if (!controller->budget_exceeded) {
+        // Log once until a reservation succeeds again
+        controller->budget_exceeded = true;
+        LOGW("Control memory budget exceeded: %" PRIu64_ " bytes used (limit %"
+             PRIu64_ ")", sc_memory_budget_get_total(),
+             sc_memory_budget_get_limit());
+    }
+    return true;
+}
+
 bool
 sc_controller_push_msg(struct sc_controller *controller,
                        const struct sc_control_msg *msg) {
@@ -96,50 +206,367 @@ sc_controller_push_msg(struct sc_controller *controller,
         sc_control_msg_log(msg);
     }
 
-    bool pushed = false;
+    uint32_t ring_size = sc_spsc_ring_size(&controller->ring);
+    // Only the producer increments overflow_count, so it may only be
+    // overestimated
+    uint32_t overflow_count =
+        atomic_load_explicit(&controller->overflow_count,
+                             memory_order_acquire);
+
+    if (ring_size + overflow_count >= SC_CONTROL_MSG_QUEUE_LIMIT
+            && sc_control_msg_is_droppable(msg)) {
+        // The msg is discarded
+        sc_stats_inc(SC_STATS_CONTROL_MSGS_DROPPED);
+        return false;
+    }
 
-    sc_mutex_lock(&controller->mutex);
-    size_t size = sc_vecdeque_size(&controller->queue);
-    if (size < SC_CONTROL_MSG_QUEUE_LIMIT) {
-        bool was_empty = sc_vecdeque_is_empty(&controller->queue);
-        sc_vecdeque_push_noresize(&controller->queue, *msg);
-        pushed = true;
-        if (was_empty) {
-            sc_cond_signal(&controller->msg_cond);
+    bool pushed = !overflow_count && sc_spsc_ring_push(&controller->ring, *msg);
+    if (!pushed) {
+        // Slow path: the ring is full of pending msgs, or older msgs are in
+        // the overflow queue
+        uint64_t size = sc_control_msg_get_memory_size(msg);
+
+        sc_mutex_lock(&controller->mutex);
+        if (!sc_controller_reserve_overflow(controller, msg, size)) {
+            // Only droppable msgs are refused
+            sc_mutex_unlock(&controller->mutex);
+            sc_stats_inc(SC_STATS_CONTROL_MSGS_DROPPED);
+            return false;
         }
-    } else if (!sc_control_msg_is_droppable(msg)) {
-        bool ok = sc_vecdeque_push(&controller->queue, *msg);
+
+        bool ok = sc_vecdeque_push(&controller->overflow, *msg);
         if (ok) {
-            pushed = true;
+            atomic_fetch_add_explicit(&controller->overflow_count, 1,
+                                      memory_order_seq_cst);
         } else {
+            sc_memory_budget_release(SC_MEMORY_BUDGET_CONTROL, size);
+        }
+        sc_mutex_unlock(&controller->mutex);
+
+        if (!ok) {
             // A non-droppable event must be dropped anyway
             LOG_OOM();
+            return false;
         }
     }
-    // Otherwise, the msg is discarded
 
+    sc_ring_waiter_notify(&controller->waiter);
+
+    return true;
+}
+
+uint32_t
+sc_controller_get_queue_depth(struct sc_controller *controller) {
+    uint32_t overflow_count =
+        atomic_load_explicit(&controller->overflow_count,
+                             memory_order_relaxed);
+    return sc_spsc_ring_size(&controller->ring) + overflow_count;
+}
+
+uint32_t
+sc_controller_get_queue_limit(void) {
+    return SC_CONTROL_MSG_QUEUE_LIMIT;
+}
+
+static bool
+sc_controller_pop_msg(struct sc_controller *controller,
+                      struct sc_control_msg *msg) {
+    if (sc_spsc_ring_pop(&controller->ring, msg)) {
+        return true;
+    }
+
+    // The ring is empty, so the overflow msgs (if any) are the oldest
+    if (!atomic_load_explicit(&controller->overflow_count,
+                              memory_order_acquire)) {
+        return false;
+    }
+
+    sc_mutex_lock(&controller->mutex);
+    assert(!sc_vecdeque_is_empty(&controller->overflow));
+    *msg = sc_vecdeque_pop(&controller->overflow);
+    atomic_fetch_sub_explicit(&controller->overflow_count, 1,
+                              memory_order_release);
+    sc_memory_budget_release(SC_MEMORY_BUDGET_CONTROL,
+                             sc_control_msg_get_memory_size(msg));
     sc_mutex_unlock(&controller->mutex);
 
-    return pushed;
+    return true;
+}
+
+static bool
+sc_controller_has_msg(struct sc_controller *controller) {
+    return !sc_spsc_ring_is_empty(&controller->ring)
+        || atomic_load_explicit(&controller->overflow_count,
+                                memory_order_seq_cst);
+}
+
+static void
+sc_controller_wait_msg(struct sc_controller *controller) {
+    sc_ring_waiter_wait(&controller->waiter,
+        atomic_load_explicit(&controller->stopped, memory_order_relaxed)
+            || sc_controller_has_msg(controller));
+}
+
+static bool
+sc_controller_pop_next_msg(struct sc_controller *controller,
+                           struct sc_control_msg *msg) {
+    if (atomic_load_explicit(&controller->stopped, memory_order_relaxed)) {
+        // do not process further msgs
+        return false;
+    }
+
+    return sc_controller_pop_msg(controller, msg);
 }
 
+// The msgs are serialized contiguously, and sent with a single call once the
+// queue is drained (or once the batch size is reached). Any position below
+// SC_CONTROL_MSG_BATCH_SIZE leaves room for a msg of maximal size.
+static uint8_t sc_controller_buf[SC_CONTROL_MSG_BATCH_SIZE
+                                 + SC_CONTROL_MSG_MAX_SIZE];
+
 static bool
-process_msg(struct sc_controller *controller,
-            const struct sc_control_msg *msg, bool *eos) {
-    static uint8_t serialized_msg[SC_CONTROL_MSG_MAX_SIZE];
-    size_t length = sc_control_msg_serialize(msg, serialized_msg);
-    if (!length) {
+sc_controller_flush(struct sc_controller *controller, size_t *length,
+                    bool *eos) {
+    if (*length) {
+        ssize_t w = net_send_all(controller->control_socket,
+                                 sc_controller_buf, *length);
+        if ((size_t) w != *length) {
+            *eos = true;
+            return false;
+        }
+        *length = 0;
+    }
+
+    return true;
+}
+
+static void
+sc_controller_record_msg(struct sc_controller *controller, const uint8_t *data,
+                         size_t len) {
+    FILE *file = controller->record.file;
+    assert(file);
+
+    uint8_t header[SC_CONTROL_RECORD_HEADER_SIZE];
+    sc_write64be(header, sc_tick_now() - controller->record.start);
+    sc_write32be(&header[8], len);
+
+    if (fwrite(header, sizeof(header), 1, file) != 1
+            || fwrite(data, len, 1, file) != 1) {
+        // Do not interrupt the control stream
+        LOGW("Could not write control record, recording stopped");
+        fclose(file);
+        controller->record.file = NULL;
+    }
+}
+
+static bool
+sc_controller_append(struct sc_controller *controller,
+                     const struct sc_control_msg *msg, size_t *length,
+                     bool *eos) {
+    assert(*length < SC_CONTROL_MSG_BATCH_SIZE);
+    size_t n = sc_control_msg_serialize(msg, &sc_controller_buf[*length]);
+    if (!n) {
         *eos = false;
         return false;
     }
 
-    ssize_t w =
-        net_send_all(controller->control_socket, serialized_msg, length);
-    if ((size_t) w != length) {
-        *eos = true;
+    if (controller->record.file) {
+        sc_controller_record_msg(controller, &sc_controller_buf[*length], n);
+    }
+
+    *length += n;
+    if (*length >= SC_CONTROL_MSG_BATCH_SIZE) {
+        return sc_controller_flush(controller, length, eos);
+    }
+
+    return true;
+}
+
+static bool
+sc_controller_has_clipboard_chunk(struct sc_controller *controller) {
+    return controller->clipboard_stream.text
+        && controller->clipboard_stream.offset
+                < controller->clipboard_stream.length;
+}
+
+static void
+sc_controller_next_clipboard_chunk(struct sc_controller *controller,
+                                   struct sc_control_msg *chunk) {
+    assert(sc_controller_has_clipboard_chunk(controller));
+    struct sc_controller *c = controller;
+    size_t size = MIN(c->clipboard_stream.length - c->clipboard_stream.offset,
+                      SC_CONTROL_MSG_CLIPBOARD_CHUNK_SIZE);
+
+    chunk->type = SC_CONTROL_MSG_TYPE_SET_CLIPBOARD_CHUNK;
+    chunk->set_clipboard_chunk.sequence = c->clipboard_stream.sequence;
+    chunk->set_clipboard_chunk.paste = c->clipboard_stream.paste;
+    // The text remains valid until the next stream starts
+    chunk->set_clipboard_chunk.data =
+        &c->clipboard_stream.text[c->clipboard_stream.offset];
+    chunk->set_clipboard_chunk.size = size;
+
+    c->clipboard_stream.offset += size;
+    chunk->set_clipboard_chunk.last =
+        c->clipboard_stream.offset == c->clipboard_stream.length;
+}
+
+static void
+sc_controller_end_clipboard_stream(struct sc_controller *controller) {
+    assert(!sc_controller_has_clipboard_chunk(controller));
+    free(controller->clipboard_stream.text);
+    controller->clipboard_stream.text = NULL;
+}
+
+// Take ownership of the text of a SET_CLIPBOARD msg, to stream it in chunks
+static void
+sc_controller_start_clipboard_stream(struct sc_controller *controller,
+                                     struct sc_control_msg *msg,
+                                     size_t length) {
+    sc_controller_end_clipboard_stream(controller);
+
+    controller->clipboard_stream.text = msg->set_clipboard.text;
+    controller->clipboard_stream.length = length;
+    controller->clipboard_stream.offset = 0;
+    controller->clipboard_stream.sequence = msg->set_clipboard.sequence;
+    controller->clipboard_stream.paste = msg->set_clipboard.paste;
+
+    msg->set_clipboard.text = NULL;
+}
+
+// Send a text too long for a single INJECT_TEXT msg in INJECT_TEXT_CHUNK msgs
+//
+// Contrary to the clipboard chunks, they are all appended immediately: the
+// text must be injected before any input event pushed after it.
+static bool
+sc_controller_append_text_chunks(struct sc_controller *controller,
+                                 const char *text, size_t len, size_t *length,
+                                 bool *eos) {
+    struct sc_control_msg chunk;
+    chunk.type = SC_CONTROL_MSG_TYPE_INJECT_TEXT_CHUNK;
+    chunk.inject_text_chunk.sequence = controller->next_text_sequence++;
+
+    size_t offset = 0;
+    do {
+        // The device reassembles the bytes, a chunk may split a UTF-8 char
+        size_t size = MIN(len - offset, SC_CONTROL_MSG_INJECT_TEXT_CHUNK_SIZE);
+        chunk.inject_text_chunk.data = &text[offset];
+        chunk.inject_text_chunk.size = size;
+        offset += size;
+        chunk.inject_text_chunk.last = offset == len;
+
+        if (!sc_controller_append(controller, &chunk, length, eos)) {
+            return false;
+        }
+    } while (offset < len);
+
+    return true;
+}
+
+// Process a single msg (it takes ownership of `msg`)
+static bool
+process_msg(struct sc_controller *controller, struct sc_control_msg *msg,
+            size_t *length, bool *eos) {
+    // Without text chunks, a long text is truncated on serialization
+    if (controller->text_chunks
+            && msg->type == SC_CONTROL_MSG_TYPE_INJECT_TEXT
+            && strlen(msg->inject_text.text)
+                > SC_CONTROL_MSG_INJECT_TEXT_MAX_LENGTH) {
+        const char *text = msg->inject_text.text;
+        size_t len = sc_str_utf8_truncation_index(
+                text, SC_CONTROL_MSG_CLIPBOARD_TEXT_MAX_LENGTH);
+        bool ok = sc_controller_append_text_chunks(controller, text, len,
+                                                   length, eos);
+        sc_control_msg_destroy(msg);
+        return ok;
+    }
+
+    if (msg->type == SC_CONTROL_MSG_TYPE_SET_CLIPBOARD
+            && msg->set_clipboard.text) {
+        // Send the end of the previous clipboard text first, to preserve the
+        // order of the clipboard changes
+        while (sc_controller_has_clipboard_chunk(controller)) {
+            struct sc_control_msg chunk;
+            sc_controller_next_clipboard_chunk(controller, &chunk);
+            if (!sc_controller_append(controller, &chunk, length, eos)) {
+                sc_control_msg_destroy(msg);
+                return false;
+            }
+        }
+
+        const char *text = msg->set_clipboard.text;
+        size_t len = sc_str_utf8_truncation_index(
+                text, SC_CONTROL_MSG_CLIPBOARD_TEXT_MAX_LENGTH);
+        if (controller->clipboard_chunks
+                && len > SC_CONTROL_MSG_CLIPBOARD_CHUNK_SIZE) {
+            // Do not block the input msgs behind a large clipboard text: send
+            // it in chunks, one at a time once the queue is drained
+            sc_controller_start_clipboard_stream(controller, msg, len);
+            sc_control_msg_destroy(msg);
+            return true;
+        }
+    }
+
+    bool ok = sc_controller_append(controller, msg, length, eos);
+    sc_control_msg_destroy(msg);
+    return ok;
+}
+
+// Process `msg` and all the msgs already queued (it takes ownership of `msg`)
+static bool
+process_msgs(struct sc_controller *controller, struct sc_control_msg *msg,
+             bool *eos) {
+    size_t length = 0;
+
+    bool has_next;
+    do {
+        struct sc_control_msg next;
+        has_next = sc_controller_pop_next_msg(controller, &next);
+        while (has_next && sc_control_msg_coalesce(msg, &next)) {
+            // Only droppable msgs owning no data are coalesced
+            has_next = sc_controller_pop_next_msg(controller, &next);
+        }
+
+        if (!process_msg(controller, msg, &length, eos)) {
+            if (has_next) {
+                sc_control_msg_destroy(&next);
+            }
+            return false;
+        }
+
+        if (has_next) {
+            *msg = next;
+        }
+    } while (has_next);
+
+    return sc_controller_flush(controller, &length, eos);
+}
+
+static bool
+sc_controller_resume(struct sc_controller *controller) {
+    if (!controller->cbs->on_disconnected) {
+        return false;
+    }
+
+    sc_socket socket =
+        controller->cbs->on_disconnected(controller,
+                                         controller->control_socket,
+                                         controller->cbs_userdata);
+    if (socket == SC_SOCKET_NONE) {
         return false;
     }
 
+    controller->control_socket = socket;
+
+    if (controller->clipboard_stream.text) {
+        // The device dropped the chunks received on the previous connection,
+        // the clipboard text cannot be completed
+        LOGW("Clipboard transfer interrupted by the disconnection");
+        controller->clipboard_stream.offset =
+            controller->clipboard_stream.length;
+        sc_controller_end_clipboard_stream(controller);
+    }
+
+    LOGD("Controller resumed");
     return true;
 }
 
@@ -147,29 +574,36 @@ static int
 run_controller(void *data) {
     struct sc_controller *controller = data;
 
+    sc_thread_apply_policy(SC_THREAD_ROLE_CONTROL);
+
     bool error = false;
 
     for (;;) {
-        sc_mutex_lock(&controller->mutex);
-        while (!controller->stopped
-                && sc_vecdeque_is_empty(&controller->queue)) {
-            sc_cond_wait(&controller->msg_cond, &controller->mutex);
-        }
-        if (controller->stopped) {
+        if (atomic_load_explicit(&controller->stopped, memory_order_relaxed)) {
             // stop immediately, do not process further msgs
-            sc_mutex_unlock(&controller->mutex);
             LOGD("Controller stopped");
             break;
         }
 
-        assert(!sc_vecdeque_is_empty(&controller->queue));
-        struct sc_control_msg msg = sc_vecdeque_pop(&controller->queue);
-        sc_mutex_unlock(&controller->mutex);
+        struct sc_control_msg msg;
+        if (!sc_controller_pop_msg(controller, &msg)) {
+            if (!sc_controller_has_clipboard_chunk(controller)) {
+                sc_controller_wait_msg(controller);
+                continue;
+            }
+
+            // The queue is empty, send the next chunk of the clipboard text
+            sc_controller_next_clipboard_chunk(controller, &msg);
+        }
 
         bool eos;
-        bool ok = process_msg(controller, &msg, &eos);
-        sc_control_msg_destroy(&msg);
+        bool ok = process_msgs(controller, &msg, &eos);
         if (!ok) {
+            if (eos && sc_controller_resume(controller)) {
+                // The msgs sent during the disconnection are lost
+                continue;
+            }
+
             if (eos) {
                 LOGD("Controller stopped (socket closed)");
             } // else error already logged
@@ -183,6 +617,16 @@ run_controller(void *data) {
     return 0;
 }
 
+void
+sc_controller_enable_clipboard_chunks(struct sc_controller *controller) {
+    controller->clipboard_chunks = true;
+}
+
+void
+sc_controller_enable_text_chunks(struct sc_controller *controller) {
+    controller->text_chunks = true;
+}
+
 bool
 sc_controller_start(struct sc_controller *controller) {
     LOGD("Starting controller thread");
@@ -205,10 +649,8 @@ sc_controller_start(struct sc_controller *controller) {
 
 void
 sc_controller_stop(struct sc_controller *controller) {
-    sc_mutex_lock(&controller->mutex);
-    controller->stopped = true;
-    sc_cond_signal(&controller->msg_cond);
-    sc_mutex_unlock(&controller->mutex);
+    atomic_store_explicit(&controller->stopped, true, memory_order_relaxed);
+    sc_ring_waiter_wake_up(&controller->waiter);
 }
 
 void
@@ -3,24 +3,83 @@
 
 #include "common.h"
 
+#include <stdatomic.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
 
 #include "control_msg.h"
 #include "receiver.h"
 #include "util/acksync.h"
 #include "util/net.h"
+#include "util/ring_waiter.h"
+#include "util/spsc_ring.h"
 #include "util/thread.h"
+#include "util/tick.h"
 #include "util/vecdeque.h"
 
+// Must be a power of 2
+#define SC_CONTROL_MSG_RING_SIZE 64
+
+// Header of each recorded msg: timestamp (8 bytes) and length (4 bytes)
+#define SC_CONTROL_RECORD_HEADER_SIZE 12
+
 struct sc_control_msg_queue SC_VECDEQUE(struct sc_control_msg);
+struct sc_control_msg_ring SC_SPSC_RING(struct sc_control_msg,
+                                        SC_CONTROL_MSG_RING_SIZE);
 
 struct sc_controller {
     sc_socket control_socket;
     sc_thread thread;
     sc_mutex mutex;
-    sc_cond msg_cond;
-    bool stopped;
-    struct sc_control_msg_queue queue;
+    atomic_bool stopped;
+
+    // Messages are pushed from the main thread and popped by the controller
+    // thread
+    struct sc_control_msg_ring ring;
+
+    // Non-droppable messages which did not fit in the ring (protected by the
+    // mutex). While it is not empty, all new messages are appended to it, to
+    // preserve their order.
+    struct sc_control_msg_queue overflow;
+    atomic_uint_least32_t overflow_count;
+    // The memory budget exceeded warning has been logged (protected by the
+    // mutex)
+    bool budget_exceeded;
+
+    // The producer only locks its mutex when the controller thread is
+    // waiting for a message
+    struct sc_ring_waiter waiter;
+
+    // Stream the large clipboard texts in SET_CLIPBOARD_CHUNK msgs (see
+    // sc_controller_enable_clipboard_chunks())
+    bool clipboard_chunks;
+
+    // Large clipboard text being streamed in chunks (only accessed from the
+    // controller thread)
+    struct {
+        char *text; // owned, NULL if none
+        size_t length;
+        size_t offset; // chunks already sent
+        uint64_t sequence;
+        bool paste;
+    } clipboard_stream;
+
+    // Stream the long injected texts in INJECT_TEXT_CHUNK msgs (see
+    // sc_controller_enable_text_chunks())
+    bool text_chunks;
+
+    // Sequence of the next text streamed in INJECT_TEXT_CHUNK msgs (only
+    // accessed from the controller thread)
+    uint64_t next_text_sequence;
+
+    // Recording of the serialized msgs (only accessed from the controller
+    // thread once started)
+    struct {
+        FILE *file; // NULL if not recording
+        sc_tick start;
+    } record;
+
     struct sc_receiver receiver;
 
     const struct sc_controller_callbacks *cbs;
@@ -30,6 +89,12 @@ struct sc_controller {
 struct sc_controller_callbacks {
     void (*on_ended)(struct sc_controller *controller, bool error,
                      void *userdata);
+
+    // Optional: called (from the controller thread and from the receiver
+    // thread) when the control socket is closed, return a new socket to
+    // continue (or SC_SOCKET_NONE to stop)
+    sc_socket (*on_disconnected)(struct sc_controller *controller,
+                                 sc_socket socket, void *userdata);
 };
 
 bool
@@ -45,6 +110,41 @@ sc_controller_configure(struct sc_controller *controller,
 void
 sc_controller_destroy(struct sc_controller *controller);
 
+/**
+ * Record the msgs sent to the device to a file
+ *
+ * The msgs are written as they are sent (i.e. after coalescing), each one
+ * prefixed by a header: the timestamp in microseconds since the start of the
+ * recording (64 bits) and the length of the serialized msg (32 bits), in
+ * big-endian.
+ *
+ * Must be called before sc_controller_start().
+ */
+bool
+sc_controller_record(struct sc_controller *controller, const char *filename);
+
+/**
+ * Stream the clipboard texts larger than SC_CONTROL_MSG_CLIPBOARD_CHUNK_SIZE
+ * in SET_CLIPBOARD_CHUNK msgs rather than in a single SET_CLIPBOARD msg
+ *
+ * The server must support SET_CLIPBOARD_CHUNK msgs.
+ *
+ * Must be called before sc_controller_start().
+ */
+void
+sc_controller_enable_clipboard_chunks(struct sc_controller *controller);
+
+/**
+ * Stream the texts longer than SC_CONTROL_MSG_INJECT_TEXT_MAX_LENGTH in
+ * INJECT_TEXT_CHUNK msgs rather than truncating them
+ *
+ * The server must support INJECT_TEXT_CHUNK msgs.
+ *
+ * Must be called before sc_controller_start().
+ */
+void
+sc_controller_enable_text_chunks(struct sc_controller *controller);
+
 bool
 sc_controller_start(struct sc_controller *controller);
 
@@ -54,8 +154,31 @@ sc_controller_stop(struct sc_controller *controller);
 void
 sc_controller_join(struct sc_controller *controller);
 
+/**
+ * Push a message to send to the device
+ *
+ * Must always be called from the same thread (the main thread).
+ *
+ * Droppable messages are discarded (and false is returned) when too many
+ * messages are pending.
+ */
 bool
 sc_controller_push_msg(struct sc_controller *controller,
                        const struct sc_control_msg *msg);
 
+/**
+ * Return the number of messages waiting to be sent
+ *
+ * It may be called from any thread (it does not lock), the result is
+ * approximate.
+ */
+uint32_t
+sc_controller_get_queue_depth(struct sc_controller *controller);
+
+/**
+ * Return the queue depth above which droppable messages are discarded
+ */
+uint32_t
+sc_controller_get_queue_limit(void);
+
 #endif
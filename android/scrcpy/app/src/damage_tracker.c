@@ -0,0 +1,256 @@
+#include "damage_tracker.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <libavutil/pixfmt.h>
+
+#include "util/log.h"
+#include "util/yuv.h"
+
+#define TILE SC_DAMAGE_TRACKER_TILE_SIZE
+
+void
+sc_damage_tracker_init(struct sc_damage_tracker *tracker) {
+    tracker->hashes = NULL;
+    tracker->dirty = NULL;
+    tracker->states = NULL;
+    tracker->cols = 0;
+    tracker->rows = 0;
+    tracker->size.width = 0;
+    tracker->size.height = 0;
+    tracker->pix_fmt = AV_PIX_FMT_NONE;
+    tracker->valid = false;
+}
+
+void
+sc_damage_tracker_destroy(struct sc_damage_tracker *tracker) {
+    free(tracker->hashes);
+    free(tracker->dirty);
+    free(tracker->states);
+}
+
+void
+sc_damage_tracker_reset(struct sc_damage_tracker *tracker) {
+    tracker->valid = false;
+}
+
+static bool
+sc_damage_tracker_configure(struct sc_damage_tracker *tracker,
+                            const AVFrame *frame) {
+    struct sc_size size = {frame->width, frame->height};
+    if (tracker->states && size.width == tracker->size.width
+            && size.height == tracker->size.height
+            && frame->format == tracker->pix_fmt) {
+        return true;
+    }
+
+    unsigned cols = (size.width + TILE - 1) / TILE;
+    unsigned rows = (size.height + TILE - 1) / TILE;
+    size_t count = (size_t) cols * rows;
+
+    uint64_t *hashes = realloc(tracker->hashes, count * sizeof(*hashes));
+    if (!hashes) {
+        goto error;
+    }
+    tracker->hashes = hashes;
+
+    bool *dirty = realloc(tracker->dirty, count * sizeof(*dirty));
+    if (!dirty) {
+        goto error;
+    }
+    tracker->dirty = dirty;
+
+    uint32_t *states =
+        realloc(tracker->states, cols * SC_YUV_HASH_LANES * sizeof(*states));
+    if (!states) {
+        goto error;
+    }
+    tracker->states = states;
+
+    tracker->cols = cols;
+    tracker->rows = rows;
+    tracker->size = size;
+    tracker->pix_fmt = frame->format;
+    tracker->valid = false;
+    return true;
+
+error:
+    LOG_OOM();
+    // The arrays may have been reallocated, force a new configuration
+    tracker->size.width = 0;
+    tracker->size.height = 0;
+    tracker->valid = false;
+    return false;
+}
+
+// Accumulate the rows [y0, y1) of a plane, split into tiles of tile_width
+// bytes, into the states of the tiles of one tile row
+static void
+sc_damage_tracker_hash_plane(uint32_t *states, unsigned cols,
+                             const uint8_t *data, int linesize,
+                             unsigned width, unsigned tile_width,
+                             unsigned y0, unsigned y1) {
+    for (unsigned y = y0; y < y1; ++y) {
+        const uint8_t *row = data + (size_t) y * linesize;
+        for (unsigned col = 0; col < cols; ++col) {
+            unsigned x = col * tile_width;
+            unsigned len = MIN(tile_width, width - x);
+            sc_yuv_hash_row(&states[col * SC_YUV_HASH_LANES], row + x, len);
+        }
+    }
+}
+
+static unsigned
+sc_damage_tracker_compute_dirty(struct sc_damage_tracker *tracker,
+                                const AVFrame *frame) {
+    uint32_t *states = tracker->states;
+    unsigned cols = tracker->cols;
+    unsigned width = tracker->size.width;
+    unsigned height = tracker->size.height;
+    unsigned chroma_width = (width + 1) / 2;
+    unsigned chroma_height = (height + 1) / 2;
+    bool nv12 = frame->format == AV_PIX_FMT_NV12;
+
+    unsigned dirty_count = 0;
+    for (unsigned row = 0; row < tracker->rows; ++row) {
+        for (unsigned col = 0; col < cols; ++col) {
+            sc_yuv_hash_init(&states[col * SC_YUV_HASH_LANES]);
+        }
+
+        // Process the tile row line by line, for sequential memory accesses
+        unsigned y0 = row * TILE;
+        unsigned y1 = MIN(y0 + TILE, height);
+        sc_damage_tracker_hash_plane(states, cols, frame->data[0],
+                                     frame->linesize[0], width, TILE, y0, y1);
+
+        unsigned cy0 = y0 / 2;
+        unsigned cy1 = MIN(cy0 + TILE / 2, chroma_height);
+        if (nv12) {
+            // Interleaved UV: 2 bytes per chroma sample
+            sc_damage_tracker_hash_plane(states, cols, frame->data[1],
+                                         frame->linesize[1], 2 * chroma_width,
+                                         TILE, cy0, cy1);
+        } else {
+            sc_damage_tracker_hash_plane(states, cols, frame->data[1],
+                                         frame->linesize[1], chroma_width,
+                                         TILE / 2, cy0, cy1);
+            sc_damage_tracker_hash_plane(states, cols, frame->data[2],
+                                         frame->linesize[2], chroma_width,
+                                         TILE / 2, cy0, cy1);
+        }
+
+        for (unsigned col = 0; col < cols; ++col) {
+            size_t index = (size_t) row * cols + col;
+            uint64_t hash =
+                sc_yuv_hash_final(&states[col * SC_YUV_HASH_LANES]);
+            bool dirty = !tracker->valid || hash != tracker->hashes[index];
+            tracker->hashes[index] = hash;
+            tracker->dirty[index] = dirty;
+            dirty_count += dirty;
+        }
+    }
+
+    return dirty_count;
+}
+
+static inline void
+sc_damage_rect_set_full(struct sc_damage_rect *rect, struct sc_size size) {
+    rect->x = 0;
+    rect->y = 0;
+    rect->width = size.width;
+    rect->height = size.height;
+}
+
+unsigned
+sc_damage_tracker_update(struct sc_damage_tracker *tracker,
+                         const AVFrame *frame, struct sc_damage_rect *rects) {
+    assert(frame->format == AV_PIX_FMT_YUV420P
+        || frame->format == AV_PIX_FMT_NV12);
+
+    struct sc_size size = {frame->width, frame->height};
+
+    if (!sc_damage_tracker_configure(tracker, frame)) {
+        // Not tracked, the next frames will be fully updated
+        sc_damage_rect_set_full(&rects[0], size);
+        return 1;
+    }
+
+    bool was_valid = tracker->valid;
+    unsigned dirty_count = sc_damage_tracker_compute_dirty(tracker, frame);
+    tracker->valid = true;
+
+    if (!dirty_count) {
+        return 0;
+    }
+
+    unsigned tile_count = tracker->cols * tracker->rows;
+    if (!was_valid || dirty_count * 2 > tile_count) {
+        sc_damage_rect_set_full(&rects[0], size);
+        return 1;
+    }
+
+    // One rectangle per tile row spanning its dirty tiles, merged with the
+    // previous one if they span the same columns
+    unsigned count = 0;
+    bool overflow = false;
+    unsigned min_col = tracker->cols;
+    unsigned max_col = 0;
+    unsigned min_row = tracker->rows;
+    unsigned max_row = 0;
+    for (unsigned row = 0; row < tracker->rows; ++row) {
+        const bool *dirty = &tracker->dirty[row * tracker->cols];
+        unsigned first = tracker->cols;
+        unsigned last = 0;
+        for (unsigned col = 0; col < tracker->cols; ++col) {
+            if (dirty[col]) {
+                first = MIN(first, col);
+                last = col;
+            }
+        }
+        if (first == tracker->cols) {
+            continue;
+        }
+
+        min_col = MIN(min_col, first);
+        max_col = MAX(max_col, last);
+        min_row = MIN(min_row, row);
+        max_row = row;
+
+        uint16_t x = first * TILE;
+        uint16_t y = row * TILE;
+        uint16_t width = MIN((last + 1) * TILE, size.width) - x;
+        uint16_t height = MIN(y + TILE, size.height) - y;
+
+        if (count) {
+            struct sc_damage_rect *prev = &rects[count - 1];
+            if (prev->x == x && prev->width == width
+                    && prev->y + prev->height == y) {
+                prev->height += height;
+                continue;
+            }
+        }
+
+        if (count == SC_DAMAGE_TRACKER_MAX_RECTS) {
+            overflow = true;
+            continue;
+        }
+
+        struct sc_damage_rect *rect = &rects[count++];
+        rect->x = x;
+        rect->y = y;
+        rect->width = width;
+        rect->height = height;
+    }
+
+    assert(count);
+    if (overflow) {
+        // Too many rectangles, update their bounding box
+        rects[0].x = min_col * TILE;
+        rects[0].y = min_row * TILE;
+        rects[0].width = MIN((max_col + 1) * TILE, size.width) - rects[0].x;
+        rects[0].height = MIN((max_row + 1) * TILE, size.height) - rects[0].y;
+        return 1;
+    }
+
+    return count;
+}
@@ -0,0 +1,70 @@
+#ifndef SC_DAMAGE_TRACKER_H
+#define SC_DAMAGE_TRACKER_H
+
+#include "common.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <libavutil/frame.h>
+
+#include "coords.h"
+
+#define SC_DAMAGE_TRACKER_TILE_SIZE 64
+#define SC_DAMAGE_TRACKER_MAX_RECTS 8
+
+struct sc_damage_rect {
+    uint16_t x;
+    uint16_t y;
+    uint16_t width;
+    uint16_t height;
+};
+
+/**
+ * Detect the regions which changed between consecutive frames
+ *
+ * Each frame is split into tiles of SC_DAMAGE_TRACKER_TILE_SIZE pixels (on
+ * all the YUV 4:2:0 planes), whose hashes are compared to those of the
+ * previous frame. The hashes are computed by sc_yuv_hash_row(), so
+ * sc_yuv_init() should have been called.
+ *
+ * Only the hashes are stored, not the previous frame.
+ */
+struct sc_damage_tracker {
+    uint64_t *hashes; // cols * rows, of the previous frame
+    bool *dirty; // cols * rows, for the current frame
+    uint32_t *states; // cols * SC_YUV_HASH_LANES, hash states of a tile row
+    unsigned cols;
+    unsigned rows;
+    struct sc_size size;
+    int pix_fmt;
+    bool valid; // false if the next frame must be fully updated
+};
+
+void
+sc_damage_tracker_init(struct sc_damage_tracker *tracker);
+
+void
+sc_damage_tracker_destroy(struct sc_damage_tracker *tracker);
+
+/**
+ * Force the next frame to be fully damaged
+ *
+ * To be called whenever the destination has been lost or not updated.
+ */
+void
+sc_damage_tracker_reset(struct sc_damage_tracker *tracker);
+
+/**
+ * Compute the damaged regions of a new YUV420P or NV12 frame
+ *
+ * Write at most SC_DAMAGE_TRACKER_MAX_RECTS rectangles (with even coordinates)
+ * to `rects`, and return their number (0 if the frame did not change).
+ *
+ * If more than half of the frame changed, a single rectangle covering the
+ * whole frame is returned.
+ */
+unsigned
+sc_damage_tracker_update(struct sc_damage_tracker *tracker,
+                         const AVFrame *frame, struct sc_damage_rect *rects);
+
+#endif
@@ -1,14 +1,238 @@
 #include "decoder.h"
 
+#include <assert.h>
 #include <errno.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
 #include <libavcodec/packet.h>
 #include <libavutil/avutil.h>
+#include <libavutil/cpu.h>
+#ifdef SCRCPY_LAVC_HAS_HW_CONFIG
+# include <libavutil/hwcontext.h>
+#endif
 
+#include "latency_tracer.h"
+#include "packet_merger.h"
+#include "stats.h"
 #include "util/log.h"
+#include "util/nal.h"
+#include "util/tick.h"
 
 /** Downcast packet_sink to decoder */
 #define DOWNCAST(SINK) container_of(SINK, struct sc_decoder, packet_sink)
 
+// Above this size, the video is decoded on several threads by default
+#define SC_DECODER_AUTO_THREADS_MIN_PIXELS (1280 * 720 * 2)
+#define SC_DECODER_AUTO_THREADS_MAX 4
+
+// Do not accumulate the skipped frames indefinitely: only the packets
+// received shortly after the display skipped frames may be dropped
+#define SC_DECODER_SKIP_BUDGET_MAX 8
+
+// Let the base delay follow slowly an increase (by 1/N of the difference on
+// each packet), to absorb the drift between the device and local clocks
+#define SC_DECODER_CATCH_UP_BASE_DRIFT 4096
+
+// Minimal delay between two catch-ups, so that a stale key frame still in the
+// backlog does not trigger a new key frame request immediately
+#define SC_DECODER_CATCH_UP_COOLDOWN SC_TICK_FROM_SEC(1)
+
+#ifdef SCRCPY_LAVC_HAS_HW_CONFIG
+static enum AVPixelFormat
+sc_decoder_get_hw_format(AVCodecContext *ctx, const enum AVPixelFormat *fmts) {
+    struct sc_decoder *decoder = ctx->opaque;
+
+    for (const enum AVPixelFormat *p = fmts; *p != AV_PIX_FMT_NONE; ++p) {
+        if (*p == decoder->hw_pix_fmt) {
+            return *p;
+        }
+    }
+
+    LOGE("Decoder '%s': hardware surface format not available",
+         decoder->name);
+    return AV_PIX_FMT_NONE;
+}
+
+static enum AVPixelFormat
+sc_decoder_find_hw_pix_fmt(const AVCodec *codec, enum AVHWDeviceType type) {
+    for (int i = 0;; ++i) {
+        const AVCodecHWConfig *config = avcodec_get_hw_config(codec, i);
+        if (!config) {
+            return AV_PIX_FMT_NONE;
+        }
+
+        if ((config->methods & AV_CODEC_HW_CONFIG_METHOD_HW_DEVICE_CTX)
+                && config->device_type == type) {
+            return config->pix_fmt;
+        }
+    }
+}
+
+// Open a private codec context using the requested hardware device.
+//
+// The codec context provided by the demuxer is already open (and it is shared
+// with the other packet sinks), so the hardware device could not be attached
+// to it.
+static bool
+sc_decoder_open_hwaccel(struct sc_decoder *decoder, const AVCodecContext *ctx) {
+    assert(decoder->hwaccel);
+
+    enum AVHWDeviceType type = av_hwdevice_find_type_by_name(decoder->hwaccel);
+    if (type == AV_HWDEVICE_TYPE_NONE) {
+        LOGW("Decoder '%s': unknown hardware device type: %s",
+             decoder->name, decoder->hwaccel);
+        return false;
+    }
+
+    const AVCodec *codec = ctx->codec;
+    decoder->hw_pix_fmt = sc_decoder_find_hw_pix_fmt(codec, type);
+    if (decoder->hw_pix_fmt == AV_PIX_FMT_NONE) {
+        LOGW("Decoder '%s': codec %s does not support %s", decoder->name,
+             codec->name, decoder->hwaccel);
+        return false;
+    }
+
+    int r = av_hwdevice_ctx_create(&decoder->hw_device_ctx, type, NULL, NULL,
+                                   0);
+    if (r < 0) {
+        LOGW("Decoder '%s': could not create %s device: %d", decoder->name,
+             decoder->hwaccel, r);
+        return false;
+    }
+
+    AVCodecContext *hw_ctx = avcodec_alloc_context3(codec);
+    if (!hw_ctx) {
+        LOG_OOM();
+        goto error_unref_device;
+    }
+
+    hw_ctx->flags = ctx->flags;
+    hw_ctx->width = ctx->width;
+    hw_ctx->height = ctx->height;
+    hw_ctx->opaque = decoder;
+    hw_ctx->get_format = sc_decoder_get_hw_format;
+    hw_ctx->hw_device_ctx = av_buffer_ref(decoder->hw_device_ctx);
+    if (!hw_ctx->hw_device_ctx) {
+        LOG_OOM();
+        goto error_free_context;
+    }
+
+    if (avcodec_open2(hw_ctx, codec, NULL) < 0) {
+        LOGW("Decoder '%s': could not open %s codec", decoder->name,
+             decoder->hwaccel);
+        goto error_free_context;
+    }
+
+    decoder->sw_frame = av_frame_alloc();
+    if (!decoder->sw_frame) {
+        LOG_OOM();
+        goto error_free_context;
+    }
+
+    decoder->hw_ctx = hw_ctx;
+
+    LOGI("Decoder '%s': hardware decoding enabled (%s)", decoder->name,
+         decoder->hwaccel);
+
+    return true;
+
+error_free_context:
+    avcodec_free_context(&hw_ctx);
+error_unref_device:
+    av_buffer_unref(&decoder->hw_device_ctx);
+
+    return false;
+}
+#endif
+
+static void
+sc_decoder_close_hwaccel(struct sc_decoder *decoder) {
+#ifdef SCRCPY_LAVC_HAS_HW_CONFIG
+    if (decoder->hw_ctx) {
+        av_frame_free(&decoder->sw_frame);
+        avcodec_free_context(&decoder->hw_ctx);
+        av_buffer_unref(&decoder->hw_device_ctx);
+    }
+#else
+    (void) decoder;
+#endif
+}
+
+static int
+sc_decoder_get_thread_count(struct sc_decoder *decoder,
+                            const AVCodecContext *ctx) {
+    if (decoder->threads != -1) {
+        return decoder->threads;
+    }
+
+    int64_t pixels = (int64_t) ctx->width * ctx->height;
+    if (pixels < SC_DECODER_AUTO_THREADS_MIN_PIXELS) {
+        // Single-threaded decoding is fast enough
+        return 1;
+    }
+
+    return CLAMP(av_cpu_count(), 1, SC_DECODER_AUTO_THREADS_MAX);
+}
+
+static const char *
+sc_decoder_get_thread_type_name(int thread_type) {
+    switch (thread_type) {
+        case FF_THREAD_FRAME:
+            return "frame";
+        case FF_THREAD_SLICE:
+            return "slice";
+        default:
+            return "no";
+    }
+}
+
+// The codec context provided by the demuxer is already open, so the threading
+// settings could not be applied to it
+static bool
+sc_decoder_open_sw_ctx(struct sc_decoder *decoder, const AVCodecContext *ctx,
+                       int thread_count) {
+    const AVCodec *codec = ctx->codec;
+    AVCodecContext *sw_ctx = avcodec_alloc_context3(codec);
+    if (!sw_ctx) {
+        LOG_OOM();
+        return false;
+    }
+
+    sw_ctx->flags = ctx->flags;
+    sw_ctx->flags2 = ctx->flags2;
+    sw_ctx->width = ctx->width;
+    sw_ctx->height = ctx->height;
+    sw_ctx->pix_fmt = ctx->pix_fmt;
+    sw_ctx->thread_count = thread_count;
+
+    if (decoder->thread_type == SC_DECODER_THREAD_TYPE_FRAME) {
+        sw_ctx->thread_type = FF_THREAD_FRAME;
+        // FFmpeg disables frame threading in low delay mode
+        sw_ctx->flags &= ~AV_CODEC_FLAG_LOW_DELAY;
+    } else {
+        sw_ctx->thread_type = FF_THREAD_SLICE;
+    }
+
+    if (decoder->fast) {
+        sw_ctx->flags2 |= AV_CODEC_FLAG2_FAST;
+    }
+
+    if (avcodec_open2(sw_ctx, codec, NULL) < 0) {
+        LOGE("Decoder '%s': could not open codec", decoder->name);
+        avcodec_free_context(&sw_ctx);
+        return false;
+    }
+
+    LOGD("Decoder '%s': %d thread(s), %s threading%s", decoder->name,
+         sw_ctx->thread_count,
+         sc_decoder_get_thread_type_name(sw_ctx->active_thread_type),
+         decoder->fast ? ", fast" : "");
+
+    decoder->sw_ctx = sw_ctx;
+    return true;
+}
+
 static bool
 sc_decoder_open(struct sc_decoder *decoder, AVCodecContext *ctx) {
     decoder->frame = av_frame_alloc();
@@ -17,39 +241,309 @@ sc_decoder_open(struct sc_decoder *decoder, AVCodecContext *ctx) {
         return false;
     }
 
+    decoder->hw_ctx = NULL;
+    decoder->hw_device_ctx = NULL;
+    decoder->sw_frame = NULL;
+    decoder->sw_ctx = NULL;
+
+    if (decoder->skip_nonref) {
+        enum AVCodecID codec_id = ctx->codec_id;
+        if (codec_id != AV_CODEC_ID_H264 && codec_id != AV_CODEC_ID_HEVC) {
+            LOGW("Decoder '%s': cannot skip non-reference frames for codec "
+                 "%s", decoder->name, avcodec_get_name(codec_id));
+            decoder->skip_nonref = false;
+        }
+        decoder->display_skipped = sc_stats_get(SC_STATS_FRAMES_SKIPPED);
+        decoder->skip_budget = 0;
+        decoder->nonref_dropped = 0;
+    }
+
+    decoder->resyncing = false;
+    decoder->resyncs = 0;
+
+    decoder->pending_config = NULL;
+
+    decoder->sinks_failed = false;
+
+    decoder->catching_up = false;
+    decoder->has_catch_up_base = false;
+    decoder->catch_ups = 0;
+    decoder->catch_up_dropped = 0;
+
+    if (decoder->hwaccel && ctx->codec_type == AVMEDIA_TYPE_VIDEO) {
+#ifdef SCRCPY_LAVC_HAS_HW_CONFIG
+        bool ok = sc_decoder_open_hwaccel(decoder, ctx);
+        if (!ok) {
+            LOGW("Decoder '%s': fallback to software decoding", decoder->name);
+        }
+#else
+        LOGW("Decoder '%s': hardware decoding not supported by this FFmpeg "
+             "version", decoder->name);
+#endif
+    }
+
+    if (!decoder->hw_ctx && ctx->codec_type == AVMEDIA_TYPE_VIDEO) {
+        int thread_count = sc_decoder_get_thread_count(decoder, ctx);
+        if (thread_count != 1 || decoder->fast) {
+            bool ok = sc_decoder_open_sw_ctx(decoder, ctx, thread_count);
+            if (!ok) {
+                av_frame_free(&decoder->frame);
+                return false;
+            }
+        }
+    }
+
+    // The sinks are always opened with the demuxer codec context: the frames
+    // they receive are always in system memory
     if (!sc_frame_source_sinks_open(&decoder->frame_source, ctx)) {
+        avcodec_free_context(&decoder->sw_ctx);
+        sc_decoder_close_hwaccel(decoder);
         av_frame_free(&decoder->frame);
         return false;
     }
 
-    decoder->ctx = ctx;
+    if (decoder->hw_ctx) {
+        decoder->ctx = decoder->hw_ctx;
+    } else if (decoder->sw_ctx) {
+        decoder->ctx = decoder->sw_ctx;
+    } else {
+        decoder->ctx = ctx;
+    }
 
     return true;
 }
 
 static void
 sc_decoder_close(struct sc_decoder *decoder) {
-    sc_frame_source_sinks_close(&decoder->frame_source);
+    if (decoder->skip_nonref) {
+        LOGD("Decoder '%s': %" PRIu64_ " non-reference frame(s) dropped",
+             decoder->name, decoder->nonref_dropped);
+    }
+    if (decoder->resync) {
+        LOGD("Decoder '%s': %" PRIu64_ " resync(s)", decoder->name,
+             decoder->resyncs);
+    }
+    if (decoder->catch_up_max_lag) {
+        LOGD("Decoder '%s': %" PRIu64_ " catch-up(s), %" PRIu64_ " packet(s) "
+             "dropped", decoder->name, decoder->catch_ups,
+             decoder->catch_up_dropped);
+    }
+
+    if (decoder->sinks_failed) {
+        sc_frame_source_sinks_abort(&decoder->frame_source);
+    } else {
+        sc_frame_source_sinks_close(&decoder->frame_source);
+    }
+    avcodec_free_context(&decoder->sw_ctx);
+    sc_decoder_close_hwaccel(decoder);
     av_frame_free(&decoder->frame);
+    free(decoder->pending_config);
 }
 
 static bool
-sc_decoder_push(struct sc_decoder *decoder, const AVPacket *packet) {
-    bool is_config = packet->pts == AV_NOPTS_VALUE;
-    if (is_config) {
+sc_decoder_push_frame(struct sc_decoder *decoder, const AVFrame *frame) {
+    if (!decoder->hw_ctx || frame->format != decoder->hw_pix_fmt) {
+        bool ok = sc_frame_source_sinks_push(&decoder->frame_source, frame);
+        decoder->sinks_failed = !ok;
+        return ok;
+    }
+
+#ifdef SCRCPY_LAVC_HAS_HW_CONFIG
+    // The frame is in GPU memory, download it
+    AVFrame *sw_frame = decoder->sw_frame;
+    int r = av_hwframe_transfer_data(sw_frame, frame, 0);
+    if (r < 0) {
+        LOGE("Decoder '%s': could not download hardware frame: %d",
+             decoder->name, r);
+        return false;
+    }
+
+    r = av_frame_copy_props(sw_frame, frame);
+    if (r < 0) {
+        LOGE("Decoder '%s': could not copy frame properties: %d",
+             decoder->name, r);
+        av_frame_unref(sw_frame);
+        return false;
+    }
+
+    bool ok = sc_frame_source_sinks_push(&decoder->frame_source, sw_frame);
+    av_frame_unref(sw_frame);
+    decoder->sinks_failed = !ok;
+    return ok;
+#else
+    assert(!"unreachable");
+    return false;
+#endif
+}
+
+// Return the avcodec_send_packet() result (AVERROR(EAGAIN) if the pending
+// frames must be received first)
+static int
+sc_decoder_send_config(struct sc_decoder *decoder, const uint8_t *config,
+                       size_t config_size) {
+    // The config (SPS/PPS) is attached to the packet as side data rather than
+    // prepended to its payload: send it separately, just before the packet
+    AVPacket *packet = av_packet_alloc();
+    if (!packet) {
+        LOG_OOM();
+        return AVERROR(ENOMEM);
+    }
+
+    if (av_new_packet(packet, config_size)) {
+        LOG_OOM();
+        av_packet_free(&packet);
+        return AVERROR(ENOMEM);
+    }
+
+    memcpy(packet->data, config, config_size);
+
+    int ret = avcodec_send_packet(decoder->ctx, packet);
+    av_packet_free(&packet);
+    return ret;
+}
+
+// Keep a config which could not be sent, to send it before the next key frame
+// (otherwise it could not be decoded if the config changed)
+static bool
+sc_decoder_keep_config(struct sc_decoder *decoder, const uint8_t *config,
+                       size_t config_size) {
+    if (!config || config == decoder->pending_config) {
         // nothing to do
         return true;
     }
 
-    int ret = avcodec_send_packet(decoder->ctx, packet);
-    if (ret < 0 && ret != AVERROR(EAGAIN)) {
-        LOGE("Decoder '%s': could not send video packet: %d",
-             decoder->name, ret);
+    // Only the latest config is relevant
+    uint8_t *copy = realloc(decoder->pending_config, config_size);
+    if (!copy) {
+        LOG_OOM();
+        return false;
+    }
+    memcpy(copy, config, config_size);
+
+    decoder->pending_config = copy;
+    decoder->pending_config_size = config_size;
+    return true;
+}
+
+// Keep the config attached to a packet to drop (if any)
+static bool
+sc_decoder_drop_packet(struct sc_decoder *decoder, const AVPacket *packet) {
+    size_t config_size;
+    const uint8_t *config = sc_packet_merger_get_config(packet, &config_size);
+    return sc_decoder_keep_config(decoder, config, config_size);
+}
+
+static bool
+sc_decoder_should_drop(struct sc_decoder *decoder, const AVPacket *packet) {
+    assert(decoder->skip_nonref);
+
+    // The frames skipped by the display since the last packet
+    uint64_t skipped = sc_stats_get(SC_STATS_FRAMES_SKIPPED);
+    uint64_t new_skipped = skipped - decoder->display_skipped;
+    decoder->display_skipped = skipped;
+    decoder->skip_budget = MIN(decoder->skip_budget + new_skipped,
+                               SC_DECODER_SKIP_BUDGET_MAX);
+
+    if (!decoder->skip_budget || (packet->flags & AV_PKT_FLAG_KEY)) {
+        return false;
+    }
+
+    bool nonref = decoder->ctx->codec_id == AV_CODEC_ID_H264
+                ? sc_nal_h264_is_non_reference(packet->data, packet->size)
+                : sc_nal_h265_is_non_reference(packet->data, packet->size);
+    if (!nonref) {
         return false;
     }
 
+    --decoder->skip_budget;
+    ++decoder->nonref_dropped;
+    sc_stats_inc(SC_STATS_FRAMES_DECODE_SKIPPED);
+    return true;
+}
+
+// Return true if the packet must be dropped to catch up with the device
+static bool
+sc_decoder_should_catch_up(struct sc_decoder *decoder,
+                           const AVPacket *packet) {
+    assert(decoder->catch_up_max_lag);
+    assert(packet->pts != AV_NOPTS_VALUE);
+
+    sc_tick now = sc_tick_now();
+    // The PTS are in microseconds
+    sc_tick delay = now - SC_TICK_FROM_US(packet->pts);
+    if (!decoder->has_catch_up_base || delay < decoder->catch_up_base) {
+        decoder->catch_up_base = delay;
+        decoder->has_catch_up_base = true;
+    } else {
+        decoder->catch_up_base += (delay - decoder->catch_up_base)
+                                / SC_DECODER_CATCH_UP_BASE_DRIFT;
+    }
+
+    bool key = packet->flags & AV_PKT_FLAG_KEY;
+
+    if (decoder->catching_up) {
+        if (!key) {
+            ++decoder->catch_up_dropped;
+            return true;
+        }
+
+        LOGI("Decoder '%s': caught up on key frame", decoder->name);
+        decoder->catching_up = false;
+        return false;
+    }
+
+    sc_tick lag = delay - decoder->catch_up_base;
+    bool cooldown = decoder->catch_ups
+                 && now - decoder->last_catch_up < SC_DECODER_CATCH_UP_COOLDOWN;
+    if (key || lag <= decoder->catch_up_max_lag || cooldown) {
+        return false;
+    }
+
+    // The frames being decoded are late too
+    avcodec_flush_buffers(decoder->ctx);
+    decoder->catching_up = true;
+    decoder->last_catch_up = now;
+    ++decoder->catch_ups;
+    ++decoder->catch_up_dropped;
+    sc_stats_inc(SC_STATS_VIDEO_CATCH_UPS);
+    LOGW("Decoder '%s': %" PRItick " ms behind, skipping to the next key "
+         "frame", decoder->name, SC_TICK_TO_MS(lag));
+
+    if (decoder->cbs) {
+        decoder->cbs->on_resync(decoder, decoder->cbs_userdata);
+    }
+
+    return true;
+}
+
+// Handle a decoding error, return false if the stream must end
+static bool
+sc_decoder_on_error(struct sc_decoder *decoder) {
+    if (!decoder->resync) {
+        return false;
+    }
+
+    // The next frames may reference the corrupted ones: discard the decoder
+    // state and wait for a key frame
+    avcodec_flush_buffers(decoder->ctx);
+    decoder->resyncing = true;
+    ++decoder->resyncs;
+    sc_stats_inc(SC_STATS_DECODE_RESYNCS);
+    LOGW("Decoder '%s': waiting for the next key frame", decoder->name);
+
+    if (decoder->cbs) {
+        decoder->cbs->on_resync(decoder, decoder->cbs_userdata);
+    }
+
+    return true;
+}
+
+// Receive and push all the frames available, return false if the stream must
+// end
+static bool
+sc_decoder_receive_frames(struct sc_decoder *decoder, bool trace_latency) {
     for (;;) {
-        ret = avcodec_receive_frame(decoder->ctx, decoder->frame);
+        int ret = avcodec_receive_frame(decoder->ctx, decoder->frame);
         if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) {
             break;
         }
@@ -57,12 +551,16 @@ sc_decoder_push(struct sc_decoder *decoder, const AVPacket *packet) {
         if (ret) {
             LOGE("Decoder '%s', could not receive video frame: %d",
                  decoder->name, ret);
-            return false;
+            return sc_decoder_on_error(decoder);
         }
 
         // a frame was received
-        bool ok = sc_frame_source_sinks_push(&decoder->frame_source,
-                                             decoder->frame);
+        if (trace_latency) {
+            sc_latency_tracer_mark(SC_LATENCY_STAGE_DECODE_RECEIVE,
+                                   decoder->frame->pts);
+        }
+
+        bool ok = sc_decoder_push_frame(decoder, decoder->frame);
         av_frame_unref(decoder->frame);
         if (!ok) {
             // Error already logged
@@ -73,6 +571,86 @@ sc_decoder_push(struct sc_decoder *decoder, const AVPacket *packet) {
     return true;
 }
 
+static bool
+sc_decoder_push(struct sc_decoder *decoder, const AVPacket *packet) {
+    bool is_config = packet->pts == AV_NOPTS_VALUE;
+    if (is_config) {
+        // nothing to do
+        return true;
+    }
+
+    if (decoder->resyncing) {
+        if (!(packet->flags & AV_PKT_FLAG_KEY)) {
+            LOGV("Decoder '%s': packet dropped until the next key frame",
+                 decoder->name);
+            return sc_decoder_drop_packet(decoder, packet);
+        }
+
+        LOGI("Decoder '%s': resynchronized on key frame", decoder->name);
+        decoder->resyncing = false;
+    }
+
+    if (decoder->catch_up_max_lag
+            && sc_decoder_should_catch_up(decoder, packet)) {
+        LOGV("Decoder '%s': packet dropped to catch up", decoder->name);
+        return sc_decoder_drop_packet(decoder, packet);
+    }
+
+    bool trace_latency = decoder->ctx->codec_type == AVMEDIA_TYPE_VIDEO;
+
+    size_t config_size;
+    const uint8_t *config = sc_packet_merger_get_config(packet, &config_size);
+    if (!config && decoder->pending_config
+            && (packet->flags & AV_PKT_FLAG_KEY)) {
+        // The config of a packet which could not be decoded
+        config = decoder->pending_config;
+        config_size = decoder->pending_config_size;
+    }
+    if (config) {
+        int ret = sc_decoder_send_config(decoder, config, config_size);
+        if (ret == AVERROR(EAGAIN)) {
+            // The decoder does not accept input until its pending frames are
+            // received, the config must not be lost
+            if (!sc_decoder_receive_frames(decoder, trace_latency)) {
+                return false;
+            }
+            if (decoder->resyncing) {
+                // Receiving failed, the decoder has been flushed and this
+                // packet is lost: send its config before the next key frame
+                return sc_decoder_keep_config(decoder, config, config_size);
+            }
+            ret = sc_decoder_send_config(decoder, config, config_size);
+        }
+        if (ret < 0) {
+            LOGE("Decoder '%s': could not send config packet: %d",
+                 decoder->name, ret);
+            return sc_decoder_on_error(decoder);
+        }
+
+        // The config has been sent, a pending one is obsolete
+        free(decoder->pending_config);
+        decoder->pending_config = NULL;
+    }
+
+    if (decoder->skip_nonref && sc_decoder_should_drop(decoder, packet)) {
+        LOGV("Decoder '%s': non-reference frame dropped", decoder->name);
+        return true;
+    }
+
+    if (trace_latency) {
+        sc_latency_tracer_mark(SC_LATENCY_STAGE_DECODE_SEND, packet->pts);
+    }
+
+    int ret = avcodec_send_packet(decoder->ctx, packet);
+    if (ret < 0 && ret != AVERROR(EAGAIN)) {
+        LOGE("Decoder '%s': could not send video packet: %d",
+             decoder->name, ret);
+        return sc_decoder_on_error(decoder);
+    }
+
+    return sc_decoder_receive_frames(decoder, trace_latency);
+}
+
 static bool
 sc_decoder_packet_sink_open(struct sc_packet_sink *sink, AVCodecContext *ctx) {
     struct sc_decoder *decoder = DOWNCAST(sink);
@@ -93,8 +671,18 @@ sc_decoder_packet_sink_push(struct sc_packet_sink *sink,
 }
 
 void
-sc_decoder_init(struct sc_decoder *decoder, const char *name) {
+sc_decoder_init(struct sc_decoder *decoder, const char *name,
+                const char *hwaccel) {
     decoder->name = name; // statically allocated
+    decoder->hwaccel = hwaccel;
+    decoder->threads = 1;
+    decoder->thread_type = SC_DECODER_THREAD_TYPE_AUTO;
+    decoder->fast = false;
+    decoder->skip_nonref = false;
+    decoder->resync = false;
+    decoder->catch_up_max_lag = 0;
+    decoder->cbs = NULL;
+    decoder->cbs_userdata = NULL;
     sc_frame_source_init(&decoder->frame_source);
 
     static const struct sc_packet_sink_ops ops = {
@@ -105,3 +693,38 @@ sc_decoder_init(struct sc_decoder *decoder, const char *name) {
 
     decoder->packet_sink.ops = &ops;
 }
+
+void
+sc_decoder_set_threading(struct sc_decoder *decoder, int threads,
+                         enum sc_decoder_thread_type thread_type, bool fast) {
+    assert(threads >= -1);
+    decoder->threads = threads;
+    decoder->thread_type = thread_type;
+    decoder->fast = fast;
+}
+
+void
+sc_decoder_set_skip_nonref(struct sc_decoder *decoder, bool skip_nonref) {
+    decoder->skip_nonref = skip_nonref;
+}
+
+void
+sc_decoder_set_resync(struct sc_decoder *decoder,
+                      const struct sc_decoder_callbacks *cbs,
+                      void *cbs_userdata) {
+    assert(!cbs || cbs->on_resync);
+    decoder->resync = true;
+    decoder->cbs = cbs;
+    decoder->cbs_userdata = cbs_userdata;
+}
+
+void
+sc_decoder_set_catch_up(struct sc_decoder *decoder, sc_tick max_lag,
+                        const struct sc_decoder_callbacks *cbs,
+                        void *cbs_userdata) {
+    assert(max_lag > 0);
+    assert(!cbs || cbs->on_resync);
+    decoder->catch_up_max_lag = max_lag;
+    decoder->cbs = cbs;
+    decoder->cbs_userdata = cbs_userdata;
+}
@@ -5,8 +5,10 @@
 
 #include <libavcodec/avcodec.h>
 
+#include "options.h"
 #include "trait/frame_source.h"
 #include "trait/packet_sink.h"
+#include "util/tick.h"
 
 struct sc_decoder {
     struct sc_packet_sink packet_sink; // packet sink trait
@@ -14,12 +16,121 @@ struct sc_decoder {
 
     const char *name; // must be statically allocated (e.g. a string literal)
 
+    // FFmpeg hardware device type name, or NULL for software decoding
+    const char *hwaccel;
+
+    // Software decoding threads (-1 for automatic, 0 for one per CPU core)
+    int threads;
+    enum sc_decoder_thread_type thread_type;
+    bool fast;
+
+    // Drop the non-reference packets while the display skips frames
+    bool skip_nonref;
+    uint64_t display_skipped; // last value of SC_STATS_FRAMES_SKIPPED
+    unsigned skip_budget; // number of packets which may still be dropped
+    uint64_t nonref_dropped;
+
+    // On decoding error, drop the packets until the next key frame instead of
+    // failing (the sinks keep the last frame meanwhile)
+    bool resync;
+    bool resyncing; // waiting for a key frame
+    uint64_t resyncs;
+
+    // Config (SPS/PPS) of a packet which could not be decoded (dropped, or
+    // lost by a resync), to send before the next key frame
+    uint8_t *pending_config;
+    size_t pending_config_size;
+
+    // When the video lags behind the device by more than catch_up_max_lag
+    // (0 if disabled), drop the packets until the next key frame
+    sc_tick catch_up_max_lag;
+    bool catching_up; // waiting for a key frame
+    bool has_catch_up_base;
+    sc_tick catch_up_base; // minimal (local time - PTS), i.e. no lag
+    sc_tick last_catch_up; // local time
+    uint64_t catch_ups;
+    uint64_t catch_up_dropped;
+
+    const struct sc_decoder_callbacks *cbs; // may be NULL
+    void *cbs_userdata;
+
     AVCodecContext *ctx;
     AVFrame *frame;
+
+    // Only used if the software decoder needs specific settings (threading),
+    // which could not be applied to the shared demuxer codec context
+    AVCodecContext *sw_ctx; // owned by the decoder (contrary to ctx)
+
+    // Only used if hardware decoding is enabled (hw_ctx is not NULL)
+    AVCodecContext *hw_ctx; // owned by the decoder (contrary to ctx)
+    AVBufferRef *hw_device_ctx;
+    enum AVPixelFormat hw_pix_fmt;
+    AVFrame *sw_frame; // frame downloaded from the GPU
+
+    // A frame sink failed, the frames still queued for the others must be
+    // discarded on close
+    bool sinks_failed;
+};
+
+struct sc_decoder_callbacks {
+    // Called from the decoding thread when the packets are dropped until the
+    // next key frame (on decoding error or to catch up), to request a new key
+    // frame to the device
+    void (*on_resync)(struct sc_decoder *decoder, void *userdata);
 };
 
 // The name must be statically allocated (e.g. a string literal)
+//
+// If hwaccel is not NULL, it is the FFmpeg hardware device type name to use
+// to decode video (e.g. "vaapi").
+void
+sc_decoder_init(struct sc_decoder *decoder, const char *name,
+                const char *hwaccel);
+
+/**
+ * Configure software decoding threads (before the stream is opened)
+ *
+ * By default, a single thread is used.
+ */
+void
+sc_decoder_set_threading(struct sc_decoder *decoder, int threads,
+                         enum sc_decoder_thread_type thread_type, bool fast);
+
+/**
+ * Drop the non-reference video packets before decoding while the display
+ * cannot keep up (H.264 and H.265 only)
+ *
+ * Each frame skipped by the display allows to drop one of the next
+ * non-reference packets: their frames would be skipped anyway, and no other
+ * frame depends on them.
+ */
+void
+sc_decoder_set_skip_nonref(struct sc_decoder *decoder, bool skip_nonref);
+
+/**
+ * Recover from decoding errors instead of ending the stream
+ *
+ * The decoder is flushed, then the packets are dropped until the next key
+ * frame, so the last decoded frame remains presented meanwhile. If cbs is not
+ * NULL, on_resync() is called on each error to request a key frame.
+ */
+void
+sc_decoder_set_resync(struct sc_decoder *decoder,
+                      const struct sc_decoder_callbacks *cbs,
+                      void *cbs_userdata);
+
+/**
+ * Skip to the next key frame when the video lags behind the device
+ *
+ * The lag is the increase of the delay between the packet PTS and the local
+ * reception time. It grows when packets pile up (for example after the device
+ * or the connection stalled): rather than decoding all of them at full speed,
+ * the packets are dropped until the next key frame. If cbs is not NULL,
+ * on_resync() is called to request a key frame.
+ */
 void
-sc_decoder_init(struct sc_decoder *decoder, const char *name);
+sc_decoder_set_catch_up(struct sc_decoder *decoder, sc_tick max_lag,
+                        const struct sc_decoder_callbacks *cbs,
+                        void *cbs_userdata);
 
 #endif
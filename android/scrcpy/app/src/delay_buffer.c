@@ -4,50 +4,180 @@
 #include <stdlib.h>
 #include <libavcodec/avcodec.h>
 
+#include "memory_budget.h"
+#include "stats.h"
 #include "util/log.h"
 
 /** Downcast frame_sink to sc_delay_buffer */
 #define DOWNCAST(SINK) container_of(SINK, struct sc_delay_buffer, frame_sink)
 
+// In adaptive mode, target this multiple of the mean jitter (the mean
+// deviation underestimates the late frames)
+#define SC_DELAY_BUFFER_JITTER_FACTOR 4
+// In adaptive mode, the delay decreases by 1/64 of the difference with the
+// target on every frame (about 1 second at 60 fps), to avoid oscillations
+#define SC_DELAY_BUFFER_DECREASE_SHIFT 6
+
+// If the frame rate is unknown, size the pool for this frame rate
+#define SC_DELAY_BUFFER_DEFAULT_FPS 60
+// Do not preallocate more frames (the pool still grows on demand)
+#define SC_DELAY_BUFFER_MAX_POOL_SIZE 256
+
+static AVFrame *
+sc_delay_buffer_acquire_frame(struct sc_delay_buffer *db) {
+    sc_mutex_assert(&db->mutex);
+
+    if (!sc_vecdeque_is_empty(&db->pool)) {
+        return sc_vecdeque_pop(&db->pool);
+    }
+
+    // The pool is exhausted, the frame will join it once released
+    AVFrame *frame = av_frame_alloc();
+    if (!frame) {
+        LOG_OOM();
+    }
+    return frame;
+}
+
+static void
+sc_delay_buffer_release_frame(struct sc_delay_buffer *db, AVFrame *frame) {
+    sc_mutex_assert(&db->mutex);
+
+    av_frame_unref(frame);
+    if (!sc_vecdeque_push(&db->pool, frame)) {
+        // Not fatal, the frame will just not be reused
+        av_frame_free(&frame);
+    }
+}
+
+static size_t
+sc_delay_buffer_get_pool_size(struct sc_delay_buffer *db,
+                              const AVCodecContext *ctx) {
+    sc_tick delay = db->adaptive ? db->max_delay : db->delay;
+
+    uint64_t fps = SC_DELAY_BUFFER_DEFAULT_FPS;
+    if (ctx && ctx->framerate.num > 0 && ctx->framerate.den > 0) {
+        fps = (ctx->framerate.num + ctx->framerate.den - 1)
+            / ctx->framerate.den;
+    }
+
+    // +2: the frame being forwarded and the frame being pushed
+    uint64_t size = (uint64_t) delay * fps / SC_TICK_FREQ + 2;
+    return MIN(size, SC_DELAY_BUFFER_MAX_POOL_SIZE);
+}
+
 static bool
-sc_delayed_frame_init(struct sc_delayed_frame *dframe, const AVFrame *frame) {
-    dframe->frame = av_frame_alloc();
-    if (!dframe->frame) {
+sc_delay_buffer_pool_init(struct sc_delay_buffer *db, size_t size) {
+    sc_vecdeque_init(&db->pool);
+
+    if (!sc_vecdeque_reserve(&db->pool, size)) {
         LOG_OOM();
         return false;
     }
 
+    for (size_t i = 0; i < size; ++i) {
+        AVFrame *frame = av_frame_alloc();
+        if (!frame) {
+            LOG_OOM();
+            while (!sc_vecdeque_is_empty(&db->pool)) {
+                AVFrame *f = sc_vecdeque_pop(&db->pool);
+                av_frame_free(&f);
+            }
+            sc_vecdeque_destroy(&db->pool);
+            return false;
+        }
+        sc_vecdeque_push_noresize(&db->pool, frame);
+    }
+
+    return true;
+}
+
+static void
+sc_delay_buffer_pool_destroy(struct sc_delay_buffer *db) {
+    while (!sc_vecdeque_is_empty(&db->pool)) {
+        AVFrame *frame = sc_vecdeque_pop(&db->pool);
+        av_frame_free(&frame);
+    }
+    sc_vecdeque_destroy(&db->pool);
+}
+
+// The frame data kept alive by the references (the decoder cannot reuse it)
+static uint64_t
+sc_delay_buffer_get_frame_size(const AVFrame *frame) {
+    uint64_t size = 0;
+    for (unsigned i = 0; i < AV_NUM_DATA_POINTERS && frame->buf[i]; ++i) {
+        size += frame->buf[i]->size;
+    }
+    return size;
+}
+
+static bool
+sc_delayed_frame_init(struct sc_delay_buffer *db,
+                      struct sc_delayed_frame *dframe, const AVFrame *frame) {
+    dframe->frame = sc_delay_buffer_acquire_frame(db);
+    if (!dframe->frame) {
+        return false;
+    }
+
+    // Only the buffer references are copied, not the frame data
     if (av_frame_ref(dframe->frame, frame)) {
         LOG_OOM();
-        av_frame_free(&dframe->frame);
+        sc_delay_buffer_release_frame(db, dframe->frame);
         return false;
     }
 
+    dframe->size = sc_delay_buffer_get_frame_size(frame);
     return true;
 }
 
 static void
-sc_delayed_frame_destroy(struct sc_delayed_frame *dframe) {
-    av_frame_unref(dframe->frame);
-    av_frame_free(&dframe->frame);
+sc_delayed_frame_destroy(struct sc_delay_buffer *db,
+                         struct sc_delayed_frame *dframe) {
+    sc_memory_budget_release(SC_MEMORY_BUDGET_DELAY_BUFFER, dframe->size);
+    sc_delay_buffer_release_frame(db, dframe->frame);
+}
+
+// Reserve the memory of a new frame. If the memory budget is exceeded, shrink
+// the buffer by dropping the oldest frames (the newest one is always kept).
+static void
+sc_delay_buffer_reserve(struct sc_delay_buffer *db, uint64_t size) {
+    sc_mutex_assert(&db->mutex);
+
+    unsigned dropped = 0;
+    while (!sc_memory_budget_reserve(SC_MEMORY_BUDGET_DELAY_BUFFER, size)) {
+        if (sc_vecdeque_is_empty(&db->queue)) {
+            // The budget is used by other components
+            sc_memory_budget_force_reserve(SC_MEMORY_BUDGET_DELAY_BUFFER,
+                                           size);
+            break;
+        }
+
+        struct sc_delayed_frame *old = sc_vecdeque_popref(&db->queue);
+        sc_delayed_frame_destroy(db, old);
+        ++dropped;
+    }
+
+    if (dropped) {
+        LOGD("Buffering over memory budget, %u frame(s) dropped", dropped);
+        sc_stats_add(SC_STATS_BUFFERED_FRAMES_DROPPED, dropped);
+    }
 }
 
 static int
 run_buffering(void *data) {
     struct sc_delay_buffer *db = data;
 
-    assert(db->delay > 0);
+    assert(db->adaptive || db->delay > 0);
 
-    for (;;) {
-        sc_mutex_lock(&db->mutex);
+    sc_mutex_lock(&db->mutex);
 
+    for (;;) {
         while (!db->stopped && sc_vecdeque_is_empty(&db->queue)) {
             sc_cond_wait(&db->queue_cond, &db->mutex);
         }
 
         if (db->stopped) {
-            sc_mutex_unlock(&db->mutex);
-            goto stopped;
+            break;
         }
 
         struct sc_delayed_frame dframe = sc_vecdeque_pop(&db->queue);
@@ -68,40 +198,40 @@ run_buffering(void *data) {
                 !sc_cond_timedwait(&db->wait_cond, &db->mutex, deadline);
         }
 
-        bool stopped = db->stopped;
-        sc_mutex_unlock(&db->mutex);
-
-        if (stopped) {
-            sc_delayed_frame_destroy(&dframe);
-            goto stopped;
+        if (db->stopped) {
+            sc_delayed_frame_destroy(db, &dframe);
+            break;
         }
 
+        sc_mutex_unlock(&db->mutex);
+
 #ifdef SC_BUFFERING_DEBUG
         LOGD("Buffering: %" PRItick ";%" PRItick ";%" PRItick,
              pts, dframe.push_date, sc_tick_now());
 #endif
 
         bool ok = sc_frame_source_sinks_push(&db->frame_source, dframe.frame);
-        sc_delayed_frame_destroy(&dframe);
+
+        sc_mutex_lock(&db->mutex);
+        sc_delayed_frame_destroy(db, &dframe);
         if (!ok) {
             LOGE("Delayed frame could not be pushed, stopping");
-            sc_mutex_lock(&db->mutex);
             // Prevent to push any new frame
             db->stopped = true;
-            sc_mutex_unlock(&db->mutex);
-            goto stopped;
+            break;
         }
     }
 
-stopped:
     assert(db->stopped);
 
     // Flush queue
     while (!sc_vecdeque_is_empty(&db->queue)) {
         struct sc_delayed_frame *dframe = sc_vecdeque_popref(&db->queue);
-        sc_delayed_frame_destroy(dframe);
+        sc_delayed_frame_destroy(db, dframe);
     }
 
+    sc_mutex_unlock(&db->mutex);
+
     LOGD("Buffering thread ended");
 
     return 0;
@@ -131,11 +261,26 @@ sc_delay_buffer_frame_sink_open(struct sc_frame_sink *sink,
     sc_clock_init(&db->clock);
     sc_vecdeque_init(&db->queue);
     db->stopped = false;
+    db->jitter = 0;
+    db->has_last = false;
+    if (db->adaptive) {
+        db->delay = db->min_delay;
+    }
 
-    if (!sc_frame_source_sinks_open(&db->frame_source, ctx)) {
+    size_t pool_size = sc_delay_buffer_get_pool_size(db, ctx);
+    if (!sc_vecdeque_reserve(&db->queue, pool_size)) {
+        LOG_OOM();
         goto error_destroy_wait_cond;
     }
 
+    if (!sc_delay_buffer_pool_init(db, pool_size)) {
+        goto error_destroy_queue;
+    }
+
+    if (!sc_frame_source_sinks_open(&db->frame_source, ctx)) {
+        goto error_destroy_pool;
+    }
+
     ok = sc_thread_create(&db->thread, run_buffering, "scrcpy-dbuf", db);
     if (!ok) {
         LOGE("Could not start buffering thread");
@@ -146,6 +291,10 @@ sc_delay_buffer_frame_sink_open(struct sc_frame_sink *sink,
 
 error_close_sinks:
     sc_frame_source_sinks_close(&db->frame_source);
+error_destroy_pool:
+    sc_delay_buffer_pool_destroy(db);
+error_destroy_queue:
+    sc_vecdeque_destroy(&db->queue);
 error_destroy_wait_cond:
     sc_cond_destroy(&db->wait_cond);
 error_destroy_queue_cond:
@@ -170,11 +319,49 @@ sc_delay_buffer_frame_sink_close(struct sc_frame_sink *sink) {
 
     sc_frame_source_sinks_close(&db->frame_source);
 
+    sc_delay_buffer_pool_destroy(db);
+    sc_vecdeque_destroy(&db->queue);
+
     sc_cond_destroy(&db->wait_cond);
     sc_cond_destroy(&db->queue_cond);
     sc_mutex_destroy(&db->mutex);
 }
 
+static void
+sc_delay_buffer_adapt(struct sc_delay_buffer *db, sc_tick system,
+                      sc_tick stream) {
+    sc_mutex_assert(&db->mutex);
+    assert(db->adaptive);
+
+    if (db->has_last) {
+        // Difference of relative transit times (RFC 3550, section 6.4.1)
+        sc_tick d = (system - db->last_system) - (stream - db->last_stream);
+        if (d < 0) {
+            d = -d;
+        }
+        db->jitter += (d - db->jitter) / 16;
+    }
+    db->last_system = system;
+    db->last_stream = stream;
+    db->has_last = true;
+
+    sc_tick target = db->jitter * SC_DELAY_BUFFER_JITTER_FACTOR;
+    target = CLAMP(target, db->min_delay, db->max_delay);
+
+    if (target > db->delay) {
+        // Absorb the stutter immediately
+        db->delay = target;
+    } else {
+        // Decrease slowly (frames are presented faster meanwhile)
+        db->delay -= (db->delay - target) >> SC_DELAY_BUFFER_DECREASE_SHIFT;
+    }
+
+#ifdef SC_BUFFERING_DEBUG
+    LOGD("Buffering jitter=%" PRItick " delay=%" PRItick, db->jitter,
+         db->delay);
+#endif
+}
+
 static bool
 sc_delay_buffer_frame_sink_push(struct sc_frame_sink *sink,
                                 const AVFrame *frame) {
@@ -188,7 +375,11 @@ sc_delay_buffer_frame_sink_push(struct sc_frame_sink *sink,
     }
 
     sc_tick pts = SC_TICK_FROM_US(frame->pts);
-    sc_clock_update(&db->clock, sc_tick_now(), pts);
+    sc_tick now = sc_tick_now();
+    sc_clock_update(&db->clock, now, pts);
+    if (db->adaptive) {
+        sc_delay_buffer_adapt(db, now, pts);
+    }
     sc_cond_signal(&db->wait_cond);
 
     if (db->first_frame_asap && db->clock.range == 1) {
@@ -197,7 +388,7 @@ sc_delay_buffer_frame_sink_push(struct sc_frame_sink *sink,
     }
 
     struct sc_delayed_frame dframe;
-    bool ok = sc_delayed_frame_init(&dframe, frame);
+    bool ok = sc_delayed_frame_init(db, &dframe, frame);
     if (!ok) {
         sc_mutex_unlock(&db->mutex);
         return false;
@@ -207,8 +398,11 @@ sc_delay_buffer_frame_sink_push(struct sc_frame_sink *sink,
     dframe.push_date = sc_tick_now();
 #endif
 
+    sc_delay_buffer_reserve(db, dframe.size);
+
     ok = sc_vecdeque_push(&db->queue, dframe);
     if (!ok) {
+        sc_delayed_frame_destroy(db, &dframe);
         sc_mutex_unlock(&db->mutex);
         LOG_OOM();
         return false;
@@ -221,6 +415,19 @@ sc_delay_buffer_frame_sink_push(struct sc_frame_sink *sink,
     return true;
 }
 
+static void
+sc_delay_buffer_init_common(struct sc_delay_buffer *db) {
+    sc_frame_source_init(&db->frame_source);
+
+    static const struct sc_frame_sink_ops ops = {
+        .open = sc_delay_buffer_frame_sink_open,
+        .close = sc_delay_buffer_frame_sink_close,
+        .push = sc_delay_buffer_frame_sink_push,
+    };
+
+    db->frame_sink.ops = &ops;
+}
+
 void
 sc_delay_buffer_init(struct sc_delay_buffer *db, sc_tick delay,
                      bool first_frame_asap) {
@@ -228,14 +435,22 @@ sc_delay_buffer_init(struct sc_delay_buffer *db, sc_tick delay,
 
     db->delay = delay;
     db->first_frame_asap = first_frame_asap;
+    db->adaptive = false;
 
-    sc_frame_source_init(&db->frame_source);
+    sc_delay_buffer_init_common(db);
+}
 
-    static const struct sc_frame_sink_ops ops = {
-        .open = sc_delay_buffer_frame_sink_open,
-        .close = sc_delay_buffer_frame_sink_close,
-        .push = sc_delay_buffer_frame_sink_push,
-    };
+void
+sc_delay_buffer_init_adaptive(struct sc_delay_buffer *db, sc_tick min_delay,
+                              sc_tick max_delay, bool first_frame_asap) {
+    assert(min_delay >= 0);
+    assert(max_delay > min_delay);
 
-    db->frame_sink.ops = &ops;
+    db->delay = min_delay;
+    db->first_frame_asap = first_frame_asap;
+    db->adaptive = true;
+    db->min_delay = min_delay;
+    db->max_delay = max_delay;
+
+    sc_delay_buffer_init_common(db);
 }
@@ -20,20 +20,33 @@ typedef struct AVFrame AVFrame;
 
 struct sc_delayed_frame {
     AVFrame *frame;
+    uint64_t size; // reserved from the memory budget
 #ifdef SC_BUFFERING_DEBUG
     sc_tick push_date;
 #endif
 };
 
 struct sc_delayed_frame_queue SC_VECDEQUE(struct sc_delayed_frame);
+struct sc_delayed_frame_pool SC_VECDEQUE(AVFrame *);
 
 struct sc_delay_buffer {
     struct sc_frame_source frame_source; // frame source trait
     struct sc_frame_sink frame_sink; // frame sink trait
 
-    sc_tick delay;
+    sc_tick delay; // current delay (protected by the mutex if adaptive)
     bool first_frame_asap;
 
+    // In adaptive mode, the delay follows the measured jitter, within
+    // [min_delay, max_delay]
+    bool adaptive;
+    sc_tick min_delay;
+    sc_tick max_delay;
+    // RFC 3550 inter-arrival jitter estimation (protected by the mutex)
+    sc_tick jitter;
+    sc_tick last_system;
+    sc_tick last_stream;
+    bool has_last;
+
     sc_thread thread;
     sc_mutex mutex;
     sc_cond queue_cond;
@@ -41,6 +54,9 @@ struct sc_delay_buffer {
 
     struct sc_clock clock;
     struct sc_delayed_frame_queue queue;
+    // Preallocated frames, moved to the queue on push and back to the pool
+    // once forwarded, to avoid allocations on every frame
+    struct sc_delayed_frame_pool pool;
     bool stopped;
 };
 
@@ -60,4 +76,19 @@ void
 sc_delay_buffer_init(struct sc_delay_buffer *db, sc_tick delay,
                      bool first_frame_asap);
 
+/**
+ * Initialize an adaptive delay buffer.
+ *
+ * The delay is adjusted according to the inter-arrival jitter of the frames
+ * (their PTS against the local clock), so that the latency stays minimal on
+ * good links while stutter is absorbed on bad ones.
+ *
+ * \param min_delay the minimal delay (may be 0)
+ * \param max_delay the maximal delay (strictly greater than min_delay)
+ * \param first_frame_asap if true, do not delay the first frame
+ */
+void
+sc_delay_buffer_init_adaptive(struct sc_delay_buffer *db, sc_tick min_delay,
+                              sc_tick max_delay, bool first_frame_asap);
+
 #endif
@@ -2,10 +2,14 @@
 
 #include <assert.h>
 #include <inttypes.h>
+#include <limits.h>
+#include <string.h>
 #include <libavcodec/avcodec.h>
 #include <libavutil/channel_layout.h>
 
+#include "latency_tracer.h"
 #include "packet_merger.h"
+#include "stats.h"
 #include "util/binary.h"
 #include "util/log.h"
 
@@ -16,6 +20,12 @@
 
 #define SC_PACKET_PTS_MASK (SC_PACKET_FLAG_KEY_FRAME - 1)
 
+// Size of the receive buffer (larger packets are received directly)
+#define SC_DEMUXER_READER_SIZE 0x40000 // 256k
+
+// Minimal size of the packet pool buffers (including the padding)
+#define SC_PACKET_POOL_MIN_BUFFER_SIZE 0x10000 // 64k
+
 static enum AVCodecID
 sc_demuxer_to_avcodec_id(uint32_t codec_id) {
 #define SC_CODEC_ID_H264 UINT32_C(0x68323634) // "h264" in ASCII
@@ -53,9 +63,8 @@ sc_demuxer_to_avcodec_id(uint32_t codec_id) {
 
 static bool
 sc_demuxer_recv_codec_id(struct sc_demuxer *demuxer, uint32_t *codec_id) {
-    uint8_t data[4];
-    ssize_t r = net_recv_all(demuxer->socket, data, 4);
-    if (r < 4) {
+    const uint8_t *data = sc_net_reader_next(&demuxer->reader, 4);
+    if (!data) {
         return false;
     }
 
@@ -66,9 +75,8 @@ sc_demuxer_recv_codec_id(struct sc_demuxer *demuxer, uint32_t *codec_id) {
 static bool
 sc_demuxer_recv_video_size(struct sc_demuxer *demuxer, uint32_t *width,
                            uint32_t *height) {
-    uint8_t data[8];
-    ssize_t r = net_recv_all(demuxer->socket, data, 8);
-    if (r < 8) {
+    const uint8_t *data = sc_net_reader_next(&demuxer->reader, 8);
+    if (!data) {
         return false;
     }
 
@@ -77,6 +85,80 @@ sc_demuxer_recv_video_size(struct sc_demuxer *demuxer, uint32_t *width,
     return true;
 }
 
+#ifdef SCRCPY_LAVU_HAS_SIZE_T_BUFFER_SIZE
+static AVBufferRef *
+sc_demuxer_packet_pool_alloc(void *opaque, size_t size) {
+#else
+static AVBufferRef *
+sc_demuxer_packet_pool_alloc(void *opaque, int size) {
+#endif
+    // Only called when the pool has no free buffer
+    struct sc_demuxer *demuxer = opaque;
+    ++demuxer->packet_pool.misses;
+    return av_buffer_alloc(size);
+}
+
+static size_t
+sc_demuxer_packet_pool_buffer_size(size_t needed) {
+    size_t size = SC_PACKET_POOL_MIN_BUFFER_SIZE;
+    while (size < needed) {
+        size <<= 1;
+    }
+    return size;
+}
+
+static bool
+sc_demuxer_alloc_packet(struct sc_demuxer *demuxer, AVPacket *packet,
+                        uint32_t len) {
+    size_t needed = (size_t) len + AV_INPUT_BUFFER_PADDING_SIZE;
+
+    if (needed > demuxer->packet_pool.buffer_size) {
+        // The pool buffers are too small for this packet: replace the pool.
+        // The buffers still referenced by the sinks remain valid, the old
+        // pool is freed once all of them are released.
+        av_buffer_pool_uninit(&demuxer->packet_pool.pool);
+
+        size_t buffer_size = sc_demuxer_packet_pool_buffer_size(needed);
+        if (buffer_size > INT_MAX) {
+            LOGE("Demuxer '%s': packet too big: %" PRIu32, demuxer->name, len);
+            demuxer->packet_pool.buffer_size = 0;
+            return false;
+        }
+
+        demuxer->packet_pool.pool =
+            av_buffer_pool_init2(buffer_size, demuxer,
+                                 sc_demuxer_packet_pool_alloc, NULL);
+        if (!demuxer->packet_pool.pool) {
+            LOG_OOM();
+            demuxer->packet_pool.buffer_size = 0;
+            return false;
+        }
+
+        demuxer->packet_pool.buffer_size = buffer_size;
+        LOGD("Demuxer '%s': packet pool buffer size: %" SC_PRIsizet,
+             demuxer->name, buffer_size);
+    }
+
+    uint64_t misses = demuxer->packet_pool.misses;
+    AVBufferRef *buf = av_buffer_pool_get(demuxer->packet_pool.pool);
+    if (!buf) {
+        LOG_OOM();
+        return false;
+    }
+
+    if (misses == demuxer->packet_pool.misses) {
+        ++demuxer->packet_pool.hits;
+    }
+
+    // Like av_new_packet(), but only the padding is zeroed
+    memset(buf->data + len, 0, AV_INPUT_BUFFER_PADDING_SIZE);
+    packet->buf = buf;
+    packet->data = buf->data;
+    packet->size = len;
+
+    return true;
+}
+
 static bool
 sc_demuxer_recv_packet(struct sc_demuxer *demuxer, AVPacket *packet) {
     // The video and audio streams contain a sequence of raw packets (as
@@ -99,9 +181,10 @@ sc_demuxer_recv_packet(struct sc_demuxer *demuxer, AVPacket *packet) {
     // | `- key frame
     //  `-- config packet
 
-    uint8_t header[SC_PACKET_HEADER_SIZE];
-    ssize_t r = net_recv_all(demuxer->socket, header, SC_PACKET_HEADER_SIZE);
-    if (r < SC_PACKET_HEADER_SIZE) {
+    // Parse the header in place
+    const uint8_t *header =
+        sc_net_reader_next(&demuxer->reader, SC_PACKET_HEADER_SIZE);
+    if (!header) {
         return false;
     }
 
@@ -109,13 +192,11 @@ sc_demuxer_recv_packet(struct sc_demuxer *demuxer, AVPacket *packet) {
     uint32_t len = sc_read32be(&header[8]);
     assert(len);
 
-    if (av_new_packet(packet, len)) {
-        LOG_OOM();
+    if (!sc_demuxer_alloc_packet(demuxer, packet, len)) {
         return false;
     }
 
-    r = net_recv_all(demuxer->socket, packet->data, len);
-    if (r < 0 || ((uint32_t) r) < len) {
+    if (!sc_net_reader_read_all(&demuxer->reader, packet->data, len)) {
         av_packet_unref(packet);
         return false;
     }
@@ -134,19 +215,73 @@ sc_demuxer_recv_packet(struct sc_demuxer *demuxer, AVPacket *packet) {
     return true;
 }
 
+static bool
+sc_demuxer_resume(struct sc_demuxer *demuxer, uint32_t raw_codec_id,
+                  bool video) {
+    if (!demuxer->cbs->on_disconnected) {
+        return false;
+    }
+
+    sc_socket socket = demuxer->cbs->on_disconnected(demuxer, demuxer->socket,
+                                                     demuxer->cbs_userdata);
+    if (socket == SC_SOCKET_NONE) {
+        return false;
+    }
+
+    demuxer->socket = socket;
+    sc_net_reader_reset(&demuxer->reader, socket);
+
+    // The sinks are still open with the initial codec context, so the stream
+    // header must match
+    uint32_t codec_id;
+    bool ok = sc_demuxer_recv_codec_id(demuxer, &codec_id);
+    if (!ok) {
+        LOGE("Demuxer '%s': could not resume the stream", demuxer->name);
+        return false;
+    }
+
+    if (codec_id != raw_codec_id) {
+        LOGE("Demuxer '%s': the resumed stream has a different codec",
+             demuxer->name);
+        return false;
+    }
+
+    if (video) {
+        // The decoder gets the actual size from the stream
+        uint32_t width;
+        uint32_t height;
+        ok = sc_demuxer_recv_video_size(demuxer, &width, &height);
+        if (!ok) {
+            LOGE("Demuxer '%s': could not resume the stream", demuxer->name);
+            return false;
+        }
+    }
+
+    LOGI("Demuxer '%s': stream resumed", demuxer->name);
+    return true;
+}
+
 static int
 run_demuxer(void *data) {
     struct sc_demuxer *demuxer = data;
 
+    sc_thread_apply_policy(demuxer->role);
+
     // Flag to report end-of-stream (i.e. device disconnected)
     enum sc_demuxer_status status = SC_DEMUXER_STATUS_ERROR;
 
+    bool ok = sc_net_reader_init(&demuxer->reader, demuxer->socket,
+                                 SC_DEMUXER_READER_SIZE);
+    if (!ok) {
+        goto end;
+    }
+
     uint32_t raw_codec_id;
-    bool ok = sc_demuxer_recv_codec_id(demuxer, &raw_codec_id);
+    ok = sc_demuxer_recv_codec_id(demuxer, &raw_codec_id);
     if (!ok) {
         LOGE("Demuxer '%s': stream disabled due to connection error",
              demuxer->name);
-        goto end;
+        goto finally_destroy_reader;
     }
 
     if (raw_codec_id == 0) {
@@ -154,13 +289,13 @@ run_demuxer(void *data) {
              demuxer->name);
         sc_packet_source_sinks_disable(&demuxer->packet_source);
         status = SC_DEMUXER_STATUS_DISABLED;
-        goto end;
+        goto finally_destroy_reader;
     }
 
     if (raw_codec_id == 1) {
         LOGE("Demuxer '%s': stream configuration error on the device",
              demuxer->name);
-        goto end;
+        goto finally_destroy_reader;
     }
 
     enum AVCodecID codec_id = sc_demuxer_to_avcodec_id(raw_codec_id);
@@ -168,7 +303,7 @@ run_demuxer(void *data) {
         LOGE("Demuxer '%s': stream disabled due to unsupported codec",
              demuxer->name);
         sc_packet_source_sinks_disable(&demuxer->packet_source);
-        goto end;
+        goto finally_destroy_reader;
     }
 
     const AVCodec *codec = avcodec_find_decoder(codec_id);
@@ -176,13 +311,13 @@ run_demuxer(void *data) {
         LOGE("Demuxer '%s': stream disabled due to missing decoder",
              demuxer->name);
         sc_packet_source_sinks_disable(&demuxer->packet_source);
-        goto end;
+        goto finally_destroy_reader;
     }
 
     AVCodecContext *codec_ctx = avcodec_alloc_context3(codec);
     if (!codec_ctx) {
         LOG_OOM();
-        goto end;
+        goto finally_destroy_reader;
     }
 
     codec_ctx->flags |= AV_CODEC_FLAG_LOW_DELAY;
@@ -234,6 +369,15 @@ run_demuxer(void *data) {
         sc_packet_merger_init(&merger);
     }
 
+    bool video = codec->type == AVMEDIA_TYPE_VIDEO;
+    enum sc_stats_counter stats_packets = video ? SC_STATS_VIDEO_PACKETS
+                                                : SC_STATS_AUDIO_PACKETS;
+    enum sc_stats_counter stats_bytes = video ? SC_STATS_VIDEO_BYTES
+                                              : SC_STATS_AUDIO_BYTES;
+
+    // If a sink failed, the packets still queued for the others are discarded
+    bool sinks_failed = false;
+
     AVPacket *packet = av_packet_alloc();
     if (!packet) {
         LOG_OOM();
@@ -243,11 +387,27 @@ run_demuxer(void *data) {
     for (;;) {
         bool ok = sc_demuxer_recv_packet(demuxer, packet);
         if (!ok) {
+            if (sc_demuxer_resume(demuxer, raw_codec_id, video)) {
+                if (must_merge_config_packet) {
+                    // Drop any config packet of the previous connection
+                    sc_packet_merger_destroy(&merger);
+                    sc_packet_merger_init(&merger);
+                }
+                continue;
+            }
+
             // end of stream
             status = SC_DEMUXER_STATUS_EOS;
             break;
         }
 
+        sc_stats_inc(stats_packets);
+        sc_stats_add(stats_bytes, packet->size);
+
+        if (video && packet->pts != AV_NOPTS_VALUE) {
+            sc_latency_tracer_mark(SC_LATENCY_STAGE_RECV, packet->pts);
+        }
+
         if (must_merge_config_packet) {
             // Prepend any config packet to the next media packet
             ok = sc_packet_merger_merge(&merger, packet);
@@ -261,11 +421,15 @@ run_demuxer(void *data) {
         av_packet_unref(packet);
         if (!ok) {
             // The sink already logged its concrete error
+            sinks_failed = true;
             break;
         }
     }
 
     LOGD("Demuxer '%s': end of frames", demuxer->name);
+    LOGD("Demuxer '%s': packet pool: %" PRIu64_ " hits, %" PRIu64_ " misses",
+         demuxer->name, demuxer->packet_pool.hits,
+         demuxer->packet_pool.misses);
 
     if (must_merge_config_packet) {
         sc_packet_merger_destroy(&merger);
@@ -273,24 +437,41 @@ run_demuxer(void *data) {
 
     av_packet_free(&packet);
 finally_close_sinks:
-    sc_packet_source_sinks_close(&demuxer->packet_source);
+    if (sinks_failed) {
+        sc_packet_source_sinks_abort(&demuxer->packet_source);
+    } else {
+        sc_packet_source_sinks_close(&demuxer->packet_source);
+    }
 finally_free_context:
     avcodec_free_context(&codec_ctx);
+finally_destroy_reader:
+    sc_net_reader_destroy(&demuxer->reader);
 end:
+    // Buffers still referenced by the sinks keep the pool alive until they
+    // are released
+    av_buffer_pool_uninit(&demuxer->packet_pool.pool);
+
     demuxer->cbs->on_ended(demuxer, status, demuxer->cbs_userdata);
 
     return 0;
 }
 
 void
-sc_demuxer_init(struct sc_demuxer *demuxer, const char *name, sc_socket socket,
+sc_demuxer_init(struct sc_demuxer *demuxer, const char *name,
+                enum sc_thread_role role, sc_socket socket,
                 const struct sc_demuxer_callbacks *cbs, void *cbs_userdata) {
     assert(socket != SC_SOCKET_NONE);
 
     demuxer->name = name; // statically allocated
+    demuxer->role = role;
     demuxer->socket = socket;
     sc_packet_source_init(&demuxer->packet_source);
 
+    demuxer->packet_pool.pool = NULL;
+    demuxer->packet_pool.buffer_size = 0;
+    demuxer->packet_pool.hits = 0;
+    demuxer->packet_pool.misses = 0;
+
     assert(cbs && cbs->on_ended);
 
     demuxer->cbs = cbs;
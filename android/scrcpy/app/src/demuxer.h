@@ -4,6 +4,9 @@
 #include "common.h"
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <libavutil/buffer.h>
 
 #include "trait/packet_source.h"
 #include "util/net.h"
@@ -13,10 +16,25 @@ struct sc_demuxer {
     struct sc_packet_source packet_source; // packet source trait
 
     const char *name; // must be statically allocated (e.g. a string literal)
+    enum sc_thread_role role; // scheduling policy of the thread
 
     sc_socket socket;
     sc_thread thread;
 
+    // Buffers the received stream, so that small packets (typically audio)
+    // do not cost two recv() calls each.
+    // It is only accessed from the demuxer thread.
+    struct sc_net_reader reader;
+
+    // Pool of packet buffers, to avoid an allocation per packet.
+    // It is only accessed from the demuxer thread.
+    struct {
+        AVBufferPool *pool;
+        size_t buffer_size; // size of every buffer of the current pool
+        uint64_t hits;
+        uint64_t misses; // the pool had to allocate a new buffer
+    } packet_pool;
+
     const struct sc_demuxer_callbacks *cbs;
     void *cbs_userdata;
 };
@@ -30,11 +48,18 @@ enum sc_demuxer_status {
 struct sc_demuxer_callbacks {
     void (*on_ended)(struct sc_demuxer *demuxer, enum sc_demuxer_status,
                      void *userdata);
+
+    // Optional: called when the socket is closed, to continue the stream on a
+    // new socket without closing the sinks (so the decoders are kept open).
+    // Return SC_SOCKET_NONE to end the stream.
+    sc_socket (*on_disconnected)(struct sc_demuxer *demuxer, sc_socket socket,
+                                 void *userdata);
 };
 
 // The name must be statically allocated (e.g. a string literal)
 void
-sc_demuxer_init(struct sc_demuxer *demuxer, const char *name, sc_socket socket,
+sc_demuxer_init(struct sc_demuxer *demuxer, const char *name,
+                enum sc_thread_role role, sc_socket socket,
                 const struct sc_demuxer_callbacks *cbs, void *cbs_userdata);
 
 bool
@@ -17,11 +17,13 @@ enum sc_device_msg_type {
     DEVICE_MSG_TYPE_UHID_OUTPUT,
 };
 
+// The payloads are not copied: they reference the deserialized buffer
 struct sc_device_msg {
     enum sc_device_msg_type type;
     union {
         struct {
-            char *text; // owned, to be freed by free()
+            const char *text; // not null-terminated
+            size_t length;
         } clipboard;
         struct {
             uint64_t sequence;
@@ -29,17 +31,16 @@ struct sc_device_msg {
         struct {
             uint16_t id;
             uint16_t size;
-            uint8_t *data; // owned, to be freed by free()
+            const uint8_t *data;
         } uhid_output;
     };
 };
 
 // return the number of bytes consumed (0 for no msg available, -1 on error)
+//
+// The msg references buf, which must outlive it.
 ssize_t
 sc_device_msg_deserialize(const uint8_t *buf, size_t len,
                           struct sc_device_msg *msg);
 
-void
-sc_device_msg_destroy(struct sc_device_msg *msg);
-
 #endif
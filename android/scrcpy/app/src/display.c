@@ -5,6 +5,7 @@
 #include <string.h>
 #include <libavutil/pixfmt.h>
 
+#include "latency_tracer.h"
 #include "util/log.h"
 
 static bool
@@ -30,9 +31,15 @@ sc_display_init_novideo_icon(struct sc_display *display,
 
 bool
 sc_display_init(struct sc_display *display, SDL_Window *window,
-                SDL_Surface *icon_novideo, bool mipmaps) {
-    display->renderer =
-        SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+                SDL_Surface *icon_novideo, bool mipmaps, bool shader,
+                bool damage_tracking, bool vsync) {
+    uint32_t renderer_flags = SDL_RENDERER_ACCELERATED;
+    if (vsync) {
+        // SDL_RenderPresent() will block until the next vblank
+        renderer_flags |= SDL_RENDERER_PRESENTVSYNC;
+    }
+
+    display->renderer = SDL_CreateRenderer(window, -1, renderer_flags);
     if (!display->renderer) {
         LOGE("Could not create renderer: %s", SDL_GetError());
         return false;
@@ -42,8 +49,12 @@ sc_display_init(struct sc_display *display, SDL_Window *window,
     int r = SDL_GetRendererInfo(display->renderer, &renderer_info);
     const char *renderer_name = r ? NULL : renderer_info.name;
     LOGI("Renderer: %s", renderer_name ? renderer_name : "(unknown)");
+    if (vsync && !r && !(renderer_info.flags & SDL_RENDERER_PRESENTVSYNC)) {
+        LOGW("Renderer vsync not supported, frame pacing will be approximate");
+    }
 
     display->mipmaps = false;
+    display->shader = false;
 
 #ifdef SC_DISPLAY_FORCE_OPENGL_CORE_PROFILE
     display->gl_context = NULL;
@@ -73,7 +84,26 @@ sc_display_init(struct sc_display *display, SDL_Window *window,
 
         LOGI("OpenGL version: %s", gl->version);
 
-        if (mipmaps) {
+        if (shader) {
+#ifndef SCRCPY_SDL_HAS_RENDER_FLUSH
+            LOGW("Shader rendering disabled (SDL >= 2.0.10 required)");
+#elif defined(SC_DISPLAY_FORCE_OPENGL_CORE_PROFILE)
+            // The SDL renderer does not draw into the Core Profile context
+            LOGW("Shader rendering disabled (not supported on this platform)");
+#else
+            display->shader =
+                sc_opengl_renderer_init(&display->gl_renderer, gl);
+            if (display->shader) {
+                LOGI("Shader rendering enabled");
+            } else {
+                LOGW("Shader rendering disabled");
+            }
+#endif
+        }
+
+        if (display->shader) {
+            LOGD("Trilinear filtering disabled (shader rendering)");
+        } else if (mipmaps) {
             bool supports_mipmaps =
                 sc_opengl_version_at_least(gl, 3, 0, /* OpenGL 3.0+ */
                                                2, 0  /* OpenGL ES 2.0+ */);
@@ -87,11 +117,28 @@ sc_display_init(struct sc_display *display, SDL_Window *window,
         } else {
             LOGI("Trilinear filtering disabled");
         }
-    } else if (mipmaps) {
-        LOGD("Trilinear filtering disabled (not an OpenGL renderer)");
+    } else {
+        if (mipmaps) {
+            LOGD("Trilinear filtering disabled (not an OpenGL renderer)");
+        }
+        if (shader) {
+            LOGW("Shader rendering disabled (not an OpenGL renderer)");
+        }
     }
 
+    // The shader path uploads the full frames
+    display->damage_tracking = damage_tracking && !display->shader;
+    if (damage_tracking && display->shader) {
+        LOGW("Damage tracking disabled (not supported by shader rendering)");
+    }
+    sc_damage_tracker_init(&display->damage_tracker);
+
     display->texture = NULL;
+    display->pix_fmt = AV_PIX_FMT_YUV420P;
+    // A zero size marks the "no video" icon texture, which is never pooled
+    display->texture_size.width = 0;
+    display->texture_size.height = 0;
+    display->texture_pool_count = 0;
     display->pending.flags = 0;
     display->pending.frame = NULL;
     display->has_frame = false;
@@ -100,6 +147,10 @@ sc_display_init(struct sc_display *display, SDL_Window *window,
         // Without video, set a static scrcpy icon as window content
         bool ok = sc_display_init_novideo_icon(display, icon_novideo);
         if (!ok) {
+            sc_damage_tracker_destroy(&display->damage_tracker);
+            if (display->shader) {
+                sc_opengl_renderer_destroy(&display->gl_renderer);
+            }
 #ifdef SC_DISPLAY_FORCE_OPENGL_CORE_PROFILE
             SDL_GL_DeleteContext(display->gl_context);
 #endif
@@ -116,20 +167,79 @@ sc_display_destroy(struct sc_display *display) {
     if (display->pending.frame) {
         av_frame_free(&display->pending.frame);
     }
+    sc_damage_tracker_destroy(&display->damage_tracker);
+    if (display->shader) {
+        sc_opengl_renderer_destroy(&display->gl_renderer);
+    }
 #ifdef SC_DISPLAY_FORCE_OPENGL_CORE_PROFILE
     SDL_GL_DeleteContext(display->gl_context);
 #endif
     if (display->texture) {
         SDL_DestroyTexture(display->texture);
     }
+    for (unsigned i = 0; i < display->texture_pool_count; ++i) {
+        SDL_DestroyTexture(display->texture_pool[i].texture);
+    }
     SDL_DestroyRenderer(display->renderer);
 }
 
+// Move the current texture to the pool, evicting the least recently used one
+// if it is full
+static void
+sc_display_release_texture(struct sc_display *display) {
+    assert(display->texture);
+
+    if (!display->texture_size.width) {
+        // The "no video" icon
+        SDL_DestroyTexture(display->texture);
+        display->texture = NULL;
+        return;
+    }
+
+    struct sc_display_texture *pool = display->texture_pool;
+    if (display->texture_pool_count == SC_DISPLAY_TEXTURE_POOL_SIZE) {
+        SDL_DestroyTexture(pool[SC_DISPLAY_TEXTURE_POOL_SIZE - 1].texture);
+        --display->texture_pool_count;
+    }
+
+    memmove(&pool[1], &pool[0], display->texture_pool_count * sizeof(*pool));
+    pool[0].texture = display->texture;
+    pool[0].size = display->texture_size;
+    pool[0].pix_fmt = display->texture_pix_fmt;
+    ++display->texture_pool_count;
+
+    display->texture = NULL;
+}
+
+// Take a texture of the requested size and the current pixel format out of
+// the pool, or return NULL if there is none
+static SDL_Texture *
+sc_display_take_pooled_texture(struct sc_display *display,
+                               struct sc_size size) {
+    struct sc_display_texture *pool = display->texture_pool;
+    for (unsigned i = 0; i < display->texture_pool_count; ++i) {
+        if (pool[i].size.width == size.width
+                && pool[i].size.height == size.height
+                && pool[i].pix_fmt == display->pix_fmt) {
+            SDL_Texture *texture = pool[i].texture;
+            --display->texture_pool_count;
+            memmove(&pool[i], &pool[i + 1],
+                    (display->texture_pool_count - i) * sizeof(*pool));
+            return texture;
+        }
+    }
+
+    return NULL;
+}
+
 static SDL_Texture *
 sc_display_create_texture(struct sc_display *display,
                           struct sc_size size) {
     SDL_Renderer *renderer = display->renderer;
-    SDL_Texture *texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_YV12,
+    uint32_t format = display->pix_fmt == AV_PIX_FMT_NV12
+                    ? SDL_PIXELFORMAT_NV12
+                    : SDL_PIXELFORMAT_YV12;
+    SDL_Texture *texture = SDL_CreateTexture(renderer, format,
                                              SDL_TEXTUREACCESS_STREAMING,
                                              size.width, size.height);
     if (!texture) {
@@ -153,6 +263,32 @@ sc_display_create_texture(struct sc_display *display,
     return texture;
 }
 
+static bool
+sc_display_create_video_texture(struct sc_display *display,
+                                struct sc_size size) {
+    // The new texture content is undefined
+    sc_damage_tracker_reset(&display->damage_tracker);
+
+    if (display->shader) {
+        return sc_opengl_renderer_set_size(&display->gl_renderer, size,
+                                           display->pix_fmt);
+    }
+
+    display->texture = sc_display_take_pooled_texture(display, size);
+    if (display->texture) {
+        LOGD("Texture reused from the pool");
+    } else {
+        display->texture = sc_display_create_texture(display, size);
+        if (!display->texture) {
+            return false;
+        }
+    }
+
+    display->texture_size = size;
+    display->texture_pix_fmt = display->pix_fmt;
+    return true;
+}
+
 static inline void
 sc_display_set_pending_size(struct sc_display *display, struct sc_size size) {
     assert(!display->texture);
@@ -191,9 +327,9 @@ static bool
 sc_display_apply_pending(struct sc_display *display) {
     if (display->pending.flags & SC_DISPLAY_PENDING_FLAG_SIZE) {
         assert(!display->texture);
-        display->texture =
-            sc_display_create_texture(display, display->pending.size);
-        if (!display->texture) {
+        bool ok = sc_display_create_video_texture(display,
+                                                  display->pending.size);
+        if (!ok) {
             return false;
         }
 
@@ -221,11 +357,11 @@ sc_display_set_texture_size_internal(struct sc_display *display,
     assert(size.width && size.height);
 
     if (display->texture) {
-        SDL_DestroyTexture(display->texture);
+        sc_display_release_texture(display);
     }
 
-    display->texture = sc_display_create_texture(display, size);
-    if (!display->texture) {
+    bool ok = sc_display_create_video_texture(display, size);
+    if (!ok) {
         return false;
     }
 
@@ -251,9 +387,98 @@ sc_display_to_sdl_color_range(enum AVColorRange color_range) {
                                            : SDL_YUV_CONVERSION_AUTOMATIC;
 }
 
+static bool
+sc_display_update_texture_pix_fmt(struct sc_display *display,
+                                  const AVFrame *frame) {
+    enum AVPixelFormat pix_fmt = frame->format;
+    if (pix_fmt == display->pix_fmt) {
+        return true;
+    }
+
+    if (pix_fmt != AV_PIX_FMT_YUV420P && pix_fmt != AV_PIX_FMT_NV12) {
+        LOGE("Unsupported frame pixel format: %d", pix_fmt);
+        return false;
+    }
+
+#ifndef SCRCPY_SDL_HAS_UPDATE_NV_TEXTURE
+    if (pix_fmt == AV_PIX_FMT_NV12 && !display->shader) {
+        LOGE("NV12 frames require SDL >= 2.0.16");
+        return false;
+    }
+#endif
+
+    // The texture must be recreated for the new pixel format
+    display->pix_fmt = pix_fmt;
+    struct sc_size size = {frame->width, frame->height};
+    return sc_display_set_texture_size_internal(display, size);
+}
+
+// Upload a region of the frame (the whole frame if rect is NULL)
+static bool
+sc_display_update_texture_rect(struct sc_display *display,
+                               const AVFrame *frame,
+                               const struct sc_damage_rect *rect) {
+    const uint8_t *data[3] = {frame->data[0], frame->data[1], frame->data[2]};
+    SDL_Rect sdl_rect;
+    if (rect) {
+        assert(!(rect->x % 2) && !(rect->y % 2));
+        sdl_rect.x = rect->x;
+        sdl_rect.y = rect->y;
+        sdl_rect.w = rect->width;
+        sdl_rect.h = rect->height;
+
+        // Point to the top-left corner of the region in each plane
+        data[0] += (size_t) rect->y * frame->linesize[0] + rect->x;
+        bool nv12 = display->pix_fmt == AV_PIX_FMT_NV12;
+        // For NV12, the chroma plane is interleaved (2 bytes per sample)
+        size_t chroma_x = nv12 ? rect->x : rect->x / 2;
+        data[1] += (size_t) rect->y / 2 * frame->linesize[1] + chroma_x;
+        if (!nv12) {
+            data[2] += (size_t) rect->y / 2 * frame->linesize[2] + chroma_x;
+        }
+    }
+
+    const SDL_Rect *r = rect ? &sdl_rect : NULL;
+
+    int ret;
+#ifdef SCRCPY_SDL_HAS_UPDATE_NV_TEXTURE
+    if (display->pix_fmt == AV_PIX_FMT_NV12) {
+        ret = SDL_UpdateNVTexture(display->texture, r,
+                                  data[0], frame->linesize[0],
+                                  data[1], frame->linesize[1]);
+    } else
+#endif
+    {
+        ret = SDL_UpdateYUVTexture(display->texture, r,
+                                   data[0], frame->linesize[0],
+                                   data[1], frame->linesize[1],
+                                   data[2], frame->linesize[2]);
+    }
+    if (ret) {
+        LOGD("Could not update texture: %s", SDL_GetError());
+        return false;
+    }
+
+    return true;
+}
+
 static bool
 sc_display_update_texture_internal(struct sc_display *display,
                                    const AVFrame *frame) {
+    if (!sc_display_update_texture_pix_fmt(display, frame)) {
+        return false;
+    }
+
+    if (display->shader) {
+        if (!sc_opengl_renderer_update(&display->gl_renderer, frame)) {
+            return false;
+        }
+
+        display->has_frame = true;
+        sc_latency_tracer_mark(SC_LATENCY_STAGE_UPLOAD, frame->pts);
+        return true;
+    }
+
     if (!display->has_frame) {
         // First frame
         display->has_frame = true;
@@ -264,13 +489,29 @@ sc_display_update_texture_internal(struct sc_display *display,
         SDL_SetYUVConversionMode(sdl_color_range);
     }
 
-    int ret = SDL_UpdateYUVTexture(display->texture, NULL,
-                                   frame->data[0], frame->linesize[0],
-                                   frame->data[1], frame->linesize[1],
-                                   frame->data[2], frame->linesize[2]);
-    if (ret) {
-        LOGD("Could not update texture: %s", SDL_GetError());
-        return false;
+    if (display->damage_tracking) {
+        struct sc_damage_rect rects[SC_DAMAGE_TRACKER_MAX_RECTS];
+        unsigned count = sc_damage_tracker_update(&display->damage_tracker,
+                                                  frame, rects);
+        for (unsigned i = 0; i < count; ++i) {
+            if (!sc_display_update_texture_rect(display, frame, &rects[i])) {
+                sc_damage_tracker_reset(&display->damage_tracker);
+                return false;
+            }
+        }
+
+        sc_latency_tracer_mark(SC_LATENCY_STAGE_UPLOAD, frame->pts);
+
+        if (!count) {
+            // The texture is unchanged
+            return true;
+        }
+    } else {
+        if (!sc_display_update_texture_rect(display, frame, NULL)) {
+            return false;
+        }
+
+        sc_latency_tracer_mark(SC_LATENCY_STAGE_UPLOAD, frame->pts);
     }
 
     if (display->mipmaps) {
@@ -313,6 +554,30 @@ sc_display_render(struct sc_display *display, const SDL_Rect *geometry,
     SDL_Renderer *renderer = display->renderer;
     SDL_Texture *texture = display->texture;
 
+#ifdef SCRCPY_SDL_HAS_RENDER_FLUSH
+    if (display->shader) {
+        if (display->has_frame) {
+            int output_width;
+            int output_height;
+            if (SDL_GetRendererOutputSize(renderer, &output_width,
+                                          &output_height)) {
+                LOGE("Could not get renderer output size: %s",
+                     SDL_GetError());
+                return SC_DISPLAY_RESULT_ERROR;
+            }
+
+            // Execute the SDL_RenderClear() before drawing
+            SDL_RenderFlush(renderer);
+            sc_opengl_renderer_render(&display->gl_renderer, geometry,
+                                      output_height, orientation);
+        }
+
+        SDL_RenderPresent(renderer);
+        sc_latency_tracer_mark_present();
+        return SC_DISPLAY_RESULT_OK;
+    }
+#endif
+
     if (orientation == SC_ORIENTATION_0) {
         int ret = SDL_RenderCopy(renderer, texture, NULL, geometry);
         if (ret) {
@@ -347,5 +612,6 @@ sc_display_render(struct sc_display *display, const SDL_Rect *geometry,
     }
 
     SDL_RenderPresent(display->renderer);
+    sc_latency_tracer_mark_present();
     return SC_DISPLAY_RESULT_OK;
 }
@@ -9,16 +9,39 @@
 #include <SDL2/SDL.h>
 
 #include "coords.h"
+#include "damage_tracker.h"
 #include "opengl.h"
+#include "opengl_renderer.h"
 #include "options.h"
 
 #ifdef __APPLE__
 # define SC_DISPLAY_FORCE_OPENGL_CORE_PROFILE
 #endif
 
+// Enough to keep the texture of the other orientation
+#define SC_DISPLAY_TEXTURE_POOL_SIZE 2
+
+struct sc_display_texture {
+    SDL_Texture *texture;
+    struct sc_size size;
+    enum AVPixelFormat pix_fmt;
+};
+
 struct sc_display {
     SDL_Renderer *renderer;
     SDL_Texture *texture;
+    // The pixel format of the frames the texture is created for (YUV420P, or
+    // NV12 for frames downloaded from a hardware decoder)
+    enum AVPixelFormat pix_fmt;
+    // The size and pixel format of the video texture, if any
+    struct sc_size texture_size;
+    enum AVPixelFormat texture_pix_fmt;
+
+    // Textures of the previous sizes, most recent first, so that switching
+    // back to them (device rotation, resizing) does not stall on a new
+    // allocation
+    struct sc_display_texture texture_pool[SC_DISPLAY_TEXTURE_POOL_SIZE];
+    unsigned texture_pool_count;
 
     struct sc_opengl gl;
 #ifdef SC_DISPLAY_FORCE_OPENGL_CORE_PROFILE
@@ -27,6 +50,15 @@ struct sc_display {
 
     bool mipmaps;
 
+    // If set, the video frames are rendered by gl_renderer instead of the
+    // SDL texture
+    bool shader;
+    struct sc_opengl_renderer gl_renderer;
+
+    // If set, only the regions which changed are uploaded to the texture
+    bool damage_tracking;
+    struct sc_damage_tracker damage_tracker;
+
     struct {
 #define SC_DISPLAY_PENDING_FLAG_SIZE 1
 #define SC_DISPLAY_PENDING_FLAG_FRAME 2
@@ -46,7 +78,8 @@ enum sc_display_result {
 
 bool
 sc_display_init(struct sc_display *display, SDL_Window *window,
-                SDL_Surface *icon_novideo, bool mipmaps);
+                SDL_Surface *icon_novideo, bool mipmaps, bool shader,
+                bool damage_tracking, bool vsync);
 
 void
 sc_display_destroy(struct sc_display *display);
@@ -1,15 +1,71 @@
 #include "events.h"
 
 #include <assert.h>
+#include <signal.h>
 
 #include "util/log.h"
 #include "util/thread.h"
+#include "util/vecdeque.h"
+
+// Interval to check for a termination signal in headless mode
+#define SC_EVENTS_SIGNAL_CHECK_INTERVAL SC_TICK_FROM_MS(100)
+
+struct sc_event_queue SC_VECDEQUE(SDL_Event);
+
+static struct {
+    bool enabled;
+    sc_mutex mutex;
+    sc_cond cond;
+    struct sc_event_queue queue;
+    bool reject_runnables;
+} sc_headless;
+
+static volatile sig_atomic_t sc_quit_requested;
+
+static void
+sc_events_on_signal(int sig) {
+    (void) sig;
+    // Only async-signal-safe operations are allowed here
+    sc_quit_requested = 1;
+}
+
+// Return 1 on success, 0 if filtered, -1 on error (like SDL_PushEvent())
+static int
+sc_events_push(SDL_Event *event) {
+    if (!sc_headless.enabled) {
+        return SDL_PushEvent(event);
+    }
+
+    sc_mutex_lock(&sc_headless.mutex);
+
+    if (event->type == SC_EVENT_RUN_ON_MAIN_THREAD
+            && sc_headless.reject_runnables) {
+        sc_mutex_unlock(&sc_headless.mutex);
+        return 0;
+    }
+
+    bool ok = sc_vecdeque_push(&sc_headless.queue, *event);
+    if (!ok) {
+        sc_mutex_unlock(&sc_headless.mutex);
+        LOG_OOM();
+        return -1;
+    }
+
+    sc_cond_signal(&sc_headless.cond);
+    sc_mutex_unlock(&sc_headless.mutex);
+
+    return 1;
+}
 
 bool
-sc_push_event_impl(uint32_t type, const char *name) {
-    SDL_Event event;
-    event.type = type;
-    int ret = SDL_PushEvent(&event);
+sc_push_event_impl(uint32_t type, void *data, const char *name) {
+    SDL_Event event = {
+        .user = {
+            .type = type,
+            .data1 = data,
+        },
+    };
+    int ret = sc_events_push(&event);
     // ret < 0: error (queue full)
     // ret == 0: event was filtered
     // ret == 1: success
@@ -30,7 +86,7 @@ sc_post_to_main_thread(sc_runnable_fn run, void *userdata) {
             .data2 = userdata,
         },
     };
-    int ret = SDL_PushEvent(&event);
+    int ret = sc_events_push(&event);
     // ret < 0: error (queue full)
     // ret == 0: event was filtered
     // ret == 1: success
@@ -64,5 +120,106 @@ void
 sc_reject_new_runnables(void) {
     assert(sc_thread_get_id() == SC_MAIN_THREAD_ID);
 
+    if (sc_headless.enabled) {
+        sc_mutex_lock(&sc_headless.mutex);
+        sc_headless.reject_runnables = true;
+        sc_mutex_unlock(&sc_headless.mutex);
+        return;
+    }
+
     SDL_SetEventFilter(task_event_filter, NULL);
 }
+
+bool
+sc_events_init_headless(void) {
+    assert(sc_thread_get_id() == SC_MAIN_THREAD_ID);
+    assert(!sc_headless.enabled);
+
+    bool ok = sc_mutex_init(&sc_headless.mutex);
+    if (!ok) {
+        return false;
+    }
+
+    ok = sc_cond_init(&sc_headless.cond);
+    if (!ok) {
+        sc_mutex_destroy(&sc_headless.mutex);
+        return false;
+    }
+
+    sc_vecdeque_init(&sc_headless.queue);
+    sc_headless.reject_runnables = false;
+    sc_headless.enabled = true;
+
+#ifndef _WIN32
+    // SDL installs these handlers on SDL_Init(), handle them without SDL (on
+    // Windows, the console control handler pushes the event directly)
+    signal(SIGINT, sc_events_on_signal);
+    signal(SIGTERM, sc_events_on_signal);
+#endif
+
+    return true;
+}
+
+void
+sc_events_destroy_headless(void) {
+    assert(sc_headless.enabled);
+
+#ifndef _WIN32
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+#endif
+
+    sc_headless.enabled = false;
+    sc_vecdeque_destroy(&sc_headless.queue);
+    sc_cond_destroy(&sc_headless.cond);
+    sc_mutex_destroy(&sc_headless.mutex);
+}
+
+static bool
+sc_events_pop_headless(SDL_Event *event) {
+    sc_mutex_assert(&sc_headless.mutex);
+
+    if (!sc_vecdeque_is_empty(&sc_headless.queue)) {
+        *event = sc_vecdeque_pop(&sc_headless.queue);
+        return true;
+    }
+
+    if (sc_quit_requested) {
+        sc_quit_requested = 0;
+        event->type = SDL_QUIT;
+        return true;
+    }
+
+    return false;
+}
+
+bool
+sc_events_wait(SDL_Event *event) {
+    if (!sc_headless.enabled) {
+        return SDL_WaitEvent(event);
+    }
+
+    sc_mutex_lock(&sc_headless.mutex);
+    while (!sc_events_pop_headless(event)) {
+        // A signal handler could not signal the condition variable, so wake
+        // up periodically to check for a termination request
+        sc_tick deadline = sc_tick_now() + SC_EVENTS_SIGNAL_CHECK_INTERVAL;
+        sc_cond_timedwait(&sc_headless.cond, &sc_headless.mutex, deadline);
+    }
+    sc_mutex_unlock(&sc_headless.mutex);
+
+    return true;
+}
+
+bool
+sc_events_poll(SDL_Event *event) {
+    if (!sc_headless.enabled) {
+        return SDL_PollEvent(event);
+    }
+
+    sc_mutex_lock(&sc_headless.mutex);
+    bool ok = sc_events_pop_headless(event);
+    sc_mutex_unlock(&sc_headless.mutex);
+
+    return ok;
+}
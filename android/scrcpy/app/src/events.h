@@ -20,12 +20,20 @@ enum {
     SC_EVENT_TIME_LIMIT_REACHED,
     SC_EVENT_CONTROLLER_ERROR,
     SC_EVENT_AOA_OPEN_ERROR,
+    SC_EVENT_PRESENT_FRAME,
+    SC_EVENT_RESTREAMER_ERROR,
+    SC_EVENT_SCREEN_FRAME_SIZE,
+    SC_EVENT_SCREEN_RENDER_ERROR,
 };
 
 bool
-sc_push_event_impl(uint32_t type, const char *name);
+sc_push_event_impl(uint32_t type, void *data, const char *name);
 
-#define sc_push_event(TYPE) sc_push_event_impl(TYPE, # TYPE)
+#define sc_push_event(TYPE) sc_push_event_impl(TYPE, NULL, # TYPE)
+
+// The data is received in event.user.data1
+#define sc_push_event_with_data(TYPE, DATA) \
+    sc_push_event_impl(TYPE, DATA, # TYPE)
 
 typedef void (*sc_runnable_fn)(void *userdata);
 
@@ -35,4 +43,31 @@ sc_post_to_main_thread(sc_runnable_fn run, void *userdata);
 void
 sc_reject_new_runnables(void);
 
+/**
+ * Deliver the events through an internal queue instead of the SDL event queue
+ *
+ * This allows to run without initializing SDL at all (when there is no window,
+ * no playback and no clipboard synchronization). SIGINT and SIGTERM are then
+ * handled by pushing a SDL_QUIT event.
+ *
+ * Must be called from the main thread before any event is pushed.
+ */
+bool
+sc_events_init_headless(void);
+
+void
+sc_events_destroy_headless(void);
+
+/**
+ * Wait for the next event, either from SDL or from the headless queue
+ */
+bool
+sc_events_wait(SDL_Event *event);
+
+/**
+ * Poll the next event (if any), either from SDL or from the headless queue
+ */
+bool
+sc_events_poll(SDL_Event *event);
+
 #endif
@@ -6,9 +6,19 @@
 
 #include "adb/adb.h"
 #include "util/log.h"
+#include "util/tick.h"
 
 #define DEFAULT_PUSH_TARGET "/sdcard/Download/"
 
+// Dropping many files generates one event per file: wait until no more files
+// are received during this delay before starting the transfer, so that they
+// are pushed in the same batch
+#define SC_FILE_PUSHER_BATCH_DELAY SC_TICK_FROM_MS(50)
+// Maximum number of files pushed by a single adb command
+#define SC_FILE_PUSHER_BATCH_MAX_FILES 64
+// Keep the command line far below the Windows limit (32767 characters)
+#define SC_FILE_PUSHER_BATCH_MAX_LENGTH 16384
+
 static void
 sc_file_pusher_request_destroy(struct sc_file_pusher_request *req) {
     free(req->file);
@@ -52,6 +62,9 @@ sc_file_pusher_init(struct sc_file_pusher *fp, const char *serial,
     fp->initialized = false;
 
     fp->stopped = false;
+    fp->cancelled = false;
+    fp->push_total = 0;
+    fp->push_done = 0;
 
     fp->push_target = push_target ? push_target : DEFAULT_PUSH_TARGET;
 
@@ -100,6 +113,10 @@ sc_file_pusher_request(struct sc_file_pusher *fp,
         return false;
     }
 
+    if (action == SC_FILE_PUSHER_ACTION_PUSH_FILE) {
+        ++fp->push_total;
+    }
+
     if (was_empty) {
         sc_cond_signal(&fp->event_cond);
     }
@@ -108,51 +125,206 @@ sc_file_pusher_request(struct sc_file_pusher *fp,
     return true;
 }
 
+void
+sc_file_pusher_cancel(struct sc_file_pusher *fp) {
+    if (!fp->initialized) {
+        return;
+    }
+
+    sc_mutex_lock(&fp->mutex);
+    size_t dropped = sc_vecdeque_size(&fp->queue);
+    while (!sc_vecdeque_is_empty(&fp->queue)) {
+        struct sc_file_pusher_request *req = sc_vecdeque_popref(&fp->queue);
+        sc_file_pusher_request_destroy(req);
+    }
+    fp->push_total = 0;
+    fp->push_done = 0;
+    fp->cancelled = true;
+    // Terminate the running adb process, if any
+    sc_intr_interrupt(&fp->intr);
+    sc_mutex_unlock(&fp->mutex);
+
+    LOGI("File transfers cancelled (%" SC_PRIsizet " pending request(s) "
+         "dropped)", dropped);
+}
+
+// Wait until the queue stops growing, to push the dropped files together
+static void
+sc_file_pusher_wait_batch(struct sc_file_pusher *fp) {
+    sc_mutex_assert(&fp->mutex);
+
+    size_t size;
+    do {
+        size = sc_vecdeque_size(&fp->queue);
+        sc_tick deadline = sc_tick_now() + SC_FILE_PUSHER_BATCH_DELAY;
+        bool timed_out = false;
+        while (!fp->stopped && !fp->cancelled && !timed_out) {
+            timed_out =
+                !sc_cond_timedwait(&fp->event_cond, &fp->mutex, deadline);
+        }
+    } while (!fp->stopped && !fp->cancelled
+            && sc_vecdeque_size(&fp->queue) != size);
+}
+
+// Pop the consecutive push requests to execute in a single adb command
+static size_t
+sc_file_pusher_pop_batch(struct sc_file_pusher *fp,
+                         struct sc_file_pusher_request *batch) {
+    sc_mutex_assert(&fp->mutex);
+
+    size_t count = 0;
+    size_t length = 0;
+    while (count < SC_FILE_PUSHER_BATCH_MAX_FILES
+            && !sc_vecdeque_is_empty(&fp->queue)) {
+        struct sc_file_pusher_request *req = sc_vecdeque_peek(&fp->queue);
+        if (req->action != SC_FILE_PUSHER_ACTION_PUSH_FILE) {
+            break;
+        }
+
+        // +3 for the quotes and the separator
+        length += strlen(req->file) + 3;
+        if (count && length > SC_FILE_PUSHER_BATCH_MAX_LENGTH) {
+            break;
+        }
+
+        batch[count++] = sc_vecdeque_pop(&fp->queue);
+    }
+
+    assert(count);
+    return count;
+}
+
+static void
+sc_file_pusher_install(struct sc_file_pusher *fp,
+                       struct sc_file_pusher_request *req) {
+    LOGI("Installing %s...", req->file);
+    bool ok = sc_adb_install(&fp->intr, fp->serial, req->file, 0);
+    if (ok) {
+        LOGI("%s successfully installed", req->file);
+    } else if (!sc_intr_is_interrupted(&fp->intr)) {
+        LOGE("Failed to install %s", req->file);
+    }
+}
+
+static void
+sc_file_pusher_push(struct sc_file_pusher *fp,
+                    struct sc_file_pusher_request *batch, size_t count,
+                    unsigned done, unsigned total) {
+    const char *push_target = fp->push_target;
+
+    bool ok;
+    if (count == 1) {
+        LOGI("Pushing %s...", batch[0].file);
+        ok = sc_adb_push(&fp->intr, fp->serial, batch[0].file, push_target,
+                         0);
+    } else {
+        const char *files[SC_FILE_PUSHER_BATCH_MAX_FILES];
+        for (size_t i = 0; i < count; ++i) {
+            files[i] = batch[i].file;
+        }
+
+        LOGI("Pushing %" SC_PRIsizet " files (%u-%u/%u)...", count, done + 1,
+             done + (unsigned) count, total);
+        ok = sc_adb_push_files(&fp->intr, fp->serial, files, count,
+                               push_target, 0);
+    }
+
+    if (sc_intr_is_interrupted(&fp->intr)) {
+        // Cancelled or stopped, already logged
+        return;
+    }
+
+    if (count == 1) {
+        if (ok) {
+            LOGI("%s successfully pushed to %s", batch[0].file, push_target);
+        } else {
+            LOGE("Failed to push %s to %s", batch[0].file, push_target);
+        }
+    } else {
+        if (ok) {
+            LOGI("%u/%u files successfully pushed to %s",
+                 done + (unsigned) count, total, push_target);
+        } else {
+            // adb continues on error, but does not report which files failed
+            LOGE("Failed to push some of the %" SC_PRIsizet " files to %s",
+                 count, push_target);
+        }
+    }
+}
+
 static int
 run_file_pusher(void *data) {
     struct sc_file_pusher *fp = data;
-    struct sc_intr *intr = &fp->intr;
 
-    const char *serial = fp->serial;
-    assert(serial);
+    assert(fp->serial);
+    assert(fp->push_target);
 
-    const char *push_target = fp->push_target;
-    assert(push_target);
+    struct sc_file_pusher_request batch[SC_FILE_PUSHER_BATCH_MAX_FILES];
 
     for (;;) {
         sc_mutex_lock(&fp->mutex);
         while (!fp->stopped && sc_vecdeque_is_empty(&fp->queue)) {
             sc_cond_wait(&fp->event_cond, &fp->mutex);
         }
+
+        if (!fp->stopped && fp->cancelled) {
+            // The cancellation interrupted the previous transfer (if any)
+            fp->cancelled = false;
+            sc_intr_reset(&fp->intr);
+        }
+
+        if (!fp->stopped && sc_vecdeque_size(&fp->queue) == 1
+                && sc_vecdeque_peek(&fp->queue)->action
+                        == SC_FILE_PUSHER_ACTION_PUSH_FILE) {
+            // Maybe the first file of a multiple drop
+            sc_file_pusher_wait_batch(fp);
+        }
+
         if (fp->stopped) {
             // stop immediately, do not process further events
             sc_mutex_unlock(&fp->mutex);
             break;
         }
 
+        if (fp->cancelled) {
+            // Cancelled while waiting for the batch
+            sc_mutex_unlock(&fp->mutex);
+            continue;
+        }
+
         assert(!sc_vecdeque_is_empty(&fp->queue));
-        struct sc_file_pusher_request req = sc_vecdeque_pop(&fp->queue);
+        size_t count;
+        if (sc_vecdeque_peek(&fp->queue)->action
+                == SC_FILE_PUSHER_ACTION_INSTALL_APK) {
+            batch[0] = sc_vecdeque_pop(&fp->queue);
+            count = 1;
+        } else {
+            count = sc_file_pusher_pop_batch(fp, batch);
+        }
+        unsigned done = fp->push_done;
+        unsigned total = fp->push_total;
         sc_mutex_unlock(&fp->mutex);
 
-        if (req.action == SC_FILE_PUSHER_ACTION_INSTALL_APK) {
-            LOGI("Installing %s...", req.file);
-            bool ok = sc_adb_install(intr, serial, req.file, 0);
-            if (ok) {
-                LOGI("%s successfully installed", req.file);
-            } else {
-                LOGE("Failed to install %s", req.file);
-            }
+        if (batch[0].action == SC_FILE_PUSHER_ACTION_INSTALL_APK) {
+            sc_file_pusher_install(fp, &batch[0]);
         } else {
-            LOGI("Pushing %s...", req.file);
-            bool ok = sc_adb_push(intr, serial, req.file, push_target, 0);
-            if (ok) {
-                LOGI("%s successfully pushed to %s", req.file, push_target);
-            } else {
-                LOGE("Failed to push %s to %s", req.file, push_target);
+            sc_file_pusher_push(fp, batch, count, done, total);
+
+            sc_mutex_lock(&fp->mutex);
+            if (!fp->cancelled) {
+                fp->push_done += count;
+                if (fp->push_done == fp->push_total) {
+                    // All the requested files have been processed
+                    fp->push_done = 0;
+                    fp->push_total = 0;
+                }
             }
+            sc_mutex_unlock(&fp->mutex);
         }
 
-        sc_file_pusher_request_destroy(&req);
+        for (size_t i = 0; i < count; ++i) {
+            sc_file_pusher_request_destroy(&batch[i]);
+        }
     }
     return 0;
 }
@@ -29,8 +29,13 @@ struct sc_file_pusher {
     sc_cond event_cond;
     bool stopped;
     bool initialized;
+    bool cancelled; // all the pending requests have been cancelled
     struct sc_file_pusher_request_queue queue;
 
+    // Aggregate progress of the files to push, since the queue was last empty
+    unsigned push_total;
+    unsigned push_done;
+
     struct sc_intr intr;
 };
 
@@ -55,4 +60,10 @@ bool
 sc_file_pusher_request(struct sc_file_pusher *fp,
                        enum sc_file_pusher_action action, char *file);
 
+/**
+ * Cancel the current transfer and drop all the pending requests
+ */
+void
+sc_file_pusher_cancel(struct sc_file_pusher *fp);
+
 #endif
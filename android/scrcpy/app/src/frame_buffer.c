@@ -4,8 +4,37 @@
 
 #include "util/log.h"
 
+static bool
+sc_frame_buffer_init_ring(struct sc_frame_buffer *fb) {
+    for (unsigned i = 0; i < fb->slot_count; ++i) {
+        fb->slots[i] = av_frame_alloc();
+        if (!fb->slots[i]) {
+            LOG_OOM();
+            while (i) {
+                av_frame_free(&fb->slots[--i]);
+            }
+            return false;
+        }
+    }
+
+    atomic_init(&fb->head, 0);
+    atomic_init(&fb->tail, 0);
+
+    return true;
+}
+
 bool
-sc_frame_buffer_init(struct sc_frame_buffer *fb) {
+sc_frame_buffer_init(struct sc_frame_buffer *fb, unsigned slot_count,
+                     enum sc_frame_buffer_policy policy) {
+    assert(slot_count && slot_count <= SC_FRAME_BUFFER_MAX_SLOTS);
+
+    fb->slot_count = slot_count;
+    fb->policy = policy;
+
+    if (slot_count > 1) {
+        return sc_frame_buffer_init_ring(fb);
+    }
+
     fb->pending_frame = av_frame_alloc();
     if (!fb->pending_frame) {
         LOG_OOM();
@@ -34,6 +63,13 @@ sc_frame_buffer_init(struct sc_frame_buffer *fb) {
 
 void
 sc_frame_buffer_destroy(struct sc_frame_buffer *fb) {
+    if (fb->slot_count > 1) {
+        for (unsigned i = 0; i < fb->slot_count; ++i) {
+            av_frame_free(&fb->slots[i]);
+        }
+        return;
+    }
+
     sc_mutex_destroy(&fb->mutex);
     av_frame_free(&fb->pending_frame);
     av_frame_free(&fb->tmp_frame);
@@ -46,9 +82,43 @@ swap_frames(AVFrame **lhs, AVFrame **rhs) {
     *rhs = tmp;
 }
 
+static bool
+sc_frame_buffer_ring_push(struct sc_frame_buffer *fb, const AVFrame *frame,
+                          enum sc_frame_buffer_drop *drop, unsigned *slot) {
+    unsigned tail = atomic_load_explicit(&fb->tail, memory_order_relaxed);
+    unsigned head = atomic_load_explicit(&fb->head, memory_order_acquire);
+
+    unsigned index = tail % fb->slot_count;
+    if (tail - head == fb->slot_count) {
+        // The ring is full. The slots are owned by the consumer, so the only
+        // option without blocking is to drop the new frame.
+        *drop = SC_FRAME_BUFFER_DROP_FULL;
+        *slot = index;
+        return true;
+    }
+
+    // The slot between head and tail has been released by the consumer (it
+    // is empty)
+    int r = av_frame_ref(fb->slots[index], frame);
+    if (r) {
+        LOGE("Could not ref frame: %d", r);
+        return false;
+    }
+
+    // Publish the frame to the consumer
+    atomic_store_explicit(&fb->tail, tail + 1, memory_order_release);
+
+    *drop = SC_FRAME_BUFFER_DROP_NONE;
+    return true;
+}
+
 bool
 sc_frame_buffer_push(struct sc_frame_buffer *fb, const AVFrame *frame,
-                     bool *previous_frame_skipped) {
+                     enum sc_frame_buffer_drop *drop, unsigned *slot) {
+    if (fb->slot_count > 1) {
+        return sc_frame_buffer_ring_push(fb, frame, drop, slot);
+    }
+
     // Use a temporary frame to preserve pending_frame in case of error.
     // tmp_frame is an empty frame, no need to call av_frame_unref() beforehand.
     int r = av_frame_ref(fb->tmp_frame, frame);
@@ -64,9 +134,9 @@ sc_frame_buffer_push(struct sc_frame_buffer *fb, const AVFrame *frame,
     swap_frames(&fb->pending_frame, &fb->tmp_frame);
     av_frame_unref(fb->tmp_frame);
 
-    if (previous_frame_skipped) {
-        *previous_frame_skipped = !fb->pending_frame_consumed;
-    }
+    *drop = fb->pending_frame_consumed ? SC_FRAME_BUFFER_DROP_NONE
+                                       : SC_FRAME_BUFFER_DROP_REPLACED;
+    *slot = 0;
     fb->pending_frame_consumed = false;
 
     sc_mutex_unlock(&fb->mutex);
@@ -74,10 +144,57 @@ sc_frame_buffer_push(struct sc_frame_buffer *fb, const AVFrame *frame,
     return true;
 }
 
-void
-sc_frame_buffer_consume(struct sc_frame_buffer *fb, AVFrame *dst) {
+static bool
+sc_frame_buffer_ring_consume(struct sc_frame_buffer *fb, AVFrame *dst,
+                             unsigned *stale) {
+    unsigned head = atomic_load_explicit(&fb->head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&fb->tail, memory_order_acquire);
+
+    unsigned dropped = 0;
+    if (fb->policy == SC_FRAME_BUFFER_POLICY_NEWEST_KEEP_SPARE) {
+        // Keep at most 2 frames: the one to consume and a spare
+        while (tail - head > 2) {
+            av_frame_unref(fb->slots[head % fb->slot_count]);
+            ++head;
+            ++dropped;
+        }
+    }
+
+    if (stale) {
+        *stale = dropped;
+    }
+
+    if (head == tail) {
+        // Nothing to consume, but release the dropped slots anyway
+        atomic_store_explicit(&fb->head, head, memory_order_release);
+        return false;
+    }
+
+    av_frame_move_ref(dst, fb->slots[head % fb->slot_count]);
+    // av_frame_move_ref() resets its source frame, so the slot is empty
+
+    // Release the slot to the producer
+    atomic_store_explicit(&fb->head, head + 1, memory_order_release);
+
+    return true;
+}
+
+bool
+sc_frame_buffer_consume(struct sc_frame_buffer *fb, AVFrame *dst,
+                        unsigned *stale) {
+    if (fb->slot_count > 1) {
+        return sc_frame_buffer_ring_consume(fb, dst, stale);
+    }
+
+    if (stale) {
+        *stale = 0;
+    }
+
     sc_mutex_lock(&fb->mutex);
-    assert(!fb->pending_frame_consumed);
+    if (fb->pending_frame_consumed) {
+        sc_mutex_unlock(&fb->mutex);
+        return false;
+    }
     fb->pending_frame_consumed = true;
 
     av_frame_move_ref(dst, fb->pending_frame);
@@ -85,4 +202,6 @@ sc_frame_buffer_consume(struct sc_frame_buffer *fb, AVFrame *dst) {
     // av_frame_unref()
 
     sc_mutex_unlock(&fb->mutex);
+
+    return true;
 }
@@ -3,6 +3,7 @@
 
 #include "common.h"
 
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <libavutil/frame.h>
 
@@ -11,35 +12,92 @@
 // forward declarations
 typedef struct AVFrame AVFrame;
 
+#define SC_FRAME_BUFFER_MAX_SLOTS 16
+
 /**
- * A frame buffer holds 1 pending frame, which is the last frame received from
- * the producer (typically, the decoder).
+ * A frame buffer holds the pending frames received from the producer
+ * (typically, the decoder).
+ *
+ * With a single slot (the default), it holds 1 pending frame, which is the
+ * last frame received. If a pending frame has not been consumed when the
+ * producer pushes a new frame, then it is lost. The intent is to always
+ * provide access to the very last frame to minimize latency.
  *
- * If a pending frame has not been consumed when the producer pushes a new
- * frame, then it is lost. The intent is to always provide access to the very
- * last frame to minimize latency.
+ * With several slots, it is a lock-free single-producer single-consumer ring:
+ * the producer never blocks, and a few late consumptions (if the consumer
+ * stalls for some milliseconds) do not drop any frame. The pending slots are
+ * owned by the consumer, so if the ring is full, the new frame is dropped
+ * rather than overwriting the oldest one. The frames are handed over to the
+ * consumer with av_frame_move_ref().
  */
 
+enum sc_frame_buffer_policy {
+    // Consume the pending frames in order
+    SC_FRAME_BUFFER_POLICY_FIFO,
+    // Drop the stale frames so that at most 2 frames are pending, consume the
+    // oldest of them and keep the newest as a spare for the next consumption
+    SC_FRAME_BUFFER_POLICY_NEWEST_KEEP_SPARE,
+};
+
+enum sc_frame_buffer_drop {
+    SC_FRAME_BUFFER_DROP_NONE,
+    // single slot: the previous pending frame has been replaced
+    SC_FRAME_BUFFER_DROP_REPLACED,
+    // ring: no free slot, the pushed frame has been dropped
+    SC_FRAME_BUFFER_DROP_FULL,
+    // ring: a stale frame has been dropped on consumption
+    SC_FRAME_BUFFER_DROP_STALE,
+};
+
 struct sc_frame_buffer {
+    unsigned slot_count;
+    enum sc_frame_buffer_policy policy;
+
+    // single slot (slot_count == 1)
     AVFrame *pending_frame;
     AVFrame *tmp_frame; // To preserve the pending frame on error
 
     sc_mutex mutex;
 
     bool pending_frame_consumed;
+
+    // ring (slot_count > 1)
+    AVFrame *slots[SC_FRAME_BUFFER_MAX_SLOTS];
+    // Monotonic indices (the slot is the index modulo slot_count)
+    atomic_uint head; // next frame to consume, written by the consumer only
+    atomic_uint tail; // next slot to fill, written by the producer only
 };
 
 bool
-sc_frame_buffer_init(struct sc_frame_buffer *fb);
+sc_frame_buffer_init(struct sc_frame_buffer *fb, unsigned slot_count,
+                     enum sc_frame_buffer_policy policy);
 
 void
 sc_frame_buffer_destroy(struct sc_frame_buffer *fb);
 
+/**
+ * Push a frame (called from the producer thread)
+ *
+ * If a frame is dropped, then *drop is set to the reason and *slot to the
+ * slot concerned (the slot of the replaced frame, or the slot the pushed frame
+ * could not be written to). Otherwise, *drop is set to
+ * SC_FRAME_BUFFER_DROP_NONE.
+ */
 bool
 sc_frame_buffer_push(struct sc_frame_buffer *fb, const AVFrame *frame,
-                     bool *skipped);
+                     enum sc_frame_buffer_drop *drop, unsigned *slot);
 
-void
-sc_frame_buffer_consume(struct sc_frame_buffer *fb, AVFrame *dst);
+/**
+ * Consume a pending frame (called from the consumer thread)
+ *
+ * Return false if there is no pending frame (which may happen in ring mode, if
+ * stale frames have been dropped by a previous consumption).
+ *
+ * If stale is not NULL, it is set to the number of frames dropped (with the
+ * reason SC_FRAME_BUFFER_DROP_STALE).
+ */
+bool
+sc_frame_buffer_consume(struct sc_frame_buffer *fb, AVFrame *dst,
+                        unsigned *stale);
 
 #endif
@@ -0,0 +1,104 @@
+#include "frame_pacer.h"
+
+#include <assert.h>
+#include <inttypes.h>
+
+#include "util/log.h"
+
+//#define SC_FRAME_PACER_DEBUG // uncomment to debug
+
+#define SC_FRAME_PACER_DEFAULT_REFRESH_RATE 60
+
+void
+sc_frame_pacer_init(struct sc_frame_pacer *pacer) {
+    sc_clock_init(&pacer->clock);
+    pacer->period = SC_TICK_FREQ / SC_FRAME_PACER_DEFAULT_REFRESH_RATE;
+    pacer->vblank = 0;
+    pacer->target = 0;
+
+    pacer->stats.presented = 0;
+    pacer->stats.late = 0;
+    pacer->stats.early = 0;
+    pacer->stats.dropped = 0;
+}
+
+void
+sc_frame_pacer_set_refresh_rate(struct sc_frame_pacer *pacer,
+                                int refresh_rate) {
+    if (refresh_rate <= 0) {
+        LOGD("Unknown display refresh rate, assuming %d Hz",
+             SC_FRAME_PACER_DEFAULT_REFRESH_RATE);
+        refresh_rate = SC_FRAME_PACER_DEFAULT_REFRESH_RATE;
+    }
+
+    sc_tick period = SC_TICK_FREQ / refresh_rate;
+    if (period != pacer->period) {
+        LOGD("Frame pacing on a %d Hz display", refresh_rate);
+        pacer->period = period;
+    }
+}
+
+sc_tick
+sc_frame_pacer_schedule(struct sc_frame_pacer *pacer, sc_tick now,
+                        sc_tick pts) {
+    if (pacer->target) {
+        // The previous frame will never be presented
+        ++pacer->stats.dropped;
+    }
+
+    sc_clock_update(&pacer->clock, now, pts);
+
+    // The arrival date of the frame if there were no jitter
+    sc_tick expected = sc_clock_to_system_time(&pacer->clock, pts);
+    if (expected < now) {
+        expected = now;
+    }
+
+    if (!pacer->vblank) {
+        // Nothing presented yet, the vblank phase is unknown
+        pacer->target = expected;
+        return expected;
+    }
+
+    assert(pacer->period > 0);
+    assert(expected >= pacer->vblank);
+
+    // Target the first vblank following the expected date, but never the
+    // vblank of the last presentation (it is already in the past)
+    sc_tick k = (expected - pacer->vblank + pacer->period - 1) / pacer->period;
+    if (k < 1) {
+        k = 1;
+    }
+    pacer->target = pacer->vblank + k * pacer->period;
+
+#ifdef SC_FRAME_PACER_DEBUG
+    LOGD("Frame pacer: pts=%" PRItick " expected=%" PRItick
+         " target=%" PRItick, pts, expected - now, pacer->target - now);
+#endif
+
+    // Render during the half period preceding the target vblank, so that the
+    // presentation waits for that vblank (with vsync enabled)
+    return pacer->target - pacer->period / 2;
+}
+
+void
+sc_frame_pacer_on_presented(struct sc_frame_pacer *pacer, sc_tick date) {
+    // With vsync enabled, SDL_RenderPresent() returns just after a vblank
+    pacer->vblank = date;
+
+    if (!pacer->target) {
+        // Not a scheduled presentation (e.g. the window has been exposed)
+        return;
+    }
+
+    ++pacer->stats.presented;
+
+    sc_tick tolerance = pacer->period / 2;
+    if (date > pacer->target + tolerance) {
+        ++pacer->stats.late;
+    } else if (date < pacer->target - tolerance) {
+        ++pacer->stats.early;
+    }
+
+    pacer->target = 0;
+}
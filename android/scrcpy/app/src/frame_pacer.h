@@ -0,0 +1,87 @@
+#ifndef SC_FRAME_PACER_H
+#define SC_FRAME_PACER_H
+
+#include "common.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "clock.h"
+#include "util/tick.h"
+
+/**
+ * The frame pacer schedules the presentation of video frames on the host
+ * display refresh cycle.
+ *
+ * Frames are received with a network and decoding jitter. Presenting them as
+ * soon as they are decoded makes them hit arbitrary vblanks (sometimes two
+ * frames in the same refresh period, sometimes none), which causes judder.
+ *
+ * Instead, the device frame cadence is estimated from the PTS (using a
+ * sc_clock to map the stream time to the system time), and each frame is
+ * assigned to the first vblank following its expected (smoothed) arrival time.
+ *
+ * The vblank phase is estimated from the presentation dates: with vsync
+ * enabled, SDL_RenderPresent() returns just after a vblank.
+ *
+ * All functions must be called from the same thread (the main thread).
+ */
+struct sc_frame_pacer {
+    struct sc_clock clock;
+
+    // host display refresh period
+    sc_tick period;
+    // date of a recent vblank (0 if unknown)
+    sc_tick vblank;
+
+    // vblank targeted by the pending presentation (0 if none)
+    sc_tick target;
+
+    struct sc_frame_pacer_stats {
+        uint64_t presented;
+        uint64_t late;    // presented after the target vblank
+        uint64_t early;   // presented before the target vblank
+        uint64_t dropped; // replaced before being presented
+    } stats;
+};
+
+void
+sc_frame_pacer_init(struct sc_frame_pacer *pacer);
+
+/**
+ * Set the host display refresh rate (in Hz, 0 if unknown)
+ */
+void
+sc_frame_pacer_set_refresh_rate(struct sc_frame_pacer *pacer,
+                                int refresh_rate);
+
+/**
+ * Schedule the presentation of a new frame
+ *
+ * Return the date at which the frame must be rendered, so that the
+ * presentation occurs on the target vblank (it may be in the past, in that
+ * case the frame must be rendered immediately).
+ *
+ * If a previous frame is still pending, it is counted as dropped (it will
+ * never be presented).
+ */
+sc_tick
+sc_frame_pacer_schedule(struct sc_frame_pacer *pacer, sc_tick now,
+                        sc_tick pts);
+
+/**
+ * Notify that the pending frame has been presented (i.e. SDL_RenderPresent()
+ * returned) at the given date
+ */
+void
+sc_frame_pacer_on_presented(struct sc_frame_pacer *pacer, sc_tick date);
+
+/**
+ * Indicate whether a scheduled frame has not been presented yet
+ */
+static inline bool
+sc_frame_pacer_is_pending(struct sc_frame_pacer *pacer) {
+    return pacer->target;
+}
+
+#endif
@@ -0,0 +1,284 @@
+#include "frame_transform.h"
+
+#include <assert.h>
+#include <string.h>
+#include <libavutil/pixdesc.h>
+
+#include "util/log.h"
+#include "util/yuv.h"
+
+/** Downcast frame_sink to sc_frame_transform */
+#define DOWNCAST(SINK) container_of(SINK, struct sc_frame_transform, frame_sink)
+
+static void
+sc_frame_transform_get_size(struct sc_frame_transform *ft, int width,
+                            int height, int *out_width, int *out_height) {
+    if (ft->downscale) {
+        // Keep even dimensions, so that the downscaled chroma planes only
+        // depend on complete 2x2 blocks of source chroma samples
+        width = (width / 2) & ~1;
+        height = (height / 2) & ~1;
+    }
+
+    if (ft->pix_fmt == AV_PIX_FMT_YUYV422) {
+        // Pixels are packed by pairs
+        width &= ~1;
+    }
+
+    *out_width = width;
+    *out_height = height;
+}
+
+static bool
+sc_frame_transform_open(struct sc_frame_transform *ft,
+                        const AVCodecContext *ctx) {
+    if (ctx->pix_fmt != AV_PIX_FMT_YUV420P) {
+        LOGE("Frame transform: unsupported input format: %s",
+             av_get_pix_fmt_name(ctx->pix_fmt));
+        return false;
+    }
+
+    ft->ctx = avcodec_alloc_context3(NULL);
+    if (!ft->ctx) {
+        LOG_OOM();
+        return false;
+    }
+
+    ft->ctx->codec_type = AVMEDIA_TYPE_VIDEO;
+    ft->ctx->pix_fmt = ft->pix_fmt;
+    sc_frame_transform_get_size(ft, ctx->width, ctx->height, &ft->ctx->width,
+                                &ft->ctx->height);
+    ft->ctx->time_base = ctx->time_base;
+    ft->ctx->framerate = ctx->framerate;
+    ft->ctx->sample_aspect_ratio = ctx->sample_aspect_ratio;
+    ft->ctx->color_range = ctx->color_range;
+    ft->ctx->colorspace = ctx->colorspace;
+
+    ft->frame = av_frame_alloc();
+    if (!ft->frame) {
+        LOG_OOM();
+        goto error_free_context;
+    }
+
+    ft->tmp_frame = av_frame_alloc();
+    if (!ft->tmp_frame) {
+        LOG_OOM();
+        goto error_free_frame;
+    }
+
+    if (!sc_frame_source_sinks_open(&ft->frame_source, ft->ctx)) {
+        goto error_free_tmp_frame;
+    }
+
+    LOGD("Frame transform: %s to %s%s (%s)",
+         av_get_pix_fmt_name(ctx->pix_fmt), av_get_pix_fmt_name(ft->pix_fmt),
+         ft->downscale ? ", downscaled 2x" : "", sc_yuv_get_impl_name());
+
+    return true;
+
+error_free_tmp_frame:
+    av_frame_free(&ft->tmp_frame);
+error_free_frame:
+    av_frame_free(&ft->frame);
+error_free_context:
+    avcodec_free_context(&ft->ctx);
+
+    return false;
+}
+
+static void
+sc_frame_transform_close(struct sc_frame_transform *ft) {
+    sc_frame_source_sinks_close(&ft->frame_source);
+    av_frame_free(&ft->tmp_frame);
+    av_frame_free(&ft->frame);
+    avcodec_free_context(&ft->ctx);
+}
+
+// Make sure that the frame owns a writable buffer of the requested format
+static bool
+sc_frame_transform_prepare(AVFrame *frame, enum AVPixelFormat pix_fmt,
+                           int width, int height) {
+    if (frame->buf[0] && frame->format == pix_fmt && frame->width == width
+            && frame->height == height && av_frame_is_writable(frame)) {
+        // No sink still references the previous frame, reuse it
+        return true;
+    }
+
+    av_frame_unref(frame);
+    frame->format = pix_fmt;
+    frame->width = width;
+    frame->height = height;
+    if (av_frame_get_buffer(frame, 0) < 0) {
+        LOG_OOM();
+        return false;
+    }
+
+    return true;
+}
+
+static void
+sc_frame_transform_downscale(AVFrame *dst, const AVFrame *src) {
+    for (int i = 0; i < 3; ++i) {
+        int w = i ? dst->width / 2 : dst->width;
+        int h = i ? dst->height / 2 : dst->height;
+        const uint8_t *s = src->data[i];
+        int s_stride = src->linesize[i];
+        for (int y = 0; y < h; ++y) {
+            sc_yuv_downscale_2x(dst->data[i] + y * dst->linesize[i],
+                                s + 2 * y * s_stride,
+                                s + (2 * y + 1) * s_stride, w);
+        }
+    }
+}
+
+static void
+sc_frame_transform_to_nv12(AVFrame *dst, const AVFrame *src) {
+    int w = dst->width;
+    int h = dst->height;
+    int cw = (w + 1) / 2;
+    int ch = (h + 1) / 2;
+
+    for (int y = 0; y < h; ++y) {
+        memcpy(dst->data[0] + y * dst->linesize[0],
+               src->data[0] + y * src->linesize[0], w);
+    }
+
+    for (int y = 0; y < ch; ++y) {
+        sc_yuv_interleave_uv(dst->data[1] + y * dst->linesize[1],
+                             src->data[1] + y * src->linesize[1],
+                             src->data[2] + y * src->linesize[2], cw);
+    }
+}
+
+static void
+sc_frame_transform_to_yuyv(AVFrame *dst, const AVFrame *src) {
+    for (int y = 0; y < dst->height; ++y) {
+        sc_yuv_pack_yuyv(dst->data[0] + y * dst->linesize[0],
+                         src->data[0] + y * src->linesize[0],
+                         src->data[1] + (y / 2) * src->linesize[1],
+                         src->data[2] + (y / 2) * src->linesize[2],
+                         dst->width);
+    }
+}
+
+static void
+sc_frame_transform_to_bgra(AVFrame *dst, const AVFrame *src) {
+    bool bt709 = src->colorspace == AVCOL_SPC_BT709;
+    bool full_range = src->color_range == AVCOL_RANGE_JPEG;
+    const struct sc_yuv_coeffs *coeffs = sc_yuv_get_coeffs(bt709, full_range);
+
+    for (int y = 0; y < dst->height; ++y) {
+        sc_yuv_to_bgra(dst->data[0] + y * dst->linesize[0],
+                       src->data[0] + y * src->linesize[0],
+                       src->data[1] + (y / 2) * src->linesize[1],
+                       src->data[2] + (y / 2) * src->linesize[2],
+                       dst->width, coeffs);
+    }
+}
+
+static bool
+sc_frame_transform_push(struct sc_frame_transform *ft, const AVFrame *frame) {
+    if (frame->format != AV_PIX_FMT_YUV420P) {
+        // e.g. NV12 frames downloaded from a hardware decoder
+        LOGE("Frame transform: unsupported frame format: %s",
+             av_get_pix_fmt_name(frame->format));
+        return false;
+    }
+
+    int width;
+    int height;
+    sc_frame_transform_get_size(ft, frame->width, frame->height, &width,
+                                &height);
+    if (!width || !height) {
+        LOGE("Frame transform: frame too small: %dx%d", frame->width,
+             frame->height);
+        return false;
+    }
+
+    const AVFrame *src = frame;
+    if (ft->downscale) {
+        // If no conversion is requested, downscale directly into the output
+        AVFrame *scaled = ft->pix_fmt == AV_PIX_FMT_YUV420P ? ft->frame
+                                                             : ft->tmp_frame;
+        if (!sc_frame_transform_prepare(scaled, AV_PIX_FMT_YUV420P, width,
+                                        height)) {
+            return false;
+        }
+        sc_frame_transform_downscale(scaled, frame);
+        src = scaled;
+    }
+
+    AVFrame *out = ft->frame;
+    if (ft->pix_fmt != AV_PIX_FMT_YUV420P) {
+        if (!sc_frame_transform_prepare(out, ft->pix_fmt, width, height)) {
+            return false;
+        }
+
+        switch (ft->pix_fmt) {
+            case AV_PIX_FMT_NV12:
+                sc_frame_transform_to_nv12(out, src);
+                break;
+            case AV_PIX_FMT_YUYV422:
+                sc_frame_transform_to_yuyv(out, src);
+                break;
+            default:
+                assert(ft->pix_fmt == AV_PIX_FMT_BGRA);
+                sc_frame_transform_to_bgra(out, src);
+                break;
+        }
+    }
+
+    // Only copy the relevant properties (av_frame_copy_props() would also
+    // duplicate the side data on every reuse)
+    out->pts = frame->pts;
+    out->sample_aspect_ratio = frame->sample_aspect_ratio;
+    out->color_range = frame->color_range;
+    out->colorspace = frame->colorspace;
+    out->color_primaries = frame->color_primaries;
+    out->color_trc = frame->color_trc;
+
+    // The sinks reference the frame if they need to keep it, in which case
+    // a new buffer will be allocated for the next one
+    return sc_frame_source_sinks_push(&ft->frame_source, out);
+}
+
+static bool
+sc_frame_transform_frame_sink_open(struct sc_frame_sink *sink,
+                                   const AVCodecContext *ctx) {
+    struct sc_frame_transform *ft = DOWNCAST(sink);
+    return sc_frame_transform_open(ft, ctx);
+}
+
+static void
+sc_frame_transform_frame_sink_close(struct sc_frame_sink *sink) {
+    struct sc_frame_transform *ft = DOWNCAST(sink);
+    sc_frame_transform_close(ft);
+}
+
+static bool
+sc_frame_transform_frame_sink_push(struct sc_frame_sink *sink,
+                                   const AVFrame *frame) {
+    struct sc_frame_transform *ft = DOWNCAST(sink);
+    return sc_frame_transform_push(ft, frame);
+}
+
+void
+sc_frame_transform_init(struct sc_frame_transform *ft,
+                        enum AVPixelFormat pix_fmt, bool downscale) {
+    assert(pix_fmt == AV_PIX_FMT_NV12 || pix_fmt == AV_PIX_FMT_YUYV422
+            || pix_fmt == AV_PIX_FMT_BGRA
+            || (pix_fmt == AV_PIX_FMT_YUV420P && downscale));
+
+    ft->pix_fmt = pix_fmt;
+    ft->downscale = downscale;
+
+    sc_frame_source_init(&ft->frame_source);
+
+    static const struct sc_frame_sink_ops ops = {
+        .open = sc_frame_transform_frame_sink_open,
+        .close = sc_frame_transform_frame_sink_close,
+        .push = sc_frame_transform_frame_sink_push,
+    };
+
+    ft->frame_sink.ops = &ops;
+}
@@ -0,0 +1,49 @@
+#ifndef SC_FRAME_TRANSFORM_H
+#define SC_FRAME_TRANSFORM_H
+
+#include "common.h"
+
+#include <stdbool.h>
+#include <libavcodec/avcodec.h>
+#include <libavutil/frame.h>
+
+#include "trait/frame_source.h"
+#include "trait/frame_sink.h"
+
+/**
+ * Pixel format conversion (and optional 2x downscaling) stage
+ *
+ * It receives YUV420P frames and forwards them, converted, to its own sinks.
+ * Inserting it once in the pipeline allows several consumers requiring the
+ * same format to share a single conversion.
+ *
+ * The conversion is performed synchronously by the thread pushing the frames,
+ * using the kernels from util/yuv.h.
+ */
+struct sc_frame_transform {
+    struct sc_frame_sink frame_sink; // frame sink trait
+    struct sc_frame_source frame_source; // frame source trait
+
+    // output format: AV_PIX_FMT_YUV420P (only with downscale),
+    // AV_PIX_FMT_NV12, AV_PIX_FMT_YUYV422 or AV_PIX_FMT_BGRA
+    enum AVPixelFormat pix_fmt;
+    bool downscale;
+
+    // codec context describing the output frames, passed to the sinks
+    AVCodecContext *ctx;
+
+    AVFrame *frame; // output frame, reused while no sink references it
+    AVFrame *tmp_frame; // downscaled YUV420P frame, before conversion
+};
+
+/**
+ * Initialize a frame transform
+ *
+ * If `downscale` is set, the frames are downscaled by 2 (each dimension being
+ * rounded down to an even value) before the conversion.
+ */
+void
+sc_frame_transform_init(struct sc_frame_transform *ft,
+                        enum AVPixelFormat pix_fmt, bool downscale);
+
+#endif
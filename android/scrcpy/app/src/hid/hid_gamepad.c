@@ -3,6 +3,7 @@
 #include <assert.h>
 #include <inttypes.h>
 #include <stddef.h>
+#include <string.h>
 #include <sys/types.h>
 
 #include "util/binary.h"
@@ -367,6 +368,26 @@ sc_hid_gamepad_get_button_id(enum sc_gamepad_button button) {
     }
 }
 
+bool
+sc_hid_gamepad_merge_input(struct sc_hid_input *dst,
+                           const struct sc_hid_input *src) {
+    assert(dst->size == SC_HID_GAMEPAD_EVENT_SIZE);
+    assert(src->size == SC_HID_GAMEPAD_EVENT_SIZE);
+
+    if (dst->hid_id != src->hid_id) {
+        return false;
+    }
+
+    // Each report contains the whole gamepad state, but a button change must
+    // not be lost (e.g. a quick press and release)
+    if (memcmp(dst->data + 12, src->data + 12, 3)) {
+        return false;
+    }
+
+    memcpy(dst->data, src->data, SC_HID_GAMEPAD_EVENT_SIZE);
+    return true;
+}
+
 bool
 sc_hid_gamepad_generate_input_from_button(struct sc_hid_gamepad *hid,
                                           struct sc_hid_input *hid_input,
@@ -393,12 +414,19 @@ sc_hid_gamepad_generate_input_from_button(struct sc_hid_gamepad *hid,
         return false;
     }
 
+    uint32_t buttons = slot->buttons;
     if (event->action == SC_ACTION_DOWN) {
-        slot->buttons |= button;
+        buttons |= button;
     } else {
         assert(event->action == SC_ACTION_UP);
-        slot->buttons &= ~button;
+        buttons &= ~button;
+    }
+
+    if (buttons == slot->buttons) {
+        // The report would be identical to the previous one
+        return false;
     }
+    slot->buttons = buttons;
 
     uint16_t hid_id = sc_hid_gamepad_slot_get_id(slot_idx);
     sc_hid_gamepad_event_from_slot(hid_id, slot, hid_input);
@@ -422,31 +450,45 @@ sc_hid_gamepad_generate_input_from_axis(struct sc_hid_gamepad *hid,
 
     struct sc_hid_gamepad_slot *slot = &hid->slots[slot_idx];
 
+    uint16_t *axis;
+    uint16_t value;
     switch (event->axis) {
         case SC_GAMEPAD_AXIS_LEFTX:
-            slot->axis_left_x = AXIS_RESCALE(event->value);
+            axis = &slot->axis_left_x;
+            value = AXIS_RESCALE(event->value);
             break;
         case SC_GAMEPAD_AXIS_LEFTY:
-            slot->axis_left_y = AXIS_RESCALE(event->value);
+            axis = &slot->axis_left_y;
+            value = AXIS_RESCALE(event->value);
             break;
         case SC_GAMEPAD_AXIS_RIGHTX:
-            slot->axis_right_x = AXIS_RESCALE(event->value);
+            axis = &slot->axis_right_x;
+            value = AXIS_RESCALE(event->value);
             break;
         case SC_GAMEPAD_AXIS_RIGHTY:
-            slot->axis_right_y = AXIS_RESCALE(event->value);
+            axis = &slot->axis_right_y;
+            value = AXIS_RESCALE(event->value);
             break;
         case SC_GAMEPAD_AXIS_LEFT_TRIGGER:
+            axis = &slot->axis_left_trigger;
             // Trigger is always positive between 0 and 32767
-            slot->axis_left_trigger = MAX(0, event->value);
+            value = MAX(0, event->value);
             break;
         case SC_GAMEPAD_AXIS_RIGHT_TRIGGER:
+            axis = &slot->axis_right_trigger;
             // Trigger is always positive between 0 and 32767
-            slot->axis_right_trigger = MAX(0, event->value);
+            value = MAX(0, event->value);
             break;
         default:
             return false;
     }
 
+    if (*axis == value) {
+        // The report would be identical to the previous one
+        return false;
+    }
+    *axis = value;
+
     uint16_t hid_id = sc_hid_gamepad_slot_get_id(slot_idx);
     sc_hid_gamepad_event_from_slot(hid_id, slot, hid_input);
 
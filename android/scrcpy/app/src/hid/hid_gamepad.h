@@ -51,4 +51,15 @@ sc_hid_gamepad_generate_input_from_axis(struct sc_hid_gamepad *hid,
                                         struct sc_hid_input *hid_input,
                                 const struct sc_gamepad_axis_event *event);
 
+/**
+ * Replace a previous (not sent yet) input by a more recent one, for the same
+ * gamepad
+ *
+ * Return false if they could not be merged (different gamepads, or the buttons
+ * state changed, which must not be lost).
+ */
+bool
+sc_hid_gamepad_merge_input(struct sc_hid_input *dst,
+                           const struct sc_hid_input *src);
+
 #endif
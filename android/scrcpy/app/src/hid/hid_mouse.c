@@ -1,5 +1,6 @@
 #include "hid_mouse.h"
 
+#include <assert.h>
 #include <stdint.h>
 
 // 1 byte for buttons + padding, 1 byte for X position, 1 byte for Y position,
@@ -211,6 +212,33 @@ sc_hid_mouse_generate_input_from_scroll(struct sc_hid_input *hid_input,
     return true;
 }
 
+bool
+sc_hid_mouse_merge_motion_input(struct sc_hid_input *dst,
+                                const struct sc_hid_input *src) {
+    assert(dst->hid_id == SC_HID_ID_MOUSE);
+    assert(src->hid_id == SC_HID_ID_MOUSE);
+    assert(dst->size == SC_HID_MOUSE_INPUT_SIZE);
+    assert(src->size == SC_HID_MOUSE_INPUT_SIZE);
+
+    const uint8_t *s = src->data;
+    uint8_t *d = dst->data;
+
+    if (d[0] != s[0] || d[3] || d[4] || s[3] || s[4]) {
+        // Different buttons state or scrolling
+        return false;
+    }
+
+    int x = (int8_t) d[1] + (int8_t) s[1];
+    int y = (int8_t) d[2] + (int8_t) s[2];
+    if (x < -127 || x > 127 || y < -127 || y > 127) {
+        return false;
+    }
+
+    d[1] = x;
+    d[2] = y;
+    return true;
+}
+
 void sc_hid_mouse_generate_open(struct sc_hid_open *hid_open) {
     hid_open->hid_id = SC_HID_ID_MOUSE;
     hid_open->report_desc = SC_HID_MOUSE_REPORT_DESC;
@@ -3,6 +3,8 @@
 
 #include "common.h"
 
+#include <stdbool.h>
+
 #include "hid/hid_event.h"
 #include "input_events.h"
 
@@ -26,4 +28,14 @@ bool
 sc_hid_mouse_generate_input_from_scroll(struct sc_hid_input *hid_input,
                                     const struct sc_mouse_scroll_event *event);
 
+/**
+ * Merge a motion input into a previous (not sent yet) motion input
+ *
+ * Return false if the inputs could not be merged (different buttons state,
+ * scrolling, or accumulated motion out of range).
+ */
+bool
+sc_hid_mouse_merge_motion_input(struct sc_hid_input *dst,
+                                const struct sc_hid_input *src);
+
 #endif
@@ -286,3 +286,56 @@ scrcpy_icon_destroy(SDL_Surface *icon) {
     av_frame_free(&frame);
     SDL_FreeSurface(icon);
 }
+
+static int
+run_icon_loader(void *data) {
+    struct scrcpy_icon_loader *loader = data;
+    loader->icon = scrcpy_icon_load();
+    return 0;
+}
+
+void
+scrcpy_icon_loader_start(struct scrcpy_icon_loader *loader) {
+    loader->icon = NULL;
+    loader->joined = false;
+    loader->thread_started = sc_thread_create(&loader->thread,
+                                              run_icon_loader, "scrcpy-icon",
+                                              loader);
+    if (!loader->thread_started) {
+        LOGW("Could not start icon loader thread");
+    }
+}
+
+static void
+scrcpy_icon_loader_join(struct scrcpy_icon_loader *loader) {
+    if (loader->joined) {
+        return;
+    }
+
+    if (loader->thread_started) {
+        sc_thread_join(&loader->thread, NULL);
+    } else {
+        loader->icon = scrcpy_icon_load();
+    }
+    loader->joined = true;
+}
+
+SDL_Surface *
+scrcpy_icon_loader_take(struct scrcpy_icon_loader *loader) {
+    scrcpy_icon_loader_join(loader);
+
+    SDL_Surface *icon = loader->icon;
+    loader->icon = NULL;
+    return icon;
+}
+
+void
+scrcpy_icon_loader_destroy(struct scrcpy_icon_loader *loader) {
+    if (loader->thread_started) {
+        // Do not load the icon only to release it
+        scrcpy_icon_loader_join(loader);
+    }
+    if (loader->icon) {
+        scrcpy_icon_destroy(loader->icon);
+    }
+}
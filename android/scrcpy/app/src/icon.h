@@ -3,12 +3,51 @@
 
 #include "common.h"
 
+#include <stdbool.h>
 #include <SDL2/SDL_surface.h>
 
+#include "util/thread.h"
+
+/**
+ * Decode the icon in the background
+ *
+ * Decoding the PNG (through libavformat) takes a noticeable part of the
+ * startup time, so it is started while the server is connecting.
+ */
+struct scrcpy_icon_loader {
+    sc_thread thread;
+    bool thread_started;
+    bool joined;
+    SDL_Surface *icon;
+};
+
 SDL_Surface *
 scrcpy_icon_load(void);
 
 void
 scrcpy_icon_destroy(SDL_Surface *icon);
 
+/**
+ * Start loading the icon from a separate thread
+ *
+ * If the thread could not be started, the icon will be loaded synchronously
+ * by scrcpy_icon_loader_take().
+ */
+void
+scrcpy_icon_loader_start(struct scrcpy_icon_loader *loader);
+
+/**
+ * Wait for the icon and transfer its ownership to the caller
+ *
+ * Must be called at most once. Return NULL if the icon could not be loaded.
+ */
+SDL_Surface *
+scrcpy_icon_loader_take(struct scrcpy_icon_loader *loader);
+
+/**
+ * Wait for the loader thread and release the icon if it has not been taken
+ */
+void
+scrcpy_icon_loader_destroy(struct scrcpy_icon_loader *loader);
+
 #endif
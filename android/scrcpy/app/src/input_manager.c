@@ -8,6 +8,7 @@
 #include "android/input.h"
 #include "android/keycodes.h"
 #include "input_events.h"
+#include "latency_tracer.h"
 #include "screen.h"
 #include "shortcut_mod.h"
 #include "util/log.h"
@@ -24,6 +25,7 @@ sc_input_manager_init(struct sc_input_manager *im,
 
     im->controller = params->controller;
     im->fp = params->fp;
+    im->snapshot = params->snapshot;
     im->screen = params->screen;
     im->kp = params->kp;
     im->mp = params->mp;
@@ -414,7 +416,11 @@ sc_input_manager_process_key(struct sc_input_manager *im,
                 }
                 return;
             case SDLK_s:
-                if (im->kp && !shift && !repeat && !paused) {
+                if (shift) {
+                    if (im->snapshot && !repeat && down) {
+                        sc_snapshot_request(im->snapshot);
+                    }
+                } else if (im->kp && !repeat && !paused) {
                     action_app_switch(im, action);
                 }
                 return;
@@ -521,8 +527,12 @@ sc_input_manager_process_key(struct sc_input_manager *im,
                 }
                 return;
             case SDLK_i:
-                if (video && !shift && !repeat && down) {
-                    switch_fps_counter_state(im);
+                if (video && !repeat && down) {
+                    if (shift) {
+                        sc_latency_tracer_dump();
+                    } else {
+                        switch_fps_counter_state(im);
+                    }
                 }
                 return;
             case SDLK_n:
@@ -552,6 +562,11 @@ sc_input_manager_process_key(struct sc_input_manager *im,
                     open_hard_keyboard_settings(im);
                 }
                 return;
+            case SDLK_ESCAPE:
+                if (im->fp && !shift && !repeat && down) {
+                    sc_file_pusher_cancel(im->fp);
+                }
+                return;
         }
 
         return;
@@ -629,6 +644,80 @@ sc_input_manager_get_position(struct sc_input_manager *im, int32_t x,
     };
 }
 
+// Merge the mouse motion events immediately following in the SDL queue, so
+// that a high polling rate mouse does not generate one control message per
+// event. Only the events at the head of the queue are merged, to preserve the
+// order with the other events (e.g. button events).
+static void
+sc_input_manager_coalesce_mouse_motion(SDL_MouseMotionEvent *motion) {
+    SDL_Event next;
+    while (SDL_PeepEvents(&next, 1, SDL_PEEKEVENT, SDL_FIRSTEVENT,
+                          SDL_LASTEVENT) == 1
+            && next.type == SDL_MOUSEMOTION
+            && next.motion.windowID == motion->windowID
+            && next.motion.which == motion->which
+            && next.motion.state == motion->state) {
+        // New events are only appended, so this removes the peeked event
+        int r = SDL_PeepEvents(&next, 1, SDL_GETEVENT, SDL_MOUSEMOTION,
+                               SDL_MOUSEMOTION);
+        assert(r == 1);
+        (void) r;
+
+        motion->timestamp = next.motion.timestamp;
+        motion->x = next.motion.x;
+        motion->y = next.motion.y;
+        motion->xrel += next.motion.xrel;
+        motion->yrel += next.motion.yrel;
+    }
+}
+
+// Same as sc_input_manager_coalesce_mouse_motion(), for the moves of a single
+// finger
+static void
+sc_input_manager_coalesce_finger_motion(SDL_TouchFingerEvent *finger) {
+    assert(finger->type == SDL_FINGERMOTION);
+
+    SDL_Event next;
+    while (SDL_PeepEvents(&next, 1, SDL_PEEKEVENT, SDL_FIRSTEVENT,
+                          SDL_LASTEVENT) == 1
+            && next.type == SDL_FINGERMOTION
+            && next.tfinger.touchId == finger->touchId
+            && next.tfinger.fingerId == finger->fingerId) {
+        int r = SDL_PeepEvents(&next, 1, SDL_GETEVENT, SDL_FINGERMOTION,
+                               SDL_FINGERMOTION);
+        assert(r == 1);
+        (void) r;
+
+        finger->timestamp = next.tfinger.timestamp;
+        finger->x = next.tfinger.x;
+        finger->y = next.tfinger.y;
+        finger->dx += next.tfinger.dx;
+        finger->dy += next.tfinger.dy;
+        finger->pressure = next.tfinger.pressure;
+    }
+}
+
+// Same as sc_input_manager_coalesce_mouse_motion(), for the motion of a single
+// gamepad axis (only the last value matters)
+static void
+sc_input_manager_coalesce_gamepad_axis(SDL_ControllerAxisEvent *axis) {
+    SDL_Event next;
+    while (SDL_PeepEvents(&next, 1, SDL_PEEKEVENT, SDL_FIRSTEVENT,
+                          SDL_LASTEVENT) == 1
+            && next.type == SDL_CONTROLLERAXISMOTION
+            && next.caxis.which == axis->which
+            && next.caxis.axis == axis->axis) {
+        int r = SDL_PeepEvents(&next, 1, SDL_GETEVENT,
+                               SDL_CONTROLLERAXISMOTION,
+                               SDL_CONTROLLERAXISMOTION);
+        assert(r == 1);
+        (void) r;
+
+        axis->timestamp = next.caxis.timestamp;
+        axis->value = next.caxis.value;
+    }
+}
+
 static void
 sc_input_manager_process_mouse_motion(struct sc_input_manager *im,
                                       const SDL_MouseMotionEvent *event) {
@@ -1030,12 +1119,15 @@ sc_input_manager_handle_event(struct sc_input_manager *im,
             // event even if control is disabled
             sc_input_manager_process_key(im, &event->key);
             break;
-        case SDL_MOUSEMOTION:
+        case SDL_MOUSEMOTION: {
             if (!im->mp || paused) {
                 break;
             }
-            sc_input_manager_process_mouse_motion(im, &event->motion);
+            SDL_MouseMotionEvent motion = event->motion;
+            sc_input_manager_coalesce_mouse_motion(&motion);
+            sc_input_manager_process_mouse_motion(im, &motion);
             break;
+        }
         case SDL_MOUSEWHEEL:
             if (!im->mp || paused) {
                 break;
@@ -1048,7 +1140,15 @@ sc_input_manager_handle_event(struct sc_input_manager *im,
             // the event even if control is disabled
             sc_input_manager_process_mouse_button(im, &event->button);
             break;
-        case SDL_FINGERMOTION:
+        case SDL_FINGERMOTION: {
+            if (!im->mp || paused) {
+                break;
+            }
+            SDL_TouchFingerEvent finger = event->tfinger;
+            sc_input_manager_coalesce_finger_motion(&finger);
+            sc_input_manager_process_touch(im, &finger);
+            break;
+        }
         case SDL_FINGERDOWN:
         case SDL_FINGERUP:
             if (!im->mp || paused) {
@@ -1064,12 +1164,15 @@ sc_input_manager_handle_event(struct sc_input_manager *im,
             }
             sc_input_manager_process_gamepad_device(im, &event->cdevice);
             break;
-        case SDL_CONTROLLERAXISMOTION:
+        case SDL_CONTROLLERAXISMOTION: {
             if (!im->gp || paused) {
                 break;
             }
-            sc_input_manager_process_gamepad_axis(im, &event->caxis);
+            SDL_ControllerAxisEvent axis = event->caxis;
+            sc_input_manager_coalesce_gamepad_axis(&axis);
+            sc_input_manager_process_gamepad_axis(im, &axis);
             break;
+        }
         case SDL_CONTROLLERBUTTONDOWN:
         case SDL_CONTROLLERBUTTONUP:
             if (!im->gp || paused) {
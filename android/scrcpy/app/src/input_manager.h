@@ -11,6 +11,7 @@
 #include "controller.h"
 #include "file_pusher.h"
 #include "options.h"
+#include "snapshot.h"
 #include "trait/gamepad_processor.h"
 #include "trait/key_processor.h"
 #include "trait/mouse_processor.h"
@@ -18,6 +19,7 @@
 struct sc_input_manager {
     struct sc_controller *controller;
     struct sc_file_pusher *fp;
+    struct sc_snapshot *snapshot; // may be NULL
     struct sc_screen *screen;
 
     struct sc_key_processor *kp;
@@ -49,6 +51,7 @@ struct sc_input_manager {
 struct sc_input_manager_params {
     struct sc_controller *controller;
     struct sc_file_pusher *fp;
+    struct sc_snapshot *snapshot;
     struct sc_screen *screen;
     struct sc_key_processor *kp;
     struct sc_mouse_processor *mp;
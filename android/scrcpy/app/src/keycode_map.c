@@ -0,0 +1,207 @@
+#include "keycode_map.h"
+
+#include <assert.h>
+#include <SDL2/SDL_keycode.h>
+
+/*
+ * A keycode is either a character (lower than 128), or a scancode combined
+ * with SDLK_SCANCODE_MASK. Both ranges are packed into a single dense index,
+ * so that each table is a plain array of Android keycodes (AKEYCODE_UNKNOWN,
+ * i.e. 0, for the keys not mapped), generated at compile time.
+ */
+#define SC_KEYCODE_MAP_CHARS 128
+#define SC_KEYCODE_MAP_SIZE (SC_KEYCODE_MAP_CHARS + SDL_NUM_SCANCODES)
+#define SC_KEYCODE_MAP_INDEX(K) \
+    (((K) & SDLK_SCANCODE_MASK) ? SC_KEYCODE_MAP_CHARS \
+                                  + ((K) & ~SDLK_SCANCODE_MASK) \
+                                : (K))
+
+static_assert(AKEYCODE_UNKNOWN == 0, "AKEYCODE_UNKNOWN must be 0");
+
+#define MAP(FROM, TO) [SC_KEYCODE_MAP_INDEX(FROM)] = TO
+
+// Navigation keys and ENTER.
+// Used in all modes.
+static const uint16_t special_keys[SC_KEYCODE_MAP_SIZE] = {
+    MAP(SC_KEYCODE_RETURN,    AKEYCODE_ENTER),
+    MAP(SC_KEYCODE_KP_ENTER,  AKEYCODE_NUMPAD_ENTER),
+    MAP(SC_KEYCODE_ESCAPE,    AKEYCODE_ESCAPE),
+    MAP(SC_KEYCODE_BACKSPACE, AKEYCODE_DEL),
+    MAP(SC_KEYCODE_TAB,       AKEYCODE_TAB),
+    MAP(SC_KEYCODE_PAGEUP,    AKEYCODE_PAGE_UP),
+    MAP(SC_KEYCODE_DELETE,    AKEYCODE_FORWARD_DEL),
+    MAP(SC_KEYCODE_HOME,      AKEYCODE_MOVE_HOME),
+    MAP(SC_KEYCODE_END,       AKEYCODE_MOVE_END),
+    MAP(SC_KEYCODE_PAGEDOWN,  AKEYCODE_PAGE_DOWN),
+    MAP(SC_KEYCODE_RIGHT,     AKEYCODE_DPAD_RIGHT),
+    MAP(SC_KEYCODE_LEFT,      AKEYCODE_DPAD_LEFT),
+    MAP(SC_KEYCODE_DOWN,      AKEYCODE_DPAD_DOWN),
+    MAP(SC_KEYCODE_UP,        AKEYCODE_DPAD_UP),
+    MAP(SC_KEYCODE_LCTRL,     AKEYCODE_CTRL_LEFT),
+    MAP(SC_KEYCODE_RCTRL,     AKEYCODE_CTRL_RIGHT),
+    MAP(SC_KEYCODE_LSHIFT,    AKEYCODE_SHIFT_LEFT),
+    MAP(SC_KEYCODE_RSHIFT,    AKEYCODE_SHIFT_RIGHT),
+    MAP(SC_KEYCODE_LALT,      AKEYCODE_ALT_LEFT),
+    MAP(SC_KEYCODE_RALT,      AKEYCODE_ALT_RIGHT),
+    MAP(SC_KEYCODE_LGUI,      AKEYCODE_META_LEFT),
+    MAP(SC_KEYCODE_RGUI,      AKEYCODE_META_RIGHT),
+};
+
+// Numpad navigation keys.
+// Used in all modes, when NumLock and Shift are disabled.
+static const uint16_t kp_nav_keys[SC_KEYCODE_MAP_SIZE] = {
+    MAP(SC_KEYCODE_KP_0,      AKEYCODE_INSERT),
+    MAP(SC_KEYCODE_KP_1,      AKEYCODE_MOVE_END),
+    MAP(SC_KEYCODE_KP_2,      AKEYCODE_DPAD_DOWN),
+    MAP(SC_KEYCODE_KP_3,      AKEYCODE_PAGE_DOWN),
+    MAP(SC_KEYCODE_KP_4,      AKEYCODE_DPAD_LEFT),
+    MAP(SC_KEYCODE_KP_6,      AKEYCODE_DPAD_RIGHT),
+    MAP(SC_KEYCODE_KP_7,      AKEYCODE_MOVE_HOME),
+    MAP(SC_KEYCODE_KP_8,      AKEYCODE_DPAD_UP),
+    MAP(SC_KEYCODE_KP_9,      AKEYCODE_PAGE_UP),
+    MAP(SC_KEYCODE_KP_PERIOD, AKEYCODE_FORWARD_DEL),
+};
+
+// Letters and space.
+// Used in non-text mode.
+static const uint16_t alphaspace_keys[SC_KEYCODE_MAP_SIZE] = {
+    MAP(SC_KEYCODE_a,     AKEYCODE_A),
+    MAP(SC_KEYCODE_b,     AKEYCODE_B),
+    MAP(SC_KEYCODE_c,     AKEYCODE_C),
+    MAP(SC_KEYCODE_d,     AKEYCODE_D),
+    MAP(SC_KEYCODE_e,     AKEYCODE_E),
+    MAP(SC_KEYCODE_f,     AKEYCODE_F),
+    MAP(SC_KEYCODE_g,     AKEYCODE_G),
+    MAP(SC_KEYCODE_h,     AKEYCODE_H),
+    MAP(SC_KEYCODE_i,     AKEYCODE_I),
+    MAP(SC_KEYCODE_j,     AKEYCODE_J),
+    MAP(SC_KEYCODE_k,     AKEYCODE_K),
+    MAP(SC_KEYCODE_l,     AKEYCODE_L),
+    MAP(SC_KEYCODE_m,     AKEYCODE_M),
+    MAP(SC_KEYCODE_n,     AKEYCODE_N),
+    MAP(SC_KEYCODE_o,     AKEYCODE_O),
+    MAP(SC_KEYCODE_p,     AKEYCODE_P),
+    MAP(SC_KEYCODE_q,     AKEYCODE_Q),
+    MAP(SC_KEYCODE_r,     AKEYCODE_R),
+    MAP(SC_KEYCODE_s,     AKEYCODE_S),
+    MAP(SC_KEYCODE_t,     AKEYCODE_T),
+    MAP(SC_KEYCODE_u,     AKEYCODE_U),
+    MAP(SC_KEYCODE_v,     AKEYCODE_V),
+    MAP(SC_KEYCODE_w,     AKEYCODE_W),
+    MAP(SC_KEYCODE_x,     AKEYCODE_X),
+    MAP(SC_KEYCODE_y,     AKEYCODE_Y),
+    MAP(SC_KEYCODE_z,     AKEYCODE_Z),
+    MAP(SC_KEYCODE_SPACE, AKEYCODE_SPACE),
+};
+
+// Numbers and punctuation keys.
+// Used in raw mode only.
+static const uint16_t numbers_punct_keys[SC_KEYCODE_MAP_SIZE] = {
+    MAP(SC_KEYCODE_HASH,          AKEYCODE_POUND),
+    MAP(SC_KEYCODE_PERCENT,       AKEYCODE_PERIOD),
+    MAP(SC_KEYCODE_QUOTE,         AKEYCODE_APOSTROPHE),
+    MAP(SC_KEYCODE_ASTERISK,      AKEYCODE_STAR),
+    MAP(SC_KEYCODE_PLUS,          AKEYCODE_PLUS),
+    MAP(SC_KEYCODE_COMMA,         AKEYCODE_COMMA),
+    MAP(SC_KEYCODE_MINUS,         AKEYCODE_MINUS),
+    MAP(SC_KEYCODE_PERIOD,        AKEYCODE_PERIOD),
+    MAP(SC_KEYCODE_SLASH,         AKEYCODE_SLASH),
+    MAP(SC_KEYCODE_0,             AKEYCODE_0),
+    MAP(SC_KEYCODE_1,             AKEYCODE_1),
+    MAP(SC_KEYCODE_2,             AKEYCODE_2),
+    MAP(SC_KEYCODE_3,             AKEYCODE_3),
+    MAP(SC_KEYCODE_4,             AKEYCODE_4),
+    MAP(SC_KEYCODE_5,             AKEYCODE_5),
+    MAP(SC_KEYCODE_6,             AKEYCODE_6),
+    MAP(SC_KEYCODE_7,             AKEYCODE_7),
+    MAP(SC_KEYCODE_8,             AKEYCODE_8),
+    MAP(SC_KEYCODE_9,             AKEYCODE_9),
+    MAP(SC_KEYCODE_SEMICOLON,     AKEYCODE_SEMICOLON),
+    MAP(SC_KEYCODE_EQUALS,        AKEYCODE_EQUALS),
+    MAP(SC_KEYCODE_AT,            AKEYCODE_AT),
+    MAP(SC_KEYCODE_LEFTBRACKET,   AKEYCODE_LEFT_BRACKET),
+    MAP(SC_KEYCODE_BACKSLASH,     AKEYCODE_BACKSLASH),
+    MAP(SC_KEYCODE_RIGHTBRACKET,  AKEYCODE_RIGHT_BRACKET),
+    MAP(SC_KEYCODE_BACKQUOTE,     AKEYCODE_GRAVE),
+    MAP(SC_KEYCODE_KP_1,          AKEYCODE_NUMPAD_1),
+    MAP(SC_KEYCODE_KP_2,          AKEYCODE_NUMPAD_2),
+    MAP(SC_KEYCODE_KP_3,          AKEYCODE_NUMPAD_3),
+    MAP(SC_KEYCODE_KP_4,          AKEYCODE_NUMPAD_4),
+    MAP(SC_KEYCODE_KP_5,          AKEYCODE_NUMPAD_5),
+    MAP(SC_KEYCODE_KP_6,          AKEYCODE_NUMPAD_6),
+    MAP(SC_KEYCODE_KP_7,          AKEYCODE_NUMPAD_7),
+    MAP(SC_KEYCODE_KP_8,          AKEYCODE_NUMPAD_8),
+    MAP(SC_KEYCODE_KP_9,          AKEYCODE_NUMPAD_9),
+    MAP(SC_KEYCODE_KP_0,          AKEYCODE_NUMPAD_0),
+    MAP(SC_KEYCODE_KP_DIVIDE,     AKEYCODE_NUMPAD_DIVIDE),
+    MAP(SC_KEYCODE_KP_MULTIPLY,   AKEYCODE_NUMPAD_MULTIPLY),
+    MAP(SC_KEYCODE_KP_MINUS,      AKEYCODE_NUMPAD_SUBTRACT),
+    MAP(SC_KEYCODE_KP_PLUS,       AKEYCODE_NUMPAD_ADD),
+    MAP(SC_KEYCODE_KP_PERIOD,     AKEYCODE_NUMPAD_DOT),
+    MAP(SC_KEYCODE_KP_EQUALS,     AKEYCODE_NUMPAD_EQUALS),
+    MAP(SC_KEYCODE_KP_LEFTPAREN,  AKEYCODE_NUMPAD_LEFT_PAREN),
+    MAP(SC_KEYCODE_KP_RIGHTPAREN, AKEYCODE_NUMPAD_RIGHT_PAREN),
+};
+
+#undef MAP
+
+static inline enum android_keycode
+sc_keycode_map_get(const uint16_t table[], enum sc_keycode keycode) {
+    uint32_t k = keycode;
+    uint32_t index;
+    if (k < SC_KEYCODE_MAP_CHARS) {
+        index = k;
+    } else if ((k & SDLK_SCANCODE_MASK)
+            && (k & ~SDLK_SCANCODE_MASK) < SDL_NUM_SCANCODES) {
+        index = SC_KEYCODE_MAP_CHARS + (k & ~SDLK_SCANCODE_MASK);
+    } else {
+        // Other characters (unicode)
+        return AKEYCODE_UNKNOWN;
+    }
+
+    return table[index];
+}
+
+bool
+sc_keycode_to_android(enum sc_keycode from, uint16_t mods,
+                      enum sc_key_inject_mode key_inject_mode,
+                      enum android_keycode *to) {
+    enum android_keycode keycode = sc_keycode_map_get(special_keys, from);
+    if (keycode != AKEYCODE_UNKNOWN) {
+        *to = keycode;
+        return true;
+    }
+
+    if (!(mods & (SC_MOD_NUM | SC_MOD_LSHIFT | SC_MOD_RSHIFT))) {
+        // Handle Numpad events when Num Lock is disabled
+        // If SHIFT is pressed, a text event will be sent instead
+        keycode = sc_keycode_map_get(kp_nav_keys, from);
+        if (keycode != AKEYCODE_UNKNOWN) {
+            *to = keycode;
+            return true;
+        }
+    }
+
+    if (key_inject_mode == SC_KEY_INJECT_MODE_TEXT &&
+            !(mods & (SC_MOD_LCTRL | SC_MOD_RCTRL))) {
+        // do not forward alpha and space key events (unless Ctrl is pressed)
+        return false;
+    }
+
+    // Handle letters and space
+    keycode = sc_keycode_map_get(alphaspace_keys, from);
+    if (keycode != AKEYCODE_UNKNOWN) {
+        *to = keycode;
+        return true;
+    }
+
+    if (key_inject_mode == SC_KEY_INJECT_MODE_RAW) {
+        keycode = sc_keycode_map_get(numbers_punct_keys, from);
+        if (keycode != AKEYCODE_UNKNOWN) {
+            *to = keycode;
+            return true;
+        }
+    }
+
+    return false;
+}
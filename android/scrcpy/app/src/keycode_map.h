@@ -0,0 +1,29 @@
+#ifndef SC_KEYCODE_MAP_H
+#define SC_KEYCODE_MAP_H
+
+#include "common.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "android/keycodes.h"
+#include "input_events.h"
+#include "options.h"
+
+/**
+ * Convert a scrcpy keycode to an Android keycode
+ *
+ * The mapping depends on the modifiers state (`mods`, a bitwise-OR of sc_mod
+ * values) and on the key inject mode.
+ *
+ * The tables are indexed directly by the keycode, so that the conversion of
+ * each key event takes constant time.
+ *
+ * \return false if the key must not be injected as a key event
+ */
+bool
+sc_keycode_to_android(enum sc_keycode from, uint16_t mods,
+                      enum sc_key_inject_mode key_inject_mode,
+                      enum android_keycode *to);
+
+#endif
@@ -0,0 +1,251 @@
+#include "latency_tracer.h"
+
+#include <assert.h>
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "util/file.h"
+#include "util/histogram.h"
+#include "util/log.h"
+#include "util/tick.h"
+
+// Number of frames traced simultaneously (it must be larger than the number
+// of frames in flight in the whole pipeline)
+#define SC_LATENCY_TRACER_RING_SIZE 64
+
+#define SC_LATENCY_NO_PTS -1
+
+// One histogram for the duration between each pair of consecutive stages, and
+// one for the total duration
+#define SC_LATENCY_INTERVAL_COUNT SC_LATENCY_STAGE_COUNT
+#define SC_LATENCY_INTERVAL_TOTAL (SC_LATENCY_INTERVAL_COUNT - 1)
+
+static const char *const sc_latency_interval_names[] = {
+    "demux->decode",
+    "decode",
+    "decode->buffer",
+    "buffer->upload",
+    "upload->present",
+    "total",
+};
+static_assert(ARRAY_LEN(sc_latency_interval_names)
+                == SC_LATENCY_INTERVAL_COUNT, "Missing interval names");
+
+struct sc_latency_entry {
+    atomic_int_least64_t pts;
+    // 0 if the stage has not been reached
+    atomic_int_least64_t ticks[SC_LATENCY_STAGE_COUNT];
+};
+
+static struct {
+    atomic_bool enabled;
+    char *filename; // NULL to log the statistics
+
+    atomic_uint next_entry;
+    struct sc_latency_entry entries[SC_LATENCY_TRACER_RING_SIZE];
+
+    // The frame uploaded but not presented yet
+    atomic_int_least64_t pending_present_pts;
+
+    struct sc_histogram histograms[SC_LATENCY_INTERVAL_COUNT];
+} sc_latency_tracer;
+
+bool
+sc_latency_tracer_enable(const char *filename) {
+    assert(!atomic_load(&sc_latency_tracer.enabled));
+
+    if (filename) {
+        sc_latency_tracer.filename = strdup(filename);
+        if (!sc_latency_tracer.filename) {
+            LOG_OOM();
+            return false;
+        }
+    } else {
+        sc_latency_tracer.filename = NULL;
+    }
+
+    atomic_init(&sc_latency_tracer.next_entry, 0);
+    for (unsigned i = 0; i < SC_LATENCY_TRACER_RING_SIZE; ++i) {
+        struct sc_latency_entry *entry = &sc_latency_tracer.entries[i];
+        atomic_init(&entry->pts, SC_LATENCY_NO_PTS);
+        for (unsigned j = 0; j < SC_LATENCY_STAGE_COUNT; ++j) {
+            atomic_init(&entry->ticks[j], 0);
+        }
+    }
+    atomic_init(&sc_latency_tracer.pending_present_pts, SC_LATENCY_NO_PTS);
+
+    for (unsigned i = 0; i < SC_LATENCY_INTERVAL_COUNT; ++i) {
+        sc_histogram_init(&sc_latency_tracer.histograms[i]);
+    }
+
+    atomic_store_explicit(&sc_latency_tracer.enabled, true,
+                          memory_order_release);
+    return true;
+}
+
+void
+sc_latency_tracer_disable(void) {
+    atomic_store_explicit(&sc_latency_tracer.enabled, false,
+                          memory_order_relaxed);
+    free(sc_latency_tracer.filename);
+    sc_latency_tracer.filename = NULL;
+}
+
+bool
+sc_latency_tracer_is_enabled(void) {
+    return atomic_load_explicit(&sc_latency_tracer.enabled,
+                                memory_order_acquire);
+}
+
+static struct sc_latency_entry *
+sc_latency_tracer_find(int64_t pts) {
+    // Search from the most recent entry, the frames are usually in flight for
+    // a short time
+    unsigned next = atomic_load_explicit(&sc_latency_tracer.next_entry,
+                                         memory_order_relaxed);
+    for (unsigned i = 1; i <= SC_LATENCY_TRACER_RING_SIZE; ++i) {
+        unsigned index = (next - i) % SC_LATENCY_TRACER_RING_SIZE;
+        struct sc_latency_entry *entry = &sc_latency_tracer.entries[index];
+        if (atomic_load_explicit(&entry->pts, memory_order_acquire) == pts) {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+void
+sc_latency_tracer_mark(enum sc_latency_stage stage, int64_t pts) {
+    assert(stage < SC_LATENCY_STAGE_COUNT);
+    assert(stage != SC_LATENCY_STAGE_PRESENT); // use mark_present()
+
+    if (!sc_latency_tracer_is_enabled()) {
+        return;
+    }
+
+    sc_tick now = sc_tick_now();
+
+    if (stage == SC_LATENCY_STAGE_RECV) {
+        unsigned index =
+            atomic_fetch_add_explicit(&sc_latency_tracer.next_entry, 1,
+                                      memory_order_relaxed)
+                % SC_LATENCY_TRACER_RING_SIZE;
+        struct sc_latency_entry *entry = &sc_latency_tracer.entries[index];
+
+        // Invalidate the entry while it is reset
+        atomic_store_explicit(&entry->pts, SC_LATENCY_NO_PTS,
+                              memory_order_relaxed);
+        for (unsigned i = 0; i < SC_LATENCY_STAGE_COUNT; ++i) {
+            atomic_store_explicit(&entry->ticks[i], 0, memory_order_relaxed);
+        }
+        atomic_store_explicit(&entry->ticks[stage], now, memory_order_relaxed);
+        atomic_store_explicit(&entry->pts, pts, memory_order_release);
+        return;
+    }
+
+    struct sc_latency_entry *entry = sc_latency_tracer_find(pts);
+    if (!entry) {
+        // Not traced (or overwritten)
+        return;
+    }
+
+    atomic_store_explicit(&entry->ticks[stage], now, memory_order_relaxed);
+
+    if (stage == SC_LATENCY_STAGE_UPLOAD) {
+        atomic_store_explicit(&sc_latency_tracer.pending_present_pts, pts,
+                              memory_order_relaxed);
+    }
+}
+
+void
+sc_latency_tracer_mark_present(void) {
+    if (!sc_latency_tracer_is_enabled()) {
+        return;
+    }
+
+    int64_t pts =
+        atomic_exchange_explicit(&sc_latency_tracer.pending_present_pts,
+                                 SC_LATENCY_NO_PTS, memory_order_relaxed);
+    if (pts == SC_LATENCY_NO_PTS) {
+        // Already presented
+        return;
+    }
+
+    struct sc_latency_entry *entry = sc_latency_tracer_find(pts);
+    if (!entry) {
+        return;
+    }
+
+    sc_tick now = sc_tick_now();
+    atomic_store_explicit(&entry->ticks[SC_LATENCY_STAGE_PRESENT], now,
+                          memory_order_relaxed);
+
+    sc_tick ticks[SC_LATENCY_STAGE_COUNT];
+    for (unsigned i = 0; i < SC_LATENCY_STAGE_COUNT; ++i) {
+        ticks[i] = atomic_load_explicit(&entry->ticks[i], memory_order_relaxed);
+    }
+
+    for (unsigned i = 0; i < SC_LATENCY_STAGE_COUNT - 1; ++i) {
+        // A stage may be missing if the entry has been reset concurrently
+        if (ticks[i] && ticks[i + 1] && ticks[i + 1] >= ticks[i]) {
+            sc_histogram_record(&sc_latency_tracer.histograms[i],
+                                ticks[i + 1] - ticks[i]);
+        }
+    }
+
+    sc_tick recv = ticks[SC_LATENCY_STAGE_RECV];
+    if (recv && now >= recv) {
+        struct sc_histogram *total =
+            &sc_latency_tracer.histograms[SC_LATENCY_INTERVAL_TOTAL];
+        sc_histogram_record(total, now - recv);
+    }
+}
+
+void
+sc_latency_tracer_dump(void) {
+    if (!sc_latency_tracer_is_enabled()) {
+        return;
+    }
+
+    FILE *file = NULL;
+    if (sc_latency_tracer.filename) {
+        file = sc_file_open(sc_latency_tracer.filename, "a");
+        if (!file) {
+            LOGE("Could not open latency stats file: %s",
+                 sc_latency_tracer.filename);
+            return;
+        }
+        fprintf(file, "Video pipeline latency (us):\n");
+    } else {
+        LOGI("Video pipeline latency (us):");
+    }
+
+    for (unsigned i = 0; i < SC_LATENCY_INTERVAL_COUNT; ++i) {
+        struct sc_histogram_stats stats;
+        sc_histogram_get_stats(&sc_latency_tracer.histograms[i], &stats);
+
+        char line[256];
+        int r = snprintf(line, sizeof(line),
+                         "%-16s count=%" PRIu64 " mean=%" PRIu64 " p50=%"
+                         PRIu64 " p90=%" PRIu64 " p99=%" PRIu64 " max=%"
+                         PRIu64, sc_latency_interval_names[i], stats.count,
+                         stats.mean, stats.p50, stats.p90, stats.p99,
+                         stats.max);
+        assert(r > 0);
+        (void) r;
+
+        if (file) {
+            fprintf(file, "    %s\n", line);
+        } else {
+            LOGI("    %s", line);
+        }
+    }
+
+    if (file) {
+        fclose(file);
+        LOGI("Latency stats written to %s", sc_latency_tracer.filename);
+    }
+}
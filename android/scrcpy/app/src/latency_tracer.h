@@ -0,0 +1,79 @@
+#ifndef SC_LATENCY_TRACER_H
+#define SC_LATENCY_TRACER_H
+
+#include "common.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Video pipeline latency tracer
+ *
+ * Each video frame is timestamped at every stage of the pipeline, and the
+ * duration between consecutive stages is aggregated into histograms, to find
+ * where the frames lose time.
+ *
+ * The frames are identified by their PTS. The tracer is global (the stages
+ * are spread over several components and threads), and recording is
+ * lock-free. When it is disabled, marking a stage costs a single atomic load.
+ */
+
+enum sc_latency_stage {
+    // The packet has been received by the demuxer
+    SC_LATENCY_STAGE_RECV,
+    // The packet is sent to the decoder
+    SC_LATENCY_STAGE_DECODE_SEND,
+    // The frame has been received from the decoder
+    SC_LATENCY_STAGE_DECODE_RECEIVE,
+    // The frame has been pushed to the screen frame buffer
+    SC_LATENCY_STAGE_FRAME_PUSH,
+    // The frame has been uploaded to the texture
+    SC_LATENCY_STAGE_UPLOAD,
+    // The frame has been presented on the window
+    SC_LATENCY_STAGE_PRESENT,
+
+    SC_LATENCY_STAGE_COUNT,
+};
+
+/**
+ * Enable the tracer
+ *
+ * If filename is not NULL, the statistics are appended to this file on dump,
+ * otherwise they are logged.
+ */
+bool
+sc_latency_tracer_enable(const char *filename);
+
+/**
+ * Disable the tracer and release its resources
+ */
+void
+sc_latency_tracer_disable(void);
+
+bool
+sc_latency_tracer_is_enabled(void);
+
+/**
+ * Record the current time for the given stage of the frame identified by pts
+ *
+ * SC_LATENCY_STAGE_RECV starts a new trace for this frame.
+ */
+void
+sc_latency_tracer_mark(enum sc_latency_stage stage, int64_t pts);
+
+/**
+ * Record the presentation of the frame most recently uploaded
+ *
+ * A frame is only accounted on its first presentation (the same texture may
+ * be rendered several times, for example on window resize).
+ */
+void
+sc_latency_tracer_mark_present(void);
+
+/**
+ * Write the statistics collected so far
+ */
+void
+sc_latency_tracer_dump(void);
+
+#endif
@@ -13,6 +13,7 @@
 #include "scrcpy.h"
 #include "usb/scrcpy_otg.h"
 #include "util/log.h"
+#include "util/log_async.h"
 #include "util/net.h"
 #include "util/thread.h"
 #include "version.h"
@@ -86,12 +87,19 @@ main_scrcpy(int argc, char *argv[]) {
 
     sc_log_configure();
 
+    bool async_log = args.opts.async_log && sc_log_async_start();
+
 #ifdef HAVE_USB
     ret = args.opts.otg ? scrcpy_otg(&args.opts) : scrcpy(&args.opts);
 #else
     ret = scrcpy(&args.opts);
 #endif
 
+    if (async_log) {
+        // All the other threads have been joined
+        sc_log_async_stop();
+    }
+
 end:
     if (args.pause_on_exit == SC_PAUSE_ON_EXIT_TRUE ||
             (args.pause_on_exit == SC_PAUSE_ON_EXIT_IF_ERROR &&
@@ -0,0 +1,117 @@
+#include "memory_budget.h"
+
+#include <assert.h>
+#include <stdatomic.h>
+
+static const char *const sc_memory_budget_user_names[] = {
+    [SC_MEMORY_BUDGET_CONTROL] = "control",
+    [SC_MEMORY_BUDGET_RECORDER] = "recorder",
+    [SC_MEMORY_BUDGET_DELAY_BUFFER] = "delay_buffer",
+};
+static_assert(ARRAY_LEN(sc_memory_budget_user_names)
+                    == SC_MEMORY_BUDGET_USER_COUNT,
+              "Missing memory budget user names");
+
+static uint64_t sc_memory_budget_limit;
+static atomic_uint_least64_t sc_memory_budget_total;
+static atomic_uint_least64_t sc_memory_budget_peak;
+static atomic_uint_least64_t sc_memory_budget_usage[SC_MEMORY_BUDGET_USER_COUNT];
+
+void
+sc_memory_budget_init(uint64_t limit) {
+    sc_memory_budget_limit = limit;
+    atomic_init(&sc_memory_budget_total, 0);
+    atomic_init(&sc_memory_budget_peak, 0);
+    for (unsigned i = 0; i < SC_MEMORY_BUDGET_USER_COUNT; ++i) {
+        atomic_init(&sc_memory_budget_usage[i], 0);
+    }
+}
+
+static void
+sc_memory_budget_update_peak(uint64_t total) {
+    uint64_t peak = atomic_load_explicit(&sc_memory_budget_peak,
+                                         memory_order_relaxed);
+    while (total > peak
+            && !atomic_compare_exchange_weak_explicit(&sc_memory_budget_peak,
+                                                      &peak, total,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+        // peak has been updated, retry
+    }
+}
+
+bool
+sc_memory_budget_reserve(enum sc_memory_budget_user user, uint64_t size) {
+    assert(user < SC_MEMORY_BUDGET_USER_COUNT);
+
+    uint64_t total = atomic_load_explicit(&sc_memory_budget_total,
+                                          memory_order_relaxed);
+    uint64_t new_total;
+    do {
+        new_total = total + size;
+        if (sc_memory_budget_limit && new_total > sc_memory_budget_limit) {
+            return false;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&sc_memory_budget_total,
+                                                    &total, new_total,
+                                                    memory_order_relaxed,
+                                                    memory_order_relaxed));
+
+    atomic_fetch_add_explicit(&sc_memory_budget_usage[user], size,
+                              memory_order_relaxed);
+    sc_memory_budget_update_peak(new_total);
+    return true;
+}
+
+void
+sc_memory_budget_force_reserve(enum sc_memory_budget_user user,
+                               uint64_t size) {
+    assert(user < SC_MEMORY_BUDGET_USER_COUNT);
+
+    uint64_t total = atomic_fetch_add_explicit(&sc_memory_budget_total, size,
+                                               memory_order_relaxed);
+    atomic_fetch_add_explicit(&sc_memory_budget_usage[user], size,
+                              memory_order_relaxed);
+    sc_memory_budget_update_peak(total + size);
+}
+
+void
+sc_memory_budget_release(enum sc_memory_budget_user user, uint64_t size) {
+    assert(user < SC_MEMORY_BUDGET_USER_COUNT);
+    assert(atomic_load_explicit(&sc_memory_budget_usage[user],
+                                memory_order_relaxed) >= size);
+
+    atomic_fetch_sub_explicit(&sc_memory_budget_usage[user], size,
+                              memory_order_relaxed);
+    atomic_fetch_sub_explicit(&sc_memory_budget_total, size,
+                              memory_order_relaxed);
+}
+
+uint64_t
+sc_memory_budget_get_usage(enum sc_memory_budget_user user) {
+    assert(user < SC_MEMORY_BUDGET_USER_COUNT);
+    return atomic_load_explicit(&sc_memory_budget_usage[user],
+                                memory_order_relaxed);
+}
+
+uint64_t
+sc_memory_budget_get_total(void) {
+    return atomic_load_explicit(&sc_memory_budget_total,
+                                memory_order_relaxed);
+}
+
+uint64_t
+sc_memory_budget_get_peak(void) {
+    return atomic_load_explicit(&sc_memory_budget_peak, memory_order_relaxed);
+}
+
+uint64_t
+sc_memory_budget_get_limit(void) {
+    return sc_memory_budget_limit;
+}
+
+const char *
+sc_memory_budget_get_user_name(enum sc_memory_budget_user user) {
+    assert(user < SC_MEMORY_BUDGET_USER_COUNT);
+    return sc_memory_budget_user_names[user];
+}
@@ -0,0 +1,82 @@
+#ifndef SC_MEMORY_BUDGET_H
+#define SC_MEMORY_BUDGET_H
+
+#include "common.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Process-wide memory budget of the buffering components
+ *
+ * The components whose buffers may grow with the session (when the device,
+ * the disk or the display cannot keep up) account their memory to their own
+ * user. Once the total would exceed the limit, a reservation fails, and the
+ * component applies its own policy:
+ *  - the controller drops the droppable messages, and force-reserves the
+ *    other ones beyond the limit (it never blocks the producer);
+ *  - the recorder drops the video packets until the next key frame (and the
+ *    audio packets);
+ *  - the delay buffer drops its oldest frames.
+ *
+ * Like the stats counters, the budget is global and lock-free, so that it may
+ * be updated from the components hot paths.
+ */
+
+enum sc_memory_budget_user {
+    SC_MEMORY_BUDGET_CONTROL,
+    SC_MEMORY_BUDGET_RECORDER,
+    SC_MEMORY_BUDGET_DELAY_BUFFER,
+
+    SC_MEMORY_BUDGET_USER_COUNT,
+};
+
+/**
+ * Initialize the budget
+ *
+ * \param limit the budget in bytes, 0 for unlimited (the usage is still
+ *              tracked)
+ */
+void
+sc_memory_budget_init(uint64_t limit);
+
+/**
+ * Reserve size bytes for the user
+ *
+ * Return false (and reserve nothing) if the budget would be exceeded.
+ */
+bool
+sc_memory_budget_reserve(enum sc_memory_budget_user user, uint64_t size);
+
+/**
+ * Reserve size bytes for the user, even if the budget is exceeded
+ *
+ * For memory which must be kept anyway (e.g. codec configuration packets).
+ */
+void
+sc_memory_budget_force_reserve(enum sc_memory_budget_user user, uint64_t size);
+
+void
+sc_memory_budget_release(enum sc_memory_budget_user user, uint64_t size);
+
+// Return the bytes currently reserved by the user
+uint64_t
+sc_memory_budget_get_usage(enum sc_memory_budget_user user);
+
+// Return the bytes currently reserved by all the users
+uint64_t
+sc_memory_budget_get_total(void);
+
+// Return the highest total since initialization
+uint64_t
+sc_memory_budget_get_peak(void);
+
+// Return the limit in bytes (0 if unlimited)
+uint64_t
+sc_memory_budget_get_limit(void);
+
+// Return the user name, used for the stats and the logs
+const char *
+sc_memory_budget_get_user_name(enum sc_memory_budget_user user);
+
+#endif
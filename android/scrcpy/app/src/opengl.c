@@ -5,6 +5,11 @@
 #include <string.h>
 #include <SDL2/SDL.h>
 
+#include "util/log.h"
+
+#define SC_OPENGL_LOAD(GL, NAME) \
+    ((GL)->NAME = SDL_GL_GetProcAddress("gl" #NAME))
+
 void
 sc_opengl_init(struct sc_opengl *gl) {
     gl->GetString = SDL_GL_GetProcAddress("glGetString");
@@ -19,6 +24,50 @@ sc_opengl_init(struct sc_opengl *gl) {
     // optional
     gl->GenerateMipmap = SDL_GL_GetProcAddress("glGenerateMipmap");
 
+    // optional, for the shader render path
+    gl->has_shaders = SC_OPENGL_LOAD(gl, GetIntegerv)
+                   && SC_OPENGL_LOAD(gl, IsEnabled)
+                   && SC_OPENGL_LOAD(gl, Enable)
+                   && SC_OPENGL_LOAD(gl, Disable)
+                   && SC_OPENGL_LOAD(gl, GetError)
+                   && SC_OPENGL_LOAD(gl, Viewport)
+                   && SC_OPENGL_LOAD(gl, PixelStorei)
+                   && SC_OPENGL_LOAD(gl, GenTextures)
+                   && SC_OPENGL_LOAD(gl, DeleteTextures)
+                   && SC_OPENGL_LOAD(gl, BindTexture)
+                   && SC_OPENGL_LOAD(gl, ActiveTexture)
+                   && SC_OPENGL_LOAD(gl, TexImage2D)
+                   && SC_OPENGL_LOAD(gl, TexSubImage2D)
+                   && SC_OPENGL_LOAD(gl, CreateShader)
+                   && SC_OPENGL_LOAD(gl, ShaderSource)
+                   && SC_OPENGL_LOAD(gl, CompileShader)
+                   && SC_OPENGL_LOAD(gl, GetShaderiv)
+                   && SC_OPENGL_LOAD(gl, GetShaderInfoLog)
+                   && SC_OPENGL_LOAD(gl, DeleteShader)
+                   && SC_OPENGL_LOAD(gl, CreateProgram)
+                   && SC_OPENGL_LOAD(gl, AttachShader)
+                   && SC_OPENGL_LOAD(gl, BindAttribLocation)
+                   && SC_OPENGL_LOAD(gl, LinkProgram)
+                   && SC_OPENGL_LOAD(gl, GetProgramiv)
+                   && SC_OPENGL_LOAD(gl, GetProgramInfoLog)
+                   && SC_OPENGL_LOAD(gl, DeleteProgram)
+                   && SC_OPENGL_LOAD(gl, UseProgram)
+                   && SC_OPENGL_LOAD(gl, GetUniformLocation)
+                   && SC_OPENGL_LOAD(gl, Uniform1i)
+                   && SC_OPENGL_LOAD(gl, Uniform2f)
+                   && SC_OPENGL_LOAD(gl, Uniform3fv)
+                   && SC_OPENGL_LOAD(gl, UniformMatrix3fv)
+                   && SC_OPENGL_LOAD(gl, GenBuffers)
+                   && SC_OPENGL_LOAD(gl, DeleteBuffers)
+                   && SC_OPENGL_LOAD(gl, BindBuffer)
+                   && SC_OPENGL_LOAD(gl, BufferData)
+                   && SC_OPENGL_LOAD(gl, GenVertexArrays)
+                   && SC_OPENGL_LOAD(gl, DeleteVertexArrays)
+                   && SC_OPENGL_LOAD(gl, BindVertexArray)
+                   && SC_OPENGL_LOAD(gl, VertexAttribPointer)
+                   && SC_OPENGL_LOAD(gl, EnableVertexAttribArray)
+                   && SC_OPENGL_LOAD(gl, DrawArrays);
+
     const char *version = (const char *) gl->GetString(GL_VERSION);
     assert(version);
     gl->version = version;
@@ -38,6 +87,21 @@ sc_opengl_init(struct sc_opengl *gl) {
         gl->version_major = 0;
         gl->version_minor = 0;
     }
+
+    // The function pointers may be non-NULL even if the functions are not
+    // supported, so also check the version
+    gl->has_pbo = gl->has_shaders
+               && sc_opengl_version_at_least(gl, 3, 2, 3, 0)
+               && SC_OPENGL_LOAD(gl, MapBufferRange)
+               && SC_OPENGL_LOAD(gl, UnmapBuffer)
+               && SC_OPENGL_LOAD(gl, FenceSync)
+               && SC_OPENGL_LOAD(gl, ClientWaitSync)
+               && SC_OPENGL_LOAD(gl, DeleteSync);
+
+    gl->has_buffer_storage = gl->has_pbo && !gl->is_opengles
+            && (sc_opengl_version_at_least(gl, 4, 4, 0, 0)
+                || SDL_GL_ExtensionSupported("GL_ARB_buffer_storage"))
+            && SC_OPENGL_LOAD(gl, BufferStorage);
 }
 
 bool
@@ -55,3 +119,80 @@ sc_opengl_version_at_least(struct sc_opengl *gl,
         || (gl->version_major == minver_major
          && gl->version_minor >= minver_minor);
 }
+
+static GLuint
+sc_opengl_compile_shader(struct sc_opengl *gl, GLenum type,
+                         const char *header, const char *src) {
+    GLuint shader = gl->CreateShader(type);
+    if (!shader) {
+        LOGE("Could not create OpenGL shader");
+        return 0;
+    }
+
+    const GLchar *srcs[] = {header, src};
+    gl->ShaderSource(shader, 2, srcs, NULL);
+    gl->CompileShader(shader);
+
+    GLint status;
+    gl->GetShaderiv(shader, GL_COMPILE_STATUS, &status);
+    if (!status) {
+        char info[512];
+        gl->GetShaderInfoLog(shader, sizeof(info), NULL, info);
+        LOGE("Could not compile %s shader: %s",
+             type == GL_VERTEX_SHADER ? "vertex" : "fragment", info);
+        gl->DeleteShader(shader);
+        return 0;
+    }
+
+    return shader;
+}
+
+GLuint
+sc_opengl_create_program(struct sc_opengl *gl, const char *header,
+                         const char *vertex_src, const char *fragment_src,
+                         const char *const *attribs) {
+    assert(gl->has_shaders);
+
+    GLuint vertex_shader =
+        sc_opengl_compile_shader(gl, GL_VERTEX_SHADER, header, vertex_src);
+    if (!vertex_shader) {
+        return 0;
+    }
+
+    GLuint fragment_shader =
+        sc_opengl_compile_shader(gl, GL_FRAGMENT_SHADER, header, fragment_src);
+    if (!fragment_shader) {
+        gl->DeleteShader(vertex_shader);
+        return 0;
+    }
+
+    GLuint program = gl->CreateProgram();
+    if (!program) {
+        LOGE("Could not create OpenGL program");
+        goto end;
+    }
+
+    gl->AttachShader(program, vertex_shader);
+    gl->AttachShader(program, fragment_shader);
+    for (GLuint i = 0; attribs[i]; ++i) {
+        gl->BindAttribLocation(program, i, attribs[i]);
+    }
+    gl->LinkProgram(program);
+
+    GLint status;
+    gl->GetProgramiv(program, GL_LINK_STATUS, &status);
+    if (!status) {
+        char info[512];
+        gl->GetProgramInfoLog(program, sizeof(info), NULL, info);
+        LOGE("Could not link OpenGL program: %s", info);
+        gl->DeleteProgram(program);
+        program = 0;
+    }
+
+end:
+    // The shaders are deleted once the program is deleted
+    gl->DeleteShader(vertex_shader);
+    gl->DeleteShader(fragment_shader);
+
+    return program;
+}
@@ -23,6 +23,175 @@ struct sc_opengl {
 
     void
     (*GenerateMipmap)(GLenum target);
+
+    // The following functions are only used by the shader render path (see
+    // opengl_renderer.h), they are available if has_shaders is true
+    bool has_shaders;
+
+    void
+    (*GetIntegerv)(GLenum pname, GLint *data);
+
+    GLboolean
+    (*IsEnabled)(GLenum cap);
+
+    void
+    (*Enable)(GLenum cap);
+
+    void
+    (*Disable)(GLenum cap);
+
+    GLenum
+    (*GetError)(void);
+
+    void
+    (*Viewport)(GLint x, GLint y, GLsizei width, GLsizei height);
+
+    void
+    (*PixelStorei)(GLenum pname, GLint param);
+
+    void
+    (*GenTextures)(GLsizei n, GLuint *textures);
+
+    void
+    (*DeleteTextures)(GLsizei n, const GLuint *textures);
+
+    void
+    (*BindTexture)(GLenum target, GLuint texture);
+
+    void
+    (*ActiveTexture)(GLenum texture);
+
+    void
+    (*TexImage2D)(GLenum target, GLint level, GLint internalformat,
+                  GLsizei width, GLsizei height, GLint border, GLenum format,
+                  GLenum type, const void *pixels);
+
+    void
+    (*TexSubImage2D)(GLenum target, GLint level, GLint xoffset,
+                     GLint yoffset, GLsizei width, GLsizei height,
+                     GLenum format, GLenum type, const void *pixels);
+
+    GLuint
+    (*CreateShader)(GLenum type);
+
+    void
+    (*ShaderSource)(GLuint shader, GLsizei count, const GLchar *const *string,
+                    const GLint *length);
+
+    void
+    (*CompileShader)(GLuint shader);
+
+    void
+    (*GetShaderiv)(GLuint shader, GLenum pname, GLint *params);
+
+    void
+    (*GetShaderInfoLog)(GLuint shader, GLsizei max_length, GLsizei *length,
+                        GLchar *info_log);
+
+    void
+    (*DeleteShader)(GLuint shader);
+
+    GLuint
+    (*CreateProgram)(void);
+
+    void
+    (*AttachShader)(GLuint program, GLuint shader);
+
+    void
+    (*BindAttribLocation)(GLuint program, GLuint index, const GLchar *name);
+
+    void
+    (*LinkProgram)(GLuint program);
+
+    void
+    (*GetProgramiv)(GLuint program, GLenum pname, GLint *params);
+
+    void
+    (*GetProgramInfoLog)(GLuint program, GLsizei max_length, GLsizei *length,
+                         GLchar *info_log);
+
+    void
+    (*DeleteProgram)(GLuint program);
+
+    void
+    (*UseProgram)(GLuint program);
+
+    GLint
+    (*GetUniformLocation)(GLuint program, const GLchar *name);
+
+    void
+    (*Uniform1i)(GLint location, GLint v0);
+
+    void
+    (*Uniform2f)(GLint location, GLfloat v0, GLfloat v1);
+
+    void
+    (*Uniform3fv)(GLint location, GLsizei count, const GLfloat *value);
+
+    void
+    (*UniformMatrix3fv)(GLint location, GLsizei count, GLboolean transpose,
+                        const GLfloat *value);
+
+    void
+    (*GenBuffers)(GLsizei n, GLuint *buffers);
+
+    void
+    (*DeleteBuffers)(GLsizei n, const GLuint *buffers);
+
+    void
+    (*BindBuffer)(GLenum target, GLuint buffer);
+
+    void
+    (*BufferData)(GLenum target, GLsizeiptr size, const void *data,
+                  GLenum usage);
+
+    void
+    (*GenVertexArrays)(GLsizei n, GLuint *arrays);
+
+    void
+    (*DeleteVertexArrays)(GLsizei n, const GLuint *arrays);
+
+    void
+    (*BindVertexArray)(GLuint array);
+
+    void
+    (*VertexAttribPointer)(GLuint index, GLint size, GLenum type,
+                           GLboolean normalized, GLsizei stride,
+                           const void *pointer);
+
+    void
+    (*EnableVertexAttribArray)(GLuint index);
+
+    void
+    (*DrawArrays)(GLenum mode, GLint first, GLsizei count);
+
+    // Pixel buffer objects with fences (OpenGL 3.2+ or OpenGL ES 3.0+),
+    // available if has_pbo is true
+    bool has_pbo;
+
+    void *
+    (*MapBufferRange)(GLenum target, GLintptr offset, GLsizeiptr length,
+                      GLbitfield access);
+
+    GLboolean
+    (*UnmapBuffer)(GLenum target);
+
+    GLsync
+    (*FenceSync)(GLenum condition, GLbitfield flags);
+
+    GLenum
+    (*ClientWaitSync)(GLsync sync, GLbitfield flags, GLuint64 timeout);
+
+    void
+    (*DeleteSync)(GLsync sync);
+
+    // Immutable buffer storage, for persistent mappings (OpenGL 4.4+ or
+    // GL_ARB_buffer_storage), available if has_buffer_storage is true
+    bool has_buffer_storage;
+
+    void
+    (*BufferStorage)(GLenum target, GLsizeiptr size, const void *data,
+                     GLbitfield flags);
 };
 
 void
@@ -33,4 +202,18 @@ sc_opengl_version_at_least(struct sc_opengl *gl,
                            int minver_major, int minver_minor,
                            int minver_es_major, int minver_es_minor);
 
+/**
+ * Compile and link a shader program
+ *
+ * The header (typically the #version directive) is prepended to both shader
+ * sources. The vertex attributes in the NULL-terminated array `attribs` are
+ * bound to their index in the array.
+ *
+ * Return 0 on error.
+ */
+GLuint
+sc_opengl_create_program(struct sc_opengl *gl, const char *header,
+                         const char *vertex_src, const char *fragment_src,
+                         const char *const *attribs);
+
 #endif
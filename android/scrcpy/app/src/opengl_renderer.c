@@ -0,0 +1,669 @@
+#include "opengl_renderer.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "util/log.h"
+
+#define SC_OPENGL_RENDERER_ATTRIB_POSITION 0
+#define SC_OPENGL_RENDERER_ATTRIB_TEX_COORD 1
+
+// Timeout to wait for the GPU to release a pixel buffer, in nanoseconds
+#define SC_OPENGL_RENDERER_PBO_WAIT_TIMEOUT ((GLuint64) 100 * 1000 * 1000)
+
+static const char *const attribs[] = {"position", "tex_coord", NULL};
+
+static const char *const vertex_src =
+    "in vec2 position;\n"
+    "in vec2 tex_coord;\n"
+    "out vec2 v_tex_coord;\n"
+    "void main() {\n"
+    "    v_tex_coord = tex_coord;\n"
+    "    gl_Position = vec4(position, 0.0, 1.0);\n"
+    "}\n";
+
+// The planes are filtered separately (the YUV to RGB conversion is affine,
+// so it may be applied after filtering). The filter is a Mitchell-Netravali
+// bicubic, stretched by the downscaling ratio (up to 3x, so at most 12x12
+// texels are read per plane) to avoid aliasing.
+static const char *const fragment_src =
+    "in vec2 v_tex_coord;\n"
+    "out vec4 frag_color;\n"
+    "uniform sampler2D tex_y;\n"
+    "uniform sampler2D tex_u;\n"
+    "uniform sampler2D tex_v;\n"
+    "uniform bool nv12;\n"
+    "uniform mat3 yuv_to_rgb;\n"
+    "uniform vec3 yuv_offset;\n"
+    "uniform vec2 output_size;\n"
+    "\n"
+    "float weight(float x) {\n"
+    "    x = abs(x);\n"
+    "    if (x < 1.0) {\n"
+    "        return ((7.0 * x - 12.0) * x * x + 16.0 / 3.0) / 6.0;\n"
+    "    }\n"
+    "    if (x < 2.0) {\n"
+    "        return (((-7.0 / 3.0 * x + 12.0) * x - 20.0) * x + 32.0 / 3.0)\n"
+    "               / 6.0;\n"
+    "    }\n"
+    "    return 0.0;\n"
+    "}\n"
+    "\n"
+    "vec4 sample_plane(sampler2D tex) {\n"
+    "    vec2 size = vec2(textureSize(tex, 0));\n"
+    "    vec2 scale = clamp(size / output_size, 1.0, 3.0);\n"
+    "    vec2 pos = v_tex_coord * size - 0.5;\n"
+    "    vec2 base = floor(pos);\n"
+    "    vec2 f = pos - base;\n"
+    "    vec4 sum = vec4(0.0);\n"
+    "    float weight_sum = 0.0;\n"
+    "    for (int j = -5; j <= 6; ++j) {\n"
+    "        float wy = weight((float(j) - f.y) / scale.y);\n"
+    "        if (wy == 0.0) {\n"
+    "            continue;\n"
+    "        }\n"
+    "        for (int i = -5; i <= 6; ++i) {\n"
+    "            float w = wy * weight((float(i) - f.x) / scale.x);\n"
+    "            if (w == 0.0) {\n"
+    "                continue;\n"
+    "            }\n"
+    "            vec2 coord = (base + vec2(i, j) + 0.5) / size;\n"
+    "            sum += w * textureLod(tex, coord, 0.0);\n"
+    "            weight_sum += w;\n"
+    "        }\n"
+    "    }\n"
+    "    return sum / weight_sum;\n"
+    "}\n"
+    "\n"
+    "void main() {\n"
+    "    vec3 yuv;\n"
+    "    yuv.x = sample_plane(tex_y).r;\n"
+    "    if (nv12) {\n"
+    "        yuv.yz = sample_plane(tex_u).rg;\n"
+    "    } else {\n"
+    "        yuv.y = sample_plane(tex_u).r;\n"
+    "        yuv.z = sample_plane(tex_v).r;\n"
+    "    }\n"
+    "    vec3 rgb = yuv_to_rgb * (yuv - yuv_offset);\n"
+    "    frag_color = vec4(clamp(rgb, 0.0, 1.0), 1.0);\n"
+    "}\n";
+
+// The GL state modified by the renderer, cached by the SDL renderer
+struct sc_opengl_state {
+    GLint program;
+    GLint vao;
+    GLint array_buffer;
+    GLint pixel_unpack_buffer;
+    GLint active_texture;
+    GLint textures[3];
+    GLint viewport[4];
+    GLint unpack_alignment;
+    GLint unpack_row_length;
+    GLboolean blend;
+    GLboolean scissor;
+};
+
+static void
+sc_opengl_state_save(struct sc_opengl *gl, struct sc_opengl_state *state) {
+    gl->GetIntegerv(GL_CURRENT_PROGRAM, &state->program);
+    gl->GetIntegerv(GL_VERTEX_ARRAY_BINDING, &state->vao);
+    gl->GetIntegerv(GL_ARRAY_BUFFER_BINDING, &state->array_buffer);
+    if (gl->has_pbo) {
+        gl->GetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING,
+                        &state->pixel_unpack_buffer);
+    }
+    gl->GetIntegerv(GL_ACTIVE_TEXTURE, &state->active_texture);
+    for (unsigned i = 0; i < ARRAY_LEN(state->textures); ++i) {
+        gl->ActiveTexture(GL_TEXTURE0 + i);
+        gl->GetIntegerv(GL_TEXTURE_BINDING_2D, &state->textures[i]);
+    }
+    gl->GetIntegerv(GL_VIEWPORT, state->viewport);
+    gl->GetIntegerv(GL_UNPACK_ALIGNMENT, &state->unpack_alignment);
+    gl->GetIntegerv(GL_UNPACK_ROW_LENGTH, &state->unpack_row_length);
+    state->blend = gl->IsEnabled(GL_BLEND);
+    state->scissor = gl->IsEnabled(GL_SCISSOR_TEST);
+}
+
+static void
+sc_opengl_set_enabled(struct sc_opengl *gl, GLenum cap, bool enabled) {
+    if (enabled) {
+        gl->Enable(cap);
+    } else {
+        gl->Disable(cap);
+    }
+}
+
+static void
+sc_opengl_state_restore(struct sc_opengl *gl,
+                        const struct sc_opengl_state *state) {
+    gl->UseProgram(state->program);
+    gl->BindVertexArray(state->vao);
+    gl->BindBuffer(GL_ARRAY_BUFFER, state->array_buffer);
+    if (gl->has_pbo) {
+        gl->BindBuffer(GL_PIXEL_UNPACK_BUFFER, state->pixel_unpack_buffer);
+    }
+    for (unsigned i = 0; i < ARRAY_LEN(state->textures); ++i) {
+        gl->ActiveTexture(GL_TEXTURE0 + i);
+        gl->BindTexture(GL_TEXTURE_2D, state->textures[i]);
+    }
+    gl->ActiveTexture(state->active_texture);
+    gl->Viewport(state->viewport[0], state->viewport[1], state->viewport[2],
+                 state->viewport[3]);
+    gl->PixelStorei(GL_UNPACK_ALIGNMENT, state->unpack_alignment);
+    gl->PixelStorei(GL_UNPACK_ROW_LENGTH, state->unpack_row_length);
+    sc_opengl_set_enabled(gl, GL_BLEND, state->blend);
+    sc_opengl_set_enabled(gl, GL_SCISSOR_TEST, state->scissor);
+}
+
+static void
+sc_opengl_clear_errors(struct sc_opengl *gl) {
+    // Do not report errors caused by the SDL renderer
+    while (gl->GetError() != GL_NO_ERROR) {
+        // continue
+    }
+}
+
+bool
+sc_opengl_renderer_init(struct sc_opengl_renderer *renderer,
+                        struct sc_opengl *gl) {
+    if (!gl->has_shaders
+            || !sc_opengl_version_at_least(gl, 3, 0, /* OpenGL 3.0+ */
+                                               3, 0  /* OpenGL ES 3.0+ */)) {
+        LOGW("Shader rendering requires OpenGL 3.0+ or OpenGL ES 3.0+");
+        return false;
+    }
+
+    const char *header = gl->is_opengles ? "#version 300 es\n"
+                                           "precision highp float;\n"
+                                         : "#version 130\n";
+
+    GLuint program = sc_opengl_create_program(gl, header, vertex_src,
+                                              fragment_src, attribs);
+    if (!program) {
+        return false;
+    }
+
+    struct sc_opengl_state state;
+    sc_opengl_state_save(gl, &state);
+
+    gl->UseProgram(program);
+    gl->Uniform1i(gl->GetUniformLocation(program, "tex_y"), 0);
+    gl->Uniform1i(gl->GetUniformLocation(program, "tex_u"), 1);
+    gl->Uniform1i(gl->GetUniformLocation(program, "tex_v"), 2);
+    renderer->uniforms.nv12 = gl->GetUniformLocation(program, "nv12");
+    renderer->uniforms.yuv_to_rgb =
+        gl->GetUniformLocation(program, "yuv_to_rgb");
+    renderer->uniforms.yuv_offset =
+        gl->GetUniformLocation(program, "yuv_offset");
+    renderer->uniforms.output_size =
+        gl->GetUniformLocation(program, "output_size");
+
+    // Interleaved position and texture coordinates, updated on render
+    gl->GenVertexArrays(1, &renderer->vao);
+    gl->BindVertexArray(renderer->vao);
+    gl->GenBuffers(1, &renderer->vbo);
+    gl->BindBuffer(GL_ARRAY_BUFFER, renderer->vbo);
+    gl->VertexAttribPointer(SC_OPENGL_RENDERER_ATTRIB_POSITION, 2, GL_FLOAT,
+                            GL_FALSE, 4 * sizeof(GLfloat), (void *) 0);
+    gl->VertexAttribPointer(SC_OPENGL_RENDERER_ATTRIB_TEX_COORD, 2, GL_FLOAT,
+                            GL_FALSE, 4 * sizeof(GLfloat),
+                            (void *) (2 * sizeof(GLfloat)));
+    gl->EnableVertexAttribArray(SC_OPENGL_RENDERER_ATTRIB_POSITION);
+    gl->EnableVertexAttribArray(SC_OPENGL_RENDERER_ATTRIB_TEX_COORD);
+
+    gl->GenTextures(ARRAY_LEN(renderer->textures), renderer->textures);
+
+    renderer->pbo.enabled = gl->has_pbo;
+    renderer->pbo.persistent = gl->has_buffer_storage;
+    renderer->pbo.size = 0; // the buffers are allocated on the first frame
+    for (unsigned i = 0; i < SC_OPENGL_RENDERER_PBO_COUNT; ++i) {
+        renderer->pbo.fences[i] = NULL;
+    }
+    if (renderer->pbo.enabled) {
+        LOGD("OpenGL texture uploads through %s pixel buffers",
+             renderer->pbo.persistent ? "persistent mapped" : "mapped");
+    }
+
+    sc_opengl_state_restore(gl, &state);
+
+    renderer->gl = gl;
+    renderer->program = program;
+    renderer->size.width = 0;
+    renderer->size.height = 0;
+    renderer->pix_fmt = AV_PIX_FMT_NONE;
+
+    return true;
+}
+
+static void
+sc_opengl_renderer_release_pbos(struct sc_opengl_renderer *renderer) {
+    struct sc_opengl *gl = renderer->gl;
+
+    for (unsigned i = 0; i < SC_OPENGL_RENDERER_PBO_COUNT; ++i) {
+        if (renderer->pbo.fences[i]) {
+            gl->DeleteSync(renderer->pbo.fences[i]);
+            renderer->pbo.fences[i] = NULL;
+        }
+    }
+
+    // Deleting a buffer unmaps it
+    gl->DeleteBuffers(SC_OPENGL_RENDERER_PBO_COUNT, renderer->pbo.buffers);
+    renderer->pbo.size = 0;
+}
+
+// Must be called with GL_PIXEL_UNPACK_BUFFER bound to 0
+static bool
+sc_opengl_renderer_alloc_pbos(struct sc_opengl_renderer *renderer,
+                              size_t size) {
+    struct sc_opengl *gl = renderer->gl;
+
+    if (renderer->pbo.size) {
+        // Immutable storage cannot be resized, recreate the buffers
+        sc_opengl_renderer_release_pbos(renderer);
+    }
+    gl->GenBuffers(SC_OPENGL_RENDERER_PBO_COUNT, renderer->pbo.buffers);
+
+    sc_opengl_clear_errors(gl);
+
+    bool mapped = true;
+    for (unsigned i = 0; i < SC_OPENGL_RENDERER_PBO_COUNT; ++i) {
+        gl->BindBuffer(GL_PIXEL_UNPACK_BUFFER, renderer->pbo.buffers[i]);
+        if (renderer->pbo.persistent) {
+            GLbitfield flags = GL_MAP_WRITE_BIT
+                             | GL_MAP_PERSISTENT_BIT
+                             | GL_MAP_COHERENT_BIT;
+            gl->BufferStorage(GL_PIXEL_UNPACK_BUFFER, size, NULL, flags);
+            renderer->pbo.mapped[i] =
+                gl->MapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, flags);
+            if (!renderer->pbo.mapped[i]) {
+                mapped = false;
+                break;
+            }
+        } else {
+            gl->BufferData(GL_PIXEL_UNPACK_BUFFER, size, NULL,
+                           GL_STREAM_DRAW);
+        }
+    }
+    gl->BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    GLenum error = gl->GetError();
+    if (!mapped || error != GL_NO_ERROR) {
+        LOGW("Could not allocate OpenGL pixel buffers: error 0x%x",
+             (unsigned) error);
+        // Do not retry on every frame
+        gl->DeleteBuffers(SC_OPENGL_RENDERER_PBO_COUNT,
+                          renderer->pbo.buffers);
+        renderer->pbo.enabled = false;
+        return false;
+    }
+
+    renderer->pbo.size = size;
+    renderer->pbo.index = 0;
+    return true;
+}
+
+void
+sc_opengl_renderer_destroy(struct sc_opengl_renderer *renderer) {
+    struct sc_opengl *gl = renderer->gl;
+    if (renderer->pbo.size) {
+        sc_opengl_renderer_release_pbos(renderer);
+    }
+    gl->DeleteTextures(ARRAY_LEN(renderer->textures), renderer->textures);
+    gl->DeleteBuffers(1, &renderer->vbo);
+    gl->DeleteVertexArrays(1, &renderer->vao);
+    gl->DeleteProgram(renderer->program);
+}
+
+static inline unsigned
+sc_opengl_renderer_plane_count(enum AVPixelFormat pix_fmt) {
+    return pix_fmt == AV_PIX_FMT_NV12 ? 2 : 3;
+}
+
+static struct sc_size
+sc_opengl_renderer_plane_size(struct sc_opengl_renderer *renderer,
+                              unsigned plane) {
+    if (!plane) {
+        return renderer->size;
+    }
+
+    // 4:2:0 chroma subsampling
+    struct sc_size size = {
+        .width = (renderer->size.width + 1) / 2,
+        .height = (renderer->size.height + 1) / 2,
+    };
+    return size;
+}
+
+static inline bool
+sc_opengl_renderer_is_interleaved(struct sc_opengl_renderer *renderer,
+                                  unsigned plane) {
+    return plane && renderer->pix_fmt == AV_PIX_FMT_NV12;
+}
+
+bool
+sc_opengl_renderer_set_size(struct sc_opengl_renderer *renderer,
+                            struct sc_size size, enum AVPixelFormat pix_fmt) {
+    assert(size.width && size.height);
+    assert(pix_fmt == AV_PIX_FMT_YUV420P || pix_fmt == AV_PIX_FMT_NV12);
+
+    struct sc_opengl *gl = renderer->gl;
+
+    renderer->size = size;
+    renderer->pix_fmt = pix_fmt;
+
+    struct sc_opengl_state state;
+    sc_opengl_state_save(gl, &state);
+    sc_opengl_clear_errors(gl);
+
+    gl->ActiveTexture(GL_TEXTURE0);
+    unsigned plane_count = sc_opengl_renderer_plane_count(pix_fmt);
+    for (unsigned i = 0; i < plane_count; ++i) {
+        struct sc_size plane_size = sc_opengl_renderer_plane_size(renderer, i);
+        bool interleaved = sc_opengl_renderer_is_interleaved(renderer, i);
+
+        gl->BindTexture(GL_TEXTURE_2D, renderer->textures[i]);
+        // The shader reads texels individually
+        gl->TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        gl->TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        gl->TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        gl->TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        gl->TexImage2D(GL_TEXTURE_2D, 0, interleaved ? GL_RG8 : GL_R8,
+                       plane_size.width, plane_size.height, 0,
+                       interleaved ? GL_RG : GL_RED, GL_UNSIGNED_BYTE, NULL);
+    }
+
+    GLenum error = gl->GetError();
+    sc_opengl_state_restore(gl, &state);
+
+    if (error != GL_NO_ERROR) {
+        LOGD("Could not create OpenGL textures: error 0x%x", (unsigned) error);
+        renderer->size.width = 0;
+        renderer->size.height = 0;
+        return false;
+    }
+
+    return true;
+}
+
+static void
+sc_opengl_renderer_update_colorspace(struct sc_opengl_renderer *renderer,
+                                     const AVFrame *frame) {
+    // Luma coefficients
+    float kr;
+    float kb;
+    switch (frame->colorspace) {
+        case AVCOL_SPC_BT709:
+            kr = 0.2126f;
+            kb = 0.0722f;
+            break;
+        case AVCOL_SPC_BT2020_NCL:
+        case AVCOL_SPC_BT2020_CL:
+            kr = 0.2627f;
+            kb = 0.0593f;
+            break;
+        case AVCOL_SPC_BT470BG:
+        case AVCOL_SPC_SMPTE170M:
+            kr = 0.299f;
+            kb = 0.114f;
+            break;
+        default:
+            // Same as SDL_YUV_CONVERSION_AUTOMATIC: BT.709 for HD content,
+            // BT.601 otherwise
+            if (frame->height > 576) {
+                kr = 0.2126f;
+                kb = 0.0722f;
+            } else {
+                kr = 0.299f;
+                kb = 0.114f;
+            }
+    }
+    float kg = 1.f - kr - kb;
+
+    bool full_range = frame->color_range == AVCOL_RANGE_JPEG;
+    float y_scale = full_range ? 1.f : 255.f / 219;
+    float c_scale = full_range ? 1.f : 255.f / 224;
+
+    GLfloat *m = renderer->yuv_to_rgb;
+    // Y column
+    m[0] = y_scale;
+    m[1] = y_scale;
+    m[2] = y_scale;
+    // U column
+    m[3] = 0;
+    m[4] = -c_scale * 2 * (1 - kb) * kb / kg;
+    m[5] = c_scale * 2 * (1 - kb);
+    // V column
+    m[6] = c_scale * 2 * (1 - kr);
+    m[7] = -c_scale * 2 * (1 - kr) * kr / kg;
+    m[8] = 0;
+
+    renderer->yuv_offset[0] = full_range ? 0 : 16.f / 255;
+    renderer->yuv_offset[1] = 128.f / 255;
+    renderer->yuv_offset[2] = 128.f / 255;
+}
+
+// Copy the frame planes to the next pixel buffer, and leave it bound to
+// GL_PIXEL_UNPACK_BUFFER. On success, the offsets of the planes in the buffer
+// are written to `pixels`.
+static bool
+sc_opengl_renderer_map_pbo(struct sc_opengl_renderer *renderer,
+                           const AVFrame *frame, const uint8_t *pixels[3]) {
+    if (!renderer->pbo.enabled) {
+        return false;
+    }
+
+    struct sc_opengl *gl = renderer->gl;
+
+    unsigned plane_count = sc_opengl_renderer_plane_count(renderer->pix_fmt);
+    size_t plane_bytes[3];
+    size_t size = 0;
+    for (unsigned i = 0; i < plane_count; ++i) {
+        struct sc_size plane_size = sc_opengl_renderer_plane_size(renderer, i);
+        assert(frame->linesize[i] > 0);
+        plane_bytes[i] = (size_t) frame->linesize[i] * plane_size.height;
+        size += plane_bytes[i];
+    }
+
+    gl->BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    if (size > renderer->pbo.size) {
+        if (!sc_opengl_renderer_alloc_pbos(renderer, size)) {
+            return false;
+        }
+    }
+
+    unsigned index = renderer->pbo.index;
+    GLsync fence = renderer->pbo.fences[index];
+    if (fence) {
+        // With 3 buffers, the upload is almost always complete
+        GLenum ret = gl->ClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+                                        SC_OPENGL_RENDERER_PBO_WAIT_TIMEOUT);
+        if (ret == GL_TIMEOUT_EXPIRED || ret == GL_WAIT_FAILED) {
+            LOGW("Timeout waiting for OpenGL pixel buffer");
+        }
+        gl->DeleteSync(fence);
+        renderer->pbo.fences[index] = NULL;
+    }
+
+    gl->BindBuffer(GL_PIXEL_UNPACK_BUFFER, renderer->pbo.buffers[index]);
+
+    uint8_t *mapped;
+    if (renderer->pbo.persistent) {
+        mapped = renderer->pbo.mapped[index];
+    } else {
+        // The fence guarantees that the GPU does not read the buffer anymore
+        GLbitfield access = GL_MAP_WRITE_BIT
+                          | GL_MAP_INVALIDATE_BUFFER_BIT
+                          | GL_MAP_UNSYNCHRONIZED_BIT;
+        mapped = gl->MapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, access);
+        if (!mapped) {
+            LOGD("Could not map OpenGL pixel buffer");
+            gl->BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            return false;
+        }
+    }
+
+    size_t offset = 0;
+    for (unsigned i = 0; i < plane_count; ++i) {
+        memcpy(mapped + offset, frame->data[i], plane_bytes[i]);
+        pixels[i] = (const uint8_t *) (uintptr_t) offset;
+        offset += plane_bytes[i];
+    }
+
+    if (!renderer->pbo.persistent) {
+        if (!gl->UnmapBuffer(GL_PIXEL_UNPACK_BUFFER)) {
+            // The content has been lost (rare), upload directly
+            LOGD("Could not unmap OpenGL pixel buffer");
+            gl->BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool
+sc_opengl_renderer_update(struct sc_opengl_renderer *renderer,
+                          const AVFrame *frame) {
+    assert(renderer->size.width == frame->width);
+    assert(renderer->size.height == frame->height);
+    assert(renderer->pix_fmt == frame->format);
+
+    struct sc_opengl *gl = renderer->gl;
+
+    struct sc_opengl_state state;
+    sc_opengl_state_save(gl, &state);
+    sc_opengl_clear_errors(gl);
+
+    // With a pixel buffer bound, the TexSubImage2D() "pixels" are offsets
+    // in the buffer
+    const uint8_t *pixels[3];
+    bool pbo = sc_opengl_renderer_map_pbo(renderer, frame, pixels);
+    if (!pbo) {
+        for (unsigned i = 0; i < ARRAY_LEN(pixels); ++i) {
+            pixels[i] = frame->data[i];
+        }
+    }
+
+    gl->ActiveTexture(GL_TEXTURE0);
+    gl->PixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    unsigned plane_count = sc_opengl_renderer_plane_count(renderer->pix_fmt);
+    for (unsigned i = 0; i < plane_count; ++i) {
+        struct sc_size plane_size = sc_opengl_renderer_plane_size(renderer, i);
+        bool interleaved = sc_opengl_renderer_is_interleaved(renderer, i);
+
+        int row_length = frame->linesize[i] / (interleaved ? 2 : 1);
+        gl->PixelStorei(GL_UNPACK_ROW_LENGTH, row_length);
+        gl->BindTexture(GL_TEXTURE_2D, renderer->textures[i]);
+        gl->TexSubImage2D(GL_TEXTURE_2D, 0, 0, 0,
+                          plane_size.width, plane_size.height,
+                          interleaved ? GL_RG : GL_RED, GL_UNSIGNED_BYTE,
+                          pixels[i]);
+    }
+
+    if (pbo) {
+        // The buffer may be written again once the GPU has read it
+        unsigned index = renderer->pbo.index;
+        renderer->pbo.fences[index] =
+            gl->FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        renderer->pbo.index = (index + 1) % SC_OPENGL_RENDERER_PBO_COUNT;
+    }
+
+    GLenum error = gl->GetError();
+    sc_opengl_state_restore(gl, &state);
+
+    if (error != GL_NO_ERROR) {
+        LOGD("Could not update OpenGL textures: error 0x%x", (unsigned) error);
+        return false;
+    }
+
+    sc_opengl_renderer_update_colorspace(renderer, frame);
+
+    return true;
+}
+
+// Map a corner of the output (0 or 1 for each coordinate, y pointing down)
+// to texture coordinates: the frame is mirrored then rotated clockwise
+static void
+sc_opengl_renderer_map_corner(enum sc_orientation orientation, float ox,
+                              float oy, GLfloat *u, GLfloat *v) {
+    unsigned cw_rotation = sc_orientation_get_rotation(orientation);
+    switch (cw_rotation) {
+        case 0:
+            *u = ox;
+            *v = oy;
+            break;
+        case 1:
+            *u = oy;
+            *v = 1 - ox;
+            break;
+        case 2:
+            *u = 1 - ox;
+            *v = 1 - oy;
+            break;
+        default:
+            assert(cw_rotation == 3);
+            *u = 1 - oy;
+            *v = ox;
+    }
+
+    if (sc_orientation_is_mirror(orientation)) {
+        *u = 1 - *u;
+    }
+}
+
+void
+sc_opengl_renderer_render(struct sc_opengl_renderer *renderer,
+                          const SDL_Rect *geometry, int output_height,
+                          enum sc_orientation orientation) {
+    assert(renderer->size.width && renderer->size.height);
+
+    struct sc_opengl *gl = renderer->gl;
+
+    // Triangle strip: bottom-left, bottom-right, top-left, top-right
+    static const float corners[4][2] = {{0, 1}, {1, 1}, {0, 0}, {1, 0}};
+    GLfloat vertices[4][4];
+    for (unsigned i = 0; i < 4; ++i) {
+        float ox = corners[i][0];
+        float oy = corners[i][1];
+        vertices[i][0] = ox * 2 - 1;
+        vertices[i][1] = 1 - oy * 2;
+        sc_opengl_renderer_map_corner(orientation, ox, oy, &vertices[i][2],
+                                      &vertices[i][3]);
+    }
+
+    // The output size in the texture axes, to compute the scaling ratio
+    bool swap = sc_orientation_is_swap(orientation);
+    float output_w = swap ? geometry->h : geometry->w;
+    float output_h = swap ? geometry->w : geometry->h;
+
+    struct sc_opengl_state state;
+    sc_opengl_state_save(gl, &state);
+
+    gl->Disable(GL_BLEND);
+    gl->Disable(GL_SCISSOR_TEST);
+    gl->Viewport(geometry->x, output_height - geometry->y - geometry->h,
+                 geometry->w, geometry->h);
+
+    gl->UseProgram(renderer->program);
+    gl->Uniform1i(renderer->uniforms.nv12,
+                  renderer->pix_fmt == AV_PIX_FMT_NV12);
+    gl->UniformMatrix3fv(renderer->uniforms.yuv_to_rgb, 1, GL_FALSE,
+                         renderer->yuv_to_rgb);
+    gl->Uniform3fv(renderer->uniforms.yuv_offset, 1, renderer->yuv_offset);
+    gl->Uniform2f(renderer->uniforms.output_size, output_w, output_h);
+
+    unsigned plane_count = sc_opengl_renderer_plane_count(renderer->pix_fmt);
+    for (unsigned i = 0; i < plane_count; ++i) {
+        gl->ActiveTexture(GL_TEXTURE0 + i);
+        gl->BindTexture(GL_TEXTURE_2D, renderer->textures[i]);
+    }
+
+    gl->BindVertexArray(renderer->vao);
+    gl->BindBuffer(GL_ARRAY_BUFFER, renderer->vbo);
+    gl->BufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices,
+                   GL_STREAM_DRAW);
+    gl->DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+    sc_opengl_state_restore(gl, &state);
+}
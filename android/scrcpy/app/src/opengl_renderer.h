@@ -0,0 +1,112 @@
+#ifndef SC_OPENGL_RENDERER_H
+#define SC_OPENGL_RENDERER_H
+
+#include "common.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <libavutil/frame.h>
+#include <libavutil/pixfmt.h>
+#include <SDL2/SDL_rect.h>
+
+#include "coords.h"
+#include "opengl.h"
+#include "options.h"
+
+/**
+ * Custom OpenGL render path for YUV frames
+ *
+ * The planes are uploaded as separate textures (Y, U and V, or Y and
+ * interleaved UV for NV12), then a single shader pass converts to RGB and
+ * scales (with a bicubic filter, stretched when downscaling) directly to the
+ * window. This avoids the mipmaps generation on every frame.
+ *
+ * If supported, the planes are uploaded through a ring of pixel buffer
+ * objects (persistently mapped if possible), so that the texture uploads are
+ * asynchronous instead of stalling the GL pipeline.
+ *
+ * It draws into the context of the SDL renderer: the GL state modified is
+ * restored after each call, so that it does not interfere with the SDL
+ * renderer cached state.
+ *
+ * All functions must be called from the main thread, with the SDL renderer
+ * GL context current.
+ */
+struct sc_opengl_renderer {
+    struct sc_opengl *gl;
+
+    GLuint program;
+    GLuint vao;
+    GLuint vbo;
+    GLuint textures[3];
+
+    struct {
+        GLint nv12;
+        GLint yuv_to_rgb;
+        GLint yuv_offset;
+        GLint output_size;
+    } uniforms;
+
+    struct {
+#define SC_OPENGL_RENDERER_PBO_COUNT 3
+        bool enabled;
+        bool persistent;
+        GLuint buffers[SC_OPENGL_RENDERER_PBO_COUNT];
+        // Only for persistent mappings
+        void *mapped[SC_OPENGL_RENDERER_PBO_COUNT];
+        // Signaled once the GPU has read the buffer
+        GLsync fences[SC_OPENGL_RENDERER_PBO_COUNT];
+        size_t size; // of each buffer, 0 until allocated
+        unsigned index; // next buffer to use
+    } pbo;
+
+    struct sc_size size; // 0x0 until the textures are created
+    enum AVPixelFormat pix_fmt;
+
+    // Color conversion for the current frames (column-major)
+    GLfloat yuv_to_rgb[9];
+    GLfloat yuv_offset[3];
+};
+
+/**
+ * Initialize the renderer
+ *
+ * Require OpenGL 3.0+ or OpenGL ES 3.0+.
+ */
+bool
+sc_opengl_renderer_init(struct sc_opengl_renderer *renderer,
+                        struct sc_opengl *gl);
+
+void
+sc_opengl_renderer_destroy(struct sc_opengl_renderer *renderer);
+
+/**
+ * (Re)create the textures for frames of the given size and pixel format
+ *
+ * The pixel format must be AV_PIX_FMT_YUV420P or AV_PIX_FMT_NV12.
+ */
+bool
+sc_opengl_renderer_set_size(struct sc_opengl_renderer *renderer,
+                            struct sc_size size, enum AVPixelFormat pix_fmt);
+
+/**
+ * Upload the frame planes
+ *
+ * The frame must match the size and pixel format of the textures.
+ */
+bool
+sc_opengl_renderer_update(struct sc_opengl_renderer *renderer,
+                          const AVFrame *frame);
+
+/**
+ * Draw the frame to the geometry rectangle
+ *
+ * The geometry is expressed in renderer output pixels, whose height is
+ * output_height (OpenGL viewport coordinates start at the bottom).
+ */
+void
+sc_opengl_renderer_render(struct sc_opengl_renderer *renderer,
+                          const SDL_Rect *geometry, int output_height,
+                          enum sc_orientation orientation);
+
+#endif
@@ -6,6 +6,14 @@ const struct scrcpy_options scrcpy_options_default = {
     .serial = NULL,
     .crop = NULL,
     .record_filename = NULL,
+    .archive_filename = NULL,
+    .archive_encoder = NULL,
+    .archive_bit_rate = 2000000,
+    .archive_downscale = false,
+    .snapshot_dir = NULL,
+    .snapshot_format = SC_SNAPSHOT_FORMAT_PNG,
+    .record_control_filename = NULL,
+    .restream_url = NULL,
     .window_title = NULL,
     .push_target = NULL,
     .render_driver = NULL,
@@ -13,16 +21,25 @@ const struct scrcpy_options scrcpy_options_default = {
     .audio_codec_options = NULL,
     .video_encoder = NULL,
     .audio_encoder = NULL,
+    .video_hwaccel = NULL,
+    .video_decoder_threads = -1,
+    .video_decoder_thread_type = SC_DECODER_THREAD_TYPE_AUTO,
+    .video_decoder_fast = false,
+    .video_decoder_skip = false,
+    .video_decoder_resync = false,
+    .video_catch_up = 0,
     .camera_id = NULL,
     .camera_size = NULL,
     .camera_ar = NULL,
     .camera_fps = 0,
     .log_level = SC_LOG_LEVEL_INFO,
+    .async_log = false,
     .video_codec = SC_CODEC_H264,
     .audio_codec = SC_CODEC_OPUS,
     .video_source = SC_VIDEO_SOURCE_DISPLAY,
     .audio_source = SC_AUDIO_SOURCE_AUTO,
     .record_format = SC_RECORD_FORMAT_AUTO,
+    .restream_format = SC_RESTREAM_FORMAT_AUTO,
     .keyboard_input_mode = SC_KEYBOARD_INPUT_MODE_AUTO,
     .mouse_input_mode = SC_MOUSE_INPUT_MODE_AUTO,
     .gamepad_input_mode = SC_GAMEPAD_INPUT_MODE_DISABLED,
@@ -47,6 +64,10 @@ const struct scrcpy_options scrcpy_options_default = {
     },
     .tunnel_host = 0,
     .tunnel_port = 0,
+    .stats_port = 0,
+    .socket_profile = SC_SOCKET_PROFILE_DEFAULT,
+    .thread_profile = SC_THREAD_PROFILE_DEFAULT,
+    .thread_affinity = {0},
     .shortcut_mods = SC_SHORTCUT_MOD_LALT | SC_SHORTCUT_MOD_LSUPER,
     .max_size = 0,
     .video_bit_rate = 0,
@@ -62,17 +83,33 @@ const struct scrcpy_options scrcpy_options_default = {
     .window_width = 0,
     .window_height = 0,
     .display_id = 0,
+    .extra_display_id = SC_DISPLAY_ID_NONE,
     .video_buffer = 0,
+    .video_buffer_max = 0,
+    .record_segment_duration = 0,
+    .record_segment_size = 0,
+    .record_segment_count = 0,
+    .memory_budget = 0,
+    .record_low_latency = false,
+    .display_frame_slots = 1,
+    .display_frame_policy = SC_DISPLAY_FRAME_POLICY_FIFO,
+    .display_pacing = false,
+    .match_display_rate = false,
     .audio_buffer = -1, // depends on the audio format,
     .audio_output_buffer = SC_TICK_FROM_MS(5),
+    .audio_output_backend = SC_AUDIO_OUTPUT_BACKEND_SDL,
     .time_limit = 0,
     .screen_off_timeout = -1,
 #ifdef HAVE_V4L2
     .v4l2_device = NULL,
     .v4l2_buffer = 0,
+    .v4l2_direct = false,
+    .v4l2_pixel_format = SC_V4L2_PIXEL_FORMAT_YUV420P,
+    .v4l2_orientation = SC_ORIENTATION_0,
 #endif
 #ifdef HAVE_USB
     .otg = false,
+    .usb_transport = false,
 #endif
     .show_touches = false,
     .fullscreen = false,
@@ -84,13 +121,18 @@ const struct scrcpy_options scrcpy_options_default = {
     .key_inject_mode = SC_KEY_INJECT_MODE_MIXED,
     .window_borderless = false,
     .mipmaps = true,
+    .render_shader = false,
+    .render_thread = false,
+    .damage_tracking = false,
     .stay_awake = false,
     .force_adb_forward = false,
     .disable_screensaver = false,
     .forward_key_repeat = true,
     .legacy_paste = false,
+    .text_chunks = false,
     .power_off_on_close = false,
     .clipboard_autosync = true,
+    .clipboard_chunks = false,
     .downsize_on_error = true,
     .tcpip = false,
     .tcpip_dst = NULL,
@@ -98,11 +140,14 @@ const struct scrcpy_options scrcpy_options_default = {
     .select_usb = false,
     .cleanup = true,
     .start_fps_counter = false,
+    .adaptive_video = false,
+    .latency_stats = NULL,
     .power_on = true,
     .video = true,
     .audio = true,
     .require_audio = false,
     .kill_adb_on_close = false,
+    .resume = false,
     .camera_high_speed = false,
     .list = 0,
     .window = true,
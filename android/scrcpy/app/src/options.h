@@ -39,6 +39,44 @@ sc_record_format_is_audio_only(enum sc_record_format fmt) {
         || fmt == SC_RECORD_FORMAT_WAV;
 }
 
+enum sc_restream_format {
+    SC_RESTREAM_FORMAT_AUTO, // MPEG-TS
+    SC_RESTREAM_FORMAT_MPEGTS,
+    SC_RESTREAM_FORMAT_MP4,
+};
+
+enum sc_snapshot_format {
+    SC_SNAPSHOT_FORMAT_PNG,
+    SC_SNAPSHOT_FORMAT_JPEG,
+    SC_SNAPSHOT_FORMAT_WEBP,
+};
+
+enum sc_socket_profile {
+    SC_SOCKET_PROFILE_DEFAULT,
+    SC_SOCKET_PROFILE_LOW_LATENCY,
+    SC_SOCKET_PROFILE_THROUGHPUT,
+};
+
+enum sc_thread_profile {
+    SC_THREAD_PROFILE_DEFAULT,
+    SC_THREAD_PROFILE_LATENCY,
+    SC_THREAD_PROFILE_REALTIME,
+};
+
+// Masks of the CPUs allowed for each thread role (0 for no restriction)
+struct sc_thread_affinity {
+    uint64_t video;
+    uint64_t audio;
+    uint64_t control;
+    uint64_t recording;
+};
+
+enum sc_decoder_thread_type {
+    SC_DECODER_THREAD_TYPE_AUTO, // slice
+    SC_DECODER_THREAD_TYPE_SLICE,
+    SC_DECODER_THREAD_TYPE_FRAME,
+};
+
 enum sc_codec {
     SC_CODEC_H264,
     SC_CODEC_H265,
@@ -97,6 +135,22 @@ enum sc_orientation_lock {
     SC_ORIENTATION_LOCKED_INITIAL, // lock to initial device orientation
 };
 
+enum sc_display_frame_policy {
+    SC_DISPLAY_FRAME_POLICY_FIFO,
+    SC_DISPLAY_FRAME_POLICY_NEWEST_KEEP_SPARE,
+};
+
+enum sc_audio_output_backend {
+    SC_AUDIO_OUTPUT_BACKEND_SDL,
+    SC_AUDIO_OUTPUT_BACKEND_ALSA,
+};
+
+enum sc_v4l2_pixel_format {
+    SC_V4L2_PIXEL_FORMAT_YUV420P,
+    SC_V4L2_PIXEL_FORMAT_NV12,
+    SC_V4L2_PIXEL_FORMAT_YUYV,
+};
+
 enum sc_display_ime_policy {
     SC_DISPLAY_IME_POLICY_UNDEFINED,
     SC_DISPLAY_IME_POLICY_LOCAL,
@@ -227,10 +281,24 @@ struct sc_port_range {
 
 #define SC_WINDOW_POSITION_UNDEFINED (-0x8000)
 
+// The device display ids are non-negative 32-bit integers
+#define SC_DISPLAY_ID_NONE UINT32_MAX
+
+// Must not exceed SC_FRAME_BUFFER_MAX_SLOTS
+#define SC_DISPLAY_FRAME_SLOTS_MAX 16
+
 struct scrcpy_options {
     const char *serial;
     const char *crop;
     const char *record_filename;
+    const char *archive_filename;
+    const char *archive_encoder;
+    uint32_t archive_bit_rate;
+    bool archive_downscale;
+    const char *snapshot_dir;
+    enum sc_snapshot_format snapshot_format;
+    const char *record_control_filename;
+    const char *restream_url;
     const char *window_title;
     const char *push_target;
     const char *render_driver;
@@ -238,16 +306,25 @@ struct scrcpy_options {
     const char *audio_codec_options;
     const char *video_encoder;
     const char *audio_encoder;
+    const char *video_hwaccel; // FFmpeg hw device type name (e.g. "vaapi")
+    int video_decoder_threads; // -1 for automatic, 0 for one per CPU core
+    enum sc_decoder_thread_type video_decoder_thread_type;
+    bool video_decoder_fast;
+    bool video_decoder_skip;
+    bool video_decoder_resync;
+    sc_tick video_catch_up; // 0 to disable
     const char *camera_id;
     const char *camera_size;
     const char *camera_ar;
     uint16_t camera_fps;
     enum sc_log_level log_level;
+    bool async_log;
     enum sc_codec video_codec;
     enum sc_codec audio_codec;
     enum sc_video_source video_source;
     enum sc_audio_source audio_source;
     enum sc_record_format record_format;
+    enum sc_restream_format restream_format;
     enum sc_keyboard_input_mode keyboard_input_mode;
     enum sc_mouse_input_mode mouse_input_mode;
     enum sc_gamepad_input_mode gamepad_input_mode;
@@ -256,6 +333,10 @@ struct scrcpy_options {
     struct sc_port_range port_range;
     uint32_t tunnel_host;
     uint16_t tunnel_port;
+    uint16_t stats_port; // 0 to disable the stats server
+    enum sc_socket_profile socket_profile;
+    enum sc_thread_profile thread_profile;
+    struct sc_thread_affinity thread_affinity;
     uint8_t shortcut_mods; // OR of enum sc_shortcut_mod values
     uint16_t max_size;
     uint32_t video_bit_rate;
@@ -272,17 +353,33 @@ struct scrcpy_options {
     uint16_t window_width;
     uint16_t window_height;
     uint32_t display_id;
+    uint32_t extra_display_id; // SC_DISPLAY_ID_NONE if disabled
     sc_tick video_buffer;
+    sc_tick video_buffer_max; // 0 to disable adaptive buffering
+    sc_tick record_segment_duration; // 0 to disable
+    uint64_t record_segment_size; // in bytes, 0 to disable
+    unsigned record_segment_count; // 0 to keep all segments
+    uint64_t memory_budget; // in bytes, 0 for unlimited
+    bool record_low_latency;
+    uint8_t display_frame_slots;
+    enum sc_display_frame_policy display_frame_policy;
+    bool display_pacing;
+    bool match_display_rate;
     sc_tick audio_buffer;
     sc_tick audio_output_buffer;
+    enum sc_audio_output_backend audio_output_backend;
     sc_tick time_limit;
     sc_tick screen_off_timeout;
 #ifdef HAVE_V4L2
     const char *v4l2_device;
     sc_tick v4l2_buffer;
+    bool v4l2_direct;
+    enum sc_v4l2_pixel_format v4l2_pixel_format;
+    enum sc_orientation v4l2_orientation;
 #endif
 #ifdef HAVE_USB
     bool otg;
+    bool usb_transport;
 #endif
     bool show_touches;
     bool fullscreen;
@@ -294,13 +391,18 @@ struct scrcpy_options {
     enum sc_key_inject_mode key_inject_mode;
     bool window_borderless;
     bool mipmaps;
+    bool render_shader;
+    bool render_thread;
+    bool damage_tracking;
     bool stay_awake;
     bool force_adb_forward;
     bool disable_screensaver;
     bool forward_key_repeat;
     bool legacy_paste;
+    bool text_chunks;
     bool power_off_on_close;
     bool clipboard_autosync;
+    bool clipboard_chunks;
     bool downsize_on_error;
     bool tcpip;
     const char *tcpip_dst;
@@ -308,11 +410,15 @@ struct scrcpy_options {
     bool select_tcpip;
     bool cleanup;
     bool start_fps_counter;
+    bool adaptive_video;
+    // NULL if disabled, empty to log the statistics, or the output file
+    const char *latency_stats;
     bool power_on;
     bool video;
     bool audio;
     bool require_audio;
     bool kill_adb_on_close;
+    bool resume;
     bool camera_high_speed;
 #define SC_OPTION_LIST_ENCODERS 0x1
 #define SC_OPTION_LIST_DISPLAYS 0x2
@@ -32,16 +32,17 @@ sc_packet_merger_merge(struct sc_packet_merger *merger, AVPacket *packet) {
         memcpy(merger->config, packet->data, packet->size);
         merger->config_size = packet->size;
     } else if (merger->config) {
-        size_t config_size = merger->config_size;
-        size_t media_size = packet->size;
-
-        if (av_grow_packet(packet, config_size)) {
+        // Only the (small) config payload is copied, the media payload is
+        // left untouched
+        uint8_t *side_data =
+            av_packet_new_side_data(packet, AV_PKT_DATA_NEW_EXTRADATA,
+                                    merger->config_size);
+        if (!side_data) {
             LOG_OOM();
             return false;
         }
 
-        memmove(packet->data + config_size, packet->data, media_size);
-        memcpy(packet->data, merger->config, config_size);
+        memcpy(side_data, merger->config, merger->config_size);
 
         free(merger->config);
         merger->config = NULL;
@@ -50,3 +51,59 @@ sc_packet_merger_merge(struct sc_packet_merger *merger, AVPacket *packet) {
 
     return true;
 }
+
+const uint8_t *
+sc_packet_merger_get_config(const AVPacket *packet, size_t *size) {
+#ifdef SCRCPY_LAVU_HAS_SIZE_T_BUFFER_SIZE
+    size_t side_data_size;
+#else
+    int side_data_size;
+#endif
+    const uint8_t *side_data =
+        av_packet_get_side_data(packet, AV_PKT_DATA_NEW_EXTRADATA,
+                                &side_data_size);
+    if (!side_data || !side_data_size) {
+        return NULL;
+    }
+
+    *size = side_data_size;
+    return side_data;
+}
+
+bool
+sc_packet_merger_inline_config(AVPacket *packet) {
+    size_t config_size;
+    const uint8_t *side_data = sc_packet_merger_get_config(packet,
+                                                           &config_size);
+    if (!side_data) {
+        // nothing to do
+        return true;
+    }
+
+    // The side data is owned by the packet, keep a copy before growing it
+    uint8_t *config = malloc(config_size);
+    if (!config) {
+        LOG_OOM();
+        return false;
+    }
+    memcpy(config, side_data, config_size);
+
+    size_t media_size = packet->size;
+
+    // The buffer is shared with the other sinks, so if it is not writable,
+    // av_grow_packet() reallocates it
+    if (av_grow_packet(packet, config_size)) {
+        LOG_OOM();
+        free(config);
+        return false;
+    }
+
+    memmove(packet->data + config_size, packet->data, media_size);
+    memcpy(packet->data, config, config_size);
+    free(config);
+
+    // The config is now in-band, the muxer must not handle it again
+    av_packet_shrink_side_data(packet, AV_PKT_DATA_NEW_EXTRADATA, 0);
+
+    return true;
+}
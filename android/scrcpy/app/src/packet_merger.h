@@ -4,6 +4,7 @@
 #include "common.h"
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <libavcodec/packet.h>
 
@@ -13,11 +14,14 @@
  * device orientation change).
  *
  * Every time a config packet is received, it must be sent alone (for recorder
- * extradata), then concatenated to the next media packet (for correct decoding
+ * extradata), then associated to the next media packet (for correct decoding
  * and recording).
  *
- * This helper reads every input packet and modifies each media packet which
- * immediately follows a config packet to prepend the config packet payload.
+ * This helper reads every input packet and attaches the config packet payload
+ * to the media packet which immediately follows a config packet, as
+ * AV_PKT_DATA_NEW_EXTRADATA side data. The media payload is not rewritten:
+ * each sink consumes the config prefix the way it needs (see
+ * sc_packet_merger_get_config()).
  */
 
 struct sc_packet_merger {
@@ -34,10 +38,27 @@ sc_packet_merger_destroy(struct sc_packet_merger *merger);
 /**
  * If the packet is a config packet, then keep its data for later.
  * Otherwise (if the packet is a media packet), then if a config packet is
- * pending, prepend the config packet to this packet (so the packet is
- * modified!).
+ * pending, attach the config packet payload to this packet as side data (so
+ * the packet is modified, but not its payload!).
  */
 bool
 sc_packet_merger_merge(struct sc_packet_merger *merger, AVPacket *packet);
 
+/**
+ * Return the config payload attached to a media packet by
+ * sc_packet_merger_merge(), or NULL if there is none.
+ */
+const uint8_t *
+sc_packet_merger_get_config(const AVPacket *packet, size_t *size);
+
+/**
+ * Prepend the config attached by sc_packet_merger_merge() (if any) to the
+ * packet payload, so that a muxed stream contains the new SPS/PPS in-band
+ *
+ * This copy is not required for decoding, so it is performed by the sinks
+ * which need it (on their own thread), not by the demuxer.
+ */
+bool
+sc_packet_merger_inline_config(AVPacket *packet);
+
 #endif
@@ -2,6 +2,9 @@
 
 #include <assert.h>
 #include <inttypes.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
 #include <SDL2/SDL_clipboard.h>
 
 #include "device_msg.h"
@@ -10,13 +13,65 @@
 #include "util/str.h"
 #include "util/thread.h"
 
+#define SC_RECEIVER_SCRATCH_SIZE 4096
+
+/**
+ * Reference-counted reception buffer
+ *
+ * The device msgs reference slices of the buffer, so that their payload is
+ * never copied. The buffer is released once all the msgs referencing it have
+ * been processed (on the main thread).
+ */
+struct sc_receiver_buffer {
+    atomic_uint refs;
+    uint8_t data[DEVICE_MSG_MAX_SIZE];
+};
+
+struct sc_clipboard_task_data {
+    struct sc_receiver_buffer *buffer;
+    const char *text; // references the buffer, not null-terminated
+    size_t length;
+};
+
 struct sc_uhid_output_task_data {
     struct sc_uhid_devices *uhid_devices;
+    struct sc_receiver_buffer *buffer;
     uint16_t id;
     uint16_t size;
-    uint8_t *data;
+    const uint8_t *data; // references the buffer
 };
 
+static struct sc_receiver_buffer *
+sc_receiver_buffer_new(void) {
+    struct sc_receiver_buffer *buffer = malloc(sizeof(*buffer));
+    if (!buffer) {
+        LOG_OOM();
+        return NULL;
+    }
+
+    atomic_init(&buffer->refs, 1);
+    return buffer;
+}
+
+static void
+sc_receiver_buffer_ref(struct sc_receiver_buffer *buffer) {
+    atomic_fetch_add_explicit(&buffer->refs, 1, memory_order_relaxed);
+}
+
+static void
+sc_receiver_buffer_unref(struct sc_receiver_buffer *buffer) {
+    // The reads of the msgs data must happen before the buffer is reused
+    if (atomic_fetch_sub_explicit(&buffer->refs, 1,
+                                  memory_order_acq_rel) == 1) {
+        free(buffer);
+    }
+}
+
+static bool
+sc_receiver_buffer_is_shared(struct sc_receiver_buffer *buffer) {
+    return atomic_load_explicit(&buffer->refs, memory_order_acquire) > 1;
+}
+
 bool
 sc_receiver_init(struct sc_receiver *receiver, sc_socket control_socket,
                  const struct sc_receiver_callbacks *cbs, void *cbs_userdata) {
@@ -28,6 +83,7 @@ sc_receiver_init(struct sc_receiver *receiver, sc_socket control_socket,
     receiver->control_socket = control_socket;
     receiver->acksync = NULL;
     receiver->uhid_devices = NULL;
+    sc_arena_init(&receiver->scratch, SC_RECEIVER_SCRATCH_SIZE);
 
     assert(cbs && cbs->on_ended);
     receiver->cbs = cbs;
@@ -38,26 +94,45 @@ sc_receiver_init(struct sc_receiver *receiver, sc_socket control_socket,
 
 void
 sc_receiver_destroy(struct sc_receiver *receiver) {
+    sc_arena_destroy(&receiver->scratch);
     sc_mutex_destroy(&receiver->mutex);
 }
 
 static void
-task_set_clipboard(void *userdata) {
-    assert(sc_thread_get_id() == SC_MAIN_THREAD_ID);
-
-    char *text = userdata;
-
+set_clipboard(const char *text, size_t length) {
     char *current = SDL_GetClipboardText();
-    bool same = current && !strcmp(current, text);
+    bool same = current && strlen(current) == length
+                        && !memcmp(current, text, length);
     SDL_free(current);
     if (same) {
         LOGD("Computer clipboard unchanged");
-    } else {
-        LOGI("Device clipboard copied");
-        SDL_SetClipboardText(text);
+        return;
     }
 
-    free(text);
+    // SDL requires a null-terminated string
+    char *str = malloc(length + 1);
+    if (!str) {
+        LOG_OOM();
+        return;
+    }
+    memcpy(str, text, length);
+    str[length] = '\0';
+
+    LOGI("Device clipboard copied");
+    SDL_SetClipboardText(str);
+    free(str);
+}
+
+static void
+task_set_clipboard(void *userdata) {
+    assert(sc_thread_get_id() == SC_MAIN_THREAD_ID);
+
+    struct sc_clipboard_task_data *data = userdata;
+
+    set_clipboard(data->text, data->length);
+
+    sc_receiver_buffer_unref(data->buffer);
+    free(data);
 }
 
 static void
@@ -69,21 +144,33 @@ task_uhid_output(void *userdata) {
     sc_uhid_devices_process_hid_output(data->uhid_devices, data->id, data->data,
                                        data->size);
 
-    free(data->data);
+    sc_receiver_buffer_unref(data->buffer);
     free(data);
 }
 
 static void
-process_msg(struct sc_receiver *receiver, struct sc_device_msg *msg) {
+process_msg(struct sc_receiver *receiver, struct sc_receiver_buffer *buffer,
+            const struct sc_device_msg *msg) {
     switch (msg->type) {
         case DEVICE_MSG_TYPE_CLIPBOARD: {
-            // Take ownership of the text (do not destroy the msg)
-            char *text = msg->clipboard.text;
+            struct sc_clipboard_task_data *data = malloc(sizeof(*data));
+            if (!data) {
+                LOG_OOM();
+                return;
+            }
+
+            // The text is not copied, keep the buffer alive until the task
+            // is executed
+            sc_receiver_buffer_ref(buffer);
+            data->buffer = buffer;
+            data->text = msg->clipboard.text;
+            data->length = msg->clipboard.length;
 
-            bool ok = sc_post_to_main_thread(task_set_clipboard, text);
+            bool ok = sc_post_to_main_thread(task_set_clipboard, data);
             if (!ok) {
                 LOGW("Could not post clipboard to main thread");
-                free(text);
+                sc_receiver_buffer_unref(buffer);
+                free(data);
                 return;
             }
 
@@ -104,16 +191,17 @@ process_msg(struct sc_receiver *receiver, struct sc_device_msg *msg) {
             }
 
             sc_acksync_ack(receiver->acksync, msg->ack_clipboard.sequence);
-            // No allocation to free in the msg
             break;
         case DEVICE_MSG_TYPE_UHID_OUTPUT:
             if (sc_get_log_level() <= SC_LOG_LEVEL_VERBOSE) {
-                char *hex = sc_str_to_hex_string(msg->uhid_output.data,
-                                                 msg->uhid_output.size);
+                char *hex =
+                    sc_arena_alloc(&receiver->scratch,
+                                   SC_STR_HEX_SIZE(msg->uhid_output.size));
                 if (hex) {
+                    sc_str_write_hex(hex, msg->uhid_output.data,
+                                     msg->uhid_output.size);
                     LOGV("UHID output [%" PRIu16 "] %s",
                          msg->uhid_output.id, hex);
-                    free(hex);
                 } else {
                     LOGV("UHID output [%" PRIu16 "] size=%" PRIu16,
                          msg->uhid_output.id, msg->uhid_output.size);
@@ -122,7 +210,6 @@ process_msg(struct sc_receiver *receiver, struct sc_device_msg *msg) {
 
             if (!receiver->uhid_devices) {
                 LOGE("Received unexpected HID output message");
-                sc_device_msg_destroy(msg);
                 return;
             }
 
@@ -137,14 +224,16 @@ process_msg(struct sc_receiver *receiver, struct sc_device_msg *msg) {
             // processing SC_EVENT_RUN_ON_MAIN_THREAD on exit, when everything
             // gets deinitialized)
             data->uhid_devices = receiver->uhid_devices;
+            sc_receiver_buffer_ref(buffer);
+            data->buffer = buffer;
             data->id = msg->uhid_output.id;
-            data->data = msg->uhid_output.data; // take ownership
+            data->data = msg->uhid_output.data; // references the buffer
             data->size = msg->uhid_output.size;
 
             bool ok = sc_post_to_main_thread(task_uhid_output, data);
             if (!ok) {
                 LOGW("Could not post UHID output to main thread");
-                free(data->data);
+                sc_receiver_buffer_unref(buffer);
                 free(data);
                 return;
             }
@@ -154,25 +243,27 @@ process_msg(struct sc_receiver *receiver, struct sc_device_msg *msg) {
 }
 
 static ssize_t
-process_msgs(struct sc_receiver *receiver, const uint8_t *buf, size_t len) {
-    size_t head = 0;
+process_msgs(struct sc_receiver *receiver, struct sc_receiver_buffer *buffer,
+             size_t tail, size_t head) {
+    size_t pos = tail;
     for (;;) {
         struct sc_device_msg msg;
-        ssize_t r = sc_device_msg_deserialize(&buf[head], len - head, &msg);
+        ssize_t r = sc_device_msg_deserialize(&buffer->data[pos], head - pos,
+                                              &msg);
         if (r == -1) {
             return -1;
         }
         if (r == 0) {
-            return head;
+            return pos - tail;
         }
 
-        process_msg(receiver, &msg);
-        // the device msg must be destroyed by process_msg()
+        process_msg(receiver, buffer, &msg);
+        sc_arena_reset(&receiver->scratch);
 
-        head += r;
-        assert(head <= len);
-        if (head == len) {
-            return head;
+        pos += r;
+        assert(pos <= head);
+        if (pos == head) {
+            return pos - tail;
         }
     }
 }
@@ -181,36 +272,86 @@ static int
 run_receiver(void *data) {
     struct sc_receiver *receiver = data;
 
-    static uint8_t buf[DEVICE_MSG_MAX_SIZE];
-    size_t head = 0;
+    sc_thread_apply_policy(SC_THREAD_ROLE_CONTROL);
 
     bool error = false;
 
+    struct sc_receiver_buffer *buffer = sc_receiver_buffer_new();
+    if (!buffer) {
+        error = true;
+        goto end;
+    }
+
+    // [tail, head) contains the received bytes not processed yet (at most
+    // one partial msg)
+    size_t head = 0;
+    size_t tail = 0;
+
     for (;;) {
-        assert(head < DEVICE_MSG_MAX_SIZE);
-        ssize_t r = net_recv(receiver->control_socket, buf + head,
+        if (head == DEVICE_MSG_MAX_SIZE) {
+            // Any msg fits in the buffer, so the partial msg does not start
+            // at the beginning
+            assert(tail);
+            size_t remaining = head - tail;
+            if (sc_receiver_buffer_is_shared(buffer)) {
+                // Some processed msgs still reference the buffer, continue in
+                // a new one
+                struct sc_receiver_buffer *new_buffer =
+                    sc_receiver_buffer_new();
+                if (!new_buffer) {
+                    error = true;
+                    break;
+                }
+                memcpy(new_buffer->data, &buffer->data[tail], remaining);
+                sc_receiver_buffer_unref(buffer);
+                buffer = new_buffer;
+            } else {
+                memmove(buffer->data, &buffer->data[tail], remaining);
+            }
+            head = remaining;
+            tail = 0;
+        }
+
+        ssize_t r = net_recv(receiver->control_socket, &buffer->data[head],
                              DEVICE_MSG_MAX_SIZE - head);
         if (r <= 0) {
+            sc_socket socket = SC_SOCKET_NONE;
+            if (receiver->cbs->on_disconnected) {
+                socket = receiver->cbs->on_disconnected(
+                        receiver, receiver->control_socket,
+                        receiver->cbs_userdata);
+            }
+            if (socket != SC_SOCKET_NONE) {
+                receiver->control_socket = socket;
+                // Drop the partial msg of the previous connection
+                tail = head;
+                continue;
+            }
+
             LOGD("Receiver stopped");
             // device disconnected: keep error=false
             break;
         }
 
         head += r;
-        ssize_t consumed = process_msgs(receiver, buf, head);
+        ssize_t consumed = process_msgs(receiver, buffer, tail, head);
         if (consumed == -1) {
             // an error occurred
             error = true;
             break;
         }
 
-        if (consumed) {
-            head -= consumed;
-            // shift the remaining data in the buffer
-            memmove(buf, &buf[consumed], head);
+        tail += consumed;
+        if (tail == head && !sc_receiver_buffer_is_shared(buffer)) {
+            // Nothing pending, restart from the beginning (without any copy)
+            head = 0;
+            tail = 0;
         }
     }
 
+    sc_receiver_buffer_unref(buffer);
+
+end:
     receiver->cbs->on_ended(receiver, error, receiver->cbs_userdata);
 
     return 0;
@@ -7,6 +7,7 @@
 
 #include "uhid/uhid_output.h"
 #include "util/acksync.h"
+#include "util/arena.h"
 #include "util/net.h"
 #include "util/thread.h"
 
@@ -20,12 +21,20 @@ struct sc_receiver {
     struct sc_acksync *acksync;
     struct sc_uhid_devices *uhid_devices;
 
+    // Transient allocations of the receiver thread, reset after each msg
+    struct sc_arena scratch;
+
     const struct sc_receiver_callbacks *cbs;
     void *cbs_userdata;
 };
 
 struct sc_receiver_callbacks {
     void (*on_ended)(struct sc_receiver *receiver, bool error, void *userdata);
+
+    // Optional: called when the socket is closed, return a new socket to
+    // continue receiving (or SC_SOCKET_NONE to stop)
+    sc_socket (*on_disconnected)(struct sc_receiver *receiver,
+                                 sc_socket socket, void *userdata);
 };
 
 bool
@@ -9,6 +9,11 @@
 #include <libavutil/time.h>
 #include <libavutil/display.h>
 
+#include "memory_budget.h"
+#include "packet_merger.h"
+#include "recorder_writer.h"
+#include "stats.h"
+#include "util/file.h"
 #include "util/log.h"
 #include "util/str.h"
 
@@ -18,6 +23,9 @@
 #define DOWNCAST_AUDIO(SINK) \
     container_of(SINK, struct sc_recorder, audio_packet_sink)
 
+// Warn once if more packets than this are waiting to be recorded
+#define SC_RECORDER_PENDING_WARN_THRESHOLD 256
+
 static const AVRational SCRCPY_TIME_BASE = {1, 1000000}; // timestamps in us
 
 static const AVOutputFormat *
@@ -53,14 +61,144 @@ sc_recorder_packet_ref(const AVPacket *packet) {
     return p;
 }
 
+// Pop a packet, and release its memory from the budget
+static AVPacket *
+sc_recorder_queue_pop(struct sc_recorder_queue *queue) {
+    AVPacket *p = sc_vecdeque_pop(queue);
+    sc_memory_budget_release(SC_MEMORY_BUDGET_RECORDER, p->size);
+    return p;
+}
+
 static void
 sc_recorder_queue_clear(struct sc_recorder_queue *queue) {
     while (!sc_vecdeque_is_empty(queue)) {
-        AVPacket *p = sc_vecdeque_pop(queue);
+        AVPacket *p = sc_recorder_queue_pop(queue);
         av_packet_free(&p);
     }
 }
 
+// Reserve the memory of a packet to queue. Return false if the packet must be
+// dropped because the memory budget is exceeded (the disk does not keep up).
+static bool
+sc_recorder_reserve_packet(struct sc_recorder *recorder,
+                           const AVPacket *packet, bool video) {
+    sc_mutex_assert(&recorder->mutex);
+
+    if (packet->pts == AV_NOPTS_VALUE) {
+        // Config packets are required to decode the next packets
+        sc_memory_budget_force_reserve(SC_MEMORY_BUDGET_RECORDER,
+                                       packet->size);
+        return true;
+    }
+
+    bool *dropping = video ? &recorder->video_dropping
+                           : &recorder->audio_dropping;
+
+    // Once a video packet is dropped, the next ones cannot be decoded until
+    // the next key frame (all audio packets are independently decodable)
+    bool resync = !video || (packet->flags & AV_PKT_FLAG_KEY);
+    if ((!*dropping || resync)
+            && sc_memory_budget_reserve(SC_MEMORY_BUDGET_RECORDER,
+                                        packet->size)) {
+        *dropping = false;
+        return true;
+    }
+
+    if (!*dropping) {
+        if (video) {
+            LOGW("Recording over memory budget, dropping video packets until "
+                 "the next key frame");
+        } else {
+            LOGW("Recording over memory budget, dropping audio packets");
+        }
+        *dropping = true;
+    }
+
+    sc_stats_inc(SC_STATS_RECORDER_PACKETS_DROPPED);
+    return false;
+}
+
+// Keep the config attached to a dropped video packet: the next key frame
+// recorded must carry it, otherwise the recording would not be decodable if
+// the config changed meanwhile
+static bool
+sc_recorder_keep_dropped_config(struct sc_recorder *recorder,
+                                const AVPacket *packet) {
+    sc_mutex_assert(&recorder->mutex);
+
+    size_t config_size;
+    const uint8_t *config = sc_packet_merger_get_config(packet, &config_size);
+    if (!config) {
+        // nothing to do
+        return true;
+    }
+
+    // Only the latest config is relevant
+    uint8_t *copy = realloc(recorder->video_pending_config, config_size);
+    if (!copy) {
+        LOG_OOM();
+        return false;
+    }
+    memcpy(copy, config, config_size);
+
+    recorder->video_pending_config = copy;
+    recorder->video_pending_config_size = config_size;
+    return true;
+}
+
+// Attach the config of a previously dropped video packet to the packet to
+// record (if it is a key frame which does not carry a newer config)
+static bool
+sc_recorder_attach_pending_config(struct sc_recorder *recorder,
+                                  AVPacket *packet) {
+    sc_mutex_assert(&recorder->mutex);
+
+    if (!recorder->video_pending_config
+            || !(packet->flags & AV_PKT_FLAG_KEY)) {
+        // nothing to do
+        return true;
+    }
+
+    size_t config_size;
+    if (!sc_packet_merger_get_config(packet, &config_size)) {
+        uint8_t *side_data =
+            av_packet_new_side_data(packet, AV_PKT_DATA_NEW_EXTRADATA,
+                                    recorder->video_pending_config_size);
+        if (!side_data) {
+            LOG_OOM();
+            return false;
+        }
+
+        memcpy(side_data, recorder->video_pending_config,
+               recorder->video_pending_config_size);
+    }
+
+    free(recorder->video_pending_config);
+    recorder->video_pending_config = NULL;
+    return true;
+}
+
+static void
+sc_recorder_update_pending(struct sc_recorder *recorder) {
+    sc_mutex_assert(&recorder->mutex);
+
+    size_t pending = sc_vecdeque_size(&recorder->video_queue)
+                   + sc_vecdeque_size(&recorder->audio_queue);
+    recorder->max_pending = MAX(recorder->max_pending, pending);
+
+    if (pending > SC_RECORDER_PENDING_WARN_THRESHOLD
+            && !recorder->pending_warned) {
+        LOGW("Recording is falling behind (%" SC_PRIsizet " packets pending)",
+             pending);
+        recorder->pending_warned = true;
+    }
+}
+
+static inline bool
+sc_recorder_is_segmented(struct sc_recorder *recorder) {
+    return recorder->segmentation.duration || recorder->segmentation.size;
+}
+
 static const char *
 sc_recorder_get_format_name(enum sc_record_format format) {
     switch (format) {
@@ -106,6 +244,17 @@ sc_recorder_rescale_packet(AVStream *stream, AVPacket *packet) {
 static bool
 sc_recorder_write_stream(struct sc_recorder *recorder,
                          struct sc_recorder_stream *st, AVPacket *packet) {
+    if (sc_recorder_is_segmented(recorder)) {
+        packet->pts -= recorder->segment_pts;
+        packet->dts = packet->pts;
+        if (packet->pts < 0) {
+            // An audio packet older than the first video packet of the
+            // segment, drop it
+            LOGD("Dropping packet before the start of the segment");
+            return true;
+        }
+    }
+
     AVStream *stream = recorder->ctx->streams[st->index];
     sc_recorder_rescale_packet(stream, packet);
     if (st->last_pts != AV_NOPTS_VALUE && packet->pts <= st->last_pts) {
@@ -130,6 +279,66 @@ sc_recorder_write_audio(struct sc_recorder *recorder, AVPacket *packet) {
     return sc_recorder_write_stream(recorder, &recorder->audio_stream, packet);
 }
 
+static bool
+sc_recorder_set_orientation(AVStream *stream, enum sc_orientation orientation) {
+    assert(!sc_orientation_is_mirror(orientation));
+
+    uint8_t *raw_data;
+#ifdef SCRCPY_LAVC_HAS_CODECPAR_CODEC_SIDEDATA
+    AVPacketSideData *sd =
+        av_packet_side_data_new(&stream->codecpar->coded_side_data,
+                                &stream->codecpar->nb_coded_side_data,
+                                AV_PKT_DATA_DISPLAYMATRIX,
+                                sizeof(int32_t) * 9, 0);
+    if (!sd) {
+        LOG_OOM();
+        return false;
+    }
+
+    raw_data = sd->data;
+#else
+    raw_data = av_stream_new_side_data(stream, AV_PKT_DATA_DISPLAYMATRIX,
+                                      sizeof(int32_t) * 9);
+    if (!raw_data) {
+        LOG_OOM();
+        return false;
+    }
+#endif
+
+    int32_t *matrix = (int32_t *) raw_data;
+
+    unsigned rotation = orientation;
+    unsigned angle = rotation * 90;
+
+    av_display_rotation_set(matrix, angle);
+
+    return true;
+}
+
+static char *
+sc_recorder_get_segment_filename(const char *filename, unsigned index) {
+    // Insert the index before the extension: "file.mp4" -> "file-00042.mp4"
+    const char *sep = strrchr(filename, SC_PATH_SEPARATOR);
+    const char *dot = strrchr(sep ? sep + 1 : filename, '.');
+    const char *ext = dot ? dot : "";
+    int base_len = dot ? (int) (dot - filename) : (int) strlen(filename);
+
+    char *name;
+    int r = asprintf(&name, "%.*s-%05u%s", base_len, filename, index, ext);
+    if (r == -1) {
+        LOG_OOM();
+        return NULL;
+    }
+
+    return name;
+}
+
+static inline const char *
+sc_recorder_get_current_filename(struct sc_recorder *recorder) {
+    return recorder->segment_filename ? recorder->segment_filename
+                                      : recorder->filename;
+}
+
 static bool
 sc_recorder_open_output_file(struct sc_recorder *recorder) {
     const char *format_name = sc_recorder_get_format_name(recorder->format);
@@ -140,25 +349,32 @@ sc_recorder_open_output_file(struct sc_recorder *recorder) {
         return false;
     }
 
+    assert(!recorder->segment_filename);
+    if (sc_recorder_is_segmented(recorder)) {
+        recorder->segment_filename =
+            sc_recorder_get_segment_filename(recorder->filename,
+                                             recorder->segment_index);
+        if (!recorder->segment_filename) {
+            return false;
+        }
+    }
+
+    const char *filename = sc_recorder_get_current_filename(recorder);
+
     recorder->ctx = avformat_alloc_context();
     if (!recorder->ctx) {
         LOG_OOM();
-        return false;
+        goto error_free_segment_filename;
     }
 
-    char *file_url = sc_str_concat("file:", recorder->filename);
-    if (!file_url) {
+    bool ok = sc_recorder_writer_open(&recorder->writer, filename);
+    if (!ok) {
         avformat_free_context(recorder->ctx);
-        return false;
+        recorder->ctx = NULL;
+        goto error_free_segment_filename;
     }
 
-    int ret = avio_open(&recorder->ctx->pb, file_url, AVIO_FLAG_WRITE);
-    free(file_url);
-    if (ret < 0) {
-        LOGE("Failed to open output file: %s", recorder->filename);
-        avformat_free_context(recorder->ctx);
-        return false;
-    }
+    recorder->ctx->pb = recorder->writer.avio;
 
     // contrary to the deprecated API (av_oformat_next()), av_muxer_iterate()
     // returns (on purpose) a pointer-to-const, but AVFormatContext.oformat
@@ -169,14 +385,216 @@ sc_recorder_open_output_file(struct sc_recorder *recorder) {
     av_dict_set(&recorder->ctx->metadata, "comment",
                 "Recorded by scrcpy " SCRCPY_VERSION, 0);
 
-    LOGI("Recording started to %s file: %s", format_name, recorder->filename);
+    if (recorder->low_latency) {
+        // Do not keep the data in the AVIOContext buffer
+        recorder->ctx->flush_packets = 1;
+        recorder->ctx->pb->seekable = 0;
+    }
+
+    if (recorder->segment_index) {
+        LOGI("Recording next segment to %s", filename);
+    } else {
+        LOGI("Recording started to %s file: %s", format_name, filename);
+    }
     return true;
+
+error_free_segment_filename:
+    free(recorder->segment_filename);
+    recorder->segment_filename = NULL;
+
+    return false;
 }
 
-static void
+static bool
 sc_recorder_close_output_file(struct sc_recorder *recorder) {
-    avio_close(recorder->ctx->pb);
+    if (!recorder->ctx) {
+        // Already closed (on segment rotation failure)
+        return false;
+    }
+
+    // The AVIOContext is owned by the writer
+    recorder->ctx->pb = NULL;
+    bool ok = sc_recorder_writer_close(&recorder->writer);
     avformat_free_context(recorder->ctx);
+    recorder->ctx = NULL;
+    return ok;
+}
+
+// Called once a segment is complete, to delete the old ones if necessary
+static void
+sc_recorder_complete_segment(struct sc_recorder *recorder) {
+    char *filename = recorder->segment_filename;
+    assert(filename);
+    recorder->segment_filename = NULL;
+
+    unsigned max_count = recorder->segmentation.max_count;
+    if (!max_count) {
+        // Keep all the segments
+        free(filename);
+        return;
+    }
+
+    bool ok = sc_vecdeque_push(&recorder->segments, filename);
+    if (!ok) {
+        LOG_OOM();
+        // Do not delete the file, just forget it
+        free(filename);
+        return;
+    }
+
+    // The current segment (about to be open) counts
+    while (sc_vecdeque_size(&recorder->segments) >= max_count) {
+        char *old = sc_vecdeque_pop(&recorder->segments);
+        LOGD("Deleting old segment: %s", old);
+        if (!sc_file_remove(old)) {
+            LOGW("Could not delete old segment: %s", old);
+        }
+        free(old);
+    }
+}
+
+static bool
+sc_recorder_write_header(struct sc_recorder *recorder) {
+    AVDictionary *opts = NULL;
+
+    if (recorder->low_latency) {
+        // Never seek back, so that the output may be streamed
+        switch (recorder->format) {
+            case SC_RECORD_FORMAT_MP4:
+            case SC_RECORD_FORMAT_M4A:
+            case SC_RECORD_FORMAT_AAC:
+                av_dict_set(&opts, "movflags",
+                            "empty_moov+default_base_moof+frag_every_frame",
+                            0);
+                break;
+            case SC_RECORD_FORMAT_MKV:
+            case SC_RECORD_FORMAT_MKA:
+                av_dict_set(&opts, "live", "1", 0);
+                break;
+            default:
+                break;
+        }
+    }
+
+    int ret = avformat_write_header(recorder->ctx, &opts);
+    av_dict_free(&opts);
+    if (ret < 0) {
+        LOGE("Failed to write header to %s",
+             sc_recorder_get_current_filename(recorder));
+        return false;
+    }
+
+    return true;
+}
+
+static bool
+sc_recorder_copy_streams(AVFormatContext *dst, const AVFormatContext *src) {
+    for (unsigned i = 0; i < src->nb_streams; ++i) {
+        AVStream *stream = avformat_new_stream(dst, NULL);
+        if (!stream) {
+            LOG_OOM();
+            return false;
+        }
+
+        assert(stream->index == (int) i);
+
+        const AVStream *src_stream = src->streams[i];
+        if (avcodec_parameters_copy(stream->codecpar,
+                                    src_stream->codecpar) < 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Finalize the current segment and start the next one, without re-encoding or
+// re-muxing anything: the packets are just written to another file
+static bool
+sc_recorder_next_segment(struct sc_recorder *recorder, int64_t pts) {
+    assert(sc_recorder_is_segmented(recorder));
+
+    AVFormatContext *prev_ctx = recorder->ctx;
+
+    int ret = av_write_trailer(prev_ctx);
+    if (ret < 0) {
+        LOGE("Failed to write trailer to %s",
+             sc_recorder_get_current_filename(recorder));
+    }
+
+    prev_ctx->pb = NULL;
+    bool ok = sc_recorder_writer_close(&recorder->writer);
+    recorder->ctx = NULL;
+    if (ret < 0 || !ok) {
+        avformat_free_context(prev_ctx);
+        return false;
+    }
+
+    sc_recorder_complete_segment(recorder);
+
+    ++recorder->segment_index;
+    ok = sc_recorder_open_output_file(recorder);
+    if (!ok) {
+        avformat_free_context(prev_ctx);
+        return false;
+    }
+
+    // The codec parameters (including the extradata and the orientation
+    // side data) are the same for all segments
+    ok = sc_recorder_copy_streams(recorder->ctx, prev_ctx);
+    avformat_free_context(prev_ctx);
+    if (!ok) {
+        goto error_close;
+    }
+
+#ifndef SCRCPY_LAVC_HAS_CODECPAR_CODEC_SIDEDATA
+    // The orientation is stored in the stream side data, not copied with the
+    // codec parameters
+    if (recorder->video && recorder->orientation != SC_ORIENTATION_0) {
+        AVStream *video_stream =
+            recorder->ctx->streams[recorder->video_stream.index];
+        if (!sc_recorder_set_orientation(video_stream,
+                                         recorder->orientation)) {
+            goto error_close;
+        }
+    }
+#endif
+
+    if (!sc_recorder_write_header(recorder)) {
+        goto error_close;
+    }
+
+    recorder->video_stream.last_pts = AV_NOPTS_VALUE;
+    recorder->audio_stream.last_pts = AV_NOPTS_VALUE;
+    recorder->segment_pts = pts;
+
+    return true;
+
+error_close:
+    sc_recorder_close_output_file(recorder);
+    return false;
+}
+
+static bool
+sc_recorder_must_cut(struct sc_recorder *recorder, const AVPacket *packet) {
+    assert(sc_recorder_is_segmented(recorder));
+
+    // Video segments must start on a key frame (all audio packets are
+    // independently decodable)
+    if (recorder->video && !(packet->flags & AV_PKT_FLAG_KEY)) {
+        return false;
+    }
+
+    const struct sc_recorder_segmentation *seg = &recorder->segmentation;
+    if (seg->duration && packet->pts - recorder->segment_pts >= seg->duration) {
+        return true;
+    }
+
+    if (seg->size && (uint64_t) avio_tell(recorder->ctx->pb) >= seg->size) {
+        return true;
+    }
+
+    return false;
 }
 
 static inline bool
@@ -218,14 +636,14 @@ sc_recorder_process_header(struct sc_recorder *recorder) {
     AVPacket *video_pkt = NULL;
     if (!sc_vecdeque_is_empty(&recorder->video_queue)) {
         assert(recorder->video);
-        video_pkt = sc_vecdeque_pop(&recorder->video_queue);
+        video_pkt = sc_recorder_queue_pop(&recorder->video_queue);
     }
 
     AVPacket *audio_pkt = NULL;
     if (recorder->audio_expects_config_packet &&
             !sc_vecdeque_is_empty(&recorder->audio_queue)) {
         assert(recorder->audio);
-        audio_pkt = sc_vecdeque_pop(&recorder->audio_queue);
+        audio_pkt = sc_recorder_queue_pop(&recorder->audio_queue);
     }
 
     sc_mutex_unlock(&recorder->mutex);
@@ -262,9 +680,8 @@ sc_recorder_process_header(struct sc_recorder *recorder) {
         }
     }
 
-    bool ok = avformat_write_header(recorder->ctx, NULL) >= 0;
+    bool ok = sc_recorder_write_header(recorder);
     if (!ok) {
-        LOGE("Failed to write header to %s", recorder->filename);
         goto end;
     }
 
@@ -281,6 +698,25 @@ end:
     return ret;
 }
 
+// Write a video packet, starting a new segment before it if necessary
+static bool
+sc_recorder_process_video(struct sc_recorder *recorder, AVPacket *packet) {
+    if (sc_recorder_is_segmented(recorder)
+            && sc_recorder_must_cut(recorder, packet)) {
+        if (!sc_recorder_next_segment(recorder, packet->pts)) {
+            return false;
+        }
+    }
+
+    bool ok = sc_recorder_write_video(recorder, packet);
+    if (!ok) {
+        LOGE("Could not record video packet");
+        return false;
+    }
+
+    return true;
+}
+
 static bool
 sc_recorder_process_packets(struct sc_recorder *recorder) {
     int64_t pts_origin = AV_NOPTS_VALUE;
@@ -330,11 +766,11 @@ sc_recorder_process_packets(struct sc_recorder *recorder) {
                 && sc_vecdeque_is_empty(&recorder->audio_queue)));
 
         if (!video_pkt && !sc_vecdeque_is_empty(&recorder->video_queue)) {
-            video_pkt = sc_vecdeque_pop(&recorder->video_queue);
+            video_pkt = sc_recorder_queue_pop(&recorder->video_queue);
         }
 
         if (!audio_pkt && !sc_vecdeque_is_empty(&recorder->audio_queue)) {
-            audio_pkt = sc_vecdeque_pop(&recorder->audio_queue);
+            audio_pkt = sc_recorder_queue_pop(&recorder->audio_queue);
         }
 
         if (recorder->stopped && !video_pkt && !audio_pkt) {
@@ -350,7 +786,7 @@ sc_recorder_process_packets(struct sc_recorder *recorder) {
 
         // Ignore further config packets (e.g. on device orientation
         // change). The next non-config packet will have the config packet
-        // data prepended.
+        // data attached, and prepended by sc_packet_merger_inline_config().
         if (video_pkt && video_pkt->pts == AV_NOPTS_VALUE) {
             av_packet_free(&video_pkt);
             video_pkt = NULL;
@@ -361,6 +797,11 @@ sc_recorder_process_packets(struct sc_recorder *recorder) {
             audio_pkt = NULL;
         }
 
+        if (video_pkt && !sc_packet_merger_inline_config(video_pkt)) {
+            error = true;
+            goto end;
+        }
+
         if (pts_origin == AV_NOPTS_VALUE) {
             if (!recorder->audio) {
                 assert(video_pkt);
@@ -392,28 +833,48 @@ sc_recorder_process_packets(struct sc_recorder *recorder) {
             video_pkt->pts -= pts_origin;
             video_pkt->dts = video_pkt->pts;
 
-            if (video_pkt_previous) {
-                // we now know the duration of the previous packet
-                video_pkt_previous->duration = video_pkt->pts
-                                             - video_pkt_previous->pts;
-
-                bool ok = sc_recorder_write_video(recorder, video_pkt_previous);
-                av_packet_free(&video_pkt_previous);
+            if (recorder->low_latency) {
+                // Write the packet immediately, the muxer computes its
+                // duration
+                bool ok = sc_recorder_process_video(recorder, video_pkt);
+                av_packet_free(&video_pkt);
                 if (!ok) {
-                    LOGE("Could not record video packet");
                     error = true;
                     goto end;
                 }
-            }
+            } else {
+                if (video_pkt_previous) {
+                    // we now know the duration of the previous packet
+                    video_pkt_previous->duration = video_pkt->pts
+                                                 - video_pkt_previous->pts;
+
+                    bool ok = sc_recorder_process_video(recorder,
+                                                        video_pkt_previous);
+                    av_packet_free(&video_pkt_previous);
+                    if (!ok) {
+                        error = true;
+                        goto end;
+                    }
+                }
 
-            video_pkt_previous = video_pkt;
-            video_pkt = NULL;
+                video_pkt_previous = video_pkt;
+                video_pkt = NULL;
+            }
         }
 
         if (audio_pkt) {
             audio_pkt->pts -= pts_origin;
             audio_pkt->dts = audio_pkt->pts;
 
+            // Without video, the audio stream drives the segmentation
+            if (!recorder->video && sc_recorder_is_segmented(recorder)
+                    && sc_recorder_must_cut(recorder, audio_pkt)) {
+                if (!sc_recorder_next_segment(recorder, audio_pkt->pts)) {
+                    error = true;
+                    goto end;
+                }
+            }
+
             bool ok = sc_recorder_write_audio(recorder, audio_pkt);
             if (!ok) {
                 LOGE("Could not record audio packet");
@@ -443,7 +904,8 @@ sc_recorder_process_packets(struct sc_recorder *recorder) {
 
     int ret = av_write_trailer(recorder->ctx);
     if (ret < 0) {
-        LOGE("Failed to write trailer to %s", recorder->filename);
+        LOGE("Failed to write trailer to %s",
+             sc_recorder_get_current_filename(recorder));
         error = false;
     }
 
@@ -466,17 +928,20 @@ sc_recorder_record(struct sc_recorder *recorder) {
     }
 
     ok = sc_recorder_process_packets(recorder);
-    sc_recorder_close_output_file(recorder);
-    return ok;
+    bool closed = sc_recorder_close_output_file(recorder);
+
+    free(recorder->segment_filename);
+    recorder->segment_filename = NULL;
+
+    return ok && closed;
 }
 
 static int
 run_recorder(void *data) {
     struct sc_recorder *recorder = data;
 
-    // Recording is a background task
-    bool ok = sc_thread_set_priority(SC_THREAD_PRIORITY_LOW);
-    (void) ok; // We don't care if it worked
+    // Recording is a background task (low priority by default)
+    sc_thread_apply_policy(SC_THREAD_ROLE_RECORDING);
 
     bool success = sc_recorder_record(recorder);
 
@@ -496,6 +961,8 @@ run_recorder(void *data) {
         LOGE("Recording failed to %s", recorder->filename);
     }
 
+    LOGD("Recorder: max %" SC_PRIsizet " packets pending",
+         recorder->max_pending);
     LOGD("Recorder thread ended");
 
     recorder->cbs->on_ended(recorder, success, recorder->cbs_userdata);
@@ -503,42 +970,6 @@ run_recorder(void *data) {
     return 0;
 }
 
-static bool
-sc_recorder_set_orientation(AVStream *stream, enum sc_orientation orientation) {
-    assert(!sc_orientation_is_mirror(orientation));
-
-    uint8_t *raw_data;
-#ifdef SCRCPY_LAVC_HAS_CODECPAR_CODEC_SIDEDATA
-    AVPacketSideData *sd =
-        av_packet_side_data_new(&stream->codecpar->coded_side_data,
-                                &stream->codecpar->nb_coded_side_data,
-                                AV_PKT_DATA_DISPLAYMATRIX,
-                                sizeof(int32_t) * 9, 0);
-    if (!sd) {
-        LOG_OOM();
-        return false;
-    }
-
-    raw_data = sd->data;
-#else
-    raw_data = av_stream_new_side_data(stream, AV_PKT_DATA_DISPLAYMATRIX,
-                                      sizeof(int32_t) * 9);
-    if (!raw_data) {
-        LOG_OOM();
-        return false;
-    }
-#endif
-
-    int32_t *matrix = (int32_t *) raw_data;
-
-    unsigned rotation = orientation;
-    unsigned angle = rotation * 90;
-
-    av_display_rotation_set(matrix, angle);
-
-    return true;
-}
-
 static bool
 sc_recorder_video_packet_sink_open(struct sc_packet_sink *sink,
                                    AVCodecContext *ctx) {
@@ -611,9 +1042,24 @@ sc_recorder_video_packet_sink_push(struct sc_packet_sink *sink,
         return false;
     }
 
+    if (!sc_recorder_reserve_packet(recorder, packet, true)) {
+        // Not an error, the recording continues
+        bool ok = sc_recorder_keep_dropped_config(recorder, packet);
+        sc_mutex_unlock(&recorder->mutex);
+        return ok;
+    }
+
     AVPacket *rec = sc_recorder_packet_ref(packet);
     if (!rec) {
         LOG_OOM();
+        sc_memory_budget_release(SC_MEMORY_BUDGET_RECORDER, packet->size);
+        sc_mutex_unlock(&recorder->mutex);
+        return false;
+    }
+
+    if (!sc_recorder_attach_pending_config(recorder, rec)) {
+        av_packet_free(&rec);
+        sc_memory_budget_release(SC_MEMORY_BUDGET_RECORDER, packet->size);
         sc_mutex_unlock(&recorder->mutex);
         return false;
     }
@@ -623,10 +1069,13 @@ sc_recorder_video_packet_sink_push(struct sc_packet_sink *sink,
     bool ok = sc_vecdeque_push(&recorder->video_queue, rec);
     if (!ok) {
         LOG_OOM();
+        av_packet_free(&rec);
+        sc_memory_budget_release(SC_MEMORY_BUDGET_RECORDER, packet->size);
         sc_mutex_unlock(&recorder->mutex);
         return false;
     }
 
+    sc_recorder_update_pending(recorder);
     sc_cond_signal(&recorder->cond);
 
     sc_mutex_unlock(&recorder->mutex);
@@ -698,9 +1147,16 @@ sc_recorder_audio_packet_sink_push(struct sc_packet_sink *sink,
         return false;
     }
 
+    if (!sc_recorder_reserve_packet(recorder, packet, false)) {
+        // Not an error, the recording continues
+        sc_mutex_unlock(&recorder->mutex);
+        return true;
+    }
+
     AVPacket *rec = sc_recorder_packet_ref(packet);
     if (!rec) {
         LOG_OOM();
+        sc_memory_budget_release(SC_MEMORY_BUDGET_RECORDER, packet->size);
         sc_mutex_unlock(&recorder->mutex);
         return false;
     }
@@ -710,10 +1166,13 @@ sc_recorder_audio_packet_sink_push(struct sc_packet_sink *sink,
     bool ok = sc_vecdeque_push(&recorder->audio_queue, rec);
     if (!ok) {
         LOG_OOM();
+        av_packet_free(&rec);
+        sc_memory_budget_release(SC_MEMORY_BUDGET_RECORDER, packet->size);
         sc_mutex_unlock(&recorder->mutex);
         return false;
     }
 
+    sc_recorder_update_pending(recorder);
     sc_cond_signal(&recorder->cond);
 
     sc_mutex_unlock(&recorder->mutex);
@@ -745,7 +1204,8 @@ sc_recorder_stream_init(struct sc_recorder_stream *stream) {
 bool
 sc_recorder_init(struct sc_recorder *recorder, const char *filename,
                  enum sc_record_format format, bool video, bool audio,
-                 enum sc_orientation orientation,
+                 enum sc_orientation orientation, bool low_latency,
+                 const struct sc_recorder_segmentation *segmentation,
                  const struct sc_recorder_callbacks *cbs, void *cbs_userdata) {
     assert(!sc_orientation_is_mirror(orientation));
 
@@ -770,10 +1230,16 @@ sc_recorder_init(struct sc_recorder *recorder, const char *filename,
     recorder->audio = audio;
 
     recorder->orientation = orientation;
+    recorder->low_latency = low_latency;
 
     sc_vecdeque_init(&recorder->video_queue);
     sc_vecdeque_init(&recorder->audio_queue);
     recorder->stopped = false;
+    recorder->max_pending = 0;
+    recorder->pending_warned = false;
+    recorder->video_dropping = false;
+    recorder->audio_dropping = false;
+    recorder->video_pending_config = NULL;
 
     recorder->video_init = false;
     recorder->audio_init = false;
@@ -785,6 +1251,18 @@ sc_recorder_init(struct sc_recorder *recorder, const char *filename,
 
     recorder->format = format;
 
+    if (segmentation) {
+        recorder->segmentation = *segmentation;
+    } else {
+        recorder->segmentation.duration = 0;
+        recorder->segmentation.size = 0;
+        recorder->segmentation.max_count = 0;
+    }
+    recorder->segment_index = 0;
+    recorder->segment_pts = 0;
+    recorder->segment_filename = NULL;
+    sc_vecdeque_init(&recorder->segments);
+
     assert(cbs && cbs->on_ended);
     recorder->cbs = cbs;
     recorder->cbs_userdata = cbs_userdata;
@@ -847,7 +1325,13 @@ sc_recorder_join(struct sc_recorder *recorder) {
 
 void
 sc_recorder_destroy(struct sc_recorder *recorder) {
+    while (!sc_vecdeque_is_empty(&recorder->segments)) {
+        char *filename = sc_vecdeque_pop(&recorder->segments);
+        free(filename);
+    }
+    sc_vecdeque_destroy(&recorder->segments);
     sc_cond_destroy(&recorder->cond);
     sc_mutex_destroy(&recorder->mutex);
+    free(recorder->video_pending_config);
     free(recorder->filename);
 }
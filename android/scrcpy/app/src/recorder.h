@@ -9,11 +9,25 @@
 #include <libavformat/avformat.h>
 
 #include "options.h"
+#include "recorder_writer.h"
 #include "trait/packet_sink.h"
 #include "util/thread.h"
+#include "util/tick.h"
 #include "util/vecdeque.h"
 
 struct sc_recorder_queue SC_VECDEQUE(AVPacket *);
+struct sc_recorder_segments SC_VECDEQUE(char *);
+
+struct sc_recorder_segmentation {
+    // Start a new segment on the first key frame after this duration (0 to
+    // disable)
+    sc_tick duration;
+    // Start a new segment on the first key frame after this size in bytes (0
+    // to disable)
+    uint64_t size;
+    // Number of segments to keep (older ones are deleted), 0 to keep all
+    unsigned max_count;
+};
 
 struct sc_recorder_stream {
     int index;
@@ -36,10 +50,14 @@ struct sc_recorder {
     bool video;
 
     enum sc_orientation orientation;
+    // write the video packets immediately (without their duration), and
+    // produce a streamable output
+    bool low_latency;
 
     char *filename;
     enum sc_record_format format;
     AVFormatContext *ctx;
+    struct sc_recorder_writer writer;
 
     sc_thread thread;
     sc_mutex mutex;
@@ -48,6 +66,16 @@ struct sc_recorder {
     bool stopped;
     struct sc_recorder_queue video_queue;
     struct sc_recorder_queue audio_queue;
+    // backpressure metrics: max number of packets pending in both queues
+    size_t max_pending;
+    bool pending_warned;
+    // Packets are being dropped because the memory budget is exceeded
+    bool video_dropping;
+    bool audio_dropping;
+    // Config (SPS/PPS) attached to a dropped video packet, to attach to the
+    // next video packet recorded
+    uint8_t *video_pending_config;
+    size_t video_pending_config_size;
 
     // wake up the recorder thread once the video or audio codec is known
     bool video_init;
@@ -58,6 +86,16 @@ struct sc_recorder {
     struct sc_recorder_stream video_stream;
     struct sc_recorder_stream audio_stream;
 
+    // Accessed only from the recorder thread
+    struct sc_recorder_segmentation segmentation;
+    unsigned segment_index;
+    // pts of the first packet of the current segment
+    int64_t segment_pts;
+    // filename of the current segment (NULL if not segmented)
+    char *segment_filename;
+    // completed segments, only tracked if segmentation.max_count != 0
+    struct sc_recorder_segments segments;
+
     const struct sc_recorder_callbacks *cbs;
     void *cbs_userdata;
 };
@@ -70,7 +108,8 @@ struct sc_recorder_callbacks {
 bool
 sc_recorder_init(struct sc_recorder *recorder, const char *filename,
                  enum sc_record_format format, bool video, bool audio,
-                 enum sc_orientation orientation,
+                 enum sc_orientation orientation, bool low_latency,
+                 const struct sc_recorder_segmentation *segmentation,
                  const struct sc_recorder_callbacks *cbs, void *cbs_userdata);
 
 bool
@@ -0,0 +1,319 @@
+#include "recorder_writer.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <libavutil/mem.h>
+
+#include "util/log.h"
+#include "util/str.h"
+
+// Size of the AVIOContext buffer used by the muxer, so the size of most chunks
+#define SC_RECORDER_WRITER_BUFFER_SIZE (1 << 20) // 1 MiB
+// Maximum amount of data queued for the writer thread before the muxer blocks
+#define SC_RECORDER_WRITER_MAX_QUEUED_BYTES (32 << 20) // 32 MiB
+
+#ifdef SCRCPY_LAVF_HAS_AVIO_WRITE_CONST_BUF
+# define SC_AVIO_WRITE_BUF const uint8_t
+#else
+# define SC_AVIO_WRITE_BUF uint8_t
+#endif
+
+static int
+sc_recorder_writer_write_packet(void *opaque, SC_AVIO_WRITE_BUF *buf,
+                                int buf_size) {
+    struct sc_recorder_writer *writer = opaque;
+    assert(buf_size > 0);
+
+    struct sc_recorder_chunk chunk;
+    chunk.data = malloc(buf_size);
+    if (!chunk.data) {
+        LOG_OOM();
+        return AVERROR(ENOMEM);
+    }
+    memcpy(chunk.data, buf, buf_size);
+    chunk.size = buf_size;
+    chunk.offset = writer->pos;
+
+    sc_mutex_lock(&writer->mutex);
+
+    if (writer->queued_bytes + chunk.size > SC_RECORDER_WRITER_MAX_QUEUED_BYTES
+            && !writer->error) {
+        // The storage does not keep up, wait for the writer thread
+        sc_tick start = sc_tick_now();
+        // The queue is never empty here (chunk.size is lower than the limit)
+        while (writer->queued_bytes + chunk.size
+                    > SC_RECORDER_WRITER_MAX_QUEUED_BYTES && !writer->error) {
+            sc_cond_wait(&writer->cond, &writer->mutex);
+        }
+        ++writer->stats.stalls;
+        writer->stats.stall_duration += sc_tick_now() - start;
+    }
+
+    if (writer->error) {
+        sc_mutex_unlock(&writer->mutex);
+        free(chunk.data);
+        return AVERROR(EIO);
+    }
+
+    bool ok = sc_vecdeque_push(&writer->queue, chunk);
+    if (!ok) {
+        sc_mutex_unlock(&writer->mutex);
+        LOG_OOM();
+        free(chunk.data);
+        return AVERROR(ENOMEM);
+    }
+
+    writer->queued_bytes += chunk.size;
+    writer->stats.max_queued_bytes =
+        MAX(writer->stats.max_queued_bytes, writer->queued_bytes);
+
+    // The muxer and the writer thread never wait at the same time (the queue
+    // cannot be both full and empty), so signaling is sufficient
+    sc_cond_signal(&writer->cond);
+    sc_mutex_unlock(&writer->mutex);
+
+    writer->pos += buf_size;
+    writer->size = MAX(writer->size, writer->pos);
+
+    return buf_size;
+}
+
+static int64_t
+sc_recorder_writer_seek(void *opaque, int64_t offset, int whence) {
+    struct sc_recorder_writer *writer = opaque;
+
+    // The actual seek is performed by the writer thread, from the offset of
+    // each chunk
+    int64_t pos;
+    switch (whence & ~AVSEEK_FORCE) {
+        case AVSEEK_SIZE:
+            return writer->size;
+        case SEEK_SET:
+            pos = offset;
+            break;
+        case SEEK_CUR:
+            pos = writer->pos + offset;
+            break;
+        case SEEK_END:
+            pos = writer->size + offset;
+            break;
+        default:
+            return AVERROR(EINVAL);
+    }
+
+    if (pos < 0) {
+        return AVERROR(EINVAL);
+    }
+
+    writer->pos = pos;
+    return pos;
+}
+
+static bool
+sc_recorder_writer_write_chunk(struct sc_recorder_writer *writer,
+                               const struct sc_recorder_chunk *chunk) {
+    if (chunk->offset != writer->file_pos) {
+        int64_t r = avio_seek(writer->file, chunk->offset, SEEK_SET);
+        if (r < 0) {
+            LOGE("Could not seek in the record file");
+            return false;
+        }
+    }
+
+    avio_write(writer->file, chunk->data, chunk->size);
+    // Each chunk is large, flush immediately to detect errors early
+    avio_flush(writer->file);
+    if (writer->file->error) {
+        LOGE("Could not write to the record file");
+        return false;
+    }
+
+    writer->file_pos = chunk->offset + chunk->size;
+    return true;
+}
+
+static int
+run_recorder_writer(void *data) {
+    struct sc_recorder_writer *writer = data;
+
+    // Recording is a background task (low priority by default)
+    sc_thread_apply_policy(SC_THREAD_ROLE_RECORDING);
+
+    sc_mutex_lock(&writer->mutex);
+
+    for (;;) {
+        while (!writer->stopped && sc_vecdeque_is_empty(&writer->queue)) {
+            sc_cond_wait(&writer->cond, &writer->mutex);
+        }
+
+        if (sc_vecdeque_is_empty(&writer->queue)) {
+            // stopped and all the chunks are written
+            assert(writer->stopped);
+            break;
+        }
+
+        struct sc_recorder_chunk chunk = sc_vecdeque_pop(&writer->queue);
+        bool error = writer->error;
+
+        sc_mutex_unlock(&writer->mutex);
+
+        bool ok = true;
+        if (!error) {
+            sc_tick start = sc_tick_now();
+            ok = sc_recorder_writer_write_chunk(writer, &chunk);
+            sc_tick duration = sc_tick_now() - start;
+
+            // the stats are read only once the thread is joined
+            if (ok) {
+                writer->stats.bytes_written += chunk.size;
+            }
+            writer->stats.max_write_duration =
+                MAX(writer->stats.max_write_duration, duration);
+        }
+        // else discard the remaining chunks
+
+        free(chunk.data);
+
+        sc_mutex_lock(&writer->mutex);
+
+        assert(writer->queued_bytes >= chunk.size);
+        writer->queued_bytes -= chunk.size;
+        if (!error && !ok) {
+            // The muxer will fail on its next write
+            writer->error = true;
+        }
+        sc_cond_signal(&writer->cond);
+    }
+
+    sc_mutex_unlock(&writer->mutex);
+
+    LOGD("Recorder writer thread ended");
+
+    return 0;
+}
+
+bool
+sc_recorder_writer_open(struct sc_recorder_writer *writer,
+                        const char *filename) {
+    char *file_url = sc_str_concat("file:", filename);
+    if (!file_url) {
+        return false;
+    }
+
+    int ret = avio_open(&writer->file, file_url, AVIO_FLAG_WRITE);
+    free(file_url);
+    if (ret < 0) {
+        LOGE("Failed to open output file: %s", filename);
+        return false;
+    }
+
+    uint8_t *buffer = av_malloc(SC_RECORDER_WRITER_BUFFER_SIZE);
+    if (!buffer) {
+        LOG_OOM();
+        goto error_close_file;
+    }
+
+    writer->avio = avio_alloc_context(buffer, SC_RECORDER_WRITER_BUFFER_SIZE,
+                                      1, writer, NULL,
+                                      sc_recorder_writer_write_packet,
+                                      sc_recorder_writer_seek);
+    if (!writer->avio) {
+        LOG_OOM();
+        av_free(buffer);
+        goto error_close_file;
+    }
+
+    bool ok = sc_mutex_init(&writer->mutex);
+    if (!ok) {
+        goto error_free_avio;
+    }
+
+    ok = sc_cond_init(&writer->cond);
+    if (!ok) {
+        goto error_mutex_destroy;
+    }
+
+    writer->pos = 0;
+    writer->size = 0;
+    writer->file_pos = 0;
+
+    sc_vecdeque_init(&writer->queue);
+    writer->queued_bytes = 0;
+    writer->stopped = false;
+    writer->error = false;
+
+    memset(&writer->stats, 0, sizeof(writer->stats));
+
+    ok = sc_thread_create(&writer->thread, run_recorder_writer,
+                          "scrcpy-rec-io", writer);
+    if (!ok) {
+        LOGE("Could not start recorder writer thread");
+        goto error_cond_destroy;
+    }
+
+    return true;
+
+error_cond_destroy:
+    sc_cond_destroy(&writer->cond);
+error_mutex_destroy:
+    sc_mutex_destroy(&writer->mutex);
+error_free_avio:
+    av_freep(&writer->avio->buffer);
+    avio_context_free(&writer->avio);
+error_close_file:
+    avio_closep(&writer->file);
+
+    return false;
+}
+
+static void
+sc_recorder_writer_log_stats(struct sc_recorder_writer *writer) {
+    struct sc_recorder_writer_stats *stats = &writer->stats;
+
+    LOGD("Recorder writer: %" PRIu64_ " bytes written, max queued: %"
+         SC_PRIsizet " bytes, max write duration: %" PRItick " ms",
+         stats->bytes_written, stats->max_queued_bytes,
+         SC_TICK_TO_MS(stats->max_write_duration));
+
+    if (stats->stalls) {
+        LOGW("Recording storage too slow: blocked %u times (%" PRItick " ms)",
+             stats->stalls, SC_TICK_TO_MS(stats->stall_duration));
+    }
+}
+
+bool
+sc_recorder_writer_close(struct sc_recorder_writer *writer) {
+    // Queue the remaining buffered data
+    avio_flush(writer->avio);
+
+    sc_mutex_lock(&writer->mutex);
+    writer->stopped = true;
+    sc_cond_signal(&writer->cond);
+    sc_mutex_unlock(&writer->mutex);
+
+    sc_thread_join(&writer->thread, NULL);
+
+    assert(sc_vecdeque_is_empty(&writer->queue));
+    assert(!writer->queued_bytes);
+
+    bool ok = !writer->error && !writer->avio->error;
+
+    sc_recorder_writer_log_stats(writer);
+
+    if (avio_closep(&writer->file) < 0) {
+        LOGE("Could not close the record file");
+        ok = false;
+    }
+
+    av_freep(&writer->avio->buffer);
+    avio_context_free(&writer->avio);
+
+    sc_vecdeque_destroy(&writer->queue);
+    sc_cond_destroy(&writer->cond);
+    sc_mutex_destroy(&writer->mutex);
+
+    return ok;
+}
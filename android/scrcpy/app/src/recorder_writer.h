@@ -0,0 +1,85 @@
+#ifndef SC_RECORDER_WRITER_H
+#define SC_RECORDER_WRITER_H
+
+#include "common.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <libavformat/avio.h>
+
+#include "util/thread.h"
+#include "util/tick.h"
+#include "util/vecdeque.h"
+
+/**
+ * Asynchronous file writer for the recorder
+ *
+ * The muxer writes to a custom AVIOContext backed by a large buffer. Each time
+ * this buffer is full (or on seek/flush), its content is copied to a chunk,
+ * which is queued for the writer thread.
+ *
+ * The queue is bounded: if the storage is too slow, the muxer blocks until
+ * some chunks are written, so that the memory usage does not grow forever.
+ *
+ * Seeks (used by some muxers to rewrite the headers on finalization) are
+ * handled by tagging each chunk with its offset in the file, so they never
+ * block the muxer.
+ */
+
+struct sc_recorder_chunk {
+    uint8_t *data;
+    size_t size;
+    int64_t offset;
+};
+
+struct sc_recorder_chunk_queue SC_VECDEQUE(struct sc_recorder_chunk);
+
+struct sc_recorder_writer_stats {
+    uint64_t bytes_written;
+    size_t max_queued_bytes;
+    // number of times the muxer had to wait for the writer thread
+    unsigned stalls;
+    sc_tick stall_duration;
+    sc_tick max_write_duration;
+};
+
+struct sc_recorder_writer {
+    // AVIOContext to pass to the muxer (AVFormatContext.pb)
+    AVIOContext *avio;
+
+    // Accessed only from the muxer thread
+    int64_t pos;
+    int64_t size;
+
+    // Accessed only from the writer thread
+    AVIOContext *file;
+    int64_t file_pos;
+
+    sc_thread thread;
+    sc_mutex mutex;
+    sc_cond cond;
+
+    struct sc_recorder_chunk_queue queue;
+    size_t queued_bytes;
+    bool stopped;
+    bool error;
+
+    struct sc_recorder_writer_stats stats;
+};
+
+/**
+ * Open the file and start the writer thread
+ */
+bool
+sc_recorder_writer_open(struct sc_recorder_writer *writer,
+                        const char *filename);
+
+/**
+ * Flush the pending data, stop the writer thread and close the file
+ *
+ * Return false if any write failed.
+ */
+bool
+sc_recorder_writer_close(struct sc_recorder_writer *writer);
+
+#endif
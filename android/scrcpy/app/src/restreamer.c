@@ -0,0 +1,571 @@
+#include "restreamer.h"
+
+#include <assert.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+
+#include "packet_merger.h"
+#include "util/log.h"
+
+/** Downcast packet sinks to restreamer */
+#define DOWNCAST_VIDEO(SINK) \
+    container_of(SINK, struct sc_restreamer, video_packet_sink)
+#define DOWNCAST_AUDIO(SINK) \
+    container_of(SINK, struct sc_restreamer, audio_packet_sink)
+
+// Maximum number of packets waiting to be sent (about 1 second)
+#define SC_RESTREAMER_QUEUE_SIZE 128
+
+static const AVRational SCRCPY_TIME_BASE = {1, 1000000}; // timestamps in us
+
+static const char *
+sc_restreamer_get_format_name(enum sc_restream_format format) {
+    switch (format) {
+        case SC_RESTREAM_FORMAT_MPEGTS:
+            return "mpegts";
+        case SC_RESTREAM_FORMAT_MP4:
+            return "mp4";
+        default:
+            return NULL;
+    }
+}
+
+static void
+sc_restreamer_queue_clear(struct sc_restreamer_queue *queue) {
+    while (!sc_vecdeque_is_empty(queue)) {
+        AVPacket *p = sc_vecdeque_pop(queue);
+        av_packet_free(&p);
+    }
+}
+
+static int
+sc_restreamer_interrupt_cb(void *opaque) {
+    struct sc_restreamer *restreamer = opaque;
+    return atomic_load_explicit(&restreamer->interrupted, memory_order_relaxed);
+}
+
+static bool
+sc_restreamer_set_extradata(AVStream *ostream, const AVPacket *packet) {
+    uint8_t *extradata =
+        av_mallocz(packet->size + AV_INPUT_BUFFER_PADDING_SIZE);
+    if (!extradata) {
+        LOG_OOM();
+        return false;
+    }
+
+    // copy the config packet to the extra data
+    memcpy(extradata, packet->data, packet->size);
+
+    av_freep(&ostream->codecpar->extradata);
+    ostream->codecpar->extradata = extradata;
+    ostream->codecpar->extradata_size = packet->size;
+    return true;
+}
+
+static bool
+sc_restreamer_is_ready(struct sc_restreamer *restreamer) {
+    sc_mutex_assert(&restreamer->mutex);
+
+    if (restreamer->video
+            && (!restreamer->video_init || !restreamer->video_config)) {
+        return false;
+    }
+
+    if (restreamer->audio
+            && (!restreamer->audio_init
+                || (restreamer->audio_expects_config_packet
+                    && !restreamer->audio_config))) {
+        return false;
+    }
+
+    return true;
+}
+
+static bool
+sc_restreamer_write_header(struct sc_restreamer *restreamer) {
+    AVDictionary *opts = NULL;
+    if (restreamer->format == SC_RESTREAM_FORMAT_MP4) {
+        // The output is not seekable, write a fragmented MP4
+        av_dict_set(&opts, "movflags",
+                    "empty_moov+default_base_moof+frag_keyframe", 0);
+    }
+
+    int ret = avformat_write_header(restreamer->ctx, &opts);
+    av_dict_free(&opts);
+    if (ret < 0) {
+        LOGE("Failed to write header to %s", restreamer->url);
+        return false;
+    }
+
+    return true;
+}
+
+static bool
+sc_restreamer_write(struct sc_restreamer *restreamer, AVPacket *packet,
+                    int64_t *pts_origin, int64_t last_pts[2]) {
+    bool video = packet->stream_index == restreamer->video_index;
+
+    if (video && !sc_packet_merger_inline_config(packet)) {
+        return false;
+    }
+
+    if (*pts_origin == AV_NOPTS_VALUE) {
+        if (restreamer->video && !video) {
+            // Start the stream on the first video packet (a key frame)
+            return true;
+        }
+        *pts_origin = packet->pts;
+    }
+
+    if (packet->pts < *pts_origin) {
+        // An audio packet older than the first video packet
+        return true;
+    }
+
+    packet->pts -= *pts_origin;
+    packet->dts = packet->pts;
+
+    AVStream *stream = restreamer->ctx->streams[packet->stream_index];
+    av_packet_rescale_ts(packet, SCRCPY_TIME_BASE, stream->time_base);
+
+    int64_t *last = &last_pts[video ? 0 : 1];
+    if (*last != AV_NOPTS_VALUE && packet->pts <= *last) {
+        // The muxer requires strictly increasing timestamps
+        packet->pts = ++*last;
+        packet->dts = packet->pts;
+    } else {
+        *last = packet->pts;
+    }
+
+    // The packets are received in real time, they are already interleaved
+    if (av_write_frame(restreamer->ctx, packet) < 0) {
+        LOGE("Could not send packet to %s", restreamer->url);
+        return false;
+    }
+
+    return true;
+}
+
+static bool
+sc_restreamer_process_packets(struct sc_restreamer *restreamer) {
+    sc_mutex_lock(&restreamer->mutex);
+    while (!restreamer->stopped && !sc_restreamer_is_ready(restreamer)) {
+        sc_cond_wait(&restreamer->cond, &restreamer->mutex);
+    }
+    bool stopped = restreamer->stopped;
+    sc_mutex_unlock(&restreamer->mutex);
+
+    if (stopped) {
+        // Stopped before the stream could start
+        return true;
+    }
+
+    if (!sc_restreamer_write_header(restreamer)) {
+        return false;
+    }
+
+    int64_t pts_origin = AV_NOPTS_VALUE;
+    int64_t last_pts[2] = {AV_NOPTS_VALUE, AV_NOPTS_VALUE};
+    bool error = false;
+
+    for (;;) {
+        sc_mutex_lock(&restreamer->mutex);
+        while (!restreamer->stopped
+                && sc_vecdeque_is_empty(&restreamer->queue)) {
+            sc_cond_wait(&restreamer->cond, &restreamer->mutex);
+        }
+
+        if (restreamer->stopped) {
+            // This is a live stream, the pending packets are discarded
+            sc_mutex_unlock(&restreamer->mutex);
+            break;
+        }
+
+        AVPacket *packet = sc_vecdeque_pop(&restreamer->queue);
+        sc_mutex_unlock(&restreamer->mutex);
+
+        bool ok = sc_restreamer_write(restreamer, packet, &pts_origin,
+                                      last_pts);
+        av_packet_free(&packet);
+        if (!ok) {
+            error = true;
+            break;
+        }
+    }
+
+    if (!error) {
+        av_write_trailer(restreamer->ctx);
+    }
+
+    return !error;
+}
+
+static bool
+sc_restreamer_stream(struct sc_restreamer *restreamer) {
+    AVFormatContext *ctx = restreamer->ctx;
+    int ret = avio_open2(&ctx->pb, restreamer->url, AVIO_FLAG_WRITE,
+                         &ctx->interrupt_callback, NULL);
+    if (ret < 0) {
+        LOGE("Failed to open restream output: %s", restreamer->url);
+        return false;
+    }
+
+    LOGI("Restreaming started to %s", restreamer->url);
+
+    bool ok = sc_restreamer_process_packets(restreamer);
+    avio_closep(&ctx->pb);
+    return ok;
+}
+
+static int
+run_restreamer(void *data) {
+    struct sc_restreamer *restreamer = data;
+
+    bool success = sc_restreamer_stream(restreamer);
+
+    sc_mutex_lock(&restreamer->mutex);
+    // Prevent the producers to push any new packet
+    restreamer->stopped = true;
+    // Discard pending packets
+    sc_restreamer_queue_clear(&restreamer->queue);
+    uint64_t dropped = restreamer->dropped;
+    sc_mutex_unlock(&restreamer->mutex);
+
+    if (dropped) {
+        LOGI("Restreaming: %" PRIu64_ " packets dropped", dropped);
+    }
+
+    if (success) {
+        LOGI("Restreaming complete to %s", restreamer->url);
+    } else {
+        LOGE("Restreaming failed to %s", restreamer->url);
+    }
+
+    LOGD("Restreamer thread ended");
+
+    restreamer->cbs->on_ended(restreamer, success, restreamer->cbs_userdata);
+
+    return 0;
+}
+
+static bool
+sc_restreamer_open_stream(struct sc_restreamer *restreamer,
+                          AVCodecContext *ctx, bool video) {
+    sc_mutex_lock(&restreamer->mutex);
+    if (restreamer->stopped) {
+        sc_mutex_unlock(&restreamer->mutex);
+        return false;
+    }
+
+    AVStream *stream = avformat_new_stream(restreamer->ctx, ctx->codec);
+    if (!stream) {
+        sc_mutex_unlock(&restreamer->mutex);
+        return false;
+    }
+
+    int r = avcodec_parameters_from_context(stream->codecpar, ctx);
+    if (r < 0) {
+        sc_mutex_unlock(&restreamer->mutex);
+        return false;
+    }
+
+    if (video) {
+        restreamer->video_index = stream->index;
+        restreamer->video_init = true;
+    } else {
+        restreamer->audio_index = stream->index;
+        // A config packet is provided for all supported formats except raw
+        // audio
+        restreamer->audio_expects_config_packet =
+            ctx->codec_id != AV_CODEC_ID_PCM_S16LE;
+        restreamer->audio_init = true;
+    }
+
+    sc_cond_signal(&restreamer->cond);
+    sc_mutex_unlock(&restreamer->mutex);
+
+    return true;
+}
+
+static bool
+sc_restreamer_video_packet_sink_open(struct sc_packet_sink *sink,
+                                     AVCodecContext *ctx) {
+    return sc_restreamer_open_stream(DOWNCAST_VIDEO(sink), ctx, true);
+}
+
+static bool
+sc_restreamer_audio_packet_sink_open(struct sc_packet_sink *sink,
+                                     AVCodecContext *ctx) {
+    return sc_restreamer_open_stream(DOWNCAST_AUDIO(sink), ctx, false);
+}
+
+static void
+sc_restreamer_packet_sink_close(struct sc_restreamer *restreamer) {
+    sc_mutex_lock(&restreamer->mutex);
+    // EOS also stops the restreamer
+    restreamer->stopped = true;
+    sc_cond_signal(&restreamer->cond);
+    sc_mutex_unlock(&restreamer->mutex);
+}
+
+static void
+sc_restreamer_video_packet_sink_close(struct sc_packet_sink *sink) {
+    sc_restreamer_packet_sink_close(DOWNCAST_VIDEO(sink));
+}
+
+static void
+sc_restreamer_audio_packet_sink_close(struct sc_packet_sink *sink) {
+    sc_restreamer_packet_sink_close(DOWNCAST_AUDIO(sink));
+}
+
+static bool
+sc_restreamer_push(struct sc_restreamer *restreamer, const AVPacket *packet,
+                   bool video) {
+    sc_mutex_lock(&restreamer->mutex);
+
+    if (restreamer->stopped) {
+        // reject any new packet
+        sc_mutex_unlock(&restreamer->mutex);
+        return false;
+    }
+
+    int index = video ? restreamer->video_index : restreamer->audio_index;
+
+    if (packet->pts == AV_NOPTS_VALUE) {
+        // Only the first config packet is used for the extradata. The next
+        // ones are attached to the following media packet (by the packet
+        // merger) and inlined by the restreamer thread.
+        bool *config = video ? &restreamer->video_config
+                             : &restreamer->audio_config;
+        if (!*config) {
+            AVStream *stream = restreamer->ctx->streams[index];
+            if (!sc_restreamer_set_extradata(stream, packet)) {
+                sc_mutex_unlock(&restreamer->mutex);
+                return false;
+            }
+            *config = true;
+            sc_cond_signal(&restreamer->cond);
+        }
+
+        sc_mutex_unlock(&restreamer->mutex);
+        return true;
+    }
+
+    bool key_frame = packet->flags & AV_PKT_FLAG_KEY;
+
+    if (video && restreamer->wait_key_frame) {
+        if (!key_frame) {
+            ++restreamer->dropped;
+            sc_mutex_unlock(&restreamer->mutex);
+            return true;
+        }
+        restreamer->wait_key_frame = false;
+    }
+
+    if (sc_vecdeque_size(&restreamer->queue) == SC_RESTREAMER_QUEUE_SIZE) {
+        // The network does not keep up
+        if (!restreamer->dropped) {
+            LOGW("Restreaming too slow, dropping packets");
+        }
+
+        if (video && key_frame) {
+            // Restart from this key frame, the pending packets are stale
+            restreamer->dropped += sc_vecdeque_size(&restreamer->queue);
+            sc_restreamer_queue_clear(&restreamer->queue);
+        } else {
+            ++restreamer->dropped;
+            if (video) {
+                // The next video packets could not be decoded
+                restreamer->wait_key_frame = true;
+            }
+            sc_mutex_unlock(&restreamer->mutex);
+            return true;
+        }
+    }
+
+    AVPacket *p = av_packet_alloc();
+    if (!p) {
+        LOG_OOM();
+        sc_mutex_unlock(&restreamer->mutex);
+        return false;
+    }
+
+    if (av_packet_ref(p, packet)) {
+        LOG_OOM();
+        av_packet_free(&p);
+        sc_mutex_unlock(&restreamer->mutex);
+        return false;
+    }
+
+    p->stream_index = index;
+
+    // The capacity has been reserved on init
+    sc_vecdeque_push_noresize(&restreamer->queue, p);
+    sc_cond_signal(&restreamer->cond);
+
+    sc_mutex_unlock(&restreamer->mutex);
+    return true;
+}
+
+static bool
+sc_restreamer_video_packet_sink_push(struct sc_packet_sink *sink,
+                                     const AVPacket *packet) {
+    return sc_restreamer_push(DOWNCAST_VIDEO(sink), packet, true);
+}
+
+static bool
+sc_restreamer_audio_packet_sink_push(struct sc_packet_sink *sink,
+                                     const AVPacket *packet) {
+    return sc_restreamer_push(DOWNCAST_AUDIO(sink), packet, false);
+}
+
+static void
+sc_restreamer_audio_packet_sink_disable(struct sc_packet_sink *sink) {
+    struct sc_restreamer *restreamer = DOWNCAST_AUDIO(sink);
+
+    LOGW("Audio stream restreaming disabled");
+
+    sc_mutex_lock(&restreamer->mutex);
+    restreamer->audio = false;
+    restreamer->audio_init = true;
+    sc_cond_signal(&restreamer->cond);
+    sc_mutex_unlock(&restreamer->mutex);
+}
+
+bool
+sc_restreamer_init(struct sc_restreamer *restreamer, const char *url,
+                   enum sc_restream_format format, bool video, bool audio,
+                   const struct sc_restreamer_callbacks *cbs,
+                   void *cbs_userdata) {
+    assert(video || audio);
+
+    restreamer->url = strdup(url);
+    if (!restreamer->url) {
+        LOG_OOM();
+        return false;
+    }
+
+    const char *format_name = sc_restreamer_get_format_name(format);
+    assert(format_name);
+
+    restreamer->ctx = NULL;
+    int r = avformat_alloc_output_context2(&restreamer->ctx, NULL, format_name,
+                                           NULL);
+    if (r < 0) {
+        LOGE("Could not find muxer: %s", format_name);
+        goto error_free_url;
+    }
+
+    restreamer->ctx->interrupt_callback.callback = sc_restreamer_interrupt_cb;
+    restreamer->ctx->interrupt_callback.opaque = restreamer;
+
+    bool ok = sc_mutex_init(&restreamer->mutex);
+    if (!ok) {
+        goto error_free_context;
+    }
+
+    ok = sc_cond_init(&restreamer->cond);
+    if (!ok) {
+        goto error_mutex_destroy;
+    }
+
+    sc_vecdeque_init(&restreamer->queue);
+    if (!sc_vecdeque_reserve(&restreamer->queue, SC_RESTREAMER_QUEUE_SIZE)) {
+        LOG_OOM();
+        goto error_cond_destroy;
+    }
+
+    restreamer->video = video;
+    restreamer->audio = audio;
+    restreamer->format = format;
+    restreamer->stopped = false;
+    atomic_init(&restreamer->interrupted, false);
+
+    restreamer->video_init = false;
+    restreamer->audio_init = false;
+    restreamer->video_config = false;
+    restreamer->audio_config = false;
+    restreamer->audio_expects_config_packet = false;
+
+    restreamer->video_index = -1;
+    restreamer->audio_index = -1;
+
+    restreamer->wait_key_frame = false;
+    restreamer->dropped = 0;
+
+    assert(cbs && cbs->on_ended);
+    restreamer->cbs = cbs;
+    restreamer->cbs_userdata = cbs_userdata;
+
+    if (video) {
+        static const struct sc_packet_sink_ops video_ops = {
+            .open = sc_restreamer_video_packet_sink_open,
+            .close = sc_restreamer_video_packet_sink_close,
+            .push = sc_restreamer_video_packet_sink_push,
+        };
+
+        restreamer->video_packet_sink.ops = &video_ops;
+    }
+
+    if (audio) {
+        static const struct sc_packet_sink_ops audio_ops = {
+            .open = sc_restreamer_audio_packet_sink_open,
+            .close = sc_restreamer_audio_packet_sink_close,
+            .push = sc_restreamer_audio_packet_sink_push,
+            .disable = sc_restreamer_audio_packet_sink_disable,
+        };
+
+        restreamer->audio_packet_sink.ops = &audio_ops;
+    }
+
+    return true;
+
+error_cond_destroy:
+    sc_cond_destroy(&restreamer->cond);
+error_mutex_destroy:
+    sc_mutex_destroy(&restreamer->mutex);
+error_free_context:
+    avformat_free_context(restreamer->ctx);
+error_free_url:
+    free(restreamer->url);
+
+    return false;
+}
+
+bool
+sc_restreamer_start(struct sc_restreamer *restreamer) {
+    bool ok = sc_thread_create(&restreamer->thread, run_restreamer,
+                               "scrcpy-restream", restreamer);
+    if (!ok) {
+        LOGE("Could not start restreamer thread");
+        return false;
+    }
+
+    return true;
+}
+
+void
+sc_restreamer_stop(struct sc_restreamer *restreamer) {
+    sc_mutex_lock(&restreamer->mutex);
+    restreamer->stopped = true;
+    atomic_store_explicit(&restreamer->interrupted, true, memory_order_relaxed);
+    sc_cond_signal(&restreamer->cond);
+    sc_mutex_unlock(&restreamer->mutex);
+}
+
+void
+sc_restreamer_join(struct sc_restreamer *restreamer) {
+    sc_thread_join(&restreamer->thread, NULL);
+}
+
+void
+sc_restreamer_destroy(struct sc_restreamer *restreamer) {
+    sc_vecdeque_destroy(&restreamer->queue);
+    sc_cond_destroy(&restreamer->cond);
+    sc_mutex_destroy(&restreamer->mutex);
+    avformat_free_context(restreamer->ctx);
+    free(restreamer->url);
+}
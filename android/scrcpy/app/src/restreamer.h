@@ -0,0 +1,92 @@
+#ifndef SC_RESTREAMER_H
+#define SC_RESTREAMER_H
+
+#include "common.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <libavcodec/packet.h>
+#include <libavformat/avformat.h>
+
+#include "options.h"
+#include "trait/packet_sink.h"
+#include "util/thread.h"
+#include "util/vecdeque.h"
+
+/**
+ * Packet sink muxing the video and audio streams (without decoding them) to a
+ * network endpoint (any URL supported by FFmpeg, e.g. tcp://, udp:// or
+ * srt://), for live restreaming.
+ *
+ * The packets are sent from a separate thread, through a bounded queue. If the
+ * network does not keep up, the packets are dropped, until the next video key
+ * frame.
+ */
+
+struct sc_restreamer_queue SC_VECDEQUE(AVPacket *);
+
+struct sc_restreamer {
+    struct sc_packet_sink video_packet_sink;
+    struct sc_packet_sink audio_packet_sink;
+
+    // The audio flag may be reset once from the audio demuxer thread if the
+    // audio is disabled dynamically (protected by the mutex)
+    bool audio;
+    bool video;
+
+    char *url;
+    enum sc_restream_format format;
+    AVFormatContext *ctx;
+
+    sc_thread thread;
+    sc_mutex mutex;
+    sc_cond cond;
+    // set on sc_restreamer_stop(), packet_sink close or streaming failure
+    bool stopped;
+    // interrupt the blocking network I/O
+    atomic_bool interrupted;
+    struct sc_restreamer_queue queue;
+
+    // wake up the restreamer thread once the codecs and configs are known
+    bool video_init;
+    bool audio_init;
+    bool video_config;
+    bool audio_config;
+    bool audio_expects_config_packet;
+
+    int video_index;
+    int audio_index;
+
+    // drop the video packets until the next key frame
+    bool wait_key_frame;
+    uint64_t dropped;
+
+    const struct sc_restreamer_callbacks *cbs;
+    void *cbs_userdata;
+};
+
+struct sc_restreamer_callbacks {
+    void (*on_ended)(struct sc_restreamer *restreamer, bool success,
+                     void *userdata);
+};
+
+bool
+sc_restreamer_init(struct sc_restreamer *restreamer, const char *url,
+                   enum sc_restream_format format, bool video, bool audio,
+                   const struct sc_restreamer_callbacks *cbs,
+                   void *cbs_userdata);
+
+bool
+sc_restreamer_start(struct sc_restreamer *restreamer);
+
+void
+sc_restreamer_stop(struct sc_restreamer *restreamer);
+
+void
+sc_restreamer_join(struct sc_restreamer *restreamer);
+
+void
+sc_restreamer_destroy(struct sc_restreamer *restreamer);
+
+#endif
@@ -14,18 +14,28 @@
 # include <windows.h>
 #endif
 
+#include "archiver.h"
 #include "audio_player.h"
+#include "congestion_controller.h"
 #include "controller.h"
 #include "decoder.h"
 #include "delay_buffer.h"
 #include "demuxer.h"
 #include "events.h"
 #include "file_pusher.h"
+#include "frame_transform.h"
+#include "icon.h"
 #include "keyboard_sdk.h"
+#include "latency_tracer.h"
+#include "memory_budget.h"
 #include "mouse_sdk.h"
 #include "recorder.h"
+#include "restreamer.h"
 #include "screen.h"
 #include "server.h"
+#include "snapshot.h"
+#include "stats.h"
+#include "stats_server.h"
 #include "uhid/gamepad_uhid.h"
 #include "uhid/keyboard_uhid.h"
 #include "uhid/mouse_uhid.h"
@@ -40,7 +50,9 @@
 #include "util/log.h"
 #include "util/rand.h"
 #include "util/timeout.h"
+#include "util/thread.h"
 #include "util/tick.h"
+#include "util/yuv.h"
 #ifdef HAVE_V4L2
 # include "v4l2_sink.h"
 #endif
@@ -54,13 +66,24 @@ struct scrcpy {
     struct sc_decoder video_decoder;
     struct sc_decoder audio_decoder;
     struct sc_recorder recorder;
+    struct sc_restreamer restreamer;
     struct sc_delay_buffer video_buffer;
+    struct sc_archiver archiver;
+    struct sc_frame_transform archive_transform;
+    struct sc_snapshot snapshot;
+    // secondary display (--extra-display-id), view-only
+    struct sc_demuxer extra_video_demuxer;
+    struct sc_decoder extra_video_decoder;
+    struct sc_screen extra_screen;
 #ifdef HAVE_V4L2
     struct sc_v4l2_sink v4l2_sink;
     struct sc_delay_buffer v4l2_buffer;
+    struct sc_frame_transform v4l2_transform;
 #endif
     struct sc_controller controller;
+    struct sc_congestion_controller congestion_controller;
     struct sc_file_pusher file_pusher;
+    struct scrcpy_icon_loader icon_loader;
 #ifdef HAVE_USB
     struct sc_usb usb;
     struct sc_aoa aoa;
@@ -89,6 +112,7 @@ struct scrcpy {
 #endif
     };
     struct sc_timeout timeout;
+    struct sc_stats_server stats_server;
 };
 
 #ifdef _WIN32
@@ -175,10 +199,38 @@ sdl_configure(bool video_playback, bool disable_screensaver) {
     }
 }
 
+// Return the id of the window targeted by the event, or 0 if none
+static uint32_t
+get_event_window_id(const SDL_Event *event) {
+    switch (event->type) {
+        case SDL_WINDOWEVENT:
+            return event->window.windowID;
+        case SDL_KEYDOWN:
+        case SDL_KEYUP:
+            return event->key.windowID;
+        case SDL_TEXTINPUT:
+            return event->text.windowID;
+        case SDL_MOUSEMOTION:
+            return event->motion.windowID;
+        case SDL_MOUSEBUTTONDOWN:
+        case SDL_MOUSEBUTTONUP:
+            return event->button.windowID;
+        case SDL_MOUSEWHEEL:
+            return event->wheel.windowID;
+        case SDL_DROPFILE:
+            return event->drop.windowID;
+        default:
+            return 0;
+    }
+}
+
 static enum scrcpy_exit_code
-event_loop(struct scrcpy *s, bool has_screen) {
+event_loop(struct scrcpy *s, bool has_screen, bool has_extra_screen) {
+    uint32_t extra_window_id =
+        has_extra_screen ? SDL_GetWindowID(s->extra_screen.window) : 0;
+
     SDL_Event event;
-    while (SDL_WaitEvent(&event)) {
+    while (sc_events_wait(&event)) {
         switch (event.type) {
             case SC_EVENT_DEVICE_DISCONNECTED:
                 LOGW("Device disconnected");
@@ -192,6 +244,9 @@ event_loop(struct scrcpy *s, bool has_screen) {
             case SC_EVENT_RECORDER_ERROR:
                 LOGE("Recorder error");
                 return SCRCPY_EXIT_FAILURE;
+            case SC_EVENT_RESTREAMER_ERROR:
+                LOGE("Restreamer error");
+                return SCRCPY_EXIT_FAILURE;
             case SC_EVENT_AOA_OPEN_ERROR:
                 LOGE("AOA open error");
                 return SCRCPY_EXIT_FAILURE;
@@ -207,11 +262,45 @@ event_loop(struct scrcpy *s, bool has_screen) {
                 run(userdata);
                 break;
             }
-            default:
-                if (has_screen && !sc_screen_handle_event(&s->screen, &event)) {
+            case SC_EVENT_NEW_FRAME:
+            case SC_EVENT_SCREEN_INIT_SIZE:
+            case SC_EVENT_PRESENT_FRAME:
+            case SC_EVENT_SCREEN_FRAME_SIZE:
+            case SC_EVENT_SCREEN_RENDER_ERROR: {
+                // These events are posted by the screen to itself
+                struct sc_screen *screen = event.user.data1;
+                assert(screen);
+                if (!sc_screen_handle_event(screen, &event)) {
                     return SCRCPY_EXIT_FAILURE;
                 }
                 break;
+            }
+            default: {
+                if (!has_screen) {
+                    break;
+                }
+
+                struct sc_screen *screen = &s->screen;
+                if (has_extra_screen) {
+                    if (event.type == SDL_WINDOWEVENT
+                            && event.window.event == SDL_WINDOWEVENT_CLOSE) {
+                        // SDL_QUIT is only posted once the last window is
+                        // closed, but closing any window ends the session
+                        LOGD("User requested to quit");
+                        return SCRCPY_EXIT_SUCCESS;
+                    }
+
+                    uint32_t window_id = get_event_window_id(&event);
+                    if (window_id && window_id == extra_window_id) {
+                        screen = &s->extra_screen;
+                    }
+                }
+
+                if (!sc_screen_handle_event(screen, &event)) {
+                    return SCRCPY_EXIT_FAILURE;
+                }
+                break;
+            }
         }
     }
     return SCRCPY_EXIT_FAILURE;
@@ -222,7 +311,7 @@ terminate_event_loop(void) {
     sc_reject_new_runnables();
 
     SDL_Event event;
-    while (SDL_PollEvent(&event)) {
+    while (sc_events_poll(&event)) {
         if (event.type == SC_EVENT_RUN_ON_MAIN_THREAD) {
             // Make sure all posted runnables are run, to avoid memory leaks
             sc_runnable_fn run = event.user.data1;
@@ -236,7 +325,7 @@ terminate_event_loop(void) {
 static bool
 await_for_server(bool *connected) {
     SDL_Event event;
-    while (SDL_WaitEvent(&event)) {
+    while (sc_events_wait(&event)) {
         switch (event.type) {
             case SDL_QUIT:
                 if (connected) {
@@ -270,6 +359,17 @@ sc_recorder_on_ended(struct sc_recorder *recorder, bool success,
     }
 }
 
+static void
+sc_restreamer_on_ended(struct sc_restreamer *restreamer, bool success,
+                       void *userdata) {
+    (void) restreamer;
+    (void) userdata;
+
+    if (!success) {
+        sc_push_event(SC_EVENT_RESTREAMER_ERROR);
+    }
+}
+
 static void
 sc_video_demuxer_on_ended(struct sc_demuxer *demuxer,
                           enum sc_demuxer_status status, void *userdata) {
@@ -286,6 +386,90 @@ sc_video_demuxer_on_ended(struct sc_demuxer *demuxer,
     }
 }
 
+static void
+task_request_keyframe(void *userdata) {
+    struct sc_controller *controller = userdata;
+
+    struct sc_control_msg msg;
+    msg.type = SC_CONTROL_MSG_TYPE_RESET_VIDEO;
+
+    if (!sc_controller_push_msg(controller, &msg)) {
+        LOGW("Could not request a keyframe");
+    }
+}
+
+static sc_socket
+sc_video_demuxer_on_disconnected(struct sc_demuxer *demuxer, sc_socket socket,
+                                 void *userdata) {
+    (void) userdata;
+
+    struct scrcpy *s = container_of(demuxer, struct scrcpy, video_demuxer);
+
+    sc_socket new_socket =
+        sc_server_resume(&s->server, SC_SERVER_STREAM_VIDEO, socket);
+    if (new_socket != SC_SOCKET_NONE && s->server.params.control) {
+        // The device encoder kept running, the next packets may reference
+        // frames lost during the disconnection.
+        // The controller msgs are pushed from the main thread.
+        bool ok = sc_post_to_main_thread(task_request_keyframe,
+                                         &s->controller);
+        if (!ok) {
+            LOGW("Could not post keyframe request");
+        }
+    }
+
+    return new_socket;
+}
+
+static void
+sc_video_decoder_on_resync(struct sc_decoder *decoder, void *userdata) {
+    (void) userdata;
+
+    struct scrcpy *s = container_of(decoder, struct scrcpy, video_decoder);
+
+    // The controller msgs are pushed from the main thread
+    bool ok = sc_post_to_main_thread(task_request_keyframe, &s->controller);
+    if (!ok) {
+        LOGW("Could not post keyframe request");
+    }
+}
+
+static void
+sc_video_packet_source_on_drop(struct sc_packet_source *source,
+                               void *userdata) {
+    (void) userdata;
+
+    struct scrcpy *s =
+        container_of(source, struct scrcpy, video_demuxer.packet_source);
+
+    // The controller msgs are pushed from the main thread
+    bool ok = sc_post_to_main_thread(task_request_keyframe, &s->controller);
+    if (!ok) {
+        LOGW("Could not post keyframe request");
+    }
+}
+
+static sc_socket
+sc_extra_video_demuxer_on_disconnected(struct sc_demuxer *demuxer,
+                                       sc_socket socket, void *userdata) {
+    (void) userdata;
+
+    // The key frame is requested by the main video demuxer, which is
+    // necessarily disconnected too
+    struct scrcpy *s =
+        container_of(demuxer, struct scrcpy, extra_video_demuxer);
+    return sc_server_resume(&s->server, SC_SERVER_STREAM_EXTRA_VIDEO, socket);
+}
+
+static sc_socket
+sc_audio_demuxer_on_disconnected(struct sc_demuxer *demuxer, sc_socket socket,
+                                 void *userdata) {
+    (void) userdata;
+
+    struct scrcpy *s = container_of(demuxer, struct scrcpy, audio_demuxer);
+    return sc_server_resume(&s->server, SC_SERVER_STREAM_AUDIO, socket);
+}
+
 static void
 sc_audio_demuxer_on_ended(struct sc_demuxer *demuxer,
                           enum sc_demuxer_status status, void *userdata) {
@@ -319,6 +503,15 @@ sc_controller_on_ended(struct sc_controller *controller, bool error,
     }
 }
 
+static sc_socket
+sc_controller_on_disconnected(struct sc_controller *controller,
+                              sc_socket socket, void *userdata) {
+    (void) userdata;
+
+    struct scrcpy *s = container_of(controller, struct scrcpy, controller);
+    return sc_server_resume(&s->server, SC_SERVER_STREAM_CONTROL, socket);
+}
+
 static void
 sc_server_on_connection_failed(struct sc_server *server, void *userdata) {
     (void) server;
@@ -362,6 +555,36 @@ scrcpy_generate_scid(void) {
     return sc_rand_u32(&rand) & 0x7FFFFFFF;
 }
 
+static void
+configure_thread_policies(enum sc_thread_profile profile,
+                          const struct sc_thread_affinity *affinity) {
+    bool latency = profile != SC_THREAD_PROFILE_DEFAULT;
+    bool realtime = profile == SC_THREAD_PROFILE_REALTIME;
+
+    struct sc_thread_policy policy = {
+        .set_priority = latency,
+        .priority = SC_THREAD_PRIORITY_HIGH,
+        .realtime = realtime,
+        .affinity = affinity->video,
+    };
+    sc_thread_set_policy(SC_THREAD_ROLE_VIDEO, &policy);
+
+    policy.affinity = affinity->audio;
+    sc_thread_set_policy(SC_THREAD_ROLE_AUDIO, &policy);
+
+    // The control threads mostly wait for the socket, so a higher priority
+    // is sufficient
+    policy.realtime = false;
+    policy.affinity = affinity->control;
+    sc_thread_set_policy(SC_THREAD_ROLE_CONTROL, &policy);
+
+    // The recording must never preempt the playback
+    policy.set_priority = true;
+    policy.priority = SC_THREAD_PRIORITY_LOW;
+    policy.affinity = affinity->recording;
+    sc_thread_set_policy(SC_THREAD_ROLE_RECORDING, &policy);
+}
+
 static void
 init_sdl_gamepads(void) {
     // Trigger a SDL_CONTROLLERDEVICEADDED event for all gamepads already
@@ -386,13 +609,49 @@ scrcpy(struct scrcpy_options *options) {
 #endif
     struct scrcpy *s = &scrcpy;
 
-    // Minimal SDL initialization
-    if (SDL_Init(SDL_INIT_EVENTS)) {
-        LOGE("Could not initialize SDL: %s", SDL_GetError());
-        return SCRCPY_EXIT_FAILURE;
+    // Without window, playback, gamepads and clipboard synchronization,
+    // nothing requires SDL: run the headless engine (socket -> demuxer ->
+    // recorder/restreamer/V4L2) without initializing it
+    bool headless = !options->window && !options->video_playback
+                 && !options->audio_playback
+                 && options->gamepad_input_mode
+                        == SC_GAMEPAD_INPUT_MODE_DISABLED
+                 && !(options->control && options->clipboard_autosync);
+
+    if (headless) {
+        if (!sc_events_init_headless()) {
+            return SCRCPY_EXIT_FAILURE;
+        }
+        LOGD("Headless mode: SDL not initialized");
+    } else {
+        // Minimal SDL initialization
+        if (SDL_Init(SDL_INIT_EVENTS)) {
+            LOGE("Could not initialize SDL: %s", SDL_GetError());
+            return SCRCPY_EXIT_FAILURE;
+        }
+
+        atexit(SDL_Quit);
     }
 
-    atexit(SDL_Quit);
+    if (options->latency_stats) {
+        const char *file = *options->latency_stats ? options->latency_stats
+                                                   : NULL;
+        if (!sc_latency_tracer_enable(file)) {
+            return SCRCPY_EXIT_FAILURE;
+        }
+    }
+
+    // Must be configured before any thread is started
+    configure_thread_policies(options->thread_profile,
+                              &options->thread_affinity);
+
+    // Start counting the session statistics
+    sc_stats_init();
+    sc_memory_budget_init(options->memory_budget);
+
+    // Select the pixel conversion kernels for the current CPU
+    sc_yuv_init();
+    LOGD("YUV conversion: %s", sc_yuv_get_impl_name());
 
     enum scrcpy_exit_code ret = SCRCPY_EXIT_FAILURE;
 
@@ -400,11 +659,16 @@ scrcpy(struct scrcpy_options *options) {
     bool file_pusher_initialized = false;
     bool recorder_initialized = false;
     bool recorder_started = false;
+    bool restreamer_initialized = false;
+    bool restreamer_started = false;
 #ifdef HAVE_V4L2
     bool v4l2_sink_initialized = false;
 #endif
+    bool archiver_initialized = false;
+    bool snapshot_initialized = false;
     bool video_demuxer_started = false;
     bool audio_demuxer_started = false;
+    bool extra_video_demuxer_started = false;
 #ifdef HAVE_USB
     bool aoa_hid_initialized = false;
     bool keyboard_aoa_initialized = false;
@@ -413,9 +677,13 @@ scrcpy(struct scrcpy_options *options) {
 #endif
     bool controller_initialized = false;
     bool controller_started = false;
+    bool icon_loader_started = false;
     bool screen_initialized = false;
+    bool extra_screen_initialized = false;
     bool timeout_initialized = false;
     bool timeout_started = false;
+    bool stats_server_initialized = false;
+    bool stats_server_started = false;
 
     struct sc_acksync *acksync = NULL;
 
@@ -436,6 +704,7 @@ scrcpy(struct scrcpy_options *options) {
         .port_range = options->port_range,
         .tunnel_host = options->tunnel_host,
         .tunnel_port = options->tunnel_port,
+        .socket_profile = options->socket_profile,
         .max_size = options->max_size,
         .video_bit_rate = options->video_bit_rate,
         .audio_bit_rate = options->audio_bit_rate,
@@ -446,6 +715,7 @@ scrcpy(struct scrcpy_options *options) {
         .capture_orientation_lock = options->capture_orientation_lock,
         .control = options->control,
         .display_id = options->display_id,
+        .extra_display_id = options->extra_display_id,
         .new_display = options->new_display,
         .display_ime_policy = options->display_ime_policy,
         .video = options->video,
@@ -470,6 +740,10 @@ scrcpy(struct scrcpy_options *options) {
         .cleanup = options->cleanup,
         .power_on = options->power_on,
         .kill_adb_on_close = options->kill_adb_on_close,
+        .resume = options->resume,
+#ifdef HAVE_USB
+        .usb_transport = options->usb_transport,
+#endif
         .camera_high_speed = options->camera_high_speed,
         .vd_destroy_content = options->vd_destroy_content,
         .vd_system_decorations = options->vd_system_decorations,
@@ -482,6 +756,12 @@ scrcpy(struct scrcpy_options *options) {
         .on_disconnected = sc_server_on_disconnected,
     };
     if (!sc_server_init(&s->server, &params, &cbs, NULL)) {
+        if (options->latency_stats) {
+            sc_latency_tracer_disable();
+        }
+        if (headless) {
+            sc_events_destroy_headless();
+        }
         return SCRCPY_EXIT_FAILURE;
     }
 
@@ -507,6 +787,12 @@ scrcpy(struct scrcpy_options *options) {
     assert(!options->video_playback || options->video);
     assert(!options->audio_playback || options->audio);
 
+    if (options->window) {
+        // Decode the icon while the server is connecting
+        scrcpy_icon_loader_start(&s->icon_loader);
+        icon_loader_started = true;
+    }
+
     if (options->window ||
             (options->control && options->clipboard_autosync)) {
         // Initialize the video subsystem even if --no-video or
@@ -524,9 +810,10 @@ scrcpy(struct scrcpy_options *options) {
         }
     }
 
-    if (options->audio_playback) {
-        if (SDL_Init(SDL_INIT_AUDIO)) {
-            LOGE("Could not initialize SDL audio: %s", SDL_GetError());
+    if (options->video_playback && options->display_pacing) {
+        // The frame pacer schedules the presentations using SDL timers
+        if (SDL_Init(SDL_INIT_TIMER)) {
+            LOGE("Could not initialize SDL timer: %s", SDL_GetError());
             goto end;
         }
     }
@@ -576,17 +863,43 @@ scrcpy(struct scrcpy_options *options) {
     if (options->video) {
         static const struct sc_demuxer_callbacks video_demuxer_cbs = {
             .on_ended = sc_video_demuxer_on_ended,
+            .on_disconnected = sc_video_demuxer_on_disconnected,
         };
-        sc_demuxer_init(&s->video_demuxer, "video", s->server.video_socket,
-                        &video_demuxer_cbs, NULL);
+        sc_demuxer_init(&s->video_demuxer, "video", SC_THREAD_ROLE_VIDEO,
+                        s->server.video_socket, &video_demuxer_cbs, NULL);
     }
 
     if (options->audio) {
         static const struct sc_demuxer_callbacks audio_demuxer_cbs = {
             .on_ended = sc_audio_demuxer_on_ended,
+            .on_disconnected = sc_audio_demuxer_on_disconnected,
+        };
+        sc_demuxer_init(&s->audio_demuxer, "audio", SC_THREAD_ROLE_AUDIO,
+                        s->server.audio_socket, &audio_demuxer_cbs, options);
+    }
+
+    bool extra_display = options->extra_display_id != SC_DISPLAY_ID_NONE;
+    if (extra_display) {
+        // Checked by the command line parser
+        assert(options->video_playback);
+
+        // Like the main video stream, the device may not disable it
+        static const struct sc_demuxer_callbacks extra_video_demuxer_cbs = {
+            .on_ended = sc_video_demuxer_on_ended,
+            .on_disconnected = sc_extra_video_demuxer_on_disconnected,
         };
-        sc_demuxer_init(&s->audio_demuxer, "audio", s->server.audio_socket,
-                        &audio_demuxer_cbs, options);
+        sc_demuxer_init(&s->extra_video_demuxer, "extra video",
+                        SC_THREAD_ROLE_VIDEO, s->server.extra_video_socket,
+                        &extra_video_demuxer_cbs, NULL);
+
+        sc_decoder_init(&s->extra_video_decoder, "extra video",
+                        options->video_hwaccel);
+        sc_decoder_set_threading(&s->extra_video_decoder,
+                                 options->video_decoder_threads,
+                                 options->video_decoder_thread_type,
+                                 options->video_decoder_fast);
+        sc_packet_source_add_sink(&s->extra_video_demuxer.packet_source,
+                                  &s->extra_video_decoder.packet_sink);
     }
 
     bool needs_video_decoder = options->video_playback;
@@ -594,13 +907,53 @@ scrcpy(struct scrcpy_options *options) {
 #ifdef HAVE_V4L2
     needs_video_decoder |= !!options->v4l2_device;
 #endif
+    needs_video_decoder |= !!options->archive_filename;
     if (needs_video_decoder) {
-        sc_decoder_init(&s->video_decoder, "video");
+        sc_decoder_init(&s->video_decoder, "video", options->video_hwaccel);
+        sc_decoder_set_threading(&s->video_decoder,
+                                 options->video_decoder_threads,
+                                 options->video_decoder_thread_type,
+                                 options->video_decoder_fast);
+        sc_decoder_set_skip_nonref(&s->video_decoder,
+                                   options->video_decoder_skip);
+        static const struct sc_decoder_callbacks video_decoder_cbs = {
+            .on_resync = sc_video_decoder_on_resync,
+        };
+        // The controller is started before the demuxers
+        const struct sc_decoder_callbacks *cbs =
+            options->control ? &video_decoder_cbs : NULL;
+        if (options->video_decoder_resync) {
+            sc_decoder_set_resync(&s->video_decoder, cbs, NULL);
+        }
+        if (options->video_catch_up) {
+            sc_decoder_set_catch_up(&s->video_decoder, options->video_catch_up,
+                                    cbs, NULL);
+        }
         sc_packet_source_add_sink(&s->video_demuxer.packet_source,
                                   &s->video_decoder.packet_sink);
+
+        // If the frames are pushed both to the screen and to the V4L2 sink,
+        // a slow sink must not delay the other (this has no effect with a
+        // single sink)
+        sc_frame_source_set_async(&s->video_decoder.frame_source, 4);
+    }
+
+    struct sc_snapshot *snapshot = NULL;
+    if (needs_video_decoder) {
+        if (!sc_snapshot_init(&s->snapshot, options->snapshot_dir,
+                              options->snapshot_format)) {
+            goto end;
+        }
+        snapshot_initialized = true;
+        snapshot = &s->snapshot;
+
+        // A tap only references the requested frames, it does not enable the
+        // asynchronous fan-out for a single sink
+        sc_frame_source_add_tap(&s->video_decoder.frame_source,
+                                &s->snapshot.frame_sink);
     }
     if (needs_audio_decoder) {
-        sc_decoder_init(&s->audio_decoder, "audio");
+        sc_decoder_init(&s->audio_decoder, "audio", NULL);
         sc_packet_source_add_sink(&s->audio_demuxer.packet_source,
                                   &s->audio_decoder.packet_sink);
     }
@@ -609,9 +962,18 @@ scrcpy(struct scrcpy_options *options) {
         static const struct sc_recorder_callbacks recorder_cbs = {
             .on_ended = sc_recorder_on_ended,
         };
+        static const struct sc_packet_source_callbacks video_source_cbs = {
+            .on_drop = sc_video_packet_source_on_drop,
+        };
+        struct sc_recorder_segmentation segmentation = {
+            .duration = options->record_segment_duration,
+            .size = options->record_segment_size,
+            .max_count = options->record_segment_count,
+        };
         if (!sc_recorder_init(&s->recorder, options->record_filename,
                               options->record_format, options->video,
                               options->audio, options->record_orientation,
+                              options->record_low_latency, &segmentation,
                               &recorder_cbs, NULL)) {
             goto end;
         }
@@ -622,13 +984,53 @@ scrcpy(struct scrcpy_options *options) {
         }
         recorder_started = true;
 
+        if (options->video) {
+            // The recording must never drop packets
+            sc_packet_source_add_lossless_sink(&s->video_demuxer.packet_source,
+                                               &s->recorder.video_packet_sink);
+            if (needs_video_decoder) {
+                // Do not delay the recording while the video is decoded
+                // (packets are only dropped for the decoder, if it stalls for
+                // about one second)
+                sc_packet_source_set_async(&s->video_demuxer.packet_source,
+                                           64);
+                if (options->control) {
+                    // The decoder waits for the next key frame after a drop
+                    sc_packet_source_set_callbacks(
+                            &s->video_demuxer.packet_source,
+                            &video_source_cbs, NULL);
+                }
+            }
+        }
+        if (options->audio) {
+            sc_packet_source_add_lossless_sink(&s->audio_demuxer.packet_source,
+                                               &s->recorder.audio_packet_sink);
+        }
+    }
+
+    if (options->restream_url) {
+        static const struct sc_restreamer_callbacks restreamer_cbs = {
+            .on_ended = sc_restreamer_on_ended,
+        };
+        if (!sc_restreamer_init(&s->restreamer, options->restream_url,
+                                options->restream_format, options->video,
+                                options->audio, &restreamer_cbs, NULL)) {
+            goto end;
+        }
+        restreamer_initialized = true;
+
+        if (!sc_restreamer_start(&s->restreamer)) {
+            goto end;
+        }
+        restreamer_started = true;
+
         if (options->video) {
             sc_packet_source_add_sink(&s->video_demuxer.packet_source,
-                                      &s->recorder.video_packet_sink);
+                                      &s->restreamer.video_packet_sink);
         }
         if (options->audio) {
             sc_packet_source_add_sink(&s->audio_demuxer.packet_source,
-                                      &s->recorder.audio_packet_sink);
+                                      &s->restreamer.audio_packet_sink);
         }
     }
 
@@ -640,6 +1042,7 @@ scrcpy(struct scrcpy_options *options) {
     if (options->control) {
         static const struct sc_controller_callbacks controller_cbs = {
             .on_ended = sc_controller_on_ended,
+            .on_disconnected = sc_controller_on_disconnected,
         };
 
         if (!sc_controller_init(&s->controller, s->server.control_socket,
@@ -648,8 +1051,30 @@ scrcpy(struct scrcpy_options *options) {
         }
         controller_initialized = true;
 
+        if (options->clipboard_chunks) {
+            sc_controller_enable_clipboard_chunks(&s->controller);
+        }
+        if (options->text_chunks) {
+            sc_controller_enable_text_chunks(&s->controller);
+        }
+
+        if (options->record_control_filename) {
+            if (!sc_controller_record(&s->controller,
+                                      options->record_control_filename)) {
+                goto end;
+            }
+        }
+
         controller = &s->controller;
 
+        if (options->adaptive_video && options->video) {
+            sc_congestion_controller_init(&s->congestion_controller,
+                                          controller, options->video_bit_rate,
+                                          options->max_size);
+            sc_packet_source_add_sink(&s->video_demuxer.packet_source,
+                                    &s->congestion_controller.packet_sink);
+        }
+
 #ifdef HAVE_USB
         bool use_keyboard_aoa =
             options->keyboard_input_mode == SC_KEYBOARD_INPUT_MODE_AOA;
@@ -806,6 +1231,7 @@ aoa_complete:
             .video = options->video_playback,
             .controller = controller,
             .fp = fp,
+            .snapshot = snapshot,
             .kp = kp,
             .mp = mp,
             .gp = gp,
@@ -822,6 +1248,18 @@ aoa_complete:
             .window_borderless = options->window_borderless,
             .orientation = options->display_orientation,
             .mipmaps = options->mipmaps,
+            .render_shader = options->render_shader,
+            .damage_tracking = options->damage_tracking,
+            .frame_slots = options->display_frame_slots,
+            .frame_policy =
+                options->display_frame_policy
+                        == SC_DISPLAY_FRAME_POLICY_NEWEST_KEEP_SPARE
+                    ? SC_FRAME_BUFFER_POLICY_NEWEST_KEEP_SPARE
+                    : SC_FRAME_BUFFER_POLICY_FIFO,
+            .pacing = options->display_pacing,
+            .match_display_rate = options->match_display_rate,
+            .render_thread = options->render_thread,
+            .icon_loader = &s->icon_loader,
             .fullscreen = options->fullscreen,
             .start_fps_counter = options->start_fps_counter,
         };
@@ -833,7 +1271,13 @@ aoa_complete:
 
         if (options->video_playback) {
             struct sc_frame_source *src = &s->video_decoder.frame_source;
-            if (options->video_buffer) {
+            if (options->video_buffer_max) {
+                sc_delay_buffer_init_adaptive(&s->video_buffer,
+                                              options->video_buffer,
+                                              options->video_buffer_max, true);
+                sc_frame_source_add_sink(src, &s->video_buffer.frame_sink);
+                src = &s->video_buffer.frame_source;
+            } else if (options->video_buffer) {
                 sc_delay_buffer_init(&s->video_buffer,
                                      options->video_buffer, true);
                 sc_frame_source_add_sink(src, &s->video_buffer.frame_sink);
@@ -842,18 +1286,55 @@ aoa_complete:
 
             sc_frame_source_add_sink(src, &s->screen.frame_sink);
         }
+
+        if (extra_display) {
+            char extra_window_title[256];
+            snprintf(extra_window_title, sizeof(extra_window_title),
+                     "%s (display %" PRIu32 ")", window_title,
+                     options->extra_display_id);
+
+            // View-only: the control msgs have no target display, the events
+            // are always injected to the main display
+            struct sc_screen_params extra_screen_params = screen_params;
+            extra_screen_params.controller = NULL;
+            extra_screen_params.fp = NULL;
+            extra_screen_params.snapshot = NULL;
+            extra_screen_params.kp = NULL;
+            extra_screen_params.mp = NULL;
+            extra_screen_params.gp = NULL;
+            extra_screen_params.window_title = extra_window_title;
+            extra_screen_params.window_x = SC_WINDOW_POSITION_UNDEFINED;
+            extra_screen_params.window_y = SC_WINDOW_POSITION_UNDEFINED;
+            extra_screen_params.window_width = 0;
+            extra_screen_params.window_height = 0;
+            extra_screen_params.icon_loader = NULL;
+            extra_screen_params.fullscreen = false;
+            extra_screen_params.start_fps_counter = false;
+
+            if (!sc_screen_init(&s->extra_screen, &extra_screen_params)) {
+                goto end;
+            }
+            extra_screen_initialized = true;
+
+            sc_frame_source_add_sink(&s->extra_video_decoder.frame_source,
+                                     &s->extra_screen.frame_sink);
+        }
     }
 
     if (options->audio_playback) {
         sc_audio_player_init(&s->audio_player, options->audio_buffer,
-                             options->audio_output_buffer);
+                             options->audio_output_buffer,
+                             options->audio_output_backend);
         sc_frame_source_add_sink(&s->audio_decoder.frame_source,
                                  &s->audio_player.frame_sink);
     }
 
 #ifdef HAVE_V4L2
     if (options->v4l2_device) {
-        if (!sc_v4l2_sink_init(&s->v4l2_sink, options->v4l2_device)) {
+        if (!sc_v4l2_sink_init(&s->v4l2_sink, options->v4l2_device,
+                               options->v4l2_direct,
+                               options->v4l2_pixel_format,
+                               options->v4l2_orientation)) {
             goto end;
         }
 
@@ -864,12 +1345,41 @@ aoa_complete:
             src = &s->v4l2_buffer.frame_source;
         }
 
+        if (!options->v4l2_direct
+                && options->v4l2_pixel_format != SC_V4L2_PIXEL_FORMAT_YUV420P) {
+            // The direct output converts while copying into the V4L2
+            // buffers, but the muxer expects frames in the device format
+            enum AVPixelFormat pix_fmt =
+                options->v4l2_pixel_format == SC_V4L2_PIXEL_FORMAT_NV12
+                    ? AV_PIX_FMT_NV12 : AV_PIX_FMT_YUYV422;
+            sc_frame_transform_init(&s->v4l2_transform, pix_fmt, false);
+            sc_frame_source_add_sink(src, &s->v4l2_transform.frame_sink);
+            src = &s->v4l2_transform.frame_source;
+        }
+
         sc_frame_source_add_sink(src, &s->v4l2_sink.frame_sink);
 
         v4l2_sink_initialized = true;
     }
 #endif
 
+    if (options->archive_filename) {
+        if (!sc_archiver_init(&s->archiver, options->archive_filename,
+                              options->archive_encoder,
+                              options->archive_bit_rate)) {
+            goto end;
+        }
+        archiver_initialized = true;
+
+        // The hardware encoders take NV12 frames
+        sc_frame_transform_init(&s->archive_transform, AV_PIX_FMT_NV12,
+                                options->archive_downscale);
+        sc_frame_source_add_sink(&s->video_decoder.frame_source,
+                                 &s->archive_transform.frame_sink);
+        sc_frame_source_add_sink(&s->archive_transform.frame_source,
+                                 &s->archiver.frame_sink);
+    }
+
     // Now that the header values have been consumed, the socket(s) will
     // receive the stream(s). Start the demuxer(s).
 
@@ -880,6 +1390,13 @@ aoa_complete:
         video_demuxer_started = true;
     }
 
+    if (extra_display) {
+        if (!sc_demuxer_start(&s->extra_video_demuxer)) {
+            goto end;
+        }
+        extra_video_demuxer_started = true;
+    }
+
     if (options->audio) {
         if (!sc_demuxer_start(&s->audio_demuxer)) {
             goto end;
@@ -920,6 +1437,19 @@ aoa_complete:
         timeout_started = true;
     }
 
+    if (options->stats_port) {
+        if (!sc_stats_server_init(&s->stats_server, options->stats_port,
+                                  controller, snapshot)) {
+            goto end;
+        }
+        stats_server_initialized = true;
+
+        if (!sc_stats_server_start(&s->stats_server)) {
+            goto end;
+        }
+        stats_server_started = true;
+    }
+
     if (options->control
             && options->gamepad_input_mode != SC_GAMEPAD_INPUT_MODE_DISABLED) {
         init_sdl_gamepads();
@@ -944,7 +1474,7 @@ aoa_complete:
         }
     }
 
-    ret = event_loop(s, options->window);
+    ret = event_loop(s, options->window, extra_screen_initialized);
     terminate_event_loop();
     LOGD("quit...");
 
@@ -953,12 +1483,18 @@ aoa_complete:
         // may only be called once the video demuxer thread is joined (it may
         // take time)
         sc_screen_hide_window(&s->screen);
+        if (extra_screen_initialized) {
+            sc_screen_hide_window(&s->extra_screen);
+        }
     }
 
 end:
     if (timeout_started) {
         sc_timeout_stop(&s->timeout);
     }
+    if (stats_server_started) {
+        sc_stats_server_stop(&s->stats_server);
+    }
 
     // The demuxer is not stopped explicitly, because it will stop by itself on
     // end-of-stream
@@ -989,9 +1525,15 @@ end:
     if (recorder_initialized) {
         sc_recorder_stop(&s->recorder);
     }
+    if (restreamer_initialized) {
+        sc_restreamer_stop(&s->restreamer);
+    }
     if (screen_initialized) {
         sc_screen_interrupt(&s->screen);
     }
+    if (extra_screen_initialized) {
+        sc_screen_interrupt(&s->extra_screen);
+    }
 
     if (server_started) {
         // shutdown the sockets and kill the server
@@ -1005,6 +1547,15 @@ end:
         sc_timeout_destroy(&s->timeout);
     }
 
+    // The stats server reads the controller state, join it before the
+    // controller is destroyed
+    if (stats_server_started) {
+        sc_stats_server_join(&s->stats_server);
+    }
+    if (stats_server_initialized) {
+        sc_stats_server_destroy(&s->stats_server);
+    }
+
     // now that the sockets are shutdown, the demuxer and controller are
     // interrupted, we can join them
     if (video_demuxer_started) {
@@ -1015,12 +1566,24 @@ end:
         sc_demuxer_join(&s->audio_demuxer);
     }
 
+    if (extra_video_demuxer_started) {
+        sc_demuxer_join(&s->extra_video_demuxer);
+    }
+
 #ifdef HAVE_V4L2
     if (v4l2_sink_initialized) {
         sc_v4l2_sink_destroy(&s->v4l2_sink);
     }
 #endif
 
+    if (archiver_initialized) {
+        sc_archiver_destroy(&s->archiver);
+    }
+
+    if (snapshot_initialized) {
+        sc_snapshot_destroy(&s->snapshot);
+    }
+
 #ifdef HAVE_USB
     if (aoa_hid_initialized) {
         sc_aoa_join(&s->aoa);
@@ -1038,6 +1601,15 @@ end:
         sc_screen_join(&s->screen);
         sc_screen_destroy(&s->screen);
     }
+    if (extra_screen_initialized) {
+        sc_screen_join(&s->extra_screen);
+        sc_screen_destroy(&s->extra_screen);
+    }
+
+    if (icon_loader_started) {
+        // The icon has been taken by the screen, unless it failed before
+        scrcpy_icon_loader_destroy(&s->icon_loader);
+    }
 
     if (controller_started) {
         sc_controller_join(&s->controller);
@@ -1053,6 +1625,13 @@ end:
         sc_recorder_destroy(&s->recorder);
     }
 
+    if (restreamer_started) {
+        sc_restreamer_join(&s->restreamer);
+    }
+    if (restreamer_initialized) {
+        sc_restreamer_destroy(&s->restreamer);
+    }
+
     if (file_pusher_initialized) {
         sc_file_pusher_join(&s->file_pusher);
         sc_file_pusher_destroy(&s->file_pusher);
@@ -1064,5 +1643,21 @@ end:
 
     sc_server_destroy(&s->server);
 
+    if (options->memory_budget) {
+        LOGD("Memory budget: peak usage %" PRIu64 " KiB (limit %" PRIu64
+             " KiB)", sc_memory_budget_get_peak() >> 10,
+             options->memory_budget >> 10);
+    }
+
+    if (options->latency_stats) {
+        // All the pipeline threads are joined
+        sc_latency_tracer_dump();
+        sc_latency_tracer_disable();
+    }
+
+    if (headless) {
+        sc_events_destroy_headless();
+    }
+
     return ret;
 }
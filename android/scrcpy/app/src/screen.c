@@ -1,16 +1,22 @@
 #include "screen.h"
 
 #include <assert.h>
+#include <inttypes.h>
 #include <string.h>
 #include <SDL2/SDL.h>
 
 #include "events.h"
 #include "icon.h"
+#include "latency_tracer.h"
 #include "options.h"
+#include "stats.h"
 #include "util/log.h"
 
 #define DISPLAY_MARGINS 96
 
+static_assert(SC_DISPLAY_FRAME_SLOTS_MAX <= SC_FRAME_BUFFER_MAX_SLOTS,
+              "Too many display frame slots");
+
 #define DOWNCAST(SINK) container_of(SINK, struct sc_screen, frame_sink)
 
 static inline struct sc_size
@@ -163,19 +169,15 @@ sc_screen_is_relative_mode(struct sc_screen *screen) {
 }
 
 static void
-sc_screen_update_content_rect(struct sc_screen *screen) {
-    assert(screen->video);
-
+sc_screen_compute_content_rect(struct sc_screen *screen,
+                               struct sc_size content_size, SDL_Rect *rect) {
     int dw;
     int dh;
     SDL_GL_GetDrawableSize(screen->window, &dw, &dh);
 
-    struct sc_size content_size = screen->content_size;
     // The drawable size is the window size * the HiDPI scale
     struct sc_size drawable_size = {dw, dh};
 
-    SDL_Rect *rect = &screen->rect;
-
     if (is_optimal_size(drawable_size, content_size)) {
         rect->x = 0;
         rect->y = 0;
@@ -201,6 +203,25 @@ sc_screen_update_content_rect(struct sc_screen *screen) {
     }
 }
 
+static void
+sc_screen_update_content_rect(struct sc_screen *screen) {
+    assert(screen->video);
+    sc_screen_compute_content_rect(screen, screen->content_size,
+                                   &screen->rect);
+}
+
+// Wake up the render thread to present the current frame again
+static void
+sc_screen_request_redraw(struct sc_screen *screen) {
+    assert(screen->render_thread);
+
+    sc_mutex_lock(&screen->render.mutex);
+    screen->render.redraw = true;
+    screen->render.orientation = screen->orientation;
+    sc_cond_signal(&screen->render.cond);
+    sc_mutex_unlock(&screen->render.mutex);
+}
+
 // render the texture to the renderer
 //
 // Set the update_content_rect flag if the window or content size may have
@@ -210,12 +231,117 @@ sc_screen_render(struct sc_screen *screen, bool update_content_rect) {
     assert(screen->video);
 
     if (update_content_rect) {
+        // Also needed with a render thread, to convert the input coordinates
         sc_screen_update_content_rect(screen);
     }
 
+    if (screen->render_thread) {
+        sc_screen_request_redraw(screen);
+        return;
+    }
+
     enum sc_display_result res =
         sc_display_render(&screen->display, &screen->rect, screen->orientation);
     (void) res; // any error already logged
+
+    if (screen->pacing) {
+        sc_frame_pacer_on_presented(&screen->pacer, sc_tick_now());
+    }
+}
+
+static uint32_t
+sc_screen_present_timer_cb(uint32_t interval, void *userdata) {
+    (void) interval;
+    struct sc_screen *screen = userdata;
+
+    // Called from the SDL timer thread, render from the main thread
+    sc_push_event_with_data(SC_EVENT_PRESENT_FRAME, screen);
+
+    // Do not repeat
+    return 0;
+}
+
+// render the new frame immediately, or schedule its presentation on the
+// vblank selected by the frame pacer
+static void
+sc_screen_present(struct sc_screen *screen, int64_t pts) {
+    assert(screen->video);
+
+    if (!screen->pacing || pts == AV_NOPTS_VALUE) {
+        sc_screen_render(screen, false);
+        return;
+    }
+
+    if (screen->present_timer) {
+        // The pending frame has been replaced before its presentation
+        SDL_RemoveTimer(screen->present_timer);
+        screen->present_timer = 0;
+    }
+
+    sc_tick now = sc_tick_now();
+    // PTS (written by the server) are expressed in microseconds
+    sc_tick date = sc_frame_pacer_schedule(&screen->pacer, now,
+                                           SC_TICK_FROM_US(pts));
+    sc_tick delay_ms = SC_TICK_TO_MS(date - now);
+    if (delay_ms <= 0) {
+        sc_screen_render(screen, false);
+        return;
+    }
+
+    screen->present_timer =
+        SDL_AddTimer(delay_ms, sc_screen_present_timer_cb, screen);
+    if (!screen->present_timer) {
+        LOGW("Could not schedule frame presentation: %s", SDL_GetError());
+        sc_screen_render(screen, false);
+    }
+}
+
+static void
+sc_screen_send_display_rate(struct sc_screen *screen, int refresh_rate) {
+    assert(screen->match_display_rate);
+
+    if (refresh_rate <= 0 || refresh_rate == screen->display_rate) {
+        // Unknown or unchanged
+        return;
+    }
+
+    struct sc_control_msg msg;
+    msg.type = SC_CONTROL_MSG_TYPE_SET_MAX_FPS;
+    msg.set_max_fps.max_fps = MIN(refresh_rate, UINT16_MAX);
+
+    if (!sc_controller_push_msg(screen->im.controller, &msg)) {
+        LOGW("Could not request 'set max fps'");
+        return;
+    }
+
+    LOGI("Requesting the device to limit the frame rate to %d fps",
+         refresh_rate);
+    screen->display_rate = msg.set_max_fps.max_fps;
+}
+
+static void
+sc_screen_update_refresh_rate(struct sc_screen *screen) {
+    assert(screen->pacing || screen->match_display_rate);
+
+    int index = SDL_GetWindowDisplayIndex(screen->window);
+    if (index < 0) {
+        LOGW("Could not get window display index: %s", SDL_GetError());
+        return;
+    }
+
+    SDL_DisplayMode mode;
+    if (SDL_GetCurrentDisplayMode(index, &mode)) {
+        LOGW("Could not get display mode: %s", SDL_GetError());
+        return;
+    }
+
+    if (screen->pacing) {
+        sc_frame_pacer_set_refresh_rate(&screen->pacer, mode.refresh_rate);
+    }
+
+    if (screen->match_display_rate) {
+        sc_screen_send_display_rate(screen, mode.refresh_rate);
+    }
 }
 
 static void
@@ -272,7 +398,7 @@ sc_screen_frame_sink_open(struct sc_frame_sink *sink,
     screen->frame_size.height = ctx->height;
 
     // Post the event on the UI thread (the texture must be created from there)
-    bool ok = sc_push_event(SC_EVENT_SCREEN_INIT_SIZE);
+    bool ok = sc_push_event_with_data(SC_EVENT_SCREEN_INIT_SIZE, screen);
     if (!ok) {
         return false;
     }
@@ -296,30 +422,146 @@ sc_screen_frame_sink_close(struct sc_frame_sink *sink) {
     // nothing to do, the screen lifecycle is not managed by the frame producer
 }
 
+static const char *
+sc_screen_get_drop_reason(enum sc_frame_buffer_drop drop) {
+    switch (drop) {
+        case SC_FRAME_BUFFER_DROP_REPLACED:
+            return "replaced";
+        case SC_FRAME_BUFFER_DROP_FULL:
+            return "full";
+        case SC_FRAME_BUFFER_DROP_STALE:
+            return "stale";
+        default:
+            return "(unknown)";
+    }
+}
+
 static bool
 sc_screen_frame_sink_push(struct sc_frame_sink *sink, const AVFrame *frame) {
     struct sc_screen *screen = DOWNCAST(sink);
     assert(screen->video);
 
-    bool previous_skipped;
-    bool ok = sc_frame_buffer_push(&screen->fb, frame, &previous_skipped);
+    // Mark before pushing, the frame may be consumed immediately
+    sc_latency_tracer_mark(SC_LATENCY_STAGE_FRAME_PUSH, frame->pts);
+
+    enum sc_frame_buffer_drop drop;
+    unsigned slot;
+    bool ok = sc_frame_buffer_push(&screen->fb, frame, &drop, &slot);
     if (!ok) {
         return false;
     }
 
-    if (previous_skipped) {
-        sc_fps_counter_add_skipped_frame(&screen->fps_counter);
-        // The SC_EVENT_NEW_FRAME triggered for the previous frame will consume
-        // this new frame instead
-    } else {
-        // Post the event on the UI thread
-        bool ok = sc_push_event(SC_EVENT_NEW_FRAME);
-        if (!ok) {
-            return false;
+    if (drop == SC_FRAME_BUFFER_DROP_NONE) {
+        if (screen->render_thread) {
+            sc_mutex_lock(&screen->render.mutex);
+            ++screen->render.pending_frames;
+            sc_cond_signal(&screen->render.cond);
+            sc_mutex_unlock(&screen->render.mutex);
+        } else {
+            // Post the event on the UI thread
+            bool ok = sc_push_event_with_data(SC_EVENT_NEW_FRAME, screen);
+            if (!ok) {
+                return false;
+            }
         }
+    } else {
+        sc_fps_counter_add_skipped_frame(&screen->fps_counter);
+        sc_stats_inc(SC_STATS_FRAMES_SKIPPED);
+        LOGV("Frame skipped (slot %u: %s)", slot,
+             sc_screen_get_drop_reason(drop));
+        // If the pending frame has been replaced, the SC_EVENT_NEW_FRAME (or
+        // the pending_frames increment) triggered for the previous frame will
+        // consume this new frame instead. If the ring is full, the new frame
+        // is dropped, and the pending frames have their own events.
+    }
+
+    return true;
+}
+
+static int
+run_render(void *data);
+
+// Start the render thread, which initializes the display
+static bool
+sc_screen_start_render_thread(struct sc_screen *screen, bool mipmaps,
+                              bool shader, bool damage_tracking) {
+    assert(screen->render_thread);
+
+    bool ok = sc_mutex_init(&screen->render.mutex);
+    if (!ok) {
+        return false;
+    }
+
+    ok = sc_cond_init(&screen->render.cond);
+    if (!ok) {
+        goto error_mutex_destroy;
+    }
+
+    screen->render.stopped = false;
+    screen->render.initialized = false;
+    screen->render.init_ok = false;
+    screen->render.pending_frames = 0;
+    screen->render.redraw = false;
+    screen->render.apply_resume_frame = false;
+    screen->render.paused = false;
+    screen->render.orientation = screen->orientation;
+    screen->render.display_params.mipmaps = mipmaps;
+    screen->render.display_params.shader = shader;
+    screen->render.display_params.damage_tracking = damage_tracking;
+    screen->render.texture_size.width = 0;
+    screen->render.texture_size.height = 0;
+    screen->render.applied_orientation = screen->orientation;
+    screen->render.has_frame = false;
+
+    ok = sc_thread_create(&screen->render.thread, run_render, "scrcpy-render",
+                          screen);
+    if (!ok) {
+        LOGE("Could not start render thread");
+        goto error_cond_destroy;
+    }
+
+    // The renderer must be created from the thread using it
+    sc_mutex_lock(&screen->render.mutex);
+    while (!screen->render.initialized) {
+        sc_cond_wait(&screen->render.cond, &screen->render.mutex);
+    }
+    ok = screen->render.init_ok;
+    sc_mutex_unlock(&screen->render.mutex);
+
+    if (!ok) {
+        // The thread has already ended
+        sc_thread_join(&screen->render.thread, NULL);
+        goto error_cond_destroy;
     }
 
     return true;
+
+error_cond_destroy:
+    sc_cond_destroy(&screen->render.cond);
+error_mutex_destroy:
+    sc_mutex_destroy(&screen->render.mutex);
+
+    return false;
+}
+
+static void
+sc_screen_stop_render_thread(struct sc_screen *screen) {
+    assert(screen->render_thread);
+
+    sc_mutex_lock(&screen->render.mutex);
+    screen->render.stopped = true;
+    sc_cond_signal(&screen->render.cond);
+    sc_mutex_unlock(&screen->render.mutex);
+}
+
+// Stop the render thread (which destroys the display) and release it
+static void
+sc_screen_destroy_render_thread(struct sc_screen *screen) {
+    assert(screen->render_thread);
+
+    sc_thread_join(&screen->render.thread, NULL);
+    sc_cond_destroy(&screen->render.cond);
+    sc_mutex_destroy(&screen->render.mutex);
 }
 
 bool
@@ -335,6 +577,19 @@ sc_screen_init(struct sc_screen *screen,
     screen->orientation = SC_ORIENTATION_0;
 
     screen->video = params->video;
+    screen->pacing = params->video && params->pacing;
+    screen->present_timer = 0;
+    if (screen->pacing) {
+        sc_frame_pacer_init(&screen->pacer);
+    }
+
+    screen->match_display_rate = params->video && params->match_display_rate
+                              && params->controller;
+    screen->display_rate = 0;
+
+    screen->render_thread = params->video && params->render_thread;
+    // The presentation timers run on the event thread
+    assert(!screen->render_thread || !screen->pacing);
 
     screen->req.x = params->window_x;
     screen->req.y = params->window_y;
@@ -343,7 +598,8 @@ sc_screen_init(struct sc_screen *screen,
     screen->req.fullscreen = params->fullscreen;
     screen->req.start_fps_counter = params->start_fps_counter;
 
-    bool ok = sc_frame_buffer_init(&screen->fb);
+    bool ok = sc_frame_buffer_init(&screen->fb, params->frame_slots,
+                                   params->frame_policy);
     if (!ok) {
         return false;
     }
@@ -400,7 +656,9 @@ sc_screen_init(struct sc_screen *screen,
         goto error_destroy_fps_counter;
     }
 
-    SDL_Surface *icon = scrcpy_icon_load();
+    SDL_Surface *icon = params->icon_loader
+                      ? scrcpy_icon_loader_take(params->icon_loader)
+                      : scrcpy_icon_load();
     if (icon) {
         SDL_SetWindowIcon(screen->window, icon);
     } else if (params->video) {
@@ -414,8 +672,15 @@ sc_screen_init(struct sc_screen *screen,
 
     SDL_Surface *icon_novideo = params->video ? NULL : icon;
     bool mipmaps = params->video && params->mipmaps;
-    ok = sc_display_init(&screen->display, screen->window, icon_novideo,
-                         mipmaps);
+    bool shader = params->video && params->render_shader;
+    if (screen->render_thread) {
+        ok = sc_screen_start_render_thread(screen, mipmaps, shader,
+                                           params->damage_tracking);
+    } else {
+        ok = sc_display_init(&screen->display, screen->window, icon_novideo,
+                             mipmaps, shader, params->damage_tracking,
+                             screen->pacing);
+    }
     if (icon) {
         scrcpy_icon_destroy(icon);
     }
@@ -432,6 +697,7 @@ sc_screen_init(struct sc_screen *screen,
     struct sc_input_manager_params im_params = {
         .controller = params->controller,
         .fp = params->fp,
+        .snapshot = params->snapshot,
         .screen = screen,
         .kp = params->kp,
         .mp = params->mp,
@@ -473,7 +739,12 @@ sc_screen_init(struct sc_screen *screen,
     return true;
 
 error_destroy_display:
-    sc_display_destroy(&screen->display);
+    if (screen->render_thread) {
+        sc_screen_stop_render_thread(screen);
+        sc_screen_destroy_render_thread(screen);
+    } else {
+        sc_display_destroy(&screen->display);
+    }
 error_destroy_window:
     SDL_DestroyWindow(screen->window);
 error_destroy_fps_counter:
@@ -508,6 +779,10 @@ sc_screen_show_initial_window(struct sc_screen *screen) {
 
     SDL_ShowWindow(screen->window);
     sc_screen_update_content_rect(screen);
+
+    if (screen->pacing || screen->match_display_rate) {
+        sc_screen_update_refresh_rate(screen);
+    }
 }
 
 void
@@ -518,11 +793,17 @@ sc_screen_hide_window(struct sc_screen *screen) {
 void
 sc_screen_interrupt(struct sc_screen *screen) {
     sc_fps_counter_interrupt(&screen->fps_counter);
+    if (screen->render_thread) {
+        sc_screen_stop_render_thread(screen);
+    }
 }
 
 void
 sc_screen_join(struct sc_screen *screen) {
     sc_fps_counter_join(&screen->fps_counter);
+    if (screen->render_thread) {
+        sc_thread_join(&screen->render.thread, NULL);
+    }
 }
 
 void
@@ -530,7 +811,23 @@ sc_screen_destroy(struct sc_screen *screen) {
 #ifndef NDEBUG
     assert(!screen->open);
 #endif
-    sc_display_destroy(&screen->display);
+    if (screen->pacing) {
+        if (screen->present_timer) {
+            SDL_RemoveTimer(screen->present_timer);
+        }
+
+        struct sc_frame_pacer_stats *stats = &screen->pacer.stats;
+        LOGD("Frame pacing: %" PRIu64_ " presented, %" PRIu64_ " late, %"
+             PRIu64_ " early, %" PRIu64_ " dropped", stats->presented,
+             stats->late, stats->early, stats->dropped);
+    }
+    if (screen->render_thread) {
+        // The display has been destroyed by the render thread (joined)
+        sc_cond_destroy(&screen->render.cond);
+        sc_mutex_destroy(&screen->render.mutex);
+    } else {
+        sc_display_destroy(&screen->display);
+    }
     av_frame_free(&screen->frame);
     SDL_DestroyWindow(screen->window);
     sc_fps_counter_destroy(&screen->fps_counter);
@@ -614,6 +911,11 @@ sc_screen_init_size(struct sc_screen *screen) {
         get_oriented_size(screen->frame_size, screen->orientation);
     screen->content_size = content_size;
 
+    if (screen->render_thread) {
+        // The texture is created by the render thread on the first frame
+        return true;
+    }
+
     enum sc_display_result res =
         sc_display_set_texture_size(&screen->display, screen->frame_size);
     return res != SC_DISPLAY_RESULT_ERROR;
@@ -641,13 +943,81 @@ prepare_for_frame(struct sc_screen *screen, struct sc_size new_frame_size) {
     return sc_display_set_texture_size(&screen->display, screen->frame_size);
 }
 
+// Present the current texture (from the render thread)
+static void
+sc_screen_render_thread_draw(struct sc_screen *screen) {
+    assert(screen->render_thread);
+
+    struct sc_size content_size =
+        get_oriented_size(screen->render.texture_size,
+                          screen->render.applied_orientation);
+    sc_screen_compute_content_rect(screen, content_size,
+                                   &screen->render.rect);
+
+    enum sc_display_result res =
+        sc_display_render(&screen->display, &screen->render.rect,
+                          screen->render.applied_orientation);
+    (void) res; // any error already logged
+}
+
+static bool
+sc_screen_render_thread_apply_frame(struct sc_screen *screen,
+                                    const AVFrame *frame) {
+    assert(screen->render_thread);
+
+    struct sc_size frame_size = {frame->width, frame->height};
+    struct sc_size *texture_size = &screen->render.texture_size;
+    if (frame_size.width != texture_size->width
+            || frame_size.height != texture_size->height) {
+        *texture_size = frame_size;
+
+        // The window is resized (or shown on the first frame) by the event
+        // thread
+        sc_mutex_lock(&screen->render.mutex);
+        screen->render.frame_size = frame_size;
+        sc_mutex_unlock(&screen->render.mutex);
+        bool ok = sc_push_event_with_data(SC_EVENT_SCREEN_FRAME_SIZE, screen);
+        if (!ok) {
+            return false;
+        }
+
+        enum sc_display_result res =
+            sc_display_set_texture_size(&screen->display, frame_size);
+        if (res == SC_DISPLAY_RESULT_ERROR) {
+            return false;
+        }
+        if (res == SC_DISPLAY_RESULT_PENDING) {
+            // Not an error, but do not continue
+            return true;
+        }
+    }
+
+    enum sc_display_result res =
+        sc_display_update_texture(&screen->display, frame);
+    if (res == SC_DISPLAY_RESULT_ERROR) {
+        return false;
+    }
+    if (res == SC_DISPLAY_RESULT_PENDING) {
+        // Not an error, but do not continue
+        return true;
+    }
+
+    screen->render.has_frame = true;
+    sc_screen_render_thread_draw(screen);
+    return true;
+}
+
 static bool
 sc_screen_apply_frame(struct sc_screen *screen) {
     assert(screen->video);
 
     sc_fps_counter_add_rendered_frame(&screen->fps_counter);
+    sc_stats_inc(SC_STATS_FRAMES_RENDERED);
 
     AVFrame *frame = screen->frame;
+    if (screen->render_thread) {
+        return sc_screen_render_thread_apply_frame(screen, frame);
+    }
     struct sc_size new_frame_size = {frame->width, frame->height};
     enum sc_display_result res = prepare_for_frame(screen, new_frame_size);
     if (res == SC_DISPLAY_RESULT_ERROR) {
@@ -678,33 +1048,144 @@ sc_screen_apply_frame(struct sc_screen *screen) {
         }
     }
 
-    sc_screen_render(screen, false);
+    sc_screen_present(screen, frame->pts);
     return true;
 }
 
 static bool
-sc_screen_update_frame(struct sc_screen *screen) {
+sc_screen_consume_frame(struct sc_screen *screen, AVFrame *dst) {
+    unsigned stale;
+    bool consumed = sc_frame_buffer_consume(&screen->fb, dst, &stale);
+    for (unsigned i = 0; i < stale; ++i) {
+        sc_fps_counter_add_skipped_frame(&screen->fps_counter);
+    }
+    sc_stats_add(SC_STATS_FRAMES_SKIPPED, stale);
+    if (stale) {
+        LOGV("%u frame(s) skipped (%s)", stale,
+             sc_screen_get_drop_reason(SC_FRAME_BUFFER_DROP_STALE));
+    }
+    return consumed;
+}
+
+// The paused state is passed explicitly, since the render thread does not
+// read screen->paused
+static bool
+sc_screen_update_frame(struct sc_screen *screen, bool paused) {
     assert(screen->video);
 
-    if (screen->paused) {
+    if (paused) {
         if (!screen->resume_frame) {
             screen->resume_frame = av_frame_alloc();
             if (!screen->resume_frame) {
                 LOG_OOM();
                 return false;
             }
-        } else {
+        }
+
+        // While paused, screen->frame is unused (it is replaced by the resume
+        // frame on unpause), so use it as a temporary frame. The resume frame
+        // is only replaced if a new frame has been consumed.
+        av_frame_unref(screen->frame);
+        if (sc_screen_consume_frame(screen, screen->frame)) {
             av_frame_unref(screen->resume_frame);
+            av_frame_move_ref(screen->resume_frame, screen->frame);
         }
-        sc_frame_buffer_consume(&screen->fb, screen->resume_frame);
         return true;
     }
 
     av_frame_unref(screen->frame);
-    sc_frame_buffer_consume(&screen->fb, screen->frame);
+    if (!sc_screen_consume_frame(screen, screen->frame)) {
+        // In ring mode, a previous consumption may have dropped the frame
+        // associated to this event
+        return true;
+    }
     return sc_screen_apply_frame(screen);
 }
 
+// Present the frame received while paused, if any (on unpause)
+static bool
+sc_screen_apply_resume_frame(struct sc_screen *screen) {
+    if (!screen->resume_frame) {
+        return true;
+    }
+
+    av_frame_free(&screen->frame);
+    screen->frame = screen->resume_frame;
+    screen->resume_frame = NULL;
+    return sc_screen_apply_frame(screen);
+}
+
+static int
+run_render(void *data) {
+    struct sc_screen *screen = data;
+
+    bool ok = sc_display_init(&screen->display, screen->window, NULL,
+                              screen->render.display_params.mipmaps,
+                              screen->render.display_params.shader,
+                              screen->render.display_params.damage_tracking,
+                              false);
+
+    sc_mutex_lock(&screen->render.mutex);
+    screen->render.initialized = true;
+    screen->render.init_ok = ok;
+    sc_cond_signal(&screen->render.cond);
+    sc_mutex_unlock(&screen->render.mutex);
+
+    if (!ok) {
+        return 0;
+    }
+
+    for (;;) {
+        sc_mutex_lock(&screen->render.mutex);
+
+        while (!screen->render.stopped && !screen->render.pending_frames
+                && !screen->render.redraw
+                && !screen->render.apply_resume_frame) {
+            sc_cond_wait(&screen->render.cond, &screen->render.mutex);
+        }
+
+        if (screen->render.stopped) {
+            sc_mutex_unlock(&screen->render.mutex);
+            break;
+        }
+
+        unsigned pending_frames = screen->render.pending_frames;
+        bool redraw = screen->render.redraw;
+        bool apply_resume_frame = screen->render.apply_resume_frame;
+        bool paused = screen->render.paused;
+        screen->render.pending_frames = 0;
+        screen->render.redraw = false;
+        screen->render.apply_resume_frame = false;
+        screen->render.applied_orientation = screen->render.orientation;
+
+        sc_mutex_unlock(&screen->render.mutex);
+
+        ok = true;
+        if (apply_resume_frame) {
+            ok = sc_screen_apply_resume_frame(screen);
+        }
+
+        for (unsigned i = 0; ok && i < pending_frames; ++i) {
+            ok = sc_screen_update_frame(screen, paused);
+        }
+
+        if (!ok) {
+            sc_push_event_with_data(SC_EVENT_SCREEN_RENDER_ERROR, screen);
+            break;
+        }
+
+        if (redraw && screen->render.has_frame) {
+            sc_screen_render_thread_draw(screen);
+        }
+    }
+
+    sc_display_destroy(&screen->display);
+
+    LOGD("Render thread ended");
+
+    return 0;
+}
+
 void
 sc_screen_set_paused(struct sc_screen *screen, bool paused) {
     assert(screen->video);
@@ -714,13 +1195,18 @@ sc_screen_set_paused(struct sc_screen *screen, bool paused) {
         return;
     }
 
-    if (screen->paused && screen->resume_frame) {
+    if (screen->render_thread) {
+        sc_mutex_lock(&screen->render.mutex);
+        // If display screen was paused, the render thread refreshes the frame
+        // immediately, even if the new state is also paused
+        screen->render.apply_resume_frame = screen->paused;
+        screen->render.paused = paused;
+        sc_cond_signal(&screen->render.cond);
+        sc_mutex_unlock(&screen->render.mutex);
+    } else if (screen->paused) {
         // If display screen was paused, refresh the frame immediately, even if
         // the new state is also paused.
-        av_frame_free(&screen->frame);
-        screen->frame = screen->resume_frame;
-        screen->resume_frame = NULL;
-        sc_screen_apply_frame(screen);
+        sc_screen_apply_resume_frame(screen);
     }
 
     if (!paused) {
@@ -798,6 +1284,37 @@ sc_screen_resize_to_pixel_perfect(struct sc_screen *screen) {
                                             content_size.height);
 }
 
+// Adapt the window to the frame size applied by the render thread
+static void
+sc_screen_on_frame_size(struct sc_screen *screen) {
+    assert(screen->render_thread);
+
+    sc_mutex_lock(&screen->render.mutex);
+    struct sc_size frame_size = screen->render.frame_size;
+    sc_mutex_unlock(&screen->render.mutex);
+
+    if (!screen->has_frame) {
+        screen->has_frame = true;
+        screen->frame_size = frame_size;
+        screen->content_size =
+            get_oriented_size(frame_size, screen->orientation);
+        // this is the very first frame, show the window
+        sc_screen_show_initial_window(screen);
+
+        if (sc_screen_is_relative_mode(screen)) {
+            // Capture mouse on start
+            sc_mouse_capture_set_active(&screen->mc, true);
+        }
+    } else if (frame_size.width != screen->frame_size.width
+            || frame_size.height != screen->frame_size.height) {
+        screen->frame_size = frame_size;
+        set_content_size(screen,
+                         get_oriented_size(frame_size, screen->orientation));
+    }
+
+    sc_screen_render(screen, true);
+}
+
 bool
 sc_screen_handle_event(struct sc_screen *screen, const SDL_Event *event) {
     switch (event->type) {
@@ -811,13 +1328,28 @@ sc_screen_handle_event(struct sc_screen *screen, const SDL_Event *event) {
             return true;
         }
         case SC_EVENT_NEW_FRAME: {
-            bool ok = sc_screen_update_frame(screen);
+            bool ok = sc_screen_update_frame(screen, screen->paused);
             if (!ok) {
                 LOGE("Frame update failed\n");
                 return false;
             }
             return true;
         }
+        case SC_EVENT_SCREEN_FRAME_SIZE:
+            assert(screen->render_thread);
+            sc_screen_on_frame_size(screen);
+            return true;
+        case SC_EVENT_SCREEN_RENDER_ERROR:
+            assert(screen->render_thread);
+            LOGE("Frame update failed");
+            return false;
+        case SC_EVENT_PRESENT_FRAME:
+            assert(screen->pacing);
+            screen->present_timer = 0;
+            if (screen->has_frame) {
+                sc_screen_render(screen, false);
+            }
+            return true;
         case SDL_WINDOWEVENT:
             if (!screen->video
                     && event->window.event == SDL_WINDOWEVENT_EXPOSED) {
@@ -837,6 +1369,12 @@ sc_screen_handle_event(struct sc_screen *screen, const SDL_Event *event) {
                 case SDL_WINDOWEVENT_SIZE_CHANGED:
                     sc_screen_render(screen, true);
                     break;
+                case SDL_WINDOWEVENT_MOVED:
+                    if (screen->pacing || screen->match_display_rate) {
+                        // The window may have moved to another display
+                        sc_screen_update_refresh_rate(screen);
+                    }
+                    break;
                 case SDL_WINDOWEVENT_MAXIMIZED:
                     screen->maximized = true;
                     break;
@@ -15,12 +15,15 @@
 #include "display.h"
 #include "fps_counter.h"
 #include "frame_buffer.h"
+#include "frame_pacer.h"
+#include "icon.h"
 #include "input_manager.h"
 #include "mouse_capture.h"
 #include "options.h"
 #include "trait/key_processor.h"
 #include "trait/frame_sink.h"
 #include "trait/mouse_processor.h"
+#include "util/thread.h"
 
 struct sc_screen {
     struct sc_frame_sink frame_sink; // frame sink trait
@@ -37,6 +40,48 @@ struct sc_screen {
     struct sc_frame_buffer fb;
     struct sc_fps_counter fps_counter;
 
+    bool pacing;
+    struct sc_frame_pacer pacer; // only used if pacing is enabled
+    SDL_TimerID present_timer; // 0 if no presentation is scheduled
+
+    // If enabled, the display (the renderer and its textures) is owned by a
+    // dedicated thread, which consumes and presents the frames. The event
+    // thread only forwards the geometry changes, so that event handling
+    // (window drags, input processing) does not delay the presentation.
+    bool render_thread;
+    struct {
+        sc_thread thread;
+        sc_mutex mutex;
+        sc_cond cond;
+        bool stopped;
+        bool initialized; // the display initialization is complete
+        bool init_ok;
+
+        // Requests to the render thread
+        unsigned pending_frames; // number of frames pushed to fb
+        bool redraw; // the geometry may have changed
+        bool apply_resume_frame; // the screen was paused
+        bool paused;
+        enum sc_orientation orientation;
+
+        // The new frame size, read on SC_EVENT_SCREEN_FRAME_SIZE
+        struct sc_size frame_size;
+
+        // Only accessed from the render thread
+        struct {
+            bool mipmaps;
+            bool shader;
+            bool damage_tracking;
+        } display_params;
+        struct sc_size texture_size;
+        enum sc_orientation applied_orientation;
+        struct SDL_Rect rect;
+        bool has_frame;
+    } render;
+
+    bool match_display_rate;
+    uint16_t display_rate; // last rate sent to the device (0 if none)
+
     // The initial requested window properties
     struct {
         int16_t x;
@@ -76,6 +121,7 @@ struct sc_screen_params {
 
     struct sc_controller *controller;
     struct sc_file_pusher *fp;
+    struct sc_snapshot *snapshot;
     struct sc_key_processor *kp;
     struct sc_mouse_processor *mp;
     struct sc_gamepad_processor *gp;
@@ -97,6 +143,18 @@ struct sc_screen_params {
 
     enum sc_orientation orientation;
     bool mipmaps;
+    bool render_shader;
+    bool damage_tracking;
+
+    unsigned frame_slots; // 1 for a single pending frame (lowest latency)
+    enum sc_frame_buffer_policy frame_policy;
+    bool pacing; // present frames on the vblank minimizing judder
+    // request the device to cap its frame rate to the display refresh rate
+    bool match_display_rate;
+    // consume and present the frames on a dedicated thread (not with pacing)
+    bool render_thread;
+    // icon loading in progress (may be NULL to load it synchronously)
+    struct scrcpy_icon_loader *icon_loader;
 
     bool fullscreen;
     bool start_fps_counter;
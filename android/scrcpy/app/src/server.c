@@ -64,11 +64,44 @@ push_server(struct sc_intr *intr, const char *serial) {
         free(server_path);
         return false;
     }
-    bool ok = sc_adb_push(intr, serial, server_path, SC_DEVICE_SERVER_PATH, 0);
+    // The server is pushed on every start, skip the transfer if the same file
+    // (same size and modification time) is already on the device
+    bool ok = sc_adb_push(intr, serial, server_path, SC_DEVICE_SERVER_PATH,
+                          SC_ADB_PUSH_SYNC);
     free(server_path);
     return ok;
 }
 
+static int
+run_push_server(void *data) {
+    struct sc_server *server = data;
+
+    sc_tick start = sc_tick_now();
+    bool ok = push_server(&server->push_intr, server->serial);
+    if (!ok) {
+        return -1;
+    }
+
+    LOGD("Startup: server pushed in %" PRItick " ms",
+         SC_TICK_TO_MS(sc_tick_now() - start));
+    return 0;
+}
+
+static bool
+sc_server_join_push(sc_thread *push_thread) {
+    int status;
+    sc_thread_join(push_thread, &status);
+    return !status;
+}
+
+static void
+sc_server_log_phase(const char *name, sc_tick *phase_start) {
+    sc_tick now = sc_tick_now();
+    LOGD("Startup: %s in %" PRItick " ms", name,
+         SC_TICK_TO_MS(now - *phase_start));
+    *phase_start = now;
+}
+
 static const char *
 log_level_to_server_string(enum sc_log_level level) {
     switch (level) {
@@ -335,6 +368,9 @@ execute_server(struct sc_server *server,
     if (params->display_id) {
         ADD_PARAM("display_id=%" PRIu32, params->display_id);
     }
+    if (params->extra_display_id != SC_DISPLAY_ID_NONE) {
+        ADD_PARAM("extra_display_id=%" PRIu32, params->extra_display_id);
+    }
     if (params->camera_id) {
         VALIDATE_STRING(params->camera_id);
         ADD_PARAM("camera_id=%s", params->camera_id);
@@ -387,6 +423,14 @@ execute_server(struct sc_server *server,
     if (params->power_off_on_close) {
         ADD_PARAM("power_off_on_close=true");
     }
+    if (params->resume) {
+        ADD_PARAM("resume=true");
+    }
+#ifdef HAVE_USB
+    if (params->usb_transport) {
+        ADD_PARAM("transport=usb");
+    }
+#endif
     if (!params->clipboard_autosync) {
         // By default, clipboard_autosync is true
         ADD_PARAM("clipboard_autosync=false");
@@ -540,8 +584,27 @@ sc_server_init(struct sc_server *server, const struct sc_server_params *params,
         return false;
     }
 
+    ok = sc_cond_init(&server->cond_resumed);
+    if (!ok) {
+        sc_cond_destroy(&server->cond_stopped);
+        sc_mutex_destroy(&server->mutex);
+        sc_adb_destroy();
+        return false;
+    }
+
     ok = sc_intr_init(&server->intr);
     if (!ok) {
+        sc_cond_destroy(&server->cond_resumed);
+        sc_cond_destroy(&server->cond_stopped);
+        sc_mutex_destroy(&server->mutex);
+        sc_adb_destroy();
+        return false;
+    }
+
+    ok = sc_intr_init(&server->push_intr);
+    if (!ok) {
+        sc_intr_destroy(&server->intr);
+        sc_cond_destroy(&server->cond_resumed);
         sc_cond_destroy(&server->cond_stopped);
         sc_mutex_destroy(&server->mutex);
         sc_adb_destroy();
@@ -555,6 +618,14 @@ sc_server_init(struct sc_server *server, const struct sc_server_params *params,
     server->video_socket = SC_SOCKET_NONE;
     server->audio_socket = SC_SOCKET_NONE;
     server->control_socket = SC_SOCKET_NONE;
+    server->extra_video_socket = SC_SOCKET_NONE;
+
+    sc_vector_init(&server->retired_sockets);
+    server->resuming = false;
+
+#ifdef HAVE_USB
+    server->usb_transport_initialized = false;
+#endif
 
     sc_adb_tunnel_init(&server->tunnel);
 
@@ -585,8 +656,104 @@ device_read_info(struct sc_intr *intr, sc_socket device_socket,
     return true;
 }
 
+static void
+sc_server_tune_sockets(enum sc_socket_profile profile, sc_socket video_socket,
+                       sc_socket audio_socket, sc_socket control_socket) {
+    // Errors are logged but not fatal: the sockets work without tuning
+    switch (profile) {
+        case SC_SOCKET_PROFILE_DEFAULT:
+            break;
+        case SC_SOCKET_PROFILE_LOW_LATENCY: {
+            // DSCP "Expedited Forwarding" for the small, latency-sensitive
+            // streams, "AF41" (interactive video) for the video stream
+#define SC_TOS_EF (46 << 2)
+#define SC_TOS_AF41 (34 << 2)
+#define SC_BUSY_POLL_USEC 50
+            sc_socket sockets[] = {video_socket, audio_socket, control_socket};
+            int tos[] = {SC_TOS_AF41, SC_TOS_EF, SC_TOS_EF};
+            for (size_t i = 0; i < ARRAY_LEN(sockets); ++i) {
+                if (sockets[i] != SC_SOCKET_NONE) {
+                    net_set_tos(sockets[i], tos[i]);
+                    net_set_busy_poll(sockets[i], SC_BUSY_POLL_USEC);
+                }
+            }
+            break;
+        }
+        case SC_SOCKET_PROFILE_THROUGHPUT:
+            // Absorb bursts of large video packets (e.g. key frames)
+            if (video_socket != SC_SOCKET_NONE) {
+                net_set_recv_buffer_size(video_socket, 4 << 20); // 4 MiB
+            }
+            break;
+        default:
+            assert(!"unexpected socket profile");
+    }
+}
+
+#ifdef HAVE_USB
+static bool
+sc_server_connect_usb(struct sc_server *server, struct sc_server_info *info) {
+    bool video = server->params.video;
+    bool audio = server->params.audio;
+    bool control = server->params.control;
+    bool extra_video =
+        server->params.extra_display_id != SC_DISPLAY_ID_NONE;
+
+    // The streams are numbered in the order of the adb tunnel connections
+    unsigned count = 0;
+    int control_index = -1;
+    int video_index = video ? (int) count++ : -1;
+    int audio_index = audio ? (int) count++ : -1;
+    if (control) {
+        control_index = count++;
+    }
+    int extra_video_index = extra_video ? (int) count++ : -1;
+    assert(count);
+
+    struct sc_usb_transport *transport = &server->usb_transport;
+    bool ok = sc_usb_transport_init(transport, server->serial);
+    if (!ok) {
+        return false;
+    }
+
+    sc_socket sockets[SC_USB_TRANSPORT_MAX_STREAMS];
+    ok = sc_usb_transport_start(transport, count, control_index, sockets);
+    if (!ok) {
+        sc_usb_transport_destroy(transport);
+        return false;
+    }
+
+    // The transport threads use the sockets until they are joined on destroy
+    server->usb_transport_initialized = true;
+
+    // The sockets will be closed on destroy if device_read_info() fails
+    sc_mutex_lock(&server->mutex);
+    bool stopped = server->stopped;
+    server->video_socket = video ? sockets[video_index] : SC_SOCKET_NONE;
+    server->audio_socket = audio ? sockets[audio_index] : SC_SOCKET_NONE;
+    server->control_socket = control ? sockets[control_index]
+                                     : SC_SOCKET_NONE;
+    server->extra_video_socket = extra_video ? sockets[extra_video_index]
+                                             : SC_SOCKET_NONE;
+    sc_mutex_unlock(&server->mutex);
+
+    if (stopped) {
+        return false;
+    }
+
+    // The first socket carries the device info, as over the adb tunnel
+    return device_read_info(&server->intr, sockets[0], info);
+}
+#endif
+
 static bool
 sc_server_connect_to(struct sc_server *server, struct sc_server_info *info) {
+#ifdef HAVE_USB
+    if (server->params.usb_transport) {
+        return sc_server_connect_usb(server, info);
+    }
+#endif
+
     struct sc_adb_tunnel *tunnel = &server->tunnel;
 
     assert(tunnel->enabled);
@@ -597,10 +764,15 @@ sc_server_connect_to(struct sc_server *server, struct sc_server_info *info) {
     bool video = server->params.video;
     bool audio = server->params.audio;
     bool control = server->params.control;
+    // The secondary video stream is connected last, so that the order of the
+    // other sockets does not depend on it
+    bool extra_video =
+        server->params.extra_display_id != SC_DISPLAY_ID_NONE;
 
     sc_socket video_socket = SC_SOCKET_NONE;
     sc_socket audio_socket = SC_SOCKET_NONE;
     sc_socket control_socket = SC_SOCKET_NONE;
+    sc_socket extra_video_socket = SC_SOCKET_NONE;
     if (!tunnel->forward) {
         if (video) {
             video_socket =
@@ -625,6 +797,14 @@ sc_server_connect_to(struct sc_server *server, struct sc_server_info *info) {
                 goto fail;
             }
         }
+
+        if (extra_video) {
+            extra_video_socket =
+                net_accept_intr(&server->intr, tunnel->server_socket);
+            if (extra_video_socket == SC_SOCKET_NONE) {
+                goto fail;
+            }
+        }
     } else {
         uint32_t tunnel_host = server->params.tunnel_host;
         if (!tunnel_host) {
@@ -679,6 +859,20 @@ sc_server_connect_to(struct sc_server *server, struct sc_server_info *info) {
                 }
             }
         }
+
+        if (extra_video) {
+            // It requires the main video stream, so it is never the first
+            assert(video);
+            extra_video_socket = net_socket();
+            if (extra_video_socket == SC_SOCKET_NONE) {
+                goto fail;
+            }
+            bool ok = net_connect_intr(&server->intr, extra_video_socket,
+                                       tunnel_host, tunnel_port);
+            if (!ok) {
+                goto fail;
+            }
+        }
     }
 
     if (control_socket != SC_SOCKET_NONE) {
@@ -689,9 +883,17 @@ sc_server_connect_to(struct sc_server *server, struct sc_server_info *info) {
         (void) ok; // error already logged
     }
 
-    // we don't need the adb tunnel anymore
-    sc_adb_tunnel_close(tunnel, &server->intr, serial,
-                        server->device_socket_name);
+    sc_server_tune_sockets(server->params.socket_profile, video_socket,
+                           audio_socket, control_socket);
+    // Tuned as a video socket
+    sc_server_tune_sockets(server->params.socket_profile, extra_video_socket,
+                           SC_SOCKET_NONE, SC_SOCKET_NONE);
+
+    if (!server->params.resume) {
+        // we don't need the adb tunnel anymore
+        sc_adb_tunnel_close(tunnel, &server->intr, serial,
+                            server->device_socket_name);
+    } // else keep it to reconnect the sockets on disconnection
 
     sc_socket first_socket = video ? video_socket
                            : audio ? audio_socket
@@ -706,10 +908,22 @@ sc_server_connect_to(struct sc_server *server, struct sc_server_info *info) {
     assert(!video || video_socket != SC_SOCKET_NONE);
     assert(!audio || audio_socket != SC_SOCKET_NONE);
     assert(!control || control_socket != SC_SOCKET_NONE);
+    assert(!extra_video || extra_video_socket != SC_SOCKET_NONE);
+
+    sc_mutex_lock(&server->mutex);
+    // Once stopped, the sockets would not be interrupted anymore
+    bool stopped = server->stopped;
+    if (!stopped) {
+        server->video_socket = video_socket;
+        server->audio_socket = audio_socket;
+        server->control_socket = control_socket;
+        server->extra_video_socket = extra_video_socket;
+    }
+    sc_mutex_unlock(&server->mutex);
 
-    server->video_socket = video_socket;
-    server->audio_socket = audio_socket;
-    server->control_socket = control_socket;
+    if (stopped) {
+        goto fail;
+    }
 
     return true;
 
@@ -732,6 +946,12 @@ fail:
         }
     }
 
+    if (extra_video_socket != SC_SOCKET_NONE) {
+        if (!net_close(extra_video_socket)) {
+            LOGW("Could not close extra video socket");
+        }
+    }
+
     if (tunnel->enabled) {
         // Always leave this function with tunnel disabled
         sc_adb_tunnel_close(tunnel, &server->intr, serial,
@@ -943,6 +1163,9 @@ run_server(void *data) {
 
     const struct sc_server_params *params = &server->params;
 
+    sc_tick startup = sc_tick_now();
+    sc_tick phase_start = startup;
+
     // Execute "adb start-server" before "adb devices" so that daemon starting
     // output/errors is correctly printed in the console ("adb devices" output
     // is parsed, so it is not output)
@@ -952,6 +1175,8 @@ run_server(void *data) {
         goto error_connection_failed;
     }
 
+    sc_server_log_phase("adb server started", &phase_start);
+
     // params->tcpip_dst implies params->tcpip
     assert(!params->tcpip_dst || params->tcpip);
 
@@ -1028,14 +1253,26 @@ run_server(void *data) {
     assert(serial);
     LOGD("Device serial: %s", serial);
 
-    ok = push_server(&server->intr, serial);
+    sc_server_log_phase("device selected", &phase_start);
+
+    // Push the server while the tunnel is set up: both are independent adb
+    // commands, only execute_server() requires both
+    sc_thread push_thread;
+    ok = sc_thread_create(&push_thread, run_push_server, "scrcpy-push",
+                          server);
     if (!ok) {
+        LOGE("Could not start push thread");
         goto error_connection_failed;
     }
 
     // If --list-* is passed, then the server just prints the requested data
     // then exits.
     if (params->list) {
+        ok = sc_server_join_push(&push_thread);
+        if (!ok) {
+            goto error_connection_failed;
+        }
+
         sc_pid pid = execute_server(server, params);
         if (pid == SC_PROCESS_NONE) {
             goto error_connection_failed;
@@ -1051,23 +1288,44 @@ run_server(void *data) {
                      params->scid);
     if (r == -1) {
         LOG_OOM();
+        sc_server_join_push(&push_thread);
         goto error_connection_failed;
     }
     assert(r == sizeof(SC_SOCKET_NAME_PREFIX) - 1 + 8);
     assert(server->device_socket_name);
 
-    ok = sc_adb_tunnel_open(&server->tunnel, &server->intr, serial,
-                            server->device_socket_name, params->port_range,
-                            params->force_adb_forward);
+#ifdef HAVE_USB
+    bool usb_transport = params->usb_transport;
+#else
+    bool usb_transport = false;
+#endif
+
+    if (!usb_transport) {
+        ok = sc_adb_tunnel_open(&server->tunnel, &server->intr, serial,
+                                server->device_socket_name, params->port_range,
+                                params->force_adb_forward);
+    }
+    bool pushed = sc_server_join_push(&push_thread);
     if (!ok) {
         goto error_connection_failed;
     }
+    if (!pushed) {
+        if (server->tunnel.enabled) {
+            sc_adb_tunnel_close(&server->tunnel, &server->intr, serial,
+                                server->device_socket_name);
+        }
+        goto error_connection_failed;
+    }
+
+    sc_server_log_phase("server pushed and tunnel opened", &phase_start);
 
     // server will connect to our server socket
     sc_pid pid = execute_server(server, params);
     if (pid == SC_PROCESS_NONE) {
-        sc_adb_tunnel_close(&server->tunnel, &server->intr, serial,
-                            server->device_socket_name);
+        if (server->tunnel.enabled) {
+            sc_adb_tunnel_close(&server->tunnel, &server->intr, serial,
+                                server->device_socket_name);
+        }
         goto error_connection_failed;
     }
 
@@ -1079,8 +1337,10 @@ run_server(void *data) {
     if (!ok) {
         sc_process_terminate(pid);
         sc_process_wait(pid, true); // ignore exit code
-        sc_adb_tunnel_close(&server->tunnel, &server->intr, serial,
-                            server->device_socket_name);
+        if (server->tunnel.enabled) {
+            sc_adb_tunnel_close(&server->tunnel, &server->intr, serial,
+                                server->device_socket_name);
+        }
         goto error_connection_failed;
     }
 
@@ -1094,6 +1354,10 @@ run_server(void *data) {
         goto error_connection_failed;
     }
 
+    sc_server_log_phase("server executed and connected", &phase_start);
+    LOGD("Startup: total %" PRItick " ms",
+         SC_TICK_TO_MS(phase_start - startup));
+
     // Now connected
     server->cbs->on_connected(server, server->cbs_userdata);
 
@@ -1102,7 +1366,11 @@ run_server(void *data) {
     while (!server->stopped) {
         sc_cond_wait(&server->cond_stopped, &server->mutex);
     }
-    sc_mutex_unlock(&server->mutex);
+
+    // The intr is interrupted, so any pending sc_server_resume() fails quickly
+    while (server->resuming) {
+        sc_cond_wait(&server->cond_resumed, &server->mutex);
+    }
 
     // Interrupt sockets to wake up socket blocking calls on the server
 
@@ -1121,6 +1389,29 @@ run_server(void *data) {
         net_interrupt(server->control_socket);
     }
 
+    if (server->extra_video_socket != SC_SOCKET_NONE) {
+        // There is no extra_video_socket without --extra-display-id
+        net_interrupt(server->extra_video_socket);
+    }
+
+#ifdef HAVE_USB
+    if (server->usb_transport_initialized) {
+        sc_usb_transport_stop(&server->usb_transport);
+    }
+#endif
+    sc_mutex_unlock(&server->mutex);
+
+    if (server->tunnel.enabled) {
+        // The tunnel is kept open with --resume. The server intr is already
+        // interrupted, so remove it through a new one.
+        struct sc_intr intr;
+        if (sc_intr_init(&intr)) {
+            sc_adb_tunnel_close(&server->tunnel, &intr, serial,
+                                server->device_socket_name);
+            sc_intr_destroy(&intr);
+        }
+    }
+
     // Give some delay for the server to terminate properly
 #define WATCHDOG_DELAY SC_TICK_FROM_SEC(1)
     sc_tick deadline = sc_tick_now() + WATCHDOG_DELAY;
@@ -1164,12 +1455,107 @@ sc_server_start(struct sc_server *server) {
     return true;
 }
 
+static sc_socket *
+sc_server_stream_socket(struct sc_server *server,
+                        enum sc_server_stream stream) {
+    switch (stream) {
+        case SC_SERVER_STREAM_VIDEO:
+            return &server->video_socket;
+        case SC_SERVER_STREAM_AUDIO:
+            return &server->audio_socket;
+        case SC_SERVER_STREAM_CONTROL:
+            return &server->control_socket;
+        case SC_SERVER_STREAM_EXTRA_VIDEO:
+            return &server->extra_video_socket;
+        default:
+            assert(!"unexpected stream");
+            return NULL;
+    }
+}
+
+static void
+sc_server_retire_socket(struct sc_server *server, sc_socket socket) {
+    if (socket == SC_SOCKET_NONE) {
+        return;
+    }
+
+    // Wake up the stream threads still blocked on the previous connection
+    net_interrupt(socket);
+
+    bool ok = sc_vector_push(&server->retired_sockets, socket);
+    if (!ok) {
+        // The socket may still be in use, it cannot be closed
+        LOG_OOM();
+    }
+}
+
+sc_socket
+sc_server_resume(struct sc_server *server, enum sc_server_stream stream,
+                 sc_socket old_socket) {
+    if (!server->params.resume) {
+        return SC_SOCKET_NONE;
+    }
+
+    sc_mutex_lock(&server->mutex);
+    while (server->resuming) {
+        sc_cond_wait(&server->cond_resumed, &server->mutex);
+    }
+
+    sc_socket *socket = sc_server_stream_socket(server, stream);
+    if (*socket != old_socket) {
+        // Another stream thread already reconnected (or failed to)
+        sc_socket new_socket = *socket;
+        sc_mutex_unlock(&server->mutex);
+        return new_socket;
+    }
+
+    if (server->stopped || !server->tunnel.enabled) {
+        // The tunnel is closed on the first reconnection failure
+        sc_mutex_unlock(&server->mutex);
+        return SC_SOCKET_NONE;
+    }
+
+    server->resuming = true;
+
+    sc_server_retire_socket(server, server->video_socket);
+    sc_server_retire_socket(server, server->audio_socket);
+    sc_server_retire_socket(server, server->control_socket);
+    sc_server_retire_socket(server, server->extra_video_socket);
+    server->video_socket = SC_SOCKET_NONE;
+    server->audio_socket = SC_SOCKET_NONE;
+    server->control_socket = SC_SOCKET_NONE;
+    server->extra_video_socket = SC_SOCKET_NONE;
+    sc_mutex_unlock(&server->mutex);
+
+    LOGW("Device connection lost, resuming...");
+    sc_tick start = sc_tick_now();
+
+    // The device name is sent again, but it is the same
+    struct sc_server_info info;
+    bool ok = sc_server_connect_to(server, &info);
+    if (ok) {
+        LOGI("Session resumed in %" PRItick " ms",
+             SC_TICK_TO_MS(sc_tick_now() - start));
+    } else {
+        LOGE("Could not resume the session");
+    }
+
+    sc_mutex_lock(&server->mutex);
+    server->resuming = false;
+    sc_cond_broadcast(&server->cond_resumed);
+    sc_socket new_socket = *socket;
+    sc_mutex_unlock(&server->mutex);
+
+    return new_socket;
+}
+
 void
 sc_server_stop(struct sc_server *server) {
     sc_mutex_lock(&server->mutex);
     server->stopped = true;
     sc_cond_signal(&server->cond_stopped);
     sc_intr_interrupt(&server->intr);
+    sc_intr_interrupt(&server->push_intr);
     sc_mutex_unlock(&server->mutex);
 }
 
@@ -1180,6 +1566,15 @@ sc_server_join(struct sc_server *server) {
 
 void
 sc_server_destroy(struct sc_server *server) {
+#ifdef HAVE_USB
+    if (server->usb_transport_initialized) {
+        // The stream threads are joined, the sockets are not used anymore
+        sc_usb_transport_stop(&server->usb_transport);
+        sc_usb_transport_join(&server->usb_transport);
+        sc_usb_transport_destroy(&server->usb_transport);
+    }
+#endif
+
     if (server->video_socket != SC_SOCKET_NONE) {
         net_close(server->video_socket);
     }
@@ -1189,10 +1584,19 @@ sc_server_destroy(struct sc_server *server) {
     if (server->control_socket != SC_SOCKET_NONE) {
         net_close(server->control_socket);
     }
+    if (server->extra_video_socket != SC_SOCKET_NONE) {
+        net_close(server->extra_video_socket);
+    }
+    for (size_t i = 0; i < server->retired_sockets.size; ++i) {
+        net_close(server->retired_sockets.data[i]);
+    }
+    sc_vector_destroy(&server->retired_sockets);
 
     free(server->serial);
     free(server->device_socket_name);
+    sc_intr_destroy(&server->push_intr);
     sc_intr_destroy(&server->intr);
+    sc_cond_destroy(&server->cond_resumed);
     sc_cond_destroy(&server->cond_stopped);
     sc_mutex_destroy(&server->mutex);
 
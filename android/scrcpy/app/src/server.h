@@ -12,6 +12,10 @@
 #include "util/net.h"
 #include "util/thread.h"
 #include "util/tick.h"
+#include "util/vector.h"
+#ifdef HAVE_USB
+# include "usb/usb_transport.h"
+#endif
 
 #define SC_DEVICE_NAME_FIELD_LENGTH 64
 struct sc_server_info {
@@ -39,6 +43,7 @@ struct sc_server_params {
     struct sc_port_range port_range;
     uint32_t tunnel_host;
     uint16_t tunnel_port;
+    enum sc_socket_profile socket_profile;
     uint16_t max_size;
     uint32_t video_bit_rate;
     uint32_t audio_bit_rate;
@@ -49,6 +54,8 @@ struct sc_server_params {
     enum sc_orientation_lock capture_orientation_lock;
     bool control;
     uint32_t display_id;
+    // SC_DISPLAY_ID_NONE if no secondary video stream is requested
+    uint32_t extra_display_id;
     const char *new_display;
     enum sc_display_ime_policy display_ime_policy;
     bool video;
@@ -67,6 +74,10 @@ struct sc_server_params {
     bool cleanup;
     bool power_on;
     bool kill_adb_on_close;
+    bool resume;
+#ifdef HAVE_USB
+    bool usb_transport;
+#endif
     bool camera_high_speed;
     bool vd_destroy_content;
     bool vd_system_decorations;
@@ -87,16 +98,44 @@ struct sc_server {
     bool stopped;
 
     struct sc_intr intr;
+    // the server is pushed concurrently with the tunnel setup, so it needs
+    // its own interruptor
+    struct sc_intr push_intr;
     struct sc_adb_tunnel tunnel;
 
+    // The sockets may be replaced by sc_server_resume() (protected by the
+    // mutex once connected)
     sc_socket video_socket;
     sc_socket audio_socket;
     sc_socket control_socket;
+    // secondary video stream, only if params.extra_display_id is set
+    sc_socket extra_video_socket;
+
+    // With --resume, the sockets of the previous connections are shut down,
+    // but only closed on destroy, since the stream threads may still use them
+    // until they notice the disconnection
+    struct SC_VECTOR(sc_socket) retired_sockets;
+    bool resuming; // a stream thread is reconnecting the sockets
+    sc_cond cond_resumed;
+
+#ifdef HAVE_USB
+    // With --usb-transport, the sockets are the local ends of the transport,
+    // and the adb tunnel is never opened
+    struct sc_usb_transport usb_transport;
+    bool usb_transport_initialized;
+#endif
 
     const struct sc_server_callbacks *cbs;
     void *cbs_userdata;
 };
 
+enum sc_server_stream {
+    SC_SERVER_STREAM_VIDEO,
+    SC_SERVER_STREAM_AUDIO,
+    SC_SERVER_STREAM_CONTROL,
+    SC_SERVER_STREAM_EXTRA_VIDEO,
+};
+
 struct sc_server_callbacks {
     /**
      * Called when the server failed to connect
@@ -130,6 +169,19 @@ sc_server_start(struct sc_server *server);
 void
 sc_server_stop(struct sc_server *server);
 
+// reconnect the sockets through the adb tunnel after a transient
+// disconnection (--resume)
+//
+// It is called from the stream threads (demuxers, controller and receiver)
+// with the socket which has been closed: the first one reconnects all the
+// sockets, the others just retrieve their new socket.
+//
+// Return the new socket of the stream, or SC_SOCKET_NONE if the session could
+// not be resumed.
+sc_socket
+sc_server_resume(struct sc_server *server, enum sc_server_stream stream,
+                 sc_socket old_socket);
+
 // join the server thread
 void
 sc_server_join(struct sc_server *server);
@@ -0,0 +1,466 @@
+#include "snapshot.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "util/file.h"
+#include "util/log.h"
+#include "util/yuv.h"
+
+/** Downcast frame_sink to sc_snapshot */
+#define DOWNCAST(SINK) container_of(SINK, struct sc_snapshot, frame_sink)
+
+// JPEG quantizer scale (lower is better), 3 is visually lossless
+#define SC_SNAPSHOT_JPEG_QSCALE 3
+
+static const char *
+sc_snapshot_get_encoder_name(enum sc_snapshot_format format) {
+    switch (format) {
+        case SC_SNAPSHOT_FORMAT_PNG:
+            return "png";
+        case SC_SNAPSHOT_FORMAT_JPEG:
+            return "mjpeg";
+        case SC_SNAPSHOT_FORMAT_WEBP:
+            return "libwebp";
+        default:
+            assert(!"unexpected snapshot format");
+            return NULL;
+    }
+}
+
+static const char *
+sc_snapshot_get_extension(enum sc_snapshot_format format) {
+    switch (format) {
+        case SC_SNAPSHOT_FORMAT_PNG:
+            return "png";
+        case SC_SNAPSHOT_FORMAT_JPEG:
+            return "jpg";
+        case SC_SNAPSHOT_FORMAT_WEBP:
+            return "webp";
+        default:
+            assert(!"unexpected snapshot format");
+            return NULL;
+    }
+}
+
+// The PNG encoder does not accept YUV input
+static bool
+sc_snapshot_convert_to_rgba(struct sc_snapshot *snapshot,
+                            const AVFrame *frame) {
+    AVFrame *rgba = snapshot->rgba_frame;
+    rgba->format = AV_PIX_FMT_RGBA;
+    rgba->width = frame->width;
+    rgba->height = frame->height;
+
+    int r = av_frame_get_buffer(rgba, 0);
+    if (r < 0) {
+        LOG_OOM();
+        return false;
+    }
+
+    bool bt709 = frame->colorspace == AVCOL_SPC_BT709;
+    bool full_range = frame->color_range == AVCOL_RANGE_JPEG;
+    const struct sc_yuv_coeffs *coeffs = sc_yuv_get_coeffs(bt709, full_range);
+
+    size_t width = frame->width;
+    for (int y = 0; y < frame->height; ++y) {
+        uint8_t *dst = rgba->data[0] + y * rgba->linesize[0];
+        const uint8_t *src_y = frame->data[0] + y * frame->linesize[0];
+        const uint8_t *src_u = frame->data[1] + (y / 2) * frame->linesize[1];
+        const uint8_t *src_v = frame->data[2] + (y / 2) * frame->linesize[2];
+        sc_yuv_to_bgra(dst, src_y, src_u, src_v, width, coeffs);
+
+        // BGRA to RGBA
+        for (size_t x = 0; x < width; ++x) {
+            uint8_t b = dst[4 * x];
+            dst[4 * x] = dst[4 * x + 2];
+            dst[4 * x + 2] = b;
+        }
+    }
+
+    return true;
+}
+
+static bool
+sc_snapshot_encode(struct sc_snapshot *snapshot, const AVFrame *frame) {
+    const char *name = sc_snapshot_get_encoder_name(snapshot->format);
+    const AVCodec *encoder = avcodec_find_encoder_by_name(name);
+    if (!encoder) {
+        LOGE("Snapshot: encoder %s not available", name);
+        return false;
+    }
+
+    if (frame->format != AV_PIX_FMT_YUV420P) {
+        LOGE("Snapshot: unsupported frame format: %d", frame->format);
+        return false;
+    }
+
+    if (snapshot->format == SC_SNAPSHOT_FORMAT_PNG) {
+        if (!sc_snapshot_convert_to_rgba(snapshot, frame)) {
+            return false;
+        }
+        frame = snapshot->rgba_frame;
+    }
+
+    AVCodecContext *enc = avcodec_alloc_context3(encoder);
+    if (!enc) {
+        LOG_OOM();
+        return false;
+    }
+
+    enc->width = frame->width;
+    enc->height = frame->height;
+    enc->pix_fmt = frame->format;
+    enc->time_base = (AVRational) {1, 1};
+    enc->color_range = frame->color_range;
+    enc->colorspace = frame->colorspace;
+
+    if (snapshot->format == SC_SNAPSHOT_FORMAT_JPEG) {
+        enc->flags |= AV_CODEC_FLAG_QSCALE;
+        enc->global_quality = FF_QP2LAMBDA * SC_SNAPSHOT_JPEG_QSCALE;
+        if (frame->color_range != AVCOL_RANGE_JPEG) {
+            // Limited range YUV is valid, but non-standard, in JPEG
+            enc->strict_std_compliance = FF_COMPLIANCE_UNOFFICIAL;
+        }
+    }
+
+    bool ok = false;
+
+    int r = avcodec_open2(enc, encoder, NULL);
+    if (r < 0) {
+        LOGE("Snapshot: could not open encoder %s: %d", name, r);
+        goto end;
+    }
+
+    r = avcodec_send_frame(enc, frame);
+    if (r < 0) {
+        LOGE("Snapshot: could not encode frame: %d", r);
+        goto end;
+    }
+
+    // Flush, so that the packet is available even for encoders with delay
+    r = avcodec_send_frame(enc, NULL);
+    if (r < 0) {
+        LOGE("Snapshot: could not flush encoder: %d", r);
+        goto end;
+    }
+
+    r = avcodec_receive_packet(enc, snapshot->packet);
+    if (r < 0) {
+        LOGE("Snapshot: could not receive packet: %d", r);
+        goto end;
+    }
+
+    ok = true;
+
+end:
+    avcodec_free_context(&enc);
+    av_frame_unref(snapshot->rgba_frame);
+
+    return ok;
+}
+
+// Return a new path "[dir/]scrcpy-YYYYMMDD-HHMMSS[-N].ext" which does not
+// exist yet
+static char *
+sc_snapshot_make_path(struct sc_snapshot *snapshot) {
+    time_t now = time(NULL);
+    struct tm *tm = localtime(&now);
+    if (!tm) {
+        LOGE("Snapshot: could not get the local time");
+        return NULL;
+    }
+
+    char basename[32];
+    size_t len = strftime(basename, sizeof(basename), "scrcpy-%Y%m%d-%H%M%S",
+                          tm);
+    if (!len) {
+        return NULL;
+    }
+
+    const char *ext = sc_snapshot_get_extension(snapshot->format);
+    const char *dir = snapshot->dir;
+
+    // dir + separator + basename + "-NNNNNNNNNN." + ext + '\0'
+    size_t size = (dir ? strlen(dir) + 1 : 0) + len + 12 + strlen(ext) + 1;
+    char *path = malloc(size);
+    if (!path) {
+        LOG_OOM();
+        return NULL;
+    }
+
+    const char sep[] = {SC_PATH_SEPARATOR, '\0'};
+    const char *prefix = dir ? dir : "";
+    const char *prefix_sep = dir ? sep : "";
+
+    for (unsigned i = 1; i; ++i) {
+        int r;
+        if (i == 1) {
+            r = snprintf(path, size, "%s%s%s.%s", prefix, prefix_sep,
+                         basename, ext);
+        } else {
+            r = snprintf(path, size, "%s%s%s-%u.%s", prefix, prefix_sep,
+                         basename, i, ext);
+        }
+        assert(r > 0 && (size_t) r < size);
+        (void) r;
+
+        if (!sc_file_is_regular(path)) {
+            return path;
+        }
+    }
+
+    free(path);
+    return NULL;
+}
+
+static bool
+sc_snapshot_save(struct sc_snapshot *snapshot, const AVFrame *frame) {
+    if (!sc_snapshot_encode(snapshot, frame)) {
+        return false;
+    }
+
+    AVPacket *packet = snapshot->packet;
+    bool ok = false;
+
+    char *path = sc_snapshot_make_path(snapshot);
+    if (!path) {
+        goto end;
+    }
+
+    FILE *file = sc_file_open(path, "wb");
+    if (!file) {
+        LOGE("Snapshot: could not open %s", path);
+        goto end;
+    }
+
+    size_t w = fwrite(packet->data, 1, packet->size, file);
+    // fclose() must always be called
+    bool closed = !fclose(file);
+    if (w != (size_t) packet->size || !closed) {
+        LOGE("Snapshot: could not write %s", path);
+        sc_file_remove(path);
+        goto end;
+    }
+
+    LOGI("Snapshot saved to %s (%dx%d)", path, frame->width, frame->height);
+    ok = true;
+
+end:
+    free(path);
+    av_packet_unref(packet);
+
+    return ok;
+}
+
+static int
+run_snapshot(void *data) {
+    struct sc_snapshot *snapshot = data;
+
+    for (;;) {
+        sc_mutex_lock(&snapshot->mutex);
+
+        while (!snapshot->stopped && !snapshot->has_frame) {
+            sc_cond_wait(&snapshot->cond, &snapshot->mutex);
+        }
+
+        if (snapshot->stopped) {
+            sc_mutex_unlock(&snapshot->mutex);
+            break;
+        }
+
+        // Release the pending slot immediately, so that the next snapshot may
+        // be requested while this one is encoded
+        av_frame_move_ref(snapshot->frame, snapshot->pending_frame);
+        snapshot->has_frame = false;
+        sc_mutex_unlock(&snapshot->mutex);
+
+        sc_snapshot_save(snapshot, snapshot->frame);
+        av_frame_unref(snapshot->frame);
+    }
+
+    LOGD("Snapshot thread ended");
+
+    return 0;
+}
+
+static bool
+sc_snapshot_open(struct sc_snapshot *snapshot, const AVCodecContext *ctx) {
+    (void) ctx;
+
+    bool ok = sc_mutex_init(&snapshot->mutex);
+    if (!ok) {
+        return false;
+    }
+
+    ok = sc_cond_init(&snapshot->cond);
+    if (!ok) {
+        goto error_mutex_destroy;
+    }
+
+    snapshot->pending_frame = av_frame_alloc();
+    if (!snapshot->pending_frame) {
+        LOG_OOM();
+        goto error_cond_destroy;
+    }
+
+    snapshot->frame = av_frame_alloc();
+    if (!snapshot->frame) {
+        LOG_OOM();
+        goto error_free_pending_frame;
+    }
+
+    snapshot->rgba_frame = av_frame_alloc();
+    if (!snapshot->rgba_frame) {
+        LOG_OOM();
+        goto error_free_frame;
+    }
+
+    snapshot->packet = av_packet_alloc();
+    if (!snapshot->packet) {
+        LOG_OOM();
+        goto error_free_rgba_frame;
+    }
+
+    snapshot->has_frame = false;
+    snapshot->stopped = false;
+
+    LOGD("Starting snapshot thread");
+    ok = sc_thread_create(&snapshot->thread, run_snapshot, "scrcpy-snapshot",
+                          snapshot);
+    if (!ok) {
+        LOGE("Could not start snapshot thread");
+        goto error_free_packet;
+    }
+
+    return true;
+
+error_free_packet:
+    av_packet_free(&snapshot->packet);
+error_free_rgba_frame:
+    av_frame_free(&snapshot->rgba_frame);
+error_free_frame:
+    av_frame_free(&snapshot->frame);
+error_free_pending_frame:
+    av_frame_free(&snapshot->pending_frame);
+error_cond_destroy:
+    sc_cond_destroy(&snapshot->cond);
+error_mutex_destroy:
+    sc_mutex_destroy(&snapshot->mutex);
+
+    return false;
+}
+
+static void
+sc_snapshot_close(struct sc_snapshot *snapshot) {
+    sc_mutex_lock(&snapshot->mutex);
+    snapshot->stopped = true;
+    sc_cond_signal(&snapshot->cond);
+    sc_mutex_unlock(&snapshot->mutex);
+
+    sc_thread_join(&snapshot->thread, NULL);
+
+    av_packet_free(&snapshot->packet);
+    av_frame_free(&snapshot->rgba_frame);
+    av_frame_free(&snapshot->frame);
+    av_frame_free(&snapshot->pending_frame); // unreferences a pending frame
+    sc_cond_destroy(&snapshot->cond);
+    sc_mutex_destroy(&snapshot->mutex);
+}
+
+static bool
+sc_snapshot_push(struct sc_snapshot *snapshot, const AVFrame *frame) {
+    // Fast path, for all the frames while no snapshot is requested
+    if (!atomic_load_explicit(&snapshot->requested, memory_order_relaxed)) {
+        return true;
+    }
+
+    if (!atomic_exchange_explicit(&snapshot->requested, false,
+                                  memory_order_relaxed)) {
+        return true;
+    }
+
+    sc_mutex_lock(&snapshot->mutex);
+    if (snapshot->has_frame) {
+        // Only possible if requests are very close to each other
+        sc_mutex_unlock(&snapshot->mutex);
+        LOGW("Snapshot: previous request still pending, ignored");
+        return true;
+    }
+
+    // Take a reference (the frame data is not copied)
+    int r = av_frame_ref(snapshot->pending_frame, frame);
+    if (r) {
+        sc_mutex_unlock(&snapshot->mutex);
+        LOG_OOM();
+        // A failed snapshot must not stop the decoder
+        return true;
+    }
+
+    snapshot->has_frame = true;
+    sc_cond_signal(&snapshot->cond);
+    sc_mutex_unlock(&snapshot->mutex);
+
+    return true;
+}
+
+static bool
+sc_snapshot_frame_sink_open(struct sc_frame_sink *sink,
+                            const AVCodecContext *ctx) {
+    struct sc_snapshot *snapshot = DOWNCAST(sink);
+    return sc_snapshot_open(snapshot, ctx);
+}
+
+static void
+sc_snapshot_frame_sink_close(struct sc_frame_sink *sink) {
+    struct sc_snapshot *snapshot = DOWNCAST(sink);
+    sc_snapshot_close(snapshot);
+}
+
+static bool
+sc_snapshot_frame_sink_push(struct sc_frame_sink *sink,
+                            const AVFrame *frame) {
+    struct sc_snapshot *snapshot = DOWNCAST(sink);
+    return sc_snapshot_push(snapshot, frame);
+}
+
+bool
+sc_snapshot_init(struct sc_snapshot *snapshot, const char *dir,
+                 enum sc_snapshot_format format) {
+    if (dir) {
+        snapshot->dir = strdup(dir);
+        if (!snapshot->dir) {
+            LOG_OOM();
+            return false;
+        }
+    } else {
+        snapshot->dir = NULL;
+    }
+
+    snapshot->format = format;
+    atomic_init(&snapshot->requested, false);
+
+    static const struct sc_frame_sink_ops ops = {
+        .open = sc_snapshot_frame_sink_open,
+        .close = sc_snapshot_frame_sink_close,
+        .push = sc_snapshot_frame_sink_push,
+    };
+
+    snapshot->frame_sink.ops = &ops;
+
+    return true;
+}
+
+void
+sc_snapshot_destroy(struct sc_snapshot *snapshot) {
+    free(snapshot->dir);
+}
+
+void
+sc_snapshot_request(struct sc_snapshot *snapshot) {
+    atomic_store_explicit(&snapshot->requested, true, memory_order_relaxed);
+    LOGD("Snapshot requested");
+}
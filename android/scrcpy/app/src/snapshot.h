@@ -0,0 +1,58 @@
+#ifndef SC_SNAPSHOT_H
+#define SC_SNAPSHOT_H
+
+#include "common.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <libavcodec/avcodec.h>
+
+#include "options.h"
+#include "trait/frame_sink.h"
+#include "util/thread.h"
+
+/**
+ * Snapshot sink, to save the current video frame as an image file
+ *
+ * On request, it takes a reference to the next decoded frame (without
+ * copying it), and encodes it to PNG, JPEG or WebP from a separate thread.
+ *
+ * While no snapshot is requested, pushing a frame is a single atomic load, so
+ * the decoder thread is never blocked.
+ */
+struct sc_snapshot {
+    struct sc_frame_sink frame_sink; // frame sink trait
+
+    char *dir; // NULL for the current directory
+    enum sc_snapshot_format format;
+
+    atomic_bool requested;
+
+    sc_thread thread;
+    sc_mutex mutex;
+    sc_cond cond;
+    bool has_frame;
+    bool stopped;
+
+    AVFrame *pending_frame; // referenced by push(), moved by the thread
+    AVFrame *frame; // only accessed from the snapshot thread
+    AVFrame *rgba_frame; // only used for PNG
+    AVPacket *packet;
+};
+
+bool
+sc_snapshot_init(struct sc_snapshot *snapshot, const char *dir,
+                 enum sc_snapshot_format format);
+
+void
+sc_snapshot_destroy(struct sc_snapshot *snapshot);
+
+/**
+ * Request a snapshot of the next frame
+ *
+ * It may be called from any thread.
+ */
+void
+sc_snapshot_request(struct sc_snapshot *snapshot);
+
+#endif
@@ -0,0 +1,217 @@
+#include "stats.h"
+
+#include <assert.h>
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "util/log.h"
+#include "util/strbuf.h"
+#include "util/tick.h"
+
+struct sc_stats_counter_desc {
+    const char *name; // JSON key, also used for the Prometheus metric name
+    const char *help;
+};
+
+static const struct sc_stats_counter_desc sc_stats_counter_descs[] = {
+    [SC_STATS_VIDEO_PACKETS] = {
+        "video_packets", "Video packets received",
+    },
+    [SC_STATS_VIDEO_BYTES] = {
+        "video_bytes", "Video bytes received",
+    },
+    [SC_STATS_AUDIO_PACKETS] = {
+        "audio_packets", "Audio packets received",
+    },
+    [SC_STATS_AUDIO_BYTES] = {
+        "audio_bytes", "Audio bytes received",
+    },
+    [SC_STATS_FRAMES_RENDERED] = {
+        "frames_rendered", "Video frames rendered",
+    },
+    [SC_STATS_FRAMES_SKIPPED] = {
+        "frames_skipped", "Video frames skipped before being rendered",
+    },
+    [SC_STATS_FRAMES_DECODE_SKIPPED] = {
+        "frames_decode_skipped",
+        "Non-reference video frames dropped before decoding",
+    },
+    [SC_STATS_DECODE_RESYNCS] = {
+        "decode_resyncs",
+        "Video decoding errors recovered at the next key frame",
+    },
+    [SC_STATS_VIDEO_CATCH_UPS] = {
+        "video_catch_ups",
+        "Video backlogs skipped to the next key frame",
+    },
+    [SC_STATS_AUDIO_UNDERFLOW_SAMPLES] = {
+        "audio_underflow_samples",
+        "Silent audio samples inserted on playback buffer underflow",
+    },
+    [SC_STATS_RECORDER_PACKETS_DROPPED] = {
+        "recorder_packets_dropped",
+        "Packets not recorded because the memory budget was exceeded",
+    },
+    [SC_STATS_BUFFERED_FRAMES_DROPPED] = {
+        "buffered_frames_dropped",
+        "Delayed frames dropped because the memory budget was exceeded",
+    },
+    [SC_STATS_CONTROL_MSGS_DROPPED] = {
+        "control_msgs_dropped",
+        "Control messages dropped because the queue or the memory budget "
+        "was full",
+    },
+};
+static_assert(ARRAY_LEN(sc_stats_counter_descs) == SC_STATS_COUNTER_COUNT,
+              "Missing counter descriptions");
+
+static atomic_uint_least64_t sc_stats_counters[SC_STATS_COUNTER_COUNT];
+static sc_tick sc_stats_start;
+
+void
+sc_stats_init(void) {
+    for (unsigned i = 0; i < SC_STATS_COUNTER_COUNT; ++i) {
+        atomic_init(&sc_stats_counters[i], 0);
+    }
+    sc_stats_start = sc_tick_now();
+}
+
+void
+sc_stats_add(enum sc_stats_counter counter, uint64_t value) {
+    assert(counter < SC_STATS_COUNTER_COUNT);
+    atomic_fetch_add_explicit(&sc_stats_counters[counter], value,
+                              memory_order_relaxed);
+}
+
+uint64_t
+sc_stats_get(enum sc_stats_counter counter) {
+    assert(counter < SC_STATS_COUNTER_COUNT);
+    return atomic_load_explicit(&sc_stats_counters[counter],
+                                memory_order_relaxed);
+}
+
+static bool
+sc_stats_append_prometheus(struct sc_strbuf *buf, const char *name,
+                           const char *help, bool counter, uint64_t value) {
+    const char *suffix = counter ? "_total" : "";
+    const char *type = counter ? "counter" : "gauge";
+
+    char line[512];
+    int r = snprintf(line, sizeof(line),
+                     "# HELP scrcpy_%s%s %s\n"
+                     "# TYPE scrcpy_%s%s %s\n"
+                     "scrcpy_%s%s %" PRIu64 "\n",
+                     name, suffix, help, name, suffix, type, name, suffix,
+                     value);
+    if (r < 0 || (size_t) r >= sizeof(line)) {
+        return false;
+    }
+
+    return sc_strbuf_append(buf, line, r);
+}
+
+static bool
+sc_stats_append_json(struct sc_strbuf *buf, const char *name, uint64_t value,
+                     bool first) {
+    char item[128];
+    int r = snprintf(item, sizeof(item), "%s\"%s\":%" PRIu64,
+                     first ? "" : ",", name, value);
+    if (r < 0 || (size_t) r >= sizeof(item)) {
+        return false;
+    }
+
+    return sc_strbuf_append(buf, item, r);
+}
+
+static bool
+sc_stats_append(struct sc_strbuf *buf, enum sc_stats_format format,
+                const char *name, const char *help, bool counter,
+                uint64_t value, bool first) {
+    if (format == SC_STATS_FORMAT_PROMETHEUS) {
+        return sc_stats_append_prometheus(buf, name, help, counter, value);
+    }
+
+    assert(format == SC_STATS_FORMAT_JSON);
+    return sc_stats_append_json(buf, name, value, first);
+}
+
+char *
+sc_stats_format(enum sc_stats_format format,
+                const struct sc_stats_gauges *gauges) {
+    struct sc_strbuf buf;
+    if (!sc_strbuf_init(&buf, 2048)) {
+        LOG_OOM();
+        return NULL;
+    }
+
+    bool json = format == SC_STATS_FORMAT_JSON;
+    if (json && !sc_strbuf_append_char(&buf, '{')) {
+        goto error;
+    }
+
+    uint64_t uptime = SC_TICK_TO_SEC(sc_tick_now() - sc_stats_start);
+    if (!sc_stats_append(&buf, format, "uptime_seconds",
+                         "Time since the session started", false, uptime,
+                         true)) {
+        goto error;
+    }
+
+    for (unsigned i = 0; i < SC_STATS_COUNTER_COUNT; ++i) {
+        const struct sc_stats_counter_desc *desc = &sc_stats_counter_descs[i];
+        uint64_t value = sc_stats_get(i);
+        if (!sc_stats_append(&buf, format, desc->name, desc->help, true, value,
+                             false)) {
+            goto error;
+        }
+    }
+
+    if (gauges->has_control) {
+        if (!sc_stats_append(&buf, format, "control_queue_depth",
+                             "Control messages waiting to be sent", false,
+                             gauges->control_queue_depth, false)
+                || !sc_stats_append(&buf, format, "control_queue_limit",
+                                    "Control queue depth above which "
+                                    "messages are dropped", false,
+                                    gauges->control_queue_limit, false)) {
+            goto error;
+        }
+    }
+
+    if (gauges->has_memory) {
+        uint64_t total = 0;
+        for (unsigned i = 0; i < SC_MEMORY_BUDGET_USER_COUNT; ++i) {
+            char name[64];
+            snprintf(name, sizeof(name), "memory_%s_bytes",
+                     sc_memory_budget_get_user_name(i));
+            if (!sc_stats_append(&buf, format, name,
+                                 "Memory used by the buffered data", false,
+                                 gauges->memory_usage[i], false)) {
+                goto error;
+            }
+            total += gauges->memory_usage[i];
+        }
+
+        if (!sc_stats_append(&buf, format, "memory_total_bytes",
+                             "Memory used by all the buffered data", false,
+                             total, false)
+                || !sc_stats_append(&buf, format, "memory_limit_bytes",
+                                    "Memory budget of the buffered data "
+                                    "(0 if unlimited)", false,
+                                    gauges->memory_limit, false)) {
+            goto error;
+        }
+    }
+
+    if (json && !sc_strbuf_append_staticstr(&buf, "}\n")) {
+        goto error;
+    }
+
+    return buf.s;
+
+error:
+    LOG_OOM();
+    free(buf.s);
+    return NULL;
+}
@@ -0,0 +1,79 @@
+#ifndef SC_STATS_H
+#define SC_STATS_H
+
+#include "common.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "memory_budget.h"
+
+/**
+ * Session statistics
+ *
+ * The counters are global and updated with relaxed atomic increments only, so
+ * that the components may update them from their hot paths without locking.
+ * They are published by the stats server (see stats_server.h).
+ */
+
+enum sc_stats_counter {
+    SC_STATS_VIDEO_PACKETS,
+    SC_STATS_VIDEO_BYTES,
+    SC_STATS_AUDIO_PACKETS,
+    SC_STATS_AUDIO_BYTES,
+    SC_STATS_FRAMES_RENDERED,
+    SC_STATS_FRAMES_SKIPPED,
+    SC_STATS_FRAMES_DECODE_SKIPPED,
+    SC_STATS_DECODE_RESYNCS,
+    SC_STATS_VIDEO_CATCH_UPS,
+    SC_STATS_AUDIO_UNDERFLOW_SAMPLES,
+    SC_STATS_RECORDER_PACKETS_DROPPED,
+    SC_STATS_BUFFERED_FRAMES_DROPPED,
+    SC_STATS_CONTROL_MSGS_DROPPED,
+
+    SC_STATS_COUNTER_COUNT,
+};
+
+enum sc_stats_format {
+    SC_STATS_FORMAT_PROMETHEUS,
+    SC_STATS_FORMAT_JSON,
+};
+
+// Values which are not counters, read on demand
+struct sc_stats_gauges {
+    bool has_control;
+    uint32_t control_queue_depth;
+    uint32_t control_queue_limit;
+
+    bool has_memory;
+    uint64_t memory_usage[SC_MEMORY_BUDGET_USER_COUNT];
+    uint64_t memory_limit; // 0 if unlimited
+};
+
+/**
+ * Initialize the counters and the session start time
+ */
+void
+sc_stats_init(void);
+
+void
+sc_stats_add(enum sc_stats_counter counter, uint64_t value);
+
+static inline void
+sc_stats_inc(enum sc_stats_counter counter) {
+    sc_stats_add(counter, 1);
+}
+
+uint64_t
+sc_stats_get(enum sc_stats_counter counter);
+
+/**
+ * Format the current statistics
+ *
+ * Return an allocated string (to be released by free()), or NULL on error.
+ */
+char *
+sc_stats_format(enum sc_stats_format format,
+                const struct sc_stats_gauges *gauges);
+
+#endif
@@ -0,0 +1,256 @@
+#include "stats_server.h"
+
+#include <assert.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "memory_budget.h"
+#include "snapshot.h"
+#include "stats.h"
+#include "util/log.h"
+#include "util/net_intr.h"
+
+#define SC_STATS_SERVER_REQUEST_MAX 1024
+
+bool
+sc_stats_server_init(struct sc_stats_server *server, uint16_t port,
+                     struct sc_controller *controller,
+                     struct sc_snapshot *snapshot) {
+    bool ok = sc_intr_init(&server->intr);
+    if (!ok) {
+        return false;
+    }
+
+    server->port = port;
+    server->controller = controller;
+    server->snapshot = snapshot;
+    server->server_socket = SC_SOCKET_NONE;
+
+    return true;
+}
+
+// Read the request until the end of the request line, and return the path
+// (and whether the method is POST rather than GET)
+static bool
+sc_stats_server_read_path(struct sc_stats_server *server, sc_socket socket,
+                          char *path, size_t path_size, bool *post) {
+    char req[SC_STATS_SERVER_REQUEST_MAX];
+    size_t len = 0;
+    char *eol = NULL;
+    while (!eol && len < sizeof(req) - 1) {
+        ssize_t r = net_recv_intr(&server->intr, socket, req + len,
+                                  sizeof(req) - 1 - len);
+        if (r <= 0) {
+            return false;
+        }
+        len += r;
+        req[len] = '\0';
+        eol = strstr(req, "\r\n");
+    }
+
+    if (!eol) {
+        return false;
+    }
+    *eol = '\0';
+
+    // "GET /path HTTP/1.1" or "POST /path HTTP/1.1"
+    const char *start;
+    if (!strncmp(req, "GET ", 4)) {
+        *post = false;
+        start = req + 4;
+    } else if (!strncmp(req, "POST ", 5)) {
+        *post = true;
+        start = req + 5;
+    } else {
+        return false;
+    }
+
+    size_t path_len = strcspn(start, " ?");
+    if (!path_len || path_len >= path_size) {
+        return false;
+    }
+
+    memcpy(path, start, path_len);
+    path[path_len] = '\0';
+    return true;
+}
+
+static void
+sc_stats_server_send_response(struct sc_stats_server *server,
+                              sc_socket socket, const char *status,
+                              const char *content_type, const char *body) {
+    size_t body_len = strlen(body);
+
+    char header[256];
+    int r = snprintf(header, sizeof(header),
+                     "HTTP/1.1 %s\r\n"
+                     "Content-Type: %s\r\n"
+                     "Content-Length: %" SC_PRIsizet "\r\n"
+                     "Connection: close\r\n"
+                     "\r\n", status, content_type, body_len);
+    assert(r > 0 && (size_t) r < sizeof(header));
+
+    if (net_send_all_intr(&server->intr, socket, header, r) != r) {
+        return;
+    }
+    net_send_all_intr(&server->intr, socket, body, body_len);
+}
+
+static void
+sc_stats_server_handle(struct sc_stats_server *server, sc_socket socket) {
+    char path[64];
+    bool post;
+    if (!sc_stats_server_read_path(server, socket, path, sizeof(path),
+                                   &post)) {
+        sc_stats_server_send_response(server, socket, "400 Bad Request",
+                                      "text/plain", "Bad request\n");
+        return;
+    }
+
+    if (!strcmp(path, "/snapshot")) {
+        // Saving a snapshot writes to the disk, so it must not be triggered
+        // by a GET request (which could be sent by a mere prefetch)
+        if (!post) {
+            sc_stats_server_send_response(server, socket,
+                                          "405 Method Not Allowed",
+                                          "text/plain", "Use POST\n");
+            return;
+        }
+
+        if (!server->snapshot) {
+            sc_stats_server_send_response(server, socket,
+                                          "503 Service Unavailable",
+                                          "text/plain", "No video\n");
+            return;
+        }
+
+        // The snapshot is saved asynchronously, from the next frame
+        sc_snapshot_request(server->snapshot);
+        sc_stats_server_send_response(server, socket, "202 Accepted",
+                                      "text/plain", "Snapshot requested\n");
+        return;
+    }
+
+    enum sc_stats_format format;
+    const char *content_type;
+    if (!strcmp(path, "/metrics")) {
+        format = SC_STATS_FORMAT_PROMETHEUS;
+        content_type = "text/plain; version=0.0.4";
+    } else if (!strcmp(path, "/stats")) {
+        format = SC_STATS_FORMAT_JSON;
+        content_type = "application/json";
+    } else {
+        sc_stats_server_send_response(server, socket, "404 Not Found",
+                                      "text/plain", "Not found\n");
+        return;
+    }
+
+    if (post) {
+        // The statistics are read-only
+        sc_stats_server_send_response(server, socket, "405 Method Not Allowed",
+                                      "text/plain", "Use GET\n");
+        return;
+    }
+
+    struct sc_stats_gauges gauges = {
+        .has_control = server->controller,
+    };
+    if (server->controller) {
+        gauges.control_queue_depth =
+            sc_controller_get_queue_depth(server->controller);
+        gauges.control_queue_limit = sc_controller_get_queue_limit();
+    }
+
+    gauges.has_memory = true;
+    for (unsigned i = 0; i < SC_MEMORY_BUDGET_USER_COUNT; ++i) {
+        gauges.memory_usage[i] = sc_memory_budget_get_usage(i);
+    }
+    gauges.memory_limit = sc_memory_budget_get_limit();
+
+    char *body = sc_stats_format(format, &gauges);
+    if (!body) {
+        sc_stats_server_send_response(server, socket,
+                                      "500 Internal Server Error",
+                                      "text/plain", "Internal error\n");
+        return;
+    }
+
+    sc_stats_server_send_response(server, socket, "200 OK", content_type,
+                                  body);
+    free(body);
+}
+
+static int
+run_stats_server(void *data) {
+    struct sc_stats_server *server = data;
+
+    for (;;) {
+        sc_socket socket = net_accept_intr(&server->intr,
+                                           server->server_socket);
+        if (socket == SC_SOCKET_NONE) {
+            if (!sc_intr_is_interrupted(&server->intr)) {
+                LOGE("Stats server: could not accept connection");
+            }
+            break;
+        }
+
+        sc_stats_server_handle(server, socket);
+        net_close(socket);
+    }
+
+    LOGD("Stats server stopped");
+    return 0;
+}
+
+bool
+sc_stats_server_start(struct sc_stats_server *server) {
+    sc_socket socket = net_socket();
+    if (socket == SC_SOCKET_NONE) {
+        LOGE("Stats server: could not create socket");
+        return false;
+    }
+
+    bool ok = net_listen_intr(&server->intr, socket, IPV4_LOCALHOST,
+                              server->port, 4);
+    if (!ok) {
+        LOGE("Stats server: could not listen on port %" PRIu16, server->port);
+        net_close(socket);
+        return false;
+    }
+
+    server->server_socket = socket;
+
+    LOGD("Starting stats server thread");
+    ok = sc_thread_create(&server->thread, run_stats_server,
+                          "scrcpy-stats", server);
+    if (!ok) {
+        LOGE("Could not start stats server thread");
+        net_close(socket);
+        server->server_socket = SC_SOCKET_NONE;
+        return false;
+    }
+
+    LOGI("Stats available on http://localhost:%" PRIu16 "/metrics (and "
+         "/stats)", server->port);
+    return true;
+}
+
+void
+sc_stats_server_stop(struct sc_stats_server *server) {
+    sc_intr_interrupt(&server->intr);
+}
+
+void
+sc_stats_server_join(struct sc_stats_server *server) {
+    sc_thread_join(&server->thread, NULL);
+}
+
+void
+sc_stats_server_destroy(struct sc_stats_server *server) {
+    if (server->server_socket != SC_SOCKET_NONE) {
+        net_close(server->server_socket);
+    }
+    sc_intr_destroy(&server->intr);
+}
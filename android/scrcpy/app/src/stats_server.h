@@ -0,0 +1,58 @@
+#ifndef SC_STATS_SERVER_H
+#define SC_STATS_SERVER_H
+
+#include "common.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "controller.h"
+#include "util/intr.h"
+#include "util/net.h"
+#include "util/thread.h"
+
+// forward declarations
+struct sc_snapshot;
+
+/**
+ * Minimal local HTTP server publishing the session statistics (see stats.h)
+ *
+ * It listens on localhost only, and serves:
+ *  - /metrics: Prometheus text exposition format
+ *  - /stats: JSON
+ *  - /snapshot (POST only): request a snapshot of the video (if available)
+ *
+ * Requests are handled one at a time from a dedicated thread, which only
+ * accesses atomic values (it never takes the locks of the other components).
+ */
+struct sc_stats_server {
+    uint16_t port;
+    struct sc_controller *controller; // may be NULL
+    struct sc_snapshot *snapshot; // may be NULL
+
+    sc_socket server_socket;
+    sc_thread thread;
+    struct sc_intr intr;
+};
+
+bool
+sc_stats_server_init(struct sc_stats_server *server, uint16_t port,
+                     struct sc_controller *controller,
+                     struct sc_snapshot *snapshot);
+
+/**
+ * Listen on the port and start the thread
+ */
+bool
+sc_stats_server_start(struct sc_stats_server *server);
+
+void
+sc_stats_server_stop(struct sc_stats_server *server);
+
+void
+sc_stats_server_join(struct sc_stats_server *server);
+
+void
+sc_stats_server_destroy(struct sc_stats_server *server);
+
+#endif
@@ -94,3 +94,17 @@ sc_file_is_regular(const char *path) {
     return S_ISREG(path_stat.st_mode);
 }
 
+
+bool
+sc_file_remove(const char *path) {
+    if (unlink(path)) {
+        perror("unlink");
+        return false;
+    }
+    return true;
+}
+
+FILE *
+sc_file_open(const char *path, const char *mode) {
+    return fopen(path, mode);
+}
@@ -4,174 +4,184 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <signal.h>
+#include <spawn.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
 #include "util/log.h"
 
+// Not declared by <unistd.h> on all platforms (e.g. macOS)
+extern char **environ;
+
+// Create a pipe whose both ends are close-on-exec (only the ends explicitly
+// duplicated to the stdio of a child are inherited), and never use the stdio
+// file descriptors (if they were closed), so that dup2() in the child never
+// has the same source and target
+static bool
+sc_pipe_cloexec(int fds[2]) {
+#ifdef HAVE_PIPE2
+    if (pipe2(fds, O_CLOEXEC) == -1) {
+        perror("pipe2");
+        return false;
+    }
+#else
+    if (pipe(fds) == -1) {
+        perror("pipe");
+        return false;
+    }
+#endif
+
+    for (int i = 0; i < 2; ++i) {
+#ifndef HAVE_PIPE2
+        if (fcntl(fds[i], F_SETFD, FD_CLOEXEC) == -1) {
+            perror("fcntl");
+            goto error;
+        }
+#endif
+        if (fds[i] <= STDERR_FILENO) {
+            int fd = fcntl(fds[i], F_DUPFD_CLOEXEC, STDERR_FILENO + 1);
+            if (fd == -1) {
+                perror("fcntl");
+                goto error;
+            }
+            close(fds[i]);
+            fds[i] = fd;
+        }
+    }
+
+    return true;
+
+error:
+    close(fds[0]);
+    close(fds[1]);
+    return false;
+}
+
 enum sc_process_result
 sc_process_execute_p(const char *const argv[], sc_pid *pid, unsigned flags,
                      int *pin, int *pout, int *perr) {
     bool inherit_stdout = !pout && !(flags & SC_PROCESS_NO_STDOUT);
     bool inherit_stderr = !perr && !(flags & SC_PROCESS_NO_STDERR);
 
+    // The process is spawned by posix_spawn() rather than fork() + exec(): the
+    // page tables of the scrcpy process (which may be large, with the decoders
+    // and the recording buffers) are not copied for each adb command.
+
     int in[2];
     int out[2];
     int err[2];
-    int internal[2]; // communication between parent and children
 
-    if (pipe(internal) == -1) {
-        perror("pipe");
+    if (pin && !sc_pipe_cloexec(in)) {
         return SC_PROCESS_ERROR_GENERIC;
     }
-    if (pin) {
-        if (pipe(in) == -1) {
-            perror("pipe");
-            close(internal[0]);
-            close(internal[1]);
-            return SC_PROCESS_ERROR_GENERIC;
-        }
+    if (pout && !sc_pipe_cloexec(out)) {
+        goto error_close_in;
     }
-    if (pout) {
-        if (pipe(out) == -1) {
-            perror("pipe");
-            // clean up
-            if (pin) {
-                close(in[0]);
-                close(in[1]);
-            }
-            close(internal[0]);
-            close(internal[1]);
-            return SC_PROCESS_ERROR_GENERIC;
-        }
+    if (perr && !sc_pipe_cloexec(err)) {
+        goto error_close_out;
     }
-    if (perr) {
-        if (pipe(err) == -1) {
-            perror("pipe");
-            // clean up
-            if (pout) {
-                close(out[0]);
-                close(out[1]);
-            }
-            if (pin) {
-                close(in[0]);
-                close(in[1]);
-            }
-            close(internal[0]);
-            close(internal[1]);
-            return SC_PROCESS_ERROR_GENERIC;
-        }
+
+    posix_spawn_file_actions_t actions;
+    int r = posix_spawn_file_actions_init(&actions);
+    if (r) {
+        LOGE("Could not initialize posix_spawn file actions: %s",
+             strerror(r));
+        goto error_close_err;
     }
 
-    *pid = fork();
-    if (*pid == -1) {
-        perror("fork");
-        // clean up
-        if (perr) {
-            close(err[0]);
-            close(err[1]);
-        }
-        if (pout) {
-            close(out[0]);
-            close(out[1]);
-        }
-        if (pin) {
-            close(in[0]);
-            close(in[1]);
-        }
-        close(internal[0]);
-        close(internal[1]);
-        return SC_PROCESS_ERROR_GENERIC;
+    posix_spawnattr_t attr;
+    r = posix_spawnattr_init(&attr);
+    if (r) {
+        LOGE("Could not initialize posix_spawn attributes: %s", strerror(r));
+        goto error_destroy_actions;
     }
 
-    if (*pid == 0) {
-        if (pin) {
-            if (in[0] != STDIN_FILENO) {
-                dup2(in[0], STDIN_FILENO);
-                close(in[0]);
-            }
-            close(in[1]);
-        } else {
-            int devnull = open("/dev/null", O_RDONLY | O_CREAT, 0666);
-            if (devnull != -1) {
-                dup2(devnull, STDIN_FILENO);
-            } else {
-                LOGE("Could not open /dev/null for stdin");
-            }
-        }
+    if (pin) {
+        r = posix_spawn_file_actions_adddup2(&actions, in[0], STDIN_FILENO);
+    } else {
+        r = posix_spawn_file_actions_addopen(&actions, STDIN_FILENO,
+                                             "/dev/null", O_RDONLY, 0);
+    }
 
+    if (!r) {
         if (pout) {
-            if (out[1] != STDOUT_FILENO) {
-                dup2(out[1], STDOUT_FILENO);
-                close(out[1]);
-            }
-            close(out[0]);
+            r = posix_spawn_file_actions_adddup2(&actions, out[1],
+                                                 STDOUT_FILENO);
         } else if (!inherit_stdout) {
-            int devnull = open("/dev/null", O_WRONLY | O_CREAT, 0666);
-            if (devnull != -1) {
-                dup2(devnull, STDOUT_FILENO);
-            } else {
-                LOGE("Could not open /dev/null for stdout");
-            }
+            r = posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO,
+                                                 "/dev/null", O_WRONLY, 0);
         }
+    }
 
+    if (!r) {
         if (perr) {
-            if (err[1] != STDERR_FILENO) {
-                dup2(err[1], STDERR_FILENO);
-                close(err[1]);
-            }
-            close(err[0]);
+            r = posix_spawn_file_actions_adddup2(&actions, err[1],
+                                                 STDERR_FILENO);
         } else if (!inherit_stderr) {
-            int devnull = open("/dev/null", O_WRONLY | O_CREAT, 0666);
-            if (devnull != -1) {
-                dup2(devnull, STDERR_FILENO);
-            } else {
-                LOGE("Could not open /dev/null for stderr");
-            }
+            r = posix_spawn_file_actions_addopen(&actions, STDERR_FILENO,
+                                                 "/dev/null", O_WRONLY, 0);
         }
+    }
 
-        close(internal[0]);
-        enum sc_process_result err;
+#ifdef HAVE_POSIX_SPAWN_FILE_ACTIONS_ADDCLOSEFROM_NP
+    if (!r) {
+        // Do not leak the file descriptors not marked close-on-exec (opened by
+        // the libraries) to the child (like close_range() after a fork())
+        r = posix_spawn_file_actions_addclosefrom_np(&actions,
+                                                     STDERR_FILENO + 1);
+    }
+#endif
 
+    if (!r) {
         // Somehow SDL masks many signals - undo them for other processes
         // https://github.com/libsdl-org/SDL/blob/release-2.0.18/src/thread/pthread/SDL_systhread.c#L167
         sigset_t mask;
         sigemptyset(&mask);
-        sigprocmask(SIG_SETMASK, &mask, NULL);
-
-        if (fcntl(internal[1], F_SETFD, FD_CLOEXEC) == 0) {
-            execvp(argv[0], (char *const *) argv);
-            perror("exec");
-            err = errno == ENOENT ? SC_PROCESS_ERROR_MISSING_BINARY
-                                  : SC_PROCESS_ERROR_GENERIC;
-        } else {
-            perror("fcntl");
-            err = SC_PROCESS_ERROR_GENERIC;
-        }
-        // send err to the parent
-        if (write(internal[1], &err, sizeof(err)) == -1) {
-            perror("write");
-        }
-        close(internal[1]);
-        _exit(1);
+        r = posix_spawnattr_setsigmask(&attr, &mask);
     }
 
-    // parent
-    assert(*pid > 0);
+    if (!r) {
+        r = posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK);
+    }
 
-    close(internal[1]);
+    if (r) {
+        LOGE("Could not configure posix_spawn: %s", strerror(r));
+        goto error_destroy_attr;
+    }
+
+    // The exec errors (like a missing binary) are reported by posix_spawnp()
+    // itself (on glibc >= 2.24, macOS and the BSDs)
+    r = posix_spawnp(pid, argv[0], &actions, &attr, (char *const *) argv,
+                     environ);
+    posix_spawnattr_destroy(&attr);
+    posix_spawn_file_actions_destroy(&actions);
 
-    enum sc_process_result res = SC_PROCESS_SUCCESS;
-    // wait for EOF or receive err from child
-    if (read(internal[0], &res, sizeof(res)) == -1) {
-        perror("read");
-        res = SC_PROCESS_ERROR_GENERIC;
+    if (r) {
+        errno = r;
+        perror("posix_spawnp");
+        enum sc_process_result res = r == ENOENT
+                                   ? SC_PROCESS_ERROR_MISSING_BINARY
+                                   : SC_PROCESS_ERROR_GENERIC;
+        if (perr) {
+            close(err[0]);
+            close(err[1]);
+        }
+        if (pout) {
+            close(out[0]);
+            close(out[1]);
+        }
+        if (pin) {
+            close(in[0]);
+            close(in[1]);
+        }
+        return res;
     }
 
-    close(internal[0]);
+    assert(*pid > 0);
 
     if (pin) {
         close(in[0]);
@@ -186,7 +196,29 @@ sc_process_execute_p(const char *const argv[], sc_pid *pid, unsigned flags,
         close(err[1]);
     }
 
-    return res;
+    return SC_PROCESS_SUCCESS;
+
+error_destroy_attr:
+    posix_spawnattr_destroy(&attr);
+error_destroy_actions:
+    posix_spawn_file_actions_destroy(&actions);
+error_close_err:
+    if (perr) {
+        close(err[0]);
+        close(err[1]);
+    }
+error_close_out:
+    if (pout) {
+        close(out[0]);
+        close(out[1]);
+    }
+error_close_in:
+    if (pin) {
+        close(in[0]);
+        close(in[1]);
+    }
+
+    return SC_PROCESS_ERROR_GENERIC;
 }
 
 bool
@@ -0,0 +1,63 @@
+#include "util/thread.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+
+#include "util/log.h"
+
+bool
+sc_thread_set_realtime(enum sc_thread_role role) {
+    // The control threads mostly sleep and run in short bursts
+    int policy = role == SC_THREAD_ROLE_CONTROL ? SCHED_RR : SCHED_FIFO;
+
+    int min = sched_get_priority_min(policy);
+    int max = sched_get_priority_max(policy);
+    if (min < 0 || max < min) {
+        return false;
+    }
+
+    // Stay at the bottom of the real-time range (audio above video), so that
+    // the system real-time threads are never delayed
+    int priority = min + (role == SC_THREAD_ROLE_AUDIO ? 2 : 1);
+    struct sched_param param = {
+        .sched_priority = MIN(priority, max),
+    };
+
+    // SDL threads are pthreads on all Unix platforms
+    int r = pthread_setschedparam(pthread_self(), policy, &param);
+    if (r) {
+        LOGD("pthread_setschedparam() failed: %s", strerror(r));
+        return false;
+    }
+
+    return true;
+}
+
+bool
+sc_thread_set_affinity(uint64_t cpus) {
+    assert(cpus);
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (unsigned i = 0; i < 64 && i < CPU_SETSIZE; ++i) {
+        if (cpus & (UINT64_C(1) << i)) {
+            CPU_SET(i, &set);
+        }
+    }
+
+    int r = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (r) {
+        LOGD("pthread_setaffinity_np() failed: %s", strerror(r));
+        return false;
+    }
+
+    return true;
+#else
+    // macOS only supports affinity tags (hints), which do not pin threads
+    (void) cpus;
+    LOGD("CPU affinity is not supported on this platform");
+    return false;
+#endif
+}
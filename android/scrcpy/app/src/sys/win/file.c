@@ -2,6 +2,7 @@
 
 #include <windows.h>
 
+#include <stdio.h>
 #include <sys/stat.h>
 
 #include "util/log.h"
@@ -41,3 +42,38 @@ sc_file_is_regular(const char *path) {
     return S_ISREG(path_stat.st_mode);
 }
 
+
+bool
+sc_file_remove(const char *path) {
+    wchar_t *wide_path = sc_str_to_wchars(path);
+    if (!wide_path) {
+        LOG_OOM();
+        return false;
+    }
+
+    int r = _wremove(wide_path);
+    free(wide_path);
+
+    return !r;
+}
+
+FILE *
+sc_file_open(const char *path, const char *mode) {
+    wchar_t *wide_path = sc_str_to_wchars(path);
+    if (!wide_path) {
+        LOG_OOM();
+        return NULL;
+    }
+
+    wchar_t *wide_mode = sc_str_to_wchars(mode);
+    if (!wide_mode) {
+        LOG_OOM();
+        free(wide_path);
+        return NULL;
+    }
+
+    FILE *file = _wfopen(wide_path, wide_mode);
+    free(wide_mode);
+    free(wide_path);
+    return file;
+}
@@ -0,0 +1,43 @@
+#include "util/thread.h"
+
+#include <assert.h>
+#include <windows.h>
+#include <avrt.h>
+
+#include "util/log.h"
+
+bool
+sc_thread_set_realtime(enum sc_thread_role role) {
+    // Register the thread to the Multimedia Class Scheduler Service, which
+    // boosts its priority while it is active
+    const wchar_t *task = role == SC_THREAD_ROLE_AUDIO ? L"Pro Audio"
+                                                       : L"Games";
+    DWORD task_index = 0;
+    HANDLE handle = AvSetMmThreadCharacteristicsW(task, &task_index);
+    if (!handle) {
+        sc_log_windows_error("Could not register MMCSS task",
+                             GetLastError());
+        return false;
+    }
+
+    // The registration is reverted when the thread exits
+    return true;
+}
+
+bool
+sc_thread_set_affinity(uint64_t cpus) {
+    assert(cpus);
+    // Only the first processor group is supported
+    DWORD_PTR mask = (DWORD_PTR) cpus;
+    if (!mask) {
+        LOGD("CPU affinity: no CPU in the first processor group");
+        return false;
+    }
+
+    if (!SetThreadAffinityMask(GetCurrentThread(), mask)) {
+        sc_log_windows_error("Could not set thread affinity", GetLastError());
+        return false;
+    }
+
+    return true;
+}
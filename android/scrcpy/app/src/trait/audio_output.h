@@ -0,0 +1,55 @@
+#ifndef SC_AUDIO_OUTPUT_H
+#define SC_AUDIO_OUTPUT_H
+
+#include "common.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Audio output trait.
+ *
+ * An audio output backend plays interleaved 32-bit float samples, that it
+ * pulls from its own (real-time) thread.
+ */
+struct sc_audio_output {
+    const struct sc_audio_output_ops *ops;
+};
+
+struct sc_audio_output_callbacks {
+    /**
+     * Fill `out` with exactly `samples` samples
+     *
+     * Called from the backend thread, it must not block.
+     */
+    void (*on_pull)(uint8_t *out, uint32_t samples, void *userdata);
+};
+
+struct sc_audio_output_ops {
+    /**
+     * Open the audio device
+     *
+     * The requested period size (in samples) is passed in `period`, and
+     * replaced by the obtained value.
+     *
+     * No callback is called before start().
+     */
+    bool (*open)(struct sc_audio_output *aout, uint32_t sample_rate,
+                 uint8_t nb_channels, uint32_t *period,
+                 const struct sc_audio_output_callbacks *cbs,
+                 void *cbs_userdata);
+
+    /**
+     * Start playback
+     */
+    bool (*start)(struct sc_audio_output *aout);
+
+    /**
+     * Stop playback (if started) and close the audio device
+     *
+     * Once it returns, no callback is called anymore.
+     */
+    void (*close)(struct sc_audio_output *aout);
+};
+
+#endif
@@ -1,57 +1,370 @@
 #include "frame_source.h"
 
 #include <assert.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <libavutil/frame.h>
+
+#include "util/log.h"
+#include "util/thread.h"
+#include "util/vecdeque.h"
+
+struct sc_frame_source_queue SC_VECDEQUE(AVFrame *);
+
+struct sc_frame_source_worker {
+    struct sc_frame_sink *sink;
+    unsigned queue_size;
+
+    sc_thread thread;
+    sc_mutex mutex;
+    sc_cond cond;
+
+    // the following fields are protected by the mutex
+    struct sc_frame_source_queue queue;
+    bool stopped;
+    bool drain; // on stop, push the queued frames before exiting
+    bool failed;
+
+    uint64_t dropped; // only accessed by the source thread
+};
 
 void
 sc_frame_source_init(struct sc_frame_source *source) {
+    source->sinks = NULL;
     source->sink_count = 0;
+    source->taps = NULL;
+    source->async_queue_size = 0;
+    source->workers = NULL;
 }
 
 void
 sc_frame_source_add_sink(struct sc_frame_source *source,
                          struct sc_frame_sink *sink) {
-    assert(source->sink_count < SC_FRAME_SOURCE_MAX_SINKS);
     assert(sink);
     assert(sink->ops);
-    source->sinks[source->sink_count++] = sink;
+    assert(!source->workers); // sinks must be added before open()
+
+    sink->next = NULL;
+
+    // append, sinks are opened and fed in the order they are added
+    struct sc_frame_sink **plast = &source->sinks;
+    while (*plast) {
+        assert(*plast != sink);
+        plast = &(*plast)->next;
+    }
+    *plast = sink;
+    ++source->sink_count;
+}
+
+void
+sc_frame_source_add_tap(struct sc_frame_source *source,
+                        struct sc_frame_sink *tap) {
+    assert(tap);
+    assert(tap->ops);
+    assert(!source->workers); // taps must be added before open()
+
+    // prepend, the order of the taps does not matter
+    tap->next = source->taps;
+    source->taps = tap;
+}
+
+static void
+sc_frame_source_taps_close_until(struct sc_frame_source *source,
+                                 struct sc_frame_sink *end) {
+    for (struct sc_frame_sink *tap = source->taps; tap != end;
+            tap = tap->next) {
+        tap->ops->close(tap);
+    }
+}
+
+void
+sc_frame_source_set_async(struct sc_frame_source *source,
+                          unsigned queue_size) {
+    assert(queue_size);
+    assert(!source->workers);
+    source->async_queue_size = queue_size;
+}
+
+static struct sc_frame_sink *
+sc_frame_source_get_sink(struct sc_frame_source *source, unsigned index) {
+    assert(index < source->sink_count);
+    struct sc_frame_sink *sink = source->sinks;
+    while (index--) {
+        sink = sink->next;
+    }
+    return sink;
 }
 
 static void
 sc_frame_source_sinks_close_firsts(struct sc_frame_source *source,
                                     unsigned count) {
+    // close in reverse order
     while (count) {
-        struct sc_frame_sink *sink = source->sinks[--count];
+        struct sc_frame_sink *sink = sc_frame_source_get_sink(source, --count);
         sink->ops->close(sink);
     }
 }
 
+static void
+sc_frame_source_worker_flush(struct sc_frame_source_worker *worker) {
+    while (!sc_vecdeque_is_empty(&worker->queue)) {
+        AVFrame *frame = sc_vecdeque_pop(&worker->queue);
+        av_frame_free(&frame);
+    }
+}
+
+static int
+run_frame_source_worker(void *data) {
+    struct sc_frame_source_worker *worker = data;
+    struct sc_frame_sink *sink = worker->sink;
+
+    for (;;) {
+        sc_mutex_lock(&worker->mutex);
+
+        while (!worker->stopped && sc_vecdeque_is_empty(&worker->queue)) {
+            sc_cond_wait(&worker->cond, &worker->mutex);
+        }
+
+        if (worker->stopped
+                && (!worker->drain || sc_vecdeque_is_empty(&worker->queue))) {
+            sc_mutex_unlock(&worker->mutex);
+            break;
+        }
+
+        AVFrame *frame = sc_vecdeque_pop(&worker->queue);
+        sc_mutex_unlock(&worker->mutex);
+
+        bool ok = sink->ops->push(sink, frame);
+        av_frame_free(&frame);
+
+        if (!ok) {
+            sc_mutex_lock(&worker->mutex);
+            // The source will fail on the next push
+            worker->failed = true;
+            sc_mutex_unlock(&worker->mutex);
+            break;
+        }
+    }
+
+    return 0;
+}
+
+static bool
+sc_frame_source_worker_start(struct sc_frame_source_worker *worker,
+                             struct sc_frame_sink *sink, unsigned queue_size) {
+    worker->sink = sink;
+    worker->queue_size = queue_size;
+    worker->stopped = false;
+    worker->drain = false;
+    worker->failed = false;
+    worker->dropped = 0;
+
+    sc_vecdeque_init(&worker->queue);
+    if (!sc_vecdeque_reserve(&worker->queue, queue_size)) {
+        LOG_OOM();
+        return false;
+    }
+
+    if (!sc_mutex_init(&worker->mutex)) {
+        goto error_destroy_queue;
+    }
+
+    if (!sc_cond_init(&worker->cond)) {
+        goto error_destroy_mutex;
+    }
+
+    bool ok = sc_thread_create(&worker->thread, run_frame_source_worker,
+                               "scrcpy-fsink", worker);
+    if (!ok) {
+        LOGE("Could not start frame sink worker thread");
+        goto error_destroy_cond;
+    }
+
+    return true;
+
+error_destroy_cond:
+    sc_cond_destroy(&worker->cond);
+error_destroy_mutex:
+    sc_mutex_destroy(&worker->mutex);
+error_destroy_queue:
+    sc_vecdeque_destroy(&worker->queue);
+
+    return false;
+}
+
+static void
+sc_frame_source_worker_stop(struct sc_frame_source_worker *worker,
+                            bool drain) {
+    sc_mutex_lock(&worker->mutex);
+    worker->stopped = true;
+    worker->drain = drain;
+    sc_cond_signal(&worker->cond);
+    sc_mutex_unlock(&worker->mutex);
+
+    sc_thread_join(&worker->thread, NULL);
+
+    if (worker->dropped) {
+        LOGD("Frame sink worker: %" PRIu64_ " frame(s) dropped",
+             worker->dropped);
+    }
+
+    sc_frame_source_worker_flush(worker);
+    sc_vecdeque_destroy(&worker->queue);
+    sc_cond_destroy(&worker->cond);
+    sc_mutex_destroy(&worker->mutex);
+}
+
+static void
+sc_frame_source_stop_workers(struct sc_frame_source *source, unsigned count,
+                             bool drain) {
+    while (count) {
+        sc_frame_source_worker_stop(&source->workers[--count], drain);
+    }
+}
+
+static bool
+sc_frame_source_start_workers(struct sc_frame_source *source) {
+    assert(source->async_queue_size);
+    assert(!source->workers);
+
+    source->workers = malloc(source->sink_count * sizeof(*source->workers));
+    if (!source->workers) {
+        LOG_OOM();
+        return false;
+    }
+
+    unsigned i = 0;
+    for (struct sc_frame_sink *sink = source->sinks; sink; sink = sink->next) {
+        bool ok = sc_frame_source_worker_start(&source->workers[i], sink,
+                                               source->async_queue_size);
+        if (!ok) {
+            sc_frame_source_stop_workers(source, i, false);
+            free(source->workers);
+            source->workers = NULL;
+            return false;
+        }
+        ++i;
+    }
+
+    return true;
+}
+
 bool
 sc_frame_source_sinks_open(struct sc_frame_source *source,
                            const AVCodecContext *ctx) {
     assert(source->sink_count);
-    for (unsigned i = 0; i < source->sink_count; ++i) {
-        struct sc_frame_sink *sink = source->sinks[i];
+    unsigned i = 0;
+    for (struct sc_frame_sink *sink = source->sinks; sink; sink = sink->next) {
         if (!sink->ops->open(sink, ctx)) {
             sc_frame_source_sinks_close_firsts(source, i);
             return false;
         }
+        ++i;
+    }
+
+    for (struct sc_frame_sink *tap = source->taps; tap; tap = tap->next) {
+        if (!tap->ops->open(tap, ctx)) {
+            sc_frame_source_taps_close_until(source, tap);
+            sc_frame_source_sinks_close_firsts(source, source->sink_count);
+            return false;
+        }
+    }
+
+    // With a single sink, a worker would only add a thread hop
+    if (source->async_queue_size && source->sink_count > 1) {
+        if (!sc_frame_source_start_workers(source)) {
+            sc_frame_source_sinks_close(source);
+            return false;
+        }
     }
 
     return true;
 }
 
-void
-sc_frame_source_sinks_close(struct sc_frame_source *source) {
+static void
+sc_frame_source_sinks_stop(struct sc_frame_source *source, bool drain) {
     assert(source->sink_count);
+    if (source->workers) {
+        sc_frame_source_stop_workers(source, source->sink_count, drain);
+        free(source->workers);
+        source->workers = NULL;
+    }
+
+    sc_frame_source_taps_close_until(source, NULL);
     sc_frame_source_sinks_close_firsts(source, source->sink_count);
 }
 
+void
+sc_frame_source_sinks_close(struct sc_frame_source *source) {
+    sc_frame_source_sinks_stop(source, true);
+}
+
+void
+sc_frame_source_sinks_abort(struct sc_frame_source *source) {
+    sc_frame_source_sinks_stop(source, false);
+}
+
+static bool
+sc_frame_source_worker_push(struct sc_frame_source_worker *worker,
+                            const AVFrame *frame) {
+    AVFrame *ref = av_frame_alloc();
+    if (!ref) {
+        LOG_OOM();
+        return false;
+    }
+
+    if (av_frame_ref(ref, frame)) {
+        LOG_OOM();
+        av_frame_free(&ref);
+        return false;
+    }
+
+    sc_mutex_lock(&worker->mutex);
+
+    if (worker->failed) {
+        sc_mutex_unlock(&worker->mutex);
+        av_frame_free(&ref);
+        return false;
+    }
+
+    if (sc_vecdeque_size(&worker->queue) == worker->queue_size) {
+        // The sink is too slow, drop its oldest frame
+        AVFrame *old = sc_vecdeque_pop(&worker->queue);
+        av_frame_free(&old);
+        ++worker->dropped;
+    }
+
+    // The capacity has been reserved on start
+    sc_vecdeque_push_noresize(&worker->queue, ref);
+    sc_cond_signal(&worker->cond);
+
+    sc_mutex_unlock(&worker->mutex);
+
+    return true;
+}
+
 bool
 sc_frame_source_sinks_push(struct sc_frame_source *source,
                             const AVFrame *frame) {
     assert(source->sink_count);
-    for (unsigned i = 0; i < source->sink_count; ++i) {
-        struct sc_frame_sink *sink = source->sinks[i];
+
+    for (struct sc_frame_sink *tap = source->taps; tap; tap = tap->next) {
+        if (!tap->ops->push(tap, frame)) {
+            return false;
+        }
+    }
+
+    if (source->workers) {
+        for (unsigned i = 0; i < source->sink_count; ++i) {
+            if (!sc_frame_source_worker_push(&source->workers[i], frame)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    for (struct sc_frame_sink *sink = source->sinks; sink; sink = sink->next) {
         if (!sink->ops->push(sink, frame)) {
             return false;
         }
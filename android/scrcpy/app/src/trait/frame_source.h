@@ -7,16 +7,31 @@
 
 #include "trait/frame_sink.h"
 
-#define SC_FRAME_SOURCE_MAX_SINKS 2
+// forward declarations
+struct sc_frame_source_worker;
 
 /**
  * Frame source trait
  *
  * Component able to send AVFrames should implement this trait.
+ *
+ * By default, frames are pushed to all sinks sequentially, from the thread
+ * calling sc_frame_source_sinks_push(). In asynchronous mode (see
+ * sc_frame_source_set_async()), each sink receives the frames from its own
+ * worker thread, so that a slow sink does not delay the others.
+ *
+ * Taps (see sc_frame_source_add_tap()) are always fed synchronously, before
+ * the other sinks.
  */
 struct sc_frame_source {
-    struct sc_frame_sink *sinks[SC_FRAME_SOURCE_MAX_SINKS];
+    struct sc_frame_sink *sinks; // linked list
     unsigned sink_count;
+
+    struct sc_frame_sink *taps; // linked list
+
+    unsigned async_queue_size; // 0 for synchronous push
+    // one worker per sink, only if the asynchronous mode is active
+    struct sc_frame_source_worker *workers;
 };
 
 void
@@ -26,13 +41,55 @@ void
 sc_frame_source_add_sink(struct sc_frame_source *source,
                          struct sc_frame_sink *sink);
 
+/**
+ * Add a sink which only observes the frames
+ *
+ * A tap is pushed every frame synchronously, from the source thread, even in
+ * asynchronous mode; its push() must therefore never block. It is not counted
+ * as a sink for the asynchronous mode, so adding a tap to a source with a
+ * single sink does not start any worker.
+ */
+void
+sc_frame_source_add_tap(struct sc_frame_source *source,
+                        struct sc_frame_sink *tap);
+
+/**
+ * Enable the asynchronous fan-out mode
+ *
+ * Each sink will be fed from its own thread, via a queue of at most
+ * `queue_size` frames. If the queue of a sink is full, its oldest frame is
+ * dropped.
+ *
+ * It has no effect if there is only one sink (the frames are then pushed
+ * directly).
+ *
+ * Must be called before sc_frame_source_sinks_open().
+ */
+void
+sc_frame_source_set_async(struct sc_frame_source *source, unsigned queue_size);
+
 bool
 sc_frame_source_sinks_open(struct sc_frame_source *source,
                            const AVCodecContext *ctx);
 
+/**
+ * Close the sinks
+ *
+ * In asynchronous mode, the frames still queued are pushed to their sink
+ * first.
+ */
 void
 sc_frame_source_sinks_close(struct sc_frame_source *source);
 
+/**
+ * Close the sinks after a failure
+ *
+ * Same as sc_frame_source_sinks_close(), but the frames still queued in
+ * asynchronous mode are discarded.
+ */
+void
+sc_frame_source_sinks_abort(struct sc_frame_source *source);
+
 bool
 sc_frame_source_sinks_push(struct sc_frame_source *source,
                            const AVFrame *frame);
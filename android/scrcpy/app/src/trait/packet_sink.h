@@ -13,6 +13,11 @@
  */
 struct sc_packet_sink {
     const struct sc_packet_sink_ops *ops;
+
+    // next sink of the same source (managed by the packet source)
+    struct sc_packet_sink *next;
+    // never drop packets in asynchronous mode (managed by the packet source)
+    bool lossless;
 };
 
 struct sc_packet_sink_ops {
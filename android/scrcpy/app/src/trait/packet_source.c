@@ -1,57 +1,529 @@
 #include "packet_source.h"
 
 #include <assert.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <libavcodec/avcodec.h>
+
+#include "packet_merger.h"
+#include "util/log.h"
+#include "util/thread.h"
+#include "util/vecdeque.h"
+
+struct sc_packet_source_queue SC_VECDEQUE(AVPacket *);
+
+struct sc_packet_source_worker {
+    struct sc_packet_sink *sink;
+    unsigned queue_size;
+    bool video;
+
+    sc_thread thread;
+    sc_mutex mutex;
+    sc_cond cond;
+    sc_cond space_cond; // signaled when a slot is released (lossless only)
+
+    // the following fields are protected by the mutex
+    struct sc_packet_source_queue queue;
+    bool stopped;
+    bool drain; // on stop, push the queued packets before exiting
+    bool failed;
+
+    // only accessed by the source thread
+    bool wait_key_frame;
+    uint64_t dropped;
+    // config attached to a dropped packet, to attach to the next key frame
+    uint8_t *config;
+    size_t config_size;
+};
+
+static inline bool
+sc_packet_is_config(const AVPacket *packet) {
+    // Config packets have no PTS (see demuxer)
+    return packet->pts == AV_NOPTS_VALUE;
+}
 
 void
 sc_packet_source_init(struct sc_packet_source *source) {
+    source->sinks = NULL;
     source->sink_count = 0;
+    source->async_queue_size = 0;
+    source->workers = NULL;
+    source->cbs = NULL;
+    source->cbs_userdata = NULL;
 }
 
 void
 sc_packet_source_add_sink(struct sc_packet_source *source,
                           struct sc_packet_sink *sink) {
-    assert(source->sink_count < SC_PACKET_SOURCE_MAX_SINKS);
     assert(sink);
     assert(sink->ops);
-    source->sinks[source->sink_count++] = sink;
+    assert(!source->workers); // sinks must be added before open()
+
+    sink->next = NULL;
+    sink->lossless = false;
+
+    // append, sinks are opened and fed in the order they are added
+    struct sc_packet_sink **plast = &source->sinks;
+    while (*plast) {
+        assert(*plast != sink);
+        plast = &(*plast)->next;
+    }
+    *plast = sink;
+    ++source->sink_count;
+}
+
+void
+sc_packet_source_add_lossless_sink(struct sc_packet_source *source,
+                                   struct sc_packet_sink *sink) {
+    sc_packet_source_add_sink(source, sink);
+    sink->lossless = true;
+}
+
+void
+sc_packet_source_set_async(struct sc_packet_source *source,
+                           unsigned queue_size) {
+    assert(queue_size);
+    assert(!source->workers);
+    source->async_queue_size = queue_size;
+}
+
+void
+sc_packet_source_set_callbacks(struct sc_packet_source *source,
+                               const struct sc_packet_source_callbacks *cbs,
+                               void *cbs_userdata) {
+    assert(!cbs || cbs->on_drop);
+    assert(!source->workers);
+    source->cbs = cbs;
+    source->cbs_userdata = cbs_userdata;
+}
+
+static struct sc_packet_sink *
+sc_packet_source_get_sink(struct sc_packet_source *source, unsigned index) {
+    assert(index < source->sink_count);
+    struct sc_packet_sink *sink = source->sinks;
+    while (index--) {
+        sink = sink->next;
+    }
+    return sink;
 }
 
 static void
 sc_packet_source_sinks_close_firsts(struct sc_packet_source *source,
                                     unsigned count) {
+    // close in reverse order
     while (count) {
-        struct sc_packet_sink *sink = source->sinks[--count];
+        struct sc_packet_sink *sink =
+            sc_packet_source_get_sink(source, --count);
         sink->ops->close(sink);
     }
 }
 
+static void
+sc_packet_source_worker_flush(struct sc_packet_source_worker *worker) {
+    while (!sc_vecdeque_is_empty(&worker->queue)) {
+        AVPacket *packet = sc_vecdeque_pop(&worker->queue);
+        av_packet_free(&packet);
+    }
+}
+
+static int
+run_packet_source_worker(void *data) {
+    struct sc_packet_source_worker *worker = data;
+    struct sc_packet_sink *sink = worker->sink;
+
+    for (;;) {
+        sc_mutex_lock(&worker->mutex);
+
+        while (!worker->stopped && sc_vecdeque_is_empty(&worker->queue)) {
+            sc_cond_wait(&worker->cond, &worker->mutex);
+        }
+
+        if (worker->stopped
+                && (!worker->drain || sc_vecdeque_is_empty(&worker->queue))) {
+            sc_mutex_unlock(&worker->mutex);
+            break;
+        }
+
+        AVPacket *packet = sc_vecdeque_pop(&worker->queue);
+        if (sink->lossless) {
+            sc_cond_signal(&worker->space_cond);
+        }
+        sc_mutex_unlock(&worker->mutex);
+
+        bool ok = sink->ops->push(sink, packet);
+        av_packet_free(&packet);
+
+        if (!ok) {
+            sc_mutex_lock(&worker->mutex);
+            // The source will fail on the next push
+            worker->failed = true;
+            sc_cond_signal(&worker->space_cond);
+            sc_mutex_unlock(&worker->mutex);
+            break;
+        }
+    }
+
+    return 0;
+}
+
+static bool
+sc_packet_source_worker_start(struct sc_packet_source_worker *worker,
+                              struct sc_packet_sink *sink, unsigned queue_size,
+                              bool video) {
+    worker->sink = sink;
+    worker->queue_size = queue_size;
+    worker->video = video;
+    worker->stopped = false;
+    worker->drain = false;
+    worker->failed = false;
+    worker->wait_key_frame = false;
+    worker->dropped = 0;
+    worker->config = NULL;
+
+    sc_vecdeque_init(&worker->queue);
+    if (!sc_vecdeque_reserve(&worker->queue, queue_size)) {
+        LOG_OOM();
+        return false;
+    }
+
+    if (!sc_mutex_init(&worker->mutex)) {
+        goto error_destroy_queue;
+    }
+
+    if (!sc_cond_init(&worker->cond)) {
+        goto error_destroy_mutex;
+    }
+
+    if (!sc_cond_init(&worker->space_cond)) {
+        goto error_destroy_cond;
+    }
+
+    bool ok = sc_thread_create(&worker->thread, run_packet_source_worker,
+                               "scrcpy-psink", worker);
+    if (!ok) {
+        LOGE("Could not start packet sink worker thread");
+        goto error_destroy_space_cond;
+    }
+
+    return true;
+
+error_destroy_space_cond:
+    sc_cond_destroy(&worker->space_cond);
+error_destroy_cond:
+    sc_cond_destroy(&worker->cond);
+error_destroy_mutex:
+    sc_mutex_destroy(&worker->mutex);
+error_destroy_queue:
+    sc_vecdeque_destroy(&worker->queue);
+
+    return false;
+}
+
+static void
+sc_packet_source_worker_stop(struct sc_packet_source_worker *worker,
+                             bool drain) {
+    sc_mutex_lock(&worker->mutex);
+    worker->stopped = true;
+    worker->drain = drain;
+    sc_cond_signal(&worker->cond);
+    sc_mutex_unlock(&worker->mutex);
+
+    sc_thread_join(&worker->thread, NULL);
+
+    if (worker->dropped) {
+        LOGD("Packet sink worker: %" PRIu64_ " packet(s) dropped",
+             worker->dropped);
+    }
+
+    sc_packet_source_worker_flush(worker);
+    sc_vecdeque_destroy(&worker->queue);
+    free(worker->config);
+    sc_cond_destroy(&worker->space_cond);
+    sc_cond_destroy(&worker->cond);
+    sc_mutex_destroy(&worker->mutex);
+}
+
+static void
+sc_packet_source_stop_workers(struct sc_packet_source *source,
+                              unsigned count, bool drain) {
+    while (count) {
+        sc_packet_source_worker_stop(&source->workers[--count], drain);
+    }
+}
+
+static bool
+sc_packet_source_start_workers(struct sc_packet_source *source, bool video) {
+    assert(source->async_queue_size);
+    assert(!source->workers);
+
+    source->workers = malloc(source->sink_count * sizeof(*source->workers));
+    if (!source->workers) {
+        LOG_OOM();
+        return false;
+    }
+
+    unsigned i = 0;
+    for (struct sc_packet_sink *sink = source->sinks; sink; sink = sink->next) {
+        bool ok = sc_packet_source_worker_start(&source->workers[i], sink,
+                                                source->async_queue_size,
+                                                video);
+        if (!ok) {
+            sc_packet_source_stop_workers(source, i, false);
+            free(source->workers);
+            source->workers = NULL;
+            return false;
+        }
+        ++i;
+    }
+
+    return true;
+}
+
 bool
 sc_packet_source_sinks_open(struct sc_packet_source *source,
                             AVCodecContext *ctx) {
     assert(source->sink_count);
-    for (unsigned i = 0; i < source->sink_count; ++i) {
-        struct sc_packet_sink *sink = source->sinks[i];
+    unsigned i = 0;
+    for (struct sc_packet_sink *sink = source->sinks; sink; sink = sink->next) {
         if (!sink->ops->open(sink, ctx)) {
             sc_packet_source_sinks_close_firsts(source, i);
             return false;
         }
+        ++i;
+    }
+
+    // With a single sink, a worker would only add a thread hop
+    if (source->async_queue_size && source->sink_count > 1) {
+        bool video = ctx->codec_type == AVMEDIA_TYPE_VIDEO;
+        if (!sc_packet_source_start_workers(source, video)) {
+            sc_packet_source_sinks_close(source);
+            return false;
+        }
     }
 
     return true;
 }
 
-void
-sc_packet_source_sinks_close(struct sc_packet_source *source) {
+static void
+sc_packet_source_sinks_stop(struct sc_packet_source *source, bool drain) {
     assert(source->sink_count);
+    if (source->workers) {
+        sc_packet_source_stop_workers(source, source->sink_count, drain);
+        free(source->workers);
+        source->workers = NULL;
+    }
+
     sc_packet_source_sinks_close_firsts(source, source->sink_count);
 }
 
+void
+sc_packet_source_sinks_close(struct sc_packet_source *source) {
+    sc_packet_source_sinks_stop(source, true);
+}
+
+void
+sc_packet_source_sinks_abort(struct sc_packet_source *source) {
+    sc_packet_source_sinks_stop(source, false);
+}
+
+// Keep the config attached to a packet to drop, otherwise the sink could not
+// decode the next key frame if the config changed
+static bool
+sc_packet_source_worker_keep_config(struct sc_packet_source_worker *worker,
+                                    const AVPacket *packet) {
+    size_t config_size;
+    const uint8_t *config = sc_packet_merger_get_config(packet, &config_size);
+    if (!config) {
+        // nothing to do
+        return true;
+    }
+
+    // Only the latest config is relevant
+    uint8_t *copy = realloc(worker->config, config_size);
+    if (!copy) {
+        LOG_OOM();
+        return false;
+    }
+    memcpy(copy, config, config_size);
+
+    worker->config = copy;
+    worker->config_size = config_size;
+    return true;
+}
+
+// Attach the kept config (if any) to the next key frame, unless it carries a
+// newer config
+static bool
+sc_packet_source_worker_attach_config(struct sc_packet_source_worker *worker,
+                                      AVPacket *packet) {
+    if (!worker->config || sc_packet_is_config(packet)
+            || !(packet->flags & AV_PKT_FLAG_KEY)) {
+        // nothing to do
+        return true;
+    }
+
+    size_t config_size;
+    if (!sc_packet_merger_get_config(packet, &config_size)) {
+        uint8_t *side_data =
+            av_packet_new_side_data(packet, AV_PKT_DATA_NEW_EXTRADATA,
+                                    worker->config_size);
+        if (!side_data) {
+            LOG_OOM();
+            return false;
+        }
+
+        memcpy(side_data, worker->config, worker->config_size);
+    }
+
+    free(worker->config);
+    worker->config = NULL;
+    return true;
+}
+
+// Drop a packet pushed to a worker (not queued)
+static bool
+sc_packet_source_worker_skip(struct sc_packet_source_worker *worker,
+                             const AVPacket *packet) {
+    ++worker->dropped;
+    return sc_packet_source_worker_keep_config(worker, packet);
+}
+
+// Drop packets from a full queue, keeping the config packets
+static bool
+sc_packet_source_worker_drop(struct sc_packet_source_worker *worker) {
+    assert(sc_mutex_held(&worker->mutex));
+
+    // For video, the queued packets could not be decoded without the dropped
+    // one, so drop all of them (the sink will restart on the next key frame).
+    // For audio, only drop the oldest one.
+    bool ok = true;
+    bool dropped = false;
+    size_t size = sc_vecdeque_size(&worker->queue);
+    for (size_t i = 0; i < size; ++i) {
+        AVPacket *packet = sc_vecdeque_pop(&worker->queue);
+        bool keep = sc_packet_is_config(packet) || (!worker->video && dropped);
+        if (keep) {
+            // The capacity is unchanged, and the order is preserved
+            sc_vecdeque_push_noresize(&worker->queue, packet);
+        } else {
+            // The packets are in order, so the last config kept is the latest
+            ok &= sc_packet_source_worker_skip(worker, packet);
+            av_packet_free(&packet);
+            dropped = true;
+        }
+    }
+
+    if (worker->video) {
+        worker->wait_key_frame = true;
+    }
+
+    return ok;
+}
+
+static bool
+sc_packet_source_worker_push(struct sc_packet_source *source,
+                             struct sc_packet_source_worker *worker,
+                             const AVPacket *packet) {
+    bool config = sc_packet_is_config(packet);
+    if (worker->wait_key_frame && !config) {
+        if (!(packet->flags & AV_PKT_FLAG_KEY)) {
+            // The sink could not decode it
+            return sc_packet_source_worker_skip(worker, packet);
+        }
+        worker->wait_key_frame = false;
+    }
+
+    AVPacket *ref = av_packet_alloc();
+    if (!ref) {
+        LOG_OOM();
+        return false;
+    }
+
+    if (av_packet_ref(ref, packet)) {
+        LOG_OOM();
+        av_packet_free(&ref);
+        return false;
+    }
+
+    sc_mutex_lock(&worker->mutex);
+
+    if (worker->sink->lossless) {
+        // Never drop, wait for the sink to consume a packet
+        while (!worker->failed
+                && sc_vecdeque_size(&worker->queue) == worker->queue_size) {
+            sc_cond_wait(&worker->space_cond, &worker->mutex);
+        }
+    }
+
+    if (worker->failed) {
+        sc_mutex_unlock(&worker->mutex);
+        av_packet_free(&ref);
+        return false;
+    }
+
+    bool ok = true;
+    bool queue = true;
+    bool request_key_frame = false;
+
+    if (sc_vecdeque_size(&worker->queue) == worker->queue_size) {
+        // The sink is too slow
+        ok = sc_packet_source_worker_drop(worker);
+        // The sink waits for the next key frame, request one early
+        request_key_frame = worker->video;
+
+        if (worker->wait_key_frame && !config
+                && !(packet->flags & AV_PKT_FLAG_KEY)) {
+            queue = false;
+        } else {
+            worker->wait_key_frame = false;
+
+            if (sc_vecdeque_size(&worker->queue) == worker->queue_size) {
+                // Only config packets, this should never happen
+                LOGW("Packet sink queue full of config packets");
+                queue = false;
+            }
+        }
+    }
+
+    if (queue) {
+        ok &= sc_packet_source_worker_attach_config(worker, ref);
+        // The capacity has been reserved on start
+        sc_vecdeque_push_noresize(&worker->queue, ref);
+        sc_cond_signal(&worker->cond);
+    }
+
+    sc_mutex_unlock(&worker->mutex);
+
+    if (!queue) {
+        ok &= sc_packet_source_worker_skip(worker, ref);
+        av_packet_free(&ref);
+    }
+
+    if (request_key_frame && source->cbs) {
+        source->cbs->on_drop(source, source->cbs_userdata);
+    }
+
+    return ok;
+}
+
 bool
 sc_packet_source_sinks_push(struct sc_packet_source *source,
                             const AVPacket *packet) {
     assert(source->sink_count);
-    for (unsigned i = 0; i < source->sink_count; ++i) {
-        struct sc_packet_sink *sink = source->sinks[i];
+
+    if (source->workers) {
+        for (unsigned i = 0; i < source->sink_count; ++i) {
+            if (!sc_packet_source_worker_push(source, &source->workers[i],
+                                              packet)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    for (struct sc_packet_sink *sink = source->sinks; sink; sink = sink->next) {
         if (!sink->ops->push(sink, packet)) {
             return false;
         }
@@ -63,8 +535,7 @@ sc_packet_source_sinks_push(struct sc_packet_source *source,
 void
 sc_packet_source_sinks_disable(struct sc_packet_source *source) {
     assert(source->sink_count);
-    for (unsigned i = 0; i < source->sink_count; ++i) {
-        struct sc_packet_sink *sink = source->sinks[i];
+    for (struct sc_packet_sink *sink = source->sinks; sink; sink = sink->next) {
         if (sink->ops->disable) {
             sink->ops->disable(sink);
         }
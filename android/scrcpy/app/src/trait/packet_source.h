@@ -7,16 +7,39 @@
 
 #include "trait/packet_sink.h"
 
-#define SC_PACKET_SOURCE_MAX_SINKS 2
+// forward declarations
+struct sc_packet_source_worker;
+struct sc_packet_source_callbacks;
 
 /**
  * Packet source trait
  *
  * Component able to send AVPackets should implement this trait.
+ *
+ * By default, packets are pushed to all sinks sequentially, from the thread
+ * calling sc_packet_source_sinks_push(). In asynchronous mode (see
+ * sc_packet_source_set_async()), each sink receives the packets from its own
+ * worker thread, so that a slow sink does not delay the others.
  */
 struct sc_packet_source {
-    struct sc_packet_sink *sinks[SC_PACKET_SOURCE_MAX_SINKS];
+    struct sc_packet_sink *sinks; // linked list
     unsigned sink_count;
+
+    unsigned async_queue_size; // 0 for synchronous push
+    // one worker per sink, only if the asynchronous mode is active
+    struct sc_packet_source_worker *workers;
+
+    const struct sc_packet_source_callbacks *cbs; // may be NULL
+    void *cbs_userdata;
+};
+
+struct sc_packet_source_callbacks {
+    /**
+     * Called from the source thread when video packets have been dropped
+     * because the queue of a sink was full, so that the sink waits for the
+     * next key frame (typically, to request one from the device)
+     */
+    void (*on_drop)(struct sc_packet_source *source, void *userdata);
 };
 
 void
@@ -26,13 +49,68 @@ void
 sc_packet_source_add_sink(struct sc_packet_source *source,
                           struct sc_packet_sink *sink);
 
+/**
+ * Add a sink which must receive all the packets (typically, the recorder)
+ *
+ * In asynchronous mode, the packets are never dropped for this sink: if its
+ * queue is full, sc_packet_source_sinks_push() waits for a free slot.
+ */
+void
+sc_packet_source_add_lossless_sink(struct sc_packet_source *source,
+                                   struct sc_packet_sink *sink);
+
+/**
+ * Enable the asynchronous fan-out mode
+ *
+ * Each sink will be fed from its own thread, via a queue of at most
+ * `queue_size` packets. If the queue of a sink is full, packets are dropped
+ * (for video, until the next key frame, so that the sink never receives
+ * packets it could not decode), except for lossless sinks (see
+ * sc_packet_source_add_lossless_sink()). Config packets are never dropped, and
+ * the config attached to a dropped packet is attached to the next key frame
+ * pushed to the sink.
+ *
+ * It has no effect if there is only one sink (the packets are then pushed
+ * directly).
+ *
+ * Must be called before sc_packet_source_sinks_open().
+ */
+void
+sc_packet_source_set_async(struct sc_packet_source *source,
+                           unsigned queue_size);
+
+/**
+ * Set the callbacks notified of the packets dropped in asynchronous mode
+ *
+ * Must be called before sc_packet_source_sinks_open().
+ */
+void
+sc_packet_source_set_callbacks(struct sc_packet_source *source,
+                               const struct sc_packet_source_callbacks *cbs,
+                               void *cbs_userdata);
+
 bool
 sc_packet_source_sinks_open(struct sc_packet_source *source,
                             AVCodecContext *ctx);
 
+/**
+ * Close the sinks
+ *
+ * In asynchronous mode, the packets still queued are pushed to their sink
+ * first.
+ */
 void
 sc_packet_source_sinks_close(struct sc_packet_source *source);
 
+/**
+ * Close the sinks after a failure
+ *
+ * Same as sc_packet_source_sinks_close(), but the packets still queued in
+ * asynchronous mode are discarded.
+ */
+void
+sc_packet_source_sinks_abort(struct sc_packet_source *source);
+
 bool
 sc_packet_source_sinks_push(struct sc_packet_source *source,
                             const AVPacket *packet);
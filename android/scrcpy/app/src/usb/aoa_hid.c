@@ -4,10 +4,13 @@
 #include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/types.h>
 #include <libusb-1.0/libusb.h>
 
 #include "events.h"
+#include "hid/hid_gamepad.h"
+#include "hid/hid_mouse.h"
 #include "util/log.h"
 #include "util/str.h"
 #include "util/tick.h"
@@ -29,13 +32,10 @@ struct sc_vec_hid_ids SC_VECTOR(uint16_t);
 static void
 sc_hid_input_log(const struct sc_hid_input *hid_input) {
     // HID input: [00] FF FF FF FF...
-    assert(hid_input->size);
-    char *hex = sc_str_to_hex_string(hid_input->data, hid_input->size);
-    if (!hex) {
-        return;
-    }
+    assert(hid_input->size && hid_input->size <= SC_HID_MAX_SIZE);
+    char hex[SC_STR_HEX_SIZE(SC_HID_MAX_SIZE)];
+    sc_str_write_hex(hex, hid_input->data, hid_input->size);
     LOGV("HID input: [%" PRIu16 "] %s", hid_input->hid_id, hex);
-    free(hex);
 }
 
 static void
@@ -57,6 +57,42 @@ sc_hid_close_log(const struct sc_hid_close *hid_close) {
     LOGV("HID close: [%" PRIu16 "]", hid_close->hid_id);
 }
 
+static void
+sc_aoa_free_transfers(struct sc_aoa *aoa, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        free(aoa->transfers[i].transfer->buffer);
+        libusb_free_transfer(aoa->transfers[i].transfer);
+    }
+}
+
+static bool
+sc_aoa_alloc_transfers(struct sc_aoa *aoa) {
+    for (size_t i = 0; i < SC_AOA_TRANSFER_POOL_SIZE; ++i) {
+        struct sc_aoa_transfer *t = &aoa->transfers[i];
+        t->aoa = aoa;
+        atomic_init(&t->busy, false);
+
+        t->transfer = libusb_alloc_transfer(0);
+        if (!t->transfer) {
+            LOG_OOM();
+            sc_aoa_free_transfers(aoa, i);
+            return false;
+        }
+
+        // Control setup + HID event data
+        t->transfer->buffer =
+            malloc(LIBUSB_CONTROL_SETUP_SIZE + SC_HID_MAX_SIZE);
+        if (!t->transfer->buffer) {
+            LOG_OOM();
+            libusb_free_transfer(t->transfer);
+            sc_aoa_free_transfers(aoa, i);
+            return false;
+        }
+    }
+
+    return true;
+}
+
 bool
 sc_aoa_init(struct sc_aoa *aoa, struct sc_usb *usb,
             struct sc_acksync *acksync) {
@@ -78,6 +114,16 @@ sc_aoa_init(struct sc_aoa *aoa, struct sc_usb *usb,
         return false;
     }
 
+    if (!sc_aoa_alloc_transfers(aoa)) {
+        sc_cond_destroy(&aoa->event_cond);
+        sc_mutex_destroy(&aoa->mutex);
+        sc_vecdeque_destroy(&aoa->queue);
+        return false;
+    }
+
+    atomic_init(&aoa->inflight, 0);
+    aoa->transfer_completed = 0;
+
     aoa->stopped = false;
     aoa->acksync = acksync;
     aoa->usb = usb;
@@ -87,6 +133,9 @@ sc_aoa_init(struct sc_aoa *aoa, struct sc_usb *usb,
 
 void
 sc_aoa_destroy(struct sc_aoa *aoa) {
+    assert(!atomic_load(&aoa->inflight));
+    sc_aoa_free_transfers(aoa, SC_AOA_TRANSFER_POOL_SIZE);
+
     sc_vecdeque_destroy(&aoa->queue);
 
     sc_cond_destroy(&aoa->event_cond);
@@ -154,9 +203,63 @@ sc_aoa_set_hid_report_desc(struct sc_aoa *aoa, uint16_t accessory_id,
     return true;
 }
 
+static void LIBUSB_CALL
+sc_aoa_transfer_cb(struct libusb_transfer *transfer) {
+    struct sc_aoa_transfer *t = transfer->user_data;
+    struct sc_aoa *aoa = t->aoa;
+
+    if (transfer->status != LIBUSB_TRANSFER_COMPLETED) {
+        LOGW("SEND_HID_EVENT: transfer failed (status %d)",
+             (int) transfer->status);
+        if (transfer->status == LIBUSB_TRANSFER_NO_DEVICE) {
+            sc_usb_check_disconnected(aoa->usb, LIBUSB_ERROR_NO_DEVICE);
+        }
+    }
+
+    atomic_store(&t->busy, false);
+    atomic_fetch_sub(&aoa->inflight, 1);
+    // Wake up sc_aoa_wait_transfers()
+    aoa->transfer_completed = 1;
+}
+
+// Wait until at most max_inflight HID events are being sent
+static void
+sc_aoa_wait_transfers(struct sc_aoa *aoa, unsigned max_inflight) {
+    for (;;) {
+        // Reset before checking, so that a completion happening in between is
+        // not missed
+        aoa->transfer_completed = 0;
+        if (atomic_load(&aoa->inflight) <= max_inflight) {
+            return;
+        }
+
+        // The transfer callbacks may be called either from this thread or from
+        // the libusb event thread, libusb handles the synchronization.
+        // The transfers have a timeout, so this never blocks forever.
+        int r = libusb_handle_events_completed(aoa->usb->context,
+                                               &aoa->transfer_completed);
+        if (r < 0 && r != LIBUSB_ERROR_INTERRUPTED) {
+            LOGW("libusb_handle_events_completed() failed: %s",
+                 libusb_strerror(r));
+        }
+    }
+}
+
 static bool
 sc_aoa_send_hid_event(struct sc_aoa *aoa,
                       const struct sc_hid_input *hid_input) {
+    // Wait for a free transfer
+    sc_aoa_wait_transfers(aoa, SC_AOA_TRANSFER_POOL_SIZE - 1);
+
+    struct sc_aoa_transfer *t = NULL;
+    for (size_t i = 0; i < SC_AOA_TRANSFER_POOL_SIZE; ++i) {
+        if (!atomic_load(&aoa->transfers[i].busy)) {
+            t = &aoa->transfers[i];
+            break;
+        }
+    }
+    assert(t);
+
     uint8_t request_type = LIBUSB_ENDPOINT_OUT | LIBUSB_REQUEST_TYPE_VENDOR;
     uint8_t request = ACCESSORY_SEND_HID_EVENT;
     // <https://source.android.com/devices/accessories/aoa2.html#hid-support>
@@ -164,12 +267,25 @@ sc_aoa_send_hid_event(struct sc_aoa *aoa,
     // index (arg1): 0 (unused)
     uint16_t value = hid_input->hid_id;
     uint16_t index = 0;
-    unsigned char *data = (uint8_t *) hid_input->data; // discard const
     uint16_t length = hid_input->size;
-    int result = libusb_control_transfer(aoa->usb->handle, request_type,
-                                         request, value, index, data, length,
-                                         DEFAULT_TIMEOUT);
+    assert(length <= SC_HID_MAX_SIZE);
+
+    // The control transfers on endpoint 0 are executed in order, so the HID
+    // events are still received in order by the device
+    unsigned char *buffer = t->transfer->buffer;
+    libusb_fill_control_setup(buffer, request_type, request, value, index,
+                              length);
+    memcpy(buffer + LIBUSB_CONTROL_SETUP_SIZE, hid_input->data, length);
+    libusb_fill_control_transfer(t->transfer, aoa->usb->handle, buffer,
+                                 sc_aoa_transfer_cb, t, DEFAULT_TIMEOUT);
+
+    atomic_store(&t->busy, true);
+    atomic_fetch_add(&aoa->inflight, 1);
+
+    int result = libusb_submit_transfer(t->transfer);
     if (result < 0) {
+        atomic_store(&t->busy, false);
+        atomic_fetch_sub(&aoa->inflight, 1);
         LOGE("SEND_HID_EVENT: libusb error: %s", libusb_strerror(result));
         sc_usb_check_disconnected(aoa->usb, result);
         return false;
@@ -221,6 +337,26 @@ sc_aoa_setup_hid(struct sc_aoa *aoa, uint16_t accessory_id,
     return true;
 }
 
+// Merge an input into the last pending one if possible, so that a high
+// polling rate mouse or gamepad does not generate one USB transfer per event
+static bool
+sc_aoa_merge_input(struct sc_hid_input *dst, const struct sc_hid_input *src) {
+    if (dst->hid_id != src->hid_id) {
+        return false;
+    }
+
+    if (src->hid_id == SC_HID_ID_MOUSE) {
+        return sc_hid_mouse_merge_motion_input(dst, src);
+    }
+
+    if (src->hid_id >= SC_HID_ID_GAMEPAD_FIRST
+            && src->hid_id <= SC_HID_ID_GAMEPAD_LAST) {
+        return sc_hid_gamepad_merge_input(dst, src);
+    }
+
+    return false;
+}
+
 bool
 sc_aoa_push_input_with_ack_to_wait(struct sc_aoa *aoa,
                                    const struct sc_hid_input *hid_input,
@@ -234,6 +370,17 @@ sc_aoa_push_input_with_ack_to_wait(struct sc_aoa *aoa,
     bool pushed = false;
 
     size_t size = sc_vecdeque_size(&aoa->queue);
+
+    if (size && ack_to_wait == SC_SEQUENCE_INVALID) {
+        struct sc_aoa_event *last = sc_vecdeque_peek_back(&aoa->queue);
+        if (last->type == SC_AOA_EVENT_TYPE_INPUT
+                && last->input.ack_to_wait == SC_SEQUENCE_INVALID
+                && sc_aoa_merge_input(&last->input.hid, hid_input)) {
+            sc_mutex_unlock(&aoa->mutex);
+            return true;
+        }
+    }
+
     if (size < SC_AOA_EVENT_QUEUE_LIMIT) {
         bool was_empty = sc_vecdeque_is_empty(&aoa->queue);
 
@@ -356,6 +503,9 @@ sc_aoa_process_event(struct sc_aoa *aoa, struct sc_aoa_event *event,
             break;
         }
         case SC_AOA_EVENT_TYPE_OPEN: {
+            // The pending HID events must be sent before
+            sc_aoa_wait_transfers(aoa, 0);
+
             struct sc_hid_open *hid_open = &event->open.hid;
             bool ok = sc_aoa_setup_hid(aoa, hid_open->hid_id,
                                        hid_open->report_desc,
@@ -380,6 +530,8 @@ sc_aoa_process_event(struct sc_aoa *aoa, struct sc_aoa_event *event,
             break;
         }
         case SC_AOA_EVENT_TYPE_CLOSE: {
+            sc_aoa_wait_transfers(aoa, 0);
+
             struct sc_hid_close *hid_close = &event->close.hid;
             bool ok = sc_aoa_unregister_hid(aoa, hid_close->hid_id);
             if (ok) {
@@ -430,6 +582,10 @@ run_aoa_thread(void *data) {
         }
     }
 
+    // Wait for the pending HID events (the transfers must not be freed while
+    // they are in flight)
+    sc_aoa_wait_transfers(aoa, 0);
+
     // Explicitly unregister all registered HID ids before exiting
     for (size_t i = 0; i < vec_open.size; ++i) {
         uint16_t hid_id = vec_open.data[i];
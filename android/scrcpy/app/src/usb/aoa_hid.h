@@ -3,6 +3,7 @@
 
 #include "common.h"
 
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -37,6 +38,15 @@ struct sc_aoa_event {
 
 struct sc_aoa_event_queue SC_VECDEQUE(struct sc_aoa_event);
 
+// Maximum number of HID events sent asynchronously at the same time
+#define SC_AOA_TRANSFER_POOL_SIZE 4
+
+struct sc_aoa_transfer {
+    struct sc_aoa *aoa;
+    struct libusb_transfer *transfer;
+    atomic_bool busy;
+};
+
 struct sc_aoa {
     struct sc_usb *usb;
     sc_thread thread;
@@ -45,6 +55,12 @@ struct sc_aoa {
     bool stopped;
     struct sc_aoa_event_queue queue;
 
+    // HID events are sent without waiting for the previous ones to complete
+    struct sc_aoa_transfer transfers[SC_AOA_TRANSFER_POOL_SIZE];
+    atomic_uint inflight;
+    // set from the transfer callbacks, for libusb_handle_events_completed()
+    int transfer_completed;
+
     struct sc_acksync *acksync;
 };
 
@@ -0,0 +1,523 @@
+#include "usb_transport.h"
+
+#include <assert.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <SDL2/SDL_timer.h>
+
+#include "util/binary.h"
+#include "util/log.h"
+
+// See <https://source.android.com/devices/accessories/aoa>.
+#define ACCESSORY_GET_PROTOCOL 51
+#define ACCESSORY_SEND_STRING 52
+#define ACCESSORY_START 53
+
+#define AOA_VENDOR_ID 0x18D1
+#define AOA_PRODUCT_ID_ACCESSORY 0x2D00
+#define AOA_PRODUCT_ID_ACCESSORY_ADB 0x2D01
+
+#define DEFAULT_TIMEOUT 1000
+
+// The device re-enumerates once switched to accessory mode
+#define SC_USB_TRANSPORT_ENUMERATION_ATTEMPTS 50
+#define SC_USB_TRANSPORT_ENUMERATION_DELAY_MS 100
+
+// Timeout of individual bulk transfers, to check whether the transport is
+// stopped
+#define SC_USB_TRANSPORT_POLL_TIMEOUT 200
+
+#define SC_USB_TRANSPORT_HEADER_SIZE 4
+#define SC_USB_TRANSPORT_MAX_PAYLOAD 0xFFFFFF
+
+// Large bulk reads, to receive many frames per transfer at high bit rates
+#define SC_USB_TRANSPORT_IN_BUFFER_SIZE (256 * 1024)
+#define SC_USB_TRANSPORT_OUT_BUFFER_SIZE (16 * 1024)
+
+static bool
+is_accessory(const struct libusb_device_descriptor *desc) {
+    return desc->idVendor == AOA_VENDOR_ID
+        && (desc->idProduct == AOA_PRODUCT_ID_ACCESSORY
+            || desc->idProduct == AOA_PRODUCT_ID_ACCESSORY_ADB);
+}
+
+static bool
+has_serial(libusb_device *device, const struct libusb_device_descriptor *desc,
+           const char *serial) {
+    if (!desc->iSerialNumber) {
+        return false;
+    }
+
+    libusb_device_handle *handle;
+    int result = libusb_open(device, &handle);
+    if (result < 0) {
+        return false;
+    }
+
+    char buffer[128];
+    result = libusb_get_string_descriptor_ascii(handle, desc->iSerialNumber,
+                                                (unsigned char *) buffer,
+                                                sizeof(buffer) - 1);
+    libusb_close(handle);
+    if (result < 0) {
+        return false;
+    }
+
+    buffer[result] = '\0';
+    return !strcmp(buffer, serial);
+}
+
+// Return a new reference to the device with the given serial, in accessory
+// mode or not, or NULL
+static libusb_device *
+find_device(struct sc_usb *usb, const char *serial, bool accessory) {
+    libusb_device **list;
+    ssize_t count = libusb_get_device_list(usb->context, &list);
+    if (count < 0) {
+        LOGE("List USB devices: libusb error: %s", libusb_strerror(count));
+        return NULL;
+    }
+
+    libusb_device *found = NULL;
+    for (size_t i = 0; i < (size_t) count; ++i) {
+        struct libusb_device_descriptor desc;
+        if (libusb_get_device_descriptor(list[i], &desc) < 0) {
+            continue;
+        }
+
+        if (is_accessory(&desc) == accessory
+                && has_serial(list[i], &desc, serial)) {
+            found = libusb_ref_device(list[i]);
+            break;
+        }
+    }
+
+    libusb_free_device_list(list, 1);
+    return found;
+}
+
+static bool
+send_string(libusb_device_handle *handle, uint16_t index, const char *s) {
+    int result = libusb_control_transfer(handle, LIBUSB_REQUEST_TYPE_VENDOR,
+                                         ACCESSORY_SEND_STRING, 0, index,
+                                         (unsigned char *) s, strlen(s) + 1,
+                                         DEFAULT_TIMEOUT);
+    if (result < 0) {
+        LOGE("SEND_STRING: libusb error: %s", libusb_strerror(result));
+        return false;
+    }
+
+    return true;
+}
+
+static bool
+start_accessory(libusb_device *device, const char *serial) {
+    libusb_device_handle *handle;
+    int result = libusb_open(device, &handle);
+    if (result < 0) {
+        LOGE("Open USB device: libusb error: %s", libusb_strerror(result));
+        return false;
+    }
+
+    uint8_t data[2];
+    result = libusb_control_transfer(handle,
+                                     LIBUSB_ENDPOINT_IN
+                                         | LIBUSB_REQUEST_TYPE_VENDOR,
+                                     ACCESSORY_GET_PROTOCOL, 0, 0, data,
+                                     sizeof(data), DEFAULT_TIMEOUT);
+    // The protocol version is little-endian, 0 if unsupported
+    if (result < 0 || !(data[0] | data[1] << 8)) {
+        LOGE("The device does not support the AOA accessory mode");
+        libusb_close(handle);
+        return false;
+    }
+
+    // Manufacturer, model, description, version, URI and serial
+    bool ok = send_string(handle, 0, "Genymobile")
+           && send_string(handle, 1, "scrcpy")
+           && send_string(handle, 2, "scrcpy USB transport")
+           && send_string(handle, 3, SCRCPY_VERSION)
+           && send_string(handle, 4, "https://github.com/Genymobile/scrcpy")
+           && send_string(handle, 5, serial);
+    if (!ok) {
+        libusb_close(handle);
+        return false;
+    }
+
+    result = libusb_control_transfer(handle, LIBUSB_REQUEST_TYPE_VENDOR,
+                                     ACCESSORY_START, 0, 0, NULL, 0,
+                                     DEFAULT_TIMEOUT);
+    libusb_close(handle);
+    if (result < 0) {
+        LOGE("START: libusb error: %s", libusb_strerror(result));
+        return false;
+    }
+
+    return true;
+}
+
+static bool
+find_bulk_endpoints(struct sc_usb_transport *transport) {
+    libusb_device *device = libusb_get_device(transport->usb.handle);
+
+    struct libusb_config_descriptor *config;
+    int result = libusb_get_active_config_descriptor(device, &config);
+    if (result < 0) {
+        LOGE("Config descriptor: libusb error: %s", libusb_strerror(result));
+        return false;
+    }
+
+    // The accessory interface is always the first one (the adb interface, if
+    // any, comes next)
+    bool found_in = false;
+    bool found_out = false;
+    if (config->bNumInterfaces) {
+        const struct libusb_interface_descriptor *iface =
+            &config->interface[0].altsetting[0];
+        transport->interface = iface->bInterfaceNumber;
+        for (uint8_t i = 0; i < iface->bNumEndpoints; ++i) {
+            const struct libusb_endpoint_descriptor *ep = &iface->endpoint[i];
+            if ((ep->bmAttributes & LIBUSB_TRANSFER_TYPE_MASK)
+                    != LIBUSB_TRANSFER_TYPE_BULK) {
+                continue;
+            }
+            if (ep->bEndpointAddress & LIBUSB_ENDPOINT_IN) {
+                transport->endpoint_in = ep->bEndpointAddress;
+                found_in = true;
+            } else {
+                transport->endpoint_out = ep->bEndpointAddress;
+                found_out = true;
+            }
+        }
+    }
+
+    libusb_free_config_descriptor(config);
+
+    if (!found_in || !found_out) {
+        LOGE("Could not find the bulk endpoints of the accessory interface");
+        return false;
+    }
+
+    return true;
+}
+
+bool
+sc_usb_transport_init(struct sc_usb_transport *transport, const char *serial) {
+    assert(serial);
+
+    if (!sc_usb_init(&transport->usb)) {
+        LOGE("Could not initialize USB");
+        return false;
+    }
+
+    libusb_device *device = find_device(&transport->usb, serial, true);
+    if (!device) {
+        device = find_device(&transport->usb, serial, false);
+        if (!device) {
+            LOGE("Could not find USB device %s", serial);
+            goto error_destroy_usb;
+        }
+
+        bool ok = start_accessory(device, serial);
+        libusb_unref_device(device);
+        if (!ok) {
+            goto error_destroy_usb;
+        }
+
+        LOGD("Waiting for the device to switch to accessory mode...");
+        device = NULL;
+        for (unsigned i = 0; !device
+                && i < SC_USB_TRANSPORT_ENUMERATION_ATTEMPTS; ++i) {
+            SDL_Delay(SC_USB_TRANSPORT_ENUMERATION_DELAY_MS);
+            device = find_device(&transport->usb, serial, true);
+        }
+
+        if (!device) {
+            LOGE("The device did not switch to accessory mode");
+            goto error_destroy_usb;
+        }
+    }
+
+    bool ok = sc_usb_connect(&transport->usb, device, NULL, NULL);
+    libusb_unref_device(device);
+    if (!ok) {
+        goto error_destroy_usb;
+    }
+
+    if (!find_bulk_endpoints(transport)) {
+        goto error_disconnect;
+    }
+
+    int result = libusb_claim_interface(transport->usb.handle,
+                                        transport->interface);
+    if (result < 0) {
+        LOGE("Claim USB interface: libusb error: %s",
+             libusb_strerror(result));
+        goto error_disconnect;
+    }
+
+    transport->stream_count = 0;
+    transport->control_index = -1;
+    transport->has_out_thread = false;
+    atomic_init(&transport->stopped, false);
+    atomic_init(&transport->bytes_in, 0);
+    atomic_init(&transport->bytes_out, 0);
+
+    return true;
+
+error_disconnect:
+    sc_usb_disconnect(&transport->usb);
+error_destroy_usb:
+    sc_usb_destroy(&transport->usb);
+
+    return false;
+}
+
+static void
+sc_usb_transport_interrupt_sockets(struct sc_usb_transport *transport) {
+    for (unsigned i = 0; i < transport->stream_count; ++i) {
+        net_interrupt(transport->sockets[i]);
+    }
+}
+
+static int
+run_usb_transport_in(void *data) {
+    struct sc_usb_transport *transport = data;
+
+    sc_thread_apply_policy(SC_THREAD_ROLE_VIDEO);
+
+    uint8_t *buf = malloc(SC_USB_TRANSPORT_IN_BUFFER_SIZE);
+    if (!buf) {
+        LOG_OOM();
+        goto end;
+    }
+
+    // A frame may span several transfers, and a transfer may contain several
+    // frames
+    uint8_t header[SC_USB_TRANSPORT_HEADER_SIZE];
+    size_t header_len = 0;
+    unsigned stream = 0;
+    size_t remaining = 0; // payload bytes of the current frame
+
+    while (!atomic_load(&transport->stopped)) {
+        int len;
+        int result = libusb_bulk_transfer(transport->usb.handle,
+                                          transport->endpoint_in, buf,
+                                          SC_USB_TRANSPORT_IN_BUFFER_SIZE,
+                                          &len, SC_USB_TRANSPORT_POLL_TIMEOUT);
+        if (result < 0 && result != LIBUSB_ERROR_TIMEOUT) {
+            LOGD("USB transport read: libusb error: %s",
+                 libusb_strerror(result));
+            break;
+        }
+
+        atomic_fetch_add_explicit(&transport->bytes_in, len,
+                                  memory_order_relaxed);
+
+        const uint8_t *p = buf;
+        const uint8_t *end = buf + len;
+        while (p < end) {
+            if (!remaining) {
+                size_t n = MIN(SC_USB_TRANSPORT_HEADER_SIZE - header_len,
+                               (size_t) (end - p));
+                memcpy(header + header_len, p, n);
+                header_len += n;
+                p += n;
+                if (header_len < SC_USB_TRANSPORT_HEADER_SIZE) {
+                    break;
+                }
+
+                header_len = 0;
+                stream = header[0];
+                remaining = sc_read32be(header) & SC_USB_TRANSPORT_MAX_PAYLOAD;
+                if (stream >= transport->stream_count) {
+                    LOGE("USB transport: unexpected stream %u", stream);
+                    goto end;
+                }
+                continue;
+            }
+
+            size_t n = MIN(remaining, (size_t) (end - p));
+            ssize_t w = net_send_all(transport->sockets[stream], p, n);
+            if (w < 0 || (size_t) w != n) {
+                // The stream socket has been closed
+                goto end;
+            }
+            p += n;
+            remaining -= n;
+        }
+    }
+
+end:
+    free(buf);
+    // Wake up the stream threads: from their point of view, this is a
+    // disconnection
+    sc_usb_transport_interrupt_sockets(transport);
+    LOGD("USB transport input thread ended");
+    return 0;
+}
+
+static int
+run_usb_transport_out(void *data) {
+    struct sc_usb_transport *transport = data;
+
+    sc_thread_apply_policy(SC_THREAD_ROLE_CONTROL);
+
+    assert(transport->control_index >= 0);
+    unsigned stream = transport->control_index;
+    sc_socket socket = transport->sockets[stream];
+
+    uint8_t *buf = malloc(SC_USB_TRANSPORT_HEADER_SIZE
+                          + SC_USB_TRANSPORT_OUT_BUFFER_SIZE);
+    if (!buf) {
+        LOG_OOM();
+        goto end;
+    }
+
+    for (;;) {
+        // Forward the control msgs as soon as they are available, without
+        // waiting to fill the buffer
+        ssize_t r = net_recv(socket, buf + SC_USB_TRANSPORT_HEADER_SIZE,
+                             SC_USB_TRANSPORT_OUT_BUFFER_SIZE);
+        if (r <= 0) {
+            // Stopped or disconnected
+            break;
+        }
+
+        sc_write32be(buf, (uint32_t) stream << 24 | (uint32_t) r);
+
+        int total = SC_USB_TRANSPORT_HEADER_SIZE + (int) r;
+        int sent = 0;
+        while (sent < total) {
+            int len;
+            int result = libusb_bulk_transfer(transport->usb.handle,
+                                              transport->endpoint_out,
+                                              buf + sent, total - sent, &len,
+                                              SC_USB_TRANSPORT_POLL_TIMEOUT);
+            // On timeout, a part of the data may have been transferred
+            sent += len;
+            if (result == LIBUSB_ERROR_TIMEOUT
+                    && !atomic_load(&transport->stopped)) {
+                continue;
+            }
+            if (result < 0) {
+                LOGD("USB transport write: libusb error: %s",
+                     libusb_strerror(result));
+                goto end;
+            }
+        }
+
+        atomic_fetch_add_explicit(&transport->bytes_out, total,
+                                  memory_order_relaxed);
+    }
+
+end:
+    free(buf);
+    sc_usb_transport_interrupt_sockets(transport);
+    LOGD("USB transport output thread ended");
+    return 0;
+}
+
+bool
+sc_usb_transport_start(struct sc_usb_transport *transport,
+                       unsigned stream_count, int control_index,
+                       sc_socket out_sockets[]) {
+    assert(stream_count && stream_count <= SC_USB_TRANSPORT_MAX_STREAMS);
+    assert(control_index < (int) stream_count);
+
+    unsigned i;
+    for (i = 0; i < stream_count; ++i) {
+        sc_socket pair[2];
+        if (!net_socketpair(pair)) {
+            LOGE("Could not create the USB transport sockets");
+            goto error_close_sockets;
+        }
+
+        // The frames are forwarded as soon as they are received, do not let
+        // Nagle's algorithm delay them
+        net_set_tcp_nodelay(pair[0], true);
+        net_set_tcp_nodelay(pair[1], true);
+
+        out_sockets[i] = pair[0];
+        transport->sockets[i] = pair[1];
+    }
+
+    transport->stream_count = stream_count;
+    transport->control_index = control_index;
+    transport->start_time = sc_tick_now();
+
+    bool ok = sc_thread_create(&transport->in_thread, run_usb_transport_in,
+                               "scrcpy-usb-in", transport);
+    if (!ok) {
+        LOGE("Could not start USB transport input thread");
+        goto error_close_sockets;
+    }
+
+    if (control_index >= 0) {
+        ok = sc_thread_create(&transport->out_thread, run_usb_transport_out,
+                              "scrcpy-usb-out", transport);
+        if (!ok) {
+            LOGE("Could not start USB transport output thread");
+            atomic_store(&transport->stopped, true);
+            sc_usb_transport_interrupt_sockets(transport);
+            sc_thread_join(&transport->in_thread, NULL);
+            goto error_close_sockets;
+        }
+        transport->has_out_thread = true;
+    }
+
+    return true;
+
+error_close_sockets:
+    while (i--) {
+        net_close(out_sockets[i]);
+        net_close(transport->sockets[i]);
+    }
+    transport->stream_count = 0;
+
+    return false;
+}
+
+void
+sc_usb_transport_stop(struct sc_usb_transport *transport) {
+    atomic_store(&transport->stopped, true);
+    sc_usb_transport_interrupt_sockets(transport);
+}
+
+void
+sc_usb_transport_join(struct sc_usb_transport *transport) {
+    if (!transport->stream_count) {
+        // Not started
+        return;
+    }
+
+    sc_thread_join(&transport->in_thread, NULL);
+    if (transport->has_out_thread) {
+        sc_thread_join(&transport->out_thread, NULL);
+    }
+}
+
+void
+sc_usb_transport_destroy(struct sc_usb_transport *transport) {
+    if (transport->stream_count) {
+        sc_tick duration = sc_tick_now() - transport->start_time;
+        uint64_t bytes_in = atomic_load(&transport->bytes_in);
+        uint64_t bytes_out = atomic_load(&transport->bytes_out);
+        // To compare with the adb tunnel
+        LOGI("USB transport: received %" PRIu64 " bytes, sent %" PRIu64
+             " bytes in %" PRItick " ms (%.1f Mbps in)", bytes_in, bytes_out,
+             SC_TICK_TO_MS(duration),
+             duration > 0 ? (double) bytes_in * 8 * SC_TICK_FREQ
+                                / duration / 1000000
+                          : 0.0);
+
+        for (unsigned i = 0; i < transport->stream_count; ++i) {
+            net_close(transport->sockets[i]);
+        }
+    }
+
+    libusb_release_interface(transport->usb.handle, transport->interface);
+    sc_usb_disconnect(&transport->usb);
+    sc_usb_destroy(&transport->usb);
+}
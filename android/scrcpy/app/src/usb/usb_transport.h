@@ -0,0 +1,74 @@
+#ifndef SC_USB_TRANSPORT_H
+#define SC_USB_TRANSPORT_H
+
+#include "common.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "usb/usb.h"
+#include "util/net.h"
+#include "util/thread.h"
+#include "util/tick.h"
+
+// Video, audio, control and secondary video
+#define SC_USB_TRANSPORT_MAX_STREAMS 4
+
+/**
+ * Transport of the streams over a dedicated USB bulk interface, instead of
+ * the adb forwarding.
+ *
+ * The device is switched to the AOA accessory mode (keeping adb), and the
+ * streams are multiplexed over its bulk endpoints in frames:
+ *
+ *     [stream index (1 byte)][payload length (3 bytes, big-endian)][payload]
+ *
+ * Each stream is exposed as one end of a local socket pair, so that the
+ * demuxers, the controller and the receiver read and write it unchanged.
+ */
+struct sc_usb_transport {
+    struct sc_usb usb;
+    int interface;
+    uint8_t endpoint_in;
+    uint8_t endpoint_out;
+
+    unsigned stream_count;
+    // The local ends of the socket pairs (the other ends are returned by
+    // sc_usb_transport_start())
+    sc_socket sockets[SC_USB_TRANSPORT_MAX_STREAMS];
+    // The only stream sent to the device, or -1
+    int control_index;
+
+    sc_thread in_thread;
+    sc_thread out_thread;
+    bool has_out_thread;
+    atomic_bool stopped;
+
+    // For the throughput logged on destroy
+    sc_tick start_time;
+    atomic_uint_least64_t bytes_in;
+    atomic_uint_least64_t bytes_out;
+};
+
+// Find the USB device by serial, and switch it to accessory mode if necessary
+bool
+sc_usb_transport_init(struct sc_usb_transport *transport, const char *serial);
+
+// Create the socket pairs and start forwarding; on success, out_sockets
+// contains the stream_count sockets to read and write the streams
+bool
+sc_usb_transport_start(struct sc_usb_transport *transport,
+                       unsigned stream_count, int control_index,
+                       sc_socket out_sockets[]);
+
+void
+sc_usb_transport_stop(struct sc_usb_transport *transport);
+
+void
+sc_usb_transport_join(struct sc_usb_transport *transport);
+
+void
+sc_usb_transport_destroy(struct sc_usb_transport *transport);
+
+#endif
@@ -0,0 +1,88 @@
+#include "arena.h"
+
+#include <assert.h>
+#include <stdalign.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "util/log.h"
+
+#define SC_ARENA_ALIGN alignof(max_align_t)
+
+void
+sc_arena_init(struct sc_arena *arena, size_t chunk_size) {
+    assert(chunk_size);
+    arena->chunks = NULL;
+    arena->chunk_size = chunk_size;
+}
+
+static void
+sc_arena_free_chunks(struct sc_arena_chunk *chunk) {
+    while (chunk) {
+        struct sc_arena_chunk *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+}
+
+void
+sc_arena_destroy(struct sc_arena *arena) {
+    sc_arena_free_chunks(arena->chunks);
+}
+
+void *
+sc_arena_alloc(struct sc_arena *arena, size_t size) {
+    if (size > SIZE_MAX - SC_ARENA_ALIGN) {
+        LOG_OOM();
+        return NULL;
+    }
+    // Keep the next allocation aligned
+    size = (size + SC_ARENA_ALIGN - 1) & ~(SC_ARENA_ALIGN - 1);
+
+    struct sc_arena_chunk *chunk = arena->chunks;
+    if (!chunk || chunk->size - chunk->used < size) {
+        size_t chunk_size = MAX(arena->chunk_size, size);
+        if (chunk_size > SIZE_MAX - sizeof(*chunk)) {
+            LOG_OOM();
+            return NULL;
+        }
+
+        chunk = malloc(sizeof(*chunk) + chunk_size);
+        if (!chunk) {
+            LOG_OOM();
+            return NULL;
+        }
+
+        chunk->next = arena->chunks;
+        chunk->size = chunk_size;
+        chunk->used = 0;
+        arena->chunks = chunk;
+    }
+
+    void *ptr = (uint8_t *) chunk->data + chunk->used;
+    chunk->used += size;
+    return ptr;
+}
+
+void
+sc_arena_reset(struct sc_arena *arena) {
+    struct sc_arena_chunk *chunk = arena->chunks;
+    if (!chunk) {
+        return;
+    }
+
+    if (chunk->next) {
+        // The working set did not fit in a single chunk: replace all the
+        // chunks by a single one large enough for all of them
+        size_t total = 0;
+        for (struct sc_arena_chunk *c = chunk; c; c = c->next) {
+            total += c->size;
+        }
+        sc_arena_free_chunks(chunk);
+        arena->chunks = NULL;
+        arena->chunk_size = MAX(arena->chunk_size, total);
+        return;
+    }
+
+    chunk->used = 0;
+}
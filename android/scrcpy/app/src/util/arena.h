@@ -0,0 +1,58 @@
+#ifndef SC_ARENA_H
+#define SC_ARENA_H
+
+#include "common.h"
+
+#include <stddef.h>
+
+/**
+ * Bump allocator for short-lived buffers
+ *
+ * The allocations are never freed individually: they are all released at
+ * once by sc_arena_reset(), typically once a message has been processed.
+ *
+ * The memory is kept across resets, so that once the arena has grown to fit
+ * the largest working set, no allocation reaches malloc() anymore.
+ *
+ * An arena is not thread-safe: each thread uses its own scratch arena.
+ */
+
+struct sc_arena_chunk {
+    struct sc_arena_chunk *next;
+    size_t size; // capacity of data, in bytes
+    size_t used;
+    max_align_t data[];
+};
+
+struct sc_arena {
+    struct sc_arena_chunk *chunks; // the current chunk first
+    size_t chunk_size;
+};
+
+/**
+ * Initialize an arena (nothing is allocated until the first allocation)
+ */
+void
+sc_arena_init(struct sc_arena *arena, size_t chunk_size);
+
+void
+sc_arena_destroy(struct sc_arena *arena);
+
+/**
+ * Allocate `size` bytes, suitably aligned for any type
+ *
+ * The memory is valid until the next sc_arena_reset().
+ */
+void *
+sc_arena_alloc(struct sc_arena *arena, size_t size);
+
+/**
+ * Release all the allocations at once
+ *
+ * If several chunks were needed, they are replaced by a single larger one on
+ * the next allocation.
+ */
+void
+sc_arena_reset(struct sc_arena *arena);
+
+#endif
@@ -5,15 +5,28 @@
 #include <util/log.h>
 #include <util/memory.h>
 
+static uint32_t
+sc_audiobuf_next_power_of_2(uint32_t value) {
+    assert(value && value <= UINT32_C(1) << 31);
+
+    uint32_t pow2 = 1;
+    while (pow2 < value) {
+        pow2 <<= 1;
+    }
+    return pow2;
+}
+
 bool
 sc_audiobuf_init(struct sc_audiobuf *buf, size_t sample_size,
                  uint32_t capacity) {
     assert(sample_size);
     assert(capacity);
 
-    // The actual capacity is (alloc_size - 1) so that head == tail is
-    // non-ambiguous
-    buf->alloc_size = capacity + 1;
+    // The cursors are not wrapped, so the allocation size must divide 2^32
+    // for (head - tail) to remain correct on overflow
+    buf->alloc_size = sc_audiobuf_next_power_of_2(capacity);
+    buf->mask = buf->alloc_size - 1;
+    buf->capacity = capacity;
     buf->data = sc_allocarray(buf->alloc_size, sample_size);
     if (!buf->data) {
         LOG_OOM();
@@ -32,12 +45,23 @@ sc_audiobuf_destroy(struct sc_audiobuf *buf) {
     free(buf->data);
 }
 
-uint32_t
-sc_audiobuf_read(struct sc_audiobuf *buf, void *to_, uint32_t samples_count) {
-    assert(samples_count);
-
-    uint8_t *to = to_;
+static void
+sc_audiobuf_fill_spans(struct sc_audiobuf *buf,
+                       struct sc_audiobuf_spans *spans, uint32_t cursor,
+                       uint32_t count) {
+    uint32_t index = cursor & buf->mask;
+    uint32_t right_count = MIN(buf->alloc_size - index, count);
+
+    spans->data[0] = buf->data + (index * buf->sample_size);
+    spans->count[0] = right_count;
+    spans->data[1] = buf->data;
+    spans->count[1] = count - right_count;
+}
 
+uint32_t
+sc_audiobuf_get_read_spans(struct sc_audiobuf *buf,
+                           struct sc_audiobuf_spans *spans,
+                           uint32_t max_samples) {
     // Only the reader thread can write tail without synchronization, so
     // memory_order_relaxed is sufficient
     uint32_t tail = atomic_load_explicit(&buf->tail, memory_order_relaxed);
@@ -45,33 +69,64 @@ sc_audiobuf_read(struct sc_audiobuf *buf, void *to_, uint32_t samples_count) {
     // The head cursor is updated after the data is written to the array
     uint32_t head = atomic_load_explicit(&buf->head, memory_order_acquire);
 
-    uint32_t can_read = (buf->alloc_size + head - tail) % buf->alloc_size;
-    if (!can_read) {
+    uint32_t count = MIN(head - tail, max_samples);
+    sc_audiobuf_fill_spans(buf, spans, tail, count);
+    return count;
+}
+
+void
+sc_audiobuf_advance_read(struct sc_audiobuf *buf, uint32_t samples) {
+    uint32_t tail = atomic_load_explicit(&buf->tail, memory_order_relaxed);
+    assert(samples <= atomic_load_explicit(&buf->head, memory_order_relaxed)
+                      - tail);
+    atomic_store_explicit(&buf->tail, tail + samples, memory_order_release);
+}
+
+uint32_t
+sc_audiobuf_get_write_spans(struct sc_audiobuf *buf,
+                            struct sc_audiobuf_spans *spans,
+                            uint32_t max_samples) {
+    // Only the writer thread can write head, so memory_order_relaxed is
+    // sufficient
+    uint32_t head = atomic_load_explicit(&buf->head, memory_order_relaxed);
+
+    // The tail cursor is updated after the data is consumed by the reader
+    uint32_t tail = atomic_load_explicit(&buf->tail, memory_order_acquire);
+
+    uint32_t count = MIN(buf->capacity - (head - tail), max_samples);
+    sc_audiobuf_fill_spans(buf, spans, head, count);
+    return count;
+}
+
+void
+sc_audiobuf_advance_write(struct sc_audiobuf *buf, uint32_t samples) {
+    uint32_t head = atomic_load_explicit(&buf->head, memory_order_relaxed);
+    assert(samples <= buf->capacity
+                    - (head - atomic_load_explicit(&buf->tail,
+                                                   memory_order_relaxed)));
+    atomic_store_explicit(&buf->head, head + samples, memory_order_release);
+}
+
+uint32_t
+sc_audiobuf_read(struct sc_audiobuf *buf, void *to_, uint32_t samples_count) {
+    assert(samples_count);
+
+    uint8_t *to = to_;
+
+    struct sc_audiobuf_spans spans;
+    samples_count = sc_audiobuf_get_read_spans(buf, &spans, samples_count);
+    if (!samples_count) {
         return 0;
     }
-    if (samples_count > can_read) {
-        samples_count = can_read;
-    }
 
     if (to) {
-        uint32_t right_count = buf->alloc_size - tail;
-        if (right_count > samples_count) {
-            right_count = samples_count;
-        }
-        memcpy(to,
-               buf->data + (tail * buf->sample_size),
-               right_count * buf->sample_size);
-
-        if (samples_count > right_count) {
-            uint32_t left_count = samples_count - right_count;
-            memcpy(to + (right_count * buf->sample_size),
-                   buf->data,
-                   left_count * buf->sample_size);
-        }
+        size_t right_bytes = spans.count[0] * buf->sample_size;
+        memcpy(to, spans.data[0], right_bytes);
+        memcpy(to + right_bytes, spans.data[1],
+               spans.count[1] * buf->sample_size);
     }
 
-    uint32_t new_tail = (tail + samples_count) % buf->alloc_size;
-    atomic_store_explicit(&buf->tail, new_tail, memory_order_release);
+    sc_audiobuf_advance_read(buf, samples_count);
 
     return samples_count;
 }
@@ -81,73 +136,34 @@ sc_audiobuf_write(struct sc_audiobuf *buf, const void *from_,
                   uint32_t samples_count) {
     const uint8_t *from = from_;
 
-    // Only the writer thread can write head, so memory_order_relaxed is
-    // sufficient
-    uint32_t head = atomic_load_explicit(&buf->head, memory_order_relaxed);
-
-    // The tail cursor is updated after the data is consumed by the reader
-    uint32_t tail = atomic_load_explicit(&buf->tail, memory_order_acquire);
-
-    uint32_t can_write = (buf->alloc_size + tail - head - 1) % buf->alloc_size;
-    if (!can_write) {
+    struct sc_audiobuf_spans spans;
+    samples_count = sc_audiobuf_get_write_spans(buf, &spans, samples_count);
+    if (!samples_count) {
         return 0;
     }
-    if (samples_count > can_write) {
-        samples_count = can_write;
-    }
 
-    uint32_t right_count = buf->alloc_size - head;
-    if (right_count > samples_count) {
-        right_count = samples_count;
-    }
-    memcpy(buf->data + (head * buf->sample_size),
-           from,
-           right_count * buf->sample_size);
-
-    if (samples_count > right_count) {
-        uint32_t left_count = samples_count - right_count;
-        memcpy(buf->data,
-               from + (right_count * buf->sample_size),
-               left_count * buf->sample_size);
-    }
+    size_t right_bytes = spans.count[0] * buf->sample_size;
+    memcpy(spans.data[0], from, right_bytes);
+    memcpy(spans.data[1], from + right_bytes,
+           spans.count[1] * buf->sample_size);
 
-    uint32_t new_head = (head + samples_count) % buf->alloc_size;
-    atomic_store_explicit(&buf->head, new_head, memory_order_release);
+    sc_audiobuf_advance_write(buf, samples_count);
 
     return samples_count;
 }
 
 uint32_t
 sc_audiobuf_write_silence(struct sc_audiobuf *buf, uint32_t samples_count) {
-    // Only the writer thread can write head, so memory_order_relaxed is
-    // sufficient
-    uint32_t head = atomic_load_explicit(&buf->head, memory_order_relaxed);
-
-    // The tail cursor is updated after the data is consumed by the reader
-    uint32_t tail = atomic_load_explicit(&buf->tail, memory_order_acquire);
-
-    uint32_t can_write = (buf->alloc_size + tail - head - 1) % buf->alloc_size;
-    if (!can_write) {
+    struct sc_audiobuf_spans spans;
+    samples_count = sc_audiobuf_get_write_spans(buf, &spans, samples_count);
+    if (!samples_count) {
         return 0;
     }
-    if (samples_count > can_write) {
-        samples_count = can_write;
-    }
 
-    uint32_t right_count = buf->alloc_size - head;
-    if (right_count > samples_count) {
-        right_count = samples_count;
-    }
-    memset(buf->data + (head * buf->sample_size), 0,
-           right_count * buf->sample_size);
-
-    if (samples_count > right_count) {
-        uint32_t left_count = samples_count - right_count;
-        memset(buf->data, 0, left_count * buf->sample_size);
-    }
+    memset(spans.data[0], 0, spans.count[0] * buf->sample_size);
+    memset(spans.data[1], 0, spans.count[1] * buf->sample_size);
 
-    uint32_t new_head = (head + samples_count) % buf->alloc_size;
-    atomic_store_explicit(&buf->head, new_head, memory_order_release);
+    sc_audiobuf_advance_write(buf, samples_count);
 
     return samples_count;
 }
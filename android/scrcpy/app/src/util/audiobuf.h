@@ -9,20 +9,44 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#define SC_AUDIOBUF_CACHE_LINE_SIZE 64
+
 /**
- * Wrapper around bytebuf to read and write samples
+ * Single-producer/single-consumer lock-free ring buffer of samples
  *
  * Each sample takes sample_size bytes.
+ *
+ * The allocation size is a power of 2, so that the cursors can wrap around
+ * freely and be indexed by a mask.
  */
 struct sc_audiobuf {
     uint8_t *data;
-    uint32_t alloc_size; // in samples
+    uint32_t alloc_size; // in samples, a power of 2
+    uint32_t mask; // alloc_size - 1
+    uint32_t capacity; // in samples, at most alloc_size
     size_t sample_size;
 
+    // The cursors are not wrapped (they must be masked to get an index), and
+    // they are on separate cache lines to avoid false sharing between the
+    // producer and the consumer.
+    uint8_t pad0_[SC_AUDIOBUF_CACHE_LINE_SIZE];
     atomic_uint_least32_t head; // writer cursor, in samples
+    uint8_t pad1_[SC_AUDIOBUF_CACHE_LINE_SIZE - sizeof(atomic_uint_least32_t)];
     atomic_uint_least32_t tail; // reader cursor, in samples
+    uint8_t pad2_[SC_AUDIOBUF_CACHE_LINE_SIZE - sizeof(atomic_uint_least32_t)];
     // empty: tail == head
-    // full: ((tail + 1) % alloc_size) == head
+    // full: head - tail == capacity
+};
+
+/**
+ * Up to two contiguous regions of the ring buffer
+ *
+ * The second region is used only if the first one reaches the end of the
+ * array.
+ */
+struct sc_audiobuf_spans {
+    uint8_t *data[2];
+    uint32_t count[2]; // in samples
 };
 
 static inline uint32_t
@@ -43,6 +67,44 @@ sc_audiobuf_init(struct sc_audiobuf *buf, size_t sample_size,
 void
 sc_audiobuf_destroy(struct sc_audiobuf *buf);
 
+/**
+ * Expose the readable samples (at most max_samples) without copying them
+ *
+ * Must only be called by the reader; the samples are consumed by
+ * sc_audiobuf_advance_read().
+ *
+ * \return the number of samples exposed (the sum of the spans counts)
+ */
+uint32_t
+sc_audiobuf_get_read_spans(struct sc_audiobuf *buf,
+                           struct sc_audiobuf_spans *spans,
+                           uint32_t max_samples);
+
+/**
+ * Consume samples previously exposed by sc_audiobuf_get_read_spans()
+ */
+void
+sc_audiobuf_advance_read(struct sc_audiobuf *buf, uint32_t samples);
+
+/**
+ * Expose the writable space (at most max_samples) to be filled in place
+ *
+ * Must only be called by the writer; the samples are published by
+ * sc_audiobuf_advance_write().
+ *
+ * \return the number of samples exposed (the sum of the spans counts)
+ */
+uint32_t
+sc_audiobuf_get_write_spans(struct sc_audiobuf *buf,
+                            struct sc_audiobuf_spans *spans,
+                            uint32_t max_samples);
+
+/**
+ * Publish samples written to the spans of sc_audiobuf_get_write_spans()
+ */
+void
+sc_audiobuf_advance_write(struct sc_audiobuf *buf, uint32_t samples);
+
 uint32_t
 sc_audiobuf_read(struct sc_audiobuf *buf, void *to, uint32_t samples_count);
 
@@ -55,15 +117,20 @@ sc_audiobuf_write_silence(struct sc_audiobuf *buf, uint32_t samples);
 
 static inline uint32_t
 sc_audiobuf_capacity(struct sc_audiobuf *buf) {
-    assert(buf->alloc_size);
-    return buf->alloc_size - 1;
+    assert(buf->capacity);
+    return buf->capacity;
 }
 
 static inline uint32_t
 sc_audiobuf_can_read(struct sc_audiobuf *buf) {
     uint32_t head = atomic_load_explicit(&buf->head, memory_order_acquire);
     uint32_t tail = atomic_load_explicit(&buf->tail, memory_order_acquire);
-    return (buf->alloc_size + head - tail) % buf->alloc_size;
+    return head - tail;
+}
+
+static inline uint32_t
+sc_audiobuf_can_write(struct sc_audiobuf *buf) {
+    return buf->capacity - sc_audiobuf_can_read(buf);
 }
 
 #endif
@@ -4,6 +4,7 @@
 #include "common.h"
 
 #include <stdbool.h>
+#include <stdio.h>
 
 #ifdef _WIN32
 # define SC_PATH_SEPARATOR '\\'
@@ -46,4 +47,16 @@ sc_file_get_local_path(const char *name);
 bool
 sc_file_is_regular(const char *path);
 
+/**
+ * Delete a file
+ */
+bool
+sc_file_remove(const char *path);
+
+/**
+ * Open a file like fopen(), with an UTF-8 path on all platforms
+ */
+FILE *
+sc_file_open(const char *path, const char *mode);
+
 #endif
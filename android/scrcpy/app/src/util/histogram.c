@@ -0,0 +1,161 @@
+#include "histogram.h"
+
+#include <assert.h>
+
+#define SC_HISTOGRAM_MAX_VALUE ((UINT64_C(1) << SC_HISTOGRAM_MAX_BITS) - 1)
+
+static unsigned
+sc_histogram_log2(uint64_t value) {
+    assert(value);
+    unsigned r = 0;
+    while (value >>= 1) {
+        ++r;
+    }
+    return r;
+}
+
+static unsigned
+sc_histogram_bucket_index(uint64_t value) {
+    if (value < SC_HISTOGRAM_SUB_COUNT) {
+        return value;
+    }
+
+    unsigned e = sc_histogram_log2(value);
+    assert(e >= SC_HISTOGRAM_SUB_BITS);
+    unsigned octave = e - SC_HISTOGRAM_SUB_BITS + 1;
+    unsigned sub = (value >> (e - SC_HISTOGRAM_SUB_BITS))
+                 - SC_HISTOGRAM_SUB_COUNT;
+    return octave * SC_HISTOGRAM_SUB_COUNT + sub;
+}
+
+static uint64_t
+sc_histogram_bucket_lower_bound(unsigned index) {
+    if (index < SC_HISTOGRAM_SUB_COUNT) {
+        return index;
+    }
+
+    unsigned octave = index / SC_HISTOGRAM_SUB_COUNT;
+    unsigned sub = index % SC_HISTOGRAM_SUB_COUNT;
+    return (uint64_t) (SC_HISTOGRAM_SUB_COUNT + sub) << (octave - 1);
+}
+
+static uint64_t
+sc_histogram_bucket_upper_bound(unsigned index) {
+    if (index < SC_HISTOGRAM_SUB_COUNT) {
+        return index;
+    }
+
+    unsigned octave = index / SC_HISTOGRAM_SUB_COUNT;
+    return sc_histogram_bucket_lower_bound(index)
+         + (UINT64_C(1) << (octave - 1)) - 1;
+}
+
+void
+sc_histogram_init(struct sc_histogram *hist) {
+    for (unsigned i = 0; i < SC_HISTOGRAM_BUCKET_COUNT; ++i) {
+        atomic_init(&hist->buckets[i], 0);
+    }
+    atomic_init(&hist->count, 0);
+    atomic_init(&hist->sum, 0);
+    atomic_init(&hist->max, 0);
+}
+
+void
+sc_histogram_record(struct sc_histogram *hist, int64_t value) {
+    uint64_t v = value > 0 ? (uint64_t) value : 0;
+    if (v > SC_HISTOGRAM_MAX_VALUE) {
+        v = SC_HISTOGRAM_MAX_VALUE;
+    }
+
+    unsigned index = sc_histogram_bucket_index(v);
+    assert(index < SC_HISTOGRAM_BUCKET_COUNT);
+
+    atomic_fetch_add_explicit(&hist->buckets[index], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&hist->count, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&hist->sum, v, memory_order_relaxed);
+
+    uint64_t max = atomic_load_explicit(&hist->max, memory_order_relaxed);
+    while (v > max && !atomic_compare_exchange_weak_explicit(&hist->max, &max,
+                                                   v, memory_order_relaxed,
+                                                   memory_order_relaxed)) {
+        // max has been reloaded, retry
+    }
+}
+
+static uint64_t
+sc_histogram_find_percentile(const uint32_t *buckets, uint64_t total,
+                             unsigned percentile, uint64_t max) {
+    assert(total);
+    assert(percentile <= 100);
+
+    // rank = ceil(total * percentile / 100), at least 1
+    uint64_t rank = (total * percentile + 99) / 100;
+    if (!rank) {
+        rank = 1;
+    }
+
+    uint64_t cumulated = 0;
+    for (unsigned i = 0; i < SC_HISTOGRAM_BUCKET_COUNT; ++i) {
+        cumulated += buckets[i];
+        if (cumulated >= rank) {
+            uint64_t upper = sc_histogram_bucket_upper_bound(i);
+            return MIN(upper, max);
+        }
+    }
+
+    return max;
+}
+
+static uint64_t
+sc_histogram_snapshot(struct sc_histogram *hist, uint32_t *buckets) {
+    uint64_t total = 0;
+    for (unsigned i = 0; i < SC_HISTOGRAM_BUCKET_COUNT; ++i) {
+        buckets[i] = atomic_load_explicit(&hist->buckets[i],
+                                          memory_order_relaxed);
+        total += buckets[i];
+    }
+    return total;
+}
+
+uint64_t
+sc_histogram_get_percentile(struct sc_histogram *hist, unsigned percentile) {
+    uint32_t buckets[SC_HISTOGRAM_BUCKET_COUNT];
+    uint64_t total = sc_histogram_snapshot(hist, buckets);
+    if (!total) {
+        return 0;
+    }
+
+    uint64_t max = atomic_load_explicit(&hist->max, memory_order_relaxed);
+    return sc_histogram_find_percentile(buckets, total, percentile, max);
+}
+
+void
+sc_histogram_get_stats(struct sc_histogram *hist,
+                       struct sc_histogram_stats *stats) {
+    uint32_t buckets[SC_HISTOGRAM_BUCKET_COUNT];
+    uint64_t total = sc_histogram_snapshot(hist, buckets);
+    if (!total) {
+        *stats = (struct sc_histogram_stats) {0};
+        return;
+    }
+
+    uint64_t max = atomic_load_explicit(&hist->max, memory_order_relaxed);
+    uint64_t count = atomic_load_explicit(&hist->count, memory_order_relaxed);
+    uint64_t sum = atomic_load_explicit(&hist->sum, memory_order_relaxed);
+
+    uint64_t min = 0;
+    for (unsigned i = 0; i < SC_HISTOGRAM_BUCKET_COUNT; ++i) {
+        if (buckets[i]) {
+            min = sc_histogram_bucket_lower_bound(i);
+            break;
+        }
+    }
+
+    stats->count = total;
+    stats->min = min;
+    stats->max = max;
+    stats->mean = count ? sum / count : 0;
+    stats->p50 = sc_histogram_find_percentile(buckets, total, 50, max);
+    stats->p90 = sc_histogram_find_percentile(buckets, total, 90, max);
+    stats->p99 = sc_histogram_find_percentile(buckets, total, 99, max);
+}
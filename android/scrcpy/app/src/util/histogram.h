@@ -0,0 +1,72 @@
+#ifndef SC_HISTOGRAM_H
+#define SC_HISTOGRAM_H
+
+#include "common.h"
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+/**
+ * Lock-free histogram of non-negative values (typically durations in
+ * microseconds), with a bounded relative error (HDR-style)
+ *
+ * Values lower than 2^SC_HISTOGRAM_SUB_BITS are recorded exactly. Above, each
+ * power-of-two range is split into 2^SC_HISTOGRAM_SUB_BITS linear buckets, so
+ * the relative error is less than 1/2^SC_HISTOGRAM_SUB_BITS (6.25%).
+ *
+ * Values are recorded from any thread without locking. Reading while values
+ * are recorded is allowed, but the result may be slightly inconsistent (e.g.
+ * the count may not match the sum of the buckets exactly).
+ */
+
+#define SC_HISTOGRAM_SUB_BITS 4
+#define SC_HISTOGRAM_SUB_COUNT (1 << SC_HISTOGRAM_SUB_BITS)
+// Values larger than 2^SC_HISTOGRAM_MAX_BITS - 1 are clamped (~67s in us)
+#define SC_HISTOGRAM_MAX_BITS 26
+#define SC_HISTOGRAM_BUCKET_COUNT \
+    ((SC_HISTOGRAM_MAX_BITS - SC_HISTOGRAM_SUB_BITS + 1) \
+        * SC_HISTOGRAM_SUB_COUNT)
+
+struct sc_histogram {
+    atomic_uint_least32_t buckets[SC_HISTOGRAM_BUCKET_COUNT];
+    atomic_uint_least64_t count;
+    atomic_uint_least64_t sum;
+    atomic_uint_least64_t max;
+};
+
+struct sc_histogram_stats {
+    uint64_t count;
+    uint64_t min;
+    uint64_t max;
+    uint64_t mean;
+    uint64_t p50;
+    uint64_t p90;
+    uint64_t p99;
+};
+
+void
+sc_histogram_init(struct sc_histogram *hist);
+
+/**
+ * Record a value (negative values are recorded as 0)
+ */
+void
+sc_histogram_record(struct sc_histogram *hist, int64_t value);
+
+/**
+ * Return the value at the given percentile (between 0 and 100)
+ *
+ * The result is the upper bound of the bucket containing the value, so it
+ * never underestimates. Return 0 if the histogram is empty.
+ */
+uint64_t
+sc_histogram_get_percentile(struct sc_histogram *hist, unsigned percentile);
+
+/**
+ * Compute a summary of the recorded values
+ */
+void
+sc_histogram_get_stats(struct sc_histogram *hist,
+                       struct sc_histogram_stats *stats);
+
+#endif
@@ -69,6 +69,15 @@ sc_intr_is_interrupted(struct sc_intr *intr) {
     return atomic_load_explicit(&intr->interrupted, memory_order_relaxed);
 }
 
+/**
+ * Clear the interrupted state, so that the interruptor can be reused
+ *
+ * Must be called from the thread using the interruptor, while no component
+ * is set.
+ */
+void
+sc_intr_reset(struct sc_intr *intr);
+
 /**
  * Destroy the interruptor
  */
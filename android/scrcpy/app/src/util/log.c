@@ -137,16 +137,20 @@ static const char *const sc_sdl_log_priority_names[SDL_NUM_LOG_PRIORITIES] = {
     [SDL_LOG_PRIORITY_CRITICAL] = "CRITICAL",
 };
 
+void
+sc_log_print(SDL_LogPriority priority, const char *message) {
+    FILE *out = priority < SDL_LOG_PRIORITY_WARN ? stdout : stderr;
+    assert(priority < SDL_NUM_LOG_PRIORITIES);
+    const char *prio_name = sc_sdl_log_priority_names[priority];
+    fprintf(out, "%s: %s\n", prio_name, message);
+}
+
 static void SDLCALL
 sc_sdl_log_print(void *userdata, int category, SDL_LogPriority priority,
                  const char *message) {
     (void) userdata;
     (void) category;
-
-    FILE *out = priority < SDL_LOG_PRIORITY_WARN ? stdout : stderr;
-    assert(priority < SDL_NUM_LOG_PRIORITIES);
-    const char *prio_name = sc_sdl_log_priority_names[priority];
-    fprintf(out, "%s: %s\n", prio_name, message);
+    sc_log_print(priority, message);
 }
 
 void
@@ -35,6 +35,12 @@ bool
 sc_log_windows_error(const char *prefix, int error);
 #endif
 
+/**
+ * Write a formatted log message to the console, synchronously
+ */
+void
+sc_log_print(SDL_LogPriority priority, const char *message);
+
 void
 sc_log_configure(void);
 
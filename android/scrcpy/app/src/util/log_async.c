@@ -0,0 +1,151 @@
+#include "log_async.h"
+
+#include <assert.h>
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <SDL2/SDL_log.h>
+
+#include "util/log.h"
+#include "util/logbuf.h"
+#include "util/thread.h"
+#include "util/tick.h"
+
+#define SC_LOG_ASYNC_CAPACITY 1024
+// The producers never wake up the flusher (this would require a lock), so it
+// polls the queue at this interval
+#define SC_LOG_ASYNC_FLUSH_INTERVAL SC_TICK_FROM_MS(10)
+
+static struct {
+    struct sc_logbuf buf;
+    sc_thread thread;
+    sc_mutex mutex;
+    sc_cond cond;
+    bool stopped;
+    atomic_uint_least32_t dropped;
+} sc_log_async;
+
+static void
+sc_log_async_flush(void) {
+    const char *text;
+    int priority;
+    while ((text = sc_logbuf_peek(&sc_log_async.buf, &priority))) {
+        sc_log_print(priority, text);
+        sc_logbuf_consume(&sc_log_async.buf);
+    }
+
+    uint32_t dropped = atomic_exchange_explicit(&sc_log_async.dropped, 0,
+                                                memory_order_relaxed);
+    if (dropped) {
+        // Do not use LOGW(), which would push to the queue
+        char message[64];
+        snprintf(message, sizeof(message), "%" PRIu32 " log message(s) "
+                 "dropped (queue full)", dropped);
+        sc_log_print(SDL_LOG_PRIORITY_WARN, message);
+    }
+}
+
+static int
+run_log_flusher(void *data) {
+    (void) data;
+
+    for (;;) {
+        sc_log_async_flush();
+
+        sc_mutex_lock(&sc_log_async.mutex);
+        bool stopped = sc_log_async.stopped;
+        if (!stopped) {
+            sc_tick deadline = sc_tick_now() + SC_LOG_ASYNC_FLUSH_INTERVAL;
+            sc_cond_timedwait(&sc_log_async.cond, &sc_log_async.mutex,
+                              deadline);
+        }
+        sc_mutex_unlock(&sc_log_async.mutex);
+
+        if (stopped) {
+            break;
+        }
+    }
+
+    return 0;
+}
+
+static void SDLCALL
+sc_log_async_output(void *userdata, int category, SDL_LogPriority priority,
+                    const char *message) {
+    (void) userdata;
+    (void) category;
+
+    if (sc_logbuf_push(&sc_log_async.buf, priority, message)) {
+        return;
+    }
+
+    if (priority >= SDL_LOG_PRIORITY_WARN) {
+        // Never lose an error
+        sc_log_print(priority, message);
+    } else {
+        atomic_fetch_add_explicit(&sc_log_async.dropped, 1,
+                                  memory_order_relaxed);
+    }
+}
+
+bool
+sc_log_async_start(void) {
+    if (!sc_logbuf_init(&sc_log_async.buf, SC_LOG_ASYNC_CAPACITY)) {
+        LOG_OOM();
+        return false;
+    }
+
+    bool ok = sc_mutex_init(&sc_log_async.mutex);
+    if (!ok) {
+        goto error_destroy_buf;
+    }
+
+    ok = sc_cond_init(&sc_log_async.cond);
+    if (!ok) {
+        goto error_destroy_mutex;
+    }
+
+    sc_log_async.stopped = false;
+    atomic_init(&sc_log_async.dropped, 0);
+
+    ok = sc_thread_create(&sc_log_async.thread, run_log_flusher, "scrcpy-log",
+                          NULL);
+    if (!ok) {
+        LOGE("Could not start log flusher thread");
+        goto error_destroy_cond;
+    }
+
+    SDL_LogSetOutputFunction(sc_log_async_output, NULL);
+
+    LOGD("Asynchronous logging enabled");
+    return true;
+
+error_destroy_cond:
+    sc_cond_destroy(&sc_log_async.cond);
+error_destroy_mutex:
+    sc_mutex_destroy(&sc_log_async.mutex);
+error_destroy_buf:
+    sc_logbuf_destroy(&sc_log_async.buf);
+
+    return false;
+}
+
+void
+sc_log_async_stop(void) {
+    // Log synchronously from now on
+    sc_log_configure();
+
+    sc_mutex_lock(&sc_log_async.mutex);
+    sc_log_async.stopped = true;
+    sc_cond_signal(&sc_log_async.cond);
+    sc_mutex_unlock(&sc_log_async.mutex);
+
+    sc_thread_join(&sc_log_async.thread, NULL);
+
+    // Flush the messages pushed after the last iteration of the flusher
+    sc_log_async_flush();
+
+    sc_cond_destroy(&sc_log_async.cond);
+    sc_mutex_destroy(&sc_log_async.mutex);
+    sc_logbuf_destroy(&sc_log_async.buf);
+}
@@ -0,0 +1,32 @@
+#ifndef SC_LOG_ASYNC_H
+#define SC_LOG_ASYNC_H
+
+#include "common.h"
+
+#include <stdbool.h>
+
+/**
+ * Write the log messages to the console from a separate thread
+ *
+ * Once started, the logging threads only format their messages (as before)
+ * and copy them into a lock-free queue, which is flushed to the console by a
+ * background thread. Writing to the console (especially on Windows, where the
+ * output is not buffered) never blocks the calling threads anymore.
+ *
+ * If the queue is full, errors and warnings are written synchronously (so
+ * they may be reordered), and the other messages are dropped and counted.
+ *
+ * Must be called after sc_log_configure().
+ */
+bool
+sc_log_async_start(void);
+
+/**
+ * Flush the pending messages and restore the synchronous logging
+ *
+ * Must be called once the other threads which may log have been joined.
+ */
+void
+sc_log_async_stop(void);
+
+#endif
@@ -0,0 +1,114 @@
+#include "logbuf.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "util/memory.h"
+
+bool
+sc_logbuf_init(struct sc_logbuf *buf, uint32_t capacity) {
+    // The cursors are not wrapped, so the capacity must divide 2^32
+    assert(capacity && !(capacity & (capacity - 1)));
+
+    // Do not log on error: this is used by the logger itself
+    buf->entries = sc_allocarray(capacity, sizeof(*buf->entries));
+    if (!buf->entries) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < capacity; ++i) {
+        // The entry at position i is free for the producer reserving i
+        atomic_init(&buf->entries[i].seq, i);
+        buf->entries[i].heap_text = NULL;
+    }
+
+    buf->mask = capacity - 1;
+    atomic_init(&buf->head, 0);
+    buf->tail = 0;
+
+    return true;
+}
+
+void
+sc_logbuf_destroy(struct sc_logbuf *buf) {
+    for (uint32_t i = 0; i <= buf->mask; ++i) {
+        free(buf->entries[i].heap_text);
+    }
+    free(buf->entries);
+}
+
+bool
+sc_logbuf_push(struct sc_logbuf *buf, int priority, const char *message) {
+    struct sc_logbuf_entry *entry;
+
+    uint32_t pos = atomic_load_explicit(&buf->head, memory_order_relaxed);
+    for (;;) {
+        entry = &buf->entries[pos & buf->mask];
+        uint32_t seq =
+            atomic_load_explicit(&entry->seq, memory_order_acquire);
+        int32_t diff = (int32_t) (seq - pos);
+        if (!diff) {
+            // The entry is free, try to reserve it
+            if (atomic_compare_exchange_weak_explicit(&buf->head, &pos,
+                                                      pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                break;
+            }
+            // pos has been reloaded, retry
+        } else if (diff < 0) {
+            // The entry has not been consumed yet since the last lap
+            return false;
+        } else {
+            // Another producer reserved this position
+            pos = atomic_load_explicit(&buf->head, memory_order_relaxed);
+        }
+    }
+
+    entry->priority = priority;
+
+    size_t len = strlen(message);
+    if (len < SC_LOGBUF_TEXT_SIZE) {
+        memcpy(entry->text, message, len + 1);
+        entry->heap_text = NULL;
+    } else {
+        entry->heap_text = strdup(message);
+        if (!entry->heap_text) {
+            memcpy(entry->text, message, SC_LOGBUF_TEXT_SIZE - 1);
+            entry->text[SC_LOGBUF_TEXT_SIZE - 1] = '\0';
+        }
+    }
+
+    // Publish the entry to the consumer
+    atomic_store_explicit(&entry->seq, pos + 1, memory_order_release);
+    return true;
+}
+
+const char *
+sc_logbuf_peek(struct sc_logbuf *buf, int *priority) {
+    struct sc_logbuf_entry *entry = &buf->entries[buf->tail & buf->mask];
+    uint32_t seq = atomic_load_explicit(&entry->seq, memory_order_acquire);
+    if (seq != buf->tail + 1) {
+        // Not published yet
+        return NULL;
+    }
+
+    *priority = entry->priority;
+    return entry->heap_text ? entry->heap_text : entry->text;
+}
+
+void
+sc_logbuf_consume(struct sc_logbuf *buf) {
+    struct sc_logbuf_entry *entry = &buf->entries[buf->tail & buf->mask];
+    assert(atomic_load_explicit(&entry->seq, memory_order_relaxed)
+            == buf->tail + 1);
+
+    free(entry->heap_text);
+    entry->heap_text = NULL;
+
+    // Release the entry for the producer of the next lap
+    atomic_store_explicit(&entry->seq, buf->tail + buf->mask + 1,
+                          memory_order_release);
+    ++buf->tail;
+}
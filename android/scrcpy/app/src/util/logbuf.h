@@ -0,0 +1,83 @@
+#ifndef SC_LOGBUF_H
+#define SC_LOGBUF_H
+
+#include "common.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Multi-producer/single-consumer lock-free queue of log messages
+ *
+ * The capacity is a power of 2. Each entry has its own sequence number, so
+ * that producers reserve an entry by a single compare-and-swap on the head
+ * cursor, then publish it independently of the other producers (bounded
+ * queue from Dmitry Vyukov).
+ *
+ * Short messages are copied inline; longer ones are duplicated on the heap.
+ */
+
+// So that an entry takes 256 bytes
+#define SC_LOGBUF_TEXT_SIZE 240
+
+struct sc_logbuf_entry {
+    atomic_uint_least32_t seq;
+    int priority;
+    char *heap_text; // NULL if the message is stored inline
+    char text[SC_LOGBUF_TEXT_SIZE];
+};
+
+#define SC_LOGBUF_CACHE_LINE_SIZE 64
+
+struct sc_logbuf {
+    struct sc_logbuf_entry *entries;
+    uint32_t mask; // capacity - 1
+
+    // The cursors are not wrapped, and they are on separate cache lines to
+    // avoid false sharing between the producers and the consumer
+    uint8_t pad0_[SC_LOGBUF_CACHE_LINE_SIZE];
+    atomic_uint_least32_t head; // shared by the producers
+    uint8_t pad1_[SC_LOGBUF_CACHE_LINE_SIZE - sizeof(atomic_uint_least32_t)];
+    uint32_t tail; // only accessed by the consumer
+};
+
+/**
+ * Initialize a log buffer of `capacity` entries (must be a power of 2)
+ */
+bool
+sc_logbuf_init(struct sc_logbuf *buf, uint32_t capacity);
+
+/**
+ * Destroy the log buffer, dropping the messages not consumed
+ */
+void
+sc_logbuf_destroy(struct sc_logbuf *buf);
+
+/**
+ * Copy a message to the buffer (from any thread)
+ *
+ * A message which cannot be duplicated on the heap is truncated.
+ *
+ * \return false if the buffer is full
+ */
+bool
+sc_logbuf_push(struct sc_logbuf *buf, int priority, const char *message);
+
+/**
+ * Expose the oldest message without consuming it
+ *
+ * Must only be called by the consumer.
+ *
+ * \return the message, or NULL if none is available
+ */
+const char *
+sc_logbuf_peek(struct sc_logbuf *buf, int *priority);
+
+/**
+ * Consume the message returned by the last sc_logbuf_peek()
+ */
+void
+sc_logbuf_consume(struct sc_logbuf *buf);
+
+#endif
@@ -0,0 +1,162 @@
+#ifndef SC_MPSC_RING_H
+#define SC_MPSC_RING_H
+
+#include "common.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "util/spsc_ring.h" // for SC_RING_CACHE_LINE_SIZE
+
+/**
+ * A multi-producer single-consumer lock-free ring of fixed capacity.
+ *
+ * It is generic over the type of its items, so it is implemented via macros
+ * (like SC_VECDEQUE):
+ *
+ *     struct ring_int SC_MPSC_RING(int, 64);
+ *
+ * The capacity must be a power of 2. Any number of threads may push
+ * concurrently, and exactly one thread may pop at a time. To block until an
+ * item is available, use sc_ring_waiter (util/ring_waiter.h).
+ *
+ * Each slot has its own sequence number: a producer reserves a slot by a
+ * single compare-and-swap on the head cursor, then publishes it independently
+ * of the other producers (bounded queue from Dmitry Vyukov).
+ *
+ * Functions and macros having name ending with '_' are private.
+ */
+
+/**
+ * MPSC ring struct body
+ */
+#define SC_MPSC_RING(type, capacity) { \
+    struct { \
+        /* pos + 1 once the item at pos is published, pos + capacity once it \
+         * has been consumed */ \
+        atomic_uint_least32_t seq; \
+        type item; \
+    } slots[capacity]; \
+    uint8_t pad0_[SC_RING_CACHE_LINE_SIZE]; \
+    atomic_uint_least32_t head; /* shared by the producers */ \
+    uint8_t pad1_[SC_RING_CACHE_LINE_SIZE - sizeof(atomic_uint_least32_t)]; \
+    atomic_uint_least32_t tail; /* written by the consumer */ \
+    uint8_t pad2_[SC_RING_CACHE_LINE_SIZE - sizeof(atomic_uint_least32_t)]; \
+}
+
+#define sc_mpsc_ring_capacity(pr) \
+    ((uint32_t) ARRAY_LEN((pr)->slots))
+
+#define sc_mpsc_ring_mask_(pr) \
+    (sc_mpsc_ring_capacity(pr) - 1)
+
+/**
+ * Initialize an empty ring
+ */
+#define sc_mpsc_ring_init(pr) \
+(void) ({ \
+    /* The cursors are not wrapped, so the capacity must divide 2^32 */ \
+    _Static_assert(!(ARRAY_LEN((pr)->slots) & (ARRAY_LEN((pr)->slots) - 1)), \
+                   "The ring capacity must be a power of 2"); \
+    for (uint32_t i_ = 0; i_ < sc_mpsc_ring_capacity(pr); ++i_) { \
+        /* The slot at position i_ is free for the producer reserving i_ */ \
+        atomic_init(&(pr)->slots[i_].seq, i_); \
+    } \
+    atomic_init(&(pr)->head, 0); \
+    atomic_init(&(pr)->tail, 0); \
+})
+
+/**
+ * Return the number of items in the ring (reserved or published)
+ *
+ * May be called from any thread (the result may be outdated immediately).
+ */
+#define sc_mpsc_ring_size(pr) \
+({ \
+    /* Read tail first, so that head - tail may not underflow */ \
+    uint32_t tail_ = atomic_load_explicit(&(pr)->tail, memory_order_acquire); \
+    uint32_t head_ = atomic_load_explicit(&(pr)->head, memory_order_acquire); \
+    head_ - tail_; \
+})
+
+/**
+ * Return whether no item is ready to be popped
+ *
+ * Must only be called by the consumer (typically as a wait condition).
+ */
+#define sc_mpsc_ring_is_empty(pr) \
+({ \
+    uint32_t tail_ = atomic_load_explicit(&(pr)->tail, memory_order_relaxed); \
+    atomic_load_explicit(&(pr)->slots[tail_ & sc_mpsc_ring_mask_(pr)].seq, \
+                         memory_order_seq_cst) != tail_ + 1; \
+})
+
+/**
+ * Push a copy of `value` (from any thread)
+ *
+ * \return false if the ring is full
+ */
+#define sc_mpsc_ring_push(pr, value) \
+({ \
+    uint32_t pos_ = atomic_load_explicit(&(pr)->head, memory_order_relaxed); \
+    bool ok_; \
+    for (;;) { \
+        uint32_t seq_ = \
+            atomic_load_explicit(&(pr)->slots[pos_ & sc_mpsc_ring_mask_(pr)] \
+                                    .seq, memory_order_acquire); \
+        int32_t diff_ = (int32_t) (seq_ - pos_); \
+        if (!diff_) { \
+            /* The slot is free, try to reserve it (pos_ is reloaded on \
+             * failure) */ \
+            if (atomic_compare_exchange_weak_explicit(&(pr)->head, &pos_, \
+                                                      pos_ + 1, \
+                                                      memory_order_relaxed, \
+                                                      memory_order_relaxed)) {\
+                ok_ = true; \
+                break; \
+            } \
+        } else if (diff_ < 0) { \
+            /* The slot has not been consumed since the previous lap */ \
+            ok_ = false; \
+            break; \
+        } else { \
+            /* Another producer reserved this position */ \
+            pos_ = atomic_load_explicit(&(pr)->head, memory_order_relaxed); \
+        } \
+    } \
+    if (ok_) { \
+        (pr)->slots[pos_ & sc_mpsc_ring_mask_(pr)].item = (value); \
+        /* Publish the item (seq_cst to pair with sc_ring_waiter) */ \
+        atomic_store_explicit(&(pr)->slots[pos_ & sc_mpsc_ring_mask_(pr)].seq,\
+                              pos_ + 1, memory_order_seq_cst); \
+    } \
+    ok_; \
+})
+
+/**
+ * Pop the oldest published item into `*pitem`
+ *
+ * Must only be called by the consumer.
+ *
+ * \return false if no item is ready
+ */
+#define sc_mpsc_ring_pop(pr, pitem) \
+({ \
+    uint32_t tail_ = atomic_load_explicit(&(pr)->tail, memory_order_relaxed); \
+    uint32_t index_ = tail_ & sc_mpsc_ring_mask_(pr); \
+    uint32_t seq_ = atomic_load_explicit(&(pr)->slots[index_].seq, \
+                                         memory_order_acquire); \
+    bool ok_ = seq_ == tail_ + 1; \
+    if (ok_) { \
+        *(pitem) = (pr)->slots[index_].item; \
+        /* Release the slot for the producer of the next lap */ \
+        atomic_store_explicit(&(pr)->slots[index_].seq, \
+                              tail_ + sc_mpsc_ring_capacity(pr), \
+                              memory_order_release); \
+        atomic_store_explicit(&(pr)->tail, tail_ + 1, memory_order_release); \
+    } \
+    ok_; \
+})
+
+#endif
@@ -0,0 +1,68 @@
+#include "nal.h"
+
+#include <assert.h>
+
+// Return the position of the first byte of the next NAL unit header, or len
+static size_t
+sc_nal_find_next(const uint8_t *data, size_t len, size_t pos) {
+    // Search for the 3-byte start code 00 00 01 (a 4-byte start code is
+    // 00 00 00 01, so it ends with a 3-byte start code)
+    while (pos + 3 <= len) {
+        if (data[pos + 2] > 1) {
+            pos += 3;
+        } else if (!data[pos] && !data[pos + 1] && data[pos + 2] == 1) {
+            return pos + 3;
+        } else {
+            ++pos;
+        }
+    }
+
+    return len;
+}
+
+bool
+sc_nal_h264_is_non_reference(const uint8_t *data, size_t len) {
+    bool has_slice = false;
+
+    size_t pos = sc_nal_find_next(data, len, 0);
+    while (pos < len) {
+        uint8_t header = data[pos];
+        unsigned type = header & 0x1F;
+        unsigned ref_idc = (header >> 5) & 0x3;
+
+        // 1: non-IDR slice, 2-4: slice data partitions, 5: IDR slice
+        if (type >= 1 && type <= 5) {
+            if (ref_idc || type == 5) {
+                return false;
+            }
+            has_slice = true;
+        }
+
+        pos = sc_nal_find_next(data, len, pos + 1);
+    }
+
+    return has_slice;
+}
+
+bool
+sc_nal_h265_is_non_reference(const uint8_t *data, size_t len) {
+    bool has_slice = false;
+
+    size_t pos = sc_nal_find_next(data, len, 0);
+    while (pos < len) {
+        unsigned type = (data[pos] >> 1) & 0x3F;
+
+        // VCL NAL unit types are 0 to 31
+        if (type <= 31) {
+            // The sub-layer non-reference types are the even types up to 14
+            if (type > 14 || type % 2) {
+                return false;
+            }
+            has_slice = true;
+        }
+
+        pos = sc_nal_find_next(data, len, pos + 1);
+    }
+
+    return has_slice;
+}
@@ -0,0 +1,37 @@
+#ifndef SC_NAL_H
+#define SC_NAL_H
+
+#include "common.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Inspect the NAL units of an Annex B access unit (the NAL units are prefixed
+ * by start codes)
+ *
+ * A non-reference picture is not used to predict any other picture, so it can
+ * be dropped before decoding without corrupting the following frames.
+ */
+
+/**
+ * Indicate whether all the slices (VCL NAL units) of an H.264 access unit
+ * have nal_ref_idc == 0
+ *
+ * Return false if the access unit contains no slice.
+ */
+bool
+sc_nal_h264_is_non_reference(const uint8_t *data, size_t len);
+
+/**
+ * Indicate whether all the slices (VCL NAL units) of an H.265 access unit
+ * are sub-layer non-reference pictures (TRAIL_N, TSA_N, STSA_N, RADL_N,
+ * RASL_N and the reserved RSV_VCL_N types)
+ *
+ * Return false if the access unit contains no slice.
+ */
+bool
+sc_nal_h265_is_non_reference(const uint8_t *data, size_t len);
+
+#endif
@@ -3,6 +3,7 @@
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #ifdef _WIN32
 # include <ws2tcpip.h>
@@ -203,6 +204,57 @@ net_accept(sc_socket server_socket) {
     return wrap(raw_sock);
 }
 
+bool
+net_socketpair(sc_socket sockets[2]) {
+    sc_socket server_socket = net_socket();
+    if (server_socket == SC_SOCKET_NONE) {
+        return false;
+    }
+
+    // Let the system choose the port
+    bool ok = net_listen(server_socket, IPV4_LOCALHOST, 0, 1);
+    if (!ok) {
+        goto close_server;
+    }
+
+    SOCKADDR_IN sin;
+    socklen_t sinsize = sizeof(sin);
+    if (getsockname(unwrap(server_socket), (SOCKADDR *) &sin, &sinsize)
+            == SOCKET_ERROR) {
+        net_perror("getsockname");
+        goto close_server;
+    }
+
+    sc_socket client_socket = net_socket();
+    if (client_socket == SC_SOCKET_NONE) {
+        goto close_server;
+    }
+
+    // The connection is completed by the system (within the backlog), so
+    // connecting before accepting does not block
+    ok = net_connect(client_socket, IPV4_LOCALHOST, ntohs(sin.sin_port));
+    if (!ok) {
+        goto close_client;
+    }
+
+    sc_socket accepted_socket = net_accept(server_socket);
+    if (accepted_socket == SC_SOCKET_NONE) {
+        goto close_client;
+    }
+
+    net_close(server_socket);
+
+    sockets[0] = client_socket;
+    sockets[1] = accepted_socket;
+    return true;
+
+close_client:
+    net_close(client_socket);
+close_server:
+    net_close(server_socket);
+    return false;
+}
+
 ssize_t
 net_recv(sc_socket socket, void *buf, size_t len) {
     sc_raw_socket raw_sock = unwrap(socket);
@@ -215,6 +267,109 @@ net_recv_all(sc_socket socket, void *buf, size_t len) {
     return recv(raw_sock, buf, len, MSG_WAITALL);
 }
 
+bool
+sc_net_reader_init(struct sc_net_reader *reader, sc_socket socket,
+                   size_t cap) {
+    assert(cap);
+
+    reader->buf = malloc(cap);
+    if (!reader->buf) {
+        LOG_OOM();
+        return false;
+    }
+
+    reader->socket = socket;
+    reader->cap = cap;
+    reader->head = 0;
+    reader->tail = 0;
+
+    return true;
+}
+
+void
+sc_net_reader_destroy(struct sc_net_reader *reader) {
+    free(reader->buf);
+}
+
+void
+sc_net_reader_reset(struct sc_net_reader *reader, sc_socket socket) {
+    reader->socket = socket;
+    reader->head = 0;
+    reader->tail = 0;
+}
+
+// Receive until at least len bytes are buffered
+static bool
+sc_net_reader_fill(struct sc_net_reader *reader, size_t len) {
+    assert(len <= reader->cap);
+
+    size_t avail = reader->tail - reader->head;
+    if (avail >= len) {
+        return true;
+    }
+
+    if (reader->head + len > reader->cap) {
+        // Not enough room after the unread bytes, move them to the start
+        memmove(reader->buf, &reader->buf[reader->head], avail);
+        reader->head = 0;
+        reader->tail = avail;
+    }
+
+    while (reader->tail - reader->head < len) {
+        // Receive as much as available, to serve the next reads
+        ssize_t r = net_recv(reader->socket, &reader->buf[reader->tail],
+                             reader->cap - reader->tail);
+        if (r <= 0) {
+            return false;
+        }
+        reader->tail += r;
+    }
+
+    return true;
+}
+
+const uint8_t *
+sc_net_reader_next(struct sc_net_reader *reader, size_t len) {
+    if (!sc_net_reader_fill(reader, len)) {
+        return NULL;
+    }
+
+    const uint8_t *data = &reader->buf[reader->head];
+    reader->head += len;
+    return data;
+}
+
+bool
+sc_net_reader_read_all(struct sc_net_reader *reader, void *buf, size_t len) {
+    size_t avail = reader->tail - reader->head;
+    if (avail >= len) {
+        memcpy(buf, &reader->buf[reader->head], len);
+        reader->head += len;
+        return true;
+    }
+
+    // Consume all the buffered bytes
+    memcpy(buf, &reader->buf[reader->head], avail);
+    reader->head = 0;
+    reader->tail = 0;
+    buf = (uint8_t *) buf + avail;
+    len -= avail;
+
+    if (len > reader->cap / 2) {
+        // Large payload: receive it directly, rather than copying it
+        ssize_t r = net_recv_all(reader->socket, buf, len);
+        return r >= 0 && (size_t) r == len;
+    }
+
+    const uint8_t *data = sc_net_reader_next(reader, len);
+    if (!data) {
+        return false;
+    }
+
+    memcpy(buf, data, len);
+    return true;
+}
+
 ssize_t
 net_send(sc_socket socket, const void *buf, size_t len) {
     sc_raw_socket raw_sock = unwrap(socket);
@@ -284,6 +439,53 @@ net_set_tcp_nodelay(sc_socket socket, bool tcp_nodelay) {
     return true;
 }
 
+static bool
+net_set_int_option(sc_socket socket, int level, int option, int value,
+                   const char *name) {
+    sc_raw_socket raw_sock = unwrap(socket);
+
+    int ret = setsockopt(raw_sock, level, option, (const void *) &value,
+                         sizeof(value));
+    if (ret == -1) {
+        net_perror(name);
+        return false;
+    }
+
+    assert(ret == 0);
+    return true;
+}
+
+bool
+net_set_recv_buffer_size(sc_socket socket, int size) {
+    return net_set_int_option(socket, SOL_SOCKET, SO_RCVBUF, size,
+                              "setsockopt(SO_RCVBUF)");
+}
+
+bool
+net_set_send_buffer_size(sc_socket socket, int size) {
+    return net_set_int_option(socket, SOL_SOCKET, SO_SNDBUF, size,
+                              "setsockopt(SO_SNDBUF)");
+}
+
+bool
+net_set_busy_poll(sc_socket socket, int usec) {
+#ifdef SO_BUSY_POLL
+    return net_set_int_option(socket, SOL_SOCKET, SO_BUSY_POLL, usec,
+                              "setsockopt(SO_BUSY_POLL)");
+#else
+    (void) socket;
+    (void) usec;
+    LOGD("Socket busy polling not supported on this platform");
+    return false;
+#endif
+}
+
+bool
+net_set_tos(sc_socket socket, int tos) {
+    return net_set_int_option(socket, IPPROTO_IP, IP_TOS, tos,
+                              "setsockopt(IP_TOS)");
+}
+
 bool
 net_parse_ipv4(const char *s, uint32_t *ipv4) {
     struct in_addr addr;
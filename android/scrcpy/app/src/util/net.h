@@ -60,6 +60,11 @@ net_listen(sc_socket server_socket, uint32_t addr, uint16_t port, int backlog);
 sc_socket
 net_accept(sc_socket server_socket);
 
+// Create a pair of connected sockets over the loopback interface
+// (used to feed a component reading from a socket, for example in benchmarks)
+bool
+net_socketpair(sc_socket sockets[2]);
+
 // the _all versions wait/retry until len bytes have been written/read
 ssize_t
 net_recv(sc_socket socket, void *buf, size_t len);
@@ -73,6 +78,36 @@ net_send(sc_socket socket, const void *buf, size_t len);
 ssize_t
 net_send_all(sc_socket socket, const void *buf, size_t len);
 
+// Buffered reader, to receive many small messages per recv() call
+struct sc_net_reader {
+    sc_socket socket;
+    uint8_t *buf;
+    size_t cap;
+    size_t head; // index of the first unread byte
+    size_t tail; // index past the last received byte
+};
+
+bool
+sc_net_reader_init(struct sc_net_reader *reader, sc_socket socket,
+                   size_t cap);
+
+void
+sc_net_reader_destroy(struct sc_net_reader *reader);
+
+// Switch to a new socket, dropping any buffered data
+void
+sc_net_reader_reset(struct sc_net_reader *reader, sc_socket socket);
+
+// Return a pointer to the next len bytes (len <= cap), directly in the
+// buffer, or NULL on error or end-of-stream.
+// The bytes are consumed, and the pointer is valid until the next call.
+const uint8_t *
+sc_net_reader_next(struct sc_net_reader *reader, size_t len);
+
+// Read exactly len bytes into buf (large reads bypass the buffer)
+bool
+sc_net_reader_read_all(struct sc_net_reader *reader, void *buf, size_t len);
+
 // Shutdown the socket (or close on Windows) so that any blocking send() or
 // recv() are interrupted.
 bool
@@ -87,6 +122,23 @@ net_close(sc_socket socket);
 bool
 net_set_tcp_nodelay(sc_socket socket, bool tcp_nodelay);
 
+// Set the size of the kernel receive buffer (SO_RCVBUF)
+bool
+net_set_recv_buffer_size(sc_socket socket, int size);
+
+// Set the size of the kernel send buffer (SO_SNDBUF)
+bool
+net_set_send_buffer_size(sc_socket socket, int size);
+
+// Busy poll for up to `usec` microseconds on blocking reads (SO_BUSY_POLL),
+// to reduce the wake up latency at the cost of CPU (Linux only)
+bool
+net_set_busy_poll(sc_socket socket, int usec);
+
+// Set the IP "type of service" byte (the DSCP value is tos >> 2)
+bool
+net_set_tos(sc_socket socket, int tos);
+
 /**
  * Parse `ip` "xxx.xxx.xxx.xxx" to an IPv4 host representation
  */
@@ -0,0 +1,319 @@
+#include "resampler.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "util/log.h"
+#include "util/memory.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) \
+        && (defined(__GNUC__) || defined(__clang__))
+// The AVX2 kernel is compiled via a function attribute, and selected at
+// runtime according to the CPU features
+# define SC_RESAMPLER_X86
+# include <immintrin.h>
+# define SC_TARGET(T) __attribute__((target(T)))
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+# define SC_RESAMPLER_NEON
+# include <arm_neon.h>
+#endif
+
+#define SC_Q32_ONE (UINT64_C(1) << 32)
+#define SC_Q32_TO_FLOAT (1.0f / 4294967296.0f)
+
+// The interpolation of the frame at position p uses the frames at
+// floor(p) - 1 ... floor(p) + 2
+#define SC_RESAMPLER_HISTORY 1
+#define SC_RESAMPLER_LOOKAHEAD 2
+
+static inline float
+sc_resampler_cubic(float x0, float x1, float x2, float x3, float t) {
+    // Catmull-Rom spline between x1 and x2
+    return x1 + 0.5f * t * (x2 - x0
+                            + t * (2.f * x0 - 5.f * x1 + 4.f * x2 - x3
+                                   + t * (3.f * (x1 - x2) + x3 - x0)));
+}
+
+/* Scalar implementation */
+
+static void
+sc_resampler_kernel_c(float *out, const float *in, unsigned channels,
+                      uint64_t pos, uint64_t step, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+        uint64_t p = pos + i * step;
+        uint32_t idx = p >> 32;
+        float t = (uint32_t) p * SC_Q32_TO_FLOAT;
+
+        const float *s = in + (idx - 1) * channels;
+        for (unsigned c = 0; c < channels; ++c) {
+            out[c] = sc_resampler_cubic(s[c], s[channels + c],
+                                        s[2 * channels + c],
+                                        s[3 * channels + c], t);
+        }
+        out += channels;
+    }
+}
+
+#ifdef SC_RESAMPLER_X86
+
+/* AVX2 implementation (for 2 channels) */
+
+SC_TARGET("avx2") static inline __m256
+sc_resampler_cubic_avx2(__m256 x0, __m256 x1, __m256 x2, __m256 x3,
+                        __m256 t) {
+    // Same computation as sc_resampler_cubic()
+    __m256 a = _mm256_sub_ps(
+            _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(3.f),
+                                        _mm256_sub_ps(x1, x2)), x3), x0);
+    __m256 b = _mm256_sub_ps(
+            _mm256_add_ps(_mm256_sub_ps(_mm256_add_ps(x0, x0),
+                                        _mm256_mul_ps(_mm256_set1_ps(5.f),
+                                                      x1)),
+                          _mm256_mul_ps(_mm256_set1_ps(4.f), x2)), x3);
+    __m256 c = _mm256_sub_ps(x2, x0);
+    __m256 y = _mm256_add_ps(b, _mm256_mul_ps(t, a));
+    y = _mm256_add_ps(c, _mm256_mul_ps(t, y));
+    return _mm256_add_ps(x1, _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(0.5f),
+                                                         t), y));
+}
+
+SC_TARGET("avx2") static void
+sc_resampler_kernel_stereo_avx2(float *out, const float *in, unsigned channels,
+                                uint64_t pos, uint64_t step, uint32_t count) {
+    assert(channels == 2);
+
+    // 4 stereo frames per vector: the 64-bit lanes contain the Q32 positions
+    // of the 4 frames, the 32-bit lanes the samples [L0 R0 L1 R1 ...]
+    __m256i vp = _mm256_add_epi64(_mm256_set1_epi64x(pos),
+                                  _mm256_setr_epi64x(0, step, 2 * step,
+                                                     3 * step));
+    const __m256i vstep4 = _mm256_set1_epi64x(4 * step);
+    const __m256i channel = _mm256_setr_epi32(0, 1, 0, 1, 0, 1, 0, 1);
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256 frac_scale = _mm256_set1_ps(1.0f / (1 << 24));
+
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        // Integer part (the index of x1), duplicated for both channels
+        __m256i idx = _mm256_shuffle_epi32(_mm256_srli_epi64(vp, 32),
+                                           _MM_SHUFFLE(2, 2, 0, 0));
+        __m256i vi0 = _mm256_add_epi32(
+                _mm256_slli_epi32(_mm256_sub_epi32(idx, one), 1), channel);
+
+        // Fractional part, on 24 bits to be converted exactly to float
+        __m256i frac = _mm256_srli_epi64(_mm256_slli_epi64(vp, 32), 40);
+        frac = _mm256_shuffle_epi32(frac, _MM_SHUFFLE(2, 2, 0, 0));
+        __m256 t = _mm256_mul_ps(_mm256_cvtepi32_ps(frac), frac_scale);
+
+        __m256 x0 = _mm256_i32gather_ps(in, vi0, 4);
+        __m256 x1 = _mm256_i32gather_ps(in + 2, vi0, 4);
+        __m256 x2 = _mm256_i32gather_ps(in + 4, vi0, 4);
+        __m256 x3 = _mm256_i32gather_ps(in + 6, vi0, 4);
+
+        __m256 y = sc_resampler_cubic_avx2(x0, x1, x2, x3, t);
+        _mm256_storeu_ps(out + i * 2, y);
+
+        vp = _mm256_add_epi64(vp, vstep4);
+    }
+
+    sc_resampler_kernel_c(out + i * 2, in, 2, pos + i * step, step,
+                          count - i);
+}
+
+#endif // SC_RESAMPLER_X86
+
+#ifdef SC_RESAMPLER_NEON
+
+/* NEON implementation (for 2 channels) */
+
+static void
+sc_resampler_kernel_stereo_neon(float *out, const float *in, unsigned channels,
+                                uint64_t pos, uint64_t step, uint32_t count) {
+    assert(channels == 2);
+    (void) channels;
+
+    for (uint32_t i = 0; i < count; ++i) {
+        uint64_t p = pos + i * step;
+        uint32_t idx = p >> 32;
+        float32x2_t t = vdup_n_f32((uint32_t) p * SC_Q32_TO_FLOAT);
+
+        const float *s = in + (idx - 1) * 2;
+        // x0 and x1, then x2 and x3 (both channels)
+        float32x4_t x01 = vld1q_f32(s);
+        float32x4_t x23 = vld1q_f32(s + 4);
+        float32x2_t x0 = vget_low_f32(x01);
+        float32x2_t x1 = vget_high_f32(x01);
+        float32x2_t x2 = vget_low_f32(x23);
+        float32x2_t x3 = vget_high_f32(x23);
+
+        float32x2_t a = vsub_f32(vmla_n_f32(x3, vsub_f32(x1, x2), 3.f), x0);
+        float32x2_t b = vsub_f32(vmla_n_f32(vmls_n_f32(vmul_n_f32(x0, 2.f),
+                                                       x1, 5.f),
+                                            x2, 4.f), x3);
+        float32x2_t c = vsub_f32(x2, x0);
+        float32x2_t y = vmla_f32(b, t, a);
+        y = vmla_f32(c, t, y);
+        y = vmla_f32(x1, vmul_n_f32(t, 0.5f), y);
+
+        vst1_f32(out + i * 2, y);
+    }
+}
+
+#endif // SC_RESAMPLER_NEON
+
+bool
+sc_resampler_init(struct sc_resampler *r, unsigned channels) {
+    assert(channels);
+
+    r->channels = channels;
+    r->buf_cap = 4096;
+    r->buf = sc_allocarray(r->buf_cap, channels * sizeof(float));
+    if (!r->buf) {
+        LOG_OOM();
+        return false;
+    }
+
+    // Start with silent history, so that the first input frame is output
+    // first
+    memset(r->buf, 0, SC_RESAMPLER_HISTORY * channels * sizeof(float));
+    r->buf_frames = SC_RESAMPLER_HISTORY;
+    r->pos = SC_RESAMPLER_HISTORY * SC_Q32_ONE;
+    r->step = SC_Q32_ONE;
+    r->compensation_remaining = 0;
+
+    r->kernel = sc_resampler_kernel_c;
+    r->impl_name = "scalar";
+#if defined(SC_RESAMPLER_X86)
+    __builtin_cpu_init();
+    if (channels == 2 && __builtin_cpu_supports("avx2")) {
+        r->kernel = sc_resampler_kernel_stereo_avx2;
+        r->impl_name = "AVX2";
+    }
+#elif defined(SC_RESAMPLER_NEON)
+    if (channels == 2) {
+        r->kernel = sc_resampler_kernel_stereo_neon;
+        r->impl_name = "NEON";
+    }
+#endif
+
+    return true;
+}
+
+void
+sc_resampler_destroy(struct sc_resampler *r) {
+    free(r->buf);
+}
+
+bool
+sc_resampler_set_compensation(struct sc_resampler *r, int32_t delta,
+                              uint32_t distance) {
+    if (!distance || !delta) {
+        r->step = SC_Q32_ONE;
+        r->compensation_remaining = 0;
+        return true;
+    }
+
+    int64_t out_frames = (int64_t) distance + delta;
+    if (out_frames <= 0 || llabs(delta) > distance / 4) {
+        return false;
+    }
+
+    // distance input frames are consumed by (distance + delta) output frames
+    r->step = ((uint64_t) distance << 32) / (uint64_t) out_frames;
+    r->compensation_remaining = distance + delta;
+    return true;
+}
+
+uint32_t
+sc_resampler_get_delay(struct sc_resampler *r) {
+    uint32_t idx = r->pos >> 32;
+    assert(idx <= r->buf_frames);
+    return r->buf_frames - idx;
+}
+
+static bool
+sc_resampler_append(struct sc_resampler *r, const float *const *in,
+                    bool planar, uint32_t in_frames) {
+    unsigned channels = r->channels;
+
+    uint32_t needed = r->buf_frames + in_frames;
+    if (needed > r->buf_cap) {
+        uint32_t new_cap = MAX(needed, r->buf_cap * 2);
+        float *buf = sc_allocarray(new_cap, channels * sizeof(float));
+        if (!buf) {
+            LOG_OOM();
+            return false;
+        }
+        memcpy(buf, r->buf, r->buf_frames * channels * sizeof(float));
+        free(r->buf);
+        r->buf = buf;
+        r->buf_cap = new_cap;
+    }
+
+    float *dst = r->buf + r->buf_frames * channels;
+    if (planar) {
+        for (uint32_t i = 0; i < in_frames; ++i) {
+            for (unsigned c = 0; c < channels; ++c) {
+                *dst++ = in[c][i];
+            }
+        }
+    } else {
+        memcpy(dst, in[0], in_frames * channels * sizeof(float));
+    }
+
+    r->buf_frames = needed;
+    return true;
+}
+
+int32_t
+sc_resampler_process(struct sc_resampler *r, float *out, uint32_t out_cap,
+                     const float *const *in, bool planar, uint32_t in_frames) {
+    if (in_frames && !sc_resampler_append(r, in, planar, in_frames)) {
+        return -1;
+    }
+
+    unsigned channels = r->channels;
+
+    uint32_t produced = 0;
+    if (r->buf_frames > SC_RESAMPLER_LOOKAHEAD) {
+        // Last position for which all the interpolation inputs are available
+        uint64_t limit =
+            (uint64_t) (r->buf_frames - SC_RESAMPLER_LOOKAHEAD - 1) << 32
+            | UINT32_MAX;
+
+        while (produced < out_cap && r->pos <= limit) {
+            uint64_t avail = (limit - r->pos) / r->step + 1;
+            uint32_t n = MIN(avail, out_cap - produced);
+            if (r->compensation_remaining) {
+                n = MIN(n, r->compensation_remaining);
+            }
+
+            r->kernel(out + produced * channels, r->buf, channels, r->pos,
+                      r->step, n);
+            r->pos += n * r->step;
+            produced += n;
+
+            if (r->compensation_remaining) {
+                r->compensation_remaining -= n;
+                if (!r->compensation_remaining) {
+                    r->step = SC_Q32_ONE;
+                }
+            }
+        }
+    }
+
+    // Drop the consumed frames, except the history
+    uint32_t idx = r->pos >> 32;
+    if (idx > SC_RESAMPLER_HISTORY) {
+        uint32_t shift = MIN(idx, r->buf_frames) - SC_RESAMPLER_HISTORY;
+        memmove(r->buf, r->buf + shift * channels,
+                (r->buf_frames - shift) * channels * sizeof(float));
+        r->buf_frames -= shift;
+        r->pos -= (uint64_t) shift << 32;
+    }
+
+    return produced;
+}
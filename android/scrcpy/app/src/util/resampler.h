@@ -0,0 +1,86 @@
+#ifndef SC_RESAMPLER_H
+#define SC_RESAMPLER_H
+
+#include "common.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Lightweight resampler for clock drift compensation
+ *
+ * It converts 32-bit float samples (interleaved or planar) to interleaved
+ * float samples, slightly stretched or compressed to keep the audio buffering
+ * on target, using cubic (Catmull-Rom) interpolation.
+ *
+ * Unlike libswresample, it never converts the sample rate or the format, so it
+ * is much cheaper for the compensation of a few percent at most.
+ *
+ * For stereo, the interpolation is implemented with AVX2 or NEON depending on
+ * the CPU, with a scalar fallback.
+ */
+
+struct sc_resampler {
+    unsigned channels;
+
+    // Pending input frames (interleaved), including the history needed by the
+    // interpolation
+    float *buf;
+    uint32_t buf_frames;
+    uint32_t buf_cap;
+
+    // Position of the next output frame in buf, in Q32 fixed-point
+    uint64_t pos;
+    // Input step per output frame, in Q32 fixed-point (1 << 32 when there is
+    // no compensation)
+    uint64_t step;
+    // Number of output frames before the compensation ends (0 if disabled)
+    uint32_t compensation_remaining;
+
+    void (*kernel)(float *out, const float *in, unsigned channels,
+                   uint64_t pos, uint64_t step, uint32_t count);
+    const char *impl_name;
+};
+
+bool
+sc_resampler_init(struct sc_resampler *r, unsigned channels);
+
+void
+sc_resampler_destroy(struct sc_resampler *r);
+
+/**
+ * Output `delta` frames more (or less, if negative) than the input over the
+ * next `distance` output frames
+ *
+ * Same semantics as swr_set_compensation(). Passing distance == 0 disables
+ * the compensation.
+ *
+ * \retval false if the requested compensation is out of range (more than
+ *               25%)
+ */
+bool
+sc_resampler_set_compensation(struct sc_resampler *r, int32_t delta,
+                              uint32_t distance);
+
+/**
+ * Return the number of input frames buffered but not output yet
+ */
+uint32_t
+sc_resampler_get_delay(struct sc_resampler *r);
+
+/**
+ * Resample `in_frames` input frames to `out` (at most `out_cap` frames)
+ *
+ * If `planar`, `in` contains one pointer per channel, otherwise `in[0]`
+ * contains the interleaved frames.
+ *
+ * Frames that could not be output (because of the interpolation lookahead, or
+ * if `out` is too small) are kept for the next call.
+ *
+ * \return the number of frames written to `out`, or -1 on allocation failure
+ */
+int32_t
+sc_resampler_process(struct sc_resampler *r, float *out, uint32_t out_cap,
+                     const float *const *in, bool planar, uint32_t in_frames);
+
+#endif
@@ -0,0 +1,31 @@
+#include "ring_waiter.h"
+
+bool
+sc_ring_waiter_init(struct sc_ring_waiter *waiter) {
+    bool ok = sc_mutex_init(&waiter->mutex);
+    if (!ok) {
+        return false;
+    }
+
+    ok = sc_cond_init(&waiter->cond);
+    if (!ok) {
+        sc_mutex_destroy(&waiter->mutex);
+        return false;
+    }
+
+    atomic_init(&waiter->waiting, false);
+    return true;
+}
+
+void
+sc_ring_waiter_destroy(struct sc_ring_waiter *waiter) {
+    sc_cond_destroy(&waiter->cond);
+    sc_mutex_destroy(&waiter->mutex);
+}
+
+void
+sc_ring_waiter_wake_up(struct sc_ring_waiter *waiter) {
+    sc_mutex_lock(&waiter->mutex);
+    sc_cond_broadcast(&waiter->cond);
+    sc_mutex_unlock(&waiter->mutex);
+}
@@ -0,0 +1,74 @@
+#ifndef SC_RING_WAITER_H
+#define SC_RING_WAITER_H
+
+#include "common.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+
+#include "util/thread.h"
+
+/**
+ * Blocking wait helpers for the lock-free rings (spsc_ring.h, mpsc_ring.h)
+ *
+ * The producers never lock the mutex unless the consumer is actually
+ * waiting: the consumer sets the waiting flag before checking its condition,
+ * and the producers check the flag after publishing an item. Both accesses
+ * are sequentially consistent (like the ring cursors publishing the items),
+ * so either the consumer sees the new item, or the producer sees that the
+ * consumer is waiting and signals it.
+ */
+struct sc_ring_waiter {
+    sc_mutex mutex;
+    sc_cond cond;
+    atomic_bool waiting;
+};
+
+bool
+sc_ring_waiter_init(struct sc_ring_waiter *waiter);
+
+void
+sc_ring_waiter_destroy(struct sc_ring_waiter *waiter);
+
+/**
+ * Wake up the consumer if it is waiting
+ *
+ * To be called by the producers after each push.
+ */
+static inline void
+sc_ring_waiter_notify(struct sc_ring_waiter *waiter) {
+    if (atomic_load_explicit(&waiter->waiting, memory_order_seq_cst)) {
+        sc_mutex_lock(&waiter->mutex);
+        sc_cond_signal(&waiter->cond);
+        sc_mutex_unlock(&waiter->mutex);
+    }
+}
+
+/**
+ * Unconditionally wake up the consumer
+ *
+ * To be called after changing a state checked by the wait condition other
+ * than the ring content (typically a "stopped" flag).
+ */
+void
+sc_ring_waiter_wake_up(struct sc_ring_waiter *waiter);
+
+/**
+ * Block until `condition` is true
+ *
+ * The condition is evaluated with the waiter mutex locked; it must only read
+ * atomic variables with memory_order_seq_cst (typically
+ * sc_spsc_ring_is_empty() or sc_mpsc_ring_is_empty()).
+ */
+#define sc_ring_waiter_wait(pw, condition) \
+(void) ({ \
+    sc_mutex_lock(&(pw)->mutex); \
+    atomic_store_explicit(&(pw)->waiting, true, memory_order_seq_cst); \
+    while (!(condition)) { \
+        sc_cond_wait(&(pw)->cond, &(pw)->mutex); \
+    } \
+    atomic_store_explicit(&(pw)->waiting, false, memory_order_relaxed); \
+    sc_mutex_unlock(&(pw)->mutex); \
+})
+
+#endif
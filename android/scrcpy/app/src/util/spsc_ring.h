@@ -0,0 +1,128 @@
+#ifndef SC_SPSC_RING_H
+#define SC_SPSC_RING_H
+
+#include "common.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * A single-producer single-consumer lock-free ring of fixed capacity.
+ *
+ * It is generic over the type of its items, so it is implemented via macros
+ * (like SC_VECDEQUE).
+ *
+ * To use a ring, a new type must be defined, with a capacity which must be a
+ * power of 2:
+ *
+ *     struct ring_int SC_SPSC_RING(int, 64);
+ *
+ * Exactly one thread may push and exactly one thread may pop at a time. The
+ * items are copied by value. To block until an item is available, use
+ * sc_ring_waiter (util/ring_waiter.h).
+ *
+ * Functions and macros having name ending with '_' are private.
+ */
+
+#define SC_RING_CACHE_LINE_SIZE 64
+
+/**
+ * SPSC ring struct body
+ *
+ * The cursors are never wrapped (they are masked to get an index), and they
+ * are on separate cache lines to avoid false sharing between the producer
+ * and the consumer.
+ */
+#define SC_SPSC_RING(type, capacity) { \
+    type data[capacity]; \
+    uint8_t pad0_[SC_RING_CACHE_LINE_SIZE]; \
+    atomic_uint_least32_t head; /* written by the producer */ \
+    uint8_t pad1_[SC_RING_CACHE_LINE_SIZE - sizeof(atomic_uint_least32_t)]; \
+    atomic_uint_least32_t tail; /* written by the consumer */ \
+    uint8_t pad2_[SC_RING_CACHE_LINE_SIZE - sizeof(atomic_uint_least32_t)]; \
+}
+
+#define sc_spsc_ring_capacity(pr) \
+    ((uint32_t) ARRAY_LEN((pr)->data))
+
+#define sc_spsc_ring_mask_(pr) \
+    (sc_spsc_ring_capacity(pr) - 1)
+
+/**
+ * Initialize an empty ring
+ */
+#define sc_spsc_ring_init(pr) \
+(void) ({ \
+    /* The cursors are not wrapped, so the capacity must divide 2^32 */ \
+    _Static_assert(!(ARRAY_LEN((pr)->data) & (ARRAY_LEN((pr)->data) - 1)), \
+                   "The ring capacity must be a power of 2"); \
+    atomic_init(&(pr)->head, 0); \
+    atomic_init(&(pr)->tail, 0); \
+})
+
+/**
+ * Return the number of items in the ring
+ *
+ * May be called from any thread (the result may be outdated immediately).
+ */
+#define sc_spsc_ring_size(pr) \
+({ \
+    /* Read tail first, so that head - tail may not underflow */ \
+    uint32_t tail_ = atomic_load_explicit(&(pr)->tail, memory_order_acquire); \
+    uint32_t head_ = atomic_load_explicit(&(pr)->head, memory_order_acquire); \
+    head_ - tail_; \
+})
+
+/**
+ * Return whether the ring is empty
+ *
+ * Must only be called by the consumer (typically as a wait condition).
+ */
+#define sc_spsc_ring_is_empty(pr) \
+    (atomic_load_explicit(&(pr)->head, memory_order_seq_cst) \
+        == atomic_load_explicit(&(pr)->tail, memory_order_relaxed))
+
+/**
+ * Push a copy of `value`
+ *
+ * Must only be called by the producer.
+ *
+ * \return false if the ring is full
+ */
+#define sc_spsc_ring_push(pr, value) \
+({ \
+    /* Only the producer writes head */ \
+    uint32_t head_ = atomic_load_explicit(&(pr)->head, memory_order_relaxed); \
+    uint32_t tail_ = atomic_load_explicit(&(pr)->tail, memory_order_acquire); \
+    bool ok_ = head_ - tail_ < sc_spsc_ring_capacity(pr); \
+    if (ok_) { \
+        (pr)->data[head_ & sc_spsc_ring_mask_(pr)] = (value); \
+        /* Publish the item (seq_cst to pair with sc_ring_waiter) */ \
+        atomic_store_explicit(&(pr)->head, head_ + 1, memory_order_seq_cst); \
+    } \
+    ok_; \
+})
+
+/**
+ * Pop the oldest item into `*pitem`
+ *
+ * Must only be called by the consumer.
+ *
+ * \return false if the ring is empty
+ */
+#define sc_spsc_ring_pop(pr, pitem) \
+({ \
+    /* Only the consumer writes tail */ \
+    uint32_t tail_ = atomic_load_explicit(&(pr)->tail, memory_order_relaxed); \
+    uint32_t head_ = atomic_load_explicit(&(pr)->head, memory_order_acquire); \
+    bool ok_ = tail_ != head_; \
+    if (ok_) { \
+        *(pitem) = (pr)->data[tail_ & sc_spsc_ring_mask_(pr)]; \
+        /* Release the slot once the item has been read */ \
+        atomic_store_explicit(&(pr)->tail, tail_ + 1, memory_order_release); \
+    } \
+    ok_; \
+})
+
+#endif
@@ -355,21 +355,28 @@ sc_str_remove_trailing_cr(char *s, size_t len) {
     return len;
 }
 
+void
+sc_str_write_hex(char *out, const uint8_t *data, size_t len) {
+    static const char digits[] = "0123456789ABCDEF";
+
+    for (size_t i = 0; i < len; ++i) {
+        out[i * 3] = digits[data[i] >> 4];
+        out[i * 3 + 1] = digits[data[i] & 0xF];
+        out[i * 3 + 2] = ' ';
+    }
+
+    // Remove the final space
+    out[len ? len * 3 - 1 : 0] = '\0';
+}
+
 char *
 sc_str_to_hex_string(const uint8_t *data, size_t size) {
-    size_t buffer_size = size * 3 + 1;
-    char *buffer = malloc(buffer_size);
+    char *buffer = malloc(SC_STR_HEX_SIZE(size));
     if (!buffer) {
         LOG_OOM();
         return NULL;
     }
 
-    for (size_t i = 0; i < size; ++i) {
-        snprintf(buffer + i * 3, 4, "%02X ", data[i]);
-    }
-
-    // Remove the final space
-    buffer[size * 3] = '\0';
-
+    sc_str_write_hex(buffer, data, size);
     return buffer;
 }
@@ -149,6 +149,17 @@ sc_str_index_of_column(const char *s, unsigned col, const char *seps);
 size_t
 sc_str_remove_trailing_cr(char *s, size_t len);
 
+// Size of the hexadecimal string of len bytes, including the final '\0'
+#define SC_STR_HEX_SIZE(len) ((len) * 3 + 1)
+
+/**
+ * Write binary data as a hexadecimal string ("01 AB ...") to `out`
+ *
+ * The output buffer must be at least SC_STR_HEX_SIZE(len) bytes.
+ */
+void
+sc_str_write_hex(char *out, const uint8_t *data, size_t len);
+
 /**
  * Convert binary data to hexadecimal string
  */
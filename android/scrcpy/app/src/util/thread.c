@@ -1,6 +1,7 @@
 #include "thread.h"
 
 #include <assert.h>
+#include <inttypes.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
@@ -65,6 +66,58 @@ sc_thread_join(sc_thread *thread, int *status) {
     SDL_WaitThread(thread->thread, status);
 }
 
+static struct sc_thread_policy sc_thread_policies[SC_THREAD_ROLE_COUNT] = {
+    // Recording is a background task
+    [SC_THREAD_ROLE_RECORDING] = {
+        .set_priority = true,
+        .priority = SC_THREAD_PRIORITY_LOW,
+    },
+};
+
+static const char *const sc_thread_role_names[SC_THREAD_ROLE_COUNT] = {
+    [SC_THREAD_ROLE_VIDEO] = "video",
+    [SC_THREAD_ROLE_AUDIO] = "audio",
+    [SC_THREAD_ROLE_CONTROL] = "control",
+    [SC_THREAD_ROLE_RECORDING] = "recording",
+};
+
+void
+sc_thread_set_policy(enum sc_thread_role role,
+                     const struct sc_thread_policy *policy) {
+    assert(role < SC_THREAD_ROLE_COUNT);
+    sc_thread_policies[role] = *policy;
+}
+
+void
+sc_thread_apply_policy(enum sc_thread_role role) {
+    assert(role < SC_THREAD_ROLE_COUNT);
+    const struct sc_thread_policy *policy = &sc_thread_policies[role];
+    const char *name = sc_thread_role_names[role];
+
+    if (policy->affinity) {
+        if (sc_thread_set_affinity(policy->affinity)) {
+            LOGD("Thread '%s': CPU affinity set to 0x%" PRIx64_, name,
+                 policy->affinity);
+        } else {
+            LOGW("Thread '%s': could not set CPU affinity", name);
+        }
+    }
+
+    if (policy->realtime) {
+        if (sc_thread_set_realtime(role)) {
+            LOGD("Thread '%s': real-time scheduling enabled", name);
+            return;
+        }
+        LOGW("Thread '%s': could not enable real-time scheduling (missing "
+             "privileges?), fallback to high priority", name);
+    }
+
+    if (policy->set_priority) {
+        bool ok = sc_thread_set_priority(policy->priority);
+        (void) ok; // We don't care if it worked, at least we tried
+    }
+}
+
 bool
 sc_mutex_init(sc_mutex *mutex) {
     SDL_mutex *sdl_mutex = SDL_CreateMutex();
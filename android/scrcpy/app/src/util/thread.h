@@ -5,6 +5,7 @@
 
 #include <stdatomic.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "tick.h"
 
@@ -28,6 +29,26 @@ enum sc_thread_priority {
     SC_THREAD_PRIORITY_TIME_CRITICAL,
 };
 
+// The threads whose scheduling may be configured (see sc_thread_set_policy())
+enum sc_thread_role {
+    SC_THREAD_ROLE_VIDEO, // video demuxer (and decoder)
+    SC_THREAD_ROLE_AUDIO, // audio demuxer (and decoder)
+    SC_THREAD_ROLE_CONTROL, // controller and receiver
+    SC_THREAD_ROLE_RECORDING, // recorder and recorder writer
+};
+
+#define SC_THREAD_ROLE_COUNT 4
+
+struct sc_thread_policy {
+    bool set_priority;
+    enum sc_thread_priority priority; // only if set_priority
+    // Use a real-time scheduling class (SCHED_FIFO on Linux, MMCSS on
+    // Windows) if permitted, otherwise fall back to the priority
+    bool realtime;
+    // Mask of the CPUs allowed to run the thread, 0 for no restriction
+    uint64_t affinity;
+};
+
 typedef struct sc_mutex {
     SDL_mutex *mutex;
 #ifndef NDEBUG
@@ -51,6 +72,40 @@ sc_thread_join(sc_thread *thread, int *status);
 bool
 sc_thread_set_priority(enum sc_thread_priority priority);
 
+/**
+ * Configure the scheduling policy of the threads of a role
+ *
+ * Must be called before the threads are started.
+ */
+void
+sc_thread_set_policy(enum sc_thread_role role,
+                     const struct sc_thread_policy *policy);
+
+/**
+ * Apply the policy of the role to the current thread
+ *
+ * To be called by each thread at its start. Failures are logged but not
+ * fatal (typically, real-time scheduling requires privileges).
+ */
+void
+sc_thread_apply_policy(enum sc_thread_role role);
+
+/**
+ * Switch the current thread to a real-time scheduling class
+ *
+ * Implemented in sys/ for each platform.
+ */
+bool
+sc_thread_set_realtime(enum sc_thread_role role);
+
+/**
+ * Restrict the current thread to a set of CPUs (bit i for CPU i)
+ *
+ * Implemented in sys/ for each platform.
+ */
+bool
+sc_thread_set_affinity(uint64_t cpus);
+
 bool
 sc_mutex_init(sc_mutex *mutex);
 
@@ -353,6 +353,28 @@ sc_vecdeque_growsize_(size_t value)
     ok; \
 })
 
+/**
+ * Return a pointer to the next item to pop (still in the VecDeque)
+ *
+ * It is an error to call this function if the VecDeque is empty.
+ */
+#define sc_vecdeque_peek(pv) \
+({ \
+    assert(!sc_vecdeque_is_empty(pv)); \
+    &(pv)->data[(pv)->origin]; \
+})
+
+/**
+ * Return a pointer to the last pushed item (still in the VecDeque)
+ *
+ * It is an error to call this function if the VecDeque is empty.
+ */
+#define sc_vecdeque_peek_back(pv) \
+({ \
+    assert(!sc_vecdeque_is_empty(pv)); \
+    &(pv)->data[((pv)->origin + (pv)->size - 1) % (pv)->cap]; \
+})
+
 /**
  * Pop an item and return a pointer to it (still in the VecDeque)
  *
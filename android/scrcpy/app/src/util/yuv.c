@@ -0,0 +1,821 @@
+#include "yuv.h"
+
+#include <assert.h>
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) \
+        && (defined(__GNUC__) || defined(__clang__))
+// Kernels are compiled for specific targets (via function attributes), and
+// selected at runtime according to the CPU features
+# define SC_YUV_X86
+# include <immintrin.h>
+# define SC_TARGET(T) __attribute__((target(T)))
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+// NEON is always available on aarch64 (and on armv7 builds enabling it)
+# define SC_YUV_NEON
+# include <arm_neon.h>
+#endif
+
+// Q16 coefficients
+#define SC_Q16(x) ((int32_t) ((x) * 65536 + 0.5))
+
+// Row hash: each 32-bit lane is updated as rotl((lane ^ word) * prime)
+#define SC_YUV_HASH_BLOCK_SIZE (4 * SC_YUV_HASH_LANES)
+#define SC_YUV_HASH_PRIME 0x9E3779B1u
+#define SC_YUV_HASH_ROTATION 13
+
+static const struct sc_yuv_coeffs SC_YUV_BT601_LIMITED = {
+    .y_offset = 16,
+    .uv_offset = 128,
+    .y_mul = SC_Q16(1.164383),
+    .v_to_r = SC_Q16(1.596027),
+    .u_to_g = SC_Q16(0.391762),
+    .v_to_g = SC_Q16(0.812968),
+    .u_to_b = SC_Q16(2.017232),
+};
+
+static const struct sc_yuv_coeffs SC_YUV_BT601_FULL = {
+    .y_offset = 0,
+    .uv_offset = 128,
+    .y_mul = SC_Q16(1.0),
+    .v_to_r = SC_Q16(1.402),
+    .u_to_g = SC_Q16(0.344136),
+    .v_to_g = SC_Q16(0.714136),
+    .u_to_b = SC_Q16(1.772),
+};
+
+static const struct sc_yuv_coeffs SC_YUV_BT709_LIMITED = {
+    .y_offset = 16,
+    .uv_offset = 128,
+    .y_mul = SC_Q16(1.164383),
+    .v_to_r = SC_Q16(1.792741),
+    .u_to_g = SC_Q16(0.213249),
+    .v_to_g = SC_Q16(0.532909),
+    .u_to_b = SC_Q16(2.112402),
+};
+
+static const struct sc_yuv_coeffs SC_YUV_BT709_FULL = {
+    .y_offset = 0,
+    .uv_offset = 128,
+    .y_mul = SC_Q16(1.0),
+    .v_to_r = SC_Q16(1.5748),
+    .u_to_g = SC_Q16(0.187324),
+    .v_to_g = SC_Q16(0.468124),
+    .u_to_b = SC_Q16(1.8556),
+};
+
+const struct sc_yuv_coeffs *
+sc_yuv_get_coeffs(bool bt709, bool full_range) {
+    if (bt709) {
+        return full_range ? &SC_YUV_BT709_FULL : &SC_YUV_BT709_LIMITED;
+    }
+    return full_range ? &SC_YUV_BT601_FULL : &SC_YUV_BT601_LIMITED;
+}
+
+static inline uint8_t
+sc_clip_u8(int32_t v) {
+    return v < 0 ? 0 : v > 255 ? 255 : v;
+}
+
+/* Scalar implementation */
+
+static void
+sc_yuv_interleave_uv_c(uint8_t *dst, const uint8_t *u, const uint8_t *v,
+                       size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        dst[2 * i] = u[i];
+        dst[2 * i + 1] = v[i];
+    }
+}
+
+static void
+sc_yuv_pack_yuyv_c(uint8_t *dst, const uint8_t *y, const uint8_t *u,
+                   const uint8_t *v, size_t width) {
+    assert(!(width % 2));
+    for (size_t x = 0; x < width; x += 2) {
+        dst[2 * x] = y[x];
+        dst[2 * x + 1] = u[x / 2];
+        dst[2 * x + 2] = y[x + 1];
+        dst[2 * x + 3] = v[x / 2];
+    }
+}
+
+static void
+sc_yuv_to_bgra_c(uint8_t *dst, const uint8_t *y, const uint8_t *u,
+                 const uint8_t *v, size_t width,
+                 const struct sc_yuv_coeffs *c) {
+    for (size_t x = 0; x < width; ++x) {
+        int32_t yy = (y[x] - c->y_offset) * c->y_mul + (1 << 15);
+        int32_t uu = u[x / 2] - c->uv_offset;
+        int32_t vv = v[x / 2] - c->uv_offset;
+        dst[4 * x] = sc_clip_u8((yy + c->u_to_b * uu) >> 16);
+        dst[4 * x + 1] =
+            sc_clip_u8((yy - c->u_to_g * uu - c->v_to_g * vv) >> 16);
+        dst[4 * x + 2] = sc_clip_u8((yy + c->v_to_r * vv) >> 16);
+        dst[4 * x + 3] = 0xFF;
+    }
+}
+
+static void
+sc_yuv_downscale_2x_c(uint8_t *dst, const uint8_t *row0, const uint8_t *row1,
+                      size_t dst_width) {
+    for (size_t i = 0; i < dst_width; ++i) {
+        dst[i] = (row0[2 * i] + row0[2 * i + 1]
+                + row1[2 * i] + row1[2 * i + 1] + 2) >> 2;
+    }
+}
+
+static void
+sc_yuv_transpose_c(uint8_t *dst, ptrdiff_t dst_stride, const uint8_t *src,
+                   ptrdiff_t src_stride, size_t width, size_t height) {
+    for (size_t y = 0; y < height; ++y) {
+        const uint8_t *row = src + (ptrdiff_t) y * src_stride;
+        for (size_t x = 0; x < width; ++x) {
+            dst[(ptrdiff_t) x * dst_stride + y] = row[x];
+        }
+    }
+}
+
+static void
+sc_yuv_reverse_row_c(uint8_t *dst, const uint8_t *src, size_t width) {
+    for (size_t x = 0; x < width; ++x) {
+        dst[x] = src[width - 1 - x];
+    }
+}
+
+// Transpose the borders not covered by the blocks of size x size samples
+static void
+sc_yuv_transpose_tails(uint8_t *dst, ptrdiff_t dst_stride, const uint8_t *src,
+                       ptrdiff_t src_stride, size_t width, size_t height,
+                       size_t size) {
+    size_t bw = width - width % size;
+    size_t bh = height - height % size;
+    // right columns, over the whole height
+    sc_yuv_transpose_c(dst + (ptrdiff_t) bw * dst_stride, dst_stride, src + bw,
+                       src_stride, width - bw, height);
+    // bottom rows, below the blocks
+    sc_yuv_transpose_c(dst + bh, dst_stride, src + (ptrdiff_t) bh * src_stride,
+                       src_stride, bw, height - bh);
+}
+
+static inline uint32_t
+sc_rotl32(uint32_t v, unsigned n) {
+    return (v << n) | (v >> (32 - n));
+}
+
+static void
+sc_yuv_hash_blocks_c(uint32_t *state, const uint8_t *data, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        for (unsigned k = 0; k < SC_YUV_HASH_LANES; ++k) {
+            uint32_t w;
+            memcpy(&w, data + 4 * k, sizeof(w));
+            state[k] = sc_rotl32((state[k] ^ w) * SC_YUV_HASH_PRIME,
+                                 SC_YUV_HASH_ROTATION);
+        }
+        data += SC_YUV_HASH_BLOCK_SIZE;
+    }
+}
+
+#ifdef SC_YUV_X86
+
+/* SSE4.1 implementation */
+
+SC_TARGET("sse4.1") static void
+sc_yuv_interleave_uv_sse41(uint8_t *dst, const uint8_t *u, const uint8_t *v,
+                           size_t count) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i uu = _mm_loadu_si128((const __m128i *) (u + i));
+        __m128i vv = _mm_loadu_si128((const __m128i *) (v + i));
+        _mm_storeu_si128((__m128i *) (dst + 2 * i), _mm_unpacklo_epi8(uu, vv));
+        _mm_storeu_si128((__m128i *) (dst + 2 * i + 16),
+                         _mm_unpackhi_epi8(uu, vv));
+    }
+    sc_yuv_interleave_uv_c(dst + 2 * i, u + i, v + i, count - i);
+}
+
+SC_TARGET("sse4.1") static void
+sc_yuv_pack_yuyv_sse41(uint8_t *dst, const uint8_t *y, const uint8_t *u,
+                       const uint8_t *v, size_t width) {
+    size_t x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m128i yy = _mm_loadu_si128((const __m128i *) (y + x));
+        __m128i uu = _mm_loadl_epi64((const __m128i *) (u + x / 2));
+        __m128i vv = _mm_loadl_epi64((const __m128i *) (v + x / 2));
+        __m128i uv = _mm_unpacklo_epi8(uu, vv);
+        _mm_storeu_si128((__m128i *) (dst + 2 * x), _mm_unpacklo_epi8(yy, uv));
+        _mm_storeu_si128((__m128i *) (dst + 2 * x + 16),
+                         _mm_unpackhi_epi8(yy, uv));
+    }
+    sc_yuv_pack_yuyv_c(dst + 2 * x, y + x, u + x / 2, v + x / 2, width - x);
+}
+
+SC_TARGET("sse4.1") static inline void
+sc_yuv_to_rgb_sse41(__m128i y, __m128i u, __m128i v,
+                    const struct sc_yuv_coeffs *c,
+                    __m128i *r, __m128i *g, __m128i *b) {
+    // 4 pixels, 32-bit lanes
+    __m128i yy = _mm_mullo_epi32(_mm_sub_epi32(y, _mm_set1_epi32(c->y_offset)),
+                                 _mm_set1_epi32(c->y_mul));
+    yy = _mm_add_epi32(yy, _mm_set1_epi32(1 << 15));
+    __m128i uu = _mm_sub_epi32(u, _mm_set1_epi32(c->uv_offset));
+    __m128i vv = _mm_sub_epi32(v, _mm_set1_epi32(c->uv_offset));
+
+    __m128i rr = _mm_add_epi32(yy, _mm_mullo_epi32(vv,
+                                                   _mm_set1_epi32(c->v_to_r)));
+    __m128i gg = _mm_sub_epi32(yy, _mm_mullo_epi32(uu,
+                                                   _mm_set1_epi32(c->u_to_g)));
+    gg = _mm_sub_epi32(gg, _mm_mullo_epi32(vv, _mm_set1_epi32(c->v_to_g)));
+    __m128i bb = _mm_add_epi32(yy, _mm_mullo_epi32(uu,
+                                                   _mm_set1_epi32(c->u_to_b)));
+
+    *r = _mm_srai_epi32(rr, 16);
+    *g = _mm_srai_epi32(gg, 16);
+    *b = _mm_srai_epi32(bb, 16);
+}
+
+SC_TARGET("sse4.1") static void
+sc_yuv_to_bgra_sse41(uint8_t *dst, const uint8_t *y, const uint8_t *u,
+                     const uint8_t *v, size_t width,
+                     const struct sc_yuv_coeffs *c) {
+    size_t x = 0;
+    for (; x + 8 <= width; x += 8) {
+        int32_t u4;
+        int32_t v4;
+        memcpy(&u4, u + x / 2, 4);
+        memcpy(&v4, v + x / 2, 4);
+
+        // 8 luma samples and 4 chroma samples, duplicated horizontally
+        __m128i y16 = _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i *)
+                                                        (y + x)));
+        __m128i u16 = _mm_cvtepu8_epi16(_mm_cvtsi32_si128(u4));
+        __m128i v16 = _mm_cvtepu8_epi16(_mm_cvtsi32_si128(v4));
+        u16 = _mm_unpacklo_epi16(u16, u16);
+        v16 = _mm_unpacklo_epi16(v16, v16);
+
+        __m128i r0, g0, b0, r1, g1, b1;
+        sc_yuv_to_rgb_sse41(_mm_cvtepi16_epi32(y16), _mm_cvtepi16_epi32(u16),
+                            _mm_cvtepi16_epi32(v16), c, &r0, &g0, &b0);
+        sc_yuv_to_rgb_sse41(_mm_cvtepi16_epi32(_mm_srli_si128(y16, 8)),
+                            _mm_cvtepi16_epi32(_mm_srli_si128(u16, 8)),
+                            _mm_cvtepi16_epi32(_mm_srli_si128(v16, 8)),
+                            c, &r1, &g1, &b1);
+
+        // Saturate to [0, 255] (the low 8 bytes contain the 8 pixels)
+        __m128i r = _mm_packus_epi16(_mm_packs_epi32(r0, r1), _mm_setzero_si128());
+        __m128i g = _mm_packus_epi16(_mm_packs_epi32(g0, g1), _mm_setzero_si128());
+        __m128i b = _mm_packus_epi16(_mm_packs_epi32(b0, b1), _mm_setzero_si128());
+
+        __m128i bg = _mm_unpacklo_epi8(b, g);
+        __m128i ra = _mm_unpacklo_epi8(r, _mm_set1_epi8((char) 0xFF));
+        _mm_storeu_si128((__m128i *) (dst + 4 * x), _mm_unpacklo_epi16(bg, ra));
+        _mm_storeu_si128((__m128i *) (dst + 4 * x + 16),
+                         _mm_unpackhi_epi16(bg, ra));
+    }
+    sc_yuv_to_bgra_c(dst + 4 * x, y + x, u + x / 2, v + x / 2, width - x, c);
+}
+
+SC_TARGET("sse4.1") static void
+sc_yuv_downscale_2x_sse41(uint8_t *dst, const uint8_t *row0,
+                          const uint8_t *row1, size_t dst_width) {
+    const __m128i ones = _mm_set1_epi8(1);
+    const __m128i two = _mm_set1_epi16(2);
+    size_t i = 0;
+    for (; i + 16 <= dst_width; i += 16) {
+        const __m128i *p0 = (const __m128i *) (row0 + 2 * i);
+        const __m128i *p1 = (const __m128i *) (row1 + 2 * i);
+        // Horizontal sums of pairs (16-bit)
+        __m128i a = _mm_maddubs_epi16(_mm_loadu_si128(p0), ones);
+        __m128i b = _mm_maddubs_epi16(_mm_loadu_si128(p0 + 1), ones);
+        __m128i c = _mm_maddubs_epi16(_mm_loadu_si128(p1), ones);
+        __m128i d = _mm_maddubs_epi16(_mm_loadu_si128(p1 + 1), ones);
+        __m128i lo = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(a, c), two),
+                                    2);
+        __m128i hi = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(b, d), two),
+                                    2);
+        _mm_storeu_si128((__m128i *) (dst + i), _mm_packus_epi16(lo, hi));
+    }
+    sc_yuv_downscale_2x_c(dst + i, row0 + 2 * i, row1 + 2 * i, dst_width - i);
+}
+
+SC_TARGET("sse4.1") static void
+sc_yuv_transpose_sse41(uint8_t *dst, ptrdiff_t dst_stride, const uint8_t *src,
+                       ptrdiff_t src_stride, size_t width, size_t height) {
+    // 8x8 blocks, transposed by interleaving 8-, 16- then 32-bit elements
+    for (size_t y = 0; y + 8 <= height; y += 8) {
+        const uint8_t *s = src + (ptrdiff_t) y * src_stride;
+        for (size_t x = 0; x + 8 <= width; x += 8) {
+            __m128i r[8];
+            for (int i = 0; i < 8; ++i) {
+                r[i] = _mm_loadl_epi64((const __m128i *)
+                                       (s + i * src_stride + x));
+            }
+
+            __m128i a0 = _mm_unpacklo_epi8(r[0], r[1]);
+            __m128i a1 = _mm_unpacklo_epi8(r[2], r[3]);
+            __m128i a2 = _mm_unpacklo_epi8(r[4], r[5]);
+            __m128i a3 = _mm_unpacklo_epi8(r[6], r[7]);
+            __m128i b0 = _mm_unpacklo_epi16(a0, a1); // columns 0..3, rows 0..3
+            __m128i b1 = _mm_unpackhi_epi16(a0, a1); // columns 4..7, rows 0..3
+            __m128i b2 = _mm_unpacklo_epi16(a2, a3); // columns 0..3, rows 4..7
+            __m128i b3 = _mm_unpackhi_epi16(a2, a3); // columns 4..7, rows 4..7
+            __m128i c[4] = {
+                _mm_unpacklo_epi32(b0, b2), // columns 0 and 1
+                _mm_unpackhi_epi32(b0, b2), // columns 2 and 3
+                _mm_unpacklo_epi32(b1, b3), // columns 4 and 5
+                _mm_unpackhi_epi32(b1, b3), // columns 6 and 7
+            };
+
+            uint8_t *d = dst + (ptrdiff_t) x * dst_stride + y;
+            for (int i = 0; i < 4; ++i) {
+                _mm_storel_epi64((__m128i *) (d + 2 * i * dst_stride), c[i]);
+                _mm_storel_epi64((__m128i *) (d + (2 * i + 1) * dst_stride),
+                                 _mm_srli_si128(c[i], 8));
+            }
+        }
+    }
+    sc_yuv_transpose_tails(dst, dst_stride, src, src_stride, width, height, 8);
+}
+
+SC_TARGET("sse4.1") static void
+sc_yuv_reverse_row_sse41(uint8_t *dst, const uint8_t *src, size_t width) {
+    const __m128i reverse = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8,
+                                          7, 6, 5, 4, 3, 2, 1, 0);
+    size_t x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *) (src + width - x - 16));
+        _mm_storeu_si128((__m128i *) (dst + x), _mm_shuffle_epi8(v, reverse));
+    }
+    sc_yuv_reverse_row_c(dst + x, src, width - x);
+}
+
+SC_TARGET("sse4.1") static inline __m128i
+sc_yuv_hash_step_sse41(__m128i h, __m128i w, __m128i prime) {
+    h = _mm_mullo_epi32(_mm_xor_si128(h, w), prime);
+    return _mm_or_si128(_mm_slli_epi32(h, SC_YUV_HASH_ROTATION),
+                        _mm_srli_epi32(h, 32 - SC_YUV_HASH_ROTATION));
+}
+
+SC_TARGET("sse4.1") static void
+sc_yuv_hash_blocks_sse41(uint32_t *state, const uint8_t *data,
+                         size_t count) {
+    const __m128i prime = _mm_set1_epi32((int32_t) SC_YUV_HASH_PRIME);
+    // 2 independent chains of 4 lanes
+    __m128i h0 = _mm_loadu_si128((const __m128i *) state);
+    __m128i h1 = _mm_loadu_si128((const __m128i *) (state + 4));
+    for (size_t i = 0; i < count; ++i) {
+        const __m128i *p = (const __m128i *) data;
+        h0 = sc_yuv_hash_step_sse41(h0, _mm_loadu_si128(p), prime);
+        h1 = sc_yuv_hash_step_sse41(h1, _mm_loadu_si128(p + 1), prime);
+        data += SC_YUV_HASH_BLOCK_SIZE;
+    }
+    _mm_storeu_si128((__m128i *) state, h0);
+    _mm_storeu_si128((__m128i *) (state + 4), h1);
+}
+
+/* AVX2 implementation (the YUV to RGB conversion, the transposition and the
+ * row hash use the SSE4.1 ones) */
+
+SC_TARGET("avx2") static void
+sc_yuv_interleave_uv_avx2(uint8_t *dst, const uint8_t *u, const uint8_t *v,
+                          size_t count) {
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i uu = _mm256_loadu_si256((const __m256i *) (u + i));
+        __m256i vv = _mm256_loadu_si256((const __m256i *) (v + i));
+        // unpack works within 128-bit lanes, reorder the lanes afterwards
+        __m256i lo = _mm256_unpacklo_epi8(uu, vv);
+        __m256i hi = _mm256_unpackhi_epi8(uu, vv);
+        _mm256_storeu_si256((__m256i *) (dst + 2 * i),
+                            _mm256_permute2x128_si256(lo, hi, 0x20));
+        _mm256_storeu_si256((__m256i *) (dst + 2 * i + 32),
+                            _mm256_permute2x128_si256(lo, hi, 0x31));
+    }
+    sc_yuv_interleave_uv_sse41(dst + 2 * i, u + i, v + i, count - i);
+}
+
+SC_TARGET("avx2") static void
+sc_yuv_pack_yuyv_avx2(uint8_t *dst, const uint8_t *y, const uint8_t *u,
+                      const uint8_t *v, size_t width) {
+    size_t x = 0;
+    for (; x + 32 <= width; x += 32) {
+        __m256i yy = _mm256_loadu_si256((const __m256i *) (y + x));
+        __m128i uu = _mm_loadu_si128((const __m128i *) (u + x / 2));
+        __m128i vv = _mm_loadu_si128((const __m128i *) (v + x / 2));
+        // lane 0: chroma of pixels 0..15, lane 1: chroma of pixels 16..31
+        __m256i uv = _mm256_inserti128_si256(
+                _mm256_castsi128_si256(_mm_unpacklo_epi8(uu, vv)),
+                _mm_unpackhi_epi8(uu, vv), 1);
+        __m256i lo = _mm256_unpacklo_epi8(yy, uv);
+        __m256i hi = _mm256_unpackhi_epi8(yy, uv);
+        _mm256_storeu_si256((__m256i *) (dst + 2 * x),
+                            _mm256_permute2x128_si256(lo, hi, 0x20));
+        _mm256_storeu_si256((__m256i *) (dst + 2 * x + 32),
+                            _mm256_permute2x128_si256(lo, hi, 0x31));
+    }
+    sc_yuv_pack_yuyv_sse41(dst + 2 * x, y + x, u + x / 2, v + x / 2,
+                           width - x);
+}
+
+SC_TARGET("avx2") static void
+sc_yuv_downscale_2x_avx2(uint8_t *dst, const uint8_t *row0,
+                         const uint8_t *row1, size_t dst_width) {
+    const __m256i ones = _mm256_set1_epi8(1);
+    const __m256i two = _mm256_set1_epi16(2);
+    size_t i = 0;
+    for (; i + 32 <= dst_width; i += 32) {
+        const __m256i *p0 = (const __m256i *) (row0 + 2 * i);
+        const __m256i *p1 = (const __m256i *) (row1 + 2 * i);
+        __m256i a = _mm256_maddubs_epi16(_mm256_loadu_si256(p0), ones);
+        __m256i b = _mm256_maddubs_epi16(_mm256_loadu_si256(p0 + 1), ones);
+        __m256i c = _mm256_maddubs_epi16(_mm256_loadu_si256(p1), ones);
+        __m256i d = _mm256_maddubs_epi16(_mm256_loadu_si256(p1 + 1), ones);
+        __m256i lo = _mm256_srli_epi16(
+                _mm256_add_epi16(_mm256_add_epi16(a, c), two), 2);
+        __m256i hi = _mm256_srli_epi16(
+                _mm256_add_epi16(_mm256_add_epi16(b, d), two), 2);
+        // packus works within 128-bit lanes, restore the order of the 64-bit
+        // blocks
+        __m256i packed = _mm256_packus_epi16(lo, hi);
+        _mm256_storeu_si256((__m256i *) (dst + i),
+                            _mm256_permute4x64_epi64(packed, 0xD8));
+    }
+    sc_yuv_downscale_2x_sse41(dst + i, row0 + 2 * i, row1 + 2 * i,
+                              dst_width - i);
+}
+
+SC_TARGET("avx2") static void
+sc_yuv_reverse_row_avx2(uint8_t *dst, const uint8_t *src, size_t width) {
+    // shuffle works within 128-bit lanes, swap the lanes afterwards
+    const __m256i reverse = _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8,
+                                             7, 6, 5, 4, 3, 2, 1, 0,
+                                             15, 14, 13, 12, 11, 10, 9, 8,
+                                             7, 6, 5, 4, 3, 2, 1, 0);
+    size_t x = 0;
+    for (; x + 32 <= width; x += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)
+                                       (src + width - x - 32));
+        v = _mm256_shuffle_epi8(v, reverse);
+        _mm256_storeu_si256((__m256i *) (dst + x),
+                            _mm256_permute4x64_epi64(v, 0x4E));
+    }
+    sc_yuv_reverse_row_sse41(dst + x, src, width - x);
+}
+
+#endif // SC_YUV_X86
+
+#ifdef SC_YUV_NEON
+
+/* NEON implementation */
+
+static void
+sc_yuv_interleave_uv_neon(uint8_t *dst, const uint8_t *u, const uint8_t *v,
+                          size_t count) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        uint8x16x2_t uv;
+        uv.val[0] = vld1q_u8(u + i);
+        uv.val[1] = vld1q_u8(v + i);
+        vst2q_u8(dst + 2 * i, uv);
+    }
+    sc_yuv_interleave_uv_c(dst + 2 * i, u + i, v + i, count - i);
+}
+
+static void
+sc_yuv_pack_yuyv_neon(uint8_t *dst, const uint8_t *y, const uint8_t *u,
+                      const uint8_t *v, size_t width) {
+    size_t x = 0;
+    for (; x + 16 <= width; x += 16) {
+        uint8x8x2_t yy = vld2_u8(y + x); // even and odd samples
+        uint8x8x4_t yuyv;
+        yuyv.val[0] = yy.val[0];
+        yuyv.val[1] = vld1_u8(u + x / 2);
+        yuyv.val[2] = yy.val[1];
+        yuyv.val[3] = vld1_u8(v + x / 2);
+        vst4_u8(dst + 2 * x, yuyv);
+    }
+    sc_yuv_pack_yuyv_c(dst + 2 * x, y + x, u + x / 2, v + x / 2, width - x);
+}
+
+static inline uint8x8_t
+sc_yuv_narrow_neon(int32x4_t lo, int32x4_t hi) {
+    int16x8_t v = vcombine_s16(vqmovn_s32(vshrq_n_s32(lo, 16)),
+                               vqmovn_s32(vshrq_n_s32(hi, 16)));
+    return vqmovun_s16(v);
+}
+
+static inline void
+sc_yuv_to_bgra8_neon(uint8_t *dst, uint8x8_t y8, uint8x8_t u8, uint8x8_t v8,
+                     const struct sc_yuv_coeffs *c) {
+    int16x8_t y16 = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(y8)),
+                              vdupq_n_s16(c->y_offset));
+    int16x8_t u16 = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(u8)),
+                              vdupq_n_s16(c->uv_offset));
+    int16x8_t v16 = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(v8)),
+                              vdupq_n_s16(c->uv_offset));
+
+    int32x4_t round = vdupq_n_s32(1 << 15);
+    int32x4_t ylo = vmlaq_n_s32(round, vmovl_s16(vget_low_s16(y16)), c->y_mul);
+    int32x4_t yhi = vmlaq_n_s32(round, vmovl_s16(vget_high_s16(y16)),
+                                c->y_mul);
+    int32x4_t ulo = vmovl_s16(vget_low_s16(u16));
+    int32x4_t uhi = vmovl_s16(vget_high_s16(u16));
+    int32x4_t vlo = vmovl_s16(vget_low_s16(v16));
+    int32x4_t vhi = vmovl_s16(vget_high_s16(v16));
+
+    uint8x8x4_t bgra;
+    bgra.val[0] = sc_yuv_narrow_neon(vmlaq_n_s32(ylo, ulo, c->u_to_b),
+                                     vmlaq_n_s32(yhi, uhi, c->u_to_b));
+    bgra.val[1] = sc_yuv_narrow_neon(
+            vmlsq_n_s32(vmlsq_n_s32(ylo, ulo, c->u_to_g), vlo, c->v_to_g),
+            vmlsq_n_s32(vmlsq_n_s32(yhi, uhi, c->u_to_g), vhi, c->v_to_g));
+    bgra.val[2] = sc_yuv_narrow_neon(vmlaq_n_s32(ylo, vlo, c->v_to_r),
+                                     vmlaq_n_s32(yhi, vhi, c->v_to_r));
+    bgra.val[3] = vdup_n_u8(0xFF);
+    vst4_u8(dst, bgra);
+}
+
+static void
+sc_yuv_to_bgra_neon(uint8_t *dst, const uint8_t *y, const uint8_t *u,
+                    const uint8_t *v, size_t width,
+                    const struct sc_yuv_coeffs *c) {
+    size_t x = 0;
+    for (; x + 16 <= width; x += 16) {
+        uint8x16_t yy = vld1q_u8(y + x);
+        // duplicate each chroma sample horizontally
+        uint8x8_t u8 = vld1_u8(u + x / 2);
+        uint8x8_t v8 = vld1_u8(v + x / 2);
+        uint8x8x2_t uu = vzip_u8(u8, u8);
+        uint8x8x2_t vv = vzip_u8(v8, v8);
+        sc_yuv_to_bgra8_neon(dst + 4 * x, vget_low_u8(yy), uu.val[0],
+                             vv.val[0], c);
+        sc_yuv_to_bgra8_neon(dst + 4 * x + 32, vget_high_u8(yy), uu.val[1],
+                             vv.val[1], c);
+    }
+    sc_yuv_to_bgra_c(dst + 4 * x, y + x, u + x / 2, v + x / 2, width - x, c);
+}
+
+static void
+sc_yuv_downscale_2x_neon(uint8_t *dst, const uint8_t *row0,
+                         const uint8_t *row1, size_t dst_width) {
+    size_t i = 0;
+    for (; i + 16 <= dst_width; i += 16) {
+        // Horizontal sums of pairs (16-bit)
+        uint16x8_t a = vpaddlq_u8(vld1q_u8(row0 + 2 * i));
+        uint16x8_t b = vpaddlq_u8(vld1q_u8(row0 + 2 * i + 16));
+        uint16x8_t c = vpaddlq_u8(vld1q_u8(row1 + 2 * i));
+        uint16x8_t d = vpaddlq_u8(vld1q_u8(row1 + 2 * i + 16));
+        // Rounding shift: (sum + 2) >> 2
+        uint8x16_t out = vcombine_u8(vrshrn_n_u16(vaddq_u16(a, c), 2),
+                                     vrshrn_n_u16(vaddq_u16(b, d), 2));
+        vst1q_u8(dst + i, out);
+    }
+    sc_yuv_downscale_2x_c(dst + i, row0 + 2 * i, row1 + 2 * i, dst_width - i);
+}
+
+static void
+sc_yuv_transpose_neon(uint8_t *dst, ptrdiff_t dst_stride, const uint8_t *src,
+                      ptrdiff_t src_stride, size_t width, size_t height) {
+    // 8x8 blocks, transposed by exchanging 8-, 16- then 32-bit elements
+    for (size_t y = 0; y + 8 <= height; y += 8) {
+        const uint8_t *s = src + (ptrdiff_t) y * src_stride;
+        for (size_t x = 0; x + 8 <= width; x += 8) {
+            uint8x8_t r[8];
+            for (int i = 0; i < 8; ++i) {
+                r[i] = vld1_u8(s + i * src_stride + x);
+            }
+
+            // even and odd columns of pairs of rows
+            uint8x8x2_t t0 = vtrn_u8(r[0], r[1]);
+            uint8x8x2_t t1 = vtrn_u8(r[2], r[3]);
+            uint8x8x2_t t2 = vtrn_u8(r[4], r[5]);
+            uint8x8x2_t t3 = vtrn_u8(r[6], r[7]);
+
+            // columns (0, 4), (2, 6), (1, 5) and (3, 7) of 4 rows
+            uint16x4x2_t u0 = vtrn_u16(vreinterpret_u16_u8(t0.val[0]),
+                                       vreinterpret_u16_u8(t1.val[0]));
+            uint16x4x2_t u1 = vtrn_u16(vreinterpret_u16_u8(t0.val[1]),
+                                       vreinterpret_u16_u8(t1.val[1]));
+            uint16x4x2_t u2 = vtrn_u16(vreinterpret_u16_u8(t2.val[0]),
+                                       vreinterpret_u16_u8(t3.val[0]));
+            uint16x4x2_t u3 = vtrn_u16(vreinterpret_u16_u8(t2.val[1]),
+                                       vreinterpret_u16_u8(t3.val[1]));
+
+            // columns (0, 4), (1, 5), (2, 6) and (3, 7) of the 8 rows
+            uint32x2x2_t v[4] = {
+                vtrn_u32(vreinterpret_u32_u16(u0.val[0]),
+                         vreinterpret_u32_u16(u2.val[0])),
+                vtrn_u32(vreinterpret_u32_u16(u1.val[0]),
+                         vreinterpret_u32_u16(u3.val[0])),
+                vtrn_u32(vreinterpret_u32_u16(u0.val[1]),
+                         vreinterpret_u32_u16(u2.val[1])),
+                vtrn_u32(vreinterpret_u32_u16(u1.val[1]),
+                         vreinterpret_u32_u16(u3.val[1])),
+            };
+
+            uint8_t *d = dst + (ptrdiff_t) x * dst_stride + y;
+            for (int i = 0; i < 4; ++i) {
+                vst1_u8(d + i * dst_stride, vreinterpret_u8_u32(v[i].val[0]));
+                vst1_u8(d + (i + 4) * dst_stride,
+                        vreinterpret_u8_u32(v[i].val[1]));
+            }
+        }
+    }
+    sc_yuv_transpose_tails(dst, dst_stride, src, src_stride, width, height, 8);
+}
+
+static void
+sc_yuv_reverse_row_neon(uint8_t *dst, const uint8_t *src, size_t width) {
+    size_t x = 0;
+    for (; x + 16 <= width; x += 16) {
+        // reverse each 64-bit half, then swap the halves
+        uint8x16_t v = vrev64q_u8(vld1q_u8(src + width - x - 16));
+        vst1q_u8(dst + x, vcombine_u8(vget_high_u8(v), vget_low_u8(v)));
+    }
+    sc_yuv_reverse_row_c(dst + x, src, width - x);
+}
+
+static inline uint32x4_t
+sc_yuv_hash_step_neon(uint32x4_t h, uint32x4_t w, uint32x4_t prime) {
+    h = vmulq_u32(veorq_u32(h, w), prime);
+    return vsriq_n_u32(vshlq_n_u32(h, SC_YUV_HASH_ROTATION), h,
+                       32 - SC_YUV_HASH_ROTATION);
+}
+
+static void
+sc_yuv_hash_blocks_neon(uint32_t *state, const uint8_t *data, size_t count) {
+    const uint32x4_t prime = vdupq_n_u32(SC_YUV_HASH_PRIME);
+    uint32x4_t h0 = vld1q_u32(state);
+    uint32x4_t h1 = vld1q_u32(state + 4);
+    for (size_t i = 0; i < count; ++i) {
+        uint32x4_t w0 = vreinterpretq_u32_u8(vld1q_u8(data));
+        uint32x4_t w1 = vreinterpretq_u32_u8(vld1q_u8(data + 16));
+        h0 = sc_yuv_hash_step_neon(h0, w0, prime);
+        h1 = sc_yuv_hash_step_neon(h1, w1, prime);
+        data += SC_YUV_HASH_BLOCK_SIZE;
+    }
+    vst1q_u32(state, h0);
+    vst1q_u32(state + 4, h1);
+}
+
+#endif // SC_YUV_NEON
+
+struct sc_yuv_impl {
+    const char *name;
+    void (*interleave_uv)(uint8_t *dst, const uint8_t *u, const uint8_t *v,
+                          size_t count);
+    void (*pack_yuyv)(uint8_t *dst, const uint8_t *y, const uint8_t *u,
+                      const uint8_t *v, size_t width);
+    void (*to_bgra)(uint8_t *dst, const uint8_t *y, const uint8_t *u,
+                    const uint8_t *v, size_t width,
+                    const struct sc_yuv_coeffs *coeffs);
+    void (*downscale_2x)(uint8_t *dst, const uint8_t *row0,
+                         const uint8_t *row1, size_t dst_width);
+    void (*transpose)(uint8_t *dst, ptrdiff_t dst_stride, const uint8_t *src,
+                      ptrdiff_t src_stride, size_t width, size_t height);
+    void (*reverse_row)(uint8_t *dst, const uint8_t *src, size_t width);
+    void (*hash_blocks)(uint32_t *state, const uint8_t *data, size_t count);
+};
+
+static const struct sc_yuv_impl SC_YUV_IMPL_C = {
+    .name = "scalar",
+    .interleave_uv = sc_yuv_interleave_uv_c,
+    .pack_yuyv = sc_yuv_pack_yuyv_c,
+    .to_bgra = sc_yuv_to_bgra_c,
+    .downscale_2x = sc_yuv_downscale_2x_c,
+    .transpose = sc_yuv_transpose_c,
+    .reverse_row = sc_yuv_reverse_row_c,
+    .hash_blocks = sc_yuv_hash_blocks_c,
+};
+
+#ifdef SC_YUV_X86
+static const struct sc_yuv_impl SC_YUV_IMPL_SSE41 = {
+    .name = "SSE4.1",
+    .interleave_uv = sc_yuv_interleave_uv_sse41,
+    .pack_yuyv = sc_yuv_pack_yuyv_sse41,
+    .to_bgra = sc_yuv_to_bgra_sse41,
+    .downscale_2x = sc_yuv_downscale_2x_sse41,
+    .transpose = sc_yuv_transpose_sse41,
+    .reverse_row = sc_yuv_reverse_row_sse41,
+    .hash_blocks = sc_yuv_hash_blocks_sse41,
+};
+
+static const struct sc_yuv_impl SC_YUV_IMPL_AVX2 = {
+    .name = "AVX2",
+    .interleave_uv = sc_yuv_interleave_uv_avx2,
+    .pack_yuyv = sc_yuv_pack_yuyv_avx2,
+    .to_bgra = sc_yuv_to_bgra_sse41,
+    .downscale_2x = sc_yuv_downscale_2x_avx2,
+    .transpose = sc_yuv_transpose_sse41,
+    .reverse_row = sc_yuv_reverse_row_avx2,
+    .hash_blocks = sc_yuv_hash_blocks_sse41,
+};
+#endif
+
+#ifdef SC_YUV_NEON
+static const struct sc_yuv_impl SC_YUV_IMPL_NEON = {
+    .name = "NEON",
+    .interleave_uv = sc_yuv_interleave_uv_neon,
+    .pack_yuyv = sc_yuv_pack_yuyv_neon,
+    .to_bgra = sc_yuv_to_bgra_neon,
+    .downscale_2x = sc_yuv_downscale_2x_neon,
+    .transpose = sc_yuv_transpose_neon,
+    .reverse_row = sc_yuv_reverse_row_neon,
+    .hash_blocks = sc_yuv_hash_blocks_neon,
+};
+#endif
+
+// Usable even if sc_yuv_init() has not been called
+static const struct sc_yuv_impl *sc_yuv_impl = &SC_YUV_IMPL_C;
+
+void
+sc_yuv_init(void) {
+#if defined(SC_YUV_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        sc_yuv_impl = &SC_YUV_IMPL_AVX2;
+    } else if (__builtin_cpu_supports("sse4.1")) {
+        sc_yuv_impl = &SC_YUV_IMPL_SSE41;
+    } else {
+        sc_yuv_impl = &SC_YUV_IMPL_C;
+    }
+#elif defined(SC_YUV_NEON)
+    sc_yuv_impl = &SC_YUV_IMPL_NEON;
+#endif
+}
+
+const char *
+sc_yuv_get_impl_name(void) {
+    return sc_yuv_impl->name;
+}
+
+void
+sc_yuv_interleave_uv(uint8_t *dst, const uint8_t *u, const uint8_t *v,
+                     size_t count) {
+    sc_yuv_impl->interleave_uv(dst, u, v, count);
+}
+
+void
+sc_yuv_pack_yuyv(uint8_t *dst, const uint8_t *y, const uint8_t *u,
+                 const uint8_t *v, size_t width) {
+    assert(!(width % 2));
+    sc_yuv_impl->pack_yuyv(dst, y, u, v, width);
+}
+
+void
+sc_yuv_to_bgra(uint8_t *dst, const uint8_t *y, const uint8_t *u,
+               const uint8_t *v, size_t width,
+               const struct sc_yuv_coeffs *coeffs) {
+    sc_yuv_impl->to_bgra(dst, y, u, v, width, coeffs);
+}
+
+void
+sc_yuv_downscale_2x(uint8_t *dst, const uint8_t *row0, const uint8_t *row1,
+                    size_t dst_width) {
+    sc_yuv_impl->downscale_2x(dst, row0, row1, dst_width);
+}
+
+void
+sc_yuv_transpose(uint8_t *dst, ptrdiff_t dst_stride, const uint8_t *src,
+                 ptrdiff_t src_stride, size_t width, size_t height) {
+    sc_yuv_impl->transpose(dst, dst_stride, src, src_stride, width, height);
+}
+
+void
+sc_yuv_reverse_row(uint8_t *dst, const uint8_t *src, size_t width) {
+    sc_yuv_impl->reverse_row(dst, src, width);
+}
+
+void
+sc_yuv_hash_init(uint32_t *state) {
+    for (unsigned k = 0; k < SC_YUV_HASH_LANES; ++k) {
+        // Distinct initial values, so that the lanes are not symmetric
+        state[k] = SC_YUV_HASH_PRIME * (k + 1);
+    }
+}
+
+void
+sc_yuv_hash_row(uint32_t *state, const uint8_t *data, size_t len) {
+    size_t count = len / SC_YUV_HASH_BLOCK_SIZE;
+    sc_yuv_impl->hash_blocks(state, data, count);
+
+    size_t remaining = len % SC_YUV_HASH_BLOCK_SIZE;
+    if (remaining) {
+        // Pad the last block with zeros
+        uint8_t block[SC_YUV_HASH_BLOCK_SIZE] = {0};
+        memcpy(block, data + count * SC_YUV_HASH_BLOCK_SIZE, remaining);
+        sc_yuv_impl->hash_blocks(state, block, 1);
+    }
+}
+
+uint64_t
+sc_yuv_hash_final(const uint32_t *state) {
+    uint64_t h = 0;
+    for (unsigned k = 0; k < SC_YUV_HASH_LANES; ++k) {
+        h = (h ^ state[k]) * UINT64_C(0x9E3779B97F4A7C15);
+        h ^= h >> 32;
+    }
+    return h;
+}
@@ -0,0 +1,139 @@
+#ifndef SC_YUV_H
+#define SC_YUV_H
+
+#include "common.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Pixel conversion and scaling kernels for I420 (YUV420P) frames
+ *
+ * The kernels process one row at a time, so that the caller controls the
+ * strides (and may write directly into a mapped buffer).
+ *
+ * Depending on the CPU, they are implemented with AVX2, SSE4.1 or NEON, with
+ * a scalar fallback. sc_yuv_init() must be called once before using them.
+ */
+
+/**
+ * Fixed-point (Q16) coefficients for the YUV to RGB conversion
+ */
+struct sc_yuv_coeffs {
+    int32_t y_offset;
+    int32_t uv_offset;
+    int32_t y_mul;
+    int32_t v_to_r;
+    int32_t u_to_g;
+    int32_t v_to_g;
+    int32_t u_to_b;
+};
+
+/**
+ * Get the coefficients for BT.601 or BT.709, in limited or full range
+ */
+const struct sc_yuv_coeffs *
+sc_yuv_get_coeffs(bool bt709, bool full_range);
+
+/**
+ * Detect the CPU features and select the kernels
+ *
+ * It may be called several times, but not concurrently with the other
+ * functions.
+ */
+void
+sc_yuv_init(void);
+
+/**
+ * Return the name of the selected implementation (for logging)
+ */
+const char *
+sc_yuv_get_impl_name(void);
+
+/**
+ * Interleave `count` U and V samples (NV12 chroma row)
+ *
+ * `dst` receives 2 * count bytes.
+ */
+void
+sc_yuv_interleave_uv(uint8_t *dst, const uint8_t *u, const uint8_t *v,
+                     size_t count);
+
+/**
+ * Pack a row of `width` pixels (which must be even) as YUYV
+ *
+ * `u` and `v` contain width / 2 samples; `dst` receives 2 * width bytes.
+ */
+void
+sc_yuv_pack_yuyv(uint8_t *dst, const uint8_t *y, const uint8_t *u,
+                 const uint8_t *v, size_t width);
+
+/**
+ * Convert a row of `width` pixels to BGRA (B, G, R, A in memory order)
+ *
+ * `u` and `v` contain (width + 1) / 2 samples; `dst` receives 4 * width bytes.
+ */
+void
+sc_yuv_to_bgra(uint8_t *dst, const uint8_t *y, const uint8_t *u,
+               const uint8_t *v, size_t width,
+               const struct sc_yuv_coeffs *coeffs);
+
+/**
+ * Downscale 2 rows of 2 * `dst_width` samples into 1 row of `dst_width`
+ * samples (2x2 box filter, rounded)
+ */
+void
+sc_yuv_downscale_2x(uint8_t *dst, const uint8_t *row0, const uint8_t *row1,
+                    size_t dst_width);
+
+/**
+ * Transpose a plane of `width` x `height` 8-bit samples
+ *
+ * The sample at (x, y) in `src` is written at (y, x) in `dst`, so `dst` must
+ * have `width` rows of `height` samples. The strides may be negative, to
+ * traverse the rows in reverse order (this flips the result vertically or
+ * horizontally).
+ */
+void
+sc_yuv_transpose(uint8_t *dst, ptrdiff_t dst_stride, const uint8_t *src,
+                 ptrdiff_t src_stride, size_t width, size_t height);
+
+/**
+ * Reverse the order of `width` samples (horizontal flip of a row)
+ *
+ * `dst` and `src` must not overlap.
+ */
+void
+sc_yuv_reverse_row(uint8_t *dst, const uint8_t *src, size_t width);
+
+/**
+ * Number of 32-bit lanes of a row hash state
+ */
+#define SC_YUV_HASH_LANES 8
+
+/**
+ * Initialize a row hash state of SC_YUV_HASH_LANES lanes
+ */
+void
+sc_yuv_hash_init(uint32_t *state);
+
+/**
+ * Accumulate `len` bytes into a row hash state
+ *
+ * The data is processed by blocks of 32 bytes (one 32-bit word per lane), the
+ * last one being padded with zeros. The result is the same for all the
+ * implementations.
+ *
+ * This is a fast non-cryptographic hash, to detect changes between frames.
+ */
+void
+sc_yuv_hash_row(uint32_t *state, const uint8_t *data, size_t len);
+
+/**
+ * Compute the 64-bit hash of a row hash state
+ */
+uint64_t
+sc_yuv_hash_final(const uint32_t *state);
+
+#endif
@@ -0,0 +1,404 @@
+#include "v4l2_output.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <linux/videodev2.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <libavutil/pixfmt.h>
+
+#include "util/log.h"
+#include "util/yuv.h"
+
+static int
+xioctl(int fd, unsigned long request, void *arg) {
+    int r;
+    do {
+        r = ioctl(fd, request, arg);
+    } while (r == -1 && errno == EINTR);
+    return r;
+}
+
+static uint32_t
+sc_v4l2_output_get_fourcc(enum sc_v4l2_pixel_format pixel_format) {
+    switch (pixel_format) {
+        case SC_V4L2_PIXEL_FORMAT_NV12:
+            return V4L2_PIX_FMT_NV12;
+        case SC_V4L2_PIXEL_FORMAT_YUYV:
+            return V4L2_PIX_FMT_YUYV;
+        default:
+            assert(pixel_format == SC_V4L2_PIXEL_FORMAT_YUV420P);
+            return V4L2_PIX_FMT_YUV420;
+    }
+}
+
+bool
+sc_v4l2_output_open(struct sc_v4l2_output *output, const char *device_name,
+                    enum sc_v4l2_pixel_format pixel_format) {
+    output->fd = open(device_name, O_RDWR | O_CLOEXEC);
+    if (output->fd == -1) {
+        LOGE("Could not open V4L2 device %s: %s", device_name,
+             strerror(errno));
+        return false;
+    }
+
+    struct v4l2_capability cap;
+    memset(&cap, 0, sizeof(cap));
+    if (xioctl(output->fd, VIDIOC_QUERYCAP, &cap)) {
+        LOGE("Could not query V4L2 device capabilities: %s", strerror(errno));
+        goto error_close;
+    }
+
+    uint32_t caps = cap.capabilities & V4L2_CAP_DEVICE_CAPS ? cap.device_caps
+                                                            : cap.capabilities;
+    if (!(caps & V4L2_CAP_VIDEO_OUTPUT)) {
+        LOGE("V4L2 device %s is not a video output device", device_name);
+        goto error_close;
+    }
+    if (!(caps & V4L2_CAP_STREAMING)) {
+        LOGE("V4L2 device %s does not support streaming I/O", device_name);
+        goto error_close;
+    }
+
+    output->pixel_format = pixel_format;
+    output->width = 0;
+    output->height = 0;
+    output->bytesperline = 0;
+    output->sizeimage = 0;
+    output->buffer_count = 0;
+    output->queued_count = 0;
+    output->streaming = false;
+
+    return true;
+
+error_close:
+    close(output->fd);
+
+    return false;
+}
+
+static void
+sc_v4l2_output_release_buffers(struct sc_v4l2_output *output) {
+    if (output->streaming) {
+        enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_OUTPUT;
+        if (xioctl(output->fd, VIDIOC_STREAMOFF, &type)) {
+            LOGW("Could not stop V4L2 streaming: %s", strerror(errno));
+        }
+        output->streaming = false;
+    }
+
+    for (unsigned i = 0; i < output->buffer_count; ++i) {
+        munmap(output->buffers[i].data, output->buffers[i].length);
+    }
+
+    if (output->buffer_count) {
+        struct v4l2_requestbuffers req;
+        memset(&req, 0, sizeof(req));
+        req.count = 0;
+        req.type = V4L2_BUF_TYPE_VIDEO_OUTPUT;
+        req.memory = V4L2_MEMORY_MMAP;
+        if (xioctl(output->fd, VIDIOC_REQBUFS, &req)) {
+            LOGW("Could not release V4L2 buffers: %s", strerror(errno));
+        }
+    }
+
+    output->buffer_count = 0;
+    output->queued_count = 0;
+}
+
+static bool
+sc_v4l2_output_configure(struct sc_v4l2_output *output, unsigned width,
+                         unsigned height) {
+    sc_v4l2_output_release_buffers(output);
+
+    struct v4l2_format fmt;
+    memset(&fmt, 0, sizeof(fmt));
+    fmt.type = V4L2_BUF_TYPE_VIDEO_OUTPUT;
+    fmt.fmt.pix.width = width;
+    fmt.fmt.pix.height = height;
+    fmt.fmt.pix.pixelformat = sc_v4l2_output_get_fourcc(output->pixel_format);
+    fmt.fmt.pix.field = V4L2_FIELD_NONE;
+    fmt.fmt.pix.colorspace = V4L2_COLORSPACE_REC709;
+    if (output->pixel_format == SC_V4L2_PIXEL_FORMAT_YUYV) {
+        if (width % 2) {
+            LOGE("YUYV requires an even width (got %u)", width);
+            return false;
+        }
+        fmt.fmt.pix.bytesperline = width * 2;
+        fmt.fmt.pix.sizeimage = width * 2 * height;
+    } else {
+        // YUV420 and NV12: one full size luma plane + 2 chroma planes (or an
+        // interleaved one) subsampled by 2 in both directions, rounded up for
+        // odd sizes
+        unsigned chroma_width = (width + 1) / 2;
+        unsigned chroma_height = (height + 1) / 2;
+        fmt.fmt.pix.bytesperline = width;
+        fmt.fmt.pix.sizeimage =
+            width * height + 2 * chroma_width * chroma_height;
+    }
+
+    if (xioctl(output->fd, VIDIOC_S_FMT, &fmt)) {
+        LOGE("Could not set V4L2 format %ux%u: %s", width, height,
+             strerror(errno));
+        return false;
+    }
+
+    if (fmt.fmt.pix.width != width || fmt.fmt.pix.height != height) {
+        LOGE("V4L2 device refused size %ux%u (got %ux%u)", width, height,
+             fmt.fmt.pix.width, fmt.fmt.pix.height);
+        return false;
+    }
+
+    if (output->pixel_format != SC_V4L2_PIXEL_FORMAT_YUYV) {
+        // The chroma planes are written with a stride of (bytesperline + 1) / 2
+        size_t bytesperline = fmt.fmt.pix.bytesperline;
+        size_t needed = bytesperline * height
+                      + 2 * ((bytesperline + 1) / 2) * ((height + 1) / 2);
+        if (fmt.fmt.pix.sizeimage < needed) {
+            LOGE("V4L2 image size too small: %u < %zu",
+                 fmt.fmt.pix.sizeimage, needed);
+            return false;
+        }
+    }
+
+    output->width = width;
+    output->height = height;
+    output->bytesperline = fmt.fmt.pix.bytesperline;
+    output->sizeimage = fmt.fmt.pix.sizeimage;
+
+    struct v4l2_requestbuffers req;
+    memset(&req, 0, sizeof(req));
+    req.count = SC_V4L2_OUTPUT_BUFFER_COUNT;
+    req.type = V4L2_BUF_TYPE_VIDEO_OUTPUT;
+    req.memory = V4L2_MEMORY_MMAP;
+    if (xioctl(output->fd, VIDIOC_REQBUFS, &req)) {
+        LOGE("Could not request V4L2 buffers: %s", strerror(errno));
+        return false;
+    }
+
+    if (!req.count) {
+        LOGE("V4L2 device did not allocate any buffer");
+        return false;
+    }
+
+    unsigned count = MIN(req.count, SC_V4L2_OUTPUT_BUFFER_COUNT);
+    for (unsigned i = 0; i < count; ++i) {
+        struct v4l2_buffer buf;
+        memset(&buf, 0, sizeof(buf));
+        buf.index = i;
+        buf.type = V4L2_BUF_TYPE_VIDEO_OUTPUT;
+        buf.memory = V4L2_MEMORY_MMAP;
+        if (xioctl(output->fd, VIDIOC_QUERYBUF, &buf)) {
+            LOGE("Could not query V4L2 buffer: %s", strerror(errno));
+            goto error;
+        }
+
+        if (buf.length < output->sizeimage) {
+            LOGE("V4L2 buffer too small: %u < %u", buf.length,
+                 output->sizeimage);
+            goto error;
+        }
+
+        void *data = mmap(NULL, buf.length, PROT_READ | PROT_WRITE,
+                          MAP_SHARED, output->fd, buf.m.offset);
+        if (data == MAP_FAILED) {
+            LOGE("Could not map V4L2 buffer: %s", strerror(errno));
+            goto error;
+        }
+
+        output->buffers[i].data = data;
+        output->buffers[i].length = buf.length;
+        ++output->buffer_count;
+    }
+
+    LOGI("V4L2 output: %ux%u, %u buffers", width, height,
+         output->buffer_count);
+
+    return true;
+
+error:
+    sc_v4l2_output_release_buffers(output);
+    return false;
+}
+
+void
+sc_v4l2_output_close(struct sc_v4l2_output *output) {
+    sc_v4l2_output_release_buffers(output);
+    close(output->fd);
+}
+
+static void
+sc_copy_plane(uint8_t *dst, size_t dst_stride, const uint8_t *src,
+              size_t src_stride, size_t width, size_t height) {
+    if (dst_stride == src_stride && dst_stride == width) {
+        memcpy(dst, src, width * height);
+        return;
+    }
+
+    for (size_t y = 0; y < height; ++y) {
+        memcpy(dst + y * dst_stride, src + y * src_stride, width);
+    }
+}
+
+static void
+sc_v4l2_output_write_yuv420p(struct sc_v4l2_output *output, uint8_t *dst,
+                             const AVFrame *frame) {
+    size_t w = output->width;
+    size_t h = output->height;
+    size_t cw = (w + 1) / 2;
+    size_t ch = (h + 1) / 2;
+    size_t stride = output->bytesperline;
+    size_t cstride = (stride + 1) / 2;
+
+    uint8_t *y = dst;
+    uint8_t *u = y + stride * h;
+    uint8_t *v = u + cstride * ch;
+
+    sc_copy_plane(y, stride, frame->data[0], frame->linesize[0], w, h);
+    sc_copy_plane(u, cstride, frame->data[1], frame->linesize[1], cw, ch);
+    sc_copy_plane(v, cstride, frame->data[2], frame->linesize[2], cw, ch);
+}
+
+static void
+sc_v4l2_output_write_nv12(struct sc_v4l2_output *output, uint8_t *dst,
+                          const AVFrame *frame) {
+    size_t w = output->width;
+    size_t h = output->height;
+    size_t cw = (w + 1) / 2;
+    size_t ch = (h + 1) / 2;
+    size_t stride = output->bytesperline;
+    // A row of interleaved U and V samples is wider than a luma row if the
+    // width is odd
+    size_t uvstride = (stride + 1) / 2 * 2;
+
+    sc_copy_plane(dst, stride, frame->data[0], frame->linesize[0], w, h);
+
+    uint8_t *uv = dst + stride * h;
+    if (frame->format == AV_PIX_FMT_NV12) {
+        // Already converted (by a frame transform)
+        sc_copy_plane(uv, uvstride, frame->data[1], frame->linesize[1], cw * 2,
+                      ch);
+        return;
+    }
+
+    // Interleave U and V
+    for (size_t y = 0; y < ch; ++y) {
+        sc_yuv_interleave_uv(uv + y * uvstride,
+                             frame->data[1] + y * frame->linesize[1],
+                             frame->data[2] + y * frame->linesize[2], cw);
+    }
+}
+
+static void
+sc_v4l2_output_write_yuyv(struct sc_v4l2_output *output, uint8_t *dst,
+                          const AVFrame *frame) {
+    size_t w = output->width;
+    size_t h = output->height;
+    size_t stride = output->bytesperline;
+
+    if (frame->format == AV_PIX_FMT_YUYV422) {
+        // Already converted (by a frame transform)
+        sc_copy_plane(dst, stride, frame->data[0], frame->linesize[0], w * 2,
+                      h);
+        return;
+    }
+
+    // The width is even (checked on configuration)
+    for (size_t y = 0; y < h; ++y) {
+        sc_yuv_pack_yuyv(dst + y * stride,
+                         frame->data[0] + y * frame->linesize[0],
+                         frame->data[1] + (y / 2) * frame->linesize[1],
+                         frame->data[2] + (y / 2) * frame->linesize[2], w);
+    }
+}
+
+static inline bool
+sc_v4l2_output_accepts(struct sc_v4l2_output *output, int format) {
+    if (format == AV_PIX_FMT_YUV420P) {
+        // Converted on the fly if necessary
+        return true;
+    }
+
+    switch (output->pixel_format) {
+        case SC_V4L2_PIXEL_FORMAT_NV12:
+            return format == AV_PIX_FMT_NV12;
+        case SC_V4L2_PIXEL_FORMAT_YUYV:
+            return format == AV_PIX_FMT_YUYV422;
+        default:
+            return false;
+    }
+}
+
+bool
+sc_v4l2_output_write(struct sc_v4l2_output *output, const AVFrame *frame) {
+    assert(sc_v4l2_output_accepts(output, frame->format));
+
+    unsigned width = frame->width;
+    unsigned height = frame->height;
+    if (width != output->width || height != output->height) {
+        if (!sc_v4l2_output_configure(output, width, height)) {
+            return false;
+        }
+    }
+
+    struct v4l2_buffer buf;
+    memset(&buf, 0, sizeof(buf));
+    buf.type = V4L2_BUF_TYPE_VIDEO_OUTPUT;
+    buf.memory = V4L2_MEMORY_MMAP;
+
+    if (output->queued_count < output->buffer_count) {
+        // This buffer has never been queued
+        buf.index = output->queued_count;
+    } else if (xioctl(output->fd, VIDIOC_DQBUF, &buf)) {
+        LOGE("Could not dequeue V4L2 buffer: %s", strerror(errno));
+        return false;
+    }
+
+    assert(buf.index < output->buffer_count);
+    uint8_t *dst = output->buffers[buf.index].data;
+
+    switch (output->pixel_format) {
+        case SC_V4L2_PIXEL_FORMAT_NV12:
+            sc_v4l2_output_write_nv12(output, dst, frame);
+            break;
+        case SC_V4L2_PIXEL_FORMAT_YUYV:
+            sc_v4l2_output_write_yuyv(output, dst, frame);
+            break;
+        default:
+            assert(output->pixel_format == SC_V4L2_PIXEL_FORMAT_YUV420P);
+            sc_v4l2_output_write_yuv420p(output, dst, frame);
+            break;
+    }
+
+    buf.bytesused = output->sizeimage;
+    buf.field = V4L2_FIELD_NONE;
+    buf.flags = V4L2_BUF_FLAG_TIMESTAMP_COPY;
+    if (frame->pts != AV_NOPTS_VALUE) {
+        // PTS (written by the server) are expressed in microseconds
+        buf.timestamp.tv_sec = frame->pts / 1000000;
+        buf.timestamp.tv_usec = frame->pts % 1000000;
+    }
+
+    if (xioctl(output->fd, VIDIOC_QBUF, &buf)) {
+        LOGE("Could not queue V4L2 buffer: %s", strerror(errno));
+        return false;
+    }
+
+    if (output->queued_count < output->buffer_count) {
+        ++output->queued_count;
+    }
+
+    if (!output->streaming) {
+        enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_OUTPUT;
+        if (xioctl(output->fd, VIDIOC_STREAMON, &type)) {
+            LOGE("Could not start V4L2 streaming: %s", strerror(errno));
+            return false;
+        }
+        output->streaming = true;
+    }
+
+    return true;
+}
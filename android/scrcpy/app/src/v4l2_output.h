@@ -0,0 +1,59 @@
+#ifndef SC_V4L2_OUTPUT_H
+#define SC_V4L2_OUTPUT_H
+
+#include "common.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <libavutil/frame.h>
+
+#include "options.h"
+
+#define SC_V4L2_OUTPUT_BUFFER_COUNT 4
+
+/**
+ * Direct output to a V4L2 device (typically v4l2loopback), via a queue of
+ * mmap()ed buffers.
+ *
+ * Decoded frames are converted (if necessary) while they are copied into the
+ * V4L2 buffers, without any intermediate encoder or muxer.
+ */
+struct sc_v4l2_output {
+    int fd;
+    enum sc_v4l2_pixel_format pixel_format;
+
+    // current format (0x0 until the first frame is written)
+    unsigned width;
+    unsigned height;
+    uint32_t bytesperline;
+    uint32_t sizeimage;
+
+    struct {
+        void *data;
+        size_t length;
+    } buffers[SC_V4L2_OUTPUT_BUFFER_COUNT];
+    unsigned buffer_count;
+    // Buffers are initially owned by the application; once they have all been
+    // queued, they must be dequeued before being reused
+    unsigned queued_count;
+    bool streaming;
+};
+
+bool
+sc_v4l2_output_open(struct sc_v4l2_output *output, const char *device_name,
+                    enum sc_v4l2_pixel_format pixel_format);
+
+void
+sc_v4l2_output_close(struct sc_v4l2_output *output);
+
+/**
+ * Write a YUV420P frame, or a frame already in the output pixel format
+ *
+ * The device format is (re)configured on the first frame and whenever the
+ * frame size changes.
+ */
+bool
+sc_v4l2_output_write(struct sc_v4l2_output *output, const AVFrame *frame);
+
+#endif
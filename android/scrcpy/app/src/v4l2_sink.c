@@ -8,6 +8,7 @@
 
 #include "util/log.h"
 #include "util/str.h"
+#include "util/yuv.h"
 
 /** Downcast frame_sink to sc_v4l2_sink */
 #define DOWNCAST(SINK) container_of(SINK, struct sc_v4l2_sink, frame_sink)
@@ -111,6 +112,91 @@ encode_and_write_frame(struct sc_v4l2_sink *vs, const AVFrame *frame) {
     return true;
 }
 
+static void
+orient_plane(uint8_t *dst, ptrdiff_t dst_stride, const uint8_t *src,
+             ptrdiff_t src_stride, size_t width, size_t height,
+             enum sc_orientation orientation) {
+    // The source plane is width x height; negative strides traverse the rows
+    // in reverse order (vertical flip)
+    const uint8_t *src_last = src + (ptrdiff_t) (height - 1) * src_stride;
+    uint8_t *dst_last_col = dst + (ptrdiff_t) (width - 1) * dst_stride;
+
+    switch (orientation) {
+        case SC_ORIENTATION_90:
+            sc_yuv_transpose(dst, dst_stride, src_last, -src_stride,
+                             width, height);
+            return;
+        case SC_ORIENTATION_270:
+            sc_yuv_transpose(dst_last_col, -dst_stride, src, src_stride,
+                             width, height);
+            return;
+        case SC_ORIENTATION_FLIP_90:
+            sc_yuv_transpose(dst_last_col, -dst_stride, src_last, -src_stride,
+                             width, height);
+            return;
+        case SC_ORIENTATION_FLIP_270:
+            sc_yuv_transpose(dst, dst_stride, src, src_stride, width, height);
+            return;
+        default:
+            break;
+    }
+
+    // The remaining orientations do not swap width and height
+    bool reverse = orientation == SC_ORIENTATION_180
+                || orientation == SC_ORIENTATION_FLIP_0;
+    bool vflip = orientation == SC_ORIENTATION_180
+              || orientation == SC_ORIENTATION_FLIP_180;
+    for (size_t y = 0; y < height; ++y) {
+        const uint8_t *s = src + (ptrdiff_t) y * src_stride;
+        uint8_t *d = dst + (ptrdiff_t) (vflip ? height - 1 - y : y)
+                         * dst_stride;
+        if (reverse) {
+            sc_yuv_reverse_row(d, s, width);
+        } else {
+            memcpy(d, s, width);
+        }
+    }
+}
+
+static bool
+sc_v4l2_sink_orient(struct sc_v4l2_sink *vs, const AVFrame *frame) {
+    assert(frame->format == AV_PIX_FMT_YUV420P);
+
+    bool swap = sc_orientation_is_swap(vs->orientation);
+    int width = swap ? frame->height : frame->width;
+    int height = swap ? frame->width : frame->height;
+
+    AVFrame *oriented = vs->oriented_frame;
+    if (oriented->width != width || oriented->height != height) {
+        // First frame, or the frame size changed
+        av_frame_unref(oriented);
+        oriented->format = AV_PIX_FMT_YUV420P;
+        oriented->width = width;
+        oriented->height = height;
+        if (av_frame_get_buffer(oriented, 0) < 0) {
+            LOG_OOM();
+            av_frame_unref(oriented);
+            return false;
+        }
+    }
+
+    // The previous frame may still be referenced by the encoder
+    if (av_frame_make_writable(oriented) < 0) {
+        LOG_OOM();
+        return false;
+    }
+
+    for (int i = 0; i < 3; ++i) {
+        // The chroma planes are subsampled by 2 in both directions
+        size_t w = i ? (frame->width + 1) / 2 : frame->width;
+        size_t h = i ? (frame->height + 1) / 2 : frame->height;
+        orient_plane(oriented->data[i], oriented->linesize[i], frame->data[i],
+                     frame->linesize[i], w, h, vs->orientation);
+    }
+
+    return av_frame_copy_props(oriented, frame) >= 0;
+}
+
 static int
 run_v4l2_sink(void *data) {
     struct sc_v4l2_sink *vs = data;
@@ -130,9 +216,22 @@ run_v4l2_sink(void *data) {
         vs->has_frame = false;
         sc_mutex_unlock(&vs->mutex);
 
-        sc_frame_buffer_consume(&vs->fb, vs->frame);
+        bool consumed = sc_frame_buffer_consume(&vs->fb, vs->frame, NULL);
+        assert(consumed);
+        (void) consumed;
+
+        const AVFrame *frame = vs->frame;
+        if (vs->orientation != SC_ORIENTATION_0) {
+            if (!sc_v4l2_sink_orient(vs, vs->frame)) {
+                LOGE("Could not orient v4l2 frame");
+                av_frame_unref(vs->frame);
+                break;
+            }
+            frame = vs->oriented_frame;
+        }
 
-        bool ok = encode_and_write_frame(vs, vs->frame);
+        bool ok = vs->direct ? sc_v4l2_output_write(&vs->output, frame)
+                             : encode_and_write_frame(vs, frame);
         av_frame_unref(vs->frame);
         if (!ok) {
             LOGE("Could not send frame to v4l2 sink");
@@ -146,25 +245,7 @@ run_v4l2_sink(void *data) {
 }
 
 static bool
-sc_v4l2_sink_open(struct sc_v4l2_sink *vs, const AVCodecContext *ctx) {
-    assert(ctx->pix_fmt == AV_PIX_FMT_YUV420P);
-    (void) ctx;
-
-    bool ok = sc_frame_buffer_init(&vs->fb);
-    if (!ok) {
-        return false;
-    }
-
-    ok = sc_mutex_init(&vs->mutex);
-    if (!ok) {
-        goto error_frame_buffer_destroy;
-    }
-
-    ok = sc_cond_init(&vs->cond);
-    if (!ok) {
-        goto error_mutex_destroy;
-    }
-
+sc_v4l2_sink_open_muxer(struct sc_v4l2_sink *vs, const AVCodecContext *ctx) {
     const AVOutputFormat *format = find_muxer("v4l2");
     if (!format) {
         // Alternative name
@@ -172,7 +253,7 @@ sc_v4l2_sink_open(struct sc_v4l2_sink *vs, const AVCodecContext *ctx) {
     }
     if (!format) {
         LOGE("Could not find v4l2 muxer");
-        goto error_cond_destroy;
+        return false;
     }
 
     const AVCodec *encoder = avcodec_find_encoder(AV_CODEC_ID_RAWVIDEO);
@@ -217,6 +298,12 @@ sc_v4l2_sink_open(struct sc_v4l2_sink *vs, const AVCodecContext *ctx) {
     // The codec is from the v4l2 encoder, not from the decoder
     ostream->codecpar->codec_id = encoder->id;
 
+    bool swap = sc_orientation_is_swap(vs->orientation);
+    int width = swap ? ctx->height : ctx->width;
+    int height = swap ? ctx->width : ctx->height;
+    ostream->codecpar->width = width;
+    ostream->codecpar->height = height;
+
     int ret = avio_open(&vs->format_ctx->pb, vs->device_name, AVIO_FLAG_WRITE);
     if (ret < 0) {
         LOGE("Failed to open output device: %s", vs->device_name);
@@ -230,9 +317,10 @@ sc_v4l2_sink_open(struct sc_v4l2_sink *vs, const AVCodecContext *ctx) {
         goto error_avio_close;
     }
 
-    vs->encoder_ctx->width = ctx->width;
-    vs->encoder_ctx->height = ctx->height;
-    vs->encoder_ctx->pix_fmt = AV_PIX_FMT_YUV420P;
+    vs->encoder_ctx->width = width;
+    vs->encoder_ctx->height = height;
+    // The frames may have been converted by a frame transform
+    vs->encoder_ctx->pix_fmt = ctx->pix_fmt;
     vs->encoder_ctx->time_base.num = 1;
     vs->encoder_ctx->time_base.den = 1;
 
@@ -241,43 +329,108 @@ sc_v4l2_sink_open(struct sc_v4l2_sink *vs, const AVCodecContext *ctx) {
         goto error_avcodec_free_context;
     }
 
-    vs->frame = av_frame_alloc();
-    if (!vs->frame) {
+    vs->packet = av_packet_alloc();
+    if (!vs->packet) {
         LOG_OOM();
         goto error_avcodec_free_context;
     }
 
-    vs->packet = av_packet_alloc();
-    if (!vs->packet) {
+    vs->header_written = false;
+
+    return true;
+
+error_avcodec_free_context:
+    avcodec_free_context(&vs->encoder_ctx);
+error_avio_close:
+    avio_close(vs->format_ctx->pb);
+error_avformat_free_context:
+    avformat_free_context(vs->format_ctx);
+
+    return false;
+}
+
+static void
+sc_v4l2_sink_close_muxer(struct sc_v4l2_sink *vs) {
+    av_packet_free(&vs->packet);
+    avcodec_free_context(&vs->encoder_ctx);
+    avio_close(vs->format_ctx->pb);
+    avformat_free_context(vs->format_ctx);
+}
+
+static bool
+sc_v4l2_sink_open(struct sc_v4l2_sink *vs, const AVCodecContext *ctx) {
+    assert(ctx->pix_fmt == AV_PIX_FMT_YUV420P
+            || ctx->pix_fmt == AV_PIX_FMT_NV12
+            || ctx->pix_fmt == AV_PIX_FMT_YUYV422);
+
+    bool ok = sc_frame_buffer_init(&vs->fb, 1, SC_FRAME_BUFFER_POLICY_FIFO);
+    if (!ok) {
+        return false;
+    }
+
+    ok = sc_mutex_init(&vs->mutex);
+    if (!ok) {
+        goto error_frame_buffer_destroy;
+    }
+
+    ok = sc_cond_init(&vs->cond);
+    if (!ok) {
+        goto error_mutex_destroy;
+    }
+
+    if (vs->direct) {
+        // Write the frames directly to mmap()ed V4L2 buffers, without any
+        // rawvideo encoder nor muxer
+        ok = sc_v4l2_output_open(&vs->output, vs->device_name,
+                                 vs->pixel_format);
+    } else {
+        ok = sc_v4l2_sink_open_muxer(vs, ctx);
+    }
+    if (!ok) {
+        goto error_cond_destroy;
+    }
+
+    vs->frame = av_frame_alloc();
+    if (!vs->frame) {
         LOG_OOM();
-        goto error_av_frame_free;
+        goto error_close_output;
+    }
+
+    if (vs->orientation != SC_ORIENTATION_0) {
+        // Only the frames decoded in YUV420P (not converted upstream) can be
+        // oriented
+        assert(ctx->pix_fmt == AV_PIX_FMT_YUV420P);
+        vs->oriented_frame = av_frame_alloc();
+        if (!vs->oriented_frame) {
+            LOG_OOM();
+            goto error_av_frame_free;
+        }
     }
 
     vs->has_frame = false;
-    vs->header_written = false;
     vs->stopped = false;
 
     LOGD("Starting v4l2 thread");
     ok = sc_thread_create(&vs->thread, run_v4l2_sink, "scrcpy-v4l2", vs);
     if (!ok) {
         LOGE("Could not start v4l2 thread");
-        goto error_av_packet_free;
+        goto error_oriented_frame_free;
     }
 
     LOGI("v4l2 sink started to device: %s", vs->device_name);
 
     return true;
 
-error_av_packet_free:
-    av_packet_free(&vs->packet);
+error_oriented_frame_free:
+    av_frame_free(&vs->oriented_frame);
 error_av_frame_free:
     av_frame_free(&vs->frame);
-error_avcodec_free_context:
-    avcodec_free_context(&vs->encoder_ctx);
-error_avio_close:
-    avio_close(vs->format_ctx->pb);
-error_avformat_free_context:
-    avformat_free_context(vs->format_ctx);
+error_close_output:
+    if (vs->direct) {
+        sc_v4l2_output_close(&vs->output);
+    } else {
+        sc_v4l2_sink_close_muxer(vs);
+    }
 error_cond_destroy:
     sc_cond_destroy(&vs->cond);
 error_mutex_destroy:
@@ -297,11 +450,13 @@ sc_v4l2_sink_close(struct sc_v4l2_sink *vs) {
 
     sc_thread_join(&vs->thread, NULL);
 
-    av_packet_free(&vs->packet);
+    av_frame_free(&vs->oriented_frame);
     av_frame_free(&vs->frame);
-    avcodec_free_context(&vs->encoder_ctx);
-    avio_close(vs->format_ctx->pb);
-    avformat_free_context(vs->format_ctx);
+    if (vs->direct) {
+        sc_v4l2_output_close(&vs->output);
+    } else {
+        sc_v4l2_sink_close_muxer(vs);
+    }
     sc_cond_destroy(&vs->cond);
     sc_mutex_destroy(&vs->mutex);
     sc_frame_buffer_destroy(&vs->fb);
@@ -309,13 +464,14 @@ sc_v4l2_sink_close(struct sc_v4l2_sink *vs) {
 
 static bool
 sc_v4l2_sink_push(struct sc_v4l2_sink *vs, const AVFrame *frame) {
-    bool previous_skipped;
-    bool ok = sc_frame_buffer_push(&vs->fb, frame, &previous_skipped);
+    enum sc_frame_buffer_drop drop;
+    unsigned slot;
+    bool ok = sc_frame_buffer_push(&vs->fb, frame, &drop, &slot);
     if (!ok) {
         return false;
     }
 
-    if (!previous_skipped) {
+    if (drop == SC_FRAME_BUFFER_DROP_NONE) {
         sc_mutex_lock(&vs->mutex);
         vs->has_frame = true;
         sc_cond_signal(&vs->cond);
@@ -344,13 +500,20 @@ sc_v4l2_frame_sink_push(struct sc_frame_sink *sink, const AVFrame *frame) {
 }
 
 bool
-sc_v4l2_sink_init(struct sc_v4l2_sink *vs, const char *device_name) {
+sc_v4l2_sink_init(struct sc_v4l2_sink *vs, const char *device_name,
+                  bool direct, enum sc_v4l2_pixel_format pixel_format,
+                  enum sc_orientation orientation) {
     vs->device_name = strdup(device_name);
     if (!vs->device_name) {
         LOGE("Could not strdup v4l2 device name");
         return false;
     }
 
+    vs->direct = direct;
+    vs->pixel_format = pixel_format;
+    vs->orientation = orientation;
+    vs->oriented_frame = NULL;
+
     static const struct sc_frame_sink_ops ops = {
         .open = sc_v4l2_frame_sink_open,
         .close = sc_v4l2_frame_sink_close,
@@ -8,13 +8,29 @@
 #include <libavformat/avformat.h>
 
 #include "frame_buffer.h"
+#include "options.h"
 #include "trait/frame_sink.h"
 #include "util/thread.h"
+#include "v4l2_output.h"
 
 struct sc_v4l2_sink {
     struct sc_frame_sink frame_sink; // frame sink trait
 
     struct sc_frame_buffer fb;
+
+    // if direct is set, frames are written to mmap()ed V4L2 buffers,
+    // otherwise they are encoded as rawvideo and muxed by libavformat
+    bool direct;
+    // only used if direct (otherwise the frames are converted upstream)
+    enum sc_v4l2_pixel_format pixel_format;
+    struct sc_v4l2_output output; // only used if direct
+
+    // applied to the (YUV420P) frames in the v4l2 thread, since the consumers
+    // of the device do not handle any rotation metadata
+    enum sc_orientation orientation;
+    AVFrame *oriented_frame; // only used if orientation != SC_ORIENTATION_0
+
+    // only used if !direct
     AVFormatContext *format_ctx;
     AVCodecContext *encoder_ctx;
 
@@ -32,7 +48,9 @@ struct sc_v4l2_sink {
 };
 
 bool
-sc_v4l2_sink_init(struct sc_v4l2_sink *vs, const char *device_name);
+sc_v4l2_sink_init(struct sc_v4l2_sink *vs, const char *device_name,
+                  bool direct, enum sc_v4l2_pixel_format pixel_format,
+                  enum sc_orientation orientation);
 
 void
 sc_v4l2_sink_destroy(struct sc_v4l2_sink *vs);
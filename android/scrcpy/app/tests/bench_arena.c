@@ -0,0 +1,100 @@
+#include "common.h"
+
+#include <assert.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "util/arena.h"
+#include "util/str.h"
+
+// Compare the heap and the scratch arena for the transient hexadecimal
+// strings of the verbose UHID output logs (one per received msg)
+
+#define MSGS 1000000
+#define MAX_PAYLOAD 64
+
+static int64_t
+now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * INT64_C(1000000000) + ts.tv_nsec;
+}
+
+static size_t
+payload_size(unsigned i) {
+    // Typical HID outputs are a few bytes, with some larger ones
+    return i % 100 ? 1 + i % 8 : MAX_PAYLOAD;
+}
+
+static int64_t
+bench_heap(const uint8_t *payload, uint64_t *allocs, size_t *total) {
+    int64_t start = now_ns();
+    for (unsigned i = 0; i < MSGS; ++i) {
+        size_t size = payload_size(i);
+        char *hex = sc_str_to_hex_string(payload, size);
+        assert(hex);
+        *total += strlen(hex);
+        free(hex);
+        ++*allocs;
+    }
+    return now_ns() - start;
+}
+
+static int64_t
+bench_arena(const uint8_t *payload, uint64_t *allocs, size_t *total) {
+    struct sc_arena arena;
+    // Small on purpose, to include the growth
+    sc_arena_init(&arena, 64);
+
+    struct sc_arena_chunk *chunk = NULL;
+
+    int64_t start = now_ns();
+    for (unsigned i = 0; i < MSGS; ++i) {
+        size_t size = payload_size(i);
+        char *hex = sc_arena_alloc(&arena, SC_STR_HEX_SIZE(size));
+        assert(hex);
+        sc_str_write_hex(hex, payload, size);
+        *total += strlen(hex);
+        if (arena.chunks != chunk) {
+            // A new chunk has been allocated
+            chunk = arena.chunks;
+            ++*allocs;
+        }
+        sc_arena_reset(&arena);
+    }
+    int64_t duration = now_ns() - start;
+
+    sc_arena_destroy(&arena);
+    return duration;
+}
+
+int main(int argc, char *argv[]) {
+    (void) argc;
+    (void) argv;
+
+    uint8_t payload[MAX_PAYLOAD];
+    for (unsigned i = 0; i < MAX_PAYLOAD; ++i) {
+        payload[i] = i * 37;
+    }
+
+    uint64_t heap_allocs = 0;
+    size_t heap_total = 0;
+    int64_t heap = bench_heap(payload, &heap_allocs, &heap_total);
+
+    uint64_t arena_allocs = 0;
+    size_t arena_total = 0;
+    int64_t arena = bench_arena(payload, &arena_allocs, &arena_total);
+
+    // The same strings must have been produced
+    assert(heap_total == arena_total);
+
+    printf("heap:  %" PRIu64 " allocations, %.1f ns/msg\n", heap_allocs,
+           (double) heap / MSGS);
+    printf("arena: %" PRIu64 " allocations, %.1f ns/msg\n", arena_allocs,
+           (double) arena / MSGS);
+
+    return 0;
+}
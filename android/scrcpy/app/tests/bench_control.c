@@ -0,0 +1,457 @@
+#include "common.h"
+
+#include <assert.h>
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "controller.h"
+#include "stats.h"
+#include "util/binary.h"
+#include "util/histogram.h"
+#include "util/log.h"
+#include "util/net.h"
+#include "util/thread.h"
+#include "util/tick.h"
+#include "util/vector.h"
+
+// Load benchmark for the control stream.
+//
+// Usage:
+//     bench_control
+//         Push synthetic input storms through sc_controller_push_msg(), and
+//         receive them on a mock device over a loopback socket pair, to
+//         measure the throughput, the drops, the coalescing and the latency.
+//     bench_control --replay=file [--speed=X] [--port=N]
+//         Replay a control stream recorded by --record-control, at X times
+//         the original speed (0 for as fast as possible, 1 by default), to
+//         the mock device, or to a device control socket forwarded to
+//         localhost:N.
+
+#define TOUCH_MSG_SIZE 32 // serialized INJECT_TOUCH_EVENT
+
+// x coordinate of the msg indicating the end of the scenario
+#define SEQ_END -1
+
+struct scenario {
+    const char *name;
+    unsigned fingers; // 0 for the mouse
+    unsigned rate; // events per second for each pointer, 0 for a burst
+    unsigned events; // for each pointer
+    sc_tick device_delay; // processing time of each msg by the device
+};
+
+static const struct scenario scenarios[] = {
+    {"mouse 1000 Hz", 0, 1000, 2000, 0},
+    {"touch 10 fingers 1000 Hz", 10, 1000, 2000, 0},
+    {"touch 10 fingers 1000 Hz, slow device", 10, 1000, 2000,
+     SC_TICK_FROM_US(200)},
+    {"mouse burst, slow device", 0, 0, 20000, SC_TICK_FROM_US(50)},
+};
+
+struct bench_sleeper {
+    sc_mutex mutex;
+    sc_cond cond; // never signaled
+};
+
+struct mock_device {
+    sc_thread thread;
+    sc_socket socket;
+    bool parse; // synthetic touch msgs, otherwise only count the bytes
+    sc_tick delay;
+    const atomic_int_least64_t *push_ticks; // indexed by sequence number
+
+    struct sc_histogram latency;
+    uint64_t msgs;
+    uint64_t bytes;
+    sc_tick last;
+};
+
+struct bench_record SC_VECTOR(uint8_t);
+
+static void
+sleeper_init(struct bench_sleeper *sleeper) {
+    bool ok = sc_mutex_init(&sleeper->mutex);
+    assert(ok);
+    ok = sc_cond_init(&sleeper->cond);
+    assert(ok);
+    (void) ok;
+}
+
+static void
+sleeper_destroy(struct bench_sleeper *sleeper) {
+    sc_cond_destroy(&sleeper->cond);
+    sc_mutex_destroy(&sleeper->mutex);
+}
+
+static void
+sleep_until(struct bench_sleeper *sleeper, sc_tick deadline) {
+    sc_mutex_lock(&sleeper->mutex);
+    while (sc_tick_now() < deadline) {
+        sc_cond_timedwait(&sleeper->cond, &sleeper->mutex, deadline);
+    }
+    sc_mutex_unlock(&sleeper->mutex);
+}
+
+static int
+run_mock_device(void *data) {
+    struct mock_device *dev = data;
+
+    struct bench_sleeper sleeper;
+    sleeper_init(&sleeper);
+    sc_tick busy_until = 0;
+
+    uint8_t buf[4096];
+    for (;;) {
+        ssize_t r;
+        if (dev->parse) {
+            r = net_recv_all(dev->socket, buf, TOUCH_MSG_SIZE);
+            if (r != TOUCH_MSG_SIZE) {
+                break;
+            }
+        } else {
+            r = net_recv(dev->socket, buf, sizeof(buf));
+            if (r <= 0) {
+                break;
+            }
+        }
+
+        sc_tick now = sc_tick_now();
+        dev->bytes += r;
+        dev->last = now;
+
+        if (dev->parse) {
+            assert(buf[0] == SC_CONTROL_MSG_TYPE_INJECT_TOUCH_EVENT);
+            int32_t seq = (int32_t) sc_read32be(&buf[10]);
+            if (seq == SEQ_END) {
+                break;
+            }
+            ++dev->msgs;
+
+            sc_tick pushed = atomic_load_explicit(&dev->push_ticks[seq],
+                                                  memory_order_relaxed);
+            sc_histogram_record(&dev->latency, now - pushed);
+        }
+
+        if (dev->delay) {
+            // Simulate the processing time of a slow device (the sleep
+            // resolution is coarse, so sleep only once late enough)
+            busy_until = MAX(busy_until, now) + dev->delay;
+            if (busy_until - now >= SC_TICK_FROM_MS(2)) {
+                sleep_until(&sleeper, busy_until);
+            }
+        }
+    }
+
+    sleeper_destroy(&sleeper);
+    return 0;
+}
+
+static void
+start_mock_device(struct mock_device *dev, sc_socket socket, bool parse,
+                  sc_tick delay, const atomic_int_least64_t *push_ticks) {
+    dev->socket = socket;
+    dev->parse = parse;
+    dev->delay = delay;
+    dev->push_ticks = push_ticks;
+    sc_histogram_init(&dev->latency);
+    dev->msgs = 0;
+    dev->bytes = 0;
+    dev->last = 0;
+
+    bool ok = sc_thread_create(&dev->thread, run_mock_device, "mock-device",
+                               dev);
+    assert(ok);
+    (void) ok;
+}
+
+static void
+on_controller_ended(struct sc_controller *controller, bool error,
+                    void *userdata) {
+    (void) controller;
+    (void) error;
+    (void) userdata;
+}
+
+static struct sc_control_msg
+make_touch_msg(enum android_motionevent_action action, uint64_t pointer_id,
+               int32_t seq, unsigned index) {
+    struct sc_control_msg msg = {
+        .type = SC_CONTROL_MSG_TYPE_INJECT_TOUCH_EVENT,
+        .inject_touch_event = {
+            .action = action,
+            .pointer_id = pointer_id,
+            .position = {
+                .screen_size = {1080, 2400},
+                // The sequence number is transmitted as x coordinate
+                .point = {seq, 100 + index % 2000},
+            },
+            .pressure = pointer_id == SC_POINTER_ID_MOUSE ? 0.f : 1.f,
+        },
+    };
+    return msg;
+}
+
+static void
+run_scenario(const struct scenario *sc) {
+    sc_socket sockets[2];
+    bool ok = net_socketpair(sockets);
+    assert(ok);
+
+    unsigned pointers = sc->fingers ? sc->fingers : 1;
+    // DOWN and UP for each finger
+    unsigned total = pointers * (sc->events + (sc->fingers ? 2 : 0));
+    atomic_int_least64_t *push_ticks = malloc(total * sizeof(*push_ticks));
+    assert(push_ticks);
+    for (unsigned i = 0; i < total; ++i) {
+        atomic_init(&push_ticks[i], 0);
+    }
+
+    static const struct sc_controller_callbacks cbs = {
+        .on_ended = on_controller_ended,
+    };
+    struct sc_controller controller;
+    ok = sc_controller_init(&controller, sockets[0], &cbs, NULL);
+    assert(ok);
+
+    struct mock_device dev;
+    start_mock_device(&dev, sockets[1], true, sc->device_delay, push_ticks);
+
+    ok = sc_controller_start(&controller);
+    assert(ok);
+    (void) ok;
+
+    struct bench_sleeper sleeper;
+    sleeper_init(&sleeper);
+
+    uint64_t dropped = 0;
+    int32_t seq = 0;
+    sc_tick start = sc_tick_now();
+
+#define PUSH(ACTION, POINTER_ID, INDEX) do { \
+        atomic_store_explicit(&push_ticks[seq], sc_tick_now(), \
+                              memory_order_relaxed); \
+        struct sc_control_msg msg = \
+            make_touch_msg(ACTION, POINTER_ID, seq++, INDEX); \
+        if (!sc_controller_push_msg(&controller, &msg)) { \
+            ++dropped; \
+        } \
+    } while (0)
+
+    for (unsigned f = 0; f < sc->fingers; ++f) {
+        PUSH(AMOTION_EVENT_ACTION_DOWN, f, 0);
+    }
+
+    for (unsigned i = 0; i < sc->events; ++i) {
+        if (sc->rate) {
+            sleep_until(&sleeper, start + SC_TICK_FREQ * i / sc->rate);
+        }
+        if (sc->fingers) {
+            for (unsigned f = 0; f < sc->fingers; ++f) {
+                PUSH(AMOTION_EVENT_ACTION_MOVE, f, i);
+            }
+        } else {
+            PUSH(AMOTION_EVENT_ACTION_HOVER_MOVE, SC_POINTER_ID_MOUSE, i);
+        }
+    }
+
+    for (unsigned f = 0; f < sc->fingers; ++f) {
+        PUSH(AMOTION_EVENT_ACTION_UP, f, sc->events);
+    }
+
+#undef PUSH
+
+    sc_tick push_end = sc_tick_now();
+    assert((unsigned) seq == total);
+
+    // The end msg must not be dropped
+    while (sc_controller_get_queue_depth(&controller)
+            >= sc_controller_get_queue_limit()) {
+        sleep_until(&sleeper, sc_tick_now() + SC_TICK_FROM_MS(1));
+    }
+    struct sc_control_msg end =
+        make_touch_msg(AMOTION_EVENT_ACTION_UP, SC_POINTER_ID_GENERIC_FINGER,
+                       SEQ_END, 0);
+    ok = sc_controller_push_msg(&controller, &end);
+    assert(ok);
+
+    sc_thread_join(&dev.thread, NULL);
+
+    sc_controller_stop(&controller);
+    // Unblock the receiver
+    net_interrupt(sockets[0]);
+    sc_controller_join(&controller);
+    sc_controller_destroy(&controller);
+    net_close(sockets[0]);
+    net_close(sockets[1]);
+    sleeper_destroy(&sleeper);
+
+    uint64_t sent = total - dropped;
+    uint64_t coalesced = sent - dev.msgs;
+    sc_tick duration = dev.last - start;
+
+    struct sc_histogram_stats stats;
+    sc_histogram_get_stats(&dev.latency, &stats);
+
+    printf("%s:\n", sc->name);
+    printf("    pushed: %u in %" PRIu64 " ms, dropped: %" PRIu64
+           ", coalesced: %" PRIu64 ", received: %" PRIu64 "\n", total,
+           (uint64_t) SC_TICK_TO_MS(push_end - start), dropped, coalesced,
+           dev.msgs);
+    printf("    throughput: %.0f msgs/s\n",
+           duration ? (double) dev.msgs * SC_TICK_FREQ / duration : 0);
+    printf("    latency (us): mean=%" PRIu64 " p50=%" PRIu64 " p90=%" PRIu64
+           " p99=%" PRIu64 " max=%" PRIu64 "\n", stats.mean, stats.p50,
+           stats.p90, stats.p99, stats.max);
+
+    free(push_ticks);
+}
+
+static bool
+read_record(const char *path, struct bench_record *record) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "Could not open %s\n", path);
+        return false;
+    }
+
+    uint8_t buf[0x10000];
+    size_t r;
+    while ((r = fread(buf, 1, sizeof(buf), file)) > 0) {
+        bool ok = sc_vector_push_all(record, buf, r);
+        assert(ok);
+        (void) ok;
+    }
+
+    bool error = ferror(file);
+    fclose(file);
+    return !error;
+}
+
+static bool
+replay(const struct bench_record *record, double speed, uint16_t port) {
+    sc_socket socket;
+    sc_socket sockets[2];
+    struct mock_device dev;
+    bool mock = !port;
+
+    if (mock) {
+        bool ok = net_socketpair(sockets);
+        assert(ok);
+        (void) ok;
+        socket = sockets[0];
+        start_mock_device(&dev, sockets[1], false, 0, NULL);
+    } else {
+        socket = net_socket();
+        if (socket == SC_SOCKET_NONE) {
+            return false;
+        }
+        if (!net_connect(socket, IPV4_LOCALHOST, port)) {
+            fprintf(stderr, "Could not connect to localhost:%" PRIu16 "\n",
+                    port);
+            net_close(socket);
+            return false;
+        }
+    }
+
+    struct bench_sleeper sleeper;
+    sleeper_init(&sleeper);
+
+    const uint8_t *buf = record->data;
+    size_t size = record->size;
+    size_t offset = 0;
+    uint64_t msgs = 0;
+    bool ok = true;
+
+    sc_tick start = sc_tick_now();
+    while (offset + SC_CONTROL_RECORD_HEADER_SIZE <= size) {
+        uint64_t timestamp = sc_read64be(&buf[offset]);
+        uint32_t len = sc_read32be(&buf[offset + 8]);
+        offset += SC_CONTROL_RECORD_HEADER_SIZE;
+        if (len > size - offset) {
+            fprintf(stderr, "Truncated record at offset %" SC_PRIsizet "\n",
+                    offset);
+            ok = false;
+            break;
+        }
+
+        if (speed > 0) {
+            sleep_until(&sleeper, start + (sc_tick) (timestamp / speed));
+        }
+
+        if (net_send_all(socket, &buf[offset], len) != (ssize_t) len) {
+            fprintf(stderr, "Could not send control msg\n");
+            ok = false;
+            break;
+        }
+
+        offset += len;
+        ++msgs;
+    }
+    sc_tick duration = sc_tick_now() - start;
+
+    net_close(socket);
+    if (mock) {
+        sc_thread_join(&dev.thread, NULL);
+        net_close(sockets[1]);
+        assert(!ok || dev.bytes == offset - msgs
+                                    * SC_CONTROL_RECORD_HEADER_SIZE);
+    }
+    sleeper_destroy(&sleeper);
+
+    printf("Replayed %" PRIu64 " msgs (%" SC_PRIsizet " bytes) in %" PRIu64
+           " ms (%.0f msgs/s)\n", msgs,
+           offset - (size_t) msgs * SC_CONTROL_RECORD_HEADER_SIZE,
+           (uint64_t) SC_TICK_TO_MS(duration),
+           duration ? (double) msgs * SC_TICK_FREQ / duration : 0);
+
+    return ok;
+}
+
+int main(int argc, char *argv[]) {
+    const char *replay_path = NULL;
+    double speed = 1;
+    long port = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        if (!strncmp(arg, "--replay=", 9)) {
+            replay_path = arg + 9;
+        } else if (!strncmp(arg, "--speed=", 8)) {
+            speed = strtod(arg + 8, NULL);
+        } else if (!strncmp(arg, "--port=", 7)) {
+            port = strtol(arg + 7, NULL, 10);
+            if (port <= 0 || port > 0xFFFF) {
+                fprintf(stderr, "Invalid port: %s\n", arg + 7);
+                return 1;
+            }
+        } else {
+            fprintf(stderr, "Unexpected argument: %s\n", arg);
+            return 1;
+        }
+    }
+
+    sc_log_configure();
+    sc_set_log_level(SC_LOG_LEVEL_WARN);
+
+    bool ok = net_init();
+    assert(ok);
+    sc_stats_init();
+
+    if (replay_path) {
+        struct bench_record record;
+        sc_vector_init(&record);
+        ok = read_record(replay_path, &record)
+          && replay(&record, speed, port);
+        sc_vector_destroy(&record);
+    } else {
+        for (size_t i = 0; i < ARRAY_LEN(scenarios); ++i) {
+            run_scenario(&scenarios[i]);
+        }
+    }
+
+    net_cleanup();
+    return ok ? 0 : 1;
+}
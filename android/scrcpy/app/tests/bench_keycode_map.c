@@ -0,0 +1,101 @@
+#include "common.h"
+
+#include <assert.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "keycode_map.h"
+
+// Compare the dense keycode tables with the linear scan of the key/value
+// entries they replace, on a stream of typical key events
+
+#define EVENTS 10000000
+#define MAX_ENTRIES 256
+
+struct entry {
+    int32_t key;
+    int32_t value;
+};
+
+static int64_t
+now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * INT64_C(1000000000) + ts.tv_nsec;
+}
+
+static const enum sc_keycode stream[] = {
+    // Mostly letters, with some navigation and punctuation keys
+    SC_KEYCODE_h, SC_KEYCODE_e, SC_KEYCODE_l, SC_KEYCODE_l, SC_KEYCODE_o,
+    SC_KEYCODE_SPACE, SC_KEYCODE_w, SC_KEYCODE_o, SC_KEYCODE_r, SC_KEYCODE_l,
+    SC_KEYCODE_d, SC_KEYCODE_COMMA, SC_KEYCODE_LSHIFT, SC_KEYCODE_RETURN,
+    SC_KEYCODE_BACKSPACE, SC_KEYCODE_LEFT, SC_KEYCODE_1, SC_KEYCODE_KP_5,
+    SC_KEYCODE_x, SC_KEYCODE_F5,
+};
+
+static size_t
+build_entries(struct entry *entries) {
+    // Collect all the mappings of the raw mode (the largest one), in the
+    // order of the keycodes
+    size_t count = 0;
+    for (int32_t i = 0; i < 128 + SDL_NUM_SCANCODES; ++i) {
+        enum sc_keycode key = i < 128 ? i : (i - 128) | SDLK_SCANCODE_MASK;
+        enum android_keycode value;
+        if (sc_keycode_to_android(key, SC_MOD_NUM, SC_KEY_INJECT_MODE_RAW,
+                                  &value)) {
+            assert(count < MAX_ENTRIES);
+            entries[count].key = key;
+            entries[count].value = value;
+            ++count;
+        }
+    }
+    return count;
+}
+
+static const struct entry *
+find_linear(const struct entry *entries, size_t count, int32_t key) {
+    for (size_t i = 0; i < count; ++i) {
+        if (entries[i].key == key) {
+            return &entries[i];
+        }
+    }
+    return NULL;
+}
+
+int main(int argc, char *argv[]) {
+    (void) argc;
+    (void) argv;
+
+    static struct entry entries[MAX_ENTRIES];
+    size_t count = build_entries(entries);
+
+    // Prevent the compiler from optimizing out the lookups
+    volatile uint32_t sink = 0;
+
+    int64_t start = now_ns();
+    for (unsigned i = 0; i < EVENTS; ++i) {
+        const struct entry *e =
+            find_linear(entries, count, stream[i % ARRAY_LEN(stream)]);
+        sink += e ? (uint32_t) e->value : 0;
+    }
+    int64_t linear = now_ns() - start;
+
+    start = now_ns();
+    for (unsigned i = 0; i < EVENTS; ++i) {
+        enum android_keycode to;
+        if (sc_keycode_to_android(stream[i % ARRAY_LEN(stream)], SC_MOD_NUM,
+                                  SC_KEY_INJECT_MODE_RAW, &to)) {
+            sink += to;
+        }
+    }
+    int64_t dense = now_ns() - start;
+
+    printf("%u key events, %" SC_PRIsizet " mapped keycodes\n", EVENTS, count);
+    printf("  linear scan:  %7.2f ns/event\n", (double) linear / EVENTS);
+    printf("  dense tables: %7.2f ns/event\n", (double) dense / EVENTS);
+    (void) sink;
+
+    return 0;
+}
@@ -0,0 +1,421 @@
+#include "common.h"
+
+#include <assert.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <libavcodec/avcodec.h>
+#include <libavutil/opt.h>
+
+#include "decoder.h"
+#include "demuxer.h"
+#include "latency_tracer.h"
+#include "stats.h"
+#include "trait/frame_sink.h"
+#include "util/binary.h"
+#include "util/log.h"
+#include "util/net.h"
+#include "util/thread.h"
+#include "util/tick.h"
+#include "util/vector.h"
+
+// Replay a video stream through the real demuxer -> decoder -> sink chain.
+//
+// The stream has the format received on the video socket (with
+// send_device_meta=false and send_dummy_byte=false): a 12-byte header (codec
+// id, width, height), followed by packets, each prefixed by a 12-byte header
+// (see sc_demuxer_recv_packet()).
+//
+// Usage: bench_pipeline [--realtime] [stream_file]
+//
+// Without stream file, a synthetic H.264 stream is encoded first (the
+// benchmark is skipped if no H.264 encoder is available). In realtime mode,
+// the packets are sent according to their PTS, otherwise as fast as possible.
+
+#define SC_BENCH_SKIPPED 77 // special exit code for meson
+
+#define SC_STREAM_HEADER_SIZE 12
+#define SC_PACKET_HEADER_SIZE 12
+#define SC_PACKET_FLAG_CONFIG (UINT64_C(1) << 63)
+#define SC_PACKET_FLAG_KEY_FRAME (UINT64_C(1) << 62)
+#define SC_PACKET_PTS_MASK (SC_PACKET_FLAG_KEY_FRAME - 1)
+
+#define SC_CODEC_ID_H264 UINT32_C(0x68323634) // "h264" in ASCII
+
+#define SYNTHETIC_WIDTH 1280
+#define SYNTHETIC_HEIGHT 720
+#define SYNTHETIC_FPS 60
+#define SYNTHETIC_FRAMES 600
+
+struct bench_stream SC_VECTOR(uint8_t);
+
+struct bench_feeder {
+    sc_thread thread;
+    sc_socket socket;
+    const struct bench_stream *stream;
+    bool realtime;
+    sc_tick start;
+    uint64_t packets;
+};
+
+struct bench_sink {
+    struct sc_frame_sink frame_sink; // frame sink trait
+    uint64_t frames;
+    sc_tick last;
+};
+
+static bool
+read_file(const char *path, struct bench_stream *stream) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "Could not open %s\n", path);
+        return false;
+    }
+
+    uint8_t buf[0x10000];
+    size_t r;
+    while ((r = fread(buf, 1, sizeof(buf), file)) > 0) {
+        bool ok = sc_vector_push_all(stream, buf, r);
+        assert(ok);
+        (void) ok;
+    }
+
+    bool error = ferror(file);
+    fclose(file);
+    return !error;
+}
+
+static void
+append_packet(struct bench_stream *stream, uint64_t pts_flags,
+              const uint8_t *data, uint32_t len) {
+    uint8_t header[SC_PACKET_HEADER_SIZE];
+    sc_write64be(header, pts_flags);
+    sc_write32be(&header[8], len);
+    bool ok = sc_vector_push_all(stream, header, sizeof(header));
+    assert(ok);
+    ok = sc_vector_push_all(stream, data, len);
+    assert(ok);
+    (void) ok;
+}
+
+static void
+fill_frame(AVFrame *frame, unsigned index) {
+    // Moving gradient, so that the encoder produces non-trivial P-frames
+    for (int y = 0; y < frame->height; ++y) {
+        uint8_t *line = frame->data[0] + y * frame->linesize[0];
+        for (int x = 0; x < frame->width; ++x) {
+            line[x] = x + y + index * 4;
+        }
+    }
+    for (int y = 0; y < frame->height / 2; ++y) {
+        memset(frame->data[1] + y * frame->linesize[1], 128 + y + index,
+               frame->width / 2);
+        memset(frame->data[2] + y * frame->linesize[2], 64 + index,
+               frame->width / 2);
+    }
+}
+
+static bool
+drain_encoder(AVCodecContext *ctx, AVPacket *packet,
+              struct bench_stream *stream) {
+    int ret;
+    while (!(ret = avcodec_receive_packet(ctx, packet))) {
+        // Send the PTS in microseconds, like the device
+        uint64_t pts = av_rescale_q(packet->pts, ctx->time_base,
+                                    (AVRational) {1, SC_TICK_FREQ});
+        if (packet->flags & AV_PKT_FLAG_KEY) {
+            pts |= SC_PACKET_FLAG_KEY_FRAME;
+        }
+        append_packet(stream, pts, packet->data, packet->size);
+        av_packet_unref(packet);
+    }
+
+    return ret == AVERROR(EAGAIN) || ret == AVERROR_EOF;
+}
+
+static bool
+generate_stream(struct bench_stream *stream) {
+    const AVCodec *codec = avcodec_find_encoder(AV_CODEC_ID_H264);
+    if (!codec) {
+        return false;
+    }
+
+    AVCodecContext *ctx = avcodec_alloc_context3(codec);
+    assert(ctx);
+
+    ctx->width = SYNTHETIC_WIDTH;
+    ctx->height = SYNTHETIC_HEIGHT;
+    ctx->pix_fmt = AV_PIX_FMT_YUV420P;
+    ctx->time_base = (AVRational) {1, SYNTHETIC_FPS};
+    ctx->framerate = (AVRational) {SYNTHETIC_FPS, 1};
+    ctx->bit_rate = 8000000;
+    ctx->gop_size = SYNTHETIC_FPS * 10;
+    ctx->max_b_frames = 0; // like MediaCodec
+    // Ignored if the encoder does not support them
+    av_opt_set(ctx->priv_data, "preset", "ultrafast", 0);
+    av_opt_set(ctx->priv_data, "tune", "zerolatency", 0);
+
+    bool ok = false;
+    AVFrame *frame = NULL;
+    AVPacket *packet = NULL;
+
+    if (avcodec_open2(ctx, codec, NULL) < 0) {
+        goto end;
+    }
+
+    frame = av_frame_alloc();
+    packet = av_packet_alloc();
+    assert(frame && packet);
+
+    frame->format = ctx->pix_fmt;
+    frame->width = ctx->width;
+    frame->height = ctx->height;
+    if (av_frame_get_buffer(frame, 0) < 0) {
+        goto end;
+    }
+
+    uint8_t header[SC_STREAM_HEADER_SIZE];
+    sc_write32be(header, SC_CODEC_ID_H264);
+    sc_write32be(&header[4], SYNTHETIC_WIDTH);
+    sc_write32be(&header[8], SYNTHETIC_HEIGHT);
+    ok = sc_vector_push_all(stream, header, sizeof(header));
+    assert(ok);
+
+    for (unsigned i = 0; i < SYNTHETIC_FRAMES; ++i) {
+        if (av_frame_make_writable(frame) < 0) {
+            ok = false;
+            goto end;
+        }
+        fill_frame(frame, i);
+        frame->pts = i;
+
+        ok = avcodec_send_frame(ctx, frame) >= 0
+          && drain_encoder(ctx, packet, stream);
+        if (!ok) {
+            goto end;
+        }
+    }
+
+    // Flush
+    ok = avcodec_send_frame(ctx, NULL) >= 0
+      && drain_encoder(ctx, packet, stream);
+
+    printf("Synthetic stream: %s %dx%d, %u frames\n", codec->name,
+           SYNTHETIC_WIDTH, SYNTHETIC_HEIGHT, SYNTHETIC_FRAMES);
+
+end:
+    av_packet_free(&packet);
+    av_frame_free(&frame);
+    avcodec_free_context(&ctx);
+    return ok;
+}
+
+static int
+run_feeder(void *data) {
+    struct bench_feeder *feeder = data;
+    const uint8_t *buf = feeder->stream->data;
+    size_t size = feeder->stream->size;
+
+    // Only used to sleep until a deadline in realtime mode
+    sc_mutex mutex;
+    sc_cond cond;
+    bool ok = sc_mutex_init(&mutex);
+    assert(ok);
+    ok = sc_cond_init(&cond);
+    assert(ok);
+    (void) ok;
+    sc_mutex_lock(&mutex);
+
+    assert(size >= SC_STREAM_HEADER_SIZE);
+    ssize_t w = net_send_all(feeder->socket, buf, SC_STREAM_HEADER_SIZE);
+    size_t offset = SC_STREAM_HEADER_SIZE;
+
+    int64_t first_pts = -1;
+    while (w > 0 && offset + SC_PACKET_HEADER_SIZE <= size) {
+        uint64_t pts_flags = sc_read64be(&buf[offset]);
+        uint32_t len = sc_read32be(&buf[offset + 8]);
+        size_t packet_size = SC_PACKET_HEADER_SIZE + len;
+        if (!len || packet_size > size - offset) {
+            fprintf(stderr, "Truncated stream at offset %" SC_PRIsizet "\n",
+                    offset);
+            break;
+        }
+
+        if (feeder->realtime && !(pts_flags & SC_PACKET_FLAG_CONFIG)) {
+            int64_t pts = pts_flags & SC_PACKET_PTS_MASK;
+            if (first_pts == -1) {
+                first_pts = pts;
+            }
+            sc_tick deadline = feeder->start + SC_TICK_FROM_US(pts - first_pts);
+            while (sc_tick_now() < deadline) {
+                sc_cond_timedwait(&cond, &mutex, deadline);
+            }
+        }
+
+        w = net_send_all(feeder->socket, &buf[offset], packet_size);
+        offset += packet_size;
+        ++feeder->packets;
+    }
+
+    sc_mutex_unlock(&mutex);
+    sc_cond_destroy(&cond);
+    sc_mutex_destroy(&mutex);
+
+    // End of stream
+    net_close(feeder->socket);
+    return 0;
+}
+
+static bool
+bench_sink_open(struct sc_frame_sink *sink, const AVCodecContext *ctx) {
+    (void) sink;
+    (void) ctx;
+    return true;
+}
+
+static void
+bench_sink_close(struct sc_frame_sink *sink) {
+    (void) sink;
+}
+
+static bool
+bench_sink_push(struct sc_frame_sink *sink, const AVFrame *frame) {
+    struct bench_sink *bs = container_of(sink, struct bench_sink, frame_sink);
+
+    // Stand for the screen, with a zero-cost upload and presentation, so that
+    // the remaining stages are measured
+    sc_latency_tracer_mark(SC_LATENCY_STAGE_FRAME_PUSH, frame->pts);
+    sc_latency_tracer_mark(SC_LATENCY_STAGE_UPLOAD, frame->pts);
+    sc_latency_tracer_mark_present();
+
+    ++bs->frames;
+    bs->last = sc_tick_now();
+    return true;
+}
+
+static void
+on_demuxer_ended(struct sc_demuxer *demuxer, enum sc_demuxer_status status,
+                 void *userdata) {
+    (void) demuxer;
+    enum sc_demuxer_status *result = userdata;
+    *result = status;
+}
+
+static bool
+run_bench(const struct bench_stream *stream, bool realtime) {
+    sc_socket sockets[2];
+    bool ok = net_socketpair(sockets);
+    assert(ok);
+
+    static const struct sc_demuxer_callbacks demuxer_cbs = {
+        .on_ended = on_demuxer_ended,
+    };
+    enum sc_demuxer_status status = SC_DEMUXER_STATUS_ERROR;
+
+    struct sc_demuxer demuxer;
+    sc_demuxer_init(&demuxer, "video", SC_THREAD_ROLE_VIDEO, sockets[1],
+                    &demuxer_cbs, &status);
+
+    struct sc_decoder decoder;
+    sc_decoder_init(&decoder, "video", NULL);
+    sc_packet_source_add_sink(&demuxer.packet_source, &decoder.packet_sink);
+
+    static const struct sc_frame_sink_ops sink_ops = {
+        .open = bench_sink_open,
+        .close = bench_sink_close,
+        .push = bench_sink_push,
+    };
+    struct bench_sink sink = {
+        .frame_sink = {.ops = &sink_ops},
+    };
+    sc_frame_source_add_sink(&decoder.frame_source, &sink.frame_sink);
+
+    struct bench_feeder feeder = {
+        .socket = sockets[0],
+        .stream = stream,
+        .realtime = realtime,
+    };
+
+    feeder.start = sc_tick_now();
+    ok = sc_demuxer_start(&demuxer);
+    assert(ok);
+    ok = sc_thread_create(&feeder.thread, run_feeder, "bench-feeder", &feeder);
+    assert(ok);
+    (void) ok;
+
+    sc_thread_join(&feeder.thread, NULL);
+    sc_demuxer_join(&demuxer);
+    net_close(sockets[1]);
+
+    if (status != SC_DEMUXER_STATUS_EOS) {
+        fprintf(stderr, "Pipeline error\n");
+        return false;
+    }
+
+    sc_tick duration = sink.last - feeder.start;
+    double seconds = (double) duration / SC_TICK_FREQ;
+    uint64_t bytes = sc_stats_get(SC_STATS_VIDEO_BYTES);
+
+    printf("Mode: %s\n", realtime ? "realtime" : "as fast as possible");
+    printf("Packets: %" PRIu64 " sent, %" PRIu64 " demuxed (%" PRIu64
+           " bytes)\n", feeder.packets, sc_stats_get(SC_STATS_VIDEO_PACKETS),
+           bytes);
+    printf("Frames: %" PRIu64 " in %" PRIu64 " ms (%.1f fps, %.1f Mbps)\n",
+           sink.frames, (uint64_t) SC_TICK_TO_MS(duration),
+           seconds > 0 ? sink.frames / seconds : 0,
+           seconds > 0 ? bytes * 8 / seconds / 1000000 : 0);
+    printf("Packet pool: %" PRIu64 " hits, %" PRIu64 " misses "
+           "(allocations)\n", demuxer.packet_pool.hits,
+           demuxer.packet_pool.misses);
+    fflush(stdout);
+
+    sc_latency_tracer_dump();
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    bool realtime = false;
+    const char *path = NULL;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--realtime")) {
+            realtime = true;
+        } else {
+            path = argv[i];
+        }
+    }
+
+    sc_log_configure();
+    sc_set_log_level(SC_LOG_LEVEL_INFO);
+
+    struct bench_stream stream;
+    sc_vector_init(&stream);
+
+    if (path) {
+        if (!read_file(path, &stream)) {
+            return 1;
+        }
+        if (stream.size < SC_STREAM_HEADER_SIZE) {
+            fprintf(stderr, "Invalid stream: %s\n", path);
+            return 1;
+        }
+        printf("Stream: %s (%" SC_PRIsizet " bytes)\n", path, stream.size);
+    } else if (!generate_stream(&stream)) {
+        printf("No stream file and no H.264 encoder available, skipped\n");
+        sc_vector_destroy(&stream);
+        return SC_BENCH_SKIPPED;
+    }
+
+    bool ok = net_init();
+    assert(ok);
+    ok = sc_latency_tracer_enable(NULL);
+    assert(ok);
+    sc_stats_init();
+
+    ok = run_bench(&stream, realtime);
+
+    sc_latency_tracer_disable();
+    net_cleanup();
+    sc_vector_destroy(&stream);
+    return ok ? 0 : 1;
+}
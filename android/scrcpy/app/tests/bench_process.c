@@ -0,0 +1,118 @@
+#include "common.h"
+
+#include <assert.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "util/process.h"
+
+// Spawn latency of a child process (like each adb command), with
+// sc_process_execute_p() (posix_spawn) and with a plain fork() + exec() for
+// reference, while the parent process has a large resident memory.
+//
+// Usage:
+//     bench_process [--rss-mb=N]
+//         Touch N MiB of memory before spawning (512 by default).
+
+#define SPAWNS 200
+
+static int64_t
+now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * INT64_C(1000000000) + ts.tv_nsec;
+}
+
+static const char *const argv_true[] = {"true", NULL};
+
+static int64_t
+bench_sc_process(void) {
+    int64_t start = now_ns();
+    for (unsigned i = 0; i < SPAWNS; ++i) {
+        // Like sc_adb_execute_p(), read the output through a pipe
+        sc_pid pid;
+        sc_pipe pout;
+        enum sc_process_result r =
+            sc_process_execute_p(argv_true, &pid, 0, NULL, &pout, NULL);
+        assert(r == SC_PROCESS_SUCCESS);
+        (void) r;
+
+        char buf[16];
+        while (sc_pipe_read(pout, buf, sizeof(buf)) > 0) {
+            // discard
+        }
+        sc_pipe_close(pout);
+
+        sc_exit_code code = sc_process_wait(pid, true);
+        assert(code == 0);
+        (void) code;
+    }
+    return now_ns() - start;
+}
+
+static int64_t
+bench_fork(void) {
+    int64_t start = now_ns();
+    for (unsigned i = 0; i < SPAWNS; ++i) {
+        pid_t pid = fork();
+        assert(pid != -1);
+        if (!pid) {
+            execvp(argv_true[0], (char *const *) argv_true);
+            _exit(127);
+        }
+
+        int status;
+        pid_t r = waitpid(pid, &status, 0);
+        assert(r == pid && WIFEXITED(status) && !WEXITSTATUS(status));
+        (void) r;
+    }
+    return now_ns() - start;
+}
+
+int main(int argc, char *argv[]) {
+    long rss_mb = 512;
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        if (!strncmp(arg, "--rss-mb=", 9)) {
+            rss_mb = strtol(arg + 9, NULL, 10);
+        } else {
+            fprintf(stderr, "Unexpected argument: %s\n", arg);
+            return 1;
+        }
+    }
+
+    size_t size = (size_t) rss_mb << 20;
+    void *memory = NULL;
+    if (size) {
+        memory = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        assert(memory != MAP_FAILED);
+#ifdef MADV_NOHUGEPAGE
+        // Like a heap of many small allocations, use small pages (with
+        // transparent huge pages, the page tables would be 512x smaller)
+        madvise(memory, size, MADV_NOHUGEPAGE);
+#endif
+        // Make the pages resident (so that fork() must copy the page tables)
+        memset(memory, 0x55, size);
+    }
+
+    int64_t spawn = bench_sc_process();
+    int64_t fork = bench_fork();
+
+    printf("resident memory: %ld MiB, %u spawns\n", rss_mb, SPAWNS);
+    printf("    sc_process_execute_p: %" PRIi64 " us/spawn\n",
+           spawn / SPAWNS / 1000);
+    printf("    fork + exec:          %" PRIi64 " us/spawn\n",
+           fork / SPAWNS / 1000);
+
+    if (memory) {
+        munmap(memory, size);
+    }
+    return 0;
+}
@@ -0,0 +1,130 @@
+#include "common.h"
+
+#include <assert.h>
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <libavutil/channel_layout.h>
+#include <libavutil/opt.h>
+#include <libswresample/swresample.h>
+
+#include "util/resampler.h"
+
+// Compare the lightweight resampler with libswresample, for the drift
+// compensation of stereo float samples at 48 kHz (as decoded from OPUS)
+
+#define SAMPLE_RATE 48000
+#define BLOCK 960 // 20 ms
+#define BLOCKS (SAMPLE_RATE / BLOCK * 60) // 1 minute
+#define CHANNELS 2
+
+static int64_t
+now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * INT64_C(1000000000) + ts.tv_nsec;
+}
+
+static void
+fill_input(float *left, float *right) {
+    for (unsigned i = 0; i < BLOCK; ++i) {
+        left[i] = sinf(2 * M_PI * 440 * i / SAMPLE_RATE);
+        right[i] = sinf(2 * M_PI * 660 * i / SAMPLE_RATE);
+    }
+}
+
+static int64_t
+bench_resampler(const float *const *planes, float *out) {
+    struct sc_resampler r;
+    bool ok = sc_resampler_init(&r, CHANNELS);
+    assert(ok);
+    (void) ok;
+
+    printf("sc_resampler (%s): ", r.impl_name);
+
+    int64_t start = now_ns();
+    for (unsigned i = 0; i < BLOCKS; ++i) {
+        if (i % 50 == 0) {
+            // Recompute the compensation every second, like the regulator
+            sc_resampler_set_compensation(&r, i % 100 ? 480 : -480,
+                                          4 * SAMPLE_RATE);
+        }
+        int32_t n = sc_resampler_process(&r, out, 2 * BLOCK, planes, true,
+                                         BLOCK);
+        assert(n > 0);
+        (void) n;
+    }
+    int64_t duration = now_ns() - start;
+
+    sc_resampler_destroy(&r);
+    return duration;
+}
+
+static int64_t
+bench_swr(const float *const *planes, float *out) {
+    SwrContext *swr_ctx = swr_alloc();
+    assert(swr_ctx);
+
+#ifdef SCRCPY_LAVU_HAS_CHLAYOUT
+    AVChannelLayout layout = AV_CHANNEL_LAYOUT_STEREO;
+    av_opt_set_chlayout(swr_ctx, "in_chlayout", &layout, 0);
+    av_opt_set_chlayout(swr_ctx, "out_chlayout", &layout, 0);
+#else
+    av_opt_set_channel_layout(swr_ctx, "in_channel_layout",
+                              AV_CH_LAYOUT_STEREO, 0);
+    av_opt_set_channel_layout(swr_ctx, "out_channel_layout",
+                              AV_CH_LAYOUT_STEREO, 0);
+#endif
+    av_opt_set_int(swr_ctx, "in_sample_rate", SAMPLE_RATE, 0);
+    av_opt_set_int(swr_ctx, "out_sample_rate", SAMPLE_RATE, 0);
+    av_opt_set_sample_fmt(swr_ctx, "in_sample_fmt", AV_SAMPLE_FMT_FLTP, 0);
+    av_opt_set_sample_fmt(swr_ctx, "out_sample_fmt", AV_SAMPLE_FMT_FLT, 0);
+    int ret = swr_init(swr_ctx);
+    assert(!ret);
+
+    printf("libswresample: ");
+
+    int64_t start = now_ns();
+    for (unsigned i = 0; i < BLOCKS; ++i) {
+        if (i % 50 == 0) {
+            ret = swr_set_compensation(swr_ctx, i % 100 ? 480 : -480,
+                                       4 * SAMPLE_RATE);
+            assert(!ret);
+        }
+        uint8_t *dst = (uint8_t *) out;
+        ret = swr_convert(swr_ctx, &dst, 2 * BLOCK,
+                          (const uint8_t **) planes, BLOCK);
+        assert(ret > 0);
+    }
+    int64_t duration = now_ns() - start;
+
+    swr_free(&swr_ctx);
+    return duration;
+}
+
+static void
+print_result(int64_t duration) {
+    printf("%" PRIi64 " µs for 1 minute of audio (%.1f ns/frame)\n",
+           duration / 1000, (double) duration / (BLOCKS * BLOCK));
+}
+
+int main(int argc, char *argv[]) {
+    (void) argc;
+    (void) argv;
+
+    float left[BLOCK];
+    float right[BLOCK];
+    fill_input(left, right);
+    const float *planes[] = {left, right};
+
+    float *out = malloc(2 * BLOCK * CHANNELS * sizeof(float));
+    assert(out);
+
+    print_result(bench_resampler(planes, out));
+    print_result(bench_swr(planes, out));
+
+    free(out);
+    return 0;
+}
@@ -0,0 +1,98 @@
+#include "common.h"
+
+#include <assert.h>
+#include <stdalign.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "util/arena.h"
+
+static bool
+is_aligned(const void *p) {
+    return !((uintptr_t) p % alignof(max_align_t));
+}
+
+static void test_arena_alloc(void) {
+    struct sc_arena arena;
+    sc_arena_init(&arena, 64);
+
+    char *a = sc_arena_alloc(&arena, 3);
+    assert(a);
+    assert(is_aligned(a));
+    memcpy(a, "ab", 3);
+
+    char *b = sc_arena_alloc(&arena, 5);
+    assert(b);
+    assert(is_aligned(b));
+    assert(b > a);
+    memcpy(b, "cdef", 5);
+
+    assert(!strcmp(a, "ab"));
+    assert(!strcmp(b, "cdef"));
+
+    sc_arena_destroy(&arena);
+}
+
+static void test_arena_reuse(void) {
+    struct sc_arena arena;
+    sc_arena_init(&arena, 64);
+
+    void *p = sc_arena_alloc(&arena, 16);
+    assert(p);
+    struct sc_arena_chunk *chunk = arena.chunks;
+
+    for (int i = 0; i < 10; ++i) {
+        sc_arena_reset(&arena);
+        void *q = sc_arena_alloc(&arena, 16);
+        // The same memory is reused, without any new chunk
+        assert(q == p);
+        assert(arena.chunks == chunk);
+        assert(!chunk->next);
+    }
+
+    sc_arena_destroy(&arena);
+}
+
+static void test_arena_grow(void) {
+    struct sc_arena arena;
+    sc_arena_init(&arena, 64);
+
+    // Larger than a chunk
+    char *big = sc_arena_alloc(&arena, 1000);
+    assert(big);
+    memset(big, 'x', 1000);
+
+    char *small = sc_arena_alloc(&arena, 32);
+    assert(small);
+    memset(small, 'y', 32);
+
+    // The previous allocations are still valid
+    assert(big[999] == 'x');
+    assert(small[31] == 'y');
+    assert(arena.chunks->next);
+
+    sc_arena_reset(&arena);
+    assert(!arena.chunks);
+    assert(arena.chunk_size >= 1000 + 64);
+
+    // The same working set now fits in a single chunk
+    big = sc_arena_alloc(&arena, 1000);
+    assert(big);
+    small = sc_arena_alloc(&arena, 32);
+    assert(small);
+    assert(!arena.chunks->next);
+
+    sc_arena_destroy(&arena);
+}
+
+int main(int argc, char *argv[]) {
+    (void) argc;
+    (void) argv;
+
+    test_arena_alloc();
+    test_arena_reuse();
+    test_arena_grow();
+
+    return 0;
+}
@@ -124,6 +124,77 @@ static void test_audiobuf_partial_read_write(void) {
     sc_audiobuf_destroy(&buf);
 }
 
+static void test_audiobuf_spans(void) {
+    struct sc_audiobuf buf;
+
+    bool ok = sc_audiobuf_init(&buf, 4, 6);
+    assert(ok);
+    assert(buf.alloc_size == 8);
+    assert(sc_audiobuf_capacity(&buf) == 6);
+
+    uint32_t samples[] = {1, 2, 3, 4, 5};
+    uint32_t w = sc_audiobuf_write(&buf, samples, 5);
+    assert(w == 5);
+
+    uint32_t r = sc_audiobuf_read(&buf, NULL, 5);
+    assert(r == 5);
+
+    // The write spans wrap around the end of the array
+    struct sc_audiobuf_spans spans;
+    uint32_t count = sc_audiobuf_get_write_spans(&buf, &spans, 10);
+    assert(count == 6);
+    assert(spans.count[0] == 3);
+    assert(spans.count[1] == 3);
+    assert(spans.data[1] == buf.data);
+
+    uint32_t values[] = {10, 11, 12, 13};
+    memcpy(spans.data[0], values, 3 * 4);
+    memcpy(spans.data[1], &values[3], 4);
+    sc_audiobuf_advance_write(&buf, 4);
+
+    assert(sc_audiobuf_can_read(&buf) == 4);
+    assert(sc_audiobuf_can_write(&buf) == 2);
+
+    count = sc_audiobuf_get_read_spans(&buf, &spans, 10);
+    assert(count == 4);
+    assert(spans.count[0] == 3);
+    assert(spans.count[1] == 1);
+    assert(!memcmp(spans.data[0], values, 3 * 4));
+    assert(!memcmp(spans.data[1], &values[3], 4));
+
+    // Nothing is consumed until advance_read()
+    assert(sc_audiobuf_can_read(&buf) == 4);
+    sc_audiobuf_advance_read(&buf, 4);
+    assert(sc_audiobuf_can_read(&buf) == 0);
+
+    sc_audiobuf_destroy(&buf);
+}
+
+static void test_audiobuf_cursor_overflow(void) {
+    struct sc_audiobuf buf;
+    uint32_t data[4];
+
+    bool ok = sc_audiobuf_init(&buf, 4, 4);
+    assert(ok);
+
+    // Start just before the cursors overflow
+    atomic_init(&buf.head, UINT32_MAX - 1);
+    atomic_init(&buf.tail, UINT32_MAX - 1);
+
+    uint32_t samples[] = {1, 2, 3, 4};
+    uint32_t w = sc_audiobuf_write(&buf, samples, 4);
+    assert(w == 4);
+    assert(sc_audiobuf_can_read(&buf) == 4);
+    assert(sc_audiobuf_can_write(&buf) == 0);
+
+    uint32_t r = sc_audiobuf_read(&buf, data, 4);
+    assert(r == 4);
+    assert(!memcmp(data, samples, 16));
+    assert(sc_audiobuf_can_read(&buf) == 0);
+
+    sc_audiobuf_destroy(&buf);
+}
+
 int main(int argc, char *argv[]) {
     (void) argc;
     (void) argv;
@@ -131,6 +202,8 @@ int main(int argc, char *argv[]) {
     test_audiobuf_simple();
     test_audiobuf_boundaries();
     test_audiobuf_partial_read_write();
+    test_audiobuf_spans();
+    test_audiobuf_cursor_overflow();
 
     return 0;
 }
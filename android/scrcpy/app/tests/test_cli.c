@@ -121,6 +121,31 @@ static void test_options2(void) {
     assert(opts->record_format == SC_RECORD_FORMAT_MP4);
 }
 
+static void test_thread_options(void) {
+    struct scrcpy_cli_args args = {
+        .opts = scrcpy_options_default,
+        .help = false,
+        .version = false,
+    };
+
+    char *argv[] = {
+        "scrcpy",
+        "--thread-profile=realtime",
+        "--thread-affinity=video=2-3,audio=1,recording=0",
+        "--thread-affinity=recording=63",
+    };
+
+    bool ok = scrcpy_parse_args(&args, ARRAY_LEN(argv), argv);
+    assert(ok);
+
+    const struct scrcpy_options *opts = &args.opts;
+    assert(opts->thread_profile == SC_THREAD_PROFILE_REALTIME);
+    assert(opts->thread_affinity.video == 0xC);
+    assert(opts->thread_affinity.audio == 0x2);
+    assert(opts->thread_affinity.control == 0);
+    assert(opts->thread_affinity.recording == (UINT64_C(1) << 63 | 1));
+}
+
 static void test_parse_shortcut_mods(void) {
     uint8_t mods;
     bool ok;
@@ -157,6 +182,7 @@ int main(int argc, char *argv[]) {
     test_flag_help();
     test_options();
     test_options2();
+    test_thread_options();
     test_parse_shortcut_mods();
     return 0;
 }
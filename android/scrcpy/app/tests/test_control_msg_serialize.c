@@ -74,6 +74,31 @@ static void test_serialize_inject_text_long(void) {
     assert(!memcmp(buf, expected, sizeof(expected)));
 }
 
+static void test_serialize_inject_text_chunk(void) {
+    struct sc_control_msg msg = {
+        .type = SC_CONTROL_MSG_TYPE_INJECT_TEXT_CHUNK,
+        .inject_text_chunk = {
+            .sequence = UINT64_C(0x0102030405060708),
+            .data = "hello, world!",
+            .size = 5, // only "hello"
+            .last = true,
+        },
+    };
+
+    uint8_t buf[SC_CONTROL_MSG_MAX_SIZE];
+    size_t size = sc_control_msg_serialize(&msg, buf);
+    assert(size == 19);
+
+    const uint8_t expected[] = {
+        SC_CONTROL_MSG_TYPE_INJECT_TEXT_CHUNK,
+        0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, // sequence
+        1, // last
+        0x00, 0x00, 0x00, 0x05, // chunk size
+        'h', 'e', 'l', 'l', 'o', // chunk data
+    };
+    assert(!memcmp(buf, expected, sizeof(expected)));
+}
+
 static void test_serialize_inject_touch_event(void) {
     struct sc_control_msg msg = {
         .type = SC_CONTROL_MSG_TYPE_INJECT_TOUCH_EVENT,
@@ -289,6 +314,32 @@ static void test_serialize_set_clipboard_long(void) {
     assert(!memcmp(buf, expected, sizeof(expected)));
 }
 
+static void test_serialize_set_clipboard_chunk(void) {
+    struct sc_control_msg msg = {
+        .type = SC_CONTROL_MSG_TYPE_SET_CLIPBOARD_CHUNK,
+        .set_clipboard_chunk = {
+            .sequence = UINT64_C(0x0102030405060708),
+            .data = "hello, world!",
+            .size = 5, // only "hello"
+            .paste = true,
+            .last = true,
+        },
+    };
+
+    uint8_t buf[SC_CONTROL_MSG_MAX_SIZE];
+    size_t size = sc_control_msg_serialize(&msg, buf);
+    assert(size == 19);
+
+    const uint8_t expected[] = {
+        SC_CONTROL_MSG_TYPE_SET_CLIPBOARD_CHUNK,
+        0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, // sequence
+        3, // paste | last
+        0x00, 0x00, 0x00, 0x05, // chunk size
+        'h', 'e', 'l', 'l', 'o', // chunk data
+    };
+    assert(!memcmp(buf, expected, sizeof(expected)));
+}
+
 static void test_serialize_set_display_power(void) {
     struct sc_control_msg msg = {
         .type = SC_CONTROL_MSG_TYPE_SET_DISPLAY_POWER,
@@ -426,6 +477,117 @@ static void test_serialize_reset_video(void) {
     assert(!memcmp(buf, expected, sizeof(expected)));
 }
 
+static void test_serialize_set_video_params(void) {
+    struct sc_control_msg msg = {
+        .type = SC_CONTROL_MSG_TYPE_SET_VIDEO_PARAMS,
+        .set_video_params = {
+            .bit_rate = 4000000,
+            .max_size = 1920,
+        },
+    };
+
+    uint8_t buf[SC_CONTROL_MSG_MAX_SIZE];
+    size_t size = sc_control_msg_serialize(&msg, buf);
+    assert(size == 7);
+
+    const uint8_t expected[] = {
+        SC_CONTROL_MSG_TYPE_SET_VIDEO_PARAMS,
+        0x00, 0x3d, 0x09, 0x00, // bit_rate
+        0x07, 0x80, // max_size
+    };
+    assert(!memcmp(buf, expected, sizeof(expected)));
+}
+
+static void test_serialize_set_max_fps(void) {
+    struct sc_control_msg msg = {
+        .type = SC_CONTROL_MSG_TYPE_SET_MAX_FPS,
+        .set_max_fps = {
+            .max_fps = 60,
+        },
+    };
+
+    uint8_t buf[SC_CONTROL_MSG_MAX_SIZE];
+    size_t size = sc_control_msg_serialize(&msg, buf);
+    assert(size == 3);
+
+    const uint8_t expected[] = {
+        SC_CONTROL_MSG_TYPE_SET_MAX_FPS,
+        0x00, 0x3c, // max_fps
+    };
+    assert(!memcmp(buf, expected, sizeof(expected)));
+}
+
+static void test_coalesce_touch_move(void) {
+    struct sc_control_msg msg = {
+        .type = SC_CONTROL_MSG_TYPE_INJECT_TOUCH_EVENT,
+        .inject_touch_event = {
+            .action = AMOTION_EVENT_ACTION_MOVE,
+            .pointer_id = SC_POINTER_ID_MOUSE,
+            .position = {
+                .point = {.x = 100, .y = 200},
+                .screen_size = {.width = 1080, .height = 1920},
+            },
+            .pressure = 1.0f,
+            .action_button = 0,
+            .buttons = AMOTION_EVENT_BUTTON_PRIMARY,
+        },
+    };
+
+    struct sc_control_msg next = msg;
+    next.inject_touch_event.position.point.x = 110;
+    next.inject_touch_event.position.point.y = 220;
+
+    assert(sc_control_msg_coalesce(&msg, &next));
+    assert(msg.inject_touch_event.position.point.x == 110);
+    assert(msg.inject_touch_event.position.point.y == 220);
+
+    // Another pointer
+    next.inject_touch_event.pointer_id = 42;
+    assert(!sc_control_msg_coalesce(&msg, &next));
+
+    // Not a move
+    next = msg;
+    next.inject_touch_event.action = AMOTION_EVENT_ACTION_UP;
+    next.inject_touch_event.action_button = AMOTION_EVENT_BUTTON_PRIMARY;
+    next.inject_touch_event.buttons = 0;
+    assert(!sc_control_msg_coalesce(&msg, &next));
+}
+
+static void test_coalesce_scroll(void) {
+    struct sc_control_msg msg = {
+        .type = SC_CONTROL_MSG_TYPE_INJECT_SCROLL_EVENT,
+        .inject_scroll_event = {
+            .position = {
+                .point = {.x = 260, .y = 1026},
+                .screen_size = {.width = 1080, .height = 1920},
+            },
+            .hscroll = 1,
+            .vscroll = -1,
+            .buttons = 0,
+        },
+    };
+
+    struct sc_control_msg next = msg;
+    next.inject_scroll_event.vscroll = -2;
+
+    assert(sc_control_msg_coalesce(&msg, &next));
+    assert(msg.inject_scroll_event.hscroll == 2);
+    assert(msg.inject_scroll_event.vscroll == -3);
+
+    // The sum would be clamped
+    next.inject_scroll_event.vscroll = -14;
+    assert(!sc_control_msg_coalesce(&msg, &next));
+
+    // Another position
+    next = msg;
+    next.inject_scroll_event.position.point.x = 261;
+    assert(!sc_control_msg_coalesce(&msg, &next));
+
+    // Another type
+    next.type = SC_CONTROL_MSG_TYPE_RESET_VIDEO;
+    assert(!sc_control_msg_coalesce(&msg, &next));
+}
+
 int main(int argc, char *argv[]) {
     (void) argc;
     (void) argv;
@@ -433,6 +595,7 @@ int main(int argc, char *argv[]) {
     test_serialize_inject_keycode();
     test_serialize_inject_text();
     test_serialize_inject_text_long();
+    test_serialize_inject_text_chunk();
     test_serialize_inject_touch_event();
     test_serialize_inject_scroll_event();
     test_serialize_back_or_screen_on();
@@ -442,6 +605,7 @@ int main(int argc, char *argv[]) {
     test_serialize_get_clipboard();
     test_serialize_set_clipboard();
     test_serialize_set_clipboard_long();
+    test_serialize_set_clipboard_chunk();
     test_serialize_set_display_power();
     test_serialize_rotate_device();
     test_serialize_uhid_create();
@@ -449,5 +613,10 @@ int main(int argc, char *argv[]) {
     test_serialize_uhid_destroy();
     test_serialize_open_hard_keyboard();
     test_serialize_reset_video();
+    test_serialize_set_video_params();
+    test_serialize_set_max_fps();
+
+    test_coalesce_touch_move();
+    test_coalesce_scroll();
     return 0;
 }
@@ -0,0 +1,103 @@
+#include "common.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "damage_tracker.h"
+#include "util/yuv.h"
+
+#define WIDTH 320
+#define HEIGHT 256
+
+struct test_frame {
+    AVFrame frame;
+    uint8_t y[WIDTH * HEIGHT];
+    uint8_t u[WIDTH / 2 * HEIGHT / 2];
+    uint8_t v[WIDTH / 2 * HEIGHT / 2];
+};
+
+static void init_frame(struct test_frame *f) {
+    memset(&f->frame, 0, sizeof(f->frame));
+    f->frame.width = WIDTH;
+    f->frame.height = HEIGHT;
+    f->frame.format = AV_PIX_FMT_YUV420P;
+    f->frame.data[0] = f->y;
+    f->frame.data[1] = f->u;
+    f->frame.data[2] = f->v;
+    f->frame.linesize[0] = WIDTH;
+    f->frame.linesize[1] = WIDTH / 2;
+    f->frame.linesize[2] = WIDTH / 2;
+    memset(f->y, 16, sizeof(f->y));
+    memset(f->u, 128, sizeof(f->u));
+    memset(f->v, 128, sizeof(f->v));
+}
+
+static void test_damage_tracker(void) {
+    struct test_frame *f = malloc(sizeof(*f));
+    assert(f);
+    init_frame(f);
+
+    struct sc_damage_tracker tracker;
+    sc_damage_tracker_init(&tracker);
+
+    struct sc_damage_rect rects[SC_DAMAGE_TRACKER_MAX_RECTS];
+
+    // The first frame is fully damaged
+    unsigned count = sc_damage_tracker_update(&tracker, &f->frame, rects);
+    assert(count == 1);
+    assert(rects[0].x == 0 && rects[0].y == 0);
+    assert(rects[0].width == WIDTH && rects[0].height == HEIGHT);
+
+    // Unchanged
+    count = sc_damage_tracker_update(&tracker, &f->frame, rects);
+    assert(count == 0);
+
+    // One luma pixel in the tile (1, 2)
+    f->y[130 * WIDTH + 100] = 200;
+    count = sc_damage_tracker_update(&tracker, &f->frame, rects);
+    assert(count == 1);
+    assert(rects[0].x == 64 && rects[0].y == 128);
+    assert(rects[0].width == 64 && rects[0].height == 64);
+
+    // One chroma sample in the last tile (4, 3), vertically adjacent to a
+    // change in the tile (4, 2): merged
+    f->v[(HEIGHT / 2 - 1) * (WIDTH / 2) + WIDTH / 2 - 1] = 0;
+    f->y[150 * WIDTH + 300] = 0;
+    count = sc_damage_tracker_update(&tracker, &f->frame, rects);
+    assert(count == 1);
+    assert(rects[0].x == 256 && rects[0].y == 128);
+    assert(rects[0].width == 64 && rects[0].height == 128);
+
+    // Two separate regions
+    f->y[0] = 1;
+    f->y[200 * WIDTH + 200] = 1;
+    count = sc_damage_tracker_update(&tracker, &f->frame, rects);
+    assert(count == 2);
+    assert(rects[0].x == 0 && rects[0].y == 0);
+    assert(rects[1].x == 192 && rects[1].y == 192);
+
+    // After a reset, the frame is fully damaged
+    sc_damage_tracker_reset(&tracker);
+    count = sc_damage_tracker_update(&tracker, &f->frame, rects);
+    assert(count == 1);
+    assert(rects[0].width == WIDTH && rects[0].height == HEIGHT);
+
+    // More than half of the frame changed
+    memset(f->y, 50, sizeof(f->y) * 3 / 4);
+    count = sc_damage_tracker_update(&tracker, &f->frame, rects);
+    assert(count == 1);
+    assert(rects[0].width == WIDTH && rects[0].height == HEIGHT);
+
+    sc_damage_tracker_destroy(&tracker);
+    free(f);
+}
+
+int main(int argc, char *argv[]) {
+    (void) argc;
+    (void) argv;
+
+    sc_yuv_init();
+    test_damage_tracker();
+    return 0;
+}
@@ -19,10 +19,10 @@ static void test_deserialize_clipboard(void) {
     assert(r == 8);
 
     assert(msg.type == DEVICE_MSG_TYPE_CLIPBOARD);
-    assert(msg.clipboard.text);
-    assert(!strcmp("ABC", msg.clipboard.text));
-
-    sc_device_msg_destroy(&msg);
+    assert(msg.clipboard.length == 3);
+    assert(!memcmp("ABC", msg.clipboard.text, 3));
+    // The text is not copied
+    assert(msg.clipboard.text == (const char *) &input[5]);
 }
 
 static void test_deserialize_clipboard_big(void) {
@@ -41,10 +41,8 @@ static void test_deserialize_clipboard_big(void) {
 
     assert(msg.type == DEVICE_MSG_TYPE_CLIPBOARD);
     assert(msg.clipboard.text);
-    assert(strlen(msg.clipboard.text) == DEVICE_MSG_TEXT_MAX_LENGTH);
+    assert(msg.clipboard.length == DEVICE_MSG_TEXT_MAX_LENGTH);
     assert(msg.clipboard.text[0] == 'a');
-
-    sc_device_msg_destroy(&msg);
 }
 
 static void test_deserialize_ack_set_clipboard(void) {
@@ -79,8 +77,19 @@ static void test_deserialize_uhid_output(void) {
 
     uint8_t expected[] = {1, 2, 3, 4, 5};
     assert(!memcmp(msg.uhid_output.data, expected, sizeof(expected)));
+}
+
+static void test_deserialize_uhid_output_partial(void) {
+    const uint8_t input[] = {
+        DEVICE_MSG_TYPE_UHID_OUTPUT,
+        0, 42, // id
+        0, 5, // size
+        0x01, 0x02, 0x03, // incomplete data
+    };
 
-    sc_device_msg_destroy(&msg);
+    struct sc_device_msg msg;
+    ssize_t r = sc_device_msg_deserialize(input, sizeof(input), &msg);
+    assert(r == 0);
 }
 
 int main(int argc, char *argv[]) {
@@ -91,5 +100,6 @@ int main(int argc, char *argv[]) {
     test_deserialize_clipboard_big();
     test_deserialize_ack_set_clipboard();
     test_deserialize_uhid_output();
+    test_deserialize_uhid_output_partial();
     return 0;
 }
@@ -0,0 +1,81 @@
+#include "common.h"
+
+#include <assert.h>
+
+#include "util/histogram.h"
+
+static void test_histogram_empty(void) {
+    struct sc_histogram hist;
+    sc_histogram_init(&hist);
+
+    struct sc_histogram_stats stats;
+    sc_histogram_get_stats(&hist, &stats);
+    assert(stats.count == 0);
+    assert(stats.max == 0);
+    assert(sc_histogram_get_percentile(&hist, 50) == 0);
+}
+
+static void test_histogram_exact_small_values(void) {
+    struct sc_histogram hist;
+    sc_histogram_init(&hist);
+
+    for (int i = 0; i < SC_HISTOGRAM_SUB_COUNT; ++i) {
+        sc_histogram_record(&hist, i);
+    }
+
+    struct sc_histogram_stats stats;
+    sc_histogram_get_stats(&hist, &stats);
+    assert(stats.count == SC_HISTOGRAM_SUB_COUNT);
+    assert(stats.min == 0);
+    assert(stats.max == SC_HISTOGRAM_SUB_COUNT - 1);
+    assert(stats.p50 == SC_HISTOGRAM_SUB_COUNT / 2 - 1);
+}
+
+static void test_histogram_percentiles(void) {
+    struct sc_histogram hist;
+    sc_histogram_init(&hist);
+
+    // 1..1000
+    for (int i = 1; i <= 1000; ++i) {
+        sc_histogram_record(&hist, i);
+    }
+
+    struct sc_histogram_stats stats;
+    sc_histogram_get_stats(&hist, &stats);
+    assert(stats.count == 1000);
+    assert(stats.min == 1);
+    assert(stats.max == 1000);
+    assert(stats.mean == 500);
+
+    // The result never underestimates, and the relative error is bounded
+    assert(stats.p50 >= 500 && stats.p50 < 500 + 500 / 16 + 1);
+    assert(stats.p90 >= 900 && stats.p90 < 900 + 900 / 16 + 1);
+    assert(stats.p99 >= 990 && stats.p99 <= 1000);
+    assert(sc_histogram_get_percentile(&hist, 100) == 1000);
+}
+
+static void test_histogram_clamp(void) {
+    struct sc_histogram hist;
+    sc_histogram_init(&hist);
+
+    sc_histogram_record(&hist, -42);
+    sc_histogram_record(&hist, INT64_MAX);
+
+    struct sc_histogram_stats stats;
+    sc_histogram_get_stats(&hist, &stats);
+    assert(stats.count == 2);
+    assert(stats.min == 0);
+    assert(stats.max == (UINT64_C(1) << SC_HISTOGRAM_MAX_BITS) - 1);
+}
+
+int main(int argc, char *argv[]) {
+    (void) argc;
+    (void) argv;
+
+    test_histogram_empty();
+    test_histogram_exact_small_values();
+    test_histogram_percentiles();
+    test_histogram_clamp();
+
+    return 0;
+}
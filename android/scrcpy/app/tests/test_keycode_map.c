@@ -0,0 +1,107 @@
+#include "common.h"
+
+#include <assert.h>
+
+#include "keycode_map.h"
+
+static void test_keycode_special(void) {
+    enum android_keycode to;
+    bool ok = sc_keycode_to_android(SC_KEYCODE_RETURN, 0,
+                                    SC_KEY_INJECT_MODE_TEXT, &to);
+    assert(ok);
+    assert(to == AKEYCODE_ENTER);
+
+    ok = sc_keycode_to_android(SC_KEYCODE_RGUI, 0, SC_KEY_INJECT_MODE_TEXT,
+                               &to);
+    assert(ok);
+    assert(to == AKEYCODE_META_RIGHT);
+
+    ok = sc_keycode_to_android(SC_KEYCODE_UP, 0, SC_KEY_INJECT_MODE_TEXT, &to);
+    assert(ok);
+    assert(to == AKEYCODE_DPAD_UP);
+}
+
+static void test_keycode_numpad(void) {
+    enum android_keycode to;
+
+    // Num Lock disabled: navigation
+    bool ok = sc_keycode_to_android(SC_KEYCODE_KP_1, 0, SC_KEY_INJECT_MODE_RAW,
+                                    &to);
+    assert(ok);
+    assert(to == AKEYCODE_MOVE_END);
+
+    // Num Lock enabled: digits in raw mode only
+    ok = sc_keycode_to_android(SC_KEYCODE_KP_1, SC_MOD_NUM,
+                               SC_KEY_INJECT_MODE_RAW, &to);
+    assert(ok);
+    assert(to == AKEYCODE_NUMPAD_1);
+
+    ok = sc_keycode_to_android(SC_KEYCODE_KP_1, SC_MOD_NUM,
+                               SC_KEY_INJECT_MODE_MIXED, &to);
+    assert(!ok);
+}
+
+static void test_keycode_letters(void) {
+    enum android_keycode to;
+    bool ok = sc_keycode_to_android(SC_KEYCODE_a, 0, SC_KEY_INJECT_MODE_MIXED,
+                                    &to);
+    assert(ok);
+    assert(to == AKEYCODE_A);
+
+    ok = sc_keycode_to_android(SC_KEYCODE_z, 0, SC_KEY_INJECT_MODE_MIXED, &to);
+    assert(ok);
+    assert(to == AKEYCODE_Z);
+
+    // Letters are injected as text in text mode, unless Ctrl is pressed
+    ok = sc_keycode_to_android(SC_KEYCODE_a, 0, SC_KEY_INJECT_MODE_TEXT, &to);
+    assert(!ok);
+
+    ok = sc_keycode_to_android(SC_KEYCODE_a, SC_MOD_LCTRL,
+                               SC_KEY_INJECT_MODE_TEXT, &to);
+    assert(ok);
+    assert(to == AKEYCODE_A);
+}
+
+static void test_keycode_punct(void) {
+    enum android_keycode to;
+    bool ok = sc_keycode_to_android(SC_KEYCODE_SLASH, 0,
+                                    SC_KEY_INJECT_MODE_RAW, &to);
+    assert(ok);
+    assert(to == AKEYCODE_SLASH);
+
+    ok = sc_keycode_to_android(SC_KEYCODE_SLASH, 0, SC_KEY_INJECT_MODE_MIXED,
+                               &to);
+    assert(!ok);
+}
+
+static void test_keycode_unmapped(void) {
+    enum android_keycode to;
+    bool ok = sc_keycode_to_android(SC_KEYCODE_UNKNOWN, 0,
+                                    SC_KEY_INJECT_MODE_RAW, &to);
+    assert(!ok);
+
+    ok = sc_keycode_to_android(SC_KEYCODE_F1, 0, SC_KEY_INJECT_MODE_RAW, &to);
+    assert(!ok);
+
+    // Unicode keycodes (for example 'é') are outside the tables
+    ok = sc_keycode_to_android(0xE9, 0, SC_KEY_INJECT_MODE_RAW, &to);
+    assert(!ok);
+
+    // Out-of-range scancode
+    ok = sc_keycode_to_android(SDLK_SCANCODE_MASK | 0xFFFF, 0,
+                               SC_KEY_INJECT_MODE_RAW, &to);
+    assert(!ok);
+}
+
+int main(int argc, char *argv[]) {
+    (void) argc;
+    (void) argv;
+
+    test_keycode_special();
+    test_keycode_numpad();
+    test_keycode_letters();
+    test_keycode_punct();
+    test_keycode_unmapped();
+
+    return 0;
+}
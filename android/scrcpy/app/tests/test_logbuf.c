@@ -0,0 +1,108 @@
+#include "common.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "util/logbuf.h"
+
+static void test_logbuf_simple(void) {
+    struct sc_logbuf buf;
+    bool ok = sc_logbuf_init(&buf, 4);
+    assert(ok);
+
+    int priority;
+    assert(!sc_logbuf_peek(&buf, &priority));
+
+    ok = sc_logbuf_push(&buf, 3, "hello");
+    assert(ok);
+    ok = sc_logbuf_push(&buf, 5, "world");
+    assert(ok);
+
+    const char *text = sc_logbuf_peek(&buf, &priority);
+    assert(text);
+    assert(!strcmp(text, "hello"));
+    assert(priority == 3);
+    sc_logbuf_consume(&buf);
+
+    text = sc_logbuf_peek(&buf, &priority);
+    assert(text);
+    assert(!strcmp(text, "world"));
+    assert(priority == 5);
+    sc_logbuf_consume(&buf);
+
+    assert(!sc_logbuf_peek(&buf, &priority));
+
+    sc_logbuf_destroy(&buf);
+}
+
+static void test_logbuf_full(void) {
+    struct sc_logbuf buf;
+    bool ok = sc_logbuf_init(&buf, 4);
+    assert(ok);
+
+    int priority;
+    char message[16];
+
+    // Several laps, to check the sequence numbers
+    for (int lap = 0; lap < 3; ++lap) {
+        for (int i = 0; i < 4; ++i) {
+            sprintf(message, "%d-%d", lap, i);
+            ok = sc_logbuf_push(&buf, i, message);
+            assert(ok);
+        }
+
+        ok = sc_logbuf_push(&buf, 0, "overflow");
+        assert(!ok);
+
+        for (int i = 0; i < 4; ++i) {
+            const char *text = sc_logbuf_peek(&buf, &priority);
+            assert(text);
+            sprintf(message, "%d-%d", lap, i);
+            assert(!strcmp(text, message));
+            assert(priority == i);
+            sc_logbuf_consume(&buf);
+        }
+
+        assert(!sc_logbuf_peek(&buf, &priority));
+    }
+
+    sc_logbuf_destroy(&buf);
+}
+
+static void test_logbuf_long_message(void) {
+    struct sc_logbuf buf;
+    bool ok = sc_logbuf_init(&buf, 2);
+    assert(ok);
+
+    char message[SC_LOGBUF_TEXT_SIZE * 3];
+    memset(message, 'a', sizeof(message) - 1);
+    message[sizeof(message) - 1] = '\0';
+
+    ok = sc_logbuf_push(&buf, 1, message);
+    assert(ok);
+
+    // Not consumed: must be released on destroy
+    ok = sc_logbuf_push(&buf, 2, message);
+    assert(ok);
+
+    int priority;
+    const char *text = sc_logbuf_peek(&buf, &priority);
+    assert(text);
+    assert(!strcmp(text, message));
+    assert(priority == 1);
+    sc_logbuf_consume(&buf);
+
+    sc_logbuf_destroy(&buf);
+}
+
+int main(int argc, char *argv[]) {
+    (void) argc;
+    (void) argv;
+
+    test_logbuf_simple();
+    test_logbuf_full();
+    test_logbuf_long_message();
+
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include "common.h"
+
+#include <assert.h>
+
+#include "memory_budget.h"
+
+static void test_memory_budget_limit(void) {
+    sc_memory_budget_init(1000);
+
+    assert(sc_memory_budget_reserve(SC_MEMORY_BUDGET_RECORDER, 600));
+    assert(sc_memory_budget_reserve(SC_MEMORY_BUDGET_CONTROL, 400));
+    assert(sc_memory_budget_get_total() == 1000);
+
+    // Exceeded, nothing is reserved
+    assert(!sc_memory_budget_reserve(SC_MEMORY_BUDGET_DELAY_BUFFER, 1));
+    assert(sc_memory_budget_get_usage(SC_MEMORY_BUDGET_DELAY_BUFFER) == 0);
+    assert(sc_memory_budget_get_total() == 1000);
+
+    sc_memory_budget_release(SC_MEMORY_BUDGET_RECORDER, 100);
+    assert(sc_memory_budget_reserve(SC_MEMORY_BUDGET_DELAY_BUFFER, 100));
+    assert(sc_memory_budget_get_usage(SC_MEMORY_BUDGET_RECORDER) == 500);
+    assert(sc_memory_budget_get_usage(SC_MEMORY_BUDGET_DELAY_BUFFER) == 100);
+    assert(sc_memory_budget_get_peak() == 1000);
+}
+
+static void test_memory_budget_force(void) {
+    sc_memory_budget_init(100);
+
+    sc_memory_budget_force_reserve(SC_MEMORY_BUDGET_RECORDER, 150);
+    assert(sc_memory_budget_get_total() == 150);
+    assert(sc_memory_budget_get_peak() == 150);
+    assert(!sc_memory_budget_reserve(SC_MEMORY_BUDGET_CONTROL, 1));
+
+    sc_memory_budget_release(SC_MEMORY_BUDGET_RECORDER, 150);
+    assert(sc_memory_budget_get_total() == 0);
+    assert(sc_memory_budget_get_peak() == 150);
+}
+
+static void test_memory_budget_unlimited(void) {
+    sc_memory_budget_init(0);
+
+    assert(sc_memory_budget_reserve(SC_MEMORY_BUDGET_CONTROL, UINT64_C(1) << 40));
+    assert(sc_memory_budget_get_usage(SC_MEMORY_BUDGET_CONTROL)
+                == UINT64_C(1) << 40);
+    assert(sc_memory_budget_get_limit() == 0);
+}
+
+int main(int argc, char *argv[]) {
+    (void) argc;
+    (void) argv;
+
+    test_memory_budget_limit();
+    test_memory_budget_force();
+    test_memory_budget_unlimited();
+
+    return 0;
+}
@@ -0,0 +1,143 @@
+#include "common.h"
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "util/mpsc_ring.h"
+#include "util/ring_waiter.h"
+#include "util/thread.h"
+
+struct ring_int SC_MPSC_RING(int, 4);
+
+static void test_mpsc_ring_simple(void) {
+    struct ring_int ring;
+    sc_mpsc_ring_init(&ring);
+
+    assert(sc_mpsc_ring_capacity(&ring) == 4);
+    assert(sc_mpsc_ring_is_empty(&ring));
+    assert(sc_mpsc_ring_size(&ring) == 0);
+
+    int item;
+    assert(!sc_mpsc_ring_pop(&ring, &item));
+
+    // Several laps, to check the sequence numbers
+    for (int lap = 0; lap < 3; ++lap) {
+        for (int i = 0; i < 4; ++i) {
+            bool ok = sc_mpsc_ring_push(&ring, lap * 10 + i);
+            assert(ok);
+        }
+        assert(sc_mpsc_ring_size(&ring) == 4);
+
+        // Full
+        bool ok = sc_mpsc_ring_push(&ring, 42);
+        assert(!ok);
+
+        for (int i = 0; i < 4; ++i) {
+            ok = sc_mpsc_ring_pop(&ring, &item);
+            assert(ok);
+            assert(item == lap * 10 + i);
+        }
+        assert(sc_mpsc_ring_is_empty(&ring));
+    }
+}
+
+#define PRODUCERS 4
+#define STRESS_COUNT 50000
+
+struct ring_item {
+    int producer;
+    int value;
+};
+
+struct stress {
+    struct SC_MPSC_RING(struct ring_item, 64) ring;
+    struct sc_ring_waiter waiter;
+    atomic_int remaining_producers;
+};
+
+struct producer {
+    struct stress *stress;
+    int id;
+};
+
+static int
+run_producer(void *data) {
+    struct producer *producer = data;
+    struct stress *stress = producer->stress;
+
+    for (int i = 0; i < STRESS_COUNT; ++i) {
+        struct ring_item item = {producer->id, i};
+        while (!sc_mpsc_ring_push(&stress->ring, item)) {
+            // Full, let the consumer progress
+            sc_ring_waiter_notify(&stress->waiter);
+        }
+        sc_ring_waiter_notify(&stress->waiter);
+    }
+
+    atomic_fetch_sub(&stress->remaining_producers, 1);
+    sc_ring_waiter_wake_up(&stress->waiter);
+    return 0;
+}
+
+static void test_mpsc_ring_threads(void) {
+    struct stress stress;
+    sc_mpsc_ring_init(&stress.ring);
+    atomic_init(&stress.remaining_producers, PRODUCERS);
+    bool ok = sc_ring_waiter_init(&stress.waiter);
+    assert(ok);
+
+    sc_thread threads[PRODUCERS];
+    struct producer producers[PRODUCERS];
+    for (int i = 0; i < PRODUCERS; ++i) {
+        producers[i].stress = &stress;
+        producers[i].id = i;
+        ok = sc_thread_create(&threads[i], run_producer, "test-producer",
+                              &producers[i]);
+        assert(ok);
+    }
+
+    int expected[PRODUCERS];
+    memset(expected, 0, sizeof(expected));
+    int total = 0;
+
+    for (;;) {
+        struct ring_item item;
+        if (sc_mpsc_ring_pop(&stress.ring, &item)) {
+            // The items of each producer are received in order, without loss
+            assert(item.producer >= 0 && item.producer < PRODUCERS);
+            assert(item.value == expected[item.producer]);
+            ++expected[item.producer];
+            ++total;
+            continue;
+        }
+
+        if (!atomic_load(&stress.remaining_producers)
+                && sc_mpsc_ring_is_empty(&stress.ring)) {
+            break;
+        }
+
+        sc_ring_waiter_wait(&stress.waiter,
+                            !atomic_load(&stress.remaining_producers)
+                                || !sc_mpsc_ring_is_empty(&stress.ring));
+    }
+
+    assert(total == PRODUCERS * STRESS_COUNT);
+    assert(!sc_mpsc_ring_size(&stress.ring));
+
+    for (int i = 0; i < PRODUCERS; ++i) {
+        sc_thread_join(&threads[i], NULL);
+    }
+    sc_ring_waiter_destroy(&stress.waiter);
+}
+
+int main(int argc, char *argv[]) {
+    (void) argc;
+    (void) argv;
+
+    test_mpsc_ring_simple();
+    test_mpsc_ring_threads();
+
+    return 0;
+}
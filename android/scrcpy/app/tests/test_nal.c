@@ -0,0 +1,85 @@
+#include "common.h"
+
+#include <assert.h>
+
+#include "util/nal.h"
+
+static void test_h264(void) {
+    // SPS, PPS, IDR slice
+    const uint8_t idr[] = {
+        0, 0, 0, 1, 0x67, 0x42, 0x00,
+        0, 0, 0, 1, 0x68, 0xCE,
+        0, 0, 1, 0x65, 0x88, 0x84,
+    };
+    assert(!sc_nal_h264_is_non_reference(idr, sizeof(idr)));
+
+    // Reference P slice (nal_ref_idc = 2)
+    const uint8_t ref[] = {0, 0, 0, 1, 0x41, 0x9A, 0x00};
+    assert(!sc_nal_h264_is_non_reference(ref, sizeof(ref)));
+
+    // Non-reference slice (nal_ref_idc = 0), preceded by an SEI
+    const uint8_t nonref[] = {
+        0, 0, 0, 1, 0x06, 0x05, 0x01,
+        0, 0, 1, 0x01, 0x9E, 0x00,
+    };
+    assert(sc_nal_h264_is_non_reference(nonref, sizeof(nonref)));
+
+    // Several slices, one of them is a reference
+    const uint8_t mixed[] = {
+        0, 0, 1, 0x01, 0x9E,
+        0, 0, 1, 0x21, 0x9E,
+    };
+    assert(!sc_nal_h264_is_non_reference(mixed, sizeof(mixed)));
+
+    // No slice at all
+    const uint8_t config[] = {0, 0, 0, 1, 0x67, 0x42, 0, 0, 0, 1, 0x68};
+    assert(!sc_nal_h264_is_non_reference(config, sizeof(config)));
+
+    assert(!sc_nal_h264_is_non_reference(NULL, 0));
+
+    // Truncated start code
+    const uint8_t truncated[] = {0, 0, 1};
+    assert(!sc_nal_h264_is_non_reference(truncated, sizeof(truncated)));
+}
+
+static void test_h265(void) {
+    // IDR_W_RADL (type 19)
+    const uint8_t idr[] = {0, 0, 0, 1, 19 << 1, 0x01, 0xAF};
+    assert(!sc_nal_h265_is_non_reference(idr, sizeof(idr)));
+
+    // TRAIL_R (type 1)
+    const uint8_t ref[] = {0, 0, 0, 1, 1 << 1, 0x01, 0xD0};
+    assert(!sc_nal_h265_is_non_reference(ref, sizeof(ref)));
+
+    // Prefix SEI (type 39), then TRAIL_N (type 0)
+    const uint8_t nonref[] = {
+        0, 0, 0, 1, 39 << 1, 0x01, 0x05,
+        0, 0, 1, 0 << 1, 0x01, 0xD0,
+    };
+    assert(sc_nal_h265_is_non_reference(nonref, sizeof(nonref)));
+
+    // TSA_N (type 2), RASL_N (type 8)
+    const uint8_t nonref2[] = {
+        0, 0, 1, 2 << 1, 0x01,
+        0, 0, 1, 8 << 1, 0x01,
+    };
+    assert(sc_nal_h265_is_non_reference(nonref2, sizeof(nonref2)));
+
+    // VPS, SPS, PPS only
+    const uint8_t config[] = {
+        0, 0, 0, 1, 32 << 1, 0x01,
+        0, 0, 0, 1, 33 << 1, 0x01,
+        0, 0, 0, 1, 34 << 1, 0x01,
+    };
+    assert(!sc_nal_h265_is_non_reference(config, sizeof(config)));
+}
+
+int main(int argc, char *argv[]) {
+    (void) argc;
+    (void) argv;
+
+    test_h264();
+    test_h265();
+
+    return 0;
+}
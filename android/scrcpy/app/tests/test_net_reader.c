@@ -0,0 +1,69 @@
+#include "common.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "util/net.h"
+
+static void test_net_reader(void) {
+    bool ok = net_init();
+    assert(ok);
+
+    sc_socket sockets[2];
+    ok = net_socketpair(sockets);
+    assert(ok);
+
+    // Small messages (sliced out of the buffer) and a large one (received
+    // directly), with a buffer small enough to be compacted
+    uint8_t data[300];
+    for (size_t i = 0; i < sizeof(data); ++i) {
+        data[i] = i;
+    }
+    ssize_t w = net_send_all(sockets[0], data, sizeof(data));
+    assert(w == sizeof(data));
+
+    struct sc_net_reader reader;
+    ok = sc_net_reader_init(&reader, sockets[1], 64);
+    assert(ok);
+
+    size_t offset = 0;
+    for (int i = 0; i < 20; ++i) {
+        const uint8_t *p = sc_net_reader_next(&reader, 7);
+        assert(p);
+        assert(!memcmp(p, &data[offset], 7));
+        offset += 7;
+    }
+
+    uint8_t out[100];
+    ok = sc_net_reader_read_all(&reader, out, 20);
+    assert(ok);
+    assert(!memcmp(out, &data[offset], 20));
+    offset += 20;
+
+    ok = sc_net_reader_read_all(&reader, out, 100);
+    assert(ok);
+    assert(!memcmp(out, &data[offset], 100));
+    offset += 100;
+
+    size_t remaining = sizeof(data) - offset;
+    const uint8_t *p = sc_net_reader_next(&reader, remaining);
+    assert(p);
+    assert(!memcmp(p, &data[offset], remaining));
+
+    // End of stream
+    net_close(sockets[0]);
+    p = sc_net_reader_next(&reader, 1);
+    assert(!p);
+
+    sc_net_reader_destroy(&reader);
+    net_close(sockets[1]);
+    net_cleanup();
+}
+
+int main(int argc, char *argv[]) {
+    (void) argc;
+    (void) argv;
+
+    test_net_reader();
+    return 0;
+}
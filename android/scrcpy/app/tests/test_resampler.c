@@ -0,0 +1,150 @@
+#include "common.h"
+
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+
+#include "util/resampler.h"
+
+static void test_resampler_passthrough(void) {
+    struct sc_resampler r;
+    bool ok = sc_resampler_init(&r, 2);
+    assert(ok);
+
+    float in[2 * 100];
+    for (unsigned i = 0; i < 2 * 100; ++i) {
+        in[i] = (float) i / 200;
+    }
+
+    float out[2 * 200];
+    const float *planes[] = {in};
+    int32_t n = sc_resampler_process(&r, out, 200, planes, false, 100);
+    // The interpolation requires 2 frames of lookahead
+    assert(n == 98);
+    assert(sc_resampler_get_delay(&r) == 2);
+
+    // Without compensation, the samples are output unchanged
+    assert(!memcmp(out, in, 98 * 2 * sizeof(float)));
+
+    // The remaining frames are output once more input is available
+    n = sc_resampler_process(&r, out, 200, planes, false, 100);
+    assert(n == 100);
+    assert(!memcmp(out, &in[2 * 98], 2 * 2 * sizeof(float)));
+    assert(!memcmp(&out[2 * 2], in, 98 * 2 * sizeof(float)));
+
+    sc_resampler_destroy(&r);
+}
+
+static void test_resampler_planar(void) {
+    struct sc_resampler r;
+    bool ok = sc_resampler_init(&r, 2);
+    assert(ok);
+
+    float left[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    float right[10] = {-1, -2, -3, -4, -5, -6, -7, -8, -9, -10};
+    const float *planes[] = {left, right};
+
+    float out[2 * 10];
+    int32_t n = sc_resampler_process(&r, out, 10, planes, true, 10);
+    assert(n == 8);
+    for (int i = 0; i < n; ++i) {
+        assert(out[2 * i] == left[i]);
+        assert(out[2 * i + 1] == right[i]);
+    }
+
+    sc_resampler_destroy(&r);
+}
+
+static void test_resampler_compensation(void) {
+    struct sc_resampler r;
+    bool ok = sc_resampler_init(&r, 2);
+    assert(ok);
+
+    ok = sc_resampler_set_compensation(&r, 100, 10000);
+    assert(ok);
+
+    // Constant input
+    float in[2 * 1000];
+    for (unsigned i = 0; i < 2 * 1000; ++i) {
+        in[i] = 0.5f;
+    }
+    const float *planes[] = {in};
+
+    float out[2 * 1100];
+    uint32_t total_in = 0;
+    uint32_t total_out = 0;
+    for (int i = 0; i < 20; ++i) {
+        int32_t n = sc_resampler_process(&r, out, 1100, planes, false, 1000);
+        assert(n > 0);
+        // Skip the first frames, interpolated with the initial silent history
+        for (int j = i ? 0 : 4; j < 2 * n; ++j) {
+            assert(fabsf(out[j] - 0.5f) < 1e-5f);
+        }
+        total_in += 1000;
+        total_out += n;
+    }
+
+    // 100 frames are added over 10100 output frames, then the compensation
+    // stops
+    uint32_t delay = sc_resampler_get_delay(&r);
+    // (up to 1 frame of error, because of the fractional position)
+    int32_t added = (int32_t) (total_out + delay) - (int32_t) total_in;
+    assert(added >= 99 && added <= 101);
+
+    sc_resampler_destroy(&r);
+}
+
+static void test_resampler_sine(void) {
+    struct sc_resampler r;
+    bool ok = sc_resampler_init(&r, 1);
+    assert(ok);
+
+    ok = sc_resampler_set_compensation(&r, -200, 10000);
+    assert(ok);
+
+    // 440 Hz at 48 kHz: the interpolated samples must remain on the curve
+    float in[4800];
+    for (unsigned i = 0; i < 4800; ++i) {
+        in[i] = sinf(2 * M_PI * 440 * i / 48000);
+    }
+    const float *planes[] = {in};
+
+    float out[4800];
+    int32_t n = sc_resampler_process(&r, out, 4800, planes, false, 4800);
+    assert(n > 4650 && n < 4710);
+
+    double step = 10000. / 9800;
+    for (int i = 2; i < n; ++i) {
+        float expected = sinf(2 * M_PI * 440 * (i * step) / 48000);
+        assert(fabsf(out[i] - expected) < 1e-3f);
+    }
+
+    sc_resampler_destroy(&r);
+}
+
+static void test_resampler_invalid_compensation(void) {
+    struct sc_resampler r;
+    bool ok = sc_resampler_init(&r, 2);
+    assert(ok);
+
+    ok = sc_resampler_set_compensation(&r, 5000, 10000);
+    assert(!ok);
+
+    ok = sc_resampler_set_compensation(&r, 0, 0);
+    assert(ok);
+
+    sc_resampler_destroy(&r);
+}
+
+int main(int argc, char *argv[]) {
+    (void) argc;
+    (void) argv;
+
+    test_resampler_passthrough();
+    test_resampler_planar();
+    test_resampler_compensation();
+    test_resampler_sine();
+    test_resampler_invalid_compensation();
+
+    return 0;
+}
@@ -0,0 +1,115 @@
+#include "common.h"
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <stddef.h>
+
+#include "util/ring_waiter.h"
+#include "util/spsc_ring.h"
+#include "util/thread.h"
+
+struct ring_int SC_SPSC_RING(int, 4);
+
+static void test_spsc_ring_simple(void) {
+    struct ring_int ring;
+    sc_spsc_ring_init(&ring);
+
+    assert(sc_spsc_ring_capacity(&ring) == 4);
+    assert(sc_spsc_ring_is_empty(&ring));
+    assert(sc_spsc_ring_size(&ring) == 0);
+
+    int item;
+    assert(!sc_spsc_ring_pop(&ring, &item));
+
+    // Several laps, to check the wrapping
+    for (int lap = 0; lap < 3; ++lap) {
+        for (int i = 0; i < 4; ++i) {
+            bool ok = sc_spsc_ring_push(&ring, lap * 10 + i);
+            assert(ok);
+        }
+        assert(sc_spsc_ring_size(&ring) == 4);
+
+        // Full
+        bool ok = sc_spsc_ring_push(&ring, 42);
+        assert(!ok);
+
+        for (int i = 0; i < 4; ++i) {
+            ok = sc_spsc_ring_pop(&ring, &item);
+            assert(ok);
+            assert(item == lap * 10 + i);
+        }
+        assert(sc_spsc_ring_is_empty(&ring));
+    }
+}
+
+#define STRESS_COUNT 100000
+
+struct stress {
+    struct ring_int ring;
+    struct sc_ring_waiter waiter;
+    atomic_bool stopped;
+};
+
+static int
+run_producer(void *data) {
+    struct stress *stress = data;
+
+    for (int i = 0; i < STRESS_COUNT; ++i) {
+        while (!sc_spsc_ring_push(&stress->ring, i)) {
+            // Full, let the consumer progress
+            sc_ring_waiter_notify(&stress->waiter);
+        }
+        sc_ring_waiter_notify(&stress->waiter);
+    }
+
+    atomic_store(&stress->stopped, true);
+    sc_ring_waiter_wake_up(&stress->waiter);
+    return 0;
+}
+
+static void test_spsc_ring_threads(void) {
+    struct stress stress;
+    sc_spsc_ring_init(&stress.ring);
+    atomic_init(&stress.stopped, false);
+    bool ok = sc_ring_waiter_init(&stress.waiter);
+    assert(ok);
+
+    sc_thread thread;
+    ok = sc_thread_create(&thread, run_producer, "test-producer", &stress);
+    assert(ok);
+
+    int expected = 0;
+    for (;;) {
+        int item;
+        if (sc_spsc_ring_pop(&stress.ring, &item)) {
+            // Received in order, without loss
+            assert(item == expected);
+            ++expected;
+            continue;
+        }
+
+        if (atomic_load(&stress.stopped)
+                && sc_spsc_ring_is_empty(&stress.ring)) {
+            break;
+        }
+
+        sc_ring_waiter_wait(&stress.waiter,
+                            atomic_load(&stress.stopped)
+                                || !sc_spsc_ring_is_empty(&stress.ring));
+    }
+
+    assert(expected == STRESS_COUNT);
+
+    sc_thread_join(&thread, NULL);
+    sc_ring_waiter_destroy(&stress.waiter);
+}
+
+int main(int argc, char *argv[]) {
+    (void) argc;
+    (void) argv;
+
+    test_spsc_ring_simple();
+    test_spsc_ring_threads();
+
+    return 0;
+}
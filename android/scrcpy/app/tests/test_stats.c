@@ -0,0 +1,82 @@
+#include "common.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "stats.h"
+
+static void test_stats_prometheus(void) {
+    sc_stats_init();
+
+    sc_stats_add(SC_STATS_VIDEO_BYTES, 1000);
+    sc_stats_add(SC_STATS_VIDEO_BYTES, 234);
+    sc_stats_inc(SC_STATS_FRAMES_SKIPPED);
+    assert(sc_stats_get(SC_STATS_VIDEO_BYTES) == 1234);
+
+    struct sc_stats_gauges gauges = {
+        .has_control = true,
+        .control_queue_depth = 3,
+        .control_queue_limit = 60,
+    };
+
+    char *s = sc_stats_format(SC_STATS_FORMAT_PROMETHEUS, &gauges);
+    assert(s);
+    assert(strstr(s, "# TYPE scrcpy_video_bytes_total counter\n"));
+    assert(strstr(s, "\nscrcpy_video_bytes_total 1234\n"));
+    assert(strstr(s, "\nscrcpy_frames_skipped_total 1\n"));
+    assert(strstr(s, "\nscrcpy_audio_bytes_total 0\n"));
+    assert(strstr(s, "# TYPE scrcpy_control_queue_depth gauge\n"));
+    assert(strstr(s, "\nscrcpy_control_queue_depth 3\n"));
+    free(s);
+}
+
+static void test_stats_memory(void) {
+    sc_stats_init();
+
+    struct sc_stats_gauges gauges = {
+        .has_memory = true,
+        .memory_usage = {
+            [SC_MEMORY_BUDGET_RECORDER] = 4096,
+            [SC_MEMORY_BUDGET_DELAY_BUFFER] = 1024,
+        },
+        .memory_limit = 8192,
+    };
+
+    char *s = sc_stats_format(SC_STATS_FORMAT_JSON, &gauges);
+    assert(s);
+    assert(strstr(s, ",\"memory_control_bytes\":0,"));
+    assert(strstr(s, ",\"memory_recorder_bytes\":4096,"));
+    assert(strstr(s, ",\"memory_total_bytes\":5120,"));
+    assert(strstr(s, ",\"memory_limit_bytes\":8192}\n"));
+    free(s);
+}
+
+static void test_stats_json(void) {
+    sc_stats_init();
+
+    sc_stats_inc(SC_STATS_CONTROL_MSGS_DROPPED);
+
+    struct sc_stats_gauges gauges = {
+        .has_control = false,
+    };
+
+    char *s = sc_stats_format(SC_STATS_FORMAT_JSON, &gauges);
+    assert(s);
+    assert(!strncmp(s, "{\"uptime_seconds\":", 18));
+    assert(strstr(s, ",\"video_bytes\":0,"));
+    assert(strstr(s, ",\"control_msgs_dropped\":1}\n"));
+    assert(!strstr(s, "control_queue_depth"));
+    free(s);
+}
+
+int main(int argc, char *argv[]) {
+    (void) argc;
+    (void) argv;
+
+    test_stats_prometheus();
+    test_stats_json();
+    test_stats_memory();
+
+    return 0;
+}
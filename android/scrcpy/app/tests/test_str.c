@@ -386,6 +386,16 @@ static void test_remove_trailing_cr(void) {
     assert(!strcmp(s3, "adb\rdef"));
 }
 
+static void test_write_hex(void) {
+    char s[SC_STR_HEX_SIZE(3)];
+    const uint8_t data[] = {0x01, 0xAB, 0xF0};
+    sc_str_write_hex(s, data, 3);
+    assert(!strcmp(s, "01 AB F0"));
+
+    sc_str_write_hex(s, data, 0);
+    assert(!strcmp(s, ""));
+}
+
 int main(int argc, char *argv[]) {
     (void) argc;
     (void) argv;
@@ -408,5 +418,6 @@ int main(int argc, char *argv[]) {
     test_wrap_lines();
     test_index_of_column();
     test_remove_trailing_cr();
+    test_write_hex();
     return 0;
 }
@@ -25,6 +25,7 @@ static void test_vecdeque_push_pop(void) {
     ok = sc_vecdeque_push(&vdq, 12);
     assert(ok);
     assert(sc_vecdeque_size(&vdq) == 2);
+    assert(*sc_vecdeque_peek_back(&vdq) == 12);
 
     int v = sc_vecdeque_pop(&vdq);
     assert(v == 5);
@@ -0,0 +1,214 @@
+#include "common.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "util/yuv.h"
+
+// Large enough to exercise the vectorized loops and the scalar tails
+#define WIDTH 102
+
+static void fill(uint8_t *data, size_t len, unsigned seed) {
+    for (size_t i = 0; i < len; ++i) {
+        seed = seed * 1103515245 + 12345;
+        data[i] = seed >> 16;
+    }
+}
+
+static void test_interleave_uv(void) {
+    uint8_t u[WIDTH];
+    uint8_t v[WIDTH];
+    uint8_t dst[2 * WIDTH];
+    fill(u, sizeof(u), 1);
+    fill(v, sizeof(v), 2);
+
+    sc_yuv_interleave_uv(dst, u, v, WIDTH);
+
+    for (size_t i = 0; i < WIDTH; ++i) {
+        assert(dst[2 * i] == u[i]);
+        assert(dst[2 * i + 1] == v[i]);
+    }
+}
+
+static void test_pack_yuyv(void) {
+    uint8_t y[WIDTH];
+    uint8_t u[WIDTH / 2];
+    uint8_t v[WIDTH / 2];
+    uint8_t dst[2 * WIDTH];
+    fill(y, sizeof(y), 3);
+    fill(u, sizeof(u), 4);
+    fill(v, sizeof(v), 5);
+
+    sc_yuv_pack_yuyv(dst, y, u, v, WIDTH);
+
+    for (size_t x = 0; x < WIDTH; x += 2) {
+        assert(dst[2 * x] == y[x]);
+        assert(dst[2 * x + 1] == u[x / 2]);
+        assert(dst[2 * x + 2] == y[x + 1]);
+        assert(dst[2 * x + 3] == v[x / 2]);
+    }
+}
+
+static uint8_t clip(int32_t v) {
+    return v < 0 ? 0 : v > 255 ? 255 : v;
+}
+
+static void test_to_bgra(void) {
+    uint8_t y[WIDTH + 1];
+    uint8_t u[(WIDTH + 2) / 2];
+    uint8_t v[(WIDTH + 2) / 2];
+    uint8_t dst[4 * (WIDTH + 1)];
+    fill(y, sizeof(y), 6);
+    fill(u, sizeof(u), 7);
+    fill(v, sizeof(v), 8);
+
+    const struct sc_yuv_coeffs *c = sc_yuv_get_coeffs(false, false);
+    // odd width
+    sc_yuv_to_bgra(dst, y, u, v, WIDTH + 1, c);
+
+    for (size_t x = 0; x < WIDTH + 1; ++x) {
+        int32_t yy = (y[x] - c->y_offset) * c->y_mul + (1 << 15);
+        int32_t uu = u[x / 2] - c->uv_offset;
+        int32_t vv = v[x / 2] - c->uv_offset;
+        assert(dst[4 * x] == clip((yy + c->u_to_b * uu) >> 16));
+        assert(dst[4 * x + 1]
+                == clip((yy - c->u_to_g * uu - c->v_to_g * vv) >> 16));
+        assert(dst[4 * x + 2] == clip((yy + c->v_to_r * vv) >> 16));
+        assert(dst[4 * x + 3] == 0xFF);
+    }
+}
+
+static void test_to_bgra_limits(void) {
+    uint8_t y[16];
+    uint8_t u[8];
+    uint8_t v[8];
+    uint8_t dst[4 * 16];
+
+    // limited range: black is 16, white is 235
+    memset(y, 16, 8);
+    memset(y + 8, 235, 8);
+    memset(u, 128, sizeof(u));
+    memset(v, 128, sizeof(v));
+
+    sc_yuv_to_bgra(dst, y, u, v, 16, sc_yuv_get_coeffs(true, false));
+
+    for (size_t x = 0; x < 16; ++x) {
+        uint8_t expected = x < 8 ? 0 : 255;
+        assert(dst[4 * x] == expected);
+        assert(dst[4 * x + 1] == expected);
+        assert(dst[4 * x + 2] == expected);
+        assert(dst[4 * x + 3] == 0xFF);
+    }
+}
+
+static void test_downscale_2x(void) {
+    uint8_t row0[2 * WIDTH];
+    uint8_t row1[2 * WIDTH];
+    uint8_t dst[WIDTH];
+    fill(row0, sizeof(row0), 9);
+    fill(row1, sizeof(row1), 10);
+
+    sc_yuv_downscale_2x(dst, row0, row1, WIDTH);
+
+    for (size_t i = 0; i < WIDTH; ++i) {
+        unsigned sum = row0[2 * i] + row0[2 * i + 1]
+                     + row1[2 * i] + row1[2 * i + 1];
+        assert(dst[i] == (sum + 2) / 4);
+    }
+}
+
+static void test_transpose(void) {
+    // Not multiples of the block size
+    enum { W = 27, H = 19 };
+    uint8_t src[H * W];
+    uint8_t dst[W * H];
+    fill(src, sizeof(src), 12);
+
+    sc_yuv_transpose(dst, H, src, W, W, H);
+    for (size_t y = 0; y < H; ++y) {
+        for (size_t x = 0; x < W; ++x) {
+            assert(dst[x * H + y] == src[y * W + x]);
+        }
+    }
+
+    // Negative strides: source rows in reverse order (90° clockwise rotation)
+    sc_yuv_transpose(dst, H, src + (H - 1) * W, -W, W, H);
+    for (size_t y = 0; y < H; ++y) {
+        for (size_t x = 0; x < W; ++x) {
+            assert(dst[x * H + (H - 1 - y)] == src[y * W + x]);
+        }
+    }
+
+    // Destination rows in reverse order (90° counterclockwise rotation)
+    sc_yuv_transpose(dst + (W - 1) * H, -H, src, W, W, H);
+    for (size_t y = 0; y < H; ++y) {
+        for (size_t x = 0; x < W; ++x) {
+            assert(dst[(W - 1 - x) * H + y] == src[y * W + x]);
+        }
+    }
+}
+
+static void test_reverse_row(void) {
+    uint8_t src[WIDTH];
+    uint8_t dst[WIDTH];
+    fill(src, sizeof(src), 13);
+
+    sc_yuv_reverse_row(dst, src, WIDTH);
+
+    for (size_t x = 0; x < WIDTH; ++x) {
+        assert(dst[x] == src[WIDTH - 1 - x]);
+    }
+}
+
+static void test_hash_row(void) {
+    uint8_t data[3 * WIDTH];
+    fill(data, sizeof(data), 11);
+
+    uint32_t state[SC_YUV_HASH_LANES];
+    sc_yuv_hash_init(state);
+    sc_yuv_hash_row(state, data, WIDTH);
+    sc_yuv_hash_row(state, data + WIDTH, 2 * WIDTH);
+    uint64_t hash = sc_yuv_hash_final(state);
+
+    // All the implementations must give the same result
+    static uint64_t expected = 0;
+    if (!expected) {
+        expected = hash;
+    }
+    assert(hash == expected);
+
+    // Any byte change must change the hash
+    for (size_t i = 0; i < sizeof(data); i += 7) {
+        data[i] ^= 0x80;
+        sc_yuv_hash_init(state);
+        sc_yuv_hash_row(state, data, WIDTH);
+        sc_yuv_hash_row(state, data + WIDTH, 2 * WIDTH);
+        assert(sc_yuv_hash_final(state) != hash);
+        data[i] ^= 0x80;
+    }
+}
+
+static void run_all(void) {
+    test_interleave_uv();
+    test_pack_yuyv();
+    test_to_bgra();
+    test_to_bgra_limits();
+    test_downscale_2x();
+    test_transpose();
+    test_reverse_row();
+    test_hash_row();
+}
+
+int main(int argc, char *argv[]) {
+    (void) argc;
+    (void) argv;
+
+    // Without sc_yuv_init(), the scalar implementation is used
+    assert(!strcmp(sc_yuv_get_impl_name(), "scalar"));
+    run_all();
+
+    sc_yuv_init();
+    run_all();
+    return 0;
+}
@@ -0,0 +1,243 @@
+/**
+ * @file bench/bench.cpp
+ * @brief Micro-benchmarks of the vendored hot-path libraries.
+ *
+ * Every result is printed as one JSON object per line on stdout, so runs can be compared by scripts.
+ *
+ * Usage: sunshine_bench [--filter <substring>] [--min-time-ms <ms>]
+ */
+// standard includes
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// lib includes
+#include <utility.hpp>
+extern "C" {
+#include <rs.h>
+#include <TPCircularBuffer.h>
+}
+#ifdef SUNSHINE_BENCH_INPUTTINO
+  #include <inputtino/input.hpp>
+#endif
+
+using namespace std::literals;
+
+namespace {
+  struct options_t {
+    std::string filter;
+    std::chrono::milliseconds min_time {500ms};
+  };
+
+  /**
+   * @brief Prevent the compiler from optimizing away a computed value.
+   */
+  template<class T>
+  void do_not_optimize(const T &value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    static volatile const void *sink;
+    sink = &value;
+#endif
+  }
+
+  /**
+   * @brief Run the function repeatedly for at least the minimum time and print the result.
+   * @param options Benchmark options.
+   * @param name Name of the benchmark.
+   * @param params Parameters of the benchmark, as a JSON object.
+   * @param bytes_per_op Number of bytes processed by each call, or 0.
+   * @param fn Function to benchmark.
+   */
+  void run(const options_t &options, std::string_view name, std::string_view params, std::size_t bytes_per_op, const std::function<void()> &fn) {
+    if (!options.filter.empty() && name.find(options.filter) == std::string_view::npos) {
+      return;
+    }
+
+    // Warm up the caches and find a batch size that makes the clock overhead negligible
+    std::uint64_t batch = 1;
+    while (true) {
+      auto start = std::chrono::steady_clock::now();
+      for (std::uint64_t i = 0; i < batch; ++i) {
+        fn();
+      }
+      if (std::chrono::steady_clock::now() - start >= 10ms || batch >= (1ull << 30)) {
+        break;
+      }
+      batch *= 2;
+    }
+
+    std::uint64_t iterations = 0;
+    auto start = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::duration elapsed {};
+    do {
+      for (std::uint64_t i = 0; i < batch; ++i) {
+        fn();
+      }
+      iterations += batch;
+      elapsed = std::chrono::steady_clock::now() - start;
+    } while (elapsed < options.min_time);
+
+    auto ns_per_op = std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+    std::cout << "{\"benchmark\":\"" << name << "\",\"params\":" << params
+              << ",\"iterations\":" << iterations
+              << ",\"ns_per_op\":" << ns_per_op;
+    if (bytes_per_op > 0) {
+      std::cout << ",\"mb_per_s\":" << (bytes_per_op / ns_per_op) * 1e9 / (1024.0 * 1024.0);
+    }
+    std::cout << "}" << std::endl;
+  }
+
+  /**
+   * @brief FEC shards of one block, filled with random data.
+   */
+  struct fec_block_t {
+    fec_block_t(int data_shards, int parity_shards, int block_size):
+        data(static_cast<std::size_t>(data_shards + parity_shards) * block_size),
+        marks(data_shards + parity_shards) {
+      std::mt19937 generator {42};
+      for (auto &byte : data) {
+        byte = static_cast<std::uint8_t>(generator());
+      }
+      for (int i = 0; i < data_shards + parity_shards; ++i) {
+        shards.push_back(data.data() + static_cast<std::size_t>(i) * block_size);
+      }
+    }
+
+    std::vector<std::uint8_t> data;
+    std::vector<std::uint8_t *> shards;
+    std::vector<std::uint8_t> marks;
+  };
+
+  void bench_nanors(const options_t &options) {
+    reed_solomon_init();
+
+    // Sunshine sends up to 255 shards per FEC block, with packets of ~1 KiB of video data
+    struct config_t {
+      int data_shards;
+      int parity_shards;
+      int block_size;
+    };
+
+    for (auto config : {config_t {50, 10, 1024}, config_t {200, 40, 1024}, config_t {200, 40, 1408}}) {
+      auto rs = reed_solomon_new(config.data_shards, config.parity_shards);
+      fec_block_t block {config.data_shards, config.parity_shards, config.block_size};
+      auto total_shards = config.data_shards + config.parity_shards;
+      auto data_bytes = static_cast<std::size_t>(config.data_shards) * config.block_size;
+
+      std::stringstream params;
+      params << "{\"data_shards\":" << config.data_shards << ",\"parity_shards\":" << config.parity_shards
+             << ",\"block_size\":" << config.block_size << "}";
+
+      run(options, "nanors_encode", params.str(), data_bytes, [&]() {
+        reed_solomon_encode(rs, block.shards.data(), total_shards, config.block_size);
+        do_not_optimize(block.data);
+      });
+
+      // Worst case: as many data shards lost as there are parity shards
+      reed_solomon_encode(rs, block.shards.data(), total_shards, config.block_size);
+      run(options, "nanors_decode", params.str(), data_bytes, [&]() {
+        std::fill(block.marks.begin(), block.marks.end(), 0);
+        std::fill(block.marks.begin(), block.marks.begin() + config.parity_shards, 1);
+        reed_solomon_decode(rs, block.shards.data(), block.marks.data(), total_shards, config.block_size);
+        do_not_optimize(block.data);
+      });
+
+      reed_solomon_release(rs);
+    }
+  }
+
+  void bench_tpcircularbuffer(const options_t &options) {
+    // Audio packets of 5 ms and 10 ms of 48 kHz stereo, 16-bit and float samples
+    for (std::uint32_t chunk_size : {960u, 1920u, 3840u}) {
+      TPCircularBuffer buffer;
+      if (!TPCircularBufferInit(&buffer, 64 * 1024)) {
+        std::cerr << "Failed to initialize the circular buffer" << std::endl;
+        return;
+      }
+
+      std::vector<std::uint8_t> input(chunk_size, 0x55);
+      std::vector<std::uint8_t> output(chunk_size);
+      std::string params = "{\"chunk_size\":" + std::to_string(chunk_size) + "}";
+
+      run(options, "tpcircularbuffer_produce_consume", params, chunk_size, [&]() {
+        TPCircularBufferProduceBytes(&buffer, input.data(), chunk_size);
+
+        std::uint32_t available;
+        auto tail = TPCircularBufferTail(&buffer, &available);
+        std::memcpy(output.data(), tail, chunk_size);
+        TPCircularBufferConsume(&buffer, chunk_size);
+        do_not_optimize(output);
+      });
+
+      TPCircularBufferCleanup(&buffer);
+    }
+  }
+
+  void bench_simple_web_server(const options_t &options) {
+    // What Moonlight sends when polling the host
+    const std::string request =
+      "GET /serverinfo?uniqueid=0123456789ABCDEF&uuid=f6f5e4f2-9a51-4b1e-8f3a-1d2c3b4a5f6e HTTP/1.1\r\n"
+      "Host: 192.168.1.10:47989\r\n"
+      "User-Agent: Moonlight/6.0\r\n"
+      "Accept: */*\r\n"
+      "\r\n";
+
+    run(options, "simple_web_server_parse_request", "{}", request.size(), [&]() {
+      std::istringstream stream {request};
+      std::string method, path, query_string, version;
+      SimpleWeb::CaseInsensitiveMultimap header;
+      SimpleWeb::RequestMessage::parse(stream, method, path, query_string, version, header);
+      auto query = SimpleWeb::QueryString::parse(query_string);
+      do_not_optimize(query);
+    });
+  }
+
+#ifdef SUNSHINE_BENCH_INPUTTINO
+  void bench_inputtino(const options_t &options) {
+    auto mouse = inputtino::Mouse::create();
+    if (!mouse) {
+      std::cerr << "Skipping inputtino: " << mouse.getErrorMessage() << std::endl;
+      return;
+    }
+
+    int direction = 1;
+    run(options, "inputtino_mouse_move", "{}", 0, [&]() {
+      direction = -direction;
+      mouse->move(direction, 0);
+    });
+  }
+#endif
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  options_t options;
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg {argv[i]};
+    if (arg == "--filter" && i + 1 < argc) {
+      options.filter = argv[++i];
+    } else if (arg == "--min-time-ms" && i + 1 < argc) {
+      options.min_time = std::chrono::milliseconds {std::stoi(argv[++i])};
+    } else {
+      std::cerr << "Usage: " << argv[0] << " [--filter <substring>] [--min-time-ms <ms>]" << std::endl;
+      return 1;
+    }
+  }
+
+  bench_nanors(options);
+  bench_tpcircularbuffer(options);
+  bench_simple_web_server(options);
+#ifdef SUNSHINE_BENCH_INPUTTINO
+  bench_inputtino(options);
+#endif
+
+  return 0;
+}
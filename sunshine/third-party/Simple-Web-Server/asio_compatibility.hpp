@@ -73,6 +73,20 @@ namespace SimpleWeb {
   inline asio::executor_binder<typename asio::decay<handler_type>::type, typename execution_context::executor_type> bind_executor(strand &strand, handler_type &&handler) {
     return asio::bind_executor(strand, std::forward<handler_type>(handler));
   }
+  template <typename socket_type, typename handler_type>
+  inline void async_wait_writable(socket_type &socket, handler_type &&handler) {
+    socket.async_wait(socket_type::wait_write, std::forward<handler_type>(handler));
+  }
+  template <typename socket_type, typename handler_type>
+  inline void async_wait_readable(socket_type &socket, handler_type &&handler) {
+    socket.async_wait(socket_type::wait_read, std::forward<handler_type>(handler));
+  }
+  inline const char *buffer_data(const asio::const_buffer &buffer) noexcept {
+    return static_cast<const char *>(buffer.data());
+  }
+  inline char *buffer_data(const asio::mutable_buffer &buffer) noexcept {
+    return static_cast<char *>(buffer.data());
+  }
 #else
   using io_context = asio::io_service;
   using resolver_results = asio::ip::tcp::resolver::iterator;
@@ -112,6 +126,24 @@ namespace SimpleWeb {
   inline asio::detail::wrapped_handler<strand, handler_type, asio::detail::is_continuation_if_running> bind_executor(strand &strand, handler_type &&handler) {
     return strand.wrap(std::forward<handler_type>(handler));
   }
+  template <typename socket_type, typename handler_type>
+  inline void async_wait_writable(socket_type &socket, handler_type &&handler) {
+    socket.async_write_some(asio::null_buffers(), [handler](const error_code &ec, std::size_t /*bytes_transferred*/) {
+      handler(ec);
+    });
+  }
+  template <typename socket_type, typename handler_type>
+  inline void async_wait_readable(socket_type &socket, handler_type &&handler) {
+    socket.async_read_some(asio::null_buffers(), [handler](const error_code &ec, std::size_t /*bytes_transferred*/) {
+      handler(ec);
+    });
+  }
+  inline const char *buffer_data(const asio::const_buffer &buffer) noexcept {
+    return asio::buffer_cast<const char *>(buffer);
+  }
+  inline char *buffer_data(const asio::mutable_buffer &buffer) noexcept {
+    return asio::buffer_cast<char *>(buffer);
+  }
 #endif
 } // namespace SimpleWeb
 
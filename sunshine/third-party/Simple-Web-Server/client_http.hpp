@@ -6,6 +6,7 @@
 #include "utility.hpp"
 #include <future>
 #include <limits>
+#include <list>
 #include <random>
 #include <unordered_set>
 #include <vector>
@@ -146,6 +147,23 @@ namespace SimpleWeb {
       std::size_t max_response_streambuf_size = (std::numeric_limits<std::size_t>::max)();
       /// Set proxy server (server:port)
       std::string proxy_server;
+      /// Maximum number of connections to the server, including unused ones. Requests made while this many
+      /// connections are in use wait for one of them to become available. Default value: 0 (no limit).
+      std::size_t max_connections = 0;
+      /// Maximum number of unused connections that are kept open for later requests. Default value: 1.
+      std::size_t max_idle_connections = 1;
+      /// Close unused connections after this many seconds. Default value: 0 (no timeout).
+      long idle_timeout = 0;
+    };
+
+    class PoolStats {
+    public:
+      /// Requests that reused an open connection.
+      std::size_t hits = 0;
+      /// Requests that opened a new connection, including reconnects when a reused connection turned out to be closed.
+      std::size_t misses = 0;
+      /// Requests that had to wait for a connection, since Config::max_connections were in use.
+      std::size_t waits = 0;
     };
 
   protected:
@@ -235,34 +253,13 @@ namespace SimpleWeb {
     /// When requesting Server-Sent Events: request_callback might be called more than twice, first call with empty contents on open, and with ec = error::eof on last call
     void request(const std::string &method, const std::string &path, string_view content, const CaseInsensitiveMultimap &header,
                  std::function<void(std::shared_ptr<Response>, const error_code &)> &&request_callback_) {
-      auto session = std::make_shared<Session>(config.max_response_streambuf_size, get_connection(), create_request_header(method, path, header));
+      auto session = std::make_shared<Session>(config.max_response_streambuf_size, nullptr, create_request_header(method, path, header));
       std::weak_ptr<Session> session_weak(session); // To avoid keeping session alive longer than needed
       auto request_callback = std::make_shared<std::function<void(std::shared_ptr<Response>, const error_code &)>>(std::move(request_callback_));
       session->callback = [this, session_weak, request_callback](const error_code &ec) {
         if(auto session = session_weak.lock()) {
-          if(session->response->content.end) {
-            session->connection->cancel_timeout();
-            session->connection->in_use = false;
-          }
-          {
-            LockGuard lock(this->connections_mutex);
-
-            // Remove unused connections, but keep one open for HTTP persistent connection:
-            std::size_t unused_connections = 0;
-            for(auto it = this->connections.begin(); it != this->connections.end();) {
-              if(ec && session->connection == *it)
-                it = this->connections.erase(it);
-              else if((*it)->in_use)
-                ++it;
-              else {
-                ++unused_connections;
-                if(unused_connections > 1)
-                  it = this->connections.erase(it);
-                else
-                  ++it;
-              }
-            }
-          }
+          if(session->connection)
+            this->release_connection(session, ec);
 
           if(*request_callback)
             (*request_callback)(session->response, ec);
@@ -281,7 +278,8 @@ namespace SimpleWeb {
       write_stream << "\r\n";
       write_stream.write(content.data(), static_cast<std::streamsize>(content.size()));
 
-      connect(session);
+      if(get_connection(session))
+        connect(session);
     }
 
     /// Asynchronous request where running Client's io_service is required.
@@ -312,34 +310,13 @@ namespace SimpleWeb {
     /// When requesting Server-Sent Events: request_callback might be called more than twice, first call with empty contents on open, and with ec = error::eof on last call
     void request(const std::string &method, const std::string &path, std::istream &content, const CaseInsensitiveMultimap &header,
                  std::function<void(std::shared_ptr<Response>, const error_code &)> &&request_callback_) {
-      auto session = std::make_shared<Session>(config.max_response_streambuf_size, get_connection(), create_request_header(method, path, header));
+      auto session = std::make_shared<Session>(config.max_response_streambuf_size, nullptr, create_request_header(method, path, header));
       std::weak_ptr<Session> session_weak(session); // To avoid keeping session alive longer than needed
       auto request_callback = std::make_shared<std::function<void(std::shared_ptr<Response>, const error_code &)>>(std::move(request_callback_));
       session->callback = [this, session_weak, request_callback](const error_code &ec) {
         if(auto session = session_weak.lock()) {
-          if(session->response->content.end) {
-            session->connection->cancel_timeout();
-            session->connection->in_use = false;
-          }
-          {
-            LockGuard lock(this->connections_mutex);
-
-            // Remove unused connections, but keep one open for HTTP persistent connection:
-            std::size_t unused_connections = 0;
-            for(auto it = this->connections.begin(); it != this->connections.end();) {
-              if(ec && session->connection == *it)
-                it = this->connections.erase(it);
-              else if((*it)->in_use)
-                ++it;
-              else {
-                ++unused_connections;
-                if(unused_connections > 1)
-                  it = this->connections.erase(it);
-                else
-                  ++it;
-              }
-            }
-          }
+          if(session->connection)
+            this->release_connection(session, ec);
 
           if(*request_callback)
             (*request_callback)(session->response, ec);
@@ -362,7 +339,8 @@ namespace SimpleWeb {
       if(content_length > 0)
         write_stream << content.rdbuf();
 
-      connect(session);
+      if(get_connection(session))
+        connect(session);
     }
 
     /// Asynchronous request where running Client's io_service is required.
@@ -373,13 +351,29 @@ namespace SimpleWeb {
       request(method, path, content, CaseInsensitiveMultimap(), std::move(request_callback_));
     }
 
-    /// Close connections.
+    /// Close connections, and cancel requests that are waiting for a connection.
     void stop() noexcept {
-      LockGuard lock(connections_mutex);
-      for(auto it = connections.begin(); it != connections.end();) {
-        (*it)->close();
-        it = connections.erase(it);
+      std::list<std::shared_ptr<Session>> sessions;
+      {
+        LockGuard lock(connections_mutex);
+        for(auto it = connections.begin(); it != connections.end();) {
+          (*it)->close();
+          it = connections.erase(it);
+        }
+        sessions = std::move(waiting_sessions);
+        waiting_sessions.clear();
       }
+
+      auto lock = handler_runner->continue_lock();
+      if(!lock)
+        return;
+      for(auto &session : sessions)
+        session->callback(make_error_code::make_error_code(errc::operation_canceled));
+    }
+
+    PoolStats pool_stats() noexcept {
+      LockGuard lock(connections_mutex);
+      return stats;
     }
 
     virtual ~ClientBase() noexcept {
@@ -400,6 +394,9 @@ namespace SimpleWeb {
 
     Mutex connections_mutex;
     std::unordered_set<std::shared_ptr<Connection>> connections GUARDED_BY(connections_mutex);
+    /// Requests waiting for a connection, since Config::max_connections were in use.
+    std::list<std::shared_ptr<Session>> waiting_sessions GUARDED_BY(connections_mutex);
+    PoolStats stats GUARDED_BY(connections_mutex);
 
     std::shared_ptr<ScopeRunner> handler_runner;
 
@@ -465,8 +462,8 @@ namespace SimpleWeb {
       return response_promise.get_future().get();
     }
 
-    std::shared_ptr<Connection> get_connection() noexcept {
-      std::shared_ptr<Connection> connection;
+    /// Gives session a connection, or returns false if session has to wait for one.
+    bool get_connection(const std::shared_ptr<Session> &session) noexcept {
       LockGuard lock(connections_mutex);
 
       if(!io_service) {
@@ -474,29 +471,110 @@ namespace SimpleWeb {
         internal_io_service = true;
       }
 
+      if(!host_port) {
+        if(config.proxy_server.empty())
+          host_port = std::unique_ptr<std::pair<std::string, std::string>>(new std::pair<std::string, std::string>(host, std::to_string(port)));
+        else {
+          auto proxy_host_port = parse_host_port(config.proxy_server, 8080);
+          host_port = std::unique_ptr<std::pair<std::string, std::string>>(new std::pair<std::string, std::string>(proxy_host_port.first, std::to_string(proxy_host_port.second)));
+        }
+      }
+
+      if(!take_connection(session)) {
+        waiting_sessions.emplace_back(session);
+        ++stats.waits;
+        return false;
+      }
+      return true;
+    }
+
+    bool take_connection(const std::shared_ptr<Session> &session) noexcept REQUIRES(connections_mutex) {
+      std::shared_ptr<Connection> connection;
       for(auto it = connections.begin(); it != connections.end(); ++it) {
         if(!(*it)->in_use) {
           connection = *it;
+          ++stats.hits;
           break;
         }
       }
       if(!connection) {
+        if(config.max_connections > 0 && connections.size() >= config.max_connections)
+          return false;
         connection = create_connection();
         connections.emplace(connection);
+        ++stats.misses;
       }
+      connection->cancel_timeout(); // Idle timeout
       connection->attempt_reconnect = true;
       connection->in_use = true;
 
-      if(!host_port) {
-        if(config.proxy_server.empty())
-          host_port = std::unique_ptr<std::pair<std::string, std::string>>(new std::pair<std::string, std::string>(host, std::to_string(port)));
-        else {
-          auto proxy_host_port = parse_host_port(config.proxy_server, 8080);
-          host_port = std::unique_ptr<std::pair<std::string, std::string>>(new std::pair<std::string, std::string>(proxy_host_port.first, std::to_string(proxy_host_port.second)));
+      session->connection = connection;
+      session->response = std::shared_ptr<Response>(new Response(config.max_response_streambuf_size, connection));
+      return true;
+    }
+
+    /// Called on each response callback. Once the request is done, keeps its connection open for later requests
+    /// if possible, and starts the next request that is waiting for a connection.
+    void release_connection(const std::shared_ptr<Session> &session, const error_code &ec) {
+      auto end = session->response->content.end;
+      if(!end && !ec)
+        return;
+
+      std::shared_ptr<Session> next_session;
+      {
+        LockGuard lock(connections_mutex);
+        auto &connection = session->connection;
+        if(end) {
+          connection->cancel_timeout();
+          connection->in_use = false;
         }
+
+        // Remove unused connections, but keep up to max_idle_connections open for HTTP persistent connection:
+        std::size_t unused_connections = 0;
+        for(auto it = connections.begin(); it != connections.end();) {
+          if(ec && connection == *it)
+            it = connections.erase(it);
+          else if((*it)->in_use)
+            ++it;
+          else {
+            ++unused_connections;
+            if(unused_connections > config.max_idle_connections)
+              it = connections.erase(it);
+            else
+              ++it;
+          }
+        }
+
+        if(!waiting_sessions.empty() && take_connection(waiting_sessions.front())) {
+          next_session = std::move(waiting_sessions.front());
+          waiting_sessions.pop_front();
+        }
+        else if(!connection->in_use && config.idle_timeout > 0 && connections.count(connection) > 0)
+          set_idle_timeout(connection);
       }
 
-      return connection;
+      if(next_session)
+        connect(next_session);
+    }
+
+    void set_idle_timeout(const std::shared_ptr<Connection> &connection) noexcept REQUIRES(connections_mutex) {
+      connection->timer = make_steady_timer(*connection->socket, std::chrono::seconds(config.idle_timeout));
+      std::weak_ptr<Connection> connection_weak(connection); // To avoid keeping Connection instance alive longer than needed
+      connection->timer->async_wait([this, connection_weak](const error_code &ec) {
+        if(ec)
+          return;
+        auto connection = connection_weak.lock();
+        if(!connection)
+          return;
+        auto lock = connection->handler_runner->continue_lock();
+        if(!lock)
+          return;
+        LockGuard connections_lock(this->connections_mutex);
+        if(!connection->in_use) {
+          connections.erase(connection);
+          connection->close();
+        }
+      });
     }
 
     std::pair<std::string, unsigned short> parse_host_port(const std::string &host_port, unsigned short default_port) const noexcept {
@@ -638,6 +716,7 @@ namespace SimpleWeb {
         session->connection = create_connection();
         session->connection->attempt_reconnect = false;
         session->connection->in_use = true;
+        ++stats.misses;
         session->response = std::shared_ptr<Response>(new Response(this->config.max_response_streambuf_size, session->connection));
         connections.emplace(session->connection);
         lock.unlock();
@@ -2,6 +2,8 @@
 #define SIMPLE_WEB_CRYPTO_HPP
 
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <iomanip>
 #include <istream>
 #include <memory>
@@ -27,88 +29,179 @@ namespace SimpleWeb {
 
   public:
     class Base64 {
-    public:
-      /// Returns Base64 encoded string from input string.
-      static std::string encode(const std::string &input) noexcept {
-        std::string base64;
+      static const char *alphabet() noexcept {
+        return "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+      }
 
-        BIO *bio, *b64;
-        auto bptr = BUF_MEM_new();
+      /// Maps each character to its 6-bit value, or to 0xFF if it is not part of the alphabet.
+      static const unsigned char *reverse_alphabet() noexcept {
+        struct Table {
+          unsigned char values[256];
+          Table() noexcept {
+            std::memset(values, 0xFF, sizeof(values));
+            for(unsigned char i = 0; i < 64; ++i)
+              values[static_cast<unsigned char>(alphabet()[i])] = i;
+          }
+        };
+        static const Table table;
+        return table.values;
+      }
 
-        b64 = BIO_new(BIO_f_base64());
-        BIO_set_flags(b64, BIO_FLAGS_BASE64_NO_NL);
-        bio = BIO_new(BIO_s_mem());
-        BIO_push(b64, bio);
-        BIO_set_mem_buf(b64, bptr, BIO_CLOSE);
+      /// Maps each 12-bit value to its two encoded characters, so that a 3 byte group takes two lookups.
+      static const char *pair_alphabet() noexcept {
+        struct Table {
+          char pairs[2 * 4096];
+          Table() noexcept {
+            for(std::size_t i = 0; i < 4096; ++i) {
+              pairs[2 * i] = alphabet()[i >> 6];
+              pairs[2 * i + 1] = alphabet()[i & 0x3F];
+            }
+          }
+        };
+        static const Table table;
+        return table.pairs;
+      }
 
-        // Write directly to base64-buffer to avoid copy
-        auto base64_length = static_cast<std::size_t>(round(4 * ceil(static_cast<double>(input.size()) / 3.0)));
-        base64.resize(base64_length);
-        bptr->length = 0;
-        bptr->max = base64_length + 1;
-        bptr->data = &base64[0];
+    public:
+      /// Returns the length of the Base64 encoding of length bytes, including padding.
+      static std::size_t encoded_length(std::size_t length) noexcept {
+        return (length + 2) / 3 * 4;
+      }
 
-        if(BIO_write(b64, &input[0], static_cast<int>(input.size())) <= 0 || BIO_flush(b64) <= 0)
-          base64.clear();
+      /// Returns an upper bound of the decoded length of a Base64 string of the given length.
+      static std::size_t decoded_max_length(std::size_t length) noexcept {
+        return (length + 3) / 4 * 3;
+      }
 
-        // To keep &base64[0] through BIO_free_all(b64)
-        bptr->length = 0;
-        bptr->max = 0;
-        bptr->data = nullptr;
+      /// Writes the Base64 encoding of input into output, which must have room for encoded_length(length) characters.
+      /// Returns the number of characters written.
+      static std::size_t encode(const void *input, std::size_t length, char *output) noexcept {
+        auto in = static_cast<const unsigned char *>(input);
+        auto table = alphabet();
+        auto pairs = pair_alphabet();
+        auto out = output;
+
+        // Whole 3 byte groups have no branches, so the compiler is free to unroll or vectorize them
+        std::size_t i = 0;
+        for(; i + 3 <= length; i += 3) {
+          std::uint32_t group = (static_cast<std::uint32_t>(in[i]) << 16) | (static_cast<std::uint32_t>(in[i + 1]) << 8) | in[i + 2];
+          std::memcpy(out, &pairs[2 * (group >> 12)], 2);
+          std::memcpy(out + 2, &pairs[2 * (group & 0xFFF)], 2);
+          out += 4;
+        }
+
+        if(i < length) {
+          std::uint32_t group = static_cast<std::uint32_t>(in[i]) << 16;
+          if(i + 1 < length)
+            group |= static_cast<std::uint32_t>(in[i + 1]) << 8;
+          out[0] = table[(group >> 18) & 0x3F];
+          out[1] = table[(group >> 12) & 0x3F];
+          out[2] = i + 1 < length ? table[(group >> 6) & 0x3F] : '=';
+          out[3] = '=';
+          out += 4;
+        }
+
+        return static_cast<std::size_t>(out - output);
+      }
 
-        BIO_free_all(b64);
+      /// Decodes Base64 input into output, which must have room for decoded_max_length(length) bytes.
+      /// Padding is optional. Returns the number of bytes written, or -1 if input is not valid Base64.
+      static long decode(const char *input, std::size_t length, void *output) noexcept {
+        auto values = reverse_alphabet();
+        auto out = static_cast<unsigned char *>(output);
+        std::size_t written = 0;
+
+        if(length % 4 == 0 && length > 0 && input[length - 1] == '=') {
+          --length;
+          if(input[length - 1] == '=')
+            --length;
+        }
+        if(length % 4 == 1)
+          return -1;
+
+        std::size_t i = 0;
+        for(; i + 4 <= length; i += 4) {
+          std::uint32_t a = values[static_cast<unsigned char>(input[i])], b = values[static_cast<unsigned char>(input[i + 1])];
+          std::uint32_t c = values[static_cast<unsigned char>(input[i + 2])], d = values[static_cast<unsigned char>(input[i + 3])];
+          // Invalid characters map to 0xFF, which is outside of the 6-bit range
+          if((a | b | c | d) > 63)
+            return -1;
+          std::uint32_t group = (a << 18) | (b << 12) | (c << 6) | d;
+          out[written] = static_cast<unsigned char>(group >> 16);
+          out[written + 1] = static_cast<unsigned char>(group >> 8);
+          out[written + 2] = static_cast<unsigned char>(group);
+          written += 3;
+        }
+
+        if(i < length) {
+          std::uint32_t a = values[static_cast<unsigned char>(input[i])], b = values[static_cast<unsigned char>(input[i + 1])];
+          std::uint32_t c = i + 2 < length ? values[static_cast<unsigned char>(input[i + 2])] : 0;
+          if((a | b | c) > 63)
+            return -1;
+          std::uint32_t group = (a << 18) | (b << 12) | (c << 6);
+          out[written++] = static_cast<unsigned char>(group >> 16);
+          if(i + 2 < length)
+            out[written++] = static_cast<unsigned char>(group >> 8);
+        }
+
+        return static_cast<long>(written);
+      }
 
+      /// Returns Base64 encoded string from input string.
+      static std::string encode(const std::string &input) noexcept {
+        std::string base64(encoded_length(input.size()), '\0');
+        encode(input.data(), input.size(), &base64[0]);
         return base64;
       }
 
-      /// Returns Base64 decoded string from base64 input.
+      /// Returns Base64 decoded string from base64 input, or an empty string if the input is not valid Base64.
       static std::string decode(const std::string &base64) noexcept {
-        std::string ascii((6 * base64.size()) / 8, '\0'); // The size is a up to two bytes too large.
-
-        BIO *b64, *bio;
-
-        b64 = BIO_new(BIO_f_base64());
-        BIO_set_flags(b64, BIO_FLAGS_BASE64_NO_NL);
-// TODO: Remove in 2022 or later
-#if (defined(OPENSSL_VERSION_NUMBER) && OPENSSL_VERSION_NUMBER < 0x1000214fL) || (defined(LIBRESSL_VERSION_NUMBER) && LIBRESSL_VERSION_NUMBER < 0x2080000fL)
-        bio = BIO_new_mem_buf(const_cast<char *>(&base64[0]), static_cast<int>(base64.size()));
-#else
-        bio = BIO_new_mem_buf(&base64[0], static_cast<int>(base64.size()));
-#endif
-        bio = BIO_push(b64, bio);
-
-        auto decoded_length = BIO_read(bio, &ascii[0], static_cast<int>(ascii.size()));
+        std::string ascii(decoded_max_length(base64.size()), '\0');
+        auto decoded_length = decode(base64.data(), base64.size(), &ascii[0]);
         if(decoded_length > 0)
           ascii.resize(static_cast<std::size_t>(decoded_length));
         else
           ascii.clear();
-
-        BIO_free_all(b64);
-
         return ascii;
       }
     };
 
+    /// Writes the lowercase hex representation of length bytes into output, which must have room for 2 * length characters.
+    static void to_hex(const void *input, std::size_t length, char *output) noexcept {
+      static const char digits[] = "0123456789abcdef";
+      auto in = static_cast<const unsigned char *>(input);
+      for(std::size_t i = 0; i < length; ++i) {
+        output[2 * i] = digits[in[i] >> 4];
+        output[2 * i + 1] = digits[in[i] & 0x0F];
+      }
+    }
+
     /// Returns hex string from bytes in input string.
     static std::string to_hex_string(const std::string &input) noexcept {
-      std::stringstream hex_stream;
-      hex_stream << std::hex << std::internal << std::setfill('0');
-      for(auto &byte : input)
-        hex_stream << std::setw(2) << static_cast<int>(static_cast<unsigned char>(byte));
-      return hex_stream.str();
+      std::string hex(2 * input.size(), '\0');
+      to_hex(input.data(), input.size(), &hex[0]);
+      return hex;
+    }
+
+    /// Writes the EVP_MD hash of input into output, which must have room for EVP_MD_size(evp_md) bytes.
+    /// The hash is applied iterations times, each time to the previous result, without allocating.
+    static bool message_digest(const void *input, std::size_t length, const EVP_MD *evp_md, unsigned char *output, std::size_t iterations = 1) noexcept {
+      unsigned int digest_length;
+      if(!EVP_Digest(input, length, output, &digest_length, evp_md, nullptr))
+        return false;
+      for(std::size_t i = 1; i < iterations; ++i) {
+        unsigned char previous[EVP_MAX_MD_SIZE];
+        std::memcpy(previous, output, digest_length);
+        if(!EVP_Digest(previous, digest_length, output, &digest_length, evp_md, nullptr))
+          return false;
+      }
+      return true;
     }
 
     /// Return hash value using specific EVP_MD from input string.
     static std::string message_digest(const std::string &str, const EVP_MD *evp_md, std::size_t digest_length) noexcept {
       std::string md(digest_length, '\0');
-
-      auto ctx = EVP_MD_CTX_create();
-      EVP_MD_CTX_init(ctx);
-      EVP_DigestInit_ex(ctx, evp_md, nullptr);
-      EVP_DigestUpdate(ctx, str.data(), str.size());
-      EVP_DigestFinal_ex(ctx, reinterpret_cast<unsigned char *>(&md[0]), nullptr);
-      EVP_MD_CTX_destroy(ctx);
-
+      message_digest(str.data(), str.size(), evp_md, reinterpret_cast<unsigned char *>(&md[0]));
       return md;
     }
 
@@ -131,10 +224,8 @@ namespace SimpleWeb {
 
     /// Returns md5 hash value from input string.
     static std::string md5(const std::string &input, std::size_t iterations = 1) noexcept {
-      auto evp_md = EVP_md5();
-      auto hash = message_digest(input, evp_md, MD5_DIGEST_LENGTH);
-      for(std::size_t i = 1; i < iterations; ++i)
-        hash = message_digest(hash, evp_md, MD5_DIGEST_LENGTH);
+      std::string hash(MD5_DIGEST_LENGTH, '\0');
+      message_digest(input.data(), input.size(), EVP_md5(), reinterpret_cast<unsigned char *>(&hash[0]), iterations);
       return hash;
     }
 
@@ -149,10 +240,8 @@ namespace SimpleWeb {
 
     /// Returns sha1 hash value from input string.
     static std::string sha1(const std::string &input, std::size_t iterations = 1) noexcept {
-      auto evp_md = EVP_sha1();
-      auto hash = message_digest(input, evp_md, SHA_DIGEST_LENGTH);
-      for(std::size_t i = 1; i < iterations; ++i)
-        hash = message_digest(hash, evp_md, SHA_DIGEST_LENGTH);
+      std::string hash(SHA_DIGEST_LENGTH, '\0');
+      message_digest(input.data(), input.size(), EVP_sha1(), reinterpret_cast<unsigned char *>(&hash[0]), iterations);
       return hash;
     }
 
@@ -167,10 +256,8 @@ namespace SimpleWeb {
 
     /// Returns sha256 hash value from input string.
     static std::string sha256(const std::string &input, std::size_t iterations = 1) noexcept {
-      auto evp_md = EVP_sha256();
-      auto hash = message_digest(input, evp_md, SHA256_DIGEST_LENGTH);
-      for(std::size_t i = 1; i < iterations; ++i)
-        hash = message_digest(hash, evp_md, SHA256_DIGEST_LENGTH);
+      std::string hash(SHA256_DIGEST_LENGTH, '\0');
+      message_digest(input.data(), input.size(), EVP_sha256(), reinterpret_cast<unsigned char *>(&hash[0]), iterations);
       return hash;
     }
 
@@ -185,10 +272,8 @@ namespace SimpleWeb {
 
     /// Returns sha512 hash value from input string.
     static std::string sha512(const std::string &input, std::size_t iterations = 1) noexcept {
-      auto evp_md = EVP_sha512();
-      auto hash = message_digest(input, evp_md, SHA512_DIGEST_LENGTH);
-      for(std::size_t i = 1; i < iterations; ++i)
-        hash = message_digest(hash, evp_md, SHA512_DIGEST_LENGTH);
+      std::string hash(SHA512_DIGEST_LENGTH, '\0');
+      message_digest(input.data(), input.size(), EVP_sha512(), reinterpret_cast<unsigned char *>(&hash[0]), iterations);
       return hash;
     }
 
@@ -0,0 +1,309 @@
+#ifndef SIMPLE_WEB_FILE_CACHE_HPP
+#define SIMPLE_WEB_FILE_CACHE_HPP
+
+#include "asio_compatibility.hpp"
+#include "mutex.hpp"
+#include "status_code.hpp"
+#include "utility.hpp"
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <list>
+#include <memory>
+#include <string>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unordered_map>
+
+namespace SimpleWeb {
+  /// In-memory cache of static files, for instance the assets of a web interface.
+  ///
+  /// Entries are keyed by path, and are reloaded when the modification time or size of the file,
+  /// or of one of its precompressed variants (path + ".br" and path + ".gz"), changes.
+  /// Each representation has a strong ETag computed from its content.
+  /// The least recently used entries are evicted when the cache grows larger than max_size.
+  class FileCache {
+  public:
+    class Representation {
+    public:
+      /// nullptr if the representation does not exist.
+      std::shared_ptr<const std::string> content;
+      /// Quoted strong entity tag.
+      std::string etag;
+      /// Value of Content-Encoding, empty for the identity representation.
+      std::string encoding;
+    };
+
+    class Entry {
+      friend class FileCache;
+
+      class Stat {
+      public:
+        bool exists = false;
+        long long modified = 0;
+        long long size = 0;
+
+        bool operator==(const Stat &other) const noexcept {
+          return exists == other.exists && modified == other.modified && size == other.size;
+        }
+      };
+
+      Stat stats[3];
+
+    public:
+      Representation identity;
+      Representation brotli;
+      Representation gzip;
+      /// Modification time of the file, formatted for the Last-Modified header field.
+      std::string last_modified;
+
+      /// Returns the best representation acceptable according to the Accept-Encoding header field of a request.
+      /// Brotli is preferred over gzip when both are equally acceptable.
+      const Representation &select(const CaseInsensitiveMultimap &request_header) const noexcept {
+        if(!brotli.content && !gzip.content)
+          return identity;
+        auto it = request_header.find("Accept-Encoding");
+        if(it == request_header.end())
+          return identity;
+
+        auto br_quality = quality(it->second, "br");
+        auto gzip_quality = quality(it->second, "gzip");
+        if(brotli.content && br_quality > 0 && (!gzip.content || br_quality >= gzip_quality))
+          return brotli;
+        if(gzip.content && gzip_quality > 0)
+          return gzip;
+        return identity;
+      }
+
+      std::size_t size() const noexcept {
+        return (identity.content ? identity.content->size() : 0) +
+               (brotli.content ? brotli.content->size() : 0) +
+               (gzip.content ? gzip.content->size() : 0);
+      }
+
+    private:
+      /// Returns the quality value, in thousandths, of coding in an Accept-Encoding field value.
+      static int quality(const std::string &accept_encoding, const char *coding) noexcept {
+        int wildcard = 0;
+        std::size_t pos = 0;
+        while(pos < accept_encoding.size()) {
+          auto end = accept_encoding.find(',', pos);
+          if(end == std::string::npos)
+            end = accept_encoding.size();
+
+          auto token_begin = accept_encoding.find_first_not_of(" \t", pos);
+          if(token_begin != std::string::npos && token_begin < end) {
+            auto token_end = accept_encoding.find_first_of(" \t;", token_begin);
+            if(token_end == std::string::npos || token_end > end)
+              token_end = end;
+
+            int value = 1000;
+            auto q = accept_encoding.find("q=", token_end);
+            if(q != std::string::npos && q < end) {
+              value = 0;
+              int digits = 0;
+              bool fraction = false;
+              for(auto i = q + 2; i < end && digits < 4; ++i) {
+                auto c = accept_encoding[i];
+                if(c == '.' && !fraction)
+                  fraction = true;
+                else if(c >= '0' && c <= '9') {
+                  value = value * 10 + (c - '0');
+                  if(fraction)
+                    ++digits;
+                }
+                else
+                  break;
+              }
+              if(!fraction)
+                value *= 1000;
+              else
+                for(; digits < 3; ++digits)
+                  value *= 10;
+            }
+
+            auto token_size = token_end - token_begin;
+            if(token_size == 1 && accept_encoding[token_begin] == '*')
+              wildcard = value;
+            else if(case_insensitive_equal(accept_encoding.substr(token_begin, token_size), coding))
+              return value;
+          }
+          pos = end + 1;
+        }
+        return wildcard;
+      }
+    };
+
+    /// max_size is the total size of cached content, and files larger than max_file_size are not cached.
+    FileCache(std::size_t max_size = 64 * 1024 * 1024, std::size_t max_file_size = 8 * 1024 * 1024) noexcept
+        : max_size(max_size), max_file_size(max_file_size) {}
+
+    /// Returns the cached entry of the file at path, reading it if it is not cached or has changed.
+    /// Returns nullptr with ec set if the file could not be read, or nullptr with ec cleared if it is larger than max_file_size.
+    std::shared_ptr<const Entry> get(const std::string &path, error_code &ec) {
+      ec = error_code();
+      Entry::Stat stats[3];
+      stats[0] = stat(path);
+      if(!stats[0].exists) {
+        ec = make_error_code::make_error_code(errc::no_such_file_or_directory);
+        return nullptr;
+      }
+      if(static_cast<unsigned long long>(stats[0].size) > max_file_size)
+        return nullptr;
+      stats[1] = stat(path + ".br");
+      stats[2] = stat(path + ".gz");
+
+      {
+        LockGuard lock(mutex);
+        auto it = entries.find(path);
+        if(it != entries.end()) {
+          auto &entry = it->second.first;
+          if(entry->stats[0] == stats[0] && entry->stats[1] == stats[1] && entry->stats[2] == stats[2]) {
+            order.splice(order.begin(), order, it->second.second);
+            return entry;
+          }
+          remove(it);
+        }
+      }
+
+      auto entry = std::make_shared<Entry>();
+      if(!load(path, stats[0], entry->identity)) {
+        ec = make_error_code::make_error_code(errc::io_error);
+        return nullptr;
+      }
+      // Precompressed variants older than the file are stale, and are not served
+      if(stats[1].exists && stats[1].modified >= stats[0].modified && load(path + ".br", stats[1], entry->brotli))
+        entry->brotli.encoding = "br";
+      if(stats[2].exists && stats[2].modified >= stats[0].modified && load(path + ".gz", stats[2], entry->gzip))
+        entry->gzip.encoding = "gzip";
+      for(std::size_t i = 0; i < 3; ++i)
+        entry->stats[i] = stats[i];
+      entry->last_modified = Date::to_string(std::chrono::system_clock::from_time_t(static_cast<std::time_t>(stats[0].modified)));
+
+      auto entry_size = entry->size();
+      if(entry_size > max_size)
+        return entry;
+
+      LockGuard lock(mutex);
+      auto it = entries.find(path);
+      if(it != entries.end())
+        remove(it);
+      order.emplace_front(path);
+      entries.emplace(path, std::make_pair(entry, order.begin()));
+      size += entry_size;
+      while(size > max_size)
+        remove(entries.find(order.back()));
+      return entry;
+    }
+
+    /// Writes the representation of entry selected by the request header, or 304 Not Modified if it matches If-None-Match.
+    /// The ETag, Last-Modified and, when precompressed variants exist, Vary and Content-Encoding header fields are added to header.
+    template <class Response>
+    static void write(const std::shared_ptr<Response> &response, const Entry &entry, const CaseInsensitiveMultimap &request_header, CaseInsensitiveMultimap header = CaseInsensitiveMultimap()) {
+      auto &representation = entry.select(request_header);
+      header.emplace("ETag", representation.etag);
+      header.emplace("Last-Modified", entry.last_modified);
+      if(entry.brotli.content || entry.gzip.content)
+        header.emplace("Vary", "Accept-Encoding");
+
+      auto it = request_header.find("If-None-Match");
+      if(it != request_header.end() && matches(it->second, representation.etag)) {
+        response->write(StatusCode::redirection_not_modified, header);
+        return;
+      }
+
+      if(!representation.encoding.empty())
+        header.emplace("Content-Encoding", representation.encoding);
+      response->write(StatusCode::success_ok, representation.content, header);
+    }
+
+    /// Returns true if an If-None-Match field value matches etag, using the weak comparison of RFC 7232.
+    static bool matches(const std::string &if_none_match, const std::string &etag) noexcept {
+      std::size_t pos = 0;
+      while(pos < if_none_match.size()) {
+        pos = if_none_match.find_first_not_of(" \t,", pos);
+        if(pos == std::string::npos)
+          break;
+        if(if_none_match[pos] == '*')
+          return true;
+        if(if_none_match.compare(pos, 2, "W/") == 0)
+          pos += 2;
+        auto end = if_none_match.find('"', pos + 1);
+        if(end == std::string::npos)
+          break;
+        if(if_none_match.compare(pos, end + 1 - pos, etag) == 0)
+          return true;
+        pos = end + 1;
+      }
+      return false;
+    }
+
+    void clear() noexcept {
+      LockGuard lock(mutex);
+      entries.clear();
+      order.clear();
+      size = 0;
+    }
+
+  private:
+    std::size_t max_size;
+    std::size_t max_file_size;
+
+    Mutex mutex;
+    std::list<std::string> order GUARDED_BY(mutex);
+    std::unordered_map<std::string, std::pair<std::shared_ptr<const Entry>, std::list<std::string>::iterator>> entries GUARDED_BY(mutex);
+    std::size_t size GUARDED_BY(mutex) = 0;
+
+    void remove(std::unordered_map<std::string, std::pair<std::shared_ptr<const Entry>, std::list<std::string>::iterator>>::iterator it) REQUIRES(mutex) {
+      size -= it->second.first->size();
+      order.erase(it->second.second);
+      entries.erase(it);
+    }
+
+    static Entry::Stat stat(const std::string &path) noexcept {
+      Entry::Stat result;
+#ifdef _WIN32
+      struct _stat64 status;
+      if(_stat64(path.c_str(), &status) != 0 || (status.st_mode & _S_IFREG) == 0)
+        return result;
+#else
+      struct stat status;
+      if(::stat(path.c_str(), &status) != 0 || !S_ISREG(status.st_mode))
+        return result;
+#endif
+      result.exists = true;
+      result.modified = static_cast<long long>(status.st_mtime);
+      result.size = static_cast<long long>(status.st_size);
+      return result;
+    }
+
+    static bool load(const std::string &path, const Entry::Stat &stat, Representation &representation) {
+      std::ifstream ifs(path, std::ifstream::in | std::ios::binary);
+      if(!ifs)
+        return false;
+      auto content = std::make_shared<std::string>(static_cast<std::size_t>(stat.size), '\0');
+      if(!content->empty() && ifs.read(&(*content)[0], static_cast<std::streamsize>(content->size())).gcount() != static_cast<std::streamsize>(content->size()))
+        return false;
+
+      // 64-bit FNV-1a of the content, with the size to make collisions even less likely
+      std::uint64_t hash = 14695981039346656037ULL;
+      for(auto c : *content) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+      }
+      static const char hex[] = "0123456789abcdef";
+      std::string etag = "\"";
+      for(int shift = 60; shift >= 0; shift -= 4)
+        etag += hex[(hash >> shift) & 0xf];
+      etag += '-';
+      etag += std::to_string(content->size());
+      etag += '"';
+
+      representation.content = std::move(content);
+      representation.etag = std::move(etag);
+      return true;
+    }
+  };
+} // namespace SimpleWeb
+
+#endif /* SIMPLE_WEB_FILE_CACHE_HPP */
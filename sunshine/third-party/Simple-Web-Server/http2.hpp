@@ -0,0 +1,550 @@
+#ifndef SIMPLE_WEB_HTTP2_HPP
+#define SIMPLE_WEB_HTTP2_HPP
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace SimpleWeb {
+  /// HTTP/2 framing (RFC 7540) and HPACK header compression (RFC 7541), without any I/O.
+  class Http2 {
+  public:
+    enum class FrameType : std::uint8_t { data = 0x0,
+                                          headers = 0x1,
+                                          priority = 0x2,
+                                          rst_stream = 0x3,
+                                          settings = 0x4,
+                                          push_promise = 0x5,
+                                          ping = 0x6,
+                                          goaway = 0x7,
+                                          window_update = 0x8,
+                                          continuation = 0x9 };
+
+    enum Flag : std::uint8_t { end_stream = 0x1,
+                               ack = 0x1,
+                               end_headers = 0x4,
+                               padded = 0x8,
+                               priority = 0x20 };
+
+    enum class Setting : std::uint16_t { header_table_size = 0x1,
+                                         enable_push = 0x2,
+                                         max_concurrent_streams = 0x3,
+                                         initial_window_size = 0x4,
+                                         max_frame_size = 0x5,
+                                         max_header_list_size = 0x6 };
+
+    enum class ErrorCode : std::uint32_t { no_error = 0x0,
+                                           protocol_error = 0x1,
+                                           internal_error = 0x2,
+                                           flow_control_error = 0x3,
+                                           settings_timeout = 0x4,
+                                           stream_closed = 0x5,
+                                           frame_size_error = 0x6,
+                                           refused_stream = 0x7,
+                                           cancel = 0x8,
+                                           compression_error = 0x9,
+                                           connect_error = 0xa,
+                                           enhance_your_calm = 0xb,
+                                           inadequate_security = 0xc,
+                                           http_1_1_required = 0xd };
+
+    /// The octets that a client sends first. Its first 18 octets, "PRI * HTTP/2.0\r\n\r\n", look like an HTTP/1 request without header fields.
+    static const std::string &client_preface() noexcept {
+      static const std::string preface("PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n");
+      return preface;
+    }
+
+    static std::size_t frame_header_size() noexcept {
+      return 9;
+    }
+
+    /// Frame size and flow control window size that apply until changed by SETTINGS.
+    static std::size_t default_max_frame_size() noexcept {
+      return 16384;
+    }
+    static std::int64_t default_window_size() noexcept {
+      return 65535;
+    }
+    static std::int64_t max_window_size() noexcept {
+      return 0x7FFFFFFF;
+    }
+
+    static std::uint32_t read_uint32(const unsigned char *data) noexcept {
+      return (static_cast<std::uint32_t>(data[0]) << 24) | (static_cast<std::uint32_t>(data[1]) << 16) | (static_cast<std::uint32_t>(data[2]) << 8) | data[3];
+    }
+
+    static void append_uint32(std::string &out, std::uint32_t value) {
+      char bytes[4] = {static_cast<char>(value >> 24), static_cast<char>(value >> 16), static_cast<char>(value >> 8), static_cast<char>(value)};
+      out.append(bytes, 4);
+    }
+
+    class FrameHeader {
+    public:
+      std::uint32_t length = 0;
+      FrameType type = FrameType::data;
+      std::uint8_t flags = 0;
+      std::uint32_t stream_id = 0;
+
+      FrameHeader() noexcept {}
+      FrameHeader(std::uint32_t length, FrameType type, std::uint8_t flags, std::uint32_t stream_id) noexcept : length(length), type(type), flags(flags), stream_id(stream_id) {}
+
+      /// Parses the frame_header_size() octets at data.
+      static FrameHeader parse(const unsigned char *data) noexcept {
+        FrameHeader header;
+        header.length = (static_cast<std::uint32_t>(data[0]) << 16) | (static_cast<std::uint32_t>(data[1]) << 8) | data[2];
+        header.type = static_cast<FrameType>(data[3]);
+        header.flags = data[4];
+        header.stream_id = read_uint32(data + 5) & 0x7FFFFFFF;
+        return header;
+      }
+
+      void write(std::string &out) const {
+        char bytes[5] = {static_cast<char>(length >> 16), static_cast<char>(length >> 8), static_cast<char>(length), static_cast<char>(type), static_cast<char>(flags)};
+        out.append(bytes, 5);
+        append_uint32(out, stream_id);
+      }
+    };
+
+    /// Appends a frame whose payload is a single 32-bit value, like RST_STREAM or WINDOW_UPDATE.
+    static void append_frame(std::string &out, FrameType type, std::uint32_t stream_id, std::uint32_t value) {
+      FrameHeader(4, type, 0, stream_id).write(out);
+      append_uint32(out, value);
+    }
+
+    static void append_settings(std::string &out, const std::vector<std::pair<Setting, std::uint32_t>> &settings) {
+      FrameHeader(static_cast<std::uint32_t>(settings.size() * 6), FrameType::settings, 0, 0).write(out);
+      for(auto &setting : settings) {
+        out += static_cast<char>(static_cast<std::uint16_t>(setting.first) >> 8);
+        out += static_cast<char>(static_cast<std::uint16_t>(setting.first));
+        append_uint32(out, setting.second);
+      }
+    }
+
+    static void append_goaway(std::string &out, std::uint32_t last_stream_id, ErrorCode error_code) {
+      FrameHeader(8, FrameType::goaway, 0, 0).write(out);
+      append_uint32(out, last_stream_id);
+      append_uint32(out, static_cast<std::uint32_t>(error_code));
+    }
+
+    /// HPACK header compression.
+    class Hpack {
+    public:
+      using Field = std::pair<std::string, std::string>;
+
+      /// Size of the dynamic tables until changed by SETTINGS_HEADER_TABLE_SIZE.
+      static std::size_t default_table_size() noexcept {
+        return 4096;
+      }
+
+      /// Decodes an integer with an N-bit prefix (RFC 7541 5.1), advancing data.
+      static bool decode_integer(const unsigned char *&data, const unsigned char *end, int prefix_bits, std::uint64_t &value) noexcept {
+        if(data == end)
+          return false;
+        std::uint64_t max_prefix = (1u << prefix_bits) - 1;
+        value = *data++ & max_prefix;
+        if(value < max_prefix)
+          return true;
+        for(int shift = 0;; shift += 7) {
+          if(data == end || shift > 56)
+            return false;
+          auto byte = *data++;
+          value += static_cast<std::uint64_t>(byte & 0x7F) << shift;
+          if((byte & 0x80) == 0)
+            return true;
+        }
+      }
+
+      /// Appends an integer with an N-bit prefix, where the bits above the prefix of the first octet are set to flags.
+      static void encode_integer(std::string &out, std::uint8_t flags, int prefix_bits, std::uint64_t value) {
+        std::uint64_t max_prefix = (1u << prefix_bits) - 1;
+        if(value < max_prefix) {
+          out += static_cast<char>(flags | value);
+          return;
+        }
+        out += static_cast<char>(flags | max_prefix);
+        value -= max_prefix;
+        while(value >= 0x80) {
+          out += static_cast<char>((value & 0x7F) | 0x80);
+          value >>= 7;
+        }
+        out += static_cast<char>(value);
+      }
+
+    private:
+      /// The Huffman code of each octet, and of EOS at 256 (RFC 7541 Appendix B).
+      static const std::uint32_t *huffman_codes() noexcept {
+        static const std::uint32_t codes[257] = {
+          0x1ff8, 0x7fffd8, 0xfffffe2, 0xfffffe3, 0xfffffe4, 0xfffffe5, 0xfffffe6, 0xfffffe7,
+          0xfffffe8, 0xffffea, 0x3ffffffc, 0xfffffe9, 0xfffffea, 0x3ffffffd, 0xfffffeb, 0xfffffec,
+          0xfffffed, 0xfffffee, 0xfffffef, 0xffffff0, 0xffffff1, 0xffffff2, 0x3ffffffe, 0xffffff3,
+          0xffffff4, 0xffffff5, 0xffffff6, 0xffffff7, 0xffffff8, 0xffffff9, 0xffffffa, 0xffffffb,
+          0x14, 0x3f8, 0x3f9, 0xffa, 0x1ff9, 0x15, 0xf8, 0x7fa,
+          0x3fa, 0x3fb, 0xf9, 0x7fb, 0xfa, 0x16, 0x17, 0x18,
+          0x0, 0x1, 0x2, 0x19, 0x1a, 0x1b, 0x1c, 0x1d,
+          0x1e, 0x1f, 0x5c, 0xfb, 0x7ffc, 0x20, 0xffb, 0x3fc,
+          0x1ffa, 0x21, 0x5d, 0x5e, 0x5f, 0x60, 0x61, 0x62,
+          0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a,
+          0x6b, 0x6c, 0x6d, 0x6e, 0x6f, 0x70, 0x71, 0x72,
+          0xfc, 0x73, 0xfd, 0x1ffb, 0x7fff0, 0x1ffc, 0x3ffc, 0x22,
+          0x7ffd, 0x3, 0x23, 0x4, 0x24, 0x5, 0x25, 0x26,
+          0x27, 0x6, 0x74, 0x75, 0x28, 0x29, 0x2a, 0x7,
+          0x2b, 0x76, 0x2c, 0x8, 0x9, 0x2d, 0x77, 0x78,
+          0x79, 0x7a, 0x7b, 0x7ffe, 0x7fc, 0x3ffd, 0x1ffd, 0xffffffc,
+          0xfffe6, 0x3fffd2, 0xfffe7, 0xfffe8, 0x3fffd3, 0x3fffd4, 0x3fffd5, 0x7fffd9,
+          0x3fffd6, 0x7fffda, 0x7fffdb, 0x7fffdc, 0x7fffdd, 0x7fffde, 0xffffeb, 0x7fffdf,
+          0xffffec, 0xffffed, 0x3fffd7, 0x7fffe0, 0xffffee, 0x7fffe1, 0x7fffe2, 0x7fffe3,
+          0x7fffe4, 0x1fffdc, 0x3fffd8, 0x7fffe5, 0x3fffd9, 0x7fffe6, 0x7fffe7, 0xffffef,
+          0x3fffda, 0x1fffdd, 0xfffe9, 0x3fffdb, 0x3fffdc, 0x7fffe8, 0x7fffe9, 0x1fffde,
+          0x7fffea, 0x3fffdd, 0x3fffde, 0xfffff0, 0x1fffdf, 0x3fffdf, 0x7fffeb, 0x7fffec,
+          0x1fffe0, 0x1fffe1, 0x3fffe0, 0x1fffe2, 0x7fffed, 0x3fffe1, 0x7fffee, 0x7fffef,
+          0xfffea, 0x3fffe2, 0x3fffe3, 0x3fffe4, 0x7ffff0, 0x3fffe5, 0x3fffe6, 0x7ffff1,
+          0x3ffffe0, 0x3ffffe1, 0xfffeb, 0x7fff1, 0x3fffe7, 0x7ffff2, 0x3fffe8, 0x1ffffec,
+          0x3ffffe2, 0x3ffffe3, 0x3ffffe4, 0x7ffffde, 0x7ffffdf, 0x3ffffe5, 0xfffff1, 0x1ffffed,
+          0x7fff2, 0x1fffe3, 0x3ffffe6, 0x7ffffe0, 0x7ffffe1, 0x3ffffe7, 0x7ffffe2, 0xfffff2,
+          0x1fffe4, 0x1fffe5, 0x3ffffe8, 0x3ffffe9, 0xffffffd, 0x7ffffe3, 0x7ffffe4, 0x7ffffe5,
+          0xfffec, 0xfffff3, 0xfffed, 0x1fffe6, 0x3fffe9, 0x1fffe7, 0x1fffe8, 0x7ffff3,
+          0x3fffea, 0x3fffeb, 0x1ffffee, 0x1ffffef, 0xfffff4, 0xfffff5, 0x3ffffea, 0x7ffff4,
+          0x3ffffeb, 0x7ffffe6, 0x3ffffec, 0x3ffffed, 0x7ffffe7, 0x7ffffe8, 0x7ffffe9, 0x7ffffea,
+          0x7ffffeb, 0xffffffe, 0x7ffffec, 0x7ffffed, 0x7ffffee, 0x7ffffef, 0x7fffff0, 0x3ffffee,
+          0x3fffffff,
+        };
+        return codes;
+      }
+
+      static const std::uint8_t *huffman_code_lengths() noexcept {
+        static const std::uint8_t lengths[257] = {
+          13, 23, 28, 28, 28, 28, 28, 28, 28, 24, 30, 28, 28, 30, 28, 28,
+          28, 28, 28, 28, 28, 28, 30, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+          6, 10, 10, 12, 13, 6, 8, 11, 10, 10, 8, 11, 8, 6, 6, 6,
+          5, 5, 5, 6, 6, 6, 6, 6, 6, 6, 7, 8, 15, 6, 12, 10,
+          13, 6, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+          7, 7, 7, 7, 7, 7, 7, 7, 8, 7, 8, 13, 19, 13, 14, 6,
+          15, 5, 6, 5, 6, 5, 6, 6, 6, 5, 7, 7, 6, 6, 6, 5,
+          6, 7, 6, 5, 5, 6, 7, 7, 7, 7, 7, 15, 11, 14, 13, 28,
+          20, 22, 20, 20, 22, 22, 22, 23, 22, 23, 23, 23, 23, 23, 24, 23,
+          24, 24, 22, 23, 24, 23, 23, 23, 23, 21, 22, 23, 22, 23, 23, 24,
+          22, 21, 20, 22, 22, 23, 23, 21, 23, 22, 22, 24, 21, 22, 23, 23,
+          21, 21, 22, 21, 23, 22, 23, 23, 20, 22, 22, 22, 23, 22, 22, 23,
+          26, 26, 20, 19, 22, 23, 22, 25, 26, 26, 26, 27, 27, 26, 24, 25,
+          19, 21, 26, 27, 27, 26, 27, 24, 21, 21, 26, 26, 28, 27, 27, 27,
+          20, 24, 20, 21, 22, 21, 21, 23, 22, 22, 25, 25, 24, 24, 26, 23,
+          26, 27, 26, 26, 27, 27, 27, 27, 27, 28, 27, 27, 27, 27, 27, 26,
+          30,
+        };
+        return lengths;
+      }
+
+      /// Binary tree of the Huffman codes, where a child index of 0 means no child and a negative index -(symbol + 1) a leaf.
+      class HuffmanTree {
+      public:
+        std::vector<std::array<int, 2>> nodes;
+
+        HuffmanTree() {
+          nodes.emplace_back(std::array<int, 2>{{0, 0}});
+          for(int symbol = 0; symbol < 257; ++symbol) {
+            auto code = huffman_codes()[symbol];
+            int length = huffman_code_lengths()[symbol];
+            std::size_t node = 0;
+            for(int bit = length - 1; bit >= 0; --bit) {
+              auto &child = nodes[node][(code >> bit) & 1];
+              if(bit == 0)
+                child = -(symbol + 1);
+              else {
+                if(child == 0) {
+                  child = static_cast<int>(nodes.size());
+                  nodes.emplace_back(std::array<int, 2>{{0, 0}}); // child is invalidated
+                }
+                node = static_cast<std::size_t>(nodes[node][(code >> bit) & 1]);
+              }
+            }
+          }
+        }
+      };
+
+    public:
+      /// Appends the Huffman decoded data to out. Returns false if data is not a valid Huffman encoded string.
+      static bool huffman_decode(const unsigned char *data, std::size_t size, std::string &out) {
+        static const HuffmanTree tree;
+        std::size_t node = 0;
+        int bits = 0; // Bits since the last symbol, which must be at most 7 ones of the EOS code at the end
+        bool ones = true;
+        for(std::size_t c = 0; c < size; ++c) {
+          for(int bit = 7; bit >= 0; --bit) {
+            auto value = static_cast<std::size_t>((data[c] >> bit) & 1);
+            auto child = tree.nodes[node][value];
+            if(child < 0) {
+              if(child == -257) // EOS
+                return false;
+              out += static_cast<char>(-child - 1);
+              node = 0;
+              bits = 0;
+              ones = true;
+            }
+            else if(child == 0)
+              return false;
+            else {
+              node = static_cast<std::size_t>(child);
+              ++bits;
+              ones = ones && value == 1;
+            }
+          }
+        }
+        return bits <= 7 && ones;
+      }
+
+      static std::size_t huffman_encoded_size(const std::string &str) noexcept {
+        std::size_t bits = 0;
+        for(auto chr : str)
+          bits += huffman_code_lengths()[static_cast<unsigned char>(chr)];
+        return (bits + 7) / 8;
+      }
+
+      static void huffman_encode(const std::string &str, std::string &out) {
+        std::uint64_t pending = 0;
+        int pending_bits = 0;
+        for(auto chr : str) {
+          auto symbol = static_cast<unsigned char>(chr);
+          pending = (pending << huffman_code_lengths()[symbol]) | huffman_codes()[symbol];
+          pending_bits += huffman_code_lengths()[symbol];
+          while(pending_bits >= 8) {
+            pending_bits -= 8;
+            out += static_cast<char>(pending >> pending_bits);
+          }
+        }
+        if(pending_bits > 0) // Padded with the most significant bits of EOS
+          out += static_cast<char>((pending << (8 - pending_bits)) | (0xFF >> pending_bits));
+      }
+
+      static std::size_t static_table_size() noexcept {
+        return 61;
+      }
+
+      /// Returns the static table entry at index, from 1 to static_table_size().
+      static const Field &static_field(std::size_t index) noexcept {
+        static const Field fields[61] = {
+            {":authority", ""}, {":method", "GET"}, {":method", "POST"}, {":path", "/"}, {":path", "/index.html"}, {":scheme", "http"}, {":scheme", "https"}, {":status", "200"}, {":status", "204"}, {":status", "206"}, {":status", "304"}, {":status", "400"}, {":status", "404"}, {":status", "500"}, {"accept-charset", ""}, {"accept-encoding", "gzip, deflate"}, {"accept-language", ""}, {"accept-ranges", ""}, {"accept", ""}, {"access-control-allow-origin", ""}, {"age", ""}, {"allow", ""}, {"authorization", ""}, {"cache-control", ""}, {"content-disposition", ""}, {"content-encoding", ""}, {"content-language", ""}, {"content-length", ""}, {"content-location", ""}, {"content-range", ""}, {"content-type", ""}, {"cookie", ""}, {"date", ""}, {"etag", ""}, {"expect", ""}, {"expires", ""}, {"from", ""}, {"host", ""}, {"if-match", ""}, {"if-modified-since", ""}, {"if-none-match", ""}, {"if-range", ""}, {"if-unmodified-since", ""}, {"last-modified", ""}, {"link", ""}, {"location", ""}, {"max-forwards", ""}, {"proxy-authenticate", ""}, {"proxy-authorization", ""}, {"range", ""}, {"referer", ""}, {"refresh", ""}, {"retry-after", ""}, {"server", ""}, {"set-cookie", ""}, {"strict-transport-security", ""}, {"transfer-encoding", ""}, {"user-agent", ""}, {"vary", ""}, {"via", ""}, {"www-authenticate", ""}};
+        return fields[index - 1];
+      }
+
+      /// The dynamic table, where index 0 is the most recently added entry.
+      class DynamicTable {
+        std::deque<Field> entries;
+        std::size_t size_ = 0;
+        std::size_t max_size_ = default_table_size();
+
+        static std::size_t entry_size(const Field &field) noexcept {
+          return field.first.size() + field.second.size() + 32;
+        }
+
+        void evict(std::size_t max_size) noexcept {
+          while(size_ > max_size) {
+            size_ -= entry_size(entries.back());
+            entries.pop_back();
+          }
+        }
+
+      public:
+        std::size_t size() const noexcept {
+          return entries.size();
+        }
+        std::size_t max_size() const noexcept {
+          return max_size_;
+        }
+        const Field &operator[](std::size_t index) const noexcept {
+          return entries[index];
+        }
+
+        void set_max_size(std::size_t max_size) noexcept {
+          max_size_ = max_size;
+          evict(max_size);
+        }
+
+        /// Returns true if the field fits in the table after evicting older entries.
+        bool fits(const Field &field) const noexcept {
+          return entry_size(field) <= max_size_;
+        }
+
+        void add(Field field) {
+          auto size = entry_size(field);
+          if(size > max_size_) {
+            evict(0);
+            return;
+          }
+          evict(max_size_ - size);
+          entries.emplace_front(std::move(field));
+          size_ += size;
+        }
+      };
+
+      class Decoder {
+        DynamicTable table;
+        std::size_t max_table_size = default_table_size();
+
+        bool field(std::uint64_t index, Field &field) const {
+          if(index == 0)
+            return false;
+          if(index <= static_table_size())
+            field = static_field(static_cast<std::size_t>(index));
+          else if(index - static_table_size() <= table.size())
+            field = table[static_cast<std::size_t>(index - static_table_size() - 1)];
+          else
+            return false;
+          return true;
+        }
+
+        static bool string(const unsigned char *&data, const unsigned char *end, std::string &str) {
+          if(data == end)
+            return false;
+          bool huffman = (*data & 0x80) != 0;
+          std::uint64_t size;
+          if(!decode_integer(data, end, 7, size) || size > static_cast<std::uint64_t>(end - data))
+            return false;
+          str.clear();
+          if(huffman) {
+            if(!huffman_decode(data, static_cast<std::size_t>(size), str))
+              return false;
+          }
+          else
+            str.assign(reinterpret_cast<const char *>(data), static_cast<std::size_t>(size));
+          data += size;
+          return true;
+        }
+
+      public:
+        /// Decodes a complete header block, appending its fields to fields.
+        /// Returns false on a compression error, after which the decoder must not be used anymore.
+        bool decode(const unsigned char *data, std::size_t size, std::vector<Field> &fields) {
+          auto end = data + size;
+          bool fields_decoded = false;
+          while(data != end) {
+            auto first = *data;
+            std::uint64_t index;
+            if(first & 0x80) { // Indexed
+              Field field;
+              if(!decode_integer(data, end, 7, index) || !this->field(index, field))
+                return false;
+              fields.emplace_back(std::move(field));
+              fields_decoded = true;
+            }
+            else if((first & 0xE0) == 0x20) { // Dynamic table size update, only allowed at the beginning of the block
+              if(fields_decoded || !decode_integer(data, end, 5, index) || index > max_table_size)
+                return false;
+              table.set_max_size(static_cast<std::size_t>(index));
+            }
+            else { // Literal, with incremental indexing, without indexing or never indexed
+              bool indexing = (first & 0xC0) == 0x40;
+              Field field;
+              if(!decode_integer(data, end, indexing ? 6 : 4, index))
+                return false;
+              if(index != 0) {
+                if(!this->field(index, field))
+                  return false;
+              }
+              else if(!string(data, end, field.first))
+                return false;
+              if(!string(data, end, field.second))
+                return false;
+              if(indexing)
+                table.add(field);
+              fields.emplace_back(std::move(field));
+              fields_decoded = true;
+            }
+          }
+          return true;
+        }
+      };
+
+      class Encoder {
+        DynamicTable table;
+        /// Set when the table size has been changed since the last header block, which must then start with size updates.
+        bool size_update_pending = false;
+        std::size_t min_size_since_update = 0;
+
+        /// Fields whose values differ between responses are not added to the dynamic table,
+        /// and secret ones are sent as never indexed so that intermediaries do not compress them either.
+        static bool indexed(const std::string &name) noexcept {
+          return name != "content-length" && name != "date" && name != "etag" && name != "last-modified" && name != "expires" && name != "age";
+        }
+        static bool sensitive(const std::string &name) noexcept {
+          return name == "set-cookie" || name == "authorization" || name == "proxy-authorization";
+        }
+
+        static void string(const std::string &str, std::string &out) {
+          auto huffman_size = huffman_encoded_size(str);
+          if(huffman_size < str.size()) {
+            encode_integer(out, 0x80, 7, huffman_size);
+            huffman_encode(str, out);
+          }
+          else {
+            encode_integer(out, 0x00, 7, str.size());
+            out += str;
+          }
+        }
+
+      public:
+        /// Sets the table size to use, which must be at most the SETTINGS_HEADER_TABLE_SIZE of the peer.
+        void set_max_table_size(std::size_t max_size) noexcept {
+          if(!size_update_pending || max_size < min_size_since_update)
+            min_size_since_update = max_size;
+          size_update_pending = true;
+          table.set_max_size(max_size);
+        }
+
+        /// Appends the header block of fields to out. Names must be lowercase.
+        void encode(const std::vector<Field> &fields, std::string &out) {
+          if(size_update_pending) {
+            if(min_size_since_update < table.max_size())
+              encode_integer(out, 0x20, 5, min_size_since_update);
+            encode_integer(out, 0x20, 5, table.max_size());
+            size_update_pending = false;
+          }
+
+          for(auto &field : fields) {
+            std::size_t name_index = 0;
+            std::size_t index = 0;
+            for(std::size_t c = 1; c <= static_table_size() && index == 0; ++c) {
+              auto &static_field = Hpack::static_field(c);
+              if(static_field.first == field.first) {
+                if(name_index == 0)
+                  name_index = c;
+                if(static_field.second == field.second)
+                  index = c;
+              }
+            }
+            for(std::size_t c = 0; c < table.size() && index == 0; ++c) {
+              if(table[c].first == field.first) {
+                if(name_index == 0)
+                  name_index = static_table_size() + 1 + c;
+                if(table[c].second == field.second)
+                  index = static_table_size() + 1 + c;
+              }
+            }
+
+            if(index != 0) {
+              encode_integer(out, 0x80, 7, index);
+              continue;
+            }
+
+            bool is_sensitive = sensitive(field.first);
+            bool indexing = !is_sensitive && indexed(field.first) && table.fits(field);
+            if(indexing)
+              encode_integer(out, 0x40, 6, name_index);
+            else
+              encode_integer(out, is_sensitive ? 0x10 : 0x00, 4, name_index);
+            if(name_index == 0)
+              string(field.first, out);
+            string(field.second, out);
+            if(indexing)
+              table.add(field);
+          }
+        }
+      };
+    };
+  };
+} // namespace SimpleWeb
+
+#endif /* SIMPLE_WEB_HTTP2_HPP */
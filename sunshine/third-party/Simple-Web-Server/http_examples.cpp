@@ -8,13 +8,11 @@
 #include <boost/property_tree/ptree.hpp>
 
 // Added for the default_resource example
+#include "file_cache.hpp"
 #include <algorithm>
 #include <boost/filesystem.hpp>
 #include <fstream>
 #include <vector>
-#ifdef HAVE_OPENSSL
-#include "crypto.hpp"
-#endif
 
 using namespace std;
 // Added for the json-example:
@@ -121,11 +119,14 @@ int main() {
     work_thread.detach();
   };
 
+  // Cache of the files served by default_resource
+  SimpleWeb::FileCache file_cache;
+
   // Default GET-example. If no other matches, this anonymous function will be called.
   // Will respond with content in the web/-directory, and its subdirectories.
   // Default file: index.html
   // Can for instance be used to retrieve an HTML 5 client that uses REST-resources on this server
-  server.default_resource["GET"] = [](shared_ptr<HttpServer::Response> response, shared_ptr<HttpServer::Request> request) {
+  server.default_resource["GET"] = [&file_cache](shared_ptr<HttpServer::Response> response, shared_ptr<HttpServer::Request> request) {
     try {
       auto web_root_path = boost::filesystem::canonical("web");
       auto path = boost::filesystem::canonical(web_root_path / request->path);
@@ -141,25 +142,15 @@ int main() {
       // Uncomment the following line to enable Cache-Control
       // header.emplace("Cache-Control", "max-age=86400");
 
-#ifdef HAVE_OPENSSL
-//    Uncomment the following lines to enable ETag
-//    {
-//      ifstream ifs(path.string(), ifstream::in | ios::binary);
-//      if(ifs) {
-//        auto hash = SimpleWeb::Crypto::to_hex_string(SimpleWeb::Crypto::md5(ifs));
-//        header.emplace("ETag", "\"" + hash + "\"");
-//        auto it = request->header.find("If-None-Match");
-//        if(it != request->header.end()) {
-//          if(!it->second.empty() && it->second.compare(1, hash.size(), hash) == 0) {
-//            response->write(SimpleWeb::StatusCode::redirection_not_modified, header);
-//            return;
-//          }
-//        }
-//      }
-//      else
-//        throw invalid_argument("could not read file");
-//    }
-#endif
+      // Files up to 8 MiB are served from memory, with ETag, If-None-Match
+      // and precompressed .br and .gz variants
+      SimpleWeb::error_code ec;
+      if(auto entry = file_cache.get(path.string(), ec)) {
+        SimpleWeb::FileCache::write(response, *entry, request->header, header);
+        return;
+      }
+      if(ec)
+        throw invalid_argument("could not read file");
 
       auto ifs = make_shared<ifstream>();
       ifs->open(path.string(), ifstream::in | ios::binary | ios::ate);
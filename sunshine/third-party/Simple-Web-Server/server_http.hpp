@@ -2,16 +2,33 @@
 #define SIMPLE_WEB_SERVER_HTTP_HPP
 
 #include "asio_compatibility.hpp"
+#include "http2.hpp"
 #include "mutex.hpp"
 #include "utility.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <cstdint>
+#include <deque>
 #include <functional>
 #include <iostream>
 #include <limits>
 #include <list>
 #include <map>
+#include <set>
 #include <sstream>
 #include <thread>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
 
 // Late 2017 TODO: remove the following checks and always use std::regex
 #ifdef USE_BOOST_REGEX
@@ -27,6 +44,167 @@ namespace SimpleWeb {
 #endif
 
 namespace SimpleWeb {
+#ifdef _WIN32
+  using native_file_handle = HANDLE;
+#else
+  using native_file_handle = int;
+#endif
+
+  /// Sends a range of a file by reading it in chunks and writing them to the socket.
+  /// This works with any socket type, including TLS streams.
+  template <class socket_type>
+  class ChunkedFileSender {
+    static std::size_t chunk_size() noexcept {
+      return 64 * 1024;
+    }
+
+  public:
+    /// Reads up to size bytes at offset, returning the number of bytes read.
+    static std::size_t read(native_file_handle file, std::uint64_t offset, char *data, std::size_t size, error_code &ec) noexcept {
+#ifdef _WIN32
+      OVERLAPPED overlapped = {};
+      overlapped.Offset = static_cast<DWORD>(offset & 0xFFFFFFFF);
+      overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+      DWORD bytes_read = 0;
+      if(!::ReadFile(file, data, static_cast<DWORD>(size), &bytes_read, &overlapped) && ::GetLastError() != ERROR_HANDLE_EOF) {
+        ec = error_code(static_cast<int>(::GetLastError()), asio::error::get_system_category());
+        return 0;
+      }
+      return bytes_read;
+#else
+      for(;;) {
+        auto bytes_read = ::pread(file, data, size, static_cast<off_t>(offset));
+        if(bytes_read >= 0)
+          return static_cast<std::size_t>(bytes_read);
+        if(errno != EINTR) {
+          ec = error_code(errno, asio::error::get_system_category());
+          return 0;
+        }
+      }
+#endif
+    }
+
+  private:
+    static void send_chunk(socket_type &socket, native_file_handle file, std::uint64_t offset, std::size_t length,
+                           const std::shared_ptr<std::vector<char>> &chunk, const std::function<void(const error_code &)> &handler) {
+      if(length == 0) {
+        handler(error_code());
+        return;
+      }
+
+      error_code ec;
+      auto size = read(file, offset, chunk->data(), (std::min)(length, chunk->size()), ec);
+      if(!ec && size == 0) // The file is shorter than the range
+        ec = make_error_code::make_error_code(errc::io_error);
+      if(ec) {
+        handler(ec);
+        return;
+      }
+
+      asio::async_write(socket, asio::buffer(chunk->data(), size), [&socket, file, offset, length, chunk, handler, size](const error_code &ec, std::size_t /*bytes_transferred*/) {
+        if(ec)
+          handler(ec);
+        else
+          send_chunk(socket, file, offset + size, length - size, chunk, handler);
+      });
+    }
+
+  public:
+    static void async_send(socket_type &socket, native_file_handle file, std::uint64_t offset, std::size_t length, const std::function<void(const error_code &)> &handler) {
+      auto chunk = std::make_shared<std::vector<char>>((std::min)(length, chunk_size()));
+      send_chunk(socket, file, offset, length, chunk, handler);
+    }
+  };
+
+  /// Sends a range of a file to a socket. The socket must be kept alive until the handler is called.
+  template <class socket_type>
+  class FileSender : public ChunkedFileSender<socket_type> {};
+
+#if defined(__linux__) || (defined(_WIN32) && (defined(ASIO_HAS_WINDOWS_OVERLAPPED_PTR) || defined(BOOST_ASIO_HAS_WINDOWS_OVERLAPPED_PTR)))
+  /// On plain TCP sockets, the kernel copies the file to the socket itself (sendfile() or TransmitFile()).
+  template <>
+  class FileSender<asio::ip::tcp::socket> {
+#ifdef __linux__
+    static std::size_t max_sendfile_size() noexcept {
+      return 0x7FFFF000;
+    }
+#else
+    static std::size_t max_transmit_file_size() noexcept {
+      return 0x7FFFFFFE;
+    }
+#endif
+
+  public:
+    static void async_send(asio::ip::tcp::socket &socket, native_file_handle file, std::uint64_t offset, std::size_t length, const std::function<void(const error_code &)> &handler) {
+#ifdef __linux__
+      error_code ec;
+      if(!socket.native_non_blocking())
+        socket.native_non_blocking(true, ec);
+      if(ec) {
+        ChunkedFileSender<asio::ip::tcp::socket>::async_send(socket, file, offset, length, handler);
+        return;
+      }
+
+      while(length > 0) {
+        auto file_offset = static_cast<off_t>(offset);
+        auto bytes_sent = ::sendfile(socket.native_handle(), file, &file_offset, (std::min)(length, max_sendfile_size()));
+        if(bytes_sent > 0) {
+          offset += static_cast<std::uint64_t>(bytes_sent);
+          length -= static_cast<std::size_t>(bytes_sent);
+        }
+        else if(bytes_sent == 0) { // The file is shorter than the range
+          handler(make_error_code::make_error_code(errc::io_error));
+          return;
+        }
+        else if(errno == EAGAIN || errno == EWOULDBLOCK) {
+          async_wait_writable(socket, [&socket, file, offset, length, handler](const error_code &ec) {
+            if(ec)
+              handler(ec);
+            else
+              async_send(socket, file, offset, length, handler);
+          });
+          return;
+        }
+        else if(errno == EINVAL || errno == ENOSYS) {
+          // The file doesn't support sendfile(), so continue from where it stopped
+          ChunkedFileSender<asio::ip::tcp::socket>::async_send(socket, file, offset, length, handler);
+          return;
+        }
+        else if(errno != EINTR) {
+          handler(error_code(errno, asio::error::get_system_category()));
+          return;
+        }
+      }
+      handler(error_code());
+#else
+      if(length == 0) {
+        handler(error_code());
+        return;
+      }
+
+      auto size = (std::min)(length, max_transmit_file_size());
+      asio::windows::overlapped_ptr overlapped(get_executor(socket), [&socket, file, offset, length, handler](const error_code &ec, std::size_t bytes_transferred) {
+        if(!ec && bytes_transferred == 0) // The file is shorter than the range
+          handler(make_error_code::make_error_code(errc::io_error));
+        else if(ec)
+          handler(ec);
+        else
+          async_send(socket, file, offset + bytes_transferred, length - bytes_transferred, handler);
+      });
+      overlapped.get()->Offset = static_cast<DWORD>(offset & 0xFFFFFFFF);
+      overlapped.get()->OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+      auto ok = ::TransmitFile(socket.native_handle(), file, static_cast<DWORD>(size), 0, overlapped.get(), nullptr, 0);
+      auto last_error = ::GetLastError();
+      if(!ok && last_error != ERROR_IO_PENDING)
+        overlapped.complete(error_code(static_cast<int>(last_error), asio::error::get_system_category()), 0);
+      else
+        overlapped.release();
+#endif
+    }
+  };
+#endif
+
   template <class socket_type>
   class Server;
 
@@ -35,6 +213,7 @@ namespace SimpleWeb {
   protected:
     class Connection;
     class Session;
+    class Http2Connection;
 
   public:
     /// Response class where the content of the response is sent to client when the object is about to be destroyed.
@@ -47,18 +226,37 @@ namespace SimpleWeb {
       std::shared_ptr<Session> session;
       long timeout_content;
 
+      /// Content that is sent in order: the stream buffer, then the buffers, then the file range.
+      class Part {
+      public:
+        std::shared_ptr<asio::streambuf> streambuf;
+        std::vector<asio::const_buffer> buffers;
+        /// Keeps the memory referenced by buffers, or the file, alive until the part has been sent.
+        std::shared_ptr<const void> owner;
+        native_file_handle file;
+        bool has_file = false;
+        std::uint64_t file_offset = 0;
+        std::size_t file_length = 0;
+      };
+
+      /// Parts added by write_buffers() and write_file() that precede the current stream buffer.
+      std::vector<Part> parts;
+
       Mutex send_queue_mutex;
-      std::list<std::pair<std::shared_ptr<asio::streambuf>, std::function<void(const error_code &)>>> send_queue GUARDED_BY(send_queue_mutex);
+      std::list<std::pair<std::shared_ptr<std::vector<Part>>, std::function<void(const error_code &)>>> send_queue GUARDED_BY(send_queue_mutex);
 
       Response(std::shared_ptr<Session> session_, long timeout_content) noexcept : std::ostream(nullptr), session(std::move(session_)), timeout_content(timeout_content) {
         rdbuf(streambuf.get());
       }
 
-      template <typename size_type>
-      void write_header(const CaseInsensitiveMultimap &header, size_type size) {
+      /// Writes the status line and header fields, adding Content-Length when needed.
+      /// The size is computed first, and everything is copied into the stream buffer at once instead of being formatted through std::ostream.
+      void write_header(StatusCode status_code, const CaseInsensitiveMultimap &header, unsigned long long size) {
+        auto &status_line = SimpleWeb::status_line(status_code);
         bool content_length_written = false;
         bool chunked_transfer_encoding = false;
         bool event_stream = false;
+        std::size_t header_size = status_line.size() + 2;
         for(auto &field : header) {
           if(!content_length_written && case_insensitive_equal(field.first, "content-length"))
             content_length_written = true;
@@ -66,26 +264,113 @@ namespace SimpleWeb {
             chunked_transfer_encoding = true;
           else if(!event_stream && case_insensitive_equal(field.first, "content-type") && case_insensitive_equal(field.second, "text/event-stream"))
             event_stream = true;
+          header_size += field.first.size() + 2 + field.second.size() + 2;
+        }
 
-          *this << field.first << ": " << field.second << "\r\n";
+        static const char content_length_name[] = "Content-Length: ";
+        char size_digits[20];
+        std::size_t size_digits_count = 0;
+        bool write_content_length = !content_length_written && !chunked_transfer_encoding && !event_stream && !close_connection_after_response;
+        if(write_content_length) {
+          do {
+            size_digits[sizeof(size_digits) - ++size_digits_count] = static_cast<char>('0' + size % 10);
+            size /= 10;
+          } while(size > 0);
+          header_size += sizeof(content_length_name) - 1 + size_digits_count + 2;
         }
-        if(!content_length_written && !chunked_transfer_encoding && !event_stream && !close_connection_after_response)
-          *this << "Content-Length: " << size << "\r\n\r\n";
-        else
-          *this << "\r\n";
+
+        auto data = buffer_data(streambuf->prepare(header_size));
+        auto append = [&data](const char *source, std::size_t source_size) {
+          std::memcpy(data, source, source_size);
+          data += source_size;
+        };
+        append(status_line.data(), status_line.size());
+        for(auto &field : header) {
+          append(field.first.data(), field.first.size());
+          append(": ", 2);
+          append(field.second.data(), field.second.size());
+          append("\r\n", 2);
+        }
+        if(write_content_length) {
+          append(content_length_name, sizeof(content_length_name) - 1);
+          append(size_digits + sizeof(size_digits) - size_digits_count, size_digits_count);
+          append("\r\n", 2);
+        }
+        append("\r\n", 2);
+        streambuf->commit(header_size);
       }
 
-      void send_from_queue() REQUIRES(send_queue_mutex) {
-        auto buffer = send_queue.begin()->first->data();
-        auto self = this->shared_from_this();
-        post(session->connection->write_strand, [self, buffer] {
+      /// Ends the current part with the content of the stream buffer, and starts a new part.
+      Part &add_part() {
+        parts.emplace_back();
+        parts.back().streambuf = std::move(streambuf);
+        streambuf = std::unique_ptr<asio::streambuf>(new asio::streambuf());
+        rdbuf(streambuf.get());
+        return parts.back();
+      }
+
+      std::shared_ptr<std::vector<Part>> take_parts() {
+        add_part();
+        auto taken = std::make_shared<std::vector<Part>>(std::move(parts));
+        parts.clear();
+        return taken;
+      }
+
+      /// Writes the parts starting at index, and calls callback when all have been written or on error.
+      static void write_parts(const std::shared_ptr<Response> &self, const std::shared_ptr<std::vector<Part>> &parts, std::size_t index, const std::function<void(const error_code &)> &callback) {
+        auto lock = self->session->connection->handler_runner->continue_lock();
+        if(!lock)
+          return;
+
+        if(index == parts->size()) {
+          if(callback)
+            callback(error_code());
+          return;
+        }
+
+        auto &part = (*parts)[index];
+        std::vector<asio::const_buffer> buffers;
+        buffers.reserve(part.buffers.size() + 1);
+        if(part.streambuf->size() > 0)
+          buffers.emplace_back(part.streambuf->data());
+        buffers.insert(buffers.end(), part.buffers.begin(), part.buffers.end());
+
+        // Scatter/gather write of the stream buffer and the buffers in one go
+        asio::async_write(*self->session->connection->socket, buffers, [self, parts, index, callback](const error_code &ec, std::size_t /*bytes_transferred*/) {
           auto lock = self->session->connection->handler_runner->continue_lock();
           if(!lock)
             return;
-          asio::async_write(*self->session->connection->socket, buffer, [self](const error_code &ec, std::size_t /*bytes_transferred*/) {
+          if(ec) {
+            if(callback)
+              callback(ec);
+            return;
+          }
+
+          auto &part = (*parts)[index];
+          if(!part.has_file || part.file_length == 0) {
+            write_parts(self, parts, index + 1, callback);
+            return;
+          }
+
+          FileSender<socket_type>::async_send(*self->session->connection->socket, part.file, part.file_offset, part.file_length, [self, parts, index, callback](const error_code &ec) {
             auto lock = self->session->connection->handler_runner->continue_lock();
             if(!lock)
               return;
+            if(ec) {
+              if(callback)
+                callback(ec);
+              return;
+            }
+            write_parts(self, parts, index + 1, callback);
+          });
+        });
+      }
+
+      void send_from_queue() REQUIRES(send_queue_mutex) {
+        auto parts = send_queue.begin()->first;
+        auto self = this->shared_from_this();
+        post(session->connection->write_strand, [self, parts] {
+          write_parts(self, parts, 0, [self](const error_code &ec) {
             {
               LockGuard lock(self->send_queue_mutex);
               if(!ec) {
@@ -118,19 +403,14 @@ namespace SimpleWeb {
       }
 
       void send_on_delete(const std::function<void(const error_code &)> &callback = nullptr) noexcept {
-        auto buffer = streambuf->data();
-        auto self = this->shared_from_this(); // Keep Response instance alive through the following async_write
-        post(session->connection->write_strand, [self, buffer, callback] {
-          auto lock = self->session->connection->handler_runner->continue_lock();
-          if(!lock)
-            return;
-          asio::async_write(*self->session->connection->socket, buffer, [self, callback](const error_code &ec, std::size_t /*bytes_transferred*/) {
-            auto lock = self->session->connection->handler_runner->continue_lock();
-            if(!lock)
-              return;
-            if(callback)
-              callback(ec);
-          });
+        auto parts = take_parts();
+        if(session->http2) {
+          session->http2->send(session->stream_id, parts, true, callback);
+          return;
+        }
+        auto self = this->shared_from_this(); // Keep Response instance alive through the following writes
+        post(session->connection->write_strand, [self, parts, callback] {
+          write_parts(self, parts, 0, callback);
         });
       }
 
@@ -143,12 +423,14 @@ namespace SimpleWeb {
       ///
       /// Use this function if you need to recursively send parts of a longer message, or when using server-sent events.
       void send(std::function<void(const error_code &)> callback = nullptr) noexcept {
-        std::shared_ptr<asio::streambuf> streambuf = std::move(this->streambuf);
-        this->streambuf = std::unique_ptr<asio::streambuf>(new asio::streambuf());
-        rdbuf(this->streambuf.get());
+        auto parts = take_parts();
+        if(session->http2) {
+          session->http2->send(session->stream_id, parts, false, callback);
+          return;
+        }
 
         LockGuard lock(send_queue_mutex);
-        send_queue.emplace_back(std::move(streambuf), std::move(callback));
+        send_queue.emplace_back(std::move(parts), std::move(callback));
         if(send_queue.size() == 1)
           send_from_queue();
       }
@@ -160,29 +442,65 @@ namespace SimpleWeb {
 
       /// Convenience function for writing status line, potential header fields, and empty content.
       void write(StatusCode status_code = StatusCode::success_ok, const CaseInsensitiveMultimap &header = CaseInsensitiveMultimap()) {
-        *this << "HTTP/1.1 " << SimpleWeb::status_code(status_code) << "\r\n";
-        write_header(header, 0);
+        write_header(status_code, header, 0);
       }
 
       /// Convenience function for writing status line, header fields, and content.
       void write(StatusCode status_code, string_view content, const CaseInsensitiveMultimap &header = CaseInsensitiveMultimap()) {
-        *this << "HTTP/1.1 " << SimpleWeb::status_code(status_code) << "\r\n";
-        write_header(header, content.size());
+        write_header(status_code, header, content.size());
         if(!content.empty())
           *this << content;
       }
 
       /// Convenience function for writing status line, header fields, and content.
       void write(StatusCode status_code, std::istream &content, const CaseInsensitiveMultimap &header = CaseInsensitiveMultimap()) {
-        *this << "HTTP/1.1 " << SimpleWeb::status_code(status_code) << "\r\n";
         content.seekg(0, std::ios::end);
         auto size = content.tellg();
         content.seekg(0, std::ios::beg);
-        write_header(header, size);
+        write_header(status_code, header, static_cast<unsigned long long>(static_cast<std::streamoff>(size)));
         if(size)
           *this << content.rdbuf();
       }
 
+      /// Queue buffers to be sent after what has been written to the response stream so far, without copying them.
+      /// The buffers must stay valid until the response has been sent, for instance by passing their owner.
+      void write_buffers(std::vector<asio::const_buffer> buffers, std::shared_ptr<const void> owner = nullptr) {
+        auto &part = add_part();
+        part.buffers = std::move(buffers);
+        part.owner = std::move(owner);
+      }
+
+      /// Queue length bytes of file, starting at offset, to be sent after what has been written to the response stream so far.
+      /// On plain HTTP the kernel sends the file directly (sendfile() or TransmitFile()), otherwise it is sent in chunks.
+      /// The file must stay open until the response has been sent, for instance by passing an owner that closes it.
+      void write_file(native_file_handle file, std::uint64_t offset, std::size_t length, std::shared_ptr<const void> owner = nullptr) {
+        auto &part = add_part();
+        part.file = file;
+        part.has_file = true;
+        part.file_offset = offset;
+        part.file_length = length;
+        part.owner = std::move(owner);
+      }
+
+      /// Convenience function for writing status line, header fields, and content without copying the content.
+      void write(StatusCode status_code, std::shared_ptr<const std::string> content, const CaseInsensitiveMultimap &header = CaseInsensitiveMultimap()) {
+        write_header(status_code, header, content->size());
+        if(!content->empty())
+          write_buffers({asio::buffer(*content)}, content);
+      }
+
+      /// Convenience function for writing status line, header fields, and content without copying the content.
+      void write(StatusCode status_code, std::vector<asio::const_buffer> buffers, std::shared_ptr<const void> owner, const CaseInsensitiveMultimap &header = CaseInsensitiveMultimap()) {
+        write_header(status_code, header, asio::buffer_size(buffers));
+        write_buffers(std::move(buffers), std::move(owner));
+      }
+
+      /// Convenience function for writing status line, header fields, and a range of a file as content.
+      void write_file(StatusCode status_code, native_file_handle file, std::uint64_t offset, std::size_t length, std::shared_ptr<const void> owner = nullptr, const CaseInsensitiveMultimap &header = CaseInsensitiveMultimap()) {
+        write_header(status_code, header, length);
+        write_file(file, offset, length, std::move(owner));
+      }
+
       /// Convenience function for writing success status line, header fields, and content.
       void write(string_view content, const CaseInsensitiveMultimap &header = CaseInsensitiveMultimap()) {
         write(StatusCode::success_ok, content, header);
@@ -232,133 +550,1308 @@ namespace SimpleWeb {
       std::weak_ptr<Connection> connection;
       std::string optimization = std::to_string(0); // TODO: figure out what goes wrong in gcc optimization without this line
 
+      /// Reads the next part of the content for resources in stream_resource.
+      std::function<void(const std::function<void(const error_code &, std::size_t)> &)> content_reader;
+      /// True while content of a stream_resource request is left unread.
+      bool content_pending = false;
+      bool content_chunked = false;
+      /// Set after a chunk size line, since a chunk's data is followed by CRLF.
+      bool content_chunk_end = false;
+      bool content_last_chunk = false;
+      /// Bytes left of the Content-Length content, or of the current chunk.
+      unsigned long long content_remaining = 0;
+
       Request(std::size_t max_request_streambuf_size, const std::shared_ptr<Connection> &connection_) noexcept
           : streambuf(new asio::streambuf(max_request_streambuf_size)), content_streambuf(max_request_streambuf_size), connection(connection_), content(content_streambuf) {}
       Request(std::size_t max_request_streambuf_size, const std::shared_ptr<Connection> &connection_, std::unique_ptr<asio::streambuf> &&previous_streambuf) noexcept
           : streambuf(std::move(previous_streambuf)), content_streambuf(max_request_streambuf_size), connection(connection_), content(content_streambuf) {
       }
 
-    public:
-      std::string method, path, query_string, http_version;
+    public:
+      std::string method, path, query_string, http_version;
+
+      Content content;
+
+      CaseInsensitiveMultimap header;
+
+      /// The result of the resource regular expression match of the request path.
+      /// Left empty when the matched resource regex has no special characters, since it then equals path.
+      regex::smatch path_match;
+
+      /// The time point when the request header was fully read.
+      std::chrono::system_clock::time_point header_read_time;
+
+      asio::ip::tcp::endpoint remote_endpoint() const noexcept {
+        try {
+          if(auto connection = this->connection.lock())
+            return connection->socket->lowest_layer().remote_endpoint();
+        }
+        catch(...) {
+        }
+        return asio::ip::tcp::endpoint();
+      }
+
+      asio::ip::tcp::endpoint local_endpoint() const noexcept {
+        try {
+          if(auto connection = this->connection.lock())
+            return connection->socket->lowest_layer().local_endpoint();
+        }
+        catch(...) {
+        }
+        return asio::ip::tcp::endpoint();
+      }
+
+      /// Deprecated, please use remote_endpoint().address().to_string() instead.
+      SW_DEPRECATED std::string remote_endpoint_address() const noexcept {
+        try {
+          if(auto connection = this->connection.lock())
+            return connection->socket->lowest_layer().remote_endpoint().address().to_string();
+        }
+        catch(...) {
+        }
+        return std::string();
+      }
+
+      /// Deprecated, please use remote_endpoint().port() instead.
+      SW_DEPRECATED unsigned short remote_endpoint_port() const noexcept {
+        try {
+          if(auto connection = this->connection.lock())
+            return connection->socket->lowest_layer().remote_endpoint().port();
+        }
+        catch(...) {
+        }
+        return 0;
+      }
+
+      /// Returns query keys with percent-decoded values.
+      CaseInsensitiveMultimap parse_query_string() const noexcept {
+        return SimpleWeb::QueryString::parse(query_string);
+      }
+
+      /// For resources in stream_resource: reads the next part of the request content into content, replacing the previous part.
+      /// The callback is called with the size of the part, or with 0 when all the content has been read.
+      /// No more content is read from the connection until read_content() is called again.
+      /// For other requests, the content has already been read and the callback is called with 0.
+      void read_content(const std::function<void(const error_code &, std::size_t)> &callback) {
+        if(content_reader)
+          content_reader(callback);
+        else
+          callback(error_code(), 0);
+      }
+    };
+
+  protected:
+    class Connection;
+
+    /// Hashed timing wheel with a resolution of one second, that closes connections when their timeout expires.
+    /// One wheel and timer per io_context replaces a steady_timer per connection, and setting or cancelling a timeout is O(1).
+    class TimingWheel : public std::enable_shared_from_this<TimingWheel> {
+    public:
+      /// The timeout of a connection, linked into the slot of its expiry tick.
+      class Entry {
+        friend class TimingWheel;
+        Entry *previous = nullptr;
+        Entry *next = nullptr;
+        std::uint64_t expiry_tick = 0;
+        bool armed = false;
+
+      public:
+        std::weak_ptr<Connection> connection;
+      };
+
+      TimingWheel(io_context &context) noexcept : timer(context), start_time(std::chrono::steady_clock::now()) {}
+
+      /// Closes the connection of entry after at least the given number of seconds, replacing a previous timeout.
+      void set(Entry &entry, long seconds) noexcept {
+        LockGuard lock(mutex);
+        unlink(entry);
+        entry.expiry_tick = current_tick() + 1 + static_cast<std::uint64_t>(seconds);
+        auto &slot = slots[entry.expiry_tick % slots.size()];
+        entry.next = slot;
+        if(slot)
+          slot->previous = &entry;
+        slot = &entry;
+        entry.armed = true;
+        ++armed_count;
+        if(!running) {
+          running = true;
+          schedule();
+        }
+      }
+
+      void cancel(Entry &entry) noexcept {
+        LockGuard lock(mutex);
+        unlink(entry);
+      }
+
+      /// Cancels the timer, so that the io_context is not kept running while no timeouts are set.
+      void stop() noexcept {
+        LockGuard lock(mutex);
+        error_code ec;
+        timer.cancel(ec);
+        running = false;
+      }
+
+    private:
+      Mutex mutex;
+      asio::steady_timer timer GUARDED_BY(mutex);
+      std::chrono::steady_clock::time_point start_time;
+      std::vector<Entry *> slots GUARDED_BY(mutex) = std::vector<Entry *>(512, nullptr);
+      std::uint64_t processed_tick GUARDED_BY(mutex) = 0;
+      std::size_t armed_count GUARDED_BY(mutex) = 0;
+      bool running GUARDED_BY(mutex) = false;
+
+      std::uint64_t current_tick() const noexcept {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - start_time).count());
+      }
+
+      void unlink(Entry &entry) noexcept REQUIRES(mutex) {
+        if(!entry.armed)
+          return;
+        if(entry.previous)
+          entry.previous->next = entry.next;
+        else
+          slots[entry.expiry_tick % slots.size()] = entry.next;
+        if(entry.next)
+          entry.next->previous = entry.previous;
+        entry.previous = nullptr;
+        entry.next = nullptr;
+        entry.armed = false;
+        --armed_count;
+      }
+
+      /// Waits for the tick after the last processed one.
+      void schedule() noexcept REQUIRES(mutex) {
+        error_code ec;
+        timer.expires_at(start_time + std::chrono::seconds(processed_tick + 1), ec);
+        auto self = this->shared_from_this();
+        timer.async_wait([self](const error_code &ec) {
+          if(!ec)
+            self->expire();
+        });
+      }
+
+      void expire() noexcept {
+        std::vector<std::shared_ptr<Connection>> expired;
+        {
+          LockGuard lock(mutex);
+          auto tick = current_tick();
+          // Each slot needs to be visited at most once, even if the timer was delayed for longer than a round
+          auto last_tick = (std::min)(tick, processed_tick + slots.size());
+          for(auto t = processed_tick + 1; t <= last_tick; ++t) {
+            auto entry = slots[t % slots.size()];
+            while(entry) {
+              auto next = entry->next;
+              if(entry->expiry_tick <= tick) {
+                unlink(*entry);
+                if(auto connection = entry->connection.lock())
+                  expired.emplace_back(std::move(connection));
+              }
+              entry = next;
+            }
+          }
+          processed_tick = (std::max)(processed_tick, tick);
+          if(armed_count > 0)
+            schedule();
+          else
+            running = false;
+        }
+        // Closed outside of the lock, since closing may call handlers that set other timeouts
+        for(auto &connection : expired)
+          connection->close();
+      }
+    };
+
+    class Connection : public std::enable_shared_from_this<Connection> {
+    public:
+      template <typename... Args>
+      Connection(std::shared_ptr<ScopeRunner> handler_runner_, std::shared_ptr<TimingWheel> timing_wheel_, Args &&...args) noexcept
+          : handler_runner(std::move(handler_runner_)), socket(new socket_type(std::forward<Args>(args)...)), write_strand(get_executor(socket->lowest_layer())), timing_wheel(std::move(timing_wheel_)) {}
+
+      ~Connection() noexcept {
+        timing_wheel->cancel(timeout);
+      }
+
+      std::shared_ptr<ScopeRunner> handler_runner;
+
+      std::unique_ptr<socket_type> socket; // Socket must be unique_ptr since asio::ssl::stream<asio::ip::tcp::socket> is not movable
+
+      /**
+       * Needed for TLS communication where async_write could be called outside of the io_context runners.
+       * For more information see https://stackoverflow.com/a/12801042.
+       */
+      strand write_strand;
+
+      std::shared_ptr<TimingWheel> timing_wheel;
+      typename TimingWheel::Entry timeout;
+
+      void close() noexcept {
+        error_code ec;
+        socket->lowest_layer().shutdown(asio::ip::tcp::socket::shutdown_both, ec);
+        socket->lowest_layer().cancel(ec);
+      }
+
+      void set_timeout(long seconds) noexcept {
+        if(seconds == 0) {
+          timing_wheel->cancel(timeout);
+          return;
+        }
+
+        if(timeout.connection.expired())
+          timeout.connection = this->shared_from_this(); // Weak, to avoid keeping Connection instance alive longer than needed
+        timing_wheel->set(timeout, seconds);
+      }
+
+      void cancel_timeout() noexcept {
+        timing_wheel->cancel(timeout);
+      }
+    };
+
+    class Session {
+    public:
+      Session(std::size_t max_request_streambuf_size, std::shared_ptr<Connection> connection_) noexcept
+          : connection(std::move(connection_)), request(new Request(max_request_streambuf_size, connection)) {}
+      Session(std::size_t max_request_streambuf_size, std::shared_ptr<Connection> connection_, std::unique_ptr<asio::streambuf> &&previous_streambuf) noexcept
+          : connection(std::move(connection_)), request(new Request(max_request_streambuf_size, connection, std::move(previous_streambuf))) {}
+
+      std::shared_ptr<Connection> connection;
+      std::shared_ptr<Request> request;
+
+      /// Set for the streams of an HTTP/2 connection.
+      std::shared_ptr<Http2Connection> http2;
+      std::uint32_t stream_id = 0;
+    };
+
+    /// Serves the streams of an HTTP/2 connection (RFC 7540), each as a request with its own Session.
+    ///
+    /// Resources write their responses as for HTTP/1.1: the status line and header fields are sent in a HEADERS frame,
+    /// and the content that follows in DATA frames as the flow control windows of the client allow.
+    /// The responses of concurrent streams are interleaved, a frame at a time.
+    class Http2Connection : public std::enable_shared_from_this<Http2Connection> {
+      using Part = typename Response::Part;
+      using Field = Http2::Hpack::Field;
+      using ErrorCode = Http2::ErrorCode;
+      using Callbacks = std::vector<std::function<void(const error_code &)>>;
+
+      /// Advertised as the initial window size of the streams, and of the connection.
+      /// The windows are replenished as soon as content is received, since the request content is read in full anyway.
+      static std::int64_t receive_window_size() noexcept {
+        return 1 << 20;
+      }
+
+      /// Limit on the size of a header block of the client, including its CONTINUATION frames.
+      static std::size_t max_header_block_size() noexcept {
+        return 1 << 18;
+      }
+
+      /// A range of response content to be sent in DATA frames, or a callback to call when the content before it has been sent.
+      class Chunk {
+      public:
+        std::shared_ptr<const void> owner;
+        const char *data = nullptr;
+        std::size_t size = 0;
+        bool is_file = false;
+        native_file_handle file;
+        std::uint64_t file_offset = 0;
+        std::function<void(const error_code &)> callback;
+      };
+
+      /// State of decoding response content that a resource has written with chunked transfer encoding.
+      enum class ChunkedState { size,
+                                extension,
+                                data,
+                                data_end,
+                                trailer,
+                                done };
+
+      class Stream {
+      public:
+        std::shared_ptr<Session> session;
+        std::int64_t send_window;
+        /// Set when the client has ended the stream, and the request is complete.
+        bool remote_closed = false;
+        /// Set when END_STREAM has been sent.
+        bool local_closed = false;
+
+        /// The HTTP/1.1 status line and header fields written by the resource, until complete.
+        std::string response_header;
+        bool response_header_parsed = false;
+        std::vector<Field> response_fields;
+        bool headers_sent = false;
+
+        bool chunked = false;
+        ChunkedState chunked_state = ChunkedState::size;
+        std::uint64_t chunk_remaining = 0;
+        std::size_t trailer_line_size = 0;
+
+        std::deque<Chunk> chunks;
+        /// Set when the response is complete once the chunks have been sent.
+        bool end_pending = false;
+
+        Stream(std::shared_ptr<Session> session_, std::int64_t send_window) noexcept : session(std::move(session_)), send_window(send_window) {}
+
+        bool has_data() const noexcept {
+          for(auto &chunk : chunks) {
+            if(chunk.size > 0)
+              return true;
+          }
+          return false;
+        }
+      };
+
+      /// Frames that are written at once, referring to the response content instead of copying it.
+      class Batch {
+        class Piece {
+        public:
+          const char *data; // If nullptr, the piece is at offset in bytes
+          std::size_t offset;
+          std::size_t size;
+        };
+        std::vector<Piece> pieces;
+        /// Frame headers, and the payloads of frames other than DATA.
+        std::string bytes;
+
+        void add_bytes(std::size_t offset) {
+          auto size = bytes.size() - offset;
+          if(!pieces.empty() && !pieces.back().data && pieces.back().offset + pieces.back().size == offset)
+            pieces.back().size += size;
+          else
+            pieces.emplace_back(Piece{nullptr, offset, size});
+        }
+
+      public:
+        std::vector<std::shared_ptr<const void>> owners;
+        std::size_t size = 0;
+        /// Called with the result of the write.
+        Callbacks callbacks;
+        /// Callbacks of streams that failed, called with an error after the write.
+        Callbacks failed;
+
+        void append(const std::string &frames) {
+          auto offset = bytes.size();
+          bytes += frames;
+          add_bytes(offset);
+          size += frames.size();
+        }
+
+        void append(const Http2::FrameHeader &header) {
+          auto offset = bytes.size();
+          header.write(bytes);
+          add_bytes(offset);
+          size += Http2::frame_header_size();
+        }
+
+        void append(const char *data, std::size_t size, std::shared_ptr<const void> owner) {
+          pieces.emplace_back(Piece{data, 0, size});
+          owners.emplace_back(std::move(owner));
+          this->size += size;
+        }
+
+        bool empty() const noexcept {
+          return pieces.empty() && callbacks.empty() && failed.empty();
+        }
+
+        std::vector<asio::const_buffer> buffers() const {
+          std::vector<asio::const_buffer> buffers;
+          buffers.reserve(pieces.size());
+          for(auto &piece : pieces)
+            buffers.emplace_back(piece.data ? piece.data : bytes.data() + piece.offset, piece.size);
+          return buffers;
+        }
+      };
+
+      ServerBase *server;
+      std::shared_ptr<Connection> connection;
+      /// The request of the session that started HTTP/2, given to on_error on connection errors.
+      std::shared_ptr<Request> connection_request;
+
+      // Only used by the reads, which are not concurrent
+      std::vector<unsigned char> read_buffer;
+      std::size_t read_size = 0;
+      std::size_t preface_read;
+      bool settings_received = false;
+      Http2::Hpack::Decoder decoder;
+      std::string header_block;
+      std::uint32_t header_block_stream_id = 0;
+      bool header_block_end_stream = false;
+      bool continuation_expected = false;
+
+      Mutex mutex;
+      std::map<std::uint32_t, Stream> streams GUARDED_BY(mutex);
+      std::uint32_t last_stream_id GUARDED_BY(mutex) = 0;
+      Http2::Hpack::Encoder encoder GUARDED_BY(mutex);
+      std::int64_t send_window GUARDED_BY(mutex) = Http2::default_window_size();
+      std::int64_t initial_send_window GUARDED_BY(mutex) = Http2::default_window_size();
+      std::size_t max_send_frame_size GUARDED_BY(mutex) = Http2::default_max_frame_size();
+      /// Frames other than HEADERS and DATA, which are sent before them.
+      std::string control_frames GUARDED_BY(mutex);
+      bool writing GUARDED_BY(mutex) = false;
+      /// Set when GOAWAY has been queued, after which the connection is closed with closing_error once written.
+      bool closing GUARDED_BY(mutex) = false;
+      error_code closing_error GUARDED_BY(mutex);
+      bool closed GUARDED_BY(mutex) = false;
+
+      static void call(const Callbacks &callbacks, const error_code &ec) {
+        for(auto &callback : callbacks)
+          callback(ec);
+      }
+
+      static error_code canceled() noexcept {
+        return make_error_code::make_error_code(errc::operation_canceled);
+      }
+
+    public:
+      Http2Connection(ServerBase *server, std::shared_ptr<Connection> connection_, std::shared_ptr<Request> connection_request_, std::size_t preface_read) noexcept
+          : server(server), connection(std::move(connection_)), connection_request(std::move(connection_request_)), preface_read(preface_read) {}
+
+      /// Sends the server preface, and processes data, which has been read after the part of the client preface, before reading more.
+      void start(const char *data, std::size_t size) {
+        read_buffer.resize((std::max)(2 * (Http2::frame_header_size() + Http2::default_max_frame_size()), size));
+        std::memcpy(read_buffer.data(), data, size);
+        read_size = size;
+
+        {
+          LockGuard lock(mutex);
+          Http2::append_settings(control_frames, {{Http2::Setting::max_concurrent_streams, server->config.http2_max_concurrent_streams},
+                                                  {Http2::Setting::initial_window_size, static_cast<std::uint32_t>(receive_window_size())}});
+          Http2::append_frame(control_frames, Http2::FrameType::window_update, 0, static_cast<std::uint32_t>(receive_window_size() - Http2::default_window_size()));
+          flush();
+        }
+
+        if(process())
+          read();
+      }
+
+      /// Queues the parts written to the response of a stream, where last is set when the response is complete.
+      /// The callback is called when the parts have been sent, or if the stream has been closed.
+      void send(std::uint32_t stream_id, const std::shared_ptr<std::vector<Part>> &parts, bool last, const std::function<void(const error_code &)> &callback) {
+        Callbacks canceled;
+        {
+          LockGuard lock(mutex);
+          auto it = streams.find(stream_id);
+          if(closed || closing || it == streams.end() || it->second.end_pending) {
+            if(callback)
+              canceled.emplace_back(callback);
+          }
+          else {
+            auto &stream = it->second;
+            bool valid = true;
+            for(auto &part : *parts) {
+              if(valid && part.streambuf->size() > 0) {
+                Chunk chunk;
+                chunk.owner = part.streambuf;
+                chunk.data = buffer_data(part.streambuf->data());
+                chunk.size = part.streambuf->size();
+                valid = add_content(stream, std::move(chunk));
+              }
+              for(auto &buffer : part.buffers) {
+                if(!valid)
+                  break;
+                Chunk chunk;
+                chunk.owner = part.owner;
+                chunk.data = buffer_data(buffer);
+                chunk.size = asio::buffer_size(buffer);
+                valid = add_content(stream, std::move(chunk));
+              }
+              if(valid && part.has_file) {
+                Chunk chunk;
+                chunk.owner = part.owner;
+                chunk.is_file = true;
+                chunk.file = part.file;
+                chunk.file_offset = part.file_offset;
+                chunk.size = part.file_length;
+                valid = add_content(stream, std::move(chunk));
+              }
+            }
+            // A response that ends without a status line is reset, since it cannot be sent
+            if(!valid || (last && !stream.response_header_parsed)) {
+              if(callback)
+                canceled.emplace_back(callback);
+              reset_stream(it, ErrorCode::internal_error, canceled);
+            }
+            else {
+              if(callback) {
+                Chunk chunk;
+                chunk.callback = callback;
+                stream.chunks.emplace_back(std::move(chunk));
+              }
+              stream.end_pending = last;
+            }
+            flush();
+          }
+        }
+        call(canceled, Http2Connection::canceled());
+      }
+
+    private:
+      void read() {
+        {
+          LockGuard lock(mutex);
+          if(closing || closed)
+            return;
+          connection->set_timeout(streams.empty() ? server->config.timeout_request : server->config.timeout_content);
+        }
+
+        auto self = this->shared_from_this();
+        connection->socket->async_read_some(asio::buffer(read_buffer.data() + read_size, read_buffer.size() - read_size), [self](const error_code &ec, std::size_t bytes_transferred) {
+          auto lock = self->connection->handler_runner->continue_lock();
+          if(!lock)
+            return;
+          if(ec) {
+            self->close(ec);
+            return;
+          }
+          self->read_size += bytes_transferred;
+          if(self->process())
+            self->read();
+        });
+      }
+
+      /// Handles the complete frames that have been read. Returns false if the connection is closing.
+      bool process() {
+        std::size_t offset = 0;
+        auto &preface = Http2::client_preface();
+        if(preface_read < preface.size()) {
+          offset = (std::min)(preface.size() - preface_read, read_size);
+          if(std::memcmp(read_buffer.data(), preface.data() + preface_read, offset) != 0) {
+            close(make_error_code::make_error_code(errc::protocol_error));
+            return false;
+          }
+          preface_read += offset;
+        }
+
+        while(read_size - offset >= Http2::frame_header_size()) {
+          auto header = Http2::FrameHeader::parse(read_buffer.data() + offset);
+          if(header.length > Http2::default_max_frame_size())
+            return connection_error(ErrorCode::frame_size_error);
+          if(read_size - offset - Http2::frame_header_size() < header.length)
+            break;
+          if(!handle_frame(header, read_buffer.data() + offset + Http2::frame_header_size()))
+            return false;
+          offset += Http2::frame_header_size() + header.length;
+        }
+
+        std::memmove(read_buffer.data(), read_buffer.data() + offset, read_size - offset);
+        read_size -= offset;
+        return true;
+      }
+
+      bool handle_frame(const Http2::FrameHeader &header, const unsigned char *payload) {
+        using FrameType = Http2::FrameType;
+        if(continuation_expected && (header.type != FrameType::continuation || header.stream_id != header_block_stream_id))
+          return connection_error(ErrorCode::protocol_error);
+        if(!settings_received && header.type != FrameType::settings)
+          return connection_error(ErrorCode::protocol_error);
+
+        switch(header.type) {
+        case FrameType::data:
+          return handle_data(header, payload);
+        case FrameType::headers:
+          return handle_headers(header, payload);
+        case FrameType::continuation:
+          if(!continuation_expected)
+            return connection_error(ErrorCode::protocol_error);
+          header_block.append(reinterpret_cast<const char *>(payload), header.length);
+          if(header_block.size() > max_header_block_size())
+            return connection_error(ErrorCode::enhance_your_calm);
+          if(header.flags & Http2::end_headers) {
+            continuation_expected = false;
+            return handle_header_block();
+          }
+          return true;
+        case FrameType::priority:
+          if(header.stream_id == 0)
+            return connection_error(ErrorCode::protocol_error);
+          if(header.length != 5)
+            stream_error(header.stream_id, ErrorCode::frame_size_error);
+          return true;
+        case FrameType::rst_stream:
+          return handle_rst_stream(header, payload);
+        case FrameType::settings:
+          return handle_settings(header, payload);
+        case FrameType::push_promise:
+          return connection_error(ErrorCode::protocol_error);
+        case FrameType::ping:
+          if(header.stream_id != 0)
+            return connection_error(ErrorCode::protocol_error);
+          if(header.length != 8)
+            return connection_error(ErrorCode::frame_size_error);
+          if(!(header.flags & Http2::ack)) {
+            LockGuard lock(mutex);
+            Http2::FrameHeader(8, FrameType::ping, Http2::ack, 0).write(control_frames);
+            control_frames.append(reinterpret_cast<const char *>(payload), 8);
+            flush();
+          }
+          return true;
+        case FrameType::goaway:
+          // The client closes the connection once its streams are done
+          if(header.stream_id != 0)
+            return connection_error(ErrorCode::protocol_error);
+          return true;
+        case FrameType::window_update:
+          return handle_window_update(header, payload);
+        }
+        return true; // Unknown frame types are ignored
+      }
+
+      /// Removes the padding, and the priority fields of HEADERS, from the payload.
+      bool frame_content(const Http2::FrameHeader &header, const unsigned char *&payload, std::size_t &size) {
+        size = header.length;
+        if(header.flags & Http2::padded) {
+          if(size < 1 || payload[0] > size - 1)
+            return false;
+          size -= 1 + payload[0];
+          ++payload;
+        }
+        if(header.type == Http2::FrameType::headers && (header.flags & Http2::priority)) {
+          if(size < 5)
+            return false;
+          size -= 5;
+          payload += 5;
+        }
+        return true;
+      }
+
+      bool handle_headers(const Http2::FrameHeader &header, const unsigned char *payload) {
+        std::size_t size;
+        if(header.stream_id == 0 || header.stream_id % 2 == 0 || !frame_content(header, payload, size))
+          return connection_error(ErrorCode::protocol_error);
+        header_block.assign(reinterpret_cast<const char *>(payload), size);
+        header_block_stream_id = header.stream_id;
+        header_block_end_stream = (header.flags & Http2::end_stream) != 0;
+        if(header.flags & Http2::end_headers)
+          return handle_header_block();
+        continuation_expected = true;
+        return true;
+      }
+
+      bool handle_header_block() {
+        std::vector<Field> fields;
+        try {
+          if(!decoder.decode(reinterpret_cast<const unsigned char *>(header_block.data()), header_block.size(), fields))
+            return connection_error(ErrorCode::compression_error);
+        }
+        catch(...) {
+          return connection_error(ErrorCode::internal_error);
+        }
+        header_block.clear();
+
+        auto stream_id = header_block_stream_id;
+        std::shared_ptr<Session> session;
+        Callbacks canceled;
+        {
+          LockGuard lock(mutex);
+          if(stream_id <= last_stream_id) {
+            auto it = streams.find(stream_id);
+            if(it == streams.end()) // Closed stream
+              return true;
+            if(it->second.remote_closed || !header_block_end_stream)
+              reset_stream(it, ErrorCode::protocol_error, canceled);
+            else { // Trailer fields, which are ignored
+              it->second.remote_closed = true;
+              session = it->second.session;
+            }
+          }
+          else {
+            last_stream_id = stream_id;
+            if(closing)
+              return true;
+            if(streams.size() >= server->config.http2_max_concurrent_streams)
+              Http2::append_frame(control_frames, Http2::FrameType::rst_stream, stream_id, static_cast<std::uint32_t>(ErrorCode::refused_stream));
+            else if(auto new_session = create_session(stream_id, fields)) {
+              auto &stream = streams.emplace(std::piecewise_construct, std::forward_as_tuple(stream_id), std::forward_as_tuple(new_session, initial_send_window)).first->second;
+              if(header_block_end_stream) {
+                stream.remote_closed = true;
+                session = std::move(new_session);
+              }
+            }
+            else
+              Http2::append_frame(control_frames, Http2::FrameType::rst_stream, stream_id, static_cast<std::uint32_t>(ErrorCode::protocol_error));
+          }
+          flush();
+        }
+        call(canceled, Http2Connection::canceled());
+
+        if(session)
+          dispatch(session);
+        return true;
+      }
+
+      /// Returns a session with the request of the header fields, or nullptr if they are not a valid request.
+      std::shared_ptr<Session> create_session(std::uint32_t stream_id, const std::vector<Field> &fields) {
+        auto session = std::make_shared<Session>(server->config.max_request_streambuf_size, connection);
+        session->http2 = this->shared_from_this();
+        session->stream_id = stream_id;
+        auto &request = *session->request;
+        request.http_version = "2.0";
+        request.header_read_time = std::chrono::system_clock::now();
+
+        std::string path, authority, cookie;
+        bool regular_field = false;
+        for(auto &field : fields) {
+          if(!field.first.empty() && field.first[0] == ':') {
+            if(regular_field) // Pseudo-header fields must come first
+              return nullptr;
+            if(field.first == ":method")
+              request.method = field.second;
+            else if(field.first == ":path")
+              path = field.second;
+            else if(field.first == ":authority")
+              authority = field.second;
+            else if(field.first != ":scheme")
+              return nullptr;
+          }
+          else {
+            regular_field = true;
+            // Cookies may be split into several fields, that are joined again for the resources
+            if(field.first == "cookie")
+              cookie += (cookie.empty() ? "" : "; ") + field.second;
+            else
+              request.header.emplace(field.first, field.second);
+          }
+        }
+        if(request.method.empty() || path.empty())
+          return nullptr;
+
+        auto query_start = path.find('?');
+        if(query_start != std::string::npos) {
+          request.query_string = path.substr(query_start + 1);
+          path.resize(query_start);
+        }
+        request.path = std::move(path);
+        if(!cookie.empty())
+          request.header.emplace("cookie", std::move(cookie));
+        if(!authority.empty() && request.header.find("host") == request.header.end())
+          request.header.emplace("host", std::move(authority));
+        return session;
+      }
+
+      bool handle_data(const Http2::FrameHeader &header, const unsigned char *payload) {
+        std::size_t size;
+        if(header.stream_id == 0 || !frame_content(header, payload, size))
+          return connection_error(ErrorCode::protocol_error);
+
+        std::shared_ptr<Session> session, too_large_session;
+        Callbacks canceled;
+        {
+          LockGuard lock(mutex);
+          if(header.stream_id > last_stream_id) { // Idle stream
+            goaway(ErrorCode::protocol_error);
+            return false;
+          }
+          if(header.length > 0)
+            Http2::append_frame(control_frames, Http2::FrameType::window_update, 0, header.length);
+
+          auto it = streams.find(header.stream_id);
+          if(it != streams.end()) {
+            auto &stream = it->second;
+            auto &content = stream.session->request->content_streambuf;
+            if(stream.remote_closed)
+              reset_stream(it, ErrorCode::stream_closed, canceled);
+            else if(size > content.max_size() - content.size()) {
+              too_large_session = stream.session;
+              reset_stream(it, ErrorCode::cancel, canceled);
+            }
+            else {
+              content.commit(asio::buffer_copy(content.prepare(size), asio::buffer(payload, size)));
+              if(header.flags & Http2::end_stream) {
+                stream.remote_closed = true;
+                session = stream.session;
+              }
+              else if(header.length > 0)
+                Http2::append_frame(control_frames, Http2::FrameType::window_update, header.stream_id, header.length);
+            }
+          }
+          flush();
+        }
+        call(canceled, Http2Connection::canceled());
+
+        if(too_large_session && server->on_error)
+          server->on_error(too_large_session->request, make_error_code::make_error_code(errc::message_size));
+        if(session)
+          dispatch(session);
+        return true;
+      }
+
+      bool handle_rst_stream(const Http2::FrameHeader &header, const unsigned char * /*payload*/) {
+        if(header.stream_id == 0)
+          return connection_error(ErrorCode::protocol_error);
+        if(header.length != 4)
+          return connection_error(ErrorCode::frame_size_error);
+
+        Callbacks canceled;
+        {
+          LockGuard lock(mutex);
+          if(header.stream_id > last_stream_id) {
+            goaway(ErrorCode::protocol_error);
+            return false;
+          }
+          auto it = streams.find(header.stream_id);
+          if(it != streams.end())
+            erase_stream(it, canceled);
+        }
+        call(canceled, Http2Connection::canceled());
+        return true;
+      }
+
+      bool handle_settings(const Http2::FrameHeader &header, const unsigned char *payload) {
+        if(header.stream_id != 0)
+          return connection_error(ErrorCode::protocol_error);
+        if(header.flags & Http2::ack)
+          return header.length == 0 || connection_error(ErrorCode::frame_size_error);
+        if(header.length % 6 != 0)
+          return connection_error(ErrorCode::frame_size_error);
+
+        LockGuard lock(mutex);
+        for(std::size_t c = 0; c < header.length; c += 6) {
+          auto setting = static_cast<Http2::Setting>((payload[c] << 8) | payload[c + 1]);
+          auto value = Http2::read_uint32(payload + c + 2);
+          switch(setting) {
+          case Http2::Setting::header_table_size:
+            encoder.set_max_table_size((std::min)(static_cast<std::size_t>(value), Http2::Hpack::default_table_size()));
+            break;
+          case Http2::Setting::enable_push:
+            if(value > 1) {
+              goaway(ErrorCode::protocol_error);
+              return false;
+            }
+            break;
+          case Http2::Setting::initial_window_size: {
+            if(value > Http2::max_window_size()) {
+              goaway(ErrorCode::flow_control_error);
+              return false;
+            }
+            auto delta = static_cast<std::int64_t>(value) - initial_send_window;
+            for(auto &stream : streams) {
+              stream.second.send_window += delta;
+              if(stream.second.send_window > Http2::max_window_size()) {
+                goaway(ErrorCode::flow_control_error);
+                return false;
+              }
+            }
+            initial_send_window = value;
+            break;
+          }
+          case Http2::Setting::max_frame_size:
+            if(value < Http2::default_max_frame_size() || value > 0xFFFFFF) {
+              goaway(ErrorCode::protocol_error);
+              return false;
+            }
+            max_send_frame_size = value;
+            break;
+          default:
+            break;
+          }
+        }
+        Http2::FrameHeader(0, Http2::FrameType::settings, Http2::ack, 0).write(control_frames);
+        settings_received = true;
+        flush();
+        return true;
+      }
+
+      bool handle_window_update(const Http2::FrameHeader &header, const unsigned char *payload) {
+        if(header.length != 4)
+          return connection_error(ErrorCode::frame_size_error);
+        auto increment = Http2::read_uint32(payload) & 0x7FFFFFFF;
 
-      Content content;
+        Callbacks canceled;
+        {
+          LockGuard lock(mutex);
+          if(header.stream_id == 0) {
+            if(increment == 0 || send_window + increment > Http2::max_window_size()) {
+              goaway(increment == 0 ? ErrorCode::protocol_error : ErrorCode::flow_control_error);
+              return false;
+            }
+            send_window += increment;
+          }
+          else {
+            auto it = streams.find(header.stream_id);
+            if(it != streams.end()) {
+              if(increment == 0)
+                reset_stream(it, ErrorCode::protocol_error, canceled);
+              else if(it->second.send_window + increment > Http2::max_window_size())
+                reset_stream(it, ErrorCode::flow_control_error, canceled);
+              else
+                it->second.send_window += increment;
+            }
+          }
+          flush();
+        }
+        call(canceled, Http2Connection::canceled());
+        return true;
+      }
 
-      CaseInsensitiveMultimap header;
+      /// Finds the resource of a complete request, and calls it like find_resource() does for HTTP/1.
+      void dispatch(const std::shared_ptr<Session> &session) {
+        auto &request = *session->request;
+        regex::smatch sm_res;
+        if(!server->stream_resource.empty()) {
+          auto function = server->stream_route_table.find(request.method, request.path, sm_res);
+          if(function) {
+            stream_content(session);
+            request.path_match = std::move(sm_res);
+            server->write(session, *function);
+            return;
+          }
+        }
+        auto function = server->route_table.find(request.method, request.path, sm_res);
+        if(function) {
+          request.path_match = std::move(sm_res);
+          server->write(session, *function);
+          return;
+        }
+        auto it = server->default_resource.find(request.method);
+        if(it != server->default_resource.end()) {
+          server->write(session, it->second);
+          return;
+        }
+        stream_error(session->stream_id, ErrorCode::refused_stream); // No response would be written
+      }
 
-      /// The result of the resource regular expression match of the request path.
-      regex::smatch path_match;
+      /// Lets a stream_resource read the content, which has been received in full, in parts of at most Config::content_part_size.
+      void stream_content(const std::shared_ptr<Session> &session) {
+        auto &request = *session->request;
+        auto &source = request.content_streambuf;
+        auto &target = *request.streambuf;
+        target.commit(asio::buffer_copy(target.prepare(source.size()), source.data()));
+        source.consume(source.size());
+        request.content_pending = target.size() > 0;
+
+        auto server = this->server;
+        std::weak_ptr<Session> session_weak(session); // The session is kept alive by the response
+        request.content_reader = [server, session_weak](const std::function<void(const error_code &, std::size_t)> &callback) {
+          auto session = session_weak.lock();
+          if(!session) {
+            callback(Http2Connection::canceled(), 0);
+            return;
+          }
+          auto &request = *session->request;
+          auto &source = *request.streambuf;
+          auto &target = request.content_streambuf;
+          target.consume(target.size());
+          auto bytes = (std::min)(source.size(), server->config.content_part_size);
+          target.commit(asio::buffer_copy(target.prepare(bytes), source.data(), bytes));
+          source.consume(bytes);
+          request.content_pending = source.size() > 0;
+          callback(error_code(), bytes);
+        };
+      }
 
-      /// The time point when the request header was fully read.
-      std::chrono::system_clock::time_point header_read_time;
+      /// Adds response content of a stream, where the HTTP/1.1 status line and header fields are parsed first,
+      /// and chunked transfer encoding is removed. Returns false if the content cannot be sent.
+      bool add_content(Stream &stream, Chunk chunk) REQUIRES(mutex) {
+        while(chunk.size > 0) {
+          if(!stream.response_header_parsed || (stream.chunked && stream.chunked_state != ChunkedState::data)) {
+            if(chunk.is_file)
+              return false;
+            auto chr = *chunk.data++;
+            --chunk.size;
+            if(!stream.response_header_parsed) {
+              stream.response_header += chr;
+              auto &header = stream.response_header;
+              if(chr == '\n' && header.size() >= 2 && (header[header.size() - 2] == '\n' || (header.size() >= 4 && header.compare(header.size() - 4, 4, "\r\n\r\n") == 0))) {
+                if(!parse_response_header(stream))
+                  return false;
+              }
+              else if(header.size() > max_header_block_size())
+                return false;
+            }
+            else if(!decode_chunked(stream, chr))
+              return false;
+            continue;
+          }
 
-      asio::ip::tcp::endpoint remote_endpoint() const noexcept {
-        try {
-          if(auto connection = this->connection.lock())
-            return connection->socket->lowest_layer().remote_endpoint();
-        }
-        catch(...) {
+          auto size = stream.chunked ? static_cast<std::size_t>((std::min)(static_cast<std::uint64_t>(chunk.size), stream.chunk_remaining)) : chunk.size;
+          Chunk content = chunk;
+          content.size = size;
+          stream.chunks.emplace_back(std::move(content));
+          chunk.size -= size;
+          if(chunk.is_file)
+            chunk.file_offset += size;
+          else
+            chunk.data += size;
+          if(stream.chunked && (stream.chunk_remaining -= size) == 0)
+            stream.chunked_state = ChunkedState::data_end;
         }
-        return asio::ip::tcp::endpoint();
+        return true;
       }
 
-      asio::ip::tcp::endpoint local_endpoint() const noexcept {
-        try {
-          if(auto connection = this->connection.lock())
-            return connection->socket->lowest_layer().local_endpoint();
-        }
-        catch(...) {
+      bool parse_response_header(Stream &stream) REQUIRES(mutex) {
+        std::istringstream header_stream(stream.response_header);
+        std::string version, status_code;
+        CaseInsensitiveMultimap header;
+        if(!ResponseMessage::parse(header_stream, version, status_code, header) || status_code.size() < 3)
+          return false;
+
+        stream.response_fields.emplace_back(":status", status_code.substr(0, 3));
+        for(auto &field : header) {
+          auto name = field.first;
+          std::transform(name.begin(), name.end(), name.begin(), [](char chr) {
+            return static_cast<char>(tolower(chr));
+          });
+          // Connection-specific fields are not used in HTTP/2
+          if(name == "connection" || name == "keep-alive" || name == "proxy-connection" || name == "upgrade")
+            continue;
+          if(name == "transfer-encoding") {
+            stream.chunked = case_insensitive_equal(field.second, "chunked");
+            continue;
+          }
+          stream.response_fields.emplace_back(std::move(name), field.second);
         }
-        return asio::ip::tcp::endpoint();
+        stream.response_header.clear();
+        stream.response_header.shrink_to_fit();
+        stream.response_header_parsed = true;
+        return true;
       }
 
-      /// Deprecated, please use remote_endpoint().address().to_string() instead.
-      SW_DEPRECATED std::string remote_endpoint_address() const noexcept {
-        try {
-          if(auto connection = this->connection.lock())
-            return connection->socket->lowest_layer().remote_endpoint().address().to_string();
-        }
-        catch(...) {
+      bool decode_chunked(Stream &stream, char chr) REQUIRES(mutex) {
+        switch(stream.chunked_state) {
+        case ChunkedState::size:
+          if(std::isxdigit(static_cast<unsigned char>(chr))) {
+            if(stream.chunk_remaining > ((std::numeric_limits<std::uint64_t>::max)() >> 4))
+              return false;
+            stream.chunk_remaining = stream.chunk_remaining * 16 + static_cast<std::uint64_t>(std::isdigit(static_cast<unsigned char>(chr)) ? chr - '0' : tolower(chr) - 'a' + 10);
+          }
+          else if(chr == ';')
+            stream.chunked_state = ChunkedState::extension;
+          else if(chr == '\n')
+            stream.chunked_state = stream.chunk_remaining == 0 ? ChunkedState::trailer : ChunkedState::data;
+          else if(chr != '\r' && chr != ' ' && chr != '\t')
+            return false;
+          break;
+        case ChunkedState::extension:
+          if(chr == '\n')
+            stream.chunked_state = stream.chunk_remaining == 0 ? ChunkedState::trailer : ChunkedState::data;
+          break;
+        case ChunkedState::data_end:
+          if(chr == '\n')
+            stream.chunked_state = ChunkedState::size;
+          else if(chr != '\r')
+            return false;
+          break;
+        case ChunkedState::trailer:
+          if(chr == '\n') {
+            if(stream.trailer_line_size == 0)
+              stream.chunked_state = ChunkedState::done;
+            stream.trailer_line_size = 0;
+          }
+          else if(chr != '\r')
+            ++stream.trailer_line_size;
+          break;
+        case ChunkedState::data:
+        case ChunkedState::done:
+          break;
         }
-        return std::string();
+        return true;
       }
 
-      /// Deprecated, please use remote_endpoint().port() instead.
-      SW_DEPRECATED unsigned short remote_endpoint_port() const noexcept {
-        try {
-          if(auto connection = this->connection.lock())
-            return connection->socket->lowest_layer().remote_endpoint().port();
-        }
-        catch(...) {
+      /// Moves the callbacks at the front of the chunks, whose content has been added to batch.
+      static void take_callbacks(Stream &stream, Batch &batch) {
+        while(!stream.chunks.empty() && stream.chunks.front().size == 0) {
+          if(stream.chunks.front().callback)
+            batch.callbacks.emplace_back(std::move(stream.chunks.front().callback));
+          stream.chunks.pop_front();
         }
-        return 0;
       }
 
-      /// Returns query keys with percent-decoded values.
-      CaseInsensitiveMultimap parse_query_string() const noexcept {
-        return SimpleWeb::QueryString::parse(query_string);
+      void add_headers(std::uint32_t stream_id, Stream &stream, Batch &batch) REQUIRES(mutex) {
+        std::string block;
+        encoder.encode(stream.response_fields, block);
+        stream.response_fields.clear();
+        bool end = stream.end_pending && !stream.has_data();
+
+        std::size_t offset = 0;
+        do {
+          auto size = (std::min)(block.size() - offset, max_send_frame_size);
+          std::uint8_t flags = offset + size == block.size() ? Http2::end_headers : 0;
+          if(offset == 0 && end)
+            flags |= Http2::end_stream;
+          batch.append(Http2::FrameHeader(static_cast<std::uint32_t>(size), offset == 0 ? Http2::FrameType::headers : Http2::FrameType::continuation, flags, stream_id));
+          batch.append(block.substr(offset, size));
+          offset += size;
+        } while(offset < block.size());
+
+        stream.headers_sent = true;
+        stream.local_closed = end;
       }
-    };
 
-  protected:
-    class Connection : public std::enable_shared_from_this<Connection> {
-    public:
-      template <typename... Args>
-      Connection(std::shared_ptr<ScopeRunner> handler_runner_, Args &&...args) noexcept : handler_runner(std::move(handler_runner_)), socket(new socket_type(std::forward<Args>(args)...)), write_strand(get_executor(socket->lowest_layer())) {}
+      /// Adds a DATA frame of the stream, if the flow control windows allow. Returns false if reading a file failed.
+      bool add_data(std::uint32_t stream_id, Stream &stream, Batch &batch) REQUIRES(mutex) {
+        take_callbacks(stream, batch);
+        if(stream.chunks.empty() || send_window <= 0 || stream.send_window <= 0)
+          return true;
+
+        auto &chunk = stream.chunks.front();
+        auto size = static_cast<std::size_t>((std::min)((std::min)(static_cast<std::int64_t>((std::min)(chunk.size, max_send_frame_size)), send_window), stream.send_window));
+        const char *data = chunk.data;
+        std::shared_ptr<const void> owner = chunk.owner;
+        if(chunk.is_file) {
+          auto buffer = std::make_shared<std::vector<char>>(size);
+          error_code ec;
+          size = ChunkedFileSender<socket_type>::read(chunk.file, chunk.file_offset, buffer->data(), size, ec);
+          if(ec || size == 0) // The file is shorter than the range
+            return false;
+          data = buffer->data();
+          owner = std::move(buffer);
+          chunk.file_offset += size;
+        }
+        else
+          chunk.data += size;
+        chunk.size -= size;
+        send_window -= static_cast<std::int64_t>(size);
+        stream.send_window -= static_cast<std::int64_t>(size);
+        take_callbacks(stream, batch);
+
+        bool end = stream.end_pending && !stream.has_data();
+        batch.append(Http2::FrameHeader(static_cast<std::uint32_t>(size), Http2::FrameType::data, end ? Http2::end_stream : 0, stream_id));
+        batch.append(data, size, std::move(owner));
+        stream.local_closed = end;
+        return true;
+      }
 
-      std::shared_ptr<ScopeRunner> handler_runner;
+      /// Frames the headers and content of the streams into batch, a frame per stream at a time.
+      void add_frames(Batch &batch) REQUIRES(mutex) {
+        bool progress = true;
+        while(progress && batch.size < 256 * 1024) {
+          progress = false;
+          for(auto it = streams.begin(); it != streams.end();) {
+            auto &stream = it->second;
+            auto size = batch.size;
+            if(stream.response_header_parsed && !stream.headers_sent)
+              add_headers(it->first, stream, batch);
+            if(stream.headers_sent && !stream.local_closed) {
+              if(!add_data(it->first, stream, batch)) {
+                batch.append(frame(Http2::FrameType::rst_stream, it->first, static_cast<std::uint32_t>(ErrorCode::internal_error)));
+                erase_stream(it++, batch.failed);
+                continue;
+              }
+              if(stream.end_pending && !stream.local_closed && !stream.has_data()) {
+                batch.append(Http2::FrameHeader(0, Http2::FrameType::data, Http2::end_stream, it->first));
+                stream.local_closed = true;
+              }
+            }
+            progress = progress || batch.size != size;
+
+            if(stream.local_closed) {
+              take_callbacks(stream, batch);
+              // The rest of the request content is not needed
+              if(!stream.remote_closed)
+                batch.append(frame(Http2::FrameType::rst_stream, it->first, static_cast<std::uint32_t>(ErrorCode::no_error)));
+              it = streams.erase(it);
+            }
+            else
+              ++it;
+          }
+        }
+      }
 
-      std::unique_ptr<socket_type> socket; // Socket must be unique_ptr since asio::ssl::stream<asio::ip::tcp::socket> is not movable
+      static std::string frame(Http2::FrameType type, std::uint32_t stream_id, std::uint32_t value) {
+        std::string frame;
+        Http2::append_frame(frame, type, stream_id, value);
+        return frame;
+      }
 
-      /**
-       * Needed for TLS communication where async_write could be called outside of the io_context runners.
-       * For more information see https://stackoverflow.com/a/12801042.
-       */
-      strand write_strand;
+      /// Writes the queued frames, unless a write is in progress, in which case this is called again when it completes.
+      void flush() REQUIRES(mutex) {
+        if(writing || closed)
+          return;
 
-      std::unique_ptr<asio::steady_timer> timer;
+        auto batch = std::make_shared<Batch>();
+        if(!control_frames.empty()) {
+          batch->append(control_frames);
+          control_frames.clear();
+        }
+        if(!closing)
+          add_frames(*batch);
+        if(batch->empty())
+          return;
 
-      void close() noexcept {
-        error_code ec;
-        socket->lowest_layer().shutdown(asio::ip::tcp::socket::shutdown_both, ec);
-        socket->lowest_layer().cancel(ec);
+        writing = true;
+        auto self = this->shared_from_this();
+        post(connection->write_strand, [self, batch] {
+          auto lock = self->connection->handler_runner->continue_lock();
+          if(!lock)
+            return;
+          asio::async_write(*self->connection->socket, batch->buffers(), [self, batch](const error_code &ec, std::size_t /*bytes_transferred*/) {
+            auto lock = self->connection->handler_runner->continue_lock();
+            if(!lock)
+              return;
+
+            error_code close_ec = ec;
+            {
+              LockGuard lock(self->mutex);
+              self->writing = false;
+              if(!ec && self->closing && self->control_frames.empty())
+                close_ec = self->closing_error;
+              else if(!ec)
+                self->flush();
+            }
+            call(batch->callbacks, ec);
+            call(batch->failed, Http2Connection::canceled());
+            if(close_ec)
+              self->close(close_ec);
+          });
+        });
       }
 
-      void set_timeout(long seconds) noexcept {
-        if(seconds == 0) {
-          timer = nullptr;
-          return;
+      void erase_stream(typename std::map<std::uint32_t, Stream>::iterator it, Callbacks &canceled) REQUIRES(mutex) {
+        for(auto &chunk : it->second.chunks) {
+          if(chunk.callback)
+            canceled.emplace_back(std::move(chunk.callback));
         }
+        streams.erase(it);
+      }
 
-        timer = make_steady_timer(*socket, std::chrono::seconds(seconds));
-        std::weak_ptr<Connection> self_weak(this->shared_from_this()); // To avoid keeping Connection instance alive longer than needed
-        timer->async_wait([self_weak](const error_code &ec) {
-          if(!ec) {
-            if(auto self = self_weak.lock())
-              self->close();
-          }
-        });
+      void reset_stream(typename std::map<std::uint32_t, Stream>::iterator it, ErrorCode error_code, Callbacks &canceled) REQUIRES(mutex) {
+        Http2::append_frame(control_frames, Http2::FrameType::rst_stream, it->first, static_cast<std::uint32_t>(error_code));
+        erase_stream(it, canceled);
       }
 
-      void cancel_timeout() noexcept {
-        if(timer) {
-          try {
-            timer->cancel();
-          }
-          catch(...) {
-          }
+      void stream_error(std::uint32_t stream_id, ErrorCode error_code) {
+        Callbacks canceled;
+        {
+          LockGuard lock(mutex);
+          auto it = streams.find(stream_id);
+          if(it != streams.end())
+            reset_stream(it, error_code, canceled);
+          else
+            Http2::append_frame(control_frames, Http2::FrameType::rst_stream, stream_id, static_cast<std::uint32_t>(error_code));
+          flush();
         }
+        call(canceled, Http2Connection::canceled());
       }
-    };
 
-    class Session {
-    public:
-      Session(std::size_t max_request_streambuf_size, std::shared_ptr<Connection> connection_) noexcept
-          : connection(std::move(connection_)), request(new Request(max_request_streambuf_size, connection)) {}
-      Session(std::size_t max_request_streambuf_size, std::shared_ptr<Connection> connection_, std::unique_ptr<asio::streambuf> &&previous_streambuf) noexcept
-          : connection(std::move(connection_)), request(new Request(max_request_streambuf_size, connection, std::move(previous_streambuf))) {}
+      /// Sends GOAWAY, after which the connection is closed.
+      void goaway(ErrorCode error_code) REQUIRES(mutex) {
+        if(closing)
+          return;
+        Http2::append_goaway(control_frames, last_stream_id, error_code);
+        closing = true;
+        closing_error = make_error_code::make_error_code(errc::protocol_error);
+        flush();
+      }
 
-      std::shared_ptr<Connection> connection;
-      std::shared_ptr<Request> request;
+      bool connection_error(ErrorCode error_code) {
+        LockGuard lock(mutex);
+        goaway(error_code);
+        return false;
+      }
+
+      void close(const error_code &ec) {
+        Callbacks canceled;
+        {
+          LockGuard lock(mutex);
+          if(closed)
+            return;
+          closed = true;
+          while(!streams.empty())
+            erase_stream(streams.begin(), canceled);
+        }
+        connection->close();
+        call(canceled, Http2Connection::canceled());
+        if(server->on_error)
+          server->on_error(connection_request, ec);
+      }
     };
 
   public:
@@ -373,6 +1866,10 @@ namespace SimpleWeb {
       /// If io_service is not set, number of threads that the server will use when start() is called.
       /// Defaults to 1 thread.
       std::size_t thread_pool_size = 1;
+      /// If io_service is not set, give each of the thread_pool_size threads its own io_context, and hand out
+      /// accepted connections to them in turn. Each connection is then handled by a single thread, instead of
+      /// all threads sharing one io_context. Defaults to false.
+      bool io_context_per_thread = false;
       /// Timeout on request completion. Defaults to 5 seconds.
       long timeout_request = 5;
       /// Timeout on request/response content completion. Defaults to 300 seconds.
@@ -380,6 +1877,9 @@ namespace SimpleWeb {
       /// Maximum size of request stream buffer. Defaults to architecture maximum.
       /// Reaching this limit will result in a message_size error code.
       std::size_t max_request_streambuf_size = (std::numeric_limits<std::size_t>::max)();
+      /// Maximum size of the content parts given by Request::read_content() for resources in stream_resource.
+      /// Defaults to 64 KiB.
+      std::size_t content_part_size = 65536;
       /// IPv4 address in dotted decimal form or IPv6 address in hexadecimal notation.
       /// If empty, the address will be any address.
       std::string address;
@@ -387,6 +1887,11 @@ namespace SimpleWeb {
       bool reuse_address = true;
       /// Make use of RFC 7413 or TCP Fast Open (TFO)
       bool fast_open = false;
+      /// Set to true to also serve HTTP/2, negotiated with ALPN on HTTPS, or with prior knowledge on HTTP.
+      /// The streams are handled by the same resources, with Request::http_version set to "2.0". Defaults to false.
+      bool http2 = false;
+      /// Maximum number of concurrent HTTP/2 streams per connection. Defaults to 100.
+      std::uint32_t http2_max_concurrent_streams = 100;
     };
     /// Set before calling start().
     Config config;
@@ -403,10 +1908,145 @@ namespace SimpleWeb {
       }
     };
 
+    using resource_function = std::function<void(std::shared_ptr<typename ServerBase<socket_type>::Response>, std::shared_ptr<typename ServerBase<socket_type>::Request>)>;
+    using resource_type = std::map<regex_orderable, std::map<std::string, resource_function>>;
+
+    /// Resources compiled by start() so that most requests are routed without running every resource regex.
+    ///
+    /// Resources whose regex is a plain path, like ^/serverinfo$, are found with a single hash lookup.
+    /// The remaining resources are tried in order as before, but only if the request path starts with
+    /// the literal prefix of their regex. Routing results are the same as trying all resources in order.
+    class RouteTable {
+      class RegexRoute {
+      public:
+        const regex_orderable *regex;
+        const std::map<std::string, resource_function> *methods;
+        std::string prefix;
+      };
+
+      class LiteralRoute {
+      public:
+        /// Set if the matching resource is a regex route, in which case it is run to set path_match.
+        const regex_orderable *regex;
+        const resource_function *function;
+      };
+
+      std::vector<RegexRoute> regex_routes;
+      std::unordered_map<std::string, std::map<std::string, LiteralRoute>> literal_routes;
+
+      /// Reads the literal characters at the start of regex_str into literal.
+      /// Returns true if the whole regex is literal, such that it only matches literal.
+      static bool parse_literal(const std::string &regex_str, std::string &literal) {
+        std::size_t i = 0;
+        if(i < regex_str.size() && regex_str[i] == '^')
+          ++i;
+        for(; i < regex_str.size(); ++i) {
+          auto chr = regex_str[i];
+          if(chr == '\\' && i + 1 < regex_str.size() && !std::isalnum(static_cast<unsigned char>(regex_str[i + 1])))
+            literal += regex_str[++i]; // Escaped special character
+          else if(chr == '$' && i + 1 == regex_str.size())
+            return true;
+          else if(chr == '\\' || std::strchr("^$.|?*+()[]{}", chr))
+            break;
+          else
+            literal += chr;
+        }
+        if(i == regex_str.size())
+          return true;
+
+        // The last literal character is optional if followed by a quantifier
+        if(!literal.empty() && (regex_str[i] == '?' || regex_str[i] == '*' || regex_str[i] == '{'))
+          literal.pop_back();
+
+        // An alternative that is not inside a group need not start with the prefix
+        int depth = 0;
+        bool in_brackets = false;
+        for(; i < regex_str.size(); ++i) {
+          auto chr = regex_str[i];
+          if(chr == '\\')
+            ++i;
+          else if(in_brackets)
+            in_brackets = chr != ']';
+          else if(chr == '[')
+            in_brackets = true;
+          else if(chr == '(')
+            ++depth;
+          else if(chr == ')')
+            --depth;
+          else if(chr == '|' && depth == 0) {
+            literal.clear();
+            break;
+          }
+        }
+        return false;
+      }
+
+    public:
+      void compile(const resource_type &resource) {
+        regex_routes.clear();
+        literal_routes.clear();
+
+        std::vector<std::string> literals;
+        std::set<std::string> methods;
+        for(auto &regex_method : resource) {
+          std::string literal;
+          if(parse_literal(regex_method.first.str, literal))
+            literals.emplace_back(std::move(literal));
+          else
+            regex_routes.emplace_back(RegexRoute{&regex_method.first, &regex_method.second, std::move(literal)});
+          for(auto &method : regex_method.second)
+            methods.emplace(method.first);
+        }
+
+        // Resolve each literal path as the resources would be tried in order,
+        // since an earlier regex resource may match the same path
+        for(auto &literal : literals) {
+          auto &literal_methods = literal_routes[literal];
+          for(auto &method : methods) {
+            for(auto &regex_method : resource) {
+              auto it = regex_method.second.find(method);
+              if(it != regex_method.second.end() && regex::regex_match(literal, regex_method.first)) {
+                std::string unused;
+                auto regex = parse_literal(regex_method.first.str, unused) ? nullptr : &regex_method.first;
+                literal_methods.emplace(method, LiteralRoute{regex, &it->second});
+                break;
+              }
+            }
+          }
+        }
+      }
+
+      /// Returns the function of the first resource that matches method and path, or nullptr if there is none.
+      const resource_function *find(const std::string &method, const std::string &path, regex::smatch &path_match) const {
+        auto literal_it = literal_routes.find(path);
+        if(literal_it != literal_routes.end()) {
+          auto it = literal_it->second.find(method);
+          if(it == literal_it->second.end())
+            return nullptr;
+          if(it->second.regex)
+            regex::regex_match(path, path_match, *it->second.regex);
+          return it->second.function;
+        }
+
+        for(auto &route : regex_routes) {
+          auto it = route.methods->find(method);
+          if(it != route.methods->end() && path.compare(0, route.prefix.size(), route.prefix) == 0 && regex::regex_match(path, path_match, *route.regex))
+            return &it->second;
+        }
+        return nullptr;
+      }
+    };
+
   public:
     /// Use this container to add resources for specific request paths depending on the given regex and method.
     /// Warning: do not add or remove resources after start() is called
-    std::map<regex_orderable, std::map<std::string, std::function<void(std::shared_ptr<typename ServerBase<socket_type>::Response>, std::shared_ptr<typename ServerBase<socket_type>::Request>)>>> resource;
+    resource_type resource;
+
+    /// Like resource, but the resource function is called as soon as the request header has been read.
+    /// The content is then read in parts with Request::read_content(), so that large uploads are not buffered in memory.
+    /// These resources are tried before those in resource.
+    /// Warning: do not add or remove resources after start() is called
+    resource_type stream_resource;
 
     /// If the request path does not match a resource regex, this function is called.
     std::map<std::string, std::function<void(std::shared_ptr<typename ServerBase<socket_type>::Response>, std::shared_ptr<typename ServerBase<socket_type>::Request>)>> default_resource;
@@ -427,6 +2067,9 @@ namespace SimpleWeb {
     void start(const std::function<void(unsigned short /*port*/)> &callback = nullptr) {
       std::unique_lock<std::mutex> lock(start_stop_mutex);
 
+      route_table.compile(resource);
+      stream_route_table.compile(stream_resource);
+
       asio::ip::tcp::endpoint endpoint;
       if(!config.address.empty())
         endpoint = asio::ip::tcp::endpoint(make_address(config.address), config.port);
@@ -437,6 +2080,16 @@ namespace SimpleWeb {
         io_service = std::make_shared<io_context>();
         internal_io_service = true;
       }
+      // The main thread runs io_service, that also handles connections, and each of the other threads runs its own io_context
+      active_connection_io_services = internal_io_service && config.io_context_per_thread && config.thread_pool_size > 1 ? config.thread_pool_size - 1 : 0;
+      while(connection_io_services.size() < active_connection_io_services)
+        connection_io_services.emplace_back(std::make_shared<io_context>());
+      if(timing_wheels.find(io_service.get()) == timing_wheels.end())
+        timing_wheels.emplace(io_service.get(), std::make_shared<TimingWheel>(*io_service));
+      for(auto &connection_io_service : connection_io_services) {
+        if(timing_wheels.find(connection_io_service.get()) == timing_wheels.end())
+          timing_wheels.emplace(connection_io_service.get(), std::make_shared<TimingWheel>(*connection_io_service));
+      }
 
       if(!acceptor)
         acceptor = std::unique_ptr<asio::ip::tcp::acceptor>(new asio::ip::tcp::acceptor(*io_service));
@@ -470,6 +2123,10 @@ namespace SimpleWeb {
 
       if(internal_io_service && io_service->stopped())
         restart(*io_service);
+      for(auto &connection_io_service : connection_io_services) {
+        if(connection_io_service->stopped())
+          restart(*connection_io_service);
+      }
 
       if(callback)
         post(*io_service, [callback, port] {
@@ -480,9 +2137,19 @@ namespace SimpleWeb {
         // If thread_pool_size>1, start m_io_service.run() in (thread_pool_size-1) threads for thread-pooling
         threads.clear();
         for(std::size_t c = 1; c < config.thread_pool_size; c++) {
-          threads.emplace_back([this]() {
-            this->io_service->run();
-          });
+          if(c <= active_connection_io_services) {
+            auto connection_io_service = connection_io_services[c - 1];
+            threads.emplace_back([connection_io_service]() {
+              // Keep running while waiting for connections, until stop() is called
+              auto work = make_work_guard(*connection_io_service);
+              connection_io_service->run();
+            });
+          }
+          else {
+            threads.emplace_back([this]() {
+              this->io_service->run();
+            });
+          }
         }
 
         lock.unlock();
@@ -514,8 +2181,14 @@ namespace SimpleWeb {
           connections->set.clear();
         }
 
-        if(internal_io_service)
+        for(auto &timing_wheel : timing_wheels)
+          timing_wheel.second->stop();
+
+        if(internal_io_service) {
           io_service->stop();
+          for(auto &connection_io_service : connection_io_services)
+            connection_io_service->stop();
+        }
       }
     }
 
@@ -532,6 +2205,18 @@ namespace SimpleWeb {
     std::unique_ptr<asio::ip::tcp::acceptor> acceptor;
     std::vector<std::thread> threads;
 
+    /// The io_contexts of the threads other than the main one, if Config::io_context_per_thread is set.
+    /// They are kept until the server is destroyed, since connections may still refer to them after stop().
+    std::vector<std::shared_ptr<io_context>> connection_io_services;
+    std::size_t active_connection_io_services = 0;
+    std::size_t next_connection_io_service = 0;
+
+    /// The connection timeouts of each io_context, created in start().
+    std::unordered_map<io_context *, std::shared_ptr<TimingWheel>> timing_wheels;
+
+    RouteTable route_table;
+    RouteTable stream_route_table;
+
     struct Connections {
       Mutex mutex;
       std::unordered_set<Connection *> set GUARDED_BY(mutex);
@@ -545,10 +2230,37 @@ namespace SimpleWeb {
     virtual void after_bind() {}
     virtual void accept() = 0;
 
+    /// Returns the io_context that should handle the next accepted connection.
+    /// Only called from accept(), that runs in the main thread.
+    io_context &connection_io_service() noexcept {
+      if(active_connection_io_services == 0)
+        return *io_service;
+      auto index = next_connection_io_service++ % (active_connection_io_services + 1);
+      return index == 0 ? *io_service : *connection_io_services[index - 1];
+    }
+
+    /// Calls function in the thread of the connection, which may not be the thread that accepted it.
+    template <typename function_type>
+    void post_to_connection(io_context &connection_io_service, const std::shared_ptr<Connection> &connection, function_type &&function) {
+      if(&connection_io_service == io_service.get())
+        function();
+      else {
+        post(connection_io_service, [connection, function] {
+          auto lock = connection->handler_runner->continue_lock();
+          if(!lock)
+            return;
+          function();
+        });
+      }
+    }
+
     template <typename... Args>
-    std::shared_ptr<Connection> create_connection(Args &&...args) noexcept {
+    std::shared_ptr<Connection> create_connection(io_context &connection_io_service, Args &&...args) noexcept {
       auto connections = this->connections;
-      auto connection = std::shared_ptr<Connection>(new Connection(handler_runner, std::forward<Args>(args)...), [connections](Connection *connection) {
+      auto &timing_wheel = timing_wheels[&connection_io_service];
+      if(!timing_wheel) // Only when not created by start()
+        timing_wheel = std::make_shared<TimingWheel>(connection_io_service);
+      auto connection = std::shared_ptr<Connection>(new Connection(handler_runner, timing_wheel, connection_io_service, std::forward<Args>(args)...), [connections](Connection *connection) {
         {
           LockGuard lock(connections->mutex);
           auto it = connections->set.find(connection);
@@ -564,6 +2276,13 @@ namespace SimpleWeb {
       return connection;
     }
 
+    /// Continues the connection of session with HTTP/2, where preface_read octets of the client preface have been read.
+    void start_http2(const std::shared_ptr<Session> &session, std::size_t preface_read) {
+      auto http2 = std::make_shared<Http2Connection>(this, session->connection, session->request, preface_read);
+      auto &streambuf = *session->request->streambuf;
+      http2->start(buffer_data(streambuf.data()), streambuf.size());
+    }
+
     void read(const std::shared_ptr<Session> &session) {
       session->connection->set_timeout(config.timeout_request);
       asio::async_read_until(*session->connection->socket, *session->request->streambuf, "\r\n\r\n", [this, session](const error_code &ec, std::size_t bytes_transferred) {
@@ -576,17 +2295,42 @@ namespace SimpleWeb {
           session->connection->set_timeout(this->config.timeout_content);
           // request->streambuf->size() is not necessarily the same as bytes_transferred, from Boost-docs:
           // "After a successful async_read_until operation, the streambuf may contain additional data beyond the delimiter"
-          // The chosen solution is to extract lines from the stream directly when parsing the header. What is left of the
+          // The chosen solution is to parse the header directly from the stream buffer, and consume only the parsed bytes. What is left of the
           // streambuf (maybe some bytes of the content) is appended to in the async_read-function below (for retrieving content).
           std::size_t num_additional_bytes = session->request->streambuf->size() - bytes_transferred;
 
-          std::istream istream(session->request->streambuf.get());
-          if(!RequestMessage::parse(istream, session->request->method, session->request->path,
-                                    session->request->query_string, session->request->http_version, session->request->header)) {
+          auto &streambuf = *session->request->streambuf;
+          auto buffer = streambuf.data();
+          RequestMessage::Parser parser;
+          if(parser.parse(buffer_data(buffer), asio::buffer_size(buffer)) != RequestMessage::Parser::Result::complete) {
             if(this->on_error)
               this->on_error(session->request, make_error_code::make_error_code(errc::protocol_error));
             return;
           }
+          session->request->method.assign(parser.method().data, parser.method().size);
+          session->request->path.assign(parser.path().data, parser.path().size);
+          session->request->query_string.assign(parser.query_string().data, parser.query_string().size);
+          session->request->http_version.assign(parser.http_version().data, parser.http_version().size);
+          parser.header(session->request->header);
+          streambuf.consume(parser.size());
+
+          if(this->config.http2 && session->request->method == "PRI" && session->request->path == "*" && session->request->http_version == "2.0") {
+            // HTTP/2 with prior knowledge, where the client preface starts like a request without header fields
+            this->start_http2(session, parser.size());
+            return;
+          }
+
+          if(!this->stream_resource.empty()) {
+            regex::smatch sm_res;
+            auto function = this->stream_route_table.find(session->request->method, session->request->path, sm_res);
+            if(function) {
+              if(this->stream_content(session)) {
+                session->request->path_match = std::move(sm_res);
+                this->write(session, *function);
+              }
+              return;
+            }
+          }
 
           // If content, read that as well
           auto header_it = session->request->header.find("Content-Length");
@@ -758,6 +2502,135 @@ namespace SimpleWeb {
       });
     }
 
+    /// Prepares the request content to be read in parts by the stream_resource function.
+    bool stream_content(const std::shared_ptr<Session> &session) {
+      auto &request = *session->request;
+      auto header_it = request.header.find("Content-Length");
+      if(header_it != request.header.end()) {
+        try {
+          request.content_remaining = std::stoull(header_it->second);
+        }
+        catch(const std::exception &) {
+          if(this->on_error)
+            this->on_error(session->request, make_error_code::make_error_code(errc::protocol_error));
+          return false;
+        }
+      }
+      else if((header_it = request.header.find("Transfer-Encoding")) != request.header.end() && header_it->second == "chunked")
+        request.content_chunked = true;
+      request.content_pending = request.content_chunked || request.content_remaining > 0;
+
+      std::weak_ptr<Session> session_weak(session); // The session is kept alive by the response
+      request.content_reader = [this, session_weak](const std::function<void(const error_code &, std::size_t)> &callback) {
+        if(auto session = session_weak.lock())
+          this->read_content_part(session, callback);
+        else
+          callback(make_error_code::make_error_code(errc::operation_canceled), 0);
+      };
+      return true;
+    }
+
+    void read_content_part(const std::shared_ptr<Session> &session, const std::function<void(const error_code &, std::size_t)> &callback) {
+      auto &request = *session->request;
+      request.content_streambuf.consume(request.content_streambuf.size());
+      if(!request.content_pending) {
+        callback(error_code(), 0);
+        return;
+      }
+      if(request.content_remaining == 0) { // Only when chunked
+        read_content_chunk_line(session, callback);
+        return;
+      }
+
+      auto bytes = std::min<unsigned long long>(request.content_remaining, (std::min)(config.content_part_size, request.content_streambuf.max_size()));
+      if(request.streambuf->size() > 0) {
+        // Use bytes already read together with the header or chunk size line
+        bytes = std::min<unsigned long long>(bytes, request.streambuf->size());
+        auto &source = *request.streambuf;
+        auto &target = request.content_streambuf;
+        target.commit(asio::buffer_copy(target.prepare(bytes), source.data(), bytes));
+        source.consume(bytes);
+        content_part_read(session, bytes, callback);
+        return;
+      }
+
+      asio::async_read(*session->connection->socket, request.content_streambuf, asio::transfer_exactly(bytes), [this, session, callback](const error_code &ec, std::size_t bytes_transferred) {
+        auto lock = session->connection->handler_runner->continue_lock();
+        if(!lock)
+          return;
+
+        if(!ec)
+          this->content_part_read(session, bytes_transferred, callback);
+        else {
+          if(this->on_error)
+            this->on_error(session->request, ec);
+          callback(ec, 0);
+        }
+      });
+    }
+
+    void content_part_read(const std::shared_ptr<Session> &session, std::size_t bytes, const std::function<void(const error_code &, std::size_t)> &callback) {
+      auto &request = *session->request;
+      request.content_remaining -= bytes;
+      if(request.content_remaining == 0 && !request.content_chunked)
+        request.content_pending = false;
+      callback(error_code(), bytes);
+    }
+
+    /// Reads a chunk size line, or the CRLF ending a chunk, of chunked content.
+    void read_content_chunk_line(const std::shared_ptr<Session> &session, const std::function<void(const error_code &, std::size_t)> &callback) {
+      asio::async_read_until(*session->connection->socket, *session->request->streambuf, "\r\n", [this, session, callback](const error_code &ec, std::size_t /*bytes_transferred*/) {
+        auto lock = session->connection->handler_runner->continue_lock();
+        if(!lock)
+          return;
+
+        if(ec) {
+          if(this->on_error)
+            this->on_error(session->request, ec);
+          callback(ec, 0);
+          return;
+        }
+
+        auto &request = *session->request;
+        std::istream istream(request.streambuf.get());
+        std::string line;
+        std::getline(istream, line);
+
+        auto protocol_error = [this, &session, &callback] {
+          auto ec = make_error_code::make_error_code(errc::protocol_error);
+          if(this->on_error)
+            this->on_error(session->request, ec);
+          callback(ec, 0);
+        };
+
+        if(request.content_chunk_end) {
+          if(!line.empty() && line != "\r") {
+            protocol_error();
+            return;
+          }
+          request.content_chunk_end = false;
+          if(request.content_last_chunk) {
+            request.content_pending = false;
+            callback(error_code(), 0);
+          }
+          else
+            this->read_content_part(session, callback);
+          return;
+        }
+
+        try {
+          request.content_remaining = std::stoull(line, 0, 16);
+        }
+        catch(...) {
+          protocol_error();
+          return;
+        }
+        request.content_chunk_end = true;
+        request.content_last_chunk = request.content_remaining == 0;
+        this->read_content_part(session, callback);
+      });
+    }
+
     void find_resource(const std::shared_ptr<Session> &session) {
       // Upgrade connection
       if(on_upgrade) {
@@ -776,31 +2649,34 @@ namespace SimpleWeb {
         }
       }
       // Find path- and method-match, and call write
-      for(auto &regex_method : resource) {
-        auto it = regex_method.second.find(session->request->method);
-        if(it != regex_method.second.end()) {
-          regex::smatch sm_res;
-          if(regex::regex_match(session->request->path, sm_res, regex_method.first)) {
-            session->request->path_match = std::move(sm_res);
-            write(session, it->second);
-            return;
-          }
-        }
+      regex::smatch sm_res;
+      auto function = route_table.find(session->request->method, session->request->path, sm_res);
+      if(function) {
+        session->request->path_match = std::move(sm_res);
+        write(session, *function);
+        return;
       }
       auto it = default_resource.find(session->request->method);
       if(it != default_resource.end())
         write(session, it->second);
     }
 
-    void write(const std::shared_ptr<Session> &session,
-               std::function<void(std::shared_ptr<typename ServerBase<socket_type>::Response>, std::shared_ptr<typename ServerBase<socket_type>::Request>)> &resource_function) {
+    void write(const std::shared_ptr<Session> &session, const resource_function &resource_function) {
       auto response = std::shared_ptr<Response>(new Response(session, config.timeout_content), [this](Response *response_ptr) {
         auto response = std::shared_ptr<Response>(response_ptr);
         response->send_on_delete([this, response](const error_code &ec) {
+          if(response->session->http2) {
+            if(ec && this->on_error)
+              this->on_error(response->session->request, ec);
+            return;
+          }
           response->session->connection->cancel_timeout();
           if(!ec) {
             if(response->close_connection_after_response)
               return;
+            // The next request cannot be read before the content of this one
+            if(response->session->request->content_pending)
+              return;
 
             auto range = response->session->request->header.equal_range("Connection");
             for(auto it = range.first; it != range.second; it++) {
@@ -847,9 +2723,10 @@ namespace SimpleWeb {
 
   protected:
     void accept() override {
-      auto connection = create_connection(*io_service);
+      auto &connection_io_service = this->connection_io_service();
+      auto connection = create_connection(connection_io_service);
 
-      acceptor->async_accept(*connection->socket, [this, connection](const error_code &ec) {
+      acceptor->async_accept(*connection->socket, [this, connection, &connection_io_service](const error_code &ec) {
         auto lock = connection->handler_runner->continue_lock();
         if(!lock)
           return;
@@ -865,7 +2742,9 @@ namespace SimpleWeb {
           error_code ec;
           session->connection->socket->set_option(option, ec);
 
-          this->read(session);
+          this->post_to_connection(connection_io_service, connection, [this, session] {
+            this->read(session);
+          });
         }
         else if(this->on_error)
           this->on_error(session->request, ec);
@@ -10,6 +10,7 @@
 #endif
 
 #include <algorithm>
+#include <cstring>
 #include <openssl/ssl.h>
 
 namespace SimpleWeb {
@@ -20,6 +21,40 @@ namespace SimpleWeb {
     bool set_session_id_context = false;
 
   public:
+    class TlsConfig {
+    public:
+      /// Maximum number of sessions kept for resumption with session IDs. Set to 0 to disable the session cache.
+      /// Defaults to 20480 sessions.
+      long session_cache_size = 20480;
+      /// Seconds during which a session can be resumed, with a session ID or ticket. Defaults to 300 seconds.
+      long session_timeout = 300;
+      /// Set to false to disable resumption with session tickets (RFC 5077). Defaults to true.
+      bool session_tickets = true;
+      /// If greater than 0, number of threads that perform the handshakes, so that handshakes with their
+      /// certificate verification do not hold up the threads serving requests. Defaults to 0,
+      /// where handshakes run in the thread of the connection.
+      std::size_t handshake_thread_pool_size = 0;
+    };
+    /// Set before calling start().
+    TlsConfig tls_config;
+
+    class HandshakeStats {
+    public:
+      /// Number of completed handshakes, including those that failed.
+      std::size_t count = 0;
+      std::size_t failed = 0;
+      /// Number of successful handshakes that resumed a previous session.
+      std::size_t resumed = 0;
+      /// Time from when the connection was accepted until the handshake completed, including waiting for a handshake thread.
+      std::chrono::microseconds total_time = std::chrono::microseconds(0);
+      std::chrono::microseconds max_time = std::chrono::microseconds(0);
+    };
+
+    HandshakeStats handshake_stats() noexcept {
+      LockGuard lock(handshake_stats_mutex);
+      return stats;
+    }
+
     /**
      * Constructs a server object.
      *
@@ -48,10 +83,65 @@ namespace SimpleWeb {
       }
     }
 
+    ~Server() noexcept {
+      if(handshake_io_service) {
+        stop(); // Makes blocking handshakes return, by closing their connections
+        handshake_io_service->stop();
+        for(auto &thread : handshake_threads)
+          thread.join();
+      }
+    }
+
   protected:
     asio::ssl::context context;
 
+    std::unique_ptr<io_context> handshake_io_service;
+    std::vector<std::thread> handshake_threads;
+
+    Mutex handshake_stats_mutex;
+    HandshakeStats stats GUARDED_BY(handshake_stats_mutex);
+
+    /// Selects h2 if the client offers it, and otherwise http/1.1 or no protocol.
+    static int select_alpn_protocol(SSL * /*ssl*/, const unsigned char **out, unsigned char *out_size, const unsigned char *in, unsigned int in_size, void * /*arg*/) {
+      static const unsigned char protocols[] = "\x02h2\x08http/1.1";
+      unsigned char *selected;
+      if(SSL_select_next_proto(&selected, out_size, protocols, sizeof(protocols) - 1, in, in_size) != OPENSSL_NPN_NEGOTIATED)
+        return SSL_TLSEXT_ERR_NOACK;
+      *out = selected;
+      return SSL_TLSEXT_ERR_OK;
+    }
+
+    static bool negotiated_http2(HTTPS &socket) noexcept {
+      const unsigned char *protocol = nullptr;
+      unsigned int size = 0;
+      SSL_get0_alpn_selected(socket.native_handle(), &protocol, &size);
+      return size == 2 && std::memcmp(protocol, "h2", 2) == 0;
+    }
+
     void after_bind() override {
+      auto native_context = context.native_handle();
+      SSL_CTX_set_session_cache_mode(native_context, tls_config.session_cache_size > 0 ? SSL_SESS_CACHE_SERVER : SSL_SESS_CACHE_OFF);
+      if(tls_config.session_cache_size > 0)
+        SSL_CTX_sess_set_cache_size(native_context, tls_config.session_cache_size);
+      SSL_CTX_set_timeout(native_context, tls_config.session_timeout);
+      if(tls_config.session_tickets)
+        SSL_CTX_clear_options(native_context, SSL_OP_NO_TICKET);
+      else
+        SSL_CTX_set_options(native_context, SSL_OP_NO_TICKET);
+      if(config.http2)
+        SSL_CTX_set_alpn_select_cb(native_context, select_alpn_protocol, nullptr);
+
+      if(tls_config.handshake_thread_pool_size > 0 && !handshake_io_service) {
+        handshake_io_service = std::unique_ptr<io_context>(new io_context());
+        for(std::size_t c = 0; c < tls_config.handshake_thread_pool_size; ++c) {
+          handshake_threads.emplace_back([this] {
+            // Keep running while waiting for handshakes, until the server is destroyed
+            auto work = make_work_guard(*handshake_io_service);
+            handshake_io_service->run();
+          });
+        }
+      }
+
       if(set_session_id_context) {
         // Creating session_id_context from address:port but reversed due to small SSL_MAX_SSL_SESSION_ID_LENGTH
         auto session_id_context = std::to_string(acceptor->local_endpoint().port()) + ':';
@@ -63,9 +153,10 @@ namespace SimpleWeb {
     }
 
     void accept() override {
-      auto connection = create_connection(*io_service, context);
+      auto &connection_io_service = this->connection_io_service();
+      auto connection = create_connection(connection_io_service, context);
 
-      acceptor->async_accept(connection->socket->lowest_layer(), [this, connection](const error_code &ec) {
+      acceptor->async_accept(connection->socket->lowest_layer(), [this, connection, &connection_io_service](const error_code &ec) {
         auto lock = connection->handler_runner->continue_lock();
         if(!lock)
           return;
@@ -80,22 +171,82 @@ namespace SimpleWeb {
           error_code ec;
           session->connection->socket->lowest_layer().set_option(option, ec);
 
-          session->connection->set_timeout(config.timeout_request);
-          session->connection->socket->async_handshake(asio::ssl::stream_base::server, [this, session](const error_code &ec) {
+          auto accept_time = std::chrono::steady_clock::now();
+          this->post_to_connection(connection_io_service, connection, [this, session, &connection_io_service, accept_time] {
+            session->connection->set_timeout(config.timeout_request);
+            this->handshake(session, connection_io_service, accept_time);
+          });
+        }
+        else if(this->on_error)
+          this->on_error(session->request, ec);
+      });
+    }
+
+    void handshake(const std::shared_ptr<Session> &session, io_context &connection_io_service, std::chrono::steady_clock::time_point accept_time) {
+      if(!handshake_io_service) {
+        session->connection->socket->async_handshake(asio::ssl::stream_base::server, [this, session, accept_time](const error_code &ec) {
+          session->connection->cancel_timeout();
+          auto lock = session->connection->handler_runner->continue_lock();
+          if(!lock)
+            return;
+          this->handshake_completed(session, ec, accept_time);
+        });
+        return;
+      }
+
+      // Wait for the client hello here, so that idle connections do not hold up the handshake threads
+      async_wait_readable(session->connection->socket->lowest_layer(), [this, session, &connection_io_service, accept_time](const error_code &ec) {
+        auto lock = session->connection->handler_runner->continue_lock();
+        if(!lock)
+          return;
+        if(ec) {
+          session->connection->cancel_timeout();
+          this->handshake_completed(session, ec, accept_time);
+          return;
+        }
+
+        // Nothing else uses the socket before the handshake has completed, so it can be done blocking in another thread.
+        // The connection timeout still applies, since it closes the socket.
+        post(*handshake_io_service, [this, session, &connection_io_service, accept_time] {
+          auto lock = session->connection->handler_runner->continue_lock();
+          if(!lock)
+            return;
+          error_code ec;
+          session->connection->socket->handshake(asio::ssl::stream_base::server, ec);
+
+          post(connection_io_service, [this, session, ec, accept_time] {
             session->connection->cancel_timeout();
             auto lock = session->connection->handler_runner->continue_lock();
             if(!lock)
               return;
-            if(!ec)
-              this->read(session);
-            else if(this->on_error)
-              this->on_error(session->request, ec);
+            this->handshake_completed(session, ec, accept_time);
           });
-        }
-        else if(this->on_error)
-          this->on_error(session->request, ec);
+        });
       });
     }
+
+    void handshake_completed(const std::shared_ptr<Session> &session, const error_code &ec, std::chrono::steady_clock::time_point accept_time) {
+      auto time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - accept_time);
+      {
+        LockGuard lock(handshake_stats_mutex);
+        ++stats.count;
+        if(ec)
+          ++stats.failed;
+        else if(SSL_session_reused(session->connection->socket->native_handle()))
+          ++stats.resumed;
+        stats.total_time += time;
+        stats.max_time = (std::max)(stats.max_time, time);
+      }
+
+      if(!ec) {
+        if(config.http2 && negotiated_http2(*session->connection->socket))
+          this->start_http2(session, 0);
+        else
+          this->read(session);
+      }
+      else if(this->on_error)
+        this->on_error(session->request, ec);
+    }
   };
 } // namespace SimpleWeb
 
@@ -171,6 +171,24 @@ namespace SimpleWeb {
     }
     return pos->second;
   }
+
+  /// Returns the HTTP/1.1 status line, including the ending CRLF, of the given status code.
+  /// The status lines are formatted once, and looked up by status code number.
+  inline const std::string &status_line(StatusCode status_code_enum) noexcept {
+    class StatusLines : public std::vector<std::string> {
+    public:
+      StatusLines() : std::vector<std::string>(600) {
+        for(auto &status_code : status_code_strings())
+          (*this)[static_cast<std::size_t>(status_code.first)] = "HTTP/1.1 " + status_code.second + "\r\n";
+      }
+    };
+    static StatusLines status_lines;
+
+    auto index = static_cast<std::size_t>(status_code_enum);
+    if(index >= status_lines.size() || status_lines[index].empty())
+      return status_lines[static_cast<std::size_t>(StatusCode::unknown)];
+    return status_lines[index];
+  }
 } // namespace SimpleWeb
 
 #endif // SIMPLE_WEB_STATUS_CODE_HPP
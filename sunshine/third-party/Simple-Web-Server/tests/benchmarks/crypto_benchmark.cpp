@@ -0,0 +1,120 @@
+#include "crypto.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+using namespace SimpleWeb;
+
+/// The OpenSSL BIO chain that Crypto::Base64 used before it had its own codec, kept as the baseline.
+namespace bio {
+  string encode(const string &input) {
+    string base64;
+
+    BIO *bio, *b64;
+    auto bptr = BUF_MEM_new();
+
+    b64 = BIO_new(BIO_f_base64());
+    BIO_set_flags(b64, BIO_FLAGS_BASE64_NO_NL);
+    bio = BIO_new(BIO_s_mem());
+    BIO_push(b64, bio);
+    BIO_set_mem_buf(b64, bptr, BIO_CLOSE);
+
+    base64.resize(Crypto::Base64::encoded_length(input.size()));
+    bptr->length = 0;
+    bptr->max = base64.size() + 1;
+    bptr->data = &base64[0];
+
+    if(BIO_write(b64, &input[0], static_cast<int>(input.size())) <= 0 || BIO_flush(b64) <= 0)
+      base64.clear();
+
+    bptr->length = 0;
+    bptr->max = 0;
+    bptr->data = nullptr;
+
+    BIO_free_all(b64);
+
+    return base64;
+  }
+
+  string decode(const string &base64) {
+    string ascii((6 * base64.size()) / 8, '\0');
+
+    BIO *b64, *bio;
+
+    b64 = BIO_new(BIO_f_base64());
+    BIO_set_flags(b64, BIO_FLAGS_BASE64_NO_NL);
+    bio = BIO_new_mem_buf(&base64[0], static_cast<int>(base64.size()));
+    bio = BIO_push(b64, bio);
+
+    auto decoded_length = BIO_read(bio, &ascii[0], static_cast<int>(ascii.size()));
+    if(decoded_length > 0)
+      ascii.resize(static_cast<size_t>(decoded_length));
+    else
+      ascii.clear();
+
+    BIO_free_all(b64);
+
+    return ascii;
+  }
+
+  string sha256(const string &input) {
+    string md(SHA256_DIGEST_LENGTH, '\0');
+
+    auto ctx = EVP_MD_CTX_create();
+    EVP_MD_CTX_init(ctx);
+    EVP_DigestInit_ex(ctx, EVP_sha256(), nullptr);
+    EVP_DigestUpdate(ctx, input.data(), input.size());
+    EVP_DigestFinal_ex(ctx, reinterpret_cast<unsigned char *>(&md[0]), nullptr);
+    EVP_MD_CTX_destroy(ctx);
+
+    return md;
+  }
+} // namespace bio
+
+/// Runs function for the given number of milliseconds and prints the achieved rate.
+void measure(const string &name, long milliseconds, const function<void()> &function) {
+  size_t calls = 0;
+  auto start_time = chrono::steady_clock::now();
+  auto end_time = start_time + chrono::milliseconds(milliseconds);
+  while(chrono::steady_clock::now() < end_time) {
+    for(int i = 0; i < 100; ++i)
+      function();
+    calls += 100;
+  }
+  auto seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+  cout << left << setw(36) << name << right << setw(12) << static_cast<size_t>(static_cast<double>(calls) / seconds) << " calls/s" << endl;
+}
+
+int main(int argc, char *argv[]) {
+  long milliseconds = argc > 1 ? atol(argv[1]) : 1000;
+
+  volatile size_t sink = 0;
+  for(size_t size : vector<size_t>{32, 256, 4096}) {
+    string input;
+    for(size_t i = 0; i < size; ++i)
+      input += static_cast<char>(i * 131 + 7);
+    auto base64 = Crypto::Base64::encode(input);
+    if(bio::encode(input) != base64 || bio::decode(base64) != input) {
+      cerr << "Base64 codecs disagree" << endl;
+      return 1;
+    }
+    vector<char> buffer(Crypto::Base64::encoded_length(size));
+
+    cout << size << " bytes:" << endl;
+    measure("  base64 encode, BIO", milliseconds, [&] { sink += bio::encode(input).size(); });
+    measure("  base64 encode, string", milliseconds, [&] { sink += Crypto::Base64::encode(input).size(); });
+    measure("  base64 encode, buffer", milliseconds, [&] { sink += Crypto::Base64::encode(input.data(), input.size(), buffer.data()); });
+    measure("  base64 decode, BIO", milliseconds, [&] { sink += bio::decode(base64).size(); });
+    measure("  base64 decode, string", milliseconds, [&] { sink += Crypto::Base64::decode(base64).size(); });
+    measure("  base64 decode, buffer", milliseconds, [&] { sink += static_cast<size_t>(Crypto::Base64::decode(base64.data(), base64.size(), buffer.data())); });
+    measure("  sha256, EVP_MD_CTX", milliseconds, [&] { sink += bio::sha256(input).size(); });
+    measure("  sha256, string", milliseconds, [&] { sink += Crypto::sha256(input).size(); });
+    measure("  sha256, buffer", milliseconds, [&] {
+      unsigned char digest[SHA256_DIGEST_LENGTH];
+      sink += Crypto::message_digest(input.data(), input.size(), EVP_sha256(), digest);
+    });
+  }
+}
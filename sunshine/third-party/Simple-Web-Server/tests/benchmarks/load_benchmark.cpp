@@ -0,0 +1,250 @@
+#include "client_http.hpp"
+#include "server_http.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <future>
+#include <iomanip>
+#include <iostream>
+
+#ifdef HAVE_OPENSSL
+#include "client_https.hpp"
+#include "server_https.hpp"
+#include <cstdio>
+#include <openssl/pem.h>
+#include <openssl/x509.h>
+#endif
+
+using namespace std;
+using namespace SimpleWeb;
+
+/// Number of seconds each configuration is measured, connections and client threads driving the server.
+struct Options {
+  long seconds = 3;
+  size_t connections = 16;
+  size_t client_threads = 4;
+};
+
+struct ServerConfiguration {
+  string name;
+  size_t thread_pool_size;
+  bool io_context_per_thread;
+};
+
+static const string echo_content(1024, 'x');
+
+template <class server_type>
+void add_resources(server_type &server) {
+  // Small response like a host info query
+  server.resource["^/serverinfo$"]["GET"] = [](shared_ptr<typename server_type::Response> response, shared_ptr<typename server_type::Request> /*request*/) {
+    response->write("<?xml version=\"1.0\" encoding=\"utf-8\"?><root status_code=\"200\"><hostname>benchmark</hostname><state>idle</state></root>",
+                    {{"Content-Type", "application/xml"}});
+  };
+  // Resource found through its regex, with a header and query string to parse
+  server.resource["^/api/apps/([0-9]+)$"]["GET"] = [](shared_ptr<typename server_type::Response> response, shared_ptr<typename server_type::Request> request) {
+    auto query = request->parse_query_string();
+    response->write("{\"id\":" + request->path_match[1].str() + ",\"name\":\"" + query.find("name")->second + "\"}", {{"Content-Type", "application/json"}});
+  };
+  // Request content returned in the response
+  server.resource["^/echo$"]["POST"] = [](shared_ptr<typename server_type::Response> response, shared_ptr<typename server_type::Request> request) {
+    response->write(request->content.string());
+  };
+}
+
+/// Results of one configuration, latencies in microseconds.
+struct Result {
+  size_t requests = 0;
+  size_t errors = 0;
+  double seconds = 0;
+  vector<long> latencies;
+};
+
+template <class client_type>
+class Driver {
+public:
+  Driver(const Options &options, function<client_type *(const string &)> make_client, const string &host_port) : options(options) {
+    io_service = make_shared<io_context>();
+    for(size_t c = 0; c < options.connections; ++c) {
+      clients.emplace_back(make_client(host_port));
+      clients.back()->io_service = io_service;
+      latencies.emplace_back();
+    }
+  }
+
+  Result run() {
+    end_time = chrono::steady_clock::now() + chrono::seconds(options.seconds);
+    auto start_time = chrono::steady_clock::now();
+    for(size_t c = 0; c < clients.size(); ++c)
+      request(c, c);
+
+    vector<thread> threads;
+    for(size_t c = 0; c < options.client_threads; ++c)
+      threads.emplace_back([this] { io_service->run(); });
+    for(auto &thread : threads)
+      thread.join();
+
+    Result result;
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+    result.errors = errors;
+    for(auto &client_latencies : latencies)
+      result.latencies.insert(result.latencies.end(), client_latencies.begin(), client_latencies.end());
+    result.requests = result.latencies.size();
+    return result;
+  }
+
+private:
+  const Options &options;
+  shared_ptr<io_context> io_service;
+  vector<unique_ptr<client_type>> clients;
+  vector<vector<long>> latencies; // One vector per client, each client has one request outstanding at a time
+  atomic<size_t> errors{0};
+  chrono::steady_clock::time_point end_time;
+
+  void request(size_t client_index, size_t request_number) {
+    auto start_time = chrono::steady_clock::now();
+    if(start_time >= end_time)
+      return;
+
+    auto callback = [this, client_index, request_number, start_time](shared_ptr<typename client_type::Response> response, const SimpleWeb::error_code &ec) {
+      if(!ec && response->status_code.compare(0, 3, "200") == 0)
+        latencies[client_index].emplace_back(chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start_time).count());
+      else
+        ++errors;
+      request(client_index, request_number + 1);
+    };
+
+    auto &client = *clients[client_index];
+    switch(request_number % 3) {
+    case 0:
+      client.request("GET", "/serverinfo", callback);
+      break;
+    case 1:
+      client.request("GET", "/api/apps/" + to_string(request_number % 100) + "?name=app", callback);
+      break;
+    default:
+      client.request("POST", "/echo", echo_content, callback);
+    }
+  }
+};
+
+long percentile(const vector<long> &sorted, double fraction) {
+  if(sorted.empty())
+    return 0;
+  return sorted[min(sorted.size() - 1, static_cast<size_t>(fraction * static_cast<double>(sorted.size())))];
+}
+
+void print_result(const string &protocol, const ServerConfiguration &configuration, Result result) {
+  sort(result.latencies.begin(), result.latencies.end());
+  cout << left << setw(6) << protocol << setw(28) << configuration.name << right
+       << setw(10) << static_cast<size_t>(static_cast<double>(result.requests) / result.seconds) << " req/s"
+       << "  p50 " << setw(6) << percentile(result.latencies, 0.5) << " us"
+       << "  p99 " << setw(6) << percentile(result.latencies, 0.99) << " us"
+       << "  p999 " << setw(6) << percentile(result.latencies, 0.999) << " us";
+  if(result.errors > 0)
+    cout << "  errors " << result.errors;
+  cout << endl;
+}
+
+template <class server_type, class client_type>
+void benchmark(const string &protocol, const Options &options, const vector<ServerConfiguration> &configurations,
+               function<server_type *()> make_server, function<client_type *(const string &)> make_client) {
+  for(auto &configuration : configurations) {
+    unique_ptr<server_type> server(make_server());
+    server->config.port = 0;
+    server->config.address = "127.0.0.1";
+    server->config.thread_pool_size = configuration.thread_pool_size;
+    server->config.io_context_per_thread = configuration.io_context_per_thread;
+    add_resources(*server);
+
+    promise<unsigned short> port;
+    thread server_thread([&server, &port] {
+      server->start([&port](unsigned short assigned_port) {
+        port.set_value(assigned_port);
+      });
+    });
+
+    {
+      Driver<client_type> driver(options, make_client, "127.0.0.1:" + to_string(port.get_future().get()));
+      print_result(protocol, configuration, driver.run());
+    }
+
+    server->stop();
+    server_thread.join();
+  }
+}
+
+#ifdef HAVE_OPENSSL
+/// Writes a self-signed certificate and its private key, so that no files are needed to run the benchmark.
+bool write_self_signed_certificate(const string &certificate_file, const string &private_key_file) {
+  bool success = false;
+  EVP_PKEY *private_key = nullptr;
+  X509 *certificate = nullptr;
+  auto context = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr);
+  if(context && EVP_PKEY_keygen_init(context) > 0 && EVP_PKEY_CTX_set_ec_paramgen_curve_nid(context, NID_X9_62_prime256v1) > 0 &&
+     EVP_PKEY_keygen(context, &private_key) > 0 && (certificate = X509_new())) {
+    X509_set_version(certificate, 2);
+    ASN1_INTEGER_set(X509_get_serialNumber(certificate), 1);
+    X509_gmtime_adj(X509_getm_notBefore(certificate), 0);
+    X509_gmtime_adj(X509_getm_notAfter(certificate), 24 * 60 * 60);
+    X509_set_pubkey(certificate, private_key);
+    auto name = X509_get_subject_name(certificate);
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char *>("localhost"), -1, -1, 0);
+    X509_set_issuer_name(certificate, name);
+    if(X509_sign(certificate, private_key, EVP_sha256()) > 0) {
+      auto file = fopen(certificate_file.c_str(), "w");
+      if(file) {
+        success = PEM_write_X509(file, certificate) > 0;
+        fclose(file);
+      }
+      file = fopen(private_key_file.c_str(), "w");
+      if(file) {
+        success = success && PEM_write_PrivateKey(file, private_key, nullptr, nullptr, 0, nullptr, nullptr) > 0;
+        fclose(file);
+      }
+    }
+  }
+  X509_free(certificate);
+  EVP_PKEY_free(private_key);
+  EVP_PKEY_CTX_free(context);
+  return success;
+}
+#endif
+
+/// Usage: sws_load_benchmark [seconds per configuration] [connections] [client threads]
+int main(int argc, char *argv[]) {
+  Options options;
+  if(argc > 1)
+    options.seconds = atol(argv[1]);
+  if(argc > 2)
+    options.connections = static_cast<size_t>(atol(argv[2]));
+  if(argc > 3)
+    options.client_threads = static_cast<size_t>(atol(argv[3]));
+
+  cout << options.connections << " keep-alive connections on " << options.client_threads << " client threads, "
+       << options.seconds << " seconds per configuration" << endl;
+
+  auto hardware_threads = max<size_t>(2, thread::hardware_concurrency());
+  vector<ServerConfiguration> configurations = {
+      {"1 thread", 1, false},
+      {to_string(hardware_threads) + " threads", hardware_threads, false},
+      {to_string(hardware_threads) + " threads, context/thread", hardware_threads, true}};
+
+  benchmark<Server<HTTP>, Client<HTTP>>(
+      "HTTP", options, configurations,
+      [] { return new Server<HTTP>(); },
+      [](const string &host_port) { return new Client<HTTP>(host_port); });
+
+#ifdef HAVE_OPENSSL
+  string certificate_file = "sws_load_benchmark.crt", private_key_file = "sws_load_benchmark.key";
+  if(!write_self_signed_certificate(certificate_file, private_key_file)) {
+    cerr << "Could not create a certificate, skipping HTTPS" << endl;
+    return 1;
+  }
+  benchmark<Server<HTTPS>, Client<HTTPS>>(
+      "HTTPS", options, configurations,
+      [&certificate_file, &private_key_file] { return new Server<HTTPS>(certificate_file, private_key_file); },
+      [](const string &host_port) { return new Client<HTTPS>(host_port, false); });
+  remove(certificate_file.c_str());
+  remove(private_key_file.c_str());
+#endif
+}
@@ -36,8 +36,22 @@ int main() {
   for(auto &string_test : base64_string_tests) {
     ASSERT(Crypto::Base64::encode(string_test.first) == string_test.second);
     ASSERT(Crypto::Base64::decode(string_test.second) == string_test.first);
+
+    // Caller-provided buffers, and input without padding
+    vector<char> buffer(Crypto::Base64::decoded_max_length(string_test.second.size()) + Crypto::Base64::encoded_length(string_test.first.size()));
+    ASSERT(Crypto::Base64::encode(string_test.first.data(), string_test.first.size(), buffer.data()) == string_test.second.size());
+    ASSERT(string(buffer.data(), string_test.second.size()) == string_test.second);
+    auto unpadded = string_test.second.substr(0, string_test.second.find('='));
+    ASSERT(Crypto::Base64::decode(unpadded.data(), unpadded.size(), buffer.data()) == static_cast<long>(string_test.first.size()));
+    ASSERT(string(buffer.data(), string_test.first.size()) == string_test.first);
   }
 
+  char buffer[8];
+  ASSERT(Crypto::Base64::decode("Zm9v!A==", 8, buffer) == -1);
+  ASSERT(Crypto::Base64::decode("Zm9vY", 5, buffer) == -1);
+  ASSERT(Crypto::Base64::decode("Zg=", 3, buffer) == -1);
+  ASSERT(Crypto::Base64::decode("Zm9v YmFy") == "");
+
   for(auto &string_test : md5_string_tests) {
     ASSERT(Crypto::to_hex_string(Crypto::md5(string_test.first)) == string_test.second);
     stringstream ss(string_test.first);
@@ -62,6 +76,11 @@ int main() {
     ASSERT(Crypto::to_hex_string(Crypto::sha512(ss)) == string_test.second);
   }
 
+  // Digests written to caller-provided buffers
+  unsigned char digest[SHA256_DIGEST_LENGTH];
+  ASSERT(Crypto::message_digest("abc", 3, EVP_sha256(), digest));
+  ASSERT(Crypto::to_hex_string(string(reinterpret_cast<char *>(digest), sizeof(digest))) == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+
   // Testing iterations
   ASSERT(Crypto::to_hex_string(Crypto::sha1("Test", 1)) == "640ab2bae07bedc4c163f679a746f7ab7fb5d1fa");
   ASSERT(Crypto::to_hex_string(Crypto::sha1("Test", 2)) == "af31c6cbdecd88726d0a9b3798c71ef41f1624d5");
@@ -0,0 +1,157 @@
+#include "assert.hpp"
+#include "client_http.hpp"
+#include "file_cache.hpp"
+#include "server_http.hpp"
+#include <cstdio>
+#include <utime.h>
+
+using namespace std;
+using namespace SimpleWeb;
+
+using HttpServer = Server<HTTP>;
+using HttpClient = Client<HTTP>;
+
+static void write_file(const string &path, const string &content, time_t modified) {
+  {
+    ofstream ofs(path, ios::binary | ios::trunc);
+    ofs << content;
+  }
+  utimbuf times;
+  times.actime = modified;
+  times.modtime = modified;
+  utime(path.c_str(), &times);
+}
+
+int main() {
+  auto path = string("sws_file_cache_test.txt");
+  time_t modified = 1000000000;
+  write_file(path, "identity content", modified);
+  remove((path + ".br").c_str());
+  remove((path + ".gz").c_str());
+
+  // Test matching If-None-Match field values
+  {
+    ASSERT(FileCache::matches("\"abc\"", "\"abc\""));
+    ASSERT(FileCache::matches("W/\"abc\"", "\"abc\""));
+    ASSERT(FileCache::matches("\"x\", \"abc\"", "\"abc\""));
+    ASSERT(FileCache::matches("*", "\"abc\""));
+    ASSERT(!FileCache::matches("\"abcd\"", "\"abc\""));
+    ASSERT(!FileCache::matches("", "\"abc\""));
+    ASSERT(!FileCache::matches("\"ab", "\"abc\""));
+  }
+
+  // Test reloading entries when the file or its variants change
+  {
+    FileCache cache;
+    SimpleWeb::error_code ec;
+    auto entry = cache.get(path, ec);
+    ASSERT(!ec && entry);
+    ASSERT(*entry->identity.content == "identity content");
+    ASSERT(entry->identity.etag.size() > 2 && entry->identity.etag.front() == '"' && entry->identity.etag.back() == '"');
+    ASSERT(!entry->brotli.content && !entry->gzip.content);
+    ASSERT(entry->last_modified == "Sun, 09 Sep 2001 01:46:40 GMT");
+    ASSERT(cache.get(path, ec) == entry);
+
+    write_file(path, "changed content!", modified + 1);
+    auto changed = cache.get(path, ec);
+    ASSERT(!ec && changed && changed != entry);
+    ASSERT(*changed->identity.content == "changed content!");
+    ASSERT(changed->identity.etag != entry->identity.etag);
+
+    write_file(path + ".br", "brotli", modified + 1);
+    write_file(path + ".gz", "gzip", modified);
+    auto compressed = cache.get(path, ec);
+    ASSERT(!ec && compressed && compressed != changed);
+    ASSERT(compressed->brotli.content && *compressed->brotli.content == "brotli" && compressed->brotli.encoding == "br");
+    // The gzip variant is older than the file
+    ASSERT(!compressed->gzip.content);
+    ASSERT(compressed->brotli.etag != compressed->identity.etag);
+
+    ASSERT(!cache.get(path + ".missing", ec) && ec);
+  }
+
+  // Test selecting representations according to Accept-Encoding
+  {
+    write_file(path + ".gz", "gzip", modified + 1);
+    FileCache cache;
+    SimpleWeb::error_code ec;
+    auto entry = cache.get(path, ec);
+    ASSERT(entry && entry->brotli.content && entry->gzip.content);
+    ASSERT(&entry->select({}) == &entry->identity);
+    ASSERT(&entry->select({{"Accept-Encoding", "gzip, deflate, br"}}) == &entry->brotli);
+    ASSERT(&entry->select({{"Accept-Encoding", "gzip"}}) == &entry->gzip);
+    ASSERT(&entry->select({{"Accept-Encoding", "br;q=0.5, gzip;q=0.8"}}) == &entry->gzip);
+    ASSERT(&entry->select({{"Accept-Encoding", "br;q=0, gzip;q=0"}}) == &entry->identity);
+    ASSERT(&entry->select({{"Accept-Encoding", "*"}}) == &entry->brotli);
+    ASSERT(&entry->select({{"Accept-Encoding", "identity"}}) == &entry->identity);
+  }
+
+  // Test eviction of least recently used entries, and files larger than max_file_size
+  {
+    auto other = path + ".other";
+    write_file(other, "other content", modified);
+    FileCache cache(30, 20);
+    SimpleWeb::error_code ec;
+    auto entry = cache.get(path, ec);
+    auto other_entry = cache.get(other, ec);
+    ASSERT(entry && other_entry);
+    // Both entries sum to more than 30 bytes, so the first one was evicted
+    ASSERT(cache.get(other, ec) == other_entry);
+    ASSERT(cache.get(path, ec) != entry);
+
+    write_file(other, string(21, 'a'), modified);
+    ASSERT(!cache.get(other, ec) && !ec);
+    remove(other.c_str());
+  }
+
+  // Test responses
+  {
+    HttpServer server;
+    server.config.port = 8091;
+    FileCache cache;
+    server.resource["^/file$"]["GET"] = [&cache, &path](shared_ptr<HttpServer::Response> response, shared_ptr<HttpServer::Request> request) {
+      SimpleWeb::error_code ec;
+      auto entry = cache.get(path, ec);
+      ASSERT(entry);
+      FileCache::write(response, *entry, request->header, {{"Content-Type", "text/plain"}});
+    };
+    thread server_thread([&server]() {
+      server.start();
+    });
+    this_thread::sleep_for(chrono::seconds(1));
+
+    HttpClient client("localhost:8091");
+    auto r = client.request("GET", "/file");
+    ASSERT(r->status_code == "200 OK");
+    ASSERT(r->content.string() == "changed content!");
+    ASSERT(r->header.find("Content-Encoding") == r->header.end());
+    ASSERT(r->header.find("Vary")->second == "Accept-Encoding");
+    ASSERT(r->header.find("Content-Type")->second == "text/plain");
+    auto etag = r->header.find("ETag")->second;
+
+    r = client.request("GET", "/file", "", {{"If-None-Match", etag}});
+    ASSERT(r->status_code == "304 Not Modified");
+    ASSERT(r->content.string().empty());
+    ASSERT(r->header.find("ETag")->second == etag);
+
+    r = client.request("GET", "/file", "", {{"Accept-Encoding", "gzip, br"}});
+    ASSERT(r->status_code == "200 OK");
+    ASSERT(r->content.string() == "brotli");
+    ASSERT(r->header.find("Content-Encoding")->second == "br");
+    auto br_etag = r->header.find("ETag")->second;
+    ASSERT(br_etag != etag);
+
+    // The identity ETag does not match the brotli representation
+    r = client.request("GET", "/file", "", {{"Accept-Encoding", "br"}, {"If-None-Match", etag}});
+    ASSERT(r->status_code == "200 OK");
+    r = client.request("GET", "/file", "", {{"Accept-Encoding", "br"}, {"If-None-Match", br_etag}});
+    ASSERT(r->status_code == "304 Not Modified");
+
+    server.stop();
+    server_thread.join();
+  }
+
+  remove(path.c_str());
+  remove((path + ".br").c_str());
+  remove((path + ".gz").c_str());
+}
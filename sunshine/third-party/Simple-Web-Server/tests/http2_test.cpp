@@ -0,0 +1,202 @@
+#include "assert.hpp"
+#include "http2.hpp"
+#include "server_http.hpp"
+#include <map>
+#include <set>
+
+using namespace std;
+using namespace SimpleWeb;
+
+using HttpServer = Server<HTTP>;
+using Field = Http2::Hpack::Field;
+
+static string bytes(const vector<unsigned char> &data) {
+  return string(data.begin(), data.end());
+}
+
+static bool decode(Http2::Hpack::Decoder &decoder, const string &block, vector<Field> &fields) {
+  fields.clear();
+  return decoder.decode(reinterpret_cast<const unsigned char *>(block.data()), block.size(), fields);
+}
+
+class Frame {
+public:
+  Http2::FrameHeader header;
+  string payload;
+};
+
+static Frame read_frame(asio::ip::tcp::socket &socket) {
+  unsigned char header[9];
+  asio::read(socket, asio::buffer(header, sizeof(header)));
+  Frame frame;
+  frame.header = Http2::FrameHeader::parse(header);
+  frame.payload.resize(frame.header.length);
+  if(frame.header.length > 0)
+    asio::read(socket, asio::buffer(&frame.payload[0], frame.payload.size()));
+  return frame;
+}
+
+static void write_headers(asio::ip::tcp::socket &socket, Http2::Hpack::Encoder &encoder, uint32_t stream_id, const vector<Field> &fields, bool end_stream) {
+  string block;
+  encoder.encode(fields, block);
+  string frame;
+  Http2::FrameHeader(static_cast<uint32_t>(block.size()), Http2::FrameType::headers, Http2::end_headers | (end_stream ? Http2::end_stream : 0), stream_id).write(frame);
+  asio::write(socket, asio::buffer(frame + block));
+}
+
+int main() {
+  // Test Huffman coding with RFC 7541 C.4.1
+  {
+    string encoded;
+    Http2::Hpack::huffman_encode("www.example.com", encoded);
+    ASSERT(encoded == bytes({0xf1, 0xe3, 0xc2, 0xe5, 0xf2, 0x3a, 0x6b, 0xa0, 0xab, 0x90, 0xf4, 0xff}));
+    ASSERT(Http2::Hpack::huffman_encoded_size("www.example.com") == encoded.size());
+
+    string decoded;
+    ASSERT(Http2::Hpack::huffman_decode(reinterpret_cast<const unsigned char *>(encoded.data()), encoded.size(), decoded));
+    ASSERT(decoded == "www.example.com");
+
+    string all;
+    for(int c = 0; c < 256; ++c)
+      all += static_cast<char>(c);
+    encoded.clear();
+    decoded.clear();
+    Http2::Hpack::huffman_encode(all, encoded);
+    ASSERT(Http2::Hpack::huffman_decode(reinterpret_cast<const unsigned char *>(encoded.data()), encoded.size(), decoded));
+    ASSERT(decoded == all);
+
+    // Padding longer than 7 bits, or not made of ones, is an error
+    decoded.clear();
+    ASSERT(!Http2::Hpack::huffman_decode(reinterpret_cast<const unsigned char *>("\xff\xff"), 2, decoded));
+    ASSERT(!Http2::Hpack::huffman_decode(reinterpret_cast<const unsigned char *>("\x00"), 1, decoded));
+  }
+
+  // Test decoding the requests of RFC 7541 C.4, which use the dynamic table
+  {
+    Http2::Hpack::Decoder decoder;
+    vector<Field> fields;
+    ASSERT(decode(decoder, bytes({0x82, 0x86, 0x84, 0x41, 0x8c, 0xf1, 0xe3, 0xc2, 0xe5, 0xf2, 0x3a, 0x6b, 0xa0, 0xab, 0x90, 0xf4, 0xff}), fields));
+    ASSERT(fields == vector<Field>({{":method", "GET"}, {":scheme", "http"}, {":path", "/"}, {":authority", "www.example.com"}}));
+
+    ASSERT(decode(decoder, bytes({0x82, 0x86, 0x84, 0xbe, 0x58, 0x86, 0xa8, 0xeb, 0x10, 0x64, 0x9c, 0xbf}), fields));
+    ASSERT(fields == vector<Field>({{":method", "GET"}, {":scheme", "http"}, {":path", "/"}, {":authority", "www.example.com"}, {"cache-control", "no-cache"}}));
+
+    ASSERT(decode(decoder, bytes({0x82, 0x87, 0x85, 0xbf, 0x40, 0x88, 0x25, 0xa8, 0x49, 0xe9, 0x5b, 0xa9, 0x7d, 0x7f, 0x89, 0x25, 0xa8, 0x49, 0xe9, 0x5b, 0xb8, 0xe8, 0xb4, 0xbf}), fields));
+    ASSERT(fields == vector<Field>({{":method", "GET"}, {":scheme", "https"}, {":path", "/index.html"}, {":authority", "www.example.com"}, {"custom-key", "custom-value"}}));
+
+    // Index 0, an index past the tables, and a truncated integer
+    ASSERT(!decode(decoder, bytes({0x80}), fields));
+    ASSERT(!decode(decoder, bytes({0xff, 0x80}), fields));
+  }
+
+  // Test that the encoder and decoder keep their dynamic tables in sync
+  {
+    Http2::Hpack::Encoder encoder;
+    Http2::Hpack::Decoder decoder;
+    vector<Field> response = {{":status", "200"}, {"content-type", "application/json"}, {"server", "test"}, {"content-length", "12"}, {"set-cookie", "id=1"}};
+    string first, second;
+    encoder.encode(response, first);
+    encoder.encode(response, second);
+    // Repeated fields are indexed, except those that differ between responses
+    ASSERT(second.size() < first.size());
+
+    vector<Field> fields;
+    ASSERT(decode(decoder, first, fields) && fields == response);
+    ASSERT(decode(decoder, second, fields) && fields == response);
+
+    encoder.set_max_table_size(0);
+    string third;
+    encoder.encode(response, third);
+    ASSERT(decode(decoder, third, fields) && fields == response);
+  }
+
+  // Test serving interleaved streams with prior knowledge
+  {
+    HttpServer server;
+    server.config.port = 8090;
+    server.config.http2 = true;
+    server.resource["^/info$"]["GET"] = [](shared_ptr<HttpServer::Response> response, shared_ptr<HttpServer::Request> request) {
+      response->write(request->method + ' ' + request->path + ' ' + request->query_string + ' ' + request->http_version + ' ' + request->header.find("Host")->second);
+    };
+    server.resource["^/string$"]["POST"] = [](shared_ptr<HttpServer::Response> response, shared_ptr<HttpServer::Request> request) {
+      response->write(request->content.string(), {{"Connection", "keep-alive"}});
+    };
+    server.resource["^/large$"]["GET"] = [](shared_ptr<HttpServer::Response> response, shared_ptr<HttpServer::Request> /*request*/) {
+      response->write(string(100000, 'a'));
+    };
+    server.resource["^/chunked$"]["GET"] = [](shared_ptr<HttpServer::Response> response, shared_ptr<HttpServer::Request> /*request*/) {
+      *response << "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n4\r\ntest\r\n0\r\n\r\n";
+    };
+    thread server_thread([&server]() {
+      server.start();
+    });
+    this_thread::sleep_for(chrono::seconds(1));
+
+    io_context io_service;
+    asio::ip::tcp::socket socket(io_service);
+    socket.connect(asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), 8090));
+
+    string preface = Http2::client_preface();
+    Http2::append_settings(preface, {});
+    asio::write(socket, asio::buffer(preface));
+
+    Http2::Hpack::Encoder encoder;
+    Http2::Hpack::Decoder decoder;
+    write_headers(socket, encoder, 1, {{":method", "GET"}, {":scheme", "http"}, {":path", "/large"}}, true);
+    write_headers(socket, encoder, 3, {{":method", "GET"}, {":scheme", "http"}, {":path", "/info?a=b"}, {":authority", "localhost:8090"}}, true);
+    write_headers(socket, encoder, 5, {{":method", "POST"}, {":scheme", "http"}, {":path", "/string"}}, false);
+    string data;
+    Http2::FrameHeader(7, Http2::FrameType::data, Http2::end_stream, 5).write(data);
+    data += "content";
+    asio::write(socket, asio::buffer(data));
+    write_headers(socket, encoder, 7, {{":method", "GET"}, {":scheme", "http"}, {":path", "/chunked"}}, true);
+    write_headers(socket, encoder, 9, {{":method", "GET"}, {":scheme", "http"}, {":path", "/unknown"}}, true);
+
+    map<uint32_t, string> statuses, contents;
+    set<uint32_t> ended, reset;
+    bool settings_acknowledged = false;
+    std::size_t received = 0;
+    while(ended.size() + reset.size() < 5) {
+      auto frame = read_frame(socket);
+      auto id = frame.header.stream_id;
+      if(frame.header.type == Http2::FrameType::settings && (frame.header.flags & Http2::ack))
+        settings_acknowledged = true;
+      else if(frame.header.type == Http2::FrameType::headers) {
+        ASSERT(frame.header.flags & Http2::end_headers);
+        vector<Field> fields;
+        ASSERT(decode(decoder, frame.payload, fields));
+        ASSERT(fields.size() > 0 && fields[0].first == ":status");
+        for(auto &field : fields)
+          ASSERT(field.first != "connection" && field.first != "transfer-encoding");
+        statuses[id] = fields[0].second;
+      }
+      else if(frame.header.type == Http2::FrameType::data) {
+        ASSERT(frame.payload.size() <= Http2::default_max_frame_size());
+        contents[id] += frame.payload;
+        received += frame.payload.size();
+        // The large response exceeds the initial window of the connection
+        if(received >= 60000 && frame.payload.size() > 0) {
+          string window_update;
+          Http2::append_frame(window_update, Http2::FrameType::window_update, 0, static_cast<uint32_t>(received));
+          Http2::append_frame(window_update, Http2::FrameType::window_update, 1, static_cast<uint32_t>(received));
+          asio::write(socket, asio::buffer(window_update));
+          received = 0;
+        }
+      }
+      else if(frame.header.type == Http2::FrameType::rst_stream)
+        reset.emplace(id);
+      if((frame.header.type == Http2::FrameType::headers || frame.header.type == Http2::FrameType::data) && (frame.header.flags & Http2::end_stream))
+        ended.emplace(id);
+    }
+
+    ASSERT(settings_acknowledged);
+    ASSERT(statuses[1] == "200" && contents[1] == string(100000, 'a'));
+    ASSERT(statuses[3] == "200" && contents[3] == "GET /info a=b 2.0 localhost:8090");
+    ASSERT(statuses[5] == "200" && contents[5] == "content");
+    ASSERT(statuses[7] == "200" && contents[7] == "test");
+    ASSERT(reset.count(9) == 1);
+
+    server.stop();
+    server_thread.join();
+  }
+}
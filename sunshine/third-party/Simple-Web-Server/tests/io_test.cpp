@@ -1,13 +1,30 @@
 #include "assert.hpp"
 #include "client_http.hpp"
 #include "server_http.hpp"
+#include <cstdio>
 #include <future>
+#include <set>
 
 using namespace std;
 
 using HttpServer = SimpleWeb::Server<SimpleWeb::HTTP>;
 using HttpClient = SimpleWeb::Client<SimpleWeb::HTTP>;
 
+// Reads the request content part by part, and echoes it when all the content has been read
+void read_stream(const shared_ptr<HttpServer::Response> &response, const shared_ptr<HttpServer::Request> &request, const shared_ptr<string> &content) {
+  request->read_content([response, request, content](const SimpleWeb::error_code &ec, size_t size) {
+    ASSERT(!ec);
+    if(size == 0) {
+      response->write(*content);
+      return;
+    }
+    ASSERT(size <= 1000);
+    ASSERT(request->content.size() == size);
+    *content += request->content.string();
+    read_stream(response, request, content);
+  });
+}
+
 int main() {
   // Test ScopeRunner
   {
@@ -54,6 +71,7 @@ int main() {
 
   HttpServer server;
   server.config.port = 8080;
+  server.config.content_part_size = 1000;
 
   server.resource["^/string$"]["POST"] = [](shared_ptr<HttpServer::Response> response, shared_ptr<HttpServer::Request> request) {
     auto content = request->content.string();
@@ -225,6 +243,36 @@ int main() {
     response->write(long_response, {{"name", "value"}});
   };
 
+  auto shared_response = make_shared<const std::string>("A shared string");
+  server.resource["^/buffers$"]["GET"] = [shared_response](shared_ptr<HttpServer::Response> response, shared_ptr<HttpServer::Request> /*request*/) {
+    response->write(SimpleWeb::StatusCode::success_ok, shared_response);
+  };
+
+  std::string file_content;
+  for(int c = 0; c < 50000; ++c)
+    file_content += to_string(c);
+  auto file = tmpfile();
+  ASSERT(file);
+  ASSERT(fwrite(file_content.data(), 1, file_content.size(), file) == file_content.size());
+  ASSERT(fflush(file) == 0);
+  auto file_handle = fileno(file);
+  server.resource["^/file$"]["GET"] = [file_handle, &file_content](shared_ptr<HttpServer::Response> response, shared_ptr<HttpServer::Request> /*request*/) {
+    response->write_file(SimpleWeb::StatusCode::success_ok, file_handle, 5, file_content.size() - 5);
+  };
+  server.resource["^/mixed$"]["GET"] = [file_handle, shared_response](shared_ptr<HttpServer::Response> response, shared_ptr<HttpServer::Request> /*request*/) {
+    auto parts = make_shared<std::vector<std::string>>(std::vector<std::string>{"first ", "second "});
+    *response << "HTTP/1.1 200 OK\r\nContent-Length: " << 6 + (*parts)[0].size() + (*parts)[1].size() + shared_response->size() + 10 + 4 << "\r\n\r\nstart ";
+    using namespace SimpleWeb; // For asio, both standalone and from Boost
+    response->write_buffers({asio::buffer((*parts)[0]), asio::buffer((*parts)[1]), asio::buffer(*shared_response)}, parts);
+    response->write_file(file_handle, 0, 10);
+    *response << " end";
+  };
+
+  server.stream_resource["^/stream$"]["POST"] = [](shared_ptr<HttpServer::Response> response, shared_ptr<HttpServer::Request> request) {
+    ASSERT(request->content.size() == 0);
+    read_stream(response, request, make_shared<string>());
+  };
+
   thread server_thread([&server]() {
     // Start server
     server.start();
@@ -322,6 +370,21 @@ int main() {
       auto r = client.request("POST", "/chunked", "6\r\nSimple\r\n3\r\nWeb\r\nE\r\n in\r\n\r\nchunks.\r\n0\r\n\r\n", {{"Transfer-Encoding", "chunked"}});
       ASSERT(r->content.string() == "SimpleWeb in\r\n\r\nchunks.");
     }
+    {
+      string content;
+      for(size_t c = 0; c < 100000; ++c)
+        content += static_cast<char>('a' + c % 26);
+      auto r = client.request("POST", "/stream", content);
+      ASSERT(r->content.string() == content);
+      r = client.request("POST", "/stream", "6\r\nSimple\r\n3\r\nWeb\r\nE\r\n in\r\n\r\nchunks.\r\n0\r\n\r\n", {{"Transfer-Encoding", "chunked"}});
+      ASSERT(r->content.string() == "SimpleWeb in\r\n\r\nchunks.");
+      string chunked_content = "7d0\r\n" + content.substr(0, 2000) + "\r\n1\r\nx\r\n0\r\n\r\n";
+      r = client.request("POST", "/stream", chunked_content, {{"Transfer-Encoding", "chunked"}});
+      ASSERT(r->content.string() == content.substr(0, 2000) + "x");
+      r = client.request("POST", "/stream");
+      ASSERT(r->content.string().empty());
+      ASSERT(client.connections.size() == 1);
+    }
     {
       auto r = client.request("POST", "/chunked2", "258\r\nHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorld\r\n0\r\n\r\n", {{"Transfer-Encoding", "chunked"}});
       ASSERT(r->content.string() == "HelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorldHelloWorld");
@@ -399,6 +462,33 @@ int main() {
     }
   }
 
+  // Test zero-copy responses
+  {
+    HttpClient client("localhost:8080");
+    {
+      auto r = client.request("GET", "/buffers");
+      ASSERT(SimpleWeb::status_code(r->status_code) == SimpleWeb::StatusCode::success_ok);
+      ASSERT(r->content.string() == "A shared string");
+    }
+    {
+      auto r = client.request("GET", "/file");
+      ASSERT(SimpleWeb::status_code(r->status_code) == SimpleWeb::StatusCode::success_ok);
+      ASSERT(r->content.string() == file_content.substr(5));
+    }
+    {
+      auto r = client.request("GET", "/mixed");
+      ASSERT(SimpleWeb::status_code(r->status_code) == SimpleWeb::StatusCode::success_ok);
+      ASSERT(r->content.string() == "start first second A shared string" + file_content.substr(0, 10) + " end");
+    }
+    {
+      // The connection is reused after a file response
+      auto r = client.request("GET", "/file");
+      ASSERT(r->content.string() == file_content.substr(5));
+      r = client.request("POST", "/string", "A string");
+      ASSERT(r->content.string() == "A string");
+    }
+  }
+
   // Test large responses
   {
     {
@@ -572,6 +662,52 @@ int main() {
         ASSERT(call);
     }
 
+    // Test bounded connection pool
+    {
+      HttpClient client("localhost:8080");
+      client.config.max_connections = 3;
+      client.config.max_idle_connections = 2;
+      vector<int> calls(20, 0);
+      for(size_t c = 0; c < 20; ++c) {
+        client.request("GET", "/match/123", [c, &client, &calls](shared_ptr<HttpClient::Response> response, const SimpleWeb::error_code &ec) {
+          ASSERT(!ec);
+          ASSERT(response->content.string() == "123");
+          ASSERT(client.connections.size() <= 3);
+          calls[c] = 1;
+        });
+      }
+      ASSERT(client.connections.size() == 3);
+      client.io_service->run();
+      for(auto call : calls)
+        ASSERT(call);
+      ASSERT(client.connections.size() == 2);
+      auto stats = client.pool_stats();
+      ASSERT(stats.misses == 3);
+      ASSERT(stats.hits == 17);
+      ASSERT(stats.waits == 17);
+    }
+
+    // Test closing unused connections after idle_timeout
+    {
+      HttpClient client("localhost:8080");
+      client.config.idle_timeout = 1;
+      ASSERT(client.request("GET", "/match/123")->content.string() == "123");
+      {
+        SimpleWeb::LockGuard lock(client.connections_mutex);
+        ASSERT(client.connections.size() == 1);
+      }
+      this_thread::sleep_for(chrono::milliseconds(1500));
+      {
+        SimpleWeb::LockGuard lock(client.connections_mutex);
+        ASSERT(client.connections.empty());
+      }
+      ASSERT(client.request("GET", "/match/123")->content.string() == "123");
+      ASSERT(client.request("GET", "/match/123")->content.string() == "123");
+      auto stats = client.pool_stats();
+      ASSERT(stats.misses == 2);
+      ASSERT(stats.hits == 1);
+    }
+
     // Test concurrent synchronous request calls from same client
     {
       HttpClient client("localhost:8080");
@@ -744,4 +880,73 @@ int main() {
     ASSERT(client_catch);
     io_service->stop();
   }
+
+  // Test one io_context per thread
+  {
+    HttpServer server;
+    server.config.port = 8082;
+    server.config.thread_pool_size = 4;
+    server.config.io_context_per_thread = true;
+    server.resource["^/thread$"]["GET"] = [](shared_ptr<HttpServer::Response> response, shared_ptr<HttpServer::Request> /*request*/) {
+      stringstream id;
+      id << this_thread::get_id();
+      response->write(id.str());
+    };
+    thread server_thread([&server]() {
+      server.start();
+    });
+    this_thread::sleep_for(chrono::seconds(1));
+
+    set<string> threads;
+    for(size_t c = 0; c < 8; ++c) {
+      HttpClient client("localhost:8082");
+      auto thread = client.request("GET", "/thread")->content.string();
+      // Every request on a connection is handled by the same thread
+      for(size_t d = 0; d < 5; ++d)
+        ASSERT(client.request("GET", "/thread")->content.string() == thread);
+      threads.emplace(thread);
+    }
+    ASSERT(threads.size() == 4);
+
+    server.stop();
+    server_thread.join();
+  }
+
+  // Test closing connections after timeout_request
+  {
+    HttpServer server;
+    server.config.port = 8083;
+    server.config.timeout_request = 1;
+    server.resource["^/test$"]["GET"] = [](shared_ptr<HttpServer::Response> response, shared_ptr<HttpServer::Request> /*request*/) {
+      response->write("test");
+    };
+    thread server_thread([&server]() {
+      server.start();
+    });
+    this_thread::sleep_for(chrono::seconds(1));
+
+    {
+      // The timeout is cancelled by the response, and set again while waiting for the next request
+      HttpClient client("localhost:8083");
+      for(size_t c = 0; c < 3; ++c) {
+        ASSERT(client.request("GET", "/test")->content.string() == "test");
+        this_thread::sleep_for(chrono::milliseconds(500));
+      }
+    }
+
+    // Idle connection without request
+    SimpleWeb::io_context io_service;
+    SimpleWeb::asio::ip::tcp::socket socket(io_service);
+    socket.connect(SimpleWeb::asio::ip::tcp::endpoint(SimpleWeb::asio::ip::address_v4::loopback(), 8083));
+    auto start_time = chrono::steady_clock::now();
+    char data;
+    SimpleWeb::error_code ec;
+    socket.read_some(SimpleWeb::asio::buffer(&data, 1), ec);
+    ASSERT(ec == SimpleWeb::error::eof);
+    auto closed_after = chrono::steady_clock::now() - start_time;
+    ASSERT(closed_after >= chrono::milliseconds(900) && closed_after <= chrono::milliseconds(2500));
+
+    server.stop();
+    server_thread.join();
+  }
 }
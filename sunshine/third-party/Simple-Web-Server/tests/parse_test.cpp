@@ -2,6 +2,7 @@
 #include "client_http.hpp"
 #include "server_http.hpp"
 #include <iostream>
+#include <sstream>
 
 using namespace std;
 using namespace SimpleWeb;
@@ -337,5 +338,99 @@ int main() {
     }
   }
 
+  // Test incremental request parser
+  {
+    std::string request_message = "GET /launch?uniqueid=0123456789ABCDEF&appid=1&mode=1920x1080x60 HTTP/1.1\r\n"
+                                  "Host: 192.168.1.2:47984\r\n"
+                                  "User-Agent:  Moonlight\r\n"
+                                  "Accept: */*\r\n"
+                                  "Empty:\r\n"
+                                  "Connection: keep-alive\r\n"
+                                  "\r\n";
+    auto content = "content";
+
+    // Feeding one byte at a time, through a buffer that moves
+    {
+      RequestMessage::Parser parser;
+      std::string buffer;
+      for(std::size_t c = 0; c < request_message.size(); ++c) {
+        buffer += request_message[c];
+        std::string moved = buffer;
+        auto result = parser.parse(moved.data(), moved.size());
+        ASSERT(result == (c + 1 < request_message.size() ? RequestMessage::Parser::Result::incomplete : RequestMessage::Parser::Result::complete));
+      }
+      buffer += content;
+      ASSERT(parser.parse(buffer.data(), buffer.size()) == RequestMessage::Parser::Result::complete);
+      ASSERT(parser.size() == request_message.size());
+      ASSERT(parser.method() == "GET");
+      ASSERT(parser.path() == "/launch");
+      ASSERT(parser.query_string() == "uniqueid=0123456789ABCDEF&appid=1&mode=1920x1080x60");
+      ASSERT(parser.http_version() == "1.1");
+      ASSERT(parser.header_size() == 5);
+      StringRange value;
+      ASSERT(parser.find_header("user-agent", value) && value == "Moonlight");
+      ASSERT(parser.find_header("EMPTY", value) && value == "");
+      ASSERT(!parser.find_header("Content-Length", value));
+
+      std::stringstream stream(request_message + content);
+      std::string method, path, query_string, version;
+      CaseInsensitiveMultimap header, parser_header;
+      ASSERT(RequestMessage::parse(stream, method, path, query_string, version, header));
+      parser.header(parser_header);
+      ASSERT(parser_header == header);
+      ASSERT(parser.path().str() == path && parser.query_string().str() == query_string && parser.http_version().str() == version);
+    }
+
+    // More header fields than are stored inline
+    {
+      std::string message = "POST /pair HTTP/1.1\r\n";
+      for(int c = 0; c < 40; ++c)
+        message += "Field" + std::to_string(c) + ": " + std::to_string(c) + "\r\n";
+      message += "\r\n";
+      RequestMessage::Parser parser;
+      ASSERT(parser.parse(message.data(), message.size()) == RequestMessage::Parser::Result::complete);
+      ASSERT(parser.header_size() == 40);
+      StringRange value;
+      ASSERT(parser.find_header("field39", value) && value == "39");
+      ASSERT(parser.query_string().size == 0);
+      parser.reset();
+      ASSERT(parser.parse(request_message.data(), request_message.size()) == RequestMessage::Parser::Result::complete);
+      ASSERT(parser.method() == "GET" && parser.header_size() == 5);
+    }
+
+    {
+      RequestMessage::Parser parser;
+      std::string message = "GET /\r\n\r\n";
+      ASSERT(parser.parse(message.data(), message.size()) == RequestMessage::Parser::Result::error);
+      parser.reset();
+      message = "GET / FTP/1.1\r\n\r\n";
+      ASSERT(parser.parse(message.data(), message.size()) == RequestMessage::Parser::Result::error);
+    }
+
+    // Throughput compared to parsing from a stream
+    std::size_t iterations = 100000;
+    auto start = std::chrono::steady_clock::now();
+    for(std::size_t c = 0; c < iterations; ++c) {
+      std::stringstream stream(request_message);
+      std::string method, path, query_string, version;
+      CaseInsensitiveMultimap header;
+      RequestMessage::parse(stream, method, path, query_string, version, header);
+    }
+    auto stream_duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    std::size_t header_fields = 0;
+    for(std::size_t c = 0; c < iterations; ++c) {
+      RequestMessage::Parser parser;
+      parser.parse(request_message.data(), request_message.size());
+      header_fields += parser.header_size();
+    }
+    auto parser_duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    ASSERT(header_fields == iterations * 5);
+
+    std::cout << "Request parsing: " << iterations / stream_duration << " requests/s from stream, "
+              << iterations / parser_duration << " requests/s with RequestMessage::Parser" << std::endl;
+  }
+
   ASSERT(SimpleWeb::Date::to_string(std::chrono::system_clock::now()).size() == 29);
 }
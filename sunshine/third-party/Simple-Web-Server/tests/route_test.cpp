@@ -0,0 +1,94 @@
+#include "assert.hpp"
+#include "server_http.hpp"
+#include <chrono>
+#include <iostream>
+
+using namespace std;
+using namespace SimpleWeb;
+
+using HttpServer = Server<HTTP>;
+
+// Routes resources the way find_resource() did before the route table was added
+const HttpServer::resource_function *find_in_order(HttpServer &server, const string &method, const string &path, regex::smatch &path_match) {
+  for(auto &regex_method : server.resource) {
+    auto it = regex_method.second.find(method);
+    if(it != regex_method.second.end() && regex::regex_match(path, path_match, regex_method.first))
+      return &it->second;
+  }
+  return nullptr;
+}
+
+template <typename function_type>
+double nanoseconds_per_call(size_t iterations, const function_type &function) {
+  auto start = chrono::steady_clock::now();
+  for(size_t c = 0; c < iterations; ++c)
+    function();
+  return static_cast<double>(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count()) / iterations;
+}
+
+int main() {
+  HttpServer server;
+  auto add = [&server](const string &regex, const string &method) {
+    server.resource[regex][method] = [](shared_ptr<HttpServer::Response>, shared_ptr<HttpServer::Request>) {};
+  };
+
+  // A host API with many plain paths and a few parameterized ones
+  for(auto &path : {"serverinfo", "pair", "applist", "appasset", "launch", "resume", "cancel", "unpair", "pin", "api/pin",
+                    "api/apps", "api/logs", "api/config", "api/configLocale", "api/restart", "api/reset-display-device-persistence",
+                    "api/password", "api/clients/list", "api/clients/unpair", "api/clients/unpair-all", "api/covers/upload",
+                    "api/apps/close", "index.html", "apps", "clients", "config", "password", "troubleshooting", "welcome", "favicon.ico"}) {
+    add(string("^/") + path + "$", "GET");
+    add(string("^/") + path + "$", "POST");
+  }
+  add("^/api/apps/([0-9]+)$", "DELETE");
+  add("^/api/covers/([0-9]+)$", "GET");
+  add("^/assets\\/.+$", "GET");
+  add("^/images/sunshine\\.ico$", "GET");
+  add("^/x/(a|b)$", "GET");
+  add("^/y/z?$", "GET");
+  add("^/alt$|^/other$", "GET");
+  // Sorts before ^/applist$ and ^/appasset$, so it takes their PUT requests
+  add("^/a.*$", "PUT");
+
+  server.route_table.compile(server.resource);
+
+  vector<string> methods = {"GET", "POST", "PUT", "DELETE", "PATCH"};
+  vector<string> paths = {"/serverinfo", "/applist", "/appasset", "/api/apps", "/api/apps/", "/api/apps/12", "/api/apps/12a",
+                          "/api/covers/3", "/assets/index.js", "/assets/", "/images/sunshine.ico", "/images/sunshinexico",
+                          "/x/a", "/x/b", "/x/c", "/y/", "/y/z", "/y", "/alt", "/other", "/abc", "/", "", "/serverinfo/", "/SERVERINFO"};
+  for(auto &method : methods) {
+    for(auto &path : paths) {
+      regex::smatch expected_match, match;
+      auto expected = find_in_order(server, method, path, expected_match);
+      auto function = server.route_table.find(method, path, match);
+      ASSERT(function == expected);
+      if(function && match.size() > 0) {
+        ASSERT(match.size() == expected_match.size());
+        for(size_t c = 0; c < match.size(); ++c)
+          ASSERT(match[c] == expected_match[c]);
+      }
+    }
+  }
+
+  {
+    regex::smatch match;
+    ASSERT(server.route_table.find("PUT", "/applist", match) == &server.resource["^/a.*$"]["PUT"]);
+    ASSERT(server.route_table.find("DELETE", "/api/apps/12", match) == &server.resource["^/api/apps/([0-9]+)$"]["DELETE"]);
+    ASSERT(match[1] == "12");
+  }
+
+  // Routing micro-benchmark
+  size_t iterations = 20000;
+  for(auto &path : {"/serverinfo", "/applist", "/api/apps/12", "/unknown"}) {
+    string path_str = path;
+    auto in_order = nanoseconds_per_call(iterations, [&server, &path_str] {
+      regex::smatch match;
+      find_in_order(server, "GET", path_str, match);
+    });
+    auto route_table = nanoseconds_per_call(iterations, [&server, &path_str] {
+      regex::smatch match;
+      server.route_table.find("GET", path_str, match);
+    });
+    cout << "GET " << path << ": " << in_order << " ns in order, " << route_table << " ns with route table" << endl;
+  }
+}
@@ -29,4 +29,10 @@ int main() {
   ASSERT(status_code(StatusCode::server_error_gateway_timeout) == "504 Gateway Timeout");
   ASSERT(status_code("511 Network Authentication Required") == StatusCode::server_error_network_authentication_required);
   ASSERT(status_code(StatusCode::server_error_network_authentication_required) == "511 Network Authentication Required");
+
+  ASSERT(status_line(StatusCode::success_ok) == "HTTP/1.1 200 OK\r\n");
+  ASSERT(status_line(StatusCode::client_error_not_found) == "HTTP/1.1 404 Not Found\r\n");
+  ASSERT(status_line(StatusCode::server_error_network_authentication_required) == "HTTP/1.1 511 Network Authentication Required\r\n");
+  ASSERT(status_line(StatusCode::unknown) == "HTTP/1.1 \r\n");
+  ASSERT(status_line(static_cast<StatusCode>(950)) == "HTTP/1.1 \r\n");
 }
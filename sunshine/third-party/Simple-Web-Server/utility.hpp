@@ -2,15 +2,20 @@
 #define SIMPLE_WEB_UTILITY_HPP
 
 #include "status_code.hpp"
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 #include <iostream>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <tuple>
 #include <unordered_map>
+#include <vector>
 
 #ifndef SW_DEPRECATED
 #if defined(__GNUC__) || defined(__clang__)
@@ -65,6 +70,31 @@ namespace SimpleWeb {
 
   using CaseInsensitiveMultimap = std::unordered_multimap<std::string, std::string, CaseInsensitiveHash, CaseInsensitiveEqual>;
 
+  /// Characters in a buffer that is owned elsewhere.
+  class StringRange {
+  public:
+    const char *data = nullptr;
+    std::size_t size = 0;
+
+    StringRange() noexcept {}
+    StringRange(const char *data, std::size_t size) noexcept : data(data), size(size) {}
+
+    std::string str() const {
+      return std::string(data, size);
+    }
+
+    bool operator==(const std::string &str) const noexcept {
+      return str.size() == size && std::equal(data, data + size, str.begin());
+    }
+
+    bool case_insensitive_equal(const std::string &str) const noexcept {
+      return str.size() == size &&
+             std::equal(data, data + size, str.begin(), [](char a, char b) {
+               return tolower(a) == tolower(b);
+             });
+    }
+  };
+
   /// Percent encoding and decoding
   class Percent {
   public:
@@ -293,6 +323,206 @@ namespace SimpleWeb {
         return false;
       return true;
     }
+
+    /// Incremental parser of the request line and header fields, that refers to the parsed buffer instead of copying from it.
+    ///
+    /// Call parse() with the buffer each time more data has been received. The buffer must start with
+    /// the same data as before, but may have been moved. The returned ranges refer to the last buffer given.
+    class Parser {
+      class Range {
+      public:
+        std::size_t offset = 0;
+        std::size_t size = 0;
+      };
+      class Field {
+      public:
+        Range name, value;
+      };
+
+      const char *buffer = nullptr;
+      /// Offset of the first line that has not been parsed.
+      std::size_t parsed = 0;
+      bool request_line_parsed = false;
+      bool complete = false;
+
+      Range method_range, path_range, query_string_range, version_range;
+
+      /// Most requests have few header fields, so they are stored without allocating up to this count.
+      static std::size_t inline_fields_size() noexcept {
+        return 16;
+      }
+      std::array<Field, 16> inline_fields;
+      std::vector<Field> more_fields;
+      std::size_t fields_size = 0;
+
+      Range range(std::size_t begin, std::size_t end) const noexcept {
+        Range range;
+        range.offset = begin;
+        range.size = end - begin;
+        return range;
+      }
+
+      StringRange string_range(const Range &range) const noexcept {
+        return StringRange(buffer + range.offset, range.size);
+      }
+
+      const Field &field(std::size_t index) const noexcept {
+        return index < inline_fields_size() ? inline_fields[index] : more_fields[index - inline_fields_size()];
+      }
+
+      /// Parses a line from begin to end, both excluding the '\n'. Works like RequestMessage::parse().
+      bool parse_request_line(std::size_t begin, std::size_t end) noexcept {
+        auto method_end = static_cast<const char *>(std::memchr(buffer + begin, ' ', end - begin));
+        if(!method_end)
+          return false;
+        auto path_begin = static_cast<std::size_t>(method_end - buffer) + 1;
+        method_range = range(begin, path_begin - 1);
+
+        auto query_start = std::string::npos;
+        auto path_and_query_string_end = std::string::npos;
+        for(auto i = path_begin; i < end; ++i) {
+          if(buffer[i] == '?' && i + 1 < end && query_start == std::string::npos)
+            query_start = i + 1;
+          else if(buffer[i] == ' ') {
+            path_and_query_string_end = i;
+            break;
+          }
+        }
+        if(path_and_query_string_end == std::string::npos)
+          return false;
+        if(query_start != std::string::npos) {
+          path_range = range(path_begin, query_start - 1);
+          query_string_range = range(query_start, path_and_query_string_end);
+        }
+        else
+          path_range = range(path_begin, path_and_query_string_end);
+
+        auto protocol_begin = path_and_query_string_end + 1;
+        auto protocol_end = static_cast<const char *>(std::memchr(buffer + protocol_begin, '/', end - (std::min)(protocol_begin, end)));
+        if(!protocol_end || protocol_end - (buffer + protocol_begin) != 4 || std::memcmp(buffer + protocol_begin, "HTTP", 4) != 0)
+          return false;
+        auto version_begin = protocol_begin + 5;
+        version_range = range(version_begin, (std::max)(version_begin, end - (buffer[end - 1] == '\r' ? 1 : 0)));
+        return true;
+      }
+
+      /// Returns false at the line that ends the header fields. Works like HttpHeader::parse().
+      bool parse_header_line(std::size_t begin, std::size_t end) {
+        auto param_end = static_cast<const char *>(std::memchr(buffer + begin, ':', end - begin));
+        if(!param_end)
+          return false;
+        auto name_end = static_cast<std::size_t>(param_end - buffer);
+        auto value_start = name_end + 1;
+        while(value_start + 1 < end && buffer[value_start] == ' ')
+          ++value_start;
+        if(value_start < end) {
+          Field field;
+          field.name = range(begin, name_end);
+          field.value = range(value_start, (std::max)(value_start, end - (buffer[end - 1] == '\r' ? 1 : 0)));
+          if(fields_size < inline_fields_size())
+            inline_fields[fields_size] = field;
+          else
+            more_fields.emplace_back(field);
+          ++fields_size;
+        }
+        return true;
+      }
+
+    public:
+      enum class Result { complete,
+                          incomplete,
+                          error };
+
+      /// Parses the lines in buffer that have not been parsed by previous calls.
+      Result parse(const char *buffer, std::size_t size) noexcept {
+        this->buffer = buffer;
+        if(complete)
+          return Result::complete;
+        while(parsed < size) {
+          auto line_end = static_cast<const char *>(std::memchr(buffer + parsed, '\n', size - parsed));
+          if(!line_end)
+            return Result::incomplete;
+          auto begin = parsed;
+          auto end = static_cast<std::size_t>(line_end - buffer);
+          parsed = end + 1;
+
+          if(!request_line_parsed) {
+            if(!parse_request_line(begin, end))
+              return Result::error;
+            request_line_parsed = true;
+          }
+          else {
+            try {
+              if(!parse_header_line(begin, end)) {
+                complete = true;
+                return Result::complete;
+              }
+            }
+            catch(...) {
+              return Result::error;
+            }
+          }
+        }
+        return Result::incomplete;
+      }
+
+      /// Returns the number of parsed bytes, which is the size of the request line and header fields once complete.
+      std::size_t size() const noexcept {
+        return parsed;
+      }
+
+      void reset() noexcept {
+        parsed = 0;
+        request_line_parsed = false;
+        complete = false;
+        query_string_range = Range();
+        more_fields.clear();
+        fields_size = 0;
+      }
+
+      StringRange method() const noexcept {
+        return string_range(method_range);
+      }
+      StringRange path() const noexcept {
+        return string_range(path_range);
+      }
+      StringRange query_string() const noexcept {
+        return string_range(query_string_range);
+      }
+      StringRange http_version() const noexcept {
+        return string_range(version_range);
+      }
+
+      std::size_t header_size() const noexcept {
+        return fields_size;
+      }
+      StringRange header_name(std::size_t index) const noexcept {
+        return string_range(field(index).name);
+      }
+      StringRange header_value(std::size_t index) const noexcept {
+        return string_range(field(index).value);
+      }
+
+      /// Returns true and sets value to the first header field named name, compared case-insensitively.
+      bool find_header(const std::string &name, StringRange &value) const noexcept {
+        for(std::size_t c = 0; c < fields_size; ++c) {
+          if(header_name(c).case_insensitive_equal(name)) {
+            value = header_value(c);
+            return true;
+          }
+        }
+        return false;
+      }
+
+      /// Copies the header fields to header.
+      void header(CaseInsensitiveMultimap &header) const {
+        header.reserve(header.size() + fields_size);
+        for(std::size_t c = 0; c < fields_size; ++c) {
+          auto &field = this->field(c);
+          header.emplace(std::piecewise_construct, std::forward_as_tuple(buffer + field.name.offset, field.name.size), std::forward_as_tuple(buffer + field.value.offset, field.value.size));
+        }
+      }
+    };
   };
 
   class ResponseMessage {
@@ -43,10 +43,23 @@ static inline unsigned long min(unsigned long a, unsigned long b) {
     return a > b ? b : a;
 }
 
+static inline double secondsToHostTicks(void) {
+    if ( __secondsToHostTicks == 0.0 ) {
+        mach_timebase_info_data_t tinfo;
+        mach_timebase_info(&tinfo);
+        __secondsToHostTicks = 1.0 / (((double)tinfo.numer / tinfo.denom) * 1.0e-9);
+    }
+    return __secondsToHostTicks;
+}
+
 AudioBufferList *TPCircularBufferPrepareEmptyAudioBufferList(TPCircularBuffer *buffer, UInt32 numberOfBuffers, UInt32 bytesPerBuffer, const AudioTimeStamp *inTimestamp) {
     uint32_t availableBytes;
     TPCircularBufferABLBlockHeader *block = (TPCircularBufferABLBlockHeader*)TPCircularBufferHead(buffer, &availableBytes);
-    if ( !block || availableBytes < sizeof(TPCircularBufferABLBlockHeader)+((numberOfBuffers-1)*sizeof(AudioBuffer))+(numberOfBuffers*bytesPerBuffer) ) return NULL;
+    if ( !block ) return NULL;
+    if ( availableBytes < sizeof(TPCircularBufferABLBlockHeader)+((numberOfBuffers-1)*sizeof(AudioBuffer))+(numberOfBuffers*bytesPerBuffer) ) {
+        TPCircularBufferCountOverrun(buffer);
+        return NULL;
+    }
     
     #ifdef DEBUG
     assert(!((unsigned long)block & 0xF) /* Beware unaligned accesses */);
@@ -198,13 +211,7 @@ void TPCircularBufferConsumeNextBufferListPartial(TPCircularBuffer *buffer, UInt
         block->timestamp.mSampleTime += framesToConsume;
     }
     if ( block->timestamp.mFlags & kAudioTimeStampHostTimeValid ) {
-        if ( __secondsToHostTicks == 0.0 ) {
-            mach_timebase_info_data_t tinfo;
-            mach_timebase_info(&tinfo);
-            __secondsToHostTicks = 1.0 / (((double)tinfo.numer / tinfo.denom) * 1.0e-9);
-        }
-
-        block->timestamp.mHostTime += (UInt64)(((double)framesToConsume / audioFormat->mSampleRate) * __secondsToHostTicks);
+        block->timestamp.mHostTime += (UInt64)(((double)framesToConsume / audioFormat->mSampleRate) * secondsToHostTicks());
     }
     
     // Reposition block forward, just before the audio data, ensuring 16-byte alignment
@@ -316,3 +323,90 @@ UInt32 TPCircularBufferGetAvailableSpace(TPCircularBuffer *buffer, const AudioSt
     
     return availableAudioBytesPerBuffer > 0 ? availableAudioBytesPerBuffer / audioFormat->mBytesPerFrame : 0;
 }
+
+bool TPCircularBufferInterleavedInit(TPCircularBufferInterleaved *buffer, const AudioStreamBasicDescription *audioFormat, UInt32 capacityInFrames) {
+    assert(audioFormat->mBytesPerFrame > 0);
+    assert(!(audioFormat->mFormatFlags & kAudioFormatFlagIsNonInterleaved) || audioFormat->mChannelsPerFrame == 1);
+    
+    memset(buffer, 0, sizeof(TPCircularBufferInterleaved));
+    if ( !TPCircularBufferInit(&buffer->buffer, capacityInFrames * audioFormat->mBytesPerFrame) ) {
+        return false;
+    }
+    
+    memcpy(&buffer->audioFormat, audioFormat, sizeof(AudioStreamBasicDescription));
+    return true;
+}
+
+void TPCircularBufferInterleavedCleanup(TPCircularBufferInterleaved *buffer) {
+    TPCircularBufferCleanup(&buffer->buffer);
+    memset(buffer, 0, sizeof(TPCircularBufferInterleaved));
+}
+
+void TPCircularBufferInterleavedProduce(TPCircularBufferInterleaved *buffer, UInt32 frames, const AudioTimeStamp *timestamp) {
+    if ( frames == 0 ) return;
+    
+    if ( !buffer->hasFirstTimestamp ) {
+        // Written before the frames are produced, so the consumer never sees it change
+        if ( timestamp ) {
+            memcpy(&buffer->firstTimestamp, timestamp, sizeof(AudioTimeStamp));
+        }
+        buffer->hasFirstTimestamp = true;
+    }
+    
+    TPCircularBufferProduce(&buffer->buffer, frames * buffer->audioFormat.mBytesPerFrame);
+}
+
+bool TPCircularBufferInterleavedProduceFrames(TPCircularBufferInterleaved *buffer, const void *frames, UInt32 frameCount, const AudioTimeStamp *timestamp) {
+    if ( frameCount == 0 ) return true;
+    
+    UInt32 availableFrames;
+    void *head = TPCircularBufferInterleavedHead(buffer, &availableFrames);
+    if ( !head ) return false;
+    if ( availableFrames < frameCount ) {
+        TPCircularBufferCountOverrun(&buffer->buffer);
+        return false;
+    }
+    
+    // The memory is mirrored after the end of the buffer, so the frames never need to be split
+    memcpy(head, frames, frameCount * buffer->audioFormat.mBytesPerFrame);
+    TPCircularBufferInterleavedProduce(buffer, frameCount, timestamp);
+    return true;
+}
+
+void *TPCircularBufferInterleavedTail(TPCircularBufferInterleaved *buffer, UInt32 *outAvailableFrames, AudioTimeStamp *outTimestamp) {
+    uint32_t availableBytes;
+    void *tail = TPCircularBufferTail(&buffer->buffer, &availableBytes);
+    *outAvailableFrames = availableBytes / buffer->audioFormat.mBytesPerFrame;
+    if ( !tail ) {
+        if ( outTimestamp ) {
+            memset(outTimestamp, 0, sizeof(AudioTimeStamp));
+        }
+        return NULL;
+    }
+    
+    if ( outTimestamp ) {
+        memcpy(outTimestamp, &buffer->firstTimestamp, sizeof(AudioTimeStamp));
+        if ( outTimestamp->mFlags & kAudioTimeStampSampleTimeValid ) {
+            outTimestamp->mSampleTime += buffer->consumedFrames;
+        }
+        if ( outTimestamp->mFlags & kAudioTimeStampHostTimeValid ) {
+            outTimestamp->mHostTime += (UInt64)(((double)buffer->consumedFrames / buffer->audioFormat.mSampleRate) * secondsToHostTicks());
+        }
+    }
+    
+    return tail;
+}
+
+UInt32 TPCircularBufferInterleavedDequeueFrames(TPCircularBufferInterleaved *buffer, void *outputFrames, UInt32 frames, AudioTimeStamp *outTimestamp) {
+    UInt32 availableFrames;
+    void *tail = TPCircularBufferInterleavedTail(buffer, &availableFrames, outTimestamp);
+    if ( !tail ) return 0;
+    
+    UInt32 framesToCopy = (UInt32)min(frames, availableFrames);
+    if ( outputFrames ) {
+        memcpy(outputFrames, tail, framesToCopy * buffer->audioFormat.mBytesPerFrame);
+    }
+    
+    TPCircularBufferInterleavedConsume(buffer, framesToCopy);
+    return framesToCopy;
+}
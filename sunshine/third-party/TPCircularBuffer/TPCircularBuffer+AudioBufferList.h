@@ -225,6 +225,148 @@ UInt32 TPCircularBufferPeekContiguousWrapped(TPCircularBuffer *buffer, AudioTime
  */
 UInt32 TPCircularBufferGetAvailableSpace(TPCircularBuffer *buffer, const AudioStreamBasicDescription *audioFormat);
     
+// Interleaved frames
+
+/*!
+ * Circular buffer holding interleaved audio frames of a fixed stride
+ *
+ *  Unlike the AudioBufferList utilities, no per-chunk metadata is stored within the
+ *  circular buffer: the frames are stored back to back, so any span of them can be
+ *  read or written with a single memcpy.
+ *
+ *  Because there are no per-chunk timestamps, the frames are assumed to be contiguous.
+ *  The timestamp passed with the first produced frames is kept, and the timestamps
+ *  returned to the consumer are derived from it and the number of frames consumed since.
+ *
+ *  Thread-safe with a single producer and a single consumer, like TPCircularBuffer.
+ */
+typedef struct {
+    TPCircularBuffer            buffer;
+    AudioStreamBasicDescription audioFormat;
+    AudioTimeStamp              firstTimestamp;       // Written once by the producer, before the first frames are produced
+    bool                        hasFirstTimestamp;    // Producer only
+    UInt64                      consumedFrames;       // Consumer only
+} TPCircularBufferInterleaved;
+
+/*!
+ * Initialise an interleaved frame buffer
+ *
+ * @param buffer            Interleaved frame buffer
+ * @param audioFormat       The format of the audio to be stored. Must be interleaved (or mono), with a non-zero mBytesPerFrame.
+ * @param capacityInFrames  The number of frames the buffer must be able to hold (rounded up to the page size)
+ * @return true on success, false if the buffer could not be allocated
+ */
+bool TPCircularBufferInterleavedInit(TPCircularBufferInterleaved *buffer, const AudioStreamBasicDescription *audioFormat, UInt32 capacityInFrames);
+
+/*!
+ * Cleanup an interleaved frame buffer
+ *
+ * @param buffer            Interleaved frame buffer
+ */
+void TPCircularBufferInterleavedCleanup(TPCircularBufferInterleaved *buffer);
+
+/*!
+ * Access the front of the buffer, ready for writing frames
+ *
+ *  Note: This function should only be used on the producer thread, not the consumer thread.
+ *
+ * @param buffer            Interleaved frame buffer
+ * @param outAvailableFrames On output, the number of frames that can be written
+ * @return Pointer to the space for the next frames, or NULL if the buffer is full
+ */
+static __inline__ __attribute__((always_inline)) void *TPCircularBufferInterleavedHead(TPCircularBufferInterleaved *buffer, UInt32 *outAvailableFrames) {
+    uint32_t availableBytes;
+    void *head = TPCircularBufferHead(&buffer->buffer, &availableBytes);
+    *outAvailableFrames = availableBytes / buffer->audioFormat.mBytesPerFrame;
+    return *outAvailableFrames > 0 ? head : NULL;
+}
+
+/*!
+ * Mark the frames written to the front of the buffer as ready for reading
+ *
+ *  Note: This function should only be used on the producer thread, not the consumer thread.
+ *
+ * @param buffer            Interleaved frame buffer
+ * @param frames            The number of frames written to the pointer returned by TPCircularBufferInterleavedHead
+ * @param timestamp         The timestamp of the first of the frames, or NULL. Only the timestamp of the very first frames produced is kept.
+ */
+void TPCircularBufferInterleavedProduce(TPCircularBufferInterleaved *buffer, UInt32 frames, const AudioTimeStamp *timestamp);
+
+/*!
+ * Copy interleaved frames onto the buffer
+ *
+ *  Note: This function should only be used on the producer thread, not the consumer thread.
+ *
+ * @param buffer            Interleaved frame buffer
+ * @param frames            The interleaved frames to copy
+ * @param frameCount        The number of frames to copy
+ * @param timestamp         The timestamp of the first of the frames, or NULL. Only the timestamp of the very first frames produced is kept.
+ * @return true if the frames were copied; false if there was insufficient space, in which case nothing is copied
+ */
+bool TPCircularBufferInterleavedProduceFrames(TPCircularBufferInterleaved *buffer, const void *frames, UInt32 frameCount, const AudioTimeStamp *timestamp);
+
+/*!
+ * Access the end of the buffer, ready for reading frames
+ *
+ *  Note: This function should only be used on the consumer thread, not the producer thread.
+ *
+ * @param buffer            Interleaved frame buffer
+ * @param outAvailableFrames On output, the number of frames that can be read
+ * @param outTimestamp      On output, if not NULL, the timestamp corresponding to the first frame
+ * @return Pointer to the next frames, or NULL if the buffer is empty
+ */
+void *TPCircularBufferInterleavedTail(TPCircularBufferInterleaved *buffer, UInt32 *outAvailableFrames, AudioTimeStamp *outTimestamp);
+
+/*!
+ * Consume frames from the end of the buffer
+ *
+ *  Note: This function should only be used on the consumer thread, not the producer thread.
+ *
+ * @param buffer            Interleaved frame buffer
+ * @param frames            The number of frames to consume
+ */
+static __inline__ __attribute__((always_inline)) void TPCircularBufferInterleavedConsume(TPCircularBufferInterleaved *buffer, UInt32 frames) {
+    TPCircularBufferConsume(&buffer->buffer, frames * buffer->audioFormat.mBytesPerFrame);
+    buffer->consumedFrames += frames;
+}
+
+/*!
+ * Copy frames from the buffer, then consume them
+ *
+ *  Note: This function should only be used on the consumer thread, not the producer thread.
+ *
+ * @param buffer            Interleaved frame buffer
+ * @param outputFrames      The memory to copy the interleaved frames to, or NULL to discard them
+ * @param frames            The maximum number of frames to dequeue
+ * @param outTimestamp      On output, if not NULL, the timestamp corresponding to the first frame returned
+ * @return The number of frames dequeued
+ */
+UInt32 TPCircularBufferInterleavedDequeueFrames(TPCircularBufferInterleaved *buffer, void *outputFrames, UInt32 frames, AudioTimeStamp *outTimestamp);
+
+/*!
+ * Clear an interleaved frame buffer
+ *
+ *  Consumes all the buffered frames, keeping the timestamps of the following frames consistent.
+ *  Use this instead of TPCircularBufferClear.
+ *
+ *  Note: This function should only be used on the consumer thread, not the producer thread.
+ *
+ * @param buffer            Interleaved frame buffer
+ */
+static __inline__ __attribute__((always_inline)) void TPCircularBufferInterleavedClear(TPCircularBufferInterleaved *buffer) {
+    TPCircularBufferInterleavedDequeueFrames(buffer, NULL, UINT32_MAX, NULL);
+}
+
+/*!
+ * Determine how many frames are buffered, i.e. the latency added by the buffer
+ *
+ * @param buffer            Interleaved frame buffer
+ * @return The number of frames that are in the buffer
+ */
+static __inline__ __attribute__((always_inline)) UInt32 TPCircularBufferInterleavedFillCount(TPCircularBufferInterleaved *buffer) {
+    return buffer->buffer.fillCount / buffer->audioFormat.mBytesPerFrame;
+}
+
 #ifdef __cplusplus
 }
 #endif
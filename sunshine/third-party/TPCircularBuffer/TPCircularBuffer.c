@@ -27,11 +27,42 @@
 //  3. This notice may not be removed or altered from any source distribution.
 //
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // memfd_create
+#endif
+
 #include "TPCircularBuffer.h"
-#include <mach/mach.h>
 #include <stdio.h>
 #include <stdlib.h>
 
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+static inline bool checkStructSize(size_t structSize) {
+    if ( structSize != sizeof(TPCircularBuffer) ) {
+        fprintf(stderr, "TPCircularBuffer: Header version mismatch. Check for old versions of TPCircularBuffer in your project\n");
+        abort();
+    }
+    return true;
+}
+
+static inline void resetBuffer(TPCircularBuffer *buffer, void *bufferAddress) {
+    buffer->buffer = bufferAddress;
+    buffer->fillCount = 0;
+    buffer->head = buffer->tail = 0;
+    buffer->atomic = true;
+    TPCircularBufferResetTelemetry(buffer);
+}
+
+#if defined(__APPLE__)
+
 #define reportResult(result,operation) (_reportResult((result),(operation),strrchr(__FILE__, '/')+1,__LINE__))
 static inline bool _reportResult(kern_return_t result, const char *operation, const char* file, int line) {
     if ( result != ERR_SUCCESS ) {
@@ -45,10 +76,7 @@ bool _TPCircularBufferInit(TPCircularBuffer *buffer, uint32_t length, size_t str
     
     assert(length > 0);
     
-    if ( structSize != sizeof(TPCircularBuffer) ) {
-        fprintf(stderr, "TPCircularBuffer: Header version mismatch. Check for old versions of TPCircularBuffer in your project\n");
-        abort();
-    }
+    checkStructSize(structSize);
     
     // Keep trying until we get our buffer, needed to handle race conditions
     int retries = 3;
@@ -122,10 +150,7 @@ bool _TPCircularBufferInit(TPCircularBuffer *buffer, uint32_t length, size_t str
             continue;
         }
         
-        buffer->buffer = (void*)bufferAddress;
-        buffer->fillCount = 0;
-        buffer->head = buffer->tail = 0;
-        buffer->atomic = true;
+        resetBuffer(buffer, (void*)bufferAddress);
         
         return true;
     }
@@ -137,9 +162,171 @@ void TPCircularBufferCleanup(TPCircularBuffer *buffer) {
     memset(buffer, 0, sizeof(TPCircularBuffer));
 }
 
+#elif defined(_WIN32)
+
+// VirtualAlloc2 and MapViewOfFile3 are only available since Windows 10 1803, so they are looked up at runtime
+typedef PVOID (WINAPI *VirtualAlloc2Function)(HANDLE, PVOID, SIZE_T, ULONG, ULONG, MEM_EXTENDED_PARAMETER *, ULONG);
+typedef PVOID (WINAPI *MapViewOfFile3Function)(HANDLE, HANDLE, PVOID, ULONG64, SIZE_T, ULONG, ULONG, MEM_EXTENDED_PARAMETER *, ULONG);
+
+bool _TPCircularBufferInit(TPCircularBuffer *buffer, uint32_t length, size_t structSize) {
+    
+    assert(length > 0);
+    
+    checkStructSize(structSize);
+    
+    HMODULE kernelBase = GetModuleHandleW(L"kernelbase.dll");
+    VirtualAlloc2Function virtualAlloc2 = kernelBase ? (VirtualAlloc2Function)(void*)GetProcAddress(kernelBase, "VirtualAlloc2") : NULL;
+    MapViewOfFile3Function mapViewOfFile3 = kernelBase ? (MapViewOfFile3Function)(void*)GetProcAddress(kernelBase, "MapViewOfFile3") : NULL;
+    if ( !virtualAlloc2 || !mapViewOfFile3 ) {
+        printf("Buffer memory mirroring requires Windows 10 version 1803 or later\n");
+        return false;
+    }
+    
+    // Views must be aligned to the allocation granularity (e.g. 64 KiB), not just the page size
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    uint64_t granularity = systemInfo.dwAllocationGranularity;
+    uint64_t roundedLength = ((uint64_t)length + granularity - 1) / granularity * granularity;
+    if ( roundedLength > UINT32_MAX ) {
+        printf("Buffer length too large\n");
+        return false;
+    }
+    buffer->length = (uint32_t)roundedLength;
+    
+    // Reserve the contiguous address space for the buffer and its mirror, then split it in two placeholders
+    char *placeholder = (char*)virtualAlloc2(NULL, NULL, (SIZE_T)buffer->length * 2, MEM_RESERVE | MEM_RESERVE_PLACEHOLDER, PAGE_NOACCESS, NULL, 0);
+    if ( !placeholder ) {
+        printf("Buffer allocation failed: %lu\n", GetLastError());
+        return false;
+    }
+    
+    if ( !VirtualFree(placeholder, buffer->length, MEM_RELEASE | MEM_PRESERVE_PLACEHOLDER) ) {
+        printf("Buffer placeholder split failed: %lu\n", GetLastError());
+        VirtualFree(placeholder, 0, MEM_RELEASE);
+        return false;
+    }
+    
+    HANDLE section = CreateFileMappingW(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, buffer->length, NULL);
+    if ( !section ) {
+        printf("Buffer section creation failed: %lu\n", GetLastError());
+        VirtualFree(placeholder, 0, MEM_RELEASE);
+        VirtualFree(placeholder + buffer->length, 0, MEM_RELEASE);
+        return false;
+    }
+    
+    // Map the same section into both placeholders
+    void *view = mapViewOfFile3(section, NULL, placeholder, 0, buffer->length, MEM_REPLACE_PLACEHOLDER, PAGE_READWRITE, NULL, 0);
+    if ( !view ) {
+        printf("Buffer mapping failed: %lu\n", GetLastError());
+        CloseHandle(section);
+        VirtualFree(placeholder, 0, MEM_RELEASE);
+        VirtualFree(placeholder + buffer->length, 0, MEM_RELEASE);
+        return false;
+    }
+    
+    void *mirror = mapViewOfFile3(section, NULL, placeholder + buffer->length, 0, buffer->length, MEM_REPLACE_PLACEHOLDER, PAGE_READWRITE, NULL, 0);
+    if ( !mirror ) {
+        printf("Remap buffer memory failed: %lu\n", GetLastError());
+        CloseHandle(section);
+        UnmapViewOfFile(view);
+        VirtualFree(placeholder + buffer->length, 0, MEM_RELEASE);
+        return false;
+    }
+    
+    // The views keep the section alive
+    CloseHandle(section);
+    
+    resetBuffer(buffer, view);
+    
+    return true;
+}
+
+void TPCircularBufferCleanup(TPCircularBuffer *buffer) {
+    UnmapViewOfFile(buffer->buffer);
+    UnmapViewOfFile((char*)buffer->buffer + buffer->length);
+    memset(buffer, 0, sizeof(TPCircularBuffer));
+}
+
+#else
+
+static int createMemoryFile(void) {
+#if defined(__linux__)
+    return memfd_create("TPCircularBuffer", MFD_CLOEXEC);
+#else
+    // Anonymous shared memory; the name is only needed until it is unlinked
+    char name[64];
+    static atomicUInt32 counter;
+    snprintf(name, sizeof(name), "/TPCircularBuffer-%ld-%u", (long)getpid(), (unsigned)atomicFetchAdd(&counter, 1));
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if ( fd >= 0 ) {
+        shm_unlink(name);
+    }
+    return fd;
+#endif
+}
+
+bool _TPCircularBufferInit(TPCircularBuffer *buffer, uint32_t length, size_t structSize) {
+    
+    assert(length > 0);
+    
+    checkStructSize(structSize);
+    
+    uint64_t pageSize = (uint64_t)sysconf(_SC_PAGESIZE);
+    uint64_t roundedLength = ((uint64_t)length + pageSize - 1) / pageSize * pageSize;    // We need whole page sizes
+    if ( roundedLength > UINT32_MAX ) {
+        printf("Buffer length too large\n");
+        return false;
+    }
+    buffer->length = (uint32_t)roundedLength;
+    
+    int fd = createMemoryFile();
+    if ( fd < 0 ) {
+        perror("Buffer memory file creation");
+        return false;
+    }
+    
+    if ( ftruncate(fd, buffer->length) != 0 ) {
+        perror("Buffer memory file resize");
+        close(fd);
+        return false;
+    }
+    
+    // Reserve the contiguous address space for the buffer and its mirror
+    char *bufferAddress = (char*)mmap(NULL, (size_t)buffer->length * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if ( bufferAddress == MAP_FAILED ) {
+        perror("Buffer allocation");
+        close(fd);
+        return false;
+    }
+    
+    // Map the same file over both halves of the reservation
+    if ( mmap(bufferAddress, buffer->length, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED ||
+         mmap(bufferAddress + buffer->length, buffer->length, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED ) {
+        perror("Remap buffer memory");
+        munmap(bufferAddress, (size_t)buffer->length * 2);
+        close(fd);
+        return false;
+    }
+    
+    // The mappings keep the memory alive
+    close(fd);
+    
+    resetBuffer(buffer, bufferAddress);
+    
+    return true;
+}
+
+void TPCircularBufferCleanup(TPCircularBuffer *buffer) {
+    munmap(buffer->buffer, (size_t)buffer->length * 2);
+    memset(buffer, 0, sizeof(TPCircularBuffer));
+}
+
+#endif
+
 void TPCircularBufferClear(TPCircularBuffer *buffer) {
-    uint32_t fillCount;
-    if ( TPCircularBufferTail(buffer, &fillCount) ) {
+    // Not using TPCircularBufferTail, an empty buffer is not an underrun here
+    uint32_t fillCount = buffer->fillCount;
+    if ( fillCount > 0 ) {
         TPCircularBufferConsume(buffer, fillCount);
     }
 }
@@ -147,3 +334,24 @@ void TPCircularBufferClear(TPCircularBuffer *buffer) {
 void  TPCircularBufferSetAtomic(TPCircularBuffer *buffer, bool atomic) {
     buffer->atomic = atomic;
 }
+
+void  TPCircularBufferGetTelemetry(TPCircularBuffer *buffer, TPCircularBufferTelemetry *outTelemetry) {
+    memset(outTelemetry, 0, sizeof(TPCircularBufferTelemetry));
+#ifdef TPCIRCULARBUFFER_TELEMETRY
+    outTelemetry->overruns = buffer->overruns;
+    outTelemetry->underruns = buffer->underruns;
+    outTelemetry->highWatermark = buffer->highWatermark;
+#else
+    (void)buffer;
+#endif
+}
+
+void  TPCircularBufferResetTelemetry(TPCircularBuffer *buffer) {
+#ifdef TPCIRCULARBUFFER_TELEMETRY
+    buffer->overruns = 0;
+    buffer->underruns = 0;
+    buffer->highWatermark = buffer->fillCount;
+#else
+    (void)buffer;
+#endif
+}
@@ -13,6 +13,10 @@
 //  
 //  The implementation is thread-safe in the case of a single producer and single consumer.
 //
+//  The mirrored mapping is created with vm_remap on Darwin, with a memfd (or POSIX shared memory)
+//  mapped twice on Linux and other POSIX systems, and with VirtualAlloc2/MapViewOfFile3 placeholders
+//  on Windows 10 1803 or later.
+//
 //  Virtual memory technique originally proposed by Philip Howard (http://vrb.slashusr.org/), and
 //  adapted to Darwin by Kurt Revis (http://www.snoize.com,
 //  http://www.snoize.com/Code/PlayBufferedSoundFile.tar.gz)
@@ -43,9 +47,14 @@
 #define TPCircularBuffer_h
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 #include <assert.h>
 
+#ifndef __deprecated_msg
+    #define __deprecated_msg(msg) __attribute__((deprecated(msg)))
+#endif
+
 #ifdef __cplusplus
     extern "C++" {
         #include <atomic>
@@ -55,7 +64,8 @@
     }
 #else
     #include <stdatomic.h>
-    typedef atomic_uint_fast32_t atomicUInt32;
+    // Not atomic_uint_fast32_t, which is 64 bits on glibc and would not match std::atomic_uint32_t
+    typedef atomic_uint_least32_t atomicUInt32;
     #define atomicFetchAdd(a,b) atomic_fetch_add(a,b)
     #define atomicFetchSub(a,b) atomic_fetch_sub(a,b)
 #endif
@@ -71,14 +81,42 @@ typedef struct {
     uint32_t              head;
     volatile atomicUInt32 fillCount;
     bool                  atomic;
+#ifdef TPCIRCULARBUFFER_TELEMETRY
+    volatile atomicUInt32 overruns;         // Producer only writer
+    volatile atomicUInt32 underruns;        // Consumer only writer
+    volatile atomicUInt32 highWatermark;    // Producer only writer
+#endif
 } TPCircularBuffer;
 
+/*!
+ * Buffer usage statistics
+ *
+ *  Only collected when TPCIRCULARBUFFER_TELEMETRY is defined, for every compilation
+ *  unit using the buffer; otherwise all the values are zero.
+ */
+typedef struct {
+    uint32_t overruns;      // Number of times the producer found insufficient space
+    uint32_t underruns;     // Number of times the consumer found the buffer empty
+    uint32_t highWatermark; // Highest fill count reached, in bytes
+} TPCircularBufferTelemetry;
+
+#ifdef TPCIRCULARBUFFER_TELEMETRY
+    #define TPCircularBufferCountOverrun(buffer) atomicFetchAdd(&(buffer)->overruns, 1)
+    #define TPCircularBufferCountUnderrun(buffer) atomicFetchAdd(&(buffer)->underruns, 1)
+    #define TPCircularBufferTrackWatermark(buffer, fill) do { if ( (fill) > (buffer)->highWatermark ) (buffer)->highWatermark = (fill); } while ( 0 )
+#else
+    #define TPCircularBufferCountOverrun(buffer) ((void)0)
+    #define TPCircularBufferCountUnderrun(buffer) ((void)0)
+    #define TPCircularBufferTrackWatermark(buffer, fill) ((void)0)
+#endif
+
 /*!
  * Initialise buffer
  *
  *  Note that the length is advisory only: Because of the way the
  *  memory mirroring technique works, the true buffer length will
- *  be multiples of the device page size (e.g. 4096 bytes)
+ *  be multiples of the device page size (e.g. 4096 bytes), or of the
+ *  allocation granularity on Windows (e.g. 65536 bytes)
  *
  *  If you intend to use the AudioBufferList utilities, you should
  *  always allocate a bit more space than you need for pure audio
@@ -127,6 +165,28 @@ void  TPCircularBufferClear(TPCircularBuffer *buffer);
  */
 void  TPCircularBufferSetAtomic(TPCircularBuffer *buffer, bool atomic);
 
+/*!
+ * Get the buffer usage statistics
+ *
+ *  This is safe to use from any thread, but the values of the different
+ *  counters are not read as a single snapshot.
+ *
+ * @param buffer Circular buffer
+ * @param outTelemetry On output, the statistics (all zero unless TPCIRCULARBUFFER_TELEMETRY is defined)
+ */
+void  TPCircularBufferGetTelemetry(TPCircularBuffer *buffer, TPCircularBufferTelemetry *outTelemetry);
+
+/*!
+ * Reset the buffer usage statistics
+ *
+ *  The high watermark is reset to the current fill count. Call this while
+ *  neither the producer nor the consumer is accessing the buffer, or some
+ *  counts may be lost.
+ *
+ * @param buffer Circular buffer
+ */
+void  TPCircularBufferResetTelemetry(TPCircularBuffer *buffer);
+
 // Reading (consuming)
 
 /*!
@@ -141,7 +201,10 @@ void  TPCircularBufferSetAtomic(TPCircularBuffer *buffer, bool atomic);
  */
 static __inline__ __attribute__((always_inline)) void* TPCircularBufferTail(TPCircularBuffer *buffer, uint32_t* availableBytes) {
     *availableBytes = buffer->fillCount;
-    if ( *availableBytes == 0 ) return NULL;
+    if ( *availableBytes == 0 ) {
+        TPCircularBufferCountUnderrun(buffer);
+        return NULL;
+    }
     return (void*)((char*)buffer->buffer + buffer->tail);
 }
 
@@ -175,7 +238,10 @@ static __inline__ __attribute__((always_inline)) void TPCircularBufferConsume(TP
  */
 static __inline__ __attribute__((always_inline)) void* TPCircularBufferHead(TPCircularBuffer *buffer, uint32_t* availableBytes) {
     *availableBytes = (buffer->length - buffer->fillCount);
-    if ( *availableBytes == 0 ) return NULL;
+    if ( *availableBytes == 0 ) {
+        TPCircularBufferCountOverrun(buffer);
+        return NULL;
+    }
     return (void*)((char*)buffer->buffer + buffer->head);
 }
     
@@ -191,12 +257,15 @@ static __inline__ __attribute__((always_inline)) void* TPCircularBufferHead(TPCi
  */
 static __inline__ __attribute__((always_inline)) void TPCircularBufferProduce(TPCircularBuffer *buffer, uint32_t amount) {
     buffer->head = (buffer->head + amount) % buffer->length;
+    uint32_t fillCount;
     if ( buffer->atomic ) {
-        atomicFetchAdd(&buffer->fillCount, amount);
+        fillCount = atomicFetchAdd(&buffer->fillCount, amount) + amount;
     } else {
-        buffer->fillCount += amount;
+        fillCount = (buffer->fillCount += amount);
     }
-    assert(buffer->fillCount <= buffer->length);
+    assert(fillCount <= buffer->length);
+    TPCircularBufferTrackWatermark(buffer, fillCount);
+    (void)fillCount;
 }
 
 /*!
@@ -212,7 +281,10 @@ static __inline__ __attribute__((always_inline)) void TPCircularBufferProduce(TP
 static __inline__ __attribute__((always_inline)) bool TPCircularBufferProduceBytes(TPCircularBuffer *buffer, const void* src, uint32_t len) {
     uint32_t space;
     void *ptr = TPCircularBufferHead(buffer, &space);
-    if ( space < len ) return false;
+    if ( space < len ) {
+        if ( space > 0 ) TPCircularBufferCountOverrun(buffer); // Otherwise already counted by TPCircularBufferHead
+        return false;
+    }
     memcpy(ptr, src, len);
     TPCircularBufferProduce(buffer, len);
     return true;
@@ -223,9 +295,9 @@ static __inline__ __attribute__((always_inline)) bool TPCircularBufferProduceByt
  */
 static __inline__ __attribute__((always_inline)) __deprecated_msg("use TPCircularBufferSetAtomic(false) and TPCircularBufferConsume instead")
 void TPCircularBufferConsumeNoBarrier(TPCircularBuffer *buffer, uint32_t amount) {
+    assert(buffer->fillCount >= amount);
     buffer->tail = (buffer->tail + amount) % buffer->length;
     buffer->fillCount -= amount;
-    assert(buffer->fillCount >= 0);
 }
 
 /*!
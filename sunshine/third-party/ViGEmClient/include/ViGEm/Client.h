@@ -158,6 +158,23 @@ extern "C" {
 
 	typedef EVT_VIGEM_DS4_NOTIFICATION *PFN_VIGEM_DS4_NOTIFICATION;
 
+	/** A state report of one target submitted by vigem_targets_update_batch */
+	typedef struct _VIGEM_TARGET_REPORT
+	{
+		/** The target device object */
+		PVIGEM_TARGET Target;
+
+		/** The report matching the type of the target */
+		union
+		{
+			XUSB_REPORT Xusb;
+			DS4_REPORT_EX Ds4Ex;
+		} Report;
+
+		/** Set to the result of submitting this report */
+		VIGEM_ERROR Error;
+	} VIGEM_TARGET_REPORT, *PVIGEM_TARGET_REPORT;
+
 	/**
 	 *  Allocates an object representing a driver connection
 	 *
@@ -345,6 +362,8 @@ extern "C" {
 	 * Registers a function which gets called,
 	 * when LightBar or vibration state changes occur on the provided target device. This function
 	 * fails if the provided target device isn't fully operational or in an erroneous state.
+	 * The callbacks of all targets are invoked on the completion port thread of the client, so
+	 * they should return quickly.
 	 *
 	 * @author	Benjamin "Nefarius" Höglinger
 	 * @date	28.08.2017
@@ -499,6 +518,91 @@ extern "C" {
 		DS4_REPORT_EX report
 	);
 
+	/**
+	 * Returns the full size report buffer owned by the provided DualShock 4 target device. The
+	 * report can be modified in place and sent with vigem_target_ds4_update_ex_buffer, instead of
+	 * passing a copy of it with every vigem_target_ds4_update_ex call. The buffer stays valid until
+	 * the target is freed.
+	 *
+	 * @param 	target	The target device object.
+	 *
+	 * @returns	The report buffer, or NULL if the target isn't a DualShock 4.
+	 */
+	VIGEM_API PDS4_REPORT_EX vigem_target_ds4_get_report_ex_buffer(
+		PVIGEM_TARGET target
+	);
+
+	/**
+	 * Sends the report buffer returned by vigem_target_ds4_get_report_ex_buffer to the provided
+	 * target device. Nothing is sent when the buffer didn't change since it was last sent
+	 * successfully, so it can be called for every input event at no cost.
+	 *
+	 * @param 	vigem 	The driver connection object.
+	 * @param 	target	The target device object.
+	 *
+	 * @returns	A VIGEM_ERROR.
+	 */
+	VIGEM_API VIGEM_ERROR vigem_target_ds4_update_ex_buffer(
+		PVIGEM_CLIENT vigem,
+		PVIGEM_TARGET target
+	);
+
+	/**
+	 * Sends a state report to the provided target device without waiting for the driver to
+	 * process it. Reports are submitted from a small pool of pre-allocated requests per target;
+	 * when all of them are still being processed the report is kept and sent as soon as one
+	 * completes, replacing any older report that didn't get sent yet. Completions are picked up
+	 * by the completion port thread of the client.
+	 *
+	 * Errors of reports that completed in the background are returned by the next call for the
+	 * same target.
+	 *
+	 * @param 	vigem 	The driver connection object.
+	 * @param 	target	The target device object.
+	 * @param 	report	The report to send to the target device.
+	 *
+	 * @returns	A VIGEM_ERROR.
+	 */
+	VIGEM_API VIGEM_ERROR vigem_target_x360_update_async(
+		PVIGEM_CLIENT vigem,
+		PVIGEM_TARGET target,
+		XUSB_REPORT report
+	);
+
+	/**
+	 * Sends a full size state report to the provided target device without waiting for the driver
+	 * to process it. See vigem_target_x360_update_async for how reports are submitted.
+	 *
+	 * @param 	vigem 	The driver connection object.
+	 * @param 	target	The target device object.
+	 * @param 	report	The report buffer.
+	 *
+	 * @returns	A VIGEM_ERROR.
+	 */
+	VIGEM_API VIGEM_ERROR vigem_target_ds4_update_ex_async(
+		PVIGEM_CLIENT vigem,
+		PVIGEM_TARGET target,
+		DS4_REPORT_EX report
+	);
+
+	/**
+	 * Sends a state report to each of the provided target devices. All the reports are submitted
+	 * to the driver before waiting for any of them, so that the driver processes them at the same
+	 * time, and the requests reuse an event allocated with each target instead of creating one
+	 * per call. A target must appear at most once per batch.
+	 *
+	 * @param 	vigem  	The driver connection object.
+	 * @param 	reports	The reports to send, the Error of each one is set to its result.
+	 * @param 	count  	The number of reports.
+	 *
+	 * @returns	VIGEM_ERROR_NONE if all the reports were sent, otherwise the first error.
+	 */
+	VIGEM_API VIGEM_ERROR vigem_targets_update_batch(
+		PVIGEM_CLIENT vigem,
+		PVIGEM_TARGET_REPORT reports,
+		ULONG count
+	);
+
 	/**
 	 * Returns the internal index (serial number) the bus driver assigned to the provided
 	 *               target device object. Note that this value is specific to the inner workings of
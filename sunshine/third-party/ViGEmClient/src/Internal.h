@@ -30,6 +30,45 @@ SOFTWARE.
 // 
 #define VIGEM_TARGETS_MAX   USHRT_MAX
 
+//
+// Number of reports of a target that can be processed by the driver at once by the async update
+// functions, newer reports wait in the target for one of them to complete.
+// 
+#define VIGEM_ASYNC_REPORTS_MAX 4
+
+//
+// Number of DS4 output report requests kept pending in the driver, so that no output report
+// has to wait for the previous request to be sent again.
+// 
+#define VIGEM_DS4_OUTPUT_AWAITS_MAX 2
+
+//
+// Kinds of the requests whose completion is picked up by the client completion port.
+// 
+typedef enum
+{
+    VIGEM_PORT_REQUEST_ASYNC_REPORT,
+    VIGEM_PORT_REQUEST_DS4_OUTPUT_AWAIT,
+    VIGEM_PORT_REQUEST_DS4_NOTIFICATION
+} VIGEM_PORT_REQUEST_TYPE;
+
+//
+// Common header of the requests reported to the client completion port.
+// 
+typedef struct _VIGEM_PORT_REQUEST_T
+{
+    OVERLAPPED Overlapped;
+    VIGEM_PORT_REQUEST_TYPE Type;
+} VIGEM_PORT_REQUEST, *PVIGEM_PORT_REQUEST;
+
+//
+// A DS4 output report request of the client, answered for any of its DS4 targets.
+// 
+typedef struct _VIGEM_DS4_OUTPUT_AWAIT_T
+{
+    VIGEM_PORT_REQUEST Request;
+    DS4_AWAIT_OUTPUT Await;
+} VIGEM_DS4_OUTPUT_AWAIT, *PVIGEM_DS4_OUTPUT_AWAIT;
 
 //
 // Represents a driver connection object.
@@ -37,9 +76,12 @@ SOFTWARE.
 typedef struct _VIGEM_CLIENT_T
 {
     HANDLE hBusDevice;
-    HANDLE hDS4OutputReportPickupThread;
-    HANDLE hDS4OutputReportPickupThreadAbortEvent;
     PVIGEM_TARGET pTargetsList[VIGEM_TARGETS_MAX];
+    VIGEM_DS4_OUTPUT_AWAIT Ds4OutputAwaits[VIGEM_DS4_OUTPUT_AWAITS_MAX];
+    INIT_ONCE CompletionPortInitOnce;
+    HANDLE hCompletionPort;
+    HANDLE hCompletionPortThread;
+    volatile LONG CompletionPortRequestsInFlight;
 } VIGEM_CLIENT;
 
 //
@@ -53,6 +95,39 @@ typedef enum
     VIGEM_TARGET_DISCONNECTED
 } VIGEM_TARGET_STATE, *PVIGEM_TARGET_STATE;
 
+//
+// Any of the report submissions sent by the async update functions.
+// 
+typedef union
+{
+    XUSB_SUBMIT_REPORT Xusb;
+    DS4_SUBMIT_REPORT_EX Ds4Ex;
+} VIGEM_SUBMIT_REPORT_BUFFER;
+
+//
+// A pre-allocated report request of a target.
+// 
+typedef struct _VIGEM_ASYNC_REPORT_T
+{
+    VIGEM_PORT_REQUEST Request;
+    struct _VIGEM_TARGET_T* Target;
+    BOOLEAN InFlight;
+    DWORD IoControlCode;
+    VIGEM_SUBMIT_REPORT_BUFFER Buffer;
+} VIGEM_ASYNC_REPORT, *PVIGEM_ASYNC_REPORT;
+
+//
+// The DS4 notification request of a target, sent again after each notification while a
+// callback is registered.
+// 
+typedef struct _VIGEM_DS4_NOTIFICATION_REQUEST_T
+{
+    VIGEM_PORT_REQUEST Request;
+    struct _VIGEM_TARGET_T* Target;
+    volatile LONG InFlight;
+    DS4_REQUEST_NOTIFICATION Notification;
+} VIGEM_DS4_NOTIFICATION_REQUEST, *PVIGEM_DS4_NOTIFICATION_REQUEST;
+
 //
 // Represents a virtual gamepad object.
 // 
@@ -72,13 +147,39 @@ typedef struct _VIGEM_TARGET_T
     HANDLE Ds4CachedOutputReportUpdateAvailable;
     CRITICAL_SECTION Ds4CachedOutputReportUpdateLock;
     BOOLEAN IsDisposing;
+    VIGEM_ASYNC_REPORT AsyncReports[VIGEM_ASYNC_REPORTS_MAX];
+    CRITICAL_SECTION AsyncReportsLock;
+    ULONG AsyncReportsInFlight;
+    HANDLE AsyncReportsIdle;
+    BOOLEAN AsyncReportPending;
+    DWORD AsyncReportPendingIoControlCode;
+    VIGEM_SUBMIT_REPORT_BUFFER AsyncReportPendingBuffer;
+    VIGEM_ERROR AsyncReportError;
+    VIGEM_DS4_NOTIFICATION_REQUEST Ds4NotificationRequest;
+    OVERLAPPED ReportOverlapped;
+    HANDLE ReportEvent;
+    BOOLEAN BatchPending;
+    VIGEM_SUBMIT_REPORT_BUFFER BatchBuffer;
+    DS4_SUBMIT_REPORT_EX Ds4ReportExBuffer;
+    DS4_REPORT_EX Ds4ReportExSubmitted;
+    BOOLEAN IsDs4ReportExSubmitted;
 } VIGEM_TARGET;
 
+//
+// Events of overlapped requests that are waited on by the caller have the low-order bit set, so
+// that their completion isn't queued to the completion port of the bus handle.
+// 
+#define OVERLAPPED_EVENT_SKIP_PORT(_event_) \
+	((_event_) ? reinterpret_cast<HANDLE>(reinterpret_cast<ULONG_PTR>(_event_) | 1) : nullptr)
+
+#define OVERLAPPED_EVENT_HANDLE(_event_) \
+	reinterpret_cast<HANDLE>(reinterpret_cast<ULONG_PTR>(_event_) & ~static_cast<ULONG_PTR>(1))
+
 #define DEVICE_IO_CONTROL_BEGIN	\
 	DWORD transferred = 0; \
 	OVERLAPPED lOverlapped = { 0 }; \
-	lOverlapped.hEvent = CreateEvent(NULL, FALSE, FALSE, NULL)
+	lOverlapped.hEvent = OVERLAPPED_EVENT_SKIP_PORT(CreateEvent(NULL, FALSE, FALSE, NULL))
 
 #define DEVICE_IO_CONTROL_END \
 	if (lOverlapped.hEvent) \
-		CloseHandle(lOverlapped.hEvent)
+		CloseHandle(OVERLAPPED_EVENT_HANDLE(lOverlapped.hEvent))
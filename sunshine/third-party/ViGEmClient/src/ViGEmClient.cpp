@@ -152,125 +152,440 @@ PVIGEM_TARGET FORCEINLINE VIGEM_TARGET_ALLOC_INIT(
 	target->Size = sizeof(VIGEM_TARGET);
 	target->State = VIGEM_TARGET_INITIALIZED;
 	target->Type = Type;
+
+	InitializeCriticalSection(&target->AsyncReportsLock);
+	target->AsyncReportsIdle = CreateEvent(
+		nullptr,
+		TRUE,
+		TRUE,
+		nullptr
+	);
+	target->AsyncReportError = VIGEM_ERROR_NONE;
+
+	for (auto& report : target->AsyncReports)
+	{
+		report.Request.Type = VIGEM_PORT_REQUEST_ASYNC_REPORT;
+		report.Target = target;
+	}
+
+	target->Ds4NotificationRequest.Request.Type = VIGEM_PORT_REQUEST_DS4_NOTIFICATION;
+	target->Ds4NotificationRequest.Target = target;
+
+	target->ReportEvent = CreateEvent(
+		nullptr,
+		FALSE,
+		FALSE,
+		nullptr
+	);
+
 	return target;
 }
 
-static DWORD WINAPI vigem_internal_ds4_output_report_pickup_handler(LPVOID Parameter)
+//
+// Hands an output report received from the driver to the target waiting for it.
+// 
+static void vigem_internal_ds4_output_report_deliver(PVIGEM_CLIENT pClient, const DS4_AWAIT_OUTPUT* await)
 {
-	const auto pClient = static_cast<PVIGEM_CLIENT>(Parameter);
-	DS4_AWAIT_OUTPUT await;
-	DEVICE_IO_CONTROL_BEGIN;
+#if defined(VIGEM_VERBOSE_LOGGING_ENABLED)
+	DBGPRINT(L"Dumping buffer for %d", await->SerialNo);
 
-	// Abort event first so that in the case both are signaled at once, the result will be for the abort event
-	const HANDLE waitEvents[] =
+	const PCHAR dumpBuffer = (PCHAR)calloc(sizeof(DS4_OUTPUT_BUFFER), 3);
+	if (dumpBuffer != nullptr)
 	{
-		pClient->hDS4OutputReportPickupThreadAbortEvent,
-		lOverlapped.hEvent
-	};
+		to_hex((unsigned char*)await->Report.Buffer, sizeof(DS4_OUTPUT_BUFFER), dumpBuffer, sizeof(DS4_OUTPUT_BUFFER) * 3);
+		OutputDebugStringA(dumpBuffer);
+		free(dumpBuffer);
+	}
+#endif
 
-	DBGPRINT(L"Started DS4 Output Report pickup thread for 0x%p", pClient);
+	const PVIGEM_TARGET pTarget = await->SerialNo < VIGEM_TARGETS_MAX ? pClient->pTargetsList[await->SerialNo] : nullptr;
+
+	if (pTarget && !pTarget->IsDisposing && pTarget->Type == DualShock4Wired)
+	{
+		memcpy(&pTarget->Ds4CachedOutputReport, &await->Report, sizeof(DS4_OUTPUT_BUFFER));
+		SetEvent(pTarget->Ds4CachedOutputReportUpdateAvailable);
+	}
+	else
+	{
+		DBGPRINT(L"No target to report to for serial %d", await->SerialNo);
+	}
+}
 
+//
+// Sends the output report request to the driver again, until it's left pending.
+// 
+static void vigem_internal_ds4_output_await_start(PVIGEM_CLIENT pClient, PVIGEM_DS4_OUTPUT_AWAIT pAwait)
+{
 	do
 	{
-		DS4_AWAIT_OUTPUT_INIT(&await, 0);
+		DS4_AWAIT_OUTPUT_INIT(&pAwait->Await, 0);
+		RtlZeroMemory(&pAwait->Request.Overlapped, sizeof(OVERLAPPED));
+		pAwait->Request.Type = VIGEM_PORT_REQUEST_DS4_OUTPUT_AWAIT;
 
-		DeviceIoControl(
+		if (DeviceIoControl(
 			pClient->hBusDevice,
 			IOCTL_DS4_AWAIT_OUTPUT_AVAILABLE,
-			&await,
-			await.Size,
-			&await,
-			await.Size,
-			&transferred,
-			&lOverlapped
-		);
+			&pAwait->Await,
+			pAwait->Await.Size,
+			&pAwait->Await,
+			pAwait->Await.Size,
+			nullptr,
+			&pAwait->Request.Overlapped
+		))
+		{
+			//
+			// A report was already queued, no packet is queued to the completion port
+			// 
+			vigem_internal_ds4_output_report_deliver(pClient, &pAwait->Await);
+			continue;
+		}
 
-		const DWORD waitResult = WaitForMultipleObjects(
-			static_cast<DWORD>(std::size(waitEvents)),
-			waitEvents,
-			FALSE,
-			INFINITE
-		);
+		const DWORD error = GetLastError();
 
-		if (waitResult == WAIT_OBJECT_0)
+		if (error == ERROR_IO_PENDING)
 		{
-			DBGPRINT(L"Abort event signalled during read, exiting thread", NULL);
-			CancelIoEx(pClient->hBusDevice, &lOverlapped);
-			break;
+			InterlockedIncrement(&pClient->CompletionPortRequestsInFlight);
+			return;
 		}
 
-		if (waitResult == WAIT_FAILED)
+		//
+		// Backwards compatibility with version pre-1.19, where this IOCTL doesn't exist
+		// 
+		if (error == ERROR_INVALID_PARAMETER)
 		{
-			const DWORD error = GetLastError();
-			DBGPRINT(L"Win32 error from multi-object wait: 0x%X", error);
-			continue;
+			DBGPRINT(L"Currently used driver version doesn't support this request, aborting", NULL);
+			return;
 		}
 
-		if (waitResult != WAIT_OBJECT_0 + 1)
+		DBGPRINT(L"Win32 error requesting DS4 output report: 0x%X", error);
+		return;
+	} while (TRUE);
+}
+
+//
+// Called on the completion port thread when the driver received an output report for any DS4 target.
+// 
+static void vigem_internal_ds4_output_await_completed(PVIGEM_CLIENT pClient, PVIGEM_DS4_OUTPUT_AWAIT pAwait, DWORD error)
+{
+	if (error == ERROR_SUCCESS)
+	{
+		vigem_internal_ds4_output_report_deliver(pClient, &pAwait->Await);
+		vigem_internal_ds4_output_await_start(pClient, pAwait);
+	}
+	else if (error == ERROR_INVALID_PARAMETER)
+	{
+		DBGPRINT(L"Currently used driver version doesn't support this request, aborting", NULL);
+	}
+	else if (error == ERROR_OPERATION_ABORTED)
+	{
+		DBGPRINT(L"Read has been cancelled, aborting", NULL);
+	}
+	else
+	{
+		DBGPRINT(L"Win32 error from overlapped result: 0x%X", error);
+		vigem_internal_ds4_output_await_start(pClient, pAwait);
+	}
+
+	InterlockedDecrement(&pClient->CompletionPortRequestsInFlight);
+}
+
+//
+// Submits the pending report of the target with the given free request, until one is left pending
+// by the driver. Must be called with the target AsyncReportsLock held.
+// 
+static void vigem_internal_async_report_start(PVIGEM_CLIENT pClient, PVIGEM_ASYNC_REPORT pReport)
+{
+	const PVIGEM_TARGET pTarget = pReport->Target;
+
+	while (pTarget->AsyncReportPending)
+	{
+		pTarget->AsyncReportPending = FALSE;
+		pReport->IoControlCode = pTarget->AsyncReportPendingIoControlCode;
+		memcpy(&pReport->Buffer, &pTarget->AsyncReportPendingBuffer, sizeof(VIGEM_SUBMIT_REPORT_BUFFER));
+		RtlZeroMemory(&pReport->Request.Overlapped, sizeof(OVERLAPPED));
+
+		if (DeviceIoControl(
+			pClient->hBusDevice,
+			pReport->IoControlCode,
+			&pReport->Buffer,
+			pReport->Buffer.Xusb.Size, // Both submissions start with their size
+			nullptr,
+			0,
+			nullptr,
+			&pReport->Request.Overlapped
+		))
 		{
-			DBGPRINT(L"Unexpected result from multi-object wait: 0x%X", waitResult);
+			//
+			// Completed synchronously, no packet is queued to the completion port
+			// 
+			continue;
 		}
 
-		if (GetOverlappedResult(pClient->hBusDevice, &lOverlapped, &transferred, FALSE) == FALSE)
+		const DWORD error = GetLastError();
+
+		if (error == ERROR_IO_PENDING)
 		{
-			const DWORD error = GetLastError();
+			pReport->InFlight = TRUE;
+			pTarget->AsyncReportsInFlight++;
+			InterlockedIncrement(&pClient->CompletionPortRequestsInFlight);
+			ResetEvent(pTarget->AsyncReportsIdle);
+			return;
+		}
 
-			//
-			// Backwards compatibility with version pre-1.19, where this IOCTL doesn't exist
-			// 
-			if (error == ERROR_INVALID_PARAMETER)
-			{
-				DBGPRINT(L"Currently used driver version doesn't support this request, aborting", NULL);
-				break;
-			}
+		DBGPRINT(L"Win32 error submitting async report: 0x%X", error);
 
-			if (error == ERROR_OPERATION_ABORTED)
-			{
-				DBGPRINT(L"Read has been cancelled, aborting", NULL);
-				break;
-			}
+		if (error == ERROR_ACCESS_DENIED)
+			pTarget->AsyncReportError = VIGEM_ERROR_INVALID_TARGET;
+		else if (error == ERROR_INVALID_PARAMETER)
+			pTarget->AsyncReportError = VIGEM_ERROR_NOT_SUPPORTED;
+		else
+			pTarget->AsyncReportError = VIGEM_ERROR_WINAPI;
+	}
+}
+
+//
+// Called on the completion port thread when the driver is done with a report request.
+// 
+static void vigem_internal_async_report_completed(PVIGEM_CLIENT pClient, PVIGEM_ASYNC_REPORT pReport, DWORD error)
+{
+	const PVIGEM_TARGET pTarget = pReport->Target;
+
+	EnterCriticalSection(&pTarget->AsyncReportsLock);
+
+	pReport->InFlight = FALSE;
+	pTarget->AsyncReportsInFlight--;
+
+	if (error == ERROR_ACCESS_DENIED)
+		pTarget->AsyncReportError = VIGEM_ERROR_INVALID_TARGET;
+	else if (error == ERROR_INVALID_PARAMETER)
+		pTarget->AsyncReportError = VIGEM_ERROR_NOT_SUPPORTED;
+	else if (error != ERROR_SUCCESS && error != ERROR_OPERATION_ABORTED)
+		pTarget->AsyncReportError = VIGEM_ERROR_WINAPI;
+
+	//
+	// Reuse the request for the newest report received in the meantime
+	// 
+	if (error != ERROR_OPERATION_ABORTED)
+		vigem_internal_async_report_start(pClient, pReport);
+
+	const BOOLEAN isIdle = pTarget->AsyncReportsInFlight == 0;
+	const HANDLE idleEvent = pTarget->AsyncReportsIdle;
+
+	LeaveCriticalSection(&pTarget->AsyncReportsLock);
 
-			if (error == ERROR_IO_INCOMPLETE)
+	//
+	// Signalled last, vigem_target_free might release the target as soon as it's set
+	// 
+	if (isIdle)
+		SetEvent(idleEvent);
+
+	InterlockedDecrement(&pClient->CompletionPortRequestsInFlight);
+}
+
+//
+// Sends the notification request of the target to the driver. A request completed right away is
+// queued to the completion port as well, so that the callback is always invoked on its thread.
+// 
+static void vigem_internal_ds4_notification_start(PVIGEM_CLIENT pClient, PVIGEM_DS4_NOTIFICATION_REQUEST pRequest)
+{
+	DS4_REQUEST_NOTIFICATION_INIT(&pRequest->Notification, pRequest->Target->SerialNo);
+	RtlZeroMemory(&pRequest->Request.Overlapped, sizeof(OVERLAPPED));
+
+	InterlockedIncrement(&pClient->CompletionPortRequestsInFlight);
+
+	if (DeviceIoControl(
+		pClient->hBusDevice,
+		IOCTL_DS4_REQUEST_NOTIFICATION,
+		&pRequest->Notification,
+		pRequest->Notification.Size,
+		&pRequest->Notification,
+		pRequest->Notification.Size,
+		nullptr,
+		&pRequest->Request.Overlapped
+	))
+	{
+		if (PostQueuedCompletionStatus(pClient->hCompletionPort, 0, 0, &pRequest->Request.Overlapped))
+			return;
+	}
+	else if (GetLastError() == ERROR_IO_PENDING)
+	{
+		return;
+	}
+
+	DBGPRINT(L"Win32 error requesting DS4 notification: 0x%X", GetLastError());
+
+	InterlockedExchange(&pRequest->InFlight, FALSE);
+	InterlockedDecrement(&pClient->CompletionPortRequestsInFlight);
+}
+
+//
+// Called on the completion port thread when the driver has new output values for a DS4 target.
+// 
+static void vigem_internal_ds4_notification_completed(PVIGEM_CLIENT pClient, PVIGEM_DS4_NOTIFICATION_REQUEST pRequest, DWORD error)
+{
+	const PVIGEM_TARGET pTarget = pRequest->Target;
+
+	//
+	// Fails once the target got unplugged or the bus handle closed
+	// 
+	if (error == ERROR_SUCCESS && pTarget->Notification != nullptr)
+	{
+		reinterpret_cast<PFN_VIGEM_DS4_NOTIFICATION>(pTarget->Notification)(
+			pClient, pTarget, pRequest->Notification.Report.LargeMotor,
+			pRequest->Notification.Report.SmallMotor,
+			pRequest->Notification.Report.LightbarColor, pTarget->NotificationUserData
+		);
+	}
+
+	if (pTarget->Notification != nullptr && error != ERROR_ACCESS_DENIED && error != ERROR_OPERATION_ABORTED)
+		vigem_internal_ds4_notification_start(pClient, pRequest);
+	else
+		InterlockedExchange(&pRequest->InFlight, FALSE);
+
+	InterlockedDecrement(&pClient->CompletionPortRequestsInFlight);
+}
+
+static DWORD WINAPI vigem_internal_completion_port_handler(LPVOID Parameter)
+{
+	const auto pClient = static_cast<PVIGEM_CLIENT>(Parameter);
+	BOOLEAN stopping = FALSE;
+
+	DBGPRINT(L"Started completion port thread for 0x%p", pClient);
+
+	//
+	// On disconnect the cancelled requests are still reported after the quit packet
+	// 
+	while (!stopping || InterlockedCompareExchange(&pClient->CompletionPortRequestsInFlight, 0, 0) > 0)
+	{
+		DWORD transferred = 0;
+		ULONG_PTR key = 0;
+		LPOVERLAPPED overlapped = nullptr;
+
+		const BOOL success = GetQueuedCompletionStatus(
+			pClient->hCompletionPort,
+			&transferred,
+			&key,
+			&overlapped,
+			INFINITE
+		);
+
+		if (overlapped == nullptr)
+		{
+			if (!success)
 			{
-				DBGPRINT(L"Pending I/O not completed, aborting", NULL);
-				CancelIoEx(pClient->hBusDevice, &lOverlapped);
+				DBGPRINT(L"Win32 error from completion port: 0x%X", GetLastError());
 				break;
 			}
 
-			DBGPRINT(L"Win32 error from overlapped result: 0x%X", error);
+			stopping = TRUE;
 			continue;
 		}
 
-#if defined(VIGEM_VERBOSE_LOGGING_ENABLED)
-		DBGPRINT(L"Dumping buffer for %d", await.SerialNo);
+		const DWORD error = success ? ERROR_SUCCESS : GetLastError();
+		const auto pRequest = CONTAINING_RECORD(overlapped, VIGEM_PORT_REQUEST, Overlapped);
 
-		const PCHAR dumpBuffer = (PCHAR)calloc(sizeof(DS4_OUTPUT_BUFFER), 3);
-		if (dumpBuffer != nullptr)
+		switch (pRequest->Type)
 		{
-			to_hex(await.Report.Buffer, sizeof(DS4_OUTPUT_BUFFER), dumpBuffer, sizeof(DS4_OUTPUT_BUFFER) * 3);
-			OutputDebugStringA(dumpBuffer);
-			free(dumpBuffer);
+		case VIGEM_PORT_REQUEST_ASYNC_REPORT:
+			vigem_internal_async_report_completed(
+				pClient,
+				CONTAINING_RECORD(pRequest, VIGEM_ASYNC_REPORT, Request),
+				error
+			);
+			break;
+		case VIGEM_PORT_REQUEST_DS4_OUTPUT_AWAIT:
+			vigem_internal_ds4_output_await_completed(
+				pClient,
+				CONTAINING_RECORD(pRequest, VIGEM_DS4_OUTPUT_AWAIT, Request),
+				error
+			);
+			break;
+		case VIGEM_PORT_REQUEST_DS4_NOTIFICATION:
+			vigem_internal_ds4_notification_completed(
+				pClient,
+				CONTAINING_RECORD(pRequest, VIGEM_DS4_NOTIFICATION_REQUEST, Request),
+				error
+			);
+			break;
 		}
-#endif
+	}
 
-		const PVIGEM_TARGET pTarget = pClient->pTargetsList[await.SerialNo];
+	DBGPRINT(L"Finished completion port thread for 0x%p", pClient);
 
-		if (pTarget && !pTarget->IsDisposing && pTarget->Type == DualShock4Wired)
-		{
-			memcpy(&pTarget->Ds4CachedOutputReport, &await.Report, sizeof(DS4_OUTPUT_BUFFER));
-			SetEvent(pTarget->Ds4CachedOutputReportUpdateAvailable);
-		}
-		else
+	return 0;
+}
+
+//
+// Associates the bus handle with the completion port picking up the DS4 output reports and the
+// async reports of all targets, once per connection.
+// 
+static BOOL CALLBACK vigem_internal_completion_port_init(PINIT_ONCE InitOnce, PVOID Parameter, PVOID* Context)
+{
+	std::ignore = InitOnce;
+	std::ignore = Context;
+
+	const auto pClient = static_cast<PVIGEM_CLIENT>(Parameter);
+
+	pClient->hCompletionPort = CreateIoCompletionPort(pClient->hBusDevice, nullptr, 0, 1);
+
+	if (!pClient->hCompletionPort)
+		return FALSE;
+
+	//
+	// Requests completed right away are handled by the caller
+	// 
+	if (!SetFileCompletionNotificationModes(pClient->hBusDevice, FILE_SKIP_COMPLETION_PORT_ON_SUCCESS))
+		return FALSE;
+
+	pClient->hCompletionPortThread = CreateThread(
+		nullptr,
+		0,
+		vigem_internal_completion_port_handler,
+		pClient,
+		0,
+		nullptr
+	);
+
+	return pClient->hCompletionPortThread != nullptr;
+}
+
+//
+// Queues the report as the newest of the target and submits it if a request is free.
+// 
+static VIGEM_ERROR vigem_internal_async_report_submit(
+	PVIGEM_CLIENT pClient,
+	PVIGEM_TARGET pTarget,
+	DWORD ioControlCode,
+	const VIGEM_SUBMIT_REPORT_BUFFER* buffer
+)
+{
+	if (!InitOnceExecuteOnce(&pClient->CompletionPortInitOnce, vigem_internal_completion_port_init, pClient, nullptr))
+		return VIGEM_ERROR_WINAPI;
+
+	EnterCriticalSection(&pTarget->AsyncReportsLock);
+
+	const VIGEM_ERROR error = pTarget->AsyncReportError;
+	pTarget->AsyncReportError = VIGEM_ERROR_NONE;
+
+	//
+	// Replaces a report that is still waiting for a free request
+	// 
+	memcpy(&pTarget->AsyncReportPendingBuffer, buffer, sizeof(VIGEM_SUBMIT_REPORT_BUFFER));
+	pTarget->AsyncReportPendingIoControlCode = ioControlCode;
+	pTarget->AsyncReportPending = TRUE;
+
+	for (auto& report : pTarget->AsyncReports)
+	{
+		if (!report.InFlight)
 		{
-			DBGPRINT(L"No target to report to for serial %d", await.SerialNo);
+			vigem_internal_async_report_start(pClient, &report);
+			break;
 		}
-	} while (TRUE);
-
-	DEVICE_IO_CONTROL_END;
+	}
 
-	DBGPRINT(L"Finished DS4 Output Report pickup thread for 0x%p", pClient);
+	LeaveCriticalSection(&pTarget->AsyncReportsLock);
 
-	return 0;
+	return error;
 }
 
 PVIGEM_CLIENT vigem_alloc()
@@ -283,12 +598,6 @@ PVIGEM_CLIENT vigem_alloc()
 	RtlZeroMemory(driver, sizeof(VIGEM_CLIENT));
 
 	driver->hBusDevice = INVALID_HANDLE_VALUE;
-	driver->hDS4OutputReportPickupThreadAbortEvent = CreateEvent(
-		nullptr,
-		TRUE,
-		FALSE,
-		nullptr
-	);
 
 	return driver;
 }
@@ -296,11 +605,7 @@ PVIGEM_CLIENT vigem_alloc()
 void vigem_free(PVIGEM_CLIENT vigem)
 {
 	if (vigem)
-	{
-		CloseHandle(vigem->hDS4OutputReportPickupThreadAbortEvent);
-
 		free(vigem);
-	}
 }
 
 VIGEM_ERROR vigem_connect(PVIGEM_CLIENT vigem)
@@ -379,7 +684,7 @@ VIGEM_ERROR vigem_connect(PVIGEM_CLIENT vigem)
 
 		DWORD transferred = 0;
 		OVERLAPPED lOverlapped = { 0 };
-		lOverlapped.hEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+		lOverlapped.hEvent = OVERLAPPED_EVENT_SKIP_PORT(CreateEvent(nullptr, FALSE, FALSE, nullptr));
 
 		VIGEM_CHECK_VERSION version;
 		VIGEM_CHECK_VERSION_INIT(&version, VIGEM_COMMON_VERSION);
@@ -399,24 +704,28 @@ VIGEM_ERROR vigem_connect(PVIGEM_CLIENT vigem)
 		// wait for result
 		if (GetOverlappedResult(vigem->hBusDevice, &lOverlapped, &transferred, TRUE) != 0)
 		{
-			vigem->hDS4OutputReportPickupThread = CreateThread(
-				nullptr,
-				0,
-				vigem_internal_ds4_output_report_pickup_handler,
-				vigem,
-				0,
-				nullptr
-			);
+			//
+			// DS4 output reports of all targets are picked up by the completion port thread
+			// 
+			if (InitOnceExecuteOnce(&vigem->CompletionPortInitOnce, vigem_internal_completion_port_init, vigem, nullptr))
+			{
+				for (auto& await : vigem->Ds4OutputAwaits)
+					vigem_internal_ds4_output_await_start(vigem, &await);
+			}
+			else
+			{
+				DBGPRINT(L"Win32 error creating completion port: 0x%X", GetLastError());
+			}
 
 			error = VIGEM_ERROR_NONE;
 			free(detailDataBuffer);
-			CloseHandle(lOverlapped.hEvent);
+			CloseHandle(OVERLAPPED_EVENT_HANDLE(lOverlapped.hEvent));
 			break;
 		}
 
 		error = VIGEM_ERROR_BUS_VERSION_MISMATCH;
 
-		CloseHandle(lOverlapped.hEvent);
+		CloseHandle(OVERLAPPED_EVENT_HANDLE(lOverlapped.hEvent));
 		free(detailDataBuffer);
 	}
 
@@ -430,17 +739,6 @@ void vigem_disconnect(PVIGEM_CLIENT vigem)
 	if (!vigem)
 		return;
 
-	if (vigem->hDS4OutputReportPickupThread && vigem->hDS4OutputReportPickupThreadAbortEvent)
-	{
-		DBGPRINT(L"Awaiting DS4 thread clean-up for 0x%p", vigem);
-
-		SetEvent(vigem->hDS4OutputReportPickupThreadAbortEvent);
-		WaitForSingleObject(vigem->hDS4OutputReportPickupThread, INFINITE);
-		CloseHandle(vigem->hDS4OutputReportPickupThread);
-
-		DBGPRINT(L"DS4 thread clean-up for 0x%p finished", vigem);
-	}
-
 	if (vigem->hBusDevice != INVALID_HANDLE_VALUE)
 	{
 		DBGPRINT(L"Closing bus handle for 0x%p", vigem);
@@ -449,6 +747,23 @@ void vigem_disconnect(PVIGEM_CLIENT vigem)
 		vigem->hBusDevice = INVALID_HANDLE_VALUE;
 	}
 
+	if (vigem->hCompletionPortThread)
+	{
+		DBGPRINT(L"Awaiting completion port thread clean-up for 0x%p", vigem);
+
+		//
+		// Closing the bus handle cancelled the pending requests, the thread exits once they're all reported
+		// 
+		PostQueuedCompletionStatus(vigem->hCompletionPort, 0, 0, nullptr);
+		WaitForSingleObject(vigem->hCompletionPortThread, INFINITE);
+		CloseHandle(vigem->hCompletionPortThread);
+
+		DBGPRINT(L"Completion port thread clean-up for 0x%p finished", vigem);
+	}
+
+	if (vigem->hCompletionPort)
+		CloseHandle(vigem->hCompletionPort);
+
 	RtlZeroMemory(vigem, sizeof(VIGEM_CLIENT));
 }
 
@@ -495,6 +810,9 @@ PVIGEM_TARGET vigem_target_ds4_alloc(void)
 	);
 	InitializeCriticalSection(&target->Ds4CachedOutputReportUpdateLock);
 
+	DS4_SUBMIT_REPORT_EX_INIT(&target->Ds4ReportExBuffer, 0);
+	DS4_REPORT_INIT(reinterpret_cast<PDS4_REPORT>(&target->Ds4ReportExBuffer.Report)); // Same layout up to bTriggerR
+
 	return target;
 }
 
@@ -509,6 +827,22 @@ void vigem_target_free(PVIGEM_TARGET target)
 
 		DeleteCriticalSection(&target->Ds4CachedOutputReportUpdateLock);
 
+		//
+		// Wait for the async reports still processed by the driver
+		// 
+		if (target->AsyncReportsIdle)
+		{
+			WaitForSingleObject(target->AsyncReportsIdle, INFINITE);
+			CloseHandle(target->AsyncReportsIdle);
+		}
+
+		DeleteCriticalSection(&target->AsyncReportsLock);
+
+		if (target->ReportEvent)
+		{
+			CloseHandle(target->ReportEvent);
+		}
+
 		free(target);
 	}
 }
@@ -520,9 +854,9 @@ VIGEM_ERROR vigem_target_add(PVIGEM_CLIENT vigem, PVIGEM_TARGET target)
 	VIGEM_PLUGIN_TARGET plugin;
 	VIGEM_WAIT_DEVICE_READY devReady;
 	OVERLAPPED olPlugIn = { 0 };
-	olPlugIn.hEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+	olPlugIn.hEvent = OVERLAPPED_EVENT_SKIP_PORT(CreateEvent(nullptr, FALSE, FALSE, nullptr));
 	OVERLAPPED olWait = { 0 };
-	olWait.hEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+	olWait.hEvent = OVERLAPPED_EVENT_SKIP_PORT(CreateEvent(nullptr, FALSE, FALSE, nullptr));
 
 	do
 	{
@@ -649,10 +983,10 @@ VIGEM_ERROR vigem_target_add(PVIGEM_CLIENT vigem, PVIGEM_TARGET target)
 	}
 
 	if (olPlugIn.hEvent)
-		CloseHandle(olPlugIn.hEvent);
+		CloseHandle(OVERLAPPED_EVENT_HANDLE(olPlugIn.hEvent));
 
 	if (olWait.hEvent)
-		CloseHandle(olWait.hEvent);
+		CloseHandle(OVERLAPPED_EVENT_HANDLE(olWait.hEvent));
 
 	return error;
 }
@@ -874,58 +1208,14 @@ VIGEM_ERROR vigem_target_ds4_register_notification(
 	else
 		ResetEvent(target->CancelNotificationThreadEvent);
 
-	std::thread _async{
-		[](
-		PVIGEM_TARGET _Target,
-		PVIGEM_CLIENT _Client,
-		LPVOID _UserData)
-		{
-			DEVICE_IO_CONTROL_BEGIN;
-
-			DS4_REQUEST_NOTIFICATION ds4rn;
-			DS4_REQUEST_NOTIFICATION_INIT(&ds4rn, _Target->SerialNo);
-
-			do
-			{
-				DeviceIoControl(
-					_Client->hBusDevice,
-					IOCTL_DS4_REQUEST_NOTIFICATION,
-					&ds4rn,
-					ds4rn.Size,
-					&ds4rn,
-					ds4rn.Size,
-					&transferred,
-					&lOverlapped
-				);
-
-				if (GetOverlappedResult(_Client->hBusDevice, &lOverlapped, &transferred, TRUE) != 0)
-				{
-					if (_Target->Notification == nullptr)
-					{
-						DEVICE_IO_CONTROL_END;
-						return;
-					}
-
-					reinterpret_cast<PFN_VIGEM_DS4_NOTIFICATION>(_Target->Notification)(
-						_Client, _Target, ds4rn.Report.LargeMotor,
-						ds4rn.Report.SmallMotor,
-						ds4rn.Report.LightbarColor, _UserData
-					);
-
-					continue;
-				}
+	if (!InitOnceExecuteOnce(&vigem->CompletionPortInitOnce, vigem_internal_completion_port_init, vigem, nullptr))
+		return VIGEM_ERROR_WINAPI;
 
-				if (GetLastError() == ERROR_ACCESS_DENIED || GetLastError() == ERROR_OPERATION_ABORTED)
-				{
-					DEVICE_IO_CONTROL_END;
-					return;
-				}
-			} while (TRUE);
-		},
-		target, vigem, userData
-	};
-
-	_async.detach();
+	//
+	// A request still pending from a previous registration picks up the new callback
+	// 
+	if (InterlockedCompareExchange(&target->Ds4NotificationRequest.InFlight, TRUE, FALSE) == FALSE)
+		vigem_internal_ds4_notification_start(vigem, &target->Ds4NotificationRequest);
 
 	return VIGEM_ERROR_NONE;
 }
@@ -1133,6 +1423,249 @@ VIGEM_ERROR vigem_target_ds4_update_ex(
 	return VIGEM_ERROR_NONE;
 }
 
+VIGEM_ERROR vigem_target_x360_update_async(
+	PVIGEM_CLIENT vigem,
+	PVIGEM_TARGET target,
+	XUSB_REPORT report
+)
+{
+	if (!vigem)
+		return VIGEM_ERROR_BUS_INVALID_HANDLE;
+
+	if (!target)
+		return VIGEM_ERROR_INVALID_TARGET;
+
+	if (vigem->hBusDevice == INVALID_HANDLE_VALUE)
+		return VIGEM_ERROR_BUS_NOT_FOUND;
+
+	if (target->SerialNo == 0)
+		return VIGEM_ERROR_INVALID_TARGET;
+
+	VIGEM_SUBMIT_REPORT_BUFFER buffer;
+	XUSB_SUBMIT_REPORT_INIT(&buffer.Xusb, target->SerialNo);
+
+	buffer.Xusb.Report = report;
+
+	return vigem_internal_async_report_submit(vigem, target, IOCTL_XUSB_SUBMIT_REPORT, &buffer);
+}
+
+VIGEM_ERROR vigem_target_ds4_update_ex_async(
+	PVIGEM_CLIENT vigem,
+	PVIGEM_TARGET target,
+	DS4_REPORT_EX report
+)
+{
+	if (!vigem)
+		return VIGEM_ERROR_BUS_INVALID_HANDLE;
+
+	if (!target)
+		return VIGEM_ERROR_INVALID_TARGET;
+
+	if (vigem->hBusDevice == INVALID_HANDLE_VALUE)
+		return VIGEM_ERROR_BUS_NOT_FOUND;
+
+	if (target->SerialNo == 0)
+		return VIGEM_ERROR_INVALID_TARGET;
+
+	VIGEM_SUBMIT_REPORT_BUFFER buffer;
+	DS4_SUBMIT_REPORT_EX_INIT(&buffer.Ds4Ex, target->SerialNo);
+
+	buffer.Ds4Ex.Report = report;
+
+	// Same IOCTL, just different size
+	return vigem_internal_async_report_submit(vigem, target, IOCTL_DS4_SUBMIT_REPORT, &buffer);
+}
+
+//
+// Maps the failure of a report submission like the single target update functions do.
+// 
+static VIGEM_ERROR vigem_internal_batch_report_error(PVIGEM_TARGET target, DWORD error)
+{
+	if (error == ERROR_ACCESS_DENIED)
+		return VIGEM_ERROR_INVALID_TARGET;
+
+	if (error == ERROR_INVALID_PARAMETER && target->Type == DualShock4Wired)
+		return VIGEM_ERROR_NOT_SUPPORTED;
+
+	return VIGEM_ERROR_NONE;
+}
+
+VIGEM_ERROR vigem_targets_update_batch(
+	PVIGEM_CLIENT vigem,
+	PVIGEM_TARGET_REPORT reports,
+	ULONG count
+)
+{
+	if (!vigem)
+		return VIGEM_ERROR_BUS_INVALID_HANDLE;
+
+	if (vigem->hBusDevice == INVALID_HANDLE_VALUE)
+		return VIGEM_ERROR_BUS_NOT_FOUND;
+
+	if (!reports && count > 0)
+		return VIGEM_ERROR_INVALID_PARAMETER;
+
+	//
+	// Submit all the reports first
+	// 
+	for (ULONG i = 0; i < count; i++)
+	{
+		const auto report = &reports[i];
+		const PVIGEM_TARGET target = report->Target;
+
+		report->Error = VIGEM_ERROR_NONE;
+
+		if (!target || target->SerialNo == 0 || target->BatchPending)
+		{
+			report->Error = VIGEM_ERROR_INVALID_TARGET;
+			continue;
+		}
+
+		if (!target->ReportEvent)
+		{
+			report->Error = VIGEM_ERROR_WINAPI;
+			continue;
+		}
+
+		DWORD ioControlCode;
+
+		if (target->Type == DualShock4Wired)
+		{
+			DS4_SUBMIT_REPORT_EX_INIT(&target->BatchBuffer.Ds4Ex, target->SerialNo);
+			target->BatchBuffer.Ds4Ex.Report = report->Report.Ds4Ex;
+			ioControlCode = IOCTL_DS4_SUBMIT_REPORT; // Same IOCTL, just different size
+		}
+		else
+		{
+			XUSB_SUBMIT_REPORT_INIT(&target->BatchBuffer.Xusb, target->SerialNo);
+			target->BatchBuffer.Xusb.Report = report->Report.Xusb;
+			ioControlCode = IOCTL_XUSB_SUBMIT_REPORT;
+		}
+
+		RtlZeroMemory(&target->ReportOverlapped, sizeof(OVERLAPPED));
+		target->ReportOverlapped.hEvent = OVERLAPPED_EVENT_SKIP_PORT(target->ReportEvent);
+
+		if (DeviceIoControl(
+			vigem->hBusDevice,
+			ioControlCode,
+			&target->BatchBuffer,
+			target->BatchBuffer.Xusb.Size, // Both submissions start with their size
+			nullptr,
+			0,
+			nullptr,
+			&target->ReportOverlapped
+		) || GetLastError() == ERROR_IO_PENDING)
+		{
+			target->BatchPending = TRUE;
+			continue;
+		}
+
+		report->Error = vigem_internal_batch_report_error(target, GetLastError());
+	}
+
+	//
+	// Then collect the results, this only waits for the requests the driver didn't complete yet
+	// 
+	VIGEM_ERROR error = VIGEM_ERROR_NONE;
+
+	for (ULONG i = 0; i < count; i++)
+	{
+		const auto report = &reports[i];
+		const PVIGEM_TARGET target = report->Target;
+
+		if (report->Error == VIGEM_ERROR_NONE && target->BatchPending)
+		{
+			DWORD transferred = 0;
+
+			target->BatchPending = FALSE;
+
+			if (GetOverlappedResult(vigem->hBusDevice, &target->ReportOverlapped, &transferred, TRUE) == 0)
+				report->Error = vigem_internal_batch_report_error(target, GetLastError());
+		}
+
+		if (error == VIGEM_ERROR_NONE)
+			error = report->Error;
+	}
+
+	return error;
+}
+
+PDS4_REPORT_EX vigem_target_ds4_get_report_ex_buffer(PVIGEM_TARGET target)
+{
+	if (!target || target->Type != DualShock4Wired)
+		return nullptr;
+
+	return &target->Ds4ReportExBuffer.Report;
+}
+
+VIGEM_ERROR vigem_target_ds4_update_ex_buffer(
+	PVIGEM_CLIENT vigem,
+	PVIGEM_TARGET target
+)
+{
+	if (!vigem)
+		return VIGEM_ERROR_BUS_INVALID_HANDLE;
+
+	if (!target)
+		return VIGEM_ERROR_INVALID_TARGET;
+
+	if (vigem->hBusDevice == INVALID_HANDLE_VALUE)
+		return VIGEM_ERROR_BUS_NOT_FOUND;
+
+	if (target->SerialNo == 0 || target->Type != DualShock4Wired)
+		return VIGEM_ERROR_INVALID_TARGET;
+
+	if (!target->ReportEvent)
+		return VIGEM_ERROR_WINAPI;
+
+	//
+	// The serial number changes when the target is added again
+	// 
+	if (target->Ds4ReportExBuffer.SerialNo != target->SerialNo)
+	{
+		target->Ds4ReportExBuffer.SerialNo = target->SerialNo;
+		target->IsDs4ReportExSubmitted = FALSE;
+	}
+
+	if (target->IsDs4ReportExSubmitted &&
+		memcmp(&target->Ds4ReportExSubmitted, &target->Ds4ReportExBuffer.Report, sizeof(DS4_REPORT_EX)) == 0)
+		return VIGEM_ERROR_NONE;
+
+	DWORD transferred = 0;
+	RtlZeroMemory(&target->ReportOverlapped, sizeof(OVERLAPPED));
+	target->ReportOverlapped.hEvent = OVERLAPPED_EVENT_SKIP_PORT(target->ReportEvent);
+
+	//
+	// Sent from the buffer, the driver copies it before completing the request
+	// 
+	if (!DeviceIoControl(
+		vigem->hBusDevice,
+		IOCTL_DS4_SUBMIT_REPORT, // Same IOCTL, just different size
+		&target->Ds4ReportExBuffer,
+		target->Ds4ReportExBuffer.Size,
+		nullptr,
+		0,
+		&transferred,
+		&target->ReportOverlapped
+	) && GetLastError() != ERROR_IO_PENDING)
+	{
+		return vigem_internal_batch_report_error(target, GetLastError());
+	}
+
+	if (GetOverlappedResult(vigem->hBusDevice, &target->ReportOverlapped, &transferred, TRUE) == 0)
+	{
+		const VIGEM_ERROR error = vigem_internal_batch_report_error(target, GetLastError());
+
+		if (error != VIGEM_ERROR_NONE)
+			return error;
+	}
+
+	memcpy(&target->Ds4ReportExSubmitted, &target->Ds4ReportExBuffer.Report, sizeof(DS4_REPORT_EX));
+	target->IsDs4ReportExSubmitted = TRUE;
+
+	return VIGEM_ERROR_NONE;
+}
+
 ULONG vigem_target_get_index(PVIGEM_TARGET target)
 {
 	return target->SerialNo;
@@ -1298,7 +1831,7 @@ VIGEM_ERROR vigem_target_x360_get_output(
 
     DWORD transferred = 0;
     OVERLAPPED lOverlapped = { 0 };
-    lOverlapped.hEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    lOverlapped.hEvent = OVERLAPPED_EVENT_SKIP_PORT(CreateEvent(nullptr, FALSE, FALSE, nullptr));
 
     XUSB_REQUEST_NOTIFICATION xrn;
     XUSB_REQUEST_NOTIFICATION_INIT(&xrn, target->SerialNo);
@@ -1319,7 +1852,7 @@ VIGEM_ERROR vigem_target_x360_get_output(
         return VIGEM_ERROR_INVALID_TARGET;
     }
 
-    CloseHandle(lOverlapped.hEvent);
+    CloseHandle(OVERLAPPED_EVENT_HANDLE(lOverlapped.hEvent));
 
     output->LargeMotor = xrn.LargeMotor;
     output->SmallMotor = xrn.SmallMotor;
@@ -1351,7 +1884,7 @@ VIGEM_ERROR vigem_target_ds4_get_output(
 
     DWORD transferred = 0;
     OVERLAPPED lOverlapped = { 0 };
-    lOverlapped.hEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    lOverlapped.hEvent = OVERLAPPED_EVENT_SKIP_PORT(CreateEvent(nullptr, FALSE, FALSE, nullptr));
 
     DS4_REQUEST_NOTIFICATION ds4rn;
     DS4_REQUEST_NOTIFICATION_INIT(&ds4rn, target->SerialNo);
@@ -1372,7 +1905,7 @@ VIGEM_ERROR vigem_target_ds4_get_output(
         return VIGEM_ERROR_INVALID_TARGET;
     }
 
-    CloseHandle(lOverlapped.hEvent);
+    CloseHandle(OVERLAPPED_EVENT_HANDLE(lOverlapped.hEvent));
 
     output->LargeMotor = ds4rn.Report.LargeMotor;
     output->SmallMotor = ds4rn.Report.SmallMotor;
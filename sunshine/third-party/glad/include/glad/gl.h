@@ -4238,10 +4238,18 @@ gladLoadGLContextUserPtr(GladGLContext *context, GLADuserptrloadfunc load, void
 GLAD_API_CALL int
 gladLoadGLContext(GladGLContext *context, GLADloadfunc load);
 
+/* Resolve the entry points on their first call (see src/gl.c) */
+GLAD_API_CALL int
+gladLoadGLContextLazyUserPtr(GladGLContext *context, GLADuserptrloadfunc load, void *userptr);
+GLAD_API_CALL int
+gladLoadGLContextLazy(GladGLContext *context, GLADloadfunc load);
+
 #ifdef GLAD_GL
 
 GLAD_API_CALL int
 gladLoaderLoadGLContext(GladGLContext *context);
+GLAD_API_CALL int
+gladLoaderLoadGLContextLazy(GladGLContext *context);
 GLAD_API_CALL void
 gladLoaderUnloadGL(void);
 
@@ -1338,6 +1338,1116 @@ int gladLoadGLContext(GladGLContext *context, GLADloadfunc load) {
     return gladLoadGLContextUserPtr(context, glad_gl_get_proc_from_userptr, GLAD_GNUC_EXTENSION (void*) load);
 }
 
+/*
+ * Lazy loading: every entry point of the context starts as a trampoline, which
+ * resolves the real function on its first call, stores it in the context and
+ * forwards the call. Only the functions actually used are looked up, instead of
+ * the whole API at load time.
+ *
+ * The trampolines reference a single context: only one context may be loaded
+ * lazily at a time. Concurrent first calls of the same function resolve it
+ * twice, storing the same pointer.
+ */
+
+#define GLAD_GL_LAZY_PROCS(X, XR) \
+    X(EGLImageTargetTexture2DOES, PFNGLEGLIMAGETARGETTEXTURE2DOESPROC, (GLenum target, GLeglImageOES image), (target, image)) \
+    X(Accum, PFNGLACCUMPROC, (GLenum op, GLfloat value), (op, value)) \
+    X(ActiveShaderProgram, PFNGLACTIVESHADERPROGRAMPROC, (GLuint pipeline, GLuint program), (pipeline, program)) \
+    X(ActiveTexture, PFNGLACTIVETEXTUREPROC, (GLenum texture), (texture)) \
+    X(AlphaFunc, PFNGLALPHAFUNCPROC, (GLenum func, GLfloat ref), (func, ref)) \
+    XR(GLboolean, AreTexturesResident, PFNGLARETEXTURESRESIDENTPROC, (GLsizei n, const GLuint *textures, GLboolean *residences), (n, textures, residences)) \
+    X(ArrayElement, PFNGLARRAYELEMENTPROC, (GLint i), (i)) \
+    X(AttachShader, PFNGLATTACHSHADERPROC, (GLuint program, GLuint shader), (program, shader)) \
+    X(Begin, PFNGLBEGINPROC, (GLenum mode), (mode)) \
+    X(BeginConditionalRender, PFNGLBEGINCONDITIONALRENDERPROC, (GLuint id, GLenum mode), (id, mode)) \
+    X(BeginQuery, PFNGLBEGINQUERYPROC, (GLenum target, GLuint id), (target, id)) \
+    X(BeginQueryIndexed, PFNGLBEGINQUERYINDEXEDPROC, (GLenum target, GLuint index, GLuint id), (target, index, id)) \
+    X(BeginTransformFeedback, PFNGLBEGINTRANSFORMFEEDBACKPROC, (GLenum primitiveMode), (primitiveMode)) \
+    X(BindAttribLocation, PFNGLBINDATTRIBLOCATIONPROC, (GLuint program, GLuint index, const GLchar *name), (program, index, name)) \
+    X(BindBuffer, PFNGLBINDBUFFERPROC, (GLenum target, GLuint buffer), (target, buffer)) \
+    X(BindBufferBase, PFNGLBINDBUFFERBASEPROC, (GLenum target, GLuint index, GLuint buffer), (target, index, buffer)) \
+    X(BindBufferRange, PFNGLBINDBUFFERRANGEPROC, (GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size), (target, index, buffer, offset, size)) \
+    X(BindBuffersBase, PFNGLBINDBUFFERSBASEPROC, (GLenum target, GLuint first, GLsizei count, const GLuint *buffers), (target, first, count, buffers)) \
+    X(BindBuffersRange, PFNGLBINDBUFFERSRANGEPROC, (GLenum target, GLuint first, GLsizei count, const GLuint *buffers, const GLintptr *offsets, const GLsizeiptr *sizes), (target, first, count, buffers, offsets, sizes)) \
+    X(BindFragDataLocation, PFNGLBINDFRAGDATALOCATIONPROC, (GLuint program, GLuint color, const GLchar *name), (program, color, name)) \
+    X(BindFragDataLocationIndexed, PFNGLBINDFRAGDATALOCATIONINDEXEDPROC, (GLuint program, GLuint colorNumber, GLuint index, const GLchar *name), (program, colorNumber, index, name)) \
+    X(BindFramebuffer, PFNGLBINDFRAMEBUFFERPROC, (GLenum target, GLuint framebuffer), (target, framebuffer)) \
+    X(BindImageTexture, PFNGLBINDIMAGETEXTUREPROC, (GLuint unit, GLuint texture, GLint level, GLboolean layered, GLint layer, GLenum access, GLenum format), (unit, texture, level, layered, layer, access, format)) \
+    X(BindImageTextures, PFNGLBINDIMAGETEXTURESPROC, (GLuint first, GLsizei count, const GLuint *textures), (first, count, textures)) \
+    X(BindProgramPipeline, PFNGLBINDPROGRAMPIPELINEPROC, (GLuint pipeline), (pipeline)) \
+    X(BindRenderbuffer, PFNGLBINDRENDERBUFFERPROC, (GLenum target, GLuint renderbuffer), (target, renderbuffer)) \
+    X(BindSampler, PFNGLBINDSAMPLERPROC, (GLuint unit, GLuint sampler), (unit, sampler)) \
+    X(BindSamplers, PFNGLBINDSAMPLERSPROC, (GLuint first, GLsizei count, const GLuint *samplers), (first, count, samplers)) \
+    X(BindTexture, PFNGLBINDTEXTUREPROC, (GLenum target, GLuint texture), (target, texture)) \
+    X(BindTextureUnit, PFNGLBINDTEXTUREUNITPROC, (GLuint unit, GLuint texture), (unit, texture)) \
+    X(BindTextures, PFNGLBINDTEXTURESPROC, (GLuint first, GLsizei count, const GLuint *textures), (first, count, textures)) \
+    X(BindTransformFeedback, PFNGLBINDTRANSFORMFEEDBACKPROC, (GLenum target, GLuint id), (target, id)) \
+    X(BindVertexArray, PFNGLBINDVERTEXARRAYPROC, (GLuint array), (array)) \
+    X(BindVertexBuffer, PFNGLBINDVERTEXBUFFERPROC, (GLuint bindingindex, GLuint buffer, GLintptr offset, GLsizei stride), (bindingindex, buffer, offset, stride)) \
+    X(BindVertexBuffers, PFNGLBINDVERTEXBUFFERSPROC, (GLuint first, GLsizei count, const GLuint *buffers, const GLintptr *offsets, const GLsizei *strides), (first, count, buffers, offsets, strides)) \
+    X(Bitmap, PFNGLBITMAPPROC, (GLsizei width, GLsizei height, GLfloat xorig, GLfloat yorig, GLfloat xmove, GLfloat ymove, const GLubyte *bitmap), (width, height, xorig, yorig, xmove, ymove, bitmap)) \
+    X(BlendColor, PFNGLBLENDCOLORPROC, (GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha), (red, green, blue, alpha)) \
+    X(BlendEquation, PFNGLBLENDEQUATIONPROC, (GLenum mode), (mode)) \
+    X(BlendEquationSeparate, PFNGLBLENDEQUATIONSEPARATEPROC, (GLenum modeRGB, GLenum modeAlpha), (modeRGB, modeAlpha)) \
+    X(BlendEquationSeparatei, PFNGLBLENDEQUATIONSEPARATEIPROC, (GLuint buf, GLenum modeRGB, GLenum modeAlpha), (buf, modeRGB, modeAlpha)) \
+    X(BlendEquationi, PFNGLBLENDEQUATIONIPROC, (GLuint buf, GLenum mode), (buf, mode)) \
+    X(BlendFunc, PFNGLBLENDFUNCPROC, (GLenum sfactor, GLenum dfactor), (sfactor, dfactor)) \
+    X(BlendFuncSeparate, PFNGLBLENDFUNCSEPARATEPROC, (GLenum sfactorRGB, GLenum dfactorRGB, GLenum sfactorAlpha, GLenum dfactorAlpha), (sfactorRGB, dfactorRGB, sfactorAlpha, dfactorAlpha)) \
+    X(BlendFuncSeparatei, PFNGLBLENDFUNCSEPARATEIPROC, (GLuint buf, GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha), (buf, srcRGB, dstRGB, srcAlpha, dstAlpha)) \
+    X(BlendFunci, PFNGLBLENDFUNCIPROC, (GLuint buf, GLenum src, GLenum dst), (buf, src, dst)) \
+    X(BlitFramebuffer, PFNGLBLITFRAMEBUFFERPROC, (GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter), (srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, mask, filter)) \
+    X(BlitNamedFramebuffer, PFNGLBLITNAMEDFRAMEBUFFERPROC, (GLuint readFramebuffer, GLuint drawFramebuffer, GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter), (readFramebuffer, drawFramebuffer, srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, mask, filter)) \
+    X(BufferData, PFNGLBUFFERDATAPROC, (GLenum target, GLsizeiptr size, const void *data, GLenum usage), (target, size, data, usage)) \
+    X(BufferStorage, PFNGLBUFFERSTORAGEPROC, (GLenum target, GLsizeiptr size, const void *data, GLbitfield flags), (target, size, data, flags)) \
+    X(BufferSubData, PFNGLBUFFERSUBDATAPROC, (GLenum target, GLintptr offset, GLsizeiptr size, const void *data), (target, offset, size, data)) \
+    X(CallList, PFNGLCALLLISTPROC, (GLuint list), (list)) \
+    X(CallLists, PFNGLCALLLISTSPROC, (GLsizei n, GLenum type, const void *lists), (n, type, lists)) \
+    XR(GLenum, CheckFramebufferStatus, PFNGLCHECKFRAMEBUFFERSTATUSPROC, (GLenum target), (target)) \
+    XR(GLenum, CheckNamedFramebufferStatus, PFNGLCHECKNAMEDFRAMEBUFFERSTATUSPROC, (GLuint framebuffer, GLenum target), (framebuffer, target)) \
+    X(ClampColor, PFNGLCLAMPCOLORPROC, (GLenum target, GLenum clamp), (target, clamp)) \
+    X(Clear, PFNGLCLEARPROC, (GLbitfield mask), (mask)) \
+    X(ClearAccum, PFNGLCLEARACCUMPROC, (GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha), (red, green, blue, alpha)) \
+    X(ClearBufferData, PFNGLCLEARBUFFERDATAPROC, (GLenum target, GLenum internalformat, GLenum format, GLenum type, const void *data), (target, internalformat, format, type, data)) \
+    X(ClearBufferSubData, PFNGLCLEARBUFFERSUBDATAPROC, (GLenum target, GLenum internalformat, GLintptr offset, GLsizeiptr size, GLenum format, GLenum type, const void *data), (target, internalformat, offset, size, format, type, data)) \
+    X(ClearBufferfi, PFNGLCLEARBUFFERFIPROC, (GLenum buffer, GLint drawbuffer, GLfloat depth, GLint stencil), (buffer, drawbuffer, depth, stencil)) \
+    X(ClearBufferfv, PFNGLCLEARBUFFERFVPROC, (GLenum buffer, GLint drawbuffer, const GLfloat *value), (buffer, drawbuffer, value)) \
+    X(ClearBufferiv, PFNGLCLEARBUFFERIVPROC, (GLenum buffer, GLint drawbuffer, const GLint *value), (buffer, drawbuffer, value)) \
+    X(ClearBufferuiv, PFNGLCLEARBUFFERUIVPROC, (GLenum buffer, GLint drawbuffer, const GLuint *value), (buffer, drawbuffer, value)) \
+    X(ClearColor, PFNGLCLEARCOLORPROC, (GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha), (red, green, blue, alpha)) \
+    X(ClearDepth, PFNGLCLEARDEPTHPROC, (GLdouble depth), (depth)) \
+    X(ClearDepthf, PFNGLCLEARDEPTHFPROC, (GLfloat d), (d)) \
+    X(ClearIndex, PFNGLCLEARINDEXPROC, (GLfloat c), (c)) \
+    X(ClearNamedBufferData, PFNGLCLEARNAMEDBUFFERDATAPROC, (GLuint buffer, GLenum internalformat, GLenum format, GLenum type, const void *data), (buffer, internalformat, format, type, data)) \
+    X(ClearNamedBufferSubData, PFNGLCLEARNAMEDBUFFERSUBDATAPROC, (GLuint buffer, GLenum internalformat, GLintptr offset, GLsizeiptr size, GLenum format, GLenum type, const void *data), (buffer, internalformat, offset, size, format, type, data)) \
+    X(ClearNamedFramebufferfi, PFNGLCLEARNAMEDFRAMEBUFFERFIPROC, (GLuint framebuffer, GLenum buffer, GLint drawbuffer, GLfloat depth, GLint stencil), (framebuffer, buffer, drawbuffer, depth, stencil)) \
+    X(ClearNamedFramebufferfv, PFNGLCLEARNAMEDFRAMEBUFFERFVPROC, (GLuint framebuffer, GLenum buffer, GLint drawbuffer, const GLfloat *value), (framebuffer, buffer, drawbuffer, value)) \
+    X(ClearNamedFramebufferiv, PFNGLCLEARNAMEDFRAMEBUFFERIVPROC, (GLuint framebuffer, GLenum buffer, GLint drawbuffer, const GLint *value), (framebuffer, buffer, drawbuffer, value)) \
+    X(ClearNamedFramebufferuiv, PFNGLCLEARNAMEDFRAMEBUFFERUIVPROC, (GLuint framebuffer, GLenum buffer, GLint drawbuffer, const GLuint *value), (framebuffer, buffer, drawbuffer, value)) \
+    X(ClearStencil, PFNGLCLEARSTENCILPROC, (GLint s), (s)) \
+    X(ClearTexImage, PFNGLCLEARTEXIMAGEPROC, (GLuint texture, GLint level, GLenum format, GLenum type, const void *data), (texture, level, format, type, data)) \
+    X(ClearTexSubImage, PFNGLCLEARTEXSUBIMAGEPROC, (GLuint texture, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const void *data), (texture, level, xoffset, yoffset, zoffset, width, height, depth, format, type, data)) \
+    X(ClientActiveTexture, PFNGLCLIENTACTIVETEXTUREPROC, (GLenum texture), (texture)) \
+    XR(GLenum, ClientWaitSync, PFNGLCLIENTWAITSYNCPROC, (GLsync sync, GLbitfield flags, GLuint64 timeout), (sync, flags, timeout)) \
+    X(ClipControl, PFNGLCLIPCONTROLPROC, (GLenum origin, GLenum depth), (origin, depth)) \
+    X(ClipPlane, PFNGLCLIPPLANEPROC, (GLenum plane, const GLdouble *equation), (plane, equation)) \
+    X(Color3b, PFNGLCOLOR3BPROC, (GLbyte red, GLbyte green, GLbyte blue), (red, green, blue)) \
+    X(Color3bv, PFNGLCOLOR3BVPROC, (const GLbyte *v), (v)) \
+    X(Color3d, PFNGLCOLOR3DPROC, (GLdouble red, GLdouble green, GLdouble blue), (red, green, blue)) \
+    X(Color3dv, PFNGLCOLOR3DVPROC, (const GLdouble *v), (v)) \
+    X(Color3f, PFNGLCOLOR3FPROC, (GLfloat red, GLfloat green, GLfloat blue), (red, green, blue)) \
+    X(Color3fv, PFNGLCOLOR3FVPROC, (const GLfloat *v), (v)) \
+    X(Color3i, PFNGLCOLOR3IPROC, (GLint red, GLint green, GLint blue), (red, green, blue)) \
+    X(Color3iv, PFNGLCOLOR3IVPROC, (const GLint *v), (v)) \
+    X(Color3s, PFNGLCOLOR3SPROC, (GLshort red, GLshort green, GLshort blue), (red, green, blue)) \
+    X(Color3sv, PFNGLCOLOR3SVPROC, (const GLshort *v), (v)) \
+    X(Color3ub, PFNGLCOLOR3UBPROC, (GLubyte red, GLubyte green, GLubyte blue), (red, green, blue)) \
+    X(Color3ubv, PFNGLCOLOR3UBVPROC, (const GLubyte *v), (v)) \
+    X(Color3ui, PFNGLCOLOR3UIPROC, (GLuint red, GLuint green, GLuint blue), (red, green, blue)) \
+    X(Color3uiv, PFNGLCOLOR3UIVPROC, (const GLuint *v), (v)) \
+    X(Color3us, PFNGLCOLOR3USPROC, (GLushort red, GLushort green, GLushort blue), (red, green, blue)) \
+    X(Color3usv, PFNGLCOLOR3USVPROC, (const GLushort *v), (v)) \
+    X(Color4b, PFNGLCOLOR4BPROC, (GLbyte red, GLbyte green, GLbyte blue, GLbyte alpha), (red, green, blue, alpha)) \
+    X(Color4bv, PFNGLCOLOR4BVPROC, (const GLbyte *v), (v)) \
+    X(Color4d, PFNGLCOLOR4DPROC, (GLdouble red, GLdouble green, GLdouble blue, GLdouble alpha), (red, green, blue, alpha)) \
+    X(Color4dv, PFNGLCOLOR4DVPROC, (const GLdouble *v), (v)) \
+    X(Color4f, PFNGLCOLOR4FPROC, (GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha), (red, green, blue, alpha)) \
+    X(Color4fv, PFNGLCOLOR4FVPROC, (const GLfloat *v), (v)) \
+    X(Color4i, PFNGLCOLOR4IPROC, (GLint red, GLint green, GLint blue, GLint alpha), (red, green, blue, alpha)) \
+    X(Color4iv, PFNGLCOLOR4IVPROC, (const GLint *v), (v)) \
+    X(Color4s, PFNGLCOLOR4SPROC, (GLshort red, GLshort green, GLshort blue, GLshort alpha), (red, green, blue, alpha)) \
+    X(Color4sv, PFNGLCOLOR4SVPROC, (const GLshort *v), (v)) \
+    X(Color4ub, PFNGLCOLOR4UBPROC, (GLubyte red, GLubyte green, GLubyte blue, GLubyte alpha), (red, green, blue, alpha)) \
+    X(Color4ubv, PFNGLCOLOR4UBVPROC, (const GLubyte *v), (v)) \
+    X(Color4ui, PFNGLCOLOR4UIPROC, (GLuint red, GLuint green, GLuint blue, GLuint alpha), (red, green, blue, alpha)) \
+    X(Color4uiv, PFNGLCOLOR4UIVPROC, (const GLuint *v), (v)) \
+    X(Color4us, PFNGLCOLOR4USPROC, (GLushort red, GLushort green, GLushort blue, GLushort alpha), (red, green, blue, alpha)) \
+    X(Color4usv, PFNGLCOLOR4USVPROC, (const GLushort *v), (v)) \
+    X(ColorMask, PFNGLCOLORMASKPROC, (GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha), (red, green, blue, alpha)) \
+    X(ColorMaski, PFNGLCOLORMASKIPROC, (GLuint index, GLboolean r, GLboolean g, GLboolean b, GLboolean a), (index, r, g, b, a)) \
+    X(ColorMaterial, PFNGLCOLORMATERIALPROC, (GLenum face, GLenum mode), (face, mode)) \
+    X(ColorP3ui, PFNGLCOLORP3UIPROC, (GLenum type, GLuint color), (type, color)) \
+    X(ColorP3uiv, PFNGLCOLORP3UIVPROC, (GLenum type, const GLuint *color), (type, color)) \
+    X(ColorP4ui, PFNGLCOLORP4UIPROC, (GLenum type, GLuint color), (type, color)) \
+    X(ColorP4uiv, PFNGLCOLORP4UIVPROC, (GLenum type, const GLuint *color), (type, color)) \
+    X(ColorPointer, PFNGLCOLORPOINTERPROC, (GLint size, GLenum type, GLsizei stride, const void *pointer), (size, type, stride, pointer)) \
+    X(CompileShader, PFNGLCOMPILESHADERPROC, (GLuint shader), (shader)) \
+    X(CompressedTexImage1D, PFNGLCOMPRESSEDTEXIMAGE1DPROC, (GLenum target, GLint level, GLenum internalformat, GLsizei width, GLint border, GLsizei imageSize, const void *data), (target, level, internalformat, width, border, imageSize, data)) \
+    X(CompressedTexImage2D, PFNGLCOMPRESSEDTEXIMAGE2DPROC, (GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const void *data), (target, level, internalformat, width, height, border, imageSize, data)) \
+    X(CompressedTexImage3D, PFNGLCOMPRESSEDTEXIMAGE3DPROC, (GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLsizei depth, GLint border, GLsizei imageSize, const void *data), (target, level, internalformat, width, height, depth, border, imageSize, data)) \
+    X(CompressedTexSubImage1D, PFNGLCOMPRESSEDTEXSUBIMAGE1DPROC, (GLenum target, GLint level, GLint xoffset, GLsizei width, GLenum format, GLsizei imageSize, const void *data), (target, level, xoffset, width, format, imageSize, data)) \
+    X(CompressedTexSubImage2D, PFNGLCOMPRESSEDTEXSUBIMAGE2DPROC, (GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLsizei imageSize, const void *data), (target, level, xoffset, yoffset, width, height, format, imageSize, data)) \
+    X(CompressedTexSubImage3D, PFNGLCOMPRESSEDTEXSUBIMAGE3DPROC, (GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLsizei imageSize, const void *data), (target, level, xoffset, yoffset, zoffset, width, height, depth, format, imageSize, data)) \
+    X(CompressedTextureSubImage1D, PFNGLCOMPRESSEDTEXTURESUBIMAGE1DPROC, (GLuint texture, GLint level, GLint xoffset, GLsizei width, GLenum format, GLsizei imageSize, const void *data), (texture, level, xoffset, width, format, imageSize, data)) \
+    X(CompressedTextureSubImage2D, PFNGLCOMPRESSEDTEXTURESUBIMAGE2DPROC, (GLuint texture, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLsizei imageSize, const void *data), (texture, level, xoffset, yoffset, width, height, format, imageSize, data)) \
+    X(CompressedTextureSubImage3D, PFNGLCOMPRESSEDTEXTURESUBIMAGE3DPROC, (GLuint texture, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLsizei imageSize, const void *data), (texture, level, xoffset, yoffset, zoffset, width, height, depth, format, imageSize, data)) \
+    X(CopyBufferSubData, PFNGLCOPYBUFFERSUBDATAPROC, (GLenum readTarget, GLenum writeTarget, GLintptr readOffset, GLintptr writeOffset, GLsizeiptr size), (readTarget, writeTarget, readOffset, writeOffset, size)) \
+    X(CopyImageSubData, PFNGLCOPYIMAGESUBDATAPROC, (GLuint srcName, GLenum srcTarget, GLint srcLevel, GLint srcX, GLint srcY, GLint srcZ, GLuint dstName, GLenum dstTarget, GLint dstLevel, GLint dstX, GLint dstY, GLint dstZ, GLsizei srcWidth, GLsizei srcHeight, GLsizei srcDepth), (srcName, srcTarget, srcLevel, srcX, srcY, srcZ, dstName, dstTarget, dstLevel, dstX, dstY, dstZ, srcWidth, srcHeight, srcDepth)) \
+    X(CopyNamedBufferSubData, PFNGLCOPYNAMEDBUFFERSUBDATAPROC, (GLuint readBuffer, GLuint writeBuffer, GLintptr readOffset, GLintptr writeOffset, GLsizeiptr size), (readBuffer, writeBuffer, readOffset, writeOffset, size)) \
+    X(CopyPixels, PFNGLCOPYPIXELSPROC, (GLint x, GLint y, GLsizei width, GLsizei height, GLenum type), (x, y, width, height, type)) \
+    X(CopyTexImage1D, PFNGLCOPYTEXIMAGE1DPROC, (GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLint border), (target, level, internalformat, x, y, width, border)) \
+    X(CopyTexImage2D, PFNGLCOPYTEXIMAGE2DPROC, (GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLsizei height, GLint border), (target, level, internalformat, x, y, width, height, border)) \
+    X(CopyTexSubImage1D, PFNGLCOPYTEXSUBIMAGE1DPROC, (GLenum target, GLint level, GLint xoffset, GLint x, GLint y, GLsizei width), (target, level, xoffset, x, y, width)) \
+    X(CopyTexSubImage2D, PFNGLCOPYTEXSUBIMAGE2DPROC, (GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint x, GLint y, GLsizei width, GLsizei height), (target, level, xoffset, yoffset, x, y, width, height)) \
+    X(CopyTexSubImage3D, PFNGLCOPYTEXSUBIMAGE3DPROC, (GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLint x, GLint y, GLsizei width, GLsizei height), (target, level, xoffset, yoffset, zoffset, x, y, width, height)) \
+    X(CopyTextureSubImage1D, PFNGLCOPYTEXTURESUBIMAGE1DPROC, (GLuint texture, GLint level, GLint xoffset, GLint x, GLint y, GLsizei width), (texture, level, xoffset, x, y, width)) \
+    X(CopyTextureSubImage2D, PFNGLCOPYTEXTURESUBIMAGE2DPROC, (GLuint texture, GLint level, GLint xoffset, GLint yoffset, GLint x, GLint y, GLsizei width, GLsizei height), (texture, level, xoffset, yoffset, x, y, width, height)) \
+    X(CopyTextureSubImage3D, PFNGLCOPYTEXTURESUBIMAGE3DPROC, (GLuint texture, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLint x, GLint y, GLsizei width, GLsizei height), (texture, level, xoffset, yoffset, zoffset, x, y, width, height)) \
+    X(CreateBuffers, PFNGLCREATEBUFFERSPROC, (GLsizei n, GLuint *buffers), (n, buffers)) \
+    X(CreateFramebuffers, PFNGLCREATEFRAMEBUFFERSPROC, (GLsizei n, GLuint *framebuffers), (n, framebuffers)) \
+    XR(GLuint, CreateProgram, PFNGLCREATEPROGRAMPROC, (void), ()) \
+    X(CreateProgramPipelines, PFNGLCREATEPROGRAMPIPELINESPROC, (GLsizei n, GLuint *pipelines), (n, pipelines)) \
+    X(CreateQueries, PFNGLCREATEQUERIESPROC, (GLenum target, GLsizei n, GLuint *ids), (target, n, ids)) \
+    X(CreateRenderbuffers, PFNGLCREATERENDERBUFFERSPROC, (GLsizei n, GLuint *renderbuffers), (n, renderbuffers)) \
+    X(CreateSamplers, PFNGLCREATESAMPLERSPROC, (GLsizei n, GLuint *samplers), (n, samplers)) \
+    XR(GLuint, CreateShader, PFNGLCREATESHADERPROC, (GLenum type), (type)) \
+    XR(GLuint, CreateShaderProgramv, PFNGLCREATESHADERPROGRAMVPROC, (GLenum type, GLsizei count, const GLchar *const *strings), (type, count, strings)) \
+    X(CreateTextures, PFNGLCREATETEXTURESPROC, (GLenum target, GLsizei n, GLuint *textures), (target, n, textures)) \
+    X(CreateTransformFeedbacks, PFNGLCREATETRANSFORMFEEDBACKSPROC, (GLsizei n, GLuint *ids), (n, ids)) \
+    X(CreateVertexArrays, PFNGLCREATEVERTEXARRAYSPROC, (GLsizei n, GLuint *arrays), (n, arrays)) \
+    X(CullFace, PFNGLCULLFACEPROC, (GLenum mode), (mode)) \
+    X(DebugMessageCallback, PFNGLDEBUGMESSAGECALLBACKPROC, (GLDEBUGPROC callback, const void *userParam), (callback, userParam)) \
+    X(DebugMessageControl, PFNGLDEBUGMESSAGECONTROLPROC, (GLenum source, GLenum type, GLenum severity, GLsizei count, const GLuint *ids, GLboolean enabled), (source, type, severity, count, ids, enabled)) \
+    X(DebugMessageInsert, PFNGLDEBUGMESSAGEINSERTPROC, (GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar *buf), (source, type, id, severity, length, buf)) \
+    X(DeleteBuffers, PFNGLDELETEBUFFERSPROC, (GLsizei n, const GLuint *buffers), (n, buffers)) \
+    X(DeleteFramebuffers, PFNGLDELETEFRAMEBUFFERSPROC, (GLsizei n, const GLuint *framebuffers), (n, framebuffers)) \
+    X(DeleteLists, PFNGLDELETELISTSPROC, (GLuint list, GLsizei range), (list, range)) \
+    X(DeleteProgram, PFNGLDELETEPROGRAMPROC, (GLuint program), (program)) \
+    X(DeleteProgramPipelines, PFNGLDELETEPROGRAMPIPELINESPROC, (GLsizei n, const GLuint *pipelines), (n, pipelines)) \
+    X(DeleteQueries, PFNGLDELETEQUERIESPROC, (GLsizei n, const GLuint *ids), (n, ids)) \
+    X(DeleteRenderbuffers, PFNGLDELETERENDERBUFFERSPROC, (GLsizei n, const GLuint *renderbuffers), (n, renderbuffers)) \
+    X(DeleteSamplers, PFNGLDELETESAMPLERSPROC, (GLsizei count, const GLuint *samplers), (count, samplers)) \
+    X(DeleteShader, PFNGLDELETESHADERPROC, (GLuint shader), (shader)) \
+    X(DeleteSync, PFNGLDELETESYNCPROC, (GLsync sync), (sync)) \
+    X(DeleteTextures, PFNGLDELETETEXTURESPROC, (GLsizei n, const GLuint *textures), (n, textures)) \
+    X(DeleteTransformFeedbacks, PFNGLDELETETRANSFORMFEEDBACKSPROC, (GLsizei n, const GLuint *ids), (n, ids)) \
+    X(DeleteVertexArrays, PFNGLDELETEVERTEXARRAYSPROC, (GLsizei n, const GLuint *arrays), (n, arrays)) \
+    X(DepthFunc, PFNGLDEPTHFUNCPROC, (GLenum func), (func)) \
+    X(DepthMask, PFNGLDEPTHMASKPROC, (GLboolean flag), (flag)) \
+    X(DepthRange, PFNGLDEPTHRANGEPROC, (GLdouble n, GLdouble f), (n, f)) \
+    X(DepthRangeArrayv, PFNGLDEPTHRANGEARRAYVPROC, (GLuint first, GLsizei count, const GLdouble *v), (first, count, v)) \
+    X(DepthRangeIndexed, PFNGLDEPTHRANGEINDEXEDPROC, (GLuint index, GLdouble n, GLdouble f), (index, n, f)) \
+    X(DepthRangef, PFNGLDEPTHRANGEFPROC, (GLfloat n, GLfloat f), (n, f)) \
+    X(DetachShader, PFNGLDETACHSHADERPROC, (GLuint program, GLuint shader), (program, shader)) \
+    X(Disable, PFNGLDISABLEPROC, (GLenum cap), (cap)) \
+    X(DisableClientState, PFNGLDISABLECLIENTSTATEPROC, (GLenum array), (array)) \
+    X(DisableVertexArrayAttrib, PFNGLDISABLEVERTEXARRAYATTRIBPROC, (GLuint vaobj, GLuint index), (vaobj, index)) \
+    X(DisableVertexAttribArray, PFNGLDISABLEVERTEXATTRIBARRAYPROC, (GLuint index), (index)) \
+    X(Disablei, PFNGLDISABLEIPROC, (GLenum target, GLuint index), (target, index)) \
+    X(DispatchCompute, PFNGLDISPATCHCOMPUTEPROC, (GLuint num_groups_x, GLuint num_groups_y, GLuint num_groups_z), (num_groups_x, num_groups_y, num_groups_z)) \
+    X(DispatchComputeIndirect, PFNGLDISPATCHCOMPUTEINDIRECTPROC, (GLintptr indirect), (indirect)) \
+    X(DrawArrays, PFNGLDRAWARRAYSPROC, (GLenum mode, GLint first, GLsizei count), (mode, first, count)) \
+    X(DrawArraysIndirect, PFNGLDRAWARRAYSINDIRECTPROC, (GLenum mode, const void *indirect), (mode, indirect)) \
+    X(DrawArraysInstanced, PFNGLDRAWARRAYSINSTANCEDPROC, (GLenum mode, GLint first, GLsizei count, GLsizei instancecount), (mode, first, count, instancecount)) \
+    X(DrawArraysInstancedBaseInstance, PFNGLDRAWARRAYSINSTANCEDBASEINSTANCEPROC, (GLenum mode, GLint first, GLsizei count, GLsizei instancecount, GLuint baseinstance), (mode, first, count, instancecount, baseinstance)) \
+    X(DrawBuffer, PFNGLDRAWBUFFERPROC, (GLenum buf), (buf)) \
+    X(DrawBuffers, PFNGLDRAWBUFFERSPROC, (GLsizei n, const GLenum *bufs), (n, bufs)) \
+    X(DrawElements, PFNGLDRAWELEMENTSPROC, (GLenum mode, GLsizei count, GLenum type, const void *indices), (mode, count, type, indices)) \
+    X(DrawElementsBaseVertex, PFNGLDRAWELEMENTSBASEVERTEXPROC, (GLenum mode, GLsizei count, GLenum type, const void *indices, GLint basevertex), (mode, count, type, indices, basevertex)) \
+    X(DrawElementsIndirect, PFNGLDRAWELEMENTSINDIRECTPROC, (GLenum mode, GLenum type, const void *indirect), (mode, type, indirect)) \
+    X(DrawElementsInstanced, PFNGLDRAWELEMENTSINSTANCEDPROC, (GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instancecount), (mode, count, type, indices, instancecount)) \
+    X(DrawElementsInstancedBaseInstance, PFNGLDRAWELEMENTSINSTANCEDBASEINSTANCEPROC, (GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instancecount, GLuint baseinstance), (mode, count, type, indices, instancecount, baseinstance)) \
+    X(DrawElementsInstancedBaseVertex, PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXPROC, (GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instancecount, GLint basevertex), (mode, count, type, indices, instancecount, basevertex)) \
+    X(DrawElementsInstancedBaseVertexBaseInstance, PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXBASEINSTANCEPROC, (GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instancecount, GLint basevertex, GLuint baseinstance), (mode, count, type, indices, instancecount, basevertex, baseinstance)) \
+    X(DrawPixels, PFNGLDRAWPIXELSPROC, (GLsizei width, GLsizei height, GLenum format, GLenum type, const void *pixels), (width, height, format, type, pixels)) \
+    X(DrawRangeElements, PFNGLDRAWRANGEELEMENTSPROC, (GLenum mode, GLuint start, GLuint end, GLsizei count, GLenum type, const void *indices), (mode, start, end, count, type, indices)) \
+    X(DrawRangeElementsBaseVertex, PFNGLDRAWRANGEELEMENTSBASEVERTEXPROC, (GLenum mode, GLuint start, GLuint end, GLsizei count, GLenum type, const void *indices, GLint basevertex), (mode, start, end, count, type, indices, basevertex)) \
+    X(DrawTransformFeedback, PFNGLDRAWTRANSFORMFEEDBACKPROC, (GLenum mode, GLuint id), (mode, id)) \
+    X(DrawTransformFeedbackInstanced, PFNGLDRAWTRANSFORMFEEDBACKINSTANCEDPROC, (GLenum mode, GLuint id, GLsizei instancecount), (mode, id, instancecount)) \
+    X(DrawTransformFeedbackStream, PFNGLDRAWTRANSFORMFEEDBACKSTREAMPROC, (GLenum mode, GLuint id, GLuint stream), (mode, id, stream)) \
+    X(DrawTransformFeedbackStreamInstanced, PFNGLDRAWTRANSFORMFEEDBACKSTREAMINSTANCEDPROC, (GLenum mode, GLuint id, GLuint stream, GLsizei instancecount), (mode, id, stream, instancecount)) \
+    X(EdgeFlag, PFNGLEDGEFLAGPROC, (GLboolean flag), (flag)) \
+    X(EdgeFlagPointer, PFNGLEDGEFLAGPOINTERPROC, (GLsizei stride, const void *pointer), (stride, pointer)) \
+    X(EdgeFlagv, PFNGLEDGEFLAGVPROC, (const GLboolean *flag), (flag)) \
+    X(Enable, PFNGLENABLEPROC, (GLenum cap), (cap)) \
+    X(EnableClientState, PFNGLENABLECLIENTSTATEPROC, (GLenum array), (array)) \
+    X(EnableVertexArrayAttrib, PFNGLENABLEVERTEXARRAYATTRIBPROC, (GLuint vaobj, GLuint index), (vaobj, index)) \
+    X(EnableVertexAttribArray, PFNGLENABLEVERTEXATTRIBARRAYPROC, (GLuint index), (index)) \
+    X(Enablei, PFNGLENABLEIPROC, (GLenum target, GLuint index), (target, index)) \
+    X(End, PFNGLENDPROC, (void), ()) \
+    X(EndConditionalRender, PFNGLENDCONDITIONALRENDERPROC, (void), ()) \
+    X(EndList, PFNGLENDLISTPROC, (void), ()) \
+    X(EndQuery, PFNGLENDQUERYPROC, (GLenum target), (target)) \
+    X(EndQueryIndexed, PFNGLENDQUERYINDEXEDPROC, (GLenum target, GLuint index), (target, index)) \
+    X(EndTransformFeedback, PFNGLENDTRANSFORMFEEDBACKPROC, (void), ()) \
+    X(EvalCoord1d, PFNGLEVALCOORD1DPROC, (GLdouble u), (u)) \
+    X(EvalCoord1dv, PFNGLEVALCOORD1DVPROC, (const GLdouble *u), (u)) \
+    X(EvalCoord1f, PFNGLEVALCOORD1FPROC, (GLfloat u), (u)) \
+    X(EvalCoord1fv, PFNGLEVALCOORD1FVPROC, (const GLfloat *u), (u)) \
+    X(EvalCoord2d, PFNGLEVALCOORD2DPROC, (GLdouble u, GLdouble v), (u, v)) \
+    X(EvalCoord2dv, PFNGLEVALCOORD2DVPROC, (const GLdouble *u), (u)) \
+    X(EvalCoord2f, PFNGLEVALCOORD2FPROC, (GLfloat u, GLfloat v), (u, v)) \
+    X(EvalCoord2fv, PFNGLEVALCOORD2FVPROC, (const GLfloat *u), (u)) \
+    X(EvalMesh1, PFNGLEVALMESH1PROC, (GLenum mode, GLint i1, GLint i2), (mode, i1, i2)) \
+    X(EvalMesh2, PFNGLEVALMESH2PROC, (GLenum mode, GLint i1, GLint i2, GLint j1, GLint j2), (mode, i1, i2, j1, j2)) \
+    X(EvalPoint1, PFNGLEVALPOINT1PROC, (GLint i), (i)) \
+    X(EvalPoint2, PFNGLEVALPOINT2PROC, (GLint i, GLint j), (i, j)) \
+    X(FeedbackBuffer, PFNGLFEEDBACKBUFFERPROC, (GLsizei size, GLenum type, GLfloat *buffer), (size, type, buffer)) \
+    XR(GLsync, FenceSync, PFNGLFENCESYNCPROC, (GLenum condition, GLbitfield flags), (condition, flags)) \
+    X(Finish, PFNGLFINISHPROC, (void), ()) \
+    X(Flush, PFNGLFLUSHPROC, (void), ()) \
+    X(FlushMappedBufferRange, PFNGLFLUSHMAPPEDBUFFERRANGEPROC, (GLenum target, GLintptr offset, GLsizeiptr length), (target, offset, length)) \
+    X(FlushMappedNamedBufferRange, PFNGLFLUSHMAPPEDNAMEDBUFFERRANGEPROC, (GLuint buffer, GLintptr offset, GLsizeiptr length), (buffer, offset, length)) \
+    X(FogCoordPointer, PFNGLFOGCOORDPOINTERPROC, (GLenum type, GLsizei stride, const void *pointer), (type, stride, pointer)) \
+    X(FogCoordd, PFNGLFOGCOORDDPROC, (GLdouble coord), (coord)) \
+    X(FogCoorddv, PFNGLFOGCOORDDVPROC, (const GLdouble *coord), (coord)) \
+    X(FogCoordf, PFNGLFOGCOORDFPROC, (GLfloat coord), (coord)) \
+    X(FogCoordfv, PFNGLFOGCOORDFVPROC, (const GLfloat *coord), (coord)) \
+    X(Fogf, PFNGLFOGFPROC, (GLenum pname, GLfloat param), (pname, param)) \
+    X(Fogfv, PFNGLFOGFVPROC, (GLenum pname, const GLfloat *params), (pname, params)) \
+    X(Fogi, PFNGLFOGIPROC, (GLenum pname, GLint param), (pname, param)) \
+    X(Fogiv, PFNGLFOGIVPROC, (GLenum pname, const GLint *params), (pname, params)) \
+    X(FramebufferParameteri, PFNGLFRAMEBUFFERPARAMETERIPROC, (GLenum target, GLenum pname, GLint param), (target, pname, param)) \
+    X(FramebufferRenderbuffer, PFNGLFRAMEBUFFERRENDERBUFFERPROC, (GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer), (target, attachment, renderbuffertarget, renderbuffer)) \
+    X(FramebufferTexture, PFNGLFRAMEBUFFERTEXTUREPROC, (GLenum target, GLenum attachment, GLuint texture, GLint level), (target, attachment, texture, level)) \
+    X(FramebufferTexture1D, PFNGLFRAMEBUFFERTEXTURE1DPROC, (GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level), (target, attachment, textarget, texture, level)) \
+    X(FramebufferTexture2D, PFNGLFRAMEBUFFERTEXTURE2DPROC, (GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level), (target, attachment, textarget, texture, level)) \
+    X(FramebufferTexture3D, PFNGLFRAMEBUFFERTEXTURE3DPROC, (GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level, GLint zoffset), (target, attachment, textarget, texture, level, zoffset)) \
+    X(FramebufferTextureLayer, PFNGLFRAMEBUFFERTEXTURELAYERPROC, (GLenum target, GLenum attachment, GLuint texture, GLint level, GLint layer), (target, attachment, texture, level, layer)) \
+    X(FrontFace, PFNGLFRONTFACEPROC, (GLenum mode), (mode)) \
+    X(Frustum, PFNGLFRUSTUMPROC, (GLdouble left, GLdouble right, GLdouble bottom, GLdouble top, GLdouble zNear, GLdouble zFar), (left, right, bottom, top, zNear, zFar)) \
+    X(GenBuffers, PFNGLGENBUFFERSPROC, (GLsizei n, GLuint *buffers), (n, buffers)) \
+    X(GenFramebuffers, PFNGLGENFRAMEBUFFERSPROC, (GLsizei n, GLuint *framebuffers), (n, framebuffers)) \
+    XR(GLuint, GenLists, PFNGLGENLISTSPROC, (GLsizei range), (range)) \
+    X(GenProgramPipelines, PFNGLGENPROGRAMPIPELINESPROC, (GLsizei n, GLuint *pipelines), (n, pipelines)) \
+    X(GenQueries, PFNGLGENQUERIESPROC, (GLsizei n, GLuint *ids), (n, ids)) \
+    X(GenRenderbuffers, PFNGLGENRENDERBUFFERSPROC, (GLsizei n, GLuint *renderbuffers), (n, renderbuffers)) \
+    X(GenSamplers, PFNGLGENSAMPLERSPROC, (GLsizei count, GLuint *samplers), (count, samplers)) \
+    X(GenTextures, PFNGLGENTEXTURESPROC, (GLsizei n, GLuint *textures), (n, textures)) \
+    X(GenTransformFeedbacks, PFNGLGENTRANSFORMFEEDBACKSPROC, (GLsizei n, GLuint *ids), (n, ids)) \
+    X(GenVertexArrays, PFNGLGENVERTEXARRAYSPROC, (GLsizei n, GLuint *arrays), (n, arrays)) \
+    X(GenerateMipmap, PFNGLGENERATEMIPMAPPROC, (GLenum target), (target)) \
+    X(GenerateTextureMipmap, PFNGLGENERATETEXTUREMIPMAPPROC, (GLuint texture), (texture)) \
+    X(GetActiveAtomicCounterBufferiv, PFNGLGETACTIVEATOMICCOUNTERBUFFERIVPROC, (GLuint program, GLuint bufferIndex, GLenum pname, GLint *params), (program, bufferIndex, pname, params)) \
+    X(GetActiveAttrib, PFNGLGETACTIVEATTRIBPROC, (GLuint program, GLuint index, GLsizei bufSize, GLsizei *length, GLint *size, GLenum *type, GLchar *name), (program, index, bufSize, length, size, type, name)) \
+    X(GetActiveSubroutineName, PFNGLGETACTIVESUBROUTINENAMEPROC, (GLuint program, GLenum shadertype, GLuint index, GLsizei bufSize, GLsizei *length, GLchar *name), (program, shadertype, index, bufSize, length, name)) \
+    X(GetActiveSubroutineUniformName, PFNGLGETACTIVESUBROUTINEUNIFORMNAMEPROC, (GLuint program, GLenum shadertype, GLuint index, GLsizei bufSize, GLsizei *length, GLchar *name), (program, shadertype, index, bufSize, length, name)) \
+    X(GetActiveSubroutineUniformiv, PFNGLGETACTIVESUBROUTINEUNIFORMIVPROC, (GLuint program, GLenum shadertype, GLuint index, GLenum pname, GLint *values), (program, shadertype, index, pname, values)) \
+    X(GetActiveUniform, PFNGLGETACTIVEUNIFORMPROC, (GLuint program, GLuint index, GLsizei bufSize, GLsizei *length, GLint *size, GLenum *type, GLchar *name), (program, index, bufSize, length, size, type, name)) \
+    X(GetActiveUniformBlockName, PFNGLGETACTIVEUNIFORMBLOCKNAMEPROC, (GLuint program, GLuint uniformBlockIndex, GLsizei bufSize, GLsizei *length, GLchar *uniformBlockName), (program, uniformBlockIndex, bufSize, length, uniformBlockName)) \
+    X(GetActiveUniformBlockiv, PFNGLGETACTIVEUNIFORMBLOCKIVPROC, (GLuint program, GLuint uniformBlockIndex, GLenum pname, GLint *params), (program, uniformBlockIndex, pname, params)) \
+    X(GetActiveUniformName, PFNGLGETACTIVEUNIFORMNAMEPROC, (GLuint program, GLuint uniformIndex, GLsizei bufSize, GLsizei *length, GLchar *uniformName), (program, uniformIndex, bufSize, length, uniformName)) \
+    X(GetActiveUniformsiv, PFNGLGETACTIVEUNIFORMSIVPROC, (GLuint program, GLsizei uniformCount, const GLuint *uniformIndices, GLenum pname, GLint *params), (program, uniformCount, uniformIndices, pname, params)) \
+    X(GetAttachedShaders, PFNGLGETATTACHEDSHADERSPROC, (GLuint program, GLsizei maxCount, GLsizei *count, GLuint *shaders), (program, maxCount, count, shaders)) \
+    XR(GLint, GetAttribLocation, PFNGLGETATTRIBLOCATIONPROC, (GLuint program, const GLchar *name), (program, name)) \
+    X(GetBooleani_v, PFNGLGETBOOLEANI_VPROC, (GLenum target, GLuint index, GLboolean *data), (target, index, data)) \
+    X(GetBooleanv, PFNGLGETBOOLEANVPROC, (GLenum pname, GLboolean *data), (pname, data)) \
+    X(GetBufferParameteri64v, PFNGLGETBUFFERPARAMETERI64VPROC, (GLenum target, GLenum pname, GLint64 *params), (target, pname, params)) \
+    X(GetBufferParameteriv, PFNGLGETBUFFERPARAMETERIVPROC, (GLenum target, GLenum pname, GLint *params), (target, pname, params)) \
+    X(GetBufferPointerv, PFNGLGETBUFFERPOINTERVPROC, (GLenum target, GLenum pname, void **params), (target, pname, params)) \
+    X(GetBufferSubData, PFNGLGETBUFFERSUBDATAPROC, (GLenum target, GLintptr offset, GLsizeiptr size, void *data), (target, offset, size, data)) \
+    X(GetClipPlane, PFNGLGETCLIPPLANEPROC, (GLenum plane, GLdouble *equation), (plane, equation)) \
+    X(GetCompressedTexImage, PFNGLGETCOMPRESSEDTEXIMAGEPROC, (GLenum target, GLint level, void *img), (target, level, img)) \
+    X(GetCompressedTextureImage, PFNGLGETCOMPRESSEDTEXTUREIMAGEPROC, (GLuint texture, GLint level, GLsizei bufSize, void *pixels), (texture, level, bufSize, pixels)) \
+    X(GetCompressedTextureSubImage, PFNGLGETCOMPRESSEDTEXTURESUBIMAGEPROC, (GLuint texture, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLsizei bufSize, void *pixels), (texture, level, xoffset, yoffset, zoffset, width, height, depth, bufSize, pixels)) \
+    XR(GLuint, GetDebugMessageLog, PFNGLGETDEBUGMESSAGELOGPROC, (GLuint count, GLsizei bufSize, GLenum *sources, GLenum *types, GLuint *ids, GLenum *severities, GLsizei *lengths, GLchar *messageLog), (count, bufSize, sources, types, ids, severities, lengths, messageLog)) \
+    X(GetDoublei_v, PFNGLGETDOUBLEI_VPROC, (GLenum target, GLuint index, GLdouble *data), (target, index, data)) \
+    X(GetDoublev, PFNGLGETDOUBLEVPROC, (GLenum pname, GLdouble *data), (pname, data)) \
+    XR(GLenum, GetError, PFNGLGETERRORPROC, (void), ()) \
+    X(GetFloati_v, PFNGLGETFLOATI_VPROC, (GLenum target, GLuint index, GLfloat *data), (target, index, data)) \
+    X(GetFloatv, PFNGLGETFLOATVPROC, (GLenum pname, GLfloat *data), (pname, data)) \
+    XR(GLint, GetFragDataIndex, PFNGLGETFRAGDATAINDEXPROC, (GLuint program, const GLchar *name), (program, name)) \
+    XR(GLint, GetFragDataLocation, PFNGLGETFRAGDATALOCATIONPROC, (GLuint program, const GLchar *name), (program, name)) \
+    X(GetFramebufferAttachmentParameteriv, PFNGLGETFRAMEBUFFERATTACHMENTPARAMETERIVPROC, (GLenum target, GLenum attachment, GLenum pname, GLint *params), (target, attachment, pname, params)) \
+    X(GetFramebufferParameteriv, PFNGLGETFRAMEBUFFERPARAMETERIVPROC, (GLenum target, GLenum pname, GLint *params), (target, pname, params)) \
+    XR(GLenum, GetGraphicsResetStatus, PFNGLGETGRAPHICSRESETSTATUSPROC, (void), ()) \
+    X(GetInteger64i_v, PFNGLGETINTEGER64I_VPROC, (GLenum target, GLuint index, GLint64 *data), (target, index, data)) \
+    X(GetInteger64v, PFNGLGETINTEGER64VPROC, (GLenum pname, GLint64 *data), (pname, data)) \
+    X(GetIntegeri_v, PFNGLGETINTEGERI_VPROC, (GLenum target, GLuint index, GLint *data), (target, index, data)) \
+    X(GetIntegerv, PFNGLGETINTEGERVPROC, (GLenum pname, GLint *data), (pname, data)) \
+    X(GetInternalformati64v, PFNGLGETINTERNALFORMATI64VPROC, (GLenum target, GLenum internalformat, GLenum pname, GLsizei count, GLint64 *params), (target, internalformat, pname, count, params)) \
+    X(GetInternalformativ, PFNGLGETINTERNALFORMATIVPROC, (GLenum target, GLenum internalformat, GLenum pname, GLsizei count, GLint *params), (target, internalformat, pname, count, params)) \
+    X(GetLightfv, PFNGLGETLIGHTFVPROC, (GLenum light, GLenum pname, GLfloat *params), (light, pname, params)) \
+    X(GetLightiv, PFNGLGETLIGHTIVPROC, (GLenum light, GLenum pname, GLint *params), (light, pname, params)) \
+    X(GetMapdv, PFNGLGETMAPDVPROC, (GLenum target, GLenum query, GLdouble *v), (target, query, v)) \
+    X(GetMapfv, PFNGLGETMAPFVPROC, (GLenum target, GLenum query, GLfloat *v), (target, query, v)) \
+    X(GetMapiv, PFNGLGETMAPIVPROC, (GLenum target, GLenum query, GLint *v), (target, query, v)) \
+    X(GetMaterialfv, PFNGLGETMATERIALFVPROC, (GLenum face, GLenum pname, GLfloat *params), (face, pname, params)) \
+    X(GetMaterialiv, PFNGLGETMATERIALIVPROC, (GLenum face, GLenum pname, GLint *params), (face, pname, params)) \
+    X(GetMultisamplefv, PFNGLGETMULTISAMPLEFVPROC, (GLenum pname, GLuint index, GLfloat *val), (pname, index, val)) \
+    X(GetNamedBufferParameteri64v, PFNGLGETNAMEDBUFFERPARAMETERI64VPROC, (GLuint buffer, GLenum pname, GLint64 *params), (buffer, pname, params)) \
+    X(GetNamedBufferParameteriv, PFNGLGETNAMEDBUFFERPARAMETERIVPROC, (GLuint buffer, GLenum pname, GLint *params), (buffer, pname, params)) \
+    X(GetNamedBufferPointerv, PFNGLGETNAMEDBUFFERPOINTERVPROC, (GLuint buffer, GLenum pname, void **params), (buffer, pname, params)) \
+    X(GetNamedBufferSubData, PFNGLGETNAMEDBUFFERSUBDATAPROC, (GLuint buffer, GLintptr offset, GLsizeiptr size, void *data), (buffer, offset, size, data)) \
+    X(GetNamedFramebufferAttachmentParameteriv, PFNGLGETNAMEDFRAMEBUFFERATTACHMENTPARAMETERIVPROC, (GLuint framebuffer, GLenum attachment, GLenum pname, GLint *params), (framebuffer, attachment, pname, params)) \
+    X(GetNamedFramebufferParameteriv, PFNGLGETNAMEDFRAMEBUFFERPARAMETERIVPROC, (GLuint framebuffer, GLenum pname, GLint *param), (framebuffer, pname, param)) \
+    X(GetNamedRenderbufferParameteriv, PFNGLGETNAMEDRENDERBUFFERPARAMETERIVPROC, (GLuint renderbuffer, GLenum pname, GLint *params), (renderbuffer, pname, params)) \
+    X(GetObjectLabel, PFNGLGETOBJECTLABELPROC, (GLenum identifier, GLuint name, GLsizei bufSize, GLsizei *length, GLchar *label), (identifier, name, bufSize, length, label)) \
+    X(GetObjectPtrLabel, PFNGLGETOBJECTPTRLABELPROC, (const void *ptr, GLsizei bufSize, GLsizei *length, GLchar *label), (ptr, bufSize, length, label)) \
+    X(GetPixelMapfv, PFNGLGETPIXELMAPFVPROC, (GLenum map, GLfloat *values), (map, values)) \
+    X(GetPixelMapuiv, PFNGLGETPIXELMAPUIVPROC, (GLenum map, GLuint *values), (map, values)) \
+    X(GetPixelMapusv, PFNGLGETPIXELMAPUSVPROC, (GLenum map, GLushort *values), (map, values)) \
+    X(GetPointerv, PFNGLGETPOINTERVPROC, (GLenum pname, void **params), (pname, params)) \
+    X(GetPolygonStipple, PFNGLGETPOLYGONSTIPPLEPROC, (GLubyte *mask), (mask)) \
+    X(GetProgramBinary, PFNGLGETPROGRAMBINARYPROC, (GLuint program, GLsizei bufSize, GLsizei *length, GLenum *binaryFormat, void *binary), (program, bufSize, length, binaryFormat, binary)) \
+    X(GetProgramInfoLog, PFNGLGETPROGRAMINFOLOGPROC, (GLuint program, GLsizei bufSize, GLsizei *length, GLchar *infoLog), (program, bufSize, length, infoLog)) \
+    X(GetProgramInterfaceiv, PFNGLGETPROGRAMINTERFACEIVPROC, (GLuint program, GLenum programInterface, GLenum pname, GLint *params), (program, programInterface, pname, params)) \
+    X(GetProgramPipelineInfoLog, PFNGLGETPROGRAMPIPELINEINFOLOGPROC, (GLuint pipeline, GLsizei bufSize, GLsizei *length, GLchar *infoLog), (pipeline, bufSize, length, infoLog)) \
+    X(GetProgramPipelineiv, PFNGLGETPROGRAMPIPELINEIVPROC, (GLuint pipeline, GLenum pname, GLint *params), (pipeline, pname, params)) \
+    XR(GLuint, GetProgramResourceIndex, PFNGLGETPROGRAMRESOURCEINDEXPROC, (GLuint program, GLenum programInterface, const GLchar *name), (program, programInterface, name)) \
+    XR(GLint, GetProgramResourceLocation, PFNGLGETPROGRAMRESOURCELOCATIONPROC, (GLuint program, GLenum programInterface, const GLchar *name), (program, programInterface, name)) \
+    XR(GLint, GetProgramResourceLocationIndex, PFNGLGETPROGRAMRESOURCELOCATIONINDEXPROC, (GLuint program, GLenum programInterface, const GLchar *name), (program, programInterface, name)) \
+    X(GetProgramResourceName, PFNGLGETPROGRAMRESOURCENAMEPROC, (GLuint program, GLenum programInterface, GLuint index, GLsizei bufSize, GLsizei *length, GLchar *name), (program, programInterface, index, bufSize, length, name)) \
+    X(GetProgramResourceiv, PFNGLGETPROGRAMRESOURCEIVPROC, (GLuint program, GLenum programInterface, GLuint index, GLsizei propCount, const GLenum *props, GLsizei count, GLsizei *length, GLint *params), (program, programInterface, index, propCount, props, count, length, params)) \
+    X(GetProgramStageiv, PFNGLGETPROGRAMSTAGEIVPROC, (GLuint program, GLenum shadertype, GLenum pname, GLint *values), (program, shadertype, pname, values)) \
+    X(GetProgramiv, PFNGLGETPROGRAMIVPROC, (GLuint program, GLenum pname, GLint *params), (program, pname, params)) \
+    X(GetQueryBufferObjecti64v, PFNGLGETQUERYBUFFEROBJECTI64VPROC, (GLuint id, GLuint buffer, GLenum pname, GLintptr offset), (id, buffer, pname, offset)) \
+    X(GetQueryBufferObjectiv, PFNGLGETQUERYBUFFEROBJECTIVPROC, (GLuint id, GLuint buffer, GLenum pname, GLintptr offset), (id, buffer, pname, offset)) \
+    X(GetQueryBufferObjectui64v, PFNGLGETQUERYBUFFEROBJECTUI64VPROC, (GLuint id, GLuint buffer, GLenum pname, GLintptr offset), (id, buffer, pname, offset)) \
+    X(GetQueryBufferObjectuiv, PFNGLGETQUERYBUFFEROBJECTUIVPROC, (GLuint id, GLuint buffer, GLenum pname, GLintptr offset), (id, buffer, pname, offset)) \
+    X(GetQueryIndexediv, PFNGLGETQUERYINDEXEDIVPROC, (GLenum target, GLuint index, GLenum pname, GLint *params), (target, index, pname, params)) \
+    X(GetQueryObjecti64v, PFNGLGETQUERYOBJECTI64VPROC, (GLuint id, GLenum pname, GLint64 *params), (id, pname, params)) \
+    X(GetQueryObjectiv, PFNGLGETQUERYOBJECTIVPROC, (GLuint id, GLenum pname, GLint *params), (id, pname, params)) \
+    X(GetQueryObjectui64v, PFNGLGETQUERYOBJECTUI64VPROC, (GLuint id, GLenum pname, GLuint64 *params), (id, pname, params)) \
+    X(GetQueryObjectuiv, PFNGLGETQUERYOBJECTUIVPROC, (GLuint id, GLenum pname, GLuint *params), (id, pname, params)) \
+    X(GetQueryiv, PFNGLGETQUERYIVPROC, (GLenum target, GLenum pname, GLint *params), (target, pname, params)) \
+    X(GetRenderbufferParameteriv, PFNGLGETRENDERBUFFERPARAMETERIVPROC, (GLenum target, GLenum pname, GLint *params), (target, pname, params)) \
+    X(GetSamplerParameterIiv, PFNGLGETSAMPLERPARAMETERIIVPROC, (GLuint sampler, GLenum pname, GLint *params), (sampler, pname, params)) \
+    X(GetSamplerParameterIuiv, PFNGLGETSAMPLERPARAMETERIUIVPROC, (GLuint sampler, GLenum pname, GLuint *params), (sampler, pname, params)) \
+    X(GetSamplerParameterfv, PFNGLGETSAMPLERPARAMETERFVPROC, (GLuint sampler, GLenum pname, GLfloat *params), (sampler, pname, params)) \
+    X(GetSamplerParameteriv, PFNGLGETSAMPLERPARAMETERIVPROC, (GLuint sampler, GLenum pname, GLint *params), (sampler, pname, params)) \
+    X(GetShaderInfoLog, PFNGLGETSHADERINFOLOGPROC, (GLuint shader, GLsizei bufSize, GLsizei *length, GLchar *infoLog), (shader, bufSize, length, infoLog)) \
+    X(GetShaderPrecisionFormat, PFNGLGETSHADERPRECISIONFORMATPROC, (GLenum shadertype, GLenum precisiontype, GLint *range, GLint *precision), (shadertype, precisiontype, range, precision)) \
+    X(GetShaderSource, PFNGLGETSHADERSOURCEPROC, (GLuint shader, GLsizei bufSize, GLsizei *length, GLchar *source), (shader, bufSize, length, source)) \
+    X(GetShaderiv, PFNGLGETSHADERIVPROC, (GLuint shader, GLenum pname, GLint *params), (shader, pname, params)) \
+    XR(const GLubyte *, GetString, PFNGLGETSTRINGPROC, (GLenum name), (name)) \
+    XR(const GLubyte *, GetStringi, PFNGLGETSTRINGIPROC, (GLenum name, GLuint index), (name, index)) \
+    XR(GLuint, GetSubroutineIndex, PFNGLGETSUBROUTINEINDEXPROC, (GLuint program, GLenum shadertype, const GLchar *name), (program, shadertype, name)) \
+    XR(GLint, GetSubroutineUniformLocation, PFNGLGETSUBROUTINEUNIFORMLOCATIONPROC, (GLuint program, GLenum shadertype, const GLchar *name), (program, shadertype, name)) \
+    X(GetSynciv, PFNGLGETSYNCIVPROC, (GLsync sync, GLenum pname, GLsizei count, GLsizei *length, GLint *values), (sync, pname, count, length, values)) \
+    X(GetTexEnvfv, PFNGLGETTEXENVFVPROC, (GLenum target, GLenum pname, GLfloat *params), (target, pname, params)) \
+    X(GetTexEnviv, PFNGLGETTEXENVIVPROC, (GLenum target, GLenum pname, GLint *params), (target, pname, params)) \
+    X(GetTexGendv, PFNGLGETTEXGENDVPROC, (GLenum coord, GLenum pname, GLdouble *params), (coord, pname, params)) \
+    X(GetTexGenfv, PFNGLGETTEXGENFVPROC, (GLenum coord, GLenum pname, GLfloat *params), (coord, pname, params)) \
+    X(GetTexGeniv, PFNGLGETTEXGENIVPROC, (GLenum coord, GLenum pname, GLint *params), (coord, pname, params)) \
+    X(GetTexImage, PFNGLGETTEXIMAGEPROC, (GLenum target, GLint level, GLenum format, GLenum type, void *pixels), (target, level, format, type, pixels)) \
+    X(GetTexLevelParameterfv, PFNGLGETTEXLEVELPARAMETERFVPROC, (GLenum target, GLint level, GLenum pname, GLfloat *params), (target, level, pname, params)) \
+    X(GetTexLevelParameteriv, PFNGLGETTEXLEVELPARAMETERIVPROC, (GLenum target, GLint level, GLenum pname, GLint *params), (target, level, pname, params)) \
+    X(GetTexParameterIiv, PFNGLGETTEXPARAMETERIIVPROC, (GLenum target, GLenum pname, GLint *params), (target, pname, params)) \
+    X(GetTexParameterIuiv, PFNGLGETTEXPARAMETERIUIVPROC, (GLenum target, GLenum pname, GLuint *params), (target, pname, params)) \
+    X(GetTexParameterfv, PFNGLGETTEXPARAMETERFVPROC, (GLenum target, GLenum pname, GLfloat *params), (target, pname, params)) \
+    X(GetTexParameteriv, PFNGLGETTEXPARAMETERIVPROC, (GLenum target, GLenum pname, GLint *params), (target, pname, params)) \
+    X(GetTextureImage, PFNGLGETTEXTUREIMAGEPROC, (GLuint texture, GLint level, GLenum format, GLenum type, GLsizei bufSize, void *pixels), (texture, level, format, type, bufSize, pixels)) \
+    X(GetTextureLevelParameterfv, PFNGLGETTEXTURELEVELPARAMETERFVPROC, (GLuint texture, GLint level, GLenum pname, GLfloat *params), (texture, level, pname, params)) \
+    X(GetTextureLevelParameteriv, PFNGLGETTEXTURELEVELPARAMETERIVPROC, (GLuint texture, GLint level, GLenum pname, GLint *params), (texture, level, pname, params)) \
+    X(GetTextureParameterIiv, PFNGLGETTEXTUREPARAMETERIIVPROC, (GLuint texture, GLenum pname, GLint *params), (texture, pname, params)) \
+    X(GetTextureParameterIuiv, PFNGLGETTEXTUREPARAMETERIUIVPROC, (GLuint texture, GLenum pname, GLuint *params), (texture, pname, params)) \
+    X(GetTextureParameterfv, PFNGLGETTEXTUREPARAMETERFVPROC, (GLuint texture, GLenum pname, GLfloat *params), (texture, pname, params)) \
+    X(GetTextureParameteriv, PFNGLGETTEXTUREPARAMETERIVPROC, (GLuint texture, GLenum pname, GLint *params), (texture, pname, params)) \
+    X(GetTextureSubImage, PFNGLGETTEXTURESUBIMAGEPROC, (GLuint texture, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, GLsizei bufSize, void *pixels), (texture, level, xoffset, yoffset, zoffset, width, height, depth, format, type, bufSize, pixels)) \
+    X(GetTransformFeedbackVarying, PFNGLGETTRANSFORMFEEDBACKVARYINGPROC, (GLuint program, GLuint index, GLsizei bufSize, GLsizei *length, GLsizei *size, GLenum *type, GLchar *name), (program, index, bufSize, length, size, type, name)) \
+    X(GetTransformFeedbacki64_v, PFNGLGETTRANSFORMFEEDBACKI64_VPROC, (GLuint xfb, GLenum pname, GLuint index, GLint64 *param), (xfb, pname, index, param)) \
+    X(GetTransformFeedbacki_v, PFNGLGETTRANSFORMFEEDBACKI_VPROC, (GLuint xfb, GLenum pname, GLuint index, GLint *param), (xfb, pname, index, param)) \
+    X(GetTransformFeedbackiv, PFNGLGETTRANSFORMFEEDBACKIVPROC, (GLuint xfb, GLenum pname, GLint *param), (xfb, pname, param)) \
+    XR(GLuint, GetUniformBlockIndex, PFNGLGETUNIFORMBLOCKINDEXPROC, (GLuint program, const GLchar *uniformBlockName), (program, uniformBlockName)) \
+    X(GetUniformIndices, PFNGLGETUNIFORMINDICESPROC, (GLuint program, GLsizei uniformCount, const GLchar *const *uniformNames, GLuint *uniformIndices), (program, uniformCount, uniformNames, uniformIndices)) \
+    XR(GLint, GetUniformLocation, PFNGLGETUNIFORMLOCATIONPROC, (GLuint program, const GLchar *name), (program, name)) \
+    X(GetUniformSubroutineuiv, PFNGLGETUNIFORMSUBROUTINEUIVPROC, (GLenum shadertype, GLint location, GLuint *params), (shadertype, location, params)) \
+    X(GetUniformdv, PFNGLGETUNIFORMDVPROC, (GLuint program, GLint location, GLdouble *params), (program, location, params)) \
+    X(GetUniformfv, PFNGLGETUNIFORMFVPROC, (GLuint program, GLint location, GLfloat *params), (program, location, params)) \
+    X(GetUniformiv, PFNGLGETUNIFORMIVPROC, (GLuint program, GLint location, GLint *params), (program, location, params)) \
+    X(GetUniformuiv, PFNGLGETUNIFORMUIVPROC, (GLuint program, GLint location, GLuint *params), (program, location, params)) \
+    X(GetVertexArrayIndexed64iv, PFNGLGETVERTEXARRAYINDEXED64IVPROC, (GLuint vaobj, GLuint index, GLenum pname, GLint64 *param), (vaobj, index, pname, param)) \
+    X(GetVertexArrayIndexediv, PFNGLGETVERTEXARRAYINDEXEDIVPROC, (GLuint vaobj, GLuint index, GLenum pname, GLint *param), (vaobj, index, pname, param)) \
+    X(GetVertexArrayiv, PFNGLGETVERTEXARRAYIVPROC, (GLuint vaobj, GLenum pname, GLint *param), (vaobj, pname, param)) \
+    X(GetVertexAttribIiv, PFNGLGETVERTEXATTRIBIIVPROC, (GLuint index, GLenum pname, GLint *params), (index, pname, params)) \
+    X(GetVertexAttribIuiv, PFNGLGETVERTEXATTRIBIUIVPROC, (GLuint index, GLenum pname, GLuint *params), (index, pname, params)) \
+    X(GetVertexAttribLdv, PFNGLGETVERTEXATTRIBLDVPROC, (GLuint index, GLenum pname, GLdouble *params), (index, pname, params)) \
+    X(GetVertexAttribPointerv, PFNGLGETVERTEXATTRIBPOINTERVPROC, (GLuint index, GLenum pname, void **pointer), (index, pname, pointer)) \
+    X(GetVertexAttribdv, PFNGLGETVERTEXATTRIBDVPROC, (GLuint index, GLenum pname, GLdouble *params), (index, pname, params)) \
+    X(GetVertexAttribfv, PFNGLGETVERTEXATTRIBFVPROC, (GLuint index, GLenum pname, GLfloat *params), (index, pname, params)) \
+    X(GetVertexAttribiv, PFNGLGETVERTEXATTRIBIVPROC, (GLuint index, GLenum pname, GLint *params), (index, pname, params)) \
+    X(GetnColorTable, PFNGLGETNCOLORTABLEPROC, (GLenum target, GLenum format, GLenum type, GLsizei bufSize, void *table), (target, format, type, bufSize, table)) \
+    X(GetnCompressedTexImage, PFNGLGETNCOMPRESSEDTEXIMAGEPROC, (GLenum target, GLint lod, GLsizei bufSize, void *pixels), (target, lod, bufSize, pixels)) \
+    X(GetnConvolutionFilter, PFNGLGETNCONVOLUTIONFILTERPROC, (GLenum target, GLenum format, GLenum type, GLsizei bufSize, void *image), (target, format, type, bufSize, image)) \
+    X(GetnHistogram, PFNGLGETNHISTOGRAMPROC, (GLenum target, GLboolean reset, GLenum format, GLenum type, GLsizei bufSize, void *values), (target, reset, format, type, bufSize, values)) \
+    X(GetnMapdv, PFNGLGETNMAPDVPROC, (GLenum target, GLenum query, GLsizei bufSize, GLdouble *v), (target, query, bufSize, v)) \
+    X(GetnMapfv, PFNGLGETNMAPFVPROC, (GLenum target, GLenum query, GLsizei bufSize, GLfloat *v), (target, query, bufSize, v)) \
+    X(GetnMapiv, PFNGLGETNMAPIVPROC, (GLenum target, GLenum query, GLsizei bufSize, GLint *v), (target, query, bufSize, v)) \
+    X(GetnMinmax, PFNGLGETNMINMAXPROC, (GLenum target, GLboolean reset, GLenum format, GLenum type, GLsizei bufSize, void *values), (target, reset, format, type, bufSize, values)) \
+    X(GetnPixelMapfv, PFNGLGETNPIXELMAPFVPROC, (GLenum map, GLsizei bufSize, GLfloat *values), (map, bufSize, values)) \
+    X(GetnPixelMapuiv, PFNGLGETNPIXELMAPUIVPROC, (GLenum map, GLsizei bufSize, GLuint *values), (map, bufSize, values)) \
+    X(GetnPixelMapusv, PFNGLGETNPIXELMAPUSVPROC, (GLenum map, GLsizei bufSize, GLushort *values), (map, bufSize, values)) \
+    X(GetnPolygonStipple, PFNGLGETNPOLYGONSTIPPLEPROC, (GLsizei bufSize, GLubyte *pattern), (bufSize, pattern)) \
+    X(GetnSeparableFilter, PFNGLGETNSEPARABLEFILTERPROC, (GLenum target, GLenum format, GLenum type, GLsizei rowBufSize, void *row, GLsizei columnBufSize, void *column, void *span), (target, format, type, rowBufSize, row, columnBufSize, column, span)) \
+    X(GetnTexImage, PFNGLGETNTEXIMAGEPROC, (GLenum target, GLint level, GLenum format, GLenum type, GLsizei bufSize, void *pixels), (target, level, format, type, bufSize, pixels)) \
+    X(GetnUniformdv, PFNGLGETNUNIFORMDVPROC, (GLuint program, GLint location, GLsizei bufSize, GLdouble *params), (program, location, bufSize, params)) \
+    X(GetnUniformfv, PFNGLGETNUNIFORMFVPROC, (GLuint program, GLint location, GLsizei bufSize, GLfloat *params), (program, location, bufSize, params)) \
+    X(GetnUniformiv, PFNGLGETNUNIFORMIVPROC, (GLuint program, GLint location, GLsizei bufSize, GLint *params), (program, location, bufSize, params)) \
+    X(GetnUniformuiv, PFNGLGETNUNIFORMUIVPROC, (GLuint program, GLint location, GLsizei bufSize, GLuint *params), (program, location, bufSize, params)) \
+    X(Hint, PFNGLHINTPROC, (GLenum target, GLenum mode), (target, mode)) \
+    X(IndexMask, PFNGLINDEXMASKPROC, (GLuint mask), (mask)) \
+    X(IndexPointer, PFNGLINDEXPOINTERPROC, (GLenum type, GLsizei stride, const void *pointer), (type, stride, pointer)) \
+    X(Indexd, PFNGLINDEXDPROC, (GLdouble c), (c)) \
+    X(Indexdv, PFNGLINDEXDVPROC, (const GLdouble *c), (c)) \
+    X(Indexf, PFNGLINDEXFPROC, (GLfloat c), (c)) \
+    X(Indexfv, PFNGLINDEXFVPROC, (const GLfloat *c), (c)) \
+    X(Indexi, PFNGLINDEXIPROC, (GLint c), (c)) \
+    X(Indexiv, PFNGLINDEXIVPROC, (const GLint *c), (c)) \
+    X(Indexs, PFNGLINDEXSPROC, (GLshort c), (c)) \
+    X(Indexsv, PFNGLINDEXSVPROC, (const GLshort *c), (c)) \
+    X(Indexub, PFNGLINDEXUBPROC, (GLubyte c), (c)) \
+    X(Indexubv, PFNGLINDEXUBVPROC, (const GLubyte *c), (c)) \
+    X(InitNames, PFNGLINITNAMESPROC, (void), ()) \
+    X(InterleavedArrays, PFNGLINTERLEAVEDARRAYSPROC, (GLenum format, GLsizei stride, const void *pointer), (format, stride, pointer)) \
+    X(InvalidateBufferData, PFNGLINVALIDATEBUFFERDATAPROC, (GLuint buffer), (buffer)) \
+    X(InvalidateBufferSubData, PFNGLINVALIDATEBUFFERSUBDATAPROC, (GLuint buffer, GLintptr offset, GLsizeiptr length), (buffer, offset, length)) \
+    X(InvalidateFramebuffer, PFNGLINVALIDATEFRAMEBUFFERPROC, (GLenum target, GLsizei numAttachments, const GLenum *attachments), (target, numAttachments, attachments)) \
+    X(InvalidateNamedFramebufferData, PFNGLINVALIDATENAMEDFRAMEBUFFERDATAPROC, (GLuint framebuffer, GLsizei numAttachments, const GLenum *attachments), (framebuffer, numAttachments, attachments)) \
+    X(InvalidateNamedFramebufferSubData, PFNGLINVALIDATENAMEDFRAMEBUFFERSUBDATAPROC, (GLuint framebuffer, GLsizei numAttachments, const GLenum *attachments, GLint x, GLint y, GLsizei width, GLsizei height), (framebuffer, numAttachments, attachments, x, y, width, height)) \
+    X(InvalidateSubFramebuffer, PFNGLINVALIDATESUBFRAMEBUFFERPROC, (GLenum target, GLsizei numAttachments, const GLenum *attachments, GLint x, GLint y, GLsizei width, GLsizei height), (target, numAttachments, attachments, x, y, width, height)) \
+    X(InvalidateTexImage, PFNGLINVALIDATETEXIMAGEPROC, (GLuint texture, GLint level), (texture, level)) \
+    X(InvalidateTexSubImage, PFNGLINVALIDATETEXSUBIMAGEPROC, (GLuint texture, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth), (texture, level, xoffset, yoffset, zoffset, width, height, depth)) \
+    XR(GLboolean, IsBuffer, PFNGLISBUFFERPROC, (GLuint buffer), (buffer)) \
+    XR(GLboolean, IsEnabled, PFNGLISENABLEDPROC, (GLenum cap), (cap)) \
+    XR(GLboolean, IsEnabledi, PFNGLISENABLEDIPROC, (GLenum target, GLuint index), (target, index)) \
+    XR(GLboolean, IsFramebuffer, PFNGLISFRAMEBUFFERPROC, (GLuint framebuffer), (framebuffer)) \
+    XR(GLboolean, IsList, PFNGLISLISTPROC, (GLuint list), (list)) \
+    XR(GLboolean, IsProgram, PFNGLISPROGRAMPROC, (GLuint program), (program)) \
+    XR(GLboolean, IsProgramPipeline, PFNGLISPROGRAMPIPELINEPROC, (GLuint pipeline), (pipeline)) \
+    XR(GLboolean, IsQuery, PFNGLISQUERYPROC, (GLuint id), (id)) \
+    XR(GLboolean, IsRenderbuffer, PFNGLISRENDERBUFFERPROC, (GLuint renderbuffer), (renderbuffer)) \
+    XR(GLboolean, IsSampler, PFNGLISSAMPLERPROC, (GLuint sampler), (sampler)) \
+    XR(GLboolean, IsShader, PFNGLISSHADERPROC, (GLuint shader), (shader)) \
+    XR(GLboolean, IsSync, PFNGLISSYNCPROC, (GLsync sync), (sync)) \
+    XR(GLboolean, IsTexture, PFNGLISTEXTUREPROC, (GLuint texture), (texture)) \
+    XR(GLboolean, IsTransformFeedback, PFNGLISTRANSFORMFEEDBACKPROC, (GLuint id), (id)) \
+    XR(GLboolean, IsVertexArray, PFNGLISVERTEXARRAYPROC, (GLuint array), (array)) \
+    X(LightModelf, PFNGLLIGHTMODELFPROC, (GLenum pname, GLfloat param), (pname, param)) \
+    X(LightModelfv, PFNGLLIGHTMODELFVPROC, (GLenum pname, const GLfloat *params), (pname, params)) \
+    X(LightModeli, PFNGLLIGHTMODELIPROC, (GLenum pname, GLint param), (pname, param)) \
+    X(LightModeliv, PFNGLLIGHTMODELIVPROC, (GLenum pname, const GLint *params), (pname, params)) \
+    X(Lightf, PFNGLLIGHTFPROC, (GLenum light, GLenum pname, GLfloat param), (light, pname, param)) \
+    X(Lightfv, PFNGLLIGHTFVPROC, (GLenum light, GLenum pname, const GLfloat *params), (light, pname, params)) \
+    X(Lighti, PFNGLLIGHTIPROC, (GLenum light, GLenum pname, GLint param), (light, pname, param)) \
+    X(Lightiv, PFNGLLIGHTIVPROC, (GLenum light, GLenum pname, const GLint *params), (light, pname, params)) \
+    X(LineStipple, PFNGLLINESTIPPLEPROC, (GLint factor, GLushort pattern), (factor, pattern)) \
+    X(LineWidth, PFNGLLINEWIDTHPROC, (GLfloat width), (width)) \
+    X(LinkProgram, PFNGLLINKPROGRAMPROC, (GLuint program), (program)) \
+    X(ListBase, PFNGLLISTBASEPROC, (GLuint base), (base)) \
+    X(LoadIdentity, PFNGLLOADIDENTITYPROC, (void), ()) \
+    X(LoadMatrixd, PFNGLLOADMATRIXDPROC, (const GLdouble *m), (m)) \
+    X(LoadMatrixf, PFNGLLOADMATRIXFPROC, (const GLfloat *m), (m)) \
+    X(LoadName, PFNGLLOADNAMEPROC, (GLuint name), (name)) \
+    X(LoadTransposeMatrixd, PFNGLLOADTRANSPOSEMATRIXDPROC, (const GLdouble *m), (m)) \
+    X(LoadTransposeMatrixf, PFNGLLOADTRANSPOSEMATRIXFPROC, (const GLfloat *m), (m)) \
+    X(LogicOp, PFNGLLOGICOPPROC, (GLenum opcode), (opcode)) \
+    X(Map1d, PFNGLMAP1DPROC, (GLenum target, GLdouble u1, GLdouble u2, GLint stride, GLint order, const GLdouble *points), (target, u1, u2, stride, order, points)) \
+    X(Map1f, PFNGLMAP1FPROC, (GLenum target, GLfloat u1, GLfloat u2, GLint stride, GLint order, const GLfloat *points), (target, u1, u2, stride, order, points)) \
+    X(Map2d, PFNGLMAP2DPROC, (GLenum target, GLdouble u1, GLdouble u2, GLint ustride, GLint uorder, GLdouble v1, GLdouble v2, GLint vstride, GLint vorder, const GLdouble *points), (target, u1, u2, ustride, uorder, v1, v2, vstride, vorder, points)) \
+    X(Map2f, PFNGLMAP2FPROC, (GLenum target, GLfloat u1, GLfloat u2, GLint ustride, GLint uorder, GLfloat v1, GLfloat v2, GLint vstride, GLint vorder, const GLfloat *points), (target, u1, u2, ustride, uorder, v1, v2, vstride, vorder, points)) \
+    XR(void *, MapBuffer, PFNGLMAPBUFFERPROC, (GLenum target, GLenum access), (target, access)) \
+    XR(void *, MapBufferRange, PFNGLMAPBUFFERRANGEPROC, (GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access), (target, offset, length, access)) \
+    X(MapGrid1d, PFNGLMAPGRID1DPROC, (GLint un, GLdouble u1, GLdouble u2), (un, u1, u2)) \
+    X(MapGrid1f, PFNGLMAPGRID1FPROC, (GLint un, GLfloat u1, GLfloat u2), (un, u1, u2)) \
+    X(MapGrid2d, PFNGLMAPGRID2DPROC, (GLint un, GLdouble u1, GLdouble u2, GLint vn, GLdouble v1, GLdouble v2), (un, u1, u2, vn, v1, v2)) \
+    X(MapGrid2f, PFNGLMAPGRID2FPROC, (GLint un, GLfloat u1, GLfloat u2, GLint vn, GLfloat v1, GLfloat v2), (un, u1, u2, vn, v1, v2)) \
+    XR(void *, MapNamedBuffer, PFNGLMAPNAMEDBUFFERPROC, (GLuint buffer, GLenum access), (buffer, access)) \
+    XR(void *, MapNamedBufferRange, PFNGLMAPNAMEDBUFFERRANGEPROC, (GLuint buffer, GLintptr offset, GLsizeiptr length, GLbitfield access), (buffer, offset, length, access)) \
+    X(Materialf, PFNGLMATERIALFPROC, (GLenum face, GLenum pname, GLfloat param), (face, pname, param)) \
+    X(Materialfv, PFNGLMATERIALFVPROC, (GLenum face, GLenum pname, const GLfloat *params), (face, pname, params)) \
+    X(Materiali, PFNGLMATERIALIPROC, (GLenum face, GLenum pname, GLint param), (face, pname, param)) \
+    X(Materialiv, PFNGLMATERIALIVPROC, (GLenum face, GLenum pname, const GLint *params), (face, pname, params)) \
+    X(MatrixMode, PFNGLMATRIXMODEPROC, (GLenum mode), (mode)) \
+    X(MemoryBarrier, PFNGLMEMORYBARRIERPROC, (GLbitfield barriers), (barriers)) \
+    X(MemoryBarrierByRegion, PFNGLMEMORYBARRIERBYREGIONPROC, (GLbitfield barriers), (barriers)) \
+    X(MinSampleShading, PFNGLMINSAMPLESHADINGPROC, (GLfloat value), (value)) \
+    X(MultMatrixd, PFNGLMULTMATRIXDPROC, (const GLdouble *m), (m)) \
+    X(MultMatrixf, PFNGLMULTMATRIXFPROC, (const GLfloat *m), (m)) \
+    X(MultTransposeMatrixd, PFNGLMULTTRANSPOSEMATRIXDPROC, (const GLdouble *m), (m)) \
+    X(MultTransposeMatrixf, PFNGLMULTTRANSPOSEMATRIXFPROC, (const GLfloat *m), (m)) \
+    X(MultiDrawArrays, PFNGLMULTIDRAWARRAYSPROC, (GLenum mode, const GLint *first, const GLsizei *count, GLsizei drawcount), (mode, first, count, drawcount)) \
+    X(MultiDrawArraysIndirect, PFNGLMULTIDRAWARRAYSINDIRECTPROC, (GLenum mode, const void *indirect, GLsizei drawcount, GLsizei stride), (mode, indirect, drawcount, stride)) \
+    X(MultiDrawArraysIndirectCount, PFNGLMULTIDRAWARRAYSINDIRECTCOUNTPROC, (GLenum mode, const void *indirect, GLintptr drawcount, GLsizei maxdrawcount, GLsizei stride), (mode, indirect, drawcount, maxdrawcount, stride)) \
+    X(MultiDrawElements, PFNGLMULTIDRAWELEMENTSPROC, (GLenum mode, const GLsizei *count, GLenum type, const void *const *indices, GLsizei drawcount), (mode, count, type, indices, drawcount)) \
+    X(MultiDrawElementsBaseVertex, PFNGLMULTIDRAWELEMENTSBASEVERTEXPROC, (GLenum mode, const GLsizei *count, GLenum type, const void *const *indices, GLsizei drawcount, const GLint *basevertex), (mode, count, type, indices, drawcount, basevertex)) \
+    X(MultiDrawElementsIndirect, PFNGLMULTIDRAWELEMENTSINDIRECTPROC, (GLenum mode, GLenum type, const void *indirect, GLsizei drawcount, GLsizei stride), (mode, type, indirect, drawcount, stride)) \
+    X(MultiDrawElementsIndirectCount, PFNGLMULTIDRAWELEMENTSINDIRECTCOUNTPROC, (GLenum mode, GLenum type, const void *indirect, GLintptr drawcount, GLsizei maxdrawcount, GLsizei stride), (mode, type, indirect, drawcount, maxdrawcount, stride)) \
+    X(MultiTexCoord1d, PFNGLMULTITEXCOORD1DPROC, (GLenum target, GLdouble s), (target, s)) \
+    X(MultiTexCoord1dv, PFNGLMULTITEXCOORD1DVPROC, (GLenum target, const GLdouble *v), (target, v)) \
+    X(MultiTexCoord1f, PFNGLMULTITEXCOORD1FPROC, (GLenum target, GLfloat s), (target, s)) \
+    X(MultiTexCoord1fv, PFNGLMULTITEXCOORD1FVPROC, (GLenum target, const GLfloat *v), (target, v)) \
+    X(MultiTexCoord1i, PFNGLMULTITEXCOORD1IPROC, (GLenum target, GLint s), (target, s)) \
+    X(MultiTexCoord1iv, PFNGLMULTITEXCOORD1IVPROC, (GLenum target, const GLint *v), (target, v)) \
+    X(MultiTexCoord1s, PFNGLMULTITEXCOORD1SPROC, (GLenum target, GLshort s), (target, s)) \
+    X(MultiTexCoord1sv, PFNGLMULTITEXCOORD1SVPROC, (GLenum target, const GLshort *v), (target, v)) \
+    X(MultiTexCoord2d, PFNGLMULTITEXCOORD2DPROC, (GLenum target, GLdouble s, GLdouble t), (target, s, t)) \
+    X(MultiTexCoord2dv, PFNGLMULTITEXCOORD2DVPROC, (GLenum target, const GLdouble *v), (target, v)) \
+    X(MultiTexCoord2f, PFNGLMULTITEXCOORD2FPROC, (GLenum target, GLfloat s, GLfloat t), (target, s, t)) \
+    X(MultiTexCoord2fv, PFNGLMULTITEXCOORD2FVPROC, (GLenum target, const GLfloat *v), (target, v)) \
+    X(MultiTexCoord2i, PFNGLMULTITEXCOORD2IPROC, (GLenum target, GLint s, GLint t), (target, s, t)) \
+    X(MultiTexCoord2iv, PFNGLMULTITEXCOORD2IVPROC, (GLenum target, const GLint *v), (target, v)) \
+    X(MultiTexCoord2s, PFNGLMULTITEXCOORD2SPROC, (GLenum target, GLshort s, GLshort t), (target, s, t)) \
+    X(MultiTexCoord2sv, PFNGLMULTITEXCOORD2SVPROC, (GLenum target, const GLshort *v), (target, v)) \
+    X(MultiTexCoord3d, PFNGLMULTITEXCOORD3DPROC, (GLenum target, GLdouble s, GLdouble t, GLdouble r), (target, s, t, r)) \
+    X(MultiTexCoord3dv, PFNGLMULTITEXCOORD3DVPROC, (GLenum target, const GLdouble *v), (target, v)) \
+    X(MultiTexCoord3f, PFNGLMULTITEXCOORD3FPROC, (GLenum target, GLfloat s, GLfloat t, GLfloat r), (target, s, t, r)) \
+    X(MultiTexCoord3fv, PFNGLMULTITEXCOORD3FVPROC, (GLenum target, const GLfloat *v), (target, v)) \
+    X(MultiTexCoord3i, PFNGLMULTITEXCOORD3IPROC, (GLenum target, GLint s, GLint t, GLint r), (target, s, t, r)) \
+    X(MultiTexCoord3iv, PFNGLMULTITEXCOORD3IVPROC, (GLenum target, const GLint *v), (target, v)) \
+    X(MultiTexCoord3s, PFNGLMULTITEXCOORD3SPROC, (GLenum target, GLshort s, GLshort t, GLshort r), (target, s, t, r)) \
+    X(MultiTexCoord3sv, PFNGLMULTITEXCOORD3SVPROC, (GLenum target, const GLshort *v), (target, v)) \
+    X(MultiTexCoord4d, PFNGLMULTITEXCOORD4DPROC, (GLenum target, GLdouble s, GLdouble t, GLdouble r, GLdouble q), (target, s, t, r, q)) \
+    X(MultiTexCoord4dv, PFNGLMULTITEXCOORD4DVPROC, (GLenum target, const GLdouble *v), (target, v)) \
+    X(MultiTexCoord4f, PFNGLMULTITEXCOORD4FPROC, (GLenum target, GLfloat s, GLfloat t, GLfloat r, GLfloat q), (target, s, t, r, q)) \
+    X(MultiTexCoord4fv, PFNGLMULTITEXCOORD4FVPROC, (GLenum target, const GLfloat *v), (target, v)) \
+    X(MultiTexCoord4i, PFNGLMULTITEXCOORD4IPROC, (GLenum target, GLint s, GLint t, GLint r, GLint q), (target, s, t, r, q)) \
+    X(MultiTexCoord4iv, PFNGLMULTITEXCOORD4IVPROC, (GLenum target, const GLint *v), (target, v)) \
+    X(MultiTexCoord4s, PFNGLMULTITEXCOORD4SPROC, (GLenum target, GLshort s, GLshort t, GLshort r, GLshort q), (target, s, t, r, q)) \
+    X(MultiTexCoord4sv, PFNGLMULTITEXCOORD4SVPROC, (GLenum target, const GLshort *v), (target, v)) \
+    X(MultiTexCoordP1ui, PFNGLMULTITEXCOORDP1UIPROC, (GLenum texture, GLenum type, GLuint coords), (texture, type, coords)) \
+    X(MultiTexCoordP1uiv, PFNGLMULTITEXCOORDP1UIVPROC, (GLenum texture, GLenum type, const GLuint *coords), (texture, type, coords)) \
+    X(MultiTexCoordP2ui, PFNGLMULTITEXCOORDP2UIPROC, (GLenum texture, GLenum type, GLuint coords), (texture, type, coords)) \
+    X(MultiTexCoordP2uiv, PFNGLMULTITEXCOORDP2UIVPROC, (GLenum texture, GLenum type, const GLuint *coords), (texture, type, coords)) \
+    X(MultiTexCoordP3ui, PFNGLMULTITEXCOORDP3UIPROC, (GLenum texture, GLenum type, GLuint coords), (texture, type, coords)) \
+    X(MultiTexCoordP3uiv, PFNGLMULTITEXCOORDP3UIVPROC, (GLenum texture, GLenum type, const GLuint *coords), (texture, type, coords)) \
+    X(MultiTexCoordP4ui, PFNGLMULTITEXCOORDP4UIPROC, (GLenum texture, GLenum type, GLuint coords), (texture, type, coords)) \
+    X(MultiTexCoordP4uiv, PFNGLMULTITEXCOORDP4UIVPROC, (GLenum texture, GLenum type, const GLuint *coords), (texture, type, coords)) \
+    X(NamedBufferData, PFNGLNAMEDBUFFERDATAPROC, (GLuint buffer, GLsizeiptr size, const void *data, GLenum usage), (buffer, size, data, usage)) \
+    X(NamedBufferStorage, PFNGLNAMEDBUFFERSTORAGEPROC, (GLuint buffer, GLsizeiptr size, const void *data, GLbitfield flags), (buffer, size, data, flags)) \
+    X(NamedBufferSubData, PFNGLNAMEDBUFFERSUBDATAPROC, (GLuint buffer, GLintptr offset, GLsizeiptr size, const void *data), (buffer, offset, size, data)) \
+    X(NamedFramebufferDrawBuffer, PFNGLNAMEDFRAMEBUFFERDRAWBUFFERPROC, (GLuint framebuffer, GLenum buf), (framebuffer, buf)) \
+    X(NamedFramebufferDrawBuffers, PFNGLNAMEDFRAMEBUFFERDRAWBUFFERSPROC, (GLuint framebuffer, GLsizei n, const GLenum *bufs), (framebuffer, n, bufs)) \
+    X(NamedFramebufferParameteri, PFNGLNAMEDFRAMEBUFFERPARAMETERIPROC, (GLuint framebuffer, GLenum pname, GLint param), (framebuffer, pname, param)) \
+    X(NamedFramebufferReadBuffer, PFNGLNAMEDFRAMEBUFFERREADBUFFERPROC, (GLuint framebuffer, GLenum src), (framebuffer, src)) \
+    X(NamedFramebufferRenderbuffer, PFNGLNAMEDFRAMEBUFFERRENDERBUFFERPROC, (GLuint framebuffer, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer), (framebuffer, attachment, renderbuffertarget, renderbuffer)) \
+    X(NamedFramebufferTexture, PFNGLNAMEDFRAMEBUFFERTEXTUREPROC, (GLuint framebuffer, GLenum attachment, GLuint texture, GLint level), (framebuffer, attachment, texture, level)) \
+    X(NamedFramebufferTextureLayer, PFNGLNAMEDFRAMEBUFFERTEXTURELAYERPROC, (GLuint framebuffer, GLenum attachment, GLuint texture, GLint level, GLint layer), (framebuffer, attachment, texture, level, layer)) \
+    X(NamedRenderbufferStorage, PFNGLNAMEDRENDERBUFFERSTORAGEPROC, (GLuint renderbuffer, GLenum internalformat, GLsizei width, GLsizei height), (renderbuffer, internalformat, width, height)) \
+    X(NamedRenderbufferStorageMultisample, PFNGLNAMEDRENDERBUFFERSTORAGEMULTISAMPLEPROC, (GLuint renderbuffer, GLsizei samples, GLenum internalformat, GLsizei width, GLsizei height), (renderbuffer, samples, internalformat, width, height)) \
+    X(NewList, PFNGLNEWLISTPROC, (GLuint list, GLenum mode), (list, mode)) \
+    X(Normal3b, PFNGLNORMAL3BPROC, (GLbyte nx, GLbyte ny, GLbyte nz), (nx, ny, nz)) \
+    X(Normal3bv, PFNGLNORMAL3BVPROC, (const GLbyte *v), (v)) \
+    X(Normal3d, PFNGLNORMAL3DPROC, (GLdouble nx, GLdouble ny, GLdouble nz), (nx, ny, nz)) \
+    X(Normal3dv, PFNGLNORMAL3DVPROC, (const GLdouble *v), (v)) \
+    X(Normal3f, PFNGLNORMAL3FPROC, (GLfloat nx, GLfloat ny, GLfloat nz), (nx, ny, nz)) \
+    X(Normal3fv, PFNGLNORMAL3FVPROC, (const GLfloat *v), (v)) \
+    X(Normal3i, PFNGLNORMAL3IPROC, (GLint nx, GLint ny, GLint nz), (nx, ny, nz)) \
+    X(Normal3iv, PFNGLNORMAL3IVPROC, (const GLint *v), (v)) \
+    X(Normal3s, PFNGLNORMAL3SPROC, (GLshort nx, GLshort ny, GLshort nz), (nx, ny, nz)) \
+    X(Normal3sv, PFNGLNORMAL3SVPROC, (const GLshort *v), (v)) \
+    X(NormalP3ui, PFNGLNORMALP3UIPROC, (GLenum type, GLuint coords), (type, coords)) \
+    X(NormalP3uiv, PFNGLNORMALP3UIVPROC, (GLenum type, const GLuint *coords), (type, coords)) \
+    X(NormalPointer, PFNGLNORMALPOINTERPROC, (GLenum type, GLsizei stride, const void *pointer), (type, stride, pointer)) \
+    X(ObjectLabel, PFNGLOBJECTLABELPROC, (GLenum identifier, GLuint name, GLsizei length, const GLchar *label), (identifier, name, length, label)) \
+    X(ObjectPtrLabel, PFNGLOBJECTPTRLABELPROC, (const void *ptr, GLsizei length, const GLchar *label), (ptr, length, label)) \
+    X(Ortho, PFNGLORTHOPROC, (GLdouble left, GLdouble right, GLdouble bottom, GLdouble top, GLdouble zNear, GLdouble zFar), (left, right, bottom, top, zNear, zFar)) \
+    X(PassThrough, PFNGLPASSTHROUGHPROC, (GLfloat token), (token)) \
+    X(PatchParameterfv, PFNGLPATCHPARAMETERFVPROC, (GLenum pname, const GLfloat *values), (pname, values)) \
+    X(PatchParameteri, PFNGLPATCHPARAMETERIPROC, (GLenum pname, GLint value), (pname, value)) \
+    X(PauseTransformFeedback, PFNGLPAUSETRANSFORMFEEDBACKPROC, (void), ()) \
+    X(PixelMapfv, PFNGLPIXELMAPFVPROC, (GLenum map, GLsizei mapsize, const GLfloat *values), (map, mapsize, values)) \
+    X(PixelMapuiv, PFNGLPIXELMAPUIVPROC, (GLenum map, GLsizei mapsize, const GLuint *values), (map, mapsize, values)) \
+    X(PixelMapusv, PFNGLPIXELMAPUSVPROC, (GLenum map, GLsizei mapsize, const GLushort *values), (map, mapsize, values)) \
+    X(PixelStoref, PFNGLPIXELSTOREFPROC, (GLenum pname, GLfloat param), (pname, param)) \
+    X(PixelStorei, PFNGLPIXELSTOREIPROC, (GLenum pname, GLint param), (pname, param)) \
+    X(PixelTransferf, PFNGLPIXELTRANSFERFPROC, (GLenum pname, GLfloat param), (pname, param)) \
+    X(PixelTransferi, PFNGLPIXELTRANSFERIPROC, (GLenum pname, GLint param), (pname, param)) \
+    X(PixelZoom, PFNGLPIXELZOOMPROC, (GLfloat xfactor, GLfloat yfactor), (xfactor, yfactor)) \
+    X(PointParameterf, PFNGLPOINTPARAMETERFPROC, (GLenum pname, GLfloat param), (pname, param)) \
+    X(PointParameterfv, PFNGLPOINTPARAMETERFVPROC, (GLenum pname, const GLfloat *params), (pname, params)) \
+    X(PointParameteri, PFNGLPOINTPARAMETERIPROC, (GLenum pname, GLint param), (pname, param)) \
+    X(PointParameteriv, PFNGLPOINTPARAMETERIVPROC, (GLenum pname, const GLint *params), (pname, params)) \
+    X(PointSize, PFNGLPOINTSIZEPROC, (GLfloat size), (size)) \
+    X(PolygonMode, PFNGLPOLYGONMODEPROC, (GLenum face, GLenum mode), (face, mode)) \
+    X(PolygonOffset, PFNGLPOLYGONOFFSETPROC, (GLfloat factor, GLfloat units), (factor, units)) \
+    X(PolygonOffsetClamp, PFNGLPOLYGONOFFSETCLAMPPROC, (GLfloat factor, GLfloat units, GLfloat clamp), (factor, units, clamp)) \
+    X(PolygonStipple, PFNGLPOLYGONSTIPPLEPROC, (const GLubyte *mask), (mask)) \
+    X(PopAttrib, PFNGLPOPATTRIBPROC, (void), ()) \
+    X(PopClientAttrib, PFNGLPOPCLIENTATTRIBPROC, (void), ()) \
+    X(PopDebugGroup, PFNGLPOPDEBUGGROUPPROC, (void), ()) \
+    X(PopMatrix, PFNGLPOPMATRIXPROC, (void), ()) \
+    X(PopName, PFNGLPOPNAMEPROC, (void), ()) \
+    X(PrimitiveRestartIndex, PFNGLPRIMITIVERESTARTINDEXPROC, (GLuint index), (index)) \
+    X(PrioritizeTextures, PFNGLPRIORITIZETEXTURESPROC, (GLsizei n, const GLuint *textures, const GLfloat *priorities), (n, textures, priorities)) \
+    X(ProgramBinary, PFNGLPROGRAMBINARYPROC, (GLuint program, GLenum binaryFormat, const void *binary, GLsizei length), (program, binaryFormat, binary, length)) \
+    X(ProgramParameteri, PFNGLPROGRAMPARAMETERIPROC, (GLuint program, GLenum pname, GLint value), (program, pname, value)) \
+    X(ProgramUniform1d, PFNGLPROGRAMUNIFORM1DPROC, (GLuint program, GLint location, GLdouble v0), (program, location, v0)) \
+    X(ProgramUniform1dv, PFNGLPROGRAMUNIFORM1DVPROC, (GLuint program, GLint location, GLsizei count, const GLdouble *value), (program, location, count, value)) \
+    X(ProgramUniform1f, PFNGLPROGRAMUNIFORM1FPROC, (GLuint program, GLint location, GLfloat v0), (program, location, v0)) \
+    X(ProgramUniform1fv, PFNGLPROGRAMUNIFORM1FVPROC, (GLuint program, GLint location, GLsizei count, const GLfloat *value), (program, location, count, value)) \
+    X(ProgramUniform1i, PFNGLPROGRAMUNIFORM1IPROC, (GLuint program, GLint location, GLint v0), (program, location, v0)) \
+    X(ProgramUniform1iv, PFNGLPROGRAMUNIFORM1IVPROC, (GLuint program, GLint location, GLsizei count, const GLint *value), (program, location, count, value)) \
+    X(ProgramUniform1ui, PFNGLPROGRAMUNIFORM1UIPROC, (GLuint program, GLint location, GLuint v0), (program, location, v0)) \
+    X(ProgramUniform1uiv, PFNGLPROGRAMUNIFORM1UIVPROC, (GLuint program, GLint location, GLsizei count, const GLuint *value), (program, location, count, value)) \
+    X(ProgramUniform2d, PFNGLPROGRAMUNIFORM2DPROC, (GLuint program, GLint location, GLdouble v0, GLdouble v1), (program, location, v0, v1)) \
+    X(ProgramUniform2dv, PFNGLPROGRAMUNIFORM2DVPROC, (GLuint program, GLint location, GLsizei count, const GLdouble *value), (program, location, count, value)) \
+    X(ProgramUniform2f, PFNGLPROGRAMUNIFORM2FPROC, (GLuint program, GLint location, GLfloat v0, GLfloat v1), (program, location, v0, v1)) \
+    X(ProgramUniform2fv, PFNGLPROGRAMUNIFORM2FVPROC, (GLuint program, GLint location, GLsizei count, const GLfloat *value), (program, location, count, value)) \
+    X(ProgramUniform2i, PFNGLPROGRAMUNIFORM2IPROC, (GLuint program, GLint location, GLint v0, GLint v1), (program, location, v0, v1)) \
+    X(ProgramUniform2iv, PFNGLPROGRAMUNIFORM2IVPROC, (GLuint program, GLint location, GLsizei count, const GLint *value), (program, location, count, value)) \
+    X(ProgramUniform2ui, PFNGLPROGRAMUNIFORM2UIPROC, (GLuint program, GLint location, GLuint v0, GLuint v1), (program, location, v0, v1)) \
+    X(ProgramUniform2uiv, PFNGLPROGRAMUNIFORM2UIVPROC, (GLuint program, GLint location, GLsizei count, const GLuint *value), (program, location, count, value)) \
+    X(ProgramUniform3d, PFNGLPROGRAMUNIFORM3DPROC, (GLuint program, GLint location, GLdouble v0, GLdouble v1, GLdouble v2), (program, location, v0, v1, v2)) \
+    X(ProgramUniform3dv, PFNGLPROGRAMUNIFORM3DVPROC, (GLuint program, GLint location, GLsizei count, const GLdouble *value), (program, location, count, value)) \
+    X(ProgramUniform3f, PFNGLPROGRAMUNIFORM3FPROC, (GLuint program, GLint location, GLfloat v0, GLfloat v1, GLfloat v2), (program, location, v0, v1, v2)) \
+    X(ProgramUniform3fv, PFNGLPROGRAMUNIFORM3FVPROC, (GLuint program, GLint location, GLsizei count, const GLfloat *value), (program, location, count, value)) \
+    X(ProgramUniform3i, PFNGLPROGRAMUNIFORM3IPROC, (GLuint program, GLint location, GLint v0, GLint v1, GLint v2), (program, location, v0, v1, v2)) \
+    X(ProgramUniform3iv, PFNGLPROGRAMUNIFORM3IVPROC, (GLuint program, GLint location, GLsizei count, const GLint *value), (program, location, count, value)) \
+    X(ProgramUniform3ui, PFNGLPROGRAMUNIFORM3UIPROC, (GLuint program, GLint location, GLuint v0, GLuint v1, GLuint v2), (program, location, v0, v1, v2)) \
+    X(ProgramUniform3uiv, PFNGLPROGRAMUNIFORM3UIVPROC, (GLuint program, GLint location, GLsizei count, const GLuint *value), (program, location, count, value)) \
+    X(ProgramUniform4d, PFNGLPROGRAMUNIFORM4DPROC, (GLuint program, GLint location, GLdouble v0, GLdouble v1, GLdouble v2, GLdouble v3), (program, location, v0, v1, v2, v3)) \
+    X(ProgramUniform4dv, PFNGLPROGRAMUNIFORM4DVPROC, (GLuint program, GLint location, GLsizei count, const GLdouble *value), (program, location, count, value)) \
+    X(ProgramUniform4f, PFNGLPROGRAMUNIFORM4FPROC, (GLuint program, GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3), (program, location, v0, v1, v2, v3)) \
+    X(ProgramUniform4fv, PFNGLPROGRAMUNIFORM4FVPROC, (GLuint program, GLint location, GLsizei count, const GLfloat *value), (program, location, count, value)) \
+    X(ProgramUniform4i, PFNGLPROGRAMUNIFORM4IPROC, (GLuint program, GLint location, GLint v0, GLint v1, GLint v2, GLint v3), (program, location, v0, v1, v2, v3)) \
+    X(ProgramUniform4iv, PFNGLPROGRAMUNIFORM4IVPROC, (GLuint program, GLint location, GLsizei count, const GLint *value), (program, location, count, value)) \
+    X(ProgramUniform4ui, PFNGLPROGRAMUNIFORM4UIPROC, (GLuint program, GLint location, GLuint v0, GLuint v1, GLuint v2, GLuint v3), (program, location, v0, v1, v2, v3)) \
+    X(ProgramUniform4uiv, PFNGLPROGRAMUNIFORM4UIVPROC, (GLuint program, GLint location, GLsizei count, const GLuint *value), (program, location, count, value)) \
+    X(ProgramUniformMatrix2dv, PFNGLPROGRAMUNIFORMMATRIX2DVPROC, (GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLdouble *value), (program, location, count, transpose, value)) \
+    X(ProgramUniformMatrix2fv, PFNGLPROGRAMUNIFORMMATRIX2FVPROC, (GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (program, location, count, transpose, value)) \
+    X(ProgramUniformMatrix2x3dv, PFNGLPROGRAMUNIFORMMATRIX2X3DVPROC, (GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLdouble *value), (program, location, count, transpose, value)) \
+    X(ProgramUniformMatrix2x3fv, PFNGLPROGRAMUNIFORMMATRIX2X3FVPROC, (GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (program, location, count, transpose, value)) \
+    X(ProgramUniformMatrix2x4dv, PFNGLPROGRAMUNIFORMMATRIX2X4DVPROC, (GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLdouble *value), (program, location, count, transpose, value)) \
+    X(ProgramUniformMatrix2x4fv, PFNGLPROGRAMUNIFORMMATRIX2X4FVPROC, (GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (program, location, count, transpose, value)) \
+    X(ProgramUniformMatrix3dv, PFNGLPROGRAMUNIFORMMATRIX3DVPROC, (GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLdouble *value), (program, location, count, transpose, value)) \
+    X(ProgramUniformMatrix3fv, PFNGLPROGRAMUNIFORMMATRIX3FVPROC, (GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (program, location, count, transpose, value)) \
+    X(ProgramUniformMatrix3x2dv, PFNGLPROGRAMUNIFORMMATRIX3X2DVPROC, (GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLdouble *value), (program, location, count, transpose, value)) \
+    X(ProgramUniformMatrix3x2fv, PFNGLPROGRAMUNIFORMMATRIX3X2FVPROC, (GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (program, location, count, transpose, value)) \
+    X(ProgramUniformMatrix3x4dv, PFNGLPROGRAMUNIFORMMATRIX3X4DVPROC, (GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLdouble *value), (program, location, count, transpose, value)) \
+    X(ProgramUniformMatrix3x4fv, PFNGLPROGRAMUNIFORMMATRIX3X4FVPROC, (GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (program, location, count, transpose, value)) \
+    X(ProgramUniformMatrix4dv, PFNGLPROGRAMUNIFORMMATRIX4DVPROC, (GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLdouble *value), (program, location, count, transpose, value)) \
+    X(ProgramUniformMatrix4fv, PFNGLPROGRAMUNIFORMMATRIX4FVPROC, (GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (program, location, count, transpose, value)) \
+    X(ProgramUniformMatrix4x2dv, PFNGLPROGRAMUNIFORMMATRIX4X2DVPROC, (GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLdouble *value), (program, location, count, transpose, value)) \
+    X(ProgramUniformMatrix4x2fv, PFNGLPROGRAMUNIFORMMATRIX4X2FVPROC, (GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (program, location, count, transpose, value)) \
+    X(ProgramUniformMatrix4x3dv, PFNGLPROGRAMUNIFORMMATRIX4X3DVPROC, (GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLdouble *value), (program, location, count, transpose, value)) \
+    X(ProgramUniformMatrix4x3fv, PFNGLPROGRAMUNIFORMMATRIX4X3FVPROC, (GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (program, location, count, transpose, value)) \
+    X(ProvokingVertex, PFNGLPROVOKINGVERTEXPROC, (GLenum mode), (mode)) \
+    X(PushAttrib, PFNGLPUSHATTRIBPROC, (GLbitfield mask), (mask)) \
+    X(PushClientAttrib, PFNGLPUSHCLIENTATTRIBPROC, (GLbitfield mask), (mask)) \
+    X(PushDebugGroup, PFNGLPUSHDEBUGGROUPPROC, (GLenum source, GLuint id, GLsizei length, const GLchar *message), (source, id, length, message)) \
+    X(PushMatrix, PFNGLPUSHMATRIXPROC, (void), ()) \
+    X(PushName, PFNGLPUSHNAMEPROC, (GLuint name), (name)) \
+    X(QueryCounter, PFNGLQUERYCOUNTERPROC, (GLuint id, GLenum target), (id, target)) \
+    X(RasterPos2d, PFNGLRASTERPOS2DPROC, (GLdouble x, GLdouble y), (x, y)) \
+    X(RasterPos2dv, PFNGLRASTERPOS2DVPROC, (const GLdouble *v), (v)) \
+    X(RasterPos2f, PFNGLRASTERPOS2FPROC, (GLfloat x, GLfloat y), (x, y)) \
+    X(RasterPos2fv, PFNGLRASTERPOS2FVPROC, (const GLfloat *v), (v)) \
+    X(RasterPos2i, PFNGLRASTERPOS2IPROC, (GLint x, GLint y), (x, y)) \
+    X(RasterPos2iv, PFNGLRASTERPOS2IVPROC, (const GLint *v), (v)) \
+    X(RasterPos2s, PFNGLRASTERPOS2SPROC, (GLshort x, GLshort y), (x, y)) \
+    X(RasterPos2sv, PFNGLRASTERPOS2SVPROC, (const GLshort *v), (v)) \
+    X(RasterPos3d, PFNGLRASTERPOS3DPROC, (GLdouble x, GLdouble y, GLdouble z), (x, y, z)) \
+    X(RasterPos3dv, PFNGLRASTERPOS3DVPROC, (const GLdouble *v), (v)) \
+    X(RasterPos3f, PFNGLRASTERPOS3FPROC, (GLfloat x, GLfloat y, GLfloat z), (x, y, z)) \
+    X(RasterPos3fv, PFNGLRASTERPOS3FVPROC, (const GLfloat *v), (v)) \
+    X(RasterPos3i, PFNGLRASTERPOS3IPROC, (GLint x, GLint y, GLint z), (x, y, z)) \
+    X(RasterPos3iv, PFNGLRASTERPOS3IVPROC, (const GLint *v), (v)) \
+    X(RasterPos3s, PFNGLRASTERPOS3SPROC, (GLshort x, GLshort y, GLshort z), (x, y, z)) \
+    X(RasterPos3sv, PFNGLRASTERPOS3SVPROC, (const GLshort *v), (v)) \
+    X(RasterPos4d, PFNGLRASTERPOS4DPROC, (GLdouble x, GLdouble y, GLdouble z, GLdouble w), (x, y, z, w)) \
+    X(RasterPos4dv, PFNGLRASTERPOS4DVPROC, (const GLdouble *v), (v)) \
+    X(RasterPos4f, PFNGLRASTERPOS4FPROC, (GLfloat x, GLfloat y, GLfloat z, GLfloat w), (x, y, z, w)) \
+    X(RasterPos4fv, PFNGLRASTERPOS4FVPROC, (const GLfloat *v), (v)) \
+    X(RasterPos4i, PFNGLRASTERPOS4IPROC, (GLint x, GLint y, GLint z, GLint w), (x, y, z, w)) \
+    X(RasterPos4iv, PFNGLRASTERPOS4IVPROC, (const GLint *v), (v)) \
+    X(RasterPos4s, PFNGLRASTERPOS4SPROC, (GLshort x, GLshort y, GLshort z, GLshort w), (x, y, z, w)) \
+    X(RasterPos4sv, PFNGLRASTERPOS4SVPROC, (const GLshort *v), (v)) \
+    X(ReadBuffer, PFNGLREADBUFFERPROC, (GLenum src), (src)) \
+    X(ReadPixels, PFNGLREADPIXELSPROC, (GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void *pixels), (x, y, width, height, format, type, pixels)) \
+    X(ReadnPixels, PFNGLREADNPIXELSPROC, (GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, GLsizei bufSize, void *data), (x, y, width, height, format, type, bufSize, data)) \
+    X(Rectd, PFNGLRECTDPROC, (GLdouble x1, GLdouble y1, GLdouble x2, GLdouble y2), (x1, y1, x2, y2)) \
+    X(Rectdv, PFNGLRECTDVPROC, (const GLdouble *v1, const GLdouble *v2), (v1, v2)) \
+    X(Rectf, PFNGLRECTFPROC, (GLfloat x1, GLfloat y1, GLfloat x2, GLfloat y2), (x1, y1, x2, y2)) \
+    X(Rectfv, PFNGLRECTFVPROC, (const GLfloat *v1, const GLfloat *v2), (v1, v2)) \
+    X(Recti, PFNGLRECTIPROC, (GLint x1, GLint y1, GLint x2, GLint y2), (x1, y1, x2, y2)) \
+    X(Rectiv, PFNGLRECTIVPROC, (const GLint *v1, const GLint *v2), (v1, v2)) \
+    X(Rects, PFNGLRECTSPROC, (GLshort x1, GLshort y1, GLshort x2, GLshort y2), (x1, y1, x2, y2)) \
+    X(Rectsv, PFNGLRECTSVPROC, (const GLshort *v1, const GLshort *v2), (v1, v2)) \
+    X(ReleaseShaderCompiler, PFNGLRELEASESHADERCOMPILERPROC, (void), ()) \
+    XR(GLint, RenderMode, PFNGLRENDERMODEPROC, (GLenum mode), (mode)) \
+    X(RenderbufferStorage, PFNGLRENDERBUFFERSTORAGEPROC, (GLenum target, GLenum internalformat, GLsizei width, GLsizei height), (target, internalformat, width, height)) \
+    X(RenderbufferStorageMultisample, PFNGLRENDERBUFFERSTORAGEMULTISAMPLEPROC, (GLenum target, GLsizei samples, GLenum internalformat, GLsizei width, GLsizei height), (target, samples, internalformat, width, height)) \
+    X(ResumeTransformFeedback, PFNGLRESUMETRANSFORMFEEDBACKPROC, (void), ()) \
+    X(Rotated, PFNGLROTATEDPROC, (GLdouble angle, GLdouble x, GLdouble y, GLdouble z), (angle, x, y, z)) \
+    X(Rotatef, PFNGLROTATEFPROC, (GLfloat angle, GLfloat x, GLfloat y, GLfloat z), (angle, x, y, z)) \
+    X(SampleCoverage, PFNGLSAMPLECOVERAGEPROC, (GLfloat value, GLboolean invert), (value, invert)) \
+    X(SampleMaski, PFNGLSAMPLEMASKIPROC, (GLuint maskNumber, GLbitfield mask), (maskNumber, mask)) \
+    X(SamplerParameterIiv, PFNGLSAMPLERPARAMETERIIVPROC, (GLuint sampler, GLenum pname, const GLint *param), (sampler, pname, param)) \
+    X(SamplerParameterIuiv, PFNGLSAMPLERPARAMETERIUIVPROC, (GLuint sampler, GLenum pname, const GLuint *param), (sampler, pname, param)) \
+    X(SamplerParameterf, PFNGLSAMPLERPARAMETERFPROC, (GLuint sampler, GLenum pname, GLfloat param), (sampler, pname, param)) \
+    X(SamplerParameterfv, PFNGLSAMPLERPARAMETERFVPROC, (GLuint sampler, GLenum pname, const GLfloat *param), (sampler, pname, param)) \
+    X(SamplerParameteri, PFNGLSAMPLERPARAMETERIPROC, (GLuint sampler, GLenum pname, GLint param), (sampler, pname, param)) \
+    X(SamplerParameteriv, PFNGLSAMPLERPARAMETERIVPROC, (GLuint sampler, GLenum pname, const GLint *param), (sampler, pname, param)) \
+    X(Scaled, PFNGLSCALEDPROC, (GLdouble x, GLdouble y, GLdouble z), (x, y, z)) \
+    X(Scalef, PFNGLSCALEFPROC, (GLfloat x, GLfloat y, GLfloat z), (x, y, z)) \
+    X(Scissor, PFNGLSCISSORPROC, (GLint x, GLint y, GLsizei width, GLsizei height), (x, y, width, height)) \
+    X(ScissorArrayv, PFNGLSCISSORARRAYVPROC, (GLuint first, GLsizei count, const GLint *v), (first, count, v)) \
+    X(ScissorIndexed, PFNGLSCISSORINDEXEDPROC, (GLuint index, GLint left, GLint bottom, GLsizei width, GLsizei height), (index, left, bottom, width, height)) \
+    X(ScissorIndexedv, PFNGLSCISSORINDEXEDVPROC, (GLuint index, const GLint *v), (index, v)) \
+    X(SecondaryColor3b, PFNGLSECONDARYCOLOR3BPROC, (GLbyte red, GLbyte green, GLbyte blue), (red, green, blue)) \
+    X(SecondaryColor3bv, PFNGLSECONDARYCOLOR3BVPROC, (const GLbyte *v), (v)) \
+    X(SecondaryColor3d, PFNGLSECONDARYCOLOR3DPROC, (GLdouble red, GLdouble green, GLdouble blue), (red, green, blue)) \
+    X(SecondaryColor3dv, PFNGLSECONDARYCOLOR3DVPROC, (const GLdouble *v), (v)) \
+    X(SecondaryColor3f, PFNGLSECONDARYCOLOR3FPROC, (GLfloat red, GLfloat green, GLfloat blue), (red, green, blue)) \
+    X(SecondaryColor3fv, PFNGLSECONDARYCOLOR3FVPROC, (const GLfloat *v), (v)) \
+    X(SecondaryColor3i, PFNGLSECONDARYCOLOR3IPROC, (GLint red, GLint green, GLint blue), (red, green, blue)) \
+    X(SecondaryColor3iv, PFNGLSECONDARYCOLOR3IVPROC, (const GLint *v), (v)) \
+    X(SecondaryColor3s, PFNGLSECONDARYCOLOR3SPROC, (GLshort red, GLshort green, GLshort blue), (red, green, blue)) \
+    X(SecondaryColor3sv, PFNGLSECONDARYCOLOR3SVPROC, (const GLshort *v), (v)) \
+    X(SecondaryColor3ub, PFNGLSECONDARYCOLOR3UBPROC, (GLubyte red, GLubyte green, GLubyte blue), (red, green, blue)) \
+    X(SecondaryColor3ubv, PFNGLSECONDARYCOLOR3UBVPROC, (const GLubyte *v), (v)) \
+    X(SecondaryColor3ui, PFNGLSECONDARYCOLOR3UIPROC, (GLuint red, GLuint green, GLuint blue), (red, green, blue)) \
+    X(SecondaryColor3uiv, PFNGLSECONDARYCOLOR3UIVPROC, (const GLuint *v), (v)) \
+    X(SecondaryColor3us, PFNGLSECONDARYCOLOR3USPROC, (GLushort red, GLushort green, GLushort blue), (red, green, blue)) \
+    X(SecondaryColor3usv, PFNGLSECONDARYCOLOR3USVPROC, (const GLushort *v), (v)) \
+    X(SecondaryColorP3ui, PFNGLSECONDARYCOLORP3UIPROC, (GLenum type, GLuint color), (type, color)) \
+    X(SecondaryColorP3uiv, PFNGLSECONDARYCOLORP3UIVPROC, (GLenum type, const GLuint *color), (type, color)) \
+    X(SecondaryColorPointer, PFNGLSECONDARYCOLORPOINTERPROC, (GLint size, GLenum type, GLsizei stride, const void *pointer), (size, type, stride, pointer)) \
+    X(SelectBuffer, PFNGLSELECTBUFFERPROC, (GLsizei size, GLuint *buffer), (size, buffer)) \
+    X(ShadeModel, PFNGLSHADEMODELPROC, (GLenum mode), (mode)) \
+    X(ShaderBinary, PFNGLSHADERBINARYPROC, (GLsizei count, const GLuint *shaders, GLenum binaryFormat, const void *binary, GLsizei length), (count, shaders, binaryFormat, binary, length)) \
+    X(ShaderSource, PFNGLSHADERSOURCEPROC, (GLuint shader, GLsizei count, const GLchar *const *string, const GLint *length), (shader, count, string, length)) \
+    X(ShaderStorageBlockBinding, PFNGLSHADERSTORAGEBLOCKBINDINGPROC, (GLuint program, GLuint storageBlockIndex, GLuint storageBlockBinding), (program, storageBlockIndex, storageBlockBinding)) \
+    X(SpecializeShader, PFNGLSPECIALIZESHADERPROC, (GLuint shader, const GLchar *pEntryPoint, GLuint numSpecializationConstants, const GLuint *pConstantIndex, const GLuint *pConstantValue), (shader, pEntryPoint, numSpecializationConstants, pConstantIndex, pConstantValue)) \
+    X(StencilFunc, PFNGLSTENCILFUNCPROC, (GLenum func, GLint ref, GLuint mask), (func, ref, mask)) \
+    X(StencilFuncSeparate, PFNGLSTENCILFUNCSEPARATEPROC, (GLenum face, GLenum func, GLint ref, GLuint mask), (face, func, ref, mask)) \
+    X(StencilMask, PFNGLSTENCILMASKPROC, (GLuint mask), (mask)) \
+    X(StencilMaskSeparate, PFNGLSTENCILMASKSEPARATEPROC, (GLenum face, GLuint mask), (face, mask)) \
+    X(StencilOp, PFNGLSTENCILOPPROC, (GLenum fail, GLenum zfail, GLenum zpass), (fail, zfail, zpass)) \
+    X(StencilOpSeparate, PFNGLSTENCILOPSEPARATEPROC, (GLenum face, GLenum sfail, GLenum dpfail, GLenum dppass), (face, sfail, dpfail, dppass)) \
+    X(TexBuffer, PFNGLTEXBUFFERPROC, (GLenum target, GLenum internalformat, GLuint buffer), (target, internalformat, buffer)) \
+    X(TexBufferRange, PFNGLTEXBUFFERRANGEPROC, (GLenum target, GLenum internalformat, GLuint buffer, GLintptr offset, GLsizeiptr size), (target, internalformat, buffer, offset, size)) \
+    X(TexCoord1d, PFNGLTEXCOORD1DPROC, (GLdouble s), (s)) \
+    X(TexCoord1dv, PFNGLTEXCOORD1DVPROC, (const GLdouble *v), (v)) \
+    X(TexCoord1f, PFNGLTEXCOORD1FPROC, (GLfloat s), (s)) \
+    X(TexCoord1fv, PFNGLTEXCOORD1FVPROC, (const GLfloat *v), (v)) \
+    X(TexCoord1i, PFNGLTEXCOORD1IPROC, (GLint s), (s)) \
+    X(TexCoord1iv, PFNGLTEXCOORD1IVPROC, (const GLint *v), (v)) \
+    X(TexCoord1s, PFNGLTEXCOORD1SPROC, (GLshort s), (s)) \
+    X(TexCoord1sv, PFNGLTEXCOORD1SVPROC, (const GLshort *v), (v)) \
+    X(TexCoord2d, PFNGLTEXCOORD2DPROC, (GLdouble s, GLdouble t), (s, t)) \
+    X(TexCoord2dv, PFNGLTEXCOORD2DVPROC, (const GLdouble *v), (v)) \
+    X(TexCoord2f, PFNGLTEXCOORD2FPROC, (GLfloat s, GLfloat t), (s, t)) \
+    X(TexCoord2fv, PFNGLTEXCOORD2FVPROC, (const GLfloat *v), (v)) \
+    X(TexCoord2i, PFNGLTEXCOORD2IPROC, (GLint s, GLint t), (s, t)) \
+    X(TexCoord2iv, PFNGLTEXCOORD2IVPROC, (const GLint *v), (v)) \
+    X(TexCoord2s, PFNGLTEXCOORD2SPROC, (GLshort s, GLshort t), (s, t)) \
+    X(TexCoord2sv, PFNGLTEXCOORD2SVPROC, (const GLshort *v), (v)) \
+    X(TexCoord3d, PFNGLTEXCOORD3DPROC, (GLdouble s, GLdouble t, GLdouble r), (s, t, r)) \
+    X(TexCoord3dv, PFNGLTEXCOORD3DVPROC, (const GLdouble *v), (v)) \
+    X(TexCoord3f, PFNGLTEXCOORD3FPROC, (GLfloat s, GLfloat t, GLfloat r), (s, t, r)) \
+    X(TexCoord3fv, PFNGLTEXCOORD3FVPROC, (const GLfloat *v), (v)) \
+    X(TexCoord3i, PFNGLTEXCOORD3IPROC, (GLint s, GLint t, GLint r), (s, t, r)) \
+    X(TexCoord3iv, PFNGLTEXCOORD3IVPROC, (const GLint *v), (v)) \
+    X(TexCoord3s, PFNGLTEXCOORD3SPROC, (GLshort s, GLshort t, GLshort r), (s, t, r)) \
+    X(TexCoord3sv, PFNGLTEXCOORD3SVPROC, (const GLshort *v), (v)) \
+    X(TexCoord4d, PFNGLTEXCOORD4DPROC, (GLdouble s, GLdouble t, GLdouble r, GLdouble q), (s, t, r, q)) \
+    X(TexCoord4dv, PFNGLTEXCOORD4DVPROC, (const GLdouble *v), (v)) \
+    X(TexCoord4f, PFNGLTEXCOORD4FPROC, (GLfloat s, GLfloat t, GLfloat r, GLfloat q), (s, t, r, q)) \
+    X(TexCoord4fv, PFNGLTEXCOORD4FVPROC, (const GLfloat *v), (v)) \
+    X(TexCoord4i, PFNGLTEXCOORD4IPROC, (GLint s, GLint t, GLint r, GLint q), (s, t, r, q)) \
+    X(TexCoord4iv, PFNGLTEXCOORD4IVPROC, (const GLint *v), (v)) \
+    X(TexCoord4s, PFNGLTEXCOORD4SPROC, (GLshort s, GLshort t, GLshort r, GLshort q), (s, t, r, q)) \
+    X(TexCoord4sv, PFNGLTEXCOORD4SVPROC, (const GLshort *v), (v)) \
+    X(TexCoordP1ui, PFNGLTEXCOORDP1UIPROC, (GLenum type, GLuint coords), (type, coords)) \
+    X(TexCoordP1uiv, PFNGLTEXCOORDP1UIVPROC, (GLenum type, const GLuint *coords), (type, coords)) \
+    X(TexCoordP2ui, PFNGLTEXCOORDP2UIPROC, (GLenum type, GLuint coords), (type, coords)) \
+    X(TexCoordP2uiv, PFNGLTEXCOORDP2UIVPROC, (GLenum type, const GLuint *coords), (type, coords)) \
+    X(TexCoordP3ui, PFNGLTEXCOORDP3UIPROC, (GLenum type, GLuint coords), (type, coords)) \
+    X(TexCoordP3uiv, PFNGLTEXCOORDP3UIVPROC, (GLenum type, const GLuint *coords), (type, coords)) \
+    X(TexCoordP4ui, PFNGLTEXCOORDP4UIPROC, (GLenum type, GLuint coords), (type, coords)) \
+    X(TexCoordP4uiv, PFNGLTEXCOORDP4UIVPROC, (GLenum type, const GLuint *coords), (type, coords)) \
+    X(TexCoordPointer, PFNGLTEXCOORDPOINTERPROC, (GLint size, GLenum type, GLsizei stride, const void *pointer), (size, type, stride, pointer)) \
+    X(TexEnvf, PFNGLTEXENVFPROC, (GLenum target, GLenum pname, GLfloat param), (target, pname, param)) \
+    X(TexEnvfv, PFNGLTEXENVFVPROC, (GLenum target, GLenum pname, const GLfloat *params), (target, pname, params)) \
+    X(TexEnvi, PFNGLTEXENVIPROC, (GLenum target, GLenum pname, GLint param), (target, pname, param)) \
+    X(TexEnviv, PFNGLTEXENVIVPROC, (GLenum target, GLenum pname, const GLint *params), (target, pname, params)) \
+    X(TexGend, PFNGLTEXGENDPROC, (GLenum coord, GLenum pname, GLdouble param), (coord, pname, param)) \
+    X(TexGendv, PFNGLTEXGENDVPROC, (GLenum coord, GLenum pname, const GLdouble *params), (coord, pname, params)) \
+    X(TexGenf, PFNGLTEXGENFPROC, (GLenum coord, GLenum pname, GLfloat param), (coord, pname, param)) \
+    X(TexGenfv, PFNGLTEXGENFVPROC, (GLenum coord, GLenum pname, const GLfloat *params), (coord, pname, params)) \
+    X(TexGeni, PFNGLTEXGENIPROC, (GLenum coord, GLenum pname, GLint param), (coord, pname, param)) \
+    X(TexGeniv, PFNGLTEXGENIVPROC, (GLenum coord, GLenum pname, const GLint *params), (coord, pname, params)) \
+    X(TexImage1D, PFNGLTEXIMAGE1DPROC, (GLenum target, GLint level, GLint internalformat, GLsizei width, GLint border, GLenum format, GLenum type, const void *pixels), (target, level, internalformat, width, border, format, type, pixels)) \
+    X(TexImage2D, PFNGLTEXIMAGE2DPROC, (GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void *pixels), (target, level, internalformat, width, height, border, format, type, pixels)) \
+    X(TexImage2DMultisample, PFNGLTEXIMAGE2DMULTISAMPLEPROC, (GLenum target, GLsizei samples, GLenum internalformat, GLsizei width, GLsizei height, GLboolean fixedsamplelocations), (target, samples, internalformat, width, height, fixedsamplelocations)) \
+    X(TexImage3D, PFNGLTEXIMAGE3DPROC, (GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLsizei depth, GLint border, GLenum format, GLenum type, const void *pixels), (target, level, internalformat, width, height, depth, border, format, type, pixels)) \
+    X(TexImage3DMultisample, PFNGLTEXIMAGE3DMULTISAMPLEPROC, (GLenum target, GLsizei samples, GLenum internalformat, GLsizei width, GLsizei height, GLsizei depth, GLboolean fixedsamplelocations), (target, samples, internalformat, width, height, depth, fixedsamplelocations)) \
+    X(TexParameterIiv, PFNGLTEXPARAMETERIIVPROC, (GLenum target, GLenum pname, const GLint *params), (target, pname, params)) \
+    X(TexParameterIuiv, PFNGLTEXPARAMETERIUIVPROC, (GLenum target, GLenum pname, const GLuint *params), (target, pname, params)) \
+    X(TexParameterf, PFNGLTEXPARAMETERFPROC, (GLenum target, GLenum pname, GLfloat param), (target, pname, param)) \
+    X(TexParameterfv, PFNGLTEXPARAMETERFVPROC, (GLenum target, GLenum pname, const GLfloat *params), (target, pname, params)) \
+    X(TexParameteri, PFNGLTEXPARAMETERIPROC, (GLenum target, GLenum pname, GLint param), (target, pname, param)) \
+    X(TexParameteriv, PFNGLTEXPARAMETERIVPROC, (GLenum target, GLenum pname, const GLint *params), (target, pname, params)) \
+    X(TexStorage1D, PFNGLTEXSTORAGE1DPROC, (GLenum target, GLsizei levels, GLenum internalformat, GLsizei width), (target, levels, internalformat, width)) \
+    X(TexStorage2D, PFNGLTEXSTORAGE2DPROC, (GLenum target, GLsizei levels, GLenum internalformat, GLsizei width, GLsizei height), (target, levels, internalformat, width, height)) \
+    X(TexStorage2DMultisample, PFNGLTEXSTORAGE2DMULTISAMPLEPROC, (GLenum target, GLsizei samples, GLenum internalformat, GLsizei width, GLsizei height, GLboolean fixedsamplelocations), (target, samples, internalformat, width, height, fixedsamplelocations)) \
+    X(TexStorage3D, PFNGLTEXSTORAGE3DPROC, (GLenum target, GLsizei levels, GLenum internalformat, GLsizei width, GLsizei height, GLsizei depth), (target, levels, internalformat, width, height, depth)) \
+    X(TexStorage3DMultisample, PFNGLTEXSTORAGE3DMULTISAMPLEPROC, (GLenum target, GLsizei samples, GLenum internalformat, GLsizei width, GLsizei height, GLsizei depth, GLboolean fixedsamplelocations), (target, samples, internalformat, width, height, depth, fixedsamplelocations)) \
+    X(TexSubImage1D, PFNGLTEXSUBIMAGE1DPROC, (GLenum target, GLint level, GLint xoffset, GLsizei width, GLenum format, GLenum type, const void *pixels), (target, level, xoffset, width, format, type, pixels)) \
+    X(TexSubImage2D, PFNGLTEXSUBIMAGE2DPROC, (GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void *pixels), (target, level, xoffset, yoffset, width, height, format, type, pixels)) \
+    X(TexSubImage3D, PFNGLTEXSUBIMAGE3DPROC, (GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const void *pixels), (target, level, xoffset, yoffset, zoffset, width, height, depth, format, type, pixels)) \
+    X(TextureBarrier, PFNGLTEXTUREBARRIERPROC, (void), ()) \
+    X(TextureBuffer, PFNGLTEXTUREBUFFERPROC, (GLuint texture, GLenum internalformat, GLuint buffer), (texture, internalformat, buffer)) \
+    X(TextureBufferRange, PFNGLTEXTUREBUFFERRANGEPROC, (GLuint texture, GLenum internalformat, GLuint buffer, GLintptr offset, GLsizeiptr size), (texture, internalformat, buffer, offset, size)) \
+    X(TextureParameterIiv, PFNGLTEXTUREPARAMETERIIVPROC, (GLuint texture, GLenum pname, const GLint *params), (texture, pname, params)) \
+    X(TextureParameterIuiv, PFNGLTEXTUREPARAMETERIUIVPROC, (GLuint texture, GLenum pname, const GLuint *params), (texture, pname, params)) \
+    X(TextureParameterf, PFNGLTEXTUREPARAMETERFPROC, (GLuint texture, GLenum pname, GLfloat param), (texture, pname, param)) \
+    X(TextureParameterfv, PFNGLTEXTUREPARAMETERFVPROC, (GLuint texture, GLenum pname, const GLfloat *param), (texture, pname, param)) \
+    X(TextureParameteri, PFNGLTEXTUREPARAMETERIPROC, (GLuint texture, GLenum pname, GLint param), (texture, pname, param)) \
+    X(TextureParameteriv, PFNGLTEXTUREPARAMETERIVPROC, (GLuint texture, GLenum pname, const GLint *param), (texture, pname, param)) \
+    X(TextureStorage1D, PFNGLTEXTURESTORAGE1DPROC, (GLuint texture, GLsizei levels, GLenum internalformat, GLsizei width), (texture, levels, internalformat, width)) \
+    X(TextureStorage2D, PFNGLTEXTURESTORAGE2DPROC, (GLuint texture, GLsizei levels, GLenum internalformat, GLsizei width, GLsizei height), (texture, levels, internalformat, width, height)) \
+    X(TextureStorage2DMultisample, PFNGLTEXTURESTORAGE2DMULTISAMPLEPROC, (GLuint texture, GLsizei samples, GLenum internalformat, GLsizei width, GLsizei height, GLboolean fixedsamplelocations), (texture, samples, internalformat, width, height, fixedsamplelocations)) \
+    X(TextureStorage3D, PFNGLTEXTURESTORAGE3DPROC, (GLuint texture, GLsizei levels, GLenum internalformat, GLsizei width, GLsizei height, GLsizei depth), (texture, levels, internalformat, width, height, depth)) \
+    X(TextureStorage3DMultisample, PFNGLTEXTURESTORAGE3DMULTISAMPLEPROC, (GLuint texture, GLsizei samples, GLenum internalformat, GLsizei width, GLsizei height, GLsizei depth, GLboolean fixedsamplelocations), (texture, samples, internalformat, width, height, depth, fixedsamplelocations)) \
+    X(TextureSubImage1D, PFNGLTEXTURESUBIMAGE1DPROC, (GLuint texture, GLint level, GLint xoffset, GLsizei width, GLenum format, GLenum type, const void *pixels), (texture, level, xoffset, width, format, type, pixels)) \
+    X(TextureSubImage2D, PFNGLTEXTURESUBIMAGE2DPROC, (GLuint texture, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void *pixels), (texture, level, xoffset, yoffset, width, height, format, type, pixels)) \
+    X(TextureSubImage3D, PFNGLTEXTURESUBIMAGE3DPROC, (GLuint texture, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const void *pixels), (texture, level, xoffset, yoffset, zoffset, width, height, depth, format, type, pixels)) \
+    X(TextureView, PFNGLTEXTUREVIEWPROC, (GLuint texture, GLenum target, GLuint origtexture, GLenum internalformat, GLuint minlevel, GLuint numlevels, GLuint minlayer, GLuint numlayers), (texture, target, origtexture, internalformat, minlevel, numlevels, minlayer, numlayers)) \
+    X(TransformFeedbackBufferBase, PFNGLTRANSFORMFEEDBACKBUFFERBASEPROC, (GLuint xfb, GLuint index, GLuint buffer), (xfb, index, buffer)) \
+    X(TransformFeedbackBufferRange, PFNGLTRANSFORMFEEDBACKBUFFERRANGEPROC, (GLuint xfb, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size), (xfb, index, buffer, offset, size)) \
+    X(TransformFeedbackVaryings, PFNGLTRANSFORMFEEDBACKVARYINGSPROC, (GLuint program, GLsizei count, const GLchar *const *varyings, GLenum bufferMode), (program, count, varyings, bufferMode)) \
+    X(Translated, PFNGLTRANSLATEDPROC, (GLdouble x, GLdouble y, GLdouble z), (x, y, z)) \
+    X(Translatef, PFNGLTRANSLATEFPROC, (GLfloat x, GLfloat y, GLfloat z), (x, y, z)) \
+    X(Uniform1d, PFNGLUNIFORM1DPROC, (GLint location, GLdouble x), (location, x)) \
+    X(Uniform1dv, PFNGLUNIFORM1DVPROC, (GLint location, GLsizei count, const GLdouble *value), (location, count, value)) \
+    X(Uniform1f, PFNGLUNIFORM1FPROC, (GLint location, GLfloat v0), (location, v0)) \
+    X(Uniform1fv, PFNGLUNIFORM1FVPROC, (GLint location, GLsizei count, const GLfloat *value), (location, count, value)) \
+    X(Uniform1i, PFNGLUNIFORM1IPROC, (GLint location, GLint v0), (location, v0)) \
+    X(Uniform1iv, PFNGLUNIFORM1IVPROC, (GLint location, GLsizei count, const GLint *value), (location, count, value)) \
+    X(Uniform1ui, PFNGLUNIFORM1UIPROC, (GLint location, GLuint v0), (location, v0)) \
+    X(Uniform1uiv, PFNGLUNIFORM1UIVPROC, (GLint location, GLsizei count, const GLuint *value), (location, count, value)) \
+    X(Uniform2d, PFNGLUNIFORM2DPROC, (GLint location, GLdouble x, GLdouble y), (location, x, y)) \
+    X(Uniform2dv, PFNGLUNIFORM2DVPROC, (GLint location, GLsizei count, const GLdouble *value), (location, count, value)) \
+    X(Uniform2f, PFNGLUNIFORM2FPROC, (GLint location, GLfloat v0, GLfloat v1), (location, v0, v1)) \
+    X(Uniform2fv, PFNGLUNIFORM2FVPROC, (GLint location, GLsizei count, const GLfloat *value), (location, count, value)) \
+    X(Uniform2i, PFNGLUNIFORM2IPROC, (GLint location, GLint v0, GLint v1), (location, v0, v1)) \
+    X(Uniform2iv, PFNGLUNIFORM2IVPROC, (GLint location, GLsizei count, const GLint *value), (location, count, value)) \
+    X(Uniform2ui, PFNGLUNIFORM2UIPROC, (GLint location, GLuint v0, GLuint v1), (location, v0, v1)) \
+    X(Uniform2uiv, PFNGLUNIFORM2UIVPROC, (GLint location, GLsizei count, const GLuint *value), (location, count, value)) \
+    X(Uniform3d, PFNGLUNIFORM3DPROC, (GLint location, GLdouble x, GLdouble y, GLdouble z), (location, x, y, z)) \
+    X(Uniform3dv, PFNGLUNIFORM3DVPROC, (GLint location, GLsizei count, const GLdouble *value), (location, count, value)) \
+    X(Uniform3f, PFNGLUNIFORM3FPROC, (GLint location, GLfloat v0, GLfloat v1, GLfloat v2), (location, v0, v1, v2)) \
+    X(Uniform3fv, PFNGLUNIFORM3FVPROC, (GLint location, GLsizei count, const GLfloat *value), (location, count, value)) \
+    X(Uniform3i, PFNGLUNIFORM3IPROC, (GLint location, GLint v0, GLint v1, GLint v2), (location, v0, v1, v2)) \
+    X(Uniform3iv, PFNGLUNIFORM3IVPROC, (GLint location, GLsizei count, const GLint *value), (location, count, value)) \
+    X(Uniform3ui, PFNGLUNIFORM3UIPROC, (GLint location, GLuint v0, GLuint v1, GLuint v2), (location, v0, v1, v2)) \
+    X(Uniform3uiv, PFNGLUNIFORM3UIVPROC, (GLint location, GLsizei count, const GLuint *value), (location, count, value)) \
+    X(Uniform4d, PFNGLUNIFORM4DPROC, (GLint location, GLdouble x, GLdouble y, GLdouble z, GLdouble w), (location, x, y, z, w)) \
+    X(Uniform4dv, PFNGLUNIFORM4DVPROC, (GLint location, GLsizei count, const GLdouble *value), (location, count, value)) \
+    X(Uniform4f, PFNGLUNIFORM4FPROC, (GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3), (location, v0, v1, v2, v3)) \
+    X(Uniform4fv, PFNGLUNIFORM4FVPROC, (GLint location, GLsizei count, const GLfloat *value), (location, count, value)) \
+    X(Uniform4i, PFNGLUNIFORM4IPROC, (GLint location, GLint v0, GLint v1, GLint v2, GLint v3), (location, v0, v1, v2, v3)) \
+    X(Uniform4iv, PFNGLUNIFORM4IVPROC, (GLint location, GLsizei count, const GLint *value), (location, count, value)) \
+    X(Uniform4ui, PFNGLUNIFORM4UIPROC, (GLint location, GLuint v0, GLuint v1, GLuint v2, GLuint v3), (location, v0, v1, v2, v3)) \
+    X(Uniform4uiv, PFNGLUNIFORM4UIVPROC, (GLint location, GLsizei count, const GLuint *value), (location, count, value)) \
+    X(UniformBlockBinding, PFNGLUNIFORMBLOCKBINDINGPROC, (GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding), (program, uniformBlockIndex, uniformBlockBinding)) \
+    X(UniformMatrix2dv, PFNGLUNIFORMMATRIX2DVPROC, (GLint location, GLsizei count, GLboolean transpose, const GLdouble *value), (location, count, transpose, value)) \
+    X(UniformMatrix2fv, PFNGLUNIFORMMATRIX2FVPROC, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value)) \
+    X(UniformMatrix2x3dv, PFNGLUNIFORMMATRIX2X3DVPROC, (GLint location, GLsizei count, GLboolean transpose, const GLdouble *value), (location, count, transpose, value)) \
+    X(UniformMatrix2x3fv, PFNGLUNIFORMMATRIX2X3FVPROC, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value)) \
+    X(UniformMatrix2x4dv, PFNGLUNIFORMMATRIX2X4DVPROC, (GLint location, GLsizei count, GLboolean transpose, const GLdouble *value), (location, count, transpose, value)) \
+    X(UniformMatrix2x4fv, PFNGLUNIFORMMATRIX2X4FVPROC, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value)) \
+    X(UniformMatrix3dv, PFNGLUNIFORMMATRIX3DVPROC, (GLint location, GLsizei count, GLboolean transpose, const GLdouble *value), (location, count, transpose, value)) \
+    X(UniformMatrix3fv, PFNGLUNIFORMMATRIX3FVPROC, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value)) \
+    X(UniformMatrix3x2dv, PFNGLUNIFORMMATRIX3X2DVPROC, (GLint location, GLsizei count, GLboolean transpose, const GLdouble *value), (location, count, transpose, value)) \
+    X(UniformMatrix3x2fv, PFNGLUNIFORMMATRIX3X2FVPROC, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value)) \
+    X(UniformMatrix3x4dv, PFNGLUNIFORMMATRIX3X4DVPROC, (GLint location, GLsizei count, GLboolean transpose, const GLdouble *value), (location, count, transpose, value)) \
+    X(UniformMatrix3x4fv, PFNGLUNIFORMMATRIX3X4FVPROC, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value)) \
+    X(UniformMatrix4dv, PFNGLUNIFORMMATRIX4DVPROC, (GLint location, GLsizei count, GLboolean transpose, const GLdouble *value), (location, count, transpose, value)) \
+    X(UniformMatrix4fv, PFNGLUNIFORMMATRIX4FVPROC, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value)) \
+    X(UniformMatrix4x2dv, PFNGLUNIFORMMATRIX4X2DVPROC, (GLint location, GLsizei count, GLboolean transpose, const GLdouble *value), (location, count, transpose, value)) \
+    X(UniformMatrix4x2fv, PFNGLUNIFORMMATRIX4X2FVPROC, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value)) \
+    X(UniformMatrix4x3dv, PFNGLUNIFORMMATRIX4X3DVPROC, (GLint location, GLsizei count, GLboolean transpose, const GLdouble *value), (location, count, transpose, value)) \
+    X(UniformMatrix4x3fv, PFNGLUNIFORMMATRIX4X3FVPROC, (GLint location, GLsizei count, GLboolean transpose, const GLfloat *value), (location, count, transpose, value)) \
+    X(UniformSubroutinesuiv, PFNGLUNIFORMSUBROUTINESUIVPROC, (GLenum shadertype, GLsizei count, const GLuint *indices), (shadertype, count, indices)) \
+    XR(GLboolean, UnmapBuffer, PFNGLUNMAPBUFFERPROC, (GLenum target), (target)) \
+    XR(GLboolean, UnmapNamedBuffer, PFNGLUNMAPNAMEDBUFFERPROC, (GLuint buffer), (buffer)) \
+    X(UseProgram, PFNGLUSEPROGRAMPROC, (GLuint program), (program)) \
+    X(UseProgramStages, PFNGLUSEPROGRAMSTAGESPROC, (GLuint pipeline, GLbitfield stages, GLuint program), (pipeline, stages, program)) \
+    X(ValidateProgram, PFNGLVALIDATEPROGRAMPROC, (GLuint program), (program)) \
+    X(ValidateProgramPipeline, PFNGLVALIDATEPROGRAMPIPELINEPROC, (GLuint pipeline), (pipeline)) \
+    X(Vertex2d, PFNGLVERTEX2DPROC, (GLdouble x, GLdouble y), (x, y)) \
+    X(Vertex2dv, PFNGLVERTEX2DVPROC, (const GLdouble *v), (v)) \
+    X(Vertex2f, PFNGLVERTEX2FPROC, (GLfloat x, GLfloat y), (x, y)) \
+    X(Vertex2fv, PFNGLVERTEX2FVPROC, (const GLfloat *v), (v)) \
+    X(Vertex2i, PFNGLVERTEX2IPROC, (GLint x, GLint y), (x, y)) \
+    X(Vertex2iv, PFNGLVERTEX2IVPROC, (const GLint *v), (v)) \
+    X(Vertex2s, PFNGLVERTEX2SPROC, (GLshort x, GLshort y), (x, y)) \
+    X(Vertex2sv, PFNGLVERTEX2SVPROC, (const GLshort *v), (v)) \
+    X(Vertex3d, PFNGLVERTEX3DPROC, (GLdouble x, GLdouble y, GLdouble z), (x, y, z)) \
+    X(Vertex3dv, PFNGLVERTEX3DVPROC, (const GLdouble *v), (v)) \
+    X(Vertex3f, PFNGLVERTEX3FPROC, (GLfloat x, GLfloat y, GLfloat z), (x, y, z)) \
+    X(Vertex3fv, PFNGLVERTEX3FVPROC, (const GLfloat *v), (v)) \
+    X(Vertex3i, PFNGLVERTEX3IPROC, (GLint x, GLint y, GLint z), (x, y, z)) \
+    X(Vertex3iv, PFNGLVERTEX3IVPROC, (const GLint *v), (v)) \
+    X(Vertex3s, PFNGLVERTEX3SPROC, (GLshort x, GLshort y, GLshort z), (x, y, z)) \
+    X(Vertex3sv, PFNGLVERTEX3SVPROC, (const GLshort *v), (v)) \
+    X(Vertex4d, PFNGLVERTEX4DPROC, (GLdouble x, GLdouble y, GLdouble z, GLdouble w), (x, y, z, w)) \
+    X(Vertex4dv, PFNGLVERTEX4DVPROC, (const GLdouble *v), (v)) \
+    X(Vertex4f, PFNGLVERTEX4FPROC, (GLfloat x, GLfloat y, GLfloat z, GLfloat w), (x, y, z, w)) \
+    X(Vertex4fv, PFNGLVERTEX4FVPROC, (const GLfloat *v), (v)) \
+    X(Vertex4i, PFNGLVERTEX4IPROC, (GLint x, GLint y, GLint z, GLint w), (x, y, z, w)) \
+    X(Vertex4iv, PFNGLVERTEX4IVPROC, (const GLint *v), (v)) \
+    X(Vertex4s, PFNGLVERTEX4SPROC, (GLshort x, GLshort y, GLshort z, GLshort w), (x, y, z, w)) \
+    X(Vertex4sv, PFNGLVERTEX4SVPROC, (const GLshort *v), (v)) \
+    X(VertexArrayAttribBinding, PFNGLVERTEXARRAYATTRIBBINDINGPROC, (GLuint vaobj, GLuint attribindex, GLuint bindingindex), (vaobj, attribindex, bindingindex)) \
+    X(VertexArrayAttribFormat, PFNGLVERTEXARRAYATTRIBFORMATPROC, (GLuint vaobj, GLuint attribindex, GLint size, GLenum type, GLboolean normalized, GLuint relativeoffset), (vaobj, attribindex, size, type, normalized, relativeoffset)) \
+    X(VertexArrayAttribIFormat, PFNGLVERTEXARRAYATTRIBIFORMATPROC, (GLuint vaobj, GLuint attribindex, GLint size, GLenum type, GLuint relativeoffset), (vaobj, attribindex, size, type, relativeoffset)) \
+    X(VertexArrayAttribLFormat, PFNGLVERTEXARRAYATTRIBLFORMATPROC, (GLuint vaobj, GLuint attribindex, GLint size, GLenum type, GLuint relativeoffset), (vaobj, attribindex, size, type, relativeoffset)) \
+    X(VertexArrayBindingDivisor, PFNGLVERTEXARRAYBINDINGDIVISORPROC, (GLuint vaobj, GLuint bindingindex, GLuint divisor), (vaobj, bindingindex, divisor)) \
+    X(VertexArrayElementBuffer, PFNGLVERTEXARRAYELEMENTBUFFERPROC, (GLuint vaobj, GLuint buffer), (vaobj, buffer)) \
+    X(VertexArrayVertexBuffer, PFNGLVERTEXARRAYVERTEXBUFFERPROC, (GLuint vaobj, GLuint bindingindex, GLuint buffer, GLintptr offset, GLsizei stride), (vaobj, bindingindex, buffer, offset, stride)) \
+    X(VertexArrayVertexBuffers, PFNGLVERTEXARRAYVERTEXBUFFERSPROC, (GLuint vaobj, GLuint first, GLsizei count, const GLuint *buffers, const GLintptr *offsets, const GLsizei *strides), (vaobj, first, count, buffers, offsets, strides)) \
+    X(VertexAttrib1d, PFNGLVERTEXATTRIB1DPROC, (GLuint index, GLdouble x), (index, x)) \
+    X(VertexAttrib1dv, PFNGLVERTEXATTRIB1DVPROC, (GLuint index, const GLdouble *v), (index, v)) \
+    X(VertexAttrib1f, PFNGLVERTEXATTRIB1FPROC, (GLuint index, GLfloat x), (index, x)) \
+    X(VertexAttrib1fv, PFNGLVERTEXATTRIB1FVPROC, (GLuint index, const GLfloat *v), (index, v)) \
+    X(VertexAttrib1s, PFNGLVERTEXATTRIB1SPROC, (GLuint index, GLshort x), (index, x)) \
+    X(VertexAttrib1sv, PFNGLVERTEXATTRIB1SVPROC, (GLuint index, const GLshort *v), (index, v)) \
+    X(VertexAttrib2d, PFNGLVERTEXATTRIB2DPROC, (GLuint index, GLdouble x, GLdouble y), (index, x, y)) \
+    X(VertexAttrib2dv, PFNGLVERTEXATTRIB2DVPROC, (GLuint index, const GLdouble *v), (index, v)) \
+    X(VertexAttrib2f, PFNGLVERTEXATTRIB2FPROC, (GLuint index, GLfloat x, GLfloat y), (index, x, y)) \
+    X(VertexAttrib2fv, PFNGLVERTEXATTRIB2FVPROC, (GLuint index, const GLfloat *v), (index, v)) \
+    X(VertexAttrib2s, PFNGLVERTEXATTRIB2SPROC, (GLuint index, GLshort x, GLshort y), (index, x, y)) \
+    X(VertexAttrib2sv, PFNGLVERTEXATTRIB2SVPROC, (GLuint index, const GLshort *v), (index, v)) \
+    X(VertexAttrib3d, PFNGLVERTEXATTRIB3DPROC, (GLuint index, GLdouble x, GLdouble y, GLdouble z), (index, x, y, z)) \
+    X(VertexAttrib3dv, PFNGLVERTEXATTRIB3DVPROC, (GLuint index, const GLdouble *v), (index, v)) \
+    X(VertexAttrib3f, PFNGLVERTEXATTRIB3FPROC, (GLuint index, GLfloat x, GLfloat y, GLfloat z), (index, x, y, z)) \
+    X(VertexAttrib3fv, PFNGLVERTEXATTRIB3FVPROC, (GLuint index, const GLfloat *v), (index, v)) \
+    X(VertexAttrib3s, PFNGLVERTEXATTRIB3SPROC, (GLuint index, GLshort x, GLshort y, GLshort z), (index, x, y, z)) \
+    X(VertexAttrib3sv, PFNGLVERTEXATTRIB3SVPROC, (GLuint index, const GLshort *v), (index, v)) \
+    X(VertexAttrib4Nbv, PFNGLVERTEXATTRIB4NBVPROC, (GLuint index, const GLbyte *v), (index, v)) \
+    X(VertexAttrib4Niv, PFNGLVERTEXATTRIB4NIVPROC, (GLuint index, const GLint *v), (index, v)) \
+    X(VertexAttrib4Nsv, PFNGLVERTEXATTRIB4NSVPROC, (GLuint index, const GLshort *v), (index, v)) \
+    X(VertexAttrib4Nub, PFNGLVERTEXATTRIB4NUBPROC, (GLuint index, GLubyte x, GLubyte y, GLubyte z, GLubyte w), (index, x, y, z, w)) \
+    X(VertexAttrib4Nubv, PFNGLVERTEXATTRIB4NUBVPROC, (GLuint index, const GLubyte *v), (index, v)) \
+    X(VertexAttrib4Nuiv, PFNGLVERTEXATTRIB4NUIVPROC, (GLuint index, const GLuint *v), (index, v)) \
+    X(VertexAttrib4Nusv, PFNGLVERTEXATTRIB4NUSVPROC, (GLuint index, const GLushort *v), (index, v)) \
+    X(VertexAttrib4bv, PFNGLVERTEXATTRIB4BVPROC, (GLuint index, const GLbyte *v), (index, v)) \
+    X(VertexAttrib4d, PFNGLVERTEXATTRIB4DPROC, (GLuint index, GLdouble x, GLdouble y, GLdouble z, GLdouble w), (index, x, y, z, w)) \
+    X(VertexAttrib4dv, PFNGLVERTEXATTRIB4DVPROC, (GLuint index, const GLdouble *v), (index, v)) \
+    X(VertexAttrib4f, PFNGLVERTEXATTRIB4FPROC, (GLuint index, GLfloat x, GLfloat y, GLfloat z, GLfloat w), (index, x, y, z, w)) \
+    X(VertexAttrib4fv, PFNGLVERTEXATTRIB4FVPROC, (GLuint index, const GLfloat *v), (index, v)) \
+    X(VertexAttrib4iv, PFNGLVERTEXATTRIB4IVPROC, (GLuint index, const GLint *v), (index, v)) \
+    X(VertexAttrib4s, PFNGLVERTEXATTRIB4SPROC, (GLuint index, GLshort x, GLshort y, GLshort z, GLshort w), (index, x, y, z, w)) \
+    X(VertexAttrib4sv, PFNGLVERTEXATTRIB4SVPROC, (GLuint index, const GLshort *v), (index, v)) \
+    X(VertexAttrib4ubv, PFNGLVERTEXATTRIB4UBVPROC, (GLuint index, const GLubyte *v), (index, v)) \
+    X(VertexAttrib4uiv, PFNGLVERTEXATTRIB4UIVPROC, (GLuint index, const GLuint *v), (index, v)) \
+    X(VertexAttrib4usv, PFNGLVERTEXATTRIB4USVPROC, (GLuint index, const GLushort *v), (index, v)) \
+    X(VertexAttribBinding, PFNGLVERTEXATTRIBBINDINGPROC, (GLuint attribindex, GLuint bindingindex), (attribindex, bindingindex)) \
+    X(VertexAttribDivisor, PFNGLVERTEXATTRIBDIVISORPROC, (GLuint index, GLuint divisor), (index, divisor)) \
+    X(VertexAttribFormat, PFNGLVERTEXATTRIBFORMATPROC, (GLuint attribindex, GLint size, GLenum type, GLboolean normalized, GLuint relativeoffset), (attribindex, size, type, normalized, relativeoffset)) \
+    X(VertexAttribI1i, PFNGLVERTEXATTRIBI1IPROC, (GLuint index, GLint x), (index, x)) \
+    X(VertexAttribI1iv, PFNGLVERTEXATTRIBI1IVPROC, (GLuint index, const GLint *v), (index, v)) \
+    X(VertexAttribI1ui, PFNGLVERTEXATTRIBI1UIPROC, (GLuint index, GLuint x), (index, x)) \
+    X(VertexAttribI1uiv, PFNGLVERTEXATTRIBI1UIVPROC, (GLuint index, const GLuint *v), (index, v)) \
+    X(VertexAttribI2i, PFNGLVERTEXATTRIBI2IPROC, (GLuint index, GLint x, GLint y), (index, x, y)) \
+    X(VertexAttribI2iv, PFNGLVERTEXATTRIBI2IVPROC, (GLuint index, const GLint *v), (index, v)) \
+    X(VertexAttribI2ui, PFNGLVERTEXATTRIBI2UIPROC, (GLuint index, GLuint x, GLuint y), (index, x, y)) \
+    X(VertexAttribI2uiv, PFNGLVERTEXATTRIBI2UIVPROC, (GLuint index, const GLuint *v), (index, v)) \
+    X(VertexAttribI3i, PFNGLVERTEXATTRIBI3IPROC, (GLuint index, GLint x, GLint y, GLint z), (index, x, y, z)) \
+    X(VertexAttribI3iv, PFNGLVERTEXATTRIBI3IVPROC, (GLuint index, const GLint *v), (index, v)) \
+    X(VertexAttribI3ui, PFNGLVERTEXATTRIBI3UIPROC, (GLuint index, GLuint x, GLuint y, GLuint z), (index, x, y, z)) \
+    X(VertexAttribI3uiv, PFNGLVERTEXATTRIBI3UIVPROC, (GLuint index, const GLuint *v), (index, v)) \
+    X(VertexAttribI4bv, PFNGLVERTEXATTRIBI4BVPROC, (GLuint index, const GLbyte *v), (index, v)) \
+    X(VertexAttribI4i, PFNGLVERTEXATTRIBI4IPROC, (GLuint index, GLint x, GLint y, GLint z, GLint w), (index, x, y, z, w)) \
+    X(VertexAttribI4iv, PFNGLVERTEXATTRIBI4IVPROC, (GLuint index, const GLint *v), (index, v)) \
+    X(VertexAttribI4sv, PFNGLVERTEXATTRIBI4SVPROC, (GLuint index, const GLshort *v), (index, v)) \
+    X(VertexAttribI4ubv, PFNGLVERTEXATTRIBI4UBVPROC, (GLuint index, const GLubyte *v), (index, v)) \
+    X(VertexAttribI4ui, PFNGLVERTEXATTRIBI4UIPROC, (GLuint index, GLuint x, GLuint y, GLuint z, GLuint w), (index, x, y, z, w)) \
+    X(VertexAttribI4uiv, PFNGLVERTEXATTRIBI4UIVPROC, (GLuint index, const GLuint *v), (index, v)) \
+    X(VertexAttribI4usv, PFNGLVERTEXATTRIBI4USVPROC, (GLuint index, const GLushort *v), (index, v)) \
+    X(VertexAttribIFormat, PFNGLVERTEXATTRIBIFORMATPROC, (GLuint attribindex, GLint size, GLenum type, GLuint relativeoffset), (attribindex, size, type, relativeoffset)) \
+    X(VertexAttribIPointer, PFNGLVERTEXATTRIBIPOINTERPROC, (GLuint index, GLint size, GLenum type, GLsizei stride, const void *pointer), (index, size, type, stride, pointer)) \
+    X(VertexAttribL1d, PFNGLVERTEXATTRIBL1DPROC, (GLuint index, GLdouble x), (index, x)) \
+    X(VertexAttribL1dv, PFNGLVERTEXATTRIBL1DVPROC, (GLuint index, const GLdouble *v), (index, v)) \
+    X(VertexAttribL2d, PFNGLVERTEXATTRIBL2DPROC, (GLuint index, GLdouble x, GLdouble y), (index, x, y)) \
+    X(VertexAttribL2dv, PFNGLVERTEXATTRIBL2DVPROC, (GLuint index, const GLdouble *v), (index, v)) \
+    X(VertexAttribL3d, PFNGLVERTEXATTRIBL3DPROC, (GLuint index, GLdouble x, GLdouble y, GLdouble z), (index, x, y, z)) \
+    X(VertexAttribL3dv, PFNGLVERTEXATTRIBL3DVPROC, (GLuint index, const GLdouble *v), (index, v)) \
+    X(VertexAttribL4d, PFNGLVERTEXATTRIBL4DPROC, (GLuint index, GLdouble x, GLdouble y, GLdouble z, GLdouble w), (index, x, y, z, w)) \
+    X(VertexAttribL4dv, PFNGLVERTEXATTRIBL4DVPROC, (GLuint index, const GLdouble *v), (index, v)) \
+    X(VertexAttribLFormat, PFNGLVERTEXATTRIBLFORMATPROC, (GLuint attribindex, GLint size, GLenum type, GLuint relativeoffset), (attribindex, size, type, relativeoffset)) \
+    X(VertexAttribLPointer, PFNGLVERTEXATTRIBLPOINTERPROC, (GLuint index, GLint size, GLenum type, GLsizei stride, const void *pointer), (index, size, type, stride, pointer)) \
+    X(VertexAttribP1ui, PFNGLVERTEXATTRIBP1UIPROC, (GLuint index, GLenum type, GLboolean normalized, GLuint value), (index, type, normalized, value)) \
+    X(VertexAttribP1uiv, PFNGLVERTEXATTRIBP1UIVPROC, (GLuint index, GLenum type, GLboolean normalized, const GLuint *value), (index, type, normalized, value)) \
+    X(VertexAttribP2ui, PFNGLVERTEXATTRIBP2UIPROC, (GLuint index, GLenum type, GLboolean normalized, GLuint value), (index, type, normalized, value)) \
+    X(VertexAttribP2uiv, PFNGLVERTEXATTRIBP2UIVPROC, (GLuint index, GLenum type, GLboolean normalized, const GLuint *value), (index, type, normalized, value)) \
+    X(VertexAttribP3ui, PFNGLVERTEXATTRIBP3UIPROC, (GLuint index, GLenum type, GLboolean normalized, GLuint value), (index, type, normalized, value)) \
+    X(VertexAttribP3uiv, PFNGLVERTEXATTRIBP3UIVPROC, (GLuint index, GLenum type, GLboolean normalized, const GLuint *value), (index, type, normalized, value)) \
+    X(VertexAttribP4ui, PFNGLVERTEXATTRIBP4UIPROC, (GLuint index, GLenum type, GLboolean normalized, GLuint value), (index, type, normalized, value)) \
+    X(VertexAttribP4uiv, PFNGLVERTEXATTRIBP4UIVPROC, (GLuint index, GLenum type, GLboolean normalized, const GLuint *value), (index, type, normalized, value)) \
+    X(VertexAttribPointer, PFNGLVERTEXATTRIBPOINTERPROC, (GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void *pointer), (index, size, type, normalized, stride, pointer)) \
+    X(VertexBindingDivisor, PFNGLVERTEXBINDINGDIVISORPROC, (GLuint bindingindex, GLuint divisor), (bindingindex, divisor)) \
+    X(VertexP2ui, PFNGLVERTEXP2UIPROC, (GLenum type, GLuint value), (type, value)) \
+    X(VertexP2uiv, PFNGLVERTEXP2UIVPROC, (GLenum type, const GLuint *value), (type, value)) \
+    X(VertexP3ui, PFNGLVERTEXP3UIPROC, (GLenum type, GLuint value), (type, value)) \
+    X(VertexP3uiv, PFNGLVERTEXP3UIVPROC, (GLenum type, const GLuint *value), (type, value)) \
+    X(VertexP4ui, PFNGLVERTEXP4UIPROC, (GLenum type, GLuint value), (type, value)) \
+    X(VertexP4uiv, PFNGLVERTEXP4UIVPROC, (GLenum type, const GLuint *value), (type, value)) \
+    X(VertexPointer, PFNGLVERTEXPOINTERPROC, (GLint size, GLenum type, GLsizei stride, const void *pointer), (size, type, stride, pointer)) \
+    X(Viewport, PFNGLVIEWPORTPROC, (GLint x, GLint y, GLsizei width, GLsizei height), (x, y, width, height)) \
+    X(ViewportArrayv, PFNGLVIEWPORTARRAYVPROC, (GLuint first, GLsizei count, const GLfloat *v), (first, count, v)) \
+    X(ViewportIndexedf, PFNGLVIEWPORTINDEXEDFPROC, (GLuint index, GLfloat x, GLfloat y, GLfloat w, GLfloat h), (index, x, y, w, h)) \
+    X(ViewportIndexedfv, PFNGLVIEWPORTINDEXEDFVPROC, (GLuint index, const GLfloat *v), (index, v)) \
+    X(WaitSync, PFNGLWAITSYNCPROC, (GLsync sync, GLbitfield flags, GLuint64 timeout), (sync, flags, timeout)) \
+    X(WindowPos2d, PFNGLWINDOWPOS2DPROC, (GLdouble x, GLdouble y), (x, y)) \
+    X(WindowPos2dv, PFNGLWINDOWPOS2DVPROC, (const GLdouble *v), (v)) \
+    X(WindowPos2f, PFNGLWINDOWPOS2FPROC, (GLfloat x, GLfloat y), (x, y)) \
+    X(WindowPos2fv, PFNGLWINDOWPOS2FVPROC, (const GLfloat *v), (v)) \
+    X(WindowPos2i, PFNGLWINDOWPOS2IPROC, (GLint x, GLint y), (x, y)) \
+    X(WindowPos2iv, PFNGLWINDOWPOS2IVPROC, (const GLint *v), (v)) \
+    X(WindowPos2s, PFNGLWINDOWPOS2SPROC, (GLshort x, GLshort y), (x, y)) \
+    X(WindowPos2sv, PFNGLWINDOWPOS2SVPROC, (const GLshort *v), (v)) \
+    X(WindowPos3d, PFNGLWINDOWPOS3DPROC, (GLdouble x, GLdouble y, GLdouble z), (x, y, z)) \
+    X(WindowPos3dv, PFNGLWINDOWPOS3DVPROC, (const GLdouble *v), (v)) \
+    X(WindowPos3f, PFNGLWINDOWPOS3FPROC, (GLfloat x, GLfloat y, GLfloat z), (x, y, z)) \
+    X(WindowPos3fv, PFNGLWINDOWPOS3FVPROC, (const GLfloat *v), (v)) \
+    X(WindowPos3i, PFNGLWINDOWPOS3IPROC, (GLint x, GLint y, GLint z), (x, y, z)) \
+    X(WindowPos3iv, PFNGLWINDOWPOS3IVPROC, (const GLint *v), (v)) \
+    X(WindowPos3s, PFNGLWINDOWPOS3SPROC, (GLshort x, GLshort y, GLshort z), (x, y, z)) \
+    X(WindowPos3sv, PFNGLWINDOWPOS3SVPROC, (const GLshort *v), (v))
+
+static GladGLContext *glad_gl_lazy_context = NULL;
+static GLADuserptrloadfunc glad_gl_lazy_load = NULL;
+static void *glad_gl_lazy_userptr = NULL;
+
+#define GLAD_GL_LAZY_DEFINE(name, type, params, args) \
+    static void GLAD_API_PTR glad_gl_lazy_##name params { \
+        glad_gl_lazy_context->name = (type) glad_gl_lazy_load(glad_gl_lazy_userptr, "gl" #name); \
+        glad_gl_lazy_context->name args; \
+    }
+#define GLAD_GL_LAZY_DEFINE_RET(ret, name, type, params, args) \
+    static ret GLAD_API_PTR glad_gl_lazy_##name params { \
+        glad_gl_lazy_context->name = (type) glad_gl_lazy_load(glad_gl_lazy_userptr, "gl" #name); \
+        return glad_gl_lazy_context->name args; \
+    }
+
+GLAD_GL_LAZY_PROCS(GLAD_GL_LAZY_DEFINE, GLAD_GL_LAZY_DEFINE_RET)
+
+#define GLAD_GL_LAZY_INSTALL(name, type, params, args) \
+    context->name = glad_gl_lazy_##name;
+#define GLAD_GL_LAZY_INSTALL_RET(ret, name, type, params, args) \
+    context->name = glad_gl_lazy_##name;
+
+int gladLoadGLContextLazyUserPtr(GladGLContext *context, GLADuserptrloadfunc load, void *userptr) {
+    int version;
+
+    /* The version is detected eagerly, it sets the VERSION_X_Y flags */
+    context->GetString = (PFNGLGETSTRINGPROC) load(userptr, "glGetString");
+    if(context->GetString == NULL) return 0;
+    if(context->GetString(GL_VERSION) == NULL) return 0;
+    version = glad_gl_find_core_gl(context);
+
+    glad_gl_lazy_context = context;
+    glad_gl_lazy_load = load;
+    glad_gl_lazy_userptr = userptr;
+
+    {
+        PFNGLGETSTRINGPROC get_string = context->GetString;
+        GLAD_GL_LAZY_PROCS(GLAD_GL_LAZY_INSTALL, GLAD_GL_LAZY_INSTALL_RET)
+        context->GetString = get_string;
+    }
+
+    return version;
+}
+
+int gladLoadGLContextLazy(GladGLContext *context, GLADloadfunc load) {
+    return gladLoadGLContextLazyUserPtr(context, glad_gl_get_proc_from_userptr, GLAD_GNUC_EXTENSION (void*) load);
+}
+
 
 
  
@@ -1500,6 +2610,20 @@ int gladLoaderLoadGLContext(GladGLContext *context) {
 
 
 
+static struct _glad_gl_userptr glad_gl_lazy_loader_userptr;
+
+int gladLoaderLoadGLContextLazy(GladGLContext *context) {
+    void *handle;
+
+    /* The library stays open for the trampolines, until gladLoaderUnloadGL */
+    handle = glad_gl_dlopen_handle();
+    if (handle == NULL) return 0;
+
+    glad_gl_lazy_loader_userptr = glad_gl_build_userptr(handle);
+
+    return gladLoadGLContextLazyUserPtr(context, glad_gl_get_proc, &glad_gl_lazy_loader_userptr);
+}
+
 void gladLoaderUnloadGL(void) {
     if (_gl_handle != NULL) {
         glad_close_dlopen_handle(_gl_handle);
@@ -75,6 +75,9 @@ PYBIND11_MODULE(_core, m) {
                   })
       .def("place_finger", &inputtino::Trackpad::place_finger)
       .def("release_finger", &inputtino::Trackpad::release_finger)
+      .def("begin_frame", &inputtino::Trackpad::begin_frame)
+      .def("update_finger", &inputtino::Trackpad::update_finger)
+      .def("commit", &inputtino::Trackpad::commit)
       .def("set_left_btn", &inputtino::Trackpad::set_left_btn);
 
   // Joypad Enums
@@ -185,7 +188,10 @@ PYBIND11_MODULE(_core, m) {
                     return std::move(*result);
                   })
       .def("place_finger", &inputtino::TouchScreen::place_finger)
-      .def("release_finger", &inputtino::TouchScreen::release_finger);
+      .def("release_finger", &inputtino::TouchScreen::release_finger)
+      .def("begin_frame", &inputtino::TouchScreen::begin_frame)
+      .def("update_finger", &inputtino::TouchScreen::update_finger)
+      .def("commit", &inputtino::TouchScreen::commit);
 
   // PenTablet tool and button enums
   py::enum_<inputtino::PenTablet::TOOL_TYPE>(m, "PenToolType")
@@ -10,6 +10,7 @@
 #  include <inputtino/export_static.h>
 #endif
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -63,8 +64,57 @@ LIBINPUTTINO_EXPORT void inputtino_mouse_scroll_vertical(InputtinoMouse *mouse,
 
 LIBINPUTTINO_EXPORT void inputtino_mouse_scroll_horizontal(InputtinoMouse *mouse, int high_res_distance);
 
+/*
+ * A tagged mouse operation, used to submit several of them at once with inputtino_mouse_submit_batch()
+ */
+enum INPUTTINO_MOUSE_OP_TYPE {
+  INPUTTINO_MOUSE_OP_MOVE,
+  INPUTTINO_MOUSE_OP_MOVE_ABSOLUTE,
+  INPUTTINO_MOUSE_OP_PRESS_BUTTON,
+  INPUTTINO_MOUSE_OP_RELEASE_BUTTON,
+  INPUTTINO_MOUSE_OP_SCROLL_VERTICAL,
+  INPUTTINO_MOUSE_OP_SCROLL_HORIZONTAL
+};
+
+typedef struct InputtinoMouseOp {
+  enum INPUTTINO_MOUSE_OP_TYPE type;
+  union {
+    struct {
+      int delta_x;
+      int delta_y;
+    } move;
+    struct {
+      int x;
+      int y;
+      int screen_width;
+      int screen_height;
+    } move_absolute;
+    enum INPUTTINO_MOUSE_BUTTON button; /* PRESS_BUTTON and RELEASE_BUTTON */
+    int high_res_distance;              /* SCROLL_VERTICAL and SCROLL_HORIZONTAL */
+  };
+} InputtinoMouseOp;
+
+/*
+ * Applies num_ops operations in order with a single write() to the device, sharing one SYN_REPORT where possible.
+ * This is meant for FFI users, which can cross into the library once per frame instead of once per event.
+ */
+LIBINPUTTINO_EXPORT void inputtino_mouse_submit_batch(InputtinoMouse *mouse, const InputtinoMouseOp *ops, size_t num_ops);
+
 LIBINPUTTINO_EXPORT void inputtino_mouse_destroy(InputtinoMouse *mouse);
 
+/*
+ * A finger update for the trackpad and the touchscreen, used with the *_submit_batch() calls.
+ * When released is true, only finger_nr is used.
+ */
+typedef struct InputtinoFingerOp {
+  int finger_nr;
+  bool released;
+  float x;
+  float y;
+  float pressure;
+  int orientation;
+} InputtinoFingerOp;
+
 /*
  * TRACKPAD
  */
@@ -83,6 +133,12 @@ LIBINPUTTINO_EXPORT void inputtino_trackpad_release_finger(InputtinoTrackpad *tr
 
 LIBINPUTTINO_EXPORT void inputtino_trackpad_set_left_btn(InputtinoTrackpad *trackpad, bool pressed);
 
+/*
+ * Places and releases fingers as a single multi-touch frame, with one SYN_REPORT and one write()
+ */
+LIBINPUTTINO_EXPORT void
+inputtino_trackpad_submit_batch(InputtinoTrackpad *trackpad, const InputtinoFingerOp *ops, size_t num_ops);
+
 LIBINPUTTINO_EXPORT void inputtino_trackpad_destroy(InputtinoTrackpad *trackpad);
 
 /*
@@ -102,6 +158,12 @@ LIBINPUTTINO_EXPORT void inputtino_touchscreen_place_finger(
 
 LIBINPUTTINO_EXPORT void inputtino_touchscreen_release_finger(InputtinoTouchscreen *touchscreen, int finger_nr);
 
+/*
+ * Places and releases fingers as a single multi-touch frame, with one SYN_REPORT and one write()
+ */
+LIBINPUTTINO_EXPORT void
+inputtino_touchscreen_submit_batch(InputtinoTouchscreen *touchscreen, const InputtinoFingerOp *ops, size_t num_ops);
+
 LIBINPUTTINO_EXPORT void inputtino_touchscreen_destroy(InputtinoTouchscreen *touchscreen);
 
 /*
@@ -161,6 +223,17 @@ LIBINPUTTINO_EXPORT void inputtino_keyboard_press(InputtinoKeyboard *keyboard, s
 
 LIBINPUTTINO_EXPORT void inputtino_keyboard_release(InputtinoKeyboard *keyboard, short key_code);
 
+typedef struct InputtinoKeyboardOp {
+  short key_code;
+  bool pressed;
+} InputtinoKeyboardOp;
+
+/*
+ * Presses and releases keys in order with a single write() to the device; each key keeps its own SYN_REPORT
+ */
+LIBINPUTTINO_EXPORT void
+inputtino_keyboard_submit_batch(InputtinoKeyboard *keyboard, const InputtinoKeyboardOp *ops, size_t num_ops);
+
 LIBINPUTTINO_EXPORT void inputtino_keyboard_destroy(InputtinoKeyboard *keyboard);
 
 /*
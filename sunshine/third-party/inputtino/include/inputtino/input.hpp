@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <functional>
 #include <inputtino/result.hpp>
@@ -96,6 +97,18 @@ public:
    */
   void horizontal_scroll(int high_res_distance);
 
+  /**
+   * Starts a frame: the following calls are collected and written together with a single write() on commit().
+   * They share one SYN_REPORT, unless a call repeats an event of the current report (like the same
+   * button being pressed and released), which then starts the next one.
+   */
+  void begin_frame();
+
+  /**
+   * Writes the frame started by begin_frame()
+   */
+  void commit();
+
 protected:
   typedef struct MouseState MouseState;
   std::shared_ptr<MouseState> _state;
@@ -133,6 +146,23 @@ public:
 
   void release_finger(int finger_nr);
 
+  /**
+   * Starts a multi-touch frame: the following update_finger() and release_finger() calls are collected and
+   * written together with a single SYN_REPORT on commit(), instead of one report per finger
+   */
+  void begin_frame();
+
+  /**
+   * Same as place_finger(), but part of the frame started by begin_frame().
+   * Without a frame, it's sent right away like place_finger()
+   */
+  void update_finger(int finger_nr, float x, float y, float pressure, int orientation);
+
+  /**
+   * Writes the frame started by begin_frame()
+   */
+  void commit();
+
   void set_left_btn(bool pressed);
 
 protected:
@@ -169,6 +199,23 @@ public:
 
   void release_finger(int finger_nr);
 
+  /**
+   * Starts a multi-touch frame: the following update_finger() and release_finger() calls are collected and
+   * written together with a single SYN_REPORT on commit(), instead of one report per finger
+   */
+  void begin_frame();
+
+  /**
+   * Same as place_finger(), but part of the frame started by begin_frame().
+   * Without a frame, it's sent right away like place_finger()
+   */
+  void update_finger(int finger_nr, float x, float y, float pressure, int orientation);
+
+  /**
+   * Writes the frame started by begin_frame()
+   */
+  void commit();
+
 protected:
   typedef struct TouchScreenState TouchScreenState;
   std::shared_ptr<TouchScreenState> _state;
@@ -256,6 +303,17 @@ public:
 
   void release(short key_code);
 
+  /**
+   * Starts a frame: the following press() and release() calls are collected and written with a single write()
+   * on commit(). Each key still gets a report of its own, like on a real keyboard.
+   */
+  void begin_frame();
+
+  /**
+   * Writes the frame started by begin_frame()
+   */
+  void commit();
+
 protected:
   typedef struct KeyboardState KeyboardState;
   std::shared_ptr<KeyboardState> _state;
@@ -448,13 +506,21 @@ public:
 
   void set_on_trigger_effect(const std::function<void(const TriggerEffect &)> &callback);
 
+  /**
+   * Reports are sent as soon as the state changes, but at most once every min_interval: changes arriving faster
+   * (ex: motion sensors) are merged into the next report. 1ms allows up to 1000 Hz, 0 (default) disables the limit.
+   *
+   * Readers expect frequent events even if the state hasn't changed, so the last report is repeated
+   * after keep_alive without changes (default: 10ms).
+   */
+  void set_report_rate(std::chrono::microseconds min_interval,
+                       std::chrono::milliseconds keep_alive = std::chrono::milliseconds(10));
+
 protected:
   typedef struct PS5JoypadState PS5JoypadState;
   std::shared_ptr<PS5JoypadState> _state;
 
 private:
-  std::thread _send_input_thread;
-
   static std::array<unsigned char, 6> generate_mac_address() {
     auto rand = std::bind(std::uniform_int_distribution<unsigned char>{0, 0xFF},
                           std::default_random_engine{std::random_device()()});
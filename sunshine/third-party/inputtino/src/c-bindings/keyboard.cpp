@@ -34,6 +34,21 @@ void inputtino_keyboard_release(InputtinoKeyboard *keyboard, short key_code) {
   }
 }
 
+void inputtino_keyboard_submit_batch(InputtinoKeyboard *keyboard, const InputtinoKeyboardOp *ops, size_t num_ops) {
+  if (keyboard) {
+    auto keyboard_ptr = reinterpret_cast<inputtino::Keyboard *>(keyboard);
+    keyboard_ptr->begin_frame();
+    for (size_t i = 0; i < num_ops; i++) {
+      if (ops[i].pressed) {
+        keyboard_ptr->press(ops[i].key_code);
+      } else {
+        keyboard_ptr->release(ops[i].key_code);
+      }
+    }
+    keyboard_ptr->commit();
+  }
+}
+
 void inputtino_keyboard_destroy(InputtinoKeyboard *keyboard) {
   if (keyboard) {
     auto ptr = reinterpret_cast<inputtino::Keyboard *>(keyboard);
@@ -59,6 +59,40 @@ void inputtino_mouse_scroll_horizontal(InputtinoMouse *mouse, int high_res_dista
   }
 }
 
+void inputtino_mouse_submit_batch(InputtinoMouse *mouse, const InputtinoMouseOp *ops, size_t num_ops) {
+  if (mouse) {
+    auto mouse_ptr = reinterpret_cast<inputtino::Mouse *>(mouse);
+    mouse_ptr->begin_frame();
+    for (size_t i = 0; i < num_ops; i++) {
+      const auto &op = ops[i];
+      switch (op.type) {
+      case INPUTTINO_MOUSE_OP_MOVE:
+        mouse_ptr->move(op.move.delta_x, op.move.delta_y);
+        break;
+      case INPUTTINO_MOUSE_OP_MOVE_ABSOLUTE:
+        mouse_ptr->move_abs(op.move_absolute.x,
+                            op.move_absolute.y,
+                            op.move_absolute.screen_width,
+                            op.move_absolute.screen_height);
+        break;
+      case INPUTTINO_MOUSE_OP_PRESS_BUTTON:
+        mouse_ptr->press(inputtino::Mouse::MOUSE_BUTTON(op.button));
+        break;
+      case INPUTTINO_MOUSE_OP_RELEASE_BUTTON:
+        mouse_ptr->release(inputtino::Mouse::MOUSE_BUTTON(op.button));
+        break;
+      case INPUTTINO_MOUSE_OP_SCROLL_VERTICAL:
+        mouse_ptr->vertical_scroll(op.high_res_distance);
+        break;
+      case INPUTTINO_MOUSE_OP_SCROLL_HORIZONTAL:
+        mouse_ptr->horizontal_scroll(op.high_res_distance);
+        break;
+      }
+    }
+    mouse_ptr->commit();
+  }
+}
+
 void inputtino_mouse_destroy(InputtinoMouse *mouse) {
   if (mouse) {
     inputtino::Mouse *mouse_ptr = reinterpret_cast<inputtino::Mouse *>(mouse);
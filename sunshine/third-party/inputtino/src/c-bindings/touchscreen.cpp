@@ -35,6 +35,22 @@ void inputtino_touchscreen_release_finger(InputtinoTouchscreen *touchscreen, int
   }
 }
 
+void inputtino_touchscreen_submit_batch(InputtinoTouchscreen *touchscreen, const InputtinoFingerOp *ops, size_t num_ops) {
+  if (touchscreen) {
+    auto touchscreen_ptr = reinterpret_cast<inputtino::TouchScreen *>(touchscreen);
+    touchscreen_ptr->begin_frame();
+    for (size_t i = 0; i < num_ops; i++) {
+      const auto &op = ops[i];
+      if (op.released) {
+        touchscreen_ptr->release_finger(op.finger_nr);
+      } else {
+        touchscreen_ptr->update_finger(op.finger_nr, op.x, op.y, op.pressure, op.orientation);
+      }
+    }
+    touchscreen_ptr->commit();
+  }
+}
+
 void inputtino_touchscreen_destroy(InputtinoTouchscreen *touchscreen) {
   if (touchscreen) {
     inputtino::TouchScreen *touch_ptr = reinterpret_cast<inputtino::TouchScreen *>(touchscreen);
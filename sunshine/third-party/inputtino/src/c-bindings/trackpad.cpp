@@ -41,6 +41,22 @@ void inputtino_trackpad_set_left_btn(InputtinoTrackpad *trackpad, bool pressed)
   }
 }
 
+void inputtino_trackpad_submit_batch(InputtinoTrackpad *trackpad, const InputtinoFingerOp *ops, size_t num_ops) {
+  if (trackpad) {
+    auto trackpad_ptr = reinterpret_cast<inputtino::Trackpad *>(trackpad);
+    trackpad_ptr->begin_frame();
+    for (size_t i = 0; i < num_ops; i++) {
+      const auto &op = ops[i];
+      if (op.released) {
+        trackpad_ptr->release_finger(op.finger_nr);
+      } else {
+        trackpad_ptr->update_finger(op.finger_nr, op.x, op.y, op.pressure, op.orientation);
+      }
+    }
+    trackpad_ptr->commit();
+  }
+}
+
 void inputtino_trackpad_destroy(InputtinoTrackpad *trackpad) {
   if (trackpad) {
     inputtino::Trackpad *trackpad_ptr = reinterpret_cast<inputtino::Trackpad *>(trackpad);
@@ -1,11 +1,64 @@
 #pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
 #include <functional>
 #include <inputtino/input.hpp>
+#include <inputtino/reactor.hpp>
+#include <mutex>
 #include <optional>
+#include <type_traits>
 #include <uhid/ps5.hpp>
 #include <uhid/uhid.hpp>
 
 namespace inputtino {
+
+/**
+ * Holds a copy of a value that a single writer updates while readers load it without locks (seqlock):
+ * a reader always gets a complete copy of one of the stored values, retrying if it was overwritten while copying.
+ * The value is kept in atomic words to make reading it while it's being stored well defined.
+ */
+template <typename T> class SeqLock {
+  static_assert(std::is_trivially_copyable_v<T>);
+
+public:
+  void store(const T &value) {
+    std::array<std::uint64_t, WORDS> words = {};
+    std::memcpy(words.data(), &value, sizeof(T));
+
+    auto seq = sequence.load(std::memory_order_relaxed);
+    sequence.store(seq + 1, std::memory_order_relaxed); // Odd: a store is in progress
+    std::atomic_thread_fence(std::memory_order_release);
+    for (std::size_t i = 0; i < WORDS; i++) {
+      data[i].store(words[i], std::memory_order_relaxed);
+    }
+    sequence.store(seq + 2, std::memory_order_release);
+  }
+
+  T load() const {
+    std::array<std::uint64_t, WORDS> words;
+    unsigned int seq;
+    do {
+      seq = sequence.load(std::memory_order_acquire);
+      for (std::size_t i = 0; i < WORDS; i++) {
+        words[i] = data[i].load(std::memory_order_relaxed);
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((seq & 1) || seq != sequence.load(std::memory_order_relaxed));
+
+    T value;
+    std::memcpy(static_cast<void *>(&value), words.data(), sizeof(T));
+    return value;
+  }
+
+private:
+  static constexpr std::size_t WORDS = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+  std::atomic<unsigned int> sequence = 0;
+  std::array<std::atomic<std::uint64_t>, WORDS> data = {};
+};
+
 struct PS5JoypadState {
   std::shared_ptr<uhid::Device> dev;
   /**
@@ -21,8 +74,14 @@ struct PS5JoypadState {
   unsigned char mac_address[6] = {0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF};
   uint16_t vendor_id;
 
+  /**
+   * Guards current_state and last_touch_id, modified by the setters
+   */
+  std::mutex state_mutex;
   uhid::dualsense_input_report current_state = {};
   uint8_t last_touch_id = 0;
+  /* The last current_state published by the setters, read without locks when sending the reports */
+  SeqLock<uhid::dualsense_input_report> published_state;
 
   std::optional<std::function<void(int, int)>> on_rumble = std::nullopt;
   std::optional<std::function<void(int, int, int)>> on_led = std::nullopt;
@@ -30,7 +89,19 @@ struct PS5JoypadState {
   uint32_t last_left_trigger_event = 0;
   uint32_t last_right_trigger_event = 0;
 
-  bool stop_repeat_thread = false;
   bool is_bluetooth = true;
+
+  /**
+   * Guards the fields below, shared by the setters and the report timer; reports are sent holding it
+   */
+  std::mutex report_mutex;
+  /* The reactor timer sending the reports held back by min_report_interval and the keep alive ones */
+  Reactor::TimerId report_timer = 0;
+  /* A change is waiting for min_report_interval to elapse since the last report */
+  bool report_pending = false;
+  uint8_t seq_number = 0;
+  std::chrono::steady_clock::time_point last_report = {};
+  std::chrono::microseconds min_report_interval = std::chrono::microseconds(0);
+  std::chrono::milliseconds keep_alive_interval = std::chrono::milliseconds(10);
 };
 } // namespace inputtino
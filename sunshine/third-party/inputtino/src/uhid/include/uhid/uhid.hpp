@@ -3,26 +3,24 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <functional>
+#include <inputtino/reactor.hpp>
 #include <inputtino/result.hpp>
 #include <iostream>
 #include <linux/uhid.h>
 #include <memory>
-#include <poll.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <string>
 #include <termios.h>
-#include <thread>
 #include <unistd.h>
 #include <vector>
 
 namespace uhid {
-struct ThreadState {
+struct DeviceState {
   int fd;
   std::function<void(const uhid_event &ev, int fd)> on_event;
-  bool stop_repeat_thread = false;
 };
 
 struct DeviceDefinition {
@@ -50,18 +48,15 @@ static inputtino::Result<bool> uhid_write(int fd, const struct uhid_event *ev) {
 
 class Device {
 private:
-  Device(std::shared_ptr<std::thread> ev_thread, std::shared_ptr<ThreadState> state)
-      : ev_thread(std::move(ev_thread)), state(std::move(state)) {};
-  std::shared_ptr<std::thread> ev_thread;
-  std::shared_ptr<ThreadState> state;
+  Device(std::shared_ptr<DeviceState> state) : state(std::move(state)) {};
+  std::shared_ptr<DeviceState> state;
   std::shared_ptr<std::function<void(const uhid_event &ev, int fd)>> on_event;
 
 public:
   static inputtino::Result<Device> create(const DeviceDefinition &definition,
                                           const std::function<void(const uhid_event &ev, int fd)> &on_event);
 
-  Device(Device &&j) noexcept : ev_thread(nullptr), state(nullptr), on_event(nullptr) {
-    std::swap(j.ev_thread, ev_thread);
+  Device(Device &&j) noexcept : state(nullptr), on_event(nullptr) {
     std::swap(j.state, state);
     std::swap(j.on_event, on_event);
   }
@@ -73,25 +68,22 @@ public:
     return uhid_write(state->fd, &ev);
   }
 
-  inline void stop_thread() {
-    state->stop_repeat_thread = true;
-    if (ev_thread->joinable()) {
-      ev_thread->join(); // let's wait for the thread to finish
-    }
+  /**
+   * Stops calling on_event, waiting for a running call to return
+   */
+  inline void stop_listening() {
+    inputtino::Reactor::get().remove(state->fd);
   }
 
   ~Device() {
     if (state) {
+      stop_listening();
+
       struct uhid_event ev{};
       ev.type = UHID_DESTROY;
       uhid_write(state->fd, &ev);
 
-      close(state->fd); // This should also close the thread by causing a POLLHUP
-
-      state->stop_repeat_thread = true;
-      if (ev_thread->joinable()) {
-        ev_thread->join(); // let's wait for the thread to finish
-      }
+      close(state->fd);
     }
   }
 };
@@ -101,7 +93,29 @@ static void set_c_str(const std::string &str, unsigned char *c_str) {
   c_str[str.length()] = 0;
 }
 
-constexpr int UHID_POLL_TIMEOUT = 500; // ms
+/**
+ * Called by the reactor when the uhid fd is ready, reads one event and passes it to on_event
+ */
+static void on_uhid_ready(const std::shared_ptr<DeviceState> &state, std::uint32_t events) {
+  if (events & EPOLLIN) {
+    struct uhid_event ev{};
+    auto ret = read(state->fd, &ev, sizeof(ev));
+    if (ret == 0) {
+      std::cerr << "Read HUP on uhid-cdev" << std::endl;
+    } else if (ret < 0) {
+      std::cerr << "Cannot read uhid-cdev: " << strerror(errno) << std::endl;
+    } else if (ret != sizeof(ev)) {
+      std::cerr << "Invalid size read from uhid-dev" << ret << " != " << sizeof(ev) << std::endl;
+    } else {
+      if (state->on_event) {
+        state->on_event(ev, state->fd);
+      }
+    }
+  } else if (events & (EPOLLHUP | EPOLLERR)) {
+    std::cerr << "HUP on uhid-cdev" << std::endl;
+    inputtino::Reactor::get().remove(state->fd);
+  }
+}
 
 inputtino::Result<Device> Device::create(const DeviceDefinition &definition,
                                          const std::function<void(const uhid_event &ev, int fd)> &on_event) {
@@ -123,42 +137,19 @@ inputtino::Result<Device> Device::create(const DeviceDefinition &definition,
 
   auto res = uhid_write(fd, &ev);
   if (res) {
-    auto state = std::make_shared<ThreadState>();
+    auto state = std::make_shared<DeviceState>();
     state->fd = fd;
     state->on_event = on_event;
-    auto thread = std::make_shared<std::thread>([state]() {
-      std::array<pollfd, 1> pfds = {pollfd{.fd = state->fd, .events = POLLIN}};
-      int poll_rs = 0;
-
-      while (!state->stop_repeat_thread) {
-        poll_rs = poll(pfds.data(), pfds.size(), UHID_POLL_TIMEOUT);
-        if (poll_rs < 0) {
-          std::cerr << "Failed polling uhid fd; ret=" << strerror(errno) << std::endl;
-          break;
-        }
-        if (pfds[0].revents & POLLHUP) {
-          std::cerr << "HUP on uhid-cdev" << std::endl;
-          break;
-        }
-        if (pfds[0].revents & POLLIN) {
-          struct uhid_event ev{};
-          auto ret = read(state->fd, &ev, sizeof(ev));
-          if (ret == 0) {
-            std::cerr << "Read HUP on uhid-cdev" << std::endl;
-          } else if (ret < 0) {
-            std::cerr << "Cannot read uhid-cdev: " << strerror(errno) << std::endl;
-          } else if (ret != sizeof(ev)) {
-            std::cerr << "Invalid size read from uhid-dev" << ret << " != " << sizeof(ev) << std::endl;
-          } else {
-            if (state->on_event) {
-              state->on_event(ev, state->fd);
-            }
-          }
-        }
-      }
-    });
-    thread->detach();
-    return inputtino::Result<Device>({std::move(thread), std::move(state)});
+    // Events for all the devices are read on the shared reactor thread
+    auto listening = inputtino::Reactor::get().add(fd, [state](std::uint32_t events) { on_uhid_ready(state, events); });
+    if (!listening) {
+      auto destroy = uhid_event{};
+      destroy.type = UHID_DESTROY;
+      uhid_write(fd, &destroy);
+      close(fd);
+      return inputtino::Error(listening.getErrorMessage());
+    }
+    return inputtino::Result<Device>(Device(std::move(state)));
   } else {
     close(fd);
     return inputtino::Error(res.getErrorMessage());
@@ -21,18 +21,21 @@ static uint32_t sign_crc32(uint32_t seed, const unsigned char *buffer, size_t le
 }
 
 static void send_report(PS5JoypadState &state) {
+  // Consistent copy of the last state published by the setters, without blocking them
+  auto report = state.published_state.load();
   { // setup timestamp and increase seq_number
-    state.current_state.seq_number++;
-    if (state.current_state.seq_number >= 255) {
-      state.current_state.seq_number = 0;
+    state.seq_number++;
+    if (state.seq_number >= 255) {
+      state.seq_number = 0;
     }
+    report.seq_number = state.seq_number;
 
     // Seems that the timestamp is little endian and 0.33us units
     // see:
     // https://github.com/torvalds/linux/blob/305230142ae0637213bf6e04f6d9f10bbcb74af8/drivers/hid/hid-playstation.c#L1409-L1410
     auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch())
                    .count();
-    state.current_state.sensor_timestamp = htole32(now / 333);
+    report.sensor_timestamp = htole32(now / 333);
   }
 
   struct uhid_event ev{};
@@ -54,10 +57,10 @@ static void send_report(PS5JoypadState &state) {
                 &ev.u.input2.data[0]);
     }
 
-    unsigned char *data = (unsigned char *)&state.current_state;
-    std::copy(data, data + sizeof(state.current_state), &ev.u.input2.data[header_size]);
+    unsigned char *data = (unsigned char *)&report;
+    std::copy(data, data + sizeof(report), &ev.u.input2.data[header_size]);
 
-    ev.u.input2.size = header_size + sizeof(state.current_state);
+    ev.u.input2.size = header_size + sizeof(report);
   }
 
   if (state.is_bluetooth) { // CRC32 encode the data and append it to the reply
@@ -71,6 +74,58 @@ static void send_report(PS5JoypadState &state) {
   }
 
   state.dev->send(ev);
+  state.last_report = std::chrono::steady_clock::now();
+  state.report_pending = false;
+}
+
+/**
+ * When the report timer should send the next report: a pending change once min_report_interval has elapsed,
+ * otherwise the keep alive repeating the last report. The caller must hold state.report_mutex
+ */
+static std::chrono::steady_clock::time_point next_report_deadline(const PS5JoypadState &state) {
+  if (state.report_pending) {
+    return state.last_report +
+           std::chrono::duration_cast<std::chrono::steady_clock::duration>(state.min_report_interval);
+  }
+  return state.last_report + std::chrono::duration_cast<std::chrono::steady_clock::duration>(state.keep_alive_interval);
+}
+
+/**
+ * Called back on the reactor thread, readers expect frequent events even if the state hasn't changed
+ */
+static std::optional<std::chrono::steady_clock::time_point> on_report_timer(PS5JoypadState &state) {
+  std::lock_guard lock(state.report_mutex);
+  if (std::chrono::steady_clock::now() >= next_report_deadline(state)) {
+    send_report(state);
+  }
+  return next_report_deadline(state);
+}
+
+/**
+ * Sends the changed state right away, unless the last report was sent less than min_report_interval ago:
+ * the report timer will then send it as soon as the interval has elapsed.
+ * The caller must hold state.report_mutex
+ */
+static void report_changed(PS5JoypadState &state) {
+  if (std::chrono::steady_clock::now() - state.last_report >= state.min_report_interval) {
+    send_report(state);
+  } else if (!state.report_pending) {
+    state.report_pending = true;
+    Reactor::get().reschedule_timer(state.report_timer, next_report_deadline(state));
+  }
+}
+
+/**
+ * Publishes current_state for the report thread and reports the change.
+ * state_lock must hold state.state_mutex, it's released before reporting so that other setters aren't blocked while
+ * the report is sent
+ */
+static void publish_state(PS5JoypadState &state, std::unique_lock<std::mutex> &state_lock) {
+  state.published_state.store(state.current_state);
+  state_lock.unlock();
+
+  std::lock_guard lock(state.report_mutex);
+  report_changed(state);
 }
 
 static void on_uhid_event(std::shared_ptr<PS5JoypadState> state, uhid_event ev, int fd) {
@@ -226,15 +281,14 @@ PS5Joypad::PS5Joypad(uint16_t vendor_id, std::array<unsigned char, 6> mac_addres
   // Set the battery to 100% (so that if the client doesn't report it we don't trigger annoying low battery warnings)
   this->_state->current_state.battery_charge = 10;
   this->_state->current_state.battery_status = BATTERY_FULL;
+  this->_state->published_state.store(this->_state->current_state);
 }
 
 PS5Joypad::~PS5Joypad() {
   if (this->_state && this->_state->dev) {
-    this->_state->stop_repeat_thread = true;
-    if (this->_send_input_thread.joinable()) {
-      this->_send_input_thread.join();
-    }
-    this->_state->dev->stop_thread();
+    // Waits for a report being sent, so it must not hold report_mutex
+    Reactor::get().remove_timer(this->_state->report_timer);
+    this->_state->dev->stop_listening();
     this->_state->dev.reset(); // Will trigger ~Device and ultimately destroy the device
   }
 }
@@ -287,14 +341,14 @@ Result<PS5Joypad> PS5Joypad::create(const DeviceDefinition &device) {
     joypad._state->is_bluetooth = use_bluetooth;
     joypad._state->dev = std::make_shared<uhid::Device>(std::move(*dev));
 
-    // Readers will expect frequent events event if the state hasn't changed
-    joypad._send_input_thread = std::thread([state = joypad._state]() {
-      while (!state->stop_repeat_thread) {
-        send_report(*state);
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
-      }
-    });
-    joypad._send_input_thread.detach();
+    // Sends the changes held back by the maximum report rate, and repeats the last report when idle
+    std::lock_guard lock(joypad._state->report_mutex);
+    auto timer = Reactor::get().add_timer(next_report_deadline(*joypad._state),
+                                          [state = joypad._state]() { return on_report_timer(*state); });
+    if (!timer) {
+      return Error(timer.getErrorMessage());
+    }
+    joypad._state->report_timer = *timer;
 
     return joypad;
   }
@@ -390,6 +444,7 @@ std::vector<std::string> PS5Joypad::get_nodes() const {
 }
 
 void PS5Joypad::set_pressed_buttons(unsigned int pressed) {
+  std::unique_lock lock(this->_state->state_mutex);
   { // First reset everything to non-pressed
     this->_state->current_state.buttons[0] = 0;
     // Don't reset L2 and R2, these are handled in set_triggers
@@ -463,9 +518,10 @@ void PS5Joypad::set_pressed_buttons(unsigned int pressed) {
     if (MISC_FLAG & pressed)
       this->_state->current_state.buttons[2] |= uhid::MIC_MUTE;
   }
-  send_report(*this->_state);
+  publish_state(*this->_state, lock);
 }
 void PS5Joypad::set_triggers(int16_t left, int16_t right) {
+  std::unique_lock lock(this->_state->state_mutex);
   this->_state->current_state.z = scale_value(left, 0, 255, uhid::PS5_AXIS_MIN, uhid::PS5_AXIS_MAX);
   this->_state->current_state.rz = scale_value(right, 0, 255, uhid::PS5_AXIS_MIN, uhid::PS5_AXIS_MAX);
 
@@ -479,20 +535,21 @@ void PS5Joypad::set_triggers(int16_t left, int16_t right) {
   else
     this->_state->current_state.buttons[1] |= uhid::R2;
 
-  send_report(*this->_state);
+  publish_state(*this->_state, lock);
 }
 void PS5Joypad::set_stick(Joypad::STICK_POSITION stick_type, short x, short y) {
+  std::unique_lock lock(this->_state->state_mutex);
   switch (stick_type) {
   case RS: {
     this->_state->current_state.rx = scale_value(x, -32768, 32767, uhid::PS5_AXIS_MIN, uhid::PS5_AXIS_MAX);
     this->_state->current_state.ry = scale_value(-y, -32768, 32767, uhid::PS5_AXIS_MIN, uhid::PS5_AXIS_MAX);
-    send_report(*this->_state);
+    publish_state(*this->_state, lock);
     break;
   }
   case LS: {
     this->_state->current_state.x = scale_value(x, -32768, 32767, uhid::PS5_AXIS_MIN, uhid::PS5_AXIS_MAX);
     this->_state->current_state.y = scale_value(-y, -32768, 32767, uhid::PS5_AXIS_MIN, uhid::PS5_AXIS_MAX);
-    send_report(*this->_state);
+    publish_state(*this->_state, lock);
     break;
   }
   }
@@ -510,13 +567,14 @@ static __le16 to_le_signed(float original, float value) {
 }
 
 void PS5Joypad::set_motion(PS5Joypad::MOTION_TYPE type, float x, float y, float z) {
+  std::unique_lock lock(this->_state->state_mutex);
   switch (type) {
   case ACCELERATION: {
     this->_state->current_state.accel[0] = to_le_signed(x, (x * uhid::SDL_STANDARD_GRAVITY_CONST * 100));
     this->_state->current_state.accel[1] = to_le_signed(y, (y * uhid::SDL_STANDARD_GRAVITY_CONST * 100));
     this->_state->current_state.accel[2] = to_le_signed(z, (z * uhid::SDL_STANDARD_GRAVITY_CONST * 100));
 
-    send_report(*this->_state);
+    publish_state(*this->_state, lock);
     break;
   }
   case GYROSCOPE: {
@@ -524,20 +582,21 @@ void PS5Joypad::set_motion(PS5Joypad::MOTION_TYPE type, float x, float y, float
     this->_state->current_state.gyro[1] = to_le_signed(y, y * uhid::gyro_resolution);
     this->_state->current_state.gyro[2] = to_le_signed(z, z * uhid::gyro_resolution);
 
-    send_report(*this->_state);
+    publish_state(*this->_state, lock);
     break;
   }
   }
 }
 
 void PS5Joypad::set_battery(PS5Joypad::BATTERY_STATE state, int percentage) {
+  std::unique_lock lock(this->_state->state_mutex);
   /*
    * Each unit of battery data corresponds to 10%
    * 0 = 0-9%, 1 = 10-19%, .. and 10 = 100%
    */
   this->_state->current_state.battery_charge = std::lround((percentage / 10));
   this->_state->current_state.battery_status = state;
-  send_report(*this->_state);
+  publish_state(*this->_state, lock);
 }
 
 void PS5Joypad::set_on_led(const std::function<void(int, int, int)> &callback) {
@@ -548,7 +607,17 @@ void PS5Joypad::set_on_trigger_effect(const std::function<void(const TriggerEffe
   this->_state->on_trigger_effect = callback;
 }
 
+void PS5Joypad::set_report_rate(std::chrono::microseconds min_interval, std::chrono::milliseconds keep_alive) {
+  {
+    std::lock_guard lock(this->_state->report_mutex);
+    this->_state->min_report_interval = min_interval;
+    this->_state->keep_alive_interval = keep_alive;
+    Reactor::get().reschedule_timer(this->_state->report_timer, next_report_deadline(*this->_state));
+  }
+}
+
 void PS5Joypad::place_finger(int finger_nr, uint16_t x, uint16_t y) {
+  std::unique_lock lock(this->_state->state_mutex);
   if (finger_nr <= 1) {
     // If this finger was previously unpressed, we should increase the touch id
     if (this->_state->current_state.points[finger_nr].contact == 1) {
@@ -562,18 +631,19 @@ void PS5Joypad::place_finger(int finger_nr, uint16_t x, uint16_t y) {
     this->_state->current_state.points[finger_nr].y_lo = static_cast<uint8_t>(y & 0x000F);
     this->_state->current_state.points[finger_nr].y_hi = static_cast<uint8_t>((y & 0x0FF0) >> 4);
 
-    send_report(*this->_state);
+    publish_state(*this->_state, lock);
   }
 }
 
 void PS5Joypad::release_finger(int finger_nr) {
+  std::unique_lock lock(this->_state->state_mutex);
   if (finger_nr <= 1) {
     // if it goes above 0x7F we should reset it to 0
     if (this->_state->last_touch_id >= 0x7E) {
       this->_state->last_touch_id = 0;
     }
     this->_state->current_state.points[finger_nr].contact = 1;
-    send_report(*this->_state);
+    publish_state(*this->_state, lock);
   }
 }
 
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <array>
+#include <cerrno>
 #include <cstring>
 #include <inputtino/input.hpp>
+#include <inputtino/reactor.hpp>
 #include <iostream>
 #include <libevdev/libevdev-uinput.h>
 #include <libevdev/libevdev.h>
@@ -33,6 +36,147 @@ static std::vector<libevdev_event_ptr> fetch_events(int uinput_fd, int max_event
   return events;
 }
 
+/**
+ * Collects the events of a device report, so that they are written with a single write() instead of one per event.
+ * The events are written when SYN_REPORT is added, when the batch is full, on flush() and when the batch goes out of scope.
+ */
+template <std::size_t capacity = 32> class EventBatch {
+public:
+  explicit EventBatch(libevdev_uinput *device) : device(device) {}
+  EventBatch(const EventBatch &) = delete;
+  EventBatch &operator=(const EventBatch &) = delete;
+
+  ~EventBatch() {
+    flush();
+  }
+
+  void write(unsigned int type, unsigned int code, int value) {
+    if (size == events.size()) {
+      flush();
+    }
+    auto &ev = events[size++];
+    ev = {}; // The kernel sets the timestamp, like libevdev_uinput_write_event() does
+    ev.type = type;
+    ev.code = code;
+    ev.value = value;
+    if (type == EV_SYN && code == SYN_REPORT) {
+      flush();
+    }
+  }
+
+  void flush() {
+    if (size == 0) {
+      return;
+    }
+    auto fd = libevdev_uinput_get_fd(device);
+    auto data = reinterpret_cast<const char *>(events.data());
+    auto left = size * sizeof(input_event);
+    size = 0;
+    while (left > 0) {
+      auto ret = ::write(fd, data, left);
+      if (ret < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        std::cerr << "Failed writing uinput events; ret=" << strerror(errno);
+        return;
+      }
+      data += ret;
+      left -= static_cast<std::size_t>(ret);
+    }
+  }
+
+private:
+  libevdev_uinput *device;
+  std::array<input_event, capacity> events;
+  std::size_t size = 0;
+};
+
+/**
+ * Collects the events of several operations and writes them with a single write() when it goes out of scope.
+ * Consecutive operations share a report, ended by a single SYN_REPORT: a report is only split when an event code
+ * repeats, since readers keep a single value per code and report (pressing and releasing a key, or two key presses
+ * with their MSC_SCAN).
+ */
+class ReportFrame {
+public:
+  explicit ReportFrame(libevdev_uinput *device) : device(device) {}
+  ReportFrame(const ReportFrame &) = delete;
+  ReportFrame &operator=(const ReportFrame &) = delete;
+
+  ~ReportFrame() {
+    end_report();
+    flush();
+  }
+
+  void write(unsigned int type, unsigned int code, int value) {
+    if (type == EV_SYN) {
+      // The operations don't end their own report in a frame
+      return;
+    }
+    for (std::size_t i = report_start; i < events.size(); i++) {
+      if (events[i].type == type && events[i].code == code) {
+        end_report();
+        break;
+      }
+    }
+    append(type, code, value);
+  }
+
+private:
+  void append(unsigned int type, unsigned int code, int value) {
+    input_event ev = {}; // The kernel sets the timestamp, like libevdev_uinput_write_event() does
+    ev.type = type;
+    ev.code = code;
+    ev.value = value;
+    events.push_back(ev);
+  }
+
+  void end_report() {
+    if (report_start < events.size()) {
+      append(EV_SYN, SYN_REPORT, 0);
+      report_start = events.size();
+    }
+  }
+
+  void flush() {
+    auto fd = libevdev_uinput_get_fd(device);
+    auto data = reinterpret_cast<const char *>(events.data());
+    auto left = events.size() * sizeof(input_event);
+    while (left > 0) {
+      auto ret = ::write(fd, data, left);
+      if (ret < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        std::cerr << "Failed writing uinput events; ret=" << strerror(errno);
+        return;
+      }
+      data += ret;
+      left -= static_cast<std::size_t>(ret);
+    }
+  }
+
+  libevdev_uinput *device;
+  std::vector<input_event> events;
+  /* The index of the first event of the current report */
+  std::size_t report_start = 0;
+};
+
+/**
+ * Writes the events of an operation into frame when one was started, otherwise right away in a report of their own
+ */
+template <typename WriteEvents>
+static void write_report(libevdev_uinput *device, ReportFrame *frame, WriteEvents &&write_events) {
+  if (frame) {
+    write_events(*frame);
+  } else if (device) {
+    EventBatch batch(device);
+    write_events(batch);
+    batch.write(EV_SYN, SYN_REPORT, 0);
+  }
+}
+
 struct PenTabletState {
   libevdev_uinput_ptr pen_tablet = nullptr;
   PenTablet::TOOL_TYPE last_tool = PenTablet::SAME_AS_BEFORE;
@@ -42,8 +186,8 @@ struct BaseJoypadState {
   libevdev_uinput_ptr joy = nullptr;
   int currently_pressed_btns = 0;
 
-  bool stop_listening_events = false;
-  std::thread events_thread;
+  /* The uinput fd listened to by the event listener on the Reactor, -1 when not listening */
+  int events_fd = -1;
 
   std::optional<std::function<void(int low_freq, int high_freq)>> on_rumble = std::nullopt;
 };
@@ -52,19 +196,35 @@ struct XboxOneJoypadState : BaseJoypadState {};
 struct SwitchJoypadState : BaseJoypadState {};
 
 struct KeyboardState {
-  std::thread repeat_press_t;
-  bool stop_repeat_thread = false;
   libevdev_uinput_ptr kb = nullptr;
+  /* Guards the fields below, shared with the repeat timer on the reactor thread */
+  std::mutex keys_mutex;
   std::vector<short> cur_press_keys = {};
+  /* The reactor timer re-pressing cur_press_keys, 0 when no key is held */
+  Reactor::TimerId repeat_timer = 0;
+  std::chrono::milliseconds repeat_interval = std::chrono::milliseconds(50);
+  /* The frame started by begin_frame(), written on commit() */
+  std::unique_ptr<ReportFrame> frame = nullptr;
 };
 
 struct MouseState {
   libevdev_uinput_ptr mouse_rel = nullptr;
   libevdev_uinput_ptr mouse_abs = nullptr;
+  /* The frames started by begin_frame(), written on commit() */
+  std::unique_ptr<ReportFrame> rel_frame = nullptr;
+  std::unique_ptr<ReportFrame> abs_frame = nullptr;
 };
 
+/**
+ * Enough for a multi-touch frame updating all the fingers, written with a single SYN_REPORT
+ */
+constexpr std::size_t MT_FRAME_MAX_EVENTS = 256;
+using MultiTouchFrame = EventBatch<MT_FRAME_MAX_EVENTS>;
+
 struct TouchScreenState {
   libevdev_uinput_ptr touch_screen = nullptr;
+  /* The frame started by begin_frame(), written on commit() */
+  std::unique_ptr<MultiTouchFrame> frame = nullptr;
 
   /**
    * Multi touch protocol type B is stateful; see: https://docs.kernel.org/input/multi-touch-protocol.html
@@ -87,6 +247,10 @@ struct TouchScreenState {
 
 struct TrackpadState {
   libevdev_uinput_ptr trackpad = nullptr;
+  /* The frame started by begin_frame(), written on commit() */
+  std::unique_ptr<MultiTouchFrame> frame = nullptr;
+  /* The number of fingers when the frame started, the BTN_TOOL_* keys are updated on commit() */
+  std::size_t frame_start_fingers = 0;
 
   /**
    * Multi touch protocol type B is stateful; see: https://docs.kernel.org/input/multi-touch-protocol.html
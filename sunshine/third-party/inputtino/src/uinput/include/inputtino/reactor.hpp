@@ -0,0 +1,344 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <errno.h>
+#include <functional>
+#include <inputtino/result.hpp>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace inputtino {
+
+/**
+ * A single thread waiting on the file descriptors of all the virtual devices (uhid requests, uinput force feedback)
+ * that calls back the devices that are ready, instead of having one mostly idle thread per device.
+ *
+ * It also runs the timers of the devices (keyboard auto-repeat, PS5 reports), so that no thread has to
+ * wake up periodically for devices that have nothing to do.
+ *
+ * The thread is started the first time that the reactor is used and runs for the lifetime of the process.
+ */
+class Reactor {
+public:
+  /**
+   * Called on the reactor thread with the ready epoll events (EPOLLIN, EPOLLHUP, ...), or with 0 when nothing
+   * happened on the fd for the timeout passed to add()
+   */
+  using Callback = std::function<void(std::uint32_t events)>;
+
+  using Clock = std::chrono::steady_clock;
+  using TimerId = std::uint64_t;
+  /**
+   * Called on the reactor thread when the timer expires, returns when to be called next or nothing to stop the timer
+   */
+  using TimerCallback = std::function<std::optional<Clock::time_point>()>;
+
+  static Reactor &get() {
+    // Never destroyed: devices might still be removed by the destructors of static objects
+    static auto *reactor = new Reactor();
+    return *reactor;
+  }
+
+  Reactor(const Reactor &) = delete;
+  Reactor &operator=(const Reactor &) = delete;
+
+  /**
+   * Starts calling back on_ready when fd is readable; with a timeout the callback is also called when
+   * nothing happened on the fd for that long (ex: to update the running rumble effects)
+   */
+  Result<bool> add(int fd, Callback on_ready, std::chrono::milliseconds timeout = std::chrono::milliseconds(0)) {
+    if (epoll_fd < 0 || wake_fd < 0) {
+      return Error("Unable to start the event reactor");
+    }
+
+    std::lock_guard lock(mutex);
+    auto handler = std::make_shared<Handler>(Handler{.on_ready = std::move(on_ready),
+                                                     .timeout = timeout,
+                                                     .deadline = std::chrono::steady_clock::now() + timeout});
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+      return Error(strerror(errno));
+    }
+    handlers.insert_or_assign(fd, std::move(handler));
+    wake(); // The next timeout might be earlier than the one epoll_wait() is sleeping on
+    return true;
+  }
+
+  /**
+   * Stops calling back fd. Outside of the reactor thread it also waits for a running callback to return,
+   * so that whatever the callback uses can be released afterwards.
+   */
+  void remove(int fd) {
+    std::shared_ptr<Handler> removed;
+    {
+      std::lock_guard lock(mutex);
+      auto handler = handlers.find(fd);
+      if (handler == handlers.end()) {
+        return;
+      }
+      removed = std::move(handler->second);
+      handlers.erase(handler);
+      epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+    }
+
+    if (std::this_thread::get_id() != thread_id) {
+      std::lock_guard dispatching(dispatch_mutex);
+    }
+    // The callback is released here, outside of the lock, since it might own the device that is calling remove()
+  }
+
+  /**
+   * Calls back on_expired at deadline; the timer keeps running for as long as the callback returns a new deadline
+   */
+  Result<TimerId> add_timer(Clock::time_point deadline, TimerCallback on_expired) {
+    if (epoll_fd < 0 || timer_fd < 0) {
+      return Error("Unable to start the event reactor");
+    }
+
+    std::lock_guard lock(mutex);
+    auto id = ++last_timer_id;
+    timers.insert_or_assign(id, std::make_shared<Timer>(Timer{.on_expired = std::move(on_expired), .deadline = deadline}));
+    arm_timers();
+    return id;
+  }
+
+  /**
+   * Moves the next call of a timer, ex: earlier when there's new work to do.
+   * When the timer is running, the earliest of deadline and the one returned by the callback is used.
+   */
+  void reschedule_timer(TimerId id, Clock::time_point deadline) {
+    std::lock_guard lock(mutex);
+    if (auto timer = timers.find(id); timer != timers.end()) {
+      timer->second->deadline = deadline;
+      arm_timers();
+    }
+  }
+
+  /**
+   * Stops a timer. Like remove(), outside of the reactor thread it also waits for a running callback to return.
+   */
+  void remove_timer(TimerId id) {
+    std::shared_ptr<Timer> removed;
+    {
+      std::lock_guard lock(mutex);
+      auto timer = timers.find(id);
+      if (timer == timers.end()) {
+        return;
+      }
+      removed = std::move(timer->second);
+      timers.erase(timer);
+      arm_timers();
+    }
+
+    if (std::this_thread::get_id() != thread_id) {
+      std::lock_guard dispatching(dispatch_mutex);
+    }
+  }
+
+private:
+  struct Timer {
+    TimerCallback on_expired;
+    Clock::time_point deadline;
+  };
+
+  struct Handler {
+    Callback on_ready;
+    std::chrono::milliseconds timeout;
+    std::chrono::steady_clock::time_point deadline;
+  };
+
+  int epoll_fd = -1;
+  /* Written to when the handlers change, to wake up epoll_wait() */
+  int wake_fd = -1;
+  /* Armed with the earliest timer deadline */
+  int timer_fd = -1;
+  std::thread::id thread_id;
+
+  /* Guards handlers */
+  std::mutex mutex;
+  std::map<int /* fd */, std::shared_ptr<Handler>> handlers;
+  /* Also guarded by mutex */
+  std::map<TimerId, std::shared_ptr<Timer>> timers;
+  TimerId last_timer_id = 0;
+  /* Held by the reactor thread while calling back the handlers */
+  std::mutex dispatch_mutex;
+
+  Reactor() {
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+    if (epoll_fd < 0 || wake_fd < 0 || timer_fd < 0) {
+      std::cerr << "Failed creating the event reactor; ret=" << strerror(errno) << std::endl;
+      return;
+    }
+
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = wake_fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &ev);
+    ev.data.fd = timer_fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, timer_fd, &ev);
+
+    auto thread = std::thread([this]() { run(); });
+    thread_id = thread.get_id();
+    thread.detach();
+  }
+
+  void wake() {
+    std::uint64_t value = 1;
+    if (write(wake_fd, &value, sizeof(value)) < 0 && errno != EAGAIN) {
+      std::cerr << "Failed waking up the event reactor; ret=" << strerror(errno) << std::endl;
+    }
+  }
+
+  /**
+   * Arms timer_fd with the earliest timer deadline, or disarms it when there are no timers.
+   * The caller must hold mutex
+   */
+  void arm_timers() {
+    itimerspec spec{};
+    if (!timers.empty()) {
+      auto deadline = Clock::time_point::max();
+      for (const auto &[id, timer] : timers) {
+        deadline = std::min(deadline, timer->deadline);
+      }
+      // steady_clock is CLOCK_MONOTONIC; a zero it_value would disarm the timer, so round up to 1ns
+      auto ns = std::max<std::int64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count(), 1);
+      spec.it_value.tv_sec = ns / 1000000000;
+      spec.it_value.tv_nsec = ns % 1000000000;
+    }
+    if (timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &spec, nullptr) < 0) {
+      std::cerr << "Failed arming the event reactor timer; ret=" << strerror(errno) << std::endl;
+    }
+  }
+
+  /**
+   * Calls back the expired timers, the caller must hold dispatch_mutex
+   */
+  void dispatch_timers() {
+    std::vector<std::pair<TimerId, std::shared_ptr<Timer>>> expired;
+    {
+      std::lock_guard lock(mutex);
+      auto now = Clock::now();
+      for (const auto &[id, timer] : timers) {
+        if (timer->deadline <= now) {
+          expired.emplace_back(id, timer);
+          // So that a reschedule_timer() while running can be told apart from the callback's own deadline
+          timer->deadline = Clock::time_point::max();
+        }
+      }
+    }
+
+    for (auto &[id, timer] : expired) {
+      auto next = timer->on_expired();
+
+      std::lock_guard lock(mutex);
+      auto found = timers.find(id);
+      if (found == timers.end()) {
+        continue; // Removed by the callback
+      }
+      if (next) {
+        timer->deadline = std::min(timer->deadline, *next);
+      } else if (timer->deadline == Clock::time_point::max()) {
+        timers.erase(found);
+      }
+    }
+
+    std::lock_guard lock(mutex);
+    arm_timers();
+  }
+
+  /**
+   * @returns the ms until the first handler timeout or -1 when no handler has a timeout, as expected by epoll_wait()
+   */
+  int next_timeout() {
+    std::lock_guard lock(mutex);
+    auto now = std::chrono::steady_clock::now();
+    int timeout = -1;
+    for (const auto &[fd, handler] : handlers) {
+      if (handler->timeout.count() > 0) {
+        auto left = std::chrono::ceil<std::chrono::milliseconds>(handler->deadline - now).count();
+        left = std::max<decltype(left)>(left, 0);
+        if (timeout < 0 || left < timeout) {
+          timeout = static_cast<int>(left);
+        }
+      }
+    }
+    return timeout;
+  }
+
+  void dispatch(int fd, std::uint32_t events) {
+    std::shared_ptr<Handler> handler;
+    {
+      std::lock_guard lock(mutex);
+      if (auto found = handlers.find(fd); found != handlers.end()) {
+        handler = found->second;
+      }
+    }
+    if (handler) { // It might have been removed by a previous callback
+      handler->on_ready(events);
+      handler->deadline = std::chrono::steady_clock::now() + handler->timeout;
+    }
+  }
+
+  void run() {
+    std::array<epoll_event, 16> events = {};
+    while (true) {
+      int ready = epoll_wait(epoll_fd, events.data(), events.size(), next_timeout());
+      if (ready < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        std::cerr << "Failed waiting on the event reactor; ret=" << strerror(errno) << std::endl;
+        return;
+      }
+
+      std::lock_guard dispatching(dispatch_mutex);
+      for (int i = 0; i < ready; i++) {
+        if (events[i].data.fd == wake_fd) {
+          std::uint64_t value;
+          while (read(wake_fd, &value, sizeof(value)) > 0) {
+          }
+        } else if (events[i].data.fd == timer_fd) {
+          std::uint64_t expirations;
+          while (read(timer_fd, &expirations, sizeof(expirations)) > 0) {
+          }
+          dispatch_timers();
+        } else {
+          dispatch(events[i].data.fd, events[i].events);
+        }
+      }
+
+      std::vector<int> timed_out;
+      {
+        std::lock_guard lock(mutex);
+        auto now = std::chrono::steady_clock::now();
+        for (const auto &[fd, handler] : handlers) {
+          if (handler->timeout.count() > 0 && handler->deadline <= now) {
+            timed_out.push_back(fd);
+          }
+        }
+      }
+      for (auto fd : timed_out) {
+        dispatch(fd, 0);
+      }
+    }
+  }
+};
+
+} // namespace inputtino
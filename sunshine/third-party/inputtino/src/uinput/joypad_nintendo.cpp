@@ -83,10 +83,7 @@ SwitchJoypad::SwitchJoypad() : _state(std::make_shared<SwitchJoypadState>()) {}
 
 SwitchJoypad::~SwitchJoypad() {
   if (_state) {
-    _state->stop_listening_events = true;
-    if (_state->joy.get() != nullptr && _state->events_thread.joinable()) {
-      _state->events_thread.join();
-    }
+    stop_event_listener(_state);
   }
 }
 
@@ -99,9 +96,7 @@ Result<SwitchJoypad> SwitchJoypad::create(const DeviceDefinition &device) {
   SwitchJoypad joypad;
   joypad._state->joy = std::move(*joy_el);
 
-  auto event_thread = std::thread(event_listener, joypad._state);
-  joypad._state->events_thread = std::move(event_thread);
-  joypad._state->events_thread.detach();
+  start_event_listener(joypad._state);
 
   return joypad;
 }
@@ -112,75 +107,78 @@ void SwitchJoypad::set_pressed_buttons(unsigned int newly_pressed) {
   // Button flags that are only part of the new packet
   auto bf_new = newly_pressed;
   if (auto controller = this->_state->joy.get()) {
+    EventBatch batch(controller);
 
     if (bf_changed) {
       if ((DPAD_UP | DPAD_DOWN) & bf_changed) {
         int button_state = bf_new & DPAD_UP ? -1 : (bf_new & DPAD_DOWN ? 1 : 0);
 
-        libevdev_uinput_write_event(controller, EV_ABS, ABS_HAT0Y, button_state);
+        batch.write(EV_ABS, ABS_HAT0Y, button_state);
       }
 
       if ((DPAD_LEFT | DPAD_RIGHT) & bf_changed) {
         int button_state = bf_new & DPAD_LEFT ? -1 : (bf_new & DPAD_RIGHT ? 1 : 0);
 
-        libevdev_uinput_write_event(controller, EV_ABS, ABS_HAT0X, button_state);
+        batch.write(EV_ABS, ABS_HAT0X, button_state);
       }
 
       if (START & bf_changed)
-        libevdev_uinput_write_event(controller, EV_KEY, BTN_START, bf_new & START ? 1 : 0);
+        batch.write(EV_KEY, BTN_START, bf_new & START ? 1 : 0);
       if (BACK & bf_changed)
-        libevdev_uinput_write_event(controller, EV_KEY, BTN_SELECT, bf_new & BACK ? 1 : 0);
+        batch.write(EV_KEY, BTN_SELECT, bf_new & BACK ? 1 : 0);
       if (LEFT_STICK & bf_changed)
-        libevdev_uinput_write_event(controller, EV_KEY, BTN_THUMBL, bf_new & LEFT_STICK ? 1 : 0);
+        batch.write(EV_KEY, BTN_THUMBL, bf_new & LEFT_STICK ? 1 : 0);
       if (RIGHT_STICK & bf_changed)
-        libevdev_uinput_write_event(controller, EV_KEY, BTN_THUMBR, bf_new & RIGHT_STICK ? 1 : 0);
+        batch.write(EV_KEY, BTN_THUMBR, bf_new & RIGHT_STICK ? 1 : 0);
       if (LEFT_BUTTON & bf_changed)
-        libevdev_uinput_write_event(controller, EV_KEY, BTN_TL, bf_new & LEFT_BUTTON ? 1 : 0);
+        batch.write(EV_KEY, BTN_TL, bf_new & LEFT_BUTTON ? 1 : 0);
       if (RIGHT_BUTTON & bf_changed)
-        libevdev_uinput_write_event(controller, EV_KEY, BTN_TR, bf_new & RIGHT_BUTTON ? 1 : 0);
+        batch.write(EV_KEY, BTN_TR, bf_new & RIGHT_BUTTON ? 1 : 0);
       if (HOME & bf_changed)
-        libevdev_uinput_write_event(controller, EV_KEY, BTN_MODE, bf_new & HOME ? 1 : 0);
+        batch.write(EV_KEY, BTN_MODE, bf_new & HOME ? 1 : 0);
       if (MISC_FLAG & bf_changed) {
         // Capture button
-        libevdev_uinput_write_event(controller, EV_KEY, BTN_Z, bf_new & MISC_FLAG ? 1 : 0);
+        batch.write(EV_KEY, BTN_Z, bf_new & MISC_FLAG ? 1 : 0);
       }
       if (A & bf_changed)
-        libevdev_uinput_write_event(controller, EV_KEY, BTN_EAST, bf_new & A ? 1 : 0);
+        batch.write(EV_KEY, BTN_EAST, bf_new & A ? 1 : 0);
       if (B & bf_changed)
-        libevdev_uinput_write_event(controller, EV_KEY, BTN_SOUTH, bf_new & B ? 1 : 0);
+        batch.write(EV_KEY, BTN_SOUTH, bf_new & B ? 1 : 0);
       if (X & bf_changed)
-        libevdev_uinput_write_event(controller, EV_KEY, BTN_NORTH, bf_new & X ? 1 : 0);
+        batch.write(EV_KEY, BTN_NORTH, bf_new & X ? 1 : 0);
       if (Y & bf_changed)
-        libevdev_uinput_write_event(controller, EV_KEY, BTN_WEST, bf_new & Y ? 1 : 0);
+        batch.write(EV_KEY, BTN_WEST, bf_new & Y ? 1 : 0);
     }
 
-    libevdev_uinput_write_event(controller, EV_SYN, SYN_REPORT, 0);
+    batch.write(EV_SYN, SYN_REPORT, 0);
   }
   this->_state->currently_pressed_btns = bf_new;
 }
 
 void SwitchJoypad::set_stick(Joypad::STICK_POSITION stick_type, short x, short y) {
   if (auto controller = this->_state->joy.get()) {
+    EventBatch batch(controller);
     if (stick_type == LS) {
-      libevdev_uinput_write_event(controller, EV_ABS, ABS_X, x);
-      libevdev_uinput_write_event(controller, EV_ABS, ABS_Y, -y);
+      batch.write(EV_ABS, ABS_X, x);
+      batch.write(EV_ABS, ABS_Y, -y);
     } else {
-      libevdev_uinput_write_event(controller, EV_ABS, ABS_RX, x);
-      libevdev_uinput_write_event(controller, EV_ABS, ABS_RY, -y);
+      batch.write(EV_ABS, ABS_RX, x);
+      batch.write(EV_ABS, ABS_RY, -y);
     }
 
-    libevdev_uinput_write_event(controller, EV_SYN, SYN_REPORT, 0);
+    batch.write(EV_SYN, SYN_REPORT, 0);
   }
 }
 
 void SwitchJoypad::set_triggers(int16_t left, int16_t right) {
   if (auto controller = this->_state->joy.get()) {
+    EventBatch batch(controller);
     // Nintendo ZL and ZR are just buttons (EV_KEY)
-    libevdev_uinput_write_event(controller, EV_KEY, BTN_TL2, left > 0 ? 1 : 0);
-    libevdev_uinput_write_event(controller, EV_SYN, SYN_REPORT, 0);
+    batch.write(EV_KEY, BTN_TL2, left > 0 ? 1 : 0);
+    batch.write(EV_SYN, SYN_REPORT, 0);
 
-    libevdev_uinput_write_event(controller, EV_KEY, BTN_TR2, right > 0 ? 1 : 0);
-    libevdev_uinput_write_event(controller, EV_SYN, SYN_REPORT, 0);
+    batch.write(EV_KEY, BTN_TR2, right > 0 ? 1 : 0);
+    batch.write(EV_SYN, SYN_REPORT, 0);
   }
 }
 
@@ -84,10 +84,7 @@ PS5Joypad::PS5Joypad(uint16_t vendor_id, std::array<unsigned char, 6> mac_addres
 
 PS5Joypad::~PS5Joypad() {
   if (_state) {
-    _state->stop_listening_events = true;
-    if (_state->joy.get() != nullptr && _state->events_thread.joinable()) {
-      _state->events_thread.join();
-    }
+    stop_event_listener(_state);
   }
 }
 
@@ -100,9 +97,7 @@ Result<PS5Joypad> PS5Joypad::create(const DeviceDefinition &device) {
   PS5Joypad joypad(0);
   joypad._state->joy = std::move(*joy_el);
 
-  auto event_thread = std::thread(event_listener, joypad._state);
-  joypad._state->events_thread = std::move(event_thread);
-  joypad._state->events_thread.detach();
+  start_event_listener(joypad._state);
 
   return joypad;
 }
@@ -113,78 +108,81 @@ void PS5Joypad::set_pressed_buttons(unsigned int newly_pressed) {
   // Button flags that are only part of the new packet
   auto bf_new = newly_pressed;
   if (auto controller = this->_state->joy.get()) {
+    EventBatch batch(controller);
 
     if (bf_changed) {
       if ((DPAD_UP | DPAD_DOWN) & bf_changed) {
         int button_state = bf_new & DPAD_UP ? -1 : (bf_new & DPAD_DOWN ? 1 : 0);
 
-        libevdev_uinput_write_event(controller, EV_ABS, ABS_HAT0Y, button_state);
+        batch.write(EV_ABS, ABS_HAT0Y, button_state);
       }
 
       if ((DPAD_LEFT | DPAD_RIGHT) & bf_changed) {
         int button_state = bf_new & DPAD_LEFT ? -1 : (bf_new & DPAD_RIGHT ? 1 : 0);
 
-        libevdev_uinput_write_event(controller, EV_ABS, ABS_HAT0X, button_state);
+        batch.write(EV_ABS, ABS_HAT0X, button_state);
       }
 
       if (START & bf_changed)
-        libevdev_uinput_write_event(controller, EV_KEY, BTN_START, bf_new & START ? 1 : 0);
+        batch.write(EV_KEY, BTN_START, bf_new & START ? 1 : 0);
       if (BACK & bf_changed)
-        libevdev_uinput_write_event(controller, EV_KEY, BTN_SELECT, bf_new & BACK ? 1 : 0);
+        batch.write(EV_KEY, BTN_SELECT, bf_new & BACK ? 1 : 0);
       if (LEFT_STICK & bf_changed)
-        libevdev_uinput_write_event(controller, EV_KEY, BTN_THUMBL, bf_new & LEFT_STICK ? 1 : 0);
+        batch.write(EV_KEY, BTN_THUMBL, bf_new & LEFT_STICK ? 1 : 0);
       if (RIGHT_STICK & bf_changed)
-        libevdev_uinput_write_event(controller, EV_KEY, BTN_THUMBR, bf_new & RIGHT_STICK ? 1 : 0);
+        batch.write(EV_KEY, BTN_THUMBR, bf_new & RIGHT_STICK ? 1 : 0);
       if (LEFT_BUTTON & bf_changed)
-        libevdev_uinput_write_event(controller, EV_KEY, BTN_TL, bf_new & LEFT_BUTTON ? 1 : 0);
+        batch.write(EV_KEY, BTN_TL, bf_new & LEFT_BUTTON ? 1 : 0);
       if (RIGHT_BUTTON & bf_changed)
-        libevdev_uinput_write_event(controller, EV_KEY, BTN_TR, bf_new & RIGHT_BUTTON ? 1 : 0);
+        batch.write(EV_KEY, BTN_TR, bf_new & RIGHT_BUTTON ? 1 : 0);
       if (HOME & bf_changed)
-        libevdev_uinput_write_event(controller, EV_KEY, BTN_MODE, bf_new & HOME ? 1 : 0);
+        batch.write(EV_KEY, BTN_MODE, bf_new & HOME ? 1 : 0);
       if (A & bf_changed)
-        libevdev_uinput_write_event(controller, EV_KEY, BTN_SOUTH, bf_new & A ? 1 : 0);
+        batch.write(EV_KEY, BTN_SOUTH, bf_new & A ? 1 : 0);
       if (B & bf_changed)
-        libevdev_uinput_write_event(controller, EV_KEY, BTN_EAST, bf_new & B ? 1 : 0);
+        batch.write(EV_KEY, BTN_EAST, bf_new & B ? 1 : 0);
       if (X & bf_changed)
-        libevdev_uinput_write_event(controller, EV_KEY, BTN_WEST, bf_new & X ? 1 : 0);
+        batch.write(EV_KEY, BTN_WEST, bf_new & X ? 1 : 0);
       if (Y & bf_changed)
-        libevdev_uinput_write_event(controller, EV_KEY, BTN_NORTH, bf_new & Y ? 1 : 0);
+        batch.write(EV_KEY, BTN_NORTH, bf_new & Y ? 1 : 0);
     }
 
-    libevdev_uinput_write_event(controller, EV_SYN, SYN_REPORT, 0);
+    batch.write(EV_SYN, SYN_REPORT, 0);
   }
   this->_state->currently_pressed_btns = bf_new;
 }
 
 void PS5Joypad::set_stick(Joypad::STICK_POSITION stick_type, short x, short y) {
   if (auto controller = this->_state->joy.get()) {
+    EventBatch batch(controller);
     if (stick_type == LS) {
-      libevdev_uinput_write_event(controller, EV_ABS, ABS_X, x);
-      libevdev_uinput_write_event(controller, EV_ABS, ABS_Y, -y);
+      batch.write(EV_ABS, ABS_X, x);
+      batch.write(EV_ABS, ABS_Y, -y);
     } else {
-      libevdev_uinput_write_event(controller, EV_ABS, ABS_RX, x);
-      libevdev_uinput_write_event(controller, EV_ABS, ABS_RY, -y);
+      batch.write(EV_ABS, ABS_RX, x);
+      batch.write(EV_ABS, ABS_RY, -y);
     }
 
-    libevdev_uinput_write_event(controller, EV_SYN, SYN_REPORT, 0);
+    batch.write(EV_SYN, SYN_REPORT, 0);
   }
 }
 
 void PS5Joypad::set_triggers(int16_t left, int16_t right) {
   if (auto controller = this->_state->joy.get()) {
+    EventBatch batch(controller);
     if (left > 0) {
-      libevdev_uinput_write_event(controller, EV_ABS, ABS_Z, left);
+      batch.write(EV_ABS, ABS_Z, left);
     } else {
-      libevdev_uinput_write_event(controller, EV_ABS, ABS_Z, left);
+      batch.write(EV_ABS, ABS_Z, left);
     }
 
     if (right > 0) {
-      libevdev_uinput_write_event(controller, EV_ABS, ABS_RZ, right);
+      batch.write(EV_ABS, ABS_RZ, right);
     } else {
-      libevdev_uinput_write_event(controller, EV_ABS, ABS_RZ, right);
+      batch.write(EV_ABS, ABS_RZ, right);
     }
 
-    libevdev_uinput_write_event(controller, EV_SYN, SYN_REPORT, 0);
+    batch.write(EV_SYN, SYN_REPORT, 0);
   }
 }
 
@@ -199,5 +197,6 @@ void PS5Joypad::set_motion(MOTION_TYPE type, float x, float y, float z) {}
 void PS5Joypad::set_battery(BATTERY_STATE state, int percentage) {}
 void PS5Joypad::set_on_led(const std::function<void(int r, int g, int b)> &callback) {}
 void PS5Joypad::set_on_trigger_effect(const std::function<void(const TriggerEffect &)> &callback) {}
+void PS5Joypad::set_report_rate(std::chrono::microseconds min_interval, std::chrono::milliseconds keep_alive) {}
 
 } // namespace inputtino
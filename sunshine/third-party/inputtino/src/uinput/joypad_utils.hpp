@@ -6,19 +6,19 @@
 #include <filesystem>
 #include <inputtino/input.hpp>
 #include <inputtino/protected_types.hpp>
+#include <inputtino/reactor.hpp>
 #include <iostream>
 #include <linux/input.h>
 #include <linux/uinput.h>
+#include <map>
 #include <optional>
-#include <poll.h>
-#include <thread>
 
 namespace inputtino {
 
 using namespace std::chrono_literals;
 
 constexpr long MAX_GAIN = 0xFFFF;
-constexpr int RUMBLE_POLL_TIMEOUT = 500; // ms
+constexpr auto RUMBLE_POLL_TIMEOUT = 500ms;
 
 /**
  * Joypads will also have one `/dev/input/js*` device as child, we want to expose that as well
@@ -146,34 +146,19 @@ static ActiveRumbleEffect create_rumble_effect(const ff_effect &effect) {
  *    - later on when the rumble has been activated you'll receive an EV_FF in your /dev/input/event**
  *      where the value is the request ID
  *   You can test the virtual devices that we create by simply using the utility `fftest`
+ *
+ * The listener is called by the shared Reactor thread when the uinput fd is readable, and every RUMBLE_POLL_TIMEOUT
+ * otherwise so that the rumble is updated when effects start or stop.
  */
-static void event_listener(const std::shared_ptr<BaseJoypadState> &state) {
-  std::this_thread::sleep_for(100ms); // We have to sleep in order to be able to read from the newly created device
-
-  auto uinput_fd = libevdev_uinput_get_fd(state->joy.get());
-  if (uinput_fd < 0) {
-    std::cerr << "Unable to open uinput device, additional events will be disabled.";
-    return;
-  }
-
-  // We have to add 0_NONBLOCK to the flags in order to be able to read the events
-  int flags = fcntl(uinput_fd, F_GETFL, 0);
-  fcntl(uinput_fd, F_SETFL, flags | O_NONBLOCK);
-
-  /* Local copy of all the uploaded ff effects */
-  std::map<int, ActiveRumbleEffect> ff_effects = {};
-  std::pair<std::uint32_t, std::uint32_t> prev_rumble = {0, 0};
-
-  /* This can only be set globally when receiving FF_GAIN */
-  unsigned int current_gain = MAX_GAIN;
-
-  std::array<pollfd, 1> pfds = {pollfd{.fd = uinput_fd, .events = POLLIN}};
-  int poll_rs = 0;
-
-  while (!state->stop_listening_events) {
-    poll_rs = poll(pfds.data(), pfds.size(), RUMBLE_POLL_TIMEOUT);
-    if (poll_rs < 0) {
-      std::cerr << "Failed polling uinput fd; ret=" << strerror(errno);
+class EventListener {
+public:
+  EventListener(std::shared_ptr<BaseJoypadState> state, int uinput_fd)
+      : state(std::move(state)), uinput_fd(uinput_fd) {}
+
+  void operator()(std::uint32_t ready_events) {
+    if (ready_events & (EPOLLHUP | EPOLLERR)) {
+      std::cerr << "Failed polling uinput fd, additional events will be disabled.";
+      Reactor::get().remove(uinput_fd);
       return;
     }
 
@@ -241,6 +226,47 @@ static void event_listener(const std::shared_ptr<BaseJoypadState> &state) {
       }
     }
   }
+
+private:
+  std::shared_ptr<BaseJoypadState> state;
+  int uinput_fd;
+
+  /* Local copy of all the uploaded ff effects */
+  std::map<int, ActiveRumbleEffect> ff_effects = {};
+  std::pair<std::uint32_t, std::uint32_t> prev_rumble = {0, 0};
+
+  /* This can only be set globally when receiving FF_GAIN */
+  unsigned int current_gain = MAX_GAIN;
+};
+
+static void start_event_listener(const std::shared_ptr<BaseJoypadState> &state) {
+  auto uinput_fd = libevdev_uinput_get_fd(state->joy.get());
+  if (uinput_fd < 0) {
+    std::cerr << "Unable to open uinput device, additional events will be disabled.";
+    return;
+  }
+
+  // We have to add 0_NONBLOCK to the flags in order to be able to read the events
+  int flags = fcntl(uinput_fd, F_GETFL, 0);
+  fcntl(uinput_fd, F_SETFL, flags | O_NONBLOCK);
+
+  auto listening = Reactor::get().add(uinput_fd, EventListener(state, uinput_fd), RUMBLE_POLL_TIMEOUT);
+  if (!listening) {
+    std::cerr << "Unable to listen to uinput device, additional events will be disabled: "
+              << listening.getErrorMessage();
+    return;
+  }
+  state->events_fd = uinput_fd;
+}
+
+/**
+ * Waits for a running event listener to return, it won't be called anymore
+ */
+static void stop_event_listener(const std::shared_ptr<BaseJoypadState> &state) {
+  if (state->events_fd >= 0) {
+    Reactor::get().remove(state->events_fd);
+    state->events_fd = -1;
+  }
 }
 
 } // namespace inputtino
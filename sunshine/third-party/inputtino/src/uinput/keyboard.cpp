@@ -4,7 +4,7 @@
 #include <cstring>
 #include <inputtino/protected_types.hpp>
 #include <inputtino/keyboard.hpp>
-#include <thread>
+#include <inputtino/reactor.hpp>
 
 namespace inputtino {
 
@@ -46,14 +46,15 @@ Result<libevdev_uinput_ptr> create_keyboard(const DeviceDefinition &device) {
   return libevdev_uinput_ptr{uidev, ::libevdev_uinput_destroy};
 }
 
-static std::optional<keyboard::KEY_MAP> press_btn(libevdev_uinput *kb, short key_code) {
+static std::optional<keyboard::KEY_MAP> press_btn(libevdev_uinput *kb, ReportFrame *frame, short key_code) {
   auto search_key = keyboard::key_mappings.find(key_code);
   if (search_key != keyboard::key_mappings.end()) {
     auto mapped_key = search_key->second;
 
-    libevdev_uinput_write_event(kb, EV_MSC, MSC_SCAN, mapped_key.scan_code);
-    libevdev_uinput_write_event(kb, EV_KEY, mapped_key.linux_code, 1);
-    libevdev_uinput_write_event(kb, EV_SYN, SYN_REPORT, 0);
+    write_report(kb, frame, [&](auto &batch) {
+      batch.write(EV_MSC, MSC_SCAN, mapped_key.scan_code);
+      batch.write(EV_KEY, mapped_key.linux_code, 1);
+    });
     return mapped_key;
   }
   return {};
@@ -63,9 +64,15 @@ Keyboard::Keyboard() : _state(std::make_shared<KeyboardState>()) {}
 
 Keyboard::~Keyboard() {
   if (_state) {
-    _state->stop_repeat_thread = true;
-    if (_state->repeat_press_t.joinable()) {
-      _state->repeat_press_t.join();
+    Reactor::TimerId repeat_timer;
+    {
+      std::lock_guard lock(_state->keys_mutex);
+      repeat_timer = _state->repeat_timer;
+      _state->repeat_timer = 0;
+    }
+    // Outside of keys_mutex, since this waits for a running repeat to return
+    if (repeat_timer != 0) {
+      Reactor::get().remove_timer(repeat_timer);
     }
   }
 }
@@ -75,28 +82,42 @@ Result<Keyboard> Keyboard::create(const DeviceDefinition &device, int millis_rep
   if (kb_el) {
     Keyboard kb;
     kb._state->kb = std::move(*kb_el);
-    auto repeat_thread = std::thread([state = kb._state, millis_repress_key]() {
-      while (!state->stop_repeat_thread) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(millis_repress_key));
-        for (auto key : state->cur_press_keys) {
-          if (auto keyboard = state->kb.get()) {
-            press_btn(keyboard, key);
-          }
-        }
-      }
-    });
-    kb._state->repeat_press_t = std::move(repeat_thread);
-    kb._state->repeat_press_t.detach();
+    kb._state->repeat_interval = std::chrono::milliseconds(millis_repress_key);
     return kb;
   } else {
     return Error(kb_el.getErrorMessage());
   }
 }
 
+/**
+ * Re-presses the held keys, on the reactor thread, for as long as there are any
+ */
+static std::optional<Reactor::Clock::time_point> repeat_keys(KeyboardState &state) {
+  std::lock_guard lock(state.keys_mutex);
+  auto keyboard = state.kb.get();
+  if (state.cur_press_keys.empty() || !keyboard) {
+    state.repeat_timer = 0;
+    return std::nullopt;
+  }
+  for (auto key : state.cur_press_keys) {
+    press_btn(keyboard, nullptr, key);
+  }
+  return Reactor::Clock::now() + state.repeat_interval;
+}
+
 void Keyboard::press(short key_code) {
   if (auto keyboard = _state->kb.get()) {
-    if (auto key = press_btn(keyboard, key_code)) {
+    if (auto key = press_btn(keyboard, _state->frame.get(), key_code)) {
+      std::lock_guard lock(_state->keys_mutex);
       _state->cur_press_keys.push_back(key_code);
+      // The repeat timer only runs while keys are held
+      if (_state->repeat_timer == 0) {
+        auto timer = Reactor::get().add_timer(Reactor::Clock::now() + _state->repeat_interval,
+                                              [state = _state]() { return repeat_keys(*state); });
+        if (timer) {
+          _state->repeat_timer = *timer;
+        }
+      }
     }
   }
 }
@@ -106,15 +127,30 @@ void Keyboard::release(short key_code) {
   if (search_key != keyboard::key_mappings.end()) {
     if (auto keyboard = _state->kb.get()) {
       auto mapped_key = search_key->second;
-      this->_state->cur_press_keys.erase(
-          std::remove(this->_state->cur_press_keys.begin(), this->_state->cur_press_keys.end(), key_code),
-          this->_state->cur_press_keys.end());
+      {
+        // The repeat timer stops by itself once no key is held
+        std::lock_guard lock(_state->keys_mutex);
+        this->_state->cur_press_keys.erase(
+            std::remove(this->_state->cur_press_keys.begin(), this->_state->cur_press_keys.end(), key_code),
+            this->_state->cur_press_keys.end());
+      }
 
-      libevdev_uinput_write_event(keyboard, EV_MSC, MSC_SCAN, mapped_key.scan_code);
-      libevdev_uinput_write_event(keyboard, EV_KEY, mapped_key.linux_code, 0);
-      libevdev_uinput_write_event(keyboard, EV_SYN, SYN_REPORT, 0);
+      write_report(keyboard, _state->frame.get(), [&](auto &batch) {
+        batch.write(EV_MSC, MSC_SCAN, mapped_key.scan_code);
+        batch.write(EV_KEY, mapped_key.linux_code, 0);
+      });
     }
   }
 }
 
+void Keyboard::begin_frame() {
+  if (auto keyboard = _state->kb.get()) {
+    _state->frame = std::make_unique<ReportFrame>(keyboard);
+  }
+}
+
+void Keyboard::commit() {
+  _state->frame.reset();
+}
+
 } // namespace inputtino
\ No newline at end of file
@@ -125,22 +125,20 @@ Result<Mouse> Mouse::create(const DeviceDefinition &device) {
 }
 
 void Mouse::move(int delta_x, int delta_y) {
-  if (auto mouse = _state->mouse_rel.get()) {
-    libevdev_uinput_write_event(mouse, EV_REL, REL_X, delta_x);
-    libevdev_uinput_write_event(mouse, EV_REL, REL_Y, delta_y);
-    libevdev_uinput_write_event(mouse, EV_SYN, SYN_REPORT, 0);
-  }
+  write_report(_state->mouse_rel.get(), _state->rel_frame.get(), [&](auto &batch) {
+    batch.write(EV_REL, REL_X, delta_x);
+    batch.write(EV_REL, REL_Y, delta_y);
+  });
 }
 
 void Mouse::move_abs(int x, int y, int screen_width, int screen_height) {
   int scaled_x = (int)std::lround((ABS_MAX_WIDTH / (double)screen_width) * x);
   int scaled_y = (int)std::lround((ABS_MAX_HEIGHT / (double)screen_height) * y);
 
-  if (auto mouse = _state->mouse_abs.get()) {
-    libevdev_uinput_write_event(mouse, EV_ABS, ABS_X, scaled_x);
-    libevdev_uinput_write_event(mouse, EV_ABS, ABS_Y, scaled_y);
-    libevdev_uinput_write_event(mouse, EV_SYN, SYN_REPORT, 0);
-  }
+  write_report(_state->mouse_abs.get(), _state->abs_frame.get(), [&](auto &batch) {
+    batch.write(EV_ABS, ABS_X, scaled_x);
+    batch.write(EV_ABS, ABS_Y, scaled_y);
+  });
 }
 
 static std::pair<int, int> btn_to_uinput(Mouse::MOUSE_BUTTON button) {
@@ -159,41 +157,52 @@ static std::pair<int, int> btn_to_uinput(Mouse::MOUSE_BUTTON button) {
 }
 
 void Mouse::press(Mouse::MOUSE_BUTTON button) {
-  if (auto mouse = _state->mouse_rel.get()) {
-    auto [btn_type, scan_code] = btn_to_uinput(button);
-    libevdev_uinput_write_event(mouse, EV_MSC, MSC_SCAN, scan_code);
-    libevdev_uinput_write_event(mouse, EV_KEY, btn_type, 1);
-    libevdev_uinput_write_event(mouse, EV_SYN, SYN_REPORT, 0);
-  }
+  // Structured bindings can't be captured by a lambda before C++20
+  auto btn = btn_to_uinput(button);
+  write_report(_state->mouse_rel.get(), _state->rel_frame.get(), [&](auto &batch) {
+    batch.write(EV_MSC, MSC_SCAN, btn.second);
+    batch.write(EV_KEY, btn.first, 1);
+  });
 }
 
 void Mouse::release(Mouse::MOUSE_BUTTON button) {
-  if (auto mouse = _state->mouse_rel.get()) {
-    auto [btn_type, scan_code] = btn_to_uinput(button);
-    libevdev_uinput_write_event(mouse, EV_MSC, MSC_SCAN, scan_code);
-    libevdev_uinput_write_event(mouse, EV_KEY, btn_type, 0);
-    libevdev_uinput_write_event(mouse, EV_SYN, SYN_REPORT, 0);
-  }
+  auto btn = btn_to_uinput(button);
+  write_report(_state->mouse_rel.get(), _state->rel_frame.get(), [&](auto &batch) {
+    batch.write(EV_MSC, MSC_SCAN, btn.second);
+    batch.write(EV_KEY, btn.first, 0);
+  });
 }
 
 void Mouse::horizontal_scroll(int high_res_distance) {
   int distance = high_res_distance / 120;
 
-  if (auto mouse = _state->mouse_rel.get()) {
-    libevdev_uinput_write_event(mouse, EV_REL, REL_HWHEEL, distance);
-    libevdev_uinput_write_event(mouse, EV_REL, REL_HWHEEL_HI_RES, high_res_distance);
-    libevdev_uinput_write_event(mouse, EV_SYN, SYN_REPORT, 0);
-  }
+  write_report(_state->mouse_rel.get(), _state->rel_frame.get(), [&](auto &batch) {
+    batch.write(EV_REL, REL_HWHEEL, distance);
+    batch.write(EV_REL, REL_HWHEEL_HI_RES, high_res_distance);
+  });
 }
 
 void Mouse::vertical_scroll(int high_res_distance) {
   int distance = high_res_distance / 120;
 
+  write_report(_state->mouse_rel.get(), _state->rel_frame.get(), [&](auto &batch) {
+    batch.write(EV_REL, REL_WHEEL, distance);
+    batch.write(EV_REL, REL_WHEEL_HI_RES, high_res_distance);
+  });
+}
+
+void Mouse::begin_frame() {
   if (auto mouse = _state->mouse_rel.get()) {
-    libevdev_uinput_write_event(mouse, EV_REL, REL_WHEEL, distance);
-    libevdev_uinput_write_event(mouse, EV_REL, REL_WHEEL_HI_RES, high_res_distance);
-    libevdev_uinput_write_event(mouse, EV_SYN, SYN_REPORT, 0);
+    _state->rel_frame = std::make_unique<ReportFrame>(mouse);
   }
+  if (auto mouse = _state->mouse_abs.get()) {
+    _state->abs_frame = std::make_unique<ReportFrame>(mouse);
+  }
+}
+
+void Mouse::commit() {
+  _state->rel_frame.reset();
+  _state->abs_frame.reset();
 }
 
 } // namespace inputtino
@@ -112,50 +112,52 @@ static inline float deg2rad(float degree) {
 void PenTablet::place_tool(
     PenTablet::TOOL_TYPE tool_type, float x, float y, float pressure, float distance, float tilt_x, float tilt_y) {
   if (auto tablet = _state->pen_tablet.get()) {
+    EventBatch batch(tablet);
     if (tool_type != PenTablet::SAME_AS_BEFORE && tool_type != _state->last_tool) {
-      libevdev_uinput_write_event(tablet, EV_KEY, tool_to_linux.at(tool_type), 1);
+      batch.write(EV_KEY, tool_to_linux.at(tool_type), 1);
 
       if (_state->last_tool != PenTablet::SAME_AS_BEFORE)
-        libevdev_uinput_write_event(tablet, EV_KEY, tool_to_linux.at(_state->last_tool), 0);
+        batch.write(EV_KEY, tool_to_linux.at(_state->last_tool), 0);
 
       _state->last_tool = tool_type;
     }
 
     int scaled_x = (int)std::lround(MAX_X * x);
     int scaled_y = (int)std::lround(MAX_Y * y);
-    libevdev_uinput_write_event(tablet, EV_ABS, ABS_X, scaled_x);
-    libevdev_uinput_write_event(tablet, EV_ABS, ABS_Y, scaled_y);
+    batch.write(EV_ABS, ABS_X, scaled_x);
+    batch.write(EV_ABS, ABS_Y, scaled_y);
 
     if (pressure >= 0) {
       int scaled_pressure = (int)std::lround(pressure * PRESSURE_MAX);
-      libevdev_uinput_write_event(tablet, EV_ABS, ABS_PRESSURE, scaled_pressure);
+      batch.write(EV_ABS, ABS_PRESSURE, scaled_pressure);
       // when there's pressure, the tool must be touching the tablet
-      libevdev_uinput_write_event(tablet, EV_ABS, ABS_DISTANCE, 0);
+      batch.write(EV_ABS, ABS_DISTANCE, 0);
     }
 
     if (distance >= 0) {
       int scaled_distance = (int)std::lround(distance * DISTANCE_MAX);
-      libevdev_uinput_write_event(tablet, EV_ABS, ABS_DISTANCE, scaled_distance);
+      batch.write(EV_ABS, ABS_DISTANCE, scaled_distance);
       // when there's distance, the tool can't be touching the tablet
-      libevdev_uinput_write_event(tablet, EV_ABS, ABS_PRESSURE, 0);
+      batch.write(EV_ABS, ABS_PRESSURE, 0);
     }
 
     auto scaled_tilt_x = std::clamp(tilt_x, -90.0f, 90.0f);
     scaled_tilt_x = deg2rad(scaled_tilt_x * RESOLUTION);
-    libevdev_uinput_write_event(tablet, EV_ABS, ABS_TILT_X, (int)std::lround(scaled_tilt_x));
+    batch.write(EV_ABS, ABS_TILT_X, (int)std::lround(scaled_tilt_x));
 
     auto scaled_tilt_y = std::clamp(tilt_y, -90.0f, 90.0f);
     scaled_tilt_y = deg2rad(scaled_tilt_y * RESOLUTION);
-    libevdev_uinput_write_event(tablet, EV_ABS, ABS_TILT_Y, (int)std::lround(scaled_tilt_y));
+    batch.write(EV_ABS, ABS_TILT_Y, (int)std::lround(scaled_tilt_y));
 
-    libevdev_uinput_write_event(tablet, EV_SYN, SYN_REPORT, 0);
+    batch.write(EV_SYN, SYN_REPORT, 0);
   }
 }
 
 void PenTablet::set_btn(PenTablet::BTN_TYPE btn, bool pressed) {
   if (auto tablet = _state->pen_tablet.get()) {
-    libevdev_uinput_write_event(tablet, EV_KEY, btn_to_linux.at(btn), pressed ? 1 : 0);
-    libevdev_uinput_write_event(tablet, EV_SYN, SYN_REPORT, 0);
+    EventBatch batch(tablet);
+    batch.write(EV_KEY, btn_to_linux.at(btn), pressed ? 1 : 0);
+    batch.write(EV_SYN, SYN_REPORT, 0);
   }
 }
 
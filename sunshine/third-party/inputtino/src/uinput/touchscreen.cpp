@@ -91,50 +91,87 @@ Result<TouchScreen> TouchScreen::create(const DeviceDefinition &device) {
   }
 }
 
-void TouchScreen::place_finger(int finger_nr, float x, float y, float pressure, int orientation) {
-  if (auto ts = this->_state->touch_screen.get()) {
-    int scaled_x = (int)std::lround(TOUCH_MAX_X * x);
-    int scaled_y = (int)std::lround(TOUCH_MAX_Y * y);
-    int scaled_orientation = std::clamp(orientation, -90, 90);
-
-    if (_state->fingers.find(finger_nr) == _state->fingers.end()) {
-      // Wow, a wild finger appeared!
-      auto finger_slot = _state->fingers.size() + 1;
-      _state->fingers[finger_nr] = finger_slot;
-      libevdev_uinput_write_event(ts, EV_ABS, ABS_MT_SLOT, finger_slot);
-      libevdev_uinput_write_event(ts, EV_ABS, ABS_MT_TRACKING_ID, finger_slot);
-    } else {
-      // I already know this finger, let's check the slot
-      auto finger_slot = _state->fingers[finger_nr];
-      if (_state->current_slot != finger_slot) {
-        libevdev_uinput_write_event(ts, EV_ABS, ABS_MT_SLOT, finger_slot);
-        _state->current_slot = finger_slot;
-      }
+template <typename Batch>
+static void write_finger(TouchScreenState &state,
+                         Batch &batch,
+                         int finger_nr,
+                         float x,
+                         float y,
+                         float pressure,
+                         int orientation) {
+  int scaled_x = (int)std::lround(TOUCH_MAX_X * x);
+  int scaled_y = (int)std::lround(TOUCH_MAX_Y * y);
+  int scaled_orientation = std::clamp(orientation, -90, 90);
+
+  if (state.fingers.find(finger_nr) == state.fingers.end()) {
+    // Wow, a wild finger appeared!
+    auto finger_slot = state.fingers.size() + 1;
+    state.fingers[finger_nr] = finger_slot;
+    batch.write(EV_ABS, ABS_MT_SLOT, finger_slot);
+    batch.write(EV_ABS, ABS_MT_TRACKING_ID, finger_slot);
+  } else {
+    // I already know this finger, let's check the slot
+    auto finger_slot = state.fingers[finger_nr];
+    if (state.current_slot != finger_slot) {
+      batch.write(EV_ABS, ABS_MT_SLOT, finger_slot);
+      state.current_slot = finger_slot;
     }
+  }
+
+  batch.write(EV_ABS, ABS_X, scaled_x);
+  batch.write(EV_ABS, ABS_MT_POSITION_X, scaled_x);
+  batch.write(EV_ABS, ABS_Y, scaled_y);
+  batch.write(EV_ABS, ABS_MT_POSITION_Y, scaled_y);
+  batch.write(EV_ABS, ABS_PRESSURE, (int)std::lround(pressure * PRESSURE_MAX));
+  batch.write(EV_ABS, ABS_MT_PRESSURE, (int)std::lround(pressure * PRESSURE_MAX));
+  batch.write(EV_ABS, ABS_MT_ORIENTATION, scaled_orientation);
+}
 
-    libevdev_uinput_write_event(ts, EV_ABS, ABS_X, scaled_x);
-    libevdev_uinput_write_event(ts, EV_ABS, ABS_MT_POSITION_X, scaled_x);
-    libevdev_uinput_write_event(ts, EV_ABS, ABS_Y, scaled_y);
-    libevdev_uinput_write_event(ts, EV_ABS, ABS_MT_POSITION_Y, scaled_y);
-    libevdev_uinput_write_event(ts, EV_ABS, ABS_PRESSURE, (int)std::lround(pressure * PRESSURE_MAX));
-    libevdev_uinput_write_event(ts, EV_ABS, ABS_MT_PRESSURE, (int)std::lround(pressure * PRESSURE_MAX));
-    libevdev_uinput_write_event(ts, EV_ABS, ABS_MT_ORIENTATION, scaled_orientation);
+template <typename Batch> static void write_release_finger(TouchScreenState &state, Batch &batch, int finger_nr) {
+  auto finger_slot = state.fingers[finger_nr];
+  if (state.current_slot != finger_slot) {
+    batch.write(EV_ABS, ABS_MT_SLOT, finger_slot);
+    state.current_slot = -1;
+  }
+  state.fingers.erase(finger_nr);
+  batch.write(EV_ABS, ABS_MT_TRACKING_ID, -1);
+}
 
-    libevdev_uinput_write_event(ts, EV_SYN, SYN_REPORT, 0);
+void TouchScreen::place_finger(int finger_nr, float x, float y, float pressure, int orientation) {
+  if (auto ts = this->_state->touch_screen.get()) {
+    EventBatch batch(ts);
+    write_finger(*_state, batch, finger_nr, x, y, pressure, orientation);
+    batch.write(EV_SYN, SYN_REPORT, 0);
   }
 }
 
 void TouchScreen::release_finger(int finger_nr) {
+  if (auto frame = _state->frame.get()) {
+    write_release_finger(*_state, *frame, finger_nr);
+  } else if (auto ts = this->_state->touch_screen.get()) {
+    EventBatch batch(ts);
+    write_release_finger(*_state, batch, finger_nr);
+    batch.write(EV_SYN, SYN_REPORT, 0);
+  }
+}
+
+void TouchScreen::begin_frame() {
   if (auto ts = this->_state->touch_screen.get()) {
-    auto finger_slot = _state->fingers[finger_nr];
-    if (_state->current_slot != finger_slot) {
-      libevdev_uinput_write_event(ts, EV_ABS, ABS_MT_SLOT, finger_slot);
-      _state->current_slot = -1;
-    }
-    _state->fingers.erase(finger_nr);
-    libevdev_uinput_write_event(ts, EV_ABS, ABS_MT_TRACKING_ID, -1);
+    _state->frame = std::make_unique<MultiTouchFrame>(ts);
+  }
+}
+
+void TouchScreen::update_finger(int finger_nr, float x, float y, float pressure, int orientation) {
+  if (auto frame = _state->frame.get()) {
+    write_finger(*_state, *frame, finger_nr, x, y, pressure, orientation);
+  } else {
+    place_finger(finger_nr, x, y, pressure, orientation);
+  }
+}
 
-    libevdev_uinput_write_event(ts, EV_SYN, SYN_REPORT, 0);
+void TouchScreen::commit() {
+  if (auto frame = std::move(_state->frame)) {
+    frame->write(EV_SYN, SYN_REPORT, 0);
   }
 }
 
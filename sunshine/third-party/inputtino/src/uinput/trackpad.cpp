@@ -97,95 +97,136 @@ Result<Trackpad> Trackpad::create(const DeviceDefinition &device) {
   }
 }
 
-void Trackpad::place_finger(int finger_nr, float x, float y, float pressure, int orientation) {
-  if (auto touchpad = this->_state->trackpad.get()) {
-    int scaled_x = (int)std::lround(TOUCH_MAX_X * x);
-    int scaled_y = (int)std::lround(TOUCH_MAX_Y * y);
-    int scaled_orientation = std::clamp(orientation, -90, 90);
-
-    if (_state->fingers.find(finger_nr) == _state->fingers.end()) {
-      // Wow, a wild finger appeared!
-      auto finger_slot = _state->fingers.size() + 1;
-      _state->fingers[finger_nr] = finger_slot;
-      libevdev_uinput_write_event(touchpad, EV_ABS, ABS_MT_SLOT, finger_slot);
-      libevdev_uinput_write_event(touchpad, EV_ABS, ABS_MT_TRACKING_ID, finger_slot);
-      auto nr_fingers = _state->fingers.size();
-      { // Update number of fingers pressed
-        if (nr_fingers == 1) {
-          libevdev_uinput_write_event(touchpad, EV_KEY, BTN_TOOL_FINGER, 1);
-          libevdev_uinput_write_event(touchpad, EV_KEY, BTN_TOUCH, 1);
-        } else if (nr_fingers == 2) {
-          libevdev_uinput_write_event(touchpad, EV_KEY, BTN_TOOL_FINGER, 0);
-          libevdev_uinput_write_event(touchpad, EV_KEY, BTN_TOOL_DOUBLETAP, 1);
-        } else if (nr_fingers == 3) {
-          libevdev_uinput_write_event(touchpad, EV_KEY, BTN_TOOL_DOUBLETAP, 0);
-          libevdev_uinput_write_event(touchpad, EV_KEY, BTN_TOOL_TRIPLETAP, 1);
-        } else if (nr_fingers == 4) {
-          libevdev_uinput_write_event(touchpad, EV_KEY, BTN_TOOL_TRIPLETAP, 0);
-          libevdev_uinput_write_event(touchpad, EV_KEY, BTN_TOOL_QUADTAP, 1);
-        } else if (nr_fingers == 5) {
-          libevdev_uinput_write_event(touchpad, EV_KEY, BTN_TOOL_QUADTAP, 0);
-          libevdev_uinput_write_event(touchpad, EV_KEY, BTN_TOOL_QUINTTAP, 1);
-        }
-      }
-    } else {
-      // I already know this finger, let's check the slot
-      auto finger_slot = _state->fingers[finger_nr];
-      if (_state->current_slot != finger_slot) {
-        libevdev_uinput_write_event(touchpad, EV_ABS, ABS_MT_SLOT, finger_slot);
-        _state->current_slot = finger_slot;
-      }
+/**
+ * The BTN_TOOL_* key that libinput expects to be pressed for the given number of fingers
+ */
+static int finger_tool(std::size_t nr_fingers) {
+  switch (nr_fingers) {
+  case 0:
+    return -1;
+  case 1:
+    return BTN_TOOL_FINGER;
+  case 2:
+    return BTN_TOOL_DOUBLETAP;
+  case 3:
+    return BTN_TOOL_TRIPLETAP;
+  case 4:
+    return BTN_TOOL_QUADTAP;
+  default:
+    return BTN_TOOL_QUINTTAP;
+  }
+}
+
+/**
+ * Update number of fingers pressed, going from prev_fingers to nr_fingers
+ */
+template <typename Batch> static void write_finger_tool(Batch &batch, std::size_t prev_fingers, std::size_t nr_fingers) {
+  auto prev_tool = finger_tool(prev_fingers);
+  auto tool = finger_tool(nr_fingers);
+  if (prev_tool != tool) {
+    if (prev_tool >= 0) {
+      batch.write(EV_KEY, prev_tool, 0);
+    }
+    if (tool >= 0) {
+      batch.write(EV_KEY, tool, 1);
     }
+  }
+  if ((prev_fingers == 0) != (nr_fingers == 0)) {
+    batch.write(EV_KEY, BTN_TOUCH, nr_fingers > 0 ? 1 : 0);
+  }
+}
+
+template <typename Batch>
+static void
+write_finger(TrackpadState &state, Batch &batch, int finger_nr, float x, float y, float pressure, int orientation) {
+  int scaled_x = (int)std::lround(TOUCH_MAX_X * x);
+  int scaled_y = (int)std::lround(TOUCH_MAX_Y * y);
+  int scaled_orientation = std::clamp(orientation, -90, 90);
+
+  if (state.fingers.find(finger_nr) == state.fingers.end()) {
+    // Wow, a wild finger appeared!
+    auto finger_slot = state.fingers.size() + 1;
+    state.fingers[finger_nr] = finger_slot;
+    batch.write(EV_ABS, ABS_MT_SLOT, finger_slot);
+    batch.write(EV_ABS, ABS_MT_TRACKING_ID, finger_slot);
+  } else {
+    // I already know this finger, let's check the slot
+    auto finger_slot = state.fingers[finger_nr];
+    if (state.current_slot != finger_slot) {
+      batch.write(EV_ABS, ABS_MT_SLOT, finger_slot);
+      state.current_slot = finger_slot;
+    }
+  }
+
+  batch.write(EV_ABS, ABS_X, scaled_x);
+  batch.write(EV_ABS, ABS_MT_POSITION_X, scaled_x);
+  batch.write(EV_ABS, ABS_Y, scaled_y);
+  batch.write(EV_ABS, ABS_MT_POSITION_Y, scaled_y);
+  batch.write(EV_ABS, ABS_PRESSURE, (int)std::lround(pressure * PRESSURE_MAX));
+  batch.write(EV_ABS, ABS_MT_PRESSURE, (int)std::lround(pressure * PRESSURE_MAX));
+  batch.write(EV_ABS, ABS_MT_ORIENTATION, scaled_orientation);
+}
 
-    libevdev_uinput_write_event(touchpad, EV_ABS, ABS_X, scaled_x);
-    libevdev_uinput_write_event(touchpad, EV_ABS, ABS_MT_POSITION_X, scaled_x);
-    libevdev_uinput_write_event(touchpad, EV_ABS, ABS_Y, scaled_y);
-    libevdev_uinput_write_event(touchpad, EV_ABS, ABS_MT_POSITION_Y, scaled_y);
-    libevdev_uinput_write_event(touchpad, EV_ABS, ABS_PRESSURE, (int)std::lround(pressure * PRESSURE_MAX));
-    libevdev_uinput_write_event(touchpad, EV_ABS, ABS_MT_PRESSURE, (int)std::lround(pressure * PRESSURE_MAX));
-    libevdev_uinput_write_event(touchpad, EV_ABS, ABS_MT_ORIENTATION, scaled_orientation);
+template <typename Batch> static void write_release_finger(TrackpadState &state, Batch &batch, int finger_nr) {
+  auto finger_slot = state.fingers[finger_nr];
+  if (state.current_slot != finger_slot) {
+    batch.write(EV_ABS, ABS_MT_SLOT, finger_slot);
+    state.current_slot = -1;
+  }
+  state.fingers.erase(finger_nr);
+  batch.write(EV_ABS, ABS_MT_TRACKING_ID, -1);
+}
 
-    libevdev_uinput_write_event(touchpad, EV_SYN, SYN_REPORT, 0);
+void Trackpad::place_finger(int finger_nr, float x, float y, float pressure, int orientation) {
+  if (auto touchpad = this->_state->trackpad.get()) {
+    EventBatch batch(touchpad);
+    auto prev_fingers = _state->fingers.size();
+    write_finger(*_state, batch, finger_nr, x, y, pressure, orientation);
+    write_finger_tool(batch, prev_fingers, _state->fingers.size());
+    batch.write(EV_SYN, SYN_REPORT, 0);
   }
 }
 
 void Trackpad::release_finger(int finger_nr) {
+  if (auto frame = _state->frame.get()) {
+    write_release_finger(*_state, *frame, finger_nr);
+  } else if (auto touchpad = this->_state->trackpad.get()) {
+    EventBatch batch(touchpad);
+    auto prev_fingers = _state->fingers.size();
+    write_release_finger(*_state, batch, finger_nr);
+    write_finger_tool(batch, prev_fingers, _state->fingers.size());
+    batch.write(EV_SYN, SYN_REPORT, 0);
+  }
+}
+
+void Trackpad::begin_frame() {
   if (auto touchpad = this->_state->trackpad.get()) {
-    auto finger_slot = _state->fingers[finger_nr];
-    if (_state->current_slot != finger_slot) {
-      libevdev_uinput_write_event(touchpad, EV_ABS, ABS_MT_SLOT, finger_slot);
-      _state->current_slot = -1;
-    }
-    _state->fingers.erase(finger_nr);
-    libevdev_uinput_write_event(touchpad, EV_ABS, ABS_MT_TRACKING_ID, -1);
-    auto nr_fingers = _state->fingers.size();
-    { // Update number of fingers pressed
-      if (nr_fingers == 0) {
-        libevdev_uinput_write_event(touchpad, EV_KEY, BTN_TOOL_FINGER, 0);
-        libevdev_uinput_write_event(touchpad, EV_KEY, BTN_TOUCH, 0);
-      } else if (nr_fingers == 1) {
-        libevdev_uinput_write_event(touchpad, EV_KEY, BTN_TOOL_FINGER, 1);
-        libevdev_uinput_write_event(touchpad, EV_KEY, BTN_TOOL_DOUBLETAP, 0);
-      } else if (nr_fingers == 2) {
-        libevdev_uinput_write_event(touchpad, EV_KEY, BTN_TOOL_DOUBLETAP, 1);
-        libevdev_uinput_write_event(touchpad, EV_KEY, BTN_TOOL_TRIPLETAP, 0);
-      } else if (nr_fingers == 3) {
-        libevdev_uinput_write_event(touchpad, EV_KEY, BTN_TOOL_TRIPLETAP, 1);
-        libevdev_uinput_write_event(touchpad, EV_KEY, BTN_TOOL_QUADTAP, 0);
-      } else if (nr_fingers == 4) {
-        libevdev_uinput_write_event(touchpad, EV_KEY, BTN_TOOL_QUADTAP, 1);
-        libevdev_uinput_write_event(touchpad, EV_KEY, BTN_TOOL_QUINTTAP, 0);
-      }
-    }
+    _state->frame = std::make_unique<MultiTouchFrame>(touchpad);
+    _state->frame_start_fingers = _state->fingers.size();
+  }
+}
+
+void Trackpad::update_finger(int finger_nr, float x, float y, float pressure, int orientation) {
+  if (auto frame = _state->frame.get()) {
+    write_finger(*_state, *frame, finger_nr, x, y, pressure, orientation);
+  } else {
+    place_finger(finger_nr, x, y, pressure, orientation);
+  }
+}
 
-    libevdev_uinput_write_event(touchpad, EV_SYN, SYN_REPORT, 0);
+void Trackpad::commit() {
+  if (auto frame = std::move(_state->frame)) {
+    // A single BTN_TOOL_* change for all the fingers that appeared or were released during the frame
+    write_finger_tool(*frame, _state->frame_start_fingers, _state->fingers.size());
+    frame->write(EV_SYN, SYN_REPORT, 0);
   }
 }
 
 void Trackpad::set_left_btn(bool pressed) {
   if (auto touchpad = this->_state->trackpad.get()) {
-    libevdev_uinput_write_event(touchpad, EV_KEY, BTN_LEFT, pressed ? 1 : 0);
-    libevdev_uinput_write_event(touchpad, EV_SYN, SYN_REPORT, 0);
+    EventBatch batch(touchpad);
+    batch.write(EV_KEY, BTN_LEFT, pressed ? 1 : 0);
+    batch.write(EV_SYN, SYN_REPORT, 0);
   }
 }
 
@@ -0,0 +1,307 @@
+#include "catch2/catch_all.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <functional>
+#include <inputtino/input.hpp>
+#include <iostream>
+#include <linux/input.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace inputtino;
+using namespace std::chrono_literals;
+
+/**
+ * Reads back the events of a virtual device from its /dev/input/event* nodes, like a compositor or SDL would
+ */
+class EvdevReader {
+public:
+  explicit EvdevReader(const std::vector<std::string> &nodes) {
+    for (const auto &node : nodes) {
+      if (node.find("/event") == std::string::npos) {
+        continue; // ex: /dev/input/js*
+      }
+      auto fd = open(node.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+      if (fd >= 0) {
+        pfds.push_back(pollfd{.fd = fd, .events = POLLIN});
+      } else {
+        std::cerr << "Unable to open " << node << ": " << strerror(errno) << std::endl;
+      }
+    }
+  }
+
+  EvdevReader(const EvdevReader &) = delete;
+  EvdevReader &operator=(const EvdevReader &) = delete;
+
+  ~EvdevReader() {
+    for (auto &pfd : pfds) {
+      close(pfd.fd);
+    }
+  }
+
+  bool is_open() const {
+    return !pfds.empty();
+  }
+
+  /**
+   * Waits for the next SYN_REPORT coming from any node
+   * @returns false on timeout
+   */
+  bool wait_report(std::chrono::milliseconds timeout = 1000ms) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (true) {
+      for (auto &pfd : pfds) {
+        input_event ev{};
+        while (read(pfd.fd, &ev, sizeof(ev)) == sizeof(ev)) {
+          if (ev.type == EV_SYN && ev.code == SYN_DROPPED) {
+            dropped++;
+          } else if (ev.type == EV_SYN && ev.code == SYN_REPORT) {
+            reports++;
+            return true;
+          }
+        }
+      }
+      auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+      if (left.count() <= 0) {
+        return false;
+      }
+      poll(pfds.data(), pfds.size(), static_cast<int>(left.count()));
+    }
+  }
+
+  /**
+   * Reads all the queued events
+   */
+  void drain() {
+    while (wait_report(0ms)) {
+    }
+  }
+
+  std::size_t reports = 0;
+  /* SYN_DROPPED received: the reader couldn't keep up and the kernel dropped events */
+  std::size_t dropped = 0;
+
+private:
+  std::vector<pollfd> pfds;
+};
+
+/**
+ * Waits for the device nodes to be created by udev
+ */
+template <typename Device> static std::vector<std::string> wait_nodes(const Device &device) {
+  auto deadline = std::chrono::steady_clock::now() + 5s;
+  auto nodes = device.get_nodes();
+  while (nodes.empty() && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(50ms);
+    nodes = device.get_nodes();
+  }
+  std::this_thread::sleep_for(100ms); // Give some time to udev to set the permissions
+  return nodes;
+}
+
+/**
+ * @returns the event nodes whose device name contains (or doesn't contain, when excluded) the given text
+ */
+static std::vector<std::string>
+filter_nodes(const std::vector<std::string> &nodes, const std::string &text, bool excluded = false) {
+  std::vector<std::string> result;
+  for (const auto &node : nodes) {
+    auto fd = open(node.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+      continue;
+    }
+    char name[256] = {};
+    ioctl(fd, EVIOCGNAME(sizeof(name)), name);
+    close(fd);
+    if ((std::string(name).find(text) != std::string::npos) != excluded) {
+      result.push_back(node);
+    }
+  }
+  return result;
+}
+
+/**
+ * Sends events as fast as possible for the given time, reading them back on another thread,
+ * and prints the rate at which the reports were sent and received
+ */
+static void sustained_rate(const std::string &name,
+                           const std::vector<std::string> &nodes,
+                           const std::function<void(int)> &send_report,
+                           std::chrono::seconds duration = 1s) {
+  EvdevReader reader(nodes);
+  REQUIRE(reader.is_open());
+
+  std::atomic<bool> sending = true;
+  std::thread read_thread([&]() {
+    while (sending) {
+      reader.wait_report(10ms);
+    }
+    reader.drain();
+  });
+
+  std::size_t sent = 0;
+  auto start = std::chrono::steady_clock::now();
+  auto end = start + duration;
+  while (std::chrono::steady_clock::now() < end) {
+    send_report(static_cast<int>(sent++));
+  }
+  auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  sending = false;
+  read_thread.join();
+
+  std::cout << name << ": sent " << static_cast<std::size_t>(sent / elapsed) << " reports/s, received "
+            << static_cast<std::size_t>(reader.reports / elapsed) << " reports/s, " << reader.dropped
+            << " SYN_DROPPED" << std::endl;
+}
+
+TEST_CASE("mouse", "[benchmark]") {
+  auto mouse = std::move(*Mouse::create());
+  auto nodes = wait_nodes(mouse);
+
+  BENCHMARK("move (no reader)") {
+    mouse.move(1, 0);
+  };
+
+  EvdevReader reader(nodes);
+  REQUIRE(reader.is_open());
+  reader.drain();
+  BENCHMARK("move to evdev read") {
+    mouse.move(1, 0);
+    return reader.wait_report();
+  };
+
+  sustained_rate("mouse move", nodes, [&](int i) { mouse.move(i % 2 ? 1 : -1, 0); });
+}
+
+TEST_CASE("keyboard", "[benchmark]") {
+  auto keyboard = std::move(*Keyboard::create());
+  auto nodes = wait_nodes(keyboard);
+  short test_key = 0x41;
+
+  BENCHMARK("press and release (no reader)") {
+    keyboard.press(test_key);
+    keyboard.release(test_key);
+  };
+
+  EvdevReader reader(nodes);
+  REQUIRE(reader.is_open());
+  reader.drain();
+  BENCHMARK("press to evdev read") {
+    keyboard.press(test_key);
+    auto read = reader.wait_report();
+    keyboard.release(test_key);
+    reader.wait_report();
+    return read;
+  };
+
+  sustained_rate("keyboard press/release", nodes, [&](int i) {
+    if (i % 2) {
+      keyboard.release(test_key);
+    } else {
+      keyboard.press(test_key);
+    }
+  });
+  keyboard.release(test_key);
+}
+
+TEST_CASE("xbox joypad", "[benchmark]") {
+  auto joypad = std::move(*XboxOneJoypad::create());
+  auto nodes = wait_nodes(joypad);
+
+  BENCHMARK("set_stick (no reader)") {
+    joypad.set_stick(Joypad::LS, 1000, -1000);
+    joypad.set_stick(Joypad::LS, -1000, 1000);
+  };
+
+  EvdevReader reader(nodes);
+  REQUIRE(reader.is_open());
+  reader.drain();
+  short x = 1000;
+  BENCHMARK("set_stick to evdev read") {
+    x = -x; // The kernel drops reports that don't change anything
+    joypad.set_stick(Joypad::LS, x, 0);
+    return reader.wait_report();
+  };
+
+  sustained_rate("xbox set_stick", nodes, [&](int i) { joypad.set_stick(Joypad::LS, i % 2 ? 1000 : -1000, 0); });
+}
+
+#ifdef USE_UHID
+TEST_CASE("PS5 joypad", "[benchmark][UHID]") {
+  auto joypad = std::move(*PS5Joypad::create());
+  auto nodes = wait_nodes(joypad);
+  // The motion sensors report a new timestamp with every uhid report, including the keep alive ones
+  auto gamepad_nodes = filter_nodes(filter_nodes(nodes, "Motion", true), "Touchpad", true);
+  auto motion_nodes = filter_nodes(nodes, "Motion");
+
+  EvdevReader reader(gamepad_nodes);
+  REQUIRE(reader.is_open());
+  std::this_thread::sleep_for(100ms);
+  reader.drain();
+  short x = 1000;
+  BENCHMARK("set_stick to evdev read") {
+    x = -x;
+    joypad.set_stick(Joypad::LS, x, 0);
+    return reader.wait_report();
+  };
+
+  sustained_rate("PS5 set_stick", gamepad_nodes, [&](int i) { joypad.set_stick(Joypad::LS, i % 2 ? 1000 : -1000, 0); });
+
+  joypad.set_report_rate(1ms); // 1000 Hz
+  sustained_rate("PS5 set_motion at 1000 Hz", motion_nodes, [&](int i) {
+    joypad.set_motion(PS5Joypad::GYROSCOPE, i % 2 ? 1.0f : -1.0f, 0, 0);
+  });
+}
+#endif
+
+TEST_CASE("touch screen", "[benchmark]") {
+  auto touch = std::move(*TouchScreen::create());
+  auto nodes = wait_nodes(touch);
+  constexpr int fingers = 10;
+  float y = 0.25;
+
+  EvdevReader reader(nodes);
+  REQUIRE(reader.is_open());
+  for (int finger = 0; finger < fingers; finger++) {
+    touch.place_finger(finger, 0.05f + finger * 0.09f, y, 0.5, 0);
+  }
+  reader.drain();
+
+  BENCHMARK("10 fingers, one report per finger") {
+    y = 1.0f - y;
+    for (int finger = 0; finger < fingers; finger++) {
+      touch.place_finger(finger, 0.05f + finger * 0.09f, y, 0.5, 0);
+    }
+    for (int finger = 0; finger < fingers; finger++) {
+      reader.wait_report();
+    }
+  };
+
+  BENCHMARK("10 fingers, single frame") {
+    y = 1.0f - y;
+    touch.begin_frame();
+    for (int finger = 0; finger < fingers; finger++) {
+      touch.update_finger(finger, 0.05f + finger * 0.09f, y, 0.5, 0);
+    }
+    touch.commit();
+    return reader.wait_report();
+  };
+
+  sustained_rate("touch screen 10 fingers frame", nodes, [&](int i) {
+    touch.begin_frame();
+    for (int finger = 0; finger < fingers; finger++) {
+      touch.update_finger(finger, 0.05f + finger * 0.09f, i % 2 ? 0.25f : 0.75f, 0.5, 0);
+    }
+    touch.commit();
+  });
+
+  for (int finger = 0; finger < fingers; finger++) {
+    touch.release_finger(finger);
+  }
+}
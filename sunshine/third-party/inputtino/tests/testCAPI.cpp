@@ -26,6 +26,17 @@ TEST_CASE("C Mouse API", "[C-API]") {
     inputtino_mouse_release_button(mouse, INPUTTINO_MOUSE_BUTTON::MIDDLE);
     inputtino_mouse_scroll_vertical(mouse, 125);
     inputtino_mouse_scroll_horizontal(mouse, 125);
+
+    InputtinoMouseOp ops[4] = {};
+    ops[0].type = INPUTTINO_MOUSE_OP_MOVE;
+    ops[0].move = {10, -10};
+    ops[1].type = INPUTTINO_MOUSE_OP_PRESS_BUTTON;
+    ops[1].button = INPUTTINO_MOUSE_BUTTON::LEFT;
+    ops[2].type = INPUTTINO_MOUSE_OP_RELEASE_BUTTON;
+    ops[2].button = INPUTTINO_MOUSE_BUTTON::LEFT;
+    ops[3].type = INPUTTINO_MOUSE_OP_SCROLL_VERTICAL;
+    ops[3].high_res_distance = 120;
+    inputtino_mouse_submit_batch(mouse, ops, 4);
   }
 
   delete[] nodes;
@@ -50,6 +61,11 @@ TEST_CASE("C Trackpad API", "[C-API]") {
     inputtino_trackpad_place_finger(trackpad, 0, 100, 200, 1.0, 1);
     inputtino_trackpad_release_finger(trackpad, 0);
     inputtino_trackpad_set_left_btn(trackpad, true);
+
+    InputtinoFingerOp ops[3] = {{.finger_nr = 0, .released = false, .x = 0.2, .y = 0.2, .pressure = 1.0},
+                                {.finger_nr = 1, .released = false, .x = 0.4, .y = 0.4, .pressure = 1.0},
+                                {.finger_nr = 0, .released = true}};
+    inputtino_trackpad_submit_batch(trackpad, ops, 3);
   }
 
   delete[] nodes;
@@ -73,6 +89,10 @@ TEST_CASE("C Touchscreen API", "[C-API]") {
   { // TODO: test that this actually work
     inputtino_touchscreen_place_finger(touchscreen, 0, 100, 200, 1.0, 1);
     inputtino_touchscreen_release_finger(touchscreen, 0);
+
+    InputtinoFingerOp ops[2] = {{.finger_nr = 0, .released = false, .x = 0.2, .y = 0.2, .pressure = 1.0},
+                                {.finger_nr = 1, .released = false, .x = 0.4, .y = 0.4, .pressure = 1.0}};
+    inputtino_touchscreen_submit_batch(touchscreen, ops, 2);
   }
 
   delete[] nodes;
@@ -119,6 +139,9 @@ TEST_CASE("C Keyboard API", "[C-API]") {
   { // TODO: test that this actually work
     inputtino_keyboard_press(keyboard, 1);
     inputtino_keyboard_release(keyboard, 1);
+
+    InputtinoKeyboardOp ops[2] = {{.key_code = 0x41, .pressed = true}, {.key_code = 0x41, .pressed = false}};
+    inputtino_keyboard_submit_batch(keyboard, ops, 2);
   }
 
   delete[] nodes;
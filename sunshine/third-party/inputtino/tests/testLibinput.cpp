@@ -224,6 +224,32 @@ TEST_CASE("virtual touch screen", "[LIBINPUT]") {
         event = get_event(li);
         REQUIRE(libinput_event_get_type(event.get()) == LIBINPUT_EVENT_TOUCH_FRAME);
     }
+
+    { // Put down two fingers in a single frame
+        touch.begin_frame();
+        touch.update_finger(0, 0.1, 0.1, 0.3, 0);
+        touch.update_finger(1, 0.2, 0.2, 0.3, 0);
+        touch.commit();
+        for (int finger = 0; finger < 2; finger++) {
+            event = get_event(li);
+            REQUIRE(libinput_event_get_type(event.get()) == LIBINPUT_EVENT_TOUCH_DOWN);
+        }
+        event = get_event(li);
+        REQUIRE(libinput_event_get_type(event.get()) == LIBINPUT_EVENT_TOUCH_FRAME);
+    }
+
+    { // Lift both fingers in a single frame
+        touch.begin_frame();
+        touch.release_finger(0);
+        touch.release_finger(1);
+        touch.commit();
+        for (int finger = 0; finger < 2; finger++) {
+            event = get_event(li);
+            REQUIRE(libinput_event_get_type(event.get()) == LIBINPUT_EVENT_TOUCH_UP);
+        }
+        event = get_event(li);
+        REQUIRE(libinput_event_get_type(event.get()) == LIBINPUT_EVENT_TOUCH_FRAME);
+    }
 }
 
 TEST_CASE("virtual trackpad", "[LIBINPUT]") {
@@ -22,18 +22,34 @@ namespace display_device {
   }
 
   bool FileSettingsPersistence::store(const std::vector<std::uint8_t> &data) {
+    // The data is written to a temporary file first which then replaces the actual file, so that
+    // the previous state is still available if we crash (or lose power) while writing.
+    const auto temp_filepath {getTempFilepath()};
     try {
-      std::ofstream stream {m_filepath, std::ios::binary | std::ios::trunc};
-      if (!stream) {
-        DD_LOG(error) << "Failed to open " << m_filepath << " for writing!";
-        return false;
+      {
+        std::ofstream stream {temp_filepath, std::ios::binary | std::ios::trunc};
+        if (!stream) {
+          DD_LOG(error) << "Failed to open " << temp_filepath << " for writing!";
+          return false;
+        }
+
+        std::copy(std::begin(data), std::end(data), std::ostreambuf_iterator<char> {stream});
+        stream.close();
+        if (!stream) {
+          DD_LOG(error) << "Failed to write to " << temp_filepath << "!";
+          std::error_code error_code;
+          std::filesystem::remove(temp_filepath, error_code);
+          return false;
+        }
       }
 
-      std::copy(std::begin(data), std::end(data), std::ostreambuf_iterator<char> {stream});
+      std::filesystem::rename(temp_filepath, m_filepath);
       return true;
     } catch (const std::exception &error) {
       DD_LOG(error) << "Failed to write to " << m_filepath << "! Error:\n"
                     << error.what();
+      std::error_code error_code;
+      std::filesystem::remove(temp_filepath, error_code);
       return false;
     }
   }
@@ -69,6 +85,10 @@ namespace display_device {
     std::error_code error_code;
     std::filesystem::remove(m_filepath, error_code);
 
+    // Leftover from an interrupted store (if any), the error does not matter.
+    std::error_code temp_error_code;
+    std::filesystem::remove(getTempFilepath(), temp_error_code);
+
     if (error_code) {
       DD_LOG(error) << "Failed to remove " << m_filepath << "! Error:\n"
                     << "[" << error_code.value() << "] " << error_code.message();
@@ -77,4 +97,10 @@ namespace display_device {
 
     return true;
   }
+
+  std::filesystem::path FileSettingsPersistence::getTempFilepath() const {
+    auto temp_filepath {m_filepath};
+    temp_filepath += ".tmp";
+    return temp_filepath;
+  }
 }  // namespace display_device
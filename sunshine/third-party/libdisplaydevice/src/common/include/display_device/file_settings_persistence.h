@@ -25,6 +25,10 @@ namespace display_device {
 
     /**
      * Store the data in the file specified in constructor.
+     *
+     * The data is written to a temporary file next to it, which then replaces the file,
+     * so that the file always contains either the previous or the new data.
+     *
      * @warning The method does not create missing directories!
      * @see SettingsPersistenceInterface::store for more details.
      */
@@ -44,6 +48,12 @@ namespace display_device {
     [[nodiscard]] bool clear() override;
 
   private:
+    /**
+     * @brief Get the path of the temporary file used while storing the data.
+     * @return The file path with an additional ".tmp" extension.
+     */
+    [[nodiscard]] std::filesystem::path getTempFilepath() const;
+
     std::filesystem::path m_filepath;
   };
 }  // namespace display_device
@@ -6,8 +6,10 @@
 
 // system includes
 #include <algorithm>
+#include <atomic>
 #include <condition_variable>
 #include <functional>
+#include <future>
 #include <memory>
 #include <thread>
 
@@ -152,10 +154,20 @@ namespace display_device {
           std::unique_lock lock {m_mutex};
           while (m_keep_alive) {
             m_syncing_thread = false;
+            if (!m_async_functions.empty()) {
+              // The asynchronous executors are executed as soon as possible, before going back to sleep.
+              auto async_functions {std::move(m_async_functions)};
+              m_async_functions.clear();
+              for (auto &async_function : async_functions) {
+                async_function();
+              }
+              continue;
+            }
+
             if (auto duration {takeNextDuration(m_sleep_durations)}; duration > std::chrono::milliseconds::zero()) {
-              // We're going to sleep until manually woken up or the time elapses.
+              // We're going to sleep until manually woken up, woken up to execute early or the time elapses.
               m_sleep_cv.wait_for(lock, duration, [this]() {
-                return m_syncing_thread;
+                return m_syncing_thread || m_wake_up_requested;
               });
             } else {
               // We're going to sleep until manually woken up.
@@ -169,6 +181,8 @@ namespace display_device {
               continue;
             }
 
+            // Wake-ups requested while executing are not cleared, since whatever we are waiting for might have changed in the meantime.
+            m_wake_up_requested = false;
             try {
               SchedulerStopToken scheduler_stop_token {[&]() {
                 clearThreadLoopUnlocked();
@@ -249,6 +263,7 @@ namespace display_device {
         }
 
         if (!stop_token.stopRequested()) {
+          m_wake_up_requested = false;
           m_retry_function = std::move(exec_fn);
           m_sleep_durations = std::move(sleep_durations);
           syncThreadUnlocked();
@@ -276,6 +291,90 @@ namespace display_device {
       return executeImpl(*this, std::forward<FunctionT>(exec_fn));
     }
 
+    /**
+     * @brief Execute arbitrary logic using the provided interface in the scheduler thread, without blocking the caller.
+     * @param exec_fn Provides thread-safe access to the interface for executing arbitrary logic.
+     *                Acceptable function signatures are the same as for the `execute` method,
+     *                `stop_token` can be used to stop the scheduled function (e.g. pending retries).
+     * @return A future for the return value of the executor callback. The exceptions thrown by
+     *         the callback are stored in the future.
+     * @note The executor is executed once, as soon as possible, and does not replace the scheduled function.
+     *       If the scheduler is destroyed before the executor is executed, the future will throw `std::future_error`.
+     * @examples
+     * std::unique_ptr<SettingsManagerInterface> iface = getIface(...);
+     * RetryScheduler<SettingsManagerInterface> scheduler{std::move(iface)};
+     *
+     * auto result = scheduler.executeAsync([config](SettingsManagerInterface& iface, SchedulerStopToken& stop_token) {
+     *   // No need to keep reverting settings if we are about to apply new ones
+     *   stop_token.requestStop();
+     *   return iface.applySettings(config);
+     * });
+     *
+     * // ... do something else in the meantime
+     * if (result.get() != SettingsManagerInterface::ApplyResult::Ok) {
+     *   // Handle the error
+     * }
+     * @examples_end
+     */
+    template<class FunctionT>
+    auto executeAsync(FunctionT &&exec_fn)
+      requires detail::ExecuteCallbackLike<T, std::decay_t<FunctionT>>
+    {
+      using DecayedFunctionT = std::decay_t<FunctionT>;
+      using ResultT = decltype(executeUnlocked(*this, std::declval<DecayedFunctionT &>()));
+
+      if constexpr (detail::OptionalFunction<DecayedFunctionT>) {
+        if (!exec_fn) {
+          throw std::logic_error {"Empty callback function provided in RetryScheduler::executeAsync!"};
+        }
+      }
+
+      // The promise is shared, because std::function requires the callable to be copyable
+      auto promise {std::make_shared<std::promise<ResultT>>()};
+      auto future {promise->get_future()};
+
+      std::lock_guard lock {m_mutex};
+      m_async_functions.emplace_back([this, promise, async_fn = DecayedFunctionT {std::forward<FunctionT>(exec_fn)}]() mutable {
+        try {
+          if constexpr (std::is_void_v<ResultT>) {
+            executeUnlocked(*this, async_fn);
+            promise->set_value();
+          } else {
+            promise->set_value(executeUnlocked(*this, async_fn));
+          }
+        } catch (...) {
+          promise->set_exception(std::current_exception());
+        }
+      });
+      syncThreadUnlocked();
+      return future;
+    }
+
+    /**
+     * @brief Wake up the scheduler thread to execute the scheduled function right away, instead of
+     *        waiting for the current sleep duration to elapse.
+     *
+     * This is meant to be called from the OS notifications (e.g. display change events), so that the
+     * scheduled function can succeed as soon as the system is ready. The sleep durations are still
+     * used as a fallback.
+     *
+     * @note This method does not lock the mutex and never blocks, so that it can be safely called from
+     *       the notification callbacks that the OS might be waiting for while the scheduled function is
+     *       executing. A wake-up that coincides with the thread going to sleep might be delayed until
+     *       the sleep duration elapses.
+     * @note Nothing happens if nothing is scheduled.
+     * @examples
+     * RetryScheduler<SettingsManagerInterface> scheduler{getIface(...)};
+     * DisplayChangeListener listener{[&scheduler]() {
+     *   scheduler.wakeUp();
+     * }};
+     * @examples_end
+     */
+    void wakeUp() {
+      m_wake_up_requested = true;
+      m_sleep_cv.notify_one();
+    }
+
     /**
      * @brief Check whether anything is scheduled for execution.
      * @return True if something is scheduled, false otherwise.
@@ -344,7 +443,6 @@ namespace display_device {
       requires detail::ExecuteCallbackLike<T, decltype(exec_fn)>
     {
       using FunctionT = decltype(exec_fn);
-      constexpr bool IsConst = std::is_const_v<std::remove_reference_t<decltype(self)>>;
 
       if constexpr (detail::OptionalFunction<FunctionT>) {
         if (!exec_fn) {
@@ -353,6 +451,19 @@ namespace display_device {
       }
 
       std::lock_guard lock {self.m_mutex};
+      return executeUnlocked(self, std::forward<FunctionT>(exec_fn));
+    }
+
+    /**
+     * @brief Execute arbitrary logic using the provided interface while the mutex is already locked.
+     * @see executeImpl for details.
+     */
+    static auto executeUnlocked(auto &self, auto &&exec_fn)
+      requires detail::ExecuteCallbackLike<T, decltype(exec_fn)>
+    {
+      using FunctionT = decltype(exec_fn);
+      constexpr bool IsConst = std::is_const_v<std::remove_reference_t<decltype(self)>>;
+
       detail::auto_const_t<std::decay_t<T>, IsConst> &iface_ref {*self.m_iface};
       if constexpr (detail::ExecuteWithStopToken<T, FunctionT>) {
         detail::auto_const_t<SchedulerStopToken, IsConst> stop_token {[&self]() {
@@ -395,10 +506,12 @@ namespace display_device {
     std::unique_ptr<T> m_iface; /**< Interface to be passed around to the executor functions. */
     std::vector<std::chrono::milliseconds> m_sleep_durations; /**< Sleep times for the timer. */
     std::function<void(T &, SchedulerStopToken &)> m_retry_function {nullptr}; /**< Function to be executed until it succeeds. */
+    std::vector<std::function<void()>> m_async_functions; /**< Functions to be executed once by the thread as soon as possible. */
 
     mutable std::mutex m_mutex {}; /**< A mutex for synchronizing thread and "external" access. */
     std::condition_variable m_sleep_cv {}; /**< Condition variable for waking up thread. */
     bool m_syncing_thread {false}; /**< Safeguard for the condition variable to prevent sporadic thread wake-ups. */
+    std::atomic<bool> m_wake_up_requested {false}; /**< Set to execute the scheduled function without waiting for the sleep duration to elapse. */
     bool m_keep_alive {true}; /**< When set to false, scheduler thread will exit. */
 
     // Always the last in the list so that all the members are already initialized!
@@ -0,0 +1,144 @@
+/**
+ * @file src/windows/display_change_listener.cpp
+ * @brief Definitions for the DisplayChangeListener.
+ */
+// class header include
+#include "display_device/windows/display_change_listener.h"
+
+// system includes
+#include <future>
+#include <stdexcept>
+
+// local includes
+#include "display_device/logging.h"
+
+// Windows includes after "windows.h"
+#include <dbt.h>
+#include <initguid.h>
+#include <ntddvdeo.h>
+
+namespace display_device {
+  namespace {
+    /**
+     * @brief Name of the window class used for the hidden windows.
+     */
+    constexpr const wchar_t *WINDOW_CLASS_NAME {L"libdisplaydevice_DisplayChangeListener"};
+
+    /**
+     * @brief Create the hidden window for receiving the notifications.
+     * @param window_proc Window procedure for the window class.
+     * @param user_data Data to be passed to WM_NCCREATE message.
+     * @returns Handle to the window or nullptr if an error has occurred.
+     */
+    HWND createHiddenWindow(WNDPROC window_proc, void *user_data) {
+      const HINSTANCE instance {GetModuleHandleW(nullptr)};
+
+      WNDCLASSEXW window_class {};
+      window_class.cbSize = sizeof(window_class);
+      window_class.lpfnWndProc = window_proc;
+      window_class.hInstance = instance;
+      window_class.lpszClassName = WINDOW_CLASS_NAME;
+      // The class is already registered if there is more than one listener
+      if (!RegisterClassExW(&window_class) && GetLastError() != ERROR_CLASS_ALREADY_EXISTS) {
+        DD_LOG(error) << "Failed to register the window class for the display change listener! Error code: " << GetLastError();
+        return nullptr;
+      }
+
+      // Message-only windows (HWND_MESSAGE) do not receive the broadcast messages like WM_DISPLAYCHANGE,
+      // therefore a top-level window is created instead which is simply never shown.
+      const HWND window {CreateWindowExW(0, WINDOW_CLASS_NAME, L"", WS_POPUP, 0, 0, 0, 0, nullptr, nullptr, instance, user_data)};
+      if (!window) {
+        DD_LOG(error) << "Failed to create the window for the display change listener! Error code: " << GetLastError();
+        return nullptr;
+      }
+
+      return window;
+    }
+  }  // namespace
+
+  DisplayChangeListener::DisplayChangeListener(std::function<void()> callback):
+      m_callback {callback ? std::move(callback) : throw std::logic_error {"Empty callback function provided in DisplayChangeListener!"}} {
+    std::promise<HWND> window_promise;
+    auto window_future {window_promise.get_future()};
+
+    m_thread = std::thread {[this, &window_promise]() {
+      // The window must be created in the thread that runs its message loop
+      const HWND window {createHiddenWindow(windowProc, this)};
+      if (!window) {
+        // Error already logged
+        window_promise.set_value(nullptr);
+        return;
+      }
+
+      DEV_BROADCAST_DEVICEINTERFACE_W filter {};
+      filter.dbcc_size = sizeof(filter);
+      filter.dbcc_devicetype = DBT_DEVTYP_DEVICEINTERFACE;
+      filter.dbcc_classguid = GUID_DEVINTERFACE_MONITOR;
+      const HDEVNOTIFY device_notification {RegisterDeviceNotificationW(window, &filter, DEVICE_NOTIFY_WINDOW_HANDLE)};
+      if (!device_notification) {
+        DD_LOG(warning) << "Failed to register for the monitor device notifications, only the display changes will be noticed! Error code: " << GetLastError();
+      }
+
+      window_promise.set_value(window);
+
+      MSG message;
+      while (GetMessageW(&message, nullptr, 0, 0) > 0) {
+        DispatchMessageW(&message);
+      }
+
+      if (device_notification) {
+        UnregisterDeviceNotification(device_notification);
+      }
+    }};
+
+    m_window = window_future.get();
+  }
+
+  DisplayChangeListener::~DisplayChangeListener() {
+    if (m_window) {
+      // The window can only be destroyed by its own thread, which then also exits the message loop
+      PostMessageW(m_window, WM_CLOSE, 0, 0);
+    }
+
+    m_thread.join();
+  }
+
+  LRESULT CALLBACK DisplayChangeListener::windowProc(HWND window, UINT message, WPARAM w_param, LPARAM l_param) {
+    switch (message) {
+      case WM_NCCREATE:
+        {
+          const auto create_struct {reinterpret_cast<const CREATESTRUCTW *>(l_param)};
+          SetWindowLongPtrW(window, GWLP_USERDATA, reinterpret_cast<LONG_PTR>(create_struct->lpCreateParams));
+          break;
+        }
+      case WM_DISPLAYCHANGE:
+      case WM_DEVICECHANGE:
+        {
+          if (message == WM_DEVICECHANGE && w_param != DBT_DEVICEARRIVAL && w_param != DBT_DEVICEREMOVECOMPLETE) {
+            break;
+          }
+
+          auto *self {reinterpret_cast<DisplayChangeListener *>(GetWindowLongPtrW(window, GWLP_USERDATA))};
+          if (!self) {
+            break;
+          }
+
+          // Exceptions must not propagate through the window procedure
+          try {
+            self->m_callback();
+          } catch (const std::exception &error) {
+            DD_LOG(error) << "Exception thrown in the DisplayChangeListener callback. Error:\n"
+                          << error.what();
+          }
+          break;
+        }
+      case WM_DESTROY:
+        PostQuitMessage(0);
+        return 0;
+      default:
+        break;
+    }
+
+    return DefWindowProcW(window, message, w_param, l_param);
+  }
+}  // namespace display_device
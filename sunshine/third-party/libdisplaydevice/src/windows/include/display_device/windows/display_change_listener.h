@@ -0,0 +1,64 @@
+/**
+ * @file src/windows/include/display_device/windows/display_change_listener.h
+ * @brief Declarations for the DisplayChangeListener.
+ */
+#pragma once
+
+// system includes
+#include <functional>
+#include <thread>
+
+// local includes
+#include "types.h"
+
+namespace display_device {
+  /**
+   * @brief Listens for the OS notifications about display changes (mode changes, monitors being
+   *        connected or disconnected) and invokes the callback for each of them.
+   *
+   * The notifications are received by a hidden window living in its own thread, therefore
+   * the callback is invoked from that thread and should return quickly.
+   *
+   * @examples
+   * RetryScheduler<SettingsManagerInterface> scheduler{getIface(...)};
+   * DisplayChangeListener listener{[&scheduler]() {
+   *   // Retry right away instead of waiting for the next sleep duration
+   *   scheduler.wakeUp();
+   * }};
+   * @examples_end
+   */
+  class DisplayChangeListener final {
+  public:
+    /**
+     * @brief Default constructor.
+     * @param callback Function to be invoked once a display change is noticed. Will throw on empty function!
+     * @note If the hidden window cannot be created, an error is logged and no notifications will be received.
+     */
+    explicit DisplayChangeListener(std::function<void()> callback);
+
+    /**
+     * @brief Deleted copy constructor.
+     */
+    DisplayChangeListener(const DisplayChangeListener &) = delete;
+
+    /**
+     * @brief Deleted copy operator.
+     */
+    DisplayChangeListener &operator=(const DisplayChangeListener &) = delete;
+
+    /**
+     * @brief Destroys the hidden window and waits for the thread to exit.
+     */
+    ~DisplayChangeListener();
+
+  private:
+    /**
+     * @brief Window procedure of the hidden window.
+     */
+    static LRESULT CALLBACK windowProc(HWND window, UINT message, WPARAM w_param, LPARAM l_param);
+
+    std::function<void()> m_callback; /**< Function to be invoked once a display change is noticed. */
+    HWND m_window {nullptr}; /**< The hidden window receiving the notifications. */
+    std::thread m_thread; /**< The thread owning the window and running its message loop. */
+  };
+}  // namespace display_device
@@ -66,9 +66,12 @@ namespace display_device {
      * @param guard_fn Reference to the guard function which will be set to restore original state (if needed) in case something else fails down the line.
      * @param new_state Reference to the new state which is to be updated accordingly.
      * @param system_settings_touched Inticates whether a "write" operation could have been performed on the OS.
+     * @param deferred_primary_device If not nullptr, the change is not applied, but the device to be set as primary is stored
+     *                                here instead, so that it can be applied together with the display modes.
+     *                                The guard function is still set in this case.
      * @return True if no errors have occured, false otherwise.
      */
-    [[nodiscard]] bool preparePrimaryDevice(const SingleDisplayConfiguration &config, const std::string &device_to_configure, DdGuardFn &guard_fn, SingleDisplayConfigState &new_state, bool &system_settings_touched);
+    [[nodiscard]] bool preparePrimaryDevice(const SingleDisplayConfiguration &config, const std::string &device_to_configure, DdGuardFn &guard_fn, SingleDisplayConfigState &new_state, bool &system_settings_touched, std::string *deferred_primary_device);
 
     /**
      * @brief Changes or restores the display modes based on the cached state, new state and configuration.
@@ -78,9 +81,11 @@ namespace display_device {
      * @param guard_fn Reference to the guard function which will be set to restore original state (if needed) in case something else fails down the line.
      * @param new_state Reference to the new state which is to be updated accordingly.
      * @param system_settings_touched Inticates whether a "write" operation could have been performed on the OS.
+     * @param deferred_primary_device Device to be set as primary, deferred by preparePrimaryDevice (can be empty).
+     *                                It is cleared if the change was applied together with the display modes.
      * @return True if no errors have occured, false otherwise.
      */
-    [[nodiscard]] bool prepareDisplayModes(const SingleDisplayConfiguration &config, const std::string &device_to_configure, const std::set<std::string> &additional_devices_to_configure, DdGuardFn &guard_fn, SingleDisplayConfigState &new_state, bool &system_settings_touched);
+    [[nodiscard]] bool prepareDisplayModes(const SingleDisplayConfiguration &config, const std::string &device_to_configure, const std::set<std::string> &additional_devices_to_configure, DdGuardFn &guard_fn, SingleDisplayConfigState &new_state, bool &system_settings_touched, std::string &deferred_primary_device);
 
     /**
      * @brief Changes or restores the HDR states based on the cached state, new state and configuration.
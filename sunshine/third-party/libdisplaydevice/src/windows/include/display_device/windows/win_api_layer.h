@@ -43,7 +43,53 @@ namespace display_device {
     /** For details @see WinApiLayerInterface::setHdrState */
     [[nodiscard]] bool setHdrState(const DISPLAYCONFIG_PATH_INFO &path, HdrState state) override;
 
+    /** For details @see WinApiLayerInterface::setHdrStates */
+    [[nodiscard]] std::vector<bool> setHdrStates(const std::vector<std::pair<DISPLAYCONFIG_PATH_INFO, HdrState>> &states) override;
+
     /** For details @see WinApiLayerInterface::getDisplayScale */
     [[nodiscard]] std::optional<Rational> getDisplayScale(const std::string &display_name, const DISPLAYCONFIG_SOURCE_MODE &source_mode) const override;
+
+    /**
+     * @brief Discard the display configuration cached by every active DisplayConfigSnapshot.
+     *
+     * The snapshots are already discarded whenever the settings are changed via this layer, this
+     * is for the changes made by someone else, e.g. when receiving WM_DISPLAYCHANGE.
+     * @examples
+     * case WM_DISPLAYCHANGE:
+     *   WinApiLayer::invalidateDisplayConfigSnapshots();
+     *   break;
+     * @examples_end
+     */
+    static void invalidateDisplayConfigSnapshots();
+  };
+
+  /**
+   * @brief Caches the results of WinApiLayer::queryDisplayConfig on the current thread while it's alive.
+   *
+   * An operation like applying the settings queries the same display configuration many times,
+   * the snapshot makes sure that it is only queried once until something changes it.
+   * The monitor instance ids and EDIDs used by WinApiLayer::getDeviceId and WinApiLayer::getEdid
+   * are also cached, for as long as the outermost snapshot is alive.
+   * @examples
+   * const DisplayConfigSnapshot snapshot;
+   * const auto topology {m_dd_api->getCurrentTopology()};  // Queried
+   * const auto modes {m_dd_api->getCurrentDisplayModes(devices)};  // Cached
+   * @examples_end
+   * @note Snapshots can be nested, the cache is dropped when the outermost one is destroyed.
+   */
+  class DisplayConfigSnapshot {
+  public:
+    /**
+     * Default constructor for the class.
+     */
+    DisplayConfigSnapshot();
+
+    /**
+     * Default destructor for the class.
+     */
+    ~DisplayConfigSnapshot();
+
+    DisplayConfigSnapshot(const DisplayConfigSnapshot &) = delete;
+    DisplayConfigSnapshot &operator=(const DisplayConfigSnapshot &) = delete;
   };
 }  // namespace display_device
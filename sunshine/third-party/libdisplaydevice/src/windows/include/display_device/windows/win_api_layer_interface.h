@@ -182,6 +182,23 @@ namespace display_device {
      */
     [[nodiscard]] virtual bool setHdrState(const DISPLAYCONFIG_PATH_INFO &path, HdrState state) = 0;
 
+    /**
+     * @brief Set the HDR states for multiple paths at once.
+     *
+     * Each change blocks until the OS has applied it, so the changes are issued
+     * concurrently and the call waits only once for all of them to settle.
+     * @param states Paths and the new HDR state for each of them.
+     * @returns A vector with the result of each change, as returned by setHdrState,
+     *          in the same order as the states.
+     * @examples
+     * DISPLAYCONFIG_PATH_INFO path_1;
+     * DISPLAYCONFIG_PATH_INFO path_2;
+     * WinApiLayerInterface* iface = getIface(...);
+     * const auto results = iface->setHdrStates({{path_1, HdrState::Enabled}, {path_2, HdrState::Enabled}});
+     * @examples_end
+     */
+    [[nodiscard]] virtual std::vector<bool> setHdrStates(const std::vector<std::pair<DISPLAYCONFIG_PATH_INFO, HdrState>> &states) = 0;
+
     /**
      * @brief Get the scaling value for the display.
      * @param display_name Display to get the scaling for.
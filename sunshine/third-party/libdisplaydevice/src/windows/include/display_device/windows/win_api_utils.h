@@ -261,6 +261,25 @@ namespace display_device::win_utils {
    */
   [[nodiscard]] std::set<std::string> getAllDeviceIdsAndMatchingDuplicates(const WinApiLayerInterface &w_api, const std::set<std::string> &device_ids);
 
+  /**
+   * @brief Shift the source mode origin points so that the device moves to (0, 0) position (becomes primary).
+   *
+   * Only the provided data is modified, it is up to the caller to apply it, possibly together with other changes.
+   *
+   * @param w_api Reference to the Windows API layer.
+   * @param device_id Device to move to the (0, 0) position.
+   * @param display_data Display data to modify.
+   * @returns True if the origin points were shifted, false if the device is already primary,
+   *          or an empty optional if an error has occurred.
+   * @see WinApiLayerInterface::queryDisplayConfig on how to get the display data from the system.
+   * @examples
+   * const WinApiLayerInterface* iface = getIface(...);
+   * auto display_data = iface->queryDisplayConfig(QueryType::Active);
+   * const auto shifted = shiftOriginToDevice(*iface, "MY_DEVICE_ID", *display_data);
+   * @examples_end
+   */
+  [[nodiscard]] std::optional<bool> shiftOriginToDevice(const WinApiLayerInterface &w_api, const std::string &device_id, PathAndModeData &display_data);
+
   /**
    * @brief Check if the refresh rates are almost equal.
    * @param lhs First refresh rate.
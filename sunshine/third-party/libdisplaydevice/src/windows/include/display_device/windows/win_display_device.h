@@ -50,6 +50,9 @@ namespace display_device {
     /** For details @see WinDisplayDeviceInterface::setDisplayModes */
     [[nodiscard]] bool setDisplayModes(const DeviceDisplayModeMap &modes) override;
 
+    /** For details @see WinDisplayDeviceInterface::setDisplayModesAndPrimary */
+    [[nodiscard]] bool setDisplayModesAndPrimary(const DeviceDisplayModeMap &modes, const std::string &device_id) override;
+
     /** For details @see WinDisplayDeviceInterface::isPrimary */
     [[nodiscard]] bool isPrimary(const std::string &device_id) const override;
 
@@ -63,6 +66,14 @@ namespace display_device {
     [[nodiscard]] bool setHdrStates(const HdrStateMap &states) override;
 
   private:
+    /**
+     * @brief Set new display modes and optionally change the primary device with the same configuration change.
+     * @param modes A map of modes to set.
+     * @param primary_device_id A device to set as primary, or an empty string to leave the primary device as is.
+     * @returns True if everything was set, false otherwise.
+     */
+    [[nodiscard]] bool doSetDisplayModes(const DeviceDisplayModeMap &modes, const std::string &primary_device_id);
+
     std::shared_ptr<WinApiLayerInterface> m_w_api;
   };
 }  // namespace display_device
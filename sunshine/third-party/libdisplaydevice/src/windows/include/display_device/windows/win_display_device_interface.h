@@ -139,6 +139,27 @@ namespace display_device {
      */
     [[nodiscard]] virtual bool setDisplayModes(const DeviceDisplayModeMap &modes) = 0;
 
+    /**
+     * @brief Set new display modes for the devices and the device as a primary display in one go.
+     *
+     * Both changes are applied to the OS using a single configuration change, which
+     * avoids an extra mode-set (screen blanking) compared to calling setAsPrimary and
+     * setDisplayModes one after another.
+     *
+     * @param modes A map of modes to set.
+     * @param device_id A device to set as primary.
+     * @returns True if modes were set and the device is or was set as primary, false otherwise.
+     * @warning if any of the specified devices are duplicated, modes be provided
+     *          for duplicates too!
+     * @see setDisplayModes, setAsPrimary for more details.
+     * @examples
+     * WinDisplayDeviceInterface* iface = getIface(...);
+     * const std::string display_a { "MY_ID_1" };
+     * const auto success = iface->setDisplayModesAndPrimary({ { display_a, { { 1920, 1080 }, { 60, 1 } } } }, display_a);
+     * @examples_end
+     */
+    [[nodiscard]] virtual bool setDisplayModesAndPrimary(const DeviceDisplayModeMap &modes, const std::string &device_id) = 0;
+
     /**
      * @brief Check whether the specified device is primary.
      * @param device_id A device to perform the check for.
@@ -13,6 +13,7 @@
 #include "display_device/logging.h"
 #include "display_device/windows/json.h"
 #include "display_device/windows/settings_utils.h"
+#include "display_device/windows/win_api_layer.h"
 
 namespace display_device {
   namespace {
@@ -24,6 +25,9 @@ namespace display_device {
   }  // namespace
 
   SettingsManager::ApplyResult SettingsManager::applySettings(const SingleDisplayConfiguration &config) {
+    // Declared first, so that it still caches the queries made by the guards
+    const DisplayConfigSnapshot display_config_snapshot;
+
     const auto api_access {m_dd_api->isApiAccessAvailable()};
     DD_LOG(info) << "Trying to apply display device settings. API is available: " << toJson(api_access);
 
@@ -77,20 +81,32 @@ namespace display_device {
     }
     auto [new_state, device_to_configure, additional_devices_to_configure] = *prepped_topology_data;
 
+    // Changing the primary device and the display modes are both full configuration changes (the screens blank for each of them),
+    // so if the display modes might change too, the primary device change is deferred to be applied together with them.
+    const auto &cached_state {m_persistence_state->getState()};
+    const bool display_modes_might_change {config.m_resolution || config.m_refresh_rate || (cached_state && !cached_state->m_modified.m_original_modes.empty())};
+    std::string deferred_primary_device;
+
     DdGuardFn primary_guard_fn {noopFn};
     boost::scope::scope_exit<DdGuardFn &> primary_guard {primary_guard_fn};
-    if (!preparePrimaryDevice(config, device_to_configure, primary_guard_fn, new_state, system_settings_touched)) {
+    if (!preparePrimaryDevice(config, device_to_configure, primary_guard_fn, new_state, system_settings_touched, display_modes_might_change ? &deferred_primary_device : nullptr)) {
       // Error already logged
       return ApplyResult::PrimaryDevicePrepFailed;
     }
 
     DdGuardFn mode_guard_fn {noopFn};
     boost::scope::scope_exit<DdGuardFn &> mode_guard {mode_guard_fn};
-    if (!prepareDisplayModes(config, device_to_configure, additional_devices_to_configure, mode_guard_fn, new_state, system_settings_touched)) {
+    if (!prepareDisplayModes(config, device_to_configure, additional_devices_to_configure, mode_guard_fn, new_state, system_settings_touched, deferred_primary_device)) {
       // Error already logged
       return ApplyResult::DisplayModePrepFailed;
     }
 
+    // The display modes did not need to change after all, so the primary device is changed on its own
+    if (!deferred_primary_device.empty() && !m_dd_api->setAsPrimary(deferred_primary_device)) {
+      DD_LOG(error) << "Failed to apply new configuration, because a new primary device could not be set!";
+      return ApplyResult::PrimaryDevicePrepFailed;
+    }
+
     DdGuardFn hdr_state_guard_fn {noopFn};
     boost::scope::scope_exit<DdGuardFn &> hdr_state_guard {hdr_state_guard_fn};
     if (!prepareHdrStates(config, device_to_configure, additional_devices_to_configure, hdr_state_guard_fn, new_state, system_settings_touched)) {
@@ -206,7 +222,7 @@ namespace display_device {
     return std::make_tuple(new_state, device_to_configure, additional_devices_to_configure);
   }
 
-  bool SettingsManager::preparePrimaryDevice(const SingleDisplayConfiguration &config, const std::string &device_to_configure, DdGuardFn &guard_fn, SingleDisplayConfigState &new_state, bool &system_settings_touched) {
+  bool SettingsManager::preparePrimaryDevice(const SingleDisplayConfiguration &config, const std::string &device_to_configure, DdGuardFn &guard_fn, SingleDisplayConfigState &new_state, bool &system_settings_touched, std::string *deferred_primary_device) {
     const auto &cached_state {m_persistence_state->getState()};
     const auto cached_primary_device {cached_state ? cached_state->m_modified.m_original_primary_device : std::string {}};
     const bool ensure_primary {config.m_device_prep == SingleDisplayConfiguration::DevicePreparation::EnsurePrimary};
@@ -227,7 +243,10 @@ namespace display_device {
         system_settings_touched = true;
 
         DD_LOG(info) << info_preamble << toJson(new_device);
-        if (!m_dd_api->setAsPrimary(new_device)) {
+        if (deferred_primary_device) {
+          DD_LOG(info) << "Primary display change is deferred until the display modes are prepared.";
+          *deferred_primary_device = new_device;
+        } else if (!m_dd_api->setAsPrimary(new_device)) {
           DD_LOG(error) << error_log;
           return false;
         }
@@ -262,7 +281,7 @@ namespace display_device {
     return true;
   }
 
-  bool SettingsManager::prepareDisplayModes(const SingleDisplayConfiguration &config, const std::string &device_to_configure, const std::set<std::string> &additional_devices_to_configure, DdGuardFn &guard_fn, SingleDisplayConfigState &new_state, bool &system_settings_touched) {
+  bool SettingsManager::prepareDisplayModes(const SingleDisplayConfiguration &config, const std::string &device_to_configure, const std::set<std::string> &additional_devices_to_configure, DdGuardFn &guard_fn, SingleDisplayConfigState &new_state, bool &system_settings_touched, std::string &deferred_primary_device) {
     const auto &cached_state {m_persistence_state->getState()};
     const auto cached_display_modes {cached_state ? cached_state->m_modified.m_original_modes : DeviceDisplayModeMap {}};
     const bool change_required {config.m_resolution || config.m_refresh_rate};
@@ -280,7 +299,16 @@ namespace display_device {
     const auto try_change {[&](const DeviceDisplayModeMap &new_modes, const auto info_preamble, const auto error_log) {
       if (current_display_modes != new_modes) {
         DD_LOG(info) << info_preamble << toJson(new_modes);
-        if (!m_dd_api->setDisplayModes(new_modes)) {
+        if (!deferred_primary_device.empty()) {
+          DD_LOG(info) << "Changing primary display together with the display modes to:\n"
+                       << toJson(deferred_primary_device);
+          const bool success {m_dd_api->setDisplayModesAndPrimary(new_modes, deferred_primary_device)};
+          deferred_primary_device.clear();
+          if (!success) {
+            DD_LOG(error) << error_log;
+            return false;
+          }
+        } else if (!m_dd_api->setDisplayModes(new_modes)) {
           system_settings_touched = true;
           DD_LOG(error) << error_log;
           return false;
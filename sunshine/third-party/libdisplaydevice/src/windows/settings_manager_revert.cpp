@@ -12,6 +12,7 @@
 #include "display_device/logging.h"
 #include "display_device/windows/json.h"
 #include "display_device/windows/settings_utils.h"
+#include "display_device/windows/win_api_layer.h"
 
 namespace display_device {
   namespace {
@@ -23,6 +24,9 @@ namespace display_device {
   }  // namespace
 
   SettingsManager::RevertResult SettingsManager::revertSettings() {
+    // Declared first, so that it still caches the queries made by the guards
+    const DisplayConfigSnapshot display_config_snapshot;
+
     const auto &cached_state {m_persistence_state->getState()};
     if (!cached_state) {
       return RevertResult::Ok;
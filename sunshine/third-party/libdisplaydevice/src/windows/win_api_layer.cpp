@@ -11,9 +11,12 @@
 #include <boost/uuid/name_generator_sha1.hpp>
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_io.hpp>
+#include <atomic>
 #include <cmath>
 #include <cstdint>
+#include <future>
 #include <iomanip>
+#include <map>
 
 // local includes
 #include "display_device/logging.h"
@@ -362,6 +365,53 @@ namespace display_device {
       DD_LOG(verbose) << "\"is_W11_24H2_OrAbove\" returned true.";
       return true;
     }
+
+    /**
+     * @brief The display configuration cached by the DisplayConfigSnapshot objects of a thread.
+     */
+    struct DisplayConfigCache {
+      int m_snapshots {0}; /**< Number of alive snapshots, caching only while > 0. */
+      std::uint64_t m_generation {0}; /**< Value of `display_config_generation` when the data was cached. */
+      std::optional<PathAndModeData> m_active; /**< Cached result for QueryType::Active. */
+      std::optional<PathAndModeData> m_all; /**< Cached result for QueryType::All. */
+      std::map<std::wstring, std::optional<std::tuple<std::wstring, std::vector<std::byte>>>> m_instance_ids_and_edids; /**< Cached results of `getInstanceIdAndEdid` per monitor device path. */
+    };
+
+    /** @brief Incremented whenever the display configuration might have changed, discarding the cached data of all threads. */
+    std::atomic<std::uint64_t> display_config_generation {0};
+    thread_local DisplayConfigCache display_config_cache;
+
+    /**
+     * @brief Get the cached data for the query type.
+     * @param type Type of the query.
+     * @return Reference to the cached data.
+     */
+    std::optional<PathAndModeData> &getCachedDisplayConfig(QueryType type) {
+      return type == QueryType::Active ? display_config_cache.m_active : display_config_cache.m_all;
+    }
+
+    /**
+     * @brief A cached variant of `getInstanceIdAndEdid` while a snapshot is alive.
+     *
+     * Each device id lookup goes through the SetupAPI device enumeration and reads the EDID from
+     * the registry, while the same paths are looked up over and over when applying or reverting settings.
+     * The monitor device path stays the same for the same monitor in the same port, therefore
+     * the result is kept until the last snapshot ends, even if the display configuration changes.
+     *
+     * @see getInstanceIdAndEdid for the description.
+     */
+    std::optional<std::tuple<std::wstring, std::vector<std::byte>>> getCachedInstanceIdAndEdid(const WinApiLayerInterface &w_api, const std::wstring &device_path) {
+      if (display_config_cache.m_snapshots == 0) {
+        return getInstanceIdAndEdid(w_api, device_path);
+      }
+
+      auto &cache {display_config_cache.m_instance_ids_and_edids};
+      if (auto cached_it {cache.find(device_path)}; cached_it != std::end(cache)) {
+        return cached_it->second;
+      }
+
+      return cache[device_path] = getInstanceIdAndEdid(w_api, device_path);
+    }
   }  // namespace
 
   std::string WinApiLayer::getErrorString(LONG error_code) const {
@@ -394,7 +444,36 @@ namespace display_device {
     return error.str();
   }
 
+  void WinApiLayer::invalidateDisplayConfigSnapshots() {
+    ++display_config_generation;
+  }
+
+  DisplayConfigSnapshot::DisplayConfigSnapshot() {
+    display_config_cache.m_snapshots++;
+  }
+
+  DisplayConfigSnapshot::~DisplayConfigSnapshot() {
+    if (--display_config_cache.m_snapshots == 0) {
+      display_config_cache.m_active = std::nullopt;
+      display_config_cache.m_all = std::nullopt;
+      display_config_cache.m_instance_ids_and_edids.clear();
+    }
+  }
+
   std::optional<PathAndModeData> WinApiLayer::queryDisplayConfig(QueryType type) const {
+    const auto generation {display_config_generation.load()};
+    if (display_config_cache.m_snapshots > 0) {
+      if (display_config_cache.m_generation != generation) {
+        display_config_cache.m_active = std::nullopt;
+        display_config_cache.m_all = std::nullopt;
+        display_config_cache.m_generation = generation;
+      }
+
+      if (const auto &cached {getCachedDisplayConfig(type)}; cached) {
+        return cached;
+      }
+    }
+
     std::vector<DISPLAYCONFIG_PATH_INFO> paths;
     std::vector<DISPLAYCONFIG_MODE_INFO> modes;
     LONG result = ERROR_SUCCESS;
@@ -433,7 +512,12 @@ namespace display_device {
 
     DD_LOG(verbose) << "Result of " << (type == QueryType::Active ? "ACTIVE" : "ALL") << " display config query:\n"
                     << dumpPathsAndModes(paths, modes) << "\n";
-    return PathAndModeData {paths, modes};
+
+    PathAndModeData data {std::move(paths), std::move(modes)};
+    if (display_config_cache.m_snapshots > 0 && display_config_generation.load() == generation) {
+      getCachedDisplayConfig(type) = data;
+    }
+    return data;
   }
 
   std::string WinApiLayer::getDeviceId(const DISPLAYCONFIG_PATH_INFO &path) const {
@@ -444,7 +528,7 @@ namespace display_device {
     }
 
     std::vector<std::byte> device_id_data;
-    auto instance_id_and_edid {getInstanceIdAndEdid(*this, device_path)};
+    auto instance_id_and_edid {getCachedInstanceIdAndEdid(*this, device_path)};
     if (instance_id_and_edid) {
       // Instance ID is unique in the system and persists restarts, but not driver re-installs.
       // It looks like this:
@@ -525,7 +609,7 @@ namespace display_device {
       return {};
     }
 
-    auto instance_id_and_edid {getInstanceIdAndEdid(*this, device_path)};
+    auto instance_id_and_edid {getCachedInstanceIdAndEdid(*this, device_path)};
     return instance_id_and_edid ? std::get<1>(*instance_id_and_edid) : std::vector<std::byte> {};
   }
 
@@ -566,6 +650,11 @@ namespace display_device {
   }
 
   LONG WinApiLayer::setDisplayConfig(std::vector<DISPLAYCONFIG_PATH_INFO> paths, std::vector<DISPLAYCONFIG_MODE_INFO> modes, UINT32 flags) {
+    if (flags & SDC_APPLY) {
+      // Even a failed call might have changed some of the settings
+      invalidateDisplayConfigSnapshots();
+    }
+
     // std::vector::data() "may or may not return a null pointer, if size() is 0", therefore we want to enforce nullptr...
     return ::SetDisplayConfig(
       paths.size(),
@@ -609,6 +698,8 @@ namespace display_device {
   }
 
   bool WinApiLayer::setHdrState(const DISPLAYCONFIG_PATH_INFO &path, HdrState state) {
+    invalidateDisplayConfigSnapshots();
+
     if (is_W11_24H2_OrAbove(*this)) {
       DISPLAYCONFIG_SET_HDR_STATE hdr_state = {};
       hdr_state.header.adapterId = path.targetInfo.adapterId;
@@ -642,6 +733,38 @@ namespace display_device {
     return true;
   }
 
+  std::vector<bool> WinApiLayer::setHdrStates(const std::vector<std::pair<DISPLAYCONFIG_PATH_INFO, HdrState>> &states) {
+    std::vector<bool> results(states.size(), false);
+    if (states.empty()) {
+      return results;
+    }
+
+    // DisplayConfigSetDeviceInfo only returns once the OS has applied the change, which can take
+    // hundreds of milliseconds per display. The first change is issued from this thread and the
+    // others from their own threads, so that the total time is that of the slowest display.
+    std::vector<std::future<bool>> pending_results;
+    pending_results.reserve(states.size() - 1);
+    for (std::size_t i {1}; i < states.size(); ++i) {
+      const auto &entry {states[i]};
+      try {
+        pending_results.push_back(std::async(std::launch::async, [this, &entry]() {
+          return setHdrState(entry.first, entry.second);
+        }));
+      } catch (const std::system_error &error) {
+        DD_LOG(warning) << "Failed to start a thread for setting the HDR state, it will be set sequentially: " << error.what();
+        pending_results.push_back(std::async(std::launch::deferred, [this, &entry]() {
+          return setHdrState(entry.first, entry.second);
+        }));
+      }
+    }
+
+    results[0] = setHdrState(states[0].first, states[0].second);
+    for (std::size_t i {0}; i < pending_results.size(); ++i) {
+      results[i + 1] = pending_results[i].get();
+    }
+    return results;
+  }
+
   std::optional<Rational> WinApiLayer::getDisplayScale(const std::string &display_name, const DISPLAYCONFIG_SOURCE_MODE &source_mode) const {
     // Note: implementation based on https://stackoverflow.com/a/74046173
     struct EnumData {
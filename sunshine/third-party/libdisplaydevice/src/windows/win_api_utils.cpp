@@ -452,6 +452,58 @@ namespace display_device::win_utils {
     return all_device_ids;
   }
 
+  std::optional<bool> shiftOriginToDevice(const WinApiLayerInterface &w_api, const std::string &device_id, PathAndModeData &display_data) {
+    // Get the current origin point of the device (the one that we want to make primary)
+    POINTL origin;
+    {
+      const auto path {getActivePath(w_api, device_id, display_data.m_paths)};
+      if (!path) {
+        DD_LOG(error) << "Failed to find device for " << device_id << "!";
+        return std::nullopt;
+      }
+
+      const auto source_mode {getSourceMode(getSourceIndex(*path, display_data.m_modes), display_data.m_modes)};
+      if (!source_mode) {
+        DD_LOG(error) << "Active device does not have a source mode: " << device_id << "!";
+        return std::nullopt;
+      }
+
+      if (isPrimary(*source_mode)) {
+        DD_LOG(debug) << "Device " << device_id << " is already a primary device.";
+        return false;
+      }
+
+      origin = source_mode->position;
+    }
+
+    // Shift the source mode origin points accordingly, so that the provided
+    // device moves to (0, 0) position and others to their new positions.
+    std::set<UINT32> modified_modes;
+    for (auto &path : display_data.m_paths) {
+      const auto current_id {w_api.getDeviceId(path)};
+      const auto source_index {getSourceIndex(path, display_data.m_modes)};
+      auto source_mode {getSourceMode(source_index, display_data.m_modes)};
+
+      if (!source_index || !source_mode) {
+        DD_LOG(error) << "Active device does not have a source mode: " << current_id << "!";
+        return std::nullopt;
+      }
+
+      if (modified_modes.find(*source_index) != std::end(modified_modes)) {
+        // Happens when VIRTUAL_MODE_AWARE is not specified when querying paths, probably will never happen in our (since it's always set), but just to be safe...
+        DD_LOG(debug) << "Device " << current_id << " shares the same mode index as a previous device. Device is duplicated. Skipping.";
+        continue;
+      }
+
+      source_mode->position.x -= origin.x;
+      source_mode->position.y -= origin.y;
+
+      modified_modes.insert(*source_index);
+    }
+
+    return true;
+  }
+
   bool fuzzyCompareRefreshRates(const Rational &lhs, const Rational &rhs) {
     if (lhs.m_denominator > 0 && rhs.m_denominator > 0) {
       const double lhs_f {static_cast<double>(lhs.m_numerator) / static_cast<double>(lhs.m_denominator)};
@@ -19,49 +19,49 @@ namespace display_device {
 
     /**
      * @see setHdrStates for a description as this was split off to reduce cognitive complexity.
+     * @note All devices are validated before any state is changed, and the changes are then
+     *       made in a single WinApiLayerInterface::setHdrStates call.
      */
     bool doSetHdrStates(WinApiLayerInterface &w_api, const PathAndModeData &display_data, const HdrStateMapNoOpt &states, HdrStateMapNoOpt *changed_states) {
-      const auto try_set_state {
-        [&w_api, &display_data](const auto &device_id, const auto &state, auto &current_state) {
-          const auto path {win_utils::getActivePath(w_api, device_id, display_data.m_paths)};
-          if (!path) {
-            DD_LOG(error) << "Failed to find device for " << device_id << "!";
-            return false;
-          }
-
-          const auto current_state_int {w_api.getHdrState(*path)};
-          if (!current_state_int) {
-            DD_LOG(error) << "HDR state cannot be changed for " << device_id << "!";
-            return false;
-          }
-
-          if (state != *current_state_int) {
-            if (!w_api.setHdrState(*path, state)) {
-              // Error already logged
-              return false;
-            }
-
-            current_state = current_state_int;
-          }
-
-          return true;
-        }
-      };
-
+      std::vector<std::pair<DISPLAYCONFIG_PATH_INFO, HdrState>> paths_and_states;
+      std::vector<std::pair<std::string, HdrState>> original_states;
+      bool success {true};
       for (const auto &[device_id, state] : states) {
-        std::optional<HdrState> current_state;
-        if (try_set_state(device_id, state, current_state)) {
-          if (current_state && changed_states != nullptr) {
-            (*changed_states)[device_id] = *current_state;
-          }
+        const auto path {win_utils::getActivePath(w_api, device_id, display_data.m_paths)};
+        if (!path) {
+          DD_LOG(error) << "Failed to find device for " << device_id << "!";
+          success = false;
+        } else if (const auto current_state {w_api.getHdrState(*path)}; !current_state) {
+          DD_LOG(error) << "HDR state cannot be changed for " << device_id << "!";
+          success = false;
+        } else if (state != *current_state) {
+          paths_and_states.emplace_back(*path, state);
+          original_states.emplace_back(device_id, *current_state);
         }
+
         // If we are undoing changes we don't want to return early and continue regardless of what error we get.
-        else if (changed_states != nullptr) {
+        if (!success && changed_states != nullptr) {
           return false;
         }
       }
 
-      return true;
+      if (paths_and_states.empty()) {
+        return success;
+      }
+
+      const auto results {w_api.setHdrStates(paths_and_states)};
+      for (std::size_t i {0}; i < original_states.size(); ++i) {
+        if (i < results.size() && results[i]) {
+          if (changed_states != nullptr) {
+            (*changed_states)[original_states[i].first] = original_states[i].second;
+          }
+        } else {
+          // Error already logged
+          success = false;
+        }
+      }
+
+      return success;
     }
 
   }  // namespace
@@ -26,7 +26,7 @@ namespace display_device {
     /**
      * @see set_display_modes for a description as this was split off to reduce cognitive complexity.
      */
-    bool doSetModes(WinApiLayerInterface &w_api, const DeviceDisplayModeMap &modes, const Strategy strategy) {
+    bool doSetModes(WinApiLayerInterface &w_api, const DeviceDisplayModeMap &modes, const std::string &primary_device_id, const Strategy strategy) {
       auto display_data {w_api.queryDisplayConfig(QueryType::Active)};
       if (!display_data) {
         // Error already logged
@@ -79,6 +79,17 @@ namespace display_device {
         changes_applied = changes_applied || new_changes;
       }
 
+      if (!primary_device_id.empty()) {
+        // The origin points are shifted after the modes are modified, so that both end up in the same configuration change.
+        const auto shifted {win_utils::shiftOriginToDevice(w_api, primary_device_id, *display_data)};
+        if (!shifted) {
+          // Error already logged
+          return false;
+        }
+
+        changes_applied = changes_applied || *shifted;
+      }
+
       if (!changes_applied) {
         DD_LOG(debug) << "No changes were made to display modes as they are equal.";
         return true;
@@ -145,6 +156,19 @@ namespace display_device {
   }
 
   bool WinDisplayDevice::setDisplayModes(const DeviceDisplayModeMap &modes) {
+    return doSetDisplayModes(modes, {});
+  }
+
+  bool WinDisplayDevice::setDisplayModesAndPrimary(const DeviceDisplayModeMap &modes, const std::string &device_id) {
+    if (device_id.empty()) {
+      DD_LOG(error) << "Device id is empty!";
+      return false;
+    }
+
+    return doSetDisplayModes(modes, device_id);
+  }
+
+  bool WinDisplayDevice::doSetDisplayModes(const DeviceDisplayModeMap &modes, const std::string &primary_device_id) {
     if (modes.empty()) {
       DD_LOG(error) << "Modes map is empty!";
       return false;
@@ -182,12 +206,17 @@ namespace display_device {
       return false;
     }
 
-    if (!doSetModes(*m_w_api, modes, Strategy::Relaxed)) {
+    if (!doSetModes(*m_w_api, modes, primary_device_id, Strategy::Relaxed)) {
       // Error already logged
       return false;
     }
 
-    const auto all_modes_match = [&modes](const DeviceDisplayModeMap &current_modes) {
+    const auto all_modes_match = [this, &modes, &primary_device_id](const DeviceDisplayModeMap &current_modes) {
+      // The primary device is a part of the requested changes too
+      if (!primary_device_id.empty() && !isPrimary(primary_device_id)) {
+        return false;
+      }
+
       for (const auto &[device_id, requested_mode] : modes) {
         auto mode_it {current_modes.find(device_id)};
         if (mode_it == std::end(current_modes)) {
@@ -220,7 +249,7 @@ namespace display_device {
       // resolution to be selected, we actually need to omit SDC_ALLOW_CHANGES
       // flag.
       DD_LOG(info) << "Failed to change display modes using Windows recommended modes, trying to set modes more strictly!";
-      if (doSetModes(*m_w_api, modes, Strategy::Strict)) {
+      if (doSetModes(*m_w_api, modes, primary_device_id, Strategy::Strict)) {
         current_modes = getCurrentDisplayModes(device_ids);
         if (!current_modes.empty() && all_modes_match(current_modes)) {
           return true;
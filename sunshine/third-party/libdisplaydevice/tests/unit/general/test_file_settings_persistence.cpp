@@ -74,6 +74,15 @@ TEST_F_S(Store, FileOverwritten) {
   EXPECT_EQ(file_data, data2);
 }
 
+TEST_F_S(Store, TemporaryFileRemoved) {
+  const std::filesystem::path filepath {"myfile.ext"};
+  const std::vector<std::uint8_t> data {0x00, 0x01, 0x02, 0x04, 'S', 'O', 'M', 'E', ' ', 'D', 'A', 'T', 'A'};
+
+  EXPECT_TRUE(getImpl(filepath).store(data));
+  EXPECT_TRUE(std::filesystem::exists(filepath));
+  EXPECT_FALSE(std::filesystem::exists("myfile.ext.tmp"));
+}
+
 TEST_F_S(Store, FilepathWithDirectory) {
   const std::filesystem::path filepath {"somedir/myfile.ext"};
   const std::vector<std::uint8_t> data {0x00, 0x01, 0x02, 0x04, 'S', 'O', 'M', 'E', ' ', 'D', 'A', 'T', 'A'};
@@ -103,6 +112,19 @@ TEST_F_S(Clear, NoFileAvailable) {
   EXPECT_TRUE(getImpl().clear());
 }
 
+TEST_F_S(Clear, TemporaryFileRemoved) {
+  const std::filesystem::path filepath {"myfile.ext"};
+  const std::filesystem::path temp_filepath {"myfile.ext.tmp"};
+  {
+    std::ofstream file {temp_filepath};
+    file << "SOME DATA";
+  }
+
+  EXPECT_TRUE(std::filesystem::exists(temp_filepath));
+  EXPECT_TRUE(getImpl(filepath).clear());
+  EXPECT_FALSE(std::filesystem::exists(temp_filepath));
+}
+
 TEST_F_S(Clear, FileRemoved) {
   const std::filesystem::path filepath {"myfile.ext"};
   {
@@ -595,6 +595,121 @@ TEST_F_S(Execute, ConstVsNonConst, WithStopToken) {
   // const_impl.execute(non_const_non_const_callback_auto);
 }
 
+TEST_F_S(WakeUp) {
+  int counter {0};
+  m_impl.schedule([&](auto, auto &) {
+    counter++;
+  },
+                  {.m_sleep_durations = {10s}, .m_execution = display_device::SchedulerOptions::Execution::ScheduledOnly});
+
+  const auto wake_up_and_wait {[&](int expected_counter) {
+    const auto start {std::chrono::steady_clock::now()};
+    m_impl.wakeUp();
+    while (m_impl.execute([&](auto) {
+      return counter;
+    }) < expected_counter) {
+      std::this_thread::sleep_for(1ms);
+    }
+    return std::chrono::steady_clock::now() - start;
+  }};
+
+  EXPECT_LT(wake_up_and_wait(1), 5s);
+  EXPECT_LT(wake_up_and_wait(2), 5s);
+
+  // Stop the scheduler to avoid SEGFAULTS
+  m_impl.stop();
+}
+
+TEST_F_S(WakeUp, NothingScheduled) {
+  m_impl.wakeUp();
+  EXPECT_FALSE(m_impl.isScheduled());
+}
+
+TEST_F_S(ExecuteAsync, NullptrCallbackProvided) {
+  EXPECT_THAT([this]() {
+    static_cast<void>(m_impl.executeAsync(std::function<void(TestIface &)> {}));
+  },
+              ThrowsMessage<std::logic_error>(HasSubstr("Empty callback function provided in RetryScheduler::executeAsync!")));
+}
+
+TEST_F_S(ExecuteAsync, ExecutedInSchedulerThread) {
+  auto result {m_impl.executeAsync([](auto) {
+    return std::this_thread::get_id();
+  })};
+
+  EXPECT_NE(result.get(), std::this_thread::get_id());
+}
+
+TEST_F_S(ExecuteAsync, CallerNotBlocked) {
+  std::promise<void> release_executor;
+  auto executor_released {release_executor.get_future()};
+  auto result {m_impl.executeAsync([&](auto) {
+    executor_released.wait();
+    return 123;
+  })};
+
+  EXPECT_EQ(result.wait_for(15ms), std::future_status::timeout);
+  release_executor.set_value();
+  EXPECT_EQ(result.get(), 123);
+}
+
+TEST_F_S(ExecuteAsync, SchedulerNotStopped) {
+  int counter {0};
+  m_impl.schedule([&](auto, auto &) {
+    counter++;
+  },
+                  {.m_sleep_durations = {1ms}});
+  while (counter < 3) {
+    std::this_thread::sleep_for(1ms);
+  }
+
+  m_impl.executeAsync([](auto) {}).get();
+  EXPECT_TRUE(m_impl.isScheduled());
+
+  const int counter_after_async {m_impl.execute([&](auto) {
+    return counter;
+  })};
+  while (counter <= counter_after_async) {
+    std::this_thread::sleep_for(1ms);
+  }
+
+  // Stop the scheduler to avoid SEGFAULTS
+  m_impl.stop();
+}
+
+TEST_F_S(ExecuteAsync, SchedulerStopped) {
+  int counter {0};
+  m_impl.schedule([&](auto, auto &) {
+    counter++;
+  },
+                  {.m_sleep_durations = {1ms}});
+  while (counter < 3) {
+    std::this_thread::sleep_for(1ms);
+  }
+
+  int counter_in_async {0};
+  m_impl.executeAsync([&](auto, auto &stop_token) {
+          counter_in_async = counter;
+          stop_token.requestStop();
+        })
+    .get();
+
+  EXPECT_FALSE(m_impl.isScheduled());
+  std::this_thread::sleep_for(15ms);
+  EXPECT_EQ(counter, counter_in_async);
+}
+
+TEST_F_S(ExecuteAsync, ExceptionThrown) {
+  auto result {m_impl.executeAsync([](auto) {
+    throw std::runtime_error("Get rekt!");
+  })};
+
+  EXPECT_THAT([&]() {
+    result.get();
+  },
+              ThrowsMessage<std::runtime_error>(HasSubstr("Get rekt!")));
+}
+
 TEST_F_S(Stop) {
   EXPECT_FALSE(m_impl.isScheduled());
   m_impl.stop();
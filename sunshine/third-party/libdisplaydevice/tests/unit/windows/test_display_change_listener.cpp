@@ -0,0 +1,27 @@
+// local includes
+#include "display_device/windows/display_change_listener.h"
+#include "fixtures/fixtures.h"
+
+namespace {
+  // Convenience keywords for GMock
+  using ::testing::HasSubstr;
+
+  // Test fixture(s) for this file
+  class DisplayChangeListenerTest: public BaseTest {};
+
+  // Specialized TEST macro(s) for this test file
+#define TEST_F_S(...) DD_MAKE_TEST(TEST_F, DisplayChangeListenerTest, __VA_ARGS__)
+}  // namespace
+
+TEST_F_S(EmptyCallbackProvided) {
+  EXPECT_THAT([]() {
+    const display_device::DisplayChangeListener listener(nullptr);
+  },
+              ThrowsMessage<std::logic_error>(HasSubstr("Empty callback function provided in DisplayChangeListener!")));
+}
+
+TEST_F_S(CreatedAndDestroyed) {
+  // Multiple listeners share the same window class
+  const display_device::DisplayChangeListener listener_1 {[]() {}};
+  const display_device::DisplayChangeListener listener_2 {[]() {}};
+}
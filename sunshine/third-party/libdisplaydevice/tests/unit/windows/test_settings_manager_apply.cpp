@@ -169,6 +169,13 @@ namespace {
         .RetiresOnSaturation();
     }
 
+    void expectedSetDisplayModesAndPrimaryCall(InSequence &sequence /* To ensure that sequence is created outside this scope */, const display_device::DeviceDisplayModeMap &modes, const std::string &device_id, const bool success = true) {
+      EXPECT_CALL(*m_dd_api, setDisplayModesAndPrimary(modes, device_id))
+        .Times(1)
+        .WillOnce(Return(success))
+        .RetiresOnSaturation();
+    }
+
     void expectedGetCurrentDisplayModesCall(InSequence &sequence /* To ensure that sequence is created outside this scope */, const std::set<std::string> &devices, const display_device::DeviceDisplayModeMap &modes) {
       EXPECT_CALL(*m_dd_api, getCurrentDisplayModes(devices))
         .Times(1)
@@ -1026,6 +1033,67 @@ TEST_F_S_MOCKED(PrepareDisplayModes, DisplayModesRestoreSkipped, PersistenceFail
   EXPECT_EQ(getImpl().applySettings({.m_device_id = "DeviceId1"}), display_device::SettingsManager::ApplyResult::PersistenceSaveFailed);
 }
 
+TEST_F_S_MOCKED(PrepareDisplayModes, DisplayModesSet, TogetherWithPrimaryDevice) {
+  using DevicePrep = display_device::SingleDisplayConfiguration::DevicePreparation;
+  auto current_modes {DEFAULT_CURRENT_MODES};
+  current_modes["DeviceId4"] = {{1920, 1080}, {60, 1}};
+  auto new_modes {current_modes};
+  new_modes["DeviceId4"].m_resolution = {1280, 720};
+
+  auto persistence_input {DEFAULT_PERSISTENCE_INPUT_BASE};
+  persistence_input.m_modified.m_topology = {{"DeviceId1", "DeviceId2"}, {"DeviceId3"}, {"DeviceId4"}};
+  persistence_input.m_modified.m_original_primary_device = "DeviceId1";
+  persistence_input.m_modified.m_original_modes = current_modes;
+
+  InSequence sequence;
+  expectedDefaultCallsUntilTopologyPrep(sequence);
+  expectedIsCapturedCall(sequence, false);
+  expectedDeviceEnumCall(sequence);
+  expectedIsTopologyTheSameCall(sequence, DEFAULT_CURRENT_TOPOLOGY, persistence_input.m_modified.m_topology);
+  expectedIsCapturedCall(sequence, false);
+  expectedIsTopologyTheSameCall(sequence, DEFAULT_CURRENT_TOPOLOGY, DEFAULT_CURRENT_TOPOLOGY);
+  expectedSetTopologyCall(sequence, persistence_input.m_modified.m_topology);
+  expectedIsTopologyTheSameCall(sequence, DEFAULT_CURRENT_TOPOLOGY, persistence_input.m_modified.m_topology);
+
+  expectedIsPrimaryCall(sequence, "DeviceId1");
+  expectedGetCurrentDisplayModesCall(sequence, display_device::win_utils::flattenTopology(persistence_input.m_modified.m_topology), current_modes);
+  expectedSetDisplayModesAndPrimaryCall(sequence, new_modes, "DeviceId4");
+  expectedGetCurrentDisplayModesCall(sequence, display_device::win_utils::flattenTopology(persistence_input.m_modified.m_topology), new_modes);
+  expectedPersistenceCall(sequence, persistence_input);
+  expectedHdrWorkaroundCalls(sequence);
+
+  EXPECT_EQ(getImpl().applySettings({.m_device_id = "DeviceId4", .m_device_prep = DevicePrep::EnsurePrimary, .m_resolution = {{1280, 720}}}), display_device::SettingsManager::ApplyResult::Ok);
+}
+
+TEST_F_S_MOCKED(PrepareDisplayModes, DisplayModesSetSkipped, PrimaryDeviceSetSeparately) {
+  using DevicePrep = display_device::SingleDisplayConfiguration::DevicePreparation;
+  auto current_modes {DEFAULT_CURRENT_MODES};
+  current_modes["DeviceId4"] = {{1920, 1080}, {60, 1}};
+
+  auto persistence_input {DEFAULT_PERSISTENCE_INPUT_BASE};
+  persistence_input.m_modified.m_topology = {{"DeviceId1", "DeviceId2"}, {"DeviceId3"}, {"DeviceId4"}};
+  persistence_input.m_modified.m_original_primary_device = "DeviceId1";
+  persistence_input.m_modified.m_original_modes = current_modes;
+
+  InSequence sequence;
+  expectedDefaultCallsUntilTopologyPrep(sequence);
+  expectedIsCapturedCall(sequence, false);
+  expectedDeviceEnumCall(sequence);
+  expectedIsTopologyTheSameCall(sequence, DEFAULT_CURRENT_TOPOLOGY, persistence_input.m_modified.m_topology);
+  expectedIsCapturedCall(sequence, false);
+  expectedIsTopologyTheSameCall(sequence, DEFAULT_CURRENT_TOPOLOGY, DEFAULT_CURRENT_TOPOLOGY);
+  expectedSetTopologyCall(sequence, persistence_input.m_modified.m_topology);
+  expectedIsTopologyTheSameCall(sequence, DEFAULT_CURRENT_TOPOLOGY, persistence_input.m_modified.m_topology);
+
+  expectedIsPrimaryCall(sequence, "DeviceId1");
+  expectedGetCurrentDisplayModesCall(sequence, display_device::win_utils::flattenTopology(persistence_input.m_modified.m_topology), current_modes);
+  expectedSetAsPrimaryCall(sequence, "DeviceId4");
+  expectedPersistenceCall(sequence, persistence_input);
+  expectedHdrWorkaroundCalls(sequence);
+
+  EXPECT_EQ(getImpl().applySettings({.m_device_id = "DeviceId4", .m_device_prep = DevicePrep::EnsurePrimary, .m_resolution = {{1920, 1080}}}), display_device::SettingsManager::ApplyResult::Ok);
+}
+
 TEST_F_S_MOCKED(PrepareHdrStates, FailedToGetHdrStates) {
   InSequence sequence;
   expectedDefaultCallsUntilTopologyPrep(sequence);
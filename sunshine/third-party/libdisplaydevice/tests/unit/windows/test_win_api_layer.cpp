@@ -100,6 +100,32 @@ TEST_F_S(QueryDisplayConfig, ModeIndexValidity) {
   }
 }
 
+TEST_F_S(QueryDisplayConfig, Snapshot) {
+  const auto uncached_devices {m_layer.queryDisplayConfig(display_device::QueryType::Active)};
+  ASSERT_TRUE(uncached_devices);
+
+  const display_device::DisplayConfigSnapshot snapshot;
+  const auto active_devices {m_layer.queryDisplayConfig(display_device::QueryType::Active)};
+  const auto all_devices {m_layer.queryDisplayConfig(display_device::QueryType::All)};
+  ASSERT_TRUE(active_devices);
+  ASSERT_TRUE(all_devices);
+  EXPECT_EQ(active_devices->m_paths.size(), uncached_devices->m_paths.size());
+  EXPECT_TRUE(all_devices->m_paths.size() >= active_devices->m_paths.size());
+
+  {
+    const display_device::DisplayConfigSnapshot nested_snapshot;
+    const auto cached_devices {m_layer.queryDisplayConfig(display_device::QueryType::Active)};
+    ASSERT_TRUE(cached_devices);
+    EXPECT_EQ(cached_devices->m_paths.size(), active_devices->m_paths.size());
+    EXPECT_EQ(cached_devices->m_modes.size(), active_devices->m_modes.size());
+  }
+
+  display_device::WinApiLayer::invalidateDisplayConfigSnapshots();
+  const auto requeried_devices {m_layer.queryDisplayConfig(display_device::QueryType::Active)};
+  ASSERT_TRUE(requeried_devices);
+  EXPECT_EQ(requeried_devices->m_paths.size(), active_devices->m_paths.size());
+}
+
 TEST_F_S(GetDeviceId) {
   const auto all_devices {m_layer.queryDisplayConfig(display_device::QueryType::All)};
   ASSERT_TRUE(all_devices);
@@ -209,6 +235,14 @@ TEST_F_S(SetHdrState, InvalidPath) {
   EXPECT_FALSE(m_layer.setHdrState(INVALID_PATH, display_device::HdrState::Enabled));
 }
 
+TEST_F_S(SetHdrStates, InvalidPaths) {
+  EXPECT_EQ(m_layer.setHdrStates({{INVALID_PATH, display_device::HdrState::Enabled}, {INVALID_PATH, display_device::HdrState::Disabled}, {INVALID_PATH, display_device::HdrState::Enabled}}), std::vector<bool>({false, false, false}));
+}
+
+TEST_F_S(SetHdrStates, EmptyList) {
+  EXPECT_EQ(m_layer.setHdrStates({}), std::vector<bool> {});
+}
+
 TEST_F_S(GetDisplayScale) {
   const auto active_devices {m_layer.queryDisplayConfig(display_device::QueryType::Active)};
   ASSERT_TRUE(active_devices);
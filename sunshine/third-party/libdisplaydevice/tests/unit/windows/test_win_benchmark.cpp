@@ -0,0 +1,228 @@
+// system includes
+#include <chrono>
+#include <sstream>
+
+// local includes
+#include "display_device/windows/json.h"
+#include "display_device/windows/settings_manager.h"
+#include "display_device/windows/win_api_layer.h"
+#include "display_device/windows/win_display_device.h"
+#include "fixtures/fixtures.h"
+#include "utils/counting_win_api_layer.h"
+#include "utils/mock_win_api_layer.h"
+
+namespace {
+  // Convenience keywords for GMock
+  using ::testing::_;
+  using ::testing::HasSubstr;
+  using ::testing::Invoke;
+  using ::testing::NiceMock;
+  using ::testing::Return;
+  using ::testing::StrictMock;
+
+  // Convenience stuff for GTest
+#define GTEST_DISABLED_CLASS_NAME(x) DISABLED_##x
+
+  // Additional convenience global const(s)
+  using namespace std::chrono_literals;
+
+  // Roughly what the real OS calls take on a desktop with a couple of monitors
+  const display_device::CountingWinApiLayer::Latencies REALISTIC_LATENCIES {
+    .m_query_display_config = 2ms,
+    .m_set_display_config = 250ms,
+    .m_device_info = 200us,
+    .m_hdr = 50ms
+  };
+
+  std::string formatCallCounts(const display_device::CountingWinApiLayer &layer) {
+    std::stringstream stream;
+    for (const auto &[method, count] : layer.getCallCounts()) {
+      stream << "\n  " << method << ": " << count;
+    }
+    stream << "\n  total time in layer: " << std::chrono::duration_cast<std::chrono::milliseconds>(layer.getTotalCallTime()).count() << "ms";
+    return stream.str();
+  }
+
+  // Test fixture(s) for this file
+  class CountingWinApiLayerMocked: public BaseTest {
+  public:
+    std::shared_ptr<StrictMock<display_device::MockWinApiLayer>> m_layer {std::make_shared<StrictMock<display_device::MockWinApiLayer>>()};
+  };
+
+  class GTEST_DISABLED_CLASS_NAME(WinBenchmark):
+      public BaseTest {
+  public:
+    bool isOutputSuppressed() const override {
+      return false;
+    }
+
+    std::optional<display_device::Logger::LogLevel> getDefaultLogLevel() const override {
+      return BaseTest::getDefaultLogLevel().value_or(display_device::Logger::LogLevel::info);
+    }
+
+    // Simulates the 3 active displays from the UT data with the OS latencies applied on top
+    std::shared_ptr<display_device::CountingWinApiLayer> makeSimulatedLayer() {
+      auto layer {std::make_shared<NiceMock<display_device::MockWinApiLayer>>()};
+      const auto id_suffix {[](const DISPLAYCONFIG_PATH_INFO &path) {
+        return std::to_string(path.sourceInfo.id);
+      }};
+
+      ON_CALL(*layer, queryDisplayConfig(_))
+        .WillByDefault(Return(ut_consts::PAM_3_ACTIVE));
+      ON_CALL(*layer, getMonitorDevicePath(_))
+        .WillByDefault(Invoke([id_suffix](const auto &path) {
+          return "Path" + id_suffix(path);
+        }));
+      ON_CALL(*layer, getDeviceId(_))
+        .WillByDefault(Invoke([id_suffix](const auto &path) {
+          return "DeviceId" + id_suffix(path);
+        }));
+      ON_CALL(*layer, getDisplayName(_))
+        .WillByDefault(Invoke([id_suffix](const auto &path) {
+          return "DisplayName" + id_suffix(path);
+        }));
+      ON_CALL(*layer, setDisplayConfig(_, _, _))
+        .WillByDefault(Return(ERROR_SUCCESS));
+      ON_CALL(*layer, setHdrState(_, _))
+        .WillByDefault(Return(true));
+      ON_CALL(*layer, setHdrStates(_))
+        .WillByDefault(Invoke([](const auto &states) {
+          return std::vector<bool>(states.size(), true);
+        }));
+
+      return std::make_shared<display_device::CountingWinApiLayer>(layer, REALISTIC_LATENCIES);
+    }
+
+    display_device::SettingsManager makeSettingsManager(const std::shared_ptr<display_device::CountingWinApiLayer> &layer) {
+      return display_device::SettingsManager {
+        std::make_shared<display_device::WinDisplayDevice>(layer),
+        nullptr,
+        std::make_unique<display_device::PersistentState>(nullptr),
+        {}
+      };
+    }
+
+    // Runs the function and logs the elapsed time with the OS calls made during it
+    template<class FunctionT>
+    void measure(const std::string &scenario, display_device::CountingWinApiLayer &layer, FunctionT &&function) {
+      layer.resetCallCounts();
+
+      const auto start {std::chrono::steady_clock::now()};
+      function();
+      const auto elapsed {std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start)};
+
+      DD_LOG(info) << scenario << " took " << elapsed.count() << "ms, OS calls:" << formatCallCounts(layer);
+    }
+  };
+
+  // Specialized TEST macro(s) for this test file
+#define TEST_F_S_MOCKED(...) DD_MAKE_TEST(TEST_F, CountingWinApiLayerMocked, __VA_ARGS__)
+#define TEST_F_S_BENCHMARK(...) DD_MAKE_TEST(TEST_F, GTEST_DISABLED_CLASS_NAME(WinBenchmark), __VA_ARGS__)
+}  // namespace
+
+TEST_F_S_MOCKED(NullptrLayerProvided) {
+  EXPECT_THAT([]() {
+    const auto layer {display_device::CountingWinApiLayer {nullptr}};
+  },
+              ThrowsMessage<std::logic_error>(HasSubstr("Nullptr provided for WinApiLayerInterface in CountingWinApiLayer!")));
+}
+
+TEST_F_S_MOCKED(CallsCounted) {
+  EXPECT_CALL(*m_layer, queryDisplayConfig(display_device::QueryType::Active))
+    .Times(2)
+    .WillRepeatedly(Return(ut_consts::PAM_3_ACTIVE));
+  EXPECT_CALL(*m_layer, setDisplayConfig(_, _, _))
+    .Times(1)
+    .WillOnce(Return(ERROR_SUCCESS));
+  EXPECT_CALL(*m_layer, getErrorString(ERROR_SUCCESS))
+    .Times(1)
+    .WillOnce(Return("ErrorString"));
+
+  display_device::CountingWinApiLayer layer {m_layer};
+  EXPECT_EQ(layer.queryDisplayConfig(display_device::QueryType::Active), ut_consts::PAM_3_ACTIVE);
+  EXPECT_EQ(layer.queryDisplayConfig(display_device::QueryType::Active), ut_consts::PAM_3_ACTIVE);
+  EXPECT_EQ(layer.setDisplayConfig({}, {}, 0), ERROR_SUCCESS);
+  EXPECT_EQ(layer.getErrorString(ERROR_SUCCESS), "ErrorString");
+
+  // Error strings are not OS calls worth counting
+  const std::map<std::string, int> expected_counts {{"queryDisplayConfig", 2}, {"setDisplayConfig", 1}};
+  EXPECT_EQ(layer.getCallCounts(), expected_counts);
+  EXPECT_EQ(layer.getCallCount("queryDisplayConfig"), 2);
+  EXPECT_EQ(layer.getCallCount("getEdid"), 0);
+
+  layer.resetCallCounts();
+  EXPECT_TRUE(layer.getCallCounts().empty());
+  EXPECT_EQ(layer.getTotalCallTime(), std::chrono::microseconds::zero());
+}
+
+TEST_F_S_MOCKED(LatencySimulated) {
+  EXPECT_CALL(*m_layer, setDisplayConfig(_, _, _))
+    .Times(1)
+    .WillOnce(Return(ERROR_SUCCESS));
+
+  display_device::CountingWinApiLayer layer {m_layer, {.m_set_display_config = 20ms}};
+  const auto start {std::chrono::steady_clock::now()};
+  EXPECT_EQ(layer.setDisplayConfig({}, {}, 0), ERROR_SUCCESS);
+
+  EXPECT_GE(std::chrono::steady_clock::now() - start, 20ms);
+  EXPECT_GE(layer.getTotalCallTime(), 20ms);
+}
+
+TEST_F_S_BENCHMARK(Simulated, EnumAvailableDevices) {
+  // Usage example:
+  //   test_libdisplaydevice.exe --gtest_color=yes --gtest_also_run_disabled_tests --gtest_filter=*WinBenchmark.*
+  const auto layer {makeSimulatedLayer()};
+  auto settings_manager {makeSettingsManager(layer)};
+
+  measure("enumAvailableDevices", *layer, [&]() {
+    static_cast<void>(settings_manager.enumAvailableDevices());
+  });
+  EXPECT_GT(layer->getCallCount("queryDisplayConfig"), 0);
+}
+
+TEST_F_S_BENCHMARK(Simulated, ApplyAndRevertSettings) {
+  const auto layer {makeSimulatedLayer()};
+  auto settings_manager {makeSettingsManager(layer)};
+
+  const std::vector<std::pair<std::string, display_device::SingleDisplayConfiguration>> scenarios {
+    {"VerifyOnly", {.m_device_prep = display_device::SingleDisplayConfiguration::DevicePreparation::VerifyOnly}},
+    {"EnsurePrimary", {.m_device_id = "DeviceId2", .m_device_prep = display_device::SingleDisplayConfiguration::DevicePreparation::EnsurePrimary}},
+    {"EnsureOnlyDisplay", {.m_device_id = "DeviceId2", .m_device_prep = display_device::SingleDisplayConfiguration::DevicePreparation::EnsureOnlyDisplay}},
+    {"EnsurePrimary with resolution", {.m_device_id = "DeviceId2", .m_device_prep = display_device::SingleDisplayConfiguration::DevicePreparation::EnsurePrimary, .m_resolution = display_device::Resolution {1920, 1080}}}
+  };
+
+  for (const auto &[name, config] : scenarios) {
+    measure("applySettings (" + name + ")", *layer, [&]() {
+      DD_LOG(info) << "applySettings result: " << static_cast<int>(settings_manager.applySettings(config));
+    });
+    measure("revertSettings (" + name + ")", *layer, [&]() {
+      DD_LOG(info) << "revertSettings result: " << static_cast<int>(settings_manager.revertSettings());
+    });
+  }
+}
+
+TEST_F_S_BENCHMARK(System, ApplyAndRevertSettings) {
+  // Usage example:
+  //   test_libdisplaydevice.exe --gtest_color=yes --gtest_also_run_disabled_tests --gtest_filter=*WinBenchmark.System* config='{\"device_id\":\"\",\"device_prep\":\"VerifyOnly\",\"hdr_state\":null,\"refresh_rate\":null,\"resolution\":null}'
+  const auto config_arg {getArgWithMatchingPattern(R"(^config=)", true)};
+  if (!config_arg) {
+    GTEST_FAIL() << "\"config=<json_string>\" argument not found!";
+  }
+
+  std::string parse_error {};
+  display_device::SingleDisplayConfiguration config;
+  if (!fromJson(*config_arg, config, &parse_error)) {
+    GTEST_FAIL() << "Config argument could not be parsed!\nArgument:\n  " << *config_arg << "\nError:\n  " << parse_error;
+  }
+
+  // No simulated latencies here, the real OS calls are measured
+  const auto layer {std::make_shared<display_device::CountingWinApiLayer>(std::make_shared<display_device::WinApiLayer>())};
+  auto settings_manager {makeSettingsManager(layer)};
+
+  measure("applySettings", *layer, [&]() {
+    DD_LOG(info) << "applySettings result: " << static_cast<int>(settings_manager.applySettings(config));
+  });
+  measure("revertSettings", *layer, [&]() {
+    DD_LOG(info) << "revertSettings result: " << static_cast<int>(settings_manager.revertSettings());
+  });
+}
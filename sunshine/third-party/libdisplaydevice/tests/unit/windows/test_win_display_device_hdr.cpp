@@ -14,6 +14,9 @@ namespace {
   using ::testing::Return;
   using ::testing::StrictMock;
 
+  // Convenience type for the WinApiLayerInterface::setHdrStates argument
+  using PathsAndStates = std::vector<std::pair<DISPLAYCONFIG_PATH_INFO, display_device::HdrState>>;
+
   // Test fixture(s) for this file
   class WinDisplayDeviceHdr: public BaseTest {
   public:
@@ -154,16 +157,16 @@ TEST_F_S_MOCKED(SetHdrStates) {
     .Times(1)
     .WillOnce(Return(std::make_optional(display_device::HdrState::Disabled)))
     .RetiresOnSaturation();
-  EXPECT_CALL(*m_layer, setHdrState(ut_consts::PAM_3_ACTIVE->m_paths.at(0), display_device::HdrState::Enabled))
-    .Times(1)
-    .WillOnce(Return(true))
-    .RetiresOnSaturation();
 
   setupExpectedGetActivePathCall(3, sequence);
   EXPECT_CALL(*m_layer, getHdrState(ut_consts::PAM_3_ACTIVE->m_paths.at(2)))
     .Times(1)
     .WillOnce(Return(std::make_optional(display_device::HdrState::Enabled)))
     .RetiresOnSaturation();
+  EXPECT_CALL(*m_layer, setHdrStates(PathsAndStates {{ut_consts::PAM_3_ACTIVE->m_paths.at(0), display_device::HdrState::Enabled}}))
+    .Times(1)
+    .WillOnce(Return(std::vector<bool> {true}))
+    .RetiresOnSaturation();
 
   const display_device::HdrStateMap new_states {
     {"DeviceId1", std::make_optional(display_device::HdrState::Enabled)},
@@ -203,6 +206,40 @@ TEST_F_S_MOCKED(SetHdrStates, FailedToGetHdrState) {
   EXPECT_FALSE(m_win_dd.setHdrStates(new_states));
 }
 
+TEST_F_S_MOCKED(SetHdrStates, FailedToGetHdrState, LastDevice, NothingChanged) {
+  InSequence sequence;
+  EXPECT_CALL(*m_layer, queryDisplayConfig(display_device::QueryType::Active))
+    .Times(1)
+    .WillOnce(Return(ut_consts::PAM_4_ACTIVE_WITH_2_DUPLICATES))
+    .RetiresOnSaturation();
+
+  setupExpectedGetActivePathCall(1, sequence);
+  EXPECT_CALL(*m_layer, getHdrState(ut_consts::PAM_4_ACTIVE_WITH_2_DUPLICATES->m_paths.at(0)))
+    .Times(1)
+    .WillOnce(Return(std::make_optional(display_device::HdrState::Disabled)))
+    .RetiresOnSaturation();
+
+  setupExpectedGetActivePathCall(3, sequence);
+  EXPECT_CALL(*m_layer, getHdrState(ut_consts::PAM_4_ACTIVE_WITH_2_DUPLICATES->m_paths.at(2)))
+    .Times(1)
+    .WillOnce(Return(std::make_optional(display_device::HdrState::Disabled)))
+    .RetiresOnSaturation();
+
+  setupExpectedGetActivePathCall(4, sequence);
+  EXPECT_CALL(*m_layer, getHdrState(ut_consts::PAM_4_ACTIVE_WITH_2_DUPLICATES->m_paths.at(3)))
+    .Times(1)
+    .WillOnce(Return(std::nullopt))
+    .RetiresOnSaturation();
+
+  const display_device::HdrStateMap new_states {
+    {"DeviceId1", std::make_optional(display_device::HdrState::Enabled)},
+    {"DeviceId2", std::nullopt},
+    {"DeviceId3", std::make_optional(display_device::HdrState::Disabled)},
+    {"DeviceId4", std::make_optional(display_device::HdrState::Enabled)}
+  };
+  EXPECT_FALSE(m_win_dd.setHdrStates(new_states));
+}
+
 TEST_F_S_MOCKED(SetHdrStates, FailedToSetHdrState, LastDevice) {
   InSequence sequence;
   EXPECT_CALL(*m_layer, queryDisplayConfig(display_device::QueryType::Active))
@@ -217,10 +254,6 @@ TEST_F_S_MOCKED(SetHdrStates, FailedToSetHdrState, LastDevice) {
       .Times(1)
       .WillOnce(Return(std::make_optional(display_device::HdrState::Disabled)))
       .RetiresOnSaturation();
-    EXPECT_CALL(*m_layer, setHdrState(ut_consts::PAM_4_ACTIVE_WITH_2_DUPLICATES->m_paths.at(0), display_device::HdrState::Enabled))
-      .Times(1)
-      .WillOnce(Return(true))
-      .RetiresOnSaturation();
 
     setupExpectedGetActivePathCall(3, sequence);
     EXPECT_CALL(*m_layer, getHdrState(ut_consts::PAM_4_ACTIVE_WITH_2_DUPLICATES->m_paths.at(2)))
@@ -231,7 +264,11 @@ TEST_F_S_MOCKED(SetHdrStates, FailedToSetHdrState, LastDevice) {
     setupExpectedGetActivePathCall(4, sequence);
     EXPECT_CALL(*m_layer, getHdrState(ut_consts::PAM_4_ACTIVE_WITH_2_DUPLICATES->m_paths.at(3)))
       .Times(1)
-      .WillOnce(Return(std::nullopt))
+      .WillOnce(Return(std::make_optional(display_device::HdrState::Disabled)))
+      .RetiresOnSaturation();
+    EXPECT_CALL(*m_layer, setHdrStates(PathsAndStates {{ut_consts::PAM_4_ACTIVE_WITH_2_DUPLICATES->m_paths.at(0), display_device::HdrState::Enabled}, {ut_consts::PAM_4_ACTIVE_WITH_2_DUPLICATES->m_paths.at(3), display_device::HdrState::Enabled}}))
+      .Times(1)
+      .WillOnce(Return(std::vector<bool> {true, false}))
       .RetiresOnSaturation();
   }
 
@@ -242,9 +279,9 @@ TEST_F_S_MOCKED(SetHdrStates, FailedToSetHdrState, LastDevice) {
       .Times(1)
       .WillOnce(Return(std::make_optional(display_device::HdrState::Enabled)))
       .RetiresOnSaturation();
-    EXPECT_CALL(*m_layer, setHdrState(ut_consts::PAM_4_ACTIVE_WITH_2_DUPLICATES->m_paths.at(0), display_device::HdrState::Disabled))
+    EXPECT_CALL(*m_layer, setHdrStates(PathsAndStates {{ut_consts::PAM_4_ACTIVE_WITH_2_DUPLICATES->m_paths.at(0), display_device::HdrState::Disabled}}))
       .Times(1)
-      .WillOnce(Return(true))
+      .WillOnce(Return(std::vector<bool> {true}))
       .RetiresOnSaturation();
   }
 
@@ -271,35 +308,27 @@ TEST_F_S_MOCKED(SetHdrStates, FailedToSetHdrState, LastDevice, NoEarlyExitInReco
       .Times(1)
       .WillOnce(Return(std::make_optional(display_device::HdrState::Disabled)))
       .RetiresOnSaturation();
-    EXPECT_CALL(*m_layer, setHdrState(ut_consts::PAM_4_ACTIVE_WITH_2_DUPLICATES->m_paths.at(0), display_device::HdrState::Enabled))
-      .Times(1)
-      .WillOnce(Return(true))
-      .RetiresOnSaturation();
 
     setupExpectedGetActivePathCall(2, sequence);
     EXPECT_CALL(*m_layer, getHdrState(ut_consts::PAM_4_ACTIVE_WITH_2_DUPLICATES->m_paths.at(1)))
       .Times(1)
       .WillOnce(Return(std::make_optional(display_device::HdrState::Disabled)))
       .RetiresOnSaturation();
-    EXPECT_CALL(*m_layer, setHdrState(ut_consts::PAM_4_ACTIVE_WITH_2_DUPLICATES->m_paths.at(1), display_device::HdrState::Enabled))
-      .Times(1)
-      .WillOnce(Return(true))
-      .RetiresOnSaturation();
 
     setupExpectedGetActivePathCall(3, sequence);
     EXPECT_CALL(*m_layer, getHdrState(ut_consts::PAM_4_ACTIVE_WITH_2_DUPLICATES->m_paths.at(2)))
       .Times(1)
       .WillOnce(Return(std::make_optional(display_device::HdrState::Disabled)))
       .RetiresOnSaturation();
-    EXPECT_CALL(*m_layer, setHdrState(ut_consts::PAM_4_ACTIVE_WITH_2_DUPLICATES->m_paths.at(2), display_device::HdrState::Enabled))
-      .Times(1)
-      .WillOnce(Return(true))
-      .RetiresOnSaturation();
 
     setupExpectedGetActivePathCall(4, sequence);
     EXPECT_CALL(*m_layer, getHdrState(ut_consts::PAM_4_ACTIVE_WITH_2_DUPLICATES->m_paths.at(3)))
       .Times(1)
-      .WillOnce(Return(std::nullopt))
+      .WillOnce(Return(std::make_optional(display_device::HdrState::Disabled)))
+      .RetiresOnSaturation();
+    EXPECT_CALL(*m_layer, setHdrStates(PathsAndStates {{ut_consts::PAM_4_ACTIVE_WITH_2_DUPLICATES->m_paths.at(0), display_device::HdrState::Enabled}, {ut_consts::PAM_4_ACTIVE_WITH_2_DUPLICATES->m_paths.at(1), display_device::HdrState::Enabled}, {ut_consts::PAM_4_ACTIVE_WITH_2_DUPLICATES->m_paths.at(2), display_device::HdrState::Enabled}, {ut_consts::PAM_4_ACTIVE_WITH_2_DUPLICATES->m_paths.at(3), display_device::HdrState::Enabled}}))
+      .Times(1)
+      .WillOnce(Return(std::vector<bool> {true, true, true, false}))
       .RetiresOnSaturation();
   }
 
@@ -310,10 +339,6 @@ TEST_F_S_MOCKED(SetHdrStates, FailedToSetHdrState, LastDevice, NoEarlyExitInReco
       .Times(1)
       .WillOnce(Return(std::make_optional(display_device::HdrState::Enabled)))
       .RetiresOnSaturation();
-    EXPECT_CALL(*m_layer, setHdrState(ut_consts::PAM_4_ACTIVE_WITH_2_DUPLICATES->m_paths.at(0), display_device::HdrState::Disabled))
-      .Times(1)
-      .WillOnce(Return(false))
-      .RetiresOnSaturation();
 
     setupExpectedGetActivePathCall(2, sequence);
     EXPECT_CALL(*m_layer, getHdrState(ut_consts::PAM_4_ACTIVE_WITH_2_DUPLICATES->m_paths.at(1)))
@@ -326,9 +351,9 @@ TEST_F_S_MOCKED(SetHdrStates, FailedToSetHdrState, LastDevice, NoEarlyExitInReco
       .Times(1)
       .WillOnce(Return(std::make_optional(display_device::HdrState::Enabled)))
       .RetiresOnSaturation();
-    EXPECT_CALL(*m_layer, setHdrState(ut_consts::PAM_4_ACTIVE_WITH_2_DUPLICATES->m_paths.at(2), display_device::HdrState::Disabled))
+    EXPECT_CALL(*m_layer, setHdrStates(PathsAndStates {{ut_consts::PAM_4_ACTIVE_WITH_2_DUPLICATES->m_paths.at(0), display_device::HdrState::Disabled}, {ut_consts::PAM_4_ACTIVE_WITH_2_DUPLICATES->m_paths.at(2), display_device::HdrState::Disabled}}))
       .Times(1)
-      .WillOnce(Return(true))
+      .WillOnce(Return(std::vector<bool> {false, true}))
       .RetiresOnSaturation();
   }
 
@@ -425,6 +425,14 @@ TEST_F_S_MOCKED(SetDisplayModes, EmptyModeMap) {
   EXPECT_FALSE(m_win_dd.setDisplayModes({}));
 }
 
+TEST_F_S_MOCKED(SetDisplayModesAndPrimary, EmptyDeviceId) {
+  EXPECT_FALSE(m_win_dd.setDisplayModesAndPrimary({{"DeviceId1", {}}}, ""));
+}
+
+TEST_F_S_MOCKED(SetDisplayModesAndPrimary, EmptyModeMap) {
+  EXPECT_FALSE(m_win_dd.setDisplayModesAndPrimary({}, "DeviceId1"));
+}
+
 TEST_F_S_MOCKED(SetDisplayModes, FailedToGetDuplicateDevices) {
   EXPECT_CALL(*m_layer, queryDisplayConfig(display_device::QueryType::Active))
     .Times(1)
@@ -0,0 +1,120 @@
+// header include
+#include "counting_win_api_layer.h"
+
+// system includes
+#include <stdexcept>
+#include <thread>
+
+namespace display_device {
+  CountingWinApiLayer::CountingWinApiLayer(std::shared_ptr<WinApiLayerInterface> layer):
+      CountingWinApiLayer(std::move(layer), Latencies {}) {
+  }
+
+  CountingWinApiLayer::CountingWinApiLayer(std::shared_ptr<WinApiLayerInterface> layer, Latencies latencies):
+      m_layer {layer ? std::move(layer) : throw std::logic_error {"Nullptr provided for WinApiLayerInterface in CountingWinApiLayer!"}},
+      m_latencies {latencies} {
+  }
+
+  std::string CountingWinApiLayer::getErrorString(const LONG error_code) const {
+    // Not an OS call worth counting
+    return m_layer->getErrorString(error_code);
+  }
+
+  std::optional<PathAndModeData> CountingWinApiLayer::queryDisplayConfig(const QueryType type) const {
+    return countCall("queryDisplayConfig", m_latencies.m_query_display_config, [&]() {
+      return m_layer->queryDisplayConfig(type);
+    });
+  }
+
+  std::string CountingWinApiLayer::getDeviceId(const DISPLAYCONFIG_PATH_INFO &path) const {
+    return countCall("getDeviceId", m_latencies.m_device_info, [&]() {
+      return m_layer->getDeviceId(path);
+    });
+  }
+
+  std::vector<std::byte> CountingWinApiLayer::getEdid(const DISPLAYCONFIG_PATH_INFO &path) const {
+    return countCall("getEdid", m_latencies.m_device_info, [&]() {
+      return m_layer->getEdid(path);
+    });
+  }
+
+  std::string CountingWinApiLayer::getMonitorDevicePath(const DISPLAYCONFIG_PATH_INFO &path) const {
+    return countCall("getMonitorDevicePath", m_latencies.m_device_info, [&]() {
+      return m_layer->getMonitorDevicePath(path);
+    });
+  }
+
+  std::string CountingWinApiLayer::getFriendlyName(const DISPLAYCONFIG_PATH_INFO &path) const {
+    return countCall("getFriendlyName", m_latencies.m_device_info, [&]() {
+      return m_layer->getFriendlyName(path);
+    });
+  }
+
+  std::string CountingWinApiLayer::getDisplayName(const DISPLAYCONFIG_PATH_INFO &path) const {
+    return countCall("getDisplayName", m_latencies.m_device_info, [&]() {
+      return m_layer->getDisplayName(path);
+    });
+  }
+
+  LONG CountingWinApiLayer::setDisplayConfig(std::vector<DISPLAYCONFIG_PATH_INFO> paths, std::vector<DISPLAYCONFIG_MODE_INFO> modes, const UINT32 flags) {
+    return countCall("setDisplayConfig", m_latencies.m_set_display_config, [&]() {
+      return m_layer->setDisplayConfig(std::move(paths), std::move(modes), flags);
+    });
+  }
+
+  std::optional<HdrState> CountingWinApiLayer::getHdrState(const DISPLAYCONFIG_PATH_INFO &path) const {
+    return countCall("getHdrState", m_latencies.m_device_info, [&]() {
+      return m_layer->getHdrState(path);
+    });
+  }
+
+  bool CountingWinApiLayer::setHdrState(const DISPLAYCONFIG_PATH_INFO &path, const HdrState state) {
+    return countCall("setHdrState", m_latencies.m_hdr, [&]() {
+      return m_layer->setHdrState(path, state);
+    });
+  }
+
+  std::vector<bool> CountingWinApiLayer::setHdrStates(const std::vector<std::pair<DISPLAYCONFIG_PATH_INFO, HdrState>> &states) {
+    // The changes are made concurrently, so the latency is paid once for all of them
+    return countCall("setHdrStates", m_latencies.m_hdr, [&]() {
+      return m_layer->setHdrStates(states);
+    });
+  }
+
+  std::optional<Rational> CountingWinApiLayer::getDisplayScale(const std::string &display_name, const DISPLAYCONFIG_SOURCE_MODE &source_mode) const {
+    return countCall("getDisplayScale", m_latencies.m_device_info, [&]() {
+      return m_layer->getDisplayScale(display_name, source_mode);
+    });
+  }
+
+  const std::map<std::string, int> &CountingWinApiLayer::getCallCounts() const {
+    return m_call_counts;
+  }
+
+  int CountingWinApiLayer::getCallCount(const std::string &method) const {
+    const auto count_it {m_call_counts.find(method)};
+    return count_it == std::end(m_call_counts) ? 0 : count_it->second;
+  }
+
+  std::chrono::microseconds CountingWinApiLayer::getTotalCallTime() const {
+    return m_total_call_time;
+  }
+
+  void CountingWinApiLayer::resetCallCounts() {
+    m_call_counts.clear();
+    m_total_call_time = std::chrono::microseconds {0};
+  }
+
+  template<class FunctionT>
+  auto CountingWinApiLayer::countCall(const std::string &method, const std::chrono::microseconds latency, FunctionT &&call) const {
+    const auto start {std::chrono::steady_clock::now()};
+    if (latency > std::chrono::microseconds::zero()) {
+      std::this_thread::sleep_for(latency);
+    }
+
+    auto result {call()};
+    m_call_counts[method]++;
+    m_total_call_time += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    return result;
+  }
+}  // namespace display_device
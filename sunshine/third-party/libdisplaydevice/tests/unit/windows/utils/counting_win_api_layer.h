@@ -0,0 +1,55 @@
+#pragma once
+
+// system includes
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+
+// local includes
+#include "display_device/windows/win_api_layer_interface.h"
+
+namespace display_device {
+  // Wraps another layer to count the calls made to the OS and to (optionally) simulate the OS latencies
+  class CountingWinApiLayer: public WinApiLayerInterface {
+  public:
+    struct Latencies {
+      std::chrono::microseconds m_query_display_config {0};
+      std::chrono::microseconds m_set_display_config {0};
+      std::chrono::microseconds m_device_info {0};  // For the other queries, like getDeviceId or getEdid
+      std::chrono::microseconds m_hdr {0};
+    };
+
+    explicit CountingWinApiLayer(std::shared_ptr<WinApiLayerInterface> layer);
+    CountingWinApiLayer(std::shared_ptr<WinApiLayerInterface> layer, Latencies latencies);
+
+    [[nodiscard]] std::string getErrorString(LONG error_code) const override;
+    [[nodiscard]] std::optional<PathAndModeData> queryDisplayConfig(QueryType type) const override;
+    [[nodiscard]] std::string getDeviceId(const DISPLAYCONFIG_PATH_INFO &path) const override;
+    [[nodiscard]] std::vector<std::byte> getEdid(const DISPLAYCONFIG_PATH_INFO &path) const override;
+    [[nodiscard]] std::string getMonitorDevicePath(const DISPLAYCONFIG_PATH_INFO &path) const override;
+    [[nodiscard]] std::string getFriendlyName(const DISPLAYCONFIG_PATH_INFO &path) const override;
+    [[nodiscard]] std::string getDisplayName(const DISPLAYCONFIG_PATH_INFO &path) const override;
+    [[nodiscard]] LONG setDisplayConfig(std::vector<DISPLAYCONFIG_PATH_INFO> paths, std::vector<DISPLAYCONFIG_MODE_INFO> modes, UINT32 flags) override;
+    [[nodiscard]] std::optional<HdrState> getHdrState(const DISPLAYCONFIG_PATH_INFO &path) const override;
+    [[nodiscard]] bool setHdrState(const DISPLAYCONFIG_PATH_INFO &path, HdrState state) override;
+    [[nodiscard]] std::vector<bool> setHdrStates(const std::vector<std::pair<DISPLAYCONFIG_PATH_INFO, HdrState>> &states) override;
+    [[nodiscard]] std::optional<Rational> getDisplayScale(const std::string &display_name, const DISPLAYCONFIG_SOURCE_MODE &source_mode) const override;
+
+    // Number of calls per method name, e.g. "queryDisplayConfig"
+    [[nodiscard]] const std::map<std::string, int> &getCallCounts() const;
+    [[nodiscard]] int getCallCount(const std::string &method) const;
+    // Total time spent in the wrapped layer (including the simulated latencies)
+    [[nodiscard]] std::chrono::microseconds getTotalCallTime() const;
+    void resetCallCounts();
+
+  private:
+    template<class FunctionT>
+    auto countCall(const std::string &method, std::chrono::microseconds latency, FunctionT &&call) const;
+
+    std::shared_ptr<WinApiLayerInterface> m_layer;
+    Latencies m_latencies;
+    mutable std::map<std::string, int> m_call_counts;
+    mutable std::chrono::microseconds m_total_call_time {0};
+  };
+}  // namespace display_device
@@ -19,6 +19,7 @@ namespace display_device {
     MOCK_METHOD(LONG, setDisplayConfig, (std::vector<DISPLAYCONFIG_PATH_INFO>, std::vector<DISPLAYCONFIG_MODE_INFO>, UINT32), (override));
     MOCK_METHOD(std::optional<HdrState>, getHdrState, (const DISPLAYCONFIG_PATH_INFO &), (const, override));
     MOCK_METHOD(bool, setHdrState, (const DISPLAYCONFIG_PATH_INFO &, HdrState), (override));
+    MOCK_METHOD(std::vector<bool>, setHdrStates, ((const std::vector<std::pair<DISPLAYCONFIG_PATH_INFO, HdrState>> &)), (override));
     MOCK_METHOD(std::optional<Rational>, getDisplayScale, (const std::string &, const DISPLAYCONFIG_SOURCE_MODE &), (const, override));
   };
 }  // namespace display_device
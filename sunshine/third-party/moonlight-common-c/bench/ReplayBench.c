@@ -0,0 +1,883 @@
+// Offline replay benchmark for the video and audio receive paths
+//
+// Replays the host to client UDP traffic from a pcap capture through the RTP
+// queues, the depacketizer and a fake decoder without any sockets or threads,
+// optionally with synthetic loss and reordering. The loss and reordering are
+// drawn from a seeded PRNG before the replay starts, so runs are repeatable.
+//
+// Packets are fed as fast as possible by default. The queues give up on lost
+// packets after a timeout though, so captures with loss should be replayed
+// with --realtime, which paces them with the capture timestamps.
+//
+// The capture must be from a stream without video encryption (the default on
+// a LAN). Audio packets go through the audio FEC queue but are not decrypted
+// or decoded. Control stream (ENet) packets are counted but not replayed,
+// since they need a live ENet peer and the session keys to be parsed.
+//
+// --scan-bench skips the replay and measures the Annex B start code scan on a
+// synthetic high bitrate HEVC stream instead, checking the vector kernel in use
+// against the scalar one.
+
+#include "Limelight-internal.h"
+
+#include <stdio.h>
+#include <stdarg.h>
+
+#define DEFAULT_BASE_PORT 47989
+#define VIDEO_PORT_OFFSET 9
+#define CONTROL_PORT_OFFSET 10
+#define AUDIO_PORT_OFFSET 11
+
+#define PCAP_MAGIC_USEC 0xA1B2C3D4
+#define PCAP_MAGIC_NSEC 0xA1B23C4D
+#define PCAP_GLOBAL_HEADER_SIZE 24
+
+#define LINKTYPE_NULL 0
+#define LINKTYPE_ETHERNET 1
+#define LINKTYPE_RAW_OLD 12
+#define LINKTYPE_RAW 101
+#define LINKTYPE_LINUX_SLL 113
+#define LINKTYPE_LINUX_SLL2 276
+
+#define ETHERTYPE_VLAN 0x8100
+#define IP_PROTOCOL_UDP 17
+
+#define AUDIO_QUEUED_PACKET_POOL_SIZE 32
+
+// Synthetic stream for --scan-bench: slices of this size, scanned this many times
+#define SCAN_BENCH_SLICE_SIZE (64 * 1024)
+#define SCAN_BENCH_ITERATIONS 16
+
+// Largest distance (in packets of the same stream) a reordered packet is moved
+#define MAX_REORDER_DISTANCE 64
+
+#define STREAM_VIDEO 0
+#define STREAM_AUDIO 1
+#define STREAM_CONTROL 2
+#define STREAM_COUNT 3
+
+typedef struct _REPLAY_PACKET {
+    uint64_t captureTimeUs;
+    char* data;
+    int length;
+    int stream;
+    bool dropped;
+} REPLAY_PACKET, *PREPLAY_PACKET;
+
+typedef struct _REPLAY_OPTIONS {
+    const char* path;
+    int basePort;
+    int packetSize;
+    int videoFormat;
+    int fps;
+    int lossPercent;
+    int reorderPercent;
+    int reorderDistance;
+    int scanBenchMiB;
+    uint32_t seed;
+    bool realtime;
+    bool verbose;
+    const char* serverVersion;
+} REPLAY_OPTIONS, *PREPLAY_OPTIONS;
+
+typedef struct _REPLAY_STREAM_STATS {
+    uint32_t packets;
+    uint32_t dropped;
+    uint32_t reordered;
+    uint64_t bytes;
+    uint64_t timeUs;
+} REPLAY_STREAM_STATS, *PREPLAY_STREAM_STATS;
+
+static REPLAY_OPTIONS options;
+static REPLAY_STREAM_STATS streamStats[STREAM_COUNT];
+static const char* streamNames[STREAM_COUNT] = { "Video", "Audio", "Control" };
+
+static uint32_t framesDecoded;
+static uint32_t idrFramesDecoded;
+static uint32_t framesSkipped;
+static uint64_t frameBytes;
+static int lastFrameNumber;
+static uint32_t audioPacketsOut;
+static uint32_t audioPacketsConcealed;
+
+// Heap calls made by the library while the capture is replayed. They are only
+// counted with glibc, which lets the executable wrap its allocator.
+static bool countAllocations;
+static uint64_t allocationCount;
+
+#if defined(__GLIBC__)
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t count, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+
+void* malloc(size_t size) {
+    if (countAllocations) {
+        allocationCount++;
+    }
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    if (countAllocations) {
+        allocationCount++;
+    }
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    if (countAllocations) {
+        allocationCount++;
+    }
+    return __libc_realloc(ptr, size);
+}
+#endif
+
+// xorshift32, so the synthetic loss pattern only depends on the seed
+static uint32_t nextRandom(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static void logMessage(const char* format, ...) {
+    va_list va;
+
+    if (!options.verbose) {
+        return;
+    }
+
+    va_start(va, format);
+    vfprintf(stderr, format, va);
+    va_end(va);
+}
+
+static int submitDecodeUnit(PDECODE_UNIT decodeUnit) {
+    PLENTRY entry;
+
+    // Walk the buffer list like a decoder copying it into its input buffer would
+    for (entry = decodeUnit->bufferList; entry != NULL; entry = entry->next) {
+        frameBytes += entry->length;
+    }
+
+    if (lastFrameNumber != 0 && decodeUnit->frameNumber > lastFrameNumber + 1) {
+        framesSkipped += decodeUnit->frameNumber - lastFrameNumber - 1;
+    }
+    lastFrameNumber = decodeUnit->frameNumber;
+
+    framesDecoded++;
+    if (decodeUnit->frameType == FRAME_TYPE_IDR) {
+        idrFramesDecoded++;
+    }
+
+    return DR_OK;
+}
+
+static char* readFile(const char* path, long* length) {
+    FILE* file;
+    char* data;
+
+    file = fopen(path, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "Unable to open %s\n", path);
+        return NULL;
+    }
+
+    if (fseek(file, 0, SEEK_END) != 0 || (*length = ftell(file)) < 0 || fseek(file, 0, SEEK_SET) != 0) {
+        fprintf(stderr, "Unable to read %s\n", path);
+        fclose(file);
+        return NULL;
+    }
+
+    data = malloc(*length > 0 ? *length : 1);
+    if (data == NULL || fread(data, 1, *length, file) != (size_t)*length) {
+        fprintf(stderr, "Unable to read %s\n", path);
+        free(data);
+        fclose(file);
+        return NULL;
+    }
+
+    fclose(file);
+    return data;
+}
+
+// Returns the offset of the IP header in a captured frame, or -1 if it can't be found
+static int getNetworkHeaderOffset(char* frame, int length, uint32_t linkType) {
+    BYTE_BUFFER bb;
+    uint16_t etherType;
+
+    BbInitializeWrappedBuffer(&bb, frame, 0, length, BYTE_ORDER_BIG);
+
+    switch (linkType) {
+    case LINKTYPE_RAW:
+    case LINKTYPE_RAW_OLD:
+        return 0;
+
+    case LINKTYPE_NULL:
+        // The address family is in host order, so just check the IP version after it
+        return length > 4 ? 4 : -1;
+
+    case LINKTYPE_ETHERNET:
+        if (!BbAdvanceBuffer(&bb, 12) || !BbGet16(&bb, &etherType)) {
+            return -1;
+        }
+        while (etherType == ETHERTYPE_VLAN) {
+            if (!BbAdvanceBuffer(&bb, 2) || !BbGet16(&bb, &etherType)) {
+                return -1;
+            }
+        }
+        return bb.position;
+
+    case LINKTYPE_LINUX_SLL:
+        return length > 16 ? 16 : -1;
+
+    case LINKTYPE_LINUX_SLL2:
+        return length > 20 ? 20 : -1;
+
+    default:
+        return -1;
+    }
+}
+
+// Finds the UDP payload of a captured frame. Returns false if it isn't a
+// complete, unfragmented UDP datagram.
+static bool getUdpPayload(char* frame, int length, uint32_t linkType, uint16_t* sourcePort, char** payload, int* payloadLength) {
+    BYTE_BUFFER bb;
+    int offset;
+    int udpLength;
+    uint8_t version;
+    uint16_t udpLength16;
+
+    offset = getNetworkHeaderOffset(frame, length, linkType);
+    if (offset < 0) {
+        return false;
+    }
+
+    BbInitializeWrappedBuffer(&bb, frame, offset, length - offset, BYTE_ORDER_BIG);
+    if (!BbGet8(&bb, &version)) {
+        return false;
+    }
+
+    if ((version >> 4) == 4) {
+        uint16_t fragment;
+        uint8_t protocol;
+        int headerLength = (version & 0xF) * 4;
+
+        // Skip the TOS and total length to the fragmentation fields
+        if (headerLength < 20 || !BbAdvanceBuffer(&bb, 5) || !BbGet16(&bb, &fragment) ||
+                !BbAdvanceBuffer(&bb, 1) || !BbGet8(&bb, &protocol)) {
+            return false;
+        }
+
+        // Fragmented datagrams (MF set or non-zero offset) are not reassembled
+        if (protocol != IP_PROTOCOL_UDP || (fragment & 0x3FFF) != 0) {
+            return false;
+        }
+
+        offset += headerLength;
+    }
+    else if ((version >> 4) == 6) {
+        uint8_t nextHeader;
+
+        // Extension headers are not followed
+        if (!BbAdvanceBuffer(&bb, 5) || !BbGet8(&bb, &nextHeader) || nextHeader != IP_PROTOCOL_UDP) {
+            return false;
+        }
+
+        offset += 40;
+    }
+    else {
+        return false;
+    }
+
+    BbInitializeWrappedBuffer(&bb, frame, offset, length - offset, BYTE_ORDER_BIG);
+    if (!BbGet16(&bb, sourcePort) || !BbAdvanceBuffer(&bb, 2) || !BbGet16(&bb, &udpLength16)) {
+        return false;
+    }
+
+    // Truncated by the capture snap length
+    udpLength = udpLength16;
+    if (udpLength < 8 || offset + udpLength > length) {
+        return false;
+    }
+
+    *payload = frame + offset + 8;
+    *payloadLength = udpLength - 8;
+    return true;
+}
+
+// Parses the capture into the list of host to client datagrams of the streams
+static PREPLAY_PACKET loadCapture(char* data, long length, int* packetCount) {
+    BYTE_BUFFER bb;
+    PREPLAY_PACKET packets;
+    int packetsAllocated;
+    uint32_t magic, linkType;
+    int byteOrder;
+    bool nanosecondTimestamps;
+
+    if (length < PCAP_GLOBAL_HEADER_SIZE) {
+        fprintf(stderr, "Capture is too short\n");
+        return NULL;
+    }
+
+    BbInitializeWrappedBuffer(&bb, data, 0, (int)length, BYTE_ORDER_LITTLE);
+    BbGet32(&bb, &magic);
+    if (magic == PCAP_MAGIC_USEC || magic == PCAP_MAGIC_NSEC) {
+        byteOrder = BYTE_ORDER_LITTLE;
+    }
+    else if (BE32(magic) == PCAP_MAGIC_USEC || BE32(magic) == PCAP_MAGIC_NSEC) {
+        byteOrder = BYTE_ORDER_BIG;
+    }
+    else {
+        fprintf(stderr, "Not a pcap capture (pcapng must be converted first)\n");
+        return NULL;
+    }
+    nanosecondTimestamps = magic == PCAP_MAGIC_NSEC || BE32(magic) == PCAP_MAGIC_NSEC;
+
+    bb.byteOrder = byteOrder;
+    BbAdvanceBuffer(&bb, 16);
+    BbGet32(&bb, &linkType);
+
+    packets = NULL;
+    packetsAllocated = 0;
+    *packetCount = 0;
+
+    for (;;) {
+        uint32_t seconds, fraction;
+        uint32_t capturedLength;
+        uint16_t sourcePort;
+        char* frame;
+        char* payload;
+        int payloadLength;
+        int stream;
+
+        if (!BbGet32(&bb, &seconds) || !BbGet32(&bb, &fraction) ||
+                !BbGet32(&bb, &capturedLength) || !BbAdvanceBuffer(&bb, 4)) {
+            break;
+        }
+
+        frame = &bb.buffer[bb.position];
+        if (!BbAdvanceBuffer(&bb, (int)capturedLength)) {
+            Limelog("Ignoring truncated capture record\n");
+            break;
+        }
+
+        if (!getUdpPayload(frame, (int)capturedLength, linkType, &sourcePort, &payload, &payloadLength)) {
+            continue;
+        }
+
+        if (sourcePort == options.basePort + VIDEO_PORT_OFFSET) {
+            stream = STREAM_VIDEO;
+        }
+        else if (sourcePort == options.basePort + AUDIO_PORT_OFFSET) {
+            stream = STREAM_AUDIO;
+        }
+        else if (sourcePort == options.basePort + CONTROL_PORT_OFFSET) {
+            stream = STREAM_CONTROL;
+        }
+        else {
+            continue;
+        }
+
+        if (*packetCount == packetsAllocated) {
+            packetsAllocated = packetsAllocated != 0 ? packetsAllocated * 2 : 4096;
+            packets = extendBuffer(packets, packetsAllocated * sizeof(*packets));
+            if (packets == NULL) {
+                fprintf(stderr, "Out of memory\n");
+                return NULL;
+            }
+        }
+
+        packets[*packetCount].captureTimeUs = (uint64_t)seconds * 1000000 + (nanosecondTimestamps ? fraction / 1000 : fraction);
+        packets[*packetCount].data = payload;
+        packets[*packetCount].length = payloadLength;
+        packets[*packetCount].stream = stream;
+        packets[*packetCount].dropped = false;
+        (*packetCount)++;
+    }
+
+    if (*packetCount == 0) {
+        fprintf(stderr, "No stream traffic from base port %d found in the capture\n", options.basePort);
+        free(packets);
+        return NULL;
+    }
+
+    return packets;
+}
+
+// Moves some packets later in their stream and marks others as dropped. Only
+// packets of the same stream are swapped, so the interleaving of streams is kept,
+// and the capture times stay in place for pacing.
+static void applyImpairments(PREPLAY_PACKET packets, int packetCount) {
+    uint32_t state = options.seed != 0 ? options.seed : 1;
+    int i;
+
+    for (i = 0; i < packetCount; i++) {
+        if (options.reorderPercent > 0 && (int)(nextRandom(&state) % 100) < options.reorderPercent) {
+            int distance = 1 + (int)(nextRandom(&state) % options.reorderDistance);
+            int j;
+
+            for (j = i + 1; j < packetCount; j++) {
+                if (packets[j].stream == packets[i].stream && --distance == 0) {
+                    char* data = packets[i].data;
+                    int length = packets[i].length;
+
+                    packets[i].data = packets[j].data;
+                    packets[i].length = packets[j].length;
+                    packets[j].data = data;
+                    packets[j].length = length;
+                    streamStats[packets[j].stream].reordered++;
+                    break;
+                }
+            }
+        }
+
+        if (options.lossPercent > 0 && (int)(nextRandom(&state) % 100) < options.lossPercent) {
+            packets[i].dropped = true;
+            streamStats[packets[i].stream].dropped++;
+        }
+    }
+}
+
+// Uses the largest video datagram to find the packet size negotiated with the host
+static int detectPacketSize(PREPLAY_PACKET packets, int packetCount) {
+    int packetSize = 0;
+    int i;
+
+    for (i = 0; i < packetCount; i++) {
+        if (packets[i].stream == STREAM_VIDEO && packets[i].length > (int)sizeof(RTP_PACKET)) {
+            PRTP_PACKET rtp = (PRTP_PACKET)packets[i].data;
+            int dataOffset = sizeof(*rtp);
+
+            if (rtp->header & FLAG_EXTENSION) {
+                dataOffset += 4;
+            }
+
+            if (packets[i].length - dataOffset > packetSize) {
+                packetSize = packets[i].length - dataOffset;
+            }
+        }
+    }
+
+    return packetSize;
+}
+
+static void replayVideoPacket(PRTP_VIDEO_QUEUE queue, PREPLAY_PACKET replayPacket) {
+    int decryptedSize = StreamConfig.packetSize + MAX_RTP_HEADER_SIZE;
+    PRTP_PACKET packet;
+    char* buffer;
+
+    if (replayPacket->length < (int)sizeof(RTP_PACKET) || replayPacket->length > decryptedSize) {
+        return;
+    }
+
+    buffer = allocVideoPacketBuffer();
+    if (buffer == NULL) {
+        return;
+    }
+
+    // Copy the packet into a receive buffer and convert it like the receive thread does
+    memcpy(buffer, replayPacket->data, replayPacket->length);
+    packet = (PRTP_PACKET)buffer;
+    packet->sequenceNumber = BE16(packet->sequenceNumber);
+    packet->timestamp = BE32(packet->timestamp);
+    packet->ssrc = BE32(packet->ssrc);
+
+    if (RtpvAddPacket(queue, packet, replayPacket->length, PltGetMicroseconds(), (PRTPV_QUEUE_ENTRY)&buffer[decryptedSize]) != RTPF_RET_QUEUED) {
+        freeVideoPacketBuffer(buffer);
+    }
+}
+
+static void replayAudioPacket(PRTP_AUDIO_QUEUE queue, PBUFFER_POOL packetPool, PREPLAY_PACKET replayPacket, char* buffer) {
+    PRTP_PACKET packet;
+    int queueStatus;
+
+    if (replayPacket->length < (int)sizeof(RTP_PACKET) || replayPacket->length > RTPA_MAX_PACKET_SIZE) {
+        return;
+    }
+
+    // The queue copies what it keeps, so the receive buffer can be reused
+    memcpy(buffer, replayPacket->data, replayPacket->length);
+    packet = (PRTP_PACKET)buffer;
+    packet->sequenceNumber = BE16(packet->sequenceNumber);
+    packet->timestamp = BE32(packet->timestamp);
+    packet->ssrc = BE32(packet->ssrc);
+
+    queueStatus = RtpaAddPacket(queue, packet, (uint16_t)replayPacket->length);
+    if (RTPQ_HANDLE_NOW(queueStatus)) {
+        audioPacketsOut++;
+    }
+    else if (RTPQ_PACKET_READY(queueStatus)) {
+        PRTP_PACKET queuedPacket;
+        uint16_t length;
+
+        while ((queuedPacket = RtpaGetQueuedPacket(queue, packetPool, 0, &length)) != NULL) {
+            audioPacketsOut++;
+            if (length == 0) {
+                audioPacketsConcealed++;
+            }
+            BpFreeBuffer(packetPool, queuedPacket);
+        }
+    }
+}
+
+static double perSecond(uint64_t count, uint64_t timeUs) {
+    return timeUs != 0 ? (double)count * 1000000.0 / (double)timeUs : 0.0;
+}
+
+// Walks every start code in the buffer and returns how many were found
+static uint32_t scanStartCodes(unsigned int (*find)(const unsigned char*, unsigned int),
+                               const unsigned char* data, unsigned int length, uint64_t* checksum) {
+    unsigned int offset = 0;
+    uint32_t count = 0;
+
+    for (;;) {
+        unsigned int i = find(&data[offset], length - offset);
+        if (i == length - offset) {
+            return count;
+        }
+
+        offset += i + 3;
+        *checksum += offset;
+        count++;
+    }
+}
+
+// Fills a buffer with random slice data (with emulation prevention, like an
+// encoder would output) behind 4 byte start codes, then times both scanners.
+static int runScanBench(void) {
+    unsigned int length = (unsigned int)options.scanBenchMiB * 1024 * 1024;
+    unsigned char* data;
+    uint32_t state = options.seed != 0 ? options.seed : 1;
+    unsigned int (*scanners[2])(const unsigned char*, unsigned int) = { findAnnexBStartCodeScalar, findAnnexBStartCode };
+    const char* names[2] = { "Scalar", "Vector" };
+    uint64_t checksums[2] = { 0, 0 };
+    uint32_t counts[2] = { 0, 0 };
+    unsigned int i;
+    int j;
+
+    data = malloc(length);
+    if (data == NULL) {
+        fprintf(stderr, "Unable to allocate %d MiB\n", options.scanBenchMiB);
+        return 1;
+    }
+
+    for (i = 0; i < length; i++) {
+        if (i % SCAN_BENCH_SLICE_SIZE == 0 && i + 6 <= length) {
+            // Start code and a TRAIL_R slice NALU header
+            memcpy(&data[i], "\x00\x00\x00\x01\x02\x01", 6);
+            i += 5;
+        }
+        else if (i >= 2 && data[i - 1] == 0 && data[i - 2] == 0) {
+            data[i] = 3;
+        }
+        else {
+            // Zero bytes are common in real slice data, so bias towards them
+            uint32_t r = nextRandom(&state);
+            data[i] = (r & 0x700) == 0 ? 0 : (unsigned char)r;
+        }
+    }
+
+    initializeStartCodeScanner();
+
+    printf("Scanning %d MiB of synthetic slice data %d times\n", options.scanBenchMiB, SCAN_BENCH_ITERATIONS);
+    for (j = 0; j < 2; j++) {
+        uint64_t startTimeUs = PltGetMicroseconds();
+        uint64_t timeUs;
+        int k;
+
+        for (k = 0; k < SCAN_BENCH_ITERATIONS; k++) {
+            counts[j] = scanStartCodes(scanners[j], data, length, &checksums[j]);
+        }
+        timeUs = PltGetMicroseconds() - startTimeUs;
+
+        printf("  %-6s %8u start codes, %10.1f MB/s\n",
+               names[j], counts[j],
+               perSecond((uint64_t)length * SCAN_BENCH_ITERATIONS, timeUs) / 1000000.0);
+    }
+
+    free(data);
+
+    if (counts[0] != counts[1] || checksums[0] != checksums[1]) {
+        fprintf(stderr, "The vector start code scan doesn't match the scalar one\n");
+        return 1;
+    }
+
+    return 0;
+}
+
+static void printHistogram(const char* name, PVIDEO_TIMING_HISTOGRAM histogram) {
+    printf("  %-13s %8u samples, avg %8.1f us, max %8u us\n",
+           name,
+           histogram->sampleCount,
+           histogram->sampleCount != 0 ? (double)histogram->totalUs / histogram->sampleCount : 0.0,
+           histogram->maxUs);
+}
+
+static void printReport(PRTP_VIDEO_QUEUE videoQueue, PRTP_AUDIO_QUEUE audioQueue, uint64_t totalTimeUs) {
+    PREPLAY_STREAM_STATS video = &streamStats[STREAM_VIDEO];
+    PREPLAY_STREAM_STATS audio = &streamStats[STREAM_AUDIO];
+    int i;
+
+    printf("Replayed %s in %.1f ms (packet size %d, seed %u)\n",
+           options.path, totalTimeUs / 1000.0, StreamConfig.packetSize, options.seed);
+
+    for (i = 0; i < STREAM_COUNT; i++) {
+        printf("  %-8s %8u packets, %10llu bytes, %6u dropped, %6u reordered\n",
+               streamNames[i], streamStats[i].packets, (unsigned long long)streamStats[i].bytes,
+               streamStats[i].dropped, streamStats[i].reordered);
+    }
+
+    printf("Video: %.0f packets/s, %.1f Mbps, %u frames (%u IDR, %u skipped), %.0f frames/s\n",
+           perSecond(video->packets - video->dropped, video->timeUs),
+           perSecond(video->bytes * 8, video->timeUs) / 1000000.0,
+           framesDecoded, idrFramesDecoded, framesSkipped,
+           perSecond(framesDecoded, video->timeUs));
+    printf("  FEC: %u FEC packets, %u recovered, %u failed, %u OOS, %u invalid\n",
+           videoQueue->stats.packetCountFec, videoQueue->stats.packetCountFecRecovered,
+           videoQueue->stats.packetCountFecFailed, videoQueue->stats.packetCountOOS,
+           videoQueue->stats.packetCountInvalid + videoQueue->stats.packetCountFecInvalid);
+    printHistogram("FEC recovery", &VideoTimingStats.fecRecovery);
+    printHistogram("Frame receive", &VideoTimingStats.frameReceive);
+    printHistogram("Reassembly", &VideoTimingStats.reassembly);
+
+    printf("Audio: %.0f packets/s, %u packets out (%u concealed)\n",
+           perSecond(audio->packets - audio->dropped, audio->timeUs),
+           audioPacketsOut, audioPacketsConcealed);
+    printf("  FEC: %u FEC packets, %u recovered, %u failed, %u OOS, %u invalid\n",
+           audioQueue->stats.packetCountFec, audioQueue->stats.packetCountFecRecovered,
+           audioQueue->stats.packetCountFecFailed, audioQueue->stats.packetCountOOS,
+           audioQueue->stats.packetCountInvalid + audioQueue->stats.packetCountFecInvalid);
+
+#if defined(__GLIBC__)
+    printf("Allocations: %llu (%.2f per frame)\n",
+           (unsigned long long)allocationCount,
+           framesDecoded != 0 ? (double)allocationCount / framesDecoded : 0.0);
+#else
+    printf("Allocations: not counted on this platform\n");
+#endif
+}
+
+static void printUsage(const char* name) {
+    fprintf(stderr,
+            "Usage: %s [options] <capture.pcap>\n"
+            "       %s --scan-bench <MiB> [--seed <n>]\n"
+            "  --base-port <port>       Host base port (default %d)\n"
+            "  --packet-size <bytes>    Video packet size (default: detected from the capture)\n"
+            "  --format <h264|hevc|av1> Video format (default h264)\n"
+            "  --fps <fps>              Stream frame rate (default 60)\n"
+            "  --server-version <a.b.c.d> Host version (default 7.1.431.-1, Sunshine)\n"
+            "  --loss <percent>         Synthetic packet loss\n"
+            "  --reorder <percent>      Synthetic packet reordering\n"
+            "  --reorder-distance <n>   Largest reordering distance in packets (default 8)\n"
+            "  --seed <n>               Seed for the synthetic loss and reordering (default 1)\n"
+            "  --scan-bench <MiB>       Benchmark the start code scan on synthetic data instead\n"
+            "  --realtime               Pace the packets with the capture timestamps\n"
+            "  --verbose                Print the library log\n",
+            name, name, DEFAULT_BASE_PORT);
+}
+
+static bool parseOptions(int argc, char* argv[]) {
+    int i;
+
+    options.basePort = DEFAULT_BASE_PORT;
+    options.videoFormat = VIDEO_FORMAT_H264;
+    options.fps = 60;
+    options.reorderDistance = 8;
+    options.seed = 1;
+    options.serverVersion = "7.1.431.-1";
+
+    for (i = 1; i < argc; i++) {
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+
+        if (strcmp(argv[i], "--verbose") == 0) {
+            options.verbose = true;
+            continue;
+        }
+        else if (strcmp(argv[i], "--realtime") == 0) {
+            options.realtime = true;
+            continue;
+        }
+        else if (argv[i][0] != '-') {
+            options.path = argv[i];
+            continue;
+        }
+        else if (value == NULL) {
+            return false;
+        }
+
+        if (strcmp(argv[i], "--base-port") == 0) {
+            options.basePort = atoi(value);
+        }
+        else if (strcmp(argv[i], "--packet-size") == 0) {
+            options.packetSize = atoi(value);
+        }
+        else if (strcmp(argv[i], "--format") == 0) {
+            if (strcmp(value, "h264") == 0) {
+                options.videoFormat = VIDEO_FORMAT_H264;
+            }
+            else if (strcmp(value, "hevc") == 0) {
+                options.videoFormat = VIDEO_FORMAT_H265;
+            }
+            else if (strcmp(value, "av1") == 0) {
+                options.videoFormat = VIDEO_FORMAT_AV1_MAIN8;
+            }
+            else {
+                return false;
+            }
+        }
+        else if (strcmp(argv[i], "--fps") == 0) {
+            options.fps = atoi(value);
+        }
+        else if (strcmp(argv[i], "--server-version") == 0) {
+            options.serverVersion = value;
+        }
+        else if (strcmp(argv[i], "--loss") == 0) {
+            options.lossPercent = atoi(value);
+        }
+        else if (strcmp(argv[i], "--reorder") == 0) {
+            options.reorderPercent = atoi(value);
+        }
+        else if (strcmp(argv[i], "--reorder-distance") == 0) {
+            options.reorderDistance = atoi(value);
+        }
+        else if (strcmp(argv[i], "--seed") == 0) {
+            options.seed = (uint32_t)strtoul(value, NULL, 10);
+        }
+        else if (strcmp(argv[i], "--scan-bench") == 0) {
+            options.scanBenchMiB = atoi(value);
+            if (options.scanBenchMiB <= 0 || options.scanBenchMiB > 1024) {
+                return false;
+            }
+        }
+        else {
+            return false;
+        }
+
+        i++;
+    }
+
+    return (options.path != NULL || options.scanBenchMiB != 0) &&
+           options.fps > 0 &&
+           options.lossPercent >= 0 && options.lossPercent <= 100 &&
+           options.reorderPercent >= 0 && options.reorderPercent <= 100 &&
+           options.reorderDistance > 0 && options.reorderDistance <= MAX_REORDER_DISTANCE;
+}
+
+int main(int argc, char* argv[]) {
+    PDECODER_RENDERER_CALLBACKS drCallbacks;
+    PAUDIO_RENDERER_CALLBACKS arCallbacks;
+    PCONNECTION_LISTENER_CALLBACKS clCallbacks;
+    CONNECTION_LISTENER_CALLBACKS listenerCallbacks;
+    DECODER_RENDERER_CALLBACKS videoCallbacks;
+    RTP_VIDEO_QUEUE videoQueue;
+    RTP_AUDIO_QUEUE audioQueue;
+    BUFFER_POOL audioPacketPool;
+    PREPLAY_PACKET packets;
+    int packetCount;
+    char* capture;
+    long captureLength;
+    char audioBuffer[RTPA_MAX_PACKET_SIZE];
+    uint64_t startTimeUs;
+    int i;
+
+    if (!parseOptions(argc, argv)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    if (options.scanBenchMiB != 0) {
+        return runScanBench();
+    }
+
+    // Set up the callbacks like LiStartConnection() would
+    memset(&listenerCallbacks, 0, sizeof(listenerCallbacks));
+    listenerCallbacks.logMessage = logMessage;
+    memset(&videoCallbacks, 0, sizeof(videoCallbacks));
+    videoCallbacks.submitDecodeUnit = submitDecodeUnit;
+    videoCallbacks.capabilities = CAPABILITY_DIRECT_SUBMIT;
+    drCallbacks = &videoCallbacks;
+    arCallbacks = NULL;
+    clCallbacks = &listenerCallbacks;
+    fixupMissingCallbacks(&drCallbacks, &arCallbacks, &clCallbacks);
+    memcpy(&VideoCallbacks, drCallbacks, sizeof(VideoCallbacks));
+    memcpy(&ListenerCallbacks, clCallbacks, sizeof(ListenerCallbacks));
+
+    capture = readFile(options.path, &captureLength);
+    if (capture == NULL) {
+        return 1;
+    }
+
+    packets = loadCapture(capture, captureLength, &packetCount);
+    if (packets == NULL) {
+        free(capture);
+        return 1;
+    }
+
+    extractVersionQuadFromString(options.serverVersion, AppVersionQuad);
+    NegotiatedVideoFormat = options.videoFormat;
+    StreamConfig.fps = options.fps;
+    StreamConfig.packetSize = options.packetSize != 0 ? options.packetSize : detectPacketSize(packets, packetCount);
+    if (StreamConfig.packetSize <= 0) {
+        fprintf(stderr, "Unable to detect the video packet size\n");
+        free(packets);
+        free(capture);
+        return 1;
+    }
+
+    applyImpairments(packets, packetCount);
+
+    // The control stream isn't started, but the depacketizer reports frame
+    // losses and FEC status to it, so its queues must exist.
+    initializeControlStream();
+    initializeVideoStream();
+    RtpvInitializeQueue(&videoQueue);
+    RtpaInitializeQueue(&audioQueue);
+    BpInitializePool(&audioPacketPool, RTPA_MAX_PACKET_SIZE, AUDIO_QUEUED_PACKET_POOL_SIZE);
+
+    countAllocations = true;
+    startTimeUs = PltGetMicroseconds();
+    for (i = 0; i < packetCount; i++) {
+        PREPLAY_PACKET packet = &packets[i];
+        uint64_t packetStartTimeUs;
+
+        streamStats[packet->stream].packets++;
+        if (packet->dropped) {
+            continue;
+        }
+        streamStats[packet->stream].bytes += packet->length;
+
+        if (options.realtime) {
+            uint64_t elapsedUs = PltGetMicroseconds() - startTimeUs;
+            uint64_t captureOffsetUs = packet->captureTimeUs - packets[0].captureTimeUs;
+
+            if (captureOffsetUs > elapsedUs + 1000) {
+                PltSleepMs((int)((captureOffsetUs - elapsedUs) / 1000));
+            }
+        }
+
+        packetStartTimeUs = PltGetMicroseconds();
+        if (packet->stream == STREAM_VIDEO) {
+            replayVideoPacket(&videoQueue, packet);
+        }
+        else if (packet->stream == STREAM_AUDIO) {
+            replayAudioPacket(&audioQueue, &audioPacketPool, packet, audioBuffer);
+        }
+        streamStats[packet->stream].timeUs += PltGetMicroseconds() - packetStartTimeUs;
+    }
+    countAllocations = false;
+
+    printReport(&videoQueue, &audioQueue, PltGetMicroseconds() - startTimeUs);
+
+    // The control stream was never started, so it's left for the process exit
+    stopVideoDepacketizer();
+    RtpvCleanupQueue(&videoQueue);
+    RtpaCleanupQueue(&audioQueue);
+    BpDestroyPool(&audioPacketPool);
+    destroyVideoStream();
+    free(packets);
+    free(capture);
+    return 0;
+}
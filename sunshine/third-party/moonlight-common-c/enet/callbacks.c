@@ -51,3 +51,46 @@ enet_free (void * memory)
    callbacks.free (memory);
 }
 
+void *
+enet_free_list_alloc (ENetFreeList * list, size_t size)
+{
+   void * memory = list -> head;
+
+   if (memory == NULL)
+     return enet_malloc (size);
+
+   list -> head = * (void **) memory;
+   -- list -> count;
+
+   return memory;
+}
+
+void
+enet_free_list_free (ENetFreeList * list, void * memory)
+{
+   if (list -> count >= ENET_HOST_FREE_LIST_MAXIMUM)
+   {
+      enet_free (memory);
+
+      return;
+   }
+
+   * (void **) memory = list -> head;
+   list -> head = memory;
+   ++ list -> count;
+}
+
+void
+enet_free_list_destroy (ENetFreeList * list)
+{
+   while (list -> head != NULL)
+   {
+      void * memory = list -> head;
+
+      list -> head = * (void **) memory;
+      enet_free (memory);
+   }
+
+   list -> count = 0;
+}
+
@@ -157,6 +157,10 @@ enet_host_destroy (ENetHost * host)
     if (host -> compressor.context != NULL && host -> compressor.destroy)
       (* host -> compressor.destroy) (host -> compressor.context);
 
+    enet_free_list_destroy (& host -> outgoingCommandFreeList);
+    enet_free_list_destroy (& host -> incomingCommandFreeList);
+    enet_free_list_destroy (& host -> acknowledgementFreeList);
+
     enet_free (host -> peers);
     enet_free (host);
 }
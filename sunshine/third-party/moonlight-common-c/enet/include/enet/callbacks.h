@@ -14,12 +14,25 @@ typedef struct _ENetCallbacks
     void (ENET_CALLBACK * no_memory) (void);
 } ENetCallbacks;
 
+/** A per-host cache of fixed-size blocks, such as queued commands and
+    acknowledgements, so steady traffic doesn't allocate for every packet.
+    Blocks still come from enet_malloc(), so user-supplied callbacks apply.
+*/
+typedef struct _ENetFreeList
+{
+    void * head;
+    size_t count;
+} ENetFreeList;
+
 /** @defgroup callbacks ENet internal callbacks
     @{
     @ingroup private
 */
 extern void * enet_malloc (size_t);
 extern void   enet_free (void *);
+extern void * enet_free_list_alloc (ENetFreeList *, size_t);
+extern void   enet_free_list_free (ENetFreeList *, void *);
+extern void   enet_free_list_destroy (ENetFreeList *);
 
 /** @} */
 
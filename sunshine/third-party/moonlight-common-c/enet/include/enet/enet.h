@@ -215,6 +215,7 @@ enum
    ENET_HOST_DEFAULT_MTU                  = 900,
    ENET_HOST_DEFAULT_MAXIMUM_PACKET_SIZE  = 32 * 1024 * 1024,
    ENET_HOST_DEFAULT_MAXIMUM_WAITING_DATA = 32 * 1024 * 1024,
+   ENET_HOST_FREE_LIST_MAXIMUM            = 256,
 
    ENET_PEER_DEFAULT_ROUND_TRIP_TIME      = 500,
    ENET_PEER_DEFAULT_PACKET_THROTTLE      = 32,
@@ -400,6 +401,9 @@ typedef struct _ENetHost
    size_t               duplicatePeers;              /**< optional number of allowed peers from duplicate IPs, defaults to ENET_PROTOCOL_MAXIMUM_PEER_ID */
    size_t               maximumPacketSize;           /**< the maximum allowable packet size that may be sent or received on a peer */
    size_t               maximumWaitingData;          /**< the maximum aggregate amount of buffer space a peer may use waiting for packets to be delivered */
+   ENetFreeList         outgoingCommandFreeList;     /**< recycled ENetOutgoingCommands */
+   ENetFreeList         incomingCommandFreeList;     /**< recycled ENetIncomingCommands */
+   ENetFreeList         acknowledgementFreeList;     /**< recycled ENetAcknowledgements */
 } ENetHost;
 
 /**
@@ -156,14 +156,14 @@ enet_peer_send (ENetPeer * peer, enet_uint8 channelID, ENetPacket * packet)
          if (packet -> dataLength - fragmentOffset < fragmentLength)
            fragmentLength = packet -> dataLength - fragmentOffset;
 
-         fragment = (ENetOutgoingCommand *) enet_malloc (sizeof (ENetOutgoingCommand));
+         fragment = (ENetOutgoingCommand *) enet_free_list_alloc (& peer -> host -> outgoingCommandFreeList, sizeof (ENetOutgoingCommand));
          if (fragment == NULL)
          {
             while (! enet_list_empty (& fragments))
             {
                fragment = (ENetOutgoingCommand *) enet_list_remove (enet_list_begin (& fragments));
                
-               enet_free (fragment);
+               enet_free_list_free (& peer -> host -> outgoingCommandFreeList, fragment);
             }
             
             return -1;
@@ -247,7 +247,7 @@ enet_peer_receive (ENetPeer * peer, enet_uint8 * channelID)
    if (incomingCommand -> fragments != NULL)
      enet_free (incomingCommand -> fragments);
 
-   enet_free (incomingCommand);
+   enet_free_list_free (& peer -> host -> incomingCommandFreeList, incomingCommand);
 
    peer -> totalWaitingData -= packet -> dataLength;
 
@@ -255,7 +255,7 @@ enet_peer_receive (ENetPeer * peer, enet_uint8 * channelID)
 }
 
 static void
-enet_peer_reset_outgoing_commands (ENetList * queue)
+enet_peer_reset_outgoing_commands (ENetHost * host, ENetList * queue)
 {
     ENetOutgoingCommand * outgoingCommand;
 
@@ -271,12 +271,12 @@ enet_peer_reset_outgoing_commands (ENetList * queue)
             enet_packet_destroy (outgoingCommand -> packet);
        }
 
-       enet_free (outgoingCommand);
+       enet_free_list_free (& host -> outgoingCommandFreeList, outgoingCommand);
     }
 }
 
 static void
-enet_peer_remove_incoming_commands (ENetList * queue, ENetListIterator startCommand, ENetListIterator endCommand, ENetIncomingCommand * excludeCommand)
+enet_peer_remove_incoming_commands (ENetHost * host, ENetList * queue, ENetListIterator startCommand, ENetListIterator endCommand, ENetIncomingCommand * excludeCommand)
 {
     ENetListIterator currentCommand;    
     
@@ -302,14 +302,14 @@ enet_peer_remove_incoming_commands (ENetList * queue, ENetListIterator startComm
        if (incomingCommand -> fragments != NULL)
          enet_free (incomingCommand -> fragments);
 
-       enet_free (incomingCommand);
+       enet_free_list_free (& host -> incomingCommandFreeList, incomingCommand);
     }
 }
 
 static void
-enet_peer_reset_incoming_commands (ENetList * queue)
+enet_peer_reset_incoming_commands (ENetHost * host, ENetList * queue)
 {
-    enet_peer_remove_incoming_commands(queue, enet_list_begin (queue), enet_list_end (queue), NULL);
+    enet_peer_remove_incoming_commands(host, queue, enet_list_begin (queue), enet_list_end (queue), NULL);
 }
  
 void
@@ -325,12 +325,12 @@ enet_peer_reset_queues (ENetPeer * peer)
     }
 
     while (! enet_list_empty (& peer -> acknowledgements))
-      enet_free (enet_list_remove (enet_list_begin (& peer -> acknowledgements)));
+      enet_free_list_free (& peer -> host -> acknowledgementFreeList, enet_list_remove (enet_list_begin (& peer -> acknowledgements)));
 
-    enet_peer_reset_outgoing_commands (& peer -> sentReliableCommands);
-    enet_peer_reset_outgoing_commands (& peer -> outgoingCommands);
-    enet_peer_reset_outgoing_commands (& peer -> outgoingSendReliableCommands);
-    enet_peer_reset_incoming_commands (& peer -> dispatchedCommands);
+    enet_peer_reset_outgoing_commands (peer -> host, & peer -> sentReliableCommands);
+    enet_peer_reset_outgoing_commands (peer -> host, & peer -> outgoingCommands);
+    enet_peer_reset_outgoing_commands (peer -> host, & peer -> outgoingSendReliableCommands);
+    enet_peer_reset_incoming_commands (peer -> host, & peer -> dispatchedCommands);
 
     if (peer -> channels != NULL && peer -> channelCount > 0)
     {
@@ -338,8 +338,8 @@ enet_peer_reset_queues (ENetPeer * peer)
              channel < & peer -> channels [peer -> channelCount];
              ++ channel)
         {
-            enet_peer_reset_incoming_commands (& channel -> incomingReliableCommands);
-            enet_peer_reset_incoming_commands (& channel -> incomingUnreliableCommands);
+            enet_peer_reset_incoming_commands (peer -> host, & channel -> incomingReliableCommands);
+            enet_peer_reset_incoming_commands (peer -> host, & channel -> incomingUnreliableCommands);
         }
 
         enet_free (peer -> channels);
@@ -619,7 +619,7 @@ enet_peer_queue_acknowledgement (ENetPeer * peer, const ENetProtocol * command,
           return NULL;
     }
 
-    acknowledgement = (ENetAcknowledgement *) enet_malloc (sizeof (ENetAcknowledgement));
+    acknowledgement = (ENetAcknowledgement *) enet_free_list_alloc (& peer -> host -> acknowledgementFreeList, sizeof (ENetAcknowledgement));
     if (acknowledgement == NULL)
       return NULL;
 
@@ -705,7 +705,7 @@ enet_peer_setup_outgoing_command (ENetPeer * peer, ENetOutgoingCommand * outgoin
 ENetOutgoingCommand *
 enet_peer_queue_outgoing_command (ENetPeer * peer, const ENetProtocol * command, ENetPacket * packet, enet_uint32 offset, enet_uint16 length)
 {
-    ENetOutgoingCommand * outgoingCommand = (ENetOutgoingCommand *) enet_malloc (sizeof (ENetOutgoingCommand));
+    ENetOutgoingCommand * outgoingCommand = (ENetOutgoingCommand *) enet_free_list_alloc (& peer -> host -> outgoingCommandFreeList, sizeof (ENetOutgoingCommand));
     if (outgoingCommand == NULL)
       return NULL;
 
@@ -801,7 +801,7 @@ enet_peer_dispatch_incoming_unreliable_commands (ENetPeer * peer, ENetChannel *
        droppedCommand = currentCommand;
     }
 
-    enet_peer_remove_incoming_commands (& channel -> incomingUnreliableCommands, enet_list_begin (& channel -> incomingUnreliableCommands), droppedCommand, queuedCommand);
+    enet_peer_remove_incoming_commands (peer -> host, & channel -> incomingUnreliableCommands, enet_list_begin (& channel -> incomingUnreliableCommands), droppedCommand, queuedCommand);
 }
 
 void
@@ -960,7 +960,7 @@ enet_peer_queue_incoming_command (ENetPeer * peer, const ENetProtocol * command,
     if (packet == NULL)
       goto notifyError;
 
-    incomingCommand = (ENetIncomingCommand *) enet_malloc (sizeof (ENetIncomingCommand));
+    incomingCommand = (ENetIncomingCommand *) enet_free_list_alloc (& peer -> host -> incomingCommandFreeList, sizeof (ENetIncomingCommand));
     if (incomingCommand == NULL)
       goto notifyError;
 
@@ -978,7 +978,7 @@ enet_peer_queue_incoming_command (ENetPeer * peer, const ENetProtocol * command,
          incomingCommand -> fragments = (enet_uint32 *) enet_malloc ((fragmentCount + 31) / 32 * sizeof (enet_uint32));
        if (incomingCommand -> fragments == NULL)
        {
-          enet_free (incomingCommand);
+          enet_free_list_free (& peer -> host -> incomingCommandFreeList, incomingCommand);
 
           goto notifyError;
        }
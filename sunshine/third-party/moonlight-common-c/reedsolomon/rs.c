@@ -46,6 +46,23 @@
 #define alloca(x) _alloca(x)
 #endif
 
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define RS_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define RS_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define RS_TARGET(x) __attribute__((target(x)))
+#else
+#define RS_TARGET(x)
+#endif
+
 typedef unsigned char gf;
 
 #define GF_BITS  8
@@ -93,7 +110,7 @@ static inline gf modnn(int x) {
     return x;
 }
 
-static void addmul(gf *dst1, gf *src1, gf c, int sz) {
+static void addmul_ref(gf *dst1, gf *src1, gf c, int sz) {
     USE_GF_MULC;
     if (c != 0) {
         register gf *dst = dst1, *src = src1;
@@ -105,7 +122,7 @@ static void addmul(gf *dst1, gf *src1, gf c, int sz) {
     }
 }
 
-static void mul(gf *dst1, gf *src1, gf c, int sz) {
+static void mul_ref(gf *dst1, gf *src1, gf c, int sz) {
     USE_GF_MULC;
     if (c != 0) {
         register gf *dst = dst1, *src = src1;
@@ -114,7 +131,183 @@ static void mul(gf *dst1, gf *src1, gf c, int sz) {
         for (; dst < lim; dst++, src++)
             GF_MULC(*dst , *src);
     } else
-        memset(dst1, 0, c);
+        memset(dst1, 0, sz);
+}
+
+/*
+ * Vectorized versions of addmul() and mul(). Multiplying by a constant
+ * is linear, so c*x == c*(x & 0x0f) ^ c*(x & 0xf0): each half is looked
+ * up in a 16-entry table with a byte shuffle, 16 or 32 bytes at a time.
+ * The x86 kernels are selected at runtime by reed_solomon_init().
+ */
+#ifdef _MSC_VER
+static gf __declspec(align (16)) gf_mul_lo[(GF_SIZE + 1) * 16];
+static gf __declspec(align (16)) gf_mul_hi[(GF_SIZE + 1) * 16];
+#else
+static gf gf_mul_lo[(GF_SIZE + 1) * 16] __attribute__((aligned (16)));
+static gf gf_mul_hi[(GF_SIZE + 1) * 16] __attribute__((aligned (16)));
+#endif
+
+static void init_mul_split_tables(void) {
+    int c, x;
+    for (c = 0; c < GF_SIZE + 1; c++) {
+        for (x = 0; x < 16; x++) {
+            gf_mul_lo[c * 16 + x] = gf_mul(c, x);
+            gf_mul_hi[c * 16 + x] = gf_mul(c, (x << 4));
+        }
+    }
+}
+
+#if defined(RS_X86)
+RS_TARGET("ssse3")
+static void addmul_ssse3(gf *dst, gf *src, gf c, int sz) {
+    const __m128i mask = _mm_set1_epi8(0x0f);
+    const __m128i tlo = _mm_load_si128((const __m128i *)&gf_mul_lo[c * 16]);
+    const __m128i thi = _mm_load_si128((const __m128i *)&gf_mul_hi[c * 16]);
+    int i;
+
+    if (c == 0)
+        return;
+
+    for (i = 0; i + 16 <= sz; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i *)&src[i]);
+        __m128i lo = _mm_shuffle_epi8(tlo, _mm_and_si128(x, mask));
+        __m128i hi = _mm_shuffle_epi8(thi, _mm_and_si128(_mm_srli_epi64(x, 4), mask));
+        __m128i d = _mm_loadu_si128((const __m128i *)&dst[i]);
+        _mm_storeu_si128((__m128i *)&dst[i], _mm_xor_si128(d, _mm_xor_si128(lo, hi)));
+    }
+    addmul_ref(&dst[i], &src[i], c, sz - i);
+}
+
+RS_TARGET("ssse3")
+static void mul_ssse3(gf *dst, gf *src, gf c, int sz) {
+    const __m128i mask = _mm_set1_epi8(0x0f);
+    const __m128i tlo = _mm_load_si128((const __m128i *)&gf_mul_lo[c * 16]);
+    const __m128i thi = _mm_load_si128((const __m128i *)&gf_mul_hi[c * 16]);
+    int i;
+
+    for (i = 0; i + 16 <= sz; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i *)&src[i]);
+        __m128i lo = _mm_shuffle_epi8(tlo, _mm_and_si128(x, mask));
+        __m128i hi = _mm_shuffle_epi8(thi, _mm_and_si128(_mm_srli_epi64(x, 4), mask));
+        _mm_storeu_si128((__m128i *)&dst[i], _mm_xor_si128(lo, hi));
+    }
+    mul_ref(&dst[i], &src[i], c, sz - i);
+}
+
+RS_TARGET("avx2")
+static void addmul_avx2(gf *dst, gf *src, gf c, int sz) {
+    const __m256i mask = _mm256_set1_epi8(0x0f);
+    const __m256i tlo = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i *)&gf_mul_lo[c * 16]));
+    const __m256i thi = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i *)&gf_mul_hi[c * 16]));
+    int i;
+
+    if (c == 0)
+        return;
+
+    for (i = 0; i + 32 <= sz; i += 32) {
+        __m256i x = _mm256_loadu_si256((const __m256i *)&src[i]);
+        __m256i lo = _mm256_shuffle_epi8(tlo, _mm256_and_si256(x, mask));
+        __m256i hi = _mm256_shuffle_epi8(thi, _mm256_and_si256(_mm256_srli_epi64(x, 4), mask));
+        __m256i d = _mm256_loadu_si256((const __m256i *)&dst[i]);
+        _mm256_storeu_si256((__m256i *)&dst[i], _mm256_xor_si256(d, _mm256_xor_si256(lo, hi)));
+    }
+    addmul_ref(&dst[i], &src[i], c, sz - i);
+}
+
+RS_TARGET("avx2")
+static void mul_avx2(gf *dst, gf *src, gf c, int sz) {
+    const __m256i mask = _mm256_set1_epi8(0x0f);
+    const __m256i tlo = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i *)&gf_mul_lo[c * 16]));
+    const __m256i thi = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i *)&gf_mul_hi[c * 16]));
+    int i;
+
+    for (i = 0; i + 32 <= sz; i += 32) {
+        __m256i x = _mm256_loadu_si256((const __m256i *)&src[i]);
+        __m256i lo = _mm256_shuffle_epi8(tlo, _mm256_and_si256(x, mask));
+        __m256i hi = _mm256_shuffle_epi8(thi, _mm256_and_si256(_mm256_srli_epi64(x, 4), mask));
+        _mm256_storeu_si256((__m256i *)&dst[i], _mm256_xor_si256(lo, hi));
+    }
+    mul_ref(&dst[i], &src[i], c, sz - i);
+}
+
+static int cpu_has_ssse3(void) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 9)) != 0;
+#else
+    return __builtin_cpu_supports("ssse3");
+#endif
+}
+
+static int cpu_has_avx2(void) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    /* The OS must also save the YMM registers (OSXSAVE and XCR0) */
+    if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 || (_xgetbv(0) & 6) != 6)
+        return 0;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#elif defined(RS_NEON)
+static void addmul_neon(gf *dst, gf *src, gf c, int sz) {
+    const uint8x16_t mask = vdupq_n_u8(0x0f);
+    const uint8x16_t tlo = vld1q_u8(&gf_mul_lo[c * 16]);
+    const uint8x16_t thi = vld1q_u8(&gf_mul_hi[c * 16]);
+    int i;
+
+    if (c == 0)
+        return;
+
+    for (i = 0; i + 16 <= sz; i += 16) {
+        uint8x16_t x = vld1q_u8(&src[i]);
+        uint8x16_t lo = vqtbl1q_u8(tlo, vandq_u8(x, mask));
+        uint8x16_t hi = vqtbl1q_u8(thi, vshrq_n_u8(x, 4));
+        vst1q_u8(&dst[i], veorq_u8(vld1q_u8(&dst[i]), veorq_u8(lo, hi)));
+    }
+    addmul_ref(&dst[i], &src[i], c, sz - i);
+}
+
+static void mul_neon(gf *dst, gf *src, gf c, int sz) {
+    const uint8x16_t mask = vdupq_n_u8(0x0f);
+    const uint8x16_t tlo = vld1q_u8(&gf_mul_lo[c * 16]);
+    const uint8x16_t thi = vld1q_u8(&gf_mul_hi[c * 16]);
+    int i;
+
+    for (i = 0; i + 16 <= sz; i += 16) {
+        uint8x16_t x = vld1q_u8(&src[i]);
+        uint8x16_t lo = vqtbl1q_u8(tlo, vandq_u8(x, mask));
+        uint8x16_t hi = vqtbl1q_u8(thi, vshrq_n_u8(x, 4));
+        vst1q_u8(&dst[i], veorq_u8(lo, hi));
+    }
+    mul_ref(&dst[i], &src[i], c, sz - i);
+}
+#endif
+
+#if defined(RS_NEON)
+static void (*addmul)(gf *dst1, gf *src1, gf c, int sz) = addmul_neon;
+static void (*mul)(gf *dst1, gf *src1, gf c, int sz) = mul_neon;
+#else
+static void (*addmul)(gf *dst1, gf *src1, gf c, int sz) = addmul_ref;
+static void (*mul)(gf *dst1, gf *src1, gf c, int sz) = mul_ref;
+#endif
+
+static void select_mul_kernels(void) {
+#if defined(RS_X86)
+    if (cpu_has_avx2()) {
+        addmul = addmul_avx2;
+        mul = mul_avx2;
+    }
+    else if (cpu_has_ssse3()) {
+        addmul = addmul_ssse3;
+        mul = mul_ssse3;
+    }
+#endif
 }
 
 /* y = a.dot(b) */
@@ -380,6 +573,8 @@ static inline int code_some_shards(gf* matrixRows, gf** inputs, gf** outputs, in
 void reed_solomon_init(void) {
     generate_gf();
     init_mul_table();
+    init_mul_split_tables();
+    select_mul_kernels();
 }
 
 reed_solomon* reed_solomon_new(int data_shards, int parity_shards) {
@@ -1,11 +1,25 @@
 #include "Limelight-internal.h"
 
 static SOCKET rtpSocket = INVALID_SOCKET;
+static SOCKET preboundRtpSocket = INVALID_SOCKET;
 
+#define AUDIO_PING_INTERVAL_MS 500
+
+#define AUDIO_PACKET_QUEUE_DEPTH 30
 static LINKED_BLOCKING_QUEUE packetQueue;
 static RTP_AUDIO_QUEUE rtpAudioQueue;
 
-static PLT_THREAD udpPingThread;
+// Holds all audio packets, both received and recovered by the RTP audio queue.
+// It's preallocated with enough packets for a full decode queue, a recovered
+// FEC block and the ones held by the receive and decoder threads, so a steady
+// 5 or 10 ms Opus stream never falls back to malloc().
+#define AUDIO_PACKETS_POOLED (AUDIO_PACKET_QUEUE_DEPTH + RTPA_DATA_SHARDS + 2)
+static BUFFER_POOL packetPool;
+
+static SCHEDULER_TASK pingTask;
+static LC_SOCKADDR pingAddr;
+static int pingCount;
+
 static PLT_THREAD receiveThread;
 static PLT_THREAD decoderThread;
 
@@ -14,7 +28,7 @@ static uint32_t avRiKeyId;
 
 static unsigned short lastSeq;
 
-static bool pingThreadStarted;
+static bool pingTaskStarted;
 static bool receivedDataFromPeer;
 static uint64_t firstReceiveTime;
 
@@ -23,10 +37,32 @@ static uint64_t firstReceiveTime;
 static uint8_t opusHeaderByte;
 #endif
 
-#define MAX_PACKET_SIZE 1400
+#define MAX_PACKET_SIZE RTPA_MAX_PACKET_SIZE
+
+// The jitter buffer delays playout by a multiple of the smoothed arrival jitter,
+// but always by at least one packet and never by more than the maximum delay.
+#define AUDIO_JITTER_DELAY_MULTIPLIER 3
+#define AUDIO_JITTER_MAX_DELAY_US 100000
+
+// If nothing arrives for this long, we stop concealing the missing audio
+// and wait to buffer up to the target delay again.
+#define AUDIO_JITTER_MAX_CONCEAL_US 100000
+
+typedef struct _AUDIO_JITTER_BUFFER {
+    uint64_t lastQueueTimeUs;
+    uint64_t nextPlayoutTimeUs;
+    uint64_t targetDelayUs;
+    uint64_t concealedUs;
+    uint32_t scaledJitterUs; // 16x the jitter estimate
+    bool playing;
+} AUDIO_JITTER_BUFFER, *PAUDIO_JITTER_BUFFER;
+
+static AUDIO_JITTER_BUFFER jitterBuffer;
+static AUDIO_JITTER_BUFFER_STATS jitterBufferStats;
 
 typedef struct _QUEUE_AUDIO_PACKET_HEADER {
     LINKED_BLOCKING_QUEUE_ENTRY lentry;
+    uint64_t queueTimeUs;
     int size;
 } QUEUED_AUDIO_PACKET_HEADER, *PQUEUED_AUDIO_PACKET_HEADER;
 
@@ -35,43 +71,39 @@ typedef struct _QUEUED_AUDIO_PACKET {
     char data[MAX_PACKET_SIZE];
 } QUEUED_AUDIO_PACKET, *PQUEUED_AUDIO_PACKET;
 
-static void AudioPingThreadProc(void* context) {
+// UDP ping task, run by the scheduler thread
+static bool sendAudioPing(void* context) {
     char legacyPingData[] = { 0x50, 0x49, 0x4E, 0x47 };
-    LC_SOCKADDR saddr;
-
-    LC_ASSERT(AudioPortNumber != 0);
-
-    memcpy(&saddr, &RemoteAddr, sizeof(saddr));
-    SET_PORT(&saddr, AudioPortNumber);
 
     // We do not check for errors here. Socket errors will be handled
     // on the read-side in ReceiveThreadProc(). This avoids potential
     // issues related to receiving ICMP port unreachable messages due
     // to sending a packet prior to the host PC binding to that port.
-    int pingCount = 0;
-    while (!PltIsThreadInterrupted(&udpPingThread)) {
-        if (AudioPingPayload.payload[0] != 0) {
-            pingCount++;
-            AudioPingPayload.sequenceNumber = BE32(pingCount);
-
-            sendto(rtpSocket, (char*)&AudioPingPayload, sizeof(AudioPingPayload), 0, (struct sockaddr*)&saddr, AddrLen);
-        }
-        else {
-            sendto(rtpSocket, legacyPingData, sizeof(legacyPingData), 0, (struct sockaddr*)&saddr, AddrLen);
-        }
+    if (AudioPingPayload.payload[0] != 0) {
+        pingCount++;
+        AudioPingPayload.sequenceNumber = BE32(pingCount);
 
-        PltSleepMsInterruptible(&udpPingThread, 500);
+        sendto(rtpSocket, (char*)&AudioPingPayload, sizeof(AudioPingPayload), 0, (struct sockaddr*)&pingAddr, AddrLen);
+    }
+    else {
+        sendto(rtpSocket, legacyPingData, sizeof(legacyPingData), 0, (struct sockaddr*)&pingAddr, AddrLen);
     }
+
+    return true;
 }
 
 // Initialize the audio stream and start
 int initializeAudioStream(void) {
-    LbqInitializeLinkedBlockingQueue(&packetQueue, 30);
+    BpInitializePool(&packetPool, sizeof(QUEUED_AUDIO_PACKET), AUDIO_PACKETS_POOLED);
+    BpPreallocateBuffers(&packetPool, AUDIO_PACKETS_POOLED);
+    LbqInitializeLinkedBlockingQueue(&packetQueue, AUDIO_PACKET_QUEUE_DEPTH);
     RtpaInitializeQueue(&rtpAudioQueue);
     lastSeq = 0;
     receivedDataFromPeer = false;
-    pingThreadStarted = false;
+    pingTaskStarted = false;
     firstReceiveTime = 0;
+    memset(&jitterBuffer, 0, sizeof(jitterBuffer));
+    memset(&jitterBufferStats, 0, sizeof(jitterBufferStats));
     audioDecryptionCtx = PltCreateCryptoContext();
 #ifdef LC_DEBUG
     opusHeaderByte = INVALID_OPUS_HEADER;
@@ -84,28 +116,56 @@ int initializeAudioStream(void) {
     return 0;
 }
 
+// Bind the audio socket ahead of the connection for LiPreconnect()
+int prebindAudioStream(void) {
+    LC_ASSERT(preboundRtpSocket == INVALID_SOCKET);
+
+    preboundRtpSocket = bindUdpSocket(RemoteAddr.ss_family, &LocalAddr, AddrLen, 0, SOCK_QOS_TYPE_AUDIO);
+    if (preboundRtpSocket == INVALID_SOCKET) {
+        return LastSocketFail();
+    }
+
+    return 0;
+}
+
+void releasePreboundAudioStream(void) {
+    if (preboundRtpSocket != INVALID_SOCKET) {
+        closeSocket(preboundRtpSocket);
+        preboundRtpSocket = INVALID_SOCKET;
+    }
+}
+
 // This is called when the RTSP SETUP message is parsed and the audio port
 // number is parsed out of it. Alternatively, it's also called if parsing fails
 // and will use the well known audio port instead.
 int notifyAudioPortNegotiationComplete(void) {
-    LC_ASSERT(!pingThreadStarted);
+    LC_ASSERT(!pingTaskStarted);
     LC_ASSERT(AudioPortNumber != 0);
 
-    // For GFE 3.22 compatibility, we must start the audio ping thread before the RTSP handshake.
+    // For GFE 3.22 compatibility, we must start the audio ping before the RTSP handshake.
     // It will not reply to our RTSP PLAY request until the audio ping has been received.
-    rtpSocket = bindUdpSocket(RemoteAddr.ss_family, &LocalAddr, AddrLen, 0, SOCK_QOS_TYPE_AUDIO);
-    if (rtpSocket == INVALID_SOCKET) {
-        return LastSocketFail();
+    if (preboundRtpSocket != INVALID_SOCKET) {
+        // Adopt the socket bound by LiPreconnect()
+        rtpSocket = preboundRtpSocket;
+        preboundRtpSocket = INVALID_SOCKET;
+    }
+    else {
+        rtpSocket = bindUdpSocket(RemoteAddr.ss_family, &LocalAddr, AddrLen, 0, SOCK_QOS_TYPE_AUDIO);
+        if (rtpSocket == INVALID_SOCKET) {
+            return LastSocketFail();
+        }
     }
 
+    memcpy(&pingAddr, &RemoteAddr, sizeof(pingAddr));
+    SET_PORT(&pingAddr, AudioPortNumber);
+    pingCount = 0;
+
     // We may receive audio before our threads are started, but that's okay. We'll
     // drop the first 1 second of audio packets to catch up with the backlog.
-    int err = PltCreateThread("AudioPing", AudioPingThreadProc, NULL, &udpPingThread);
-    if (err != 0) {
-        return err;
-    }
+    SchedInitializeTask(&pingTask, sendAudioPing, NULL, AUDIO_PING_INTERVAL_MS);
+    SchedAddTask(&pingTask, 0);
 
-    pingThreadStarted = true;
+    pingTaskStarted = true;
     return 0;
 }
 
@@ -116,7 +176,7 @@ static void freePacketList(PLINKED_BLOCKING_QUEUE_ENTRY entry) {
         nextEntry = entry->flink;
 
         // The entry is stored within the data allocation
-        free(entry->data);
+        BpFreeBuffer(&packetPool, entry->data);
 
         entry = nextEntry;
     }
@@ -125,9 +185,8 @@ static void freePacketList(PLINKED_BLOCKING_QUEUE_ENTRY entry) {
 // Tear down the audio stream once we're done with it
 void destroyAudioStream(void) {
     if (rtpSocket != INVALID_SOCKET) {
-        if (pingThreadStarted) {
-            PltInterruptThread(&udpPingThread);
-            PltJoinThread(&udpPingThread);
+        if (pingTaskStarted) {
+            SchedRemoveTask(&pingTask);
         }
 
         closeSocket(rtpSocket);
@@ -137,11 +196,16 @@ void destroyAudioStream(void) {
     PltDestroyCryptoContext(audioDecryptionCtx);
     freePacketList(LbqDestroyLinkedBlockingQueue(&packetQueue));
     RtpaCleanupQueue(&rtpAudioQueue);
+    BpDestroyPool(&packetPool);
 }
 
 static bool queuePacketToLbq(PQUEUED_AUDIO_PACKET* packet) {
     int err;
 
+    // The jitter buffer measures the arrival jitter from this time, which
+    // includes any time that the packet spent in the RTP audio queue.
+    (*packet)->header.queueTimeUs = PltGetMicroseconds();
+
     do {
         err = LbqOfferQueueItem(&packetQueue, *packet, &(*packet)->header.lentry);
         if (err == LBQ_SUCCESS) {
@@ -259,7 +323,7 @@ static void AudioReceiveThreadProc(void* context) {
     waitingForAudioMs = 0;
     while (!PltIsThreadInterrupted(&receiveThread)) {
         if (packet == NULL) {
-            packet = (PQUEUED_AUDIO_PACKET)malloc(sizeof(*packet));
+            packet = (PQUEUED_AUDIO_PACKET)BpAllocBuffer(&packetPool);
             if (packet == NULL) {
                 Limelog("Audio Receive: malloc() failed\n");
                 ListenerCallbacks.connectionTerminated(-1);
@@ -348,14 +412,14 @@ static void AudioReceiveThreadProc(void* context) {
                 // If packets are ready, pull them and send them to the decoder
                 uint16_t length;
                 PQUEUED_AUDIO_PACKET queuedPacket;
-                while ((queuedPacket = (PQUEUED_AUDIO_PACKET)RtpaGetQueuedPacket(&rtpAudioQueue, sizeof(QUEUED_AUDIO_PACKET_HEADER), &length)) != NULL) {
+                while ((queuedPacket = (PQUEUED_AUDIO_PACKET)RtpaGetQueuedPacket(&rtpAudioQueue, &packetPool, sizeof(QUEUED_AUDIO_PACKET_HEADER), &length)) != NULL) {
                     // Populate header data (not preserved in queued packets)
                     queuedPacket->header.size = length;
 
                     if ((AudioCallbacks.capabilities & CAPABILITY_DIRECT_SUBMIT) == 0) {
                         if (!queuePacketToLbq(&queuedPacket)) {
                             // An exit signal was received
-                            free(queuedPacket);
+                            BpFreeBuffer(&packetPool, queuedPacket);
                             break;
                         }
                         else {
@@ -365,7 +429,7 @@ static void AudioReceiveThreadProc(void* context) {
                     }
                     else {
                         decodeInputData(queuedPacket);
-                        free(queuedPacket);
+                        BpFreeBuffer(&packetPool, queuedPacket);
                     }
                 }
 
@@ -378,24 +442,150 @@ static void AudioReceiveThreadProc(void* context) {
     }
 
     if (packet != NULL) {
-        free(packet);
+        BpFreeBuffer(&packetPool, packet);
     }
 }
 
-static void AudioDecoderThreadProc(void* context) {
+// Packets leave the LBQ in sequence (with placeholders for lost packets), so each one
+// should arrive a packet duration after the previous one. The deviation from that is
+// smoothed like the RTP interarrival jitter (RFC 3550) and sets the target delay.
+static void updateJitterEstimate(PQUEUED_AUDIO_PACKET packet) {
+    int64_t packetDurationUs = (int64_t)AudioPacketDuration * 1000;
+
+    if (jitterBuffer.lastQueueTimeUs != 0) {
+        int64_t deviationUs = (int64_t)(packet->header.queueTimeUs - jitterBuffer.lastQueueTimeUs) - packetDurationUs;
+        if (deviationUs < 0) {
+            deviationUs = -deviationUs;
+        }
+        if (deviationUs > AUDIO_JITTER_MAX_DELAY_US) {
+            deviationUs = AUDIO_JITTER_MAX_DELAY_US;
+        }
+
+        jitterBuffer.scaledJitterUs += (uint32_t)deviationUs - ((jitterBuffer.scaledJitterUs + 8) >> 4);
+    }
+    jitterBuffer.lastQueueTimeUs = packet->header.queueTimeUs;
+
+    uint64_t targetDelayUs = packetDurationUs + (uint64_t)(jitterBuffer.scaledJitterUs >> 4) * AUDIO_JITTER_DELAY_MULTIPLIER;
+    if (targetDelayUs > AUDIO_JITTER_MAX_DELAY_US) {
+        targetDelayUs = AUDIO_JITTER_MAX_DELAY_US;
+    }
+    jitterBuffer.targetDelayUs = targetDelayUs;
+
+    jitterBufferStats.jitterUs = jitterBuffer.scaledJitterUs >> 4;
+    jitterBufferStats.targetDelayMs = (uint32_t)(targetDelayUs / 1000);
+}
+
+// Returns false if the thread was interrupted while waiting
+static bool waitForPlayoutTime(uint64_t playoutTimeUs) {
+    uint64_t now = PltGetMicroseconds();
+
+    if (playoutTimeUs > now) {
+        PltSleepMsInterruptible(&decoderThread, (int)((playoutTimeUs - now + 999) / 1000));
+    }
+
+    return !PltIsThreadInterrupted(&decoderThread);
+}
+
+// Returns the next packet to decode, NULL to conceal a packet that didn't arrive
+// in time for its playout slot, or sets *exit if an exit signal was received.
+static PQUEUED_AUDIO_PACKET getNextJitterBufferPacket(bool* exit) {
+    uint64_t packetDurationUs = (uint64_t)AudioPacketDuration * 1000;
+    PQUEUED_AUDIO_PACKET packet;
     int err;
+
+    *exit = false;
+
+    for (;;) {
+        if (!jitterBuffer.playing) {
+            // Buffer the first packet for the target delay before starting playout
+            err = LbqWaitForQueueElement(&packetQueue, (void**)&packet);
+            if (err != LBQ_SUCCESS) {
+                *exit = true;
+                return NULL;
+            }
+
+            updateJitterEstimate(packet);
+
+            jitterBuffer.nextPlayoutTimeUs = packet->header.queueTimeUs + jitterBuffer.targetDelayUs;
+            if (!waitForPlayoutTime(jitterBuffer.nextPlayoutTimeUs)) {
+                BpFreeBuffer(&packetPool, packet);
+                *exit = true;
+                return NULL;
+            }
+
+            jitterBuffer.playing = true;
+            jitterBuffer.concealedUs = 0;
+            return packet;
+        }
+
+        if (!waitForPlayoutTime(jitterBuffer.nextPlayoutTimeUs)) {
+            *exit = true;
+            return NULL;
+        }
+
+        err = LbqPollQueueElement(&packetQueue, (void**)&packet);
+        if (err == LBQ_INTERRUPTED) {
+            *exit = true;
+            return NULL;
+        }
+        else if (err == LBQ_NO_ELEMENT) {
+            if (jitterBuffer.concealedUs >= AUDIO_JITTER_MAX_CONCEAL_US) {
+                // The stream has stalled, so wait for it to resume. Whatever arrives next
+                // starts a new playout with a fresh delay instead of being played late.
+                jitterBuffer.playing = false;
+                jitterBufferStats.rebufferCount++;
+                continue;
+            }
+
+            // Conceal this slot. If the packet shows up later, we keep it, which grows the
+            // delay by a packet until the queue depth exceeds the target and it is trimmed.
+            jitterBuffer.concealedUs += packetDurationUs;
+            jitterBufferStats.packetCountConcealed++;
+            return NULL;
+        }
+
+        updateJitterEstimate(packet);
+        jitterBuffer.concealedUs = 0;
+
+        // If more audio is queued than the target delay calls for (after a burst or once
+        // the jitter subsides), drop this packet and play the next one in its slot.
+        if ((uint64_t)LbqGetItemCount(&packetQueue) * packetDurationUs > jitterBuffer.targetDelayUs + 2 * packetDurationUs) {
+            BpFreeBuffer(&packetPool, packet);
+            jitterBufferStats.packetCountTrimmed++;
+            continue;
+        }
+
+        return packet;
+    }
+}
+
+static void AudioDecoderThreadProc(void* context) {
+    uint64_t packetDurationUs = (uint64_t)AudioPacketDuration * 1000;
     PQUEUED_AUDIO_PACKET packet;
+    bool exit;
 
     while (!PltIsThreadInterrupted(&decoderThread)) {
-        err = LbqWaitForQueueElement(&packetQueue, (void**)&packet);
-        if (err != LBQ_SUCCESS) {
+        packet = getNextJitterBufferPacket(&exit);
+        if (exit) {
             // An exit signal was received
             return;
         }
 
-        decodeInputData(packet);
+        if (packet != NULL) {
+            decodeInputData(packet);
+            BpFreeBuffer(&packetPool, packet);
+        }
+        else {
+            // Trigger packet loss concealment in libopus for the missed slot
+            AudioCallbacks.decodeAndPlaySample(NULL, 0);
+        }
 
-        free(packet);
+        // Schedule the next slot, unless we've fallen so far behind that we should
+        // just resynchronize our playout clock (if this thread wasn't scheduled, etc.)
+        jitterBuffer.nextPlayoutTimeUs += packetDurationUs;
+        if (jitterBuffer.nextPlayoutTimeUs + AUDIO_JITTER_MAX_DELAY_US < PltGetMicroseconds()) {
+            jitterBuffer.nextPlayoutTimeUs = PltGetMicroseconds();
+        }
     }
 }
 
@@ -421,8 +611,9 @@ void stopAudioStream(void) {
     AudioCallbacks.cleanup();
 }
 
-int startAudioStream(void* audioContext, int arFlags) {
-    int err;
+// Set up the audio renderer. This doesn't talk to the host,
+// so it can run while the control stream is starting.
+int prepareAudioStream(void* audioContext, int arFlags) {
     OPUS_MULTISTREAM_CONFIGURATION chosenConfig;
 
     if (HighQualitySurroundEnabled) {
@@ -439,14 +630,21 @@ int startAudioStream(void* audioContext, int arFlags) {
 
     chosenConfig.samplesPerFrame = 48 * AudioPacketDuration;
 
-    err = AudioCallbacks.init(StreamConfig.audioConfiguration, &chosenConfig, audioContext, arFlags);
-    if (err != 0) {
-        return err;
-    }
+    return AudioCallbacks.init(StreamConfig.audioConfiguration, &chosenConfig, audioContext, arFlags);
+}
+
+// Undo prepareAudioStream() when the audio stream won't be started
+void unprepareAudioStream(void) {
+    AudioCallbacks.cleanup();
+}
+
+// Start the audio stream after prepareAudioStream()
+int startAudioStream(void) {
+    int err;
 
     AudioCallbacks.start();
 
-    err = PltCreateThread("AudioRecv", AudioReceiveThreadProc, NULL, &receiveThread);
+    err = PltCreateThread("AudioRecv", PLT_THREAD_ROLE_RECEIVE, AudioReceiveThreadProc, NULL, &receiveThread);
     if (err != 0) {
         AudioCallbacks.stop();
         closeSocket(rtpSocket);
@@ -455,7 +653,7 @@ int startAudioStream(void* audioContext, int arFlags) {
     }
 
     if ((AudioCallbacks.capabilities & CAPABILITY_DIRECT_SUBMIT) == 0) {
-        err = PltCreateThread("AudioDec", AudioDecoderThreadProc, NULL, &decoderThread);
+        err = PltCreateThread("AudioDec", PLT_THREAD_ROLE_AUDIO, AudioDecoderThreadProc, NULL, &decoderThread);
         if (err != 0) {
             AudioCallbacks.stop();
             PltInterruptThread(&receiveThread);
@@ -480,3 +678,7 @@ int LiGetPendingAudioDuration(void) {
 const RTP_AUDIO_STATS* LiGetRTPAudioStats(void) {
     return &rtpAudioQueue.stats;
 }
+
+const AUDIO_JITTER_BUFFER_STATS* LiGetAudioJitterBufferStats(void) {
+    return &jitterBufferStats;
+}
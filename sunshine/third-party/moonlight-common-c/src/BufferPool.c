@@ -0,0 +1,104 @@
+#include "BufferPool.h"
+
+// Free buffers are chained through their first bytes
+typedef struct _BUFFER_POOL_ENTRY {
+    struct _BUFFER_POOL_ENTRY* next;
+} BUFFER_POOL_ENTRY, *PBUFFER_POOL_ENTRY;
+
+int BpInitializePool(PBUFFER_POOL pool, int bufferSize, int maxFreeCount) {
+    int err;
+
+    memset(pool, 0, sizeof(*pool));
+
+    err = PltCreateMutex(&pool->mutex);
+    if (err != 0) {
+        return err;
+    }
+
+    pool->bufferSize = bufferSize < (int)sizeof(BUFFER_POOL_ENTRY) ? (int)sizeof(BUFFER_POOL_ENTRY) : bufferSize;
+    pool->maxFreeCount = maxFreeCount;
+
+    return 0;
+}
+
+// Fills the free list up front so the first allocations don't hit the heap either.
+// Returns the number of buffers that could be allocated.
+int BpPreallocateBuffers(PBUFFER_POOL pool, int count) {
+    int allocated = 0;
+
+    PltLockMutex(&pool->mutex);
+
+    while (allocated < count && pool->freeCount < pool->maxFreeCount) {
+        PBUFFER_POOL_ENTRY entry = malloc(pool->bufferSize);
+        if (entry == NULL) {
+            break;
+        }
+
+        entry->next = pool->freeList;
+        pool->freeList = entry;
+        pool->freeCount++;
+        allocated++;
+    }
+
+    PltUnlockMutex(&pool->mutex);
+
+    return allocated;
+}
+
+// Returns a buffer of at least bufferSize bytes, or NULL if out of memory
+void* BpAllocBuffer(PBUFFER_POOL pool) {
+    PBUFFER_POOL_ENTRY entry;
+
+    PltLockMutex(&pool->mutex);
+
+    entry = pool->freeList;
+    if (entry != NULL) {
+        pool->freeList = entry->next;
+        pool->freeCount--;
+    }
+
+    PltUnlockMutex(&pool->mutex);
+
+    if (entry == NULL) {
+        entry = malloc(pool->bufferSize);
+    }
+
+    return entry;
+}
+
+void BpFreeBuffer(PBUFFER_POOL pool, void* buffer) {
+    PBUFFER_POOL_ENTRY entry = buffer;
+
+    if (entry == NULL) {
+        return;
+    }
+
+    PltLockMutex(&pool->mutex);
+
+    if (pool->freeCount < pool->maxFreeCount) {
+        entry->next = pool->freeList;
+        pool->freeList = entry;
+        pool->freeCount++;
+        entry = NULL;
+    }
+
+    PltUnlockMutex(&pool->mutex);
+
+    // The pool is full, so give this one back to the heap
+    if (entry != NULL) {
+        free(entry);
+    }
+}
+
+// All buffers must have been freed back to the pool (or the heap) before this is called
+void BpDestroyPool(PBUFFER_POOL pool) {
+    while (pool->freeList != NULL) {
+        PBUFFER_POOL_ENTRY entry = pool->freeList;
+        pool->freeList = entry->next;
+        free(entry);
+    }
+
+    pool->freeCount = 0;
+
+    PltDeleteMutex(&pool->mutex);
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Platform.h"
+#include "PlatformThreads.h"
+
+// A thread-safe free list of fixed-size buffers. Freed buffers are kept for
+// reuse (up to maxFreeCount of them) instead of being returned to the heap,
+// so a steady stream of allocations stops hitting malloc() once warmed up.
+typedef struct _BUFFER_POOL {
+    PLT_MUTEX mutex;
+    void* freeList;
+    int bufferSize;
+    int freeCount;
+    int maxFreeCount;
+} BUFFER_POOL, *PBUFFER_POOL;
+
+int BpInitializePool(PBUFFER_POOL pool, int bufferSize, int maxFreeCount);
+int BpPreallocateBuffers(PBUFFER_POOL pool, int count);
+void* BpAllocBuffer(PBUFFER_POOL pool);
+void BpFreeBuffer(PBUFFER_POOL pool, void* buffer);
+void BpDestroyPool(PBUFFER_POOL pool);
@@ -27,3 +27,107 @@ bool BbPut8(PBYTE_BUFFER buff, uint8_t c);
 bool BbPut16(PBYTE_BUFFER buff, uint16_t s);
 bool BbPut32(PBYTE_BUFFER buff, uint32_t i);
 bool BbPut64(PBYTE_BUFFER buff, uint64_t l);
+
+// Inline accessors with a fixed byte order for hot parsing and serialization paths.
+// These perform no bounds checking of their own, so callers must validate the whole
+// message once with BbHasRemaining() before using them.
+static inline bool BbHasRemaining(PBYTE_BUFFER buff, unsigned int length) {
+    // position never exceeds length, so this can't underflow
+    return buff->length - buff->position >= length;
+}
+
+static inline void BbGetBytesUnchecked(PBYTE_BUFFER buff, uint8_t* data, unsigned int length) {
+    memcpy(data, &buff->buffer[buff->position], length);
+    buff->position += length;
+}
+
+static inline uint8_t BbGet8Unchecked(PBYTE_BUFFER buff) {
+    return (uint8_t)buff->buffer[buff->position++];
+}
+
+static inline uint16_t BbGetLE16Unchecked(PBYTE_BUFFER buff) {
+    uint16_t s;
+    memcpy(&s, &buff->buffer[buff->position], sizeof(s));
+    buff->position += sizeof(s);
+    return LE16(s);
+}
+
+static inline uint16_t BbGetBE16Unchecked(PBYTE_BUFFER buff) {
+    uint16_t s;
+    memcpy(&s, &buff->buffer[buff->position], sizeof(s));
+    buff->position += sizeof(s);
+    return BE16(s);
+}
+
+static inline uint32_t BbGetLE32Unchecked(PBYTE_BUFFER buff) {
+    uint32_t i;
+    memcpy(&i, &buff->buffer[buff->position], sizeof(i));
+    buff->position += sizeof(i);
+    return LE32(i);
+}
+
+static inline uint32_t BbGetBE32Unchecked(PBYTE_BUFFER buff) {
+    uint32_t i;
+    memcpy(&i, &buff->buffer[buff->position], sizeof(i));
+    buff->position += sizeof(i);
+    return BE32(i);
+}
+
+static inline uint64_t BbGetLE64Unchecked(PBYTE_BUFFER buff) {
+    uint64_t l;
+    memcpy(&l, &buff->buffer[buff->position], sizeof(l));
+    buff->position += sizeof(l);
+    return LE64(l);
+}
+
+static inline uint64_t BbGetBE64Unchecked(PBYTE_BUFFER buff) {
+    uint64_t l;
+    memcpy(&l, &buff->buffer[buff->position], sizeof(l));
+    buff->position += sizeof(l);
+    return BE64(l);
+}
+
+static inline void BbPutBytesUnchecked(PBYTE_BUFFER buff, const uint8_t* data, unsigned int length) {
+    memcpy(&buff->buffer[buff->position], data, length);
+    buff->position += length;
+}
+
+static inline void BbPut8Unchecked(PBYTE_BUFFER buff, uint8_t c) {
+    buff->buffer[buff->position++] = (char)c;
+}
+
+static inline void BbPutLE16Unchecked(PBYTE_BUFFER buff, uint16_t s) {
+    s = LE16(s);
+    memcpy(&buff->buffer[buff->position], &s, sizeof(s));
+    buff->position += sizeof(s);
+}
+
+static inline void BbPutBE16Unchecked(PBYTE_BUFFER buff, uint16_t s) {
+    s = BE16(s);
+    memcpy(&buff->buffer[buff->position], &s, sizeof(s));
+    buff->position += sizeof(s);
+}
+
+static inline void BbPutLE32Unchecked(PBYTE_BUFFER buff, uint32_t i) {
+    i = LE32(i);
+    memcpy(&buff->buffer[buff->position], &i, sizeof(i));
+    buff->position += sizeof(i);
+}
+
+static inline void BbPutBE32Unchecked(PBYTE_BUFFER buff, uint32_t i) {
+    i = BE32(i);
+    memcpy(&buff->buffer[buff->position], &i, sizeof(i));
+    buff->position += sizeof(i);
+}
+
+static inline void BbPutLE64Unchecked(PBYTE_BUFFER buff, uint64_t l) {
+    l = LE64(l);
+    memcpy(&buff->buffer[buff->position], &l, sizeof(l));
+    buff->position += sizeof(l);
+}
+
+static inline void BbPutBE64Unchecked(PBYTE_BUFFER buff, uint64_t l) {
+    l = BE64(l);
+    memcpy(&buff->buffer[buff->position], &l, sizeof(l));
+    buff->position += sizeof(l);
+}
@@ -5,6 +5,32 @@ static ConnListenerConnectionTerminated originalTerminationCallback;
 static bool alreadyTerminated;
 static PLT_THREAD terminationCallbackThread;
 static int terminationCallbackErrorCode;
+static PLT_THREAD controlStreamStartThread;
+static int controlStreamStartError;
+
+// A connection context is a handle to one streaming session. The session state
+// itself still lives in the module globals below, so only one context may own
+// it at a time. LiStartConnection() and friends operate on defaultContext.
+struct _CONNECTION_CONTEXT {
+    bool started;
+};
+static struct _CONNECTION_CONTEXT defaultContext;
+static PLT_ATOMIC_INT sessionClaimed;
+static PCONNECTION_CONTEXT activeContext;
+
+// State set up by LiPreconnect() and handed over to the next session started
+// to the same address. While it is valid, the platform stays initialized and
+// the stream sockets stay bound.
+#define PRECONNECT_DEFAULT_WARM_PERIOD_MS 30000
+static struct {
+    bool valid;
+    char* address;
+    uint64_t expiryTimeMs;
+    struct sockaddr_storage remoteAddr;
+    struct sockaddr_storage localAddr;
+    SOCKADDR_LEN addrLen;
+    bool isNat64;
+} preconnectState;
 
 // Common globals
 char* RemoteAddrString;
@@ -65,6 +91,53 @@ void LiInterruptConnection(void) {
     ConnectionInterrupted = true;
 }
 
+// Close the pre-connection sockets that the session didn't adopt
+static void releasePreboundStreams(void) {
+    releasePreboundControlStream();
+    releasePreboundVideoStream();
+    releasePreboundAudioStream();
+}
+
+static void releasePreconnect(void) {
+    if (!preconnectState.valid) {
+        return;
+    }
+
+    releasePreboundStreams();
+    cleanupPlatform();
+
+    free(preconnectState.address);
+    memset(&preconnectState, 0, sizeof(preconnectState));
+}
+
+// Take over the pre-connection if it was made to this address and is still warm
+static bool adoptPreconnect(const char* address, bool* isNat64) {
+    if (!preconnectState.valid) {
+        return false;
+    }
+
+    if (strcmp(preconnectState.address, address) != 0) {
+        Limelog("Discarding pre-connection to %s\n", preconnectState.address);
+        releasePreconnect();
+        return false;
+    }
+    else if (PltGetMillis() > preconnectState.expiryTimeMs) {
+        Limelog("Discarding expired pre-connection to %s\n", preconnectState.address);
+        releasePreconnect();
+        return false;
+    }
+
+    memcpy(&RemoteAddr, &preconnectState.remoteAddr, sizeof(RemoteAddr));
+    memcpy(&LocalAddr, &preconnectState.localAddr, sizeof(LocalAddr));
+    AddrLen = preconnectState.addrLen;
+    *isNat64 = preconnectState.isNat64;
+
+    // The platform and the prebound sockets now belong to the session
+    free(preconnectState.address);
+    memset(&preconnectState, 0, sizeof(preconnectState));
+    return true;
+}
+
 // Stop the connection by undoing the step at the current stage and those before it
 void LiStopConnection(void) {
     // Disable termination callbacks now
@@ -131,6 +204,7 @@ void LiStopConnection(void) {
     }
     if (stage == STAGE_PLATFORM_INIT) {
         Limelog("Cleaning up platform...");
+        releasePreboundStreams();
         cleanupPlatform();
         stage--;
         Limelog("done\n");
@@ -141,6 +215,13 @@ void LiStopConnection(void) {
         free(RemoteAddrString);
         RemoteAddrString = NULL;
     }
+
+    // Hand the session state back for the next context to claim
+    if (activeContext != NULL) {
+        activeContext->started = false;
+        activeContext = NULL;
+        PltAtomicStore(&sessionClaimed, 0);
+    }
 }
 
 static void terminationCallbackThreadFunc(void* context)
@@ -149,6 +230,13 @@ static void terminationCallbackThreadFunc(void* context)
     originalTerminationCallback(terminationCallbackErrorCode);
 }
 
+// The control stream handshake takes a few round trips to the host, so it runs
+// on its own thread while LiStartConnection() sets up the decoders locally.
+static void controlStreamStartThreadFunc(void* context)
+{
+    controlStreamStartError = startControlStream();
+}
+
 // This shim callback runs the client's connectionTerminated() callback on a
 // separate thread. This is neccessary because other internal threads directly
 // invoke this callback. That can result in a deadlock if the client
@@ -168,7 +256,7 @@ static void ClInternalConnectionTerminated(int errorCode)
     alreadyTerminated = true;
 
     // Invoke the termination callback on a separate thread
-    err = PltCreateThread("AsyncTerm", terminationCallbackThreadFunc, NULL, &terminationCallbackThread);
+    err = PltCreateThread("AsyncTerm", PLT_THREAD_ROLE_DEFAULT, terminationCallbackThreadFunc, NULL, &terminationCallbackThread);
     if (err != 0) {
         // Nothing we can safely do here, so we'll just assert on debug builds
         Limelog("Failed to create termination thread: %d\n", err);
@@ -205,11 +293,50 @@ static bool parseRtspPortNumberFromUrl(const char* rtspSessionUrl, uint16_t* por
     return true;
 }
 
+// Resolve the host into RemoteAddr and AddrLen, testing reachability on a port
+// that should be listening
+static int resolveRemoteAddress(const char* address, uint16_t rtspPort) {
+    int err;
+
+    if (rtspPort != 48010) {
+        // If we have an alternate RTSP port, use that as our test port. The host probably
+        // isn't listening on 47989 or 47984 anyway, since they're using alternate ports.
+        err = resolveHostName(address, AF_UNSPEC, rtspPort, &RemoteAddr, &AddrLen);
+        if (err != 0) {
+            // Sleep for a second and try again. It's possible that we've attempt to connect
+            // before the host has gotten around to listening on the RTSP port. Give it some
+            // time before retrying.
+            PltSleepMs(1000);
+            err = resolveHostName(address, AF_UNSPEC, rtspPort, &RemoteAddr, &AddrLen);
+        }
+    }
+    else {
+        // We use TCP 47984 and 47989 first here because we know those should always be listening
+        // on hosts using the standard ports.
+        //
+        // TCP 48010 is a last resort because:
+        // a) it's not always listening and there's a race between listen() on the host and our connect()
+        // b) it's not used at all by certain host versions which perform RTSP over ENet
+        err = resolveHostName(address, AF_UNSPEC, 47984, &RemoteAddr, &AddrLen);
+        if (err != 0) {
+            err = resolveHostName(address, AF_UNSPEC, 47989, &RemoteAddr, &AddrLen);
+        }
+        if (err != 0) {
+            err = resolveHostName(address, AF_UNSPEC, 48010, &RemoteAddr, &AddrLen);
+        }
+    }
+
+    return err;
+}
+
 // Starts the connection to the streaming machine
-int LiStartConnection(PSERVER_INFORMATION serverInfo, PSTREAM_CONFIGURATION streamConfig, PCONNECTION_LISTENER_CALLBACKS clCallbacks,
+static int startConnection(PSERVER_INFORMATION serverInfo, PSTREAM_CONFIGURATION streamConfig, PCONNECTION_LISTENER_CALLBACKS clCallbacks,
     PDECODER_RENDERER_CALLBACKS drCallbacks, PAUDIO_RENDERER_CALLBACKS arCallbacks, void* renderContext, int drFlags,
     void* audioContext, int arFlags) {
     int err;
+    int videoPrepareErr, audioPrepareErr;
+    bool warmStart;
+    bool isNat64 = false;
 
     if (drCallbacks != NULL && (drCallbacks->capabilities & CAPABILITY_PULL_RENDERER) && drCallbacks->submitDecodeUnit) {
         Limelog("CAPABILITY_PULL_RENDERER cannot be set with a submitDecodeUnit callback\n");
@@ -331,7 +458,8 @@ int LiStartConnection(PSERVER_INFORMATION serverInfo, PSTREAM_CONFIGURATION stre
     
     Limelog("Initializing platform...");
     ListenerCallbacks.stageStarting(STAGE_PLATFORM_INIT);
-    err = initializePlatform();
+    warmStart = adoptPreconnect(serverInfo->address, &isNat64);
+    err = warmStart ? 0 : initializePlatform();
     if (err != 0) {
         Limelog("failed: %d\n", err);
         ListenerCallbacks.stageFailed(STAGE_PLATFORM_INIT, err);
@@ -345,32 +473,12 @@ int LiStartConnection(PSERVER_INFORMATION serverInfo, PSTREAM_CONFIGURATION stre
     Limelog("Resolving host name...");
     ListenerCallbacks.stageStarting(STAGE_NAME_RESOLUTION);
     LC_ASSERT(RtspPortNumber != 0);
-    if (RtspPortNumber != 48010) {
-        // If we have an alternate RTSP port, use that as our test port. The host probably
-        // isn't listening on 47989 or 47984 anyway, since they're using alternate ports.
-        err = resolveHostName(serverInfo->address, AF_UNSPEC, RtspPortNumber, &RemoteAddr, &AddrLen);
-        if (err != 0) {
-            // Sleep for a second and try again. It's possible that we've attempt to connect
-            // before the host has gotten around to listening on the RTSP port. Give it some
-            // time before retrying.
-            PltSleepMs(1000);
-            err = resolveHostName(serverInfo->address, AF_UNSPEC, RtspPortNumber, &RemoteAddr, &AddrLen);
-        }
+    if (warmStart) {
+        // Already resolved by LiPreconnect()
+        err = 0;
     }
     else {
-        // We use TCP 47984 and 47989 first here because we know those should always be listening
-        // on hosts using the standard ports.
-        //
-        // TCP 48010 is a last resort because:
-        // a) it's not always listening and there's a race between listen() on the host and our connect()
-        // b) it's not used at all by certain host versions which perform RTSP over ENet
-        err = resolveHostName(serverInfo->address, AF_UNSPEC, 47984, &RemoteAddr, &AddrLen);
-        if (err != 0) {
-            err = resolveHostName(serverInfo->address, AF_UNSPEC, 47989, &RemoteAddr, &AddrLen);
-        }
-        if (err != 0) {
-            err = resolveHostName(serverInfo->address, AF_UNSPEC, 48010, &RemoteAddr, &AddrLen);
-        }
+        err = resolveRemoteAddress(serverInfo->address, RtspPortNumber);
     }
     if (err != 0) {
         Limelog("failed: %d\n", err);
@@ -386,7 +494,10 @@ int LiStartConnection(PSERVER_INFORMATION serverInfo, PSTREAM_CONFIGURATION stre
     // now that we have resolved the target address and impose the video packet
     // size cap if required.
     if (StreamConfig.streamingRemotely == STREAM_CFG_AUTO) {
-        bool isNat64 = isNat64SynthesizedAddress(&RemoteAddr);
+        // This check costs a DNS query, so LiPreconnect() did it already if it ran
+        if (!warmStart) {
+            isNat64 = isNat64SynthesizedAddress(&RemoteAddr);
+        }
 
         // It's possible to have a NAT64 prefix on a ULA or other private range,
         // so we must exclude NAT64 addresses from our local address checks.
@@ -468,12 +579,38 @@ int LiStartConnection(PSERVER_INFORMATION serverInfo, PSTREAM_CONFIGURATION stre
 
     Limelog("Starting control stream...");
     ListenerCallbacks.stageStarting(STAGE_CONTROL_STREAM_START);
-    err = startControlStream();
+    err = PltCreateThread("CtrlStart", PLT_THREAD_ROLE_CONTROL, controlStreamStartThreadFunc, NULL, &controlStreamStartThread);
     if (err != 0) {
         Limelog("failed: %d\n", err);
         ListenerCallbacks.stageFailed(STAGE_CONTROL_STREAM_START, err);
         goto Cleanup;
     }
+
+    // Nothing here talks to the host, so it overlaps with the control stream
+    // handshake. Decoder and audio device setup can take a while on some clients.
+    // The stage callbacks are still reported in order once the handshake is done.
+
+    // Find out whether decryption could be a bottleneck before video starts flowing
+    if (EncryptionFeaturesEnabled & SS_ENC_VIDEO) {
+        PltMeasureCryptoThroughput();
+    }
+
+    videoPrepareErr = prepareVideoStream(renderContext, drFlags);
+    audioPrepareErr = videoPrepareErr == 0 ? prepareAudioStream(audioContext, arFlags) : 0;
+
+    PltJoinThread(&controlStreamStartThread);
+    err = controlStreamStartError;
+    if (err != 0) {
+        Limelog("failed: %d\n", err);
+        ListenerCallbacks.stageFailed(STAGE_CONTROL_STREAM_START, err);
+        if (videoPrepareErr == 0) {
+            if (audioPrepareErr == 0) {
+                unprepareAudioStream();
+            }
+            unprepareVideoStream();
+        }
+        goto Cleanup;
+    }
     stage++;
     LC_ASSERT(stage == STAGE_CONTROL_STREAM_START);
     ListenerCallbacks.stageComplete(STAGE_CONTROL_STREAM_START);
@@ -481,10 +618,13 @@ int LiStartConnection(PSERVER_INFORMATION serverInfo, PSTREAM_CONFIGURATION stre
 
     Limelog("Starting video stream...");
     ListenerCallbacks.stageStarting(STAGE_VIDEO_STREAM_START);
-    err = startVideoStream(renderContext, drFlags);
+    err = videoPrepareErr != 0 ? videoPrepareErr : startVideoStream();
     if (err != 0) {
         Limelog("Video stream start failed: %d\n", err);
         ListenerCallbacks.stageFailed(STAGE_VIDEO_STREAM_START, err);
+        if (videoPrepareErr == 0 && audioPrepareErr == 0) {
+            unprepareAudioStream();
+        }
         goto Cleanup;
     }
     stage++;
@@ -494,7 +634,7 @@ int LiStartConnection(PSERVER_INFORMATION serverInfo, PSTREAM_CONFIGURATION stre
 
     Limelog("Starting audio stream...");
     ListenerCallbacks.stageStarting(STAGE_AUDIO_STREAM_START);
-    err = startAudioStream(audioContext, arFlags);
+    err = audioPrepareErr != 0 ? audioPrepareErr : startAudioStream();
     if (err != 0) {
         Limelog("Audio stream start failed: %d\n", err);
         ListenerCallbacks.stageFailed(STAGE_AUDIO_STREAM_START, err);
@@ -534,6 +674,164 @@ Cleanup:
     return err;
 }
 
+PCONNECTION_CONTEXT LiCreateConnectionContext(void) {
+    PCONNECTION_CONTEXT context;
+
+    context = calloc(1, sizeof(*context));
+    if (context == NULL) {
+        Limelog("Failed to allocate connection context\n");
+    }
+
+    return context;
+}
+
+int LiStartConnectionWithContext(PCONNECTION_CONTEXT context, PSERVER_INFORMATION serverInfo, PSTREAM_CONFIGURATION streamConfig,
+    PCONNECTION_LISTENER_CALLBACKS clCallbacks, PDECODER_RENDERER_CALLBACKS drCallbacks, PAUDIO_RENDERER_CALLBACKS arCallbacks,
+    void* renderContext, int drFlags, void* audioContext, int arFlags) {
+    int expected = 0;
+
+    LC_ASSERT(context != NULL);
+
+    // Fail before touching any state if another context still owns the session,
+    // since the usual cleanup path would tear down that context's streams.
+    if (!PltAtomicCompareExchange(&sessionClaimed, &expected, 1)) {
+        Limelog("Another connection context is already active\n");
+        return -1;
+    }
+
+    activeContext = context;
+    context->started = true;
+
+    // On failure, startConnection() calls LiStopConnection() which releases the claim
+    return startConnection(serverInfo, streamConfig, clCallbacks, drCallbacks, arCallbacks,
+                           renderContext, drFlags, audioContext, arFlags);
+}
+
+int LiStartConnection(PSERVER_INFORMATION serverInfo, PSTREAM_CONFIGURATION streamConfig, PCONNECTION_LISTENER_CALLBACKS clCallbacks,
+    PDECODER_RENDERER_CALLBACKS drCallbacks, PAUDIO_RENDERER_CALLBACKS arCallbacks, void* renderContext, int drFlags,
+    void* audioContext, int arFlags) {
+    return LiStartConnectionWithContext(&defaultContext, serverInfo, streamConfig, clCallbacks, drCallbacks, arCallbacks,
+                                        renderContext, drFlags, audioContext, arFlags);
+}
+
+void LiStopConnectionWithContext(PCONNECTION_CONTEXT context) {
+    // Stopping a context that isn't running is a no-op, like LiStopConnection()
+    if (context != NULL && context->started && activeContext == context) {
+        LiStopConnection();
+    }
+}
+
+void LiInterruptConnectionWithContext(PCONNECTION_CONTEXT context) {
+    if (context != NULL && context->started && activeContext == context) {
+        LiInterruptConnection();
+    }
+}
+
+void LiDestroyConnectionContext(PCONNECTION_CONTEXT context) {
+    if (context == NULL) {
+        return;
+    }
+
+    LC_ASSERT(context != &defaultContext);
+
+    // Don't leave the session claimed by a context that no longer exists
+    LiStopConnectionWithContext(context);
+    free(context);
+}
+
+int LiPreconnect(PSERVER_INFORMATION serverInfo, PCONNECTION_LISTENER_CALLBACKS clCallbacks, int warmPeriodMs) {
+    PDECODER_RENDERER_CALLBACKS drCallbacks = NULL;
+    PAUDIO_RENDERER_CALLBACKS arCallbacks = NULL;
+    uint16_t rtspPort;
+    int expected = 0;
+    int err;
+
+    // The pre-connection shares the session globals, so it can't run under a session
+    if (!PltAtomicCompareExchange(&sessionClaimed, &expected, 1)) {
+        Limelog("Unable to pre-connect while a connection is active\n");
+        return -1;
+    }
+
+    // Only one host can be kept warm at a time
+    releasePreconnect();
+
+    // Initialize ListenerCallbacks before anything that could call Limelog()
+    fixupMissingCallbacks(&drCallbacks, &arCallbacks, &clCallbacks);
+    memcpy(&ListenerCallbacks, clCallbacks, sizeof(ListenerCallbacks));
+
+    if (!parseRtspPortNumberFromUrl(serverInfo->rtspSessionUrl, &rtspPort)) {
+        rtspPort = 48010;
+    }
+
+    err = initializePlatform();
+    if (err != 0) {
+        Limelog("Pre-connect platform initialization failed: %d\n", err);
+        goto Exit;
+    }
+
+    err = resolveRemoteAddress(serverInfo->address, rtspPort);
+    if (err != 0) {
+        Limelog("Pre-connect name resolution failed: %d\n", err);
+        goto Fail;
+    }
+
+    // Bind to the address the RTSP connection will come from, like a regular start
+    memset(&LocalAddr, 0, sizeof(LocalAddr));
+    err = getLocalAddressForRemote(&RemoteAddr, AddrLen, &LocalAddr);
+    if (err != 0) {
+        Limelog("Pre-connect local address lookup failed: %d\n", err);
+    }
+
+    err = prebindAudioStream();
+    if (err == 0) {
+        err = prebindVideoStream();
+    }
+    if (err == 0) {
+        err = prebindControlStream();
+    }
+    if (err != 0) {
+        Limelog("Pre-connect socket setup failed: %d\n", err);
+        goto Fail;
+    }
+
+    preconnectState.isNat64 = isNat64SynthesizedAddress(&RemoteAddr);
+
+    // Load the crypto library and pick its implementation now rather than at launch
+    PltMeasureCryptoThroughput();
+
+    preconnectState.address = strdup(serverInfo->address);
+    if (preconnectState.address == NULL) {
+        err = -1;
+        goto Fail;
+    }
+
+    memcpy(&preconnectState.remoteAddr, &RemoteAddr, sizeof(RemoteAddr));
+    memcpy(&preconnectState.localAddr, &LocalAddr, sizeof(LocalAddr));
+    preconnectState.addrLen = AddrLen;
+    preconnectState.expiryTimeMs = PltGetMillis() +
+        (warmPeriodMs > 0 ? warmPeriodMs : PRECONNECT_DEFAULT_WARM_PERIOD_MS);
+    preconnectState.valid = true;
+    goto Exit;
+
+Fail:
+    releasePreboundStreams();
+    cleanupPlatform();
+
+Exit:
+    PltAtomicStore(&sessionClaimed, 0);
+    return err;
+}
+
+void LiCancelPreconnect(void) {
+    int expected = 0;
+
+    // A running session already adopted or released the pre-connection
+    if (PltAtomicCompareExchange(&sessionClaimed, &expected, 1)) {
+        releasePreconnect();
+        PltAtomicStore(&sessionClaimed, 0);
+    }
+}
+
 const char* LiGetLaunchUrlQueryParameters(void) {
     // v0 = Video encryption and control stream encryption v2
     // v1 = RTSP encryption
@@ -14,6 +14,10 @@
 
 #define MTU_TEST_SIZE 1040
 
+// UDP is unreliable, so we send a few test packets to each port
+#define UDP_TEST_PACKET_COUNT 3
+#define UDP_TEST_PACKET_INTERVAL_MS 50
+
 unsigned int LiGetPortFlagsFromStage(int stage)
 {
     switch (stage)
@@ -113,6 +117,7 @@ unsigned int LiTestClientConnectivity(const char* testServer, unsigned short ref
     int i;
     int err;
     SOCKET sockets[PORT_FLAGS_MAX_COUNT];
+    uint64_t deadline;
 
     // Mask out invalid ports from the port flags
     testPortFlags &= VALID_PORT_FLAG_MASK;
@@ -165,34 +170,42 @@ unsigned int LiTestClientConnectivity(const char* testServer, unsigned short ref
                     }
                 }
             }
-            else {
-                const char buf[MTU_TEST_SIZE] = "moonlight-ctest";
-                int j;
+        }
+    }
 
-                // Send a few packets since UDP is unreliable
-                for (j = 0; j < 3; j++) {
-                    err = sendto(sockets[i], buf, sizeof(buf), 0, (struct sockaddr*)&address, address_length);
-                    if (err < 0) {
-                        err = (int)LastSocketError();
-                        Limelog("Failed to send test packet to UDP %u: %d\n", LiGetPortFromPortFlagIndex(i), err);
+    // Send the UDP test packets in rounds across all ports, rather than one port
+    // after another, so the UDP tests take the same time regardless of the port count.
+    for (int round = 0; round < UDP_TEST_PACKET_COUNT; round++) {
+        const char buf[MTU_TEST_SIZE] = "moonlight-ctest";
 
-                        // Mask off this bit so we don't try to include it in pollSockets() below
-                        testPortFlags &= ~(1U << i);
+        if (round != 0) {
+            PltSleepMs(UDP_TEST_PACKET_INTERVAL_MS);
+        }
 
-                        break;
-                    }
+        for (i = 0; i < PORT_FLAGS_MAX_COUNT; i++) {
+            if ((testPortFlags & (1U << i)) && LiGetProtocolFromPortFlagIndex(i) == IPPROTO_UDP) {
+                SET_PORT((LC_SOCKADDR*)&address, LiGetPortFromPortFlagIndex(i));
+                err = sendto(sockets[i], buf, sizeof(buf), 0, (struct sockaddr*)&address, address_length);
+                if (err < 0) {
+                    err = (int)LastSocketError();
+                    Limelog("Failed to send test packet to UDP %u: %d\n", LiGetPortFromPortFlagIndex(i), err);
 
-                    PltSleepMs(50);
+                    // Mask off this bit so we don't try to include it in pollSockets() below
+                    testPortFlags &= ~(1U << i);
                 }
             }
         }
     }
 
+    // All tests share a single timeout, no matter how many ports respond before it
+    deadline = PltGetMillis() + TEST_PORT_TIMEOUT_SEC * 1000;
+
     // Continue to call pollSockets() until we have no more sockets to wait for,
     // or our pollSockets() call times out.
     while (testPortFlags != 0) {
         int nfds;
         struct pollfd pfds[PORT_FLAGS_MAX_COUNT];
+        uint64_t now = PltGetMillis();
 
         nfds = 0;
 
@@ -214,10 +227,8 @@ unsigned int LiTestClientConnectivity(const char* testServer, unsigned short ref
             }
         }
 
-        // Wait for the  to complete or the timeout to elapse.
-        // NB: The timeout resets each time we get a valid response on a port,
-        // but that's probably fine.
-        err = pollSockets(pfds, nfds, TEST_PORT_TIMEOUT_SEC * 1000);
+        // Wait for the tests to complete or the timeout to elapse
+        err = now < deadline ? pollSockets(pfds, nfds, (int)(deadline - now)) : 0;
         if (err < 0) {
             // pollSockets() failed
             err = LastSocketError();
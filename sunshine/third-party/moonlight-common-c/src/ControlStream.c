@@ -6,6 +6,9 @@
 #ifndef MIN
 #define MIN(x, y) ((x) < (y) ? (x) : (y))
 #endif
+#ifndef MAX
+#define MAX(x, y) ((x) > (y) ? (x) : (y))
+#endif
 
 // NV control stream packet header for TCP
 typedef struct _NVCTL_TCP_PACKET_HEADER {
@@ -23,6 +26,10 @@ typedef struct _NVCTL_ENET_PACKET_HEADER_V2 {
 } NVCTL_ENET_PACKET_HEADER_V2, *PNVCTL_ENET_PACKET_HEADER_V2;
 
 #define AES_GCM_TAG_LENGTH 16
+
+// Shortest sleep of the control receive thread when no reliable messages are in flight
+#define CONTROL_STREAM_MIN_IDLE_WAIT_MS 10
+
 typedef struct _NVCTL_ENCRYPTED_PACKET_HEADER {
     unsigned short encryptedHeaderType; // Always LE 0x0001
     unsigned short length; // sizeof(seq) + 16 byte tag + secondary header and data
@@ -88,11 +95,12 @@ typedef struct _QUEUED_ASYNC_CALLBACK {
 
 static SOCKET ctlSock = INVALID_SOCKET;
 static ENetHost* client;
+static ENetHost* preboundClient;
 static ENetPeer* peer;
 static PLT_MUTEX enetMutex;
 static bool usePeriodicPing;
 
-static PLT_THREAD lossStatsThread;
+static SCHEDULER_TASK lossStatsTask;
 static PLT_THREAD invalidateRefFramesThread;
 static PLT_THREAD requestIdrFrameThread;
 static PLT_THREAD controlReceiveThread;
@@ -113,6 +121,11 @@ static int lastConnectionStatusUpdate;
 static uint32_t currentEnetSequenceNumber;
 static uint64_t firstFrameTimeMs;
 
+// Adaptive FEC state (only used by the loss stats thread)
+static int requestedFecPercentage;
+static uint64_t adaptiveFecIntervalStartTimeMs;
+static RTP_VIDEO_STATS adaptiveFecIntervalStartStats;
+
 static LINKED_BLOCKING_QUEUE invalidReferenceFrameTuples;
 static LINKED_BLOCKING_QUEUE frameFecStatusQueue;
 static LINKED_BLOCKING_QUEUE asyncCallbackQueue;
@@ -126,6 +139,16 @@ static PPLT_CRYPTO_CONTEXT decryptionCtx;
 #define CONN_OKAY_LOSS_RATE 5
 #define CONN_STATUS_SAMPLE_PERIOD 3000
 
+// The FEC percentage is raised right away when a FEC block can't be recovered, to keep
+// twice the observed loss rate plus a margin, and lowered by a point per interval while
+// the loss stays low.
+#define ADAPTIVE_FEC_INTERVAL_MS 1000
+#define ADAPTIVE_FEC_MIN_PACKETS 100
+#define ADAPTIVE_FEC_MIN_PERCENTAGE 5
+#define ADAPTIVE_FEC_MAX_PERCENTAGE 50
+#define ADAPTIVE_FEC_MARGIN_PERCENTAGE 5
+#define ADAPTIVE_FEC_FAILURE_STEP 10
+
 #define IDX_START_A 0
 #define IDX_REQUEST_IDR_FRAME 0
 #define IDX_START_B 1
@@ -351,6 +374,11 @@ int initializeControlStream(void) {
     firstFrameTimeMs = 0;
     currentEnetSequenceNumber = 0;
     usePeriodicPing = APP_VERSION_AT_LEAST(7, 1, 415);
+
+    // This matches the fec.repairPercent value that we send in the SDP
+    requestedFecPercentage = (StreamConfig.width >= 3840 && StreamConfig.height >= 2160) ? 5 : 20;
+    adaptiveFecIntervalStartTimeMs = 0;
+    memset(&adaptiveFecIntervalStartStats, 0, sizeof(adaptiveFecIntervalStartStats));
     encryptionCtx = PltCreateCryptoContext();
     decryptionCtx = PltCreateCryptoContext();
     hdrEnabled = false;
@@ -1019,34 +1047,52 @@ static void queueAsyncCallback(PNVCTL_ENET_PACKET_HEADER_V1 ctlHdr, int packetLe
 
     BbInitializeWrappedBuffer(&bb, (char*)ctlHdr, sizeof(*ctlHdr), packetLength - sizeof(*ctlHdr), BYTE_ORDER_LITTLE);
 
+    // Each of these messages has a fixed layout, so the length is validated once
+    // up front and the fields are read without further bounds checks.
     if (ctlHdr->type == packetTypes[IDX_RUMBLE_DATA]) {
+        if (!BbHasRemaining(&bb, 4 + 3 * sizeof(uint16_t))) {
+            goto ShortPacket;
+        }
+
         BbAdvanceBuffer(&bb, 4);
 
-        BbGet16(&bb, &queuedCb->data.rumble.controllerNumber);
-        BbGet16(&bb, &queuedCb->data.rumble.lowFreqRumble);
-        BbGet16(&bb, &queuedCb->data.rumble.highFreqRumble);
+        queuedCb->data.rumble.controllerNumber = BbGetLE16Unchecked(&bb);
+        queuedCb->data.rumble.lowFreqRumble = BbGetLE16Unchecked(&bb);
+        queuedCb->data.rumble.highFreqRumble = BbGetLE16Unchecked(&bb);
 
         queuedCb->typeIndex = IDX_RUMBLE_DATA;
     }
     else if (ctlHdr->type == packetTypes[IDX_RUMBLE_TRIGGER_DATA]) {
-        BbGet16(&bb, &queuedCb->data.rumbleTriggers.controllerNumber);
-        BbGet16(&bb, &queuedCb->data.rumbleTriggers.leftTriggerMotor);
-        BbGet16(&bb, &queuedCb->data.rumbleTriggers.rightTriggerMotor);
+        if (!BbHasRemaining(&bb, 3 * sizeof(uint16_t))) {
+            goto ShortPacket;
+        }
+
+        queuedCb->data.rumbleTriggers.controllerNumber = BbGetLE16Unchecked(&bb);
+        queuedCb->data.rumbleTriggers.leftTriggerMotor = BbGetLE16Unchecked(&bb);
+        queuedCb->data.rumbleTriggers.rightTriggerMotor = BbGetLE16Unchecked(&bb);
 
         queuedCb->typeIndex = IDX_RUMBLE_TRIGGER_DATA;
     }
     else if (ctlHdr->type == packetTypes[IDX_SET_MOTION_EVENT]) {
-        BbGet16(&bb, &queuedCb->data.setMotionEventState.controllerNumber);
-        BbGet16(&bb, &queuedCb->data.setMotionEventState.reportRateHz);
-        BbGet8(&bb, &queuedCb->data.setMotionEventState.motionType);
+        if (!BbHasRemaining(&bb, 2 * sizeof(uint16_t) + sizeof(uint8_t))) {
+            goto ShortPacket;
+        }
+
+        queuedCb->data.setMotionEventState.controllerNumber = BbGetLE16Unchecked(&bb);
+        queuedCb->data.setMotionEventState.reportRateHz = BbGetLE16Unchecked(&bb);
+        queuedCb->data.setMotionEventState.motionType = BbGet8Unchecked(&bb);
 
         queuedCb->typeIndex = IDX_SET_MOTION_EVENT;
     }
     else if (ctlHdr->type == packetTypes[IDX_SET_RGB_LED]) {
-        BbGet16(&bb, &queuedCb->data.setControllerLed.controllerNumber);
-        BbGet8(&bb, &queuedCb->data.setControllerLed.r);
-        BbGet8(&bb, &queuedCb->data.setControllerLed.g);
-        BbGet8(&bb, &queuedCb->data.setControllerLed.b);
+        if (!BbHasRemaining(&bb, sizeof(uint16_t) + 3 * sizeof(uint8_t))) {
+            goto ShortPacket;
+        }
+
+        queuedCb->data.setControllerLed.controllerNumber = BbGetLE16Unchecked(&bb);
+        queuedCb->data.setControllerLed.r = BbGet8Unchecked(&bb);
+        queuedCb->data.setControllerLed.g = BbGet8Unchecked(&bb);
+        queuedCb->data.setControllerLed.b = BbGet8Unchecked(&bb);
 
         queuedCb->typeIndex = IDX_SET_RGB_LED;
     }
@@ -1054,13 +1100,17 @@ static void queueAsyncCallback(PNVCTL_ENET_PACKET_HEADER_V1 ctlHdr, int packetLe
         queuedCb->typeIndex = IDX_HDR_INFO;
     }
     else if (ctlHdr->type == packetTypes[IDX_DS_ADAPTIVE_TRIGGERS]){
-        BbGet16(&bb, &queuedCb->data.dsAdaptiveTrigger.controllerNumber);
-        BbGet8(&bb, &queuedCb->data.dsAdaptiveTrigger.eventFlags);
-        BbGet8(&bb, &queuedCb->data.dsAdaptiveTrigger.typeLeft);
-        BbGet8(&bb, &queuedCb->data.dsAdaptiveTrigger.typeRight);
+        if (!BbHasRemaining(&bb, sizeof(uint16_t) + 3 * sizeof(uint8_t) + 2 * DS_EFFECT_PAYLOAD_SIZE)) {
+            goto ShortPacket;
+        }
 
-        BbGetBytes(&bb, queuedCb->data.dsAdaptiveTrigger.left, DS_EFFECT_PAYLOAD_SIZE);
-        BbGetBytes(&bb, queuedCb->data.dsAdaptiveTrigger.right, DS_EFFECT_PAYLOAD_SIZE);
+        queuedCb->data.dsAdaptiveTrigger.controllerNumber = BbGetLE16Unchecked(&bb);
+        queuedCb->data.dsAdaptiveTrigger.eventFlags = BbGet8Unchecked(&bb);
+        queuedCb->data.dsAdaptiveTrigger.typeLeft = BbGet8Unchecked(&bb);
+        queuedCb->data.dsAdaptiveTrigger.typeRight = BbGet8Unchecked(&bb);
+
+        BbGetBytesUnchecked(&bb, queuedCb->data.dsAdaptiveTrigger.left, DS_EFFECT_PAYLOAD_SIZE);
+        BbGetBytesUnchecked(&bb, queuedCb->data.dsAdaptiveTrigger.right, DS_EFFECT_PAYLOAD_SIZE);
         queuedCb->typeIndex = IDX_DS_ADAPTIVE_TRIGGERS;
     }
     else {
@@ -1075,6 +1125,11 @@ static void queueAsyncCallback(PNVCTL_ENET_PACKET_HEADER_V1 ctlHdr, int packetLe
         Limelog("Failed to queue async callback: %d\n", err);
         free(queuedCb);
     }
+    return;
+
+ShortPacket:
+    Limelog("Dropping truncated control message: type 0x%04x, length %d\n", ctlHdr->type, packetLength);
+    free(queuedCb);
 }
 
 static void controlReceiveThreadFunc(void* context) {
@@ -1098,8 +1153,11 @@ static void controlReceiveThreadFunc(void* context) {
         // the RTO timer or a ping.
         if (err == 0) {
             if (ENET_TIME_LESS(peer->nextTimeout, client->serviceTime)) {
-                // This can happen when we have no unacked reliable messages
-                waitTimeMs = 10;
+                // This can happen when we have no unacked reliable messages. Another thread
+                // may send one while we sleep, but ENet won't retransmit it for at least one
+                // RTT, so sleeping that long delays a retransmission by at most one more RTO
+                // instead of waking up every few milliseconds on high latency links.
+                waitTimeMs = MAX(peer->roundTripTime, CONTROL_STREAM_MIN_IDLE_WAIT_MS);
             }
             else {
                 // We add 1 ms just to ensure we're unlikely to undershoot the sleep() and have to
@@ -1361,106 +1419,191 @@ static void controlReceiveThreadFunc(void* context) {
     }
 }
 
-static void lossStatsThreadFunc(void* context) {
-    BYTE_BUFFER byteBuffer;
+// Computes the FEC percentage to request based on the loss seen during the last interval.
+// Returns the current percentage if no change should be requested.
+static int computeAdaptiveFecPercentage(void) {
+    const RTP_VIDEO_STATS* stats = LiGetRTPVideoStats();
+    uint32_t dataPackets, recoveredPackets, failedBlocks;
+    int lossPercentage, targetPercentage;
+    uint64_t now = PltGetMillis();
 
-    if (usePeriodicPing) {
-        char periodicPingPayload[8];
+    if (adaptiveFecIntervalStartTimeMs == 0) {
+        adaptiveFecIntervalStartTimeMs = now;
+        adaptiveFecIntervalStartStats = *stats;
+        return requestedFecPercentage;
+    }
 
-        BbInitializeWrappedBuffer(&byteBuffer, periodicPingPayload, 0, sizeof(periodicPingPayload), BYTE_ORDER_LITTLE);
-        BbPut16(&byteBuffer, 4); // Length of payload
-        BbPut32(&byteBuffer, 0); // Timestamp?
-
-        while (!PltIsThreadInterrupted(&lossStatsThread)) {
-            // For Sunshine servers, send the more detailed per-frame FEC messages
-            if (IS_SUNSHINE()) {
-                PQUEUED_FRAME_FEC_STATUS queuedFrameStatus;
-
-                // Sunshine should always use ENet for control messages
-                LC_ASSERT(peer != NULL);
-
-                while (LbqPollQueueElement(&frameFecStatusQueue, (void**)&queuedFrameStatus) == LBQ_SUCCESS) {
-                    // Send as an unreliable packet, since it's not a critical message
-                    if (!sendMessageEnet(SS_FRAME_FEC_PTYPE,
-                                         sizeof(queuedFrameStatus->fecStatus),
-                                         &queuedFrameStatus->fecStatus,
-                                         CTRL_CHANNEL_GENERIC,
-                                         ENET_PACKET_FLAG_UNSEQUENCED,
-                                         LbqGetItemCount(&frameFecStatusQueue) > 0)) {
-                        Limelog("Loss Stats: Sending frame FEC status message failed: %d\n", (int)LastSocketError());
-                        ListenerCallbacks.connectionTerminated(LastSocketFail());
-                        free(queuedFrameStatus);
-                        return;
-                    }
+    dataPackets = stats->packetCountVideo - adaptiveFecIntervalStartStats.packetCountVideo;
+    recoveredPackets = stats->packetCountFecRecovered - adaptiveFecIntervalStartStats.packetCountFecRecovered;
+    failedBlocks = stats->packetCountFecFailed - adaptiveFecIntervalStartStats.packetCountFecFailed;
 
-                    free(queuedFrameStatus);
-                }
-            }
+    // React to unrecoverable blocks right away, but wait for a full interval
+    // with enough packets before deciding anything else.
+    if (failedBlocks == 0 && (now - adaptiveFecIntervalStartTimeMs < ADAPTIVE_FEC_INTERVAL_MS || dataPackets < ADAPTIVE_FEC_MIN_PACKETS)) {
+        return requestedFecPercentage;
+    }
+
+    adaptiveFecIntervalStartTimeMs = now;
+    adaptiveFecIntervalStartStats = *stats;
+
+    lossPercentage = dataPackets != 0 ? (int)((recoveredPackets * 100 + dataPackets - 1) / dataPackets) : 0;
+    targetPercentage = lossPercentage * 2 + ADAPTIVE_FEC_MARGIN_PERCENTAGE;
+
+    if (failedBlocks != 0) {
+        if (targetPercentage < requestedFecPercentage + ADAPTIVE_FEC_FAILURE_STEP) {
+            targetPercentage = requestedFecPercentage + ADAPTIVE_FEC_FAILURE_STEP;
+        }
+    }
+    else if (targetPercentage < requestedFecPercentage) {
+        // Back off slowly, since loss tends to come in bursts
+        targetPercentage = requestedFecPercentage - 1;
+    }
 
-            // Send the message (and don't expect a response)
-            //
-            // NB: We send this periodic message as reliable to ensure the RTT is recomputed
-            // regularly. This only happens when an ACK is received to a reliable packet.
-            // Since the other traffic on this channel is unsequenced, it doesn't really
-            // cause any negative HOL blocking side-effects.
-            if (!sendMessageAndForget(0x0200,
-                                      sizeof(periodicPingPayload),
-                                      periodicPingPayload,
-                                      CTRL_CHANNEL_GENERIC,
-                                      ENET_PACKET_FLAG_RELIABLE,
-                                      false)) {
-                Limelog("Loss Stats: Transaction failed: %d\n", (int)LastSocketError());
+    if (targetPercentage < ADAPTIVE_FEC_MIN_PERCENTAGE) {
+        targetPercentage = ADAPTIVE_FEC_MIN_PERCENTAGE;
+    }
+    else if (targetPercentage > ADAPTIVE_FEC_MAX_PERCENTAGE) {
+        targetPercentage = ADAPTIVE_FEC_MAX_PERCENTAGE;
+    }
+
+    return targetPercentage;
+}
+
+static char periodicPingPayload[8];
+static char* lossStatsPayload;
+
+// Periodic ping task, run by the scheduler thread every PERIODIC_PING_INTERVAL_MS
+static bool sendPeriodicPing(void* context) {
+    // For Sunshine servers, send the more detailed per-frame FEC messages
+    if (IS_SUNSHINE()) {
+        PQUEUED_FRAME_FEC_STATUS queuedFrameStatus;
+
+        // Sunshine should always use ENet for control messages
+        LC_ASSERT(peer != NULL);
+
+        while (LbqPollQueueElement(&frameFecStatusQueue, (void**)&queuedFrameStatus) == LBQ_SUCCESS) {
+            // Send as an unreliable packet, since it's not a critical message
+            if (!sendMessageEnet(SS_FRAME_FEC_PTYPE,
+                                 sizeof(queuedFrameStatus->fecStatus),
+                                 &queuedFrameStatus->fecStatus,
+                                 CTRL_CHANNEL_GENERIC,
+                                 ENET_PACKET_FLAG_UNSEQUENCED,
+                                 LbqGetItemCount(&frameFecStatusQueue) > 0)) {
+                Limelog("Loss Stats: Sending frame FEC status message failed: %d\n", (int)LastSocketError());
                 ListenerCallbacks.connectionTerminated(LastSocketFail());
-                return;
+                free(queuedFrameStatus);
+                return false;
             }
 
-            // Wait a bit
-            PltSleepMsInterruptible(&lossStatsThread, PERIODIC_PING_INTERVAL_MS);
+            free(queuedFrameStatus);
+        }
+
+        // Ask for more or less FEC if the host lets us
+        if (SunshineFeatureFlags & LI_FF_ADAPTIVE_FEC) {
+            int fecPercentage = computeAdaptiveFecPercentage();
+
+            if (fecPercentage != requestedFecPercentage) {
+                SS_FEC_REQUEST fecRequest;
+
+                fecRequest.fecPercentage = (uint8_t)fecPercentage;
+                if (!sendMessageEnet(SS_FEC_REQUEST_PTYPE,
+                                     sizeof(fecRequest),
+                                     &fecRequest,
+                                     CTRL_CHANNEL_GENERIC,
+                                     ENET_PACKET_FLAG_RELIABLE,
+                                     false)) {
+                    Limelog("Loss Stats: Sending FEC request message failed: %d\n", (int)LastSocketError());
+                    ListenerCallbacks.connectionTerminated(LastSocketFail());
+                    return false;
+                }
+
+                Limelog("Requesting %d%% video FEC (was %d%%)\n", fecPercentage, requestedFecPercentage);
+                requestedFecPercentage = fecPercentage;
+            }
         }
     }
-    else {
-        char* lossStatsPayload;
 
-        // Sunshine should use the newer codepath above
-        LC_ASSERT(!IS_SUNSHINE());
+    // Send the message (and don't expect a response)
+    //
+    // NB: We send this periodic message as reliable to ensure the RTT is recomputed
+    // regularly. This only happens when an ACK is received to a reliable packet.
+    // Since the other traffic on this channel is unsequenced, it doesn't really
+    // cause any negative HOL blocking side-effects.
+    if (!sendMessageAndForget(0x0200,
+                              sizeof(periodicPingPayload),
+                              periodicPingPayload,
+                              CTRL_CHANNEL_GENERIC,
+                              ENET_PACKET_FLAG_RELIABLE,
+                              false)) {
+        Limelog("Loss Stats: Transaction failed: %d\n", (int)LastSocketError());
+        ListenerCallbacks.connectionTerminated(LastSocketFail());
+        return false;
+    }
+
+    return true;
+}
+
+// Loss stats task, run by the scheduler thread every LOSS_REPORT_INTERVAL_MS
+static bool sendLossStats(void* context) {
+    BYTE_BUFFER byteBuffer;
+
+    // Sunshine should use the periodic ping instead
+    LC_ASSERT(!IS_SUNSHINE());
+
+    // Construct the payload
+    BbInitializeWrappedBuffer(&byteBuffer, lossStatsPayload, 0, payloadLengths[IDX_LOSS_STATS], BYTE_ORDER_LITTLE);
+    BbPut32(&byteBuffer, 0);
+    BbPut32(&byteBuffer, LOSS_REPORT_INTERVAL_MS);
+    BbPut32(&byteBuffer, 1000);
+    BbPut64(&byteBuffer, lastGoodFrame);
+    BbPut32(&byteBuffer, 0);
+    BbPut32(&byteBuffer, 0);
+    BbPut32(&byteBuffer, 0x14);
+
+    // Send the message (and don't expect a response)
+    if (!sendMessageAndForget(packetTypes[IDX_LOSS_STATS],
+                              payloadLengths[IDX_LOSS_STATS],
+                              lossStatsPayload,
+                              CTRL_CHANNEL_GENERIC,
+                              0,
+                              false)) {
+        Limelog("Loss Stats: Transaction failed: %d\n", (int)LastSocketError());
+        ListenerCallbacks.connectionTerminated(LastSocketFail());
+        return false;
+    }
+
+    return true;
+}
+
+static int startLossStatsTask(void) {
+    if (usePeriodicPing) {
+        BYTE_BUFFER byteBuffer;
+
+        BbInitializeWrappedBuffer(&byteBuffer, periodicPingPayload, 0, sizeof(periodicPingPayload), BYTE_ORDER_LITTLE);
+        BbPutLE16Unchecked(&byteBuffer, 4); // Length of payload
+        BbPutLE32Unchecked(&byteBuffer, 0); // Timestamp?
 
+        SchedInitializeTask(&lossStatsTask, sendPeriodicPing, NULL, PERIODIC_PING_INTERVAL_MS);
+    }
+    else {
         lossStatsPayload = malloc(payloadLengths[IDX_LOSS_STATS]);
         if (lossStatsPayload == NULL) {
             Limelog("Loss Stats: malloc() failed\n");
-            ListenerCallbacks.connectionTerminated(-1);
-            return;
+            return -1;
         }
 
-        while (!PltIsThreadInterrupted(&lossStatsThread)) {
-            // Construct the payload
-            BbInitializeWrappedBuffer(&byteBuffer, lossStatsPayload, 0, payloadLengths[IDX_LOSS_STATS], BYTE_ORDER_LITTLE);
-            BbPut32(&byteBuffer, 0);
-            BbPut32(&byteBuffer, LOSS_REPORT_INTERVAL_MS);
-            BbPut32(&byteBuffer, 1000);
-            BbPut64(&byteBuffer, lastGoodFrame);
-            BbPut32(&byteBuffer, 0);
-            BbPut32(&byteBuffer, 0);
-            BbPut32(&byteBuffer, 0x14);
-
-            // Send the message (and don't expect a response)
-            if (!sendMessageAndForget(packetTypes[IDX_LOSS_STATS],
-                                      payloadLengths[IDX_LOSS_STATS],
-                                      lossStatsPayload,
-                                      CTRL_CHANNEL_GENERIC,
-                                      0,
-                                      false)) {
-                free(lossStatsPayload);
-                Limelog("Loss Stats: Transaction failed: %d\n", (int)LastSocketError());
-                ListenerCallbacks.connectionTerminated(LastSocketFail());
-                return;
-            }
+        SchedInitializeTask(&lossStatsTask, sendLossStats, NULL, LOSS_REPORT_INTERVAL_MS);
+    }
 
-            // Wait a bit
-            PltSleepMsInterruptible(&lossStatsThread, LOSS_REPORT_INTERVAL_MS);
-        }
+    SchedAddTask(&lossStatsTask, 0);
+    return 0;
+}
 
-        free(lossStatsPayload);
-    }
+static void stopLossStatsTask(void) {
+    SchedRemoveTask(&lossStatsTask);
+
+    free(lossStatsPayload);
+    lossStatsPayload = NULL;
 }
 
 static void requestIdrFrame(void) {
@@ -1597,12 +1740,11 @@ int stopControlStream(void) {
         shutdownTcpSocket(ctlSock);
     }
 
-    PltInterruptThread(&lossStatsThread);
+    stopLossStatsTask();
     PltInterruptThread(&requestIdrFrameThread);
     PltInterruptThread(&controlReceiveThread);
     PltInterruptThread(&asyncCallbackThread);
 
-    PltJoinThread(&lossStatsThread);
     PltJoinThread(&requestIdrFrameThread);
     PltJoinThread(&controlReceiveThread);
     PltJoinThread(&asyncCallbackThread);
@@ -1689,31 +1831,63 @@ bool LiGetEstimatedRttInfo(uint32_t* estimatedRtt, uint32_t* estimatedRttVarianc
     return ret;
 }
 
+static ENetHost* createControlHost(void) {
+    ENetAddress localAddress;
+
+    enet_address_set_address(&localAddress, (struct sockaddr *)&LocalAddr, AddrLen);
+#ifdef __3DS__
+    // binding to wildcard port is broken on the 3DS, so we need to define a port manually
+    enet_address_set_port(&localAddress, htons(n3ds_udp_port++));
+#else
+    enet_address_set_port(&localAddress, 0); // Wildcard port
+#endif
+
+    return enet_host_create(RemoteAddr.ss_family,
+                            LocalAddr.ss_family != 0 ? &localAddress : NULL,
+                            1, CTRL_CHANNEL_COUNT, 0, 0);
+}
+
+// Create the ENet host ahead of the connection for LiPreconnect(). The peer
+// can't be connected yet since the control port comes from the RTSP handshake.
+int prebindControlStream(void) {
+    LC_ASSERT(preboundClient == NULL);
+
+    preboundClient = createControlHost();
+    if (preboundClient == NULL) {
+        return -1;
+    }
+
+    return 0;
+}
+
+void releasePreboundControlStream(void) {
+    if (preboundClient != NULL) {
+        enet_host_destroy(preboundClient);
+        preboundClient = NULL;
+    }
+}
+
 // Starts the control stream
 int startControlStream(void) {
     int err;
 
     if (AppVersionQuad[0] >= 5) {
-        ENetAddress remoteAddress, localAddress;
+        ENetAddress remoteAddress;
         ENetEvent event;
 
         LC_ASSERT(ControlPortNumber != 0);
 
-        enet_address_set_address(&localAddress, (struct sockaddr *)&LocalAddr, AddrLen);
-#ifdef __3DS__
-        // binding to wildcard port is broken on the 3DS, so we need to define a port manually
-        enet_address_set_port(&localAddress, htons(n3ds_udp_port++));
-#else
-        enet_address_set_port(&localAddress, 0); // Wildcard port
-#endif
-
         enet_address_set_address(&remoteAddress, (struct sockaddr *)&RemoteAddr, AddrLen);
         enet_address_set_port(&remoteAddress, ControlPortNumber);
 
-        // Create a client
-        client = enet_host_create(RemoteAddr.ss_family,
-                                  LocalAddr.ss_family != 0 ? &localAddress : NULL,
-                                  1, CTRL_CHANNEL_COUNT, 0, 0);
+        // Create a client, or adopt the one created by LiPreconnect()
+        if (preboundClient != NULL) {
+            client = preboundClient;
+            preboundClient = NULL;
+        }
+        else {
+            client = createControlHost();
+        }
         if (client == NULL) {
             stopping = true;
             return -1;
@@ -1793,7 +1967,7 @@ int startControlStream(void) {
         enableNoDelay(ctlSock);
     }
 
-    err = PltCreateThread("ControlRecv", controlReceiveThreadFunc, NULL, &controlReceiveThread);
+    err = PltCreateThread("ControlRecv", PLT_THREAD_ROLE_CONTROL, controlReceiveThreadFunc, NULL, &controlReceiveThread);
     if (err != 0) {
         stopping = true;
         if (ctlSock != INVALID_SOCKET) {
@@ -1877,7 +2051,7 @@ int startControlStream(void) {
         return err;
     }
 
-    err = PltCreateThread("LossStats", lossStatsThreadFunc, NULL, &lossStatsThread);
+    err = startLossStatsTask();
     if (err != 0) {
         stopping = true;
 
@@ -1904,7 +2078,7 @@ int startControlStream(void) {
         return err;
     }
 
-    err = PltCreateThread("ReqIdrFrame", requestIdrFrameFunc, NULL, &requestIdrFrameThread);
+    err = PltCreateThread("ReqIdrFrame", PLT_THREAD_ROLE_CONTROL, requestIdrFrameFunc, NULL, &requestIdrFrameThread);
     if (err != 0) {
         stopping = true;
 
@@ -1915,8 +2089,7 @@ int startControlStream(void) {
             ConnectionInterrupted = true;
         }
 
-        PltInterruptThread(&lossStatsThread);
-        PltJoinThread(&lossStatsThread);
+        stopLossStatsTask();
 
         PltInterruptThread(&controlReceiveThread);
         PltJoinThread(&controlReceiveThread);
@@ -1935,7 +2108,7 @@ int startControlStream(void) {
         return err;
     }
 
-    err = PltCreateThread("CtrlAsyncCb", asyncCallbackThreadFunc, NULL, &asyncCallbackThread);
+    err = PltCreateThread("CtrlAsyncCb", PLT_THREAD_ROLE_DEFAULT, asyncCallbackThreadFunc, NULL, &asyncCallbackThread);
     if (err != 0) {
         stopping = true;
         PltSetEvent(&idrFrameRequiredEvent);
@@ -1947,8 +2120,7 @@ int startControlStream(void) {
             ConnectionInterrupted = true;
         }
 
-        PltInterruptThread(&lossStatsThread);
-        PltJoinThread(&lossStatsThread);
+        stopLossStatsTask();
 
         PltInterruptThread(&controlReceiveThread);
         PltJoinThread(&controlReceiveThread);
@@ -1972,7 +2144,7 @@ int startControlStream(void) {
 
     // Only create the reference frame invalidation thread if RFI is enabled
     if (isReferenceFrameInvalidationEnabled()) {
-        err = PltCreateThread("InvRefFrames", invalidateRefFramesFunc, NULL, &invalidateRefFramesThread);
+        err = PltCreateThread("InvRefFrames", PLT_THREAD_ROLE_CONTROL, invalidateRefFramesFunc, NULL, &invalidateRefFramesThread);
         if (err != 0) {
             stopping = true;
             PltSetEvent(&idrFrameRequiredEvent);
@@ -1985,8 +2157,7 @@ int startControlStream(void) {
                 ConnectionInterrupted = true;
             }
 
-            PltInterruptThread(&lossStatsThread);
-            PltJoinThread(&lossStatsThread);
+            stopLossStatsTask();
 
             PltInterruptThread(&controlReceiveThread);
             PltJoinThread(&controlReceiveThread);
@@ -0,0 +1,241 @@
+#include "Limelight-internal.h"
+
+#define DP_SLOT_EMPTY 0
+#define DP_SLOT_PENDING 1
+#define DP_SLOT_DECRYPTED 2
+#define DP_SLOT_FAILED 3
+
+static int positionDiff(int a, int b) {
+    return (int)((unsigned int)a - (unsigned int)b);
+}
+
+// Wakes a thread that is (or is about to be) waiting on the condition variable
+static void wakeWaiter(PDECRYPT_POOL pool, PLT_COND* cond) {
+    // Taking the mutex ensures the waiter is either already blocked on the
+    // condition variable or will see our update before it blocks
+    PltLockMutex(&pool->mutex);
+    PltUnlockMutex(&pool->mutex);
+    PltSignalConditionVariable(cond);
+}
+
+// Claims the next submitted packet for decryption. Returns false on shutdown.
+static bool claimPacket(PDECRYPT_POOL pool, int* position) {
+    int decryptPosition = PltAtomicLoad(&pool->decryptPosition);
+
+    for (;;) {
+        if (PltAtomicLoad(&pool->shutdown)) {
+            return false;
+        }
+
+        if (decryptPosition != PltAtomicLoad(&pool->submitPosition)) {
+            if (PltAtomicCompareExchange(&pool->decryptPosition, &decryptPosition, (int)((unsigned int)decryptPosition + 1))) {
+                *position = decryptPosition;
+
+                // Hand the rest of the batch to another worker
+                if (positionDiff(PltAtomicLoad(&pool->submitPosition), decryptPosition) > 1) {
+                    PltSignalConditionVariable(&pool->workerCond);
+                }
+                return true;
+            }
+
+            // Another worker claimed it and decryptPosition was reloaded
+            continue;
+        }
+
+        PltLockMutex(&pool->mutex);
+        while (!PltAtomicLoad(&pool->shutdown) &&
+               (decryptPosition = PltAtomicLoad(&pool->decryptPosition)) == PltAtomicLoad(&pool->submitPosition)) {
+            PltWaitForConditionVariable(&pool->workerCond, &pool->mutex);
+        }
+        PltUnlockMutex(&pool->mutex);
+    }
+}
+
+static void DecryptWorkerThreadProc(void* context) {
+    PDECRYPT_POOL_WORKER worker = (PDECRYPT_POOL_WORKER)context;
+    PDECRYPT_POOL pool = worker->pool;
+    int position;
+
+    while (claimPacket(pool, &position)) {
+        PDECRYPT_POOL_SLOT slot = &pool->slots[position & pool->slotMask];
+        PENC_VIDEO_HEADER encHeader = (PENC_VIDEO_HEADER)slot->packet;
+        int plaintextLength;
+
+        LC_ASSERT(PltAtomicLoad(&slot->state) == DP_SLOT_PENDING);
+
+        if (PltDecryptMessage(worker->cryptoContext, ALGORITHM_AES_GCM, 0,
+                              pool->key, pool->keyLength,
+                              encHeader->iv, sizeof(encHeader->iv),
+                              encHeader->tag, sizeof(encHeader->tag),
+                              ((unsigned char*)(encHeader + 1)), slot->length - sizeof(ENC_VIDEO_HEADER), // The ciphertext is after the header
+                              (unsigned char*)(encHeader + 1), &plaintextLength)) {
+            slot->length = plaintextLength;
+            PltAtomicStore(&slot->state, DP_SLOT_DECRYPTED);
+        }
+        else {
+            PltAtomicStore(&slot->state, DP_SLOT_FAILED);
+        }
+
+        // Only the oldest packet can unblock the consumer
+        if (position == PltAtomicLoad(&pool->completePosition)) {
+            wakeWaiter(pool, &pool->consumerCond);
+        }
+    }
+}
+
+int DpInitializePool(PDECRYPT_POOL pool, int workerCount, int slotCount, unsigned char* key, int keyLength) {
+    int ringSize;
+    int err;
+    int i;
+
+    LC_ASSERT(workerCount > 0 && workerCount <= DP_MAX_WORKERS);
+
+    memset(pool, 0, sizeof(*pool));
+
+    ringSize = 2;
+    while (ringSize < slotCount) {
+        ringSize *= 2;
+    }
+
+    pool->slots = (PDECRYPT_POOL_SLOT)calloc(ringSize, sizeof(*pool->slots));
+    if (pool->slots == NULL) {
+        return -1;
+    }
+
+    pool->slotMask = ringSize - 1;
+    pool->key = key;
+    pool->keyLength = keyLength;
+
+    err = PltCreateMutex(&pool->mutex);
+    if (err != 0) {
+        free(pool->slots);
+        return err;
+    }
+
+    PltCreateConditionVariable(&pool->workerCond, &pool->mutex);
+    PltCreateConditionVariable(&pool->consumerCond, &pool->mutex);
+
+    for (i = 0; i < workerCount; i++) {
+        PDECRYPT_POOL_WORKER worker = &pool->workers[i];
+
+        worker->pool = pool;
+        worker->cryptoContext = PltCreateCryptoContext();
+        if (worker->cryptoContext == NULL) {
+            err = -1;
+            break;
+        }
+
+        err = PltCreateThread("VideoDecrypt", PLT_THREAD_ROLE_VIDEO, DecryptWorkerThreadProc, worker, &worker->thread);
+        if (err != 0) {
+            PltDestroyCryptoContext(worker->cryptoContext);
+            break;
+        }
+
+        pool->workerCount++;
+    }
+
+    if (err != 0) {
+        DpSignalShutdown(pool);
+        DpDestroyPool(pool, NULL);
+        return err;
+    }
+
+    return 0;
+}
+
+bool DpSubmitPacket(PDECRYPT_POOL pool, char* packet, int length, uint64_t receiveTimeUs) {
+    int position = PltAtomicLoad(&pool->submitPosition);
+    PDECRYPT_POOL_SLOT slot;
+
+    LC_ASSERT(length >= (int)sizeof(ENC_VIDEO_HEADER));
+
+    if (positionDiff(position, PltAtomicLoad(&pool->completePosition)) > pool->slotMask) {
+        // The consumer is too far behind
+        return false;
+    }
+
+    slot = &pool->slots[position & pool->slotMask];
+    LC_ASSERT(PltAtomicLoad(&slot->state) == DP_SLOT_EMPTY);
+
+    slot->packet = packet;
+    slot->length = length;
+    slot->receiveTimeUs = receiveTimeUs;
+    PltAtomicStore(&slot->state, DP_SLOT_PENDING);
+
+    PltAtomicStore(&pool->submitPosition, (int)((unsigned int)position + 1));
+    return true;
+}
+
+void DpWakeWorkers(PDECRYPT_POOL pool) {
+    // The first worker to claim a packet wakes the next one if more are left
+    wakeWaiter(pool, &pool->workerCond);
+}
+
+int DpWaitForPacket(PDECRYPT_POOL pool, char** packet, int* length, uint64_t* receiveTimeUs) {
+    int position = PltAtomicLoad(&pool->completePosition);
+    PDECRYPT_POOL_SLOT slot = &pool->slots[position & pool->slotMask];
+    int state = PltAtomicLoad(&slot->state);
+
+    if (state == DP_SLOT_EMPTY || state == DP_SLOT_PENDING) {
+        PltLockMutex(&pool->mutex);
+        while (!PltAtomicLoad(&pool->shutdown) &&
+               ((state = PltAtomicLoad(&slot->state)) == DP_SLOT_EMPTY || state == DP_SLOT_PENDING)) {
+            PltWaitForConditionVariable(&pool->consumerCond, &pool->mutex);
+        }
+        PltUnlockMutex(&pool->mutex);
+
+        if (state == DP_SLOT_EMPTY || state == DP_SLOT_PENDING) {
+            return DP_INTERRUPTED;
+        }
+    }
+
+    *packet = slot->packet;
+    *length = slot->length;
+    *receiveTimeUs = slot->receiveTimeUs;
+
+    // Release the slot to the submitting thread
+    PltAtomicStore(&slot->state, DP_SLOT_EMPTY);
+    PltAtomicStore(&pool->completePosition, (int)((unsigned int)position + 1));
+
+    return state == DP_SLOT_DECRYPTED ? DP_SUCCESS : DP_DECRYPT_FAILED;
+}
+
+void DpSignalShutdown(PDECRYPT_POOL pool) {
+    int i;
+
+    PltAtomicStore(&pool->shutdown, true);
+
+    wakeWaiter(pool, &pool->consumerCond);
+    for (i = 0; i < pool->workerCount; i++) {
+        wakeWaiter(pool, &pool->workerCond);
+    }
+}
+
+void DpDestroyPool(PDECRYPT_POOL pool, DecryptPoolFreeFunc freeFunc) {
+    int submitPosition;
+    int position;
+    int i;
+
+    LC_ASSERT(PltAtomicLoad(&pool->shutdown));
+
+    for (i = 0; i < pool->workerCount; i++) {
+        PltJoinThread(&pool->workers[i].thread);
+        PltDestroyCryptoContext(pool->workers[i].cryptoContext);
+    }
+    pool->workerCount = 0;
+
+    // Whatever is left was never consumed, decrypted or not
+    submitPosition = PltAtomicLoad(&pool->submitPosition);
+    for (position = PltAtomicLoad(&pool->completePosition); position != submitPosition; position = (int)((unsigned int)position + 1)) {
+        if (freeFunc != NULL) {
+            freeFunc(pool->slots[position & pool->slotMask].packet);
+        }
+    }
+
+    PltDeleteConditionVariable(&pool->workerCond);
+    PltDeleteConditionVariable(&pool->consumerCond);
+    PltDeleteMutex(&pool->mutex);
+
+    free(pool->slots);
+    pool->slots = NULL;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Platform.h"
+#include "PlatformThreads.h"
+#include "PlatformCrypto.h"
+
+// Decrypts AES-GCM encrypted video packets on a pool of worker threads, while
+// handing them to the consumer in the order they were submitted. There must be
+// a single thread submitting packets and a single thread consuming them.
+//
+// Each packet starts with its ENC_VIDEO_HEADER and is decrypted in place, so
+// its plaintext ends up right after the header.
+
+#define DP_MAX_WORKERS 4
+
+#define DP_SUCCESS 0
+#define DP_DECRYPT_FAILED 1
+#define DP_INTERRUPTED 2
+
+typedef struct _DECRYPT_POOL_SLOT {
+    char* packet;
+    int length;
+    uint64_t receiveTimeUs;
+    PLT_ATOMIC_INT state;
+} DECRYPT_POOL_SLOT, *PDECRYPT_POOL_SLOT;
+
+typedef struct _DECRYPT_POOL_WORKER {
+    struct _DECRYPT_POOL* pool;
+    PLT_THREAD thread;
+    PPLT_CRYPTO_CONTEXT cryptoContext;
+} DECRYPT_POOL_WORKER, *PDECRYPT_POOL_WORKER;
+
+typedef struct _DECRYPT_POOL {
+    PDECRYPT_POOL_SLOT slots;
+    int slotMask;
+
+    unsigned char* key;
+    int keyLength;
+
+    // Free running positions in the slot ring, compared as differences so
+    // they can wrap around. Submitted packets are claimed by the workers at
+    // decryptPosition and returned to the consumer at completePosition.
+    PLT_ATOMIC_INT submitPosition;
+    PLT_ATOMIC_INT decryptPosition;
+    PLT_ATOMIC_INT completePosition;
+    PLT_ATOMIC_INT shutdown;
+
+    PLT_MUTEX mutex;
+    PLT_COND workerCond;
+    PLT_COND consumerCond;
+
+    DECRYPT_POOL_WORKER workers[DP_MAX_WORKERS];
+    int workerCount;
+} DECRYPT_POOL, *PDECRYPT_POOL;
+
+typedef void(*DecryptPoolFreeFunc)(char* packet);
+
+// The key must stay valid until the pool is destroyed
+int DpInitializePool(PDECRYPT_POOL pool, int workerCount, int slotCount, unsigned char* key, int keyLength);
+
+// Returns false if the pool is full, in which case the caller keeps the packet.
+// Submitted packets are only picked up by the workers after DpWakeWorkers().
+bool DpSubmitPacket(PDECRYPT_POOL pool, char* packet, int length, uint64_t receiveTimeUs);
+void DpWakeWorkers(PDECRYPT_POOL pool);
+
+// Returns the oldest submitted packet once it has been decrypted. The length is
+// that of the plaintext. The caller owns the packet, even if decryption failed.
+int DpWaitForPacket(PDECRYPT_POOL pool, char** packet, int* length, uint64_t* receiveTimeUs);
+
+void DpSignalShutdown(PDECRYPT_POOL pool);
+
+// Stops the workers and passes the packets that were never consumed to freeFunc
+void DpDestroyPool(PDECRYPT_POOL pool, DecryptPoolFreeFunc freeFunc);
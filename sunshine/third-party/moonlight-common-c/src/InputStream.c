@@ -30,6 +30,11 @@ static uint8_t currentPenButtonState;
 
 #define MAX_QUEUED_INPUT_PACKETS 150
 
+// Number of packet holders placed in the free list up front. This covers the
+// holders in flight for sustained high rate input (1 kHz mice and gamepads),
+// so steady state input never needs to allocate.
+#define PREALLOCATED_PACKET_HOLDERS 32
+
 #define PAYLOAD_SIZE(x) BE32((x)->packet.header.size)
 #define PACKET_SIZE(x) (PAYLOAD_SIZE(x) + sizeof(uint32_t))
 
@@ -42,6 +47,16 @@ static uint8_t currentPenButtonState;
 // effective input latency by avoiding packet queuing in ENet.
 #define MOUSE_BATCHING_INTERVAL_MS 1
 #define PEN_BATCHING_INTERVAL_MS 1
+#define MOTION_BATCHING_INTERVAL_MS 1
+
+// Maximum number of touch pointers with a pending batchable event
+#define MAX_BATCHED_TOUCH_POINTERS 10
+
+// State-like input (absolute mouse position and gamepad axes) is sent unreliable,
+// since each packet supersedes the previous one. Once the state stops changing for
+// this long, the last packet is sent again reliably in case it was lost.
+#define RELIABLE_REFRESH_DELAY_MS 50
+#define ABS_MOUSE_REFRESH_SLOT MAX_GAMEPADS
 
 // Don't batch up/down/cancel events
 #define TOUCH_EVENT_IS_BATCHABLE(x) ((x) == LI_TOUCH_EVENT_HOVER || (x) == LI_TOUCH_EVENT_MOVE)
@@ -78,9 +93,11 @@ typedef struct _PACKET_HOLDER {
 
 static PLT_MUTEX batchedInputMutex;
 static PPACKET_HOLDER currentQueuedControllerPacket[MAX_GAMEPADS];
+static PPACKET_HOLDER currentQueuedTouchPacket[MAX_BATCHED_TOUCH_POINTERS];
 static struct {
     float x, y, z;
     bool dirty; // Update ready to send (queued packet holder in packetQueue)
+    uint64_t lastSendTime;
 } currentGamepadSensorState[MAX_GAMEPADS][MAX_MOTION_EVENTS];
 static struct {
     int deltaX, deltaY;
@@ -91,6 +108,17 @@ static struct {
     int width, height;
     bool dirty; // Update ready to send (queued packet holder in packetQueue)
 } currentAbsoluteMouseState;
+static struct {
+    uint32_t buttonFlags;
+    bool valid;
+} lastQueuedControllerButtons[MAX_GAMEPADS];
+
+// Only accessed by the input send thread
+static struct {
+    PACKET_HOLDER holder; // Copy of the last unreliable packet
+    uint64_t sendTime;
+    bool pending;
+} reliableRefreshState[MAX_GAMEPADS + 1];
 
 // Initializes the input stream
 int initializeInputStream(void) {
@@ -100,6 +128,14 @@ int initializeInputStream(void) {
     // while the input send thread is blocked for short periods.
     LbqInitializeLinkedBlockingQueue(&packetQueue, MAX_QUEUED_INPUT_PACKETS);
     LbqInitializeLinkedBlockingQueue(&packetHolderFreeList, MAX_QUEUED_INPUT_PACKETS);
+    for (int i = 0; i < PREALLOCATED_PACKET_HOLDERS; i++) {
+        PPACKET_HOLDER holder = malloc(sizeof(*holder));
+        if (holder == NULL || LbqOfferQueueItem(&packetHolderFreeList, holder, &holder->entry) != LBQ_SUCCESS) {
+            // allocatePacketHolder() will allocate on demand instead
+            free(holder);
+            break;
+        }
+    }
 
     cryptoContext = PltCreateCryptoContext();
     encryptedControlStream = APP_VERSION_AT_LEAST(7, 1, 431);
@@ -119,6 +155,9 @@ int initializeInputStream(void) {
     absCurrentPosX = absCurrentPosY = 0.5f;
 
     memset(currentGamepadSensorState, 0, sizeof(currentGamepadSensorState));
+    memset(currentQueuedTouchPacket, 0, sizeof(currentQueuedTouchPacket));
+    memset(lastQueuedControllerButtons, 0, sizeof(lastQueuedControllerButtons));
+    memset(reliableRefreshState, 0, sizeof(reliableRefreshState));
     memset(&currentRelativeMouseState, 0, sizeof(currentRelativeMouseState));
     memset(&currentAbsoluteMouseState, 0, sizeof(currentAbsoluteMouseState));
     PltCreateMutex(&batchedInputMutex);
@@ -143,6 +182,9 @@ void destroyInputStream(void) {
         entry = nextEntry;
     }
 
+    // The free list is populated at initialization, so it may hold entries even
+    // if the input stream was never started and stopped.
+    LbqSignalQueueShutdown(&packetHolderFreeList);
     entry = LbqDestroyLinkedBlockingQueue(&packetHolderFreeList);
 
     while (entry != NULL) {
@@ -319,6 +361,54 @@ static void floatToNetfloat(float in, netfloat out) {
     }
 }
 
+// Returns the reliable refresh slot for state-like packets or -1 for other packets
+static int getReliableRefreshSlot(PPACKET_HOLDER holder, uint32_t multiControllerMagicLE) {
+    if (holder->packet.header.magic == multiControllerMagicLE) {
+        return LE16(holder->packet.multiController.controllerNumber);
+    }
+    else if (holder->packet.header.magic == LE32(MOUSE_MOVE_ABS_MAGIC)) {
+        return ABS_MOUSE_REFRESH_SLOT;
+    }
+    else {
+        return -1;
+    }
+}
+
+static bool isReliableRefreshPending(void) {
+    for (int i = 0; i < MAX_GAMEPADS + 1; i++) {
+        if (reliableRefreshState[i].pending) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Resends the latest unreliable state reliably. If channelId is negative, this sends
+// the refreshes that are due. Otherwise, it sends the pending refreshes on that channel,
+// so a reliable packet never reaches the host ahead of the state that preceded it.
+static bool sendReliableRefreshes(int channelId) {
+    uint64_t now = PltGetMillis();
+
+    for (int i = 0; i < MAX_GAMEPADS + 1; i++) {
+        if (!reliableRefreshState[i].pending) {
+            continue;
+        }
+
+        if (channelId < 0 ?
+                now >= reliableRefreshState[i].sendTime + RELIABLE_REFRESH_DELAY_MS :
+                reliableRefreshState[i].holder.channelId == channelId) {
+            reliableRefreshState[i].pending = false;
+            reliableRefreshState[i].holder.enetPacketFlags = ENET_PACKET_FLAG_RELIABLE;
+            if (!sendInputPacket(&reliableRefreshState[i].holder, channelId >= 0)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
 // Input thread proc
 static void inputSendThreadProc(void* context) {
     SOCK_RET err;
@@ -339,7 +429,23 @@ static void inputSendThreadProc(void* context) {
     uint64_t lastPenPacketTime = 0;
 
     while (!PltIsThreadInterrupted(&inputSendThread)) {
-        err = LbqWaitForQueueElement(&packetQueue, (void**)&holder);
+        int refreshSlot;
+
+        if (isReliableRefreshPending()) {
+            // Poll for input so we can send the reliable refreshes when they're due
+            err = LbqPollQueueElement(&packetQueue, (void**)&holder);
+            if (err == LBQ_NO_ELEMENT) {
+                if (!sendReliableRefreshes(-1)) {
+                    return;
+                }
+
+                PltSleepMs(1);
+                continue;
+            }
+        }
+        else {
+            err = LbqWaitForQueueElement(&packetQueue, (void**)&holder);
+        }
         if (err != LBQ_SUCCESS) {
             return;
         }
@@ -362,6 +468,19 @@ static void inputSendThreadProc(void* context) {
 
             PltUnlockMutex(&batchedInputMutex);
         }
+        // If it's a touch packet, latch it in the same way by removing it from currentQueuedTouchPacket
+        else if (holder->packet.header.magic == LE32(SS_TOUCH_MAGIC)) {
+            PltLockMutex(&batchedInputMutex);
+
+            for (int i = 0; i < MAX_BATCHED_TOUCH_POINTERS; i++) {
+                if (holder == currentQueuedTouchPacket[i]) {
+                    currentQueuedTouchPacket[i] = NULL;
+                    break;
+                }
+            }
+
+            PltUnlockMutex(&batchedInputMutex);
+        }
         // If it's a relative mouse move packet, we can do batching
         else if (holder->packet.header.magic == relMouseMagicLE) {
             uint64_t now = PltGetMillis();
@@ -373,6 +492,12 @@ static void inputSendThreadProc(void* context) {
                 now = PltGetMillis();
             }
 
+            // Relative motion must apply on top of the latest absolute position
+            if (!sendReliableRefreshes(holder->channelId)) {
+                freePacketHolder(holder);
+                return;
+            }
+
             PltLockMutex(&batchedInputMutex);
 
             // Send as many packets as it takes to get the entire delta through
@@ -515,6 +640,17 @@ static void inputSendThreadProc(void* context) {
             LC_ASSERT(controllerNumber < MAX_GAMEPADS);
             LC_ASSERT(motionType - 1 < MAX_MOTION_EVENTS);
 
+            // Delay for batching if required. Other sensor updates (including from other
+            // controllers) keep accumulating into their pending packets while we wait,
+            // so they are sent together in a single flush afterwards.
+            uint64_t now = PltGetMillis();
+            uint64_t lastSendTime = currentGamepadSensorState[controllerNumber][motionType - 1].lastSendTime;
+            if (now < lastSendTime + MOTION_BATCHING_INTERVAL_MS) {
+                flushInputOnControlStream();
+                PltSleepMs((int)(lastSendTime + MOTION_BATCHING_INTERVAL_MS - now));
+                now = PltGetMillis();
+            }
+
             PltLockMutex(&batchedInputMutex);
 
             // LI_MOTION_TYPE_* values are 1-based, so we have to subtract 1 to index into our state array
@@ -540,6 +676,7 @@ static void inputSendThreadProc(void* context) {
 
             // The state change is no longer pending
             currentGamepadSensorState[controllerNumber][motionType - 1].dirty = false;
+            currentGamepadSensorState[controllerNumber][motionType - 1].lastSendTime = now;
 
             PltUnlockMutex(&batchedInputMutex);
         }
@@ -605,12 +742,32 @@ static void inputSendThreadProc(void* context) {
             continue;
         }
 
+        refreshSlot = getReliableRefreshSlot(holder, multiControllerMagicLE);
+        if (holder->enetPacketFlags & ENET_PACKET_FLAG_RELIABLE) {
+            // This packet supersedes any pending refresh of its own state, but
+            // other state on the same channel must be delivered before it.
+            if (refreshSlot >= 0) {
+                reliableRefreshState[refreshSlot].pending = false;
+            }
+            if (!sendReliableRefreshes(holder->channelId)) {
+                freePacketHolder(holder);
+                return;
+            }
+        }
+
         // Encrypt and send the input packet
         if (!sendInputPacket(holder, LbqGetItemCount(&packetQueue) > 0)) {
             freePacketHolder(holder);
             return;
         }
 
+        // Remember the unreliable state in case we need to send it again
+        if (refreshSlot >= 0 && !(holder->enetPacketFlags & ENET_PACKET_FLAG_RELIABLE)) {
+            reliableRefreshState[refreshSlot].holder = *holder;
+            reliableRefreshState[refreshSlot].sendTime = PltGetMillis();
+            reliableRefreshState[refreshSlot].pending = true;
+        }
+
         freePacketHolder(holder);
     }
 }
@@ -662,7 +819,7 @@ int startInputStream(void) {
         enableNoDelay(inputSock);
     }
 
-    err = PltCreateThread("InputSend", inputSendThreadProc, NULL, &inputSendThread);
+    err = PltCreateThread("InputSend", PLT_THREAD_ROLE_CONTROL, inputSendThreadProc, NULL, &inputSendThread);
     if (err != 0) {
         if (inputSock != INVALID_SOCKET) {
             closeSocket(inputSock);
@@ -802,8 +959,9 @@ int LiSendMousePositionEvent(short x, short y, short referenceWidth, short refer
 
         holder->channelId = CTRL_CHANNEL_MOUSE;
 
-        // TODO: Send this as unreliable sequenced when we have a delayed reliable retransmission thread
-        holder->enetPacketFlags = ENET_PACKET_FLAG_RELIABLE;
+        // Each position supersedes the last, and the input thread resends the final one reliably.
+        // Reliability only matters for ENet, so we don't bother with older hosts.
+        holder->enetPacketFlags = AppVersionQuad[0] >= 5 ? 0 : ENET_PACKET_FLAG_RELIABLE;
 
         holder->packet.mouseMoveAbs.header.size = BE32(sizeof(NV_ABS_MOUSE_MOVE_PACKET) - sizeof(uint32_t));
         holder->packet.mouseMoveAbs.header.magic = LE32(MOUSE_MOVE_ABS_MAGIC);
@@ -1072,7 +1230,7 @@ static int sendControllerEventInternal(short controllerNumber, short activeGamep
         // Send each controller on a separate channel
         holder->channelId = CTRL_CHANNEL_GAMEPAD_BASE + controllerNumber;
 
-        // TODO: Send this as unreliable sequenced when we have a delayed reliable retransmission thread
+        // Button changes are always reliable. This is downgraded below for axis-only updates.
         holder->enetPacketFlags = ENET_PACKET_FLAG_RELIABLE;
 
         // Remember that we need to enqueue this holder since it's new
@@ -1130,6 +1288,15 @@ static int sendControllerEventInternal(short controllerNumber, short activeGamep
         if (enqueueHolder) {
             // Make this new packet holder the current enqueued packet
             currentQueuedControllerPacket[controllerNumber] = holder;
+
+            // If the buttons haven't changed, this packet only carries axis state that
+            // the next one supersedes. The input thread resends the final state reliably.
+            if (AppVersionQuad[0] >= 5 && lastQueuedControllerButtons[controllerNumber].valid &&
+                lastQueuedControllerButtons[controllerNumber].buttonFlags == (uint32_t)buttonFlags) {
+                holder->enetPacketFlags = 0;
+            }
+            lastQueuedControllerButtons[controllerNumber].buttonFlags = (uint32_t)buttonFlags;
+            lastQueuedControllerButtons[controllerNumber].valid = true;
         }
     }
 
@@ -1323,9 +1490,36 @@ int LiSendHScrollEvent(signed char scrollClicks) {
     return LiSendHighResHScrollEvent(scrollClicks * LI_WHEEL_DELTA);
 }
 
+static void populateTouchPacket(PPACKET_HOLDER holder, uint8_t eventType, uint32_t pointerId, float x, float y, float pressureOrDistance,
+                                float contactAreaMajor, float contactAreaMinor, uint16_t rotation) {
+    holder->packet.touch.header.size = BE32(sizeof(SS_TOUCH_PACKET) - sizeof(uint32_t));
+    holder->packet.touch.header.magic = LE32(SS_TOUCH_MAGIC);
+    holder->packet.touch.eventType = eventType;
+    holder->packet.touch.pointerId = LE32(pointerId);
+    holder->packet.touch.rotation = LE16(rotation);
+    memset(holder->packet.touch.zero, 0, sizeof(holder->packet.touch.zero));
+    floatToNetfloat(x, holder->packet.touch.x);
+    floatToNetfloat(y, holder->packet.touch.y);
+    floatToNetfloat(pressureOrDistance, holder->packet.touch.pressureOrDistance);
+    floatToNetfloat(contactAreaMajor, holder->packet.touch.contactAreaMajor);
+    floatToNetfloat(contactAreaMinor, holder->packet.touch.contactAreaMinor);
+}
+
+// Must be called with batchedInputMutex held
+static int findQueuedTouchPacket(uint32_t pointerId) {
+    for (int i = 0; i < MAX_BATCHED_TOUCH_POINTERS; i++) {
+        if (currentQueuedTouchPacket[i] != NULL && currentQueuedTouchPacket[i]->packet.touch.pointerId == LE32(pointerId)) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
 int LiSendTouchEvent(uint8_t eventType, uint32_t pointerId, float x, float y, float pressureOrDistance,
                      float contactAreaMajor, float contactAreaMinor, uint16_t rotation) {
     PPACKET_HOLDER holder;
+    int batchIndex;
     int err;
 
     if (!initialized) {
@@ -1337,6 +1531,30 @@ int LiSendTouchEvent(uint8_t eventType, uint32_t pointerId, float x, float y, fl
         return LI_ERR_UNSUPPORTED;
     }
 
+    // The batched input mutex protects against the enqueued packet being processed
+    // and freed from underneath us when we're trying to update it.
+    PltLockMutex(&batchedInputMutex);
+
+    batchIndex = findQueuedTouchPacket(pointerId);
+    if (batchIndex >= 0) {
+        holder = currentQueuedTouchPacket[batchIndex];
+
+        // If a move or hover event for this pointer hasn't been sent yet, just replace
+        // it with this one. Anything else ends the batch to preserve the event order.
+        if (TOUCH_EVENT_IS_BATCHABLE(eventType) && holder->packet.touch.eventType == eventType) {
+            populateTouchPacket(holder, eventType, pointerId, x, y, pressureOrDistance,
+                                contactAreaMajor, contactAreaMinor, rotation);
+            PltUnlockMutex(&batchedInputMutex);
+            return 0;
+        }
+
+        currentQueuedTouchPacket[batchIndex] = NULL;
+    }
+
+    // We're not using a currently queued packet, so it's safe
+    // to unlock while we allocate a new one.
+    PltUnlockMutex(&batchedInputMutex);
+
     holder = allocatePacketHolder(0);
     if (holder == NULL) {
         return -1;
@@ -1348,22 +1566,40 @@ int LiSendTouchEvent(uint8_t eventType, uint32_t pointerId, float x, float y, fl
     // state changing events like up/down/leave events to be dropped.
     holder->enetPacketFlags = TOUCH_EVENT_IS_BATCHABLE(eventType) ? 0 : ENET_PACKET_FLAG_RELIABLE;
 
-    holder->packet.touch.header.size = BE32(sizeof(SS_TOUCH_PACKET) - sizeof(uint32_t));
-    holder->packet.touch.header.magic = LE32(SS_TOUCH_MAGIC);
-    holder->packet.touch.eventType = eventType;
-    holder->packet.touch.pointerId = LE32(pointerId);
-    holder->packet.touch.rotation = LE16(rotation);
-    memset(holder->packet.touch.zero, 0, sizeof(holder->packet.touch.zero));
-    floatToNetfloat(x, holder->packet.touch.x);
-    floatToNetfloat(y, holder->packet.touch.y);
-    floatToNetfloat(pressureOrDistance, holder->packet.touch.pressureOrDistance);
-    floatToNetfloat(contactAreaMajor, holder->packet.touch.contactAreaMajor);
-    floatToNetfloat(contactAreaMinor, holder->packet.touch.contactAreaMinor);
+    populateTouchPacket(holder, eventType, pointerId, x, y, pressureOrDistance,
+                        contactAreaMajor, contactAreaMinor, rotation);
+
+    // Later move or hover events for this pointer can be batched into this one
+    // until the input thread picks it up, if we have a slot to track it.
+    batchIndex = -1;
+    if (TOUCH_EVENT_IS_BATCHABLE(eventType)) {
+        PltLockMutex(&batchedInputMutex);
+        if (findQueuedTouchPacket(pointerId) < 0) {
+            for (int i = 0; i < MAX_BATCHED_TOUCH_POINTERS; i++) {
+                if (currentQueuedTouchPacket[i] == NULL) {
+                    currentQueuedTouchPacket[i] = holder;
+                    batchIndex = i;
+                    break;
+                }
+            }
+        }
+        PltUnlockMutex(&batchedInputMutex);
+    }
 
     err = LbqOfferQueueItem(&packetQueue, holder, &holder->entry);
     if (err != LBQ_SUCCESS) {
         LC_ASSERT(err == LBQ_BOUND_EXCEEDED);
         Limelog("Input queue reached maximum size limit\n");
+
+        // Stop batching into this holder before we free it
+        if (batchIndex >= 0) {
+            PltLockMutex(&batchedInputMutex);
+            if (currentQueuedTouchPacket[batchIndex] == holder) {
+                currentQueuedTouchPacket[batchIndex] = NULL;
+            }
+            PltUnlockMutex(&batchedInputMutex);
+        }
+
         freePacketHolder(holder);
     }
 
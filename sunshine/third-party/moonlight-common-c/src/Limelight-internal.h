@@ -10,6 +10,9 @@
 #include "RtpAudioQueue.h"
 #include "RtpVideoQueue.h"
 #include "ByteBuffer.h"
+#include "BufferPool.h"
+#include "Scheduler.h"
+#include "DecryptPool.h"
 
 #include <enet/enet.h>
 
@@ -53,6 +56,8 @@ extern uint32_t EncryptionFeaturesSupported;
 extern uint32_t EncryptionFeaturesRequested;
 extern uint32_t EncryptionFeaturesEnabled;
 
+extern VIDEO_FRAME_TIMING_STATS VideoTimingStats;
+
 // ENet channel ID values
 #define CTRL_CHANNEL_GENERIC      0x00
 #define CTRL_CHANNEL_URGENT       0x01 // IDR and reference frame invalidation requests
@@ -87,6 +92,7 @@ extern uint32_t EncryptionFeaturesEnabled;
 // Client feature flags for x-ml-general.featureFlags SDP attribute
 #define ML_FF_FEC_STATUS 0x01 // Client sends SS_FRAME_FEC_STATUS for frame losses
 #define ML_FF_SESSION_ID_V1 0x02 // Client supports X-SS-Ping-Payload and X-SS-Connect-Data
+#define ML_FF_FRAME_NAL_INFO 0x04 // Client reads the H.264/HEVC NALU layout from the frame header
 
 #define UDP_RECV_POLL_TIMEOUT_MS 100
 
@@ -115,6 +121,8 @@ void setRecorderCallbacks(PDECODER_RENDERER_CALLBACKS drCallbacks, PAUDIO_RENDER
 char* getSdpPayloadForStreamConfig(int rtspClientVersion, int* length);
 
 int initializeControlStream(void);
+int prebindControlStream(void);
+void releasePreboundControlStream(void);
 int startControlStream(void);
 int stopControlStream(void);
 void destroyControlStream(void);
@@ -135,16 +143,32 @@ void stopVideoDepacketizer(void);
 void requestDecoderRefresh(void);
 void notifyFrameLost(unsigned int frameNumber, bool speculative);
 
+void initializeStartCodeScanner(void);
+// Returns the offset of the first 00 00 01 entirely within the buffer, or length if there is none
+unsigned int findAnnexBStartCode(const unsigned char* data, unsigned int length);
+unsigned int findAnnexBStartCodeScalar(const unsigned char* data, unsigned int length);
+
 void initializeVideoStream(void);
 void destroyVideoStream(void);
 void notifyKeyFrameReceived(void);
-int startVideoStream(void* rendererContext, int drFlags);
+void* allocVideoPacketBuffer(void);
+void freeVideoPacketBuffer(void* buffer);
+void addVideoTimingSample(PVIDEO_TIMING_HISTOGRAM histogram, uint64_t durationUs);
+int prebindVideoStream(void);
+void releasePreboundVideoStream(void);
+int prepareVideoStream(void* rendererContext, int drFlags);
+void unprepareVideoStream(void);
+int startVideoStream(void);
 void stopVideoStream(void);
 
 int initializeAudioStream(void);
+int prebindAudioStream(void);
+void releasePreboundAudioStream(void);
 int notifyAudioPortNegotiationComplete(void);
 void destroyAudioStream(void);
-int startAudioStream(void* audioContext, int arFlags);
+int prepareAudioStream(void* audioContext, int arFlags);
+void unprepareAudioStream(void);
+int startAudioStream(void);
 void stopAudioStream(void);
 
 int initializeInputStream(void);
@@ -100,6 +100,13 @@ typedef struct _STREAM_CONFIGURATION {
     // in /launch and /resume requests.
     char remoteInputAesKey[16];
     char remoteInputAesIv[16];
+
+    // Optional CPU affinity masks (bit N selects CPU N) for the audio and video
+    // receive threads and for the audio and video decoding threads. Zero leaves
+    // the threads free to run on any CPU. Only Linux (including Android) and
+    // Windows desktop honor these.
+    uint64_t receiveThreadAffinityMask;
+    uint64_t decodeThreadAffinityMask;
 } STREAM_CONFIGURATION, *PSTREAM_CONFIGURATION;
 
 // Use this function to zero the stream configuration when allocated on the stack or heap
@@ -191,6 +198,12 @@ typedef struct _DECODE_UNIT {
     // Note: This is not currently parsed from the actual bitstream, so if your
     // client has access to a bitstream parser, prefer that over this field.
     uint8_t colorspace;
+
+    // Estimated capture time of the frame in the LiGetMicroseconds() timebase. This is
+    // presentationTimeUs shifted by the smallest receive delay seen so far in the stream,
+    // so LiGetMicroseconds() - captureTimeUs is the age of the frame beyond the best-case
+    // encode and network latency. Renderers can use it to detect that they are falling behind.
+    uint64_t captureTimeUs;
 } DECODE_UNIT, *PDECODE_UNIT;
 
 // Specifies that the audio stream should be encoded in stereo (default)
@@ -276,6 +289,22 @@ typedef struct _DECODE_UNIT {
 // supports reference frame invalidation for AV1 streams. This flag is only valid on video renderers.
 #define CAPABILITY_REFERENCE_FRAME_INVALIDATION_AV1 0x40
 
+// If set in the video renderer capabilities field, the data of each decode unit is stored
+// in a single contiguous buffer: bufferList->data points to all fullLength bytes of the frame,
+// followed by at least 64 zeroed padding bytes (as required by FFmpeg), so it can be passed
+// to the decoder without copying it first. The buffer list still describes the same data,
+// with consecutive picture data merged into a single entry. This flag is only valid on video
+// renderers.
+#define CAPABILITY_CONTIGUOUS_DECODE_UNITS 0x80
+
+// If set in the video renderer capabilities field, frames that have waited in the decode unit
+// queue for several frame intervals while newer frames are pending are dropped so the renderer
+// can catch up with the stream instead of staying behind. Frames preceding a queued IDR frame
+// are skipped, otherwise the queue is flushed and the host is asked to recover with reference
+// frame invalidation (or an IDR frame if RFI is not usable). This flag has no effect when
+// CAPABILITY_DIRECT_SUBMIT is set and is only valid on video renderers.
+#define CAPABILITY_DROP_STALE_FRAMES 0x100
+
 // If set in the video renderer capabilities field, this macro specifies that the renderer
 // supports slicing to increase decoding performance. The parameter specifies the desired
 // number of slices per frame. This capability is only valid on video renderers.
@@ -559,6 +588,42 @@ void LiStopConnection(void);
 // so it is not safe to start another connection before the first LiStartConnection() call returns.
 void LiInterruptConnection(void);
 
+// A connection context is an opaque handle to a streaming session. Contexts may be
+// created up front and reused for consecutive sessions, but the library still keeps
+// the session state in process-wide storage, so only one context may be started at
+// a time. LiStartConnectionWithContext() fails without side effects if another context
+// (including the one behind LiStartConnection()) is active. All other LiXxx() functions,
+// such as input and stats, apply to the active session.
+typedef struct _CONNECTION_CONTEXT* PCONNECTION_CONTEXT;
+
+// Returns NULL if the allocation fails
+PCONNECTION_CONTEXT LiCreateConnectionContext(void);
+
+// These behave like LiStartConnection(), LiStopConnection() and LiInterruptConnection().
+// Stopping or interrupting a context that is not active does nothing.
+int LiStartConnectionWithContext(PCONNECTION_CONTEXT context, PSERVER_INFORMATION serverInfo, PSTREAM_CONFIGURATION streamConfig,
+    PCONNECTION_LISTENER_CALLBACKS clCallbacks, PDECODER_RENDERER_CALLBACKS drCallbacks, PAUDIO_RENDERER_CALLBACKS arCallbacks,
+    void* renderContext, int drFlags, void* audioContext, int arFlags);
+void LiStopConnectionWithContext(PCONNECTION_CONTEXT context);
+void LiInterruptConnectionWithContext(PCONNECTION_CONTEXT context);
+
+// Stops the context if it is still active and frees it
+void LiDestroyConnectionContext(PCONNECTION_CONTEXT context);
+
+// This function does the host-independent part of a connection ahead of time, so that
+// a following LiStartConnection() to the same serverInfo->address only has to perform the
+// RTSP handshake and start the streams. It initializes the platform, resolves the host
+// name, binds the audio, video and control stream sockets and loads the crypto library.
+//
+// The pre-connection stays warm for warmPeriodMs (30 seconds if 0 or negative). A start
+// after that, or to another address, discards it and connects from scratch. Until it is
+// used or discarded it holds the sockets, so call LiCancelPreconnect() if the stream
+// won't be started. Calling LiPreconnect() again replaces the previous pre-connection.
+//
+// This fails if a connection is active. Like LiStartConnection(), it is not thread-safe.
+int LiPreconnect(PSERVER_INFORMATION serverInfo, PCONNECTION_LISTENER_CALLBACKS clCallbacks, int warmPeriodMs);
+void LiCancelPreconnect(void);
+
 // Use to get a user-visible string to display initialization progress
 // from the integer passed to the ConnListenerStageXXX callbacks
 const char* LiGetStageName(int stage);
@@ -879,6 +944,19 @@ typedef struct _RTP_AUDIO_STATS {
 
 const RTP_AUDIO_STATS* LiGetRTPAudioStats(void);
 
+// Returns a pointer to a struct containing statistics about the audio jitter buffer,
+// which paces audio packets to the decoder when CAPABILITY_DIRECT_SUBMIT is not set
+// for the audio renderer. The data should be considered read-only and must not be modified.
+typedef struct _AUDIO_JITTER_BUFFER_STATS {
+    uint32_t targetDelayMs;           // current playout delay, adapted to the arrival jitter
+    uint32_t jitterUs;                // smoothed packet arrival jitter
+    uint32_t packetCountConcealed;    // packet slots concealed because nothing arrived in time
+    uint32_t packetCountTrimmed;      // packets dropped to bring the delay back down to the target
+    uint32_t rebufferCount;           // playout stalls that required buffering up to the target again
+} AUDIO_JITTER_BUFFER_STATS, *PAUDIO_JITTER_BUFFER_STATS;
+
+const AUDIO_JITTER_BUFFER_STATS* LiGetAudioJitterBufferStats(void);
+
 // Returns a pointer to a struct containing various statistics about the RTP video stream.
 // The data should be considered read-only and must not be modified.
 // Right now this is mainly used to track total video and FEC packets, as there are
@@ -895,6 +973,42 @@ typedef struct _RTP_VIDEO_STATS {
 
 const RTP_VIDEO_STATS* LiGetRTPVideoStats(void);
 
+// Returns a pointer to a struct containing histograms of the time spent by video frames in
+// each stage of the receive path. The data is racy with the stream threads, so it should be
+// considered approximate, as well as read-only. It is reset when a connection starts.
+//
+// Bucket i counts the durations below VIDEO_TIMING_BUCKET_LIMIT_US(i) that didn't fit in
+// the previous buckets. The last bucket counts all the longer durations.
+#define VIDEO_TIMING_HISTOGRAM_BUCKETS 16
+#define VIDEO_TIMING_BUCKET_LIMIT_US(i) (128ULL << (i))
+
+typedef struct _VIDEO_TIMING_HISTOGRAM {
+    uint32_t buckets[VIDEO_TIMING_HISTOGRAM_BUCKETS];
+    uint32_t sampleCount;
+    uint32_t maxUs;
+    uint64_t totalUs;
+} VIDEO_TIMING_HISTOGRAM, *PVIDEO_TIMING_HISTOGRAM;
+
+typedef struct _VIDEO_FRAME_TIMING_STATS {
+    VIDEO_TIMING_HISTOGRAM frameReceive;  // first to last packet of a frame (time to receive it)
+    VIDEO_TIMING_HISTOGRAM fecRecovery;   // Reed-Solomon reconstruction of FEC blocks missing data
+    VIDEO_TIMING_HISTOGRAM reassembly;    // last packet of a frame to its decode unit being queued
+    VIDEO_TIMING_HISTOGRAM queueWait;     // decode unit queued to being pulled by the renderer
+} VIDEO_FRAME_TIMING_STATS, *PVIDEO_FRAME_TIMING_STATS;
+
+const VIDEO_FRAME_TIMING_STATS* LiGetVideoFrameTimingHistogram(void);
+
+// Returns a pointer to a struct describing the crypto library used to encrypt and decrypt
+// the streams. The throughput is measured once, when the first connection with encrypted
+// video is started, and is zero before that. The data should be considered read-only and
+// must not be modified.
+typedef struct _CRYPTO_BACKEND_STATS {
+    const char* backendName;            // crypto library and version
+    uint32_t gcmDecryptThroughputMBps;  // AES-128-GCM decryption throughput of video packets
+} CRYPTO_BACKEND_STATS, *PCRYPTO_BACKEND_STATS;
+
+const CRYPTO_BACKEND_STATS* LiGetCryptoBackendStats(void);
+
 // Port index flags for use with LiGetPortFromPortFlagIndex() and LiGetProtocolFromPortFlagIndex()
 #define ML_PORT_INDEX_TCP_47984 0
 #define ML_PORT_INDEX_TCP_47989 1
@@ -1002,6 +1116,8 @@ void LiRequestIdrFrame(void);
 // This function returns any extended feature flags supported by the host.
 #define LI_FF_PEN_TOUCH_EVENTS        0x01 // LiSendTouchEvent()/LiSendPenEvent() supported
 #define LI_FF_CONTROLLER_TOUCH_EVENTS 0x02 // LiSendControllerTouchEvent() supported
+#define LI_FF_ADAPTIVE_FEC            0x04 // Host applies the video FEC percentage requested by the client
+#define LI_FF_FRAME_NAL_INFO          0x08 // Host describes the H.264/HEVC NALU layout in the frame header
 uint32_t LiGetHostFeatureFlags(void);
 
 #ifdef __cplusplus
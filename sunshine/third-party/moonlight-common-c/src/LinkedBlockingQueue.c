@@ -1,158 +1,242 @@
 #include "LinkedBlockingQueue.h"
 
-// Destroy the linked blocking queue and associated mutex and event
-PLINKED_BLOCKING_QUEUE_ENTRY LbqDestroyLinkedBlockingQueue(PLINKED_BLOCKING_QUEUE queueHead) {
-    LC_ASSERT(queueHead->shutdown || queueHead->draining || queueHead->lifetimeSize == 0);
-    
-    PltDeleteMutex(&queueHead->mutex);
-    PltDeleteConditionVariable(&queueHead->cond);
+// The ring is a bounded MPMC queue: each cell's sequence number tells whether
+// it is ready to be filled (== position) or consumed (== position + 1) for the
+// current lap. Positions are free running 32-bit counters and only compared
+// as differences, so they can wrap around.
+
+static bool enqueueEntry(PLINKED_BLOCKING_QUEUE queueHead, PLINKED_BLOCKING_QUEUE_ENTRY entry) {
+    PLINKED_BLOCKING_QUEUE_CELL cell;
+    int position = PltAtomicLoad(&queueHead->enqueuePosition);
+
+    for (;;) {
+        int diff;
+
+        cell = &queueHead->cells[position & queueHead->cellMask];
+        diff = (int)((unsigned int)PltAtomicLoad(&cell->sequence) - (unsigned int)position);
+        if (diff == 0) {
+            if (PltAtomicCompareExchange(&queueHead->enqueuePosition, &position, (int)((unsigned int)position + 1))) {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            // Full
+            return false;
+        }
+        else {
+            position = PltAtomicLoad(&queueHead->enqueuePosition);
+        }
+    }
 
-    return queueHead->head;
+    cell->entry = entry;
+    PltAtomicStore(&cell->sequence, (int)((unsigned int)position + 1));
+    return true;
 }
 
-// Flush the queue
-PLINKED_BLOCKING_QUEUE_ENTRY LbqFlushQueueItems(PLINKED_BLOCKING_QUEUE queueHead) {
-    PLINKED_BLOCKING_QUEUE_ENTRY head;
+static PLINKED_BLOCKING_QUEUE_ENTRY dequeueEntry(PLINKED_BLOCKING_QUEUE queueHead) {
+    PLINKED_BLOCKING_QUEUE_CELL cell;
+    PLINKED_BLOCKING_QUEUE_ENTRY entry;
+    int position = PltAtomicLoad(&queueHead->dequeuePosition);
 
+    for (;;) {
+        int diff;
+
+        cell = &queueHead->cells[position & queueHead->cellMask];
+        diff = (int)((unsigned int)PltAtomicLoad(&cell->sequence) - ((unsigned int)position + 1));
+        if (diff == 0) {
+            if (PltAtomicCompareExchange(&queueHead->dequeuePosition, &position, (int)((unsigned int)position + 1))) {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            // Empty (or the producer of this cell hasn't published it yet)
+            return NULL;
+        }
+        else {
+            position = PltAtomicLoad(&queueHead->dequeuePosition);
+        }
+    }
+
+    entry = cell->entry;
+    PltAtomicStore(&cell->sequence, (int)((unsigned int)position + queueHead->cellMask + 1));
+    PltAtomicAdd(&queueHead->currentSize, -1);
+
+    entry->flink = NULL;
+    entry->blink = NULL;
+    return entry;
+}
+
+static bool isQueueEmpty(PLINKED_BLOCKING_QUEUE queueHead) {
+    int position = PltAtomicLoad(&queueHead->dequeuePosition);
+    PLINKED_BLOCKING_QUEUE_CELL cell = &queueHead->cells[position & queueHead->cellMask];
+
+    return PltAtomicLoad(&cell->sequence) != (int)((unsigned int)position + 1);
+}
+
+// Wakes the consumer if it is (or is about to be) waiting in LbqWaitForQueueElement()
+static void wakeWaiter(PLINKED_BLOCKING_QUEUE queueHead) {
+    // Taking the mutex ensures the waiter is either already blocked on the
+    // condition variable or will see our update before it blocks
     PltLockMutex(&queueHead->mutex);
+    PltUnlockMutex(&queueHead->mutex);
+    PltSignalConditionVariable(&queueHead->cond);
+}
 
-    // Save the old head
-    head = queueHead->head;
+// Remove all entries from the queue and return them as a list
+static PLINKED_BLOCKING_QUEUE_ENTRY dequeueAllEntries(PLINKED_BLOCKING_QUEUE queueHead) {
+    PLINKED_BLOCKING_QUEUE_ENTRY head = NULL;
+    PLINKED_BLOCKING_QUEUE_ENTRY tail = NULL;
+    PLINKED_BLOCKING_QUEUE_ENTRY entry;
 
-    // Reinitialize the queue to empty
-    if (head != NULL) {
-        queueHead->head = NULL;
-        queueHead->tail = NULL;
-        queueHead->currentSize = 0;
-    }
-    else {
-        LC_ASSERT(queueHead->tail == NULL);
-        LC_ASSERT(queueHead->currentSize == 0);
+    while ((entry = dequeueEntry(queueHead)) != NULL) {
+        if (tail == NULL) {
+            head = entry;
+        }
+        else {
+            tail->flink = entry;
+            entry->blink = tail;
+        }
+        tail = entry;
     }
 
-    PltUnlockMutex(&queueHead->mutex);
+    return head;
+}
+
+// Destroy the linked blocking queue and associated mutex and event
+PLINKED_BLOCKING_QUEUE_ENTRY LbqDestroyLinkedBlockingQueue(PLINKED_BLOCKING_QUEUE queueHead) {
+    PLINKED_BLOCKING_QUEUE_ENTRY head;
+
+    LC_ASSERT(queueHead->shutdown || queueHead->draining || queueHead->lifetimeSize == 0);
+
+    head = queueHead->cells != NULL ? dequeueAllEntries(queueHead) : NULL;
+
+    PltDeleteMutex(&queueHead->mutex);
+    PltDeleteConditionVariable(&queueHead->cond);
+
+    free(queueHead->cells);
+    queueHead->cells = NULL;
 
     return head;
 }
 
+// Flush the queue
+PLINKED_BLOCKING_QUEUE_ENTRY LbqFlushQueueItems(PLINKED_BLOCKING_QUEUE queueHead) {
+    return dequeueAllEntries(queueHead);
+}
+
 // Linked blocking queue init
 int LbqInitializeLinkedBlockingQueue(PLINKED_BLOCKING_QUEUE queueHead, int sizeBound) {
     int err;
+    int cellCount;
+    int i;
 
     memset(queueHead, 0, sizeof(*queueHead));
 
+    // The bound is enforced by currentSize, so the ring just needs to be
+    // large enough to never fill up
+    cellCount = 2;
+    while (cellCount < sizeBound) {
+        cellCount *= 2;
+    }
+
+    queueHead->cells = (PLINKED_BLOCKING_QUEUE_CELL)malloc(sizeof(*queueHead->cells) * cellCount);
+    if (queueHead->cells == NULL) {
+        return -1;
+    }
+
+    for (i = 0; i < cellCount; i++) {
+        queueHead->cells[i].sequence = i;
+        queueHead->cells[i].entry = NULL;
+    }
+
     err = PltCreateMutex(&queueHead->mutex);
     if (err != 0) {
+        free(queueHead->cells);
+        queueHead->cells = NULL;
         return err;
     }
 
     err = PltCreateConditionVariable(&queueHead->cond, &queueHead->mutex);
     if (err != 0) {
         PltDeleteMutex(&queueHead->mutex);
+        free(queueHead->cells);
+        queueHead->cells = NULL;
         return err;
     }
 
+    queueHead->cellMask = cellCount - 1;
     queueHead->sizeBound = sizeBound;
 
     return 0;
 }
 
 void LbqSignalQueueShutdown(PLINKED_BLOCKING_QUEUE queueHead) {
-    PltLockMutex(&queueHead->mutex);
-    queueHead->shutdown = true;
-    PltUnlockMutex(&queueHead->mutex);
-    PltSignalConditionVariable(&queueHead->cond);
+    PltAtomicStore(&queueHead->shutdown, true);
+    wakeWaiter(queueHead);
 }
 
 void LbqSignalQueueDrain(PLINKED_BLOCKING_QUEUE queueHead) {
-    PltLockMutex(&queueHead->mutex);
-    queueHead->draining = true;
-    PltUnlockMutex(&queueHead->mutex);
-    PltSignalConditionVariable(&queueHead->cond);
+    PltAtomicStore(&queueHead->draining, true);
+    wakeWaiter(queueHead);
 }
 
 void LbqSignalQueueUserWake(PLINKED_BLOCKING_QUEUE queueHead) {
-    PltLockMutex(&queueHead->mutex);
-    queueHead->pendingUserWake = true;
-    PltUnlockMutex(&queueHead->mutex);
-    PltSignalConditionVariable(&queueHead->cond);
+    PltAtomicStore(&queueHead->pendingUserWake, true);
+    wakeWaiter(queueHead);
 }
 
 int LbqGetItemCount(PLINKED_BLOCKING_QUEUE queueHead) {
-    return queueHead->currentSize;
+    return PltAtomicLoad(&queueHead->currentSize);
 }
 
 int LbqOfferQueueItem(PLINKED_BLOCKING_QUEUE queueHead, void* data, PLINKED_BLOCKING_QUEUE_ENTRY entry) {
-    bool wasEmpty;
-    
     entry->flink = NULL;
+    entry->blink = NULL;
     entry->data = data;
 
-    PltLockMutex(&queueHead->mutex);
-
-    if (queueHead->shutdown || queueHead->draining) {
-        PltUnlockMutex(&queueHead->mutex);
+    if (PltAtomicLoad(&queueHead->shutdown) || PltAtomicLoad(&queueHead->draining)) {
         return LBQ_INTERRUPTED;
     }
 
-    if (queueHead->currentSize == queueHead->sizeBound) {
-        PltUnlockMutex(&queueHead->mutex);
+    // Reserve our slot first, so concurrent producers can't exceed the bound
+    if (PltAtomicAdd(&queueHead->currentSize, 1) >= queueHead->sizeBound) {
+        PltAtomicAdd(&queueHead->currentSize, -1);
         return LBQ_BOUND_EXCEEDED;
     }
 
-    wasEmpty = queueHead->head == NULL;
-    if (wasEmpty) {
-        LC_ASSERT(queueHead->currentSize == 0);
-        LC_ASSERT(queueHead->tail == NULL);
-        queueHead->head = entry;
-        queueHead->tail = entry;
-        entry->blink = NULL;
-    }
-    else {
-        LC_ASSERT(queueHead->currentSize >= 1);
-        LC_ASSERT(queueHead->head != NULL);
-        queueHead->tail->flink = entry;
-        entry->blink = queueHead->tail;
-        queueHead->tail = entry;
+    if (!enqueueEntry(queueHead, entry)) {
+        // The ring is larger than the bound, so this can't happen
+        LC_ASSERT(false);
+        PltAtomicAdd(&queueHead->currentSize, -1);
+        return LBQ_BOUND_EXCEEDED;
     }
 
-    queueHead->currentSize++;
-    queueHead->lifetimeSize++;
-
-    PltUnlockMutex(&queueHead->mutex);
+    PltAtomicAdd(&queueHead->lifetimeSize, 1);
 
-    if (wasEmpty) {
-        // Only call PltSignalConditionVariable() when transitioning from
-        // empty -> non-empty to avoid a useless syscall for each new entry.
-        PltSignalConditionVariable(&queueHead->cond);
+    // Only wake the consumer if it is waiting, to avoid a useless syscall for each new entry
+    if (PltAtomicLoad(&queueHead->waiters) != 0) {
+        wakeWaiter(queueHead);
     }
 
     return LBQ_SUCCESS;
 }
 
-// This must be synchronized with LbqFlushQueueItems by the caller
+// This must be synchronized with LbqFlushQueueItems and LbqPollQueueElement by the caller
 int LbqPeekQueueElement(PLINKED_BLOCKING_QUEUE queueHead, void** data) {
-    PltLockMutex(&queueHead->mutex);
+    int position;
+    PLINKED_BLOCKING_QUEUE_CELL cell;
 
-    if (queueHead->shutdown) {
-        PltUnlockMutex(&queueHead->mutex);
+    if (PltAtomicLoad(&queueHead->shutdown)) {
         return LBQ_INTERRUPTED;
     }
 
-    if (queueHead->head == NULL) {
-        if (queueHead->draining) {
-            PltUnlockMutex(&queueHead->mutex);
-            return LBQ_INTERRUPTED;
-        }
-        else {
-            PltUnlockMutex(&queueHead->mutex);
-            return LBQ_NO_ELEMENT;
-        }
+    position = PltAtomicLoad(&queueHead->dequeuePosition);
+    cell = &queueHead->cells[position & queueHead->cellMask];
+    if (PltAtomicLoad(&cell->sequence) != (int)((unsigned int)position + 1)) {
+        return PltAtomicLoad(&queueHead->draining) ? LBQ_INTERRUPTED : LBQ_NO_ELEMENT;
     }
 
-    *data = queueHead->head->data;
-
-    PltUnlockMutex(&queueHead->mutex);
+    *data = cell->entry->data;
 
     return LBQ_SUCCESS;
 }
@@ -160,90 +244,63 @@ int LbqPeekQueueElement(PLINKED_BLOCKING_QUEUE queueHead, void** data) {
 int LbqPollQueueElement(PLINKED_BLOCKING_QUEUE queueHead, void** data) {
     PLINKED_BLOCKING_QUEUE_ENTRY entry;
 
-    PltLockMutex(&queueHead->mutex);
-
-    if (queueHead->shutdown) {
-        PltUnlockMutex(&queueHead->mutex);
+    if (PltAtomicLoad(&queueHead->shutdown)) {
         return LBQ_INTERRUPTED;
     }
 
-    if (queueHead->head == NULL) {
-        if (queueHead->draining) {
-            PltUnlockMutex(&queueHead->mutex);
-            return LBQ_INTERRUPTED;
-        }
-        else {
-            PltUnlockMutex(&queueHead->mutex);
-            return LBQ_NO_ELEMENT;
-        }
-    }
-
-    entry = queueHead->head;
-    queueHead->head = entry->flink;
-    queueHead->currentSize--;
-    if (queueHead->head == NULL) {
-        LC_ASSERT(queueHead->currentSize == 0);
-        queueHead->tail = NULL;
-    }
-    else {
-        LC_ASSERT(queueHead->currentSize != 0);
-        queueHead->head->blink = NULL;
+    entry = dequeueEntry(queueHead);
+    if (entry == NULL) {
+        return PltAtomicLoad(&queueHead->draining) ? LBQ_INTERRUPTED : LBQ_NO_ELEMENT;
     }
 
     *data = entry->data;
 
-    PltUnlockMutex(&queueHead->mutex);
-
     return LBQ_SUCCESS;
 }
 
 int LbqWaitForQueueElement(PLINKED_BLOCKING_QUEUE queueHead, void** data) {
     PLINKED_BLOCKING_QUEUE_ENTRY entry;
 
-    PltLockMutex(&queueHead->mutex);
-
-    // Wait for a waking condition: either data available or rundown
-    while (queueHead->head == NULL && !queueHead->draining && !queueHead->shutdown && !queueHead->pendingUserWake) {
-        PltWaitForConditionVariable(&queueHead->cond, &queueHead->mutex);
-    }
+    for (;;) {
+        // If we're shutting down, abort immediately, even if there's data available
+        if (PltAtomicLoad(&queueHead->shutdown)) {
+            return LBQ_INTERRUPTED;
+        }
 
-    // If we're shutting down, abort immediately, even if there's data available
-    if (queueHead->shutdown) {
-        PltUnlockMutex(&queueHead->mutex);
-        return LBQ_INTERRUPTED;
-    }
+        // If this is a user requested wake, process it now
+        if (PltAtomicLoad(&queueHead->pendingUserWake)) {
+            PltAtomicStore(&queueHead->pendingUserWake, false);
+            return LBQ_USER_WAKE;
+        }
 
-    // If this is a user requested wake, process it now
-    if (queueHead->pendingUserWake) {
-        queueHead->pendingUserWake = false;
-        PltUnlockMutex(&queueHead->mutex);
-        return LBQ_USER_WAKE;
-    }
+        entry = dequeueEntry(queueHead);
+        if (entry != NULL) {
+            *data = entry->data;
+            return LBQ_SUCCESS;
+        }
 
-    // If we're draining, only abort if we have no data available
-    if (queueHead->draining && queueHead->head == NULL) {
-        PltUnlockMutex(&queueHead->mutex);
-        return LBQ_INTERRUPTED;
-    }
+        // If we're draining, only abort if we have no data available
+        if (PltAtomicLoad(&queueHead->draining)) {
+            if (isQueueEmpty(queueHead)) {
+                return LBQ_INTERRUPTED;
+            }
 
-    // We should have bailed by this point if there was no data
-    LC_ASSERT(queueHead->head != NULL);
+            // A producer is still publishing an entry
+            continue;
+        }
 
-    entry = queueHead->head;
-    queueHead->head = entry->flink;
-    queueHead->currentSize--;
-    if (queueHead->head == NULL) {
-        LC_ASSERT(queueHead->currentSize == 0);
-        queueHead->tail = NULL;
-    }
-    else {
-        LC_ASSERT(queueHead->currentSize != 0);
-        queueHead->head->blink = NULL;
+        // Wait for a waking condition: either data available or rundown. We announce
+        // ourselves before checking again, so a producer either sees us waiting or we
+        // see its entry.
+        PltLockMutex(&queueHead->mutex);
+        PltAtomicAdd(&queueHead->waiters, 1);
+        if (isQueueEmpty(queueHead) &&
+                !PltAtomicLoad(&queueHead->draining) &&
+                !PltAtomicLoad(&queueHead->shutdown) &&
+                !PltAtomicLoad(&queueHead->pendingUserWake)) {
+            PltWaitForConditionVariable(&queueHead->cond, &queueHead->mutex);
+        }
+        PltAtomicAdd(&queueHead->waiters, -1);
+        PltUnlockMutex(&queueHead->mutex);
     }
-
-    *data = entry->data;
-
-    PltUnlockMutex(&queueHead->mutex);
-
-    return LBQ_SUCCESS;
 }
@@ -15,17 +15,28 @@ typedef struct _LINKED_BLOCKING_QUEUE_ENTRY {
     void* data;
 } LINKED_BLOCKING_QUEUE_ENTRY, *PLINKED_BLOCKING_QUEUE_ENTRY;
 
+typedef struct _LINKED_BLOCKING_QUEUE_CELL {
+    PLT_ATOMIC_INT sequence;
+    PLINKED_BLOCKING_QUEUE_ENTRY entry;
+} LINKED_BLOCKING_QUEUE_CELL, *PLINKED_BLOCKING_QUEUE_CELL;
+
+// Producers and consumers exchange entries through a bounded ring of cells
+// without taking any lock. The mutex and condition variable are only used
+// to put an idle consumer to sleep in LbqWaitForQueueElement() and wake it.
 typedef struct _LINKED_BLOCKING_QUEUE {
     PLT_MUTEX mutex;
     PLT_COND cond;
-    PLINKED_BLOCKING_QUEUE_ENTRY head;
-    PLINKED_BLOCKING_QUEUE_ENTRY tail;
+    PLINKED_BLOCKING_QUEUE_CELL cells;
+    int cellMask;
+    PLT_ATOMIC_INT enqueuePosition;
+    PLT_ATOMIC_INT dequeuePosition;
     int sizeBound;
-    int currentSize;
-    int lifetimeSize;
-    bool shutdown;
-    bool draining;
-    bool pendingUserWake;
+    PLT_ATOMIC_INT currentSize;
+    PLT_ATOMIC_INT lifetimeSize;
+    PLT_ATOMIC_INT waiters;
+    PLT_ATOMIC_INT shutdown;
+    PLT_ATOMIC_INT draining;
+    PLT_ATOMIC_INT pendingUserWake;
 } LINKED_BLOCKING_QUEUE, *PLINKED_BLOCKING_QUEUE;
 
 int LbqInitializeLinkedBlockingQueue(PLINKED_BLOCKING_QUEUE queueHead, int sizeBound);
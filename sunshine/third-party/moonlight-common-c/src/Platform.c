@@ -3,6 +3,9 @@
 #if defined(__vita__)
 #include <pthread.h>
 #include <psp2/kernel/processmgr.h>
+#elif defined(__linux__)
+#include <sched.h>
+#include <sys/resource.h>
 #endif
 
 // The maximum amount of time before observing an interrupt
@@ -13,6 +16,7 @@ struct thread_context {
     ThreadEntry entry;
     void* context;
     const char* name;
+    int role;
 };
 
 static int activeThreads = 0;
@@ -66,6 +70,126 @@ void setThreadNameWin32(const char* name) {
 #endif
 }
 
+#ifdef LC_WINDOWS_DESKTOP
+typedef HANDLE (WINAPI *AvSetMmThreadCharacteristicsW_t)(LPCWSTR, LPDWORD);
+typedef BOOL (WINAPI *AvRevertMmThreadCharacteristics_t)(HANDLE);
+#endif
+
+#endif
+
+static uint64_t getThreadRoleAffinityMask(int role) {
+    switch (role) {
+    case PLT_THREAD_ROLE_RECEIVE:
+        return StreamConfig.receiveThreadAffinityMask;
+    case PLT_THREAD_ROLE_AUDIO:
+    case PLT_THREAD_ROLE_VIDEO:
+        return StreamConfig.decodeThreadAffinityMask;
+    default:
+        return 0;
+    }
+}
+
+// Applies the scheduling hint of the role to the calling thread. Raising the
+// priority may need privileges the client doesn't have, so failures only cost
+// the thread its boost. On Windows, this returns the MMCSS task handle to revert.
+static void* setThreadRole(const char* name, int role) {
+    uint64_t affinityMask = getThreadRoleAffinityMask(role);
+    void* mmcssHandle = NULL;
+
+#if defined(LC_WINDOWS)
+    int priority = THREAD_PRIORITY_NORMAL;
+
+    switch (role) {
+    case PLT_THREAD_ROLE_RECEIVE:
+        priority = THREAD_PRIORITY_HIGHEST;
+        break;
+    case PLT_THREAD_ROLE_AUDIO:
+#ifdef LC_WINDOWS_DESKTOP
+        {
+            // MMCSS boosts registered audio threads above everything else in the session
+            HMODULE avrt = LoadLibraryA("avrt.dll");
+            if (avrt != NULL) {
+                AvSetMmThreadCharacteristicsW_t avSetMmThreadCharacteristicsFunc =
+                        (AvSetMmThreadCharacteristicsW_t)GetProcAddress(avrt, "AvSetMmThreadCharacteristicsW");
+                DWORD taskIndex = 0;
+
+                if (avSetMmThreadCharacteristicsFunc != NULL) {
+                    mmcssHandle = avSetMmThreadCharacteristicsFunc(L"Pro Audio", &taskIndex);
+                }
+            }
+        }
+#endif
+        priority = THREAD_PRIORITY_HIGHEST;
+        break;
+    case PLT_THREAD_ROLE_VIDEO:
+    case PLT_THREAD_ROLE_CONTROL:
+        priority = THREAD_PRIORITY_ABOVE_NORMAL;
+        break;
+    }
+
+    if (priority != THREAD_PRIORITY_NORMAL && !SetThreadPriority(GetCurrentThread(), priority)) {
+        Limelog("Unable to raise the priority of thread %s: %lu\n", name, GetLastError());
+    }
+
+#ifdef LC_WINDOWS_DESKTOP
+    if (affinityMask != 0 && SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)affinityMask) == 0) {
+        Limelog("Unable to set the affinity of thread %s: %lu\n", name, GetLastError());
+    }
+#endif
+#elif defined(LC_DARWIN)
+    // There are no affinity controls on Darwin, but QoS classes give
+    // the threads priority over background work
+    if (role != PLT_THREAD_ROLE_DEFAULT) {
+        pthread_set_qos_class_self_np(QOS_CLASS_USER_INTERACTIVE, 0);
+    }
+    (void)affinityMask;
+#elif defined(__linux__)
+    if (role == PLT_THREAD_ROLE_RECEIVE || role == PLT_THREAD_ROLE_AUDIO) {
+        // These threads spend most of their time blocked on a socket or queue,
+        // so the lowest real-time priority doesn't risk starving the system.
+        struct sched_param param;
+
+        param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+        if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0) {
+            // Fall back to a better nice value, which RLIMIT_NICE may allow.
+            // The nice value is per-thread on Linux.
+            if (setpriority(PRIO_PROCESS, 0, -10) != 0) {
+                Limelog("Unable to raise the priority of thread %s: %d\n", name, errno);
+            }
+        }
+    }
+    else if (role == PLT_THREAD_ROLE_VIDEO || role == PLT_THREAD_ROLE_CONTROL) {
+        // Decoding may be CPU bound, so it only gets a better nice value
+        if (setpriority(PRIO_PROCESS, 0, -5) != 0) {
+            Limelog("Unable to raise the priority of thread %s: %d\n", name, errno);
+        }
+    }
+
+    if (affinityMask != 0) {
+        cpu_set_t cpuSet;
+        int i;
+
+        CPU_ZERO(&cpuSet);
+        for (i = 0; i < 64 && i < CPU_SETSIZE; i++) {
+            if (affinityMask & (1ULL << i)) {
+                CPU_SET(i, &cpuSet);
+            }
+        }
+
+        if (sched_setaffinity(0, sizeof(cpuSet), &cpuSet) != 0) {
+            Limelog("Unable to set the affinity of thread %s: %d\n", name, errno);
+        }
+    }
+#else
+    (void)name;
+    (void)role;
+    (void)affinityMask;
+#endif
+
+    return mmcssHandle;
+}
+
+#if defined(LC_WINDOWS)
 DWORD WINAPI ThreadProc(LPVOID lpParameter) {
     struct thread_context* ctx = (struct thread_context*)lpParameter;
 #elif defined(__WIIU__)
@@ -84,8 +208,22 @@ void* ThreadProc(void* context) {
     pthread_setname_np(ctx->name);
 #endif
 
+    void* mmcssHandle = setThreadRole(ctx->name, ctx->role);
+
     ctx->entry(ctx->context);
 
+#ifdef LC_WINDOWS_DESKTOP
+    if (mmcssHandle != NULL) {
+        AvRevertMmThreadCharacteristics_t avRevertMmThreadCharacteristicsFunc =
+                (AvRevertMmThreadCharacteristics_t)GetProcAddress(GetModuleHandleA("avrt.dll"), "AvRevertMmThreadCharacteristics");
+        if (avRevertMmThreadCharacteristicsFunc != NULL) {
+            avRevertMmThreadCharacteristicsFunc(mmcssHandle);
+        }
+    }
+#else
+    (void)mmcssHandle;
+#endif
+
 #if defined(__vita__)
 free(ctx);
 #endif
@@ -117,6 +255,20 @@ void PltSleepMsInterruptible(PLT_THREAD* thread, int ms) {
     }
 }
 
+// Returns the number of online CPUs, or 1 if it can't be determined
+int PltGetProcessorCount(void) {
+#if defined(LC_WINDOWS)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+#elif defined(_SC_NPROCESSORS_ONLN)
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+#else
+    return 1;
+#endif
+}
+
 int PltCreateMutex(PLT_MUTEX* mutex) {
 #if defined(LC_WINDOWS)
     InitializeSRWLock(mutex);
@@ -218,7 +370,7 @@ static void thread_deallocator(OSThread *thread, void *stack) {
 }
 #endif
 
-int PltCreateThread(const char* name, ThreadEntry entry, void* context, PLT_THREAD* thread) {
+int PltCreateThread(const char* name, int role, ThreadEntry entry, void* context, PLT_THREAD* thread) {
     struct thread_context* ctx;
 
     ctx = (struct thread_context*)malloc(sizeof(*ctx));
@@ -229,6 +381,7 @@ int PltCreateThread(const char* name, ThreadEntry entry, void* context, PLT_THRE
     ctx->entry = entry;
     ctx->context = context;
     ctx->name = name;
+    ctx->role = role;
 
     thread->cancelled = false;
 
@@ -617,6 +770,12 @@ int initializePlatform(void) {
         return err;
     }
 
+    err = SchedStart();
+    if (err != 0) {
+        enet_deinitialize();
+        return err;
+    }
+
     enterLowLatencyMode();
 
     return 0;
@@ -625,6 +784,8 @@ int initializePlatform(void) {
 void cleanupPlatform(void) {
     exitLowLatencyMode();
 
+    SchedStop();
+
     cleanupPlatformSockets();
 
     enet_deinitialize();
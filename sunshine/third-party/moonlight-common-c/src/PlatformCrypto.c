@@ -14,10 +14,17 @@ bool RandomStateInitialized = false;
 #endif
 
 #else
+#include <openssl/crypto.h>
 #include <openssl/evp.h>
 #include <openssl/rand.h>
 #endif
 
+// Roughly the size of a video packet
+#define CRYPTO_BENCHMARK_MESSAGE_SIZE 1392
+#define CRYPTO_BENCHMARK_DURATION_MS 20
+
+static CRYPTO_BACKEND_STATS cryptoBackendStats;
+
 static int addPkcs7PaddingInPlace(unsigned char* plaintext, int plaintextLen) {
     int paddedLength = ROUND_TO_PKCS7_PADDED_LEN(plaintextLen);
     unsigned char paddingByte = (unsigned char)(16 - (plaintextLen % 16));
@@ -232,6 +239,7 @@ bool PltEncryptMessage(PPLT_CRYPTO_CONTEXT ctx, int algorithm, int flags,
 // at least ROUND_TO_PKCS7_PADDED_LEN(inputDataLength) to allow room for PKCS7 padding.
 // For GCM, the IV can change from message to message without CIPHER_FLAG_RESET_IV.
 // CIPHER_FLAG_RESET_IV is only required for GCM when the IV length changes.
+// For GCM, outputData may be the same buffer as inputData to decrypt in place.
 // Changing the key between encrypt/decrypt calls on a single context is not supported.
 bool PltDecryptMessage(PPLT_CRYPTO_CONTEXT ctx, int algorithm, int flags,
                        unsigned char* key, int keyLength,
@@ -271,7 +279,35 @@ bool PltDecryptMessage(PPLT_CRYPTO_CONTEXT ctx, int algorithm, int flags,
         ctx->initialized = true;
     }
 
-    if (tag != NULL) {
+    if (tag != NULL && inputData == outputData) {
+        size_t finishLength;
+
+        // The auth_decrypt APIs can't work in place with the tag before the ciphertext,
+        // so run the cipher in place and check the tag separately.
+        if (mbedtls_cipher_set_iv(&ctx->ctx, iv, ivLength) != 0) {
+            return false;
+        }
+
+        mbedtls_cipher_reset(&ctx->ctx);
+
+        if (mbedtls_cipher_update_ad(&ctx->ctx, NULL, 0) != 0) {
+            return false;
+        }
+
+        if (mbedtls_cipher_update(&ctx->ctx, inputData, inputDataLength, outputData, &outLength) != 0) {
+            return false;
+        }
+
+        if (mbedtls_cipher_finish(&ctx->ctx, &outputData[outLength], &finishLength) != 0) {
+            return false;
+        }
+        outLength += finishLength;
+
+        if (mbedtls_cipher_check_tag(&ctx->ctx, tag, tagLength) != 0) {
+            return false;
+        }
+    }
+    else if (tag != NULL) {
 #ifdef USE_MBEDTLS_CRYPTO_EXT
         // We only support 16 bytes sized tag
         LC_ASSERT(tagLength == 16);
@@ -447,6 +483,105 @@ void PltDestroyCryptoContext(PPLT_CRYPTO_CONTEXT ctx) {
     free(ctx);
 }
 
+static const char* getCryptoBackendName(void) {
+#ifdef USE_MBEDTLS
+    return "mbedTLS " MBEDTLS_VERSION_STRING;
+#elif OPENSSL_VERSION_NUMBER >= 0x10100000L
+    return OpenSSL_version(OPENSSL_VERSION);
+#else
+    return SSLeay_version(SSLEAY_VERSION);
+#endif
+}
+
+const CRYPTO_BACKEND_STATS* LiGetCryptoBackendStats(void) {
+    if (cryptoBackendStats.backendName == NULL) {
+        cryptoBackendStats.backendName = getCryptoBackendName();
+    }
+
+    return &cryptoBackendStats;
+}
+
+// Measures how fast video packets can be decrypted, the same way the video stream does it.
+// The crypto library picks its fastest implementation (AES-NI, VAES, ARMv8 Crypto, ...) on
+// its own, so this mostly tells whether video decryption can keep up with the bitrate.
+void PltMeasureCryptoThroughput(void) {
+    PPLT_CRYPTO_CONTEXT encryptionCtx, decryptionCtx;
+    unsigned char key[16], iv[12];
+    unsigned char plaintext[CRYPTO_BENCHMARK_MESSAGE_SIZE];
+    unsigned char ciphertext[16 + CRYPTO_BENCHMARK_MESSAGE_SIZE];
+    unsigned char message[16 + CRYPTO_BENCHMARK_MESSAGE_SIZE];
+    uint64_t startTimeMs, elapsedMs;
+    uint64_t bytesDecrypted;
+    int length;
+
+    LiGetCryptoBackendStats();
+    if (cryptoBackendStats.gcmDecryptThroughputMBps != 0) {
+        // Already measured
+        return;
+    }
+
+    encryptionCtx = PltCreateCryptoContext();
+    decryptionCtx = PltCreateCryptoContext();
+    if (encryptionCtx == NULL || decryptionCtx == NULL) {
+        goto Exit;
+    }
+
+    PltGenerateRandomData(key, sizeof(key));
+    PltGenerateRandomData(iv, sizeof(iv));
+    memset(plaintext, 0x5A, sizeof(plaintext));
+
+    // The tag comes first, like in the encrypted video header
+    if (!PltEncryptMessage(encryptionCtx, ALGORITHM_AES_GCM, 0,
+                           key, sizeof(key),
+                           iv, sizeof(iv),
+                           ciphertext, 16,
+                           plaintext, sizeof(plaintext),
+                           &ciphertext[16], &length)) {
+        goto Exit;
+    }
+
+    bytesDecrypted = 0;
+    startTimeMs = PltGetMillis();
+    do {
+        int i;
+
+        for (i = 0; i < 64; i++) {
+            // Decryption happens in place, so start again from the ciphertext
+            memcpy(message, ciphertext, sizeof(message));
+            if (!PltDecryptMessage(decryptionCtx, ALGORITHM_AES_GCM, 0,
+                                   key, sizeof(key),
+                                   iv, sizeof(iv),
+                                   message, 16,
+                                   &message[16], CRYPTO_BENCHMARK_MESSAGE_SIZE,
+                                   &message[16], &length)) {
+                Limelog("Crypto benchmark failed to decrypt its own message!\n");
+                LC_ASSERT(false);
+                goto Exit;
+            }
+        }
+
+        bytesDecrypted += 64 * CRYPTO_BENCHMARK_MESSAGE_SIZE;
+        elapsedMs = PltGetMillis() - startTimeMs;
+    } while (elapsedMs < CRYPTO_BENCHMARK_DURATION_MS);
+
+    cryptoBackendStats.gcmDecryptThroughputMBps = (uint32_t)(bytesDecrypted / (elapsedMs * 1000));
+    Limelog("Crypto backend: %s (AES-128-GCM decryption: %u MB/s)\n",
+            cryptoBackendStats.backendName, cryptoBackendStats.gcmDecryptThroughputMBps);
+
+    // Leave some headroom for the rest of the receive path
+    if (cryptoBackendStats.gcmDecryptThroughputMBps < (uint32_t)StreamConfig.bitrate / 8000 * 2) {
+        Limelog("WARNING: Video decryption may not keep up with a bitrate of %d Kbps\n", StreamConfig.bitrate);
+    }
+
+Exit:
+    if (encryptionCtx != NULL) {
+        PltDestroyCryptoContext(encryptionCtx);
+    }
+    if (decryptionCtx != NULL) {
+        PltDestroyCryptoContext(decryptionCtx);
+    }
+}
+
 void PltGenerateRandomData(unsigned char* data, int length) {
 #ifdef USE_MBEDTLS
     // FIXME: This is not thread safe...
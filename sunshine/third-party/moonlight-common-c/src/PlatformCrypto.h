@@ -46,3 +46,5 @@ bool PltDecryptMessage(PPLT_CRYPTO_CONTEXT ctx, int algorithm, int flags,
                        unsigned char* outputData, int* outputDataLength);
 
 void PltGenerateRandomData(unsigned char* data, int length);
+
+void PltMeasureCryptoThroughput(void);
@@ -1,7 +1,22 @@
+// Needed for recvmmsg()
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
 #include "Limelight-internal.h"
 
 #define TEST_PORT_TIMEOUT_SEC 3
 
+// RFC 8305 recommends 250 ms between the starts of connection attempts
+#define HAPPY_EYEBALLS_ATTEMPT_DELAY_MS 250
+#define HAPPY_EYEBALLS_MAX_ATTEMPTS 8
+
+// Each slot holds the hash of a host name with the address family that
+// last won the connection race to it, see getPreferredFamily()
+#define FAMILY_CACHE_SIZE 8
+#define FAMILY_CACHE_V4 1
+#define FAMILY_CACHE_V6 2
+
 #define RCV_BUFFER_SIZE_MIN  32767
 #define RCV_BUFFER_SIZE_STEP 16384
 
@@ -12,6 +27,10 @@
 #endif
 #define TCPv6_MSS 1220
 
+#if defined(__linux__) && defined(MSG_WAITFORONE)
+#define LC_UDP_RECVMMSG
+#endif
+
 #if defined(LC_WINDOWS)
 
 #ifndef SIO_UDP_CONNRESET
@@ -92,6 +111,16 @@ int setNonFatalRecvTimeoutMs(SOCKET s, int timeoutMs) {
 #endif
 }
 
+int enableUdpReceiveTimestamps(SOCKET s) {
+#if defined(LC_UDP_RECVMMSG) && defined(SO_TIMESTAMPNS)
+    int val = 1;
+
+    return setsockopt(s, SOL_SOCKET, SO_TIMESTAMPNS, (char*)&val, sizeof(val));
+#else
+    return -1;
+#endif
+}
+
 int pollSockets(struct pollfd* pollFds, int pollFdsCount, int timeoutMs) {
 #if defined(LC_WINDOWS)
     // We could have used WSAPoll() but it has some nasty bugs
@@ -178,6 +207,19 @@ bool isSocketReadable(SOCKET s) {
     return true;
 }
 
+static bool isRecvTimeoutError(int err) {
+    return err == EWOULDBLOCK ||
+           err == EINTR ||
+           err == EAGAIN ||
+#if defined(LC_WINDOWS)
+           // This error is specific to overlapped I/O which isn't even
+           // possible to perform with recvfrom(). It seems to randomly
+           // be returned instead of WSAETIMEDOUT on certain systems.
+           err == WSA_IO_PENDING ||
+#endif
+           err == ETIMEDOUT;
+}
+
 int recvUdpSocket(SOCKET s, char* buffer, int size, bool useSelect) {
     int err;
 
@@ -202,17 +244,7 @@ int recvUdpSocket(SOCKET s, char* buffer, int size, bool useSelect) {
             // socket via SO_RCVTIMEO, so we can avoid a syscall
             // for each packet.
             err = (int)recvfrom(s, buffer, size, 0, NULL, NULL);
-            if (err < 0 &&
-                    (LastSocketError() == EWOULDBLOCK ||
-                     LastSocketError() == EINTR ||
-                     LastSocketError() == EAGAIN ||
-         #if defined(LC_WINDOWS)
-                     // This error is specific to overlapped I/O which isn't even
-                     // possible to perform with recvfrom(). It seems to randomly
-                     // be returned instead of WSAETIMEDOUT on certain systems.
-                     LastSocketError() == WSA_IO_PENDING ||
-         #endif
-                     LastSocketError() == ETIMEDOUT)) {
+            if (err < 0 && isRecvTimeoutError(LastSocketError())) {
                 // Return 0 for timeout
                 return 0;
             }
@@ -230,6 +262,122 @@ int recvUdpSocket(SOCKET s, char* buffer, int size, bool useSelect) {
     return err;
 }
 
+int recvUdpSocketBatch(SOCKET s, char** buffers, int* lengths, uint64_t* receiveTimesUs, int size, int count, bool useSelect) {
+#if defined(LC_UDP_RECVMMSG)
+    struct mmsghdr msgs[UDP_RECV_BATCH_MAX];
+    struct iovec iovs[UDP_RECV_BATCH_MAX];
+#if defined(SO_TIMESTAMPNS)
+    char controls[UDP_RECV_BATCH_MAX][CMSG_SPACE(sizeof(struct timespec))];
+    struct timespec realNow;
+#endif
+    uint64_t now;
+    int err, i;
+
+    LC_ASSERT(count > 0);
+    if (count > UDP_RECV_BATCH_MAX) {
+        count = UDP_RECV_BATCH_MAX;
+    }
+
+    do {
+        // The control buffer lengths are overwritten by each call
+        memset(msgs, 0, sizeof(msgs[0]) * count);
+        for (i = 0; i < count; i++) {
+            iovs[i].iov_base = buffers[i];
+            iovs[i].iov_len = size;
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+#if defined(SO_TIMESTAMPNS)
+            if (receiveTimesUs != NULL) {
+                msgs[i].msg_hdr.msg_control = controls[i];
+                msgs[i].msg_hdr.msg_controllen = sizeof(controls[i]);
+            }
+#endif
+        }
+
+        if (useSelect) {
+            struct pollfd pfd;
+
+            // Wait up to 100 ms for the socket to be readable
+            pfd.fd = s;
+            pfd.events = POLLIN;
+            err = pollSockets(&pfd, 1, UDP_RECV_POLL_TIMEOUT_MS);
+            if (err <= 0) {
+                // Return if an error or timeout occurs
+                return err;
+            }
+        }
+
+        // MSG_WAITFORONE only waits (up to the SO_RCVTIMEO timeout, if set)
+        // for the first datagram, then returns whatever else is already
+        // queued on the socket without blocking.
+        err = recvmmsg(s, msgs, count, MSG_WAITFORONE, NULL);
+        if (err < 0 && !useSelect && isRecvTimeoutError(LastSocketError())) {
+            // Return 0 for timeout
+            return 0;
+        }
+
+    // Ignore errors from previous ICMP Port Unreachable messages, like recvUdpSocket()
+    } while (err < 0 && LastSocketError() == ECONNREFUSED);
+
+    if (err <= 0) {
+        return err;
+    }
+
+    now = PltGetMicroseconds();
+#if defined(SO_TIMESTAMPNS)
+    if (receiveTimesUs != NULL) {
+        clock_gettime(CLOCK_REALTIME, &realNow);
+    }
+#endif
+
+    for (i = 0; i < err; i++) {
+        lengths[i] = (int)msgs[i].msg_len;
+
+        if (receiveTimesUs != NULL) {
+            receiveTimesUs[i] = now;
+
+#if defined(SO_TIMESTAMPNS)
+            // The kernel timestamps are on the realtime clock, so convert them using
+            // how long ago they were taken rather than their absolute value
+            for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msgs[i].msg_hdr); cmsg != NULL; cmsg = CMSG_NXTHDR(&msgs[i].msg_hdr, cmsg)) {
+                if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+                    struct timespec ts;
+                    int64_t ageUs;
+
+                    memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+                    ageUs = ((int64_t)realNow.tv_sec - ts.tv_sec) * 1000000 + (realNow.tv_nsec - ts.tv_nsec) / 1000;
+
+                    // Ignore timestamps skewed by a realtime clock adjustment
+                    if (ageUs >= 0 && (uint64_t)ageUs < now) {
+                        receiveTimesUs[i] = now - (uint64_t)ageUs;
+                    }
+                    break;
+                }
+            }
+#endif
+        }
+    }
+
+    return err;
+#else
+    int err;
+
+    LC_ASSERT(count > 0);
+
+    // No batched receive on this platform, so return one datagram per call
+    err = recvUdpSocket(s, buffers[0], size, useSelect);
+    if (err <= 0) {
+        return err;
+    }
+
+    lengths[0] = err;
+    if (receiveTimesUs != NULL) {
+        receiveTimesUs[0] = PltGetMicroseconds();
+    }
+    return 1;
+#endif
+}
+
 void closeSocket(SOCKET s) {
 #if defined(LC_WINDOWS)
     closesocket(s);
@@ -238,6 +386,51 @@ void closeSocket(SOCKET s) {
 #endif
 }
 
+// DSCP code points for the traffic classes (RFC 4594)
+#define DSCP_EF   46
+#define DSCP_AF41 34
+
+// DSCP marking is visible to the network, and some routers and ISPs drop or mangle
+// marked traffic, so it is only applied when the host is on the local network.
+static void setSocketDscp(SOCKET s, int addressFamily, int socketQosType) {
+#if !defined(LC_WINDOWS) && defined(IP_TOS)
+    int tos;
+
+    // Windows ignores IP_TOS without a qWAVE flow or a QoS policy
+    if (StreamConfig.streamingRemotely != STREAM_CFG_LOCAL) {
+        return;
+    }
+
+    switch (socketQosType) {
+    case SOCK_QOS_TYPE_AUDIO:
+        tos = DSCP_EF << 2;
+        break;
+    case SOCK_QOS_TYPE_VIDEO:
+        tos = DSCP_AF41 << 2;
+        break;
+    default:
+        return;
+    }
+
+#if defined(AF_INET6) && defined(IPV6_TCLASS)
+    if (addressFamily == AF_INET6) {
+        if (setsockopt(s, IPPROTO_IPV6, IPV6_TCLASS, (char*)&tos, sizeof(tos)) < 0) {
+            Limelog("setsockopt(IPV6_TCLASS, %d) failed: %d\n", tos, (int)LastSocketError());
+            return;
+        }
+    }
+    else
+#endif
+    if (setsockopt(s, IPPROTO_IP, IP_TOS, (char*)&tos, sizeof(tos)) < 0) {
+        Limelog("setsockopt(IP_TOS, %d) failed: %d\n", tos, (int)LastSocketError());
+        return;
+    }
+
+    Limelog("Marking %s traffic with DSCP %d\n",
+            socketQosType == SOCK_QOS_TYPE_AUDIO ? "audio" : "video", tos >> 2);
+#endif
+}
+
 // These set "safe" host or link-local QoS options that we can unconditionally
 // set without having to worry about routers blockholing the traffic.
 static void setSocketQos(SOCKET s, int socketQosType) {
@@ -355,8 +548,41 @@ SOCKET bindUdpSocket(int addressFamily, struct sockaddr_storage* localAddr, SOCK
     // Enable QOS for the socket (best effort)
     if (socketQosType != SOCK_QOS_TYPE_BEST_EFFORT) {
         setSocketQos(s, socketQosType);
+        setSocketDscp(s, addressFamily, socketQosType);
     }
 
+    setSocketRecvBufferSize(s, bufferSize);
+
+    return s;
+}
+
+// Find the local address that traffic to dstaddr will be sent from, without
+// sending anything. Connecting a UDP socket only performs the route lookup.
+int getLocalAddressForRemote(struct sockaddr_storage* dstaddr, SOCKADDR_LEN addrlen, struct sockaddr_storage* localAddr) {
+    SOCKET s;
+    SOCKADDR_LEN localAddrLen;
+    int err;
+
+    s = createSocket(dstaddr->ss_family, SOCK_DGRAM, IPPROTO_UDP, false);
+    if (s == INVALID_SOCKET) {
+        return LastSocketFail();
+    }
+
+    err = 0;
+    localAddrLen = (SOCKADDR_LEN)sizeof(*localAddr);
+    if (connect(s, (struct sockaddr*)dstaddr, addrlen) < 0 ||
+            getsockname(s, (struct sockaddr*)localAddr, &localAddrLen) < 0) {
+        err = LastSocketFail();
+        memset(localAddr, 0, sizeof(*localAddr));
+    }
+
+    closeSocket(s);
+    return err;
+}
+
+void setSocketRecvBufferSize(SOCKET s, int bufferSize) {
+    int err;
+
 #ifdef __3DS__
     if (bufferSize == 0 || bufferSize > n3ds_max_buf_size)
         bufferSize = n3ds_max_buf_size;
@@ -385,24 +611,20 @@ SOCKET bindUdpSocket(int addressFamily, struct sockaddr_storage* localAddr, SOCK
             }
         }
 
-#if defined(LC_DEBUG)
         if (err == 0) {
-            Limelog("Selected receive buffer size: %d\n", bufferSize);
-        }
-        else {
-            Limelog("Unable to set receive buffer size: %d\n", LastSocketError());
-        }
-
-        {
             SOCKADDR_LEN len = sizeof(bufferSize);
+            int requestedSize = bufferSize;
+
+            // Linux doubles the requested value and other OSes may clamp it, so log
+            // what we actually got since it bounds the burst we can absorb
             if (getsockopt(s, SOL_SOCKET, SO_RCVBUF, (char*)&bufferSize, &len) == 0) {
-                Limelog("Actual receive buffer size: %d\n", bufferSize);
+                Limelog("Receive buffer size: %d (requested %d)\n", bufferSize, requestedSize);
             }
         }
-#endif
+        else {
+            Limelog("Unable to set receive buffer size: %d\n", LastSocketError());
+        }
     }
-
-    return s;
 }
 
 int setSocketNonBlocking(SOCKET s, bool enabled) {
@@ -447,10 +669,11 @@ SOCKET createSocket(int addressFamily, int socketType, int protocol, bool nonBlo
     return s;
 }
 
-SOCKET connectTcpSocket(struct sockaddr_storage* dstaddr, SOCKADDR_LEN addrlen, unsigned short port, int timeoutSec) {
+// Creates a non-blocking TCP socket and starts connecting it to dstaddr. If the connection attempt
+// could not be started, INVALID_SOCKET is returned with the socket error set.
+static SOCKET startTcpConnect(struct sockaddr_storage* dstaddr, SOCKADDR_LEN addrlen, unsigned short port) {
     SOCKET s;
     LC_SOCKADDR addr;
-    struct pollfd pfd;
     int err;
     int val;
 
@@ -509,10 +732,50 @@ SOCKET connectTcpSocket(struct sockaddr_storage* dstaddr, SOCKADDR_LEN addrlen,
     if (err < 0) {
         err = (int)LastSocketError();
         if (err != EWOULDBLOCK && err != EAGAIN && err != EINPROGRESS) {
-            goto Exit;
+            Limelog("connect() failed: %d\n", err);
+            closeSocket(s);
+            SetLastSocketError(err);
+            return INVALID_SOCKET;
         }
     }
 
+    return s;
+}
+
+// Returns the result of a connection attempt started by startTcpConnect() once pollSockets() has signalled it
+static int getTcpConnectError(SOCKET s, struct pollfd* pfd) {
+    int err;
+
+#ifdef __3DS__ //SO_ERROR is unreliable on 3DS
+    char test_buffer[1];
+    err = (int)recv(s, test_buffer, 1, MSG_PEEK);
+    if (err < 0 &&
+        (LastSocketError() == EWOULDBLOCK ||
+        LastSocketError() == EAGAIN)) {
+        err = 0;
+    }
+#else
+    SOCKADDR_LEN len = sizeof(err);
+    getsockopt(s, SOL_SOCKET, SO_ERROR, (char*)&err, &len);
+    if (err != 0 || (pfd->revents & POLLERR)) {
+        // Get the error code
+        err = (err != 0) ? err : LastSocketFail();
+    }
+#endif
+
+    return err;
+}
+
+SOCKET connectTcpSocket(struct sockaddr_storage* dstaddr, SOCKADDR_LEN addrlen, unsigned short port, int timeoutSec) {
+    SOCKET s;
+    struct pollfd pfd;
+    int err;
+
+    s = startTcpConnect(dstaddr, addrlen, port);
+    if (s == INVALID_SOCKET) {
+        return INVALID_SOCKET;
+    }
+
     // Wait for the connection to complete or the timeout to elapse
     pfd.fd = s;
     pfd.events = POLLOUT;
@@ -532,32 +795,9 @@ SOCKET connectTcpSocket(struct sockaddr_storage* dstaddr, SOCKADDR_LEN addrlen,
         SetLastSocketError(ETIMEDOUT);
         return INVALID_SOCKET;
     }
-#ifdef __3DS__ //SO_ERROR is unreliable on 3DS
-    else {
-        char test_buffer[1];
-        err = (int)recv(s, test_buffer, 1, MSG_PEEK);
-        if (err < 0 &&
-            (LastSocketError() == EWOULDBLOCK ||
-            LastSocketError() == EAGAIN)) {
-            err = 0;
-        }
-    }
-#else
-    else {
-        // The socket was signalled
-        SOCKADDR_LEN len = sizeof(err);
-        getsockopt(s, SOL_SOCKET, SO_ERROR, (char*)&err, &len);
-        if (err != 0 || (pfd.revents & POLLERR)) {
-            // Get the error code
-            err = (err != 0) ? err : LastSocketFail();
-        }
-    }
-#endif
-
-    // Disable non-blocking I/O now that the connection is established
-    setSocketNonBlocking(s, false);
 
-Exit:
+    // The socket was signalled
+    err = getTcpConnectError(s, &pfd);
     if (err != 0) {
         Limelog("connect() failed: %d\n", err);
         closeSocket(s);
@@ -565,10 +805,118 @@ Exit:
         return INVALID_SOCKET;
     }
 
+    // Disable non-blocking I/O now that the connection is established
+    setSocketNonBlocking(s, false);
+
     return s;
 }
 
-// See TCP_MAXSEG note in connectTcpSocket() above for more information.
+SOCKET connectTcpSocketRace(struct sockaddr_storage* dstaddrs, SOCKADDR_LEN* addrlens, int count, unsigned short port, int timeoutSec, int* winner) {
+    SOCKET sockets[HAPPY_EYEBALLS_MAX_ATTEMPTS];
+    struct pollfd pfds[HAPPY_EYEBALLS_MAX_ATTEMPTS];
+    int indexes[HAPPY_EYEBALLS_MAX_ATTEMPTS];
+    int active = 0;
+    int next = 0;
+    int lastError = ETIMEDOUT;
+    uint64_t now, deadline, nextAttemptTime;
+    int i, err;
+
+    if (count > HAPPY_EYEBALLS_MAX_ATTEMPTS) {
+        count = HAPPY_EYEBALLS_MAX_ATTEMPTS;
+    }
+
+    // Every attempt gets at least timeoutSec to complete, even the last one to be started
+    now = PltGetMillis();
+    deadline = now + timeoutSec * 1000 + (count > 0 ? count - 1 : 0) * HAPPY_EYEBALLS_ATTEMPT_DELAY_MS;
+    nextAttemptTime = now;
+
+    for (;;) {
+        now = PltGetMillis();
+
+        // Start the next attempt once the previous one has had a head start, or immediately if
+        // there is nothing in flight (RFC 8305 section 5)
+        if (next < count && (active == 0 || now >= nextAttemptTime)) {
+            SOCKET s = startTcpConnect(&dstaddrs[next], addrlens[next], port);
+            if (s != INVALID_SOCKET) {
+                sockets[active] = s;
+                pfds[active].fd = s;
+                pfds[active].events = POLLOUT;
+                pfds[active].revents = 0;
+                indexes[active] = next;
+                active++;
+                nextAttemptTime = now + HAPPY_EYEBALLS_ATTEMPT_DELAY_MS;
+            }
+            else {
+                lastError = LastSocketError();
+            }
+            next++;
+            continue;
+        }
+
+        if (active == 0) {
+            // Every attempt failed
+            break;
+        }
+        else if (now >= deadline) {
+            Limelog("Connection timed out after %d seconds (TCP port %u)\n", timeoutSec, port);
+            lastError = ETIMEDOUT;
+            break;
+        }
+
+        // Wait until an attempt completes or it's time to start the next one
+        err = pollSockets(pfds, active,
+                          (int)((next < count && nextAttemptTime < deadline ? nextAttemptTime : deadline) - now));
+        if (err < 0) {
+            lastError = LastSocketError();
+            Limelog("pollSockets() failed: %d\n", lastError);
+            break;
+        }
+
+        for (i = 0; i < active;) {
+            if (pfds[i].revents == 0) {
+                i++;
+                continue;
+            }
+
+            err = getTcpConnectError(sockets[i], &pfds[i]);
+            if (err == 0) {
+                SOCKET s = sockets[i];
+
+                *winner = indexes[i];
+
+                // Abandon the attempts that lost the race
+                sockets[i] = sockets[--active];
+                while (active > 0) {
+                    closeSocket(sockets[--active]);
+                }
+
+                // Disable non-blocking I/O now that the connection is established
+                setSocketNonBlocking(s, false);
+                return s;
+            }
+
+            Limelog("connect() failed: %d\n", err);
+            closeSocket(sockets[i]);
+            lastError = err;
+
+            active--;
+            sockets[i] = sockets[active];
+            pfds[i] = pfds[active];
+            indexes[i] = indexes[active];
+
+            // Don't wait for the delay to start the next attempt after a failure
+            nextAttemptTime = now;
+        }
+    }
+
+    while (active > 0) {
+        closeSocket(sockets[--active]);
+    }
+    SetLastSocketError(lastError);
+    return INVALID_SOCKET;
+}
+
+// See TCP_MAXSEG note in startTcpConnect() above for more information.
 // TCP_NODELAY must be enabled on the socket for this function to work!
 int sendMtuSafe(SOCKET s, char* buffer, int size) {
     int bytesSent = 0;
@@ -632,9 +980,86 @@ static bool isPrivateNetworkAddressV4(struct sockaddr_in* address, bool matchCGN
     }
 }
 
+static PLT_ATOMIC_INT familyCache[FAMILY_CACHE_SIZE];
+
+static unsigned int hashHostName(const char* host) {
+    // 32-bit FNV-1a
+    unsigned int hash = 2166136261U;
+    while (*host != 0) {
+        hash ^= (unsigned char)*host++;
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+// Returns the address family of the last successful connection to host,
+// or AF_UNSPEC if there is none. Hash collisions only cost a worse guess.
+static int getPreferredFamily(const char* host) {
+    unsigned int hash = hashHostName(host);
+    int entry = PltAtomicLoad(&familyCache[hash % FAMILY_CACHE_SIZE]);
+
+    if (entry == 0 || (entry >> 4) != (int)(hash & 0x07FFFFFF)) {
+        return AF_UNSPEC;
+    }
+#ifdef AF_INET6
+    else if ((entry & 0xF) == FAMILY_CACHE_V6) {
+        return AF_INET6;
+    }
+#endif
+    else {
+        return AF_INET;
+    }
+}
+
+static void setPreferredFamily(const char* host, int family) {
+    unsigned int hash = hashHostName(host);
+
+    PltAtomicStore(&familyCache[hash % FAMILY_CACHE_SIZE],
+                   (int)((hash & 0x07FFFFFF) << 4) | (family == AF_INET ? FAMILY_CACHE_V4 : FAMILY_CACHE_V6));
+}
+
+// Orders up to HAPPY_EYEBALLS_MAX_ATTEMPTS addresses to alternate between address families,
+// starting with the preferred family, as described in RFC 8305 section 4. The relative order
+// of the addresses within each family is kept from getaddrinfo().
+static int sortAddressesForRace(struct addrinfo* res, int preferredFamily, struct sockaddr_storage* addrs, SOCKADDR_LEN* addrLens) {
+    struct addrinfo* preferred = res;
+    struct addrinfo* other = res;
+    bool takePreferred = true;
+    int count = 0;
+
+    if (preferredFamily == AF_UNSPEC) {
+        preferredFamily = res->ai_family;
+    }
+
+    while (count < HAPPY_EYEBALLS_MAX_ATTEMPTS) {
+        struct addrinfo** cursor;
+
+        while (preferred != NULL && preferred->ai_family != preferredFamily) {
+            preferred = preferred->ai_next;
+        }
+        while (other != NULL && other->ai_family == preferredFamily) {
+            other = other->ai_next;
+        }
+
+        if (preferred == NULL && other == NULL) {
+            break;
+        }
+
+        // Fall back to the remaining family when the other one runs out
+        cursor = (takePreferred && preferred != NULL) || other == NULL ? &preferred : &other;
+        memcpy(&addrs[count], (*cursor)->ai_addr, (*cursor)->ai_addrlen);
+        addrLens[count] = (SOCKADDR_LEN)(*cursor)->ai_addrlen;
+        *cursor = (*cursor)->ai_next;
+        takePreferred = !takePreferred;
+        count++;
+    }
+
+    return count;
+}
+
 int resolveHostName(const char* host, int family, int tcpTestPort, struct sockaddr_storage* addr, SOCKADDR_LEN* addrLen)
 {
-    struct addrinfo hints, *res, *currentAddr;
+    struct addrinfo hints, *res;
     int err;
     bool needsFallbackV4 = false;
 
@@ -673,27 +1098,35 @@ int resolveHostName(const char* host, int family, int tcpTestPort, struct sockad
     }
 #endif
 
-    for (currentAddr = res; currentAddr != NULL; currentAddr = currentAddr->ai_next) {
-        // Use the test port to ensure this address is working if:
-        // a) We have multiple addresses
-        // b) The caller asked us to test even with a single address
-        // c) We got an IPv6 address synthesized from an IPv4 address
-        if (tcpTestPort != 0 && (res->ai_next != NULL || (tcpTestPort & TCP_PORT_FLAG_ALWAYS_TEST) || needsFallbackV4)) {
-            SOCKET testSocket = connectTcpSocket((struct sockaddr_storage*)currentAddr->ai_addr,
-                                                 (SOCKADDR_LEN)currentAddr->ai_addrlen,
-                                                 tcpTestPort & TCP_PORT_MASK,
-                                                 TEST_PORT_TIMEOUT_SEC);
-            if (testSocket == INVALID_SOCKET) {
-                // Try the next address
-                continue;
-            }
-            else {
-                closeSocket(testSocket);
-            }
+    // Use the test port to ensure an address is working if:
+    // a) We have multiple addresses
+    // b) The caller asked us to test even with a single address
+    // c) We got an IPv6 address synthesized from an IPv4 address
+    if (tcpTestPort != 0 && (res->ai_next != NULL || (tcpTestPort & TCP_PORT_FLAG_ALWAYS_TEST) || needsFallbackV4)) {
+        struct sockaddr_storage candidates[HAPPY_EYEBALLS_MAX_ATTEMPTS];
+        SOCKADDR_LEN candidateLens[HAPPY_EYEBALLS_MAX_ATTEMPTS];
+        int count, winner;
+        SOCKET testSocket;
+
+        // Race the addresses against each other instead of waiting for each one to time out in turn
+        count = sortAddressesForRace(res, getPreferredFamily(host), candidates, candidateLens);
+        testSocket = connectTcpSocketRace(candidates, candidateLens, count,
+                                          tcpTestPort & TCP_PORT_MASK,
+                                          TEST_PORT_TIMEOUT_SEC, &winner);
+        if (testSocket != INVALID_SOCKET) {
+            closeSocket(testSocket);
+
+            memcpy(addr, &candidates[winner], candidateLens[winner]);
+            *addrLen = candidateLens[winner];
+            setPreferredFamily(host, addr->ss_family);
+
+            freeaddrinfo(res);
+            return 0;
         }
-
-        memcpy(addr, currentAddr->ai_addr, currentAddr->ai_addrlen);
-        *addrLen = (SOCKADDR_LEN)currentAddr->ai_addrlen;
+    }
+    else {
+        memcpy(addr, res->ai_addr, res->ai_addrlen);
+        *addrLen = (SOCKADDR_LEN)res->ai_addrlen;
 
         freeaddrinfo(res);
         return 0;
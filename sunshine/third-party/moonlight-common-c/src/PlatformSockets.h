@@ -107,11 +107,31 @@ void addrToUrlSafeString(struct sockaddr_storage* addr, char* string, size_t str
 
 SOCKET createSocket(int addressFamily, int socketType, int protocol, bool nonBlocking);
 SOCKET connectTcpSocket(struct sockaddr_storage* dstaddr, SOCKADDR_LEN addrlen, unsigned short port, int timeoutSec);
+// Races connections to the addresses in order with staggered starts (RFC 8305) and returns the first
+// to succeed, with its index in winner. Addresses past the first 8 are ignored.
+SOCKET connectTcpSocketRace(struct sockaddr_storage* dstaddrs, SOCKADDR_LEN* addrlens, int count, unsigned short port, int timeoutSec, int* winner);
 int sendMtuSafe(SOCKET s, char* buffer, int size);
 SOCKET bindUdpSocket(int addressFamily, struct sockaddr_storage* localAddr, SOCKADDR_LEN addrLen, int bufferSize, int socketQosType);
 int enableNoDelay(SOCKET s);
+int getLocalAddressForRemote(struct sockaddr_storage* dstaddr, SOCKADDR_LEN addrlen, struct sockaddr_storage* localAddr);
+void setSocketRecvBufferSize(SOCKET s, int bufferSize);
 int setSocketNonBlocking(SOCKET s, bool enabled);
 int recvUdpSocket(SOCKET s, char* buffer, int size, bool useSelect);
+
+// Receives up to count (at most UDP_RECV_BATCH_MAX) datagrams of up to size bytes
+// each into buffers, storing their lengths in lengths. Waits for the first one like
+// recvUdpSocket() and returns the number of datagrams received, 0 on timeout, or
+// a negative value on error. Platforms without recvmmsg() receive one per call.
+//
+// If receiveTimesUs is not NULL, it gets the PltGetMicroseconds() time each datagram
+// was received. This is the kernel receive timestamp after enableUdpReceiveTimestamps()
+// where supported, and the time the call returned otherwise.
+#define UDP_RECV_BATCH_MAX 16
+int recvUdpSocketBatch(SOCKET s, char** buffers, int* lengths, uint64_t* receiveTimesUs, int size, int count, bool useSelect);
+
+// Asks the kernel to timestamp received datagrams for recvUdpSocketBatch(). Returns
+// non-zero if not supported, in which case userspace receive times are used.
+int enableUdpReceiveTimestamps(SOCKET s);
 void shutdownTcpSocket(SOCKET s);
 int setNonFatalRecvTimeoutMs(SOCKET s, int timeoutMs);
 void closeSocket(SOCKET s);
@@ -5,6 +5,14 @@
 
 typedef void(*ThreadEntry)(void* context);
 
+// Scheduling hints for PltCreateThread(). Platforms without a matching
+// mechanism treat every role as PLT_THREAD_ROLE_DEFAULT.
+#define PLT_THREAD_ROLE_DEFAULT 0 // Housekeeping and callbacks
+#define PLT_THREAD_ROLE_RECEIVE 1 // Socket receive loops that must keep up with the host
+#define PLT_THREAD_ROLE_AUDIO   2 // Audio decoding and playback
+#define PLT_THREAD_ROLE_VIDEO   3 // Video reassembly, decryption and decoding
+#define PLT_THREAD_ROLE_CONTROL 4 // Input and control stream traffic
+
 #if defined(LC_WINDOWS)
 typedef SRWLOCK PLT_MUTEX;
 typedef CONDITION_VARIABLE PLT_COND;
@@ -47,12 +55,60 @@ typedef struct _PLT_EVENT {
 } PLT_EVENT;
 #endif
 
+// Sequentially consistent operations on a 32-bit integer shared between threads
+#if defined(_MSC_VER) && !defined(__clang__)
+typedef volatile long PLT_ATOMIC_INT;
+
+static inline int PltAtomicLoad(PLT_ATOMIC_INT* value) {
+    return InterlockedOr(value, 0);
+}
+
+static inline void PltAtomicStore(PLT_ATOMIC_INT* value, int newValue) {
+    InterlockedExchange(value, newValue);
+}
+
+// Returns the previous value
+static inline int PltAtomicAdd(PLT_ATOMIC_INT* value, int addend) {
+    return InterlockedExchangeAdd(value, addend);
+}
+
+// On failure, expected is updated with the current value
+static inline bool PltAtomicCompareExchange(PLT_ATOMIC_INT* value, int* expected, int desired) {
+    long previous = InterlockedCompareExchange(value, desired, *expected);
+    if (previous == *expected) {
+        return true;
+    }
+    *expected = previous;
+    return false;
+}
+#else
+typedef int PLT_ATOMIC_INT;
+
+static inline int PltAtomicLoad(PLT_ATOMIC_INT* value) {
+    return __atomic_load_n(value, __ATOMIC_SEQ_CST);
+}
+
+static inline void PltAtomicStore(PLT_ATOMIC_INT* value, int newValue) {
+    __atomic_store_n(value, newValue, __ATOMIC_SEQ_CST);
+}
+
+// Returns the previous value
+static inline int PltAtomicAdd(PLT_ATOMIC_INT* value, int addend) {
+    return __atomic_fetch_add(value, addend, __ATOMIC_SEQ_CST);
+}
+
+// On failure, expected is updated with the current value
+static inline bool PltAtomicCompareExchange(PLT_ATOMIC_INT* value, int* expected, int desired) {
+    return __atomic_compare_exchange_n(value, expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+#endif
+
 int PltCreateMutex(PLT_MUTEX* mutex);
 void PltDeleteMutex(PLT_MUTEX* mutex);
 void PltLockMutex(PLT_MUTEX* mutex);
 void PltUnlockMutex(PLT_MUTEX* mutex);
 
-int PltCreateThread(const char* name, ThreadEntry entry, void* context, PLT_THREAD* thread);
+int PltCreateThread(const char* name, int role, ThreadEntry entry, void* context, PLT_THREAD* thread);
 void PltInterruptThread(PLT_THREAD* thread);
 bool PltIsThreadInterrupted(PLT_THREAD* thread);
 void PltJoinThread(PLT_THREAD* thread);
@@ -71,3 +127,5 @@ void PltWaitForConditionVariable(PLT_COND* cond, PLT_MUTEX* mutex);
 
 void PltSleepMs(int ms);
 void PltSleepMsInterruptible(PLT_THREAD* thread, int ms);
+
+int PltGetProcessorCount(void);
@@ -18,6 +18,11 @@
 #define RTP_PAYLOAD_TYPE_AUDIO   97
 #define RTP_PAYLOAD_TYPE_FEC     127
 
+// Each pooled FEC block has room for shards of the largest packet size
+#define RTPA_MAX_BLOCK_SIZE (RTPA_MAX_PACKET_SIZE - sizeof(RTP_PACKET))
+#define RTPA_FEC_BLOCK_STRIDE \
+    (((sizeof(RTPA_FEC_BLOCK) + (RTPA_DATA_SHARDS * RTPA_MAX_PACKET_SIZE) + (RTPA_FEC_SHARDS * RTPA_MAX_BLOCK_SIZE)) + 15) & ~15)
+
 void RtpaInitializeQueue(PRTP_AUDIO_QUEUE queue) {
     memset(queue, 0, sizeof(*queue));
 
@@ -57,6 +62,21 @@ void RtpaInitializeQueue(PRTP_AUDIO_QUEUE queue) {
     const unsigned char parity[] = { 0x77, 0x40, 0x38, 0x0e, 0xc7, 0xa7, 0x0d, 0x6c };
     memcpy(&queue->rs->m[16], parity, sizeof(parity));
     memcpy(queue->rs->parity, parity, sizeof(parity));
+
+    // Allocate all FEC blocks up front, so the audio path doesn't allocate while streaming
+    queue->blockPool = malloc(RTPA_FEC_BLOCK_POOL_SIZE * RTPA_FEC_BLOCK_STRIDE);
+    if (queue->blockPool != NULL) {
+        for (int i = RTPA_FEC_BLOCK_POOL_SIZE - 1; i >= 0; i--) {
+            PRTPA_FEC_BLOCK block = (PRTPA_FEC_BLOCK)((uint8_t*)queue->blockPool + (i * RTPA_FEC_BLOCK_STRIDE));
+
+            block->next = queue->freeBlockHead;
+            queue->freeBlockHead = block;
+            queue->freeBlockCount++;
+        }
+    }
+    else {
+        Limelog("Audio FEC block allocation failed\n");
+    }
 }
 
 static void validateFecBlockState(PRTP_AUDIO_QUEUE queue) {
@@ -106,38 +126,25 @@ static void validateFecBlockState(PRTP_AUDIO_QUEUE queue) {
 static PRTPA_FEC_BLOCK allocateFecBlock(PRTP_AUDIO_QUEUE queue, uint16_t blockSize) {
     PRTPA_FEC_BLOCK block = queue->freeBlockHead;
 
-    if (block != NULL) {
-        LC_ASSERT(queue->freeBlockCount > 0);
-
-        // If the block size matches, we're good to go
-        if (block->blockSize == blockSize) {
-            // Advance the free block list to the next entry
-            queue->freeBlockHead = block->next;
-            queue->freeBlockCount--;
-
-            // Return the new block
-            return block;
-        }
-        else {
-            // The block size didn't match. This should never happen with GFE
-            // because it uses constant sized data shards, but Sunshine can
-            // trigger this condition. If it does happen, let's free the cached
-            // entry so we can populate the cache with correctly sized blocks.
-            queue->freeBlockHead = block->next;
-            queue->freeBlockCount--;
-
-            // Free the existing block
-            free(block);
-        }
+    // The audio stream never receives packets that wouldn't fit in a pooled block
+    LC_ASSERT(blockSize <= RTPA_MAX_BLOCK_SIZE);
+    if (blockSize > RTPA_MAX_BLOCK_SIZE) {
+        return NULL;
     }
-    else {
+
+    if (block == NULL) {
+        // All blocks are in use, so this packet is too far ahead of the oldest block
         LC_ASSERT(queue->freeBlockCount == 0);
+        return NULL;
     }
 
-    // We either didn't have any free entries or the block
-    // size didn't match, so allocate a new FEC block now.
-    uint16_t dataPacketSize = blockSize + sizeof(RTP_PACKET);
-    return malloc(sizeof(*block) + (RTPA_DATA_SHARDS * dataPacketSize) + (RTPA_FEC_SHARDS * blockSize));
+    LC_ASSERT(queue->freeBlockCount > 0);
+
+    // Advance the free block list to the next entry
+    queue->freeBlockHead = block->next;
+    queue->freeBlockCount--;
+
+    return block;
 }
 
 static void freeFecBlockHead(PRTP_AUDIO_QUEUE queue) {
@@ -159,35 +166,22 @@ static void freeFecBlockHead(PRTP_AUDIO_QUEUE queue) {
 
     validateFecBlockState(queue);
 
-    if (queue->freeBlockCount >= RTPA_CACHED_FEC_BLOCK_LIMIT) {
-        // Too many entries cached, so just free this one
-        free(blockHead);
-    }
-    else {
-        // Place this entry at the head of the free list for better cache behavior
-        blockHead->next = queue->freeBlockHead;
-        queue->freeBlockHead = blockHead;
-        queue->freeBlockCount++;
-    }
+    // Place this entry at the head of the free list for better cache behavior
+    LC_ASSERT(queue->freeBlockCount < RTPA_FEC_BLOCK_POOL_SIZE);
+    blockHead->next = queue->freeBlockHead;
+    queue->freeBlockHead = blockHead;
+    queue->freeBlockCount++;
 }
 
 void RtpaCleanupQueue(PRTP_AUDIO_QUEUE queue) {
-    while (queue->blockHead != NULL) {
-        PRTPA_FEC_BLOCK block = queue->blockHead;
-        queue->blockHead = block->next;
-        free(block);
-    }
-
+    // All blocks live in the pool
+    queue->blockHead = NULL;
     queue->blockTail = NULL;
+    queue->freeBlockHead = NULL;
+    queue->freeBlockCount = 0;
 
-    while (queue->freeBlockHead != NULL) {
-        PRTPA_FEC_BLOCK block = queue->freeBlockHead;
-        queue->freeBlockHead = block->next;
-        queue->freeBlockCount--;
-        free(block);
-    }
-
-    LC_ASSERT(queue->freeBlockCount == 0);
+    free(queue->blockPool);
+    queue->blockPool = NULL;
 
     reed_solomon_release(queue->rs);
     queue->rs = NULL;
@@ -658,7 +652,8 @@ int RtpaAddPacket(PRTP_AUDIO_QUEUE queue, PRTP_PACKET packet, uint16_t length) {
     return queueHasPacketReady(queue) ? RTPQ_RET_PACKET_READY : 0;
 }
 
-PRTP_PACKET RtpaGetQueuedPacket(PRTP_AUDIO_QUEUE queue, uint16_t customHeaderLength, uint16_t* length) {
+// Returned packets are allocated from packetPool
+PRTP_PACKET RtpaGetQueuedPacket(PRTP_AUDIO_QUEUE queue, PBUFFER_POOL packetPool, uint16_t customHeaderLength, uint16_t* length) {
     validateFecBlockState(queue);
 
     // If we're returning audio data even with discontinuities, we'll fill in blank entries
@@ -671,7 +666,8 @@ PRTP_PACKET RtpaGetQueuedPacket(PRTP_AUDIO_QUEUE queue, uint16_t customHeaderLen
         if (nextBlock->marks[nextBlock->nextDataPacketIndex]) {
             // This packet is missing. Return an empty entry to let the caller
             // know to perform packet loss concealment for this frame.
-            lostPacket = malloc(customHeaderLength);
+            LC_ASSERT(customHeaderLength <= packetPool->bufferSize);
+            lostPacket = BpAllocBuffer(packetPool);
             if (lostPacket == NULL) {
                 return NULL;
             }
@@ -704,7 +700,10 @@ PRTP_PACKET RtpaGetQueuedPacket(PRTP_AUDIO_QUEUE queue, uint16_t customHeaderLen
     // Return the next RTP sequence number by indexing into the most recent FEC block
     if (queueHasPacketReady(queue)) {
         PRTPA_FEC_BLOCK nextBlock = queue->blockHead;
-        PRTP_PACKET packet = malloc(customHeaderLength + sizeof(RTP_PACKET) + nextBlock->blockSize);
+        PRTP_PACKET packet;
+
+        LC_ASSERT(customHeaderLength + sizeof(RTP_PACKET) + nextBlock->blockSize <= (size_t)packetPool->bufferSize);
+        packet = BpAllocBuffer(packetPool);
         if (packet == NULL) {
             return NULL;
         }
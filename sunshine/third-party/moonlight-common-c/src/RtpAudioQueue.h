@@ -3,6 +3,7 @@
 #include "Video.h"
 
 #include "rs.h"
+#include "BufferPool.h"
 
 // Maximum time to wait for an OOS data/FEC shard
 // after the entire FEC block should have been received
@@ -12,8 +13,12 @@
 #define RTPA_FEC_SHARDS 2
 #define RTPA_TOTAL_SHARDS (RTPA_DATA_SHARDS + RTPA_FEC_SHARDS)
 
-// Maximum number of FEC block entries to cache
-#define RTPA_CACHED_FEC_BLOCK_LIMIT 4
+// Largest audio packet received by the audio stream
+#define RTPA_MAX_PACKET_SIZE 1400
+
+// Number of FEC blocks preallocated when the queue is initialized. No more are
+// allocated later, so this bounds the jitter window (to at least 320 ms of audio).
+#define RTPA_FEC_BLOCK_POOL_SIZE 16
 
 typedef struct _AUDIO_FEC_HEADER {
     uint8_t fecShardIndex;
@@ -53,6 +58,7 @@ typedef struct _RTP_AUDIO_QUEUE {
 
     reed_solomon* rs;
 
+    void* blockPool;
     PRTPA_FEC_BLOCK freeBlockHead;
     uint16_t freeBlockCount;
 
@@ -78,4 +84,4 @@ typedef struct _RTP_AUDIO_QUEUE {
 void RtpaInitializeQueue(PRTP_AUDIO_QUEUE queue);
 void RtpaCleanupQueue(PRTP_AUDIO_QUEUE queue);
 int RtpaAddPacket(PRTP_AUDIO_QUEUE queue, PRTP_PACKET packet, uint16_t length);
-PRTP_PACKET RtpaGetQueuedPacket(PRTP_AUDIO_QUEUE queue, uint16_t customHeaderLength, uint16_t* length);
+PRTP_PACKET RtpaGetQueuedPacket(PRTP_AUDIO_QUEUE queue, PBUFFER_POOL packetPool, uint16_t customHeaderLength, uint16_t* length);
@@ -28,16 +28,85 @@ static void purgeListEntries(PRTPV_QUEUE_LIST list) {
     while (list->head != NULL) {
         PRTPV_QUEUE_ENTRY entry = list->head;
         list->head = entry->next;
-        free(entry->packet);
+        freeVideoPacketBuffer(entry->packet);
     }
 
     list->tail = NULL;
     list->count = 0;
 }
 
+static void purgePendingFecBlock(PRTP_VIDEO_QUEUE queue) {
+    uint32_t i;
+
+    // Every pending entry is within the slots of the current FEC block
+    for (i = 0; queue->pendingFecBlockCount > 0; i++) {
+        LC_ASSERT(i < queue->pendingFecBlockSlotCount);
+
+        if (queue->pendingFecBlockSlots[i] != NULL) {
+            freeVideoPacketBuffer(queue->pendingFecBlockSlots[i]->packet);
+            queue->pendingFecBlockSlots[i] = NULL;
+            queue->pendingFecBlockCount--;
+        }
+    }
+
+    queue->pendingFecBlockFirstEntry = NULL;
+}
+
 void RtpvCleanupQueue(PRTP_VIDEO_QUEUE queue) {
-    purgeListEntries(&queue->pendingFecBlockList);
+    int i;
+
+    purgePendingFecBlock(queue);
     purgeListEntries(&queue->completedFecBlockList);
+
+    free(queue->pendingFecBlockSlots);
+    queue->pendingFecBlockSlots = NULL;
+    queue->pendingFecBlockSlotCount = 0;
+
+    for (i = 0; i < RTPV_RS_CACHE_SIZE; i++) {
+        if (queue->rsCache[i].rs != NULL) {
+            reed_solomon_release(queue->rsCache[i].rs);
+            queue->rsCache[i].rs = NULL;
+        }
+    }
+}
+
+// Returns a Reed-Solomon context for this FEC block shape, creating it (and evicting the
+// least recently used one) if it's not cached. The context remains owned by the cache.
+static reed_solomon* getReedSolomonContext(PRTP_VIDEO_QUEUE queue, int dataShards, int parityShards) {
+    PRTPV_RS_CACHE_ENTRY evictEntry = &queue->rsCache[0];
+    reed_solomon* rs;
+    int i;
+
+    queue->rsCacheClock++;
+
+    for (i = 0; i < RTPV_RS_CACHE_SIZE; i++) {
+        PRTPV_RS_CACHE_ENTRY cacheEntry = &queue->rsCache[i];
+
+        if (cacheEntry->rs != NULL &&
+                cacheEntry->rs->data_shards == dataShards &&
+                cacheEntry->rs->parity_shards == parityShards) {
+            cacheEntry->lastUsed = queue->rsCacheClock;
+            return cacheEntry->rs;
+        }
+
+        // Unused entries have a lastUsed of 0, so they are picked first
+        if (cacheEntry->lastUsed < evictEntry->lastUsed) {
+            evictEntry = cacheEntry;
+        }
+    }
+
+    rs = reed_solomon_new(dataShards, parityShards);
+    if (rs == NULL) {
+        return NULL;
+    }
+
+    if (evictEntry->rs != NULL) {
+        reed_solomon_release(evictEntry->rs);
+    }
+    evictEntry->rs = rs;
+    evictEntry->lastUsed = queue->rsCacheClock;
+
+    return rs;
 }
 
 static void insertEntryIntoList(PRTPV_QUEUE_LIST list, PRTPV_QUEUE_ENTRY entry) {
@@ -109,15 +178,16 @@ static void reportFinalFrameFecStatus(PRTP_VIDEO_QUEUE queue) {
 
 // newEntry is contained within the packet buffer so we free the whole entry by freeing entry->packet
 static bool queuePacket(PRTP_VIDEO_QUEUE queue, PRTPV_QUEUE_ENTRY newEntry, PRTP_PACKET packet, int length, bool isParity, bool isFecRecovery) {
-    PRTPV_QUEUE_ENTRY entry;
+    unsigned int index = U16(packet->sequenceNumber - queue->bufferLowestSequenceNumber);
     bool outOfSequence;
 
     LC_ASSERT(!(isFecRecovery && isParity));
     LC_ASSERT(!isBefore16(packet->sequenceNumber, queue->nextContiguousSequenceNumber));
+    LC_ASSERT(index < queue->bufferDataPackets + queue->bufferParityPackets);
 
-    // If the packet is in order, we can take the fast path and avoid having
-    // to loop through the whole list. If we get an out of order or missing
-    // packet, the fast path will stop working and we'll use the loop instead.
+    // If the packet is in order, we can take the fast path and skip the duplicate
+    // and ordering checks. If we get an out of order or missing packet, the fast
+    // path will stop working and we'll use the checks instead.
     //
     // NB: It's not enough to just check next contiguous sequence number because
     // it's possible that we hit the OOS path earlier which doesn't update the
@@ -126,23 +196,18 @@ static bool queuePacket(PRTP_VIDEO_QUEUE queue, PRTPV_QUEUE_ENTRY newEntry, PRTP
     if (queue->useFastQueuePath && packet->sequenceNumber == queue->nextContiguousSequenceNumber) {
         queue->nextContiguousSequenceNumber = U16(packet->sequenceNumber + 1);
         outOfSequence = false;
+        LC_ASSERT(queue->pendingFecBlockSlots[index] == NULL);
     }
     else {
-        outOfSequence = false;
-
         // Check for duplicates
-        entry = queue->pendingFecBlockList.head;
-        while (entry != NULL) {
-            if (packet->sequenceNumber == entry->packet->sequenceNumber) {
-                return false;
-            }
-            else if (isBefore16(packet->sequenceNumber, entry->packet->sequenceNumber)) {
-                outOfSequence = true;
-            }
-
-            entry = entry->next;
+        if (queue->pendingFecBlockSlots[index] != NULL) {
+            return false;
         }
 
+        // This packet is out of order if we already have one with a higher sequence number
+        outOfSequence = queue->pendingFecBlockCount != 0 &&
+                isBefore16(packet->sequenceNumber, queue->receivedHighestSequenceNumber);
+
         // If we make it here, we cannot use the fast queue path for this frame because
         // we're about to queue a non-duplicate packet out of order. This will not update
         // nextContiguousSequenceNumber which the fast path relies on.
@@ -176,7 +241,10 @@ static bool queuePacket(PRTP_VIDEO_QUEUE queue, PRTPV_QUEUE_ENTRY newEntry, PRTP
         }
     }
 
-    insertEntryIntoList(&queue->pendingFecBlockList, newEntry);
+    queue->pendingFecBlockSlots[index] = newEntry;
+    if (queue->pendingFecBlockCount++ == 0) {
+        queue->pendingFecBlockFirstEntry = newEntry;
+    }
 
     return true;
 }
@@ -186,7 +254,7 @@ static bool queuePacket(PRTP_VIDEO_QUEUE queue, PRTPV_QUEUE_ENTRY newEntry, PRTP
     Limelog("FEC recovery returned corrupt packet %d" \
             " (frame %d)", rtpPacket->sequenceNumber, \
             queue->currentFrameNumber);               \
-    free(packets[i]);                                 \
+    freeVideoPacketBuffer(packets[i]);                \
     continue
 
 // Returns 0 if the frame is completely constructed
@@ -206,7 +274,7 @@ static int reconstructFrame(PRTP_VIDEO_QUEUE queue) {
 
     LC_ASSERT(totalPackets - neededPackets <= queue->bufferParityPackets);
 
-    if (queue->pendingFecBlockList.count < neededPackets) {
+    if (queue->pendingFecBlockCount < neededPackets) {
         // If we've never received OOS data from this host, we can predict whether this frame will be recoverable
         // based on the packets we've received (or not) so far. If the number of missing shards exceeds the total
         // needed shards, there is no hope of recovering the data. The only way we could recover this frame is by
@@ -220,7 +288,7 @@ static int reconstructFrame(PRTP_VIDEO_QUEUE queue) {
             }
             else {
                 // Assert that there are enough remaining packets to possibly recover this frame.
-                LC_ASSERT(neededPackets - queue->pendingFecBlockList.count <= U16(queue->bufferHighestSequenceNumber - queue->receivedHighestSequenceNumber));
+                LC_ASSERT(neededPackets - queue->pendingFecBlockCount <= U16(queue->bufferHighestSequenceNumber - queue->receivedHighestSequenceNumber));
             }
         }
 
@@ -235,7 +303,7 @@ static int reconstructFrame(PRTP_VIDEO_QUEUE queue) {
     if (queue->reportedLostFrame && !queue->receivedOosData) {
         // If it turns out that we lied to the host, stop further speculative RFI requests for a while.
         queue->receivedOosData = true;
-        queue->lastOosFramePresentationTimestamp = queue->pendingFecBlockList.head->presentationTimeUs;
+        queue->lastOosFramePresentationTimestamp = queue->pendingFecBlockFirstEntry->presentationTimeUs;
         Limelog("Leaving speculative RFI mode due to incorrect loss prediction of frame %u\n", queue->currentFrameNumber);
     }
 
@@ -258,14 +326,17 @@ static int reconstructFrame(PRTP_VIDEO_QUEUE queue) {
     }
 
     reed_solomon* rs = NULL;
-    unsigned char** packets = calloc(totalPackets, sizeof(unsigned char*));
-    unsigned char* marks = calloc(totalPackets, sizeof(unsigned char));
-    if (packets == NULL || marks == NULL) {
+    unsigned char** packets = queue->fecShards;
+    unsigned char* marks = queue->fecMarks;
+    if (totalPackets > DATA_SHARDS_MAX) {
+        // reed_solomon_new() would reject this shape too
         ret = -2;
         goto cleanup;
     }
 
-    rs = reed_solomon_new(queue->bufferDataPackets, queue->bufferParityPackets);
+    memset(packets, 0, sizeof(unsigned char*) * totalPackets);
+
+    rs = getReedSolomonContext(queue, queue->bufferDataPackets, queue->bufferParityPackets);
 
     // This could happen in an OOM condition, but it could also mean the FEC data
     // that we fed to reed_solomon_new() is bogus, so we'll assert to get a better look.
@@ -278,7 +349,6 @@ static int reconstructFrame(PRTP_VIDEO_QUEUE queue) {
     memset(marks, 1, sizeof(char) * (totalPackets));
 
     int receiveSize = StreamConfig.packetSize + MAX_RTP_HEADER_SIZE;
-    int packetBufferSize = receiveSize + sizeof(RTPV_QUEUE_ENTRY);
 
 #ifdef FEC_VALIDATION_MODE
     // Choose a packet to drop
@@ -287,40 +357,38 @@ static int reconstructFrame(PRTP_VIDEO_QUEUE queue) {
     int droppedRtpPacketLength = 0;
 #endif
 
-    PRTPV_QUEUE_ENTRY entry = queue->pendingFecBlockList.head;
-    while (entry != NULL) {
-        unsigned int index = U16(entry->packet->sequenceNumber - queue->bufferLowestSequenceNumber);
+    unsigned int i;
+    for (i = 0; i < totalPackets; i++) {
+        PRTPV_QUEUE_ENTRY entry = queue->pendingFecBlockSlots[i];
+
+        if (entry == NULL) {
+            continue;
+        }
+
+        LC_ASSERT(U16(entry->packet->sequenceNumber - queue->bufferLowestSequenceNumber) == i);
 
 #ifdef FEC_VALIDATION_MODE
-        if (index == dropIndex) {
+        if (i == dropIndex) {
             // If this was the drop choice, remember the original contents
             // and "drop" it.
             droppedRtpPacket = entry->packet;
             droppedRtpPacketLength = entry->length;
-            entry = entry->next;
             continue;
         }
 #endif
 
-        // We should never have duplicate packets enqueued
-        LC_ASSERT(packets[index] == NULL);
-        LC_ASSERT(marks[index] != 0);
-
-        packets[index] = (unsigned char*) entry->packet;
-        marks[index] = 0;
+        packets[i] = (unsigned char*) entry->packet;
+        marks[i] = 0;
 
         //Set padding to zero
         if (entry->length < receiveSize) {
-            memset(&packets[index][entry->length], 0, receiveSize - entry->length);
+            memset(&packets[i][entry->length], 0, receiveSize - entry->length);
         }
-
-        entry = entry->next;
     }
 
-    unsigned int i;
     for (i = 0; i < totalPackets; i++) {
         if (marks[i]) {
-            packets[i] = malloc(packetBufferSize);
+            packets[i] = allocVideoPacketBuffer();
             if (packets[i] == NULL) {
                 ret = -4;
                 goto cleanup_packets;
@@ -328,7 +396,18 @@ static int reconstructFrame(PRTP_VIDEO_QUEUE queue) {
         }
     }
 
-    ret = reed_solomon_reconstruct(rs, packets, marks, totalPackets, receiveSize);
+    if (queue->bufferDataPackets != queue->receivedDataPackets) {
+        uint64_t recoveryStartTimeUs = PltGetMicroseconds();
+
+        ret = reed_solomon_reconstruct(rs, packets, marks, totalPackets, receiveSize);
+        addVideoTimingSample(&VideoTimingStats.fecRecovery, PltGetMicroseconds() - recoveryStartTimeUs);
+        if (ret == 0) {
+            queue->stats.packetCountFecRecovered += queue->bufferDataPackets - queue->receivedDataPackets;
+        }
+    }
+    else {
+        ret = reed_solomon_reconstruct(rs, packets, marks, totalPackets, receiveSize);
+    }
 
     // We should always provide enough parity to recover the missing data successfully.
     // If this fails, something is probably wrong with our FEC state.
@@ -353,9 +432,9 @@ cleanup_packets:
                 PRTPV_QUEUE_ENTRY queueEntry = (PRTPV_QUEUE_ENTRY)&packets[i][receiveSize];
                 PRTP_PACKET rtpPacket = (PRTP_PACKET) packets[i];
                 rtpPacket->sequenceNumber = U16(i + queue->bufferLowestSequenceNumber);
-                rtpPacket->header = queue->pendingFecBlockList.head->packet->header;
-                rtpPacket->timestamp = queue->pendingFecBlockList.head->packet->timestamp;
-                rtpPacket->ssrc = queue->pendingFecBlockList.head->packet->ssrc;
+                rtpPacket->header = queue->pendingFecBlockFirstEntry->packet->header;
+                rtpPacket->timestamp = queue->pendingFecBlockFirstEntry->packet->timestamp;
+                rtpPacket->ssrc = queue->pendingFecBlockFirstEntry->packet->ssrc;
 
                 int dataOffset = sizeof(*rtpPacket);
                 if (rtpPacket->header & FLAG_EXTENSION) {
@@ -414,7 +493,7 @@ cleanup_packets:
 
                     // This drop was fake, so we don't want to actually submit it to the depacketizer.
                     // It will get confused because it's already seen this packet before.
-                    free(packets[i]);
+                    freeVideoPacketBuffer(packets[i]);
                     continue;
                 }
 #endif
@@ -445,82 +524,49 @@ cleanup_packets:
                 LC_ASSERT(isBefore16(rtpPacket->sequenceNumber, queue->bufferFirstParitySequenceNumber));
                 queuePacket(queue, queueEntry, rtpPacket, StreamConfig.packetSize + dataOffset, false, true);
             } else if (packets[i] != NULL) {
-                free(packets[i]);
+                freeVideoPacketBuffer(packets[i]);
             }
         }
     }
 
 cleanup:
-    reed_solomon_release(rs);
-
-    if (packets != NULL)
-        free(packets);
-
-    if (marks != NULL)
-        free(marks);
-
     return ret;
 }
 
 static void stageCompleteFecBlock(PRTP_VIDEO_QUEUE queue) {
-    unsigned int nextSeqNum = queue->bufferLowestSequenceNumber;
-
-    while (queue->pendingFecBlockList.count > 0) {
-        PRTPV_QUEUE_ENTRY entry = queue->pendingFecBlockList.head;
-
-        unsigned int lowestRtpSequenceNumber = entry->packet->sequenceNumber;
-
-        do {
-            // We should never encounter a packet that's lower than our next seq num
-            LC_ASSERT(!isBefore16(entry->packet->sequenceNumber, nextSeqNum));
-
-            // Never return parity packets
-            if (entry->isParity) {
-                PRTPV_QUEUE_ENTRY parityEntry = entry;
-
-                // Skip this entry
-                entry = parityEntry->next;
-
-                // Remove this entry
-                removeEntryFromList(&queue->pendingFecBlockList, parityEntry);
-
-                // Free the entry and packet
-                free(parityEntry->packet);
+    unsigned int totalPackets = queue->bufferDataPackets + queue->bufferParityPackets;
+    unsigned int i;
 
-                continue;
-            }
+    // The slots are in sequence number order, so this moves the data packets
+    // to the completed FEC block list in order
+    for (i = 0; i < totalPackets && queue->pendingFecBlockCount > 0; i++) {
+        PRTPV_QUEUE_ENTRY entry = queue->pendingFecBlockSlots[i];
 
-            // Check for the next packet in sequence. This will be O(1) for non-reordered packet streams.
-            if (entry->packet->sequenceNumber == nextSeqNum) {
-                removeEntryFromList(&queue->pendingFecBlockList, entry);
+        if (entry == NULL) {
+            continue;
+        }
 
-                // To avoid having to sample the system time for each packet, we cheat
-                // and use the first packet's receive time for all packets. This ends up
-                // actually being better for the measurements that the depacketizer does,
-                // since it properly handles out of order packets.
-                LC_ASSERT(queue->bufferFirstRecvTimeUs != 0);
-                entry->receiveTimeUs = queue->bufferFirstRecvTimeUs;
+        queue->pendingFecBlockSlots[i] = NULL;
+        queue->pendingFecBlockCount--;
 
-                // Move this packet to the completed FEC block list
-                insertEntryIntoList(&queue->completedFecBlockList, entry);
-                break;
-            }
-            else if (isBefore16(entry->packet->sequenceNumber, lowestRtpSequenceNumber)) {
-                lowestRtpSequenceNumber = entry->packet->sequenceNumber;
-            }
+        // Never return parity packets
+        if (entry->isParity) {
+            freeVideoPacketBuffer(entry->packet);
+            continue;
+        }
 
-            entry = entry->next;
-        } while (entry != NULL);
+        // To avoid having to sample the system time for each packet, we cheat
+        // and use the first packet's receive time for all packets. This ends up
+        // actually being better for the measurements that the depacketizer does,
+        // since it properly handles out of order packets.
+        LC_ASSERT(queue->bufferFirstRecvTimeUs != 0);
+        entry->receiveTimeUs = queue->bufferFirstRecvTimeUs;
 
-        if (entry == NULL) {
-            // Start at the lowest we found last enumeration
-            nextSeqNum = lowestRtpSequenceNumber;
-        }
-        else {
-            // We found this packet so move on to the next one in sequence
-            nextSeqNum = U16(nextSeqNum + 1);
-        }
+        // Move this packet to the completed FEC block list
+        insertEntryIntoList(&queue->completedFecBlockList, entry);
     }
+
+    queue->pendingFecBlockFirstEntry = NULL;
 }
 
 static void submitCompletedFrame(PRTP_VIDEO_QUEUE queue) {
@@ -540,7 +586,7 @@ uint32_t RtpvGetCurrentFrameNumber(PRTP_VIDEO_QUEUE queue) {
     return queue->currentFrameNumber;
 }
 
-int RtpvAddPacket(PRTP_VIDEO_QUEUE queue, PRTP_PACKET packet, int length, PRTPV_QUEUE_ENTRY packetEntry) {
+int RtpvAddPacket(PRTP_VIDEO_QUEUE queue, PRTP_PACKET packet, int length, uint64_t receiveTimeUs, PRTPV_QUEUE_ENTRY packetEntry) {
     if (isBefore16(packet->sequenceNumber, queue->nextContiguousSequenceNumber)) {
         // Reject packets behind our current buffer window
         return RTPF_RET_REJECTED;
@@ -590,11 +636,12 @@ int RtpvAddPacket(PRTP_VIDEO_QUEUE queue, PRTP_PACKET packet, int length, PRTPV_
 
     // Reinitialize the queue if it's empty after a frame delivery or
     // if we can't finish a frame before receiving the next one.
-    if (queue->pendingFecBlockList.count == 0 || queue->currentFrameNumber != nvPacket->frameIndex ||
+    if (queue->pendingFecBlockCount == 0 || queue->currentFrameNumber != nvPacket->frameIndex ||
             queue->multiFecCurrentBlockNumber != fecCurrentBlockNumber) {
-        if (queue->pendingFecBlockList.count != 0) {
+        if (queue->pendingFecBlockCount != 0) {
             // Report the final status of the FEC queue before dropping this frame
             reportFinalFrameFecStatus(queue);
+            queue->stats.packetCountFecFailed++;
 
             if (queue->multiFecLastBlockNumber != 0) {
                 Limelog("Unrecoverable frame %d (block %d of %d): %d+%d=%d received < %d needed\n",
@@ -602,7 +649,7 @@ int RtpvAddPacket(PRTP_VIDEO_QUEUE queue, PRTP_PACKET packet, int length, PRTPV_
                         queue->multiFecLastBlockNumber+1,
                         queue->receivedDataPackets,
                         queue->receivedParityPackets,
-                        queue->pendingFecBlockList.count,
+                        queue->pendingFecBlockCount,
                         queue->bufferDataPackets);
 
                 // If we just missed a block of this frame rather than the whole thing,
@@ -610,7 +657,7 @@ int RtpvAddPacket(PRTP_VIDEO_QUEUE queue, PRTP_PACKET packet, int length, PRTPV_
                 // frame further is not possible.
                 if (queue->currentFrameNumber == nvPacket->frameIndex) {
                     // Discard any unsubmitted buffers from the previous frame
-                    purgeListEntries(&queue->pendingFecBlockList);
+                    purgePendingFecBlock(queue);
                     purgeListEntries(&queue->completedFecBlockList);
 
                     // Notify the host of the loss of this frame
@@ -628,7 +675,7 @@ int RtpvAddPacket(PRTP_VIDEO_QUEUE queue, PRTP_PACKET packet, int length, PRTPV_
                 Limelog("Unrecoverable frame %d: %d+%d=%d received < %d needed\n",
                         queue->currentFrameNumber, queue->receivedDataPackets,
                         queue->receivedParityPackets,
-                        queue->pendingFecBlockList.count,
+                        queue->pendingFecBlockCount,
                         queue->bufferDataPackets);
             }
         }
@@ -646,7 +693,7 @@ int RtpvAddPacket(PRTP_VIDEO_QUEUE queue, PRTP_PACKET packet, int length, PRTPV_
                     fecCurrentBlockNumber);
 
             // Discard any unsubmitted buffers from the previous frame
-            purgeListEntries(&queue->pendingFecBlockList);
+            purgePendingFecBlock(queue);
             purgeListEntries(&queue->completedFecBlockList);
 
             // Notify the host of the loss of this frame
@@ -662,7 +709,7 @@ int RtpvAddPacket(PRTP_VIDEO_QUEUE queue, PRTP_PACKET packet, int length, PRTPV_
         }
 
         // Discard any pending buffers from the previous FEC block
-        purgeListEntries(&queue->pendingFecBlockList);
+        purgePendingFecBlock(queue);
 
         // Discard any completed FEC blocks from the previous frame
         if (queue->currentFrameNumber != nvPacket->frameIndex) {
@@ -691,7 +738,10 @@ int RtpvAddPacket(PRTP_VIDEO_QUEUE queue, PRTP_PACKET packet, int length, PRTPV_
         // being able to reconstruct a full frame from it.
         connectionSawFrame(queue->currentFrameNumber);
 
-        queue->bufferFirstRecvTimeUs = PltGetMicroseconds();
+        queue->bufferFirstRecvTimeUs = receiveTimeUs;
+        if (fecCurrentBlockNumber == 0) {
+            queue->frameFirstRecvTimeUs = queue->bufferFirstRecvTimeUs;
+        }
         queue->bufferLowestSequenceNumber = U16(packet->sequenceNumber - fecIndex);
         queue->nextContiguousSequenceNumber = queue->bufferLowestSequenceNumber;
         queue->receivedDataPackets = 0;
@@ -710,6 +760,21 @@ int RtpvAddPacket(PRTP_VIDEO_QUEUE queue, PRTP_PACKET packet, int length, PRTPV_
 
         queue->stats.packetCountVideo += queue->bufferDataPackets;
         queue->stats.packetCountFec += queue->bufferParityPackets;
+
+        // Grow the slots to fit this FEC block. They are kept for later blocks.
+        uint32_t totalPackets = queue->bufferDataPackets + queue->bufferParityPackets;
+        if (totalPackets > queue->pendingFecBlockSlotCount) {
+            queue->pendingFecBlockSlots = extendBuffer(queue->pendingFecBlockSlots, totalPackets * sizeof(PRTPV_QUEUE_ENTRY));
+            if (queue->pendingFecBlockSlots == NULL) {
+                // The next packet will try again, since none are pending
+                queue->pendingFecBlockSlotCount = 0;
+                return RTPF_RET_REJECTED;
+            }
+
+            memset(&queue->pendingFecBlockSlots[queue->pendingFecBlockSlotCount], 0,
+                   (totalPackets - queue->pendingFecBlockSlotCount) * sizeof(PRTPV_QUEUE_ENTRY));
+            queue->pendingFecBlockSlotCount = totalPackets;
+        }
     }
 
     // Reject packets above our FEC queue valid sequence number range
@@ -735,7 +800,7 @@ int RtpvAddPacket(PRTP_VIDEO_QUEUE queue, PRTP_PACKET packet, int length, PRTPV_
     }
     else {
         // Update total missing packet count
-        if (queue->pendingFecBlockList.count == 1) {
+        if (queue->pendingFecBlockCount == 1) {
             // Initialize counts and highest seqnum on the first packet
             LC_ASSERT(queue->missingPackets == 0);
             LC_ASSERT(queue->receivedHighestSequenceNumber == 0);
@@ -774,9 +839,8 @@ int RtpvAddPacket(PRTP_VIDEO_QUEUE queue, PRTP_PACKET packet, int length, PRTPV_
             stageCompleteFecBlock(queue);
 
             // stageCompleteFecBlock() should have consumed all pending FEC data
-            LC_ASSERT(queue->pendingFecBlockList.head == NULL);
-            LC_ASSERT(queue->pendingFecBlockList.tail == NULL);
-            LC_ASSERT(queue->pendingFecBlockList.count == 0);
+            LC_ASSERT(queue->pendingFecBlockCount == 0);
+            LC_ASSERT(queue->pendingFecBlockFirstEntry == NULL);
 
             // If we're not yet at the last FEC block for this frame, move on to the next block.
             // Otherwise, the frame is complete and we can move on to the next frame.
@@ -785,9 +849,16 @@ int RtpvAddPacket(PRTP_VIDEO_QUEUE queue, PRTP_PACKET packet, int length, PRTPV_
                 queue->multiFecCurrentBlockNumber++;
             }
             else {
+                uint64_t frameCompleteTimeUs = PltGetMicroseconds();
+
+                addVideoTimingSample(&VideoTimingStats.frameReceive, frameCompleteTimeUs - queue->frameFirstRecvTimeUs);
+
                 // Submit all FEC blocks to the depacketizer
                 submitCompletedFrame(queue);
 
+                // The depacketizer reassembles and queues the frame synchronously
+                addVideoTimingSample(&VideoTimingStats.reassembly, PltGetMicroseconds() - frameCompleteTimeUs);
+
                 // submitCompletedFrame() should have consumed all completed FEC data
                 LC_ASSERT(queue->completedFecBlockList.head == NULL);
                 LC_ASSERT(queue->completedFecBlockList.tail == NULL);
@@ -2,6 +2,8 @@
 
 #include "Video.h"
 
+#include "rs.h"
+
 typedef struct _RTPV_QUEUE_ENTRY {
     struct _RTPV_QUEUE_ENTRY* next;
     struct _RTPV_QUEUE_ENTRY* prev;
@@ -19,11 +21,27 @@ typedef struct _RTPV_QUEUE_LIST {
     uint32_t count;
 } RTPV_QUEUE_LIST, *PRTPV_QUEUE_LIST;
 
+// Number of FEC block shapes (data and parity shard counts)
+// whose Reed-Solomon contexts are kept for reuse
+#define RTPV_RS_CACHE_SIZE 4
+
+typedef struct _RTPV_RS_CACHE_ENTRY {
+    reed_solomon* rs;
+    uint32_t lastUsed;
+} RTPV_RS_CACHE_ENTRY, *PRTPV_RS_CACHE_ENTRY;
+
 typedef struct _RTP_VIDEO_QUEUE {
-    RTPV_QUEUE_LIST pendingFecBlockList;
+    // Packets of the current FEC block, indexed by their sequence number
+    // offset from bufferLowestSequenceNumber
+    PRTPV_QUEUE_ENTRY* pendingFecBlockSlots;
+    uint32_t pendingFecBlockSlotCount;
+    uint32_t pendingFecBlockCount;
+    PRTPV_QUEUE_ENTRY pendingFecBlockFirstEntry; // first one received
+
     RTPV_QUEUE_LIST completedFecBlockList;
 
     uint64_t bufferFirstRecvTimeUs;
+    uint64_t frameFirstRecvTimeUs;
     uint32_t bufferLowestSequenceNumber;
     uint32_t bufferHighestSequenceNumber;
     uint32_t bufferFirstParitySequenceNumber;
@@ -48,6 +66,15 @@ typedef struct _RTP_VIDEO_QUEUE {
     bool receivedOosData;
 
     RTP_VIDEO_STATS stats; // the above values are short-lived, this tracks stats for the life of the queue
+
+    // Building a Reed-Solomon context inverts its encoding matrix, so keep
+    // the most recently used ones rather than rebuilding them for each recovery
+    RTPV_RS_CACHE_ENTRY rsCache[RTPV_RS_CACHE_SIZE];
+    uint32_t rsCacheClock;
+
+    // Shard pointers and erasure marks for FEC recovery
+    unsigned char* fecShards[DATA_SHARDS_MAX];
+    unsigned char fecMarks[DATA_SHARDS_MAX];
 } RTP_VIDEO_QUEUE, *PRTP_VIDEO_QUEUE;
 
 #define RTPF_RET_QUEUED    0
@@ -55,6 +82,6 @@ typedef struct _RTP_VIDEO_QUEUE {
 
 void RtpvInitializeQueue(PRTP_VIDEO_QUEUE queue);
 void RtpvCleanupQueue(PRTP_VIDEO_QUEUE queue);
-int RtpvAddPacket(PRTP_VIDEO_QUEUE queue, PRTP_PACKET packet, int length, PRTPV_QUEUE_ENTRY packetEntry);
+int RtpvAddPacket(PRTP_VIDEO_QUEUE queue, PRTP_PACKET packet, int length, uint64_t receiveTimeUs, PRTPV_QUEUE_ENTRY packetEntry);
 uint32_t RtpvGetCurrentFrameNumber(PRTP_VIDEO_QUEUE queue);
 void RtpvSubmitQueuedPackets(PRTP_VIDEO_QUEUE queue);
@@ -20,6 +20,8 @@ static PPLT_CRYPTO_CONTEXT decryptionCtx;
 static uint32_t encryptionSequenceNumber;
 
 static SOCKET sock = INVALID_SOCKET;
+static SOCKET nextSock = INVALID_SOCKET;
+static bool preconnectRtspSockets;
 static ENetHost* client;
 static ENetPeer* peer;
 
@@ -386,6 +388,13 @@ static bool transactRtspMessageTcp(PRTSP_MESSAGE request, PRTSP_MESSAGE response
     responseBuffer = NULL;
     connectRetries = 0;
 
+    // Use the connection we opened while waiting for the previous response, if any
+    if (nextSock != INVALID_SOCKET) {
+        sock = nextSock;
+        nextSock = INVALID_SOCKET;
+        goto Connected;
+    }
+
     // Retry up to 10 seconds if we receive ECONNREFUSED errors from the host PC.
     // This can happen with GFE 3.22 when initially launching a session because it
     // returns HTTP 200 OK for the /launch request before the RTSP handshake port
@@ -412,6 +421,7 @@ static bool transactRtspMessageTcp(PRTSP_MESSAGE request, PRTSP_MESSAGE response
         return ret;
     }
 
+Connected:
     serializedMessage = sealRtspMessage(request, &messageLen);
     if (serializedMessage == NULL) {
         closeSocket(sock);
@@ -429,6 +439,16 @@ static bool transactRtspMessageTcp(PRTSP_MESSAGE request, PRTSP_MESSAGE response
         goto Exit;
     }
 
+    // The host closes the connection after each response, so every request needs a new
+    // one. Connecting for the next request while this response is in flight saves a
+    // round trip per request. PLAY is the last request of the handshake.
+    if (preconnectRtspSockets && strcmp(request->message.request.command, "PLAY") != 0) {
+        LC_ASSERT(nextSock == INVALID_SOCKET);
+
+        // If this fails, the next request will just connect (and retry) as usual
+        nextSock = connectTcpSocket(&RemoteAddr, AddrLen, RtspPortNumber, RTSP_CONNECT_TIMEOUT_SEC);
+    }
+
     // Read the response until the server closes the connection
     offset = 0;
     responseBufferSize = 0;
@@ -936,6 +956,10 @@ int performRtspHandshake(PSERVER_INFORMATION serverInfo) {
     useEnet = (AppVersionQuad[0] >= 5) && (AppVersionQuad[0] <= 7) && (AppVersionQuad[2] < 404);
     currentSeqNumber = 1;
     hasSessionId = false;
+
+    // Sunshine handles each RTSP connection independently, so it is safe to have
+    // the next connection open before the current request has been answered.
+    preconnectRtspSockets = !useEnet && IS_SUNSHINE();
     controlStreamId = APP_VERSION_AT_LEAST(7, 1, 431) ? "streamid=control/13/0" : "streamid=control/1/0";
     AudioEncryptionEnabled = false;
     encryptedRtspEnabled = serverInfo->rtspSessionUrl && strstr(serverInfo->rtspSessionUrl, "rtspenc://");
@@ -1030,7 +1054,9 @@ int performRtspHandshake(PSERVER_INFORMATION serverInfo) {
         enet_host_flush(client);
     }
 
-    {
+    // Sunshine doesn't need OPTIONS and we don't use anything in its response.
+    // Skip it to save a round trip.
+    if (!IS_SUNSHINE()) {
         RTSP_MESSAGE response;
         int error = -1;
 
@@ -1393,6 +1419,12 @@ int performRtspHandshake(PSERVER_INFORMATION serverInfo) {
     ret = 0;
 
 Exit:
+    // Close the connection we may have opened for a request that we won't send
+    if (nextSock != INVALID_SOCKET) {
+        closeSocket(nextSock);
+        nextSock = INVALID_SOCKET;
+    }
+
     // Cleanup the ENet stuff
     if (useEnet) {
         if (peer != NULL) {
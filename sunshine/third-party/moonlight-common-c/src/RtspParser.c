@@ -69,6 +69,9 @@ int parseRtspMessage(PRTSP_MESSAGE msg, char* rtspMessage, int length) {
     int statusCode = 0;
     int sequenceNum;
     int exitCode;
+    int maxOptionCount;
+    int optionCount = 0;
+    POPTION_ITEM optionItems;
     POPTION_ITEM options = NULL;
     POPTION_ITEM newOpt;
 
@@ -78,12 +81,23 @@ int parseRtspMessage(PRTSP_MESSAGE msg, char* rtspMessage, int length) {
     char* optDelim = " :\r\n";
     char typeFlag = TOKEN_OPTION;
 
-    // Put the raw message into a string we can use
-    char* messageBuffer = malloc(length + 1);
-    if (messageBuffer == NULL) {
-        exitCode = RTSP_ERROR_NO_MEMORY;
-        goto ExitFailure;
+    // Each option takes a line, so the line count bounds the number of options
+    maxOptionCount = 0;
+    for (int i = 0; i < length; i++) {
+        if (rtspMessage[i] == '\n') {
+            maxOptionCount++;
+        }
+    }
+
+    // The options and the raw message share a single allocation. The option
+    // items come first, so they are suitably aligned.
+    optionItems = malloc(maxOptionCount * sizeof(OPTION_ITEM) + length + 1);
+    if (optionItems == NULL) {
+        return RTSP_ERROR_NO_MEMORY;
     }
+
+    // Put the raw message into a string we can use
+    char* messageBuffer = (char*)&optionItems[maxOptionCount];
     memcpy(messageBuffer, rtspMessage, length);
 
     // The payload logic depends on a null-terminator at the end
@@ -154,11 +168,11 @@ int parseRtspMessage(PRTSP_MESSAGE msg, char* rtspMessage, int length) {
             // The token is content
             else {
                 // Create a new node containing the option and content
-                newOpt = (POPTION_ITEM)malloc(sizeof(OPTION_ITEM));
-                if (newOpt == NULL) {
-                    exitCode = RTSP_ERROR_NO_MEMORY;
+                if (optionCount == maxOptionCount) {
+                    exitCode = RTSP_ERROR_MALFORMED;
                     goto ExitFailure;
                 }
+                newOpt = &optionItems[optionCount++];
                 newOpt->flags = 0;
                 newOpt->option = opt;
                 newOpt->content = token + 1; // Skip the protocol defined blank space
@@ -214,24 +228,20 @@ int parseRtspMessage(PRTSP_MESSAGE msg, char* rtspMessage, int length) {
     else {
         sequenceNum = SEQ_INVALID;
     }
-    // Package the new parsed message into the struct
+    // Package the new parsed message into the struct. The option items are
+    // part of the message buffer allocation, so they aren't freed separately.
     if (flag == TYPE_REQUEST) {
-        createRtspRequest(msg, messageBuffer, FLAG_ALLOCATED_MESSAGE_BUFFER | FLAG_ALLOCATED_OPTION_ITEMS, command, target,
+        createRtspRequest(msg, (char*)optionItems, FLAG_ALLOCATED_MESSAGE_BUFFER, command, target,
             protocol, sequenceNum, options, payload, payload ? length - (int)(payload - messageBuffer) : 0);
     }
     else {
-        createRtspResponse(msg, messageBuffer, FLAG_ALLOCATED_MESSAGE_BUFFER | FLAG_ALLOCATED_OPTION_ITEMS, protocol, statusCode,
+        createRtspResponse(msg, (char*)optionItems, FLAG_ALLOCATED_MESSAGE_BUFFER, protocol, statusCode,
             statusStr, sequenceNum, options, payload, payload ? length - (int)(payload - messageBuffer) : 0);
     }
     return RTSP_ERROR_SUCCESS;
 
 ExitFailure:
-    if (options) {
-        freeOptionList(options);
-    }
-    if (messageBuffer) {
-        free(messageBuffer);
-    }
+    free(optionItems);
     return exitCode;
 }
 
@@ -321,14 +331,17 @@ void freeOptionList(POPTION_ITEM optionsHead) {
 }
 
 bool appendString(char* dest, int* destOffset, int* destRemainingLength, char* source) {
-    int ret = snprintf(&dest[*destOffset], *destRemainingLength, "%s", source);
-    if (ret < 0 || ret >= *destRemainingLength) {
+    // Always leave room for the null terminator
+    size_t len = strlen(source);
+    if (len >= (size_t)*destRemainingLength) {
         LC_ASSERT(false);
         return false;
     }
 
-    *destOffset += ret;
-    *destRemainingLength -= ret;
+    memcpy(&dest[*destOffset], source, len + 1);
+
+    *destOffset += (int)len;
+    *destRemainingLength -= (int)len;
     return true;
 }
 
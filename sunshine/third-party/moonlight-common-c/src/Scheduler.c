@@ -0,0 +1,140 @@
+#include "Scheduler.h"
+
+// The scheduler thread notices new tasks and shutdown within this period
+#define SCHEDULER_MAX_SLEEP_MS 50
+
+static PLT_THREAD schedulerThread;
+
+// Held while tasks run, so SchedRemoveTask() waits for a running task to finish
+static PLT_MUTEX schedulerMutex;
+
+// Sorted by deadline
+static PSCHEDULER_TASK taskList;
+
+// Called with schedulerMutex held
+static void insertTask(PSCHEDULER_TASK task) {
+    PSCHEDULER_TASK* link = &taskList;
+
+    // Tasks with equal deadlines run in the order they were scheduled
+    while (*link != NULL && (*link)->deadlineMs <= task->deadlineMs) {
+        link = &(*link)->next;
+    }
+
+    task->next = *link;
+    *link = task;
+    task->scheduled = true;
+}
+
+// Called with schedulerMutex held
+static void unlinkTask(PSCHEDULER_TASK task) {
+    PSCHEDULER_TASK* link = &taskList;
+
+    while (*link != NULL) {
+        if (*link == task) {
+            *link = task->next;
+            break;
+        }
+
+        link = &(*link)->next;
+    }
+
+    task->next = NULL;
+    task->scheduled = false;
+}
+
+static void schedulerThreadFunc(void* context) {
+    while (!PltIsThreadInterrupted(&schedulerThread)) {
+        uint64_t now;
+        int sleepMs = SCHEDULER_MAX_SLEEP_MS;
+
+        PltLockMutex(&schedulerMutex);
+
+        now = PltGetMillis();
+        while (taskList != NULL && taskList->deadlineMs <= now) {
+            PSCHEDULER_TASK task = taskList;
+
+            unlinkTask(task);
+
+            if (task->func(task->context) && task->intervalMs > 0) {
+                // Keep the original cadence unless we've fallen a whole interval behind
+                task->deadlineMs += task->intervalMs;
+                now = PltGetMillis();
+                if (task->deadlineMs <= now) {
+                    task->deadlineMs = now + task->intervalMs;
+                }
+
+                insertTask(task);
+            }
+            else {
+                now = PltGetMillis();
+            }
+        }
+
+        if (taskList != NULL && taskList->deadlineMs - now < (uint64_t)sleepMs) {
+            sleepMs = (int)(taskList->deadlineMs - now);
+        }
+
+        PltUnlockMutex(&schedulerMutex);
+
+        PltSleepMs(sleepMs);
+    }
+}
+
+int SchedStart(void) {
+    int err;
+
+    taskList = NULL;
+
+    err = PltCreateMutex(&schedulerMutex);
+    if (err != 0) {
+        return err;
+    }
+
+    err = PltCreateThread("Scheduler", PLT_THREAD_ROLE_DEFAULT, schedulerThreadFunc, NULL, &schedulerThread);
+    if (err != 0) {
+        PltDeleteMutex(&schedulerMutex);
+        return err;
+    }
+
+    return 0;
+}
+
+void SchedStop(void) {
+    // All tasks must be removed by their owners before they are torn down
+    LC_ASSERT(taskList == NULL);
+
+    PltInterruptThread(&schedulerThread);
+    PltJoinThread(&schedulerThread);
+
+    PltDeleteMutex(&schedulerMutex);
+}
+
+void SchedInitializeTask(PSCHEDULER_TASK task, SchedulerTaskFunc func, void* context, int intervalMs) {
+    memset(task, 0, sizeof(*task));
+    task->func = func;
+    task->context = context;
+    task->intervalMs = intervalMs;
+}
+
+void SchedAddTask(PSCHEDULER_TASK task, int delayMs) {
+    PltLockMutex(&schedulerMutex);
+
+    if (task->scheduled) {
+        unlinkTask(task);
+    }
+
+    task->deadlineMs = PltGetMillis() + delayMs;
+    insertTask(task);
+
+    PltUnlockMutex(&schedulerMutex);
+}
+
+void SchedRemoveTask(PSCHEDULER_TASK task) {
+    PltLockMutex(&schedulerMutex);
+
+    if (task->scheduled) {
+        unlinkTask(task);
+    }
+
+    PltUnlockMutex(&schedulerMutex);
+}
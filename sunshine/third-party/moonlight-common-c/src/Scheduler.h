@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Platform.h"
+#include "PlatformThreads.h"
+
+// A single thread that runs the periodic and deferred work of the connection
+// (pings, loss reports) instead of each stream sleeping in its own thread.
+// Tasks run one at a time on the scheduler thread and must not block.
+
+// Return false to stop the task from being rescheduled
+typedef bool(*SchedulerTaskFunc)(void* context);
+
+typedef struct _SCHEDULER_TASK {
+    SchedulerTaskFunc func;
+    void* context;
+    int intervalMs;
+    uint64_t deadlineMs;
+    bool scheduled;
+    struct _SCHEDULER_TASK* next;
+} SCHEDULER_TASK, *PSCHEDULER_TASK;
+
+int SchedStart(void);
+void SchedStop(void);
+
+// An interval of 0 makes a one-shot task
+void SchedInitializeTask(PSCHEDULER_TASK task, SchedulerTaskFunc func, void* context, int intervalMs);
+void SchedAddTask(PSCHEDULER_TASK task, int delayMs);
+
+// Once this returns, the task is not running and will not run again
+void SchedRemoveTask(PSCHEDULER_TASK task);
@@ -0,0 +1,166 @@
+// Annex B start code scanning for H.264 and HEVC
+//
+// High bitrate frames are mostly slice data, which can't contain a start code
+// thanks to emulation prevention, so the depacketizer spends its time looking
+// for the next 00 00 01 across many kilobytes. The vector kernels compare 16 or
+// 32 positions at a time, using one load per byte of the start code, and fall
+// back to the scalar scan for the tail.
+
+#include "Limelight-internal.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define SCAN_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define SCAN_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SCAN_TARGET(x) __attribute__((target(x)))
+#else
+#define SCAN_TARGET(x)
+#endif
+
+unsigned int findAnnexBStartCodeScalar(const unsigned char* data, unsigned int length) {
+    unsigned int i = 0;
+
+    while (i + 3 <= length) {
+        if (data[i + 2] > 1) {
+            // No start code can begin at i, i + 1 or i + 2
+            i += 3;
+        }
+        else if (data[i + 2] == 1 && data[i + 1] == 0 && data[i] == 0) {
+            return i;
+        }
+        else {
+            i++;
+        }
+    }
+
+    return length;
+}
+
+#if defined(SCAN_X86)
+static int lowestBit(unsigned int mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (int)index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+SCAN_TARGET("sse2")
+static unsigned int findStartCodeSse2(const unsigned char* data, unsigned int length) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi8(1);
+    unsigned int i;
+
+    for (i = 0; i + 18 <= length; i += 16) {
+        __m128i z0 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)&data[i]), zero);
+        __m128i z1 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)&data[i + 1]), zero);
+        __m128i o2 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)&data[i + 2]), one);
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_and_si128(_mm_and_si128(z0, z1), o2));
+
+        if (mask != 0) {
+            return i + lowestBit(mask);
+        }
+    }
+
+    return i + findAnnexBStartCodeScalar(&data[i], length - i);
+}
+
+SCAN_TARGET("avx2")
+static unsigned int findStartCodeAvx2(const unsigned char* data, unsigned int length) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi8(1);
+    unsigned int i;
+
+    for (i = 0; i + 34 <= length; i += 32) {
+        __m256i z0 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)&data[i]), zero);
+        __m256i z1 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)&data[i + 1]), zero);
+        __m256i o2 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)&data[i + 2]), one);
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(_mm256_and_si256(_mm256_and_si256(z0, z1), o2));
+
+        if (mask != 0) {
+            return i + lowestBit(mask);
+        }
+    }
+
+    return i + findAnnexBStartCodeScalar(&data[i], length - i);
+}
+
+static bool cpuHasSse2(void) {
+#if defined(__x86_64__) || defined(_M_X64)
+    // Part of the x86-64 baseline
+    return true;
+#elif defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
+#else
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+
+static bool cpuHasAvx2(void) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    // The OS must also save the YMM registers (OSXSAVE and XCR0)
+    if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 || (_xgetbv(0) & 6) != 6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#elif defined(SCAN_NEON)
+static unsigned int findStartCodeNeon(const unsigned char* data, unsigned int length) {
+    const uint8x16_t zero = vdupq_n_u8(0);
+    const uint8x16_t one = vdupq_n_u8(1);
+    unsigned int i;
+
+    for (i = 0; i + 18 <= length; i += 16) {
+        uint8x16_t z0 = vceqq_u8(vld1q_u8(&data[i]), zero);
+        uint8x16_t z1 = vceqq_u8(vld1q_u8(&data[i + 1]), zero);
+        uint8x16_t o2 = vceqq_u8(vld1q_u8(&data[i + 2]), one);
+
+        // There's no movemask, so let the scalar scan locate the match
+        // within these 16 positions
+        if (vmaxvq_u8(vandq_u8(vandq_u8(z0, z1), o2)) != 0) {
+            break;
+        }
+    }
+
+    return i + findAnnexBStartCodeScalar(&data[i], length - i);
+}
+#endif
+
+#if defined(SCAN_NEON)
+static unsigned int (*findStartCode)(const unsigned char* data, unsigned int length) = findStartCodeNeon;
+#else
+static unsigned int (*findStartCode)(const unsigned char* data, unsigned int length) = findAnnexBStartCodeScalar;
+#endif
+
+void initializeStartCodeScanner(void) {
+#if defined(SCAN_X86)
+    if (cpuHasAvx2()) {
+        findStartCode = findStartCodeAvx2;
+    }
+    else if (cpuHasSse2()) {
+        findStartCode = findStartCodeSse2;
+    }
+#endif
+}
+
+unsigned int findAnnexBStartCode(const unsigned char* data, unsigned int length) {
+    return findStartCode(data, length);
+}
@@ -5,6 +5,9 @@
 typedef struct _QUEUED_DECODE_UNIT {
     DECODE_UNIT decodeUnit;
     LINKED_BLOCKING_QUEUE_ENTRY entry;
+
+    // Frame buffer holding the data with CAPABILITY_CONTIGUOUS_DECODE_UNITS
+    void* frameBuffer;
 } QUEUED_DECODE_UNIT, *PQUEUED_DECODE_UNIT;
 
 #pragma pack(push, 1)
@@ -34,6 +37,15 @@ typedef struct _NV_VIDEO_PACKET {
 
 #define FLAG_EXTENSION 0x10
 
+// With LI_FF_FRAME_NAL_INFO, bytes 6 and 7 of the frame header describe the
+// H.264/HEVC payload of the frame when FRAME_NAL_INFO_VALID is set. The payload
+// then starts with a start sequence, has no AUD or SEI NALUs, and is made of the
+// given number of parameter set NALUs (only on IDR frames) followed by the
+// picture data.
+#define FRAME_NAL_INFO_FLAGS_OFFSET 6
+#define FRAME_NAL_INFO_PARAM_SETS_OFFSET 7
+#define FRAME_NAL_INFO_VALID 0x01
+
 #define FIXED_RTP_HEADER_SIZE 12
 #define MAX_RTP_HEADER_SIZE 16
 
@@ -67,4 +79,9 @@ typedef struct _SS_FRAME_FEC_STATUS {
     uint8_t multiFecBlockCount;
 } SS_FRAME_FEC_STATUS, *PSS_FRAME_FEC_STATUS;
 
+#define SS_FEC_REQUEST_PTYPE 0x5503
+typedef struct _SS_FEC_REQUEST {
+    uint8_t fecPercentage;
+} SS_FEC_REQUEST, *PSS_FEC_REQUEST;
+
 #pragma pack(pop)
@@ -24,6 +24,18 @@ static uint64_t firstPacketPresentationTime;
 static uint32_t firstPacketRtpTimestamp;
 static bool dropStatePending;
 static bool idrFrameProcessed;
+static bool frameNalInfoNegotiated;
+static int64_t minCaptureTimeOffsetUs;
+static bool captureTimeOffsetValid;
+
+// With CAPABILITY_DROP_STALE_FRAMES, a frame is stale when it has been queued for
+// this many frame intervals while newer frames are pending
+#define STALE_FRAME_QUEUE_INTERVALS 3
+
+// Set by the renderer thread when it drops stale frames to catch up. The receive
+// thread invalidates from catchUpStartFrame on the next frame boundary.
+static PLT_ATOMIC_INT catchUpPending;
+static PLT_ATOMIC_INT catchUpStartFrame;
 
 #define DR_CLEANUP -1000
 
@@ -32,6 +44,11 @@ static unsigned int consecutiveFrameDrops;
 
 static LINKED_BLOCKING_QUEUE decodeUnitQueue;
 
+// Decode units are recycled once completed. This covers a full decode
+// unit queue plus the ones being decoded.
+#define DECODE_UNITS_POOLED 32
+static BUFFER_POOL decodeUnitPool;
+
 typedef struct _BUFFER_DESC {
     char* data;
     unsigned int offset;
@@ -43,6 +60,27 @@ typedef struct _LENTRY_INTERNAL {
     void* allocPtr;
 } LENTRY_INTERNAL, *PLENTRY_INTERNAL;
 
+// With CAPABILITY_CONTIGUOUS_DECODE_UNITS, the fragments of a frame are copied back to
+// back into a single growable buffer instead of keeping the packet buffers. The entries
+// of the NAL chain then live in the frame buffer and point into its data.
+#define FRAME_BUFFER_ENTRIES_MAX 8
+#define FRAME_BUFFER_INITIAL_SIZE (256 * 1024)
+#define FRAME_BUFFER_PADDING 64
+#define FRAME_BUFFERS_POOLED 4
+
+typedef struct _FRAME_BUFFER {
+    LINKED_BLOCKING_QUEUE_ENTRY entry;
+    char* data;
+    int length;
+    int capacity;
+    int entryCount;
+    LENTRY_INTERNAL entries[FRAME_BUFFER_ENTRIES_MAX];
+} FRAME_BUFFER, *PFRAME_BUFFER;
+
+static bool contiguousFrames;
+static PFRAME_BUFFER currentFrameBuffer;
+static LINKED_BLOCKING_QUEUE frameBufferFreeList;
+
 #define H264_NAL_TYPE(x) ((x) & 0x1F)
 #define HEVC_NAL_TYPE(x) (((x) & 0x7E) >> 1)
 
@@ -61,6 +99,11 @@ typedef struct _LENTRY_INTERNAL {
 // Init
 void initializeVideoDepacketizer(int pktSize) {
     LbqInitializeLinkedBlockingQueue(&decodeUnitQueue, 15);
+    BpInitializePool(&decodeUnitPool, sizeof(QUEUED_DECODE_UNIT), DECODE_UNITS_POOLED);
+    LbqInitializeLinkedBlockingQueue(&frameBufferFreeList, FRAME_BUFFERS_POOLED);
+
+    contiguousFrames = !!(VideoCallbacks.capabilities & CAPABILITY_CONTIGUOUS_DECODE_UNITS);
+    currentFrameBuffer = NULL;
 
     nextFrameNumber = 1;
     startFrameNumber = 0;
@@ -77,7 +120,45 @@ void initializeVideoDepacketizer(int pktSize) {
     lastPacketPayloadLength = 0;
     dropStatePending = false;
     idrFrameProcessed = false;
+    minCaptureTimeOffsetUs = 0;
+    captureTimeOffsetValid = false;
+    PltAtomicStore(&catchUpPending, 0);
+    PltAtomicStore(&catchUpStartFrame, 0);
     strictIdrFrameWait = !isReferenceFrameInvalidationEnabled();
+    frameNalInfoNegotiated = IS_SUNSHINE() && (SunshineFeatureFlags & LI_FF_FRAME_NAL_INFO);
+
+    initializeStartCodeScanner();
+}
+
+static PFRAME_BUFFER allocFrameBuffer(void) {
+    PFRAME_BUFFER frameBuffer;
+
+    // Grab an entry from the free list (if available)
+    if (LbqPollQueueElement(&frameBufferFreeList, (void**)&frameBuffer) != LBQ_SUCCESS) {
+        frameBuffer = malloc(sizeof(*frameBuffer));
+        if (frameBuffer == NULL) {
+            return NULL;
+        }
+
+        frameBuffer->data = malloc(FRAME_BUFFER_INITIAL_SIZE + FRAME_BUFFER_PADDING);
+        if (frameBuffer->data == NULL) {
+            free(frameBuffer);
+            return NULL;
+        }
+        frameBuffer->capacity = FRAME_BUFFER_INITIAL_SIZE;
+    }
+
+    frameBuffer->length = 0;
+    frameBuffer->entryCount = 0;
+    return frameBuffer;
+}
+
+static void freeFrameBuffer(PFRAME_BUFFER frameBuffer) {
+    // Place the frame buffer back into the free list, keeping its data allocation
+    if (LbqOfferQueueItem(&frameBufferFreeList, frameBuffer, &frameBuffer->entry) != LBQ_SUCCESS) {
+        free(frameBuffer->data);
+        free(frameBuffer);
+    }
 }
 
 // Free the NAL chain
@@ -87,7 +168,16 @@ static void cleanupFrameState(void) {
     while (nalChainHead != NULL) {
         lastEntry = (PLENTRY_INTERNAL)nalChainHead;
         nalChainHead = lastEntry->entry.next;
-        free(lastEntry->allocPtr);
+
+        // Frame buffer entries have no allocation of their own
+        if (lastEntry->allocPtr != NULL) {
+            freeVideoPacketBuffer(lastEntry->allocPtr);
+        }
+    }
+
+    if (currentFrameBuffer != NULL) {
+        freeFrameBuffer(currentFrameBuffer);
+        currentFrameBuffer = NULL;
     }
 
     nalChainTail = NULL;
@@ -97,12 +187,24 @@ static void cleanupFrameState(void) {
 
 // Cleanup frame state and set that we're waiting for an IDR Frame
 static void dropFrameState(void) {
+    int expected;
+
     // This may only be called at frame boundaries
     LC_ASSERT(!decodingFrame);
 
     // We're dropping frame state now
     dropStatePending = false;
 
+    // If the renderer dropped queued frames to catch up, the host must not reference
+    // them either, so widen the RFI window back to the first of them
+    expected = 1;
+    if (PltAtomicCompareExchange(&catchUpPending, &expected, 0)) {
+        unsigned int catchUpFrame = (unsigned int)PltAtomicLoad(&catchUpStartFrame);
+        if (isBefore32(catchUpFrame, startFrameNumber)) {
+            startFrameNumber = catchUpFrame;
+        }
+    }
+
     if (strictIdrFrameWait || !idrFrameProcessed || waitingForIdrFrame) {
         // We'll need an IDR frame now if we're in non-RFI mode, if we've never
         // received an IDR frame, or if we explicitly need an IDR frame.
@@ -150,8 +252,22 @@ void stopVideoDepacketizer(void) {
 
 // Cleanup video depacketizer and free malloced memory
 void destroyVideoDepacketizer(void) {
+    PLINKED_BLOCKING_QUEUE_ENTRY entry;
+
     freeDecodeUnitList(LbqDestroyLinkedBlockingQueue(&decodeUnitQueue));
     cleanupFrameState();
+    BpDestroyPool(&decodeUnitPool);
+
+    LbqSignalQueueShutdown(&frameBufferFreeList);
+    entry = LbqDestroyLinkedBlockingQueue(&frameBufferFreeList);
+    while (entry != NULL) {
+        PFRAME_BUFFER frameBuffer = entry->data;
+
+        // The entry is stored in the frame buffer
+        entry = entry->flink;
+        free(frameBuffer->data);
+        free(frameBuffer);
+    }
 }
 
 // NB: This function also ensures an additional byte for the NALU type exists after the start sequence
@@ -233,15 +349,64 @@ void validateDecodeUnitForPlayback(PDECODE_UNIT decodeUnit) {
     }
 }
 
+// Drops the dequeued frame if the renderer has fallen behind the stream. Returns false
+// if the frame was dropped and the caller must dequeue another one.
+static bool catchUpStaleFrames(PQUEUED_DECODE_UNIT* qdu) {
+    PQUEUED_DECODE_UNIT nextQdu;
+    uint64_t staleTimeUs;
+
+    if (!(VideoCallbacks.capabilities & CAPABILITY_DROP_STALE_FRAMES) || LbqGetItemCount(&decodeUnitQueue) == 0) {
+        return true;
+    }
+
+    // Nothing before a queued IDR frame is needed to decode it, so skip straight to it
+    while (LbqPeekQueueElement(&decodeUnitQueue, (void**)&nextQdu) == LBQ_SUCCESS &&
+           nextQdu->decodeUnit.frameType == FRAME_TYPE_IDR) {
+        // The queue may be flushed by the receive thread after our peek
+        if (LbqPollQueueElement(&decodeUnitQueue, (void**)&nextQdu) != LBQ_SUCCESS) {
+            break;
+        }
+
+        Limelog("Skipping frame %d to catch up with queued IDR frame %d\n",
+                (*qdu)->decodeUnit.frameNumber, nextQdu->decodeUnit.frameNumber);
+        LiCompleteVideoFrame(*qdu, DR_CLEANUP);
+        *qdu = nextQdu;
+    }
+
+    staleTimeUs = (uint64_t)STALE_FRAME_QUEUE_INTERVALS * 1000000 / (StreamConfig.fps > 0 ? StreamConfig.fps : 60);
+    if (LbqGetItemCount(&decodeUnitQueue) == 0 ||
+            PltGetMicroseconds() - (*qdu)->decodeUnit.enqueueTimeUs < staleTimeUs) {
+        return true;
+    }
+
+    Limelog("Renderer is %d frames behind; dropping queued frames to catch up\n",
+            LbqGetItemCount(&decodeUnitQueue) + 1);
+
+    // Have the receive thread drop the frames that follow and ask the host to recover
+    // from before the first frame we're dropping. This must happen before flushing
+    // the queue so no frame that depends on the dropped ones is queued afterwards.
+    PltAtomicStore(&catchUpStartFrame, (*qdu)->decodeUnit.frameNumber);
+    PltAtomicStore(&catchUpPending, 1);
+    dropStatePending = true;
+
+    LiCompleteVideoFrame(*qdu, DR_CLEANUP);
+    freeDecodeUnitList(LbqFlushQueueItems(&decodeUnitQueue));
+    *qdu = NULL;
+    return false;
+}
+
 bool LiWaitForNextVideoFrame(VIDEO_FRAME_HANDLE* frameHandle, PDECODE_UNIT* decodeUnit) {
     PQUEUED_DECODE_UNIT qdu;
 
-    int err = LbqWaitForQueueElement(&decodeUnitQueue, (void**)&qdu);
-    if (err != LBQ_SUCCESS) {
-        return false;
-    }
+    do {
+        int err = LbqWaitForQueueElement(&decodeUnitQueue, (void**)&qdu);
+        if (err != LBQ_SUCCESS) {
+            return false;
+        }
+    } while (!catchUpStaleFrames(&qdu));
 
     validateDecodeUnitForPlayback(&qdu->decodeUnit);
+    addVideoTimingSample(&VideoTimingStats.queueWait, PltGetMicroseconds() - qdu->decodeUnit.enqueueTimeUs);
 
     *frameHandle = qdu;
     *decodeUnit = &qdu->decodeUnit;
@@ -251,12 +416,15 @@ bool LiWaitForNextVideoFrame(VIDEO_FRAME_HANDLE* frameHandle, PDECODE_UNIT* deco
 bool LiPollNextVideoFrame(VIDEO_FRAME_HANDLE* frameHandle, PDECODE_UNIT* decodeUnit) {
     PQUEUED_DECODE_UNIT qdu;
 
-    int err = LbqPollQueueElement(&decodeUnitQueue, (void**)&qdu);
-    if (err != LBQ_SUCCESS) {
-        return false;
-    }
+    do {
+        int err = LbqPollQueueElement(&decodeUnitQueue, (void**)&qdu);
+        if (err != LBQ_SUCCESS) {
+            return false;
+        }
+    } while (!catchUpStaleFrames(&qdu));
 
     validateDecodeUnitForPlayback(&qdu->decodeUnit);
+    addVideoTimingSample(&VideoTimingStats.queueWait, PltGetMicroseconds() - qdu->decodeUnit.enqueueTimeUs);
 
     *frameHandle = qdu;
     *decodeUnit = &qdu->decodeUnit;
@@ -299,12 +467,18 @@ void LiCompleteVideoFrame(VIDEO_FRAME_HANDLE handle, int drStatus) {
     while (qdu->decodeUnit.bufferList != NULL) {
         lastEntry = (PLENTRY_INTERNAL)qdu->decodeUnit.bufferList;
         qdu->decodeUnit.bufferList = lastEntry->entry.next;
-        free(lastEntry->allocPtr);
+        if (lastEntry->allocPtr != NULL) {
+            freeVideoPacketBuffer(lastEntry->allocPtr);
+        }
+    }
+
+    if (qdu->frameBuffer != NULL) {
+        freeFrameBuffer(qdu->frameBuffer);
     }
 
     // We will have stack-allocated entries iff we have a direct-submit decoder
     if ((VideoCallbacks.capabilities & CAPABILITY_DIRECT_SUBMIT) == 0) {
-        free(qdu);
+        BpFreeBuffer(&decodeUnitPool, qdu);
     }
 }
 
@@ -426,16 +600,28 @@ static void skipToNextNalOrEnd(PBUFFER_DESC buffer) {
         buffer->length -= startSeq.length;
     }
 
-    // Loop until we find an Annex B start sequence (3 or 4 byte)
-    while (!getAnnexBStartSequence(buffer, NULL)) {
-        if (buffer->length == 0) {
-            // Reached the end of the buffer
+    // Find the next Annex B start sequence (3 or 4 byte). Like getAnnexBStartSequence(),
+    // we only accept one that is followed by the NALU type byte.
+    if (buffer->length > 3) {
+        unsigned int searchLength = buffer->length - 1;
+        unsigned int i = findAnnexBStartCode((unsigned char*)&buffer->data[buffer->offset], searchLength);
+
+        if (i < searchLength) {
+            // Include the leading zero of a 4 byte start sequence
+            if (i > 0 && buffer->data[buffer->offset + i - 1] == 0) {
+                i--;
+            }
+
+            buffer->offset += i;
+            buffer->length -= i;
+            LC_ASSERT(getAnnexBStartSequence(buffer, NULL));
             return;
         }
-
-        buffer->offset++;
-        buffer->length--;
     }
+
+    // Reached the end of the buffer
+    buffer->offset += buffer->length;
+    buffer->length = 0;
 }
 
 // Advance the buffer descriptor to the start of the next NAL
@@ -470,16 +656,24 @@ static void reassembleFrame(int frameNumber) {
     if (nalChainHead != NULL) {
         QUEUED_DECODE_UNIT qduDS;
         PQUEUED_DECODE_UNIT qdu;
+        int64_t captureTimeOffsetUs;
 
         // Use a stack allocation if we won't be queuing this
         if ((VideoCallbacks.capabilities & CAPABILITY_DIRECT_SUBMIT) == 0) {
-            qdu = (PQUEUED_DECODE_UNIT)malloc(sizeof(*qdu));
+            qdu = (PQUEUED_DECODE_UNIT)BpAllocBuffer(&decodeUnitPool);
         }
         else {
             qdu = &qduDS;
         }
 
         if (qdu != NULL) {
+            qdu->frameBuffer = currentFrameBuffer;
+            currentFrameBuffer = NULL;
+            if (qdu->frameBuffer != NULL) {
+                PFRAME_BUFFER frameBuffer = qdu->frameBuffer;
+                memset(&frameBuffer->data[frameBuffer->length], 0, FRAME_BUFFER_PADDING);
+            }
+
             qdu->decodeUnit.bufferList = nalChainHead;
             qdu->decodeUnit.fullLength = nalChainDataLength;
             qdu->decodeUnit.frameType = frameType;
@@ -490,6 +684,15 @@ static void reassembleFrame(int frameNumber) {
             qdu->decodeUnit.rtpTimestamp = firstPacketRtpTimestamp;
             qdu->decodeUnit.enqueueTimeUs = PltGetMicroseconds();
 
+            // The fastest frame so far approximates the offset between the host and local
+            // clocks, so frames that took longer show up as older than they should be.
+            captureTimeOffsetUs = (int64_t)(firstPacketReceiveTimeUs - firstPacketPresentationTime);
+            if (!captureTimeOffsetValid || captureTimeOffsetUs < minCaptureTimeOffsetUs) {
+                minCaptureTimeOffsetUs = captureTimeOffsetUs;
+                captureTimeOffsetValid = true;
+            }
+            qdu->decodeUnit.captureTimeUs = firstPacketPresentationTime + (uint64_t)minCaptureTimeOffsetUs;
+
             // These might be wrong for a few frames during a transition between SDR and HDR,
             // but the effects shouldn't very noticable since that's an infrequent operation.
             //
@@ -519,10 +722,11 @@ static void reassembleFrame(int frameNumber) {
                     // Clear NAL state for the frame that we failed to enqueue
                     nalChainHead = qdu->decodeUnit.bufferList;
                     nalChainDataLength = qdu->decodeUnit.fullLength;
+                    currentFrameBuffer = qdu->frameBuffer;
                     dropFrameState();
 
                     // Free the DU we were going to queue
-                    free(qdu);
+                    BpFreeBuffer(&decodeUnitPool, qdu);
 
                     // Free all frames in the decode unit queue
                     freeDecodeUnitList(LbqFlushQueueItems(&decodeUnitQueue));
@@ -600,13 +804,98 @@ static int getBufferFlags(char* data, int length) {
     }
 }
 
+static void linkFragmentEntry(PLENTRY_INTERNAL entry) {
+    nalChainDataLength += entry->entry.length;
+
+    if (nalChainTail == NULL) {
+        LC_ASSERT(nalChainHead == NULL);
+        nalChainHead = nalChainTail = (PLENTRY)entry;
+    }
+    else {
+        LC_ASSERT(nalChainHead != NULL);
+        nalChainTail->next = (PLENTRY)entry;
+        nalChainTail = nalChainTail->next;
+    }
+}
+
+// Copy the fragment at the end of the current frame buffer. The packet buffer is left
+// to the caller.
+static void appendFragment(char* data, int length) {
+    PFRAME_BUFFER frameBuffer;
+    PLENTRY_INTERNAL entry;
+    int bufferType;
+
+    if (currentFrameBuffer == NULL) {
+        currentFrameBuffer = allocFrameBuffer();
+        if (currentFrameBuffer == NULL) {
+            return;
+        }
+    }
+    frameBuffer = currentFrameBuffer;
+
+    if (frameBuffer->length + length > frameBuffer->capacity) {
+        int newCapacity = frameBuffer->capacity * 2;
+        char* newData;
+        int offset;
+        int i;
+
+        while (frameBuffer->length + length > newCapacity) {
+            newCapacity *= 2;
+        }
+
+        newData = realloc(frameBuffer->data, newCapacity + FRAME_BUFFER_PADDING);
+        if (newData == NULL) {
+            return;
+        }
+
+        frameBuffer->data = newData;
+        frameBuffer->capacity = newCapacity;
+
+        // Point the existing entries to the new allocation
+        offset = 0;
+        for (i = 0; i < frameBuffer->entryCount; i++) {
+            frameBuffer->entries[i].entry.data = &frameBuffer->data[offset];
+            offset += frameBuffer->entries[i].entry.length;
+        }
+    }
+
+    memcpy(&frameBuffer->data[frameBuffer->length], data, length);
+    bufferType = getBufferFlags(&frameBuffer->data[frameBuffer->length], length);
+    frameBuffer->length += length;
+
+    // Extend the last entry when it is picture data too (or if we're out of entries)
+    if (frameBuffer->entryCount != 0 &&
+        ((bufferType == BUFFER_TYPE_PICDATA && frameBuffer->entries[frameBuffer->entryCount - 1].entry.bufferType == BUFFER_TYPE_PICDATA) ||
+         frameBuffer->entryCount == FRAME_BUFFER_ENTRIES_MAX)) {
+        LC_ASSERT(nalChainTail == &frameBuffer->entries[frameBuffer->entryCount - 1].entry);
+        nalChainTail->length += length;
+        nalChainDataLength += length;
+        return;
+    }
+
+    entry = &frameBuffer->entries[frameBuffer->entryCount++];
+    entry->allocPtr = NULL;
+    entry->entry.next = NULL;
+    entry->entry.data = &frameBuffer->data[frameBuffer->length - length];
+    entry->entry.length = length;
+    entry->entry.bufferType = bufferType;
+    linkFragmentEntry(entry);
+}
+
 // As an optimization, we can cast the existing packet buffer to a PLENTRY and avoid
-// a malloc() and a memcpy() of the packet data.
+// an allocation and a memcpy() of the packet data.
 static void queueFragment(PLENTRY_INTERNAL* existingEntry, char* data, int offset, int length) {
     PLENTRY_INTERNAL entry;
 
+    if (contiguousFrames) {
+        appendFragment(&data[offset], length);
+        return;
+    }
+
     if (existingEntry == NULL || *existingEntry == NULL) {
-        entry = (PLENTRY_INTERNAL)malloc(sizeof(*entry) + length);
+        // A fragment never spans packets, so it always fits in a packet buffer
+        LC_ASSERT(sizeof(*entry) + length <= StreamConfig.packetSize + MAX_RTP_HEADER_SIZE + sizeof(RTPV_QUEUE_ENTRY));
+        entry = (PLENTRY_INTERNAL)allocVideoPacketBuffer();
     }
     else {
         entry = *existingEntry;
@@ -635,18 +924,7 @@ static void queueFragment(PLENTRY_INTERNAL* existingEntry, char* data, int offse
         }
 
         entry->entry.bufferType = getBufferFlags(entry->entry.data, entry->entry.length);
-
-        nalChainDataLength += entry->entry.length;
-
-        if (nalChainTail == NULL) {
-            LC_ASSERT(nalChainHead == NULL);
-            nalChainHead = nalChainTail = (PLENTRY)entry;
-        }
-        else {
-            LC_ASSERT(nalChainHead != NULL);
-            nalChainTail->next = (PLENTRY)entry;
-            nalChainTail = nalChainTail->next;
-        }
+        linkFragmentEntry(entry);
     }
 }
 
@@ -731,6 +1009,35 @@ void requestDecoderRefresh(void) {
     LiRequestIdrFrame();
 }
 
+// Process the first RTP payload of an IDR frame using the NALU layout provided by the host.
+// Only the parameter sets are walked, and the rest is queued as picture data.
+static void processAvcHevcRtpPayloadFast(PBUFFER_DESC currentPos, uint8_t parameterSetCount, PLENTRY_INTERNAL* existingEntry) {
+    // We should not have any NALUs when processing the first packet in an IDR frame
+    LC_ASSERT(nalChainHead == NULL);
+    LC_ASSERT(nalChainTail == NULL);
+
+    // No longer waiting for an IDR frame
+    waitingForIdrFrame = false;
+    waitingForRefInvalFrame = false;
+
+    // Cancel any pending IDR frame request
+    waitingForNextSuccessfulFrame = false;
+
+    frameType = FRAME_TYPE_IDR;
+
+    while (parameterSetCount-- > 0 && currentPos->length != 0) {
+        int start = currentPos->offset;
+
+        LC_ASSERT_VT(getAnnexBStartSequence(currentPos, NULL));
+        skipToNextNalOrEnd(currentPos);
+        queueFragment(NULL, currentPos->data, start, currentPos->offset - start);
+    }
+
+    if (currentPos->length != 0) {
+        queueFragment(existingEntry, currentPos->data, currentPos->offset, currentPos->length);
+    }
+}
+
 // Return 1 if packet is the first one in the frame
 static bool isFirstPacket(uint8_t flags, uint8_t fecBlockNumber) {
     // Clear the picture data flag
@@ -752,6 +1059,9 @@ static void processRtpPayload(PNV_VIDEO_PACKET videoPacket, int length,
     uint32_t streamPacketIndex;
     uint8_t fecCurrentBlockNumber;
     uint8_t fecLastBlockNumber;
+    bool frameNalInfoValid = false;
+    bool frameNalInfoIdr = false;
+    uint8_t frameNalInfoParamSets = 0;
 
     // Mask the top 8 bits from the SPI
     videoPacket->streamPacketIndex >>= 8;
@@ -897,7 +1207,16 @@ static void processRtpPayload(PNV_VIDEO_PACKET videoPacket, int length,
         if (IS_SUNSHINE() && currentPos.length >= 3) {
             BYTE_BUFFER bb;
             BbInitializeWrappedBuffer(&bb, currentPos.data, currentPos.offset + 1, 2, BYTE_ORDER_LITTLE);
-            BbGet16(&bb, &frameHostProcessingLatency);
+            frameHostProcessingLatency = BbGetLE16Unchecked(&bb);
+        }
+
+        // Sunshine can describe the H.264/HEVC NALU layout, which saves us from parsing the bitstream
+        if (frameNalInfoNegotiated && currentPos.length >= 8 &&
+                (currentPos.data[currentPos.offset + FRAME_NAL_INFO_FLAGS_OFFSET] & FRAME_NAL_INFO_VALID)) {
+            frameNalInfoValid = true;
+            frameNalInfoIdr = currentPos.data[currentPos.offset + 3] == 2;
+            frameNalInfoParamSets = (uint8_t)currentPos.data[currentPos.offset + FRAME_NAL_INFO_PARAM_SETS_OFFSET];
+            LC_ASSERT_VT(frameNalInfoIdr || frameNalInfoParamSets == 0);
         }
 
         // Codecs like H.264 and HEVC handle the FEC trailing zero padding just fine, but other
@@ -906,7 +1225,7 @@ static void processRtpPayload(PNV_VIDEO_PACKET videoPacket, int length,
         if (!(NegotiatedVideoFormat & (VIDEO_FORMAT_MASK_H264 | VIDEO_FORMAT_MASK_H265)) && currentPos.length >= 6) {
             BYTE_BUFFER bb;
             BbInitializeWrappedBuffer(&bb, currentPos.data, currentPos.offset + 4, 2, BYTE_ORDER_LITTLE);
-            BbGet16(&bb, &lastPacketPayloadLength);
+            lastPacketPayloadLength = BbGetLE16Unchecked(&bb);
         }
 
         if (APP_VERSION_AT_LEAST(7, 1, 450)) {
@@ -969,8 +1288,8 @@ static void processRtpPayload(PNV_VIDEO_PACKET videoPacket, int length,
             currentPos.length -= frameHeaderSize;
         }
 
-        // We only parse H.264 and HEVC at the NALU level
-        if (NegotiatedVideoFormat & (VIDEO_FORMAT_MASK_H264 | VIDEO_FORMAT_MASK_H265)) {
+        // We only parse H.264 and HEVC at the NALU level, unless the host did it for us
+        if ((NegotiatedVideoFormat & (VIDEO_FORMAT_MASK_H264 | VIDEO_FORMAT_MASK_H265)) && !frameNalInfoValid) {
             // The Annex B NALU start prefix must be next
             if (!getAnnexBStartSequence(&currentPos, NULL)) {
                 // If we aren't starting on a start prefix, something went wrong.
@@ -1001,7 +1320,15 @@ static void processRtpPayload(PNV_VIDEO_PACKET videoPacket, int length,
     }
 
     if (NegotiatedVideoFormat & (VIDEO_FORMAT_MASK_H264 | VIDEO_FORMAT_MASK_H265)) {
-        if (firstPacket && isIdrFrameStart(&currentPos)) {
+        if (frameNalInfoValid) {
+            if (frameNalInfoIdr) {
+                processAvcHevcRtpPayloadFast(&currentPos, frameNalInfoParamSets, existingEntry);
+            }
+            else {
+                queueFragment(existingEntry, currentPos.data, currentPos.offset, currentPos.length);
+            }
+        }
+        else if (firstPacket && isIdrFrameStart(&currentPos)) {
             // SPS and PPS prefix is padded between NALs, so we must decode it with the slow path
             processAvcHevcRtpPayloadSlow(&currentPos, existingEntry);
         }
@@ -1112,9 +1439,24 @@ static void processRtpPayload(PNV_VIDEO_PACKET videoPacket, int length,
                 // and have to wait until we hit our consecutive drop limit to
                 // request a new one (potentially several seconds).
                 dropStatePending = false;
+
+                // This IDR frame also catches the renderer up
+                PltAtomicStore(&catchUpPending, 0);
             }
             else {
+                bool catchUp = PltAtomicLoad(&catchUpPending) != 0;
+
                 dropFrameState();
+
+                // Ask for recovery now rather than on the next frame
+                if (catchUp) {
+                    if (waitingForIdrFrame) {
+                        LiRequestIdrFrame();
+                    }
+                    else {
+                        connectionDetectedFrameLoss(startFrameNumber, frameIndex);
+                    }
+                }
                 return;
             }
         }
@@ -1185,7 +1527,7 @@ void queueRtpPacket(PRTPV_QUEUE_ENTRY queueEntryPtr) {
 
     if (existingEntry != NULL) {
         // processRtpPayload didn't want this packet, so just free it
-        free(existingEntry->allocPtr);
+        freeVideoPacketBuffer(existingEntry->allocPtr);
     }
 }
 
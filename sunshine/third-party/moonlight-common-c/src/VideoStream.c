@@ -5,20 +5,60 @@
 
 #define FIRST_FRAME_PORT 47996
 
+#define VIDEO_PING_INTERVAL_MS 500
+
 static RTP_VIDEO_QUEUE rtpQueue;
+static BUFFER_POOL packetPool;
+
+// Space in front of each packet buffer for the encryption header, so encrypted
+// packets can be received straight into the buffer and decrypted in place.
+static int packetHeadroom;
 
 static SOCKET rtpSocket = INVALID_SOCKET;
+static SOCKET preboundRtpSocket = INVALID_SOCKET;
 static SOCKET firstFrameSocket = INVALID_SOCKET;
 
 static PPLT_CRYPTO_CONTEXT decryptionCtx;
 
-static PLT_THREAD udpPingThread;
+VIDEO_FRAME_TIMING_STATS VideoTimingStats;
+
+static SCHEDULER_TASK pingTask;
+static LC_SOCKADDR pingAddr;
+static int pingCount;
+
 static PLT_THREAD receiveThread;
 static PLT_THREAD decoderThread;
+static PLT_THREAD reassemblyThread;
 
 static bool receivedDataFromPeer;
 static uint64_t firstDataTimeMs;
-static bool receivedFullFrame;
+static volatile bool receivedFullFrame;
+
+// When pipelined, the receive thread only receives (and, without the decrypt pool,
+// decrypts) packets and hands them over to the reassembly thread, which runs them
+// through the RTP queue (FEC recovery and reordering) and the depacketizer.
+static bool pipelinedReceive;
+static LINKED_BLOCKING_QUEUE reassemblyQueue;
+
+// Current frame number of the RTP queue, published by the reassembly thread for
+// the receive thread's early discard of old packets. It may lag behind, which
+// only lets a few more old packets through to the RTP queue.
+static PLT_ATOMIC_INT currentFrameNumberHint;
+
+// With enough cores, encrypted packets are decrypted by a pool of workers between
+// the receive thread and the reassembly thread, which takes them from the pool
+// (in receive order) instead of the reassembly queue.
+static bool decryptPoolStarted;
+static DECRYPT_POOL decryptPool;
+
+// A packet waiting for the reassembly thread. It is stored where the RTP queue
+// entry of the packet buffer goes, since the RTP queue overwrites it only after
+// the packet has been dequeued.
+typedef struct _REASSEMBLY_QUEUE_ENTRY {
+    LINKED_BLOCKING_QUEUE_ENTRY lentry;
+    uint64_t receiveTimeUs;
+    int length;
+} REASSEMBLY_QUEUE_ENTRY, *PREASSEMBLY_QUEUE_ENTRY;
 
 // We can't request an IDR frame until the depacketizer knows
 // that a packet was lost. This timeout bounds the time that
@@ -34,14 +74,37 @@ static bool receivedFullFrame;
 // and subsequent packet/frame bursts that follow.
 #define RTP_RECV_PACKETS_BUFFERED 2048
 
+// At higher bitrates, the socket buffer is grown to hold this much of the stream
+// at the negotiated bitrate, so the burst of a large keyframe isn't dropped by the
+// kernel while the receive thread is not scheduled.
+#define RTP_RECV_BUFFER_WINDOW_MS 200
+#define RTP_RECV_BUFFER_MAX_SIZE (32 * 1024 * 1024)
+
+// Encrypted streams and streams at or above this bitrate (in Kbps) split the receive
+// thread in two, since decryption and FEC recovery no longer fit on a single core.
+#define PIPELINED_RECEIVE_MIN_BITRATE 100000
+
+// The decrypt pool is used when there are cores left over for it after the
+// receive and reassembly threads
+#define DECRYPT_POOL_MIN_PROCESSORS 3
+
 // Initialize the video stream
 void initializeVideoStream(void) {
+    // Packet buffers are recycled between the receive thread, the RTP queue (which
+    // also allocates FEC recovered packets), and the depacketizer (which stores its
+    // copied fragments in them) until the decode unit is completed. Keep enough of
+    // them around to cover a full socket buffer worth of packets.
+    packetHeadroom = (EncryptionFeaturesEnabled & SS_ENC_VIDEO) ? sizeof(ENC_VIDEO_HEADER) : 0;
+    BpInitializePool(&packetPool,
+                     packetHeadroom + StreamConfig.packetSize + MAX_RTP_HEADER_SIZE + sizeof(RTPV_QUEUE_ENTRY),
+                     RTP_RECV_PACKETS_BUFFERED);
     initializeVideoDepacketizer(StreamConfig.packetSize);
     RtpvInitializeQueue(&rtpQueue);
     decryptionCtx = PltCreateCryptoContext();
     receivedDataFromPeer = false;
     firstDataTimeMs = 0;
     receivedFullFrame = false;
+    memset(&VideoTimingStats, 0, sizeof(VideoTimingStats));
 }
 
 // Clean up the video stream
@@ -49,55 +112,233 @@ void destroyVideoStream(void) {
     PltDestroyCryptoContext(decryptionCtx);
     destroyVideoDepacketizer();
     RtpvCleanupQueue(&rtpQueue);
+    BpDestroyPool(&packetPool);
 }
 
-// UDP Ping proc
-static void VideoPingThreadProc(void* context) {
-    char legacyPingData[] = { 0x50, 0x49, 0x4E, 0x47 };
-    LC_SOCKADDR saddr;
+// Returns a buffer large enough for a received RTP packet followed by its queue entry
+void* allocVideoPacketBuffer(void) {
+    char* buffer = (char*)BpAllocBuffer(&packetPool);
+    return buffer != NULL ? buffer + packetHeadroom : NULL;
+}
 
-    LC_ASSERT(VideoPortNumber != 0);
+void freeVideoPacketBuffer(void* buffer) {
+    BpFreeBuffer(&packetPool, (char*)buffer - packetHeadroom);
+}
+
+void addVideoTimingSample(PVIDEO_TIMING_HISTOGRAM histogram, uint64_t durationUs) {
+    int bucket = 0;
 
-    memcpy(&saddr, &RemoteAddr, sizeof(saddr));
-    SET_PORT(&saddr, VideoPortNumber);
+    while (bucket < VIDEO_TIMING_HISTOGRAM_BUCKETS - 1 && durationUs >= VIDEO_TIMING_BUCKET_LIMIT_US(bucket)) {
+        bucket++;
+    }
+
+    histogram->buckets[bucket]++;
+    histogram->sampleCount++;
+    histogram->totalUs += durationUs;
+    if (durationUs > histogram->maxUs) {
+        histogram->maxUs = durationUs > UINT32_MAX ? UINT32_MAX : (uint32_t)durationUs;
+    }
+}
+
+// UDP ping task, run by the scheduler thread
+static bool sendVideoPing(void* context) {
+    char legacyPingData[] = { 0x50, 0x49, 0x4E, 0x47 };
 
     // We do not check for errors here. Socket errors will be handled
     // on the read-side in ReceiveThreadProc(). This avoids potential
     // issues related to receiving ICMP port unreachable messages due
     // to sending a packet prior to the host PC binding to that port.
-    int pingCount = 0;
-    while (!PltIsThreadInterrupted(&udpPingThread)) {
-        if (VideoPingPayload.payload[0] != 0) {
-            pingCount++;
-            VideoPingPayload.sequenceNumber = BE32(pingCount);
+    if (VideoPingPayload.payload[0] != 0) {
+        pingCount++;
+        VideoPingPayload.sequenceNumber = BE32(pingCount);
+
+        sendto(rtpSocket, (char*)&VideoPingPayload, sizeof(VideoPingPayload), 0, (struct sockaddr*)&pingAddr, AddrLen);
+    }
+    else {
+        sendto(rtpSocket, legacyPingData, sizeof(legacyPingData), 0, (struct sockaddr*)&pingAddr, AddrLen);
+    }
+
+    return true;
+}
+
+static uint32_t getCurrentFrameNumber(void) {
+    if (pipelinedReceive) {
+        return (uint32_t)PltAtomicLoad(&currentFrameNumberHint);
+    }
+    else {
+        return RtpvGetCurrentFrameNumber(&rtpQueue);
+    }
+}
 
-            sendto(rtpSocket, (char*)&VideoPingPayload, sizeof(VideoPingPayload), 0, (struct sockaddr*)&saddr, AddrLen);
+static void convertRtpHeader(PRTP_PACKET packet) {
+    packet->sequenceNumber = BE16(packet->sequenceNumber);
+    packet->timestamp = BE32(packet->timestamp);
+    packet->ssrc = BE32(packet->ssrc);
+}
+
+static void freeDecryptPoolPacket(char* packet) {
+    freeVideoPacketBuffer(packet + packetHeadroom);
+}
+
+// Returns the next packet for the reassembly thread, or false when stopping
+static bool waitForReassemblyPacket(char** buffer, int* length, uint64_t* receiveTimeUs) {
+    int decryptedSize = StreamConfig.packetSize + MAX_RTP_HEADER_SIZE;
+
+    if (decryptPoolStarted) {
+        for (;;) {
+            char* packet;
+            int err;
+
+            err = DpWaitForPacket(&decryptPool, &packet, length, receiveTimeUs);
+            if (err == DP_INTERRUPTED) {
+                return false;
+            }
+
+            *buffer = packet + packetHeadroom;
+            if (err == DP_SUCCESS) {
+                convertRtpHeader((PRTP_PACKET)*buffer);
+                return true;
+            }
+
+            Limelog("Failed to decrypt video packet!\n");
+            freeVideoPacketBuffer(*buffer);
+        }
+    }
+    else {
+        PREASSEMBLY_QUEUE_ENTRY entry;
+
+        if (LbqWaitForQueueElement(&reassemblyQueue, (void**)buffer) != LBQ_SUCCESS) {
+            return false;
+        }
+
+        entry = (PREASSEMBLY_QUEUE_ENTRY)&(*buffer)[decryptedSize];
+        *length = entry->length;
+        *receiveTimeUs = entry->receiveTimeUs;
+        return true;
+    }
+}
+
+// Reassembly thread proc
+static void VideoReassemblyThreadProc(void* context) {
+    int decryptedSize = StreamConfig.packetSize + MAX_RTP_HEADER_SIZE;
+    uint64_t receiveTimeUs;
+    char* buffer;
+    int length;
+
+    while (waitForReassemblyPacket(&buffer, &length, &receiveTimeUs)) {
+        // The RTP queue entry replaces the reassembly queue entry, whose fields were read above
+        if (RtpvAddPacket(&rtpQueue, (PRTP_PACKET)buffer, length, receiveTimeUs, (PRTPV_QUEUE_ENTRY)&buffer[decryptedSize]) != RTPF_RET_QUEUED) {
+            freeVideoPacketBuffer(buffer);
+        }
+
+        PltAtomicStore(&currentFrameNumberHint, (int)RtpvGetCurrentFrameNumber(&rtpQueue));
+    }
+}
+
+static int getDecryptWorkerCount(void) {
+    int workerCount = PltGetProcessorCount() - 2;
+    return workerCount < DP_MAX_WORKERS ? workerCount : DP_MAX_WORKERS;
+}
+
+static int getReceiveBufferSize(void) {
+    int64_t bufferSize = (int64_t)RTP_RECV_PACKETS_BUFFERED * (StreamConfig.packetSize + MAX_RTP_HEADER_SIZE);
+
+    // Bitrate is in Kbps
+    int64_t windowSize = (int64_t)StreamConfig.bitrate * 1000 / 8 * RTP_RECV_BUFFER_WINDOW_MS / 1000;
+    if (windowSize > bufferSize) {
+        bufferSize = windowSize < RTP_RECV_BUFFER_MAX_SIZE ? windowSize : RTP_RECV_BUFFER_MAX_SIZE;
+    }
+
+    return (int)bufferSize;
+}
+
+static bool startReassemblyThread(bool encrypted) {
+    PltAtomicStore(&currentFrameNumberHint, (int)RtpvGetCurrentFrameNumber(&rtpQueue));
+
+    decryptPoolStarted = false;
+    if (encrypted && PltGetProcessorCount() >= DECRYPT_POOL_MIN_PROCESSORS) {
+        if (DpInitializePool(&decryptPool, getDecryptWorkerCount(), RTP_RECV_PACKETS_BUFFERED,
+                             (unsigned char*)StreamConfig.remoteInputAesKey, sizeof(StreamConfig.remoteInputAesKey)) == 0) {
+            decryptPoolStarted = true;
         }
         else {
-            sendto(rtpSocket, legacyPingData, sizeof(legacyPingData), 0, (struct sockaddr*)&saddr, AddrLen);
+            Limelog("Video Receive: failed to start decryption workers; decrypting on the receive thread\n");
         }
+    }
+
+    if (!decryptPoolStarted && LbqInitializeLinkedBlockingQueue(&reassemblyQueue, RTP_RECV_PACKETS_BUFFERED) != 0) {
+        return false;
+    }
 
-        PltSleepMsInterruptible(&udpPingThread, 500);
+    if (PltCreateThread("VideoReasm", PLT_THREAD_ROLE_VIDEO, VideoReassemblyThreadProc, NULL, &reassemblyThread) != 0) {
+        if (decryptPoolStarted) {
+            DpSignalShutdown(&decryptPool);
+            DpDestroyPool(&decryptPool, freeDecryptPoolPacket);
+            decryptPoolStarted = false;
+        }
+        else {
+            LbqSignalQueueShutdown(&reassemblyQueue);
+            LbqDestroyLinkedBlockingQueue(&reassemblyQueue);
+        }
+        return false;
+    }
+
+    return true;
+}
+
+static void stopReassemblyThread(void) {
+    PLINKED_BLOCKING_QUEUE_ENTRY entry;
+
+    if (decryptPoolStarted) {
+        DpSignalShutdown(&decryptPool);
+        PltJoinThread(&reassemblyThread);
+        DpDestroyPool(&decryptPool, freeDecryptPoolPacket);
+        decryptPoolStarted = false;
+        return;
+    }
+
+    LbqSignalQueueShutdown(&reassemblyQueue);
+    PltJoinThread(&reassemblyThread);
+
+    // Free the packets that never made it to the RTP queue. The entries live
+    // inside the buffers, so grab the next one before freeing.
+    entry = LbqDestroyLinkedBlockingQueue(&reassemblyQueue);
+    while (entry != NULL) {
+        PLINKED_BLOCKING_QUEUE_ENTRY nextEntry = entry->flink;
+        freeVideoPacketBuffer(entry->data);
+        entry = nextEntry;
     }
 }
 
 // Receive thread proc
 static void VideoReceiveThreadProc(void* context) {
     int err;
-    int bufferSize, receiveSize, decryptedSize, minSize;
-    char* buffer;
-    char* encryptedBuffer;
+    int receiveSize, decryptedSize, minSize;
+    char* buffers[UDP_RECV_BATCH_MAX];
+    char* receiveBuffers[UDP_RECV_BATCH_MAX];
+    int lengths[UDP_RECV_BATCH_MAX];
+    uint64_t receiveTimesUs[UDP_RECV_BATCH_MAX];
     int queueStatus;
     bool useSelect;
     int waitingForVideoMs;
     bool encrypted;
+    bool decryptPending;
+    int i;
 
     encrypted = !!(EncryptionFeaturesEnabled & SS_ENC_VIDEO);
     decryptedSize = StreamConfig.packetSize + MAX_RTP_HEADER_SIZE;
     minSize = sizeof(RTP_PACKET) + ((EncryptionFeaturesEnabled & SS_ENC_VIDEO) ? sizeof(ENC_VIDEO_HEADER) : 0);
     receiveSize = decryptedSize + ((EncryptionFeaturesEnabled & SS_ENC_VIDEO) ? sizeof(ENC_VIDEO_HEADER) : 0);
-    bufferSize = decryptedSize + sizeof(RTPV_QUEUE_ENTRY);
-    buffer = NULL;
+    memset(buffers, 0, sizeof(buffers));
+
+    LC_ASSERT(sizeof(REASSEMBLY_QUEUE_ENTRY) <= sizeof(RTPV_QUEUE_ENTRY));
+    pipelinedReceive = false;
+    if (encrypted || StreamConfig.bitrate >= PIPELINED_RECEIVE_MIN_BITRATE) {
+        pipelinedReceive = startReassemblyThread(encrypted);
+        if (!pipelinedReceive) {
+            Limelog("Video Receive: failed to start reassembly thread; continuing without it\n");
+        }
+    }
 
     if (setNonFatalRecvTimeoutMs(rtpSocket, UDP_RECV_POLL_TIMEOUT_MS) < 0) {
         // SO_RCVTIMEO failed, so use select() to wait
@@ -108,42 +349,41 @@ static void VideoReceiveThreadProc(void* context) {
         useSelect = false;
     }
 
-    // Allocate a staging buffer to use for each received packet
-    if (encrypted) {
-        encryptedBuffer = (char*)malloc(receiveSize);
-        if (encryptedBuffer == NULL) {
-            Limelog("Video Receive: malloc() failed\n");
-            ListenerCallbacks.connectionTerminated(-1);
-            return;
-        }
-    }
-    else {
-        encryptedBuffer = NULL;
-    }
-
     waitingForVideoMs = 0;
     while (!PltIsThreadInterrupted(&receiveThread)) {
-        PRTP_PACKET packet;
+        int packetCount;
 
-        if (buffer == NULL) {
-            buffer = (char*)malloc(bufferSize);
-            if (buffer == NULL) {
-                Limelog("Video Receive: malloc() failed\n");
-                ListenerCallbacks.connectionTerminated(-1);
-                break;
+        // Replace the buffers handed over to the queue by the previous batch
+        for (i = 0; i < UDP_RECV_BATCH_MAX; i++) {
+            if (buffers[i] == NULL) {
+                buffers[i] = (char*)allocVideoPacketBuffer();
+                if (buffers[i] == NULL) {
+                    break;
+                }
             }
+
+            // Encrypted packets are received with their header in the buffer headroom
+            receiveBuffers[i] = buffers[i] - packetHeadroom;
+        }
+        if (i != UDP_RECV_BATCH_MAX) {
+            Limelog("Video Receive: malloc() failed\n");
+            ListenerCallbacks.connectionTerminated(-1);
+            break;
         }
 
-        err = recvUdpSocket(rtpSocket,
-                            encrypted ? encryptedBuffer : buffer,
-                            receiveSize,
-                            useSelect);
-        if (err < 0) {
-            Limelog("Video Receive: recvUdpSocket() failed: %d\n", (int)LastSocketError());
+        packetCount = recvUdpSocketBatch(rtpSocket,
+                                         receiveBuffers,
+                                         lengths,
+                                         receiveTimesUs,
+                                         receiveSize,
+                                         UDP_RECV_BATCH_MAX,
+                                         useSelect);
+        if (packetCount < 0) {
+            Limelog("Video Receive: recvUdpSocketBatch() failed: %d\n", (int)LastSocketError());
             ListenerCallbacks.connectionTerminated(LastSocketFail());
             break;
         }
-        else if  (err == 0) {
+        else if  (packetCount == 0) {
             if (!receivedDataFromPeer) {
                 // If we wait many seconds without ever receiving a video packet,
                 // assume something is broken and terminate the connection.
@@ -176,71 +416,106 @@ static void VideoReceiveThreadProc(void* context) {
         }
 #endif
 
-        if (err < minSize) {
-            // Runt packet
-            continue;
-        }
+        decryptPending = false;
+        for (i = 0; i < packetCount; i++) {
+            char* buffer = buffers[i];
+            PRTP_PACKET packet;
 
-        // Decrypt the packet into the buffer if encryption is enabled
-        if (encrypted) {
-            PENC_VIDEO_HEADER encHeader = (PENC_VIDEO_HEADER)encryptedBuffer;
-
-            // If this frame is below our current frame number, discard it before decryption
-            // to save CPU cycles decrypting FEC shards for a frame we already reassembled.
-            //
-            // Since this is happening _before_ decryption, this packet is not trusted yet.
-            // It's imperative that we do not mutate any state based on this packet until
-            // after it has been decrypted successfully!
-            //
-            // It's possible for an attacker to inject a fake packet that has any value of
-            // header fields they want, however this provides them no benefit because we will
-            // simply drop said packet here (if it's below the current frame number) or it
-            // will pass this check and be dropped during decryption (if contents is tampered)
-            // or after decryption in the RTP queue (if it's a replay of a previous authentic
-            // packet from the host).
-            //
-            // In short, an attacker spoofing this value via MITM or sending malicious values
-            // impersonating the host from off-link doesn't gain them anything. If they have
-            // a true MITM, they can DoS our connection by just dropping all our traffic, so
-            // tampering with packets to fail this check doesn't accomplish anything they
-            // couldn't already do. If they're not on-link, we just throw their malicious
-            // traffic away (as mentioned in the paragraph above) and continue accepting
-            // legitmate video traffic.
-            if (encHeader->frameNumber && LE32(encHeader->frameNumber) < RtpvGetCurrentFrameNumber(&rtpQueue)) {
+            err = lengths[i];
+            if (err < minSize) {
+                // Runt packet
                 continue;
             }
 
-            if (!PltDecryptMessage(decryptionCtx, ALGORITHM_AES_GCM, 0,
-                                   (unsigned char*)StreamConfig.remoteInputAesKey, sizeof(StreamConfig.remoteInputAesKey),
-                                   encHeader->iv, sizeof(encHeader->iv),
-                                   encHeader->tag, sizeof(encHeader->tag),
-                                   ((unsigned char*)(encHeader + 1)), err - sizeof(ENC_VIDEO_HEADER), // The ciphertext is after the header
-                                   (unsigned char*)buffer, &err)) {
-                Limelog("Failed to decrypt video packet!\n");
+            // Decrypt the packet in place if encryption is enabled
+            if (encrypted) {
+                PENC_VIDEO_HEADER encHeader = (PENC_VIDEO_HEADER)receiveBuffers[i];
+
+                // If this frame is below our current frame number, discard it before decryption
+                // to save CPU cycles decrypting FEC shards for a frame we already reassembled.
+                //
+                // Since this is happening _before_ decryption, this packet is not trusted yet.
+                // It's imperative that we do not mutate any state based on this packet until
+                // after it has been decrypted successfully!
+                //
+                // It's possible for an attacker to inject a fake packet that has any value of
+                // header fields they want, however this provides them no benefit because we will
+                // simply drop said packet here (if it's below the current frame number) or it
+                // will pass this check and be dropped during decryption (if contents is tampered)
+                // or after decryption in the RTP queue (if it's a replay of a previous authentic
+                // packet from the host).
+                //
+                // In short, an attacker spoofing this value via MITM or sending malicious values
+                // impersonating the host from off-link doesn't gain them anything. If they have
+                // a true MITM, they can DoS our connection by just dropping all our traffic, so
+                // tampering with packets to fail this check doesn't accomplish anything they
+                // couldn't already do. If they're not on-link, we just throw their malicious
+                // traffic away (as mentioned in the paragraph above) and continue accepting
+                // legitmate video traffic.
+                if (encHeader->frameNumber && LE32(encHeader->frameNumber) < getCurrentFrameNumber()) {
+                    continue;
+                }
+
+                // The workers decrypt it and hand it to the reassembly thread in order
+                if (decryptPoolStarted) {
+                    if (DpSubmitPacket(&decryptPool, receiveBuffers[i], err, receiveTimesUs[i])) {
+                        buffers[i] = NULL;
+                        decryptPending = true;
+                    }
+                    continue;
+                }
+
+                if (!PltDecryptMessage(decryptionCtx, ALGORITHM_AES_GCM, 0,
+                                       (unsigned char*)StreamConfig.remoteInputAesKey, sizeof(StreamConfig.remoteInputAesKey),
+                                       encHeader->iv, sizeof(encHeader->iv),
+                                       encHeader->tag, sizeof(encHeader->tag),
+                                       ((unsigned char*)(encHeader + 1)), err - sizeof(ENC_VIDEO_HEADER), // The ciphertext is after the header
+                                       (unsigned char*)buffer, &err)) {
+                    Limelog("Failed to decrypt video packet!\n");
+                    continue;
+                }
+            }
+
+            // Convert fields to host byte-order
+            packet = (PRTP_PACKET)&buffer[0];
+            convertRtpHeader(packet);
+
+            if (pipelinedReceive) {
+                PREASSEMBLY_QUEUE_ENTRY entry = (PREASSEMBLY_QUEUE_ENTRY)&buffer[decryptedSize];
+
+                // If the reassembly thread is too far behind, the packet is dropped
+                // and the buffer reused. The RTP queue treats it as a lost packet.
+                entry->length = err;
+                entry->receiveTimeUs = receiveTimesUs[i];
+                if (LbqOfferQueueItem(&reassemblyQueue, buffer, &entry->lentry) == LBQ_SUCCESS) {
+                    // The reassembly thread owns the buffer
+                    buffers[i] = NULL;
+                }
                 continue;
             }
-        }
 
-        // Convert fields to host byte-order
-        packet = (PRTP_PACKET)&buffer[0];
-        packet->sequenceNumber = BE16(packet->sequenceNumber);
-        packet->timestamp = BE32(packet->timestamp);
-        packet->ssrc = BE32(packet->ssrc);
+            queueStatus = RtpvAddPacket(&rtpQueue, packet, err, receiveTimesUs[i], (PRTPV_QUEUE_ENTRY)&buffer[decryptedSize]);
 
-        queueStatus = RtpvAddPacket(&rtpQueue, packet, err, (PRTPV_QUEUE_ENTRY)&buffer[decryptedSize]);
+            if (queueStatus == RTPF_RET_QUEUED) {
+                // The queue owns the buffer
+                buffers[i] = NULL;
+            }
+        }
 
-        if (queueStatus == RTPF_RET_QUEUED) {
-            // The queue owns the buffer
-            buffer = NULL;
+        // Wake the workers once per batch rather than for each packet
+        if (decryptPending) {
+            DpWakeWorkers(&decryptPool);
         }
     }
 
-    if (buffer != NULL) {
-        free(buffer);
+    if (pipelinedReceive) {
+        stopReassemblyThread();
     }
 
-    if (encryptedBuffer != NULL) {
-        free(encryptedBuffer);
+    for (i = 0; i < UDP_RECV_BATCH_MAX; i++) {
+        if (buffers[i] != NULL) {
+            freeVideoPacketBuffer(buffers[i]);
+        }
     }
 }
 
@@ -285,7 +560,7 @@ void stopVideoStream(void) {
     // Wake up client code that may be waiting on the decode unit queue
     stopVideoDepacketizer();
 
-    PltInterruptThread(&udpPingThread);
+    SchedRemoveTask(&pingTask);
     PltInterruptThread(&receiveThread);
     if ((VideoCallbacks.capabilities & (CAPABILITY_DIRECT_SUBMIT | CAPABILITY_PULL_RENDERER)) == 0) {
         PltInterruptThread(&decoderThread);
@@ -295,7 +570,6 @@ void stopVideoStream(void) {
         shutdownTcpSocket(firstFrameSocket);
     }
 
-    PltJoinThread(&udpPingThread);
     PltJoinThread(&receiveThread);
     if ((VideoCallbacks.capabilities & (CAPABILITY_DIRECT_SUBMIT | CAPABILITY_PULL_RENDERER)) == 0) {
         PltJoinThread(&decoderThread);
@@ -313,8 +587,28 @@ void stopVideoStream(void) {
     VideoCallbacks.cleanup();
 }
 
-// Start the video stream
-int startVideoStream(void* rendererContext, int drFlags) {
+// Bind the video socket ahead of the connection for LiPreconnect()
+int prebindVideoStream(void) {
+    LC_ASSERT(preboundRtpSocket == INVALID_SOCKET);
+
+    preboundRtpSocket = bindUdpSocket(RemoteAddr.ss_family, &LocalAddr, AddrLen, 0, SOCK_QOS_TYPE_VIDEO);
+    if (preboundRtpSocket == INVALID_SOCKET) {
+        return LastSocketFail();
+    }
+
+    return 0;
+}
+
+void releasePreboundVideoStream(void) {
+    if (preboundRtpSocket != INVALID_SOCKET) {
+        closeSocket(preboundRtpSocket);
+        preboundRtpSocket = INVALID_SOCKET;
+    }
+}
+
+// Set up the decoder and the video socket. This doesn't talk to the host,
+// so it can run while the control stream is starting.
+int prepareVideoStream(void* rendererContext, int drFlags) {
     int err;
 
     firstFrameSocket = INVALID_SOCKET;
@@ -328,17 +622,45 @@ int startVideoStream(void* rendererContext, int drFlags) {
         return err;
     }
 
-    rtpSocket = bindUdpSocket(RemoteAddr.ss_family, &LocalAddr, AddrLen,
-                              RTP_RECV_PACKETS_BUFFERED * (StreamConfig.packetSize + MAX_RTP_HEADER_SIZE),
-                              SOCK_QOS_TYPE_VIDEO);
-    if (rtpSocket == INVALID_SOCKET) {
-        VideoCallbacks.cleanup();
-        return LastSocketError();
+    if (preboundRtpSocket != INVALID_SOCKET) {
+        // Adopt the socket bound by LiPreconnect(). The receive buffer depends on
+        // the stream configuration, so it can only be sized now.
+        rtpSocket = preboundRtpSocket;
+        preboundRtpSocket = INVALID_SOCKET;
+        setSocketRecvBufferSize(rtpSocket, getReceiveBufferSize());
+    }
+    else {
+        rtpSocket = bindUdpSocket(RemoteAddr.ss_family, &LocalAddr, AddrLen,
+                                  getReceiveBufferSize(),
+                                  SOCK_QOS_TYPE_VIDEO);
+        if (rtpSocket == INVALID_SOCKET) {
+            VideoCallbacks.cleanup();
+            return LastSocketError();
+        }
     }
 
+    // Frame receive times should not include our own scheduling delay
+    if (enableUdpReceiveTimestamps(rtpSocket) != 0) {
+        Limelog("Kernel receive timestamps are unavailable; using userspace receive times\n");
+    }
+
+    return 0;
+}
+
+// Undo prepareVideoStream() when the video stream won't be started
+void unprepareVideoStream(void) {
+    closeSocket(rtpSocket);
+    rtpSocket = INVALID_SOCKET;
+    VideoCallbacks.cleanup();
+}
+
+// Start the video stream after prepareVideoStream()
+int startVideoStream(void) {
+    int err;
+
     VideoCallbacks.start();
 
-    err = PltCreateThread("VideoRecv", VideoReceiveThreadProc, NULL, &receiveThread);
+    err = PltCreateThread("VideoRecv", PLT_THREAD_ROLE_RECEIVE, VideoReceiveThreadProc, NULL, &receiveThread);
     if (err != 0) {
         VideoCallbacks.stop();
         closeSocket(rtpSocket);
@@ -347,7 +669,7 @@ int startVideoStream(void* rendererContext, int drFlags) {
     }
 
     if ((VideoCallbacks.capabilities & (CAPABILITY_DIRECT_SUBMIT | CAPABILITY_PULL_RENDERER)) == 0) {
-        err = PltCreateThread("VideoDec", VideoDecoderThreadProc, NULL, &decoderThread);
+        err = PltCreateThread("VideoDec", PLT_THREAD_ROLE_VIDEO, VideoDecoderThreadProc, NULL, &decoderThread);
         if (err != 0) {
             VideoCallbacks.stop();
             PltInterruptThread(&receiveThread);
@@ -381,26 +703,12 @@ int startVideoStream(void* rendererContext, int drFlags) {
 
     // Start pinging before reading the first frame so GFE knows where
     // to send UDP data
-    err = PltCreateThread("VideoPing", VideoPingThreadProc, NULL, &udpPingThread);
-    if (err != 0) {
-        VideoCallbacks.stop();
-        stopVideoDepacketizer();
-        PltInterruptThread(&receiveThread);
-        if ((VideoCallbacks.capabilities & (CAPABILITY_DIRECT_SUBMIT | CAPABILITY_PULL_RENDERER)) == 0) {
-            PltInterruptThread(&decoderThread);
-        }
-        PltJoinThread(&receiveThread);
-        if ((VideoCallbacks.capabilities & (CAPABILITY_DIRECT_SUBMIT | CAPABILITY_PULL_RENDERER)) == 0) {
-            PltJoinThread(&decoderThread);
-        }
-        closeSocket(rtpSocket);
-        if (firstFrameSocket != INVALID_SOCKET) {
-            closeSocket(firstFrameSocket);
-            firstFrameSocket = INVALID_SOCKET;
-        }
-        VideoCallbacks.cleanup();
-        return err;
-    }
+    LC_ASSERT(VideoPortNumber != 0);
+    memcpy(&pingAddr, &RemoteAddr, sizeof(pingAddr));
+    SET_PORT(&pingAddr, VideoPortNumber);
+    pingCount = 0;
+    SchedInitializeTask(&pingTask, sendVideoPing, NULL, VIDEO_PING_INTERVAL_MS);
+    SchedAddTask(&pingTask, 0);
 
     if (AppVersionQuad[0] == 3) {
         // Read the first frame to start the flow of video
@@ -417,3 +725,7 @@ int startVideoStream(void* rendererContext, int drFlags) {
 const RTP_VIDEO_STATS* LiGetRTPVideoStats(void) {
     return &rtpQueue.stats;
 }
+
+const VIDEO_FRAME_TIMING_STATS* LiGetVideoFrameTimingHistogram(void) {
+    return &VideoTimingStats;
+}
@@ -223,6 +223,102 @@ void obl_axpyb32_ref(u8 *a, u32 *b, u8 u, unsigned k)
 #endif
 #endif
 
+#if (defined(__x86_64__) || defined(_M_X64)) && !defined(OBLAS_NO_GFNI)
+#define OBLAS_GFNI
+#endif
+
+#if defined(OBLAS_GFNI)
+/*
+ * GFNI backend, selected at runtime by obl_init(). Multiplying by u is
+ * linear over GF(2), so it is an 8x8 bit matrix that GF2P8AFFINEQB applies
+ * to 64 bytes at once. GF2P8MULB cannot be used since it is hardwired to
+ * the AES polynomial (0x11b), not the one of these tables (0x11d).
+ */
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define OBLAS_GFNI_TARGET
+#else
+#define OBLAS_GFNI_TARGET __attribute__((target("gfni,avx512f,avx512bw")))
+#endif
+
+static int obl_gfni_enabled;
+static uint64_t GF2_8_AFFINE[256];
+
+static u8 gf2_8_mul_shuf(u8 u, u8 x)
+{
+    return GF2_8_SHUF_LO[u * 16 + (x & 0x0f)] ^ GF2_8_SHUF_HI[u * 16 + (x >> 4)];
+}
+
+/* byte 7 - i of the matrix selects the input bits which make output bit i */
+static uint64_t gf2_8_affine_matrix(u8 u)
+{
+    uint64_t m = 0;
+    for (int i = 0; i < 8; i++) {
+        u8 row = 0;
+        for (int j = 0; j < 8; j++)
+            row |= ((gf2_8_mul_shuf(u, 1 << j) >> i) & 1) << j;
+        m |= (uint64_t)row << (8 * (7 - i));
+    }
+    return m;
+}
+
+static int obl_cpu_has_gfni(void)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    /* the OS must save the opmask and ZMM registers (XCR0 bits 1, 2, 5, 6 and 7) */
+    if ((info[2] & (1 << 27)) == 0 || (_xgetbv(0) & 0xe6) != 0xe6)
+        return 0;
+    __cpuidex(info, 7, 0);
+    return (info[2] & (1 << 8)) && (info[1] & (1 << 16)) && (info[1] & (1 << 30));
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("gfni") && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+#endif
+}
+
+#define OBL_GFNI(a, b, f)                                                                                                          \
+    do {                                                                                                                           \
+        const __m512i m = _mm512_set1_epi64((long long)GF2_8_AFFINE[u]);                                                           \
+        unsigned i = 0;                                                                                                            \
+        for (; i + sizeof(__m512i) <= k; i += sizeof(__m512i)) {                                                                   \
+            __m512i bx = _mm512_gf2p8affine_epi64_epi8(_mm512_loadu_si512(b + i), m, 0);                                           \
+            _mm512_storeu_si512(a + i, f(_mm512_loadu_si512(a + i), bx));                                                          \
+        }                                                                                                                          \
+        if (i < k) {                                                                                                               \
+            __mmask64 tail = ~0ULL >> (sizeof(__m512i) - (k - i));                                                                 \
+            __m512i bx = _mm512_gf2p8affine_epi64_epi8(_mm512_maskz_loadu_epi8(tail, b + i), m, 0);                                \
+            _mm512_mask_storeu_epi8(a + i, tail, f(_mm512_maskz_loadu_epi8(tail, a + i), bx));                                     \
+        }                                                                                                                          \
+    } while (0)
+
+#define OBL_GFNI_NOOP(a, b) (b)
+
+OBLAS_GFNI_TARGET static void obl_axpy_gfni(u8 *a, u8 *b, u8 u, unsigned k)
+{
+    OBL_GFNI(a, b, _mm512_xor_si512);
+}
+
+OBLAS_GFNI_TARGET static void obl_scal_gfni(u8 *a, u8 u, unsigned k)
+{
+    OBL_GFNI(a, a, OBL_GFNI_NOOP);
+}
+#endif
+
+void obl_init(void)
+{
+#if defined(OBLAS_GFNI)
+    if (obl_gfni_enabled || !obl_cpu_has_gfni())
+        return;
+
+    for (int u = 0; u < 256; u++)
+        GF2_8_AFFINE[u] = gf2_8_affine_matrix(u);
+    obl_gfni_enabled = 1;
+#endif
+}
+
 #define OBL_NOOP(a, b) (b)
 void obl_axpy(u8 *a, u8 *b, u8 u, unsigned k)
 {
@@ -231,12 +327,24 @@ void obl_axpy(u8 *a, u8 *b, u8 u, unsigned k)
         for (; ap < ae; ap++, bp++)
             *ap ^= *bp;
     } else {
+#if defined(OBLAS_GFNI)
+        if (obl_gfni_enabled) {
+            obl_axpy_gfni(a, b, u, k);
+            return;
+        }
+#endif
         OBL_SHUF(obl_axpy, a, b, OBL_SHUF_XOR);
     }
 }
 
 void obl_scal(u8 *a, u8 u, unsigned k)
 {
+#if defined(OBLAS_GFNI)
+    if (obl_gfni_enabled) {
+        obl_scal_gfni(a, u, k);
+        return;
+    }
+#endif
     OBL_SHUF(obl_scal, a, a, OBL_NOOP);
 }
 
@@ -5,6 +5,8 @@
 typedef uint8_t u8;
 typedef uint32_t u32;
 
+/* selects the fastest backend supported by the CPU, call once before use */
+void obl_init(void);
 void obl_axpy(u8 *a, u8 *b, u8 u, unsigned k);
 void obl_scal(u8 *a, u8 u, unsigned k);
 void obl_swap(u8 *a, u8 *b, unsigned k);
@@ -28,17 +28,39 @@ static void scal(u8 *a, u8 u, int k)
     obl_scal(a, u, k);
 }
 
-static void gemm(u8 *a, u8 **b, u8 **c, int n, int k, int m)
+/* c = a.b over the columns [off, off + m) */
+static void gemm_range(u8 *a, u8 **b, u8 **c, int n, int k, int off, int m)
 {
     int ci = 0;
     for (int row = 0; row < n; row++, ci++) {
         u8 *ap = a + (row * k);
-        memset(c[ci], 0, m);
+        memset(c[ci] + off, 0, m);
         for (int idx = 0; idx < k; idx++)
-            axpy(c[ci], b[idx], ap[idx], m);
+            axpy(c[ci] + off, b[idx] + off, ap[idx], m);
     }
 }
 
+/* c = a.b over the columns [off, off + m), b being k rows at a fixed stride, the last one only l bytes long */
+static void gemm_strided_range(u8 *a, u8 *b, int stride, int l, u8 **c, int n, int k, int off, int m)
+{
+    u8 *last = b + (size_t)(k - 1) * stride;
+    int tail = l - off < m ? l - off : m;
+    for (int row = 0; row < n; row++) {
+        u8 *ap = a + (row * k);
+        memset(c[row] + off, 0, m);
+        for (int idx = 0; idx < k - 1; idx++)
+            axpy(c[row] + off, b + (size_t)idx * stride + off, ap[idx], m);
+        /* the missing end of the last row is zero and adds nothing */
+        if (tail > 0)
+            axpy(c[row] + off, last + off, ap[k - 1], tail);
+    }
+}
+
+static void gemm(u8 *a, u8 **b, u8 **c, int n, int k, int m)
+{
+    gemm_range(a, b, c, n, k, 0, m);
+}
+
 static int invert_mat(u8 *src, u8 *wrk, u8 **dst, int V0, int K, int T, u8 *c, u8 *d)
 {
     int V0b = V0, W = K - V0;
@@ -57,7 +79,8 @@ static int invert_mat(u8 *src, u8 *wrk, u8 **dst, int V0, int K, int T, u8 *c, u
     }
     for (int x = 0; x < W; x++) {
         u = GF2_8_INV[wrk[x * W + x]];
-        scal(wrk + x * W + x, u, W);
+        /* the columns before the pivot are already zero, do not scale past the row */
+        scal(wrk + x * W + x, u, W - x);
         scal(dst[c[V0b + x]], u, T);
         for (int row = x + 1; row < W; row++) {
             u = wrk[row * W + x];
@@ -77,6 +100,7 @@ static int invert_mat(u8 *src, u8 *wrk, u8 **dst, int V0, int K, int T, u8 *c, u
 
 void reed_solomon_init(void)
 {
+    obl_init();
 }
 
 reed_solomon *reed_solomon_new_static(void *buf, size_t len, int ds, int ps)
@@ -168,3 +192,38 @@ int reed_solomon_encode(reed_solomon *rs, u8 **shards, int nr_shards, int bs)
     gemm(rs->p, shards, shards + rs->ds, rs->ps, rs->ds, bs);
     return 0;
 }
+
+/* keep the slices a multiple of the widest vector so only the last one has a tail */
+#define RS_JOB_ALIGN 64
+
+int reed_solomon_encode_split(reed_solomon *rs, u8 **shards, int nr_shards, int bs, reed_solomon_job *jobs, int nr_jobs)
+{
+    if (nr_shards < rs->ts || nr_jobs <= 0 || bs <= 0)
+        return -1;
+
+    int chunk = (bs + nr_jobs - 1) / nr_jobs;
+    chunk = (chunk + RS_JOB_ALIGN - 1) / RS_JOB_ALIGN * RS_JOB_ALIGN;
+
+    int n = 0;
+    for (int off = 0; off < bs; off += chunk, n++) {
+        jobs[n].rs = rs;
+        jobs[n].shards = shards;
+        jobs[n].offset = off;
+        jobs[n].len = (bs - off < chunk) ? bs - off : chunk;
+    }
+    return n;
+}
+
+void reed_solomon_encode_job(const reed_solomon_job *job)
+{
+    reed_solomon *rs = job->rs;
+    gemm_range(rs->p, job->shards, job->shards + rs->ds, rs->ps, rs->ds, job->offset, job->len);
+}
+
+int reed_solomon_encode_strided(reed_solomon *rs, u8 *data, int stride, int last_len, u8 **parity, int nr_parity, int bs)
+{
+    if (nr_parity < rs->ps || bs <= 0 || stride < bs || last_len <= 0 || last_len > bs)
+        return -1;
+    gemm_strided_range(rs->p, data, stride, last_len, parity, rs->ps, rs->ds, 0, bs);
+    return 0;
+}
@@ -23,4 +23,33 @@ void reed_solomon_release(reed_solomon *rs);
 int reed_solomon_encode(reed_solomon *rs, uint8_t **shards, int nr_shards, int bs);
 int reed_solomon_decode(reed_solomon *rs, uint8_t **shards, uint8_t *marks, int nr_shards, int bs);
 
+/* a slice of the parity computation of one block, see reed_solomon_encode_split() */
+typedef struct _reed_solomon_job {
+    reed_solomon *rs;
+    uint8_t **shards;
+    int offset;
+    int len;
+} reed_solomon_job;
+
+/*
+ * Split the encoding of one block into at most nr_jobs slices covering
+ * disjoint byte ranges of the shards, without allocating. The slices may
+ * be run concurrently, in any order and on any thread, with
+ * reed_solomon_encode_job(); once all of them have completed, the parity
+ * shards are identical to those of reed_solomon_encode().
+ * Returns the number of jobs filled in, or -1 on error.
+ */
+int reed_solomon_encode_split(reed_solomon *rs, uint8_t **shards, int nr_shards, int bs, reed_solomon_job *jobs, int nr_jobs);
+void reed_solomon_encode_job(const reed_solomon_job *job);
+
+/*
+ * Encode one block straight from a frame buffer, without staging copies.
+ * Data shard i is read from data + i * stride; all of them are bs bytes
+ * long except the last one, which holds only last_len bytes and is
+ * encoded as if it were zero padded to bs. Parity shard j is written to
+ * parity[j], for instance the payload of a packet just past its header.
+ * Returns 0, or -1 on error.
+ */
+int reed_solomon_encode_strided(reed_solomon *rs, uint8_t *data, int stride, int last_len, uint8_t **parity, int nr_parity, int bs);
+
 #endif
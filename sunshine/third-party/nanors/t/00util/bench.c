@@ -91,10 +91,37 @@ int run(int seed, int K, int N, int T, double *et, double *dt)
     return ret;
 }
 
+/* common FEC block shapes, with shards the size of a video packet */
+static const int SHAPES[][2] = {
+    {4, 1}, {10, 2}, {20, 5}, {50, 10}, {100, 20}, {100, 25}, {200, 50},
+};
+
+#define SHAPE_SHARD_SIZE 1408
+
+static void bench_shapes(void)
+{
+    int Mb = 128;
+    for (unsigned s = 0; s < sizeof(SHAPES) / sizeof(SHAPES[0]); s++) {
+        int K = SHAPES[s][0], N = SHAPES[s][1], T = SHAPE_SHARD_SIZE;
+        int num = Mb * (1024 * 1024) / (K * T);
+        double et = 0.0, dt = 0.0;
+        for (int i = 0; i < num; i++) {
+            run(0, K, N, T, &et, &dt);
+        }
+        printf("ds = %3d, ps = %3d, bs = %d: encode %6.2f GB/s, decode %6.2f GB/s\n",
+               K, N, T, Mb / 1024.0 / et, Mb / 1024.0 / dt);
+    }
+}
+
 int main(int argc, char *argv[])
 {
     double t0 = now(0);
     int seed = time(NULL), K, N, T;
+    if (argc == 1) {
+        srand(seed);
+        bench_shapes();
+        return 0;
+    }
     if (argc != 4)
         return -1;
 
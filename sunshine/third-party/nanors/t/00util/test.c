@@ -37,6 +37,47 @@ int run(int seed, int K, int N, int T)
     if (rs) {
         reed_solomon_encode(rs, buf, K + N, T);
 
+        /* the split encode must produce the same parity, whatever the order of the jobs */
+        reed_solomon_job jobs[4];
+        int nr_jobs = reed_solomon_encode_split(rs, cmp, K + N, T, jobs, 4);
+        for (int i = nr_jobs - 1; i >= 0; i--)
+            reed_solomon_encode_job(&jobs[i]);
+        for (int i = K; i < K + N; i++) {
+            if (memcmp(cmp[i], buf[i], T)) {
+                printf("split encode mismatch at row %d\n", i);
+                failed = 1;
+            }
+        }
+
+        /* the strided encode reads the data from one frame buffer whose last shard is short */
+        int header = 16, stride = T + header, last_len = MAP(rand(), RAND_MAX, 1, T + 1);
+        /* sized to end with the last shard, and garbage between the shards */
+        uint8_t *frame = malloc((K - 1) * stride + last_len);
+        memset(frame, 0xa5, (K - 1) * stride + last_len);
+        uint8_t *packets = calloc(N, stride);
+        uint8_t **payloads = calloc(N, sizeof(uint8_t *));
+        for (int i = 0; i < K; i++)
+            memcpy(frame + i * stride, buf[i], i == K - 1 ? last_len : T);
+        for (int i = 0; i < N; i++)
+            payloads[i] = packets + i * stride + header;
+        memcpy(cmp[K - 1], buf[K - 1], last_len);
+        memset(cmp[K - 1] + last_len, 0, T - last_len);
+        reed_solomon_encode(rs, cmp, K + N, T);
+        if (reed_solomon_encode_strided(rs, frame, stride, last_len, payloads, N, T)) {
+            printf("strided encode failed\n");
+            failed = 1;
+        }
+        for (int i = 0; i < N; i++) {
+            if (memcmp(payloads[i], cmp[K + i], T)) {
+                printf("strided encode mismatch at row %d\n", K + i);
+                failed = 1;
+            }
+        }
+        memcpy(cmp[K - 1], buf[K - 1], T);
+        free(frame);
+        free(packets);
+        free(payloads);
+
         for (int i = 0; i < K + N; i++) {
             marks[i] = 0;
         }
@@ -33,7 +33,7 @@ static struct tray tray;
 static void toggle_cb(struct tray_menu *item) {
   printf("toggle cb\n");
   item->checked = !item->checked;
-  tray_update(&tray);
+  tray_update_item(item);
 }
 
 static void hello_cb(struct tray_menu *item) {
@@ -44,7 +44,7 @@ static void hello_cb(struct tray_menu *item) {
   } else {
     tray.icon = TRAY_ICON1;
   }
-  tray_update(&tray);
+  tray_update_icon(&tray);
 }
 
 static void quit_cb(struct tray_menu *item) {
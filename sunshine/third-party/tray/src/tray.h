@@ -64,6 +64,22 @@ extern "C" {
    */
   void tray_update(struct tray *tray);
 
+  /**
+   * @brief Update a single menu item in place, without rebuilding the menu.
+   *
+   * The text, disabled and checked state of the native item are updated from @p item.
+   * Use tray_update() instead when items are added or removed, or when a submenu changes.
+   *
+   * @param item The menu item to update. It must be part of the menu passed to the last tray_update() call.
+   */
+  void tray_update_item(struct tray_menu *item);
+
+  /**
+   * @brief Update the tray icon and tooltip only, without rebuilding the menu or showing a notification.
+   * @param tray The tray to update.
+   */
+  void tray_update_icon(struct tray *tray);
+
   /**
    * @brief Terminate UI loop.
    */
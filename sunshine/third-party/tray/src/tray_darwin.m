@@ -87,14 +87,47 @@ int tray_loop(int blocking) {
   return 0;
 }
 
-void tray_update(struct tray *tray) {
+static NSMenuItem *_tray_find_item(NSMenu *menu, struct tray_menu *m) {
+  for (NSMenuItem *menuItem in [menu itemArray]) {
+    if ([[menuItem representedObject] pointerValue] == m) {
+      return menuItem;
+    }
+    if ([menuItem hasSubmenu]) {
+      NSMenuItem *found = _tray_find_item([menuItem submenu], m);
+      if (found != nil) {
+        return found;
+      }
+    }
+  }
+  return nil;
+}
+
+static void _tray_set_icon(struct tray *tray) {
   NSImage *image = [[NSImage alloc] initWithContentsOfFile:[NSString stringWithUTF8String:tray->icon]];
   NSSize size = NSMakeSize(16, 16);
   [image setSize:NSMakeSize(16, 16)];
   statusItem.button.image = image;
+}
+
+void tray_update(struct tray *tray) {
+  _tray_set_icon(tray);
   [statusItem setMenu:_tray_menu(tray->menu)];
 }
 
+void tray_update_item(struct tray_menu *m) {
+  NSMenuItem *menuItem = m->text != NULL ? _tray_find_item([statusItem menu], m) : nil;
+  if (menuItem == nil) {
+    return;
+  }
+  [menuItem setTitle:[NSString stringWithUTF8String:m->text]];
+  [menuItem setEnabled:(m->disabled ? FALSE : TRUE)];
+  [menuItem setState:(m->checked ? 1 : 0)];
+}
+
+void tray_update_icon(struct tray *tray) {
+  _tray_set_icon(tray);
+}
+
 void tray_exit(void) {
   [app terminate:app];
 }
@@ -18,6 +18,7 @@
 #endif
 #include <libnotify/notify.h>
 #define TRAY_APPINDICATOR_ID "tray-id"  ///< Tray appindicator ID.
+#define TRAY_MENU_DATA_KEY "tray-menu"  ///< Key of the tray_menu pointer stored on the native menu items.
 
 // local includes
 #include "tray.h"
@@ -27,6 +28,7 @@ static pthread_cond_t async_update_cv = PTHREAD_COND_INITIALIZER;
 static pthread_mutex_t async_update_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 static AppIndicator *indicator = NULL;
+static GtkMenuShell *current_menu = NULL;
 static int loop_result = 0;
 static NotifyNotification *currentNotification = NULL;
 
@@ -57,12 +59,82 @@ static GtkMenuShell *_tray_menu(struct tray_menu *m) {
         g_signal_connect(item, "activate", G_CALLBACK(_tray_menu_cb), m);
       }
     }
+    g_object_set_data(G_OBJECT(item), TRAY_MENU_DATA_KEY, m);
     gtk_widget_show(item);
     gtk_menu_shell_append(menu, item);
   }
   return menu;
 }
 
+static GtkWidget *_tray_find_item(GtkMenuShell *menu, struct tray_menu *m) {
+  GtkWidget *found = NULL;
+  GList *children = gtk_container_get_children(GTK_CONTAINER(menu));
+  for (GList *child = children; child != NULL && found == NULL; child = child->next) {
+    GtkWidget *item = GTK_WIDGET(child->data);
+    if (g_object_get_data(G_OBJECT(item), TRAY_MENU_DATA_KEY) == m) {
+      found = item;
+    } else if (GTK_IS_MENU_ITEM(item)) {
+      GtkWidget *submenu = gtk_menu_item_get_submenu(GTK_MENU_ITEM(item));
+      if (submenu != NULL) {
+        found = _tray_find_item(GTK_MENU_SHELL(submenu), m);
+      }
+    }
+  }
+  g_list_free(children);
+  return found;
+}
+
+/**
+ * @brief Function to run on the tray loop thread, with its argument.
+ */
+struct tray_call {
+  void (*fn)(void *);  ///< Function to run.
+  void *data;  ///< Argument of the function.
+};
+
+static gboolean _tray_call_internal(gpointer user_data) {
+  struct tray_call *call = user_data;
+  call->fn(call->data);
+
+  // Unwait any pending tray_update() calls
+  pthread_mutex_lock(&async_update_mutex);
+  async_update_pending = false;
+  pthread_cond_broadcast(&async_update_cv);
+  pthread_mutex_unlock(&async_update_mutex);
+  return G_SOURCE_REMOVE;
+}
+
+static void _tray_invoke_sync(void (*fn)(void *), void *data) {
+  // Perform the update on the tray loop thread, but block
+  // in this thread to ensure none of the strings stored in the
+  // tray structs go out of scope before the callback runs.
+
+  if (g_main_context_is_owner(g_main_context_default())) {
+    // Invoke the callback directly if we're on the loop thread
+    fn(data);
+  } else {
+    // If there's already an update pending, wait for it to complete
+    // and claim the next pending update slot.
+    pthread_mutex_lock(&async_update_mutex);
+    while (async_update_pending) {
+      pthread_cond_wait(&async_update_cv, &async_update_mutex);
+    }
+    async_update_pending = true;
+    pthread_mutex_unlock(&async_update_mutex);
+
+    // Queue the update callback to the tray thread, the call lives until it has run
+    struct tray_call call = {.fn = fn, .data = data};
+    g_main_context_invoke(NULL, _tray_call_internal, &call);
+
+    // Wait for the callback to run
+    pthread_mutex_lock(&async_update_mutex);
+    while (async_update_pending) {
+      pthread_cond_wait(&async_update_cv, &async_update_mutex);
+    }
+    pthread_mutex_unlock(&async_update_mutex);
+  }
+}
+
 int tray_init(struct tray *tray) {
   if (gtk_init_check(0, NULL) == FALSE) {
     return -1;
@@ -82,14 +154,15 @@ int tray_loop(int blocking) {
   return loop_result;
 }
 
-static gboolean tray_update_internal(gpointer user_data) {
-  struct tray *tray = user_data;
+static void tray_update_internal(void *data) {
+  struct tray *tray = data;
 
   if (indicator != NULL && IS_APP_INDICATOR(indicator)) {
     app_indicator_set_icon_full(indicator, tray->icon, tray->icon);
     // GTK is all about reference counting, so previous menu should be destroyed
     // here
-    app_indicator_set_menu(indicator, GTK_MENU(_tray_menu(tray->menu)));
+    current_menu = _tray_menu(tray->menu);
+    app_indicator_set_menu(indicator, GTK_MENU(current_menu));
   }
   if (tray->notification_text != 0 && strlen(tray->notification_text) > 0 && notify_is_initted()) {
     if (currentNotification != NULL && NOTIFY_IS_NOTIFICATION(currentNotification)) {
@@ -105,45 +178,48 @@ static gboolean tray_update_internal(gpointer user_data) {
       notify_notification_show(currentNotification, NULL);
     }
   }
-
-  // Unwait any pending tray_update() calls
-  pthread_mutex_lock(&async_update_mutex);
-  async_update_pending = false;
-  pthread_cond_broadcast(&async_update_cv);
-  pthread_mutex_unlock(&async_update_mutex);
-  return G_SOURCE_REMOVE;
 }
 
 void tray_update(struct tray *tray) {
-  // Perform the tray update on the tray loop thread, but block
-  // in this thread to ensure none of the strings stored in the
-  // tray icon struct go out of scope before the callback runs.
+  _tray_invoke_sync(tray_update_internal, tray);
+}
 
-  if (g_main_context_is_owner(g_main_context_default())) {
-    // Invoke the callback directly if we're on the loop thread
-    tray_update_internal(tray);
-  } else {
-    // If there's already an update pending, wait for it to complete
-    // and claim the next pending update slot.
-    pthread_mutex_lock(&async_update_mutex);
-    while (async_update_pending) {
-      pthread_cond_wait(&async_update_cv, &async_update_mutex);
-    }
-    async_update_pending = true;
-    pthread_mutex_unlock(&async_update_mutex);
+static void tray_update_item_internal(void *data) {
+  struct tray_menu *m = data;
+  if (current_menu == NULL || m->text == NULL) {
+    return;
+  }
 
-    // Queue the update callback to the tray thread
-    g_main_context_invoke(NULL, tray_update_internal, tray);
+  GtkWidget *item = _tray_find_item(current_menu, m);
+  if (item == NULL || GTK_IS_SEPARATOR_MENU_ITEM(item)) {
+    return;
+  }
 
-    // Wait for the callback to run
-    pthread_mutex_lock(&async_update_mutex);
-    while (async_update_pending) {
-      pthread_cond_wait(&async_update_cv, &async_update_mutex);
-    }
-    pthread_mutex_unlock(&async_update_mutex);
+  gtk_menu_item_set_label(GTK_MENU_ITEM(item), m->text);
+  gtk_widget_set_sensitive(item, !m->disabled);
+  if (GTK_IS_CHECK_MENU_ITEM(item)) {
+    // Changing the state emits "activate", which must not invoke the callback again
+    g_signal_handlers_block_by_func(item, G_CALLBACK(_tray_menu_cb), m);
+    gtk_check_menu_item_set_active(GTK_CHECK_MENU_ITEM(item), !!m->checked);
+    g_signal_handlers_unblock_by_func(item, G_CALLBACK(_tray_menu_cb), m);
   }
 }
 
+void tray_update_item(struct tray_menu *item) {
+  _tray_invoke_sync(tray_update_item_internal, item);
+}
+
+static void tray_update_icon_internal(void *data) {
+  struct tray *tray = data;
+  if (indicator != NULL && IS_APP_INDICATOR(indicator)) {
+    app_indicator_set_icon_full(indicator, tray->icon, tray->icon);
+  }
+}
+
+void tray_update_icon(struct tray *tray) {
+  _tray_invoke_sync(tray_update_icon_internal, tray);
+}
+
 static gboolean tray_exit_internal(gpointer user_data) {
   if (currentNotification != NULL && NOTIFY_IS_NOTIFICATION(currentNotification)) {
     int v = notify_notification_close(currentNotification, NULL);
@@ -90,6 +90,20 @@ static LRESULT CALLBACK _tray_wnd_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARA
   return DefWindowProc(hwnd, msg, wparam, lparam);
 }
 
+/**
+ * @brief Convert UTF-8 text to UTF-16 (wide string).
+ * @param text UTF-8 text.
+ * @return Wide string to be freed by the caller, or NULL on allocation failure.
+ */
+static wchar_t *_tray_wide_text(const char *text) {
+  int wide_size = MultiByteToWideChar(CP_UTF8, 0, text, -1, NULL, 0);
+  wchar_t *wide_text = (wchar_t *) malloc(wide_size * sizeof(wchar_t));
+  if (wide_text != NULL) {
+    MultiByteToWideChar(CP_UTF8, 0, text, -1, wide_text, wide_size);
+  }
+  return wide_text;
+}
+
 static HMENU _tray_menu(struct tray_menu *m, UINT *id) {
   HMENU hmenu = CreatePopupMenu();
   for (; m != NULL && m->text != NULL; m++, (*id)++) {
@@ -114,14 +128,11 @@ static HMENU _tray_menu(struct tray_menu *m, UINT *id) {
       }
       item.wID = *id;
 
-      // Convert UTF-8 text to UTF-16 (wide string)
-      int wide_size = MultiByteToWideChar(CP_UTF8, 0, m->text, -1, NULL, 0);
-      wchar_t *wide_text = (wchar_t *) malloc(wide_size * sizeof(wchar_t));
+      wchar_t *wide_text = _tray_wide_text(m->text);
       if (wide_text == NULL) {
         DestroyMenu(hmenu);
         return NULL;
       }
-      MultiByteToWideChar(CP_UTF8, 0, m->text, -1, wide_text, wide_size);
 
       item.dwTypeData = wide_text;
       item.dwItemData = (ULONG_PTR) m;
@@ -134,6 +145,37 @@ static HMENU _tray_menu(struct tray_menu *m, UINT *id) {
   return hmenu;
 }
 
+/**
+ * @brief Find the native menu item of a tray menu item.
+ * @param hmenu Menu to search, including its submenus.
+ * @param m Tray menu item to find.
+ * @param out_menu On output, the menu containing the item.
+ * @return Position of the item in the containing menu, or -1 if not found.
+ */
+static int _tray_find_item(HMENU hmenu, struct tray_menu *m, HMENU *out_menu) {
+  int count = GetMenuItemCount(hmenu);
+  for (int i = 0; i < count; i++) {
+    MENUITEMINFOW item = {
+      .cbSize = sizeof(MENUITEMINFOW),
+      .fMask = MIIM_DATA | MIIM_SUBMENU,
+    };
+    if (!GetMenuItemInfoW(hmenu, i, TRUE, &item)) {
+      continue;
+    }
+    if (item.dwItemData == (ULONG_PTR) m) {
+      *out_menu = hmenu;
+      return i;
+    }
+    if (item.hSubMenu != NULL) {
+      int position = _tray_find_item(item.hSubMenu, m, out_menu);
+      if (position >= 0) {
+        return position;
+      }
+    }
+  }
+  return -1;
+}
+
 /**
  * @brief Create icon information.
  * @param path Path to the icon.
@@ -315,6 +357,45 @@ void tray_update(struct tray *tray) {
   }
 }
 
+void tray_update_item(struct tray_menu *m) {
+  HMENU item_menu;
+  int position = hmenu != NULL && m->text != NULL ? _tray_find_item(hmenu, m, &item_menu) : -1;
+  if (position < 0) {
+    return;
+  }
+
+  wchar_t *wide_text = _tray_wide_text(m->text);
+  if (wide_text == NULL) {
+    return;
+  }
+
+  MENUITEMINFOW item;
+  memset(&item, 0, sizeof(item));
+  item.cbSize = sizeof(MENUITEMINFOW);
+  item.fMask = MIIM_STRING | MIIM_STATE;
+  item.fState = (m->disabled ? MFS_DISABLED : 0) | (m->checked ? MFS_CHECKED : 0);
+  item.dwTypeData = wide_text;
+  SetMenuItemInfoW(item_menu, position, TRUE, &item);
+  free(wide_text);
+}
+
+void tray_update_icon(struct tray *tray) {
+  HICON icon = _fetch_icon(tray->icon, REGULAR);
+  if (icon != NULL) {
+    nid.hIcon = icon;
+  }
+  if (tray->tooltip != 0 && strlen(tray->tooltip) > 0) {
+    MultiByteToWideChar(CP_UTF8, 0, tray->tooltip, -1, nid.szTip, sizeof(nid.szTip) / sizeof(wchar_t));
+    nid.uFlags |= NIF_TIP;
+  }
+
+  // Leave out the notification, or the last one would be shown again
+  UINT flags = nid.uFlags;
+  nid.uFlags &= ~NIF_INFO;
+  Shell_NotifyIconW(NIM_MODIFY, &nid);
+  nid.uFlags = flags;
+}
+
 void tray_exit(void) {
   Shell_NotifyIconW(NIM_DELETE, &nid);
   _destroy_icon_cache();
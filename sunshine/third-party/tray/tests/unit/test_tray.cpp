@@ -132,6 +132,38 @@ TEST_F(TrayTest, TestToggleCallback) {
   EXPECT_EQ(testTray.menu[1].checked, !initialCheckedState);
 }
 
+TEST_F(TrayTest, TestTrayUpdateItem) {
+  // update an item in place
+  testTray.menu[0].text = "Hello2";
+  testTray.menu[2].disabled = 0;
+  tray_update_item(&testTray.menu[0]);
+  tray_update_item(&testTray.menu[2]);
+  EXPECT_STREQ(testTray.menu[0].text, "Hello2");
+  EXPECT_EQ(testTray.menu[2].disabled, 0);
+
+  // update an item of a submenu
+  tray_update_item(&submenu7_8[0]);
+
+  // put back the original values
+  testTray.menu[0].text = "Hello";
+  testTray.menu[2].disabled = 1;
+  tray_update_item(&testTray.menu[0]);
+  tray_update_item(&testTray.menu[2]);
+  EXPECT_STREQ(testTray.menu[0].text, "Hello");
+  EXPECT_EQ(testTray.menu[2].disabled, 1);
+}
+
+TEST_F(TrayTest, TestTrayUpdateIcon) {
+  testTray.icon = TRAY_ICON2;
+  tray_update_icon(&testTray);
+  EXPECT_EQ(testTray.icon, TRAY_ICON2);
+
+  // put back the original value
+  testTray.icon = TRAY_ICON1;
+  tray_update_icon(&testTray);
+  EXPECT_EQ(testTray.icon, TRAY_ICON1);
+}
+
 TEST_F(TrayTest, TestTrayExit) {
   tray_exit();
   // TODO: Check the state after tray_exit